@@ -0,0 +1,17 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/com_google_googletest"
+  "CMakeFiles/com_google_googletest-complete"
+  "com_google_googletest-prefix/src/com_google_googletest-stamp/com_google_googletest-build"
+  "com_google_googletest-prefix/src/com_google_googletest-stamp/com_google_googletest-configure"
+  "com_google_googletest-prefix/src/com_google_googletest-stamp/com_google_googletest-download"
+  "com_google_googletest-prefix/src/com_google_googletest-stamp/com_google_googletest-install"
+  "com_google_googletest-prefix/src/com_google_googletest-stamp/com_google_googletest-mkdir"
+  "com_google_googletest-prefix/src/com_google_googletest-stamp/com_google_googletest-patch"
+  "com_google_googletest-prefix/src/com_google_googletest-stamp/com_google_googletest-test"
+  "com_google_googletest-prefix/src/com_google_googletest-stamp/com_google_googletest-update"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang )
+  include(CMakeFiles/com_google_googletest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
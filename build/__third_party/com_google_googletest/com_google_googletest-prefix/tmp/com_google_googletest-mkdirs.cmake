@@ -0,0 +1,22 @@
+# Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+# file Copyright.txt or https://cmake.org/licensing for details.
+
+cmake_minimum_required(VERSION 3.5)
+
+file(MAKE_DIRECTORY
+  "/root/repo/build/__third_party/com_google_googletest/src"
+  "/root/repo/build/__third_party/com_google_googletest/build"
+  "/root/repo/build/__third_party/com_google_googletest/com_google_googletest-prefix"
+  "/root/repo/build/__third_party/com_google_googletest/com_google_googletest-prefix/tmp"
+  "/root/repo/build/__third_party/com_google_googletest/com_google_googletest-prefix/src/com_google_googletest-stamp"
+  "/root/repo/build/__third_party/com_google_googletest/com_google_googletest-prefix/src"
+  "/root/repo/build/__third_party/com_google_googletest/com_google_googletest-prefix/src/com_google_googletest-stamp"
+)
+
+set(configSubDirs )
+foreach(subDir IN LISTS configSubDirs)
+    file(MAKE_DIRECTORY "/root/repo/build/__third_party/com_google_googletest/com_google_googletest-prefix/src/com_google_googletest-stamp/${subDir}")
+endforeach()
+if(cfgdir)
+  file(MAKE_DIRECTORY "/root/repo/build/__third_party/com_google_googletest/com_google_googletest-prefix/src/com_google_googletest-stamp${cfgdir}") # cfgdir has leading slash
+endif()
@@ -17,7 +17,11 @@
 #ifndef TINK_AEAD_H_
 #define TINK_AEAD_H_
 
+#include <cstring>
+
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "tink/util/status.h"
 #include "tink/util/statusor.h"
 
 namespace crypto {
@@ -49,7 +53,146 @@ class Aead {
       absl::string_view ciphertext,
       absl::string_view associated_data) const = 0;
 
+  // A conservative upper bound on the ciphertext overhead (output prefix,
+  // IV and tag) of Tink's self-contained Aead implementations; used by the
+  // default MaxEncryptionSize() below. It does not cover implementations
+  // whose ciphertext embeds backend-dependent material, such as the
+  // KMS-wrapped DEK stored by KmsEnvelopeAead.
+  static constexpr size_t kMaxCiphertextOverhead = 128;
+
+  // Returns an upper bound on the size of the ciphertext for a plaintext of
+  // the given size. Implementations which know their exact overhead should
+  // override this. The default bound is NOT a hard guarantee: it holds for
+  // Tink's self-contained ciphers, but implementations with variable,
+  // backend-dependent overhead (e.g. KMS-backed AEADs) inherit it and can
+  // produce larger ciphertexts. Callers sizing buffers from this value must
+  // therefore treat an "output buffer too small" failure of EncryptInto()
+  // as recoverable and fall back to Encrypt().
+  virtual size_t MaxEncryptionSize(size_t plaintext_size) const {
+    return plaintext_size + kMaxCiphertextOverhead;
+  }
+
+  // Encrypts 'plaintext' with 'associated_data' as associated data, writing
+  // the ciphertext into the caller-provided buffer 'out', and returns the
+  // number of bytes written. 'out' must be at least
+  // MaxEncryptionSize(plaintext.size()) bytes long; since that bound is not
+  // guaranteed for every implementation (see above), callers must be
+  // prepared for a buffer-size failure. Unless documented
+  // otherwise by the implementation, 'plaintext' must not overlap 'out'.
+  // The default implementation falls back to Encrypt() and copies;
+  // implementations should override it to write the ciphertext directly
+  // into 'out' so that callers can reuse preallocated buffers.
+  virtual crypto::tink::util::StatusOr<size_t> EncryptInto(
+      absl::string_view plaintext, absl::string_view associated_data,
+      absl::Span<char> out) const {
+    auto ciphertext = Encrypt(plaintext, associated_data);
+    if (!ciphertext.ok()) return ciphertext.status();
+    if (out.size() < ciphertext.ValueOrDie().size()) {
+      return crypto::tink::util::Status(
+          crypto::tink::util::error::INVALID_ARGUMENT,
+          "Output buffer too small.");
+    }
+    memcpy(out.data(), ciphertext.ValueOrDie().data(),
+           ciphertext.ValueOrDie().size());
+    return ciphertext.ValueOrDie().size();
+  }
+
+  // Decrypts 'ciphertext' with 'associated_data' as associated data, writing
+  // the plaintext into the caller-provided buffer 'out', and returns the
+  // number of bytes written. 'out' must be at least ciphertext.size() bytes
+  // long (the plaintext is always shorter than the ciphertext). On failure
+  // the contents of 'out' are unspecified. Unless documented otherwise by the
+  // implementation, 'ciphertext' must not overlap 'out'.
+  // The default implementation falls back to Decrypt() and copies;
+  // implementations should override it to write the plaintext directly into
+  // 'out' so that callers can reuse preallocated buffers.
+  virtual crypto::tink::util::StatusOr<size_t> DecryptInto(
+      absl::string_view ciphertext, absl::string_view associated_data,
+      absl::Span<char> out) const {
+    auto plaintext = Decrypt(ciphertext, associated_data);
+    if (!plaintext.ok()) return plaintext.status();
+    if (out.size() < plaintext.ValueOrDie().size()) {
+      return crypto::tink::util::Status(
+          crypto::tink::util::error::INVALID_ARGUMENT,
+          "Output buffer too small.");
+    }
+    memcpy(out.data(), plaintext.ValueOrDie().data(),
+           plaintext.ValueOrDie().size());
+    return plaintext.ValueOrDie().size();
+  }
+
+  // Encrypts the concatenation of the 'plaintext' fragments, with the
+  // concatenation of the 'associated_data' fragments as associated data, and
+  // returns the resulting ciphertext; fully equivalent to concatenating the
+  // fragments and calling Encrypt(). The default implementation does exactly
+  // that; implementations should override it to hand the fragments to the
+  // cipher without coalescing them first, so that callers assembling
+  // messages from several pieces (e.g. envelope header fields as associated
+  // data) need no concatenation per operation.
+  virtual crypto::tink::util::StatusOr<std::string> EncryptFragments(
+      absl::Span<const absl::string_view> plaintext,
+      absl::Span<const absl::string_view> associated_data) const {
+    std::string full_plaintext = ConcatFragments(plaintext);
+    std::string full_associated_data = ConcatFragments(associated_data);
+    return Encrypt(full_plaintext, full_associated_data);
+  }
+
+  // Decrypts 'ciphertext' with the concatenation of the 'associated_data'
+  // fragments as associated data; fully equivalent to concatenating the
+  // fragments and calling Decrypt(). See EncryptFragments().
+  virtual crypto::tink::util::StatusOr<std::string> DecryptFragments(
+      absl::string_view ciphertext,
+      absl::Span<const absl::string_view> associated_data) const {
+    std::string full_associated_data = ConcatFragments(associated_data);
+    return Decrypt(ciphertext, full_associated_data);
+  }
+
+  // Encrypts each entry of 'plaintexts' with 'associated_data' as associated
+  // data, writing ciphertext i into the caller-provided buffer 'outs[i]' and
+  // its size into 'ciphertext_sizes[i]'. All three spans must have the same
+  // length, and each outs[i] must be at least
+  // MaxEncryptionSize(plaintexts[i].size()) bytes long.
+  // The default implementation calls EncryptInto() per entry; implementations
+  // can override it to amortize per-call setup costs (e.g. IV generation)
+  // over the whole batch.
+  virtual crypto::tink::util::Status EncryptBatch(
+      absl::Span<const absl::string_view> plaintexts,
+      absl::string_view associated_data, absl::Span<const absl::Span<char>> outs,
+      absl::Span<size_t> ciphertext_sizes) const {
+    if (plaintexts.size() != outs.size() ||
+        plaintexts.size() != ciphertext_sizes.size()) {
+      return crypto::tink::util::Status(
+          crypto::tink::util::error::INVALID_ARGUMENT,
+          "plaintexts, outs and ciphertext_sizes must have the same length.");
+    }
+    for (size_t i = 0; i < plaintexts.size(); i++) {
+      auto written = EncryptInto(plaintexts[i], associated_data, outs[i]);
+      if (!written.ok()) return written.status();
+      ciphertext_sizes[i] = written.ValueOrDie();
+    }
+    return crypto::tink::util::Status::OK;
+  }
+
   virtual ~Aead() {}
+
+ protected:
+  // Concatenates 'fragments' into one string; used by the default
+  // implementations of the fragment-based operations above.
+  static std::string ConcatFragments(
+      absl::Span<const absl::string_view> fragments) {
+    size_t total_size = 0;
+    for (absl::string_view fragment : fragments) {
+      total_size += fragment.size();
+    }
+    std::string result;
+    result.reserve(total_size);
+    for (absl::string_view fragment : fragments) {
+      if (!fragment.empty()) {
+        result.append(fragment.data(), fragment.size());
+      }
+    }
+    return result;
+  }
 };
 
 }  // namespace tink
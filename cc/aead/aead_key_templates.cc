@@ -17,20 +17,9 @@
 #include "tink/aead/aead_key_templates.h"
 
 #include "absl/strings/string_view.h"
-#include "proto/aes_ctr_hmac_aead.pb.h"
-#include "proto/aes_eax.pb.h"
-#include "proto/aes_gcm.pb.h"
-#include "proto/aes_gcm_siv.pb.h"
-#include "proto/common.pb.h"
 #include "proto/kms_envelope.pb.h"
 #include "proto/tink.pb.h"
-#include "proto/xchacha20_poly1305.pb.h"
 
-using google::crypto::tink::AesCtrHmacAeadKeyFormat;
-using google::crypto::tink::AesEaxKeyFormat;
-using google::crypto::tink::AesGcmKeyFormat;
-using google::crypto::tink::AesGcmSivKeyFormat;
-using google::crypto::tink::HashType;
 using google::crypto::tink::KeyTemplate;
 using google::crypto::tink::KmsEnvelopeAeadKeyFormat;
 using google::crypto::tink::OutputPrefixType;
@@ -40,67 +29,55 @@ namespace tink {
 
 namespace {
 
-KeyTemplate* NewAesEaxKeyTemplate(int key_size_in_bytes, int iv_size_in_bytes) {
+// The key formats of the templates below are fixed, and serialize to short,
+// deterministic byte strings. They are precomputed here as compile-time
+// constants so that first use of a template only fills in a KeyTemplate proto,
+// instead of building and serializing a key format proto as well; binaries
+// that start many short-lived processes pay that cost on every startup.
+// Each constant documents the message it encodes, and
+// aead_key_templates_test.cc checks the constants against the proto
+// serializer.
+
+// Serialized AesEaxKeyFormat with params.iv_size = 16, key_size = 16.
+constexpr char kAes128EaxKeyFormat[] = "\x0a\x02\x08\x10\x10\x10";
+
+// Serialized AesEaxKeyFormat with params.iv_size = 16, key_size = 32.
+constexpr char kAes256EaxKeyFormat[] = "\x0a\x02\x08\x10\x10\x20";
+
+// Serialized AesGcmKeyFormat with key_size = 16.
+constexpr char kAes128GcmKeyFormat[] = "\x10\x10";
+
+// Serialized AesGcmKeyFormat with key_size = 32.
+constexpr char kAes256GcmKeyFormat[] = "\x10\x20";
+
+// Serialized AesGcmSivKeyFormat with key_size = 16.
+constexpr char kAes128GcmSivKeyFormat[] = "\x10\x10";
+
+// Serialized AesGcmSivKeyFormat with key_size = 32.
+constexpr char kAes256GcmSivKeyFormat[] = "\x10\x20";
+
+// Serialized AesCtrHmacAeadKeyFormat with
+//   aes_ctr_key_format.params.iv_size = 16, aes_ctr_key_format.key_size = 16,
+//   hmac_key_format.params.hash = SHA256, hmac_key_format.params.tag_size =
+//   16, hmac_key_format.key_size = 32.
+constexpr char kAes128CtrHmacSha256KeyFormat[] =
+    "\x0a\x06\x0a\x02\x08\x10\x10\x10\x12\x08\x0a\x04\x08\x03\x10\x10\x10\x20";
+
+// Serialized AesCtrHmacAeadKeyFormat with
+//   aes_ctr_key_format.params.iv_size = 16, aes_ctr_key_format.key_size = 32,
+//   hmac_key_format.params.hash = SHA256, hmac_key_format.params.tag_size =
+//   32, hmac_key_format.key_size = 32.
+constexpr char kAes256CtrHmacSha256KeyFormat[] =
+    "\x0a\x06\x0a\x02\x08\x10\x10\x20\x12\x08\x0a\x04\x08\x03\x10\x20\x10\x20";
+
+KeyTemplate* NewKeyTemplate(const char* type_url,
+                            OutputPrefixType output_prefix_type,
+                            const char* serialized_key_format,
+                            size_t serialized_key_format_size) {
   KeyTemplate* key_template = new KeyTemplate;
-  key_template->set_type_url(
-      "type.googleapis.com/google.crypto.tink.AesEaxKey");
-  key_template->set_output_prefix_type(OutputPrefixType::TINK);
-  AesEaxKeyFormat key_format;
-  key_format.set_key_size(key_size_in_bytes);
-  key_format.mutable_params()->set_iv_size(iv_size_in_bytes);
-  key_format.SerializeToString(key_template->mutable_value());
-  return key_template;
-}
-
-KeyTemplate* NewAesGcmKeyTemplate(int key_size_in_bytes,
-                                  OutputPrefixType output_prefix_type) {
-  KeyTemplate* key_template = new KeyTemplate;
-  key_template->set_type_url(
-      "type.googleapis.com/google.crypto.tink.AesGcmKey");
+  key_template->set_type_url(type_url);
   key_template->set_output_prefix_type(output_prefix_type);
-  AesGcmKeyFormat key_format;
-  key_format.set_key_size(key_size_in_bytes);
-  key_format.SerializeToString(key_template->mutable_value());
-  return key_template;
-}
-
-KeyTemplate* NewAesGcmSivKeyTemplate(int key_size_in_bytes) {
-  KeyTemplate* key_template = new KeyTemplate;
-  key_template->set_type_url(
-      "type.googleapis.com/google.crypto.tink.AesGcmSivKey");
-  key_template->set_output_prefix_type(OutputPrefixType::TINK);
-  AesGcmSivKeyFormat key_format;
-  key_format.set_key_size(key_size_in_bytes);
-  key_format.SerializeToString(key_template->mutable_value());
-  return key_template;
-}
-
-KeyTemplate* NewAesCtrHmacAeadKeyTemplate(int aes_key_size_in_bytes,
-                                          int iv_size_in_bytes,
-                                          int hmac_key_size_in_bytes,
-                                          int tag_size_in_bytes,
-                                          HashType hash_type) {
-  KeyTemplate* key_template = new KeyTemplate;
-  key_template->set_type_url(
-      "type.googleapis.com/google.crypto.tink.AesCtrHmacAeadKey");
-  key_template->set_output_prefix_type(OutputPrefixType::TINK);
-  AesCtrHmacAeadKeyFormat key_format;
-  auto aes_ctr_key_format = key_format.mutable_aes_ctr_key_format();
-  aes_ctr_key_format->set_key_size(aes_key_size_in_bytes);
-  aes_ctr_key_format->mutable_params()->set_iv_size(iv_size_in_bytes);
-  auto hmac_key_format = key_format.mutable_hmac_key_format();
-  hmac_key_format->set_key_size(hmac_key_size_in_bytes);
-  hmac_key_format->mutable_params()->set_hash(hash_type);
-  hmac_key_format->mutable_params()->set_tag_size(tag_size_in_bytes);
-  key_format.SerializeToString(key_template->mutable_value());
-  return key_template;
-}
-
-KeyTemplate* NewXChaCha20Poly1305KeyTemplate() {
-  KeyTemplate* key_template = new KeyTemplate;
-  key_template->set_type_url(
-      "type.googleapis.com/google.crypto.tink.XChaCha20Poly1305Key");
-  key_template->set_output_prefix_type(OutputPrefixType::TINK);
+  key_template->set_value(serialized_key_format, serialized_key_format_size);
   return key_template;
 }
 
@@ -108,78 +85,91 @@ KeyTemplate* NewXChaCha20Poly1305KeyTemplate() {
 
 // static
 const KeyTemplate& AeadKeyTemplates::Aes128Eax() {
-  static const KeyTemplate* key_template =
-      NewAesEaxKeyTemplate(/* key_size_in_bytes= */ 16,
-                           /* iv_size_in_bytes= */ 16);
+  static const KeyTemplate* key_template = NewKeyTemplate(
+      "type.googleapis.com/google.crypto.tink.AesEaxKey",
+      OutputPrefixType::TINK, kAes128EaxKeyFormat,
+      sizeof(kAes128EaxKeyFormat) - 1);
   return *key_template;
 }
 
 // static
 const KeyTemplate& AeadKeyTemplates::Aes256Eax() {
-  static const KeyTemplate* key_template =
-      NewAesEaxKeyTemplate(/* key_size_in_bytes= */ 32,
-                           /* iv_size_in_bytes= */ 16);
+  static const KeyTemplate* key_template = NewKeyTemplate(
+      "type.googleapis.com/google.crypto.tink.AesEaxKey",
+      OutputPrefixType::TINK, kAes256EaxKeyFormat,
+      sizeof(kAes256EaxKeyFormat) - 1);
   return *key_template;
 }
 
 // static
 const KeyTemplate& AeadKeyTemplates::Aes128Gcm() {
-  static const KeyTemplate* key_template =
-      NewAesGcmKeyTemplate(/* key_size_in_bytes= */ 16, OutputPrefixType::TINK);
+  static const KeyTemplate* key_template = NewKeyTemplate(
+      "type.googleapis.com/google.crypto.tink.AesGcmKey",
+      OutputPrefixType::TINK, kAes128GcmKeyFormat,
+      sizeof(kAes128GcmKeyFormat) - 1);
   return *key_template;
 }
 
 // static
 const KeyTemplate& AeadKeyTemplates::Aes256Gcm() {
-  static const KeyTemplate* key_template =
-      NewAesGcmKeyTemplate(/* key_size_in_bytes= */ 32, OutputPrefixType::TINK);
+  static const KeyTemplate* key_template = NewKeyTemplate(
+      "type.googleapis.com/google.crypto.tink.AesGcmKey",
+      OutputPrefixType::TINK, kAes256GcmKeyFormat,
+      sizeof(kAes256GcmKeyFormat) - 1);
   return *key_template;
 }
 
 // static
 const KeyTemplate& AeadKeyTemplates::Aes256GcmNoPrefix() {
-  static const KeyTemplate* key_template =
-      NewAesGcmKeyTemplate(/* key_size_in_bytes= */ 32, OutputPrefixType::RAW);
+  static const KeyTemplate* key_template = NewKeyTemplate(
+      "type.googleapis.com/google.crypto.tink.AesGcmKey",
+      OutputPrefixType::RAW, kAes256GcmKeyFormat,
+      sizeof(kAes256GcmKeyFormat) - 1);
   return *key_template;
 }
 
 // static
 const KeyTemplate& AeadKeyTemplates::Aes128GcmSiv() {
-  static const KeyTemplate* key_template =
-      NewAesGcmSivKeyTemplate(/* key_size_in_bytes= */ 16);
+  static const KeyTemplate* key_template = NewKeyTemplate(
+      "type.googleapis.com/google.crypto.tink.AesGcmSivKey",
+      OutputPrefixType::TINK, kAes128GcmSivKeyFormat,
+      sizeof(kAes128GcmSivKeyFormat) - 1);
   return *key_template;
 }
 
 // static
 const KeyTemplate& AeadKeyTemplates::Aes256GcmSiv() {
-  static const KeyTemplate* key_template =
-      NewAesGcmSivKeyTemplate(/* key_size_in_bytes= */ 32);
+  static const KeyTemplate* key_template = NewKeyTemplate(
+      "type.googleapis.com/google.crypto.tink.AesGcmSivKey",
+      OutputPrefixType::TINK, kAes256GcmSivKeyFormat,
+      sizeof(kAes256GcmSivKeyFormat) - 1);
   return *key_template;
 }
 
 // static
 const KeyTemplate& AeadKeyTemplates::Aes128CtrHmacSha256() {
-  static const KeyTemplate* key_template = NewAesCtrHmacAeadKeyTemplate(
-      /* aes_key_size_in_bytes= */ 16,
-      /* iv_size_in_bytes= */ 16,
-      /* hmac_key_size_in_bytes= */ 32,
-      /* tag_size_in_bytes= */ 16, HashType::SHA256);
+  static const KeyTemplate* key_template = NewKeyTemplate(
+      "type.googleapis.com/google.crypto.tink.AesCtrHmacAeadKey",
+      OutputPrefixType::TINK, kAes128CtrHmacSha256KeyFormat,
+      sizeof(kAes128CtrHmacSha256KeyFormat) - 1);
   return *key_template;
 }
 
 // static
 const KeyTemplate& AeadKeyTemplates::Aes256CtrHmacSha256() {
-  static const KeyTemplate* key_template = NewAesCtrHmacAeadKeyTemplate(
-      /* aes_key_size_in_bytes= */ 32,
-      /* iv_size_in_bytes= */ 16,
-      /* hmac_key_size_in_bytes= */ 32,
-      /* tag_size_in_bytes= */ 32, HashType::SHA256);
+  static const KeyTemplate* key_template = NewKeyTemplate(
+      "type.googleapis.com/google.crypto.tink.AesCtrHmacAeadKey",
+      OutputPrefixType::TINK, kAes256CtrHmacSha256KeyFormat,
+      sizeof(kAes256CtrHmacSha256KeyFormat) - 1);
   return *key_template;
 }
 
 // static
 const KeyTemplate& AeadKeyTemplates::XChaCha20Poly1305() {
-  static const KeyTemplate* key_template = NewXChaCha20Poly1305KeyTemplate();
+  // XChaCha20Poly1305KeyFormat is empty, so is its serialization.
+  static const KeyTemplate* key_template = NewKeyTemplate(
+      "type.googleapis.com/google.crypto.tink.XChaCha20Poly1305Key",
+      OutputPrefixType::TINK, "", 0);
   return *key_template;
 }
 
@@ -390,6 +390,54 @@ TEST(AeadKeyTemplatesTest, testKmsEnvelopeAeadMultipleKeysSameKek) {
   EXPECT_THAT(EncryptThenDecrypt(*aead1, *aead2, "message", "aad"), IsOk());
 }
 
+TEST(AeadKeyTemplatesTest, SerializedFormatsMatchProtoSerializer) {
+  // The templates precompute their serialized key formats as compile-time
+  // constants; verify the constants against the proto serializer.
+  AesEaxKeyFormat eax_format;
+  eax_format.set_key_size(16);
+  eax_format.mutable_params()->set_iv_size(16);
+  EXPECT_EQ(AeadKeyTemplates::Aes128Eax().value(),
+            eax_format.SerializeAsString());
+  eax_format.set_key_size(32);
+  EXPECT_EQ(AeadKeyTemplates::Aes256Eax().value(),
+            eax_format.SerializeAsString());
+
+  AesGcmKeyFormat gcm_format;
+  gcm_format.set_key_size(16);
+  EXPECT_EQ(AeadKeyTemplates::Aes128Gcm().value(),
+            gcm_format.SerializeAsString());
+  gcm_format.set_key_size(32);
+  EXPECT_EQ(AeadKeyTemplates::Aes256Gcm().value(),
+            gcm_format.SerializeAsString());
+  EXPECT_EQ(AeadKeyTemplates::Aes256GcmNoPrefix().value(),
+            gcm_format.SerializeAsString());
+
+  AesGcmSivKeyFormat gcm_siv_format;
+  gcm_siv_format.set_key_size(16);
+  EXPECT_EQ(AeadKeyTemplates::Aes128GcmSiv().value(),
+            gcm_siv_format.SerializeAsString());
+  gcm_siv_format.set_key_size(32);
+  EXPECT_EQ(AeadKeyTemplates::Aes256GcmSiv().value(),
+            gcm_siv_format.SerializeAsString());
+
+  AesCtrHmacAeadKeyFormat ctr_hmac_format;
+  auto* aes_ctr_key_format = ctr_hmac_format.mutable_aes_ctr_key_format();
+  aes_ctr_key_format->set_key_size(16);
+  aes_ctr_key_format->mutable_params()->set_iv_size(16);
+  auto* hmac_key_format = ctr_hmac_format.mutable_hmac_key_format();
+  hmac_key_format->set_key_size(32);
+  hmac_key_format->mutable_params()->set_hash(HashType::SHA256);
+  hmac_key_format->mutable_params()->set_tag_size(16);
+  EXPECT_EQ(AeadKeyTemplates::Aes128CtrHmacSha256().value(),
+            ctr_hmac_format.SerializeAsString());
+  aes_ctr_key_format->set_key_size(32);
+  hmac_key_format->mutable_params()->set_tag_size(32);
+  EXPECT_EQ(AeadKeyTemplates::Aes256CtrHmacSha256().value(),
+            ctr_hmac_format.SerializeAsString());
+
+  EXPECT_TRUE(AeadKeyTemplates::XChaCha20Poly1305().value().empty());
+}
+
 }  // namespace
 }  // namespace tink
 }  // namespace crypto
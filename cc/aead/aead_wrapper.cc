@@ -16,10 +16,24 @@
 
 #include "tink/aead/aead_wrapper.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#include "absl/container/fixed_array.h"
 #include "tink/aead.h"
 #include "tink/crypto_format.h"
+#include "tink/internal/monitoring.h"
+#include "tink/internal/profiling.h"
+#include "tink/internal/registry_metrics.h"
+#include "tink/memory_footprint.h"
 #include "tink/primitive_set.h"
+#include "tink/subtle/aes_gcm_boringssl.h"
+#include "tink/subtle/subtle_util.h"
 #include "tink/subtle/subtle_util_boringssl.h"
+#include "tink/util/errors.h"
+#include "tink/util/execution_context.h"
+#include "tink/warmup.h"
 #include "tink/util/status.h"
 #include "tink/util/statusor.h"
 
@@ -28,6 +42,82 @@ namespace tink {
 
 namespace {
 
+// With at least this many RAW keys, trial decryption runs in parallel.
+constexpr size_t kParallelRawTrialThreshold = 8;
+// Upper bound on the workers racing the trials; see TryRawKeysParallel().
+constexpr int kRawTrialWorkers = 4;
+
+// True if every entry of 'aead_set' already holds a constructed primitive
+// of the concrete type subtle::AesGcmBoringSsl. Detected once at wrap time;
+// the trial loops then call the concrete Decrypt directly, which skips the
+// virtual dispatch per tried key and lets the compiler inline across the
+// loop. A lazy entry which has not materialized yet has an unknown type and
+// keeps the set non-uniform; sets wrapped through the registry build their
+// non-primary keys lazily, so the specialization mainly serves sets whose
+// primitives were constructed eagerly.
+bool IsUniformAesGcm(const PrimitiveSet<Aead>& aead_set) {
+  for (const auto* entry : aead_set.get_all()) {
+    const Aead* aead = entry->primitive_or_null();
+    if (aead == nullptr ||
+        dynamic_cast<const subtle::AesGcmBoringSsl*>(aead) == nullptr) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Decrypts with 'aead', devirtualized to AesGcmBoringSsl::Decrypt if the
+// caller established that the set is uniformly AES-GCM.
+util::StatusOr<std::string> TrialDecrypt(const Aead& aead,
+                                         bool uniform_aes_gcm,
+                                         absl::string_view ciphertext,
+                                         absl::string_view associated_data) {
+  if (uniform_aes_gcm) {
+    return static_cast<const subtle::AesGcmBoringSsl&>(aead)
+        .subtle::AesGcmBoringSsl::Decrypt(ciphertext, associated_data);
+  }
+  return aead.Decrypt(ciphertext, associated_data);
+}
+
+// Races trial decryptions of 'ciphertext' with the RAW keys in
+// 'raw_primitives' across a few workers (scheduled via the installed
+// ExecutionContext, if any). Workers stop claiming further keys once one
+// of them succeeds; a trial already under way runs to completion, since
+// an AEAD decryption cannot be interrupted midway. Returns the entry
+// whose key decrypted the ciphertext and fills 'plaintext', or nullptr
+// if no key matched.
+const PrimitiveSet<Aead>::Entry<Aead>* TryRawKeysParallel(
+    const PrimitiveSet<Aead>::Primitives& raw_primitives,
+    absl::string_view ciphertext, absl::string_view associated_data,
+    bool uniform_aes_gcm, std::string* plaintext) {
+  std::atomic<size_t> next_index(0);
+  std::atomic<bool> succeeded(false);
+  const PrimitiveSet<Aead>::Entry<Aead>* winner = nullptr;
+  auto work = [&raw_primitives, &ciphertext, &associated_data, &plaintext,
+               uniform_aes_gcm, &next_index, &succeeded, &winner]() {
+    while (!succeeded.load(std::memory_order_acquire)) {
+      size_t i = next_index.fetch_add(1);
+      if (i >= raw_primitives.size()) return;
+      auto aead_or = raw_primitives[i]->primitive_or_status();
+      if (!aead_or.ok()) continue;
+      auto decrypt_result = TrialDecrypt(*aead_or.ValueOrDie(),
+                                         uniform_aes_gcm, ciphertext,
+                                         associated_data);
+      // At most one key can carry the matching tag, so the exchange below
+      // has a single winner; it publishes the result and stops the race.
+      if (decrypt_result.ok() &&
+          !succeeded.exchange(true, std::memory_order_acq_rel)) {
+        *plaintext = std::move(decrypt_result.ValueOrDie());
+        winner = raw_primitives[i];
+      }
+    }
+  };
+  int worker_count = static_cast<int>(
+      std::min(static_cast<size_t>(kRawTrialWorkers), raw_primitives.size()));
+  util::RunParallelWork(/* context= */ nullptr, worker_count, work);
+  return winner;
+}
+
 util::Status Validate(PrimitiveSet<Aead>* aead_set) {
   if (aead_set == nullptr) {
     return util::Status(util::error::INTERNAL, "aead_set must be non-NULL");
@@ -39,10 +129,20 @@ util::Status Validate(PrimitiveSet<Aead>* aead_set) {
   return util::Status::OK;
 }
 
-class AeadSetWrapper : public Aead {
+// The wrapper is instantiated at wrap time for either a RAW primary
+// (no output prefix) or a prefixed primary, so the encrypt paths carry
+// no per-operation branch on the prefix type and skip the identifier
+// copy entirely when there is nothing to copy.
+template <bool kRawPrimary>
+class AeadSetWrapper : public Aead,
+                       public MemoryFootprintProvider,
+                       public Warmable {
  public:
   explicit AeadSetWrapper(std::unique_ptr<PrimitiveSet<Aead>> aead_set)
-      : aead_set_(std::move(aead_set)) {}
+      : aead_set_(std::move(aead_set)),
+        primary_(aead_set_->get_primary()),
+        key_id_(primary_->get_identifier()),
+        uniform_aes_gcm_(IsUniformAesGcm(*aead_set_)) {}
 
   crypto::tink::util::StatusOr<std::string> Encrypt(
       absl::string_view plaintext,
@@ -52,43 +152,215 @@ class AeadSetWrapper : public Aead {
       absl::string_view ciphertext,
       absl::string_view associated_data) const override;
 
+  size_t MaxEncryptionSize(size_t plaintext_size) const override {
+    return kPrefixSize +
+           primary_->get_primitive().MaxEncryptionSize(plaintext_size);
+  }
+
+  crypto::tink::util::StatusOr<size_t> EncryptInto(
+      absl::string_view plaintext, absl::string_view associated_data,
+      absl::Span<char> out) const override;
+
+  crypto::tink::util::Status EncryptBatch(
+      absl::Span<const absl::string_view> plaintexts,
+      absl::string_view associated_data,
+      absl::Span<const absl::Span<char>> outs,
+      absl::Span<size_t> ciphertext_sizes) const override;
+
+  // Reports the wrapper object plus everything the wrapped set holds
+  // (entries, lookup structures and the footprints the individual
+  // primitives report for themselves), so the value covers the whole
+  // keyset behind this Aead.
+  size_t MemoryFootprint() const override {
+    return sizeof(*this) + aead_set_->MemoryFootprint();
+  }
+
+  // Runs one dummy encryption and decryption with every key of the set,
+  // which materializes lazily built primitives, resolves the CPU feature
+  // dispatch of the underlying cipher and faults in the key schedules, so
+  // the first real operation does not pay these one-time costs. Best
+  // effort: all keys are attempted and the first error is returned.
+  util::Status Warmup() const override {
+    util::Status result = util::Status::OK;
+    for (const auto* entry : aead_set_->get_all()) {
+      auto aead_or = entry->primitive_or_status();
+      if (!aead_or.ok()) {
+        if (result.ok()) result = aead_or.status();
+        continue;
+      }
+      Aead& aead = *aead_or.ValueOrDie();
+      auto ciphertext = aead.Encrypt("warmup", "");
+      if (!ciphertext.ok()) {
+        if (result.ok()) result = ciphertext.status();
+        continue;
+      }
+      auto plaintext = aead.Decrypt(ciphertext.ValueOrDie(), "");
+      if (!plaintext.ok() && result.ok()) result = plaintext.status();
+    }
+    return result;
+  }
+
   ~AeadSetWrapper() override {}
 
  private:
+  // The primary's prefix size is a property of the keyset and fixed at
+  // wrap time: zero for a RAW primary, the standard 5-byte prefix
+  // otherwise.
+  static constexpr size_t kPrefixSize =
+      kRawPrimary ? 0 : CryptoFormat::kNonRawPrefixSize;
+
   std::unique_ptr<PrimitiveSet<Aead>> aead_set_;
+  // The set is sealed before wrapping, so the primary entry and its
+  // identifier are stable for the lifetime of the wrapper.
+  const PrimitiveSet<Aead>::Entry<Aead>* primary_;
+  absl::string_view key_id_;
+  // Whether every entry is a materialized subtle::AesGcmBoringSsl, in
+  // which case the trial loops call its Decrypt without virtual dispatch.
+  const bool uniform_aes_gcm_;
 };
 
-util::StatusOr<std::string> AeadSetWrapper::Encrypt(
+template <bool kRawPrimary>
+constexpr size_t AeadSetWrapper<kRawPrimary>::kPrefixSize;
+
+template <bool kRawPrimary>
+util::StatusOr<std::string> AeadSetWrapper<kRawPrimary>::Encrypt(
     absl::string_view plaintext, absl::string_view associated_data) const {
   // BoringSSL expects a non-null pointer for plaintext and additional_data,
   // regardless of whether the size is 0.
   plaintext = subtle::SubtleUtilBoringSSL::EnsureNonNull(plaintext);
   associated_data = subtle::SubtleUtilBoringSSL::EnsureNonNull(associated_data);
 
-  auto encrypt_result = aead_set_->get_primary()->get_primitive()
-      .Encrypt(plaintext, associated_data);
+  TINK_PROFILE_SCOPE(AeadEncrypt);
+  internal::MonitoredOp monitored_op("aead.encrypt", primary_->get_key_id());
+  // Write the output prefix and the ciphertext directly into the result
+  // string, instead of encrypting into a temporary and concatenating it
+  // behind the prefix -- the concatenation costs a second full-ciphertext
+  // copy.
+  Aead& primary = primary_->get_primitive();
+  std::string ciphertext;
+  subtle::ResizeStringUninitialized(
+      &ciphertext, kPrefixSize + primary.MaxEncryptionSize(plaintext.size()));
+  if (!kRawPrimary) {
+    std::memcpy(&ciphertext[0], key_id_.data(), kPrefixSize);
+  }
+  auto encrypt_result = primary.EncryptInto(
+      plaintext, associated_data,
+      absl::Span<char>(&ciphertext[0] + kPrefixSize,
+                       ciphertext.size() - kPrefixSize));
+  if (!encrypt_result.ok()) {
+    // MaxEncryptionSize() is not a hard guarantee: primitives whose overhead
+    // depends on a backend (e.g. KMS envelope encryption wrapping a DEK of
+    // backend-determined size) inherit the default bound and can exceed it,
+    // which makes EncryptInto() fail on an undersized buffer. Fall back to
+    // the allocating Encrypt() so such keys keep working through the
+    // wrapper; self-contained ciphers never take this path.
+    auto fallback_result = primary.Encrypt(plaintext, associated_data);
+    if (!fallback_result.ok()) {
+      monitored_op.SetFailed();
+      return fallback_result.status();
+    }
+    primary_->IncrementHitCount();
+    ciphertext.resize(kPrefixSize);
+    ciphertext.append(fallback_result.ValueOrDie());
+    return std::move(ciphertext);
+  }
+  primary_->IncrementHitCount();
+  ciphertext.resize(kPrefixSize + encrypt_result.ValueOrDie());
+  return std::move(ciphertext);
+}
+
+template <bool kRawPrimary>
+util::StatusOr<size_t> AeadSetWrapper<kRawPrimary>::EncryptInto(
+    absl::string_view plaintext, absl::string_view associated_data,
+    absl::Span<char> out) const {
+  plaintext = subtle::SubtleUtilBoringSSL::EnsureNonNull(plaintext);
+  associated_data = subtle::SubtleUtilBoringSSL::EnsureNonNull(associated_data);
+
+  if (out.size() < kPrefixSize) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "Output buffer too small");
+  }
+  if (!kRawPrimary) {
+    std::memcpy(out.data(), key_id_.data(), kPrefixSize);
+  }
+  auto encrypt_result = primary_->get_primitive().EncryptInto(
+      plaintext, associated_data, out.subspan(kPrefixSize));
   if (!encrypt_result.ok()) return encrypt_result.status();
-  const std::string& key_id = aead_set_->get_primary()->get_identifier();
-  return key_id + encrypt_result.ValueOrDie();
+  return kPrefixSize + encrypt_result.ValueOrDie();
+}
+
+template <bool kRawPrimary>
+util::Status AeadSetWrapper<kRawPrimary>::EncryptBatch(
+    absl::Span<const absl::string_view> plaintexts,
+    absl::string_view associated_data, absl::Span<const absl::Span<char>> outs,
+    absl::Span<size_t> ciphertext_sizes) const {
+  if (plaintexts.size() != outs.size() ||
+      plaintexts.size() != ciphertext_sizes.size()) {
+    return util::Status(
+        util::error::INVALID_ARGUMENT,
+        "plaintexts, outs and ciphertext_sizes must have the same length.");
+  }
+  associated_data = subtle::SubtleUtilBoringSSL::EnsureNonNull(associated_data);
+
+  absl::FixedArray<absl::Span<char>> inner_outs(outs.size());
+  for (size_t i = 0; i < outs.size(); i++) {
+    if (outs[i].size() < kPrefixSize) {
+      return util::Status(util::error::INVALID_ARGUMENT,
+                          "Output buffer too small");
+    }
+    if (!kRawPrimary) {
+      std::memcpy(outs[i].data(), key_id_.data(), kPrefixSize);
+    }
+    inner_outs[i] = outs[i].subspan(kPrefixSize);
+  }
+  util::Status status = primary_->get_primitive().EncryptBatch(
+      plaintexts, associated_data, inner_outs, ciphertext_sizes);
+  if (!status.ok()) return status;
+  for (size_t i = 0; i < ciphertext_sizes.size(); i++) {
+    ciphertext_sizes[i] += kPrefixSize;
+  }
+  return util::Status::OK;
 }
 
-util::StatusOr<std::string> AeadSetWrapper::Decrypt(
+template <bool kRawPrimary>
+util::StatusOr<std::string> AeadSetWrapper<kRawPrimary>::Decrypt(
     absl::string_view ciphertext, absl::string_view associated_data) const {
   // BoringSSL expects a non-null pointer for plaintext and additional_data,
   // regardless of whether the size is 0.
   associated_data = subtle::SubtleUtilBoringSSL::EnsureNonNull(associated_data);
 
+  // Until a key matches, failures are attributed to key id 0.
+  TINK_PROFILE_SCOPE(AeadDecrypt);
+  internal::MonitoredOp monitored_op("aead.decrypt", /* key_id = */ 0);
+
+  // Records the number of keys tried into the trial-decryption counters
+  // on every return path.
+  struct TrialDepthRecorder {
+    int attempts = 0;
+    ~TrialDepthRecorder() {
+      internal::RegistryMetrics::Global().RecordTrialDecrypt(attempts);
+    }
+  } trial_depth;
+
   if (ciphertext.length() > CryptoFormat::kNonRawPrefixSize) {
     absl::string_view key_id =
         ciphertext.substr(0, CryptoFormat::kNonRawPrefixSize);
-    auto primitives_result = aead_set_->get_primitives(key_id);
-    if (primitives_result.ok()) {
+    const auto* primitives = aead_set_->get_primitives_or_null(key_id);
+    if (primitives != nullptr) {
       absl::string_view raw_ciphertext =
           ciphertext.substr(CryptoFormat::kNonRawPrefixSize);
-      for (auto& aead_entry : *(primitives_result.ValueOrDie())) {
-        Aead& aead = aead_entry->get_primitive();
-        auto decrypt_result = aead.Decrypt(raw_ciphertext, associated_data);
+      for (auto& aead_entry : *primitives) {
+        auto aead_or = aead_entry->primitive_or_status();
+        // Skip entries whose lazy materialization failed; RAW keys below may
+        // still succeed.
+        if (!aead_or.ok()) continue;
+        Aead& aead = *aead_or.ValueOrDie();
+        trial_depth.attempts++;
+        auto decrypt_result = TrialDecrypt(aead, uniform_aes_gcm_,
+                                           raw_ciphertext, associated_data);
         if (decrypt_result.ok()) {
+          aead_entry->IncrementHitCount();
+          monitored_op.set_key_id(aead_entry->get_key_id());
           return std::move(decrypt_result.ValueOrDie());
         } else {
           // LOG that a matching key didn't decrypt the ciphertext.
@@ -98,17 +370,40 @@ util::StatusOr<std::string> AeadSetWrapper::Decrypt(
   }
 
   // No matching key succeeded with decryption, try all RAW keys.
-  auto raw_primitives_result = aead_set_->get_raw_primitives();
-  if (raw_primitives_result.ok()) {
-    for (auto& aead_entry : *(raw_primitives_result.ValueOrDie())) {
-      Aead& aead = aead_entry->get_primitive();
-      auto decrypt_result = aead.Decrypt(ciphertext, associated_data);
-      if (decrypt_result.ok()) {
-        return std::move(decrypt_result.ValueOrDie());
+  const auto* raw_primitives = aead_set_->get_raw_primitives_or_null();
+  if (raw_primitives != nullptr) {
+    if (raw_primitives->size() >= kParallelRawTrialThreshold) {
+      // Enough keys that sequential trials dominate tail latency; race
+      // them across a few workers instead. All keys are (potentially)
+      // tried concurrently, so they all count as attempts.
+      trial_depth.attempts += raw_primitives->size();
+      std::string plaintext;
+      const auto* winner =
+          TryRawKeysParallel(*raw_primitives, ciphertext, associated_data,
+                             uniform_aes_gcm_, &plaintext);
+      if (winner != nullptr) {
+        winner->IncrementHitCount();
+        monitored_op.set_key_id(winner->get_key_id());
+        return std::move(plaintext);
+      }
+    } else {
+      for (auto& aead_entry : *raw_primitives) {
+        auto aead_or = aead_entry->primitive_or_status();
+        if (!aead_or.ok()) continue;
+        Aead& aead = *aead_or.ValueOrDie();
+        trial_depth.attempts++;
+        auto decrypt_result =
+            TrialDecrypt(aead, uniform_aes_gcm_, ciphertext, associated_data);
+        if (decrypt_result.ok()) {
+          aead_entry->IncrementHitCount();
+          monitored_op.set_key_id(aead_entry->get_key_id());
+          return std::move(decrypt_result.ValueOrDie());
+        }
       }
     }
   }
-  return util::Status(util::error::INVALID_ARGUMENT, "decryption failed");
+  monitored_op.SetFailed();
+  return DecryptionFailedStatus();
 }
 
 }  // anonymous namespace
@@ -117,7 +412,17 @@ util::StatusOr<std::unique_ptr<Aead>> AeadWrapper::Wrap(
     std::unique_ptr<PrimitiveSet<Aead>> aead_set) const {
   util::Status status = Validate(aead_set.get());
   if (!status.ok()) return status;
-  std::unique_ptr<Aead> aead(new AeadSetWrapper(std::move(aead_set)));
+  // Sets built through PrimitiveSet::Builder arrive sealed already; this is
+  // a no-op then and covers callers which construct sets directly.
+  aead_set->Seal();
+  // Bind the prefix handling of the encrypt paths at wrap time; the
+  // primary's output prefix type cannot change afterwards.
+  std::unique_ptr<Aead> aead;
+  if (aead_set->get_primary()->get_identifier().empty()) {
+    aead.reset(new AeadSetWrapper<true>(std::move(aead_set)));
+  } else {
+    aead.reset(new AeadSetWrapper<false>(std::move(aead_set)));
+  }
   return std::move(aead);
 }
 
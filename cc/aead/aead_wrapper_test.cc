@@ -16,13 +16,21 @@
 
 #include "tink/aead/aead_wrapper.h"
 
+#include <string>
+#include <vector>
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
 #include "tink/aead.h"
+#include "tink/memory_footprint.h"
 #include "tink/primitive_set.h"
+#include "tink/subtle/aes_gcm_boringssl.h"
+#include "tink/util/secret_data.h"
 #include "tink/util/status.h"
 #include "tink/util/test_matchers.h"
 #include "tink/util/test_util.h"
+#include "tink/warmup.h"
 #include "proto/tink.pb.h"
 
 using ::crypto::tink::test::DummyAead;
@@ -119,6 +127,75 @@ TEST(AeadSetWrapperTest, Basic) {
                       decrypt_result.status().error_message());
 }
 
+TEST(AeadSetWrapperTest, EncryptFallsBackWhenOverheadExceedsDefaultBound) {
+  KeysetInfo keyset_info;
+  KeysetInfo::KeyInfo* key_info = keyset_info.add_key_info();
+  key_info->set_output_prefix_type(OutputPrefixType::TINK);
+  key_info->set_key_id(1234543);
+  key_info->set_status(KeyStatusType::ENABLED);
+
+  // DummyAead's ciphertext overhead grows with the length of its name, so a
+  // long name models a primitive which does not override MaxEncryptionSize()
+  // and whose real overhead exceeds the default bound (e.g. a KMS envelope
+  // AEAD storing a wrapped DEK in the ciphertext). The wrapper must then
+  // fall back to the allocating Encrypt() instead of failing.
+  std::string aead_name(2 * Aead::kMaxCiphertextOverhead, 'a');
+  std::unique_ptr<PrimitiveSet<Aead>> aead_set(new PrimitiveSet<Aead>());
+  auto entry_result = aead_set->AddPrimitive(
+      absl::make_unique<DummyAead>(aead_name), keyset_info.key_info(0));
+  ASSERT_TRUE(entry_result.ok());
+  ASSERT_THAT(aead_set->set_primary(entry_result.ValueOrDie()), IsOk());
+
+  AeadWrapper wrapper;
+  auto aead_result = wrapper.Wrap(std::move(aead_set));
+  ASSERT_TRUE(aead_result.ok()) << aead_result.status();
+  auto aead = std::move(aead_result.ValueOrDie());
+
+  std::string plaintext = "some_plaintext";
+  std::string aad = "some_aad";
+  auto encrypt_result = aead->Encrypt(plaintext, aad);
+  ASSERT_TRUE(encrypt_result.ok()) << encrypt_result.status();
+  auto decrypt_result = aead->Decrypt(encrypt_result.ValueOrDie(), aad);
+  ASSERT_TRUE(decrypt_result.ok()) << decrypt_result.status();
+  EXPECT_EQ(plaintext, decrypt_result.ValueOrDie());
+}
+
+TEST(AeadSetWrapperTest, RawPrimaryEncryptsWithoutPrefix) {
+  KeysetInfo keyset_info;
+  KeysetInfo::KeyInfo* key_info = keyset_info.add_key_info();
+  key_info->set_output_prefix_type(OutputPrefixType::RAW);
+  key_info->set_key_id(1234543);
+  key_info->set_status(KeyStatusType::ENABLED);
+
+  std::string aead_name = "raw_aead";
+  std::unique_ptr<PrimitiveSet<Aead>> aead_set(new PrimitiveSet<Aead>());
+  auto entry_result = aead_set->AddPrimitive(
+      absl::make_unique<DummyAead>(aead_name), keyset_info.key_info(0));
+  ASSERT_TRUE(entry_result.ok());
+  ASSERT_THAT(aead_set->set_primary(entry_result.ValueOrDie()), IsOk());
+
+  AeadWrapper wrapper;
+  auto aead_result = wrapper.Wrap(std::move(aead_set));
+  EXPECT_TRUE(aead_result.ok()) << aead_result.status();
+  std::unique_ptr<Aead> aead = std::move(aead_result.ValueOrDie());
+  std::string plaintext = "some_plaintext";
+  std::string aad = "some_aad";
+
+  // A RAW primary writes no output prefix: the wrapper's ciphertext is
+  // exactly the primitive's.
+  auto encrypt_result = aead->Encrypt(plaintext, aad);
+  EXPECT_TRUE(encrypt_result.ok()) << encrypt_result.status();
+  std::string ciphertext = encrypt_result.ValueOrDie();
+  EXPECT_EQ(DummyAead(aead_name).Encrypt(plaintext, aad).ValueOrDie(),
+            ciphertext);
+  EXPECT_EQ(aead->MaxEncryptionSize(plaintext.size()),
+            DummyAead(aead_name).MaxEncryptionSize(plaintext.size()));
+
+  auto decrypt_result = aead->Decrypt(ciphertext, aad);
+  EXPECT_TRUE(decrypt_result.ok()) << decrypt_result.status();
+  EXPECT_EQ(plaintext, decrypt_result.ValueOrDie());
+}
+
 TEST(AeadSetWrapperTest, DecryptNonPrimary) {
   KeysetInfo::KeyInfo* key_info;
   KeysetInfo keyset_info;
@@ -186,6 +263,181 @@ TEST(AeadSetWrapperTest, DecryptNonPrimary) {
   auto decrypt_result = aead->Decrypt(ciphertext, aad);
   EXPECT_TRUE(decrypt_result.ok()) << decrypt_result.status();
 }
+
+TEST(AeadSetWrapperTest, DecryptManyRawKeys) {
+  // Enough RAW keys to trigger the parallel trial-decryption path.
+  constexpr int kNumRawKeys = 12;
+  KeysetInfo keyset_info;
+  std::unique_ptr<PrimitiveSet<Aead>> aead_set(new PrimitiveSet<Aead>());
+  for (int i = 0; i < kNumRawKeys; i++) {
+    KeysetInfo::KeyInfo* key_info = keyset_info.add_key_info();
+    key_info->set_output_prefix_type(OutputPrefixType::RAW);
+    key_info->set_key_id(100 + i);
+    key_info->set_status(KeyStatusType::ENABLED);
+    std::unique_ptr<Aead> aead =
+        absl::make_unique<DummyAead>(absl::StrCat("aead", i));
+    auto entry_result =
+        aead_set->AddPrimitive(std::move(aead), keyset_info.key_info(i));
+    ASSERT_TRUE(entry_result.ok());
+    if (i == 0) {
+      ASSERT_THAT(aead_set->set_primary(entry_result.ValueOrDie()), IsOk());
+    }
+  }
+
+  std::string plaintext = "some_plaintext";
+  std::string aad = "some_aad";
+  // Each key's ciphertext must decrypt, no matter where in the set the
+  // matching key sits.
+  std::vector<std::string> ciphertexts;
+  for (int i = 0; i < kNumRawKeys; i++) {
+    DummyAead raw_aead(absl::StrCat("aead", i));
+    ciphertexts.push_back(raw_aead.Encrypt(plaintext, aad).ValueOrDie());
+  }
+
+  AeadWrapper wrapper;
+  auto aead_result = wrapper.Wrap(std::move(aead_set));
+  EXPECT_THAT(aead_result.status(), IsOk());
+  auto aead = std::move(aead_result.ValueOrDie());
+  for (const std::string& ciphertext : ciphertexts) {
+    auto decrypt_result = aead->Decrypt(ciphertext, aad);
+    EXPECT_TRUE(decrypt_result.ok()) << decrypt_result.status();
+    EXPECT_EQ(plaintext, decrypt_result.ValueOrDie());
+  }
+
+  auto decrypt_result = aead->Decrypt("no key matches this", aad);
+  EXPECT_FALSE(decrypt_result.ok());
+}
+
+TEST(AeadSetWrapperTest, UniformAesGcmKeyset) {
+  // A set whose entries are all materialized AesGcmBoringSsl primitives
+  // takes the devirtualized trial-decryption path; every key must still
+  // decrypt its own ciphertexts.
+  KeysetInfo keyset_info;
+  KeysetInfo::KeyInfo* key_info = keyset_info.add_key_info();
+  key_info->set_output_prefix_type(OutputPrefixType::TINK);
+  key_info->set_key_id(1234543);
+  key_info->set_status(KeyStatusType::ENABLED);
+  key_info = keyset_info.add_key_info();
+  key_info->set_output_prefix_type(OutputPrefixType::RAW);
+  key_info->set_key_id(726329);
+  key_info->set_status(KeyStatusType::ENABLED);
+
+  std::unique_ptr<PrimitiveSet<Aead>> aead_set(new PrimitiveSet<Aead>());
+  auto primary_aead = subtle::AesGcmBoringSsl::New(
+      util::SecretDataFromStringView(std::string(16, 'p')));
+  ASSERT_THAT(primary_aead.status(), IsOk());
+  auto entry_result = aead_set->AddPrimitive(
+      std::move(primary_aead.ValueOrDie()), keyset_info.key_info(0));
+  ASSERT_TRUE(entry_result.ok());
+  ASSERT_THAT(aead_set->set_primary(entry_result.ValueOrDie()), IsOk());
+
+  std::string raw_key(16, 'r');
+  auto raw_aead =
+      subtle::AesGcmBoringSsl::New(util::SecretDataFromStringView(raw_key));
+  ASSERT_THAT(raw_aead.status(), IsOk());
+  entry_result = aead_set->AddPrimitive(std::move(raw_aead.ValueOrDie()),
+                                        keyset_info.key_info(1));
+  ASSERT_TRUE(entry_result.ok());
+
+  std::string plaintext = "some_plaintext";
+  std::string aad = "some_aad";
+  AeadWrapper wrapper;
+  auto aead_result = wrapper.Wrap(std::move(aead_set));
+  EXPECT_THAT(aead_result.status(), IsOk());
+  auto aead = std::move(aead_result.ValueOrDie());
+
+  // Round trip through the primary.
+  auto encrypt_result = aead->Encrypt(plaintext, aad);
+  EXPECT_THAT(encrypt_result.status(), IsOk());
+  auto decrypt_result = aead->Decrypt(encrypt_result.ValueOrDie(), aad);
+  EXPECT_TRUE(decrypt_result.ok()) << decrypt_result.status();
+  EXPECT_EQ(plaintext, decrypt_result.ValueOrDie());
+
+  // A ciphertext from the RAW key is found via trial decryption.
+  auto same_raw_aead =
+      subtle::AesGcmBoringSsl::New(util::SecretDataFromStringView(raw_key));
+  ASSERT_THAT(same_raw_aead.status(), IsOk());
+  auto raw_ciphertext =
+      same_raw_aead.ValueOrDie()->Encrypt(plaintext, aad);
+  EXPECT_THAT(raw_ciphertext.status(), IsOk());
+  decrypt_result = aead->Decrypt(raw_ciphertext.ValueOrDie(), aad);
+  EXPECT_TRUE(decrypt_result.ok()) << decrypt_result.status();
+  EXPECT_EQ(plaintext, decrypt_result.ValueOrDie());
+}
+
+TEST(AeadSetWrapperTest, ReportsMemoryFootprint) {
+  KeysetInfo keyset_info;
+  KeysetInfo::KeyInfo* key_info = keyset_info.add_key_info();
+  key_info->set_output_prefix_type(OutputPrefixType::TINK);
+  key_info->set_key_id(1234543);
+  key_info->set_status(KeyStatusType::ENABLED);
+  std::unique_ptr<PrimitiveSet<Aead>> aead_set(new PrimitiveSet<Aead>());
+  auto entry_result = aead_set->AddPrimitive(
+      absl::make_unique<DummyAead>("aead0"), keyset_info.key_info(0));
+  ASSERT_TRUE(entry_result.ok());
+  ASSERT_THAT(aead_set->set_primary(entry_result.ValueOrDie()), IsOk());
+
+  AeadWrapper wrapper;
+  auto aead_result = wrapper.Wrap(std::move(aead_set));
+  ASSERT_THAT(aead_result.status(), IsOk());
+  auto aead = std::move(aead_result.ValueOrDie());
+
+  // The wrapped Aead supports footprint introspection via dynamic_cast and
+  // covers at least the set and its one entry.
+  auto* provider = dynamic_cast<const MemoryFootprintProvider*>(aead.get());
+  ASSERT_NE(provider, nullptr);
+  EXPECT_GE(provider->MemoryFootprint(),
+            sizeof(PrimitiveSet<Aead>) +
+                sizeof(PrimitiveSet<Aead>::Entry<Aead>));
+}
+
+TEST(AeadSetWrapperTest, WarmupMaterializesAllKeys) {
+  KeysetInfo keyset_info;
+  KeysetInfo::KeyInfo* key_info = keyset_info.add_key_info();
+  key_info->set_output_prefix_type(OutputPrefixType::TINK);
+  key_info->set_key_id(1234543);
+  key_info->set_status(KeyStatusType::ENABLED);
+  key_info = keyset_info.add_key_info();
+  key_info->set_output_prefix_type(OutputPrefixType::RAW);
+  key_info->set_key_id(726329);
+  key_info->set_status(KeyStatusType::ENABLED);
+
+  std::unique_ptr<PrimitiveSet<Aead>> aead_set(new PrimitiveSet<Aead>());
+  auto entry_result = aead_set->AddPrimitive(
+      absl::make_unique<DummyAead>("aead0"), keyset_info.key_info(0));
+  ASSERT_TRUE(entry_result.ok());
+  ASSERT_THAT(aead_set->set_primary(entry_result.ValueOrDie()), IsOk());
+  bool lazy_materialized = false;
+  auto lazy_result = aead_set->AddLazyPrimitive(
+      [&lazy_materialized]()
+          -> crypto::tink::util::StatusOr<std::unique_ptr<Aead>> {
+        lazy_materialized = true;
+        std::unique_ptr<Aead> aead = absl::make_unique<DummyAead>("aead1");
+        return std::move(aead);
+      },
+      keyset_info.key_info(1));
+  ASSERT_TRUE(lazy_result.ok());
+
+  AeadWrapper wrapper;
+  auto aead_result = wrapper.Wrap(std::move(aead_set));
+  ASSERT_THAT(aead_result.status(), IsOk());
+  auto aead = std::move(aead_result.ValueOrDie());
+
+  // The wrapped Aead supports warmup via dynamic_cast; warming runs a dummy
+  // operation with every key, which also materializes lazy entries.
+  auto* warmable = dynamic_cast<const Warmable*>(aead.get());
+  ASSERT_NE(warmable, nullptr);
+  EXPECT_FALSE(lazy_materialized);
+  EXPECT_THAT(warmable->Warmup(), IsOk());
+  EXPECT_TRUE(lazy_materialized);
+
+  // Real operations still work after warmup.
+  auto encrypt_result = aead->Encrypt("some_plaintext", "some_aad");
+  ASSERT_TRUE(encrypt_result.ok()) << encrypt_result.status();
+  auto decrypt_result = aead->Decrypt(encrypt_result.ValueOrDie(), "some_aad");
+  ASSERT_TRUE(decrypt_result.ok()) << decrypt_result.status();
+  EXPECT_EQ(decrypt_result.ValueOrDie(), "some_plaintext");
+}
 }  // namespace
 }  // namespace tink
 }  // namespace crypto
@@ -19,8 +19,11 @@
 #include <map>
 
 #include "absl/base/casts.h"
+#include "absl/memory/memory.h"
 #include "absl/strings/str_cat.h"
 #include "tink/aead.h"
+#include "tink/aead/cord_aead.h"
+#include "tink/aead/internal/cord_aead_from_aead.h"
 #include "tink/key_manager.h"
 #include "tink/mac.h"
 #include "tink/mac/hmac_key_manager.h"
@@ -29,6 +32,7 @@
 #include "tink/subtle/encrypt_then_authenticate.h"
 #include "tink/subtle/hmac_boringssl.h"
 #include "tink/subtle/random.h"
+#include "tink/subtle/stateful_hmac_boringssl.h"
 #include "tink/util/enums.h"
 #include "tink/util/errors.h"
 #include "tink/util/protobuf_helper.h"
@@ -81,17 +85,38 @@ StatusOr<AesCtrHmacAeadKey> AesCtrHmacAeadKeyManager::CreateKey(
 
 StatusOr<std::unique_ptr<Aead>> AesCtrHmacAeadKeyManager::AeadFactory::Create(
     const AesCtrHmacAeadKey& key) const {
+  return NewAead(key);
+}
+
+StatusOr<std::unique_ptr<CordAead>>
+AesCtrHmacAeadKeyManager::CordAeadFactory::Create(
+    const AesCtrHmacAeadKey& key) const {
+  auto aead = NewAead(key);
+  if (!aead.ok()) return aead.status();
+  return CordAeadFromAead::New(std::move(aead.ValueOrDie()));
+}
+
+// static
+StatusOr<std::unique_ptr<Aead>> AesCtrHmacAeadKeyManager::NewAead(
+    const AesCtrHmacAeadKey& key) {
   auto aes_ctr_result = subtle::AesCtrBoringSsl::New(
       util::SecretDataFromStringView(key.aes_ctr_key().key_value()),
       key.aes_ctr_key().params().iv_size());
   if (!aes_ctr_result.ok()) return aes_ctr_result.status();
 
-  auto hmac_result = HmacKeyManager().GetPrimitive<Mac>(key.hmac_key());
-  if (!hmac_result.ok()) return hmac_result.status();
+  auto stateful_hmac_factory =
+      absl::make_unique<subtle::StatefulHmacBoringSslFactory>(
+          Enums::ProtoToSubtle(key.hmac_key().params().hash()),
+          key.hmac_key().params().tag_size(),
+          util::SecretDataFromStringView(key.hmac_key().key_value()));
+  // The factory is otherwise only consulted per crypto operation, so validate
+  // the HMAC parameters once here to surface errors early.
+  auto stateful_hmac = stateful_hmac_factory->Create();
+  if (!stateful_hmac.ok()) return stateful_hmac.status();
 
   auto cipher_res = subtle::EncryptThenAuthenticate::New(
-      std::move(aes_ctr_result.ValueOrDie()),
-      std::move(hmac_result.ValueOrDie()), key.hmac_key().params().tag_size());
+      std::move(aes_ctr_result.ValueOrDie()), std::move(stateful_hmac_factory),
+      key.hmac_key().params().tag_size());
   if (!cipher_res.ok()) {
     return cipher_res.status();
   }
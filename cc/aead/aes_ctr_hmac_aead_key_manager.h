@@ -21,6 +21,7 @@
 #include "absl/memory/memory.h"
 #include "absl/strings/str_cat.h"
 #include "tink/aead.h"
+#include "tink/aead/cord_aead.h"
 #include "tink/core/key_type_manager.h"
 #include "tink/key_manager.h"
 #include "tink/util/constants.h"
@@ -37,15 +38,20 @@ namespace tink {
 class AesCtrHmacAeadKeyManager
     : public KeyTypeManager<google::crypto::tink::AesCtrHmacAeadKey,
                             google::crypto::tink::AesCtrHmacAeadKeyFormat,
-                            List<Aead>> {
+                            List<Aead, CordAead>> {
  public:
   class AeadFactory : public PrimitiveFactory<Aead> {
     crypto::tink::util::StatusOr<std::unique_ptr<Aead>> Create(
         const google::crypto::tink::AesCtrHmacAeadKey& key) const override;
   };
+  class CordAeadFactory : public PrimitiveFactory<CordAead> {
+    crypto::tink::util::StatusOr<std::unique_ptr<CordAead>> Create(
+        const google::crypto::tink::AesCtrHmacAeadKey& key) const override;
+  };
 
   AesCtrHmacAeadKeyManager()
-      : KeyTypeManager(absl::make_unique<AeadFactory>()) {}
+      : KeyTypeManager(absl::make_unique<AeadFactory>(),
+                       absl::make_unique<CordAeadFactory>()) {}
 
   uint32_t get_version() const override { return 0; }
 
@@ -70,6 +76,10 @@ class AesCtrHmacAeadKeyManager
   }
 
  private:
+  // Creates the underlying Aead; shared by AeadFactory and CordAeadFactory.
+  static crypto::tink::util::StatusOr<std::unique_ptr<Aead>> NewAead(
+      const google::crypto::tink::AesCtrHmacAeadKey& key);
+
   const std::string key_type_ =
       absl::StrCat(kTypeGoogleapisCom,
                    google::crypto::tink::AesCtrHmacAeadKey().GetTypeName());
@@ -18,6 +18,8 @@
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "tink/aead/cord_aead.h"
+#include "tink/aead/internal/cord_aead_from_aead.h"
 #include "tink/config.h"
 #include "tink/mac/mac_config.h"
 #include "tink/subtle/aead_test_util.h"
@@ -214,6 +216,26 @@ TEST(AesCtrHmacAeadKeyManagerTest, CreateAead) {
               IsOk());
 }
 
+TEST(AesCtrHmacAeadKeyManagerTest, CreateCordAead) {
+  AesCtrHmacAeadKey key = CreateValidKey();
+
+  StatusOr<std::unique_ptr<CordAead>> cord_aead_or =
+      AesCtrHmacAeadKeyManager().GetPrimitive<CordAead>(key);
+  ASSERT_THAT(cord_aead_or.status(), IsOk());
+
+  StatusOr<std::unique_ptr<Aead>> aead_or =
+      AesCtrHmacAeadKeyManager().GetPrimitive<Aead>(key);
+  ASSERT_THAT(aead_or.status(), IsOk());
+  StatusOr<std::unique_ptr<CordAead>> direct_cord_aead_or =
+      CordAeadFromAead::New(std::move(aead_or.ValueOrDie()));
+  ASSERT_THAT(direct_cord_aead_or.status(), IsOk());
+
+  EXPECT_THAT(EncryptThenDecrypt(*cord_aead_or.ValueOrDie(),
+                                 *direct_cord_aead_or.ValueOrDie(),
+                                 "message", "aad"),
+              IsOk());
+}
+
 }  // namespace
 }  // namespace tink
 }  // namespace crypto
@@ -21,8 +21,12 @@
 #include "absl/memory/memory.h"
 #include "absl/strings/str_cat.h"
 #include "tink/aead.h"
+#include "tink/aead/cord_aead.h"
+#include "tink/aead/internal/cord_aead_from_aead.h"
 #include "tink/core/key_type_manager.h"
+#include "tink/subtle/aes_eax_aesni.h"
 #include "tink/subtle/aes_eax_boringssl.h"
+#include "tink/subtle/cpu_features.h"
 #include "tink/subtle/random.h"
 #include "tink/util/constants.h"
 #include "tink/util/errors.h"
@@ -38,18 +42,27 @@ namespace tink {
 
 class AesEaxKeyManager
     : public KeyTypeManager<google::crypto::tink::AesEaxKey,
-                            google::crypto::tink::AesEaxKeyFormat, List<Aead>> {
+                            google::crypto::tink::AesEaxKeyFormat,
+                            List<Aead, CordAead>> {
  public:
   class AeadFactory : public PrimitiveFactory<Aead> {
     crypto::tink::util::StatusOr<std::unique_ptr<Aead>> Create(
         const google::crypto::tink::AesEaxKey& key) const override {
-      return subtle::AesEaxBoringSsl::New(
-          util::SecretDataFromStringView(key.key_value()),
-          key.params().iv_size());
+      return NewAead(key);
+    }
+  };
+  class CordAeadFactory : public PrimitiveFactory<CordAead> {
+    crypto::tink::util::StatusOr<std::unique_ptr<CordAead>> Create(
+        const google::crypto::tink::AesEaxKey& key) const override {
+      auto aead = NewAead(key);
+      if (!aead.ok()) return aead.status();
+      return CordAeadFromAead::New(std::move(aead.ValueOrDie()));
     }
   };
 
-  AesEaxKeyManager() : KeyTypeManager(absl::make_unique<AeadFactory>()) {}
+  AesEaxKeyManager()
+      : KeyTypeManager(absl::make_unique<AeadFactory>(),
+                       absl::make_unique<CordAeadFactory>()) {}
 
   uint32_t get_version() const override { return 0; }
 
@@ -89,6 +102,25 @@ class AesEaxKeyManager
   }
 
  private:
+  // Creates the underlying Aead; shared by AeadFactory and CordAeadFactory.
+  static crypto::tink::util::StatusOr<std::unique_ptr<Aead>> NewAead(
+      const google::crypto::tink::AesEaxKey& key) {
+#if defined(__SSE4_1__) && defined(__AES__)
+    // Prefer the AES-NI based implementation, but only if the machine
+    // running the binary actually supports the required instructions; a
+    // binary built with -maes can end up on older machines of a
+    // heterogeneous fleet.
+    if (subtle::CpuFeatures::HasAesni()) {
+      return subtle::AesEaxAesni::New(
+          util::SecretDataFromStringView(key.key_value()),
+          key.params().iv_size());
+    }
+#endif
+    return subtle::AesEaxBoringSsl::New(
+        util::SecretDataFromStringView(key.key_value()),
+        key.params().iv_size());
+  }
+
   crypto::tink::util::Status ValidateKeySize(uint32_t key_size) const {
     if (key_size != 16 && key_size != 32) {
       return crypto::tink::util::Status(
@@ -19,6 +19,8 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "tink/aead.h"
+#include "tink/aead/cord_aead.h"
+#include "tink/aead/internal/cord_aead_from_aead.h"
 #include "tink/subtle/aead_test_util.h"
 #include "tink/util/secret_data.h"
 #include "tink/util/status.h"
@@ -192,6 +194,33 @@ TEST(AesGcmKeyManagerTest, CreateAead) {
               IsOk());
 }
 
+TEST(AesEaxKeyManagerTest, CreateCordAead) {
+  AesEaxKeyFormat format;
+  format.set_key_size(32);
+  format.mutable_params()->set_iv_size(16);
+  StatusOr<AesEaxKey> key_or = AesEaxKeyManager().CreateKey(format);
+  ASSERT_THAT(key_or.status(), IsOk());
+
+  StatusOr<std::unique_ptr<CordAead>> aead_or =
+      AesEaxKeyManager().GetPrimitive<CordAead>(key_or.ValueOrDie());
+
+  ASSERT_THAT(aead_or.status(), IsOk());
+
+  StatusOr<std::unique_ptr<Aead>> boring_ssl_aead_or =
+      subtle::AesEaxBoringSsl::New(
+          util::SecretDataFromStringView(key_or.ValueOrDie().key_value()),
+          key_or.ValueOrDie().params().iv_size());
+  ASSERT_THAT(boring_ssl_aead_or.status(), IsOk());
+  StatusOr<std::unique_ptr<CordAead>> direct_cord_aead_or =
+      CordAeadFromAead::New(std::move(boring_ssl_aead_or.ValueOrDie()));
+  ASSERT_THAT(direct_cord_aead_or.status(), IsOk());
+
+  ASSERT_THAT(EncryptThenDecrypt(*aead_or.ValueOrDie(),
+                                 *direct_cord_aead_or.ValueOrDie(),
+                                 "message", "aad"),
+              IsOk());
+}
+
 }  // namespace
 }  // namespace tink
 }  // namespace crypto
@@ -26,7 +26,7 @@
 #include "tink/aead/internal/cord_aes_gcm_boringssl.h"
 #include "tink/core/key_type_manager.h"
 #include "tink/key_manager.h"
-#include "tink/subtle/aes_gcm_boringssl.h"
+#include "tink/subtle/crypto_provider_registry.h"
 #include "tink/subtle/random.h"
 #include "tink/util/constants.h"
 #include "tink/util/errors.h"
@@ -50,8 +50,12 @@ class AesGcmKeyManager
   class AeadFactory : public PrimitiveFactory<Aead> {
     crypto::tink::util::StatusOr<std::unique_ptr<Aead>> Create(
         const google::crypto::tink::AesGcmKey& key) const override {
-      auto aes_gcm_result = subtle::AesGcmBoringSsl::New(
-          util::SecretDataFromStringView(key.key_value()));
+      // The registry contains only the BoringSSL provider unless offload
+      // engines have been registered, in which case operations are routed
+      // by payload size; see CryptoProviderRegistry.
+      auto aes_gcm_result =
+          subtle::CryptoProviderRegistry::GlobalInstance().NewAesGcmAead(
+              util::SecretDataFromStringView(key.key_value()));
       if (!aes_gcm_result.ok()) return aes_gcm_result.status();
       return {std::move(aes_gcm_result.ValueOrDie())};
     }
@@ -0,0 +1,77 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/aead/async_aead_from_aead.h"
+
+#include <utility>
+
+#include "tink/util/status.h"
+
+namespace crypto {
+namespace tink {
+
+using crypto::tink::util::StatusOr;
+
+// static
+StatusOr<std::unique_ptr<AsyncAead>> AsyncAeadFromAead::New(
+    std::unique_ptr<Aead> aead, Executor executor) {
+  if (aead == nullptr) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "aead must be non-null");
+  }
+  std::unique_ptr<AsyncAead> async_aead(
+      new AsyncAeadFromAead(std::move(aead), std::move(executor)));
+  return std::move(async_aead);
+}
+
+std::future<StatusOr<std::string>> AsyncAeadFromAead::Run(
+    std::function<StatusOr<std::string>()> operation) const {
+  if (executor_ == nullptr) {
+    std::promise<StatusOr<std::string>> promise;
+    promise.set_value(operation());
+    return promise.get_future();
+  }
+  // The promise is shared with the executor's queue, so the future stays
+  // valid even if it outlives this call.
+  auto promise = std::make_shared<std::promise<StatusOr<std::string>>>();
+  std::future<StatusOr<std::string>> future = promise->get_future();
+  executor_([promise, operation]() { promise->set_value(operation()); });
+  return future;
+}
+
+std::future<StatusOr<std::string>> AsyncAeadFromAead::EncryptAsync(
+    absl::string_view plaintext, absl::string_view associated_data) const {
+  // Copy the arguments: the operation may run after this call returned.
+  std::string plaintext_copy(plaintext);
+  std::string associated_data_copy(associated_data);
+  const Aead* aead = aead_.get();
+  return Run([aead, plaintext_copy, associated_data_copy]() {
+    return aead->Encrypt(plaintext_copy, associated_data_copy);
+  });
+}
+
+std::future<StatusOr<std::string>> AsyncAeadFromAead::DecryptAsync(
+    absl::string_view ciphertext, absl::string_view associated_data) const {
+  std::string ciphertext_copy(ciphertext);
+  std::string associated_data_copy(associated_data);
+  const Aead* aead = aead_.get();
+  return Run([aead, ciphertext_copy, associated_data_copy]() {
+    return aead->Decrypt(ciphertext_copy, associated_data_copy);
+  });
+}
+
+}  // namespace tink
+}  // namespace crypto
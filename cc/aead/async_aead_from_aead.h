@@ -0,0 +1,77 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_AEAD_ASYNC_AEAD_FROM_AEAD_H_
+#define TINK_AEAD_ASYNC_AEAD_FROM_AEAD_H_
+
+#include <functional>
+#include <future>  // NOLINT(build/c++11)
+#include <memory>
+#include <string>
+
+#include "absl/strings/string_view.h"
+#include "tink/aead.h"
+#include "tink/async_aead.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+
+// An AsyncAead that wraps a synchronous Aead.
+//
+// Without an executor each operation runs inline in the calling thread and
+// the returned future is already ready -- the right choice for CPU-bound
+// Aeads, where the operation is cheaper than a thread handoff.
+//
+// With an executor the operation is submitted to it and the future becomes
+// ready once the executor has run it. This is how I/O-bound Aeads such as
+// KmsEnvelopeAead are used without pinning a caller thread per KMS round
+// trip: pass a hook into the server's thread pool or fiber scheduler. The
+// executor must eventually run every submitted function exactly once.
+class AsyncAeadFromAead : public AsyncAead {
+ public:
+  using Executor = std::function<void(std::function<void()>)>;
+
+  // 'aead' must be non-null; a null 'executor' selects inline execution.
+  static crypto::tink::util::StatusOr<std::unique_ptr<AsyncAead>> New(
+      std::unique_ptr<Aead> aead, Executor executor = nullptr);
+
+  std::future<crypto::tink::util::StatusOr<std::string>> EncryptAsync(
+      absl::string_view plaintext,
+      absl::string_view associated_data) const override;
+
+  std::future<crypto::tink::util::StatusOr<std::string>> DecryptAsync(
+      absl::string_view ciphertext,
+      absl::string_view associated_data) const override;
+
+ private:
+  AsyncAeadFromAead(std::unique_ptr<Aead> aead, Executor executor)
+      : aead_(std::move(aead)), executor_(std::move(executor)) {}
+
+  // Runs 'operation' inline or on executor_, fulfilling the returned future
+  // with its result.
+  std::future<crypto::tink::util::StatusOr<std::string>> Run(
+      std::function<crypto::tink::util::StatusOr<std::string>()> operation)
+      const;
+
+  const std::unique_ptr<Aead> aead_;
+  const Executor executor_;
+};
+
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_AEAD_ASYNC_AEAD_FROM_AEAD_H_
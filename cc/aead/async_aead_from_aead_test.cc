@@ -0,0 +1,127 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/aead/async_aead_from_aead.h"
+
+#include <chrono>  // NOLINT(build/c++11)
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+#include "tink/util/test_matchers.h"
+#include "tink/util/test_util.h"
+
+namespace crypto {
+namespace tink {
+namespace {
+
+using ::crypto::tink::test::DummyAead;
+using ::crypto::tink::test::IsOk;
+using ::crypto::tink::test::StatusIs;
+
+TEST(AsyncAeadFromAeadTest, InlineEncryptDecrypt) {
+  auto async_aead_or =
+      AsyncAeadFromAead::New(absl::make_unique<DummyAead>("async aead"));
+  ASSERT_THAT(async_aead_or.status(), IsOk());
+  auto async_aead = std::move(async_aead_or.ValueOrDie());
+
+  auto ciphertext_future = async_aead->EncryptAsync("some plaintext", "aad");
+  // Without an executor the operation runs inline and the future is ready.
+  ASSERT_EQ(std::future_status::ready,
+            ciphertext_future.wait_for(std::chrono::seconds(0)));
+  auto ciphertext_or = ciphertext_future.get();
+  ASSERT_THAT(ciphertext_or.status(), IsOk());
+
+  auto plaintext_future =
+      async_aead->DecryptAsync(ciphertext_or.ValueOrDie(), "aad");
+  ASSERT_EQ(std::future_status::ready,
+            plaintext_future.wait_for(std::chrono::seconds(0)));
+  auto plaintext_or = plaintext_future.get();
+  ASSERT_THAT(plaintext_or.status(), IsOk());
+  EXPECT_EQ("some plaintext", plaintext_or.ValueOrDie());
+}
+
+TEST(AsyncAeadFromAeadTest, InlineDecryptFailurePropagates) {
+  auto async_aead_or =
+      AsyncAeadFromAead::New(absl::make_unique<DummyAead>("async aead"));
+  ASSERT_THAT(async_aead_or.status(), IsOk());
+  auto async_aead = std::move(async_aead_or.ValueOrDie());
+
+  auto plaintext_or = async_aead->DecryptAsync("bad ciphertext", "aad").get();
+  EXPECT_FALSE(plaintext_or.ok());
+}
+
+TEST(AsyncAeadFromAeadTest, ExecutorRunsOperations) {
+  // An executor that queues the submitted functions for a later, manual run.
+  std::vector<std::function<void()>> queue;
+  auto async_aead_or = AsyncAeadFromAead::New(
+      absl::make_unique<DummyAead>("async aead"),
+      [&queue](std::function<void()> fn) { queue.push_back(std::move(fn)); });
+  ASSERT_THAT(async_aead_or.status(), IsOk());
+  auto async_aead = std::move(async_aead_or.ValueOrDie());
+
+  auto ciphertext_future = async_aead->EncryptAsync("some plaintext", "aad");
+  // The operation has been submitted, but not run yet.
+  ASSERT_EQ(1, queue.size());
+  EXPECT_EQ(std::future_status::timeout,
+            ciphertext_future.wait_for(std::chrono::seconds(0)));
+
+  queue[0]();
+  ASSERT_EQ(std::future_status::ready,
+            ciphertext_future.wait_for(std::chrono::seconds(0)));
+  auto ciphertext_or = ciphertext_future.get();
+  ASSERT_THAT(ciphertext_or.status(), IsOk());
+
+  auto plaintext_future =
+      async_aead->DecryptAsync(ciphertext_or.ValueOrDie(), "aad");
+  ASSERT_EQ(2, queue.size());
+  queue[1]();
+  auto plaintext_or = plaintext_future.get();
+  ASSERT_THAT(plaintext_or.status(), IsOk());
+  EXPECT_EQ("some plaintext", plaintext_or.ValueOrDie());
+}
+
+TEST(AsyncAeadFromAeadTest, ArgumentsNeedNotOutliveCall) {
+  std::vector<std::function<void()>> queue;
+  auto async_aead_or = AsyncAeadFromAead::New(
+      absl::make_unique<DummyAead>("async aead"),
+      [&queue](std::function<void()> fn) { queue.push_back(std::move(fn)); });
+  ASSERT_THAT(async_aead_or.status(), IsOk());
+  auto async_aead = std::move(async_aead_or.ValueOrDie());
+
+  std::future<util::StatusOr<std::string>> ciphertext_future;
+  {
+    std::string plaintext = "some plaintext";
+    std::string aad = "aad";
+    ciphertext_future = async_aead->EncryptAsync(plaintext, aad);
+  }  // The arguments are destroyed before the operation runs.
+  queue[0]();
+  EXPECT_THAT(ciphertext_future.get().status(), IsOk());
+}
+
+TEST(AsyncAeadFromAeadTest, NullAeadRejected) {
+  auto async_aead_or = AsyncAeadFromAead::New(nullptr);
+  EXPECT_THAT(async_aead_or.status(),
+              StatusIs(util::error::INVALID_ARGUMENT));
+}
+
+}  // namespace
+}  // namespace tink
+}  // namespace crypto
@@ -77,7 +77,11 @@ util::StatusOr<absl::Cord> CordAeadSetWrapper::Decrypt(
       auto raw_ciphertext =
           ciphertext.Subcord(key_id.size(), ciphertext.size());
       for (auto& aead_entry : *(primitives_result.ValueOrDie())) {
-        CordAead& aead = aead_entry->get_primitive();
+        auto aead_or = aead_entry->primitive_or_status();
+        // Skip entries whose lazy materialization failed; RAW keys below may
+        // still succeed.
+        if (!aead_or.ok()) continue;
+        CordAead& aead = *aead_or.ValueOrDie();
         auto decrypt_result = aead.Decrypt(raw_ciphertext, associated_data);
         if (decrypt_result.ok()) {
           return std::move(decrypt_result.ValueOrDie());
@@ -92,7 +96,9 @@ util::StatusOr<absl::Cord> CordAeadSetWrapper::Decrypt(
   auto raw_primitives_result = aead_set_->get_raw_primitives();
   if (raw_primitives_result.ok()) {
     for (auto& aead_entry : *(raw_primitives_result.ValueOrDie())) {
-      CordAead& aead = aead_entry->get_primitive();
+      auto aead_or = aead_entry->primitive_or_status();
+      if (!aead_or.ok()) continue;
+      CordAead& aead = *aead_or.ValueOrDie();
       auto decrypt_result = aead.Decrypt(ciphertext, associated_data);
       if (decrypt_result.ok()) {
         return std::move(decrypt_result.ValueOrDie());
@@ -107,6 +113,7 @@ util::StatusOr<std::unique_ptr<CordAead>> CordAeadWrapper::Wrap(
     std::unique_ptr<PrimitiveSet<CordAead>> aead_set) const {
   util::Status status = Validate(aead_set.get());
   if (!status.ok()) return status;
+  aead_set->Seal();
   std::unique_ptr<CordAead> aead(new CordAeadSetWrapper(std::move(aead_set)));
   return std::move(aead);
 }
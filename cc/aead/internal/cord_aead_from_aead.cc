@@ -0,0 +1,83 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/aead/internal/cord_aead_from_aead.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/strings/cord.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "tink/aead.h"
+#include "tink/aead/cord_aead.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+
+util::StatusOr<std::unique_ptr<CordAead>> CordAeadFromAead::New(
+    std::unique_ptr<Aead> aead) {
+  if (aead == nullptr) {
+    return util::Status(util::error::INVALID_ARGUMENT, "aead must be non-null");
+  }
+  std::unique_ptr<CordAead> result(new CordAeadFromAead(std::move(aead)));
+  return util::StatusOr<std::unique_ptr<CordAead>>(std::move(result));
+}
+
+util::StatusOr<absl::Cord> CordAeadFromAead::Encrypt(
+    absl::Cord plaintext, absl::Cord additional_data) const {
+  // Flatten() copies only if the Cord consists of more than one chunk.
+  absl::string_view plaintext_flat = plaintext.Flatten();
+  absl::string_view additional_data_flat = additional_data.Flatten();
+
+  size_t buffer_size = aead_->MaxEncryptionSize(plaintext_flat.size());
+  char* buffer = std::allocator<char>().allocate(buffer_size);
+  auto written = aead_->EncryptInto(plaintext_flat, additional_data_flat,
+                                    absl::MakeSpan(buffer, buffer_size));
+  if (!written.ok()) {
+    std::allocator<char>().deallocate(buffer, buffer_size);
+    return written.status();
+  }
+  // The ciphertext may be shorter than MaxEncryptionSize(); the releaser
+  // must still free the full allocation.
+  return absl::MakeCordFromExternal(
+      absl::string_view(buffer, written.ValueOrDie()),
+      [buffer, buffer_size](absl::string_view) {
+        std::allocator<char>().deallocate(buffer, buffer_size);
+      });
+}
+
+util::StatusOr<absl::Cord> CordAeadFromAead::Decrypt(
+    absl::Cord ciphertext, absl::Cord additional_data) const {
+  absl::string_view ciphertext_flat = ciphertext.Flatten();
+  absl::string_view additional_data_flat = additional_data.Flatten();
+
+  auto plaintext = aead_->Decrypt(ciphertext_flat, additional_data_flat);
+  if (!plaintext.ok()) {
+    return plaintext.status();
+  }
+  // Hand the plaintext string over to the Cord without copying it.
+  auto* plaintext_holder = new std::string(std::move(plaintext.ValueOrDie()));
+  return absl::MakeCordFromExternal(
+      *plaintext_holder,
+      [plaintext_holder](absl::string_view) { delete plaintext_holder; });
+}
+
+}  // namespace tink
+}  // namespace crypto
@@ -0,0 +1,62 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_AEAD_INTERNAL_CORD_AEAD_FROM_AEAD_H_
+#define TINK_AEAD_INTERNAL_CORD_AEAD_FROM_AEAD_H_
+
+#include <memory>
+
+#include "absl/strings/cord.h"
+#include "tink/aead.h"
+#include "tink/aead/cord_aead.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+
+// CordAeadFromAead adapts an Aead working on contiguous buffers (e.g.
+// XChaCha20-Poly1305, AES-EAX or AES-CTR-HMAC) to the CordAead interface.
+// Unlike CordAesGcmBoringSsl it cannot stream individual Cord chunks through
+// the cipher; instead it flattens the input once (a no-op for Cords that
+// already consist of a single chunk) and writes the ciphertext directly into
+// the buffer backing the returned Cord via Aead::EncryptInto, so no further
+// copies are made. The returned Cord is a single flat chunk and thus leaks
+// no information about the Cord-structure of the plaintext.
+class CordAeadFromAead : public CordAead {
+ public:
+  static crypto::tink::util::StatusOr<std::unique_ptr<CordAead>> New(
+      std::unique_ptr<Aead> aead);
+
+  crypto::tink::util::StatusOr<absl::Cord> Encrypt(
+      absl::Cord plaintext, absl::Cord additional_data) const override;
+
+  crypto::tink::util::StatusOr<absl::Cord> Decrypt(
+      absl::Cord ciphertext, absl::Cord additional_data) const override;
+
+  ~CordAeadFromAead() override {}
+
+ private:
+  explicit CordAeadFromAead(std::unique_ptr<Aead> aead)
+      : aead_(std::move(aead)) {}
+
+  const std::unique_ptr<Aead> aead_;
+};
+
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_AEAD_INTERNAL_CORD_AEAD_FROM_AEAD_H_
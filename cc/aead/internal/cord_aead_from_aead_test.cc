@@ -0,0 +1,134 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tink/aead/internal/cord_aead_from_aead.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/strings/cord_test_helpers.h"
+#include "absl/strings/str_split.h"
+#include "tink/subtle/xchacha20_poly1305_boringssl.h"
+#include "tink/util/secret_data.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+#include "tink/util/test_matchers.h"
+#include "tink/util/test_util.h"
+
+namespace crypto {
+namespace tink {
+
+using ::crypto::tink::test::IsOk;
+using ::crypto::tink::test::StatusIs;
+
+namespace {
+
+std::unique_ptr<CordAead> GetCordAead() {
+  util::SecretData key = util::SecretDataFromStringView(test::HexDecodeOrDie(
+      "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"));
+  auto aead = subtle::XChacha20Poly1305BoringSsl::New(key);
+  EXPECT_TRUE(aead.ok()) << aead.status();
+  auto cord_aead = CordAeadFromAead::New(std::move(aead.ValueOrDie()));
+  EXPECT_TRUE(cord_aead.ok()) << cord_aead.status();
+  return std::move(cord_aead.ValueOrDie());
+}
+
+TEST(CordAeadFromAeadTest, EncryptDecryptCord) {
+  auto cipher = GetCordAead();
+  const std::string message = "Some data to encrypt.";
+  const std::string aad = "Some data to authenticate.";
+
+  absl::Cord message_cord = absl::Cord(message);
+  absl::Cord aad_cord = absl::Cord(aad);
+
+  auto ct = cipher->Encrypt(message_cord, aad_cord);
+  ASSERT_THAT(ct.status(), IsOk());
+  // XChaCha20-Poly1305: 24 byte nonce and 16 byte tag.
+  EXPECT_EQ(ct.ValueOrDie().size(), message_cord.size() + 24 + 16);
+
+  auto pt = cipher->Decrypt(ct.ValueOrDie(), aad_cord);
+  ASSERT_THAT(pt.status(), IsOk());
+  EXPECT_EQ(pt.ValueOrDie(), message_cord.Flatten());
+}
+
+TEST(CordAeadFromAeadTest, ChunkyCordEncrypt) {
+  auto cipher = GetCordAead();
+  std::string message = "This is some long message which will be fragmented.";
+  const std::string aad = "Some data to authenticate.";
+
+  absl::Cord message_cord =
+      absl::MakeFragmentedCord(absl::StrSplit(message, absl::ByLength(3)));
+  absl::Cord aad_cord =
+      absl::MakeFragmentedCord(absl::StrSplit(aad, absl::ByLength(4)));
+
+  auto ct = cipher->Encrypt(message_cord, aad_cord);
+  ASSERT_THAT(ct.status(), IsOk());
+
+  auto pt = cipher->Decrypt(ct.ValueOrDie(), absl::Cord(aad));
+  ASSERT_THAT(pt.status(), IsOk());
+  EXPECT_EQ(pt.ValueOrDie(), message);
+}
+
+TEST(CordAeadFromAeadTest, CompatibleWithWrappedAead) {
+  util::SecretData key = util::SecretDataFromStringView(test::HexDecodeOrDie(
+      "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"));
+  auto aead = subtle::XChacha20Poly1305BoringSsl::New(key);
+  ASSERT_THAT(aead.status(), IsOk());
+  auto aead2 = subtle::XChacha20Poly1305BoringSsl::New(key);
+  ASSERT_THAT(aead2.status(), IsOk());
+  auto cipher = CordAeadFromAead::New(std::move(aead.ValueOrDie()));
+  ASSERT_THAT(cipher.status(), IsOk());
+
+  const std::string message = "Some data to encrypt.";
+  const std::string aad = "Some data to authenticate.";
+
+  // Ciphertexts produced through the Cord interface decrypt with the plain
+  // Aead and vice versa.
+  auto ct = cipher.ValueOrDie()->Encrypt(absl::Cord(message), absl::Cord(aad));
+  ASSERT_THAT(ct.status(), IsOk());
+  auto pt = aead2.ValueOrDie()->Decrypt(std::string(ct.ValueOrDie()), aad);
+  ASSERT_THAT(pt.status(), IsOk());
+  EXPECT_EQ(pt.ValueOrDie(), message);
+
+  auto ct2 = aead2.ValueOrDie()->Encrypt(message, aad);
+  ASSERT_THAT(ct2.status(), IsOk());
+  auto pt2 = cipher.ValueOrDie()->Decrypt(absl::Cord(ct2.ValueOrDie()),
+                                          absl::Cord(aad));
+  ASSERT_THAT(pt2.status(), IsOk());
+  EXPECT_EQ(pt2.ValueOrDie(), message);
+}
+
+TEST(CordAeadFromAeadTest, WrongAadRejected) {
+  auto cipher = GetCordAead();
+  auto ct = cipher->Encrypt(absl::Cord("message"), absl::Cord("aad"));
+  ASSERT_THAT(ct.status(), IsOk());
+
+  auto pt = cipher->Decrypt(ct.ValueOrDie(), absl::Cord("wrong aad"));
+  EXPECT_FALSE(pt.ok());
+}
+
+TEST(CordAeadFromAeadTest, NullAeadRejected) {
+  auto cipher = CordAeadFromAead::New(nullptr);
+  EXPECT_THAT(cipher.status(),
+              StatusIs(util::error::INVALID_ARGUMENT));
+}
+
+}  // namespace
+}  // namespace tink
+}  // namespace crypto
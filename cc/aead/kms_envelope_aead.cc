@@ -16,11 +16,17 @@
 
 #include "tink/aead/kms_envelope_aead.h"
 
+#include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "absl/base/internal/endian.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/types/span.h"
 #include "tink/aead.h"
 #include "tink/registry.h"
 #include "tink/util/errors.h"
@@ -53,22 +59,42 @@ std::string GetEnvelopeCiphertext(absl::string_view encrypted_dek,
 }  // namespace
 
 // static
-util::StatusOr<std::unique_ptr<Aead>> KmsEnvelopeAead::New(
+util::StatusOr<std::unique_ptr<KmsEnvelopeAead>> KmsEnvelopeAead::New(
     const google::crypto::tink::KeyTemplate& dek_template,
     std::unique_ptr<Aead> remote_aead) {
+  return New(dek_template, std::move(remote_aead), CachingOptions());
+}
+
+// static
+util::StatusOr<std::unique_ptr<KmsEnvelopeAead>> KmsEnvelopeAead::New(
+    const google::crypto::tink::KeyTemplate& dek_template,
+    std::unique_ptr<Aead> remote_aead, const CachingOptions& options) {
   if (remote_aead == nullptr) {
     return util::Status(util::error::INVALID_ARGUMENT,
                         "remote_aead must be non-null");
   }
   auto km_result = Registry::get_key_manager<Aead>(dek_template.type_url());
   if (!km_result.ok()) return km_result.status();
-  std::unique_ptr<Aead> envelope_aead(
-      new KmsEnvelopeAead(dek_template, std::move(remote_aead)));
+  std::unique_ptr<KmsEnvelopeAead> envelope_aead(
+      new KmsEnvelopeAead(dek_template, std::move(remote_aead), options));
   return std::move(envelope_aead);
 }
 
-util::StatusOr<std::string> KmsEnvelopeAead::Encrypt(
-    absl::string_view plaintext, absl::string_view associated_data) const {
+util::StatusOr<std::shared_ptr<Aead>> KmsEnvelopeAead::GetEncryptionDek(
+    int message_count, std::string* encrypted_dek) const {
+  std::shared_ptr<Aead> aead;
+  if (options_.max_messages_per_dek > 1) {
+    absl::MutexLock lock(&mu_);
+    if (cached_dek_aead_ != nullptr &&
+        cached_dek_message_count_ + message_count <=
+            options_.max_messages_per_dek &&
+        absl::Now() < cached_dek_expiration_) {
+      cached_dek_message_count_ += message_count;
+      *encrypted_dek = cached_encrypted_dek_;
+      return cached_dek_aead_;
+    }
+  }
+
   // Generate DEK.
   auto dek_result = Registry::NewKeyData(dek_template_);
   if (!dek_result.ok()) return dek_result.status();
@@ -78,17 +104,163 @@ util::StatusOr<std::string> KmsEnvelopeAead::Encrypt(
   auto dek_encrypt_result =
       remote_aead_->Encrypt(dek->value(), kEmptyAssociatedData);
   if (!dek_encrypt_result.ok()) return dek_encrypt_result.status();
+  *encrypted_dek = std::move(dek_encrypt_result.ValueOrDie());
 
-  // Encrypt plaintext using DEK.
   auto aead_result = Registry::GetPrimitive<Aead>(*dek);
   if (!aead_result.ok()) return aead_result.status();
-  auto aead = std::move(aead_result.ValueOrDie());
-  auto encrypt_result = aead->Encrypt(plaintext, associated_data);
+  aead = std::move(aead_result.ValueOrDie());
+
+  if (options_.max_messages_per_dek > 1) {
+    absl::MutexLock lock(&mu_);
+    cached_dek_aead_ = aead;
+    cached_encrypted_dek_ = *encrypted_dek;
+    cached_dek_message_count_ = message_count;
+    cached_dek_expiration_ = absl::Now() + options_.max_dek_age;
+  }
+  return aead;
+}
+
+util::StatusOr<std::string> KmsEnvelopeAead::Encrypt(
+    absl::string_view plaintext, absl::string_view associated_data) const {
+  std::string encrypted_dek;
+  auto aead_result = GetEncryptionDek(/* message_count = */ 1, &encrypted_dek);
+  if (!aead_result.ok()) return aead_result.status();
+
+  // Encrypt plaintext using DEK.
+  auto encrypt_result =
+      aead_result.ValueOrDie()->Encrypt(plaintext, associated_data);
   if (!encrypt_result.ok()) return encrypt_result.status();
 
   // Build and return ciphertext.
-  return GetEnvelopeCiphertext(dek_encrypt_result.ValueOrDie(),
-                               encrypt_result.ValueOrDie());
+  return GetEnvelopeCiphertext(encrypted_dek, encrypt_result.ValueOrDie());
+}
+
+util::StatusOr<std::string> KmsEnvelopeAead::EncryptEnvelopeBatch(
+    absl::Span<const absl::string_view> plaintexts,
+    absl::string_view associated_data) const {
+  std::string encrypted_dek;
+  auto aead_result = GetEncryptionDek(
+      static_cast<int>(plaintexts.size()), &encrypted_dek);
+  if (!aead_result.ok()) return aead_result.status();
+  Aead& aead = *aead_result.ValueOrDie();
+
+  std::string result;
+  uint8_t size_buffer[kEncryptedDekPrefixSize];
+  absl::big_endian::Store32(size_buffer, encrypted_dek.size());
+  result.append(reinterpret_cast<const char*>(size_buffer),
+                kEncryptedDekPrefixSize);
+  result.append(encrypted_dek.data(), encrypted_dek.size());
+  for (absl::string_view plaintext : plaintexts) {
+    auto encrypt_result = aead.Encrypt(plaintext, associated_data);
+    if (!encrypt_result.ok()) return encrypt_result.status();
+    const std::string& payload = encrypt_result.ValueOrDie();
+    absl::big_endian::Store32(size_buffer, payload.size());
+    result.append(reinterpret_cast<const char*>(size_buffer),
+                  kEncryptedDekPrefixSize);
+    result.append(payload.data(), payload.size());
+  }
+  return result;
+}
+
+util::StatusOr<std::shared_ptr<Aead>> KmsEnvelopeAead::GetDecryptionDek(
+    absl::string_view encrypted_dek) const {
+  std::string cache_key(encrypted_dek);
+  std::shared_ptr<Aead> aead;
+  std::shared_ptr<InFlightUnwrap> in_flight;
+  bool is_leader = false;
+  {
+    absl::MutexLock lock(&mu_);
+    if (options_.decrypt_cache_size > 0) {
+      auto it = decrypt_cache_.find(cache_key);
+      if (it != decrypt_cache_.end()) {
+        decrypt_recency_.splice(decrypt_recency_.begin(), decrypt_recency_,
+                                it->second.recency);
+        aead = it->second.aead;
+      }
+    }
+    if (aead == nullptr) {
+      // Coalesce with an unwrap of the same encrypted DEK that is already
+      // in flight, or register a new one that later arrivals can join.
+      auto it = in_flight_unwraps_.find(cache_key);
+      if (it != in_flight_unwraps_.end()) {
+        in_flight = it->second;
+      } else {
+        in_flight = std::make_shared<InFlightUnwrap>();
+        in_flight_unwraps_[cache_key] = in_flight;
+        is_leader = true;
+      }
+    }
+  }
+
+  if (aead == nullptr && !is_leader) {
+    // Another caller is unwrapping this DEK right now; wait for its result
+    // instead of issuing a duplicate KMS call.
+    absl::MutexLock lock(&in_flight->mu);
+    in_flight->mu.Await(absl::Condition(&in_flight->done));
+    if (!in_flight->status.ok()) return in_flight->status;
+    aead = in_flight->aead;
+  }
+
+  if (aead == nullptr) {
+    // This caller leads the unwrap; the outcome (success or failure) is
+    // fanned out to all callers that joined while it was in flight.
+    auto publish = [this, &in_flight, &cache_key](
+                       const util::Status& status,
+                       const std::shared_ptr<Aead>& unwrapped_aead) {
+      {
+        absl::MutexLock lock(&mu_);
+        in_flight_unwraps_.erase(cache_key);
+      }
+      absl::MutexLock lock(&in_flight->mu);
+      in_flight->status = status;
+      in_flight->aead = unwrapped_aead;
+      in_flight->done = true;
+    };
+
+    // Decrypt the DEK with remote.
+    auto dek_decrypt_result =
+        remote_aead_->Decrypt(encrypted_dek, kEmptyAssociatedData);
+    if (!dek_decrypt_result.ok()) {
+      util::Status status(
+          util::error::INVALID_ARGUMENT,
+          absl::StrCat("invalid ciphertext: ",
+                       dek_decrypt_result.status().error_message()));
+      publish(status, nullptr);
+      return status;
+    }
+
+    // Create AEAD from DEK.
+    google::crypto::tink::KeyData dek;
+    dek.set_type_url(dek_template_.type_url());
+    dek.set_value(dek_decrypt_result.ValueOrDie());
+    dek.set_key_material_type(google::crypto::tink::KeyData::SYMMETRIC);
+
+    auto aead_result = Registry::GetPrimitive<Aead>(dek);
+    if (!aead_result.ok()) {
+      publish(aead_result.status(), nullptr);
+      return aead_result.status();
+    }
+    aead = std::move(aead_result.ValueOrDie());
+
+    if (options_.decrypt_cache_size > 0) {
+      absl::MutexLock lock(&mu_);
+      if (decrypt_cache_.count(cache_key) == 0) {
+        decrypt_recency_.push_front(cache_key);
+        DecryptCacheEntry entry;
+        entry.aead = aead;
+        entry.recency = decrypt_recency_.begin();
+        decrypt_cache_[cache_key] = std::move(entry);
+        if (decrypt_cache_.size() >
+            static_cast<size_t>(options_.decrypt_cache_size)) {
+          decrypt_cache_.erase(decrypt_recency_.back());
+          decrypt_recency_.pop_back();
+        }
+      }
+    }
+    publish(util::Status::OK, aead);
+  }
+
+  return aead;
 }
 
 util::StatusOr<std::string> KmsEnvelopeAead::Decrypt(
@@ -103,31 +275,59 @@ util::StatusOr<std::string> KmsEnvelopeAead::Decrypt(
       enc_dek_size < 0) {
     return util::Status(util::error::INVALID_ARGUMENT, "invalid ciphertext");
   }
-  // Decrypt the DEK with remote.
-  auto dek_decrypt_result = remote_aead_->Decrypt(
-      ciphertext.substr(kEncryptedDekPrefixSize, enc_dek_size),
-      kEmptyAssociatedData);
-  if (!dek_decrypt_result.ok()) {
-    return util::Status(
-        util::error::INVALID_ARGUMENT,
-        absl::StrCat("invalid ciphertext: ",
-                     dek_decrypt_result.status().error_message()));
-  }
-
-  // Create AEAD from DEK.
-  google::crypto::tink::KeyData dek;
-  dek.set_type_url(dek_template_.type_url());
-  dek.set_value(dek_decrypt_result.ValueOrDie());
-  dek.set_key_material_type(google::crypto::tink::KeyData::SYMMETRIC);
+  absl::string_view encrypted_dek =
+      ciphertext.substr(kEncryptedDekPrefixSize, enc_dek_size);
 
-  // Encrypt plaintext using DEK.
-  auto aead_result = Registry::GetPrimitive<Aead>(dek);
+  auto aead_result = GetDecryptionDek(encrypted_dek);
   if (!aead_result.ok()) return aead_result.status();
-  auto aead = std::move(aead_result.ValueOrDie());
-  return aead->Decrypt(
+
+  // Decrypt the payload using DEK.
+  return aead_result.ValueOrDie()->Decrypt(
       ciphertext.substr(kEncryptedDekPrefixSize + enc_dek_size),
       associated_data);
 }
 
+util::StatusOr<std::vector<std::string>> KmsEnvelopeAead::DecryptEnvelopeBatch(
+    absl::string_view ciphertext, absl::string_view associated_data) const {
+  // Parse the batch header.
+  if (ciphertext.size() < kEncryptedDekPrefixSize) {
+    return util::Status(util::error::INVALID_ARGUMENT, "ciphertext too short");
+  }
+  auto enc_dek_size = absl::big_endian::Load32(
+      reinterpret_cast<const uint8_t*>(ciphertext.data()));
+  if (enc_dek_size > ciphertext.size() - kEncryptedDekPrefixSize ||
+      enc_dek_size < 0) {
+    return util::Status(util::error::INVALID_ARGUMENT, "invalid ciphertext");
+  }
+  absl::string_view encrypted_dek =
+      ciphertext.substr(kEncryptedDekPrefixSize, enc_dek_size);
+
+  // One KMS unwrap serves every message in the batch.
+  auto aead_result = GetDecryptionDek(encrypted_dek);
+  if (!aead_result.ok()) return aead_result.status();
+  Aead& aead = *aead_result.ValueOrDie();
+
+  absl::string_view remaining =
+      ciphertext.substr(kEncryptedDekPrefixSize + enc_dek_size);
+  std::vector<std::string> plaintexts;
+  while (!remaining.empty()) {
+    if (remaining.size() < kEncryptedDekPrefixSize) {
+      return util::Status(util::error::INVALID_ARGUMENT, "invalid ciphertext");
+    }
+    auto payload_size = absl::big_endian::Load32(
+        reinterpret_cast<const uint8_t*>(remaining.data()));
+    if (payload_size > remaining.size() - kEncryptedDekPrefixSize) {
+      return util::Status(util::error::INVALID_ARGUMENT, "invalid ciphertext");
+    }
+    auto decrypt_result = aead.Decrypt(
+        remaining.substr(kEncryptedDekPrefixSize, payload_size),
+        associated_data);
+    if (!decrypt_result.ok()) return decrypt_result.status();
+    plaintexts.push_back(std::move(decrypt_result.ValueOrDie()));
+    remaining = remaining.substr(kEncryptedDekPrefixSize + payload_size);
+  }
+  return plaintexts;
+}
+
 }  // namespace tink
 }  // namespace crypto
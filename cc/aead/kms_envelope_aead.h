@@ -17,9 +17,17 @@
 #ifndef TINK_AEAD_KMS_ENVELOPE_AEAD_H_
 #define TINK_AEAD_KMS_ENVELOPE_AEAD_H_
 
+#include <list>
 #include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
 #include "tink/aead.h"
 #include "tink/util/status.h"
 #include "tink/util/statusor.h"
@@ -42,12 +50,68 @@ namespace tink {
 //  - Encrypted DEK: variable length that is equal to the value
 //    specified in the last 4 bytes.
 //  - AEAD payload: variable length.
+//
+// For batches of messages encrypted under one DEK (EncryptEnvelopeBatch),
+// the wrapped DEK is stored once for the whole batch instead of once per
+// message:
+//  - Length of encrypted DEK: 4 bytes (big endian)
+//  - Encrypted DEK
+//  - For each message: 4-byte big-endian payload length, followed by the
+//    AEAD payload of that message.
+//
+// The size of the encrypted DEK depends on the remote KMS and routinely
+// exceeds Aead::kMaxCiphertextOverhead, and no true bound is known up
+// front, so MaxEncryptionSize() is deliberately not overridden here.
+// Callers sizing buffers from it must handle an EncryptInto() buffer-size
+// failure by falling back to Encrypt(); see the MaxEncryptionSize()
+// contract in tink/aead.h.
+//
+// Operations block on the KMS round trip. Callers that must not pin a
+// thread per operation (event loops, fiber-based servers) can wrap an
+// instance in AsyncAeadFromAead (tink/aead/async_aead_from_aead.h) with an
+// executor hooked into their scheduler.
+//
+// Concurrent decryptions of ciphertexts that carry the same encrypted DEK
+// are coalesced: the first caller unwraps the DEK with the KMS, and callers
+// arriving while that call is in flight wait for its result instead of
+// issuing duplicate KMS requests. This happens regardless of the caching
+// options below.
 class KmsEnvelopeAead : public Aead {
  public:
-  static crypto::tink::util::StatusOr<std::unique_ptr<Aead>> New(
+  // Options for optional DEK caching. With the default values every
+  // encryption generates a fresh DEK and every decryption unwraps the
+  // encrypted DEK with the KMS, i.e. caching is disabled and each
+  // operation makes a KMS round trip.
+  struct CachingOptions {
+    // Maximum number of messages encrypted under one DEK. A value larger
+    // than 1 enables the encrypt-side cache: a freshly generated DEK is
+    // reused (together with its wrapped form) for up to this many messages,
+    // so a burst of encryptions needs only one KMS round trip. Every
+    // message is still encrypted with fresh randomness, but messages
+    // sharing a DEK share its compromise blast radius, so keep the bounds
+    // small.
+    int max_messages_per_dek = 1;
+    // Maximum age of a cached DEK on the encrypt side; once exceeded the
+    // next encryption generates a fresh DEK even if the message bound has
+    // not been reached.
+    absl::Duration max_dek_age = absl::Minutes(1);
+    // Maximum number of unwrapped DEKs remembered on the decrypt side,
+    // keyed by the encrypted-DEK bytes from the ciphertext; the least
+    // recently used entry is evicted first. A value larger than 0 enables
+    // the decrypt-side cache, so repeated reads of messages sharing a DEK
+    // skip the KMS round trip.
+    int decrypt_cache_size = 0;
+  };
+
+  static crypto::tink::util::StatusOr<std::unique_ptr<KmsEnvelopeAead>> New(
       const google::crypto::tink::KeyTemplate& dek_template,
       std::unique_ptr<Aead> remote_aead);
 
+  // Like above, but with DEK caching as specified in 'options'.
+  static crypto::tink::util::StatusOr<std::unique_ptr<KmsEnvelopeAead>> New(
+      const google::crypto::tink::KeyTemplate& dek_template,
+      std::unique_ptr<Aead> remote_aead, const CachingOptions& options);
+
   crypto::tink::util::StatusOr<std::string> Encrypt(
       absl::string_view plaintext,
       absl::string_view associated_data) const override;
@@ -56,15 +120,76 @@ class KmsEnvelopeAead : public Aead {
       absl::string_view ciphertext,
       absl::string_view associated_data) const override;
 
+  // Encrypts all 'plaintexts' with the same associated data under a single
+  // DEK into one batch ciphertext (see the format above), so the wrapped
+  // DEK is stored once per batch rather than once per message and
+  // decryption needs a single KMS unwrap for the whole batch.
+  crypto::tink::util::StatusOr<std::string> EncryptEnvelopeBatch(
+      absl::Span<const absl::string_view> plaintexts,
+      absl::string_view associated_data) const;
+
+  // Decrypts a batch ciphertext produced by EncryptEnvelopeBatch and
+  // returns the plaintexts in encryption order.
+  crypto::tink::util::StatusOr<std::vector<std::string>> DecryptEnvelopeBatch(
+      absl::string_view ciphertext, absl::string_view associated_data) const;
+
   ~KmsEnvelopeAead() override {}
 
  private:
   KmsEnvelopeAead(const google::crypto::tink::KeyTemplate& dek_template,
-                  std::unique_ptr<Aead> remote_aead) :
-      dek_template_(dek_template), remote_aead_(std::move(remote_aead)) {}
+                  std::unique_ptr<Aead> remote_aead,
+                  const CachingOptions& options) :
+      dek_template_(dek_template), remote_aead_(std::move(remote_aead)),
+      options_(options) {}
+
+  // Returns the AEAD to encrypt the next 'message_count' messages with and
+  // stores its wrapped form in 'encrypted_dek': the cached encrypt-side
+  // DEK when caching permits, a freshly generated and wrapped one
+  // otherwise.
+  crypto::tink::util::StatusOr<std::shared_ptr<Aead>> GetEncryptionDek(
+      int message_count, std::string* encrypted_dek) const;
+
+  // Returns the AEAD for 'encrypted_dek', unwrapping it with the KMS
+  // unless the decrypt-side cache or an unwrap already in flight provides
+  // it.
+  crypto::tink::util::StatusOr<std::shared_ptr<Aead>> GetDecryptionDek(
+      absl::string_view encrypted_dek) const;
+
+  struct DecryptCacheEntry {
+    std::shared_ptr<Aead> aead;
+    std::list<std::string>::iterator recency;
+  };
+
+  // One in-flight KMS unwrap call; callers that find an entry for their
+  // encrypted DEK wait for 'done' instead of calling the KMS themselves.
+  struct InFlightUnwrap {
+    absl::Mutex mu;
+    bool done ABSL_GUARDED_BY(mu) = false;
+    crypto::tink::util::Status status ABSL_GUARDED_BY(mu);
+    std::shared_ptr<Aead> aead ABSL_GUARDED_BY(mu);
+  };
 
   google::crypto::tink::KeyTemplate dek_template_;
   std::unique_ptr<Aead> remote_aead_;
+  CachingOptions options_;
+
+  mutable absl::Mutex mu_;
+  // Encrypt-side cache: one wrapped DEK shared by subsequent encryptions
+  // until its message count or age bound is reached.
+  mutable std::shared_ptr<Aead> cached_dek_aead_ ABSL_GUARDED_BY(mu_);
+  mutable std::string cached_encrypted_dek_ ABSL_GUARDED_BY(mu_);
+  mutable int cached_dek_message_count_ ABSL_GUARDED_BY(mu_) = 0;
+  mutable absl::Time cached_dek_expiration_ ABSL_GUARDED_BY(mu_) =
+      absl::InfinitePast();
+  // Decrypt-side LRU cache of unwrapped DEKs, keyed by the encrypted-DEK
+  // bytes; decrypt_recency_ orders the keys from most to least recently
+  // used.
+  mutable std::unordered_map<std::string, DecryptCacheEntry>
+      decrypt_cache_ ABSL_GUARDED_BY(mu_);
+  mutable std::list<std::string> decrypt_recency_ ABSL_GUARDED_BY(mu_);
+  // Unwrap calls currently in flight, keyed by the encrypted-DEK bytes.
+  mutable std::unordered_map<std::string, std::shared_ptr<InFlightUnwrap>>
+      in_flight_unwraps_ ABSL_GUARDED_BY(mu_);
 };
 
 }  // namespace tink
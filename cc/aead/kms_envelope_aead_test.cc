@@ -16,13 +16,20 @@
 
 #include "tink/aead/kms_envelope_aead.h"
 
+#include <memory>
 #include <string>
+#include <thread>  // NOLINT(build/c++11)
 #include <vector>
 
 #include "gtest/gtest.h"
 #include "absl/base/internal/endian.h"
+#include "absl/base/thread_annotations.h"
 #include "absl/memory/memory.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "tink/aead/aead_config.h"
 #include "tink/aead/aead_key_templates.h"
 #include "tink/mac/mac_key_templates.h"
@@ -42,6 +49,81 @@ using crypto::tink::test::IsOk;
 using crypto::tink::test::StatusIs;
 using testing::HasSubstr;
 
+// Wraps an Aead and counts the calls that reach it, to observe how many
+// KMS round trips the envelope AEAD makes.
+class CountingAead : public Aead {
+ public:
+  explicit CountingAead(std::unique_ptr<Aead> aead) : aead_(std::move(aead)) {}
+
+  crypto::tink::util::StatusOr<std::string> Encrypt(
+      absl::string_view plaintext,
+      absl::string_view associated_data) const override {
+    encrypt_count_++;
+    return aead_->Encrypt(plaintext, associated_data);
+  }
+
+  crypto::tink::util::StatusOr<std::string> Decrypt(
+      absl::string_view ciphertext,
+      absl::string_view associated_data) const override {
+    decrypt_count_++;
+    return aead_->Decrypt(ciphertext, associated_data);
+  }
+
+  int encrypt_count() const { return encrypt_count_; }
+  int decrypt_count() const { return decrypt_count_; }
+
+ private:
+  std::unique_ptr<Aead> aead_;
+  mutable int encrypt_count_ = 0;
+  mutable int decrypt_count_ = 0;
+};
+
+// Wraps an Aead and blocks every Decrypt() call until Release() is called,
+// to keep a simulated KMS unwrap in flight while other callers pile up.
+class BlockingAead : public Aead {
+ public:
+  explicit BlockingAead(std::unique_ptr<Aead> aead) : aead_(std::move(aead)) {}
+
+  crypto::tink::util::StatusOr<std::string> Encrypt(
+      absl::string_view plaintext,
+      absl::string_view associated_data) const override {
+    return aead_->Encrypt(plaintext, associated_data);
+  }
+
+  crypto::tink::util::StatusOr<std::string> Decrypt(
+      absl::string_view ciphertext,
+      absl::string_view associated_data) const override {
+    {
+      absl::MutexLock lock(&mu_);
+      decrypt_count_++;
+      mu_.Await(absl::Condition(&released_));
+    }
+    return aead_->Decrypt(ciphertext, associated_data);
+  }
+
+  // Blocks until at least one Decrypt() call has arrived.
+  void WaitForDecrypt() const {
+    absl::MutexLock lock(&mu_);
+    mu_.Await(absl::Condition(
+        +[](const int* count) { return *count > 0; }, &decrypt_count_));
+  }
+
+  void Release() {
+    absl::MutexLock lock(&mu_);
+    released_ = true;
+  }
+
+  int decrypt_count() const {
+    absl::MutexLock lock(&mu_);
+    return decrypt_count_;
+  }
+
+ private:
+  std::unique_ptr<Aead> aead_;
+  mutable absl::Mutex mu_;
+  mutable int decrypt_count_ ABSL_GUARDED_BY(mu_) = 0;
+  bool released_ ABSL_GUARDED_BY(mu_) = false;
+};
 
 TEST(KmsEnvelopeAeadTest, BasicEncryptDecrypt) {
   EXPECT_THAT(AeadConfig::Register(), IsOk());
@@ -169,6 +251,268 @@ TEST(KmsEnvelopeAeadTest, KeyFormat) {
   EXPECT_THAT(key.key_value().size(), testing::Eq(16));
 }
 
+TEST(KmsEnvelopeAeadTest, CachedDekReusedAcrossEncryptions) {
+  EXPECT_THAT(AeadConfig::Register(), IsOk());
+
+  auto dek_template = AeadKeyTemplates::Aes128Gcm();
+  auto remote_aead = absl::make_unique<CountingAead>(
+      absl::make_unique<DummyAead>("kms-backed-aead"));
+  CountingAead* remote = remote_aead.get();
+
+  KmsEnvelopeAead::CachingOptions options;
+  options.max_messages_per_dek = 3;
+  options.max_dek_age = absl::Minutes(5);
+  auto aead_result =
+      KmsEnvelopeAead::New(dek_template, std::move(remote_aead), options);
+  EXPECT_THAT(aead_result.status(), IsOk());
+  auto aead = std::move(aead_result.ValueOrDie());
+
+  std::string message = "Some data to encrypt.";
+  std::string aad = "Some data to authenticate.";
+  std::vector<std::string> ciphertexts;
+  for (int i = 0; i < 3; i++) {
+    auto encrypt_result = aead->Encrypt(message, aad);
+    EXPECT_THAT(encrypt_result.status(), IsOk());
+    ciphertexts.push_back(encrypt_result.ValueOrDie());
+  }
+  // One DEK wrapped for the whole burst, so the encrypted-DEK part of
+  // the ciphertexts is identical.
+  EXPECT_EQ(1, remote->encrypt_count());
+  auto enc_dek_size = absl::big_endian::Load32(
+      reinterpret_cast<const uint8_t*>(ciphertexts[0].data()));
+  for (const std::string& ct : ciphertexts) {
+    EXPECT_EQ(ciphertexts[0].substr(0, 4 + enc_dek_size),
+              ct.substr(0, 4 + enc_dek_size));
+  }
+
+  // The fourth message exceeds max_messages_per_dek and gets a fresh DEK.
+  auto encrypt_result = aead->Encrypt(message, aad);
+  EXPECT_THAT(encrypt_result.status(), IsOk());
+  ciphertexts.push_back(encrypt_result.ValueOrDie());
+  EXPECT_EQ(2, remote->encrypt_count());
+
+  // All ciphertexts decrypt correctly.
+  for (const std::string& ct : ciphertexts) {
+    auto decrypt_result = aead->Decrypt(ct, aad);
+    EXPECT_THAT(decrypt_result.status(), IsOk());
+    EXPECT_EQ(message, decrypt_result.ValueOrDie());
+  }
+}
+
+TEST(KmsEnvelopeAeadTest, ExpiredCachedDekIsNotReused) {
+  EXPECT_THAT(AeadConfig::Register(), IsOk());
+
+  auto dek_template = AeadKeyTemplates::Aes128Gcm();
+  auto remote_aead = absl::make_unique<CountingAead>(
+      absl::make_unique<DummyAead>("kms-backed-aead"));
+  CountingAead* remote = remote_aead.get();
+
+  KmsEnvelopeAead::CachingOptions options;
+  options.max_messages_per_dek = 100;
+  options.max_dek_age = absl::ZeroDuration();
+  auto aead_result =
+      KmsEnvelopeAead::New(dek_template, std::move(remote_aead), options);
+  EXPECT_THAT(aead_result.status(), IsOk());
+  auto aead = std::move(aead_result.ValueOrDie());
+
+  std::string message = "Some data to encrypt.";
+  std::string aad = "Some data to authenticate.";
+  EXPECT_THAT(aead->Encrypt(message, aad).status(), IsOk());
+  EXPECT_THAT(aead->Encrypt(message, aad).status(), IsOk());
+  // A DEK of age zero is always expired, so every message wraps a new one.
+  EXPECT_EQ(2, remote->encrypt_count());
+}
+
+TEST(KmsEnvelopeAeadTest, DecryptCacheSkipsKms) {
+  EXPECT_THAT(AeadConfig::Register(), IsOk());
+
+  auto dek_template = AeadKeyTemplates::Aes128Gcm();
+  std::string remote_aead_name = "kms-backed-aead";
+  std::string message = "Some data to encrypt.";
+  std::string aad = "Some data to authenticate.";
+
+  // Produce two ciphertexts with distinct DEKs.
+  auto encrypting_aead_result = KmsEnvelopeAead::New(
+      dek_template, absl::make_unique<DummyAead>(remote_aead_name));
+  EXPECT_THAT(encrypting_aead_result.status(), IsOk());
+  auto encrypting_aead = std::move(encrypting_aead_result.ValueOrDie());
+  std::string ct1 = encrypting_aead->Encrypt(message, aad).ValueOrDie();
+  std::string ct2 = encrypting_aead->Encrypt(message, aad).ValueOrDie();
+
+  auto remote_aead = absl::make_unique<CountingAead>(
+      absl::make_unique<DummyAead>(remote_aead_name));
+  CountingAead* remote = remote_aead.get();
+  KmsEnvelopeAead::CachingOptions options;
+  options.decrypt_cache_size = 1;
+  auto aead_result =
+      KmsEnvelopeAead::New(dek_template, std::move(remote_aead), options);
+  EXPECT_THAT(aead_result.status(), IsOk());
+  auto aead = std::move(aead_result.ValueOrDie());
+
+  // Repeated reads of the same DEK unwrap it only once.
+  EXPECT_EQ(message, aead->Decrypt(ct1, aad).ValueOrDie());
+  EXPECT_EQ(message, aead->Decrypt(ct1, aad).ValueOrDie());
+  EXPECT_EQ(1, remote->decrypt_count());
+
+  // A different DEK evicts the cached one (cache size is 1), so reading
+  // the first ciphertext again goes back to the KMS.
+  EXPECT_EQ(message, aead->Decrypt(ct2, aad).ValueOrDie());
+  EXPECT_EQ(2, remote->decrypt_count());
+  EXPECT_EQ(message, aead->Decrypt(ct1, aad).ValueOrDie());
+  EXPECT_EQ(3, remote->decrypt_count());
+  EXPECT_EQ(message, aead->Decrypt(ct1, aad).ValueOrDie());
+  EXPECT_EQ(3, remote->decrypt_count());
+}
+
+TEST(KmsEnvelopeAeadTest, BatchEncryptDecrypt) {
+  EXPECT_THAT(AeadConfig::Register(), IsOk());
+
+  auto dek_template = AeadKeyTemplates::Aes128Gcm();
+  auto remote_aead = absl::make_unique<DummyAead>("kms-backed-aead");
+  auto aead_result = KmsEnvelopeAead::New(dek_template, std::move(remote_aead));
+  EXPECT_THAT(aead_result.status(), IsOk());
+  auto aead = std::move(aead_result.ValueOrDie());
+
+  std::vector<absl::string_view> messages = {"first", "", "third message"};
+  std::string aad = "Some data to authenticate.";
+  auto encrypt_result = aead->EncryptEnvelopeBatch(messages, aad);
+  EXPECT_THAT(encrypt_result.status(), IsOk());
+
+  auto decrypt_result =
+      aead->DecryptEnvelopeBatch(encrypt_result.ValueOrDie(), aad);
+  EXPECT_THAT(decrypt_result.status(), IsOk());
+  auto plaintexts = decrypt_result.ValueOrDie();
+  ASSERT_EQ(messages.size(), plaintexts.size());
+  for (size_t i = 0; i < messages.size(); i++) {
+    EXPECT_EQ(messages[i], plaintexts[i]);
+  }
+
+  // An empty batch is just the wrapped-DEK header.
+  auto empty_result = aead->EncryptEnvelopeBatch({}, aad);
+  EXPECT_THAT(empty_result.status(), IsOk());
+  auto empty_plaintexts =
+      aead->DecryptEnvelopeBatch(empty_result.ValueOrDie(), aad);
+  EXPECT_THAT(empty_plaintexts.status(), IsOk());
+  EXPECT_TRUE(empty_plaintexts.ValueOrDie().empty());
+}
+
+TEST(KmsEnvelopeAeadTest, BatchUsesOneKmsRoundTripEachWay) {
+  EXPECT_THAT(AeadConfig::Register(), IsOk());
+
+  auto dek_template = AeadKeyTemplates::Aes128Gcm();
+  std::string remote_aead_name = "kms-backed-aead";
+  auto remote_aead = absl::make_unique<CountingAead>(
+      absl::make_unique<DummyAead>(remote_aead_name));
+  CountingAead* remote = remote_aead.get();
+  auto aead_result = KmsEnvelopeAead::New(dek_template, std::move(remote_aead));
+  EXPECT_THAT(aead_result.status(), IsOk());
+  auto aead = std::move(aead_result.ValueOrDie());
+
+  std::vector<absl::string_view> messages = {"one", "two", "three", "four"};
+  std::string aad = "Some data to authenticate.";
+  auto encrypt_result = aead->EncryptEnvelopeBatch(messages, aad);
+  EXPECT_THAT(encrypt_result.status(), IsOk());
+  // One DEK is wrapped for the whole batch, even without encrypt-side
+  // caching.
+  EXPECT_EQ(1, remote->encrypt_count());
+
+  // Decrypt with a separate instance so the in-process DEK is not reused.
+  auto reader_remote = absl::make_unique<CountingAead>(
+      absl::make_unique<DummyAead>(remote_aead_name));
+  CountingAead* reader = reader_remote.get();
+  auto reader_result =
+      KmsEnvelopeAead::New(dek_template, std::move(reader_remote));
+  EXPECT_THAT(reader_result.status(), IsOk());
+  auto reader_aead = std::move(reader_result.ValueOrDie());
+  auto decrypt_result =
+      reader_aead->DecryptEnvelopeBatch(encrypt_result.ValueOrDie(), aad);
+  EXPECT_THAT(decrypt_result.status(), IsOk());
+  EXPECT_EQ(messages.size(), decrypt_result.ValueOrDie().size());
+  // One KMS unwrap serves all messages in the batch.
+  EXPECT_EQ(1, reader->decrypt_count());
+}
+
+TEST(KmsEnvelopeAeadTest, BatchDecryptionErrors) {
+  EXPECT_THAT(AeadConfig::Register(), IsOk());
+
+  auto dek_template = AeadKeyTemplates::Aes128Gcm();
+  auto remote_aead = absl::make_unique<DummyAead>("kms-backed-aead");
+  auto aead_result = KmsEnvelopeAead::New(dek_template, std::move(remote_aead));
+  EXPECT_THAT(aead_result.status(), IsOk());
+  auto aead = std::move(aead_result.ValueOrDie());
+
+  std::vector<absl::string_view> messages = {"first", "second"};
+  std::string aad = "Some data to authenticate.";
+  auto ct = aead->EncryptEnvelopeBatch(messages, aad).ValueOrDie();
+
+  // Empty ciphertext.
+  EXPECT_THAT(aead->DecryptEnvelopeBatch("", aad).status(),
+              StatusIs(util::error::INVALID_ARGUMENT, HasSubstr("too short")));
+
+  // Truncated ciphertext: the last payload length points past the end.
+  EXPECT_THAT(
+      aead->DecryptEnvelopeBatch(ct.substr(0, ct.size() - 1), aad).status(),
+      StatusIs(util::error::INVALID_ARGUMENT, HasSubstr("invalid")));
+
+  // Trailing garbage shorter than a length prefix.
+  EXPECT_THAT(aead->DecryptEnvelopeBatch(absl::StrCat(ct, "xy"), aad).status(),
+              StatusIs(util::error::INVALID_ARGUMENT, HasSubstr("invalid")));
+
+  // Wrong associated data.
+  EXPECT_THAT(
+      aead->DecryptEnvelopeBatch(ct, "wrong aad").status(),
+      StatusIs(util::error::INTERNAL, HasSubstr("Authentication failed")));
+}
+
+TEST(KmsEnvelopeAeadTest, ConcurrentUnwrapsAreCoalesced) {
+  EXPECT_THAT(AeadConfig::Register(), IsOk());
+
+  auto dek_template = AeadKeyTemplates::Aes128Gcm();
+  std::string remote_aead_name = "kms-backed-aead";
+  std::string message = "Some data to encrypt.";
+  std::string aad = "Some data to authenticate.";
+
+  auto encrypting_aead_result = KmsEnvelopeAead::New(
+      dek_template, absl::make_unique<DummyAead>(remote_aead_name));
+  EXPECT_THAT(encrypting_aead_result.status(), IsOk());
+  auto encrypting_aead = std::move(encrypting_aead_result.ValueOrDie());
+  std::string ct = encrypting_aead->Encrypt(message, aad).ValueOrDie();
+
+  auto remote_aead = absl::make_unique<BlockingAead>(
+      absl::make_unique<DummyAead>(remote_aead_name));
+  BlockingAead* remote = remote_aead.get();
+  // No decrypt cache: coalescing is independent of the caching options.
+  auto aead_result =
+      KmsEnvelopeAead::New(dek_template, std::move(remote_aead));
+  EXPECT_THAT(aead_result.status(), IsOk());
+  std::shared_ptr<Aead> aead = std::move(aead_result.ValueOrDie());
+
+  int num_threads = 8;
+  std::vector<std::string> plaintexts(num_threads);
+  std::vector<std::thread> threads;
+  auto decrypt = [aead, ct, aad, &plaintexts](int i) {
+    plaintexts[i] = aead->Decrypt(ct, aad).ValueOrDie();
+  };
+
+  // The first caller reaches the KMS and blocks there; everyone arriving
+  // while that call is in flight should share its result.
+  threads.emplace_back(decrypt, 0);
+  remote->WaitForDecrypt();
+  for (int i = 1; i < num_threads; i++) {
+    threads.emplace_back(decrypt, i);
+  }
+  absl::SleepFor(absl::Milliseconds(100));
+  remote->Release();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (int i = 0; i < num_threads; i++) {
+    EXPECT_EQ(message, plaintexts[i]);
+  }
+  EXPECT_EQ(1, remote->decrypt_count());
+}
+
 }  // namespace
 }  // namespace tink
 }  // namespace crypto
@@ -0,0 +1,90 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/aead/thread_local_aead.h"
+
+#include "tink/util/status.h"
+
+namespace crypto {
+namespace tink {
+
+// static
+util::StatusOr<std::unique_ptr<Aead>> ThreadLocalAead::New(
+    std::unique_ptr<const KeysetHandle> keyset_handle) {
+  if (keyset_handle == nullptr) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "keyset_handle must be non-null");
+  }
+  std::unique_ptr<ThreadLocalAead> aead(
+      new ThreadLocalAead(std::move(keyset_handle)));
+  // Build the creating thread's replica eagerly, so that configuration
+  // problems (unregistered key managers, malformed keysets) surface here
+  // rather than on the first operation of each thread.
+  auto replica = aead->replicas_.Get();
+  if (!replica.ok()) return replica.status();
+  return std::unique_ptr<Aead>(std::move(aead));
+}
+
+util::StatusOr<std::string> ThreadLocalAead::Encrypt(
+    absl::string_view plaintext, absl::string_view associated_data) const {
+  auto replica = replicas_.Get();
+  if (!replica.ok()) return replica.status();
+  return replica.ValueOrDie()->Encrypt(plaintext, associated_data);
+}
+
+util::StatusOr<std::string> ThreadLocalAead::Decrypt(
+    absl::string_view ciphertext, absl::string_view associated_data) const {
+  auto replica = replicas_.Get();
+  if (!replica.ok()) return replica.status();
+  return replica.ValueOrDie()->Decrypt(ciphertext, associated_data);
+}
+
+size_t ThreadLocalAead::MaxEncryptionSize(size_t plaintext_size) const {
+  auto replica = replicas_.Get();
+  // MaxEncryptionSize cannot report an error; the conservative default
+  // bound is correct for any replica.
+  if (!replica.ok()) return Aead::MaxEncryptionSize(plaintext_size);
+  return replica.ValueOrDie()->MaxEncryptionSize(plaintext_size);
+}
+
+util::StatusOr<size_t> ThreadLocalAead::EncryptInto(
+    absl::string_view plaintext, absl::string_view associated_data,
+    absl::Span<char> out) const {
+  auto replica = replicas_.Get();
+  if (!replica.ok()) return replica.status();
+  return replica.ValueOrDie()->EncryptInto(plaintext, associated_data, out);
+}
+
+util::StatusOr<size_t> ThreadLocalAead::DecryptInto(
+    absl::string_view ciphertext, absl::string_view associated_data,
+    absl::Span<char> out) const {
+  auto replica = replicas_.Get();
+  if (!replica.ok()) return replica.status();
+  return replica.ValueOrDie()->DecryptInto(ciphertext, associated_data, out);
+}
+
+util::Status ThreadLocalAead::EncryptBatch(
+    absl::Span<const absl::string_view> plaintexts,
+    absl::string_view associated_data, absl::Span<const absl::Span<char>> outs,
+    absl::Span<size_t> ciphertext_sizes) const {
+  auto replica = replicas_.Get();
+  if (!replica.ok()) return replica.status();
+  return replica.ValueOrDie()->EncryptBatch(plaintexts, associated_data, outs,
+                                            ciphertext_sizes);
+}
+
+}  // namespace tink
+}  // namespace crypto
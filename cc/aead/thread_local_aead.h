@@ -0,0 +1,85 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_AEAD_THREAD_LOCAL_AEAD_H_
+#define TINK_AEAD_THREAD_LOCAL_AEAD_H_
+
+#include <memory>
+#include <utility>
+
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "tink/aead.h"
+#include "tink/internal/per_thread_primitive.h"
+#include "tink/keyset_handle.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+
+// An Aead that routes every operation to a replica local to the calling
+// thread, all replicas being built from the same keyset. This is an
+// opt-in alternative to sharing one wrapped Aead instance across many
+// threads: with replicas, threads share no cache lines through the
+// primitive, which matters for high fan-in workloads where shared state
+// (ownership words, hit counters, any state behind locks) ping-pongs
+// between cores.
+//
+// Replicas are built lazily on each thread's first operation and live
+// until the thread exits, so this trades memory (one replica per thread)
+// for the shared-nothing fast path.
+class ThreadLocalAead : public Aead {
+ public:
+  // Takes ownership of 'keyset_handle' and builds one replica per calling
+  // thread from it. Fails if the handle does not yield an Aead.
+  static crypto::tink::util::StatusOr<std::unique_ptr<Aead>> New(
+      std::unique_ptr<const KeysetHandle> keyset_handle);
+
+  crypto::tink::util::StatusOr<std::string> Encrypt(
+      absl::string_view plaintext,
+      absl::string_view associated_data) const override;
+
+  crypto::tink::util::StatusOr<std::string> Decrypt(
+      absl::string_view ciphertext,
+      absl::string_view associated_data) const override;
+
+  size_t MaxEncryptionSize(size_t plaintext_size) const override;
+
+  crypto::tink::util::StatusOr<size_t> EncryptInto(
+      absl::string_view plaintext, absl::string_view associated_data,
+      absl::Span<char> out) const override;
+
+  crypto::tink::util::StatusOr<size_t> DecryptInto(
+      absl::string_view ciphertext, absl::string_view associated_data,
+      absl::Span<char> out) const override;
+
+  crypto::tink::util::Status EncryptBatch(
+      absl::Span<const absl::string_view> plaintexts,
+      absl::string_view associated_data,
+      absl::Span<const absl::Span<char>> outs,
+      absl::Span<size_t> ciphertext_sizes) const override;
+
+ private:
+  explicit ThreadLocalAead(std::unique_ptr<const KeysetHandle> keyset_handle)
+      : replicas_(std::move(keyset_handle)) {}
+
+  internal::PerThreadPrimitive<Aead> replicas_;
+};
+
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_AEAD_THREAD_LOCAL_AEAD_H_
@@ -0,0 +1,90 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/aead/thread_local_aead.h"
+
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
+#include "tink/aead/aead_config.h"
+#include "tink/aead/aead_key_templates.h"
+#include "tink/keyset_handle.h"
+#include "tink/util/test_matchers.h"
+
+namespace crypto {
+namespace tink {
+namespace {
+
+using ::crypto::tink::test::IsOk;
+
+class ThreadLocalAeadTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() { ASSERT_THAT(AeadConfig::Register(), IsOk()); }
+};
+
+TEST_F(ThreadLocalAeadTest, Basic) {
+  auto handle =
+      KeysetHandle::GenerateNew(AeadKeyTemplates::Aes128Gcm()).ValueOrDie();
+  auto aead = ThreadLocalAead::New(std::move(handle)).ValueOrDie();
+
+  std::string plaintext = "some plaintext";
+  std::string aad = "some aad";
+  std::string ciphertext = aead->Encrypt(plaintext, aad).ValueOrDie();
+  EXPECT_EQ(plaintext, aead->Decrypt(ciphertext, aad).ValueOrDie());
+}
+
+TEST_F(ThreadLocalAeadTest, ReplicasInteroperate) {
+  auto handle =
+      KeysetHandle::GenerateNew(AeadKeyTemplates::Aes128Gcm()).ValueOrDie();
+  auto aead = ThreadLocalAead::New(std::move(handle)).ValueOrDie();
+
+  // Each thread encrypts with its own replica; all ciphertexts must
+  // decrypt with the main thread's replica, since every replica is built
+  // from the same keyset.
+  constexpr int kThreadCount = 8;
+  std::string aad = "some aad";
+  std::vector<std::string> ciphertexts(kThreadCount);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreadCount; i++) {
+    threads.push_back(std::thread([&aead, &aad, &ciphertexts, i]() {
+      std::string plaintext = absl::StrCat("plaintext for thread ", i);
+      auto encrypt_result = aead->Encrypt(plaintext, aad);
+      if (encrypt_result.ok()) {
+        ciphertexts[i] = encrypt_result.ValueOrDie();
+      }
+    }));
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (int i = 0; i < kThreadCount; i++) {
+    ASSERT_FALSE(ciphertexts[i].empty());
+    EXPECT_EQ(absl::StrCat("plaintext for thread ", i),
+              aead->Decrypt(ciphertexts[i], aad).ValueOrDie());
+  }
+}
+
+TEST_F(ThreadLocalAeadTest, NullHandle) {
+  auto aead_result = ThreadLocalAead::New(nullptr);
+  EXPECT_FALSE(aead_result.ok());
+}
+
+}  // namespace
+}  // namespace tink
+}  // namespace crypto
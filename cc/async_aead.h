@@ -0,0 +1,63 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_ASYNC_AEAD_H_
+#define TINK_ASYNC_AEAD_H_
+
+#include <future>  // NOLINT(build/c++11)
+#include <string>
+
+#include "absl/strings/string_view.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+
+///////////////////////////////////////////////////////////////////////////////
+// The interface for asynchronous authenticated encryption with associated
+// data. It mirrors the Aead interface, but each operation returns a
+// std::future that becomes ready when the operation completes, so callers
+// whose implementations are I/O-bound (e.g. envelope encryption that makes
+// KMS round trips) do not have to dedicate a thread per operation. Event
+// loops and fiber frameworks can await the future with their own machinery.
+//
+// Implementations must make sure that a returned future eventually becomes
+// ready, and that the arguments are not used after the call returns (i.e.
+// copied if the operation outlives the call).
+//
+// Synchronous Aead implementations can be adapted with AsyncAeadFromAead
+// (tink/aead/async_aead_from_aead.h).
+class AsyncAead {
+ public:
+  // Encrypts 'plaintext' with 'associated_data' as associated data;
+  // the resulting future yields the ciphertext, see Aead::Encrypt().
+  virtual std::future<crypto::tink::util::StatusOr<std::string>> EncryptAsync(
+      absl::string_view plaintext,
+      absl::string_view associated_data) const = 0;
+
+  // Decrypts 'ciphertext' with 'associated_data' as associated data;
+  // the resulting future yields the plaintext, see Aead::Decrypt().
+  virtual std::future<crypto::tink::util::StatusOr<std::string>> DecryptAsync(
+      absl::string_view ciphertext,
+      absl::string_view associated_data) const = 0;
+
+  virtual ~AsyncAead() {}
+};
+
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_ASYNC_AEAD_H_
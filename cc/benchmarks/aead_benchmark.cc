@@ -0,0 +1,105 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Benchmarks for the Aead primitive, measured through the keyset wrapper
+// (i.e. including prefix handling and key lookup). Run with:
+//   bazel run -c opt //benchmarks:aead_benchmark
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "absl/types/span.h"
+#include "tink/aead.h"
+#include "tink/aead/aead_config.h"
+#include "tink/aead/aead_key_templates.h"
+#include "tink/keyset_handle.h"
+#include "tink/subtle/random.h"
+
+namespace crypto {
+namespace tink {
+namespace {
+
+constexpr char kAssociatedData[] = "associated data";
+
+Aead& GetAead() {
+  static Aead* aead = [] {
+    auto status = AeadConfig::Register();
+    if (!status.ok()) {
+      std::cerr << status.error_message() << std::endl;
+      std::exit(1);
+    }
+    auto handle = KeysetHandle::GenerateNew(AeadKeyTemplates::Aes128Gcm());
+    if (!handle.ok()) {
+      std::cerr << handle.status().error_message() << std::endl;
+      std::exit(1);
+    }
+    auto aead_result = handle.ValueOrDie()->GetPrimitive<Aead>();
+    if (!aead_result.ok()) {
+      std::cerr << aead_result.status().error_message() << std::endl;
+      std::exit(1);
+    }
+    return aead_result.ValueOrDie().release();
+  }();
+  return *aead;
+}
+
+void BM_Encrypt(benchmark::State& state) {
+  Aead& aead = GetAead();
+  std::string plaintext = subtle::Random::GetRandomBytes(state.range(0));
+  for (auto _ : state) {
+    auto ciphertext = aead.Encrypt(plaintext, kAssociatedData);
+    if (!ciphertext.ok()) std::exit(1);
+    benchmark::DoNotOptimize(ciphertext);
+  }
+  state.SetBytesProcessed(state.iterations() * plaintext.size());
+}
+BENCHMARK(BM_Encrypt)->Arg(64)->Arg(1 << 10)->Arg(1 << 14)->Arg(1 << 20);
+
+void BM_EncryptInto(benchmark::State& state) {
+  Aead& aead = GetAead();
+  std::string plaintext = subtle::Random::GetRandomBytes(state.range(0));
+  std::string buffer(aead.MaxEncryptionSize(plaintext.size()), '\0');
+  for (auto _ : state) {
+    auto size = aead.EncryptInto(plaintext, kAssociatedData,
+                                 absl::MakeSpan(&buffer[0], buffer.size()));
+    if (!size.ok()) std::exit(1);
+    benchmark::DoNotOptimize(buffer.data());
+  }
+  state.SetBytesProcessed(state.iterations() * plaintext.size());
+}
+BENCHMARK(BM_EncryptInto)->Arg(64)->Arg(1 << 10)->Arg(1 << 14)->Arg(1 << 20);
+
+void BM_Decrypt(benchmark::State& state) {
+  Aead& aead = GetAead();
+  std::string plaintext = subtle::Random::GetRandomBytes(state.range(0));
+  std::string ciphertext =
+      aead.Encrypt(plaintext, kAssociatedData).ValueOrDie();
+  for (auto _ : state) {
+    auto decrypted = aead.Decrypt(ciphertext, kAssociatedData);
+    if (!decrypted.ok()) std::exit(1);
+    benchmark::DoNotOptimize(decrypted);
+  }
+  state.SetBytesProcessed(state.iterations() * plaintext.size());
+}
+BENCHMARK(BM_Decrypt)->Arg(64)->Arg(1 << 10)->Arg(1 << 14)->Arg(1 << 20);
+
+}  // namespace
+}  // namespace tink
+}  // namespace crypto
+
+BENCHMARK_MAIN();
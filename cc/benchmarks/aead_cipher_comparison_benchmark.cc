@@ -0,0 +1,114 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Compares the subtle AEAD ciphers head to head on the local CPU, without
+// keyset-wrapper overhead, to guide the choice of key template per fleet:
+// AES-GCM wins on machines with AES hardware, XChaCha20-Poly1305 relies on
+// the vector units (AVX2 on x86_64, NEON on ARM) and usually wins where
+// AES instructions are missing. Run on a machine of each fleet with:
+//   bazel run -c opt //benchmarks:aead_cipher_comparison_benchmark
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "absl/types/span.h"
+#include "tink/aead.h"
+#include "tink/subtle/aes_gcm_boringssl.h"
+#include "tink/subtle/random.h"
+#include "tink/subtle/xchacha20_poly1305_boringssl.h"
+#include "tink/util/secret_data.h"
+
+namespace crypto {
+namespace tink {
+namespace {
+
+constexpr char kAssociatedData[] = "associated data";
+
+Aead* ValueOrExit(crypto::tink::util::StatusOr<std::unique_ptr<Aead>> aead) {
+  if (!aead.ok()) {
+    std::cerr << aead.status().error_message() << std::endl;
+    std::exit(1);
+  }
+  return aead.ValueOrDie().release();
+}
+
+Aead& GetAesGcm() {
+  static Aead* aead = ValueOrExit(
+      subtle::AesGcmBoringSsl::New(subtle::Random::GetRandomKeyBytes(16)));
+  return *aead;
+}
+
+Aead& GetXChacha20Poly1305() {
+  static Aead* aead = ValueOrExit(subtle::XChacha20Poly1305BoringSsl::New(
+      subtle::Random::GetRandomKeyBytes(32)));
+  return *aead;
+}
+
+void RunEncryptInto(Aead& aead, benchmark::State& state) {
+  std::string plaintext = subtle::Random::GetRandomBytes(state.range(0));
+  std::string buffer(aead.MaxEncryptionSize(plaintext.size()), '\0');
+  for (auto _ : state) {
+    auto size = aead.EncryptInto(plaintext, kAssociatedData,
+                                 absl::MakeSpan(&buffer[0], buffer.size()));
+    if (!size.ok()) std::exit(1);
+    benchmark::DoNotOptimize(buffer);
+  }
+  state.SetBytesProcessed(state.iterations() * plaintext.size());
+}
+
+void RunDecrypt(Aead& aead, benchmark::State& state) {
+  std::string plaintext = subtle::Random::GetRandomBytes(state.range(0));
+  auto ciphertext = aead.Encrypt(plaintext, kAssociatedData);
+  if (!ciphertext.ok()) std::exit(1);
+  for (auto _ : state) {
+    auto decrypted = aead.Decrypt(ciphertext.ValueOrDie(), kAssociatedData);
+    if (!decrypted.ok()) std::exit(1);
+    benchmark::DoNotOptimize(decrypted);
+  }
+  state.SetBytesProcessed(state.iterations() * plaintext.size());
+}
+
+void BM_AesGcmEncryptInto(benchmark::State& state) {
+  RunEncryptInto(GetAesGcm(), state);
+}
+BENCHMARK(BM_AesGcmEncryptInto)->Arg(64)->Arg(1 << 10)->Arg(1 << 14)
+    ->Arg(1 << 20);
+
+void BM_XChacha20Poly1305EncryptInto(benchmark::State& state) {
+  RunEncryptInto(GetXChacha20Poly1305(), state);
+}
+BENCHMARK(BM_XChacha20Poly1305EncryptInto)->Arg(64)->Arg(1 << 10)
+    ->Arg(1 << 14)->Arg(1 << 20);
+
+void BM_AesGcmDecrypt(benchmark::State& state) {
+  RunDecrypt(GetAesGcm(), state);
+}
+BENCHMARK(BM_AesGcmDecrypt)->Arg(64)->Arg(1 << 10)->Arg(1 << 14)
+    ->Arg(1 << 20);
+
+void BM_XChacha20Poly1305Decrypt(benchmark::State& state) {
+  RunDecrypt(GetXChacha20Poly1305(), state);
+}
+BENCHMARK(BM_XChacha20Poly1305Decrypt)->Arg(64)->Arg(1 << 10)->Arg(1 << 14)
+    ->Arg(1 << 20);
+
+}  // namespace
+}  // namespace tink
+}  // namespace crypto
+
+BENCHMARK_MAIN();
@@ -0,0 +1,239 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Benchmarks for the DeterministicAead primitive. Run with:
+//   bazel run -c opt //benchmarks:daead_benchmark
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "tink/daead/deterministic_aead_config.h"
+#include "tink/daead/deterministic_aead_key_templates.h"
+#include "tink/deterministic_aead.h"
+#include "tink/keyset_handle.h"
+#include "tink/keyset_manager.h"
+#include "tink/subtle/aes_siv_boringssl.h"
+#include "tink/subtle/random.h"
+#include "tink/util/secret_data.h"
+
+namespace crypto {
+namespace tink {
+namespace {
+
+constexpr char kAssociatedData[] = "associated data";
+
+DeterministicAead& GetDaead() {
+  static DeterministicAead* daead = [] {
+    auto status = DeterministicAeadConfig::Register();
+    if (!status.ok()) {
+      std::cerr << status.error_message() << std::endl;
+      std::exit(1);
+    }
+    auto handle =
+        KeysetHandle::GenerateNew(DeterministicAeadKeyTemplates::Aes256Siv());
+    if (!handle.ok()) {
+      std::cerr << handle.status().error_message() << std::endl;
+      std::exit(1);
+    }
+    auto daead_result =
+        handle.ValueOrDie()->GetPrimitive<DeterministicAead>();
+    if (!daead_result.ok()) {
+      std::cerr << daead_result.status().error_message() << std::endl;
+      std::exit(1);
+    }
+    return daead_result.ValueOrDie().release();
+  }();
+  return *daead;
+}
+
+// A DeterministicAead whose keyset went through several key rotations, so
+// decryption has to dispatch among many keys by ciphertext prefix.
+DeterministicAead& GetMultiKeyDaead() {
+  static DeterministicAead* daead = [] {
+    auto status = DeterministicAeadConfig::Register();
+    if (!status.ok()) {
+      std::cerr << status.error_message() << std::endl;
+      std::exit(1);
+    }
+    auto manager_result =
+        KeysetManager::New(DeterministicAeadKeyTemplates::Aes256Siv());
+    if (!manager_result.ok()) {
+      std::cerr << manager_result.status().error_message() << std::endl;
+      std::exit(1);
+    }
+    auto manager = std::move(manager_result.ValueOrDie());
+    for (int i = 0; i < 9; i++) {
+      auto rotate_result =
+          manager->Rotate(DeterministicAeadKeyTemplates::Aes256Siv());
+      if (!rotate_result.ok()) std::exit(1);
+    }
+    auto daead_result =
+        manager->GetKeysetHandle()->GetPrimitive<DeterministicAead>();
+    if (!daead_result.ok()) {
+      std::cerr << daead_result.status().error_message() << std::endl;
+      std::exit(1);
+    }
+    return daead_result.ValueOrDie().release();
+  }();
+  return *daead;
+}
+
+void BM_EncryptDeterministically(benchmark::State& state) {
+  DeterministicAead& daead = GetDaead();
+  std::string plaintext = subtle::Random::GetRandomBytes(state.range(0));
+  for (auto _ : state) {
+    auto ciphertext =
+        daead.EncryptDeterministically(plaintext, kAssociatedData);
+    if (!ciphertext.ok()) std::exit(1);
+    benchmark::DoNotOptimize(ciphertext);
+  }
+  state.SetBytesProcessed(state.iterations() * plaintext.size());
+}
+BENCHMARK(BM_EncryptDeterministically)
+    ->Arg(64)
+    ->Arg(1 << 10)
+    ->Arg(1 << 14)
+    ->Arg(1 << 20);
+
+void BM_EncryptDeterministicallyInto(benchmark::State& state) {
+  DeterministicAead& daead = GetDaead();
+  std::string plaintext = subtle::Random::GetRandomBytes(state.range(0));
+  std::string buffer(daead.MaxEncryptionSize(plaintext.size()), '\0');
+  for (auto _ : state) {
+    auto size = daead.EncryptDeterministicallyInto(
+        plaintext, kAssociatedData, absl::MakeSpan(&buffer[0], buffer.size()));
+    if (!size.ok()) std::exit(1);
+    benchmark::DoNotOptimize(buffer.data());
+  }
+  state.SetBytesProcessed(state.iterations() * plaintext.size());
+}
+BENCHMARK(BM_EncryptDeterministicallyInto)
+    ->Arg(64)
+    ->Arg(1 << 10)
+    ->Arg(1 << 14)
+    ->Arg(1 << 20);
+
+void BM_DecryptDeterministically(benchmark::State& state) {
+  DeterministicAead& daead = GetDaead();
+  std::string plaintext = subtle::Random::GetRandomBytes(state.range(0));
+  std::string ciphertext =
+      daead.EncryptDeterministically(plaintext, kAssociatedData).ValueOrDie();
+  for (auto _ : state) {
+    auto decrypted =
+        daead.DecryptDeterministically(ciphertext, kAssociatedData);
+    if (!decrypted.ok()) std::exit(1);
+    benchmark::DoNotOptimize(decrypted);
+  }
+  state.SetBytesProcessed(state.iterations() * plaintext.size());
+}
+BENCHMARK(BM_DecryptDeterministically)
+    ->Arg(64)
+    ->Arg(1 << 10)
+    ->Arg(1 << 14)
+    ->Arg(1 << 20);
+
+// A bare AES-SIV without the keyset wrapper, for measuring the columnar
+// batch API against per-value calls.
+DeterministicAead& GetAesSiv() {
+  static DeterministicAead* daead = [] {
+    util::SecretData key =
+        util::SecretDataFromStringView(subtle::Random::GetRandomBytes(64));
+    auto result = subtle::AesSivBoringSsl::New(key);
+    if (!result.ok()) {
+      std::cerr << result.status().error_message() << std::endl;
+      std::exit(1);
+    }
+    return result.ValueOrDie().release();
+  }();
+  return *daead;
+}
+
+// Encrypts a column of 16-byte values one virtual call at a time; the
+// baseline for BM_ColumnEncryptBatch below.
+void BM_ColumnEncryptPerValue(benchmark::State& state) {
+  DeterministicAead& daead = GetAesSiv();
+  const int num_values = state.range(0);
+  std::vector<std::string> values;
+  for (int i = 0; i < num_values; i++) {
+    values.push_back(subtle::Random::GetRandomBytes(16));
+  }
+  std::string buffer(num_values * daead.MaxEncryptionSize(16), '\0');
+  for (auto _ : state) {
+    size_t offset = 0;
+    for (const std::string& value : values) {
+      auto size = daead.EncryptDeterministicallyInto(
+          value, kAssociatedData,
+          absl::MakeSpan(&buffer[offset], buffer.size() - offset));
+      if (!size.ok()) std::exit(1);
+      offset += size.ValueOrDie();
+    }
+    benchmark::DoNotOptimize(buffer.data());
+  }
+  state.SetItemsProcessed(state.iterations() * num_values);
+}
+BENCHMARK(BM_ColumnEncryptPerValue)->Arg(1 << 10)->Arg(1 << 14);
+
+// Encrypts the same column with one batch call; the S2V state for the
+// shared associated data is computed once for the whole column.
+void BM_ColumnEncryptBatch(benchmark::State& state) {
+  DeterministicAead& daead = GetAesSiv();
+  const int num_values = state.range(0);
+  std::vector<std::string> values;
+  for (int i = 0; i < num_values; i++) {
+    values.push_back(subtle::Random::GetRandomBytes(16));
+  }
+  std::vector<absl::string_view> plaintexts(values.begin(), values.end());
+  std::string buffer(num_values * daead.MaxEncryptionSize(16), '\0');
+  std::vector<size_t> ciphertext_sizes(num_values);
+  for (auto _ : state) {
+    auto written = daead.EncryptDeterministicallyBatch(
+        absl::MakeSpan(plaintexts), kAssociatedData,
+        absl::MakeSpan(&buffer[0], buffer.size()),
+        absl::MakeSpan(ciphertext_sizes));
+    if (!written.ok()) std::exit(1);
+    benchmark::DoNotOptimize(buffer.data());
+  }
+  state.SetItemsProcessed(state.iterations() * num_values);
+}
+BENCHMARK(BM_ColumnEncryptBatch)->Arg(1 << 10)->Arg(1 << 14);
+
+// Measures the wrapper's key-id dispatch: the ciphertext carries the
+// primary's prefix, and nine stale keys share the keyset.
+void BM_DecryptDeterministicallyMultiKey(benchmark::State& state) {
+  DeterministicAead& daead = GetMultiKeyDaead();
+  std::string plaintext = subtle::Random::GetRandomBytes(state.range(0));
+  std::string ciphertext =
+      daead.EncryptDeterministically(plaintext, kAssociatedData).ValueOrDie();
+  for (auto _ : state) {
+    auto decrypted =
+        daead.DecryptDeterministically(ciphertext, kAssociatedData);
+    if (!decrypted.ok()) std::exit(1);
+    benchmark::DoNotOptimize(decrypted);
+  }
+  state.SetBytesProcessed(state.iterations() * plaintext.size());
+}
+BENCHMARK(BM_DecryptDeterministicallyMultiKey)->Arg(64)->Arg(1 << 10);
+
+}  // namespace
+}  // namespace tink
+}  // namespace crypto
+
+BENCHMARK_MAIN();
@@ -0,0 +1,201 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Benchmarks for the EncryptedFile utility, which composes the fast paths
+// of the streaming stack (memory-mapped ciphertext with kernel readahead,
+// background segment readahead, plaintext-segment LRU cache, pooled
+// buffers) behind a pread-style interface. The read benchmarks report the
+// end-to-end plaintext throughput including file open and stream setup;
+// on warm page cache they should approach the raw streaming decryption
+// rate, and on cold storage the device's sequential read rate. Run with:
+//   bazel run -c opt //benchmarks:encrypted_file_benchmark
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "benchmark/benchmark.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "tink/output_stream.h"
+#include "tink/streaming_aead.h"
+#include "tink/streamingaead/encrypted_file.h"
+#include "tink/subtle/aes_gcm_hkdf_streaming.h"
+#include "tink/subtle/common_enums.h"
+#include "tink/subtle/random.h"
+#include "tink/util/buffer.h"
+#include "tink/util/secret_data.h"
+
+namespace crypto {
+namespace tink {
+namespace {
+
+constexpr char kAssociatedData[] = "associated data";
+constexpr int kCiphertextSegmentSize = 1 << 20;  // 1 MB
+constexpr int kReadChunkSize = 1 << 16;          // 64 KB preads
+
+std::string TmpFilename(absl::string_view name) {
+  const char* dir = getenv("TEST_TMPDIR");
+  if (dir == nullptr) dir = "/tmp";
+  return absl::StrCat(dir, "/", name, ".", getpid());
+}
+
+std::shared_ptr<StreamingAead> GetStreamingAead() {
+  static std::shared_ptr<StreamingAead>* streaming_aead = [] {
+    subtle::AesGcmHkdfStreaming::Params params;
+    params.ikm =
+        util::SecretDataFromStringView(subtle::Random::GetRandomBytes(32));
+    params.hkdf_hash = subtle::SHA256;
+    params.derived_key_size = 32;
+    params.ciphertext_segment_size = kCiphertextSegmentSize;
+    params.ciphertext_offset = 0;
+    auto result = subtle::AesGcmHkdfStreaming::New(std::move(params));
+    if (!result.ok()) {
+      std::cerr << result.status().error_message() << std::endl;
+      std::exit(1);
+    }
+    return new std::shared_ptr<StreamingAead>(
+        std::move(result.ValueOrDie()));
+  }();
+  return *streaming_aead;
+}
+
+// Writes 'size' random bytes encrypted to a temp file; returns the filename.
+std::string WriteEncryptedFile(int64_t size) {
+  std::string filename = TmpFilename("encrypted_file_benchmark");
+  auto writer_result = streamingaead::EncryptedFile::NewWriter(
+      filename, GetStreamingAead(), kAssociatedData);
+  if (!writer_result.ok()) std::exit(1);
+  auto writer = std::move(writer_result.ValueOrDie());
+  std::string plaintext = subtle::Random::GetRandomBytes(size);
+  size_t pos = 0;
+  while (pos < plaintext.size()) {
+    void* buffer;
+    auto next_result = writer->Next(&buffer);
+    if (!next_result.ok()) std::exit(1);
+    size_t available = next_result.ValueOrDie();
+    size_t to_copy = std::min(available, plaintext.size() - pos);
+    std::memcpy(buffer, plaintext.data() + pos, to_copy);
+    if (to_copy < available) writer->BackUp(available - to_copy);
+    pos += to_copy;
+  }
+  if (!writer->Close().ok()) std::exit(1);
+  return filename;
+}
+
+streamingaead::EncryptedFile::Options FastPathOptions() {
+  streamingaead::EncryptedFile::Options options;
+  options.readahead_segments = 4;
+  options.readahead_workers = 2;
+  options.pread_workers = 2;
+  options.plaintext_cache_max_bytes = 8 * kCiphertextSegmentSize;
+  return options;
+}
+
+// Sequential scan of the whole file in 64 KB preads, including open and
+// stream setup per iteration. The argument is the plaintext size.
+void BM_EncryptedFileSequentialRead(benchmark::State& state) {
+  std::string filename = WriteEncryptedFile(state.range(0));
+  auto buffer = std::move(util::Buffer::New(kReadChunkSize).ValueOrDie());
+  for (auto _ : state) {
+    auto file_result = streamingaead::EncryptedFile::OpenForRead(
+        filename, GetStreamingAead(), kAssociatedData, FastPathOptions());
+    if (!file_result.ok()) std::exit(1);
+    auto file = std::move(file_result.ValueOrDie());
+    int64_t position = 0;
+    while (position < state.range(0)) {
+      auto status = file->PRead(position, kReadChunkSize, buffer.get());
+      if (!status.ok() &&
+          status.error_code() != util::error::OUT_OF_RANGE) {
+        std::exit(1);
+      }
+      position += buffer->size();
+    }
+    benchmark::DoNotOptimize(position);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+  unlink(filename.c_str());
+}
+BENCHMARK(BM_EncryptedFileSequentialRead)->Arg(1 << 20)->Arg(1 << 26);
+
+// Repeated 4 KB preads at pseudo-random positions of one open file; with
+// the plaintext cache covering the file, steady state is a map lookup and
+// a copy per read.
+void BM_EncryptedFileRandomRead(benchmark::State& state) {
+  const int64_t file_size = state.range(0);
+  std::string filename = WriteEncryptedFile(file_size);
+  auto file_result = streamingaead::EncryptedFile::OpenForRead(
+      filename, GetStreamingAead(), kAssociatedData, FastPathOptions());
+  if (!file_result.ok()) std::exit(1);
+  auto file = std::move(file_result.ValueOrDie());
+  constexpr int kRandomReadSize = 4096;
+  auto buffer = std::move(util::Buffer::New(kRandomReadSize).ValueOrDie());
+  uint64_t rng_state = 1;
+  for (auto _ : state) {
+    // Cheap xorshift; the positions just need to spread over the file.
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    int64_t position = rng_state % (file_size - kRandomReadSize);
+    auto status = file->PRead(position, kRandomReadSize, buffer.get());
+    if (!status.ok()) std::exit(1);
+    benchmark::DoNotOptimize(buffer->get_mem_block());
+  }
+  state.SetBytesProcessed(state.iterations() * kRandomReadSize);
+  unlink(filename.c_str());
+}
+BENCHMARK(BM_EncryptedFileRandomRead)->Arg(1 << 24);
+
+// Streaming write of the whole file through NewWriter, including file
+// creation and Close() per iteration. The argument is the plaintext size.
+void BM_EncryptedFileWrite(benchmark::State& state) {
+  std::string plaintext = subtle::Random::GetRandomBytes(state.range(0));
+  std::string filename = TmpFilename("encrypted_file_benchmark_write");
+  for (auto _ : state) {
+    auto writer_result = streamingaead::EncryptedFile::NewWriter(
+        filename, GetStreamingAead(), kAssociatedData);
+    if (!writer_result.ok()) std::exit(1);
+    auto writer = std::move(writer_result.ValueOrDie());
+    size_t pos = 0;
+    while (pos < plaintext.size()) {
+      void* buffer;
+      auto next_result = writer->Next(&buffer);
+      if (!next_result.ok()) std::exit(1);
+      size_t available = next_result.ValueOrDie();
+      size_t to_copy = std::min(available, plaintext.size() - pos);
+      std::memcpy(buffer, plaintext.data() + pos, to_copy);
+      if (to_copy < available) writer->BackUp(available - to_copy);
+      pos += to_copy;
+    }
+    if (!writer->Close().ok()) std::exit(1);
+  }
+  state.SetBytesProcessed(state.iterations() * plaintext.size());
+  unlink(filename.c_str());
+}
+BENCHMARK(BM_EncryptedFileWrite)->Arg(1 << 20)->Arg(1 << 26);
+
+}  // namespace
+}  // namespace tink
+}  // namespace crypto
+
+BENCHMARK_MAIN();
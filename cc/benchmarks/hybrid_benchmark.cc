@@ -0,0 +1,112 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Benchmarks for the HybridEncrypt/HybridDecrypt primitives. Run with:
+//   bazel run -c opt //benchmarks:hybrid_benchmark
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "tink/hybrid/hybrid_config.h"
+#include "tink/hybrid/hybrid_key_templates.h"
+#include "tink/hybrid_decrypt.h"
+#include "tink/hybrid_encrypt.h"
+#include "tink/keyset_handle.h"
+#include "tink/subtle/random.h"
+
+namespace crypto {
+namespace tink {
+namespace {
+
+constexpr char kContextInfo[] = "context info";
+
+// Holds a matching encrypter/decrypter pair for
+// EciesP256HkdfHmacSha256Aes128Gcm.
+struct HybridBundle {
+  std::unique_ptr<HybridEncrypt> encrypter;
+  std::unique_ptr<HybridDecrypt> decrypter;
+};
+
+HybridBundle& GetBundle() {
+  static HybridBundle* bundle = [] {
+    auto status = HybridConfig::Register();
+    if (!status.ok()) {
+      std::cerr << status.error_message() << std::endl;
+      std::exit(1);
+    }
+    auto handle = KeysetHandle::GenerateNew(
+        HybridKeyTemplates::EciesP256HkdfHmacSha256Aes128Gcm());
+    if (!handle.ok()) {
+      std::cerr << handle.status().error_message() << std::endl;
+      std::exit(1);
+    }
+    auto public_handle = handle.ValueOrDie()->GetPublicKeysetHandle();
+    if (!public_handle.ok()) {
+      std::cerr << public_handle.status().error_message() << std::endl;
+      std::exit(1);
+    }
+    auto encrypter =
+        public_handle.ValueOrDie()->GetPrimitive<HybridEncrypt>();
+    if (!encrypter.ok()) {
+      std::cerr << encrypter.status().error_message() << std::endl;
+      std::exit(1);
+    }
+    auto decrypter = handle.ValueOrDie()->GetPrimitive<HybridDecrypt>();
+    if (!decrypter.ok()) {
+      std::cerr << decrypter.status().error_message() << std::endl;
+      std::exit(1);
+    }
+    auto* result = new HybridBundle();
+    result->encrypter = std::move(encrypter.ValueOrDie());
+    result->decrypter = std::move(decrypter.ValueOrDie());
+    return result;
+  }();
+  return *bundle;
+}
+
+void BM_HybridEncrypt(benchmark::State& state) {
+  HybridBundle& bundle = GetBundle();
+  std::string plaintext = subtle::Random::GetRandomBytes(state.range(0));
+  for (auto _ : state) {
+    auto ciphertext = bundle.encrypter->Encrypt(plaintext, kContextInfo);
+    if (!ciphertext.ok()) std::exit(1);
+    benchmark::DoNotOptimize(ciphertext);
+  }
+  state.SetBytesProcessed(state.iterations() * plaintext.size());
+}
+BENCHMARK(BM_HybridEncrypt)->Arg(64)->Arg(1 << 10)->Arg(1 << 20);
+
+void BM_HybridDecrypt(benchmark::State& state) {
+  HybridBundle& bundle = GetBundle();
+  std::string plaintext = subtle::Random::GetRandomBytes(state.range(0));
+  std::string ciphertext =
+      bundle.encrypter->Encrypt(plaintext, kContextInfo).ValueOrDie();
+  for (auto _ : state) {
+    auto decrypted = bundle.decrypter->Decrypt(ciphertext, kContextInfo);
+    if (!decrypted.ok()) std::exit(1);
+    benchmark::DoNotOptimize(decrypted);
+  }
+  state.SetBytesProcessed(state.iterations() * plaintext.size());
+}
+BENCHMARK(BM_HybridDecrypt)->Arg(64)->Arg(1 << 10)->Arg(1 << 20);
+
+}  // namespace
+}  // namespace tink
+}  // namespace crypto
+
+BENCHMARK_MAIN();
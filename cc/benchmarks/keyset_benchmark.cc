@@ -0,0 +1,154 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Benchmarks for keyset I/O: parsing serialized keysets and turning them into
+// wrapped primitives. Run with:
+//   bazel run -c opt //benchmarks:keyset_benchmark
+
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "google/protobuf/arena.h"
+#include "absl/memory/memory.h"
+#include "tink/aead.h"
+#include "tink/aead/aead_config.h"
+#include "tink/aead/aead_key_templates.h"
+#include "tink/binary_keyset_reader.h"
+#include "tink/binary_keyset_writer.h"
+#include "tink/cleartext_keyset_handle.h"
+#include "tink/json_keyset_reader.h"
+#include "tink/json_keyset_writer.h"
+#include "tink/keyset_handle.h"
+#include "tink/keyset_manager.h"
+
+namespace crypto {
+namespace tink {
+namespace {
+
+// A serialized cleartext keyset with three AES128-GCM keys, as produced by a
+// couple of key rotations.
+const std::string& GetSerializedKeyset() {
+  static const std::string* serialized = [] {
+    auto status = AeadConfig::Register();
+    if (!status.ok()) {
+      std::cerr << status.error_message() << std::endl;
+      std::exit(1);
+    }
+    auto manager_result = KeysetManager::New(AeadKeyTemplates::Aes128Gcm());
+    if (!manager_result.ok()) {
+      std::cerr << manager_result.status().error_message() << std::endl;
+      std::exit(1);
+    }
+    auto manager = std::move(manager_result.ValueOrDie());
+    for (int i = 0; i < 2; i++) {
+      auto rotate_result = manager->Rotate(AeadKeyTemplates::Aes128Gcm());
+      if (!rotate_result.ok()) std::exit(1);
+    }
+    auto handle = manager->GetKeysetHandle();
+    return new std::string(
+        CleartextKeysetHandle::GetKeyset(*handle).SerializeAsString());
+  }();
+  return *serialized;
+}
+
+// The same keyset in JSON format.
+const std::string& GetJsonKeyset() {
+  static const std::string* json = [] {
+    auto reader = BinaryKeysetReader::New(GetSerializedKeyset()).ValueOrDie();
+    auto handle = CleartextKeysetHandle::Read(std::move(reader)).ValueOrDie();
+    auto destination = absl::make_unique<std::stringstream>();
+    auto* buffer = destination.get();
+    auto writer = JsonKeysetWriter::New(std::move(destination)).ValueOrDie();
+    auto status = CleartextKeysetHandle::Write(writer.get(), *handle);
+    if (!status.ok()) std::exit(1);
+    return new std::string(buffer->str());
+  }();
+  return *json;
+}
+
+void BM_BinaryKeysetRead(benchmark::State& state) {
+  const std::string& serialized = GetSerializedKeyset();
+  for (auto _ : state) {
+    auto reader = BinaryKeysetReader::New(serialized).ValueOrDie();
+    auto keyset = reader->Read();
+    if (!keyset.ok()) std::exit(1);
+    benchmark::DoNotOptimize(keyset);
+  }
+  state.SetBytesProcessed(state.iterations() * serialized.size());
+}
+BENCHMARK(BM_BinaryKeysetRead);
+
+void BM_BinaryKeysetReadIntoArena(benchmark::State& state) {
+  const std::string& serialized = GetSerializedKeyset();
+  for (auto _ : state) {
+    google::protobuf::Arena arena;
+    auto reader = BinaryKeysetReader::New(serialized).ValueOrDie();
+    auto keyset = reader->ReadIntoArena(&arena);
+    if (!keyset.ok()) std::exit(1);
+    benchmark::DoNotOptimize(keyset);
+  }
+  state.SetBytesProcessed(state.iterations() * serialized.size());
+}
+BENCHMARK(BM_BinaryKeysetReadIntoArena);
+
+void BM_JsonKeysetRead(benchmark::State& state) {
+  const std::string& json = GetJsonKeyset();
+  for (auto _ : state) {
+    auto reader = JsonKeysetReader::New(json).ValueOrDie();
+    auto keyset = reader->Read();
+    if (!keyset.ok()) std::exit(1);
+    benchmark::DoNotOptimize(keyset);
+  }
+  state.SetBytesProcessed(state.iterations() * json.size());
+}
+BENCHMARK(BM_JsonKeysetRead);
+
+void BM_BinaryKeysetWrite(benchmark::State& state) {
+  const std::string& serialized = GetSerializedKeyset();
+  auto reader = BinaryKeysetReader::New(serialized).ValueOrDie();
+  auto handle = CleartextKeysetHandle::Read(std::move(reader)).ValueOrDie();
+  for (auto _ : state) {
+    auto destination = absl::make_unique<std::stringstream>();
+    auto writer =
+        BinaryKeysetWriter::New(std::move(destination)).ValueOrDie();
+    auto status = CleartextKeysetHandle::Write(writer.get(), *handle);
+    if (!status.ok()) std::exit(1);
+  }
+  state.SetBytesProcessed(state.iterations() * serialized.size());
+}
+BENCHMARK(BM_BinaryKeysetWrite);
+
+void BM_ReadKeysetAndGetPrimitive(benchmark::State& state) {
+  const std::string& serialized = GetSerializedKeyset();
+  for (auto _ : state) {
+    auto reader = BinaryKeysetReader::New(serialized).ValueOrDie();
+    auto handle_result = CleartextKeysetHandle::Read(std::move(reader));
+    if (!handle_result.ok()) std::exit(1);
+    auto aead = handle_result.ValueOrDie()->GetPrimitive<Aead>();
+    if (!aead.ok()) std::exit(1);
+    benchmark::DoNotOptimize(aead);
+  }
+}
+BENCHMARK(BM_ReadKeysetAndGetPrimitive);
+
+}  // namespace
+}  // namespace tink
+}  // namespace crypto
+
+BENCHMARK_MAIN();
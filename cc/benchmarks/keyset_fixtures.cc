@@ -0,0 +1,86 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "benchmarks/keyset_fixtures.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <utility>
+
+#include "tink/aead/aead_config.h"
+#include "tink/aead/aead_key_templates.h"
+#include "tink/keyset_manager.h"
+#include "tink/mac/mac_config.h"
+#include "tink/mac/mac_key_templates.h"
+#include "tink/streamingaead/streaming_aead_config.h"
+#include "tink/streamingaead/streaming_aead_key_templates.h"
+#include "tink/util/status.h"
+
+namespace crypto {
+namespace tink {
+namespace benchmarks {
+
+using google::crypto::tink::KeyTemplate;
+using google::crypto::tink::OutputPrefixType;
+
+namespace {
+
+void ExitOnError(const util::Status& status) {
+  if (!status.ok()) {
+    std::cerr << status.error_message() << std::endl;
+    std::exit(1);
+  }
+}
+
+// Builds a keyset by generating 'num_keys' keys from 'key_template' and
+// rotating after each one, so the last key is primary.
+std::unique_ptr<KeysetHandle> KeysetOrDie(const KeyTemplate& key_template,
+                                          int num_keys) {
+  auto manager_result = KeysetManager::New(key_template);
+  ExitOnError(manager_result.status());
+  auto manager = std::move(manager_result.ValueOrDie());
+  for (int i = 1; i < num_keys; i++) {
+    ExitOnError(manager->Rotate(key_template).status());
+  }
+  return manager->GetKeysetHandle();
+}
+
+}  // namespace
+
+std::unique_ptr<KeysetHandle> AeadKeysetOrDie(int num_keys,
+                                              OutputPrefixType prefix_type) {
+  ExitOnError(AeadConfig::Register());
+  KeyTemplate key_template = AeadKeyTemplates::Aes128Gcm();
+  key_template.set_output_prefix_type(prefix_type);
+  return KeysetOrDie(key_template, num_keys);
+}
+
+std::unique_ptr<KeysetHandle> MacKeysetOrDie(int num_keys,
+                                             OutputPrefixType prefix_type) {
+  ExitOnError(MacConfig::Register());
+  KeyTemplate key_template = MacKeyTemplates::HmacSha256();
+  key_template.set_output_prefix_type(prefix_type);
+  return KeysetOrDie(key_template, num_keys);
+}
+
+std::unique_ptr<KeysetHandle> StreamingAeadKeysetOrDie(int num_keys) {
+  ExitOnError(StreamingAeadConfig::Register());
+  return KeysetOrDie(StreamingAeadKeyTemplates::Aes128GcmHkdf4KB(), num_keys);
+}
+
+}  // namespace benchmarks
+}  // namespace tink
+}  // namespace crypto
@@ -0,0 +1,58 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_BENCHMARKS_KEYSET_FIXTURES_H_
+#define TINK_BENCHMARKS_KEYSET_FIXTURES_H_
+
+#include <memory>
+
+#include "tink/keyset_handle.h"
+#include "proto/tink.pb.h"
+
+namespace crypto {
+namespace tink {
+namespace benchmarks {
+
+// Generators for representative keysets, so that benchmarks of the
+// wrapped-primitive hot paths sweep the shapes that occur in production:
+// a single key, a keyset mid-rotation, and a large legacy keyset, each with
+// RAW and TINK output prefixes. The key material is freshly generated, but
+// the geometry of the keyset (key count, prefix types, last key primary)
+// is fixed, which is what the wrapping cost depends on.
+//
+// The generators register the config of their primitive and exit the
+// process on failure, like the other fixtures in this package; they must
+// only be used in benchmark binaries.
+
+// Returns a keyset of 'num_keys' AES128-GCM keys that all use 'prefix_type';
+// the last generated key is primary.
+std::unique_ptr<KeysetHandle> AeadKeysetOrDie(
+    int num_keys, google::crypto::tink::OutputPrefixType prefix_type);
+
+// Returns a keyset of 'num_keys' HMAC-SHA256 keys that all use 'prefix_type';
+// the last generated key is primary.
+std::unique_ptr<KeysetHandle> MacKeysetOrDie(
+    int num_keys, google::crypto::tink::OutputPrefixType prefix_type);
+
+// Returns a keyset of 'num_keys' AES128-GCM-HKDF-4KB streaming keys; the
+// last generated key is primary. Streaming keys always use RAW prefixes.
+std::unique_ptr<KeysetHandle> StreamingAeadKeysetOrDie(int num_keys);
+
+}  // namespace benchmarks
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_BENCHMARKS_KEYSET_FIXTURES_H_
@@ -0,0 +1,85 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Benchmarks for the Mac primitive. Run with:
+//   bazel run -c opt //benchmarks:mac_benchmark
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "tink/keyset_handle.h"
+#include "tink/mac.h"
+#include "tink/mac/mac_config.h"
+#include "tink/mac/mac_key_templates.h"
+#include "tink/subtle/random.h"
+
+namespace crypto {
+namespace tink {
+namespace {
+
+Mac& GetMac() {
+  static Mac* mac = [] {
+    auto status = MacConfig::Register();
+    if (!status.ok()) {
+      std::cerr << status.error_message() << std::endl;
+      std::exit(1);
+    }
+    auto handle = KeysetHandle::GenerateNew(MacKeyTemplates::HmacSha256());
+    if (!handle.ok()) {
+      std::cerr << handle.status().error_message() << std::endl;
+      std::exit(1);
+    }
+    auto mac_result = handle.ValueOrDie()->GetPrimitive<Mac>();
+    if (!mac_result.ok()) {
+      std::cerr << mac_result.status().error_message() << std::endl;
+      std::exit(1);
+    }
+    return mac_result.ValueOrDie().release();
+  }();
+  return *mac;
+}
+
+void BM_ComputeMac(benchmark::State& state) {
+  Mac& mac = GetMac();
+  std::string data = subtle::Random::GetRandomBytes(state.range(0));
+  for (auto _ : state) {
+    auto tag = mac.ComputeMac(data);
+    if (!tag.ok()) std::exit(1);
+    benchmark::DoNotOptimize(tag);
+  }
+  state.SetBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_ComputeMac)->Arg(64)->Arg(1 << 10)->Arg(1 << 14)->Arg(1 << 20);
+
+void BM_VerifyMac(benchmark::State& state) {
+  Mac& mac = GetMac();
+  std::string data = subtle::Random::GetRandomBytes(state.range(0));
+  std::string tag = mac.ComputeMac(data).ValueOrDie();
+  for (auto _ : state) {
+    auto status = mac.VerifyMac(tag, data);
+    if (!status.ok()) std::exit(1);
+  }
+  state.SetBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_VerifyMac)->Arg(64)->Arg(1 << 10)->Arg(1 << 14)->Arg(1 << 20);
+
+}  // namespace
+}  // namespace tink
+}  // namespace crypto
+
+BENCHMARK_MAIN();
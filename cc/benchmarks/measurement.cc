@@ -0,0 +1,106 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "benchmarks/measurement.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sched.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstring>
+#endif
+
+#include <chrono>  // NOLINT(build/c++11)
+
+namespace crypto {
+namespace tink {
+namespace benchmarks {
+
+bool PinBenchmarkThread() {
+#if defined(__linux__)
+  int cpu = sched_getcpu();
+  if (cpu == -1) return false;
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  CPU_SET(cpu, &cpu_set);
+  return sched_setaffinity(0, sizeof(cpu_set), &cpu_set) == 0;
+#else
+  return false;
+#endif
+}
+
+void WarmUp(const std::function<void()>& op) {
+  auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+  do {
+    op();
+  } while (std::chrono::steady_clock::now() < deadline);
+}
+
+CycleCounter::CycleCounter() : fd_(-1) {
+#if defined(__linux__)
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.size = sizeof(attr);
+  attr.config = PERF_COUNT_HW_CPU_CYCLES;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  fd_ = syscall(__NR_perf_event_open, &attr, /* pid = */ 0, /* cpu = */ -1,
+                /* group_fd = */ -1, /* flags = */ 0);
+#endif
+}
+
+CycleCounter::~CycleCounter() {
+#if defined(__linux__)
+  if (fd_ != -1) close(fd_);
+#endif
+}
+
+void CycleCounter::Start() {
+#if defined(__linux__)
+  if (fd_ == -1) return;
+  ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+  ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+}
+
+uint64_t CycleCounter::Stop() {
+#if defined(__linux__)
+  if (fd_ == -1) return 0;
+  ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+  uint64_t cycles = 0;
+  if (read(fd_, &cycles, sizeof(cycles)) != sizeof(cycles)) return 0;
+  return cycles;
+#else
+  return 0;
+#endif
+}
+
+void CycleCounter::StopAndReport(benchmark::State* state, int64_t bytes) {
+  uint64_t cycles = Stop();
+  if (cycles == 0 || bytes <= 0) return;
+  state->counters["cycles_per_byte"] =
+      static_cast<double>(cycles) / static_cast<double>(bytes);
+}
+
+}  // namespace benchmarks
+}  // namespace tink
+}  // namespace crypto
@@ -0,0 +1,84 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_BENCHMARKS_MEASUREMENT_H_
+#define TINK_BENCHMARKS_MEASUREMENT_H_
+
+#include <cstdint>
+#include <functional>
+
+#include "benchmark/benchmark.h"
+
+namespace crypto {
+namespace tink {
+namespace benchmarks {
+
+// Helpers that make benchmark numbers stable enough to gate regressions on.
+// Wall time drifts with turbo and thermal state of the machine; cycles/byte
+// from the CPU's cycle counter does not, so a few percent of regression in a
+// hot path stays visible above the noise. Intended use in a benchmark:
+//
+//   PinBenchmarkThread();
+//   WarmUp([&]() { /* one untimed operation */ });
+//   CycleCounter cycles;
+//   cycles.Start();
+//   for (auto _ : state) { /* timed operation */ }
+//   cycles.StopAndReport(&state, state.iterations() * data.size());
+
+// Pins the calling thread to the CPU it currently runs on, so that the
+// benchmark loop is not migrated between cores with different frequency or
+// cache state. Returns false if pinning is not supported or not permitted;
+// the benchmark still runs, just with more variance.
+bool PinBenchmarkThread();
+
+// Runs 'op' repeatedly, untimed, for a fixed short duration. This brings
+// caches, branch predictors and the core's frequency governor to their
+// steady state before measurement starts.
+void WarmUp(const std::function<void()>& op);
+
+// Counts CPU cycles between Start() and Stop() with a hardware perf counter.
+// Falls back gracefully where perf counters are unavailable (e.g. in
+// containers without perf_event access): ok() returns false and no counter
+// is reported, while the benchmark's wall-time numbers remain valid.
+class CycleCounter {
+ public:
+  CycleCounter();
+  ~CycleCounter();
+
+  // True if the hardware counter could be opened.
+  bool ok() const { return fd_ != -1; }
+
+  // Starts (or restarts) counting.
+  void Start();
+
+  // Stops counting and returns the cycles elapsed since Start(), or 0 if
+  // the counter is unavailable.
+  uint64_t Stop();
+
+  // Stops counting and reports cycles/byte for 'bytes' processed bytes as
+  // the rate-invariant counter "cycles_per_byte" on 'state'. Does nothing
+  // if the counter is unavailable or 'bytes' is not positive.
+  void StopAndReport(benchmark::State* state, int64_t bytes);
+
+ private:
+  int fd_;
+};
+
+}  // namespace benchmarks
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_BENCHMARKS_MEASUREMENT_H_
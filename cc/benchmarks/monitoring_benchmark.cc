@@ -0,0 +1,78 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Overhead of the always-on metrics counters and the wrapper-layer
+// monitoring hooks. The per-thread sharding in RegistryMetrics is what
+// these benchmarks guard: recording must stay a few nanoseconds per call
+// and, because every thread writes only its own cache-line-aligned shard,
+// it must not get slower as threads are added. Run with increasing
+// --benchmark_min_time and thread counts on a many-core machine:
+//   bazel run -c opt //benchmarks:monitoring_benchmark
+//
+// The per-call time of BM_RecordLookup and BM_RecordTrialDecrypt should
+// be a few nanoseconds and essentially flat across the thread range; a
+// per-call time that grows with the thread count means a shared cache
+// line has crept back into the record path.
+
+#include "benchmark/benchmark.h"
+#include "tink/internal/monitoring.h"
+#include "tink/internal/registry_metrics.h"
+
+namespace crypto {
+namespace tink {
+namespace {
+
+void BM_RecordLookup(benchmark::State& state) {
+  auto& metrics = internal::RegistryMetrics::Global();
+  for (auto _ : state) {
+    metrics.RecordLookup(/* found = */ true);
+  }
+}
+BENCHMARK(BM_RecordLookup)->ThreadRange(1, 64);
+
+void BM_RecordTrialDecrypt(benchmark::State& state) {
+  auto& metrics = internal::RegistryMetrics::Global();
+  for (auto _ : state) {
+    metrics.RecordTrialDecrypt(3);
+  }
+}
+BENCHMARK(BM_RecordTrialDecrypt)->ThreadRange(1, 64);
+
+void BM_Snapshot(benchmark::State& state) {
+  auto& metrics = internal::RegistryMetrics::Global();
+  metrics.RecordLookup(/* found = */ true);
+  for (auto _ : state) {
+    auto snapshot = metrics.Snapshot();
+    benchmark::DoNotOptimize(snapshot);
+  }
+}
+BENCHMARK(BM_Snapshot);
+
+// Cost of one wrapper-layer MonitoredOp, including the two clock reads
+// and the thread-local aggregate update. Compiles to a no-op unless
+// TINK_ENABLE_MONITORING is defined.
+void BM_MonitoredOp(benchmark::State& state) {
+  for (auto _ : state) {
+    internal::MonitoredOp op("benchmark.op", /* key_id = */ 42);
+  }
+}
+BENCHMARK(BM_MonitoredOp)->ThreadRange(1, 64);
+
+}  // namespace
+}  // namespace tink
+}  // namespace crypto
+
+BENCHMARK_MAIN();
@@ -0,0 +1,75 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Benchmarks for the PrfSet primitive. Run with:
+//   bazel run -c opt //benchmarks:prf_benchmark
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "tink/keyset_handle.h"
+#include "tink/prf/prf_config.h"
+#include "tink/prf/prf_key_templates.h"
+#include "tink/prf/prf_set.h"
+#include "tink/subtle/random.h"
+
+namespace crypto {
+namespace tink {
+namespace {
+
+constexpr int kOutputLength = 16;
+
+PrfSet& GetPrfSet() {
+  static PrfSet* prf_set = [] {
+    auto status = PrfConfig::Register();
+    if (!status.ok()) {
+      std::cerr << status.error_message() << std::endl;
+      std::exit(1);
+    }
+    auto handle = KeysetHandle::GenerateNew(PrfKeyTemplates::HkdfSha256());
+    if (!handle.ok()) {
+      std::cerr << handle.status().error_message() << std::endl;
+      std::exit(1);
+    }
+    auto prf_result = handle.ValueOrDie()->GetPrimitive<PrfSet>();
+    if (!prf_result.ok()) {
+      std::cerr << prf_result.status().error_message() << std::endl;
+      std::exit(1);
+    }
+    return prf_result.ValueOrDie().release();
+  }();
+  return *prf_set;
+}
+
+void BM_ComputePrimary(benchmark::State& state) {
+  PrfSet& prf_set = GetPrfSet();
+  std::string input = subtle::Random::GetRandomBytes(state.range(0));
+  for (auto _ : state) {
+    auto output = prf_set.ComputePrimary(input, kOutputLength);
+    if (!output.ok()) std::exit(1);
+    benchmark::DoNotOptimize(output);
+  }
+  state.SetBytesProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_ComputePrimary)->Arg(64)->Arg(1 << 10)->Arg(1 << 14)->Arg(1 << 20);
+
+}  // namespace
+}  // namespace tink
+}  // namespace crypto
+
+BENCHMARK_MAIN();
@@ -0,0 +1,150 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Benchmarks for the PublicKeySign/PublicKeyVerify primitives. Run with:
+//   bazel run -c opt //benchmarks:signature_benchmark
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "tink/keyset_handle.h"
+#include "tink/public_key_sign.h"
+#include "tink/public_key_verify.h"
+#include "tink/signature/signature_config.h"
+#include "tink/signature/signature_key_templates.h"
+#include "tink/subtle/random.h"
+
+namespace {
+
+// Number of heap allocations made by this binary, maintained by the
+// operator new replacements below. Signing is allocation-sensitive (output
+// prefix fusion keeps it at a single allocation per signature), so the
+// benchmarks report allocations/op as a regression metric next to the
+// timing numbers.
+std::atomic<int64_t> total_heap_allocations{0};
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+  total_heap_allocations.fetch_add(1, std::memory_order_relaxed);
+  void* ptr = std::malloc(size);
+  if (ptr == nullptr) throw std::bad_alloc();
+  return ptr;
+}
+
+void* operator new[](std::size_t size) {
+  total_heap_allocations.fetch_add(1, std::memory_order_relaxed);
+  void* ptr = std::malloc(size);
+  if (ptr == nullptr) throw std::bad_alloc();
+  return ptr;
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+namespace crypto {
+namespace tink {
+namespace {
+
+// Holds a matching signer/verifier pair for EcdsaP256.
+struct SignatureBundle {
+  std::unique_ptr<PublicKeySign> signer;
+  std::unique_ptr<PublicKeyVerify> verifier;
+};
+
+SignatureBundle& GetBundle() {
+  static SignatureBundle* bundle = [] {
+    auto status = SignatureConfig::Register();
+    if (!status.ok()) {
+      std::cerr << status.error_message() << std::endl;
+      std::exit(1);
+    }
+    auto handle =
+        KeysetHandle::GenerateNew(SignatureKeyTemplates::EcdsaP256());
+    if (!handle.ok()) {
+      std::cerr << handle.status().error_message() << std::endl;
+      std::exit(1);
+    }
+    auto public_handle = handle.ValueOrDie()->GetPublicKeysetHandle();
+    if (!public_handle.ok()) {
+      std::cerr << public_handle.status().error_message() << std::endl;
+      std::exit(1);
+    }
+    auto signer = handle.ValueOrDie()->GetPrimitive<PublicKeySign>();
+    if (!signer.ok()) {
+      std::cerr << signer.status().error_message() << std::endl;
+      std::exit(1);
+    }
+    auto verifier =
+        public_handle.ValueOrDie()->GetPrimitive<PublicKeyVerify>();
+    if (!verifier.ok()) {
+      std::cerr << verifier.status().error_message() << std::endl;
+      std::exit(1);
+    }
+    auto* result = new SignatureBundle();
+    result->signer = std::move(signer.ValueOrDie());
+    result->verifier = std::move(verifier.ValueOrDie());
+    return result;
+  }();
+  return *bundle;
+}
+
+void BM_Sign(benchmark::State& state) {
+  SignatureBundle& bundle = GetBundle();
+  std::string data = subtle::Random::GetRandomBytes(state.range(0));
+  int64_t allocations_before =
+      total_heap_allocations.load(std::memory_order_relaxed);
+  for (auto _ : state) {
+    auto signature = bundle.signer->Sign(data);
+    if (!signature.ok()) std::exit(1);
+    benchmark::DoNotOptimize(signature);
+  }
+  state.SetBytesProcessed(state.iterations() * data.size());
+  state.counters["allocs/op"] = benchmark::Counter(
+      static_cast<double>(
+          total_heap_allocations.load(std::memory_order_relaxed) -
+          allocations_before) /
+      state.iterations());
+}
+BENCHMARK(BM_Sign)->Arg(64)->Arg(1 << 10)->Arg(1 << 20);
+
+void BM_Verify(benchmark::State& state) {
+  SignatureBundle& bundle = GetBundle();
+  std::string data = subtle::Random::GetRandomBytes(state.range(0));
+  std::string signature = bundle.signer->Sign(data).ValueOrDie();
+  for (auto _ : state) {
+    auto status = bundle.verifier->Verify(signature, data);
+    if (!status.ok()) std::exit(1);
+  }
+  state.SetBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_Verify)->Arg(64)->Arg(1 << 10)->Arg(1 << 20);
+
+}  // namespace
+}  // namespace tink
+}  // namespace crypto
+
+BENCHMARK_MAIN();
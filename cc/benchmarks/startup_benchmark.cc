@@ -0,0 +1,165 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Benchmarks for the cold-start path: config registration, keyset parsing
+// (binary and JSON) and primitive wrapping, across keyset sizes from a
+// single key up to 500 keys as left behind by long rotation histories.
+// Run with:
+//   bazel run -c opt //benchmarks:startup_benchmark
+
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include "benchmark/benchmark.h"
+#include "absl/memory/memory.h"
+#include "tink/aead.h"
+#include "tink/aead/aead_config.h"
+#include "tink/aead/aead_key_templates.h"
+#include "tink/binary_keyset_reader.h"
+#include "tink/cleartext_keyset_handle.h"
+#include "tink/json_keyset_reader.h"
+#include "tink/json_keyset_writer.h"
+#include "tink/keyset_handle.h"
+#include "tink/keyset_manager.h"
+
+namespace crypto {
+namespace tink {
+namespace {
+
+void RegisterOrDie() {
+  auto status = AeadConfig::Register();
+  if (!status.ok()) {
+    std::cerr << status.error_message() << std::endl;
+    std::exit(1);
+  }
+}
+
+// A serialized cleartext keyset with 'num_keys' AES128-GCM keys, cached
+// across benchmark runs.
+const std::string& GetSerializedKeyset(int num_keys) {
+  static auto* keysets = new std::map<int, std::string>();
+  auto it = keysets->find(num_keys);
+  if (it != keysets->end()) return it->second;
+  RegisterOrDie();
+  auto manager_result = KeysetManager::New(AeadKeyTemplates::Aes128Gcm());
+  if (!manager_result.ok()) std::exit(1);
+  auto manager = std::move(manager_result.ValueOrDie());
+  for (int i = 1; i < num_keys; i++) {
+    auto rotate_result = manager->Rotate(AeadKeyTemplates::Aes128Gcm());
+    if (!rotate_result.ok()) std::exit(1);
+  }
+  auto handle = manager->GetKeysetHandle();
+  auto inserted = keysets->emplace(
+      num_keys,
+      CleartextKeysetHandle::GetKeyset(*handle).SerializeAsString());
+  return inserted.first->second;
+}
+
+// The same keyset in JSON format.
+const std::string& GetJsonKeyset(int num_keys) {
+  static auto* keysets = new std::map<int, std::string>();
+  auto it = keysets->find(num_keys);
+  if (it != keysets->end()) return it->second;
+  auto reader =
+      BinaryKeysetReader::New(GetSerializedKeyset(num_keys)).ValueOrDie();
+  auto handle = CleartextKeysetHandle::Read(std::move(reader)).ValueOrDie();
+  auto destination = absl::make_unique<std::stringstream>();
+  auto* buffer = destination.get();
+  auto writer = JsonKeysetWriter::New(std::move(destination)).ValueOrDie();
+  auto status = CleartextKeysetHandle::Write(writer.get(), *handle);
+  if (!status.ok()) std::exit(1);
+  auto inserted = keysets->emplace(num_keys, buffer->str());
+  return inserted.first->second;
+}
+
+// Registration cost. The first Register() of the process does the real
+// work; the steady-state iterations measure the re-registration
+// (idempotency check) that every further library user pays.
+void BM_AeadConfigRegister(benchmark::State& state) {
+  for (auto _ : state) {
+    auto status = AeadConfig::Register();
+    if (!status.ok()) std::exit(1);
+  }
+}
+BENCHMARK(BM_AeadConfigRegister);
+
+// Keyset parse from the binary reader, without primitive creation.
+void BM_ParseBinaryKeyset(benchmark::State& state) {
+  const std::string& serialized = GetSerializedKeyset(state.range(0));
+  for (auto _ : state) {
+    auto reader = BinaryKeysetReader::New(serialized).ValueOrDie();
+    auto keyset = reader->Read();
+    if (!keyset.ok()) std::exit(1);
+    benchmark::DoNotOptimize(keyset);
+  }
+  state.SetBytesProcessed(state.iterations() * serialized.size());
+}
+BENCHMARK(BM_ParseBinaryKeyset)->Arg(1)->Arg(10)->Arg(100)->Arg(500);
+
+// Keyset parse from the JSON reader, without primitive creation.
+void BM_ParseJsonKeyset(benchmark::State& state) {
+  const std::string& json = GetJsonKeyset(state.range(0));
+  for (auto _ : state) {
+    auto reader = JsonKeysetReader::New(json).ValueOrDie();
+    auto keyset = reader->Read();
+    if (!keyset.ok()) std::exit(1);
+    benchmark::DoNotOptimize(keyset);
+  }
+  state.SetBytesProcessed(state.iterations() * json.size());
+}
+BENCHMARK(BM_ParseJsonKeyset)->Arg(1)->Arg(10)->Arg(100)->Arg(500);
+
+// Wrap time alone: the handle is parsed once, GetPrimitive() per
+// iteration instantiates and wraps all keys of the set.
+void BM_GetPrimitive(benchmark::State& state) {
+  RegisterOrDie();
+  auto reader =
+      BinaryKeysetReader::New(GetSerializedKeyset(state.range(0)))
+          .ValueOrDie();
+  auto handle = CleartextKeysetHandle::Read(std::move(reader)).ValueOrDie();
+  for (auto _ : state) {
+    auto aead = handle->GetPrimitive<Aead>();
+    if (!aead.ok()) std::exit(1);
+    benchmark::DoNotOptimize(aead);
+  }
+}
+BENCHMARK(BM_GetPrimitive)->Arg(1)->Arg(10)->Arg(100)->Arg(500);
+
+// The composite cold-start path of one keyset: parse, handle creation and
+// primitive wrapping, as executed on instance startup.
+void BM_ColdStartReadAndGetPrimitive(benchmark::State& state) {
+  RegisterOrDie();
+  const std::string& serialized = GetSerializedKeyset(state.range(0));
+  for (auto _ : state) {
+    auto reader = BinaryKeysetReader::New(serialized).ValueOrDie();
+    auto handle_result = CleartextKeysetHandle::Read(std::move(reader));
+    if (!handle_result.ok()) std::exit(1);
+    auto aead = handle_result.ValueOrDie()->GetPrimitive<Aead>();
+    if (!aead.ok()) std::exit(1);
+    benchmark::DoNotOptimize(aead);
+  }
+}
+BENCHMARK(BM_ColdStartReadAndGetPrimitive)->Arg(1)->Arg(10)->Arg(100)->Arg(500);
+
+}  // namespace
+}  // namespace tink
+}  // namespace crypto
+
+BENCHMARK_MAIN();
@@ -0,0 +1,207 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Benchmarks for the StreamingAead primitive. Each iteration encrypts (or
+// decrypts) a full stream of the given size, including stream setup. Run with:
+//   bazel run -c opt //benchmarks:streamingaead_benchmark
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "absl/memory/memory.h"
+#include "absl/strings/string_view.h"
+#include "tink/input_stream.h"
+#include "tink/keyset_handle.h"
+#include "tink/output_stream.h"
+#include "tink/streaming_aead.h"
+#include "tink/streamingaead/streaming_aead_config.h"
+#include "tink/streamingaead/streaming_aead_key_templates.h"
+#include "tink/subtle/aes_gcm_hkdf_streaming.h"
+#include "tink/subtle/common_enums.h"
+#include "tink/subtle/random.h"
+#include "tink/util/istream_input_stream.h"
+#include "tink/util/ostream_output_stream.h"
+#include "tink/util/secret_data.h"
+
+namespace crypto {
+namespace tink {
+namespace {
+
+constexpr char kAssociatedData[] = "associated data";
+
+StreamingAead& GetStreamingAead() {
+  static StreamingAead* streaming_aead = [] {
+    auto status = StreamingAeadConfig::Register();
+    if (!status.ok()) {
+      std::cerr << status.error_message() << std::endl;
+      std::exit(1);
+    }
+    auto handle = KeysetHandle::GenerateNew(
+        StreamingAeadKeyTemplates::Aes128GcmHkdf4KB());
+    if (!handle.ok()) {
+      std::cerr << handle.status().error_message() << std::endl;
+      std::exit(1);
+    }
+    auto saead_result = handle.ValueOrDie()->GetPrimitive<StreamingAead>();
+    if (!saead_result.ok()) {
+      std::cerr << saead_result.status().error_message() << std::endl;
+      std::exit(1);
+    }
+    return saead_result.ValueOrDie().release();
+  }();
+  return *streaming_aead;
+}
+
+// Writes all of 'data' to 'output' and closes it.
+util::Status WriteAllAndClose(absl::string_view data, OutputStream* output) {
+  size_t pos = 0;
+  while (pos < data.size()) {
+    void* buffer;
+    auto next_result = output->Next(&buffer);
+    if (!next_result.ok()) return next_result.status();
+    size_t available = next_result.ValueOrDie();
+    size_t to_copy = std::min(available, data.size() - pos);
+    std::memcpy(buffer, data.data() + pos, to_copy);
+    if (to_copy < available) {
+      output->BackUp(available - to_copy);
+    }
+    pos += to_copy;
+  }
+  return output->Close();
+}
+
+// Reads 'input' to its end; returns the number of bytes read.
+util::StatusOr<int64_t> ReadAll(InputStream* input) {
+  int64_t total = 0;
+  while (true) {
+    const void* buffer;
+    auto next_result = input->Next(&buffer);
+    if (next_result.status().error_code() == util::error::OUT_OF_RANGE) {
+      return total;
+    }
+    if (!next_result.ok()) return next_result.status();
+    total += next_result.ValueOrDie();
+  }
+}
+
+std::string EncryptToString(StreamingAead& streaming_aead,
+                            absl::string_view plaintext) {
+  auto ciphertext_stream = absl::make_unique<std::stringstream>();
+  auto* ciphertext_buffer = ciphertext_stream.get();
+  auto encrypting_stream_result = streaming_aead.NewEncryptingStream(
+      absl::make_unique<util::OstreamOutputStream>(
+          std::move(ciphertext_stream)),
+      kAssociatedData);
+  if (!encrypting_stream_result.ok()) std::exit(1);
+  auto status = WriteAllAndClose(plaintext,
+                                 encrypting_stream_result.ValueOrDie().get());
+  if (!status.ok()) std::exit(1);
+  return ciphertext_buffer->str();
+}
+
+void BM_StreamingEncrypt(benchmark::State& state) {
+  std::string plaintext = subtle::Random::GetRandomBytes(state.range(0));
+  for (auto _ : state) {
+    std::string ciphertext = EncryptToString(GetStreamingAead(), plaintext);
+    benchmark::DoNotOptimize(ciphertext);
+  }
+  state.SetBytesProcessed(state.iterations() * plaintext.size());
+}
+BENCHMARK(BM_StreamingEncrypt)->Arg(1 << 12)->Arg(1 << 20)->Arg(1 << 24);
+
+void BM_StreamingDecrypt(benchmark::State& state) {
+  std::string plaintext = subtle::Random::GetRandomBytes(state.range(0));
+  std::string ciphertext = EncryptToString(GetStreamingAead(), plaintext);
+  for (auto _ : state) {
+    auto decrypting_stream_result = GetStreamingAead().NewDecryptingStream(
+        absl::make_unique<util::IstreamInputStream>(
+            absl::make_unique<std::istringstream>(ciphertext)),
+        kAssociatedData);
+    if (!decrypting_stream_result.ok()) std::exit(1);
+    auto read_result = ReadAll(decrypting_stream_result.ValueOrDie().get());
+    if (!read_result.ok()) std::exit(1);
+    benchmark::DoNotOptimize(read_result);
+  }
+  state.SetBytesProcessed(state.iterations() * plaintext.size());
+}
+BENCHMARK(BM_StreamingDecrypt)->Arg(1 << 12)->Arg(1 << 20)->Arg(1 << 24);
+
+// Segment-size sweep: encrypts (or decrypts) a fixed-size stream with
+// AES-256-GCM-HKDF streaming at varying ciphertext segment sizes, so that
+// deployments can pick the smallest segment past the knee of the throughput
+// curve. The argument is the ciphertext segment size in bytes.
+constexpr int64_t kSweepStreamSize = 1 << 26;  // 64 MB
+
+std::unique_ptr<subtle::AesGcmHkdfStreaming> NewAesGcmHkdfStreaming(
+    int ciphertext_segment_size) {
+  subtle::AesGcmHkdfStreaming::Params params;
+  params.ikm =
+      util::SecretDataFromStringView(subtle::Random::GetRandomBytes(32));
+  params.hkdf_hash = subtle::SHA256;
+  params.derived_key_size = 32;
+  params.ciphertext_segment_size = ciphertext_segment_size;
+  params.ciphertext_offset = 0;
+  auto streaming_result = subtle::AesGcmHkdfStreaming::New(std::move(params));
+  if (!streaming_result.ok()) {
+    std::cerr << streaming_result.status().error_message() << std::endl;
+    std::exit(1);
+  }
+  return std::move(streaming_result.ValueOrDie());
+}
+
+void BM_SegmentSizeSweepEncrypt(benchmark::State& state) {
+  auto streaming_aead = NewAesGcmHkdfStreaming(state.range(0));
+  std::string plaintext = subtle::Random::GetRandomBytes(kSweepStreamSize);
+  for (auto _ : state) {
+    std::string ciphertext = EncryptToString(*streaming_aead, plaintext);
+    benchmark::DoNotOptimize(ciphertext);
+  }
+  state.SetBytesProcessed(state.iterations() * plaintext.size());
+}
+BENCHMARK(BM_SegmentSizeSweepEncrypt)
+    ->RangeMultiplier(4)
+    ->Range(1 << 12, 1 << 26);
+
+void BM_SegmentSizeSweepDecrypt(benchmark::State& state) {
+  auto streaming_aead = NewAesGcmHkdfStreaming(state.range(0));
+  std::string plaintext = subtle::Random::GetRandomBytes(kSweepStreamSize);
+  std::string ciphertext = EncryptToString(*streaming_aead, plaintext);
+  for (auto _ : state) {
+    auto decrypting_stream_result = streaming_aead->NewDecryptingStream(
+        absl::make_unique<util::IstreamInputStream>(
+            absl::make_unique<std::istringstream>(ciphertext)),
+        kAssociatedData);
+    if (!decrypting_stream_result.ok()) std::exit(1);
+    auto read_result = ReadAll(decrypting_stream_result.ValueOrDie().get());
+    if (!read_result.ok()) std::exit(1);
+    benchmark::DoNotOptimize(read_result);
+  }
+  state.SetBytesProcessed(state.iterations() * plaintext.size());
+}
+BENCHMARK(BM_SegmentSizeSweepDecrypt)
+    ->RangeMultiplier(4)
+    ->Range(1 << 12, 1 << 26);
+
+}  // namespace
+}  // namespace tink
+}  // namespace crypto
+
+BENCHMARK_MAIN();
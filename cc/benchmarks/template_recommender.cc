@@ -0,0 +1,233 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Diagnostic tool that benchmarks common AEAD and StreamingAead key
+// templates on the local hardware and prints a machine-readable
+// recommendation per payload-size bucket. Intended to be run once per
+// machine type (e.g. at image-bake time) to pick per-fleet default
+// templates instead of guessing. Run with:
+//   bazel run -c opt //benchmarks:template_recommender
+//
+// Output is tab-separated, one record per line:
+//   measure    <kind> <template> <payload_bytes> <mib_per_s>
+//   recommend  <kind> <payload_bytes> <template>
+// where <kind> is "aead" or "streaming" and throughput covers one
+// encrypt plus one decrypt of the payload.
+
+#include <algorithm>
+#include <chrono>  // NOLINT(build/c++11)
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/strings/string_view.h"
+#include "tink/aead.h"
+#include "tink/aead/aead_config.h"
+#include "tink/aead/aead_key_templates.h"
+#include "tink/input_stream.h"
+#include "tink/keyset_handle.h"
+#include "tink/output_stream.h"
+#include "tink/streaming_aead.h"
+#include "tink/streamingaead/streaming_aead_config.h"
+#include "tink/streamingaead/streaming_aead_key_templates.h"
+#include "tink/subtle/random.h"
+#include "tink/util/istream_input_stream.h"
+#include "tink/util/ostream_output_stream.h"
+#include "tink/util/status.h"
+
+namespace crypto {
+namespace tink {
+namespace {
+
+constexpr char kAssociatedData[] = "template recommender";
+
+// Minimum measurement time per (template, payload) cell; short enough to
+// keep the whole run in the tens of seconds, long enough to average out
+// scheduling noise at image-bake time.
+constexpr std::chrono::milliseconds kMinSampleTime(200);
+
+struct Candidate {
+  const char* name;
+  const google::crypto::tink::KeyTemplate* key_template;
+};
+
+std::vector<Candidate> AeadCandidates() {
+  return {
+      {"AES128_GCM", &AeadKeyTemplates::Aes128Gcm()},
+      {"AES256_GCM", &AeadKeyTemplates::Aes256Gcm()},
+      {"XCHACHA20_POLY1305", &AeadKeyTemplates::XChaCha20Poly1305()},
+  };
+}
+
+std::vector<Candidate> StreamingCandidates() {
+  return {
+      {"AES128_GCM_HKDF_4KB", &StreamingAeadKeyTemplates::Aes128GcmHkdf4KB()},
+      {"AES256_GCM_HKDF_4KB", &StreamingAeadKeyTemplates::Aes256GcmHkdf4KB()},
+      {"AES256_GCM_HKDF_1MB", &StreamingAeadKeyTemplates::Aes256GcmHkdf1MB()},
+  };
+}
+
+void ExitOnError(const util::Status& status, const char* context) {
+  if (!status.ok()) {
+    std::cerr << context << ": " << status.error_message() << std::endl;
+    std::exit(1);
+  }
+}
+
+template <class P>
+std::unique_ptr<P> GetPrimitiveOrDie(
+    const google::crypto::tink::KeyTemplate& key_template) {
+  auto handle = KeysetHandle::GenerateNew(key_template);
+  ExitOnError(handle.status(), "keyset generation failed");
+  auto primitive = handle.ValueOrDie()->GetPrimitive<P>();
+  ExitOnError(primitive.status(), "primitive creation failed");
+  return std::move(primitive.ValueOrDie());
+}
+
+// Runs 'roundtrip' repeatedly for at least kMinSampleTime (after one
+// warmup call) and returns the throughput in MiB/s, counting
+// 'payload_size' bytes per call.
+double MeasureThroughput(size_t payload_size,
+                         const std::function<void()>& roundtrip) {
+  roundtrip();  // Warmup: key setup, code paging, allocator state.
+  int iterations = 0;
+  auto start = std::chrono::steady_clock::now();
+  std::chrono::steady_clock::duration elapsed(0);
+  do {
+    roundtrip();
+    iterations++;
+    elapsed = std::chrono::steady_clock::now() - start;
+  } while (elapsed < kMinSampleTime);
+  double seconds =
+      std::chrono::duration_cast<std::chrono::duration<double>>(elapsed)
+          .count();
+  return static_cast<double>(payload_size) * iterations /
+         (1024.0 * 1024.0 * seconds);
+}
+
+double MeasureAead(const Candidate& candidate, size_t payload_size) {
+  std::unique_ptr<Aead> aead = GetPrimitiveOrDie<Aead>(*candidate.key_template);
+  std::string plaintext = subtle::Random::GetRandomBytes(payload_size);
+  return MeasureThroughput(payload_size, [&aead, &plaintext]() {
+    auto ciphertext = aead->Encrypt(plaintext, kAssociatedData);
+    ExitOnError(ciphertext.status(), "encryption failed");
+    auto decrypted = aead->Decrypt(ciphertext.ValueOrDie(), kAssociatedData);
+    ExitOnError(decrypted.status(), "decryption failed");
+  });
+}
+
+// Writes all of 'data' to 'output' and closes it.
+void WriteAllAndCloseOrDie(absl::string_view data, OutputStream* output) {
+  size_t pos = 0;
+  while (pos < data.size()) {
+    void* buffer;
+    auto next_result = output->Next(&buffer);
+    ExitOnError(next_result.status(), "stream write failed");
+    size_t available = next_result.ValueOrDie();
+    size_t to_copy = std::min(available, data.size() - pos);
+    std::memcpy(buffer, data.data() + pos, to_copy);
+    if (to_copy < available) {
+      output->BackUp(available - to_copy);
+    }
+    pos += to_copy;
+  }
+  ExitOnError(output->Close(), "stream close failed");
+}
+
+// Reads 'input' to its end.
+void ReadAllOrDie(InputStream* input) {
+  while (true) {
+    const void* buffer;
+    auto next_result = input->Next(&buffer);
+    if (next_result.status().error_code() == util::error::OUT_OF_RANGE) {
+      return;
+    }
+    ExitOnError(next_result.status(), "stream read failed");
+  }
+}
+
+double MeasureStreaming(const Candidate& candidate, size_t payload_size) {
+  std::unique_ptr<StreamingAead> streaming_aead =
+      GetPrimitiveOrDie<StreamingAead>(*candidate.key_template);
+  std::string plaintext = subtle::Random::GetRandomBytes(payload_size);
+  return MeasureThroughput(payload_size, [&streaming_aead, &plaintext]() {
+    auto ciphertext_stream = absl::make_unique<std::stringstream>();
+    auto* ciphertext_buffer = ciphertext_stream.get();
+    auto encrypting_stream = streaming_aead->NewEncryptingStream(
+        absl::make_unique<util::OstreamOutputStream>(
+            std::move(ciphertext_stream)),
+        kAssociatedData);
+    ExitOnError(encrypting_stream.status(), "encrypting stream failed");
+    WriteAllAndCloseOrDie(plaintext, encrypting_stream.ValueOrDie().get());
+
+    auto decrypting_stream = streaming_aead->NewDecryptingStream(
+        absl::make_unique<util::IstreamInputStream>(
+            absl::make_unique<std::istringstream>(ciphertext_buffer->str())),
+        kAssociatedData);
+    ExitOnError(decrypting_stream.status(), "decrypting stream failed");
+    ReadAllOrDie(decrypting_stream.ValueOrDie().get());
+  });
+}
+
+// Measures every candidate on every bucket, prints one "measure" line per
+// cell and one "recommend" line per bucket naming the fastest candidate.
+void RunAndRecommend(
+    const char* kind, const std::vector<Candidate>& candidates,
+    const std::vector<size_t>& payload_sizes,
+    double (*measure)(const Candidate&, size_t)) {
+  for (size_t payload_size : payload_sizes) {
+    const char* best_name = nullptr;
+    double best_mib_per_s = 0.0;
+    for (const Candidate& candidate : candidates) {
+      double mib_per_s = measure(candidate, payload_size);
+      std::cout << "measure\t" << kind << "\t" << candidate.name << "\t"
+                << payload_size << "\t" << mib_per_s << std::endl;
+      if (best_name == nullptr || mib_per_s > best_mib_per_s) {
+        best_name = candidate.name;
+        best_mib_per_s = mib_per_s;
+      }
+    }
+    std::cout << "recommend\t" << kind << "\t" << payload_size << "\t"
+              << best_name << std::endl;
+  }
+}
+
+void RealMain() {
+  ExitOnError(AeadConfig::Register(), "AeadConfig::Register");
+  ExitOnError(StreamingAeadConfig::Register(),
+              "StreamingAeadConfig::Register");
+
+  RunAndRecommend("aead", AeadCandidates(),
+                  {1 << 10, 16 << 10, 256 << 10, 4 << 20}, MeasureAead);
+  RunAndRecommend("streaming", StreamingCandidates(),
+                  {256 << 10, 4 << 20, 64 << 20}, MeasureStreaming);
+}
+
+}  // namespace
+}  // namespace tink
+}  // namespace crypto
+
+int main() {
+  crypto::tink::RealMain();
+  return 0;
+}
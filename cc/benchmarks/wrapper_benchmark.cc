@@ -0,0 +1,221 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Benchmarks for the per-call cost that the set wrappers add on top of the
+// raw ciphers, measured in cycles/byte so that small regressions survive
+// turbo and thermal variance of the machine (see measurement.h). The keyset
+// shape is swept over 1/10/100 keys with RAW and TINK prefixes. Run with:
+//   bazel run -c opt //benchmarks:wrapper_benchmark
+//
+// Arguments are {number of keys, output prefix} with 0 = RAW and 1 = TINK.
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include "benchmark/benchmark.h"
+#include "absl/memory/memory.h"
+#include "absl/strings/string_view.h"
+#include "benchmarks/keyset_fixtures.h"
+#include "benchmarks/measurement.h"
+#include "tink/aead.h"
+#include "tink/keyset_handle.h"
+#include "tink/mac.h"
+#include "tink/output_stream.h"
+#include "tink/streaming_aead.h"
+#include "tink/subtle/random.h"
+#include "tink/util/ostream_output_stream.h"
+#include "tink/util/status.h"
+#include "proto/tink.pb.h"
+
+namespace crypto {
+namespace tink {
+namespace {
+
+using benchmarks::AeadKeysetOrDie;
+using benchmarks::CycleCounter;
+using benchmarks::MacKeysetOrDie;
+using benchmarks::PinBenchmarkThread;
+using benchmarks::StreamingAeadKeysetOrDie;
+using benchmarks::WarmUp;
+using google::crypto::tink::OutputPrefixType;
+
+constexpr char kAssociatedData[] = "associated data";
+
+// A payload small enough that the wrapper's prefix handling and dispatch
+// are a visible fraction of the work, rather than vanishing behind the
+// bulk cipher.
+constexpr int kPayloadSize = 64;
+
+OutputPrefixType PrefixFromArg(int64_t arg) {
+  return arg == 0 ? OutputPrefixType::RAW : OutputPrefixType::TINK;
+}
+
+template <class P>
+std::unique_ptr<P> GetPrimitiveOrDie(const KeysetHandle& handle) {
+  auto primitive_result = handle.GetPrimitive<P>();
+  if (!primitive_result.ok()) {
+    std::cerr << primitive_result.status().error_message() << std::endl;
+    std::exit(1);
+  }
+  return std::move(primitive_result.ValueOrDie());
+}
+
+void BM_WrappedAeadEncrypt(benchmark::State& state) {
+  auto handle = AeadKeysetOrDie(state.range(0), PrefixFromArg(state.range(1)));
+  auto aead = GetPrimitiveOrDie<Aead>(*handle);
+  std::string plaintext = subtle::Random::GetRandomBytes(kPayloadSize);
+  PinBenchmarkThread();
+  WarmUp([&]() {
+    benchmark::DoNotOptimize(aead->Encrypt(plaintext, kAssociatedData));
+  });
+  CycleCounter cycles;
+  cycles.Start();
+  for (auto _ : state) {
+    auto ciphertext = aead->Encrypt(plaintext, kAssociatedData);
+    if (!ciphertext.ok()) std::exit(1);
+    benchmark::DoNotOptimize(ciphertext);
+  }
+  cycles.StopAndReport(&state, state.iterations() * plaintext.size());
+  state.SetBytesProcessed(state.iterations() * plaintext.size());
+}
+BENCHMARK(BM_WrappedAeadEncrypt)
+    ->Args({1, 0})->Args({1, 1})
+    ->Args({10, 0})->Args({10, 1})
+    ->Args({100, 0})->Args({100, 1});
+
+void BM_WrappedAeadDecrypt(benchmark::State& state) {
+  auto handle = AeadKeysetOrDie(state.range(0), PrefixFromArg(state.range(1)));
+  auto aead = GetPrimitiveOrDie<Aead>(*handle);
+  std::string plaintext = subtle::Random::GetRandomBytes(kPayloadSize);
+  std::string ciphertext =
+      aead->Encrypt(plaintext, kAssociatedData).ValueOrDie();
+  PinBenchmarkThread();
+  WarmUp([&]() {
+    benchmark::DoNotOptimize(aead->Decrypt(ciphertext, kAssociatedData));
+  });
+  CycleCounter cycles;
+  cycles.Start();
+  for (auto _ : state) {
+    auto decrypted = aead->Decrypt(ciphertext, kAssociatedData);
+    if (!decrypted.ok()) std::exit(1);
+    benchmark::DoNotOptimize(decrypted);
+  }
+  cycles.StopAndReport(&state, state.iterations() * plaintext.size());
+  state.SetBytesProcessed(state.iterations() * plaintext.size());
+}
+BENCHMARK(BM_WrappedAeadDecrypt)
+    ->Args({1, 0})->Args({1, 1})
+    ->Args({10, 0})->Args({10, 1})
+    ->Args({100, 0})->Args({100, 1});
+
+void BM_WrappedMacCompute(benchmark::State& state) {
+  auto handle = MacKeysetOrDie(state.range(0), PrefixFromArg(state.range(1)));
+  auto mac = GetPrimitiveOrDie<Mac>(*handle);
+  std::string data = subtle::Random::GetRandomBytes(kPayloadSize);
+  PinBenchmarkThread();
+  WarmUp([&]() { benchmark::DoNotOptimize(mac->ComputeMac(data)); });
+  CycleCounter cycles;
+  cycles.Start();
+  for (auto _ : state) {
+    auto tag = mac->ComputeMac(data);
+    if (!tag.ok()) std::exit(1);
+    benchmark::DoNotOptimize(tag);
+  }
+  cycles.StopAndReport(&state, state.iterations() * data.size());
+  state.SetBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_WrappedMacCompute)
+    ->Args({1, 0})->Args({1, 1})
+    ->Args({10, 0})->Args({10, 1})
+    ->Args({100, 0})->Args({100, 1});
+
+void BM_WrappedMacVerify(benchmark::State& state) {
+  auto handle = MacKeysetOrDie(state.range(0), PrefixFromArg(state.range(1)));
+  auto mac = GetPrimitiveOrDie<Mac>(*handle);
+  std::string data = subtle::Random::GetRandomBytes(kPayloadSize);
+  std::string tag = mac->ComputeMac(data).ValueOrDie();
+  PinBenchmarkThread();
+  WarmUp([&]() { benchmark::DoNotOptimize(mac->VerifyMac(tag, data)); });
+  CycleCounter cycles;
+  cycles.Start();
+  for (auto _ : state) {
+    auto status = mac->VerifyMac(tag, data);
+    if (!status.ok()) std::exit(1);
+  }
+  cycles.StopAndReport(&state, state.iterations() * data.size());
+  state.SetBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_WrappedMacVerify)
+    ->Args({1, 0})->Args({1, 1})
+    ->Args({10, 0})->Args({10, 1})
+    ->Args({100, 0})->Args({100, 1});
+
+// Writes all of 'data' to 'output' and closes it.
+util::Status WriteAllAndClose(absl::string_view data, OutputStream* output) {
+  size_t pos = 0;
+  while (pos < data.size()) {
+    void* buffer;
+    auto next_result = output->Next(&buffer);
+    if (!next_result.ok()) return next_result.status();
+    size_t available = next_result.ValueOrDie();
+    size_t to_write = std::min(available, data.size() - pos);
+    memcpy(buffer, data.data() + pos, to_write);
+    if (to_write < available) {
+      output->BackUp(available - to_write);
+    }
+    pos += to_write;
+  }
+  return output->Close();
+}
+
+void BM_WrappedStreamingAeadEncrypt(benchmark::State& state) {
+  auto handle = StreamingAeadKeysetOrDie(state.range(0));
+  auto streaming_aead = GetPrimitiveOrDie<StreamingAead>(*handle);
+  std::string plaintext = subtle::Random::GetRandomBytes(1 << 20);
+  auto encrypt_once = [&]() {
+    auto ciphertext_destination = absl::make_unique<std::stringstream>();
+    auto output_stream = absl::make_unique<util::OstreamOutputStream>(
+        std::move(ciphertext_destination));
+    auto encrypting_stream_result = streaming_aead->NewEncryptingStream(
+        std::move(output_stream), kAssociatedData);
+    if (!encrypting_stream_result.ok()) std::exit(1);
+    auto status = WriteAllAndClose(
+        plaintext, encrypting_stream_result.ValueOrDie().get());
+    if (!status.ok()) std::exit(1);
+  };
+  PinBenchmarkThread();
+  WarmUp(encrypt_once);
+  CycleCounter cycles;
+  cycles.Start();
+  for (auto _ : state) {
+    encrypt_once();
+  }
+  cycles.StopAndReport(&state, state.iterations() * plaintext.size());
+  state.SetBytesProcessed(state.iterations() * plaintext.size());
+}
+BENCHMARK(BM_WrappedStreamingAeadEncrypt)->Arg(1)->Arg(10);
+
+}  // namespace
+}  // namespace tink
+}  // namespace crypto
+
+BENCHMARK_MAIN();
@@ -37,18 +37,31 @@ class BinaryKeysetReader : public KeysetReader {
   static crypto::tink::util::StatusOr<std::unique_ptr<KeysetReader>> New(
       absl::string_view serialized_keyset);
 
+  // Like New(absl::string_view) above, but does NOT copy the serialized
+  // keyset: the returned reader parses directly from the caller's buffer.
+  // The bytes backing 'serialized_keyset' must remain alive and unmodified
+  // as long as the returned reader is in use (e.g. an mmap'ed region that
+  // stays mapped).
+  static crypto::tink::util::StatusOr<std::unique_ptr<KeysetReader>>
+  NewNonOwning(absl::string_view serialized_keyset);
+
   crypto::tink::util::StatusOr<std::unique_ptr<google::crypto::tink::Keyset>>
   Read() override;
 
+  // Parses the serialized keyset directly onto 'arena', without an
+  // intermediate heap-allocated message.
+  crypto::tink::util::StatusOr<google::crypto::tink::Keyset*> ReadIntoArena(
+      google::protobuf::Arena* arena) override;
+
   crypto::tink::util::StatusOr<
     std::unique_ptr<google::crypto::tink::EncryptedKeyset>>
   ReadEncrypted() override;
 
  private:
-  explicit BinaryKeysetReader(absl::string_view serialized_keyset)
-      : serialized_keyset_(serialized_keyset) {}
+  BinaryKeysetReader(absl::string_view serialized_keyset, bool copy_keyset);
 
-  std::string serialized_keyset_;
+  std::string owned_keyset_;  // empty if this reader does not own the bytes
+  absl::string_view serialized_keyset_;
 };
 
 }  // namespace tink
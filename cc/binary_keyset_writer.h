@@ -21,6 +21,7 @@
 
 #include "absl/strings/string_view.h"
 #include "tink/keyset_writer.h"
+#include "tink/output_stream.h"
 #include "tink/util/status.h"
 #include "tink/util/statusor.h"
 #include "proto/tink.pb.h"
@@ -36,6 +37,14 @@ class BinaryKeysetWriter : public KeysetWriter {
   static crypto::tink::util::StatusOr<std::unique_ptr<BinaryKeysetWriter>> New(
       std::unique_ptr<std::ostream> destination_stream);
 
+  // Returns a writer that serializes keysets directly into the buffers
+  // handed out by 'destination_stream', without materializing the
+  // serialized keyset as an intermediate string. Write() closes the
+  // stream once the keyset has been serialized, so a writer created this
+  // way writes exactly one keyset.
+  static crypto::tink::util::StatusOr<std::unique_ptr<BinaryKeysetWriter>> New(
+      std::unique_ptr<crypto::tink::OutputStream> destination_stream);
+
   crypto::tink::util::Status
   Write(const google::crypto::tink::Keyset& keyset) override;;
 
@@ -46,7 +55,13 @@ class BinaryKeysetWriter : public KeysetWriter {
   explicit BinaryKeysetWriter(std::unique_ptr<std::ostream> destination_stream)
       : destination_stream_(std::move(destination_stream)) {}
 
+  explicit BinaryKeysetWriter(
+      std::unique_ptr<crypto::tink::OutputStream> destination_stream)
+      : destination_output_stream_(std::move(destination_stream)) {}
+
+  // Exactly one of the two destinations below is non-null.
   std::unique_ptr<std::ostream> destination_stream_;
+  std::unique_ptr<crypto::tink::OutputStream> destination_output_stream_;
 };
 
 }  // namespace tink
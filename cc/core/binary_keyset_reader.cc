@@ -20,6 +20,7 @@
 #include <istream>
 #include <sstream>
 
+#include "google/protobuf/arena.h"
 #include "absl/memory/memory.h"
 #include "tink/util/errors.h"
 #include "tink/util/status.h"
@@ -48,23 +49,58 @@ util::StatusOr<std::unique_ptr<KeysetReader>> BinaryKeysetReader::New(
 util::StatusOr<std::unique_ptr<KeysetReader>> BinaryKeysetReader::New(
     absl::string_view serialized_keyset) {
   std::unique_ptr<KeysetReader> reader(
-      new BinaryKeysetReader(serialized_keyset));
+      new BinaryKeysetReader(serialized_keyset, /* copy_keyset = */ true));
   return std::move(reader);
 }
 
+//  static
+util::StatusOr<std::unique_ptr<KeysetReader>> BinaryKeysetReader::NewNonOwning(
+    absl::string_view serialized_keyset) {
+  std::unique_ptr<KeysetReader> reader(
+      new BinaryKeysetReader(serialized_keyset, /* copy_keyset = */ false));
+  return std::move(reader);
+}
+
+BinaryKeysetReader::BinaryKeysetReader(absl::string_view serialized_keyset,
+                                       bool copy_keyset) {
+  if (copy_keyset) {
+    owned_keyset_ = std::string(serialized_keyset);
+    serialized_keyset_ = owned_keyset_;
+  } else {
+    serialized_keyset_ = serialized_keyset;
+  }
+}
+
 util::StatusOr<std::unique_ptr<Keyset>> BinaryKeysetReader::Read() {
   auto keyset = absl::make_unique<Keyset>();
-  if (!keyset->ParseFromString(serialized_keyset_)) {
+  if (!keyset->ParseFromArray(serialized_keyset_.data(),
+                              serialized_keyset_.size())) {
     return util::Status(util::error::INVALID_ARGUMENT,
                         "Could not parse the input stream as a Keyset-proto.");
   }
   return std::move(keyset);
 }
 
+util::StatusOr<Keyset*> BinaryKeysetReader::ReadIntoArena(
+    google::protobuf::Arena* arena) {
+  if (arena == nullptr) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "arena must be non-null.");
+  }
+  auto* keyset = google::protobuf::Arena::CreateMessage<Keyset>(arena);
+  if (!keyset->ParseFromArray(serialized_keyset_.data(),
+                              serialized_keyset_.size())) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "Could not parse the input stream as a Keyset-proto.");
+  }
+  return keyset;
+}
+
 util::StatusOr<std::unique_ptr<EncryptedKeyset>>
 BinaryKeysetReader::ReadEncrypted() {
   auto enc_keyset = absl::make_unique<EncryptedKeyset>();
-  if (!enc_keyset->ParseFromString(serialized_keyset_)) {
+  if (!enc_keyset->ParseFromArray(serialized_keyset_.data(),
+                                  serialized_keyset_.size())) {
     return util::Status(util::error::INVALID_ARGUMENT,
         "Could not parse the input stream as an EncryptedKeyset-proto.");
   }
@@ -20,6 +20,8 @@
 #include <istream>
 #include <sstream>
 
+#include "google/protobuf/arena.h"
+#include "absl/strings/string_view.h"
 #include "tink/util/test_util.h"
 #include "gtest/gtest.h"
 #include "proto/tink.pb.h"
@@ -99,6 +101,41 @@ TEST_F(BinaryKeysetReaderTest, testReaderCreation) {
   }
 }
 
+TEST_F(BinaryKeysetReaderTest, testReadIntoArena) {
+  {  // Good string.
+    auto reader_result = BinaryKeysetReader::New(good_serialized_keyset_);
+    EXPECT_TRUE(reader_result.ok()) << reader_result.status();
+    auto reader = std::move(reader_result.ValueOrDie());
+    google::protobuf::Arena arena;
+    auto read_result = reader->ReadIntoArena(&arena);
+    EXPECT_TRUE(read_result.ok()) << read_result.status();
+    Keyset* keyset = read_result.ValueOrDie();
+    EXPECT_EQ(&arena, keyset->GetArena());
+    EXPECT_EQ(good_serialized_keyset_, keyset->SerializeAsString());
+  }
+
+  {  // Bad string.
+    auto reader_result = BinaryKeysetReader::New(bad_serialized_keyset_);
+    EXPECT_TRUE(reader_result.ok()) << reader_result.status();
+    auto reader = std::move(reader_result.ValueOrDie());
+    google::protobuf::Arena arena;
+    auto read_result = reader->ReadIntoArena(&arena);
+    EXPECT_FALSE(read_result.ok());
+    EXPECT_EQ(util::error::INVALID_ARGUMENT,
+              read_result.status().error_code());
+  }
+
+  {  // Null arena.
+    auto reader_result = BinaryKeysetReader::New(good_serialized_keyset_);
+    EXPECT_TRUE(reader_result.ok()) << reader_result.status();
+    auto reader = std::move(reader_result.ValueOrDie());
+    auto read_result = reader->ReadIntoArena(nullptr);
+    EXPECT_FALSE(read_result.ok());
+    EXPECT_EQ(util::error::INVALID_ARGUMENT,
+              read_result.status().error_code());
+  }
+}
+
 TEST_F(BinaryKeysetReaderTest, testReadFromString) {
   {  // Good string.
     auto reader_result = BinaryKeysetReader::New(good_serialized_keyset_);
@@ -121,6 +158,44 @@ TEST_F(BinaryKeysetReaderTest, testReadFromString) {
   }
 }
 
+TEST_F(BinaryKeysetReaderTest, testReadNonOwning) {
+  {  // Good string.
+    auto reader_result =
+        BinaryKeysetReader::NewNonOwning(good_serialized_keyset_);
+    EXPECT_TRUE(reader_result.ok()) << reader_result.status();
+    auto reader = std::move(reader_result.ValueOrDie());
+    auto read_result = reader->Read();
+    EXPECT_TRUE(read_result.ok()) << read_result.status();
+    auto keyset = std::move(read_result.ValueOrDie());
+    EXPECT_EQ(good_serialized_keyset_, keyset->SerializeAsString());
+    auto read_encrypted_result = reader->ReadEncrypted();
+    EXPECT_TRUE(read_encrypted_result.ok()) << read_encrypted_result.status();
+  }
+
+  {  // Bad string.
+    auto reader_result =
+        BinaryKeysetReader::NewNonOwning(bad_serialized_keyset_);
+    EXPECT_TRUE(reader_result.ok()) << reader_result.status();
+    auto reader = std::move(reader_result.ValueOrDie());
+    auto read_result = reader->Read();
+    EXPECT_FALSE(read_result.ok());
+    EXPECT_EQ(util::error::INVALID_ARGUMENT,
+              read_result.status().error_code());
+  }
+
+  {  // A view into a larger buffer; the bytes past the view must be ignored.
+    std::string buffer = good_serialized_keyset_ + "trailing garbage";
+    auto reader_result = BinaryKeysetReader::NewNonOwning(
+        absl::string_view(buffer).substr(0, good_serialized_keyset_.size()));
+    EXPECT_TRUE(reader_result.ok()) << reader_result.status();
+    auto reader = std::move(reader_result.ValueOrDie());
+    auto read_result = reader->Read();
+    EXPECT_TRUE(read_result.ok()) << read_result.status();
+    auto keyset = std::move(read_result.ValueOrDie());
+    EXPECT_EQ(good_serialized_keyset_, keyset->SerializeAsString());
+  }
+}
+
 TEST_F(BinaryKeysetReaderTest, testReadFromStream) {
   {  // Good stream.
     std::unique_ptr<std::istream> good_keyset_stream(new std::stringstream(
@@ -20,6 +20,8 @@
 #include <istream>
 #include <sstream>
 
+#include "google/protobuf/io/zero_copy_stream.h"
+#include "tink/output_stream.h"
 #include "tink/util/errors.h"
 #include "tink/util/protobuf_helper.h"
 #include "tink/util/status.h"
@@ -37,7 +39,6 @@ namespace {
 
 util::Status WriteProto(const portable_proto::MessageLite& proto,
                         std::ostream* destination) {
-  std::string serialized_proto;
   (*destination) << proto.SerializeAsString();
   if (destination->fail()) {
     return util::Status(util::error::UNKNOWN,
@@ -46,6 +47,50 @@ util::Status WriteProto(const portable_proto::MessageLite& proto,
   return util::Status::OK;
 }
 
+// Adapts a crypto::tink::OutputStream to protobuf's ZeroCopyOutputStream
+// interface; the two interfaces match method by method, so a keyset proto
+// is serialized directly into the destination's buffers.
+class ZeroCopyOutputStreamAdapter
+    : public google::protobuf::io::ZeroCopyOutputStream {
+ public:
+  explicit ZeroCopyOutputStreamAdapter(crypto::tink::OutputStream* destination)
+      : destination_(destination) {}
+
+  bool Next(void** data, int* size) override {
+    auto next_result = destination_->Next(data);
+    if (!next_result.ok()) {
+      status_ = next_result.status();
+      return false;
+    }
+    *size = next_result.ValueOrDie();
+    return true;
+  }
+
+  void BackUp(int count) override { destination_->BackUp(count); }
+
+  int64_t ByteCount() const override { return destination_->Position(); }
+
+  // The first error returned by the destination, if any.
+  const util::Status& status() const { return status_; }
+
+ private:
+  crypto::tink::OutputStream* destination_;
+  util::Status status_;
+};
+
+util::Status WriteProto(const portable_proto::MessageLite& proto,
+                        crypto::tink::OutputStream* destination) {
+  ZeroCopyOutputStreamAdapter adapter(destination);
+  if (!proto.SerializeToZeroCopyStream(&adapter)) {
+    if (!adapter.status().ok()) return adapter.status();
+    return util::Status(util::error::UNKNOWN,
+                        "Error writing to the destination stream.");
+  }
+  // Closing flushes any bytes the destination still buffers and surfaces
+  // errors of that final write.
+  return destination->Close();
+}
+
 }  // anonymous namespace
 
 
@@ -61,12 +106,30 @@ util::StatusOr<std::unique_ptr<BinaryKeysetWriter>> BinaryKeysetWriter::New(
   return std::move(writer);
 }
 
+//  static
+util::StatusOr<std::unique_ptr<BinaryKeysetWriter>> BinaryKeysetWriter::New(
+    std::unique_ptr<crypto::tink::OutputStream> destination_stream) {
+  if (destination_stream == nullptr) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "destination_stream must be non-null.");
+  }
+  std::unique_ptr<BinaryKeysetWriter> writer(
+      new BinaryKeysetWriter(std::move(destination_stream)));
+  return std::move(writer);
+}
+
 util::Status BinaryKeysetWriter::Write(const Keyset& keyset) {
+  if (destination_output_stream_ != nullptr) {
+    return WriteProto(keyset, destination_output_stream_.get());
+  }
   return WriteProto(keyset, destination_stream_.get());
 }
 
 util::Status BinaryKeysetWriter::Write(
     const EncryptedKeyset& encrypted_keyset) {
+  if (destination_output_stream_ != nullptr) {
+    return WriteProto(encrypted_keyset, destination_output_stream_.get());
+  }
   return WriteProto(encrypted_keyset, destination_stream_.get());
 }
 
@@ -19,6 +19,9 @@
 #include <ostream>
 #include <sstream>
 
+#include "absl/memory/memory.h"
+#include "absl/types/span.h"
+#include "tink/util/array_output_stream.h"
 #include "tink/util/test_util.h"
 #include "gtest/gtest.h"
 #include "proto/tink.pb.h"
@@ -100,6 +103,29 @@ TEST_F(BinaryKeysetWriterTest, testWriteEncryptedKeyset) {
   EXPECT_EQ(binary_encrypted_keyset_, buffer.str());
 }
 
+TEST_F(BinaryKeysetWriterTest, testWriteKeysetToOutputStream) {
+  std::string buffer(binary_keyset_.size(), '\0');
+  auto writer_result =
+      BinaryKeysetWriter::New(absl::make_unique<util::ArrayOutputStream>(
+          absl::Span<char>(&buffer[0], buffer.size())));
+  ASSERT_TRUE(writer_result.ok()) << writer_result.status();
+  auto writer = std::move(writer_result.ValueOrDie());
+  auto status = writer->Write(keyset_);
+  EXPECT_TRUE(status.ok()) << status;
+  EXPECT_EQ(binary_keyset_, buffer);
+}
+
+TEST_F(BinaryKeysetWriterTest, testOutputStreamTooSmall) {
+  std::string buffer(binary_keyset_.size() - 1, '\0');
+  auto writer_result =
+      BinaryKeysetWriter::New(absl::make_unique<util::ArrayOutputStream>(
+          absl::Span<char>(&buffer[0], buffer.size())));
+  ASSERT_TRUE(writer_result.ok()) << writer_result.status();
+  auto writer = std::move(writer_result.ValueOrDie());
+  auto status = writer->Write(keyset_);
+  EXPECT_FALSE(status.ok()) << status;
+}
+
 TEST_F(BinaryKeysetWriterTest, testDestinationStreamErrors) {
   std::stringbuf buffer;
   std::unique_ptr<std::ostream> destination_stream(new std::ostream(&buffer));
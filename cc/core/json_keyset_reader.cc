@@ -21,10 +21,13 @@
 #include <sstream>
 
 #include "absl/memory/memory.h"
-#include "absl/strings/escaping.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "include/rapidjson/document.h"
 #include "include/rapidjson/error/en.h"
+#include "include/rapidjson/memorystream.h"
+#include "include/rapidjson/reader.h"
+#include "tink/subtle/subtle_util.h"
 #include "tink/util/enums.h"
 #include "tink/util/errors.h"
 #include "tink/util/protobuf_helper.h"
@@ -37,7 +40,6 @@ namespace crypto {
 namespace tink {
 
 using google::crypto::tink::EncryptedKeyset;
-using google::crypto::tink::KeyData;
 using google::crypto::tink::Keyset;
 using google::crypto::tink::KeysetInfo;
 using crypto::tink::util::Enums;
@@ -117,7 +119,7 @@ EncryptedKeysetFromJson(const rapidjson::Document& json_doc) {
   auto status = ValidateEncryptedKeyset(json_doc);
   if (!status.ok()) return status;
   std::string enc_keyset;
-  if (!absl::Base64Unescape(
+  if (!subtle::Base64Decode(
           json_doc["encryptedKeyset"].GetString(), &enc_keyset)) {
     return util::Status(util::error::INVALID_ARGUMENT,
                             "Invalid JSON EncryptedKeyset");
@@ -136,93 +138,294 @@ EncryptedKeysetFromJson(const rapidjson::Document& json_doc) {
   return std::move(encrypted_keyset);
 }
 
-// Helpers for validating and parsing JSON strings with Keyset-protos.
-util::Status ValidateKeyset(const rapidjson::Document& json_doc) {
-  if (!json_doc.HasMember("primaryKeyId") ||
-      !json_doc["primaryKeyId"].IsUint() ||
-      !json_doc.HasMember("key") ||
-      !json_doc["key"].IsArray() ||
-      json_doc["key"].Size() < 1) {
-    return util::Status(util::error::INVALID_ARGUMENT,
-                            "Invalid JSON Keyset");
+// SAX-style handler that builds a Keyset-proto directly from the JSON token
+// stream, without materializing a rapidjson DOM first. Strings arrive as
+// transient buffers, so field values (incl. the base64-decoded key material)
+// are written straight into the proto. Unknown members are skipped, and the
+// same fields are required as by the DOM-based validation used before.
+class KeysetSaxHandler
+    : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, KeysetSaxHandler> {
+ public:
+  explicit KeysetSaxHandler(Keyset* keyset) : keyset_(keyset) {}
+
+  bool StartObject() {
+    if (skipping_) {
+      skip_depth_++;
+      return true;
+    }
+    switch (state_) {
+      case State::kExpectKeysetStart:
+        state_ = State::kKeysetKey;
+        return true;
+      case State::kKeyArrayValue:
+        key_ = keyset_->add_key();
+        seen_key_fields_ = 0;
+        state_ = State::kKeyKey;
+        return true;
+      case State::kExpectKeyDataStart:
+        seen_key_data_fields_ = 0;
+        state_ = State::kKeyDataKey;
+        return true;
+      default:
+        return UnexpectedValue();
+    }
   }
-  return util::Status::OK;
-}
 
-util::Status ValidateKey(const rapidjson::Value& json_value) {
-  if (!json_value.HasMember("keyData") ||
-      !json_value["keyData"].IsObject() ||
-      !json_value.HasMember("status") ||
-      !json_value["status"].IsString() ||
-      !json_value.HasMember("keyId") ||
-      !json_value["keyId"].IsUint() ||
-      !json_value.HasMember("outputPrefixType") ||
-      !json_value["outputPrefixType"].IsString()) {
-    return util::Status(util::error::INVALID_ARGUMENT,
-                            "Invalid JSON Key");
+  bool EndObject(rapidjson::SizeType /* member_count */) {
+    if (skipping_) return EndSkippedNested();
+    switch (state_) {
+      case State::kKeysetKey:
+        if (!has_primary_key_id_ || !has_key_array_) {
+          return Fail("Invalid JSON Keyset");
+        }
+        state_ = State::kDone;
+        return true;
+      case State::kKeyKey:
+        if (seen_key_fields_ != kAllKeyFields) {
+          return Fail("Invalid JSON Key");
+        }
+        state_ = State::kKeyArrayValue;
+        return true;
+      case State::kKeyDataKey:
+        if (seen_key_data_fields_ != kAllKeyDataFields) {
+          return Fail("Invalid JSON KeyData");
+        }
+        seen_key_fields_ |= kKeyData;
+        state_ = State::kKeyKey;
+        return true;
+      default:
+        return UnexpectedValue();
+    }
   }
-  return util::Status::OK;
-}
 
-util::Status ValidateKeyData(const rapidjson::Value& json_value) {
-  if (!json_value.HasMember("typeUrl") ||
-      !json_value["typeUrl"].IsString() ||
-      !json_value.HasMember("value") ||
-      !json_value["value"].IsString() ||
-      !json_value.HasMember("keyMaterialType") ||
-      !json_value["keyMaterialType"].IsString()) {
-    return util::Status(util::error::INVALID_ARGUMENT,
-                            "Invalid JSON KeyData");
+  bool Key(const char* str, rapidjson::SizeType length, bool /* copy */) {
+    if (skipping_) return true;
+    absl::string_view name(str, length);
+    switch (state_) {
+      case State::kKeysetKey:
+        if (name == "primaryKeyId") {
+          state_ = State::kExpectPrimaryKeyId;
+        } else if (name == "key") {
+          state_ = State::kExpectKeyArrayStart;
+        } else {
+          SkipNextValue();
+        }
+        return true;
+      case State::kKeyKey:
+        if (name == "keyId") {
+          state_ = State::kExpectKeyId;
+        } else if (name == "status") {
+          state_ = State::kExpectStatus;
+        } else if (name == "outputPrefixType") {
+          state_ = State::kExpectOutputPrefixType;
+        } else if (name == "keyData") {
+          state_ = State::kExpectKeyDataStart;
+        } else {
+          SkipNextValue();
+        }
+        return true;
+      case State::kKeyDataKey:
+        if (name == "typeUrl") {
+          state_ = State::kExpectTypeUrl;
+        } else if (name == "value") {
+          state_ = State::kExpectValue;
+        } else if (name == "keyMaterialType") {
+          state_ = State::kExpectKeyMaterialType;
+        } else {
+          SkipNextValue();
+        }
+        return true;
+      default:
+        return UnexpectedValue();
+    }
   }
-  return util::Status::OK;
-}
 
-util::StatusOr<std::unique_ptr<KeyData>>
-KeyDataFromJson(const rapidjson::Value& json_value) {
-  auto status = ValidateKeyData(json_value);
-  if (!status.ok()) return status;
-  std::string value_field;
-  if (!absl::Base64Unescape(json_value["value"].GetString(), &value_field)) {
-    return util::Status(util::error::INVALID_ARGUMENT,
-                            "Invalid JSON KeyData");
+  bool StartArray() {
+    if (skipping_) {
+      skip_depth_++;
+      return true;
+    }
+    if (state_ == State::kExpectKeyArrayStart) {
+      has_key_array_ = true;
+      state_ = State::kKeyArrayValue;
+      return true;
+    }
+    return UnexpectedValue();
   }
-  auto key_data = absl::make_unique<KeyData>();
-  key_data->set_type_url(json_value["typeUrl"].GetString());
-  key_data->set_value(value_field);
-  key_data->set_key_material_type(
-      Enums::KeyMaterial(json_value["keyMaterialType"].GetString()));
-  return std::move(key_data);
-}
 
-util::StatusOr<std::unique_ptr<Keyset::Key>>
-KeyFromJson(const rapidjson::Value& json_value) {
-  auto status = ValidateKey(json_value);
-  if (!status.ok()) return status;
-  auto key_data_result = KeyDataFromJson(json_value["keyData"]);
-  if (!key_data_result.ok()) return key_data_result.status();
+  bool EndArray(rapidjson::SizeType element_count) {
+    if (skipping_) return EndSkippedNested();
+    if (state_ == State::kKeyArrayValue) {
+      if (element_count < 1) return Fail("Invalid JSON Keyset");
+      state_ = State::kKeysetKey;
+      return true;
+    }
+    return UnexpectedValue();
+  }
 
-  auto key = absl::make_unique<Keyset::Key>();
-  key->set_key_id(json_value["keyId"].GetUint());
-  key->set_status(Enums::KeyStatus(json_value["status"].GetString()));
-  key->set_output_prefix_type(
-      Enums::OutputPrefix(json_value["outputPrefixType"].GetString()));
-  *(key->mutable_key_data()) = *(key_data_result.ValueOrDie());
-  return std::move(key);
-}
+  bool Uint(unsigned value) {
+    if (skipping_) return EndSkippedScalar();
+    switch (state_) {
+      case State::kExpectPrimaryKeyId:
+        keyset_->set_primary_key_id(value);
+        has_primary_key_id_ = true;
+        state_ = State::kKeysetKey;
+        return true;
+      case State::kExpectKeyId:
+        key_->set_key_id(value);
+        seen_key_fields_ |= kKeyId;
+        state_ = State::kKeyKey;
+        return true;
+      default:
+        return UnexpectedValue();
+    }
+  }
 
-util::StatusOr<std::unique_ptr<Keyset>>
-KeysetFromJson(const rapidjson::Document& json_doc) {
-  auto status = ValidateKeyset(json_doc);
-  if (!status.ok()) return status;
-  auto keyset = absl::make_unique<Keyset>();
-  keyset->set_primary_key_id(json_doc["primaryKeyId"].GetUint());
-  for (const auto& json_key : json_doc["key"].GetArray()) {
-    auto key_result = KeyFromJson(json_key);
-    if (!key_result.ok()) return key_result.status();
-    *(keyset->add_key()) = *(key_result.ValueOrDie());
+  bool String(const char* str, rapidjson::SizeType length, bool /* copy */) {
+    if (skipping_) return EndSkippedScalar();
+    absl::string_view value(str, length);
+    switch (state_) {
+      case State::kExpectStatus:
+        key_->set_status(Enums::KeyStatus(value));
+        seen_key_fields_ |= kStatus;
+        state_ = State::kKeyKey;
+        return true;
+      case State::kExpectOutputPrefixType:
+        key_->set_output_prefix_type(Enums::OutputPrefix(value));
+        seen_key_fields_ |= kOutputPrefixType;
+        state_ = State::kKeyKey;
+        return true;
+      case State::kExpectTypeUrl:
+        key_->mutable_key_data()->set_type_url(str, length);
+        seen_key_data_fields_ |= kTypeUrl;
+        state_ = State::kKeyDataKey;
+        return true;
+      case State::kExpectValue:
+        if (!subtle::Base64Decode(value,
+                                  key_->mutable_key_data()->mutable_value())) {
+          return Fail("Invalid JSON KeyData");
+        }
+        seen_key_data_fields_ |= kValue;
+        state_ = State::kKeyDataKey;
+        return true;
+      case State::kExpectKeyMaterialType:
+        key_->mutable_key_data()->set_key_material_type(
+            Enums::KeyMaterial(value));
+        seen_key_data_fields_ |= kKeyMaterialType;
+        state_ = State::kKeyDataKey;
+        return true;
+      default:
+        return UnexpectedValue();
+    }
+  }
+
+  bool Null() { return ScalarOfWrongType(); }
+  bool Bool(bool /* value */) { return ScalarOfWrongType(); }
+  bool Int(int /* value */) { return ScalarOfWrongType(); }
+  bool Int64(int64_t /* value */) { return ScalarOfWrongType(); }
+  bool Uint64(uint64_t /* value */) { return ScalarOfWrongType(); }
+  bool Double(double /* value */) { return ScalarOfWrongType(); }
+  bool RawNumber(const char* /* str */, rapidjson::SizeType /* length */,
+                 bool /* copy */) {
+    return ScalarOfWrongType();
+  }
+
+  // Error detected by the handler, if any. The parser itself reports such
+  // terminations only as kParseErrorTermination.
+  const util::Status& status() const { return status_; }
+
+ private:
+  enum class State {
+    kExpectKeysetStart,    // before the root '{'
+    kKeysetKey,            // in the root object, expecting a member name
+    kExpectPrimaryKeyId,   // after "primaryKeyId"
+    kExpectKeyArrayStart,  // after "key"
+    kKeyArrayValue,        // in the "key" array, expecting a key object
+    kKeyKey,               // in a key object, expecting a member name
+    kExpectKeyId,
+    kExpectStatus,
+    kExpectOutputPrefixType,
+    kExpectKeyDataStart,
+    kKeyDataKey,           // in a "keyData" object, expecting a member name
+    kExpectTypeUrl,
+    kExpectValue,
+    kExpectKeyMaterialType,
+    kDone,
+  };
+
+  // Required members of a key resp. keyData object.
+  enum KeyField {
+    kKeyId = 1 << 0,
+    kStatus = 1 << 1,
+    kOutputPrefixType = 1 << 2,
+    kKeyData = 1 << 3,
+    kAllKeyFields = kKeyId | kStatus | kOutputPrefixType | kKeyData,
+  };
+  enum KeyDataField {
+    kTypeUrl = 1 << 0,
+    kValue = 1 << 1,
+    kKeyMaterialType = 1 << 2,
+    kAllKeyDataFields = kTypeUrl | kValue | kKeyMaterialType,
+  };
+
+  // Starts skipping the value of an unknown member; skip_depth_ tracks how
+  // deeply we are nested in a skipped object or array.
+  void SkipNextValue() {
+    skipping_ = true;
+    skip_depth_ = 0;
+  }
+
+  bool EndSkippedScalar() {
+    if (skip_depth_ == 0) skipping_ = false;
+    return true;
+  }
+
+  bool EndSkippedNested() {
+    if (--skip_depth_ == 0) skipping_ = false;
+    return true;
   }
-  return std::move(keyset);
-}
+
+  bool ScalarOfWrongType() {
+    if (skipping_) return EndSkippedScalar();
+    return UnexpectedValue();
+  }
+
+  // A value of a type that does not fit the current state; the error message
+  // names the proto whose member was malformed, as the DOM validation did.
+  bool UnexpectedValue() {
+    switch (state_) {
+      case State::kKeyKey:
+      case State::kExpectKeyId:
+      case State::kExpectStatus:
+      case State::kExpectOutputPrefixType:
+      case State::kExpectKeyDataStart:
+        return Fail("Invalid JSON Key");
+      case State::kKeyDataKey:
+      case State::kExpectTypeUrl:
+      case State::kExpectValue:
+      case State::kExpectKeyMaterialType:
+        return Fail("Invalid JSON KeyData");
+      default:
+        return Fail("Invalid JSON Keyset");
+    }
+  }
+
+  bool Fail(const char* message) {
+    status_ = util::Status(util::error::INVALID_ARGUMENT, message);
+    return false;
+  }
+
+  Keyset* keyset_;
+  Keyset::Key* key_ = nullptr;
+  State state_ = State::kExpectKeysetStart;
+  bool skipping_ = false;
+  int skip_depth_ = 0;
+  bool has_primary_key_id_ = false;
+  bool has_key_array_ = false;
+  int seen_key_fields_ = 0;
+  int seen_key_data_fields_ = 0;
+  util::Status status_;
+};
 
 }  // namespace
 
@@ -242,44 +445,73 @@ util::StatusOr<std::unique_ptr<KeysetReader>> JsonKeysetReader::New(
 //  static
 util::StatusOr<std::unique_ptr<KeysetReader>> JsonKeysetReader::New(
     absl::string_view serialized_keyset) {
-  std::unique_ptr<KeysetReader> reader(new JsonKeysetReader(serialized_keyset));
+  std::unique_ptr<KeysetReader> reader(
+      new JsonKeysetReader(serialized_keyset, /* copy_keyset = */ true));
   return std::move(reader);
 }
 
+//  static
+util::StatusOr<std::unique_ptr<KeysetReader>> JsonKeysetReader::NewNonOwning(
+    absl::string_view serialized_keyset) {
+  std::unique_ptr<KeysetReader> reader(
+      new JsonKeysetReader(serialized_keyset, /* copy_keyset = */ false));
+  return std::move(reader);
+}
+
+JsonKeysetReader::JsonKeysetReader(absl::string_view serialized_keyset,
+                                   bool copy_keyset)
+    : keyset_stream_(nullptr) {
+  if (copy_keyset) {
+    owned_keyset_ = std::string(serialized_keyset);
+    serialized_keyset_ = owned_keyset_;
+  } else {
+    serialized_keyset_ = serialized_keyset;
+  }
+}
+
 util::StatusOr<std::unique_ptr<Keyset>> JsonKeysetReader::Read() {
   std::string serialized_keyset_from_stream;
-  std::string* serialized_keyset;
+  absl::string_view serialized_keyset;
   if (keyset_stream_ == nullptr) {
-    serialized_keyset = &serialized_keyset_;
+    serialized_keyset = serialized_keyset_;
   } else {
     serialized_keyset_from_stream =
         std::string(std::istreambuf_iterator<char>(*keyset_stream_), {});
-    serialized_keyset = &serialized_keyset_from_stream;
+    serialized_keyset = serialized_keyset_from_stream;
   }
-  rapidjson::Document json_doc(rapidjson::kObjectType);
-  if (json_doc.Parse(serialized_keyset->c_str()).HasParseError()) {
+  auto keyset = absl::make_unique<Keyset>();
+  KeysetSaxHandler handler(keyset.get());
+  rapidjson::Reader reader;
+  // A length-delimited stream, as a non-owning serialized keyset need not be
+  // null-terminated.
+  rapidjson::MemoryStream stream(serialized_keyset.data(),
+                                 serialized_keyset.size());
+  rapidjson::ParseResult parse_result = reader.Parse(stream, handler);
+  if (!parse_result) {
+    if (!handler.status().ok()) return handler.status();
     return util::Status(
         util::error::INVALID_ARGUMENT,
-        absl::StrCat(
-            "Invalid JSON Keyset: Error (offset ", json_doc.GetErrorOffset(),
-            "): ", rapidjson::GetParseError_En(json_doc.GetParseError())));
+        absl::StrCat("Invalid JSON Keyset: Error (offset ",
+                     parse_result.Offset(),
+                     "): ", rapidjson::GetParseError_En(parse_result.Code())));
   }
-  return KeysetFromJson(json_doc);
+  return std::move(keyset);
 }
 
 util::StatusOr<std::unique_ptr<EncryptedKeyset>>
 JsonKeysetReader::ReadEncrypted() {
   std::string serialized_keyset_from_stream;
-  std::string* serialized_keyset;
+  absl::string_view serialized_keyset;
   if (keyset_stream_ == nullptr) {
-    serialized_keyset = &serialized_keyset_;
+    serialized_keyset = serialized_keyset_;
   } else {
     serialized_keyset_from_stream =
         std::string(std::istreambuf_iterator<char>(*keyset_stream_), {});
-    serialized_keyset = &serialized_keyset_from_stream;
+    serialized_keyset = serialized_keyset_from_stream;
   }
   rapidjson::Document json_doc;
-  if (json_doc.Parse(serialized_keyset->c_str()).HasParseError()) {
+  if (json_doc.Parse(serialized_keyset.data(), serialized_keyset.size())
+          .HasParseError()) {
     return util::Status(
         util::error::INVALID_ARGUMENT,
         absl::StrCat("Invalid JSON EncryptedKeyset: Error (offset ",
@@ -22,6 +22,7 @@
 
 #include "gtest/gtest.h"
 #include "absl/strings/escaping.h"
+#include "absl/strings/string_view.h"
 #include "absl/strings/substitute.h"
 #include "tink/util/protobuf_helper.h"
 #include "tink/util/test_matchers.h"
@@ -192,6 +193,54 @@ TEST_F(JsonKeysetReaderTest, testReadFromString) {
   }
 }
 
+TEST_F(JsonKeysetReaderTest, testReadNonOwning) {
+  {  // Good string.
+    auto reader_result = JsonKeysetReader::NewNonOwning(good_json_keyset_);
+    EXPECT_TRUE(reader_result.ok()) << reader_result.status();
+    auto reader = std::move(reader_result.ValueOrDie());
+    auto read_result = reader->Read();
+    EXPECT_TRUE(read_result.ok()) << read_result.status();
+    auto keyset = std::move(read_result.ValueOrDie());
+    EXPECT_EQ(keyset_.SerializeAsString(), keyset->SerializeAsString());
+  }
+
+  {  // Bad string.
+    auto reader_result = JsonKeysetReader::NewNonOwning(bad_json_keyset_);
+    EXPECT_TRUE(reader_result.ok()) << reader_result.status();
+    auto reader = std::move(reader_result.ValueOrDie());
+    auto read_result = reader->Read();
+    EXPECT_FALSE(read_result.ok());
+    EXPECT_EQ(util::error::INVALID_ARGUMENT, read_result.status().error_code());
+  }
+
+  {  // A view into a larger, not null-terminated buffer; the bytes past the
+     // view must be ignored.
+    std::string buffer = good_json_keyset_ + "trailing garbage";
+    auto reader_result = JsonKeysetReader::NewNonOwning(
+        absl::string_view(buffer).substr(0, good_json_keyset_.size()));
+    EXPECT_TRUE(reader_result.ok()) << reader_result.status();
+    auto reader = std::move(reader_result.ValueOrDie());
+    auto read_result = reader->Read();
+    EXPECT_TRUE(read_result.ok()) << read_result.status();
+    auto keyset = std::move(read_result.ValueOrDie());
+    EXPECT_EQ(keyset_.SerializeAsString(), keyset->SerializeAsString());
+  }
+
+  {  // Encrypted keyset from a view into a larger buffer.
+    std::string buffer = good_json_encrypted_keyset_ + "trailing garbage";
+    auto reader_result = JsonKeysetReader::NewNonOwning(
+        absl::string_view(buffer).substr(0,
+                                         good_json_encrypted_keyset_.size()));
+    EXPECT_TRUE(reader_result.ok()) << reader_result.status();
+    auto reader = std::move(reader_result.ValueOrDie());
+    auto read_encrypted_result = reader->ReadEncrypted();
+    EXPECT_TRUE(read_encrypted_result.ok()) << read_encrypted_result.status();
+    auto encrypted_keyset = std::move(read_encrypted_result.ValueOrDie());
+    EXPECT_EQ(encrypted_keyset_.SerializeAsString(),
+              encrypted_keyset->SerializeAsString());
+  }
+}
+
 TEST_F(JsonKeysetReaderTest, testReadFromStream) {
   {  // Good stream.
     std::unique_ptr<std::istream> good_keyset_stream(new std::stringstream(
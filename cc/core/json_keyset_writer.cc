@@ -20,9 +20,8 @@
 #include <istream>
 #include <sstream>
 
-#include "absl/strings/escaping.h"
-#include "include/rapidjson/document.h"
 #include "include/rapidjson/prettywriter.h"
+#include "tink/subtle/subtle_util.h"
 #include "tink/util/enums.h"
 #include "tink/util/errors.h"
 #include "tink/util/protobuf_helper.h"
@@ -43,138 +42,97 @@ using util::Enums;
 
 namespace {
 
-// Helpers for transoforming Keyset-protos to  JSON strings.
-util::Status ToJson(const KeyData& key_data,
-                        rapidjson::Value* json_key_data,
-                        rapidjson::Document::AllocatorType* allocator) {
-  rapidjson::Value type_url(rapidjson::kStringType);
-  type_url.SetString(key_data.type_url().c_str(), *allocator);
-  json_key_data->AddMember("typeUrl", type_url, *allocator);
-
-  rapidjson::Value material_type(rapidjson::kStringType);
-  material_type.SetString(Enums::KeyMaterialName(key_data.key_material_type()),
-                          *allocator);
-  json_key_data->AddMember("keyMaterialType", material_type, *allocator);
-
-  std::string base64_string;
-  absl::Base64Escape(key_data.value(), &base64_string);
-  rapidjson::Value key_value(rapidjson::kStringType);
-  key_value.SetString(base64_string.c_str(), *allocator);
-  json_key_data->AddMember("value", key_value, *allocator);
+// rapidjson output-stream concept over std::ostream with a fixed-size
+// buffer. Together with the event-based emitters below this keeps the
+// memory needed for serialization constant, instead of materializing
+// first a rapidjson document and then the complete JSON string -- which
+// triples the peak memory for large keysets.
+class FixedBufferOstream {
+ public:
+  typedef char Ch;
+
+  explicit FixedBufferOstream(std::ostream* destination)
+      : destination_(destination) {}
+
+  void Put(char c) {
+    buffer_[count_++] = c;
+    if (count_ == sizeof(buffer_)) Flush();
+  }
 
-  return util::Status::OK;
-}
+  void Flush() {
+    destination_->write(buffer_, count_);
+    count_ = 0;
+  }
 
-util::Status ToJson(const Keyset::Key& key,
-                        rapidjson::Value* json_key,
-                        rapidjson::Document::AllocatorType* allocator) {
-  rapidjson::Value key_id(rapidjson::kNumberType);
-  key_id.SetUint(key.key_id());
-  json_key->AddMember("keyId", key_id, *allocator);
-
-  rapidjson::Value key_status(rapidjson::kStringType);
-  key_status.SetString(Enums::KeyStatusName(key.status()), *allocator);
-  json_key->AddMember("status", key_status, *allocator);
-
-  rapidjson::Value prefix_type(rapidjson::kStringType);
-  prefix_type.SetString(Enums::OutputPrefixName(key.output_prefix_type()),
-                        *allocator);
-  json_key->AddMember("outputPrefixType", prefix_type, *allocator);
-
-  rapidjson::Value json_key_data(rapidjson::kObjectType);
-  auto status = ToJson(key.key_data(), &json_key_data, allocator);
-  if (!status.ok()) return status;
-  json_key->AddMember("keyData", json_key_data, *allocator);
-  return util::Status::OK;
+  // Read-side concept methods; never called by writers.
+  char Peek() const { return '\0'; }
+  char Take() { return '\0'; }
+  size_t Tell() const { return 0; }
+  char* PutBegin() { return nullptr; }
+  size_t PutEnd(char*) { return 0; }
+
+ private:
+  std::ostream* destination_;
+  char buffer_[4096];
+  size_t count_ = 0;
+};
+
+typedef rapidjson::PrettyWriter<FixedBufferOstream> JsonWriter;
+
+// Helpers emitting Keyset-protos as JSON writer events. Only the base64
+// encoding of a single key value is ever held in memory at a time.
+void WriteJson(const KeyData& key_data, JsonWriter* writer) {
+  writer->StartObject();
+  writer->Key("typeUrl");
+  writer->String(key_data.type_url().c_str());
+  writer->Key("keyMaterialType");
+  writer->String(Enums::KeyMaterialName(key_data.key_material_type()));
+  std::string base64_string = subtle::Base64Encode(key_data.value());
+  writer->Key("value");
+  writer->String(base64_string.c_str());
+  writer->EndObject();
 }
 
-util::StatusOr<std::string> ToJsonString(const Keyset& keyset) {
-  rapidjson::Document json_doc(rapidjson::kObjectType);
-  auto& allocator = json_doc.GetAllocator();
-
-  rapidjson::Value primary_key_id(rapidjson::kNumberType);
-  primary_key_id.SetUint(keyset.primary_key_id());
-  json_doc.AddMember("primaryKeyId", primary_key_id, allocator);
-
-  rapidjson::Value key_array(rapidjson::kArrayType);
-  for (const Keyset::Key& key : keyset.key()) {
-    rapidjson::Value json_key(rapidjson::kObjectType);
-    auto status = ToJson(key, &json_key, &allocator);
-    if (!status.ok()) return status;
-    key_array.PushBack(json_key, allocator);
-  }
-  json_doc.AddMember("key", key_array, allocator);
-  rapidjson::StringBuffer string_buffer;
-  rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(string_buffer);
-  json_doc.Accept(writer);
-  return std::string(string_buffer.GetString());
+void WriteJson(const Keyset::Key& key, JsonWriter* writer) {
+  writer->StartObject();
+  writer->Key("keyId");
+  writer->Uint(key.key_id());
+  writer->Key("status");
+  writer->String(Enums::KeyStatusName(key.status()));
+  writer->Key("outputPrefixType");
+  writer->String(Enums::OutputPrefixName(key.output_prefix_type()));
+  writer->Key("keyData");
+  WriteJson(key.key_data(), writer);
+  writer->EndObject();
 }
 
-util::Status ToJson(const KeysetInfo::KeyInfo& key_info,
-                        rapidjson::Value* json_key_info,
-                        rapidjson::Document::AllocatorType* allocator) {
-  rapidjson::Value type_url(rapidjson::kStringType);
-  type_url.SetString(key_info.type_url().c_str(), *allocator);
-  json_key_info->AddMember("typeUrl", type_url, *allocator);
-
-  rapidjson::Value key_id(rapidjson::kNumberType);
-  key_id.SetUint(key_info.key_id());
-  json_key_info->AddMember("keyId", key_id, *allocator);
-
-  rapidjson::Value key_status(rapidjson::kStringType);
-  key_status.SetString(Enums::KeyStatusName(key_info.status()), *allocator);
-  json_key_info->AddMember("status", key_status, *allocator);
-
-  rapidjson::Value prefix_type(rapidjson::kStringType);
-  prefix_type.SetString(Enums::OutputPrefixName(key_info.output_prefix_type()),
-                        *allocator);
-  json_key_info->AddMember("outputPrefixType", prefix_type, *allocator);
-  return util::Status::OK;
+void WriteJson(const KeysetInfo::KeyInfo& key_info, JsonWriter* writer) {
+  writer->StartObject();
+  writer->Key("typeUrl");
+  writer->String(key_info.type_url().c_str());
+  writer->Key("keyId");
+  writer->Uint(key_info.key_id());
+  writer->Key("status");
+  writer->String(Enums::KeyStatusName(key_info.status()));
+  writer->Key("outputPrefixType");
+  writer->String(Enums::OutputPrefixName(key_info.output_prefix_type()));
+  writer->EndObject();
 }
 
-util::Status ToJson(const KeysetInfo& keyset_info,
-                        rapidjson::Value* json_keyset_info,
-                        rapidjson::Document::AllocatorType* allocator) {
-  rapidjson::Value primary_key_id(rapidjson::kNumberType);
-  primary_key_id.SetUint(keyset_info.primary_key_id());
-  json_keyset_info->AddMember("primaryKeyId", primary_key_id, *allocator);
-
-  rapidjson::Value key_info_array(rapidjson::kArrayType);
+void WriteJson(const KeysetInfo& keyset_info, JsonWriter* writer) {
+  writer->StartObject();
+  writer->Key("primaryKeyId");
+  writer->Uint(keyset_info.primary_key_id());
+  writer->Key("keyInfo");
+  writer->StartArray();
   for (const KeysetInfo::KeyInfo& key_info : keyset_info.key_info()) {
-    rapidjson::Value json_key_info(rapidjson::kObjectType);
-    auto status = ToJson(key_info, &json_key_info, allocator);
-    if (!status.ok()) return status;
-    key_info_array.PushBack(json_key_info, *allocator);
+    WriteJson(key_info, writer);
   }
-  json_keyset_info->AddMember("keyInfo", key_info_array, *allocator);
-  return util::Status::OK;
+  writer->EndArray();
+  writer->EndObject();
 }
 
-util::StatusOr<std::string> ToJsonString(const EncryptedKeyset& keyset) {
-  rapidjson::Document json_doc(rapidjson::kObjectType);
-  auto& allocator = json_doc.GetAllocator();
-
-  std::string base64_string;
-  absl::Base64Escape(keyset.encrypted_keyset(), &base64_string);
-  rapidjson::Value encrypted_keyset(rapidjson::kStringType);
-  encrypted_keyset.SetString(base64_string.c_str(), allocator);
-  json_doc.AddMember("encryptedKeyset", encrypted_keyset, allocator);
-
-  if (keyset.has_keyset_info()) {
-    rapidjson::Value json_keyset_info(rapidjson::kObjectType);
-    auto status = ToJson(keyset.keyset_info(), &json_keyset_info, &allocator);
-    if (!status.ok()) return status;
-    json_doc.AddMember("keysetInfo", json_keyset_info, allocator);
-  }
-
-  rapidjson::StringBuffer string_buffer;
-  rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(string_buffer);
-  json_doc.Accept(writer);
-  return std::string(string_buffer.GetString());
-}
-
-util::Status WriteData(absl::string_view data, std::ostream* destination) {
-  (*destination) << data;
+util::Status CheckDestination(std::ostream* destination) {
   if (destination->fail()) {
     return util::Status(util::error::UNKNOWN,
                             "Error writing to the destination stream.");
@@ -182,6 +140,40 @@ util::Status WriteData(absl::string_view data, std::ostream* destination) {
   return util::Status::OK;
 }
 
+util::Status WriteJson(const Keyset& keyset, std::ostream* destination) {
+  FixedBufferOstream stream(destination);
+  JsonWriter writer(stream);
+  writer.StartObject();
+  writer.Key("primaryKeyId");
+  writer.Uint(keyset.primary_key_id());
+  writer.Key("key");
+  writer.StartArray();
+  for (const Keyset::Key& key : keyset.key()) {
+    WriteJson(key, &writer);
+  }
+  writer.EndArray();
+  writer.EndObject();
+  stream.Flush();
+  return CheckDestination(destination);
+}
+
+util::Status WriteJson(const EncryptedKeyset& keyset,
+                       std::ostream* destination) {
+  FixedBufferOstream stream(destination);
+  JsonWriter writer(stream);
+  writer.StartObject();
+  std::string base64_string = subtle::Base64Encode(keyset.encrypted_keyset());
+  writer.Key("encryptedKeyset");
+  writer.String(base64_string.c_str());
+  if (keyset.has_keyset_info()) {
+    writer.Key("keysetInfo");
+    WriteJson(keyset.keyset_info(), &writer);
+  }
+  writer.EndObject();
+  stream.Flush();
+  return CheckDestination(destination);
+}
+
 }  // anonymous namespace
 
 
@@ -198,16 +190,12 @@ util::StatusOr<std::unique_ptr<JsonKeysetWriter>> JsonKeysetWriter::New(
 }
 
 util::Status JsonKeysetWriter::Write(const Keyset& keyset) {
-  auto json_string_result = ToJsonString(keyset);
-  if (!json_string_result.ok()) return json_string_result.status();
-  return WriteData(json_string_result.ValueOrDie(), destination_stream_.get());
+  return WriteJson(keyset, destination_stream_.get());
 }
 
 util::Status JsonKeysetWriter::Write(
     const EncryptedKeyset& encrypted_keyset) {
-  auto json_string_result = ToJsonString(encrypted_keyset);
-  if (!json_string_result.ok()) return json_string_result.status();
-  return WriteData(json_string_result.ValueOrDie(), destination_stream_.get());
+  return WriteJson(encrypted_keyset, destination_stream_.get());
 }
 
 }  // namespace tink
@@ -138,6 +138,42 @@ class KeyFactoryImpl<KeyTypeManager<KeyProto, void, List<Primitives...>>>
   }
 };
 
+// Constructs a Primitive for the given 'key_data' directly from a
+// KeyTypeManager, without going through the virtual KeyManager<Primitive>
+// interface. When the concrete KeyTypeManager type is known at compile time
+// (as it is in monomorphic deployments which use a single key type), this
+// lets the compiler inline the whole construction chain -- key proto parse,
+// validation and primitive construction -- with no virtual dispatch.
+// Example:
+//   AesGcmKeyManager key_type_manager;
+//   auto aead = GetPrimitiveFromKeyData<Aead>(key_type_manager, key_data);
+// KeyManagerImpl::GetPrimitive(KeyData) below routes through this function,
+// so both paths validate and construct identically.
+template <class Primitive, class KeyProto, class KeyFormatProto,
+          class... Primitives>
+crypto::tink::util::StatusOr<std::unique_ptr<Primitive>>
+GetPrimitiveFromKeyData(
+    const KeyTypeManager<KeyProto, KeyFormatProto, List<Primitives...>>&
+        key_type_manager,
+    const google::crypto::tink::KeyData& key_data) {
+  if (key_data.type_url() != key_type_manager.get_key_type()) {
+    return ToStatusF(util::error::INVALID_ARGUMENT,
+                     "Key type '%s' is not supported by this manager.",
+                     key_data.type_url());
+  }
+  KeyProto key_proto;
+  if (!key_proto.ParseFromString(key_data.value())) {
+    return ToStatusF(util::error::INVALID_ARGUMENT,
+                     "Could not parse key_data.value as key type '%s'.",
+                     key_data.type_url());
+  }
+  auto validation = key_type_manager.ValidateKey(key_proto);
+  if (!validation.ok()) {
+    return validation;
+  }
+  return key_type_manager.template GetPrimitive<Primitive>(key_proto);
+}
+
 // Template declaration of the class "KeyManagerImpl" with two template
 // arguments. There is only one specialization which is defined, namely when
 // the KeyTypeManager argument is of the form KeyTypeManager<KeyProto,
@@ -169,22 +205,7 @@ class KeyManagerImpl<
   // Constructs an instance of Primitive for the given 'key_data'.
   crypto::tink::util::StatusOr<std::unique_ptr<Primitive>> GetPrimitive(
       const google::crypto::tink::KeyData& key_data) const override {
-    if (!this->DoesSupport(key_data.type_url())) {
-      return ToStatusF(util::error::INVALID_ARGUMENT,
-                       "Key type '%s' is not supported by this manager.",
-                       key_data.type_url());
-    }
-    KeyProto key_proto;
-    if (!key_proto.ParseFromString(key_data.value())) {
-      return ToStatusF(util::error::INVALID_ARGUMENT,
-                       "Could not parse key_data.value as key type '%s'.",
-                       key_data.type_url());
-    }
-    auto validation = key_type_manager_->ValidateKey(key_proto);
-    if (!validation.ok()) {
-      return validation;
-    }
-    return key_type_manager_->template GetPrimitive<Primitive>(key_proto);
+    return GetPrimitiveFromKeyData<Primitive>(*key_type_manager_, key_data);
   }
 
   crypto::tink::util::StatusOr<std::unique_ptr<Primitive>> GetPrimitive(
@@ -321,6 +321,34 @@ TEST(KeyManagerImplTest, GetPrimitiveAeadVariant) {
   EXPECT_THAT(aead_variant->get(), Eq(key.key_value()));
 }
 
+TEST(KeyManagerImplTest, GetPrimitiveFromKeyDataStaticDispatch) {
+  ExampleKeyTypeManager internal_km;
+  // For comparison with the virtual path the key is created through the
+  // KeyManager interface, but the primitive construction below calls the
+  // KeyTypeManager directly, without virtual dispatch.
+  std::unique_ptr<KeyManager<Aead>> key_manager =
+      MakeKeyManager<Aead>(&internal_km);
+
+  AesGcmKeyFormat key_format;
+  key_format.set_key_size(16);
+  auto key_data = *key_manager->get_key_factory()
+                       .NewKeyData(key_format.SerializeAsString())
+                       .ValueOrDie();
+
+  auto aead = GetPrimitiveFromKeyData<Aead>(internal_km, key_data).ValueOrDie();
+  std::string encryption = aead->Encrypt("Hi", "aad").ValueOrDie();
+  std::string decryption = aead->Decrypt(encryption, "aad").ValueOrDie();
+  EXPECT_THAT(decryption, Eq("Hi"));
+
+  // The statically dispatched path validates the key type like the
+  // KeyManager interface does.
+  KeyData wrong_type_key_data = key_data;
+  wrong_type_key_data.set_type_url("wrong.type.url");
+  EXPECT_THAT(
+      GetPrimitiveFromKeyData<Aead>(internal_km, wrong_type_key_data).status(),
+      StatusIs(util::error::INVALID_ARGUMENT, HasSubstr("not supported")));
+}
+
 TEST(KeyManagerImplTest, GetPrimitiveFromKey) {
   ExampleKeyTypeManager internal_km;
   std::unique_ptr<KeyManager<Aead>> key_manager =
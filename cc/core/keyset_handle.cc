@@ -15,15 +15,22 @@
 ///////////////////////////////////////////////////////////////////////////////
 #include "tink/keyset_handle.h"
 
+#include <algorithm>
+#include <atomic>
+#include <map>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "absl/memory/memory.h"
+#include "absl/strings/string_view.h"
 #include "tink/aead.h"
 #include "tink/internal/key_info.h"
 #include "tink/keyset_reader.h"
 #include "tink/keyset_writer.h"
 #include "tink/registry.h"
 #include "tink/util/errors.h"
+#include "tink/util/execution_context.h"
 #include "tink/util/keyset_util.h"
 #include "proto/tink.pb.h"
 
@@ -62,6 +69,15 @@ Decrypt(const EncryptedKeyset& enc_keyset, const Aead& master_key_aead) {
   return std::move(keyset);
 }
 
+// FNV-1a, 64-bit.
+uint64_t Fingerprint64(absl::string_view data) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (char c : data) {
+    hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ULL;
+  }
+  return hash;
+}
+
 util::Status ValidateNoSecret(const Keyset& keyset) {
   for (const Keyset::Key& key : keyset.key()) {
     if (key.key_data().key_material_type() == KeyData::UNKNOWN_KEYMATERIAL ||
@@ -101,6 +117,68 @@ util::StatusOr<std::unique_ptr<KeysetHandle>> KeysetHandle::Read(
   return std::move(handle);
 }
 
+// static
+util::StatusOr<std::vector<util::StatusOr<std::unique_ptr<KeysetHandle>>>>
+KeysetHandle::ReadBatch(std::vector<std::unique_ptr<KeysetReader>> readers,
+                        const Aead& master_key_aead, int num_workers,
+                        util::ExecutionContext* execution_context) {
+  if (num_workers < 1) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "num_workers must be positive");
+  }
+  for (const std::unique_ptr<KeysetReader>& reader : readers) {
+    if (reader == nullptr) {
+      return util::Status(util::error::INVALID_ARGUMENT,
+                          "readers must not contain nullptr");
+    }
+  }
+  std::vector<std::unique_ptr<KeysetHandle>> handles(readers.size());
+  std::vector<util::Status> statuses(readers.size(), util::Status::OK);
+  // Readers are claimed via a shared counter; each worker performs the full
+  // read + master-key decryption for its entry, so up to 'num_workers'
+  // KMS decryptions are in flight at any time and entries complete as the
+  // responses arrive.
+  std::atomic<size_t> next_index(0);
+  auto work = [&readers, &master_key_aead, &handles, &statuses,
+               &next_index]() {
+    while (true) {
+      size_t i = next_index.fetch_add(1);
+      if (i >= readers.size()) return;
+      auto enc_keyset_result = readers[i]->ReadEncrypted();
+      if (!enc_keyset_result.ok()) {
+        statuses[i] = ToStatusF(util::error::INVALID_ARGUMENT,
+                                "Error reading encrypted keyset data: %s",
+                                enc_keyset_result.status().error_message());
+        continue;
+      }
+      auto keyset_result =
+          Decrypt(*enc_keyset_result.ValueOrDie(), master_key_aead);
+      if (!keyset_result.ok()) {
+        statuses[i] = ToStatusF(util::error::INVALID_ARGUMENT,
+                                "Error decrypting encrypted keyset: %s",
+                                keyset_result.status().error_message());
+        continue;
+      }
+      handles[i] = std::unique_ptr<KeysetHandle>(
+          new KeysetHandle(std::move(keyset_result.ValueOrDie())));
+    }
+  };
+  size_t worker_count =
+      std::min(static_cast<size_t>(num_workers), readers.size());
+  util::RunParallelWork(execution_context, static_cast<int>(worker_count),
+                        work);
+  std::vector<util::StatusOr<std::unique_ptr<KeysetHandle>>> results;
+  results.reserve(readers.size());
+  for (size_t i = 0; i < readers.size(); i++) {
+    if (statuses[i].ok()) {
+      results.push_back(std::move(handles[i]));
+    } else {
+      results.push_back(statuses[i]);
+    }
+  }
+  return std::move(results);
+}
+
 // static
 util::StatusOr<std::unique_ptr<KeysetHandle>> KeysetHandle::ReadNoSecret(
     const std::string& serialized_keyset) {
@@ -129,6 +207,73 @@ util::Status KeysetHandle::Write(KeysetWriter* writer,
   return writer->Write(*(encrypt_result.ValueOrDie().get()));
 }
 
+// static
+util::Status KeysetHandle::WriteBatch(
+    absl::Span<const KeysetHandle* const> keyset_handles, KeysetWriter* writer,
+    const Aead& master_key_aead, int num_workers,
+    util::ExecutionContext* execution_context) {
+  // How many keysets are encrypted (in parallel) before their encrypted
+  // forms are written out and their buffers released; bounds the memory
+  // held at any point to one chunk of encrypted keysets.
+  constexpr size_t kChunkSize = 256;
+
+  if (writer == nullptr) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "Writer must be non-null");
+  }
+  if (num_workers < 1) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "num_workers must be positive");
+  }
+  for (const KeysetHandle* handle : keyset_handles) {
+    if (handle == nullptr) {
+      return util::Status(util::error::INVALID_ARGUMENT,
+                          "keyset_handles must not contain nullptr");
+    }
+  }
+  std::vector<std::unique_ptr<EncryptedKeyset>> encrypted;
+  std::vector<util::Status> statuses;
+  for (size_t chunk_start = 0; chunk_start < keyset_handles.size();
+       chunk_start += kChunkSize) {
+    size_t chunk_size =
+        std::min(kChunkSize, keyset_handles.size() - chunk_start);
+    encrypted.assign(chunk_size, nullptr);
+    statuses.assign(chunk_size, util::Status::OK);
+    // Handles are claimed via a shared counter, so small keysets do not
+    // wait for large ones the way a static partition would make them.
+    std::atomic<size_t> next_index(0);
+    auto work = [&keyset_handles, &master_key_aead, &encrypted, &statuses,
+                 &next_index, chunk_start, chunk_size]() {
+      while (true) {
+        size_t i = next_index.fetch_add(1);
+        if (i >= chunk_size) return;
+        auto encrypt_result = Encrypt(
+            keyset_handles[chunk_start + i]->get_keyset(), master_key_aead);
+        if (encrypt_result.ok()) {
+          encrypted[i] = std::move(encrypt_result.ValueOrDie());
+        } else {
+          statuses[i] = encrypt_result.status();
+        }
+      }
+    };
+    size_t worker_count =
+        std::min(static_cast<size_t>(num_workers), chunk_size);
+    util::RunParallelWork(execution_context, static_cast<int>(worker_count),
+                          work);
+    for (size_t i = 0; i < chunk_size; i++) {
+      if (!statuses[i].ok()) {
+        return ToStatusF(util::error::INVALID_ARGUMENT,
+                         "Encryption of keyset %d failed: %s",
+                         static_cast<int>(chunk_start + i),
+                         statuses[i].error_message());
+      }
+      auto write_status = writer->Write(*encrypted[i]);
+      if (!write_status.ok()) return write_status;
+    }
+  }
+  return util::Status::OK;
+}
+
 util::Status KeysetHandle::WriteNoSecret(KeysetWriter* writer) const {
   if (writer == nullptr) {
     return util::Status(util::error::INVALID_ARGUMENT,
@@ -207,14 +352,59 @@ KeysetInfo KeysetHandle::GetKeysetInfo() const {
   return KeysetInfoFromKeyset(get_keyset());
 }
 
+uint64_t KeysetHandle::Fingerprint() const {
+  uint64_t cached = fingerprint_.load(std::memory_order_relaxed);
+  if (cached != 0) return cached;
+  uint64_t fingerprint = Fingerprint64(keyset_->SerializeAsString());
+  if (fingerprint == 0) fingerprint = 1;  // 0 marks "not yet computed".
+  // Concurrent first calls compute the same value, so the race is benign.
+  fingerprint_.store(fingerprint, std::memory_order_relaxed);
+  return fingerprint;
+}
+
+// static
+KeysetHandle::KeysetDiff KeysetHandle::Diff(const KeysetHandle& from,
+                                            const KeysetHandle& to) {
+  KeysetDiff diff;
+  // Keysets may legally hold several keys with the same id; keys are
+  // therefore matched per id in keyset order.
+  std::map<uint32_t, std::vector<std::string>> from_keys;
+  for (const Keyset::Key& key : from.keyset_->key()) {
+    from_keys[key.key_id()].push_back(key.SerializeAsString());
+  }
+  std::map<uint32_t, std::vector<std::string>> to_keys;
+  for (const Keyset::Key& key : to.keyset_->key()) {
+    to_keys[key.key_id()].push_back(key.SerializeAsString());
+  }
+  for (const auto& id_and_keys : to_keys) {
+    auto it = from_keys.find(id_and_keys.first);
+    if (it == from_keys.end()) {
+      diff.added_key_ids.push_back(id_and_keys.first);
+    } else if (it->second != id_and_keys.second) {
+      diff.changed_key_ids.push_back(id_and_keys.first);
+    }
+  }
+  for (const auto& id_and_keys : from_keys) {
+    if (to_keys.find(id_and_keys.first) == to_keys.end()) {
+      diff.removed_key_ids.push_back(id_and_keys.first);
+    }
+  }
+  diff.primary_changed =
+      from.keyset_->primary_key_id() != to.keyset_->primary_key_id();
+  return diff;
+}
+
 KeysetHandle::KeysetHandle(Keyset keyset)
-    : keyset_(std::move(keyset)) {}
+    : keyset_(std::make_shared<Keyset>(std::move(keyset))) {}
 
 KeysetHandle::KeysetHandle(std::unique_ptr<Keyset> keyset)
-    : keyset_(std::move(*keyset)) {}
+    : keyset_(std::move(keyset)) {}
+
+KeysetHandle::KeysetHandle(std::shared_ptr<const Keyset> keyset)
+    : keyset_(std::move(keyset)) {}
 
 const Keyset& KeysetHandle::get_keyset() const {
-  return keyset_;
+  return *keyset_;
 }
 
 }  // namespace tink
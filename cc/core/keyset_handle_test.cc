@@ -17,6 +17,7 @@
 #include "tink/core/key_manager_impl.h"
 #include "tink/keyset_handle.h"
 
+#include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "tink/aead/aead_key_templates.h"
 #include "tink/aead/aead_wrapper.h"
@@ -46,6 +47,7 @@ using crypto::tink::test::AddTinkKey;
 using crypto::tink::test::DummyAead;
 using crypto::tink::test::IsOk;
 using crypto::tink::test::StatusIs;
+using testing::HasSubstr;
 using google::crypto::tink::EcdsaKeyFormat;
 using google::crypto::tink::EncryptedKeyset;
 using google::crypto::tink::KeyData;
@@ -254,6 +256,190 @@ TEST_F(KeysetHandleTest, WriteEncryptedKeyset_Json) {
   EXPECT_EQ(util::error::INVALID_ARGUMENT, status.error_code());
 }
 
+// A KeysetWriter that collects the written encrypted keysets, optionally
+// failing after a given number of writes.
+class CollectingKeysetWriter : public KeysetWriter {
+ public:
+  explicit CollectingKeysetWriter(int fail_after = -1)
+      : fail_after_(fail_after) {}
+
+  util::Status Write(const Keyset& keyset) override {
+    return util::Status(util::error::UNIMPLEMENTED,
+                        "cleartext writes not expected");
+  }
+
+  util::Status Write(const EncryptedKeyset& encrypted_keyset) override {
+    if (fail_after_ >= 0 &&
+        static_cast<int>(encrypted_keysets_.size()) >= fail_after_) {
+      return util::Status(util::error::UNAVAILABLE, "writer failed");
+    }
+    encrypted_keysets_.push_back(encrypted_keyset);
+    return util::Status::OK;
+  }
+
+  const std::vector<EncryptedKeyset>& encrypted_keysets() const {
+    return encrypted_keysets_;
+  }
+
+ private:
+  int fail_after_;
+  std::vector<EncryptedKeyset> encrypted_keysets_;
+};
+
+TEST_F(KeysetHandleTest, ReadBatch) {
+  DummyAead aead("dummy aead 42");
+  std::vector<std::unique_ptr<KeysetReader>> readers;
+  std::vector<std::string> serialized_keysets;
+  for (int i = 0; i < 20; i++) {
+    Keyset keyset;
+    Keyset::Key key;
+    AddTinkKey(absl::StrCat("some key type ", i), /* key_id = */ i, key,
+               KeyStatusType::ENABLED, KeyData::SYMMETRIC, &keyset);
+    keyset.set_primary_key_id(i);
+    serialized_keysets.push_back(keyset.SerializeAsString());
+    std::string keyset_ciphertext =
+        aead.Encrypt(serialized_keysets.back(), /* associated_data= */ "")
+            .ValueOrDie();
+    EncryptedKeyset encrypted_keyset;
+    encrypted_keyset.set_encrypted_keyset(keyset_ciphertext);
+    readers.push_back(std::move(
+        BinaryKeysetReader::New(encrypted_keyset.SerializeAsString())
+            .ValueOrDie()));
+  }
+
+  auto results_or = KeysetHandle::ReadBatch(std::move(readers), aead,
+                                            /* num_workers = */ 4);
+  ASSERT_TRUE(results_or.ok()) << results_or.status();
+  auto& results = results_or.ValueOrDie();
+  ASSERT_EQ(serialized_keysets.size(), results.size());
+
+  // The handles arrive in reader order.
+  for (size_t i = 0; i < results.size(); i++) {
+    SCOPED_TRACE(absl::StrCat("handle #", i));
+    ASSERT_TRUE(results[i].ok()) << results[i].status();
+    EXPECT_EQ(serialized_keysets[i],
+              TestKeysetHandle::GetKeyset(*results[i].ValueOrDie())
+                  .SerializeAsString());
+  }
+}
+
+TEST_F(KeysetHandleTest, ReadBatchErrors) {
+  DummyAead aead("dummy aead 42");
+  Keyset keyset;
+  Keyset::Key key;
+  AddTinkKey("some key type", 42, key, KeyStatusType::ENABLED,
+             KeyData::SYMMETRIC, &keyset);
+  keyset.set_primary_key_id(42);
+  std::string keyset_ciphertext =
+      aead.Encrypt(keyset.SerializeAsString(), /* associated_data= */ "")
+          .ValueOrDie();
+  EncryptedKeyset encrypted_keyset;
+  encrypted_keyset.set_encrypted_keyset(keyset_ciphertext);
+
+  {  // A null reader is rejected.
+    std::vector<std::unique_ptr<KeysetReader>> readers;
+    readers.push_back(nullptr);
+    auto results_or = KeysetHandle::ReadBatch(std::move(readers), aead);
+    EXPECT_EQ(util::error::INVALID_ARGUMENT, results_or.status().error_code());
+  }
+
+  {  // num_workers must be positive.
+    std::vector<std::unique_ptr<KeysetReader>> readers;
+    auto results_or = KeysetHandle::ReadBatch(std::move(readers), aead,
+                                              /* num_workers = */ 0);
+    EXPECT_EQ(util::error::INVALID_ARGUMENT, results_or.status().error_code());
+  }
+
+  {  // A failing entry does not fail the others.
+    std::vector<std::unique_ptr<KeysetReader>> readers;
+    readers.push_back(std::move(
+        BinaryKeysetReader::New(encrypted_keyset.SerializeAsString())
+            .ValueOrDie()));
+    EncryptedKeyset wrong_keyset;
+    wrong_keyset.set_encrypted_keyset("totally wrong ciphertext");
+    readers.push_back(std::move(
+        BinaryKeysetReader::New(wrong_keyset.SerializeAsString())
+            .ValueOrDie()));
+    auto results_or = KeysetHandle::ReadBatch(std::move(readers), aead);
+    ASSERT_TRUE(results_or.ok()) << results_or.status();
+    auto& results = results_or.ValueOrDie();
+    ASSERT_EQ(2, results.size());
+    EXPECT_TRUE(results[0].ok()) << results[0].status();
+    EXPECT_EQ(util::error::INVALID_ARGUMENT, results[1].status().error_code());
+  }
+}
+
+TEST_F(KeysetHandleTest, WriteBatch) {
+  std::vector<std::unique_ptr<KeysetHandle>> handles;
+  std::vector<const KeysetHandle*> handle_ptrs;
+  std::vector<std::string> serialized_keysets;
+  for (int i = 0; i < 20; i++) {
+    Keyset keyset;
+    Keyset::Key key;
+    AddTinkKey(absl::StrCat("some key type ", i), /* key_id = */ i, key,
+               KeyStatusType::ENABLED, KeyData::SYMMETRIC, &keyset);
+    keyset.set_primary_key_id(i);
+    serialized_keysets.push_back(keyset.SerializeAsString());
+    handles.push_back(TestKeysetHandle::GetKeysetHandle(keyset));
+    handle_ptrs.push_back(handles.back().get());
+  }
+
+  DummyAead aead("dummy aead 42");
+  CollectingKeysetWriter writer;
+  auto status = KeysetHandle::WriteBatch(handle_ptrs, &writer, aead,
+                                         /* num_workers = */ 4);
+  EXPECT_TRUE(status.ok()) << status;
+  ASSERT_EQ(handles.size(), writer.encrypted_keysets().size());
+
+  // The encrypted keysets arrive in handle order.
+  for (size_t i = 0; i < handles.size(); i++) {
+    SCOPED_TRACE(absl::StrCat("handle #", i));
+    auto decrypt_result =
+        aead.Decrypt(writer.encrypted_keysets()[i].encrypted_keyset(),
+                     /* associated_data= */ "");
+    ASSERT_TRUE(decrypt_result.ok()) << decrypt_result.status();
+    EXPECT_EQ(serialized_keysets[i], decrypt_result.ValueOrDie());
+  }
+}
+
+TEST_F(KeysetHandleTest, WriteBatchErrors) {
+  Keyset keyset;
+  Keyset::Key key;
+  AddTinkKey("some key type", 42, key, KeyStatusType::ENABLED,
+             KeyData::SYMMETRIC, &keyset);
+  keyset.set_primary_key_id(42);
+  auto handle = TestKeysetHandle::GetKeysetHandle(keyset);
+  DummyAead aead("dummy aead 42");
+
+  {  // A null writer is rejected.
+    std::vector<const KeysetHandle*> handle_ptrs = {handle.get()};
+    auto status = KeysetHandle::WriteBatch(handle_ptrs, nullptr, aead);
+    EXPECT_EQ(util::error::INVALID_ARGUMENT, status.error_code());
+  }
+  {  // A null handle is rejected.
+    CollectingKeysetWriter writer;
+    std::vector<const KeysetHandle*> handle_ptrs = {handle.get(), nullptr};
+    auto status = KeysetHandle::WriteBatch(handle_ptrs, &writer, aead);
+    EXPECT_EQ(util::error::INVALID_ARGUMENT, status.error_code());
+    EXPECT_TRUE(writer.encrypted_keysets().empty());
+  }
+  {  // An invalid worker count is rejected.
+    CollectingKeysetWriter writer;
+    std::vector<const KeysetHandle*> handle_ptrs = {handle.get()};
+    auto status = KeysetHandle::WriteBatch(handle_ptrs, &writer, aead,
+                                           /* num_workers = */ 0);
+    EXPECT_EQ(util::error::INVALID_ARGUMENT, status.error_code());
+  }
+  {  // A write failure is propagated.
+    CollectingKeysetWriter writer(/* fail_after = */ 1);
+    std::vector<const KeysetHandle*> handle_ptrs = {handle.get(),
+                                                    handle.get()};
+    auto status = KeysetHandle::WriteBatch(handle_ptrs, &writer, aead);
+    EXPECT_EQ(util::error::UNAVAILABLE, status.error_code());
+    EXPECT_EQ(1, writer.encrypted_keysets().size());
+  }
+}
+
 TEST_F(KeysetHandleTest, GenerateNewKeysetHandle) {
   const google::crypto::tink::KeyTemplate* key_templates[] = {
     &AeadKeyTemplates::Aes128Gcm(),
@@ -389,6 +575,58 @@ TEST_F(KeysetHandleTest, GetPublicKeysetHandleErrors) {
   }
 }
 
+TEST_F(KeysetHandleTest, Fingerprint) {
+  Keyset keyset;
+  Keyset::Key key;
+  AddTinkKey("some key type", 42, key, KeyStatusType::ENABLED,
+             KeyData::SYMMETRIC, &keyset);
+  AddRawKey("some other key type", 711, key, KeyStatusType::ENABLED,
+            KeyData::SYMMETRIC, &keyset);
+  keyset.set_primary_key_id(42);
+
+  auto handle = TestKeysetHandle::GetKeysetHandle(keyset);
+  auto same_handle = TestKeysetHandle::GetKeysetHandle(keyset);
+  EXPECT_EQ(handle->Fingerprint(), handle->Fingerprint());
+  EXPECT_EQ(handle->Fingerprint(), same_handle->Fingerprint());
+
+  Keyset other_keyset = keyset;
+  other_keyset.set_primary_key_id(711);
+  auto other_handle = TestKeysetHandle::GetKeysetHandle(other_keyset);
+  EXPECT_NE(handle->Fingerprint(), other_handle->Fingerprint());
+}
+
+TEST_F(KeysetHandleTest, Diff) {
+  Keyset keyset;
+  Keyset::Key key;
+  AddTinkKey("some key type", 42, key, KeyStatusType::ENABLED,
+             KeyData::SYMMETRIC, &keyset);
+  AddRawKey("some other key type", 711, key, KeyStatusType::ENABLED,
+            KeyData::SYMMETRIC, &keyset);
+  keyset.set_primary_key_id(42);
+  auto handle = TestKeysetHandle::GetKeysetHandle(keyset);
+
+  {  // An identical keyset.
+    auto same_handle = TestKeysetHandle::GetKeysetHandle(keyset);
+    auto diff = KeysetHandle::Diff(*handle, *same_handle);
+    EXPECT_TRUE(diff.unchanged());
+  }
+  {  // Key 711 removed, key 4242 added, key 42 disabled and promoted.
+    Keyset other_keyset;
+    AddTinkKey("some key type", 42, key, KeyStatusType::DISABLED,
+               KeyData::SYMMETRIC, &other_keyset);
+    AddRawKey("yet another key type", 4242, key, KeyStatusType::ENABLED,
+              KeyData::SYMMETRIC, &other_keyset);
+    other_keyset.set_primary_key_id(4242);
+    auto other_handle = TestKeysetHandle::GetKeysetHandle(other_keyset);
+    auto diff = KeysetHandle::Diff(*handle, *other_handle);
+    EXPECT_FALSE(diff.unchanged());
+    EXPECT_EQ(diff.added_key_ids, std::vector<uint32_t>{4242});
+    EXPECT_EQ(diff.removed_key_ids, std::vector<uint32_t>{711});
+    EXPECT_EQ(diff.changed_key_ids, std::vector<uint32_t>{42});
+    EXPECT_TRUE(diff.primary_changed);
+  }
+}
+
 TEST_F(KeysetHandleTest, GetPrimitive) {
   Keyset keyset;
   KeyData key_data_0 =
@@ -428,6 +666,103 @@ TEST_F(KeysetHandleTest, GetPrimitive) {
   EXPECT_EQ(aead->Decrypt(raw_encryption, aad).ValueOrDie(), plaintext);
 }
 
+TEST_F(KeysetHandleTest, GetCachedPrimitive) {
+  Keyset keyset;
+  AddKeyData(*Registry::NewKeyData(AeadKeyTemplates::Aes128Gcm()).ValueOrDie(),
+             /*key_id=*/0, google::crypto::tink::OutputPrefixType::TINK,
+             KeyStatusType::ENABLED, &keyset);
+  keyset.set_primary_key_id(0);
+  std::unique_ptr<KeysetHandle> keyset_handle =
+      TestKeysetHandle::GetKeysetHandle(keyset);
+
+  auto aead_result = keyset_handle->GetCachedPrimitive<Aead>();
+  ASSERT_TRUE(aead_result.ok()) << aead_result.status();
+  std::shared_ptr<const Aead> aead = aead_result.ValueOrDie();
+
+  // A second call returns the memoized instance.
+  auto aead_result_2 = keyset_handle->GetCachedPrimitive<Aead>();
+  ASSERT_TRUE(aead_result_2.ok()) << aead_result_2.status();
+  EXPECT_EQ(aead.get(), aead_result_2.ValueOrDie().get());
+
+  std::string plaintext = "plaintext";
+  std::string aad = "aad";
+  std::string encryption = aead->Encrypt(plaintext, aad).ValueOrDie();
+  EXPECT_EQ(aead->Decrypt(encryption, aad).ValueOrDie(), plaintext);
+
+  // The cached primitive stays usable after the handle is destroyed.
+  keyset_handle.reset();
+  EXPECT_EQ(aead->Decrypt(encryption, aad).ValueOrDie(), plaintext);
+}
+
+TEST_F(KeysetHandleTest, GetPrimitivesBulk) {
+  std::vector<std::unique_ptr<KeysetHandle>> handles;
+  std::vector<const KeysetHandle*> handle_ptrs;
+  for (int i = 0; i < 10; i++) {
+    Keyset keyset;
+    AddKeyData(
+        *Registry::NewKeyData(AeadKeyTemplates::Aes128Gcm()).ValueOrDie(),
+        /*key_id=*/i, google::crypto::tink::OutputPrefixType::TINK,
+        KeyStatusType::ENABLED, &keyset);
+    keyset.set_primary_key_id(i);
+    handles.push_back(TestKeysetHandle::GetKeysetHandle(keyset));
+    handle_ptrs.push_back(handles.back().get());
+  }
+
+  auto aeads_result = KeysetHandle::GetPrimitives<Aead>(
+      handle_ptrs, /*num_workers=*/4);
+  ASSERT_TRUE(aeads_result.ok()) << aeads_result.status();
+  std::vector<std::unique_ptr<Aead>> aeads =
+      std::move(aeads_result.ValueOrDie());
+  ASSERT_EQ(aeads.size(), handles.size());
+
+  // Each primitive corresponds to the keyset of the handle at its index.
+  std::string plaintext = "plaintext";
+  std::string aad = "aad";
+  for (size_t i = 0; i < aeads.size(); i++) {
+    SCOPED_TRACE(absl::StrCat("handle #", i));
+    auto direct_aead = handles[i]->GetPrimitive<Aead>().ValueOrDie();
+    std::string encryption =
+        aeads[i]->Encrypt(plaintext, aad).ValueOrDie();
+    EXPECT_EQ(direct_aead->Decrypt(encryption, aad).ValueOrDie(), plaintext);
+  }
+}
+
+TEST_F(KeysetHandleTest, GetPrimitivesBulkErrors) {
+  Keyset keyset;
+  AddKeyData(*Registry::NewKeyData(AeadKeyTemplates::Aes128Gcm()).ValueOrDie(),
+             /*key_id=*/0, google::crypto::tink::OutputPrefixType::TINK,
+             KeyStatusType::ENABLED, &keyset);
+  keyset.set_primary_key_id(0);
+  std::unique_ptr<KeysetHandle> handle =
+      TestKeysetHandle::GetKeysetHandle(keyset);
+
+  {  // A null handle is rejected.
+    std::vector<const KeysetHandle*> handle_ptrs = {handle.get(), nullptr};
+    auto result = KeysetHandle::GetPrimitives<Aead>(handle_ptrs);
+    EXPECT_THAT(result.status(),
+                StatusIs(util::error::INVALID_ARGUMENT,
+                         HasSubstr("must not contain nullptr")));
+  }
+  {  // num_workers must be positive.
+    std::vector<const KeysetHandle*> handle_ptrs = {handle.get()};
+    auto result =
+        KeysetHandle::GetPrimitives<Aead>(handle_ptrs, /*num_workers=*/0);
+    EXPECT_THAT(result.status(),
+                StatusIs(util::error::INVALID_ARGUMENT,
+                         HasSubstr("num_workers must be positive")));
+  }
+  {  // A failing keyset is reported with its index.
+    Keyset empty_keyset;
+    std::unique_ptr<KeysetHandle> empty_handle =
+        TestKeysetHandle::GetKeysetHandle(empty_keyset);
+    std::vector<const KeysetHandle*> handle_ptrs = {handle.get(),
+                                                    empty_handle.get()};
+    auto result = KeysetHandle::GetPrimitives<Aead>(handle_ptrs);
+    EXPECT_THAT(result.status().error_message(),
+                HasSubstr("keyset_handles[1]"));
+  }
+}
+
 // Tests that GetPrimitive(nullptr) fails with a non-ok status.
 TEST_F(KeysetHandleTest, GetPrimitiveNullptrKeyManager) {
   Keyset keyset;
@@ -16,7 +16,9 @@
 
 #include "tink/keyset_manager.h"
 
-#include <random>
+#include <memory>
+#include <utility>
+#include <vector>
 
 #include "absl/memory/memory.h"
 #include "tink/keyset_handle.h"
@@ -24,6 +26,7 @@
 #include "tink/registry.h"
 #include "tink/util/enums.h"
 #include "tink/util/errors.h"
+#include "tink/util/keyset_util.h"
 #include "proto/tink.pb.h"
 
 namespace crypto {
@@ -50,16 +53,28 @@ StatusOr<std::unique_ptr<KeysetManager>> KeysetManager::New(
     const KeysetHandle& keyset_handle) {
   auto manager = absl::make_unique<KeysetManager>();
   absl::MutexLock lock(&manager->keyset_mutex_);
-  manager->keyset_ = keyset_handle.get_keyset();
+  // Adopt the handle's immutable keyset without copying it: the snapshot
+  // is shared as-is and every entry aliases into it, so key material is
+  // copied only when the corresponding entry is later mutated.
+  manager->snapshot_ = keyset_handle.keyset_;
+  manager->primary_key_id_ = manager->snapshot_->primary_key_id();
+  for (const Keyset::Key& key : manager->snapshot_->key()) {
+    manager->keys_.emplace_back(manager->snapshot_, &key);
+  }
   return std::move(manager);
 }
 
 std::unique_ptr<KeysetHandle> KeysetManager::GetKeysetHandle() {
   absl::MutexLock lock(&keyset_mutex_);
-  std::unique_ptr<Keyset> keyset_copy(new Keyset(keyset_));
-  std::unique_ptr<KeysetHandle> handle(
-      new KeysetHandle(std::move(keyset_copy)));
-  return handle;
+  if (snapshot_ == nullptr) {
+    auto keyset = std::make_shared<Keyset>();
+    keyset->set_primary_key_id(primary_key_id_);
+    for (const auto& key : keys_) {
+      *keyset->add_key() = *key;
+    }
+    snapshot_ = std::move(keyset);
+  }
+  return absl::WrapUnique(new KeysetHandle(snapshot_));
 }
 
 StatusOr<uint32_t> KeysetManager::Add(const KeyTemplate& key_template) {
@@ -68,8 +83,33 @@ StatusOr<uint32_t> KeysetManager::Add(const KeyTemplate& key_template) {
 
 crypto::tink::util::StatusOr<uint32_t> KeysetManager::Add(
     const google::crypto::tink::KeyTemplate& key_template, bool as_primary) {
+  if (key_template.output_prefix_type() ==
+      google::crypto::tink::OutputPrefixType::UNKNOWN_PREFIX) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "key template has unknown prefix");
+  }
+  auto key_data_result = Registry::NewKeyData(key_template);
+  if (!key_data_result.ok()) return key_data_result.status();
+  auto key_data = std::move(key_data_result.ValueOrDie());
+
   absl::MutexLock lock(&keyset_mutex_);
-  return KeysetHandle::AddToKeyset(key_template, as_primary, &keyset_);
+  std::vector<uint32_t> used_key_ids;
+  used_key_ids.reserve(keys_.size());
+  for (const auto& key : keys_) {
+    used_key_ids.push_back(key->key_id());
+  }
+  uint32_t key_id = GenerateUnusedKeyId(used_key_ids);
+  auto key = std::make_shared<Keyset::Key>();
+  *(key->mutable_key_data()) = *key_data;
+  key->set_status(KeyStatusType::ENABLED);
+  key->set_key_id(key_id);
+  key->set_output_prefix_type(key_template.output_prefix_type());
+  keys_.push_back(std::move(key));
+  if (as_primary) {
+    primary_key_id_ = key_id;
+  }
+  snapshot_.reset();
+  return key_id;
 }
 
 StatusOr<uint32_t> KeysetManager::Rotate(const KeyTemplate& key_template) {
@@ -79,110 +119,122 @@ StatusOr<uint32_t> KeysetManager::Rotate(const KeyTemplate& key_template) {
 
 Status KeysetManager::Enable(uint32_t key_id) {
   absl::MutexLock lock(&keyset_mutex_);
-  for (auto& key : *(keyset_.mutable_key())) {
-    if (key.key_id() == key_id) {
-      if (key.status() != KeyStatusType::DISABLED &&
-          key.status() != KeyStatusType::ENABLED) {
-        return ToStatusF(util::error::INVALID_ARGUMENT,
-                         "Cannot enable key with key_id %u and status %s.",
-                         key_id, Enums::KeyStatusName(key.status()));
-      }
-      key.set_status(KeyStatusType::ENABLED);
-      return Status::OK;
-    }
+  int index = FindKey(key_id);
+  if (index < 0) {
+    return ToStatusF(util::error::NOT_FOUND,
+                     "No key with key_id %u found in the keyset.", key_id);
+  }
+  const Keyset::Key& key = *keys_[index];
+  if (key.status() != KeyStatusType::DISABLED &&
+      key.status() != KeyStatusType::ENABLED) {
+    return ToStatusF(util::error::INVALID_ARGUMENT,
+                     "Cannot enable key with key_id %u and status %s.",
+                     key_id, Enums::KeyStatusName(key.status()));
   }
-  return ToStatusF(util::error::NOT_FOUND,
-                   "No key with key_id %u found in the keyset.", key_id);
+  auto new_key = std::make_shared<Keyset::Key>(key);
+  new_key->set_status(KeyStatusType::ENABLED);
+  keys_[index] = std::move(new_key);
+  snapshot_.reset();
+  return Status::OK;
 }
 
 Status KeysetManager::Disable(uint32_t key_id) {
   absl::MutexLock lock(&keyset_mutex_);
-  if (keyset_.primary_key_id() == key_id) {
+  if (primary_key_id_ == key_id) {
     return ToStatusF(util::error::INVALID_ARGUMENT,
                      "Cannot disable primary key (key_id %u).", key_id);
   }
-  for (auto& key : *(keyset_.mutable_key())) {
-    if (key.key_id() == key_id) {
-      if (key.status() != KeyStatusType::DISABLED &&
-          key.status() != KeyStatusType::ENABLED) {
-        return ToStatusF(util::error::INVALID_ARGUMENT,
-                         "Cannot disable key with key_id %u and status %s.",
-                         key_id, Enums::KeyStatusName(key.status()));
-      }
-      key.set_status(KeyStatusType::DISABLED);
-      return Status::OK;
-    }
+  int index = FindKey(key_id);
+  if (index < 0) {
+    return ToStatusF(util::error::NOT_FOUND,
+                     "No key with key_id %u found in the keyset.", key_id);
   }
-  return ToStatusF(util::error::NOT_FOUND,
-                   "No key with key_id %u found in the keyset.", key_id);
+  const Keyset::Key& key = *keys_[index];
+  if (key.status() != KeyStatusType::DISABLED &&
+      key.status() != KeyStatusType::ENABLED) {
+    return ToStatusF(util::error::INVALID_ARGUMENT,
+                     "Cannot disable key with key_id %u and status %s.",
+                     key_id, Enums::KeyStatusName(key.status()));
+  }
+  auto new_key = std::make_shared<Keyset::Key>(key);
+  new_key->set_status(KeyStatusType::DISABLED);
+  keys_[index] = std::move(new_key);
+  snapshot_.reset();
+  return Status::OK;
 }
 
 Status KeysetManager::Delete(uint32_t key_id) {
   absl::MutexLock lock(&keyset_mutex_);
-  if (keyset_.primary_key_id() == key_id) {
+  if (primary_key_id_ == key_id) {
     return ToStatusF(util::error::INVALID_ARGUMENT,
                      "Cannot delete primary key (key_id %u).", key_id);
   }
-  auto key_field = keyset_.mutable_key();
-  for (auto key_iter = key_field->begin();
-       key_iter != key_field->end();
-       key_iter++) {
-    auto key = *key_iter;
-    if (key.key_id() == key_id) {
-      keyset_.mutable_key()->erase(key_iter);
-      return Status::OK;
-    }
+  int index = FindKey(key_id);
+  if (index < 0) {
+    return ToStatusF(util::error::NOT_FOUND,
+                     "No key with key_id %u found in the keyset.", key_id);
   }
-  return ToStatusF(util::error::NOT_FOUND,
-                   "No key with key_id %u found in the keyset.", key_id);
+  keys_.erase(keys_.begin() + index);
+  snapshot_.reset();
+  return Status::OK;
 }
 
 Status KeysetManager::Destroy(uint32_t key_id) {
   absl::MutexLock lock(&keyset_mutex_);
-  if (keyset_.primary_key_id() == key_id) {
+  if (primary_key_id_ == key_id) {
     return ToStatusF(util::error::INVALID_ARGUMENT,
                      "Cannot destroy primary key (key_id %u).", key_id);
   }
-  for (auto& key : *(keyset_.mutable_key())) {
-    if (key.key_id() == key_id) {
-      if (key.status() != KeyStatusType::DISABLED &&
-          key.status() != KeyStatusType::DESTROYED &&
-          key.status() != KeyStatusType::ENABLED) {
-        return ToStatusF(util::error::INVALID_ARGUMENT,
-                         "Cannot destroy key with key_id %u and status %s.",
-                         key_id, Enums::KeyStatusName(key.status()));
-      }
-      key.clear_key_data();
-      key.set_status(KeyStatusType::DESTROYED);
-      return Status::OK;
-    }
+  int index = FindKey(key_id);
+  if (index < 0) {
+    return ToStatusF(util::error::NOT_FOUND,
+                     "No key with key_id %u found in the keyset.", key_id);
   }
-  return ToStatusF(util::error::NOT_FOUND,
-                   "No key with key_id %u found in the keyset.", key_id);
+  const Keyset::Key& key = *keys_[index];
+  if (key.status() != KeyStatusType::DISABLED &&
+      key.status() != KeyStatusType::DESTROYED &&
+      key.status() != KeyStatusType::ENABLED) {
+    return ToStatusF(util::error::INVALID_ARGUMENT,
+                     "Cannot destroy key with key_id %u and status %s.",
+                     key_id, Enums::KeyStatusName(key.status()));
+  }
+  auto new_key = std::make_shared<Keyset::Key>(key);
+  new_key->clear_key_data();
+  new_key->set_status(KeyStatusType::DESTROYED);
+  keys_[index] = std::move(new_key);
+  snapshot_.reset();
+  return Status::OK;
 }
 
 Status KeysetManager::SetPrimary(uint32_t key_id) {
   absl::MutexLock lock(&keyset_mutex_);
-  for (auto& key : keyset_.key()) {
-    if (key.key_id() == key_id) {
-      if (key.status() != KeyStatusType::ENABLED) {
-        return ToStatusF(util::error::INVALID_ARGUMENT,
-                         "The candidate for the primary key must be ENABLED"
-                         " (key_id %u).",
-                         key_id);
-      }
-      keyset_.set_primary_key_id(key_id);
-      return Status::OK;
-    }
+  int index = FindKey(key_id);
+  if (index < 0) {
+    return ToStatusF(util::error::NOT_FOUND,
+                     "No key with key_id %u found in the keyset.", key_id);
   }
-  return ToStatusF(util::error::NOT_FOUND,
-                   "No key with key_id %u found in the keyset.", key_id);
+  if (keys_[index]->status() != KeyStatusType::ENABLED) {
+    return ToStatusF(util::error::INVALID_ARGUMENT,
+                     "The candidate for the primary key must be ENABLED"
+                     " (key_id %u).",
+                     key_id);
+  }
+  primary_key_id_ = key_id;
+  snapshot_.reset();
+  return Status::OK;
 }
 
 
 int KeysetManager::KeyCount() const {
   absl::MutexLock lock(&keyset_mutex_);
-  return keyset_.key_size();
+  return keys_.size();
+}
+
+int KeysetManager::FindKey(uint32_t key_id) const {
+  for (size_t i = 0; i < keys_.size(); i++) {
+    if (keys_[i]->key_id() == key_id) return static_cast<int>(i);
+  }
+  return -1;
 }
 
 }  // namespace tink
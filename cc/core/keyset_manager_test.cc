@@ -230,5 +230,54 @@ TEST_F(KeysetManagerTest, testBasicOperations) {
   EXPECT_EQ(1, keyset_manager->KeyCount());
 }
 
+TEST_F(KeysetManagerTest, testHandlesShareSnapshotsAndStayIsolated) {
+  AesGcmKeyFormat key_format;
+  key_format.set_key_size(16);
+  KeyTemplate key_template;
+  key_template.set_type_url(AesGcmKeyManager().get_key_type());
+  key_template.set_output_prefix_type(OutputPrefixType::TINK);
+  key_template.set_value(key_format.SerializeAsString());
+
+  auto keyset_manager =
+      std::move(KeysetManager::New(key_template).ValueOrDie());
+
+  // Without an intervening mutation, handles share one immutable snapshot
+  // instead of each getting a deep copy of the keyset.
+  auto handle_1 = keyset_manager->GetKeysetHandle();
+  auto handle_2 = keyset_manager->GetKeysetHandle();
+  EXPECT_EQ(&TestKeysetHandle::GetKeyset(*handle_1),
+            &TestKeysetHandle::GetKeyset(*handle_2));
+
+  // A later mutation does not affect handles that were already returned.
+  auto add_result = keyset_manager->Add(key_template);
+  EXPECT_TRUE(add_result.ok()) << add_result.status();
+  EXPECT_EQ(1, TestKeysetHandle::GetKeyset(*handle_1).key().size());
+
+  auto handle_3 = keyset_manager->GetKeysetHandle();
+  EXPECT_EQ(2, TestKeysetHandle::GetKeyset(*handle_3).key().size());
+  EXPECT_NE(&TestKeysetHandle::GetKeyset(*handle_1),
+            &TestKeysetHandle::GetKeyset(*handle_3));
+
+  // A manager created from a handle adopts the keyset without copying it
+  // and sees the same contents.
+  auto keyset_manager_2 = std::move(
+      KeysetManager::New(*handle_3).ValueOrDie());
+  EXPECT_EQ(2, keyset_manager_2->KeyCount());
+  auto handle_4 = keyset_manager_2->GetKeysetHandle();
+  EXPECT_EQ(&TestKeysetHandle::GetKeyset(*handle_3),
+            &TestKeysetHandle::GetKeyset(*handle_4));
+
+  // Mutating the adopting manager copies only the touched entry and leaves
+  // the original handle untouched.
+  auto status = keyset_manager_2->Disable(
+      TestKeysetHandle::GetKeyset(*handle_3).key(1).key_id());
+  EXPECT_TRUE(status.ok()) << status;
+  EXPECT_EQ(KeyStatusType::ENABLED,
+            TestKeysetHandle::GetKeyset(*handle_3).key(1).status());
+  auto handle_5 = keyset_manager_2->GetKeysetHandle();
+  EXPECT_EQ(KeyStatusType::DISABLED,
+            TestKeysetHandle::GetKeyset(*handle_5).key(1).status());
+}
+
 }  // namespace tink
 }  // namespace crypto
@@ -0,0 +1,72 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/kms_client.h"
+
+#include <string>
+#include <utility>
+
+#include "gtest/gtest.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+#include "tink/util/test_matchers.h"
+#include "tink/util/test_util.h"
+
+namespace crypto {
+namespace tink {
+namespace {
+
+using crypto::tink::test::DummyKmsClient;
+using crypto::tink::test::IsOk;
+using crypto::tink::test::StatusIs;
+
+TEST(KmsClientTest, DefaultAsyncAeadAdaptsGetAead) {
+  std::string key_uri = "prefix1:some_key";
+  DummyKmsClient client("prefix1", key_uri);
+
+  auto async_aead_result = client.GetAsyncAead(key_uri);
+  ASSERT_THAT(async_aead_result.status(), IsOk());
+  auto async_aead = std::move(async_aead_result.ValueOrDie());
+
+  // The default implementation produces the same results as the Aead
+  // returned by GetAead().
+  std::string plaintext = "some plaintext";
+  std::string aad = "some aad";
+  auto future = async_aead->EncryptAsync(plaintext, aad);
+  auto ciphertext_result = future.get();
+  ASSERT_THAT(ciphertext_result.status(), IsOk());
+
+  auto aead = std::move(client.GetAead(key_uri).ValueOrDie());
+  auto decrypt_result = aead->Decrypt(ciphertext_result.ValueOrDie(), aad);
+  ASSERT_THAT(decrypt_result.status(), IsOk());
+  EXPECT_EQ(plaintext, decrypt_result.ValueOrDie());
+}
+
+TEST(KmsClientTest, DefaultAsyncAeadPropagatesErrors) {
+  DummyKmsClient client("prefix1", "prefix1:some_key");
+  auto async_aead_result = client.GetAsyncAead("unsupported_uri");
+  EXPECT_THAT(async_aead_result.status(),
+              StatusIs(util::error::INVALID_ARGUMENT));
+}
+
+TEST(KmsClientTest, DefaultMaxInFlightRequestsIsOne) {
+  DummyKmsClient client("prefix1", "prefix1:some_key");
+  EXPECT_EQ(1, client.max_in_flight_requests());
+}
+
+}  // namespace
+}  // namespace tink
+}  // namespace crypto
@@ -15,6 +15,9 @@
 ///////////////////////////////////////////////////////////////////////////////
 #include "tink/kms_clients.h"
 
+#include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "absl/strings/string_view.h"
@@ -43,6 +46,8 @@ Status KmsClients::LocalAdd(std::unique_ptr<KmsClient> kms_client) {
   }
   absl::MutexLock lock(&clients_mutex_);
   clients_.push_back(std::move(kms_client));
+  // Invalidate the snapshot; the next lookups will rebuild it.
+  std::atomic_store(&uri_cache_, std::shared_ptr<const UriCache>());
   return util::OkStatus();
 }
 
@@ -51,12 +56,30 @@ StatusOr<const KmsClient*> KmsClients::LocalGet(absl::string_view key_uri) {
     return Status(util::error::INVALID_ARGUMENT,
                   "key_uri must be non-empty.");
   }
+  std::string uri(key_uri);
+  auto cache = std::atomic_load(&uri_cache_);
+  if (cache != nullptr) {
+    auto it = cache->find(uri);
+    if (it != cache->end()) return it->second;
+  }
   absl::MutexLock lock(&clients_mutex_);
   for (const auto& client : clients_) {
-    if (client->DoesSupport(key_uri)) return client.get();
+    if (client->DoesSupport(key_uri)) {
+      // Publish a snapshot that also covers this URI, so the next lookup
+      // skips the DoesSupport-scan. Clients are never removed, so cached
+      // pointers stay valid; re-load the snapshot under the mutex in case
+      // another miss published a newer one in the meantime.
+      cache = std::atomic_load(&uri_cache_);
+      auto new_cache = cache == nullptr ? std::make_shared<UriCache>()
+                                        : std::make_shared<UriCache>(*cache);
+      (*new_cache)[uri] = client.get();
+      std::atomic_store(&uri_cache_,
+                        std::shared_ptr<const UriCache>(std::move(new_cache)));
+      return client.get();
+    }
   }
   return ToStatusF(util::error::NOT_FOUND, "no KmsClient found for key '%s'.",
-                   std::string(key_uri).c_str());
+                   uri.c_str());
 }
 
 }  // namespace tink
@@ -102,6 +102,32 @@ TEST(KmsClientsTest, AddAndGet) {
   EXPECT_FALSE(client_result.ValueOrDie()->DoesSupport(data_1.uri));
 }
 
+TEST(KmsClientsTest, CachedGetIsStable) {
+  UriData data = {"cached_prefix", "cached_prefix:uri1"};
+
+  auto status = KmsClients::Add(
+      absl::make_unique<DummyKmsClient>(data.prefix, data.uri));
+  EXPECT_THAT(status, IsOk());
+
+  // Repeated lookups of the same URI resolve to the same client.
+  auto client_result = KmsClients::Get(data.uri);
+  EXPECT_THAT(client_result.status(), IsOk());
+  const KmsClient* client = client_result.ValueOrDie();
+  for (int i = 0; i < 10; i++) {
+    client_result = KmsClients::Get(data.uri);
+    EXPECT_THAT(client_result.status(), IsOk());
+    EXPECT_EQ(client, client_result.ValueOrDie());
+  }
+
+  // Adding another client that also supports the URI does not change the
+  // result, as the first added client wins.
+  status = KmsClients::Add(
+      absl::make_unique<DummyKmsClient>(data.prefix, data.uri));
+  EXPECT_THAT(status, IsOk());
+  client_result = KmsClients::Get(data.uri);
+  EXPECT_THAT(client_result.status(), IsOk());
+  EXPECT_EQ(client, client_result.ValueOrDie());
+}
 
 }  // namespace
 }  // namespace tink
@@ -18,10 +18,12 @@
 
 #include <thread>  // NOLINT(build/c++11)
 
+#include "absl/memory/memory.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "tink/crypto_format.h"
 #include "tink/mac.h"
+#include "tink/memory_footprint.h"
 #include "tink/util/test_matchers.h"
 #include "tink/util/test_util.h"
 #include "proto/tink.pb.h"
@@ -257,6 +259,121 @@ TEST_F(PrimitiveSetTest, Basic) {
   }
 }
 
+TEST_F(PrimitiveSetTest, SealedLookups) {
+  uint32_t key_id_1 = 1234543;
+  KeysetInfo::KeyInfo key_1;
+  key_1.set_output_prefix_type(OutputPrefixType::TINK);
+  key_1.set_key_id(key_id_1);
+  key_1.set_status(KeyStatusType::ENABLED);
+
+  uint32_t key_id_2 = 7213743;
+  KeysetInfo::KeyInfo key_2;
+  key_2.set_output_prefix_type(OutputPrefixType::LEGACY);
+  key_2.set_key_id(key_id_2);
+  key_2.set_status(KeyStatusType::ENABLED);
+
+  uint32_t key_id_3 = 947327;
+  KeysetInfo::KeyInfo key_3;
+  key_3.set_output_prefix_type(OutputPrefixType::RAW);
+  key_3.set_key_id(key_id_3);
+  key_3.set_status(KeyStatusType::ENABLED);
+
+  PrimitiveSet<Mac> primitive_set;
+  EXPECT_FALSE(primitive_set.is_sealed());
+  EXPECT_TRUE(primitive_set
+                  .AddPrimitive(absl::make_unique<DummyMac>("MAC#1"), key_1)
+                  .ok());
+  EXPECT_TRUE(primitive_set
+                  .AddPrimitive(absl::make_unique<DummyMac>("MAC#2"), key_2)
+                  .ok());
+  EXPECT_TRUE(primitive_set
+                  .AddPrimitive(absl::make_unique<DummyMac>("MAC#3"), key_3)
+                  .ok());
+
+  primitive_set.Seal();
+  EXPECT_TRUE(primitive_set.is_sealed());
+  // Sealing twice is a no-op.
+  primitive_set.Seal();
+
+  std::string data = "some data";
+
+  {  // Lookups by prefix are served from the flat index.
+    std::string prefix = CryptoFormat::GetOutputPrefix(key_1).ValueOrDie();
+    auto& primitives = *(primitive_set.get_primitives(prefix).ValueOrDie());
+    EXPECT_EQ(1, primitives.size());
+    EXPECT_EQ(DummyMac("MAC#1").ComputeMac(data).ValueOrDie(),
+              primitives[0]->get_primitive().ComputeMac(data).ValueOrDie());
+
+    prefix = CryptoFormat::GetOutputPrefix(key_2).ValueOrDie();
+    auto& legacy_primitives =
+        *(primitive_set.get_primitives(prefix).ValueOrDie());
+    EXPECT_EQ(1, legacy_primitives.size());
+    EXPECT_EQ(key_2.key_id(), legacy_primitives[0]->get_key_id());
+  }
+
+  {  // Raw primitives are still reachable.
+    auto& primitives = *(primitive_set.get_raw_primitives().ValueOrDie());
+    EXPECT_EQ(1, primitives.size());
+    EXPECT_EQ(key_3.key_id(), primitives[0]->get_key_id());
+  }
+
+  // Unknown prefixes are rejected as before.
+  EXPECT_EQ(
+      util::error::NOT_FOUND,
+      primitive_set.get_primitives("\x01\x02\x03\x04\x05").status()
+          .error_code());
+
+  {  // The allocation-free lookup variants agree with the Status-based ones.
+    std::string prefix = CryptoFormat::GetOutputPrefix(key_1).ValueOrDie();
+    EXPECT_EQ(primitive_set.get_primitives(prefix).ValueOrDie(),
+              primitive_set.get_primitives_or_null(prefix));
+    EXPECT_EQ(primitive_set.get_raw_primitives().ValueOrDie(),
+              primitive_set.get_raw_primitives_or_null());
+    EXPECT_EQ(nullptr,
+              primitive_set.get_primitives_or_null("\x01\x02\x03\x04\x05"));
+  }
+
+  // The set cannot be modified anymore.
+  auto add_result =
+      primitive_set.AddPrimitive(absl::make_unique<DummyMac>("MAC#4"), key_1);
+  EXPECT_FALSE(add_result.ok());
+  EXPECT_EQ(util::error::FAILED_PRECONDITION, add_result.status().error_code());
+}
+
+TEST_F(PrimitiveSetTest, SealedLookupPrefilter) {
+  // The sealed lookup path rejects unknown prefixes via a 64-bit Bloom
+  // pre-filter before searching the index. Exercise both filter outcomes:
+  // a miss with a clear filter bit and a false positive which shares the
+  // output-prefix type and key-id high byte with a present key and must
+  // fall through to the index search.
+  PrimitiveSet<Mac> primitive_set;
+  std::vector<std::string> prefixes;
+  for (uint32_t i = 0; i < 100; i++) {
+    KeysetInfo::KeyInfo key_info;
+    key_info.set_output_prefix_type(OutputPrefixType::TINK);
+    key_info.set_key_id(0x01020000 + i);
+    key_info.set_status(KeyStatusType::ENABLED);
+    ASSERT_TRUE(
+        primitive_set.AddPrimitive(absl::make_unique<DummyMac>("MAC"), key_info)
+            .ok());
+    prefixes.push_back(CryptoFormat::GetOutputPrefix(key_info).ValueOrDie());
+  }
+  primitive_set.Seal();
+
+  for (const std::string& prefix : prefixes) {
+    EXPECT_NE(nullptr, primitive_set.get_primitives_or_null(prefix));
+  }
+  // Same type byte and key-id high byte as the present keys, but an absent
+  // key id: a potential filter false positive, resolved by the index.
+  EXPECT_EQ(nullptr,
+            primitive_set.get_primitives_or_null(std::string(
+                "\x01\x01\x02\xff\xff", 5)));
+  // A prefix unrelated to any present key.
+  EXPECT_EQ(nullptr,
+            primitive_set.get_primitives_or_null(std::string(
+                "\x01\xab\xcd\xef\x01", 5)));
+}
+
 TEST_F(PrimitiveSetTest, PrimaryKeyWithIdCollisions) {
   std::string mac_name_1 = "MAC#1";
   std::string mac_name_2 = "MAC#2";
@@ -290,14 +407,14 @@ TEST_F(PrimitiveSetTest, PrimaryKeyWithIdCollisions) {
     const auto& primitives =
         *(primitive_set.get_primitives(identifier).ValueOrDie());
     EXPECT_EQ(1, primitives.size());
-    EXPECT_EQ(primitive_set.get_primary(), primitives[0].get());
+    EXPECT_EQ(primitive_set.get_primary(), primitives[0]);
 
     //  Adding another primitive should not invalidate the primary.
     add_primitive_result =
         primitive_set.AddPrimitive(std::move(mac_2), key_info_2);
     EXPECT_TRUE(add_primitive_result.ok()) << add_primitive_result.status();
     EXPECT_EQ(2, primitives.size());
-    EXPECT_EQ(primitive_set.get_primary(), primitives[0].get());
+    EXPECT_EQ(primitive_set.get_primary(), primitives[0]);
   }
 
   {  // Test with TINK-keys.
@@ -320,14 +437,14 @@ TEST_F(PrimitiveSetTest, PrimaryKeyWithIdCollisions) {
     const auto& primitives =
         *(primitive_set.get_primitives(identifier).ValueOrDie());
     EXPECT_EQ(1, primitives.size());
-    EXPECT_EQ(primitive_set.get_primary(), primitives[0].get());
+    EXPECT_EQ(primitive_set.get_primary(), primitives[0]);
 
     //  Adding another primitive should not invalidate the primary.
     add_primitive_result =
         primitive_set.AddPrimitive(std::move(mac_2), key_info_2);
     EXPECT_TRUE(add_primitive_result.ok()) << add_primitive_result.status();
     EXPECT_EQ(2, primitives.size());
-    EXPECT_EQ(primitive_set.get_primary(), primitives[0].get());
+    EXPECT_EQ(primitive_set.get_primary(), primitives[0]);
   }
 
   {  // Test with LEGACY-keys.
@@ -350,14 +467,14 @@ TEST_F(PrimitiveSetTest, PrimaryKeyWithIdCollisions) {
     const auto& primitives =
         *(primitive_set.get_primitives(identifier).ValueOrDie());
     EXPECT_EQ(1, primitives.size());
-    EXPECT_EQ(primitive_set.get_primary(), primitives[0].get());
+    EXPECT_EQ(primitive_set.get_primary(), primitives[0]);
 
     //  Adding another primitive should not invalidate the primary.
     add_primitive_result =
         primitive_set.AddPrimitive(std::move(mac_2), key_info_2);
     EXPECT_TRUE(add_primitive_result.ok()) << add_primitive_result.status();
     EXPECT_EQ(2, primitives.size());
-    EXPECT_EQ(primitive_set.get_primary(), primitives[0].get());
+    EXPECT_EQ(primitive_set.get_primary(), primitives[0]);
   }
 }
 
@@ -424,7 +541,8 @@ TEST_F(PrimitiveSetTest, GetAll) {
   for (auto* entry : pset.get_all()) {
     auto mac_or = entry->get_primitive().ComputeMac("");
     ASSERT_THAT(mac_or.status(), IsOk());
-    mac_and_id.push_back({mac_or.ValueOrDie(), entry->get_identifier()});
+    mac_and_id.push_back(
+        {mac_or.ValueOrDie(), std::string(entry->get_identifier())});
   }
 
   // In the following id part, the first byte is 1 for Tink.
@@ -438,6 +556,135 @@ TEST_F(PrimitiveSetTest, GetAll) {
   EXPECT_THAT(mac_and_id, UnorderedElementsAreArray(expected_result));
 }
 
+TEST_F(PrimitiveSetTest, HitCounts) {
+  PrimitiveSet<Mac> pset;
+  auto entry1_or = pset.AddPrimitive(
+      absl::make_unique<DummyMac>("MAC1"),
+      CreateKey(0x01010101, OutputPrefixType::TINK, KeyStatusType::ENABLED));
+  ASSERT_THAT(entry1_or.status(), IsOk());
+  auto entry2_or = pset.AddPrimitive(
+      absl::make_unique<DummyMac>("MAC2"),
+      CreateKey(0x02020202, OutputPrefixType::RAW, KeyStatusType::ENABLED));
+  ASSERT_THAT(entry2_or.status(), IsOk());
+
+  // Fresh entries have never been hit.
+  EXPECT_EQ(0, entry1_or.ValueOrDie()->hit_count());
+  std::unordered_map<uint32_t, uint64_t> expected = {{0x01010101, 0},
+                                                     {0x02020202, 0}};
+  EXPECT_EQ(expected, pset.get_hit_counts());
+
+  entry1_or.ValueOrDie()->IncrementHitCount();
+  entry1_or.ValueOrDie()->IncrementHitCount();
+  entry2_or.ValueOrDie()->IncrementHitCount();
+
+  EXPECT_EQ(2, entry1_or.ValueOrDie()->hit_count());
+  EXPECT_EQ(1, entry2_or.ValueOrDie()->hit_count());
+  expected = {{0x01010101, 2}, {0x02020202, 1}};
+  EXPECT_EQ(expected, pset.get_hit_counts());
+}
+
+TEST_F(PrimitiveSetTest, HitCountsAggregateEntriesWithSameKeyId) {
+  PrimitiveSet<Mac> pset;
+  auto entry1_or = pset.AddPrimitive(
+      absl::make_unique<DummyMac>("MAC1"),
+      CreateKey(0x01010101, OutputPrefixType::TINK, KeyStatusType::ENABLED));
+  ASSERT_THAT(entry1_or.status(), IsOk());
+  auto entry2_or = pset.AddPrimitive(
+      absl::make_unique<DummyMac>("MAC2"),
+      CreateKey(0x01010101, OutputPrefixType::RAW, KeyStatusType::ENABLED));
+  ASSERT_THAT(entry2_or.status(), IsOk());
+
+  entry1_or.ValueOrDie()->IncrementHitCount();
+  entry2_or.ValueOrDie()->IncrementHitCount();
+
+  std::unordered_map<uint32_t, uint64_t> expected = {{0x01010101, 2}};
+  EXPECT_EQ(expected, pset.get_hit_counts());
+}
+
+// A DummyMac which additionally reports a fixed memory footprint.
+class SizedDummyMac : public DummyMac, public MemoryFootprintProvider {
+ public:
+  explicit SizedDummyMac(size_t footprint)
+      : DummyMac("sized MAC"), footprint_(footprint) {}
+  size_t MemoryFootprint() const override { return footprint_; }
+
+ private:
+  size_t footprint_;
+};
+
+TEST_F(PrimitiveSetTest, MemoryFootprint) {
+  PrimitiveSet<Mac> pset;
+  size_t empty = pset.MemoryFootprint();
+  EXPECT_GE(empty, sizeof(PrimitiveSet<Mac>));
+
+  ASSERT_THAT(pset.AddPrimitive(absl::make_unique<DummyMac>("MAC1"),
+                                CreateKey(0x01010101, OutputPrefixType::TINK,
+                                          KeyStatusType::ENABLED))
+                  .status(),
+              IsOk());
+  size_t with_plain = pset.MemoryFootprint();
+  // A primitive which does not report its own size still costs its entry.
+  EXPECT_GE(with_plain, empty + sizeof(PrimitiveSet<Mac>::Entry<Mac>));
+
+  ASSERT_THAT(pset.AddPrimitive(absl::make_unique<SizedDummyMac>(100000),
+                                CreateKey(0x02020202, OutputPrefixType::TINK,
+                                          KeyStatusType::ENABLED))
+                  .status(),
+              IsOk());
+  // A primitive implementing MemoryFootprintProvider adds its reported size.
+  EXPECT_GE(pset.MemoryFootprint(),
+            with_plain + sizeof(PrimitiveSet<Mac>::Entry<Mac>) + 100000);
+}
+
+TEST_F(PrimitiveSetTest, BuilderProducesSealedSetWithPrimary) {
+  PrimitiveSet<Mac>::Builder builder;
+  builder
+      .AddPrimitive(absl::make_unique<DummyMac>("MAC1"),
+                    CreateKey(0x01010101, OutputPrefixType::TINK,
+                              KeyStatusType::ENABLED))
+      .AddPrimaryPrimitive(absl::make_unique<DummyMac>("MAC2"),
+                           CreateKey(0x02020202, OutputPrefixType::TINK,
+                                     KeyStatusType::ENABLED))
+      .AddLazyPrimitive(
+          []() -> crypto::tink::util::StatusOr<std::unique_ptr<Mac>> {
+            return {absl::make_unique<DummyMac>("MAC3")};
+          },
+          CreateKey(0x03030303, OutputPrefixType::RAW,
+                    KeyStatusType::ENABLED));
+  auto pset_or = std::move(builder).Build();
+  ASSERT_THAT(pset_or.status(), IsOk());
+  auto pset = std::move(pset_or.ValueOrDie());
+
+  EXPECT_TRUE(pset->is_sealed());
+  ASSERT_NE(pset->get_primary(), nullptr);
+  EXPECT_EQ(pset->get_primary()->get_key_id(), 0x02020202);
+  // The sealed read path serves both prefixed and RAW lookups.
+  EXPECT_NE(pset->get_primitives_or_null(pset->get_primary()->get_identifier()),
+            nullptr);
+  ASSERT_NE(pset->get_raw_primitives_or_null(), nullptr);
+  auto mac_or = (*pset->get_raw_primitives_or_null())[0]->primitive_or_status();
+  ASSERT_THAT(mac_or.status(), IsOk());
+  // Sealed sets cannot grow.
+  EXPECT_FALSE(pset->AddPrimitive(absl::make_unique<DummyMac>("MAC4"),
+                                  CreateKey(0x04040404, OutputPrefixType::TINK,
+                                            KeyStatusType::ENABLED))
+                   .ok());
+}
+
+TEST_F(PrimitiveSetTest, BuilderReportsFirstError) {
+  PrimitiveSet<Mac>::Builder builder;
+  builder
+      .AddPrimitive(absl::make_unique<DummyMac>("MAC1"),
+                    CreateKey(0x01010101, OutputPrefixType::TINK,
+                              KeyStatusType::DISABLED))
+      .AddPrimaryPrimitive(absl::make_unique<DummyMac>("MAC2"),
+                           CreateKey(0x02020202, OutputPrefixType::TINK,
+                                     KeyStatusType::ENABLED));
+  auto pset_or = std::move(builder).Build();
+  EXPECT_FALSE(pset_or.ok());
+  EXPECT_EQ(pset_or.status().error_code(), util::error::INVALID_ARGUMENT);
+}
+
 }  // namespace
 }  // namespace tink
 }  // namespace crypto
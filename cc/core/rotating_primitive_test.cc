@@ -0,0 +1,92 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/rotating_primitive.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "tink/aead.h"
+#include "tink/aead/aead_config.h"
+#include "tink/aead/aead_key_templates.h"
+#include "tink/keyset_manager.h"
+#include "tink/util/test_matchers.h"
+
+namespace crypto {
+namespace tink {
+namespace {
+
+using ::crypto::tink::test::IsOk;
+
+class RotatingPrimitiveTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() { ASSERT_THAT(AeadConfig::Register(), IsOk()); }
+};
+
+TEST_F(RotatingPrimitiveTest, Basic) {
+  auto manager = KeysetManager::New(AeadKeyTemplates::Aes128Gcm())
+                     .ValueOrDie();
+  auto holder = RotatingPrimitive<Aead>::New(manager.get()).ValueOrDie();
+
+  std::string plaintext = "some plaintext";
+  std::string aad = "some aad";
+  auto aead = holder->get();
+  std::string ciphertext = aead->Encrypt(plaintext, aad).ValueOrDie();
+  EXPECT_EQ(plaintext, aead->Decrypt(ciphertext, aad).ValueOrDie());
+}
+
+TEST_F(RotatingPrimitiveTest, RotationTakesEffectAfterRefresh) {
+  auto manager = KeysetManager::New(AeadKeyTemplates::Aes128Gcm())
+                     .ValueOrDie();
+  auto holder = RotatingPrimitive<Aead>::New(manager.get()).ValueOrDie();
+
+  std::string plaintext = "some plaintext";
+  std::string aad = "some aad";
+  std::string old_ciphertext =
+      holder->get()->Encrypt(plaintext, aad).ValueOrDie();
+
+  // A primitive obtained before the rotation stays usable throughout.
+  auto old_aead = holder->get();
+
+  ASSERT_THAT(manager->Rotate(AeadKeyTemplates::Aes128Gcm()).status(),
+              IsOk());
+  ASSERT_THAT(holder->Refresh(), IsOk());
+
+  auto new_aead = holder->get();
+  EXPECT_NE(old_aead.get(), new_aead.get());
+
+  // Ciphertexts from before the rotation still decrypt: the old key
+  // remains ENABLED in the keyset.
+  EXPECT_EQ(plaintext,
+            new_aead->Decrypt(old_ciphertext, aad).ValueOrDie());
+  // New encryptions carry the new primary's prefix, so the pre-rotation
+  // primitive cannot decrypt them.
+  std::string new_ciphertext =
+      new_aead->Encrypt(plaintext, aad).ValueOrDie();
+  EXPECT_FALSE(old_aead->Decrypt(new_ciphertext, aad).ok());
+  // And the old primitive keeps working for in-flight operations.
+  EXPECT_EQ(plaintext,
+            old_aead->Decrypt(old_ciphertext, aad).ValueOrDie());
+}
+
+TEST_F(RotatingPrimitiveTest, NullManager) {
+  auto holder_result = RotatingPrimitive<Aead>::New(nullptr);
+  EXPECT_FALSE(holder_result.ok());
+}
+
+}  // namespace
+}  // namespace tink
+}  // namespace crypto
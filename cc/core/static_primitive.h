@@ -0,0 +1,167 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+#ifndef TINK_CORE_STATIC_PRIMITIVE_H_
+#define TINK_CORE_STATIC_PRIMITIVE_H_
+
+#include <memory>
+#include <utility>
+
+#include "absl/base/call_once.h"
+#include "absl/strings/str_cat.h"
+#include "tink/core/key_type_manager.h"
+#include "tink/core/template_util.h"
+#include "tink/internal/fips_utils.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+#include "proto/tink.pb.h"
+
+namespace crypto {
+namespace tink {
+
+namespace internal {
+
+// Yields the first primitive of a KeyTypeManager's PrimitiveList, which
+// serves as the default primitive for GetPrimitiveStatically.
+template <typename PrimitiveList>
+struct FirstPrimitive;
+template <typename First, typename... Rest>
+struct FirstPrimitive<List<First, Rest...>> {
+  using type = First;
+};
+
+}  // namespace internal
+
+// Creates a primitive for 'key_data' with the key type manager given as a
+// template argument, bypassing the Registry. In contrast to
+// Registry::GetPrimitive, the key type is resolved at compile time: no
+// Config::Register()-call is needed, no registry lookup happens, and the
+// key manager is statically known to the compiler. This is useful for
+// binaries whose keysets always use a fixed, known key type.
+//
+// The 'Primitive' argument defaults to the first primitive of the key type
+// manager and rarely needs to be given explicitly. For example:
+//
+//   auto aead = GetPrimitiveStatically<AesGcmKeyManager>(key_data);
+//
+// Keys of any other type are rejected with INVALID_ARGUMENT, so a binary
+// using this helper cannot transparently pick up new key types from key
+// rotation; use the Registry when that flexibility is needed.
+template <typename KeyTypeManagerT,
+          typename Primitive = typename internal::FirstPrimitive<
+              typename KeyTypeManagerT::PrimitiveList>::type>
+crypto::tink::util::StatusOr<std::unique_ptr<Primitive>>
+GetPrimitiveStatically(const google::crypto::tink::KeyData& key_data) {
+  static const KeyTypeManagerT* const key_type_manager = new KeyTypeManagerT();
+  auto fips_status =
+      internal::ChecksFipsCompatibility(key_type_manager->FipsStatus());
+  if (!fips_status.ok()) return fips_status;
+  if (key_data.type_url() != key_type_manager->get_key_type()) {
+    return crypto::tink::util::Status(
+        util::error::INVALID_ARGUMENT,
+        absl::StrCat("Key type '", key_data.type_url(),
+                     "' is not supported by this manager."));
+  }
+  typename KeyTypeManagerT::KeyProto key_proto;
+  if (!key_proto.ParseFromString(key_data.value())) {
+    return crypto::tink::util::Status(
+        util::error::INVALID_ARGUMENT,
+        absl::StrCat("Could not parse key_data.value as key type '",
+                     key_data.type_url(), "'."));
+  }
+  auto validation = key_type_manager->ValidateKey(key_proto);
+  if (!validation.ok()) return validation;
+  return key_type_manager->template GetPrimitive<Primitive>(key_proto);
+}
+
+// Holds a primitive for a fixed key, with the key type manager bound at
+// compile time, for declaration at namespace scope. Constructing a StaticKey
+// only stores the given key provider; the key material is requested and the
+// primitive is built on the first call to GetPrimitive(), at most once.
+// Subsequent calls return the cached primitive without locking (beyond the
+// call_once fast path) and without touching the Registry.
+//
+// For example:
+//
+//   const StaticKey<AesGcmKeyManager> kStorageKey(+[] {
+//     google::crypto::tink::AesGcmKey key;
+//     key.set_version(0);
+//     key.set_key_value(ReadKeyBytesFromSecureStorage());
+//     return key;
+//   });
+//
+//   ...
+//   auto aead = kStorageKey.GetPrimitive();
+//   if (!aead.ok()) return aead.status();
+//   auto ciphertext = (*aead.ValueOrDie()).Encrypt(plaintext, aad);
+//
+// The returned pointer remains valid for the lifetime of the StaticKey.
+template <typename KeyTypeManagerT,
+          typename Primitive = typename internal::FirstPrimitive<
+              typename KeyTypeManagerT::PrimitiveList>::type>
+class StaticKey {
+ public:
+  using KeyProto = typename KeyTypeManagerT::KeyProto;
+
+  explicit StaticKey(KeyProto (*key_provider)())
+      : key_provider_(key_provider) {}
+
+  StaticKey(const StaticKey&) = delete;
+  StaticKey& operator=(const StaticKey&) = delete;
+
+  // Returns the primitive for the provided key, building it on first use.
+  // The returned status is sticky: if validation or construction fails, all
+  // subsequent calls return the same error.
+  crypto::tink::util::StatusOr<const Primitive*> GetPrimitive() const {
+    absl::call_once(once_, [this]() { Init(); });
+    if (!status_.ok()) return status_;
+    return primitive_.get();
+  }
+
+ private:
+  void Init() const {
+    static const KeyTypeManagerT* const key_type_manager =
+        new KeyTypeManagerT();
+    auto fips_status =
+        internal::ChecksFipsCompatibility(key_type_manager->FipsStatus());
+    if (!fips_status.ok()) {
+      status_ = fips_status;
+      return;
+    }
+    KeyProto key_proto = key_provider_();
+    auto validation = key_type_manager->ValidateKey(key_proto);
+    if (!validation.ok()) {
+      status_ = validation;
+      return;
+    }
+    auto primitive =
+        key_type_manager->template GetPrimitive<Primitive>(key_proto);
+    if (!primitive.ok()) {
+      status_ = primitive.status();
+      return;
+    }
+    primitive_ = std::move(primitive.ValueOrDie());
+  }
+
+  KeyProto (*key_provider_)();
+  mutable absl::once_flag once_;
+  mutable std::unique_ptr<const Primitive> primitive_;
+  mutable crypto::tink::util::Status status_;
+};
+
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_CORE_STATIC_PRIMITIVE_H_
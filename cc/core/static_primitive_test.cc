@@ -0,0 +1,137 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/core/static_primitive.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "tink/aead.h"
+#include "tink/aead/aes_gcm_key_manager.h"
+#include "tink/util/status.h"
+#include "tink/util/test_matchers.h"
+#include "proto/aes_gcm.pb.h"
+#include "proto/tink.pb.h"
+
+namespace crypto {
+namespace tink {
+namespace {
+
+using ::crypto::tink::test::IsOk;
+using ::crypto::tink::test::StatusIs;
+using ::google::crypto::tink::AesGcmKey;
+using ::google::crypto::tink::AesGcmKeyFormat;
+using ::google::crypto::tink::KeyData;
+
+KeyData NewAesGcmKeyData() {
+  AesGcmKeyFormat key_format;
+  key_format.set_key_size(32);
+  auto key = AesGcmKeyManager().CreateKey(key_format).ValueOrDie();
+  KeyData key_data;
+  key_data.set_type_url(AesGcmKeyManager().get_key_type());
+  key_data.set_value(key.SerializeAsString());
+  key_data.set_key_material_type(AesGcmKeyManager().key_material_type());
+  return key_data;
+}
+
+TEST(StaticPrimitiveTest, GetPrimitiveStatically) {
+  KeyData key_data = NewAesGcmKeyData();
+  // No registration whatsoever; the manager is bound at compile time.
+  auto aead_result = GetPrimitiveStatically<AesGcmKeyManager>(key_data);
+  ASSERT_THAT(aead_result.status(), IsOk());
+  auto aead = std::move(aead_result.ValueOrDie());
+
+  std::string plaintext = "some plaintext";
+  std::string aad = "some aad";
+  auto encrypt_result = aead->Encrypt(plaintext, aad);
+  ASSERT_THAT(encrypt_result.status(), IsOk());
+  auto decrypt_result = aead->Decrypt(encrypt_result.ValueOrDie(), aad);
+  ASSERT_THAT(decrypt_result.status(), IsOk());
+  EXPECT_EQ(plaintext, decrypt_result.ValueOrDie());
+}
+
+TEST(StaticPrimitiveTest, ExplicitPrimitive) {
+  KeyData key_data = NewAesGcmKeyData();
+  // The primitive can also be selected explicitly, for managers supporting
+  // several primitives.
+  auto aead_result = GetPrimitiveStatically<AesGcmKeyManager, Aead>(key_data);
+  EXPECT_THAT(aead_result.status(), IsOk());
+}
+
+AesGcmKey NewAesGcmKey() {
+  AesGcmKeyFormat key_format;
+  key_format.set_key_size(32);
+  return AesGcmKeyManager().CreateKey(key_format).ValueOrDie();
+}
+
+AesGcmKey NewInvalidAesGcmKey() {
+  AesGcmKey key = NewAesGcmKey();
+  key.set_key_value("too short");
+  return key;
+}
+
+// Constructing these does no crypto work; the keys are requested and the
+// primitives built on first use.
+const StaticKey<AesGcmKeyManager> kStaticAead(NewAesGcmKey);
+const StaticKey<AesGcmKeyManager> kInvalidStaticAead(NewInvalidAesGcmKey);
+
+TEST(StaticKeyTest, GetPrimitive) {
+  auto aead_result = kStaticAead.GetPrimitive();
+  ASSERT_THAT(aead_result.status(), IsOk());
+  const Aead* aead = aead_result.ValueOrDie();
+
+  std::string plaintext = "some plaintext";
+  std::string aad = "some aad";
+  auto encrypt_result = aead->Encrypt(plaintext, aad);
+  ASSERT_THAT(encrypt_result.status(), IsOk());
+  auto decrypt_result = aead->Decrypt(encrypt_result.ValueOrDie(), aad);
+  ASSERT_THAT(decrypt_result.status(), IsOk());
+  EXPECT_EQ(plaintext, decrypt_result.ValueOrDie());
+
+  // Repeated calls return the same cached primitive.
+  auto second_result = kStaticAead.GetPrimitive();
+  ASSERT_THAT(second_result.status(), IsOk());
+  EXPECT_EQ(aead, second_result.ValueOrDie());
+}
+
+TEST(StaticKeyTest, InvalidKey) {
+  // The error from key validation is sticky.
+  auto aead_result = kInvalidStaticAead.GetPrimitive();
+  EXPECT_THAT(aead_result.status(),
+              StatusIs(util::error::INVALID_ARGUMENT));
+  EXPECT_THAT(kInvalidStaticAead.GetPrimitive().status(),
+              StatusIs(util::error::INVALID_ARGUMENT));
+}
+
+TEST(StaticPrimitiveTest, WrongKeyType) {
+  KeyData key_data = NewAesGcmKeyData();
+  key_data.set_type_url("type.googleapis.com/some.other.KeyType");
+  auto aead_result = GetPrimitiveStatically<AesGcmKeyManager>(key_data);
+  EXPECT_THAT(aead_result.status(),
+              StatusIs(util::error::INVALID_ARGUMENT));
+}
+
+TEST(StaticPrimitiveTest, CorruptedKey) {
+  KeyData key_data = NewAesGcmKeyData();
+  key_data.set_value("corrupted serialized key proto");
+  auto aead_result = GetPrimitiveStatically<AesGcmKeyManager>(key_data);
+  EXPECT_THAT(aead_result.status(),
+              StatusIs(util::error::INVALID_ARGUMENT));
+}
+
+}  // namespace
+}  // namespace tink
+}  // namespace crypto
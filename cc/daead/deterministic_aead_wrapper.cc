@@ -16,10 +16,14 @@
 
 #include "tink/daead/deterministic_aead_wrapper.h"
 
+#include "absl/strings/str_cat.h"
 #include "tink/crypto_format.h"
 #include "tink/deterministic_aead.h"
+#include "tink/internal/monitoring.h"
+#include "tink/internal/registry_metrics.h"
 #include "tink/primitive_set.h"
 #include "tink/subtle/subtle_util_boringssl.h"
+#include "tink/util/errors.h"
 #include "tink/util/status.h"
 #include "tink/util/statusor.h"
 
@@ -67,12 +71,18 @@ DeterministicAeadSetWrapper::EncryptDeterministically(
   plaintext = subtle::SubtleUtilBoringSSL::EnsureNonNull(plaintext);
   associated_data = subtle::SubtleUtilBoringSSL::EnsureNonNull(associated_data);
 
+  internal::MonitoredOp monitored_op("daead.encrypt",
+                                     daead_set_->get_primary()->get_key_id());
   auto encrypt_result =
       daead_set_->get_primary()->get_primitive().EncryptDeterministically(
           plaintext, associated_data);
-  if (!encrypt_result.ok()) return encrypt_result.status();
-  const std::string& key_id = daead_set_->get_primary()->get_identifier();
-  return key_id + encrypt_result.ValueOrDie();
+  if (!encrypt_result.ok()) {
+    monitored_op.SetFailed();
+    return encrypt_result.status();
+  }
+  daead_set_->get_primary()->IncrementHitCount();
+  absl::string_view key_id = daead_set_->get_primary()->get_identifier();
+  return absl::StrCat(key_id, encrypt_result.ValueOrDie());
 }
 
 util::StatusOr<std::string>
@@ -82,18 +92,37 @@ DeterministicAeadSetWrapper::DecryptDeterministically(
   // regardless of whether the size is 0.
   associated_data = subtle::SubtleUtilBoringSSL::EnsureNonNull(associated_data);
 
+  // Until a key matches, failures are attributed to key id 0.
+  internal::MonitoredOp monitored_op("daead.decrypt", /* key_id = */ 0);
+
+  // Records the number of keys tried into the trial-decryption counters
+  // on every return path.
+  struct TrialDepthRecorder {
+    int attempts = 0;
+    ~TrialDepthRecorder() {
+      internal::RegistryMetrics::Global().RecordTrialDecrypt(attempts);
+    }
+  } trial_depth;
+
   if (ciphertext.length() > CryptoFormat::kNonRawPrefixSize) {
     absl::string_view key_id =
         ciphertext.substr(0, CryptoFormat::kNonRawPrefixSize);
-    auto primitives_result = daead_set_->get_primitives(key_id);
-    if (primitives_result.ok()) {
+    const auto* primitives = daead_set_->get_primitives_or_null(key_id);
+    if (primitives != nullptr) {
       absl::string_view raw_ciphertext =
           ciphertext.substr(CryptoFormat::kNonRawPrefixSize);
-      for (auto& daead_entry : *(primitives_result.ValueOrDie())) {
-        DeterministicAead& daead = daead_entry->get_primitive();
+      for (auto& daead_entry : *primitives) {
+        auto daead_or = daead_entry->primitive_or_status();
+        // Skip entries whose lazy materialization failed; RAW keys below may
+        // still succeed.
+        if (!daead_or.ok()) continue;
+        DeterministicAead& daead = *daead_or.ValueOrDie();
+        trial_depth.attempts++;
         auto decrypt_result =
             daead.DecryptDeterministically(raw_ciphertext, associated_data);
         if (decrypt_result.ok()) {
+          daead_entry->IncrementHitCount();
+          monitored_op.set_key_id(daead_entry->get_key_id());
           return std::move(decrypt_result.ValueOrDie());
         } else {
           // LOG that a matching key didn't decrypt the ciphertext.
@@ -103,18 +132,24 @@ DeterministicAeadSetWrapper::DecryptDeterministically(
   }
 
   // No matching key succeeded with decryption, try all RAW keys.
-  auto raw_primitives_result = daead_set_->get_raw_primitives();
-  if (raw_primitives_result.ok()) {
-    for (auto& daead_entry : *(raw_primitives_result.ValueOrDie())) {
-      DeterministicAead& daead = daead_entry->get_primitive();
+  const auto* raw_primitives = daead_set_->get_raw_primitives_or_null();
+  if (raw_primitives != nullptr) {
+    for (auto& daead_entry : *raw_primitives) {
+      auto daead_or = daead_entry->primitive_or_status();
+      if (!daead_or.ok()) continue;
+      DeterministicAead& daead = *daead_or.ValueOrDie();
+      trial_depth.attempts++;
       auto decrypt_result =
           daead.DecryptDeterministically(ciphertext, associated_data);
       if (decrypt_result.ok()) {
+        daead_entry->IncrementHitCount();
+        monitored_op.set_key_id(daead_entry->get_key_id());
         return std::move(decrypt_result.ValueOrDie());
       }
     }
   }
-  return util::Status(util::error::INVALID_ARGUMENT, "decryption failed");
+  monitored_op.SetFailed();
+  return DecryptionFailedStatus();
 }
 
 }  // anonymous namespace
@@ -124,6 +159,7 @@ DeterministicAeadWrapper::Wrap(
     std::unique_ptr<PrimitiveSet<DeterministicAead>> primitive_set) const {
   util::Status status = Validate(primitive_set.get());
   if (!status.ok()) return status;
+  primitive_set->Seal();
   std::unique_ptr<DeterministicAead> daead(
       new DeterministicAeadSetWrapper(std::move(primitive_set)));
   return std::move(daead);
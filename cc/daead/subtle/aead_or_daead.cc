@@ -53,6 +53,22 @@ struct DecryptFunctor {
                                                     associated_data);
   }
 };
+
+// Functor implementing Decryption of a given ciphertext into a caller buffer.
+struct DecryptIntoFunctor {
+  crypto::tink::util::StatusOr<size_t> operator()(
+      absl::string_view ciphertext, absl::string_view associated_data,
+      absl::Span<char> out, const std::unique_ptr<const Aead>& aead_primitive) {
+    return aead_primitive->DecryptInto(ciphertext, associated_data, out);
+  }
+  crypto::tink::util::StatusOr<size_t> operator()(
+      absl::string_view ciphertext, absl::string_view associated_data,
+      absl::Span<char> out,
+      const std::unique_ptr<const DeterministicAead>& aead_primitive) {
+    return aead_primitive->DecryptDeterministicallyInto(ciphertext,
+                                                        associated_data, out);
+  }
+};
 }  // namespace
 
 crypto::tink::util::StatusOr<std::string> AeadOrDaead::Encrypt(
@@ -69,6 +85,14 @@ crypto::tink::util::StatusOr<std::string> AeadOrDaead::Decrypt(
       primitive_variant_);
 }
 
+crypto::tink::util::StatusOr<size_t> AeadOrDaead::DecryptInto(
+    absl::string_view ciphertext, absl::string_view associated_data,
+    absl::Span<char> out) const {
+  return absl::visit(
+      absl::bind_front(DecryptIntoFunctor(), ciphertext, associated_data, out),
+      primitive_variant_);
+}
+
 }  // namespace subtle
 }  // namespace tink
 }  // namespace crypto
@@ -19,6 +19,7 @@
 
 #include <memory>
 
+#include "absl/types/span.h"
 #include "absl/types/variant.h"
 #include "tink/aead.h"
 #include "tink/deterministic_aead.h"
@@ -49,6 +50,13 @@ class AeadOrDaead {
   crypto::tink::util::StatusOr<std::string> Decrypt(
       absl::string_view ciphertext, absl::string_view associated_data) const;
 
+  // Decrypts 'ciphertext' using the underlying aead or determnistic aead
+  // primitive, writing the plaintext into the caller-provided buffer 'out'
+  // and returning the number of bytes written; see Aead::DecryptInto().
+  crypto::tink::util::StatusOr<size_t> DecryptInto(
+      absl::string_view ciphertext, absl::string_view associated_data,
+      absl::Span<char> out) const;
+
  private:
   absl::variant<std::unique_ptr<const Aead>,
                 std::unique_ptr<const DeterministicAead>>
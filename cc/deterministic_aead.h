@@ -17,7 +17,11 @@
 #ifndef TINK_DETERMINISTIC_AEAD_H_
 #define TINK_DETERMINISTIC_AEAD_H_
 
+#include <cstring>
+
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "tink/util/status.h"
 #include "tink/util/statusor.h"
 
 namespace crypto {
@@ -51,6 +55,95 @@ class DeterministicAead {
       absl::string_view ciphertext,
       absl::string_view associated_data) const = 0;
 
+  // A conservative upper bound on the ciphertext overhead (output prefix and
+  // synthetic IV) of all DeterministicAead implementations provided by Tink;
+  // used by the default MaxEncryptionSize() below.
+  static constexpr size_t kMaxCiphertextOverhead = 128;
+
+  // Returns an upper bound on the size of the ciphertext for a plaintext of
+  // the given size. The default bound is conservative; implementations which
+  // know their exact overhead should override this.
+  virtual size_t MaxEncryptionSize(size_t plaintext_size) const {
+    return plaintext_size + kMaxCiphertextOverhead;
+  }
+
+  // Encrypts 'plaintext' with 'associated_data' as associated data
+  // deterministically, writing the ciphertext into the caller-provided buffer
+  // 'out', and returns the number of bytes written. 'out' must be at least
+  // MaxEncryptionSize(plaintext.size()) bytes long and must not overlap
+  // 'plaintext'. The default implementation falls back to
+  // EncryptDeterministically() and copies; implementations should override it
+  // to write the ciphertext directly into 'out' so that callers can reuse
+  // preallocated buffers.
+  virtual crypto::tink::util::StatusOr<size_t> EncryptDeterministicallyInto(
+      absl::string_view plaintext, absl::string_view associated_data,
+      absl::Span<char> out) const {
+    auto ciphertext = EncryptDeterministically(plaintext, associated_data);
+    if (!ciphertext.ok()) return ciphertext.status();
+    if (out.size() < ciphertext.ValueOrDie().size()) {
+      return crypto::tink::util::Status(
+          crypto::tink::util::error::INVALID_ARGUMENT,
+          "Output buffer too small.");
+    }
+    memcpy(out.data(), ciphertext.ValueOrDie().data(),
+           ciphertext.ValueOrDie().size());
+    return ciphertext.ValueOrDie().size();
+  }
+
+  // Encrypts every entry of 'plaintexts' with the same 'associated_data'
+  // deterministically, writing the ciphertexts back to back into the
+  // caller-provided buffer 'out' and the size of the i-th ciphertext into
+  // 'ciphertext_sizes[i]'; returns the total number of bytes written.
+  // 'ciphertext_sizes' must have at least plaintexts.size() entries, and
+  // 'out' must be at least the sum of MaxEncryptionSize() over all
+  // plaintexts bytes long. The contiguous output layout lets columnar
+  // callers encrypt a whole column into one preallocated arena. The default
+  // implementation loops over EncryptDeterministicallyInto();
+  // implementations should override it when they can amortize per-call
+  // setup over the batch.
+  virtual crypto::tink::util::StatusOr<size_t> EncryptDeterministicallyBatch(
+      absl::Span<const absl::string_view> plaintexts,
+      absl::string_view associated_data, absl::Span<char> out,
+      absl::Span<size_t> ciphertext_sizes) const {
+    if (ciphertext_sizes.size() < plaintexts.size()) {
+      return crypto::tink::util::Status(
+          crypto::tink::util::error::INVALID_ARGUMENT,
+          "ciphertext_sizes buffer too small.");
+    }
+    size_t written = 0;
+    for (size_t i = 0; i < plaintexts.size(); ++i) {
+      auto size = EncryptDeterministicallyInto(plaintexts[i], associated_data,
+                                               out.subspan(written));
+      if (!size.ok()) return size.status();
+      ciphertext_sizes[i] = size.ValueOrDie();
+      written += size.ValueOrDie();
+    }
+    return written;
+  }
+
+  // Decrypts 'ciphertext' with 'associated_data' as associated data
+  // deterministically, writing the plaintext into the caller-provided buffer
+  // 'out', and returns the number of bytes written. 'out' must be at least
+  // ciphertext.size() bytes long and must not overlap 'ciphertext'. On
+  // failure the contents of 'out' are unspecified. The default implementation
+  // falls back to DecryptDeterministically() and copies; implementations
+  // should override it to write the plaintext directly into 'out' so that
+  // callers can reuse preallocated buffers.
+  virtual crypto::tink::util::StatusOr<size_t> DecryptDeterministicallyInto(
+      absl::string_view ciphertext, absl::string_view associated_data,
+      absl::Span<char> out) const {
+    auto plaintext = DecryptDeterministically(ciphertext, associated_data);
+    if (!plaintext.ok()) return plaintext.status();
+    if (out.size() < plaintext.ValueOrDie().size()) {
+      return crypto::tink::util::Status(
+          crypto::tink::util::error::INVALID_ARGUMENT,
+          "Output buffer too small.");
+    }
+    memcpy(out.data(), plaintext.ValueOrDie().data(),
+           plaintext.ValueOrDie().size());
+    return plaintext.ValueOrDie().size();
+  }
+
   virtual ~DeterministicAead() {}
 };
 
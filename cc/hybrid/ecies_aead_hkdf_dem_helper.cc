@@ -65,8 +65,19 @@ class EciesAeadHkdfDemHelperImpl : public EciesAeadHkdfDemHelper {
     }
     const KeyManager<EncryptionPrimitive>* key_manager =
         key_manager_or.ValueOrDie();
-    return {absl::make_unique<EciesAeadHkdfDemHelperImpl<EncryptionPrimitive>>(
-        key_manager, dem_key_template, key_params)};
+    auto helper =
+        absl::make_unique<EciesAeadHkdfDemHelperImpl<EncryptionPrimitive>>(
+            key_manager, dem_key_template, key_params);
+    // Build the key proto from the template once; GetAeadOrDaead then copies
+    // this prototype instead of parsing the serialized template (and
+    // generating random key material that gets overwritten anyway) for
+    // every derived key.
+    auto key_or =
+        key_manager->get_key_factory().NewKey(dem_key_template.value());
+    if (!key_or.ok()) return key_or.status();
+    helper->key_proto_prototype_ = std::move(key_or).ValueOrDie();
+    helper->ZeroKeyBytes(helper->key_proto_prototype_.get());
+    return {std::move(helper)};
   }
 
   EciesAeadHkdfDemHelperImpl(
@@ -84,9 +95,9 @@ class EciesAeadHkdfDemHelperImpl : public EciesAeadHkdfDemHelper {
       return util::Status(util::error::INTERNAL,
                           "Wrong length of symmetric key.");
     }
-    auto key_or = key_manager_->get_key_factory().NewKey(key_template_.value());
-    if (!key_or.ok()) return key_or.status();
-    auto key = std::move(key_or).ValueOrDie();
+    std::unique_ptr<portable_proto::MessageLite> key(
+        key_proto_prototype_->New());
+    key->CheckTypeAndMergeFrom(*key_proto_prototype_);
     if (!ReplaceKeyBytes(symmetric_key_value, key.get())) {
       return util::Status(util::error::INTERNAL,
                           "Generation of DEM-key failed.");
@@ -102,6 +113,9 @@ class EciesAeadHkdfDemHelperImpl : public EciesAeadHkdfDemHelper {
 
  private:
   const KeyManager<EncryptionPrimitive>* key_manager_;  // not owned
+  // Key proto built from the DEM key template at construction time, with
+  // all key material fields cleared.
+  std::unique_ptr<portable_proto::MessageLite> key_proto_prototype_;
 };
 
 }  // namespace
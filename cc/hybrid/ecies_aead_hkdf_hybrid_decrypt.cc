@@ -81,22 +81,25 @@ util::StatusOr<std::unique_ptr<HybridDecrypt>> EciesAeadHkdfHybridDecrypt::New(
       std::move(dem_result).ValueOrDie()))};
 }
 
-util::StatusOr<std::string> EciesAeadHkdfHybridDecrypt::Decrypt(
-    absl::string_view ciphertext, absl::string_view context_info) const {
-  // Extract KEM-bytes from the ciphertext.
+util::StatusOr<std::unique_ptr<subtle::AeadOrDaead>>
+EciesAeadHkdfHybridDecrypt::GetDemForCiphertext(absl::string_view ciphertext,
+                                                absl::string_view context_info,
+                                                size_t* header_size) const {
+  // Determine the size of the KEM header; the KEM and DEM parts of the
+  // ciphertext are sliced out as string_views, without copying.
   auto header_size_result = subtle::EcUtil::EncodingSizeInBytes(
       util::Enums::ProtoToSubtle(
           recipient_key_params_.kem_params().curve_type()),
       util::Enums::ProtoToSubtle(recipient_key_params_.ec_point_format()));
   if (!header_size_result.ok()) return header_size_result.status();
-  auto header_size = header_size_result.ValueOrDie();
-  if (ciphertext.size() < header_size) {
+  *header_size = header_size_result.ValueOrDie();
+  if (ciphertext.size() < *header_size) {
     return util::Status(util::error::INVALID_ARGUMENT, "ciphertext too short");
   }
 
   // Use KEM to get a symmetric key.
   auto symmetric_key_result = recipient_kem_->GenerateKey(
-      absl::string_view(ciphertext).substr(0, header_size),
+      ciphertext.substr(0, *header_size),
       util::Enums::ProtoToSubtle(
           recipient_key_params_.kem_params().hkdf_hash_type()),
       recipient_key_params_.kem_params().hkdf_salt(), context_info,
@@ -106,7 +109,14 @@ util::StatusOr<std::string> EciesAeadHkdfHybridDecrypt::Decrypt(
   auto symmetric_key = std::move(symmetric_key_result.ValueOrDie());
 
   // Use the symmetric key to get an AEAD-primitive.
-  auto aead_or_daead_result = dem_helper_->GetAeadOrDaead(symmetric_key);
+  return dem_helper_->GetAeadOrDaead(symmetric_key);
+}
+
+util::StatusOr<std::string> EciesAeadHkdfHybridDecrypt::Decrypt(
+    absl::string_view ciphertext, absl::string_view context_info) const {
+  size_t header_size;
+  auto aead_or_daead_result =
+      GetDemForCiphertext(ciphertext, context_info, &header_size);
   if (!aead_or_daead_result.ok()) return aead_or_daead_result.status();
   auto aead_or_daead = std::move(aead_or_daead_result.ValueOrDie());
 
@@ -118,5 +128,21 @@ util::StatusOr<std::string> EciesAeadHkdfHybridDecrypt::Decrypt(
   return decrypt_result.ValueOrDie();
 }
 
+util::StatusOr<size_t> EciesAeadHkdfHybridDecrypt::DecryptInto(
+    absl::string_view ciphertext, absl::string_view context_info,
+    absl::Span<char> out) const {
+  size_t header_size;
+  auto aead_or_daead_result =
+      GetDemForCiphertext(ciphertext, context_info, &header_size);
+  if (!aead_or_daead_result.ok()) return aead_or_daead_result.status();
+  auto aead_or_daead = std::move(aead_or_daead_result.ValueOrDie());
+
+  // Decrypt straight into the caller's buffer, so the plaintext does not go
+  // through a transient std::string.
+  return aead_or_daead->DecryptInto(ciphertext.substr(header_size),
+                                    "",  // empty aad
+                                    out);
+}
+
 }  // namespace tink
 }  // namespace crypto
@@ -42,6 +42,12 @@ class EciesAeadHkdfHybridDecrypt : public HybridDecrypt {
       absl::string_view ciphertext,
       absl::string_view context_info) const override;
 
+  // Writes the plaintext directly into 'out', so that large plaintexts do
+  // not go through a transient allocation; see HybridDecrypt::DecryptInto().
+  crypto::tink::util::StatusOr<size_t> DecryptInto(
+      absl::string_view ciphertext, absl::string_view context_info,
+      absl::Span<char> out) const override;
+
  private:
   EciesAeadHkdfHybridDecrypt(
       google::crypto::tink::EciesAeadHkdfParams recipient_key_params,
@@ -51,6 +57,14 @@ class EciesAeadHkdfHybridDecrypt : public HybridDecrypt {
         recipient_kem_(std::move(kem)),
         dem_helper_(std::move(dem_helper)) {}
 
+  // Runs the KEM over the header of 'ciphertext' and returns the resulting
+  // DEM primitive; on success '*header_size' holds the size of the consumed
+  // KEM header.
+  crypto::tink::util::StatusOr<std::unique_ptr<subtle::AeadOrDaead>>
+  GetDemForCiphertext(absl::string_view ciphertext,
+                      absl::string_view context_info,
+                      size_t* header_size) const;
+
   google::crypto::tink::EciesAeadHkdfParams recipient_key_params_;
   std::unique_ptr<const subtle::EciesHkdfRecipientKemBoringSsl> recipient_kem_;
   std::unique_ptr<const EciesAeadHkdfDemHelper> dem_helper_;
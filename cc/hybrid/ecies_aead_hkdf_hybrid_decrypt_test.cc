@@ -18,6 +18,7 @@
 
 #include "gtest/gtest.h"
 #include "absl/memory/memory.h"
+#include "absl/types/span.h"
 #include "tink/aead/aes_ctr_hmac_aead_key_manager.h"
 #include "tink/aead/aes_gcm_key_manager.h"
 #include "tink/aead/xchacha20_poly1305_key_manager.h"
@@ -132,6 +133,14 @@ class EciesAeadHkdfHybridDecryptTest : public ::testing::Test {
         ASSERT_TRUE(decrypt_result.ok()) << decrypt_result.status();
         EXPECT_EQ(empty_plaintext, decrypt_result.ValueOrDie());
       }
+      {  // Decryption into a caller-provided buffer.
+        std::string buffer(ciphertext.size(), '\0');
+        auto size_result = hybrid_decrypt->DecryptInto(
+            ciphertext, context_info,
+            absl::MakeSpan(&buffer[0], buffer.size()));
+        ASSERT_TRUE(size_result.ok()) << size_result.status();
+        EXPECT_EQ(plaintext, buffer.substr(0, size_result.ValueOrDie()));
+      }
       {  // Short bad ciphertext.
         auto decrypt_result =
             hybrid_decrypt->Decrypt(Random::GetRandomBytes(16), context_info);
@@ -252,6 +261,36 @@ TEST_F(EciesAeadHkdfHybridDecryptTest, testAesGcmHybridDecryption) {
   EXPECT_EQ(i, 32 - 4);
 }
 
+TEST_F(EciesAeadHkdfHybridDecryptTest, testSenderSessionDecryption) {
+  // Register DEM key manager.
+  ASSERT_TRUE(Registry::RegisterKeyTypeManager(
+                  absl::make_unique<AesGcmKeyManager>(), true)
+                  .ok());
+
+  auto ecies_key = test::GetEciesAesGcmHkdfTestKey(
+      EllipticCurveType::NIST_P256, EcPointFormat::UNCOMPRESSED,
+      HashType::SHA256, 32);
+  std::unique_ptr<HybridDecrypt> hybrid_decrypt(
+      std::move(EciesAeadHkdfHybridDecrypt::New(ecies_key).ValueOrDie()));
+  std::unique_ptr<HybridEncrypt> hybrid_encrypt(std::move(
+      EciesAeadHkdfHybridEncrypt::New(ecies_key.public_key()).ValueOrDie()));
+
+  // Every ciphertext of a sender session must decrypt independently with
+  // the regular hybrid decryption and the session's context info.
+  std::string context_info = "some context info";
+  auto session = std::move(
+      static_cast<EciesAeadHkdfHybridEncrypt*>(hybrid_encrypt.get())
+          ->NewSession(context_info)
+          .ValueOrDie());
+  for (uint32_t plaintext_size : {0, 1, 10, 100, 1000}) {
+    std::string plaintext = Random::GetRandomBytes(plaintext_size);
+    auto ciphertext = session->Encrypt(plaintext).ValueOrDie();
+    auto decrypt_result = hybrid_decrypt->Decrypt(ciphertext, context_info);
+    ASSERT_TRUE(decrypt_result.ok()) << decrypt_result.status();
+    EXPECT_EQ(plaintext, decrypt_result.ValueOrDie());
+  }
+}
+
 TEST_F(EciesAeadHkdfHybridDecryptTest, testAesCtrAeadHybridDecryption) {
   // Register DEM key manager.
   std::string dem_key_type = AesCtrHmacAeadKeyManager().get_key_type();
@@ -79,6 +79,14 @@ util::StatusOr<std::unique_ptr<HybridEncrypt>> EciesAeadHkdfHybridEncrypt::New(
 
 util::StatusOr<std::string> EciesAeadHkdfHybridEncrypt::Encrypt(
     absl::string_view plaintext, absl::string_view context_info) const {
+  // A one-shot encryption is a session with a single message.
+  auto session_result = NewSession(context_info);
+  if (!session_result.ok()) return session_result.status();
+  return session_result.ValueOrDie()->Encrypt(plaintext);
+}
+
+util::StatusOr<std::unique_ptr<EciesAeadHkdfHybridEncrypt::Session>>
+EciesAeadHkdfHybridEncrypt::NewSession(absl::string_view context_info) const {
   // Use KEM to get a symmetric key.
   auto kem_key_result = sender_kem_->GenerateKey(
       util::Enums::ProtoToSubtle(
@@ -95,16 +103,20 @@ util::StatusOr<std::string> EciesAeadHkdfHybridEncrypt::Encrypt(
   auto aead_or_daead_result =
       dem_helper_->GetAeadOrDaead(kem_key->get_symmetric_key());
   if (!aead_or_daead_result.ok()) return aead_or_daead_result.status();
-  auto aead_or_daead = std::move(aead_or_daead_result.ValueOrDie());
 
+  return {absl::WrapUnique(
+      new Session(kem_key->get_kem_bytes(),
+                  std::move(aead_or_daead_result.ValueOrDie())))};
+}
+
+util::StatusOr<std::string> EciesAeadHkdfHybridEncrypt::Session::Encrypt(
+    absl::string_view plaintext) const {
   // Do the actual encryption using the AEAD-primitive.
-  auto encrypt_result = aead_or_daead->Encrypt(plaintext, "");  // empty aad
+  auto encrypt_result = aead_or_daead_->Encrypt(plaintext, "");  // empty aad
   if (!encrypt_result.ok()) return encrypt_result.status();
 
-  // Prepend AEAD-ciphertext with a KEM component.
-  std::string ciphertext =
-      absl::StrCat(kem_key->get_kem_bytes(), encrypt_result.ValueOrDie());
-  return ciphertext;
+  // Prepend AEAD-ciphertext with the KEM component.
+  return absl::StrCat(kem_bytes_, encrypt_result.ValueOrDie());
 }
 
 }  // namespace tink
@@ -18,7 +18,9 @@
 #define TINK_HYBRID_ECIES_AEAD_HKDF_HYBRID_ENCRYPT_H_
 
 #include <memory>
+#include <string>
 
+#include "tink/daead/subtle/aead_or_daead.h"
 #include "tink/hybrid/ecies_aead_hkdf_dem_helper.h"
 #include "tink/hybrid_encrypt.h"
 #include "tink/subtle/ecies_hkdf_sender_kem_boringssl.h"
@@ -41,6 +43,42 @@ class EciesAeadHkdfHybridEncrypt : public HybridEncrypt {
       absl::string_view plaintext,
       absl::string_view context_info) const override;
 
+  // An encryption session for a fixed recipient and context info.
+  // A session performs the KEM (incl. the EC scalar multiplication) and the
+  // key derivation only once, and encrypts each message under the derived
+  // DEM key, so encrypting many messages to the same recipient costs one
+  // KEM operation in total instead of one per message.
+  // Each ciphertext produced by a session has the regular ECIES wire format
+  // (KEM bytes followed by the DEM ciphertext) and can be decrypted
+  // independently with EciesAeadHkdfHybridDecrypt and the same context info.
+  // Note that all messages of a session share one DEM key: with a
+  // deterministic DEM (e.g. AES-SIV) equal plaintexts then yield equal
+  // ciphertexts, and an observer can link the messages via the repeated
+  // KEM bytes.
+  class Session {
+   public:
+    // Encrypts 'plaintext' under the session's DEM key and returns the
+    // resulting ciphertext, prefixed with the session's KEM bytes.
+    crypto::tink::util::StatusOr<std::string> Encrypt(
+        absl::string_view plaintext) const;
+
+   private:
+    friend class EciesAeadHkdfHybridEncrypt;
+
+    Session(std::string kem_bytes,
+            std::unique_ptr<const subtle::AeadOrDaead> aead_or_daead)
+        : kem_bytes_(std::move(kem_bytes)),
+          aead_or_daead_(std::move(aead_or_daead)) {}
+
+    std::string kem_bytes_;
+    std::unique_ptr<const subtle::AeadOrDaead> aead_or_daead_;
+  };
+
+  // Performs the KEM and key derivation for 'context_info' and returns a
+  // session that encrypts messages under the derived DEM key.
+  crypto::tink::util::StatusOr<std::unique_ptr<Session>> NewSession(
+      absl::string_view context_info) const;
+
  private:
   EciesAeadHkdfHybridEncrypt(
       const google::crypto::tink::EciesAeadHkdfPublicKey& recipient_key,
@@ -150,6 +150,54 @@ TEST_F(EciesAeadHkdfHybridEncryptTest, testBasic) {
   }
 }
 
+TEST_F(EciesAeadHkdfHybridEncryptTest, testSenderSession) {
+  ASSERT_TRUE(Registry::RegisterKeyTypeManager(
+                  absl::make_unique<AesGcmKeyManager>(), true)
+                  .ok());
+  auto ecies_key = test::GetEciesAesGcmHkdfTestKey(
+      EllipticCurveType::NIST_P256,
+      EcPointFormat::UNCOMPRESSED,
+      HashType::SHA256,
+      32);
+  auto result(EciesAeadHkdfHybridEncrypt::New(ecies_key.public_key()));
+  ASSERT_TRUE(result.ok()) << result.status();
+  std::unique_ptr<HybridEncrypt> hybrid_encrypt(
+      std::move(result.ValueOrDie()));
+
+  // NewSession is specific to EciesAeadHkdfHybridEncrypt and not part of
+  // the HybridEncrypt interface.
+  auto* ecies_encrypt =
+      static_cast<EciesAeadHkdfHybridEncrypt*>(hybrid_encrypt.get());
+  auto session_result = ecies_encrypt->NewSession("some context info");
+  ASSERT_TRUE(session_result.ok()) << session_result.status();
+  auto session = std::move(session_result.ValueOrDie());
+
+  // All ciphertexts of a session share the KEM bytes (here, an uncompressed
+  // P-256 point: 65 bytes), but the DEM encryptions remain randomized.
+  const size_t kKemBytesSize = 65;
+  auto first_result = session->Encrypt("some plaintext");
+  ASSERT_TRUE(first_result.ok()) << first_result.status();
+  std::string first_ciphertext = first_result.ValueOrDie();
+  ASSERT_GT(first_ciphertext.size(), kKemBytesSize);
+  for (int i = 0; i < 3; i++) {
+    auto encrypt_result = session->Encrypt("some plaintext");
+    ASSERT_TRUE(encrypt_result.ok()) << encrypt_result.status();
+    std::string ciphertext = encrypt_result.ValueOrDie();
+    EXPECT_EQ(first_ciphertext.substr(0, kKemBytesSize),
+              ciphertext.substr(0, kKemBytesSize));
+    EXPECT_NE(first_ciphertext, ciphertext);
+  }
+
+  // A new session performs a fresh KEM.
+  auto other_session_result = ecies_encrypt->NewSession("some context info");
+  ASSERT_TRUE(other_session_result.ok()) << other_session_result.status();
+  auto other_result =
+      other_session_result.ValueOrDie()->Encrypt("some plaintext");
+  ASSERT_TRUE(other_result.ok()) << other_result.status();
+  EXPECT_NE(first_ciphertext.substr(0, kKemBytesSize),
+            other_result.ValueOrDie().substr(0, kKemBytesSize));
+}
+
 }  // namespace
 }  // namespace tink
 }  // namespace crypto
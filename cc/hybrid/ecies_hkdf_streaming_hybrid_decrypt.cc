@@ -0,0 +1,112 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/hybrid/ecies_hkdf_streaming_hybrid_decrypt.h"
+
+#include <algorithm>
+
+#include "absl/memory/memory.h"
+#include "tink/subtle/aes_gcm_hkdf_streaming.h"
+#include "tink/subtle/ec_util.h"
+#include "tink/util/status.h"
+
+namespace crypto {
+namespace tink {
+
+namespace {
+
+// Reads exactly 'count' bytes from 'input' into 'out'; fails with the
+// stream's status (e.g. OUT_OF_RANGE) if the stream ends first.
+util::Status ReadFromStream(InputStream* input, size_t count,
+                            std::string* out) {
+  out->clear();
+  while (out->size() < count) {
+    const void* buffer;
+    auto next_result = input->Next(&buffer);
+    if (!next_result.ok()) return next_result.status();
+    int available = next_result.ValueOrDie();
+    int to_take =
+        std::min(static_cast<size_t>(available), count - out->size());
+    out->append(static_cast<const char*>(buffer), to_take);
+    if (to_take < available) input->BackUp(available - to_take);
+  }
+  return util::OkStatus();
+}
+
+}  // namespace
+
+// static
+util::StatusOr<std::unique_ptr<StreamingHybridDecrypt>>
+EciesHkdfStreamingHybridDecrypt::New(Params params,
+                                     util::SecretData priv_key) {
+  auto kem_result = subtle::EciesHkdfRecipientKemBoringSsl::New(
+      params.curve, std::move(priv_key));
+  if (!kem_result.ok()) return kem_result.status();
+
+  // Validate the DEM parameters now, with a dummy key of the right size, so
+  // that misconfigurations surface at primitive construction rather than on
+  // the first stream.
+  subtle::AesGcmHkdfStreaming::Params dem_params;
+  dem_params.ikm = util::SecretData(params.dem_derived_key_size);
+  dem_params.hkdf_hash = params.dem_hkdf_hash;
+  dem_params.derived_key_size = params.dem_derived_key_size;
+  dem_params.ciphertext_segment_size = params.dem_ciphertext_segment_size;
+  dem_params.ciphertext_offset = 0;
+  auto dem_result = subtle::AesGcmHkdfStreaming::New(std::move(dem_params));
+  if (!dem_result.ok()) return dem_result.status();
+
+  std::unique_ptr<StreamingHybridDecrypt> hybrid_decrypt(
+      new EciesHkdfStreamingHybridDecrypt(
+          std::move(params), std::move(kem_result.ValueOrDie())));
+  return std::move(hybrid_decrypt);
+}
+
+util::StatusOr<std::unique_ptr<InputStream>>
+EciesHkdfStreamingHybridDecrypt::NewDecryptingStream(
+    std::unique_ptr<InputStream> ciphertext_source,
+    absl::string_view context_info) const {
+  // The encoded ephemeral point prefixes the ciphertext stream.
+  auto header_size_result = subtle::EcUtil::EncodingSizeInBytes(
+      params_.curve, params_.point_format);
+  if (!header_size_result.ok()) return header_size_result.status();
+  std::string kem_bytes;
+  auto status = ReadFromStream(ciphertext_source.get(),
+                               header_size_result.ValueOrDie(), &kem_bytes);
+  if (!status.ok()) return status;
+
+  // One KEM operation per stream: recover the DEM's input keying material.
+  auto symmetric_key_result = recipient_kem_->GenerateKey(
+      kem_bytes, params_.hkdf_hash, params_.hkdf_salt, context_info,
+      params_.dem_derived_key_size, params_.point_format);
+  if (!symmetric_key_result.ok()) return symmetric_key_result.status();
+
+  // The ciphertext offset matches the KEM prefix consumed above, so the
+  // DEM's segment arithmetic lines up with the encrypting side.
+  subtle::AesGcmHkdfStreaming::Params dem_params;
+  dem_params.ikm = std::move(symmetric_key_result.ValueOrDie());
+  dem_params.hkdf_hash = params_.dem_hkdf_hash;
+  dem_params.derived_key_size = params_.dem_derived_key_size;
+  dem_params.ciphertext_segment_size = params_.dem_ciphertext_segment_size;
+  dem_params.ciphertext_offset = kem_bytes.size();
+  auto dem_result = subtle::AesGcmHkdfStreaming::New(std::move(dem_params));
+  if (!dem_result.ok()) return dem_result.status();
+
+  return dem_result.ValueOrDie()->NewDecryptingStream(
+      std::move(ciphertext_source), /* associated_data = */ "");
+}
+
+}  // namespace tink
+}  // namespace crypto
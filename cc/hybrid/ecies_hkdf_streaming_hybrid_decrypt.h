@@ -0,0 +1,73 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_HYBRID_ECIES_HKDF_STREAMING_HYBRID_DECRYPT_H_
+#define TINK_HYBRID_ECIES_HKDF_STREAMING_HYBRID_DECRYPT_H_
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "tink/streaming_hybrid_decrypt.h"
+#include "tink/subtle/common_enums.h"
+#include "tink/subtle/ecies_hkdf_recipient_kem_boringssl.h"
+#include "tink/util/secret_data.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+
+// Recipient side of EciesHkdfStreamingHybridEncrypt; see there for the
+// ciphertext stream layout and the meaning of the parameters.
+class EciesHkdfStreamingHybridDecrypt : public StreamingHybridDecrypt {
+ public:
+  struct Params {
+    // KEM parameters.
+    subtle::EllipticCurveType curve;
+    subtle::HashType hkdf_hash;
+    std::string hkdf_salt;
+    subtle::EcPointFormat point_format;
+    // Parameters of the AES-GCM-HKDF streaming DEM.
+    subtle::HashType dem_hkdf_hash;
+    int dem_derived_key_size;
+    int dem_ciphertext_segment_size;
+  };
+
+  // Returns a StreamingHybridDecrypt primitive for the recipient's private
+  // key, a big-endian byte array.
+  static crypto::tink::util::StatusOr<
+      std::unique_ptr<StreamingHybridDecrypt>>
+  New(Params params, util::SecretData priv_key);
+
+  crypto::tink::util::StatusOr<std::unique_ptr<InputStream>>
+  NewDecryptingStream(std::unique_ptr<InputStream> ciphertext_source,
+                      absl::string_view context_info) const override;
+
+ private:
+  EciesHkdfStreamingHybridDecrypt(
+      Params params,
+      std::unique_ptr<const subtle::EciesHkdfRecipientKemBoringSsl> kem)
+      : params_(std::move(params)), recipient_kem_(std::move(kem)) {}
+
+  const Params params_;
+  const std::unique_ptr<const subtle::EciesHkdfRecipientKemBoringSsl>
+      recipient_kem_;
+};
+
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_HYBRID_ECIES_HKDF_STREAMING_HYBRID_DECRYPT_H_
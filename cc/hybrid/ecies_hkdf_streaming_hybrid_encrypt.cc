@@ -0,0 +1,110 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/hybrid/ecies_hkdf_streaming_hybrid_encrypt.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "absl/memory/memory.h"
+#include "tink/subtle/aes_gcm_hkdf_streaming.h"
+#include "tink/util/status.h"
+
+namespace crypto {
+namespace tink {
+
+namespace {
+
+// Writes 'contents' into 'output' via its Next()/BackUp() interface.
+util::Status WriteToStream(OutputStream* output, absl::string_view contents) {
+  size_t pos = 0;
+  while (pos < contents.size()) {
+    void* buffer;
+    auto next_result = output->Next(&buffer);
+    if (!next_result.ok()) return next_result.status();
+    int available = next_result.ValueOrDie();
+    int to_copy = std::min(static_cast<size_t>(available),
+                           contents.size() - pos);
+    memcpy(buffer, contents.data() + pos, to_copy);
+    if (to_copy < available) output->BackUp(available - to_copy);
+    pos += to_copy;
+  }
+  return util::OkStatus();
+}
+
+}  // namespace
+
+// static
+util::StatusOr<std::unique_ptr<StreamingHybridEncrypt>>
+EciesHkdfStreamingHybridEncrypt::New(Params params, const std::string& pubx,
+                                     const std::string& puby) {
+  auto kem_result =
+      subtle::EciesHkdfSenderKemBoringSsl::New(params.curve, pubx, puby);
+  if (!kem_result.ok()) return kem_result.status();
+
+  // Validate the DEM parameters now, with a dummy key of the right size, so
+  // that misconfigurations surface at primitive construction rather than on
+  // the first stream.
+  subtle::AesGcmHkdfStreaming::Params dem_params;
+  dem_params.ikm = util::SecretData(params.dem_derived_key_size);
+  dem_params.hkdf_hash = params.dem_hkdf_hash;
+  dem_params.derived_key_size = params.dem_derived_key_size;
+  dem_params.ciphertext_segment_size = params.dem_ciphertext_segment_size;
+  dem_params.ciphertext_offset = 0;
+  auto dem_result = subtle::AesGcmHkdfStreaming::New(std::move(dem_params));
+  if (!dem_result.ok()) return dem_result.status();
+
+  std::unique_ptr<StreamingHybridEncrypt> hybrid_encrypt(
+      new EciesHkdfStreamingHybridEncrypt(
+          std::move(params), std::move(kem_result.ValueOrDie())));
+  return std::move(hybrid_encrypt);
+}
+
+util::StatusOr<std::unique_ptr<OutputStream>>
+EciesHkdfStreamingHybridEncrypt::NewEncryptingStream(
+    std::unique_ptr<OutputStream> ciphertext_destination,
+    absl::string_view context_info) const {
+  // One KEM operation per stream: derive the DEM's input keying material,
+  // with 'context_info' bound via the KEM's HKDF, as in the one-shot
+  // EciesAeadHkdfHybridEncrypt.
+  auto kem_key_result = sender_kem_->GenerateKey(
+      params_.hkdf_hash, params_.hkdf_salt, context_info,
+      params_.dem_derived_key_size, params_.point_format);
+  if (!kem_key_result.ok()) return kem_key_result.status();
+  auto kem_key = std::move(kem_key_result.ValueOrDie());
+
+  // The encoded ephemeral point prefixes the ciphertext stream.
+  auto status =
+      WriteToStream(ciphertext_destination.get(), kem_key->get_kem_bytes());
+  if (!status.ok()) return status;
+
+  // The DEM encrypts the rest of the stream segment by segment; the
+  // ciphertext offset keeps the segments aligned despite the KEM prefix.
+  subtle::AesGcmHkdfStreaming::Params dem_params;
+  dem_params.ikm = kem_key->get_symmetric_key();
+  dem_params.hkdf_hash = params_.dem_hkdf_hash;
+  dem_params.derived_key_size = params_.dem_derived_key_size;
+  dem_params.ciphertext_segment_size = params_.dem_ciphertext_segment_size;
+  dem_params.ciphertext_offset = kem_key->get_kem_bytes().size();
+  auto dem_result = subtle::AesGcmHkdfStreaming::New(std::move(dem_params));
+  if (!dem_result.ok()) return dem_result.status();
+
+  return dem_result.ValueOrDie()->NewEncryptingStream(
+      std::move(ciphertext_destination), /* associated_data = */ "");
+}
+
+}  // namespace tink
+}  // namespace crypto
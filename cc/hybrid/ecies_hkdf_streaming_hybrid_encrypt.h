@@ -0,0 +1,75 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_HYBRID_ECIES_HKDF_STREAMING_HYBRID_ENCRYPT_H_
+#define TINK_HYBRID_ECIES_HKDF_STREAMING_HYBRID_ENCRYPT_H_
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "tink/streaming_hybrid_encrypt.h"
+#include "tink/subtle/common_enums.h"
+#include "tink/subtle/ecies_hkdf_sender_kem_boringssl.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+
+// Streaming hybrid encryption with an ECIES HKDF-KEM and an
+// AES-GCM-HKDF streaming AEAD as DEM: one KEM operation per stream,
+// after which arbitrary amounts of plaintext are encrypted segment by
+// segment with constant memory. The ciphertext stream consists of the
+// encoded ephemeral KEM point followed by the streaming-AEAD ciphertext.
+class EciesHkdfStreamingHybridEncrypt : public StreamingHybridEncrypt {
+ public:
+  struct Params {
+    // KEM parameters.
+    subtle::EllipticCurveType curve;
+    subtle::HashType hkdf_hash;
+    std::string hkdf_salt;
+    subtle::EcPointFormat point_format;
+    // Parameters of the AES-GCM-HKDF streaming DEM.
+    subtle::HashType dem_hkdf_hash;
+    int dem_derived_key_size;
+    int dem_ciphertext_segment_size;
+  };
+
+  // Returns a StreamingHybridEncrypt primitive for the recipient's public
+  // key point, whose coordinates are big-endian byte arrays (puby empty
+  // for CURVE25519).
+  static crypto::tink::util::StatusOr<
+      std::unique_ptr<StreamingHybridEncrypt>>
+  New(Params params, const std::string& pubx, const std::string& puby);
+
+  crypto::tink::util::StatusOr<std::unique_ptr<OutputStream>>
+  NewEncryptingStream(std::unique_ptr<OutputStream> ciphertext_destination,
+                      absl::string_view context_info) const override;
+
+ private:
+  EciesHkdfStreamingHybridEncrypt(
+      Params params,
+      std::unique_ptr<const subtle::EciesHkdfSenderKemBoringSsl> kem)
+      : params_(std::move(params)), sender_kem_(std::move(kem)) {}
+
+  const Params params_;
+  const std::unique_ptr<const subtle::EciesHkdfSenderKemBoringSsl> sender_kem_;
+};
+
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_HYBRID_ECIES_HKDF_STREAMING_HYBRID_ENCRYPT_H_
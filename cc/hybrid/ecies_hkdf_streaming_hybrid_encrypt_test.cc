@@ -0,0 +1,147 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/hybrid/ecies_hkdf_streaming_hybrid_encrypt.h"
+
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include "gtest/gtest.h"
+#include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
+#include "tink/hybrid/ecies_hkdf_streaming_hybrid_decrypt.h"
+#include "tink/subtle/common_enums.h"
+#include "tink/subtle/random.h"
+#include "tink/subtle/subtle_util_boringssl.h"
+#include "tink/subtle/test_util.h"
+#include "tink/util/istream_input_stream.h"
+#include "tink/util/ostream_output_stream.h"
+#include "tink/util/secret_data.h"
+#include "tink/util/test_matchers.h"
+
+namespace crypto {
+namespace tink {
+namespace {
+
+using ::crypto::tink::test::IsOk;
+using ::crypto::tink::subtle::EcPointFormat;
+using ::crypto::tink::subtle::EllipticCurveType;
+using ::crypto::tink::subtle::HashType;
+using ::crypto::tink::subtle::SubtleUtilBoringSSL;
+
+EciesHkdfStreamingHybridEncrypt::Params GetTestParams() {
+  EciesHkdfStreamingHybridEncrypt::Params params;
+  params.curve = EllipticCurveType::NIST_P256;
+  params.hkdf_hash = HashType::SHA256;
+  params.hkdf_salt = "some salt";
+  params.point_format = EcPointFormat::UNCOMPRESSED;
+  params.dem_hkdf_hash = HashType::SHA256;
+  params.dem_derived_key_size = 32;
+  params.dem_ciphertext_segment_size = 512;
+  return params;
+}
+
+TEST(EciesHkdfStreamingHybridEncryptTest, Basic) {
+  auto ec_key =
+      SubtleUtilBoringSSL::GetNewEcKey(EllipticCurveType::NIST_P256)
+          .ValueOrDie();
+  auto params = GetTestParams();
+  auto hybrid_encrypt_result =
+      EciesHkdfStreamingHybridEncrypt::New(params, ec_key.pub_x, ec_key.pub_y);
+  ASSERT_THAT(hybrid_encrypt_result.status(), IsOk());
+  auto hybrid_encrypt = std::move(hybrid_encrypt_result.ValueOrDie());
+  auto hybrid_decrypt_result =
+      EciesHkdfStreamingHybridDecrypt::New(params, ec_key.priv);
+  ASSERT_THAT(hybrid_decrypt_result.status(), IsOk());
+  auto hybrid_decrypt = std::move(hybrid_decrypt_result.ValueOrDie());
+
+  for (int plaintext_size : {0, 1, 10, 100, 10000}) {
+    SCOPED_TRACE(absl::StrCat("plaintext_size = ", plaintext_size));
+    std::string plaintext = subtle::Random::GetRandomBytes(plaintext_size);
+    std::string context_info = "some context info";
+
+    // Encrypt the plaintext into a stringstream.
+    auto ct_stream = absl::make_unique<std::stringstream>();
+    auto ct_buf = ct_stream->rdbuf();
+    auto ct_destination =
+        absl::make_unique<util::OstreamOutputStream>(std::move(ct_stream));
+    auto enc_stream_result = hybrid_encrypt->NewEncryptingStream(
+        std::move(ct_destination), context_info);
+    ASSERT_THAT(enc_stream_result.status(), IsOk());
+    auto status = subtle::test::WriteToStream(
+        enc_stream_result.ValueOrDie().get(), plaintext);
+    ASSERT_THAT(status, IsOk());
+    std::string ciphertext = ct_buf->str();
+    EXPECT_GT(ciphertext.size(), plaintext.size());
+
+    // Decrypt the ciphertext back.
+    auto ct_source = absl::make_unique<util::IstreamInputStream>(
+        absl::make_unique<std::istringstream>(ciphertext));
+    auto dec_stream_result = hybrid_decrypt->NewDecryptingStream(
+        std::move(ct_source), context_info);
+    ASSERT_THAT(dec_stream_result.status(), IsOk());
+    std::string decrypted;
+    status = subtle::test::ReadFromStream(
+        dec_stream_result.ValueOrDie().get(), &decrypted);
+    ASSERT_THAT(status, IsOk());
+    EXPECT_EQ(plaintext, decrypted);
+
+    // Decryption with a wrong context info must fail.
+    auto bad_ct_source = absl::make_unique<util::IstreamInputStream>(
+        absl::make_unique<std::istringstream>(ciphertext));
+    auto bad_stream_result = hybrid_decrypt->NewDecryptingStream(
+        std::move(bad_ct_source), "wrong context info");
+    ASSERT_THAT(bad_stream_result.status(), IsOk());
+    std::string bad_decrypted;
+    status = subtle::test::ReadFromStream(
+        bad_stream_result.ValueOrDie().get(), &bad_decrypted);
+    EXPECT_FALSE(status.ok());
+  }
+}
+
+TEST(EciesHkdfStreamingHybridEncryptTest, InvalidDemParams) {
+  auto ec_key =
+      SubtleUtilBoringSSL::GetNewEcKey(EllipticCurveType::NIST_P256)
+          .ValueOrDie();
+  auto params = GetTestParams();
+  params.dem_derived_key_size = 12;  // too small for AES-GCM-HKDF
+  auto result =
+      EciesHkdfStreamingHybridEncrypt::New(params, ec_key.pub_x, ec_key.pub_y);
+  EXPECT_FALSE(result.ok());
+  auto dec_result = EciesHkdfStreamingHybridDecrypt::New(params, ec_key.priv);
+  EXPECT_FALSE(dec_result.ok());
+}
+
+TEST(EciesHkdfStreamingHybridEncryptTest, TruncatedKemPrefix) {
+  auto ec_key =
+      SubtleUtilBoringSSL::GetNewEcKey(EllipticCurveType::NIST_P256)
+          .ValueOrDie();
+  auto params = GetTestParams();
+  auto hybrid_decrypt = EciesHkdfStreamingHybridDecrypt::New(params,
+                                                             ec_key.priv)
+                            .ValueOrDie();
+  // A ciphertext shorter than the encoded KEM point cannot yield a stream.
+  auto ct_source = absl::make_unique<util::IstreamInputStream>(
+      absl::make_unique<std::istringstream>(std::string("short")));
+  auto result =
+      hybrid_decrypt->NewDecryptingStream(std::move(ct_source), "info");
+  EXPECT_FALSE(result.ok());
+}
+
+}  // namespace
+}  // namespace tink
+}  // namespace crypto
@@ -16,10 +16,16 @@
 
 #include "tink/hybrid/hybrid_decrypt_wrapper.h"
 
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include "tink/crypto_format.h"
 #include "tink/hybrid_decrypt.h"
 #include "tink/primitive_set.h"
 #include "tink/subtle/subtle_util_boringssl.h"
+#include "tink/util/errors.h"
 #include "tink/util/status.h"
 #include "tink/util/statusor.h"
 
@@ -38,6 +44,14 @@ class HybridDecryptSetWrapper : public HybridDecrypt {
       absl::string_view ciphertext,
       absl::string_view context_info) const override;
 
+  crypto::tink::util::StatusOr<size_t> DecryptInto(
+      absl::string_view ciphertext, absl::string_view context_info,
+      absl::Span<char> out) const override;
+
+  crypto::tink::util::StatusOr<std::vector<std::string>> DecryptBatch(
+      absl::Span<const absl::string_view> ciphertexts,
+      absl::string_view context_info) const override;
+
   ~HybridDecryptSetWrapper() override {}
 
  private:
@@ -53,12 +67,17 @@ util::StatusOr<std::string> HybridDecryptSetWrapper::Decrypt(
   if (ciphertext.length() > CryptoFormat::kNonRawPrefixSize) {
     absl::string_view key_id =
         ciphertext.substr(0, CryptoFormat::kNonRawPrefixSize);
-    auto primitives_result = hybrid_decrypt_set_->get_primitives(key_id);
-    if (primitives_result.ok()) {
+    const auto* primitives =
+        hybrid_decrypt_set_->get_primitives_or_null(key_id);
+    if (primitives != nullptr) {
       absl::string_view raw_ciphertext =
           ciphertext.substr(CryptoFormat::kNonRawPrefixSize);
-      for (auto& hybrid_decrypt_entry : *(primitives_result.ValueOrDie())) {
-        HybridDecrypt& hybrid_decrypt = hybrid_decrypt_entry->get_primitive();
+      for (auto& hybrid_decrypt_entry : *primitives) {
+        auto hybrid_decrypt_or = hybrid_decrypt_entry->primitive_or_status();
+        // Skip entries whose lazy materialization failed; RAW keys below may
+        // still succeed.
+        if (!hybrid_decrypt_or.ok()) continue;
+        HybridDecrypt& hybrid_decrypt = *hybrid_decrypt_or.ValueOrDie();
         auto decrypt_result =
             hybrid_decrypt.Decrypt(raw_ciphertext, context_info);
         if (decrypt_result.ok()) {
@@ -71,17 +90,136 @@ util::StatusOr<std::string> HybridDecryptSetWrapper::Decrypt(
   }
 
   // No matching key succeeded with decryption, try all RAW keys.
-  auto raw_primitives_result = hybrid_decrypt_set_->get_raw_primitives();
-  if (raw_primitives_result.ok()) {
-    for (auto& hybrid_decrypt_entry : *(raw_primitives_result.ValueOrDie())) {
-        HybridDecrypt& hybrid_decrypt = hybrid_decrypt_entry->get_primitive();
+  const auto* raw_primitives =
+      hybrid_decrypt_set_->get_raw_primitives_or_null();
+  if (raw_primitives != nullptr) {
+    for (auto& hybrid_decrypt_entry : *raw_primitives) {
+      auto hybrid_decrypt_or = hybrid_decrypt_entry->primitive_or_status();
+      if (!hybrid_decrypt_or.ok()) continue;
+      HybridDecrypt& hybrid_decrypt = *hybrid_decrypt_or.ValueOrDie();
       auto decrypt_result = hybrid_decrypt.Decrypt(ciphertext, context_info);
       if (decrypt_result.ok()) {
         return std::move(decrypt_result.ValueOrDie());
       }
     }
   }
-  return util::Status(util::error::INVALID_ARGUMENT, "decryption failed");
+  return DecryptionFailedStatus();
+}
+
+util::StatusOr<size_t> HybridDecryptSetWrapper::DecryptInto(
+    absl::string_view ciphertext, absl::string_view context_info,
+    absl::Span<char> out) const {
+  // BoringSSL expects a non-null pointer for context_info,
+  // regardless of whether the size is 0.
+  context_info = subtle::SubtleUtilBoringSSL::EnsureNonNull(context_info);
+
+  // Mirrors Decrypt(), but each attempt writes into the caller's buffer; a
+  // failed attempt may leave partial data there, which the next attempt (or
+  // the caller, on overall failure) overwrites or discards.
+  if (ciphertext.length() > CryptoFormat::kNonRawPrefixSize) {
+    absl::string_view key_id =
+        ciphertext.substr(0, CryptoFormat::kNonRawPrefixSize);
+    const auto* primitives =
+        hybrid_decrypt_set_->get_primitives_or_null(key_id);
+    if (primitives != nullptr) {
+      absl::string_view raw_ciphertext =
+          ciphertext.substr(CryptoFormat::kNonRawPrefixSize);
+      for (auto& hybrid_decrypt_entry : *primitives) {
+        auto hybrid_decrypt_or = hybrid_decrypt_entry->primitive_or_status();
+        if (!hybrid_decrypt_or.ok()) continue;
+        HybridDecrypt& hybrid_decrypt = *hybrid_decrypt_or.ValueOrDie();
+        auto decrypt_result =
+            hybrid_decrypt.DecryptInto(raw_ciphertext, context_info, out);
+        if (decrypt_result.ok()) {
+          return decrypt_result.ValueOrDie();
+        }
+      }
+    }
+  }
+
+  // No matching key succeeded with decryption, try all RAW keys.
+  const auto* raw_primitives =
+      hybrid_decrypt_set_->get_raw_primitives_or_null();
+  if (raw_primitives != nullptr) {
+    for (auto& hybrid_decrypt_entry : *raw_primitives) {
+      auto hybrid_decrypt_or = hybrid_decrypt_entry->primitive_or_status();
+      if (!hybrid_decrypt_or.ok()) continue;
+      HybridDecrypt& hybrid_decrypt = *hybrid_decrypt_or.ValueOrDie();
+      auto decrypt_result =
+          hybrid_decrypt.DecryptInto(ciphertext, context_info, out);
+      if (decrypt_result.ok()) {
+        return decrypt_result.ValueOrDie();
+      }
+    }
+  }
+  return DecryptionFailedStatus();
+}
+
+util::StatusOr<std::vector<std::string>> HybridDecryptSetWrapper::DecryptBatch(
+    absl::Span<const absl::string_view> ciphertexts,
+    absl::string_view context_info) const {
+  // BoringSSL expects a non-null pointer for context_info,
+  // regardless of whether the size is 0.
+  context_info = subtle::SubtleUtilBoringSSL::EnsureNonNull(context_info);
+
+  // Group the batch by key-id prefix, so that the key lookup (and any
+  // per-key amortization the underlying primitive does in its own
+  // DecryptBatch()) happens once per recipient key instead of once per
+  // ciphertext. Ciphertexts too short to carry a prefix land in the group
+  // with an empty key id and go through the RAW keys only.
+  std::unordered_map<std::string, std::vector<size_t>> groups;
+  for (size_t i = 0; i < ciphertexts.size(); ++i) {
+    std::string key_id;
+    if (ciphertexts[i].length() > CryptoFormat::kNonRawPrefixSize) {
+      key_id =
+          std::string(ciphertexts[i].substr(0, CryptoFormat::kNonRawPrefixSize));
+    }
+    groups[key_id].push_back(i);
+  }
+
+  std::vector<std::string> plaintexts(ciphertexts.size());
+  for (const auto& group : groups) {
+    const std::string& key_id = group.first;
+    const std::vector<size_t>& indices = group.second;
+    bool group_done = false;
+    if (!key_id.empty()) {
+      const auto* primitives =
+          hybrid_decrypt_set_->get_primitives_or_null(key_id);
+      if (primitives != nullptr) {
+        std::vector<absl::string_view> raw_ciphertexts;
+        raw_ciphertexts.reserve(indices.size());
+        for (size_t i : indices) {
+          raw_ciphertexts.push_back(
+              ciphertexts[i].substr(CryptoFormat::kNonRawPrefixSize));
+        }
+        for (auto& hybrid_decrypt_entry : *primitives) {
+          auto hybrid_decrypt_or = hybrid_decrypt_entry->primitive_or_status();
+          if (!hybrid_decrypt_or.ok()) continue;
+          HybridDecrypt& hybrid_decrypt = *hybrid_decrypt_or.ValueOrDie();
+          auto batch_result = hybrid_decrypt.DecryptBatch(
+              absl::MakeConstSpan(raw_ciphertexts), context_info);
+          if (batch_result.ok()) {
+            std::vector<std::string>& batch = batch_result.ValueOrDie();
+            for (size_t j = 0; j < indices.size(); ++j) {
+              plaintexts[indices[j]] = std::move(batch[j]);
+            }
+            group_done = true;
+            break;
+          }
+        }
+      }
+    }
+    if (group_done) continue;
+    // The group does not decrypt under a single matching key (e.g. RAW-key
+    // ciphertexts, or a mix of keys behind the same prefix): fall back to
+    // the per-ciphertext path, which also tries all RAW keys.
+    for (size_t i : indices) {
+      auto decrypt_result = Decrypt(ciphertexts[i], context_info);
+      if (!decrypt_result.ok()) return decrypt_result.status();
+      plaintexts[i] = std::move(decrypt_result.ValueOrDie());
+    }
+  }
+  return std::move(plaintexts);
 }
 
 util::Status Validate(PrimitiveSet<HybridDecrypt>* hybrid_decrypt_set) {
@@ -104,6 +242,7 @@ HybridDecryptWrapper::Wrap(
     std::unique_ptr<PrimitiveSet<HybridDecrypt>> primitive_set) const {
   util::Status status = Validate(primitive_set.get());
   if (!status.ok()) return status;
+  primitive_set->Seal();
   std::unique_ptr<HybridDecrypt> hybrid_decrypt(
       new HybridDecryptSetWrapper(std::move(primitive_set)));
   return std::move(hybrid_decrypt);
@@ -17,6 +17,7 @@
 #include "tink/hybrid/hybrid_decrypt_wrapper.h"
 
 #include "gtest/gtest.h"
+#include "absl/types/span.h"
 #include "tink/hybrid_decrypt.h"
 #include "tink/primitive_set.h"
 #include "tink/util/status.h"
@@ -102,7 +103,7 @@ TEST_F(HybridDecryptSetWrapperTest, Basic) {
     entry_result = hybrid_decrypt_set->AddPrimitive(std::move(hybrid_decrypt),
                                                     keyset.key_info(1));
     ASSERT_TRUE(entry_result.ok());
-    std::string prefix_id_1 = entry_result.ValueOrDie()->get_identifier();
+    std::string prefix_id_1(entry_result.ValueOrDie()->get_identifier());
     hybrid_decrypt.reset(new DummyHybridDecrypt(hybrid_name_2));
     entry_result = hybrid_decrypt_set->AddPrimitive(std::move(hybrid_decrypt),
                                                     keyset.key_info(2));
@@ -160,6 +161,115 @@ TEST_F(HybridDecryptSetWrapperTest, Basic) {
   }
 }
 
+TEST_F(HybridDecryptSetWrapperTest, DecryptInto) {
+  KeysetInfo::KeyInfo key_info;
+  key_info.set_output_prefix_type(OutputPrefixType::TINK);
+  key_info.set_key_id(1234543);
+  key_info.set_status(KeyStatusType::ENABLED);
+
+  std::unique_ptr<PrimitiveSet<HybridDecrypt>> hybrid_decrypt_set(
+      new PrimitiveSet<HybridDecrypt>());
+  auto entry_result = hybrid_decrypt_set->AddPrimitive(
+      std::unique_ptr<HybridDecrypt>(new DummyHybridDecrypt("hybrid")),
+      key_info);
+  ASSERT_TRUE(entry_result.ok());
+  std::string prefix(entry_result.ValueOrDie()->get_identifier());
+  ASSERT_THAT(hybrid_decrypt_set->set_primary(entry_result.ValueOrDie()),
+              IsOk());
+  auto hybrid_decrypt_result =
+      HybridDecryptWrapper().Wrap(std::move(hybrid_decrypt_set));
+  ASSERT_TRUE(hybrid_decrypt_result.ok()) << hybrid_decrypt_result.status();
+  auto hybrid_decrypt = std::move(hybrid_decrypt_result.ValueOrDie());
+
+  std::string plaintext = "some_plaintext";
+  std::string context_info = "some_context";
+  std::string ciphertext = prefix + DummyHybridEncrypt("hybrid")
+                                        .Encrypt(plaintext, context_info)
+                                        .ValueOrDie();
+
+  // The plaintext lands in the caller-provided buffer.
+  std::string buffer(ciphertext.size(), '\0');
+  auto size_result = hybrid_decrypt->DecryptInto(
+      ciphertext, context_info, absl::MakeSpan(&buffer[0], buffer.size()));
+  ASSERT_TRUE(size_result.ok()) << size_result.status();
+  EXPECT_EQ(plaintext, buffer.substr(0, size_result.ValueOrDie()));
+
+  // Failures surface as the generic decryption-failed error.
+  auto failed_result = hybrid_decrypt->DecryptInto(
+      "some bad ciphertext", context_info,
+      absl::MakeSpan(&buffer[0], buffer.size()));
+  EXPECT_FALSE(failed_result.ok());
+  EXPECT_EQ(util::error::INVALID_ARGUMENT,
+            failed_result.status().error_code());
+}
+
+TEST_F(HybridDecryptSetWrapperTest, DecryptBatch) {
+  KeysetInfo::KeyInfo* key;
+  KeysetInfo keyset;
+
+  key = keyset.add_key_info();
+  key->set_output_prefix_type(OutputPrefixType::RAW);
+  key->set_key_id(1234543);
+  key->set_status(KeyStatusType::ENABLED);
+
+  key = keyset.add_key_info();
+  key->set_output_prefix_type(OutputPrefixType::TINK);
+  key->set_key_id(7213743);
+  key->set_status(KeyStatusType::ENABLED);
+
+  std::unique_ptr<PrimitiveSet<HybridDecrypt>> hybrid_decrypt_set(
+      new PrimitiveSet<HybridDecrypt>());
+  auto entry_result = hybrid_decrypt_set->AddPrimitive(
+      std::unique_ptr<HybridDecrypt>(new DummyHybridDecrypt("hybrid_raw")),
+      keyset.key_info(0));
+  ASSERT_TRUE(entry_result.ok());
+  entry_result = hybrid_decrypt_set->AddPrimitive(
+      std::unique_ptr<HybridDecrypt>(new DummyHybridDecrypt("hybrid_tink")),
+      keyset.key_info(1));
+  ASSERT_TRUE(entry_result.ok());
+  std::string prefix(entry_result.ValueOrDie()->get_identifier());
+  ASSERT_THAT(hybrid_decrypt_set->set_primary(entry_result.ValueOrDie()),
+              IsOk());
+  auto hybrid_decrypt_result =
+      HybridDecryptWrapper().Wrap(std::move(hybrid_decrypt_set));
+  ASSERT_TRUE(hybrid_decrypt_result.ok()) << hybrid_decrypt_result.status();
+  auto hybrid_decrypt = std::move(hybrid_decrypt_result.ValueOrDie());
+
+  std::string context_info = "some_context";
+  std::vector<std::string> plaintexts = {"first", "second plaintext", "third"};
+  // A batch mixing ciphertexts under the TINK key with a RAW-key ciphertext.
+  std::vector<std::string> ciphertexts = {
+      prefix + DummyHybridEncrypt("hybrid_tink")
+                   .Encrypt(plaintexts[0], context_info)
+                   .ValueOrDie(),
+      DummyHybridEncrypt("hybrid_raw")
+          .Encrypt(plaintexts[1], context_info)
+          .ValueOrDie(),
+      prefix + DummyHybridEncrypt("hybrid_tink")
+                   .Encrypt(plaintexts[2], context_info)
+                   .ValueOrDie()};
+  std::vector<absl::string_view> ciphertext_views(ciphertexts.begin(),
+                                                  ciphertexts.end());
+
+  auto batch_result = hybrid_decrypt->DecryptBatch(
+      absl::MakeConstSpan(ciphertext_views), context_info);
+  ASSERT_TRUE(batch_result.ok()) << batch_result.status();
+  EXPECT_EQ(plaintexts, batch_result.ValueOrDie());
+
+  // An empty batch succeeds with no plaintexts.
+  auto empty_result = hybrid_decrypt->DecryptBatch({}, context_info);
+  ASSERT_TRUE(empty_result.ok()) << empty_result.status();
+  EXPECT_TRUE(empty_result.ValueOrDie().empty());
+
+  // One undecryptable ciphertext fails the whole batch.
+  ciphertext_views.push_back("some bad ciphertext");
+  auto failed_result = hybrid_decrypt->DecryptBatch(
+      absl::MakeConstSpan(ciphertext_views), context_info);
+  EXPECT_FALSE(failed_result.ok());
+  EXPECT_EQ(util::error::INVALID_ARGUMENT,
+            failed_result.status().error_code());
+}
+
 }  // namespace
 }  // namespace tink
 }  // namespace crypto
@@ -17,7 +17,14 @@
 #ifndef TINK_HYBRID_DECRYPT_H_
 #define TINK_HYBRID_DECRYPT_H_
 
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "tink/util/status.h"
 #include "tink/util/statusor.h"
 
 namespace crypto {
@@ -59,6 +66,49 @@ class HybridDecrypt {
   virtual crypto::tink::util::StatusOr<std::string> Decrypt(
       absl::string_view ciphertext, absl::string_view context_info) const = 0;
 
+  // Decrypts 'ciphertext' verifying the integrity of 'context_info', writing
+  // the plaintext into the caller-provided buffer 'out', and returns the
+  // number of bytes written. 'out' must be at least ciphertext.size() bytes
+  // long (the plaintext is always shorter than the ciphertext) and must not
+  // overlap 'ciphertext'. On failure the contents of 'out' are unspecified.
+  // The default implementation falls back to Decrypt() and copies;
+  // implementations should override it to write the plaintext directly into
+  // 'out' so that large plaintexts do not go through a transient allocation.
+  virtual crypto::tink::util::StatusOr<size_t> DecryptInto(
+      absl::string_view ciphertext, absl::string_view context_info,
+      absl::Span<char> out) const {
+    auto plaintext = Decrypt(ciphertext, context_info);
+    if (!plaintext.ok()) return plaintext.status();
+    if (out.size() < plaintext.ValueOrDie().size()) {
+      return crypto::tink::util::Status(
+          crypto::tink::util::error::INVALID_ARGUMENT,
+          "Output buffer too small.");
+    }
+    memcpy(out.data(), plaintext.ValueOrDie().data(),
+           plaintext.ValueOrDie().size());
+    return plaintext.ValueOrDie().size();
+  }
+
+  // Decrypts a batch of ciphertexts which all share the same 'context_info',
+  // and returns the plaintexts in the order of the ciphertexts. Fails with
+  // the status of the first ciphertext that cannot be decrypted; in that
+  // case none of the plaintexts are returned.
+  // The default implementation calls Decrypt() once per ciphertext;
+  // keyset wrappers override it to amortize per-key work (like the key
+  // lookup) over all ciphertexts addressed to the same key.
+  virtual crypto::tink::util::StatusOr<std::vector<std::string>> DecryptBatch(
+      absl::Span<const absl::string_view> ciphertexts,
+      absl::string_view context_info) const {
+    std::vector<std::string> plaintexts;
+    plaintexts.reserve(ciphertexts.size());
+    for (absl::string_view ciphertext : ciphertexts) {
+      auto plaintext = Decrypt(ciphertext, context_info);
+      if (!plaintext.ok()) return plaintext.status();
+      plaintexts.push_back(std::move(plaintext.ValueOrDie()));
+    }
+    return std::move(plaintexts);
+  }
+
   virtual ~HybridDecrypt() {}
 };
 
@@ -17,6 +17,10 @@
 #ifndef TINK_INPUT_STREAM_H_
 #define TINK_INPUT_STREAM_H_
 
+#include <algorithm>
+#include <cstring>
+
+#include "absl/types/span.h"
 #include "tink/util/status.h"
 #include "tink/util/statusor.h"
 
@@ -78,6 +82,32 @@ class InputStream {
   // * The actual result of BackUp()-call can be verified via Position().
   virtual void BackUp(int count) = 0;
 
+  // Reads exactly 'out.size()' bytes from the stream into 'out'.
+  // Returns OUT_OF_RANGE if the stream ends before that many bytes are
+  // available (a prefix of 'out' may have been overwritten by then), and
+  // any other non-OK status upon an error. Bytes served by ReadExact()
+  // cannot be returned to the stream: a subsequent BackUp() call can give
+  // back at most what the last Next() call before ReadExact() returned.
+  // The default implementation loops over Next()/BackUp(); streams that
+  // can serve the read in one step (in-memory or buffered streams)
+  // override it to skip the per-chunk virtual calls and bookkeeping.
+  virtual crypto::tink::util::Status ReadExact(absl::Span<char> out) {
+    const void* buffer;
+    int num_bytes_read = 0;
+    int num_bytes = static_cast<int>(out.size());
+    while (num_bytes_read < num_bytes) {
+      auto next_result = Next(&buffer);
+      if (!next_result.ok()) return next_result.status();
+      int num_bytes_in_chunk = next_result.ValueOrDie();
+      int num_bytes_to_copy =
+          std::min(num_bytes - num_bytes_read, num_bytes_in_chunk);
+      std::memcpy(out.data() + num_bytes_read, buffer, num_bytes_to_copy);
+      BackUp(num_bytes_in_chunk - num_bytes_to_copy);
+      num_bytes_read += num_bytes_to_copy;
+    }
+    return crypto::tink::util::OkStatus();
+  }
+
   // Returns the current byte position in the stream.
   //
   // Preconditions:
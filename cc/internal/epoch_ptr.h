@@ -0,0 +1,242 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_INTERNAL_EPOCH_PTR_H_
+#define TINK_INTERNAL_EPOCH_PTR_H_
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+
+namespace crypto {
+namespace tink {
+namespace internal {
+
+// Process-wide registry of per-thread reader epochs, the bookkeeping behind
+// EpochPtr. Every reading thread owns one cache-line-padded slot in which it
+// announces the global epoch it observed before dereferencing a protected
+// pointer (0 means quiescent). A writer retires an object under epoch E and
+// may free it once no slot announces an epoch <= E.
+//
+// Slots are shared by all EpochPtr instances: a thread announces at most one
+// epoch no matter how many protected pointers it reads, so the per-operation
+// reader cost is two uncontended stores to the thread's own slot.
+class EpochReaderRegistry {
+ public:
+  struct Slot {
+    std::atomic<std::uint64_t> epoch{0};  // 0 = quiescent
+    std::atomic<bool> in_use{false};
+    std::atomic<Slot*> next{nullptr};
+    // Reentrancy count of the owning thread; only that thread touches it.
+    int depth = 0;
+    // Keeps slots of different threads on different cache lines.
+    char padding[64];
+  };
+
+  static EpochReaderRegistry& Global() {
+    static EpochReaderRegistry* registry = new EpochReaderRegistry();
+    return *registry;
+  }
+
+  // Returns the calling thread's slot, claiming a free one (or appending a
+  // new one) on first use. The slot is returned to the free pool when the
+  // thread exits.
+  Slot* ThreadSlot() {
+    thread_local static SlotReservation reservation;
+    return reservation.slot;
+  }
+
+  std::uint64_t current_epoch() const {
+    return global_epoch_.load(std::memory_order_seq_cst);
+  }
+
+  // Closes the current epoch and returns it; objects retired under the
+  // returned epoch may be freed once MinActiveEpoch() exceeds it.
+  std::uint64_t AdvanceEpoch() {
+    return global_epoch_.fetch_add(1, std::memory_order_seq_cst);
+  }
+
+  // Returns the smallest epoch announced by any active reader, or the
+  // maximum uint64 value if no reader is active.
+  std::uint64_t MinActiveEpoch() const {
+    std::uint64_t min_epoch = std::numeric_limits<std::uint64_t>::max();
+    for (Slot* slot = head_.load(std::memory_order_acquire); slot != nullptr;
+         slot = slot->next.load(std::memory_order_acquire)) {
+      std::uint64_t epoch = slot->epoch.load(std::memory_order_seq_cst);
+      if (epoch != 0 && epoch < min_epoch) min_epoch = epoch;
+    }
+    return min_epoch;
+  }
+
+ private:
+  EpochReaderRegistry() {}
+
+  Slot* AcquireSlot() {
+    for (Slot* slot = head_.load(std::memory_order_acquire); slot != nullptr;
+         slot = slot->next.load(std::memory_order_acquire)) {
+      bool expected = false;
+      if (!slot->in_use.load(std::memory_order_relaxed) &&
+          slot->in_use.compare_exchange_strong(expected, true,
+                                               std::memory_order_acq_rel)) {
+        return slot;
+      }
+    }
+    Slot* slot = new Slot();
+    slot->in_use.store(true, std::memory_order_relaxed);
+    Slot* old_head = head_.load(std::memory_order_relaxed);
+    do {
+      slot->next.store(old_head, std::memory_order_relaxed);
+    } while (!head_.compare_exchange_weak(old_head, slot,
+                                          std::memory_order_release,
+                                          std::memory_order_relaxed));
+    return slot;
+  }
+
+  // Claims a slot for the lifetime of the thread and recycles it on exit.
+  struct SlotReservation {
+    SlotReservation() : slot(Global().AcquireSlot()) {}
+    ~SlotReservation() {
+      slot->epoch.store(0, std::memory_order_release);
+      slot->in_use.store(false, std::memory_order_release);
+    }
+    Slot* const slot;
+  };
+
+  // Append-only list of slots; slots are recycled, never freed, so readers
+  // may traverse the list without synchronization against removal.
+  std::atomic<Slot*> head_{nullptr};
+  std::atomic<std::uint64_t> global_epoch_{1};
+};
+
+// A pointer that can be swapped concurrently with readers, with epoch-based
+// reclamation of replaced objects: the per-operation reader cost is a plain
+// atomic load plus two stores to the reader's own epoch slot, with no shared
+// reference count to contend on. The price is deferred reclamation -- a
+// replaced object is freed by a later Swap()/TryReclaim() (or the
+// destructor) once every reader that might still hold it has finished.
+//
+// ReadGuards must not outlive the EpochPtr, and no reader may be active when
+// the destructor runs.
+template <class T>
+class EpochPtr {
+ public:
+  // Pins the object for the guard's lifetime by announcing the reader's
+  // epoch. Movable so it can be returned from accessors.
+  class ReadGuard {
+   public:
+    explicit ReadGuard(const std::atomic<T*>& current) {
+      EpochReaderRegistry& registry = EpochReaderRegistry::Global();
+      slot_ = registry.ThreadSlot();
+      if (slot_->depth++ == 0) {
+        // Announce-and-validate: once the global epoch is observed unchanged
+        // after the announcement, any object retired under an older epoch
+        // was already replaced, so the load below cannot return it.
+        std::uint64_t epoch = registry.current_epoch();
+        while (true) {
+          slot_->epoch.store(epoch, std::memory_order_seq_cst);
+          std::uint64_t latest = registry.current_epoch();
+          if (latest == epoch) break;
+          epoch = latest;
+        }
+      }
+      ptr_ = current.load(std::memory_order_acquire);
+    }
+
+    ReadGuard(ReadGuard&& other) : ptr_(other.ptr_), slot_(other.slot_) {
+      other.slot_ = nullptr;
+    }
+    ReadGuard(const ReadGuard&) = delete;
+    ReadGuard& operator=(const ReadGuard&) = delete;
+    ReadGuard& operator=(ReadGuard&&) = delete;
+
+    ~ReadGuard() {
+      if (slot_ != nullptr && --slot_->depth == 0) {
+        slot_->epoch.store(0, std::memory_order_release);
+      }
+    }
+
+    T* get() const { return ptr_; }
+    T* operator->() const { return ptr_; }
+    T& operator*() const { return *ptr_; }
+
+   private:
+    T* ptr_;
+    EpochReaderRegistry::Slot* slot_;
+  };
+
+  EpochPtr() : current_(nullptr) {}
+  explicit EpochPtr(std::unique_ptr<T> initial)
+      : current_(initial.release()) {}
+
+  EpochPtr(const EpochPtr&) = delete;
+  EpochPtr& operator=(const EpochPtr&) = delete;
+
+  ~EpochPtr() {
+    delete current_.load(std::memory_order_relaxed);
+    // Retired objects need no epoch check here: the contract requires that
+    // no reader is active at destruction.
+  }
+
+  // Returns a guard for the currently published object. Wait-free apart
+  // from the first call on a new thread, which registers its epoch slot.
+  ReadGuard Read() const { return ReadGuard(current_); }
+
+  // Publishes 'fresh' and retires the previous object, freeing any retired
+  // objects that no reader can still hold.
+  void Swap(std::unique_ptr<T> fresh) {
+    T* old = current_.exchange(fresh.release(), std::memory_order_acq_rel);
+    std::uint64_t retire_epoch = EpochReaderRegistry::Global().AdvanceEpoch();
+    {
+      absl::MutexLock lock(&retired_mutex_);
+      retired_.emplace_back(retire_epoch, std::unique_ptr<T>(old));
+    }
+    TryReclaim();
+  }
+
+  // Frees retired objects whose retirement epoch precedes every active
+  // reader. Called by Swap(); exposed for callers that want to bound limbo
+  // memory without swapping again.
+  void TryReclaim() {
+    std::uint64_t min_active = EpochReaderRegistry::Global().MinActiveEpoch();
+    absl::MutexLock lock(&retired_mutex_);
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < retired_.size(); i++) {
+      if (retired_[i].first >= min_active) {
+        retired_[kept++] = std::move(retired_[i]);
+      }
+    }
+    retired_.resize(kept);
+  }
+
+ private:
+  std::atomic<T*> current_;
+
+  absl::Mutex retired_mutex_;
+  std::vector<std::pair<std::uint64_t, std::unique_ptr<T>>> retired_
+      ABSL_GUARDED_BY(retired_mutex_);
+};
+
+}  // namespace internal
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_INTERNAL_EPOCH_PTR_H_
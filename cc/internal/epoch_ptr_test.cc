@@ -0,0 +1,125 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/internal/epoch_ptr.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/memory/memory.h"
+
+namespace crypto {
+namespace tink {
+namespace internal {
+namespace {
+
+// Counts live instances, to observe when reclamation actually happens.
+class Tracked {
+ public:
+  Tracked(int value, std::atomic<int>* live_count)
+      : value_(value), live_count_(live_count) {
+    live_count_->fetch_add(1);
+  }
+  ~Tracked() { live_count_->fetch_sub(1); }
+
+  int value() const { return value_; }
+
+ private:
+  const int value_;
+  std::atomic<int>* const live_count_;
+};
+
+TEST(EpochPtrTest, ReadAndSwap) {
+  std::atomic<int> live_count(0);
+  EpochPtr<Tracked> ptr(absl::make_unique<Tracked>(1, &live_count));
+  EXPECT_EQ(1, ptr.Read()->value());
+
+  ptr.Swap(absl::make_unique<Tracked>(2, &live_count));
+  EXPECT_EQ(2, ptr.Read()->value());
+}
+
+TEST(EpochPtrTest, GuardKeepsRetiredObjectAlive) {
+  std::atomic<int> live_count(0);
+  EpochPtr<Tracked> ptr(absl::make_unique<Tracked>(1, &live_count));
+  {
+    auto guard = ptr.Read();
+    ASSERT_EQ(1, guard->value());
+
+    ptr.Swap(absl::make_unique<Tracked>(2, &live_count));
+    ptr.TryReclaim();
+    // The guard still protects the object it obtained before the swap.
+    EXPECT_EQ(1, guard->value());
+    EXPECT_EQ(2, live_count.load());
+  }
+  // With the guard gone, the retired object may be reclaimed.
+  ptr.TryReclaim();
+  EXPECT_EQ(1, live_count.load());
+  EXPECT_EQ(2, ptr.Read()->value());
+}
+
+TEST(EpochPtrTest, NestedGuardsOnOneThread) {
+  std::atomic<int> live_count(0);
+  EpochPtr<Tracked> ptr(absl::make_unique<Tracked>(1, &live_count));
+  auto outer = ptr.Read();
+  {
+    auto inner = ptr.Read();
+    EXPECT_EQ(1, inner->value());
+  }
+  // The outer guard must still protect its object after the inner guard
+  // was destroyed.
+  ptr.Swap(absl::make_unique<Tracked>(2, &live_count));
+  ptr.TryReclaim();
+  EXPECT_EQ(1, outer->value());
+  EXPECT_EQ(2, live_count.load());
+}
+
+TEST(EpochPtrTest, ConcurrentReadersAndSwaps) {
+  std::atomic<int> live_count(0);
+  // Every published object carries the value 42, so a reader observing
+  // anything else dereferenced a reclaimed object.
+  EpochPtr<Tracked> ptr(absl::make_unique<Tracked>(42, &live_count));
+  std::atomic<bool> done(false);
+  std::atomic<int> errors(0);
+
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; i++) {
+    readers.emplace_back([&ptr, &done, &errors]() {
+      while (!done.load()) {
+        auto guard = ptr.Read();
+        if (guard->value() != 42) errors.fetch_add(1);
+      }
+    });
+  }
+  for (int i = 0; i < 1000; i++) {
+    ptr.Swap(absl::make_unique<Tracked>(42, &live_count));
+  }
+  done.store(true);
+  for (auto& reader : readers) {
+    reader.join();
+  }
+
+  EXPECT_EQ(0, errors.load());
+  ptr.TryReclaim();
+  EXPECT_EQ(1, live_count.load());
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace tink
+}  // namespace crypto
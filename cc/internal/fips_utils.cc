@@ -24,15 +24,22 @@ namespace crypto {
 namespace tink {
 namespace internal {
 
-#ifdef TINK_USE_ONLY_FIPS
-const bool kUseOnlyFips = true;
-#else
-const bool kUseOnlyFips = false;
-#endif
-
 static std::atomic<bool> is_fips_restricted(false);
 
-void SetFipsRestricted() { is_fips_restricted = true; }
+bool IsFipsRestricted() { return is_fips_restricted; }
+
+util::Status SetFipsRestricted() {
+  if (kFipsModeImmutable && !kUseOnlyFips) {
+    // Silently absorbing the request would leave the caller believing FIPS
+    // restrictions are in place while nothing is enforced.
+    return util::Status(
+        util::error::INTERNAL,
+        "Cannot enable FIPS restrictions at runtime: Tink was built with "
+        "TINK_FIPS_MODE_IMMUTABLE, which fixes the policy to non-FIPS.");
+  }
+  is_fips_restricted = true;
+  return util::OkStatus();
+}
 
 void UnSetFipsRestricted() { is_fips_restricted = false; }
 
@@ -46,8 +53,12 @@ crypto::tink::util::Status ChecksFipsCompatibility(
       } else {
         return util::OkStatus();
       }
-    case FipsCompatibility::kRequiresBoringCrypto:
-      if ((IsFipsModeEnabled()) && !FIPS_mode()) {
+    case FipsCompatibility::kRequiresBoringCrypto: {
+      // Whether BoringSSL was built with the BoringCrypto module is a
+      // property of the binary and cannot change at runtime; probe it once
+      // instead of on every registration.
+      static const bool kHasBoringCrypto = FIPS_mode() != 0;
+      if ((IsFipsModeEnabled()) && !kHasBoringCrypto) {
         return util::Status(
             util::error::INTERNAL,
             "BoringSSL not built with the BoringCrypto module. If you want to "
@@ -56,14 +67,13 @@ crypto::tink::util::Status ChecksFipsCompatibility(
       } else {
         return util::OkStatus();
       }
+    }
     default:
       return util::Status(util::error::INTERNAL,
                           "Could not determine FIPS status.");
   }
 }
 
-bool IsFipsModeEnabled() { return kUseOnlyFips || is_fips_restricted; }
-
 }  // namespace internal
 }  // namespace tink
 }  // namespace crypto
@@ -17,7 +17,6 @@
 #ifndef TINK_CONFIG_INTERNAL_FIPS_UTILS_H_
 #define TINK_CONFIG_INTERNAL_FIPS_UTILS_H_
 
-#include "absl/base/attributes.h"
 #include "tink/util/status.h"
 
 namespace crypto {
@@ -28,15 +27,41 @@ namespace internal {
 // is set, then usage of algorithms will be restricted to algorithms which
 // utilize the FIPS validated BoringCrypto module. TODO(kste): Check if this can
 // be removed.
-ABSL_CONST_INIT extern const bool kUseOnlyFips;
+#ifdef TINK_USE_ONLY_FIPS
+constexpr bool kUseOnlyFips = true;
+#else
+constexpr bool kUseOnlyFips = false;
+#endif
+
+// This flag indicates whether the FIPS policy is fixed at compile time.
+// It is set when building in FIPS only mode (the policy is then "always
+// FIPS"), or when building with TINK_FIPS_MODE_IMMUTABLE (the policy is
+// then "never FIPS"). With the policy fixed, IsFipsModeEnabled() folds to
+// a compile-time constant and no runtime check remains on the
+// primitive-construction and registration paths that consult it.
+#if defined(TINK_USE_ONLY_FIPS) || defined(TINK_FIPS_MODE_IMMUTABLE)
+constexpr bool kFipsModeImmutable = true;
+#else
+constexpr bool kFipsModeImmutable = false;
+#endif
+
+// Returns true if the FIPS restrictions have been enabled at runtime via
+// SetFipsRestricted().
+bool IsFipsRestricted();
 
 // This function will return true if Tink has been built in FIPS mode or if
 // the FIPS restrictions have been enabled at runtime.
-bool IsFipsModeEnabled();
+inline bool IsFipsModeEnabled() {
+  if (kUseOnlyFips) return true;
+  if (kFipsModeImmutable) return false;
+  return IsFipsRestricted();
+}
 
 // Enable FIPS restrictions. If Tink has been built in FIPS mode this is
-// redundant.
-void SetFipsRestricted();
+// redundant. In binaries built with TINK_FIPS_MODE_IMMUTABLE the policy is
+// fixed to "never FIPS" and cannot be changed at runtime; in that case this
+// returns an INTERNAL error and leaves the policy untouched.
+crypto::tink::util::Status SetFipsRestricted();
 
 // Disable FIPS restrictions. Note that if Tink has been built in FIPS mode this
 // will have no effect.
@@ -82,6 +82,34 @@ TEST(TinkFipsTest, CompatibilityInFipsModeWithoutBoringCrypto) {
       StatusIs(util::error::INTERNAL));
 }
 
+TEST(FipsUtilsTest, RuntimeRestrictionTogglesFipsMode) {
+  if (internal::kFipsModeImmutable) {
+    GTEST_SKIP() << "FIPS policy is fixed at compile time.";
+  }
+
+  EXPECT_FALSE(internal::IsFipsModeEnabled());
+  EXPECT_THAT(internal::SetFipsRestricted(), IsOk());
+  EXPECT_TRUE(internal::IsFipsModeEnabled());
+  internal::UnSetFipsRestricted();
+  EXPECT_FALSE(internal::IsFipsModeEnabled());
+}
+
+TEST(FipsUtilsTest, SetFipsRestrictedFailsWithImmutablePolicy) {
+  if (!internal::kFipsModeImmutable || internal::kUseOnlyFips) {
+    GTEST_SKIP() << "Test only run with TINK_FIPS_MODE_IMMUTABLE.";
+  }
+
+  EXPECT_THAT(internal::SetFipsRestricted(),
+              StatusIs(util::error::INTERNAL));
+  EXPECT_FALSE(internal::IsFipsModeEnabled());
+}
+
+TEST(FipsUtilsTest, FipsOnlyBuildsHaveImmutablePolicy) {
+  if (internal::kUseOnlyFips) {
+    EXPECT_TRUE(internal::kFipsModeImmutable);
+  }
+}
+
 }  // namespace
 
 }  // namespace tink
@@ -16,12 +16,134 @@
 
 #include "tink/internal/key_info.h"
 
+#include <cstdint>
+#include <string>
+
+#include "absl/strings/string_view.h"
+#include "tink/util/status.h"
+
 namespace crypto {
 namespace tink {
 
 using ::google::crypto::tink::Keyset;
 using ::google::crypto::tink::KeysetInfo;
 
+namespace {
+
+// Proto wire types, see
+// https://developers.google.com/protocol-buffers/docs/encoding.
+const int kWireTypeVarint = 0;
+const int kWireTypeFixed64 = 1;
+const int kWireTypeLengthDelimited = 2;
+const int kWireTypeFixed32 = 5;
+
+// Reads a base-128 varint from the front of *data, advancing past it.
+// Returns false if data ends mid-varint or the varint exceeds 64 bits.
+bool ReadVarint(absl::string_view* data, uint64_t* value) {
+  uint64_t result = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (data->empty()) return false;
+    uint8_t byte = static_cast<uint8_t>((*data)[0]);
+    data->remove_prefix(1);
+    result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      *value = result;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Reads a length-delimited field payload from the front of *data; *payload
+// aliases the bytes in place, nothing is copied.
+bool ReadLengthDelimited(absl::string_view* data, absl::string_view* payload) {
+  uint64_t length;
+  if (!ReadVarint(data, &length) || length > data->size()) return false;
+  *payload = data->substr(0, length);
+  data->remove_prefix(length);
+  return true;
+}
+
+// Skips over a field of the given wire type. Groups are rejected, as no
+// Tink proto uses them.
+bool SkipField(absl::string_view* data, int wire_type) {
+  switch (wire_type) {
+    case kWireTypeVarint: {
+      uint64_t ignored;
+      return ReadVarint(data, &ignored);
+    }
+    case kWireTypeFixed64:
+      if (data->size() < 8) return false;
+      data->remove_prefix(8);
+      return true;
+    case kWireTypeLengthDelimited: {
+      absl::string_view ignored;
+      return ReadLengthDelimited(data, &ignored);
+    }
+    case kWireTypeFixed32:
+      if (data->size() < 4) return false;
+      data->remove_prefix(4);
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Extracts KeyData.type_url (field 1) from a serialized KeyData, skipping
+// all other fields -- in particular the key material in value (field 2).
+bool ParseKeyDataMetadata(absl::string_view data,
+                          KeysetInfo::KeyInfo* key_info) {
+  while (!data.empty()) {
+    uint64_t tag;
+    if (!ReadVarint(&data, &tag)) return false;
+    uint64_t field_number = tag >> 3;
+    int wire_type = tag & 0x7;
+    if (field_number == 1 && wire_type == kWireTypeLengthDelimited) {
+      absl::string_view type_url;
+      if (!ReadLengthDelimited(&data, &type_url)) return false;
+      key_info->set_type_url(std::string(type_url));
+    } else if (!SkipField(&data, wire_type)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Extracts the metadata fields of a serialized Keyset.Key into *key_info.
+bool ParseKeyMetadata(absl::string_view data, KeysetInfo::KeyInfo* key_info) {
+  while (!data.empty()) {
+    uint64_t tag;
+    if (!ReadVarint(&data, &tag)) return false;
+    uint64_t field_number = tag >> 3;
+    int wire_type = tag & 0x7;
+    if (field_number == 1 && wire_type == kWireTypeLengthDelimited) {
+      absl::string_view key_data;
+      if (!ReadLengthDelimited(&data, &key_data)) return false;
+      if (!ParseKeyDataMetadata(key_data, key_info)) return false;
+    } else if (field_number == 2 && wire_type == kWireTypeVarint) {
+      uint64_t status;
+      if (!ReadVarint(&data, &status)) return false;
+      key_info->set_status(
+          static_cast<google::crypto::tink::KeyStatusType>(status));
+    } else if (field_number == 3 && wire_type == kWireTypeVarint) {
+      uint64_t key_id;
+      if (!ReadVarint(&data, &key_id)) return false;
+      key_info->set_key_id(static_cast<uint32_t>(key_id));
+    } else if (field_number == 4 && wire_type == kWireTypeVarint) {
+      uint64_t output_prefix_type;
+      if (!ReadVarint(&data, &output_prefix_type)) return false;
+      key_info->set_output_prefix_type(
+          static_cast<google::crypto::tink::OutputPrefixType>(
+              output_prefix_type));
+    } else if (!SkipField(&data, wire_type)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
 KeysetInfo::KeyInfo KeyInfoFromKey(const Keyset::Key& key) {
   KeysetInfo::KeyInfo key_info;
   key_info.set_key_id(key.key_id());
@@ -40,5 +162,39 @@ KeysetInfo KeysetInfoFromKeyset(const Keyset& keyset) {
   return keyset_info;
 }
 
+crypto::tink::util::StatusOr<KeysetInfo> KeysetInfoFromSerializedKeyset(
+    absl::string_view serialized_keyset) {
+  KeysetInfo keyset_info;
+  absl::string_view data = serialized_keyset;
+  while (!data.empty()) {
+    uint64_t tag;
+    if (!ReadVarint(&data, &tag)) {
+      return util::Status(util::error::INVALID_ARGUMENT,
+                          "invalid serialized keyset");
+    }
+    uint64_t field_number = tag >> 3;
+    int wire_type = tag & 0x7;
+    if (field_number == 1 && wire_type == kWireTypeVarint) {
+      uint64_t primary_key_id;
+      if (!ReadVarint(&data, &primary_key_id)) {
+        return util::Status(util::error::INVALID_ARGUMENT,
+                            "invalid serialized keyset");
+      }
+      keyset_info.set_primary_key_id(static_cast<uint32_t>(primary_key_id));
+    } else if (field_number == 2 && wire_type == kWireTypeLengthDelimited) {
+      absl::string_view key;
+      if (!ReadLengthDelimited(&data, &key) ||
+          !ParseKeyMetadata(key, keyset_info.add_key_info())) {
+        return util::Status(util::error::INVALID_ARGUMENT,
+                            "invalid serialized keyset");
+      }
+    } else if (!SkipField(&data, wire_type)) {
+      return util::Status(util::error::INVALID_ARGUMENT,
+                          "invalid serialized keyset");
+    }
+  }
+  return keyset_info;
+}
+
 }  // namespace tink
 }  // namespace crypto
@@ -16,6 +16,8 @@
 #ifndef TINK_INTERNAL_KEY_INFO_H_
 #define TINK_INTERNAL_KEY_INFO_H_
 
+#include "absl/strings/string_view.h"
+#include "tink/util/statusor.h"
 #include "proto/tink.pb.h"
 
 namespace crypto {
@@ -27,6 +29,16 @@ google::crypto::tink::KeysetInfo::KeyInfo KeyInfoFromKey(
 google::crypto::tink::KeysetInfo KeysetInfoFromKeyset(
     const google::crypto::tink::Keyset& keyset);
 
+// Builds a KeysetInfo directly from a serialized Keyset proto, without
+// parsing the Keyset itself. Only the metadata fields are decoded
+// (primary_key_id, and per key its key_id, status, output_prefix_type and
+// KeyData.type_url); the key material (KeyData.value) is skipped over on
+// the wire and never copied, so no transient copies of secrets are made.
+// Returns INVALID_ARGUMENT if serialized_keyset is not a valid
+// serialization of a Keyset.
+crypto::tink::util::StatusOr<google::crypto::tink::KeysetInfo>
+KeysetInfoFromSerializedKeyset(absl::string_view serialized_keyset);
+
 }  // namespace tink
 }  // namespace crypto
 
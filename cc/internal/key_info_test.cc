@@ -16,8 +16,11 @@
 
 #include "tink/internal/key_info.h"
 
+#include <string>
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "tink/util/test_matchers.h"
 #include "proto/tink.pb.h"
 
 namespace crypto {
@@ -25,8 +28,11 @@ namespace tink {
 
 namespace {
 
+using ::crypto::tink::test::IsOk;
 using ::testing::Eq;
+using ::testing::Not;
 using ::google::crypto::tink::Keyset;
+using ::google::crypto::tink::KeysetInfo;
 
 TEST(KeyInfoFromKeyTest, Basic) {
   Keyset::Key key;
@@ -73,6 +79,61 @@ TEST(KeySetInfoForKeySetTest, Basic) {
   EXPECT_THAT(KeysetInfoFromKeyset(keyset).key_info(2).key_id(), Eq(1235));
 }
 
+TEST(KeysetInfoFromSerializedKeysetTest, MatchesFullParse) {
+  Keyset keyset;
+  keyset.set_primary_key_id(1234);
+  for (int i = 0; i < 3; i++) {
+    Keyset::Key* key = keyset.add_key();
+    key->set_key_id(1233 + i);
+    key->set_status(google::crypto::tink::ENABLED);
+    key->set_output_prefix_type(google::crypto::tink::OutputPrefixType::TINK);
+    key->mutable_key_data()->set_type_url("SomeTypeUrl");
+    key->mutable_key_data()->set_value(std::string(1024, 'k'));
+    key->mutable_key_data()->set_key_material_type(
+        google::crypto::tink::KeyData::SYMMETRIC);
+  }
+
+  auto result = KeysetInfoFromSerializedKeyset(keyset.SerializeAsString());
+  ASSERT_THAT(result.status(), IsOk());
+  KeysetInfo keyset_info = result.ValueOrDie();
+  KeysetInfo expected = KeysetInfoFromKeyset(keyset);
+  EXPECT_THAT(keyset_info.primary_key_id(), Eq(expected.primary_key_id()));
+  ASSERT_THAT(keyset_info.key_info().size(), Eq(expected.key_info().size()));
+  for (int i = 0; i < expected.key_info().size(); i++) {
+    EXPECT_THAT(keyset_info.key_info(i).key_id(),
+                Eq(expected.key_info(i).key_id()));
+    EXPECT_THAT(keyset_info.key_info(i).status(),
+                Eq(expected.key_info(i).status()));
+    EXPECT_THAT(keyset_info.key_info(i).output_prefix_type(),
+                Eq(expected.key_info(i).output_prefix_type()));
+    EXPECT_THAT(keyset_info.key_info(i).type_url(),
+                Eq(expected.key_info(i).type_url()));
+  }
+}
+
+TEST(KeysetInfoFromSerializedKeysetTest, EmptySerialization) {
+  auto result = KeysetInfoFromSerializedKeyset("");
+  ASSERT_THAT(result.status(), IsOk());
+  EXPECT_THAT(result.ValueOrDie().key_info().size(), Eq(0));
+}
+
+TEST(KeysetInfoFromSerializedKeysetTest, MalformedSerialization) {
+  Keyset keyset;
+  keyset.set_primary_key_id(1234);
+  Keyset::Key* key = keyset.add_key();
+  key->set_key_id(1233);
+  key->mutable_key_data()->set_type_url("SomeTypeUrl");
+  std::string serialized = keyset.SerializeAsString();
+
+  // Truncating the serialization mid-field must be rejected.
+  EXPECT_THAT(
+      KeysetInfoFromSerializedKeyset(serialized.substr(0, serialized.size() - 1))
+          .status(),
+      Not(IsOk()));
+  // A lone tag with no payload must be rejected as well.
+  EXPECT_THAT(KeysetInfoFromSerializedKeyset("\x12").status(), Not(IsOk()));
+}
+
 }  // namespace
 }  // namespace tink
 }  // namespace crypto
@@ -16,6 +16,10 @@
 #ifndef TINK_INTERNAL_KEYSET_WRAPPER_IMPL_H_
 #define TINK_INTERNAL_KEYSET_WRAPPER_IMPL_H_
 
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+
 #include "tink/internal/key_info.h"
 #include "tink/internal/keyset_wrapper.h"
 #include "tink/primitive_set.h"
@@ -44,26 +48,165 @@ class KeysetWrapperImpl : public KeysetWrapper<Q> {
       const google::crypto::tink::Keyset& keyset) const override {
     crypto::tink::util::Status status = ValidateKeyset(keyset);
     if (!status.ok()) return status;
-    std::unique_ptr<PrimitiveSet<P>> primitives =
-        absl::make_unique<PrimitiveSet<P>>();
+    // If the keyset holds exactly one enabled key, that key is the primary
+    // and uses the RAW output prefix, the wrapped primitive would add only a
+    // virtual hop plus no-op prefix handling per operation: there is no
+    // prefix to write on encryption and nothing to dispatch on otherwise.
+    // When additionally the wrapper does not change the primitive type
+    // (P == Q), hand out the inner primitive directly instead of building
+    // the PrimitiveSet and wrapper object.
+    if (std::is_same<P, Q>::value) {
+      const google::crypto::tink::Keyset::Key* single_enabled_key = nullptr;
+      int enabled_key_count = 0;
+      for (const google::crypto::tink::Keyset::Key& key : keyset.key()) {
+        if (key.status() != google::crypto::tink::KeyStatusType::ENABLED) {
+          continue;
+        }
+        enabled_key_count++;
+        single_enabled_key = &key;
+      }
+      if (enabled_key_count == 1 &&
+          single_enabled_key->key_id() == keyset.primary_key_id() &&
+          single_enabled_key->output_prefix_type() ==
+              google::crypto::tink::OutputPrefixType::RAW) {
+        return WrapSingleRawKey(*single_enabled_key, std::is_same<P, Q>());
+      }
+    }
+    typename PrimitiveSet<P>::Builder primitives_builder;
     for (const google::crypto::tink::Keyset::Key& key : keyset.key()) {
       if (key.status() != google::crypto::tink::KeyStatusType::ENABLED) {
         continue;
       }
-      auto primitive = primitive_getter_(key.key_data());
-      if (!primitive.ok()) return primitive.status();
-      auto entry = primitives->AddPrimitive(std::move(primitive.ValueOrDie()),
-                                            KeyInfoFromKey(key));
-      if (!entry.ok()) return entry.status();
       if (key.key_id() == keyset.primary_key_id()) {
-        auto primary_result = primitives->set_primary(entry.ValueOrDie());
-        if (!primary_result.ok()) return primary_result;
+        // The primary is used by every "encrypting" operation, so it is built
+        // eagerly -- this also lets construction errors surface here.
+        auto primitive = primitive_getter_(key.key_data());
+        if (!primitive.ok()) return primitive.status();
+        primitives_builder.AddPrimaryPrimitive(
+            std::move(primitive.ValueOrDie()), KeyInfoFromKey(key));
+      } else {
+        // Non-primary keys are typically only needed while older ciphertexts
+        // are still around; building them on first use avoids paying key proto
+        // parsing and cipher setup for keys which are never hit. The getter
+        // and a copy of the key data are captured so the entry can
+        // materialize itself later; failures are reported by
+        // Entry::primitive_or_status() at the point of use.
+        auto getter = primitive_getter_;
+        google::crypto::tink::KeyData key_data = key.key_data();
+        primitives_builder.AddLazyPrimitive(
+            [getter, key_data]() { return getter(key_data); },
+            KeyInfoFromKey(key));
+      }
+    }
+    auto primitives = std::move(primitives_builder).Build();
+    if (!primitives.ok()) return primitives.status();
+    return transforming_wrapper_.Wrap(std::move(primitives.ValueOrDie()));
+  }
+
+  // Like Wrap(), but reuses the work captured in 'previous_primitives', the
+  // primitive set built when 'previous_keyset' was wrapped earlier. A key of
+  // 'keyset' which is byte-identical to its counterpart in 'previous_keyset'
+  // does not construct a primitive: the new entry shares the previously
+  // built primitive, or carries over the still-unrun factory of a lazy
+  // entry. Only added or changed keys build primitives, and removed keys are
+  // simply not carried over, so re-wrapping a keyset after a rotation costs
+  // O(changed keys) instead of O(keys). 'previous_primitives' is only read;
+  // primitives handed out from earlier wraps stay valid.
+  crypto::tink::util::StatusOr<std::unique_ptr<Q>> WrapIncremental(
+      const google::crypto::tink::Keyset& keyset,
+      const google::crypto::tink::Keyset& previous_keyset,
+      const PrimitiveSet<P>& previous_primitives) const {
+    crypto::tink::util::Status status = ValidateKeyset(keyset);
+    if (!status.ok()) return status;
+    // Keysets may legally hold several keys with the same id; reuse is
+    // limited to ids which are unambiguous on both sides, the rest is built
+    // from scratch as in Wrap().
+    std::unordered_map<uint32_t, const google::crypto::tink::Keyset::Key*>
+        previous_keys;
+    std::unordered_set<uint32_t> ambiguous_ids;
+    for (const google::crypto::tink::Keyset::Key& key : previous_keyset.key()) {
+      if (!previous_keys.emplace(key.key_id(), &key).second) {
+        ambiguous_ids.insert(key.key_id());
+      }
+    }
+    std::unordered_map<uint32_t,
+                       const typename PrimitiveSet<P>::template Entry<P>*>
+        previous_entries;
+    for (const auto* entry : previous_primitives.get_all()) {
+      if (!previous_entries.emplace(entry->get_key_id(), entry).second) {
+        ambiguous_ids.insert(entry->get_key_id());
       }
     }
-    return transforming_wrapper_.Wrap(std::move(primitives));
+    typename PrimitiveSet<P>::Builder primitives_builder;
+    for (const google::crypto::tink::Keyset::Key& key : keyset.key()) {
+      if (key.status() != google::crypto::tink::KeyStatusType::ENABLED) {
+        continue;
+      }
+      const bool is_primary = key.key_id() == keyset.primary_key_id();
+      const typename PrimitiveSet<P>::template Entry<P>* reusable = nullptr;
+      if (ambiguous_ids.count(key.key_id()) == 0) {
+        auto previous_key = previous_keys.find(key.key_id());
+        auto previous_entry = previous_entries.find(key.key_id());
+        if (previous_key != previous_keys.end() &&
+            previous_entry != previous_entries.end() &&
+            previous_key->second->SerializeAsString() ==
+                key.SerializeAsString()) {
+          reusable = previous_entry->second;
+        }
+      }
+      // Wrap() builds the primary eagerly so that its construction errors
+      // surface here; if the primary moved onto a key whose previous entry
+      // never materialized, keep that invariant by building it afresh.
+      if (reusable != nullptr && is_primary &&
+          reusable->primitive_or_null() == nullptr) {
+        reusable = nullptr;
+      }
+      if (reusable != nullptr) {
+        if (is_primary) {
+          primitives_builder.AddPrimaryEntryFrom(*reusable,
+                                                 KeyInfoFromKey(key));
+        } else {
+          primitives_builder.AddEntryFrom(*reusable, KeyInfoFromKey(key));
+        }
+      } else if (is_primary) {
+        auto primitive = primitive_getter_(key.key_data());
+        if (!primitive.ok()) return primitive.status();
+        primitives_builder.AddPrimaryPrimitive(
+            std::move(primitive.ValueOrDie()), KeyInfoFromKey(key));
+      } else {
+        auto getter = primitive_getter_;
+        google::crypto::tink::KeyData key_data = key.key_data();
+        primitives_builder.AddLazyPrimitive(
+            [getter, key_data]() { return getter(key_data); },
+            KeyInfoFromKey(key));
+      }
+    }
+    auto primitives = std::move(primitives_builder).Build();
+    if (!primitives.ok()) return primitives.status();
+    return transforming_wrapper_.Wrap(std::move(primitives.ValueOrDie()));
   }
 
  private:
+  // Builds the primitive of the only enabled (RAW, primary) key and returns
+  // it without any wrapper. Instantiated only when P == Q; the overload
+  // below keeps Wrap() compilable for transforming wrappers, which never
+  // take the fast path.
+  crypto::tink::util::StatusOr<std::unique_ptr<Q>> WrapSingleRawKey(
+      const google::crypto::tink::Keyset::Key& key,
+      std::true_type /* same_type */) const {
+    auto primitive = primitive_getter_(key.key_data());
+    if (!primitive.ok()) return primitive.status();
+    return {std::move(primitive.ValueOrDie())};
+  }
+
+  crypto::tink::util::StatusOr<std::unique_ptr<Q>> WrapSingleRawKey(
+      const google::crypto::tink::Keyset::Key& key,
+      std::false_type /* same_type */) const {
+    return crypto::tink::util::Status(
+        crypto::tink::util::error::INTERNAL,
+        "Single-key fast path requires identical primitive types.");
+  }
+
   const std::function<crypto::tink::util::StatusOr<std::unique_ptr<P>>(
       const google::crypto::tink::KeyData& key_data)>
       primitive_getter_;
@@ -19,6 +19,8 @@
 #include "gtest/gtest.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/strings/match.h"
+#include "tink/internal/key_info.h"
+#include "tink/primitive_set.h"
 #include "tink/primitive_wrapper.h"
 #include "tink/util/test_matchers.h"
 #include "tink/util/test_util.h"
@@ -49,8 +51,12 @@ class Wrapper : public PrimitiveWrapper<InputPrimitive, OutputPrimitive> {
       const override {
     auto result = absl::make_unique<OutputPrimitive>();
     for (const auto* entry : primitive_set->get_all()) {
+      auto primitive_or = entry->primitive_or_status();
+      // Mirror the real wrappers: entries which fail to materialize are
+      // skipped.
+      if (!primitive_or.ok()) continue;
       (*result).push_back(
-          std::make_pair(entry->get_key_id(), entry->get_primitive()));
+          std::make_pair(entry->get_key_id(), *primitive_or.ValueOrDie()));
       if (entry->get_key_id() == primitive_set->get_primary()->get_key_id()) {
         result->back().second.append(" (primary)");
       }
@@ -59,6 +65,21 @@ class Wrapper : public PrimitiveWrapper<InputPrimitive, OutputPrimitive> {
   }
 };
 
+// A wrapper which only records the key ids, without ever touching the
+// primitives. Used to observe whether Wrap() materializes non-primary keys.
+class IdOnlyWrapper : public PrimitiveWrapper<InputPrimitive, std::vector<int>> {
+ public:
+  crypto::tink::util::StatusOr<std::unique_ptr<std::vector<int>>> Wrap(
+      std::unique_ptr<PrimitiveSet<InputPrimitive>> primitive_set)
+      const override {
+    auto result = absl::make_unique<std::vector<int>>();
+    for (const auto* entry : primitive_set->get_all()) {
+      result->push_back(entry->get_key_id());
+    }
+    return result;
+  }
+};
+
 crypto::tink::util::StatusOr<std::unique_ptr<InputPrimitive>> CreateIn(
     const google::crypto::tink::KeyData& key_data) {
   if (absl::StartsWith(key_data.type_url(), "error:")) {
@@ -105,7 +126,7 @@ TEST(KeysetWrapperImplTest, Basic) {
                                    Pair(333, "three")));
 }
 
-TEST(KeysetWrapperImplTest, FailingGetPrimitive) {
+TEST(KeysetWrapperImplTest, FailingGetPrimitiveForPrimary) {
   Wrapper wrapper;
   auto wrapper_or =
       absl::make_unique<KeysetWrapperImpl<InputPrimitive, OutputPrimitive>>(
@@ -113,15 +134,62 @@ TEST(KeysetWrapperImplTest, FailingGetPrimitive) {
   std::vector<std::pair<int, std::string>> keydata = {{1, "ok:one"},
                                                       {2, "error:two"}};
   google::crypto::tink::Keyset keyset = CreateKeyset(keydata);
-  keyset.set_primary_key_id(1);
+  keyset.set_primary_key_id(2);
 
   util::StatusOr<std::unique_ptr<OutputPrimitive>> wrapped =
       wrapper_or->Wrap(keyset);
 
+  // The primary is built eagerly, so its construction error fails Wrap().
   ASSERT_THAT(wrapped.status(), Not(IsOk()));
   ASSERT_THAT(wrapped.status().error_message(), HasSubstr("error:two"));
 }
 
+TEST(KeysetWrapperImplTest, FailingGetPrimitiveForNonPrimary) {
+  Wrapper wrapper;
+  auto wrapper_or =
+      absl::make_unique<KeysetWrapperImpl<InputPrimitive, OutputPrimitive>>(
+          &wrapper, &CreateIn);
+  std::vector<std::pair<int, std::string>> keydata = {{1, "ok:one"},
+                                                      {2, "error:two"}};
+  google::crypto::tink::Keyset keyset = CreateKeyset(keydata);
+  keyset.set_primary_key_id(1);
+
+  util::StatusOr<std::unique_ptr<OutputPrimitive>> wrapped =
+      wrapper_or->Wrap(keyset);
+
+  // Non-primary keys are materialized lazily, so their construction errors
+  // surface at the point of use: here the wrapper skips the broken entry.
+  ASSERT_THAT(wrapped.status(), IsOk());
+  ASSERT_THAT(*wrapped.ValueOrDie(),
+              UnorderedElementsAre(Pair(1, "ok:one (primary)")));
+}
+
+TEST(KeysetWrapperImplTest, NonPrimaryKeysAreNotBuiltDuringWrap) {
+  IdOnlyWrapper wrapper;
+  int getter_calls = 0;
+  auto counting_getter =
+      [&getter_calls](const google::crypto::tink::KeyData& key_data)
+      -> crypto::tink::util::StatusOr<std::unique_ptr<InputPrimitive>> {
+    getter_calls++;
+    return CreateIn(key_data);
+  };
+  auto wrapper_impl =
+      absl::make_unique<KeysetWrapperImpl<InputPrimitive, std::vector<int>>>(
+          &wrapper, counting_getter);
+  std::vector<std::pair<int, std::string>> keydata = {
+      {111, "one"}, {222, "two"}, {333, "three"}};
+  google::crypto::tink::Keyset keyset = CreateKeyset(keydata);
+  keyset.set_primary_key_id(222);
+
+  util::StatusOr<std::unique_ptr<std::vector<int>>> wrapped =
+      wrapper_impl->Wrap(keyset);
+
+  ASSERT_THAT(wrapped.status(), IsOk());
+  EXPECT_THAT(*wrapped.ValueOrDie(), UnorderedElementsAre(111, 222, 333));
+  // Only the primary was materialized.
+  EXPECT_EQ(getter_calls, 1);
+}
+
 // This test checks that validate keyset is called. We simply pass an empty
 // keyset.
 TEST(KeysetWrapperImplTest, ValidatesKeyset) {
@@ -156,6 +224,161 @@ TEST(KeysetWrapperImplTest, OnlyEnabled) {
                                    Pair(444, "four")));
 }
 
+// A wrapper which does not change the primitive type; it marks the result so
+// tests can tell whether the wrapper was invoked.
+class SameTypeWrapper : public PrimitiveWrapper<InputPrimitive, InputPrimitive> {
+ public:
+  crypto::tink::util::StatusOr<std::unique_ptr<InputPrimitive>> Wrap(
+      std::unique_ptr<PrimitiveSet<InputPrimitive>> primitive_set)
+      const override {
+    auto primary_or = primitive_set->get_primary()->primitive_or_status();
+    if (!primary_or.ok()) return primary_or.status();
+    return absl::make_unique<InputPrimitive>("wrapped:" +
+                                             *primary_or.ValueOrDie());
+  }
+};
+
+TEST(KeysetWrapperImplTest, SingleRawKeyBypassesWrapper) {
+  SameTypeWrapper wrapper;
+  auto wrapper_impl =
+      absl::make_unique<KeysetWrapperImpl<InputPrimitive, InputPrimitive>>(
+          &wrapper, &CreateIn);
+  google::crypto::tink::Keyset keyset;
+  AddKeyData(OnlyTypeUrlKeyData("one"), 111,
+             google::crypto::tink::OutputPrefixType::RAW,
+             google::crypto::tink::KeyStatusType::ENABLED, &keyset);
+  // Disabled keys do not keep the keyset off the fast path.
+  AddKeyData(OnlyTypeUrlKeyData("two"), 222,
+             google::crypto::tink::OutputPrefixType::RAW,
+             google::crypto::tink::KeyStatusType::DISABLED, &keyset);
+  keyset.set_primary_key_id(111);
+
+  util::StatusOr<std::unique_ptr<InputPrimitive>> wrapped =
+      wrapper_impl->Wrap(keyset);
+
+  ASSERT_THAT(wrapped.status(), IsOk());
+  // The inner primitive is handed out directly; the wrapper never ran.
+  EXPECT_EQ(*wrapped.ValueOrDie(), "one");
+}
+
+TEST(KeysetWrapperImplTest, SingleNonRawKeyUsesWrapper) {
+  SameTypeWrapper wrapper;
+  auto wrapper_impl =
+      absl::make_unique<KeysetWrapperImpl<InputPrimitive, InputPrimitive>>(
+          &wrapper, &CreateIn);
+  google::crypto::tink::Keyset keyset;
+  AddKeyData(OnlyTypeUrlKeyData("one"), 111,
+             google::crypto::tink::OutputPrefixType::TINK,
+             google::crypto::tink::KeyStatusType::ENABLED, &keyset);
+  keyset.set_primary_key_id(111);
+
+  util::StatusOr<std::unique_ptr<InputPrimitive>> wrapped =
+      wrapper_impl->Wrap(keyset);
+
+  ASSERT_THAT(wrapped.status(), IsOk());
+  EXPECT_EQ(*wrapped.ValueOrDie(), "wrapped:one");
+}
+
+TEST(KeysetWrapperImplTest, IncrementalWrapReusesUnchangedKeys) {
+  Wrapper wrapper;
+  int getter_calls = 0;
+  auto counting_getter =
+      [&getter_calls](const google::crypto::tink::KeyData& key_data)
+      -> crypto::tink::util::StatusOr<std::unique_ptr<InputPrimitive>> {
+    getter_calls++;
+    return CreateIn(key_data);
+  };
+  auto wrapper_impl =
+      absl::make_unique<KeysetWrapperImpl<InputPrimitive, OutputPrimitive>>(
+          &wrapper, counting_getter);
+  google::crypto::tink::Keyset previous_keyset =
+      CreateKeyset({{111, "one"}, {222, "two"}, {333, "three"}});
+  previous_keyset.set_primary_key_id(222);
+
+  // The set built when 'previous_keyset' was wrapped; all entries
+  // materialized.
+  PrimitiveSet<InputPrimitive>::Builder previous_builder;
+  previous_builder.AddPrimitive(absl::make_unique<InputPrimitive>("one"),
+                                KeyInfoFromKey(previous_keyset.key(0)));
+  previous_builder.AddPrimaryPrimitive(absl::make_unique<InputPrimitive>("two"),
+                                       KeyInfoFromKey(previous_keyset.key(1)));
+  previous_builder.AddPrimitive(absl::make_unique<InputPrimitive>("three"),
+                                KeyInfoFromKey(previous_keyset.key(2)));
+  auto previous_set = std::move(previous_builder).Build();
+  ASSERT_THAT(previous_set.status(), IsOk());
+
+  // One rotation step: key 111 removed, key 444 added, the rest unchanged.
+  google::crypto::tink::Keyset keyset = previous_keyset;
+  keyset.mutable_key()->erase(keyset.mutable_key()->begin());
+  AddKeyData(OnlyTypeUrlKeyData("four"), 444,
+             google::crypto::tink::OutputPrefixType::TINK,
+             google::crypto::tink::KeyStatusType::ENABLED, &keyset);
+
+  util::StatusOr<std::unique_ptr<OutputPrimitive>> wrapped =
+      wrapper_impl->WrapIncremental(keyset, previous_keyset,
+                                    *previous_set.ValueOrDie());
+
+  ASSERT_THAT(wrapped.status(), IsOk());
+  ASSERT_THAT(*wrapped.ValueOrDie(),
+              UnorderedElementsAre(Pair(222, "two (primary)"),
+                                   Pair(333, "three"), Pair(444, "four")));
+  // Unchanged keys share the previous primitives: only the added key was
+  // built (lazily, when the wrapper touched it).
+  EXPECT_EQ(getter_calls, 1);
+}
+
+TEST(KeysetWrapperImplTest, IncrementalWrapRebuildsChangedKeys) {
+  Wrapper wrapper;
+  auto wrapper_impl =
+      absl::make_unique<KeysetWrapperImpl<InputPrimitive, OutputPrimitive>>(
+          &wrapper, &CreateIn);
+  google::crypto::tink::Keyset previous_keyset =
+      CreateKeyset({{111, "one"}, {222, "two"}});
+  previous_keyset.set_primary_key_id(222);
+
+  PrimitiveSet<InputPrimitive>::Builder previous_builder;
+  previous_builder.AddPrimitive(absl::make_unique<InputPrimitive>("one"),
+                                KeyInfoFromKey(previous_keyset.key(0)));
+  previous_builder.AddPrimaryPrimitive(absl::make_unique<InputPrimitive>("two"),
+                                       KeyInfoFromKey(previous_keyset.key(1)));
+  auto previous_set = std::move(previous_builder).Build();
+  ASSERT_THAT(previous_set.status(), IsOk());
+
+  // Key 111 changes its key material; the primitive may not be reused.
+  google::crypto::tink::Keyset keyset = previous_keyset;
+  *keyset.mutable_key(0)->mutable_key_data() = OnlyTypeUrlKeyData("un");
+
+  util::StatusOr<std::unique_ptr<OutputPrimitive>> wrapped =
+      wrapper_impl->WrapIncremental(keyset, previous_keyset,
+                                    *previous_set.ValueOrDie());
+
+  ASSERT_THAT(wrapped.status(), IsOk());
+  ASSERT_THAT(*wrapped.ValueOrDie(),
+              UnorderedElementsAre(Pair(111, "un"),
+                                   Pair(222, "two (primary)")));
+}
+
+TEST(KeysetWrapperImplTest, MultipleRawKeysUseWrapper) {
+  SameTypeWrapper wrapper;
+  auto wrapper_impl =
+      absl::make_unique<KeysetWrapperImpl<InputPrimitive, InputPrimitive>>(
+          &wrapper, &CreateIn);
+  google::crypto::tink::Keyset keyset;
+  AddKeyData(OnlyTypeUrlKeyData("one"), 111,
+             google::crypto::tink::OutputPrefixType::RAW,
+             google::crypto::tink::KeyStatusType::ENABLED, &keyset);
+  AddKeyData(OnlyTypeUrlKeyData("two"), 222,
+             google::crypto::tink::OutputPrefixType::RAW,
+             google::crypto::tink::KeyStatusType::ENABLED, &keyset);
+  keyset.set_primary_key_id(111);
+
+  util::StatusOr<std::unique_ptr<InputPrimitive>> wrapped =
+      wrapper_impl->Wrap(keyset);
+
+  ASSERT_THAT(wrapped.status(), IsOk());
+  EXPECT_EQ(*wrapped.ValueOrDie(), "wrapped:one");
+}
+
 }  // namespace
 
 }  // namespace tink
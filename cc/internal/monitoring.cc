@@ -0,0 +1,130 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/internal/monitoring.h"
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+
+namespace crypto {
+namespace tink {
+namespace internal {
+
+namespace {
+
+using StatsKey = std::pair<std::string, uint32_t>;  // (api, key_id)
+using StatsMap = std::map<StatsKey, MonitoringStats>;
+
+absl::Mutex* GlobalStatsMutex() {
+  static absl::Mutex* mutex = new absl::Mutex();
+  return mutex;
+}
+
+StatsMap* GlobalStats() {
+  static StatsMap* stats = new StatsMap();
+  return stats;
+}
+
+void MergeStats(const MonitoringStats& source, MonitoringStats* target) {
+  target->op_count += source.op_count;
+  target->error_count += source.error_count;
+  for (int i = 0; i < kMonitoringLatencyBucketCount; i++) {
+    target->latency_buckets[i] += source.latency_buckets[i];
+  }
+}
+
+int LatencyBucket(uint64_t latency_ns) {
+  int bucket = 0;
+  while (latency_ns > 1 && bucket < kMonitoringLatencyBucketCount - 1) {
+    latency_ns >>= 1;
+    bucket++;
+  }
+  return bucket;
+}
+
+// Per-thread aggregates. Only the owning thread touches the map; it is
+// merged into the global table under the global mutex every
+// kMonitoringFlushOpCount operations and from the destructor when the
+// thread exits.
+class ThreadStats {
+ public:
+  void Record(absl::string_view api, uint32_t key_id, uint64_t latency_ns,
+              bool ok) {
+    MonitoringStats& stats =
+        stats_[StatsKey(std::string(api), key_id)];
+    stats.op_count++;
+    if (!ok) stats.error_count++;
+    stats.latency_buckets[LatencyBucket(latency_ns)]++;
+    if (++ops_since_flush_ >= kMonitoringFlushOpCount) Flush();
+  }
+
+  void Flush() {
+    ops_since_flush_ = 0;
+    if (stats_.empty()) return;
+    absl::MutexLock lock(GlobalStatsMutex());
+    StatsMap* global_stats = GlobalStats();
+    for (const auto& entry : stats_) {
+      MergeStats(entry.second, &(*global_stats)[entry.first]);
+    }
+    stats_.clear();
+  }
+
+  ~ThreadStats() { Flush(); }
+
+ private:
+  StatsMap stats_;
+  int ops_since_flush_ = 0;
+};
+
+ThreadStats& GetThreadStats() {
+  thread_local ThreadStats stats;
+  return stats;
+}
+
+}  // namespace
+
+void RecordMonitoredOp(absl::string_view api, uint32_t key_id,
+                       uint64_t latency_ns, bool ok) {
+  GetThreadStats().Record(api, key_id, latency_ns, ok);
+}
+
+void FlushMonitoringStats() { GetThreadStats().Flush(); }
+
+std::vector<MonitoringEntry> DrainMonitoringStats() {
+  StatsMap drained;
+  {
+    absl::MutexLock lock(GlobalStatsMutex());
+    drained.swap(*GlobalStats());
+  }
+  std::vector<MonitoringEntry> result;
+  result.reserve(drained.size());
+  for (auto& entry : drained) {
+    MonitoringEntry monitoring_entry;
+    monitoring_entry.api = entry.first.first;
+    monitoring_entry.key_id = entry.first.second;
+    monitoring_entry.stats = entry.second;
+    result.push_back(std::move(monitoring_entry));
+  }
+  return result;
+}
+
+}  // namespace internal
+}  // namespace tink
+}  // namespace crypto
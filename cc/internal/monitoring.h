@@ -0,0 +1,126 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_INTERNAL_MONITORING_H_
+#define TINK_INTERNAL_MONITORING_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+
+namespace crypto {
+namespace tink {
+namespace internal {
+
+// Lightweight monitoring of primitive operations at the wrapper layer.
+//
+// Operations are recorded into thread-local aggregates (per-API and
+// per-key-id operation counters, error counters and a latency histogram),
+// so the hot path takes no locks and performs no allocations after the
+// first operation of a given key on a thread. A thread's aggregates are
+// merged into a global table every kMonitoringFlushOpCount operations and
+// at thread exit; a metrics exporter drains the global table periodically
+// via DrainMonitoringStats().
+//
+// The call sites in the wrappers are active only if TINK_ENABLE_MONITORING
+// is defined at compile time; otherwise MonitoredOp compiles to nothing
+// and the wrappers behave exactly as before.
+#ifdef TINK_ENABLE_MONITORING
+constexpr bool kMonitoringEnabled = true;
+#else
+constexpr bool kMonitoringEnabled = false;
+#endif
+
+// How many operations a thread records locally before merging its
+// aggregates into the global table.
+constexpr int kMonitoringFlushOpCount = 1024;
+
+// Bucket i of the latency histogram counts operations that took
+// [2^i, 2^(i+1)) nanoseconds; the last bucket is unbounded.
+constexpr int kMonitoringLatencyBucketCount = 32;
+
+// Aggregated statistics of one (api, key_id) pair.
+struct MonitoringStats {
+  uint64_t op_count = 0;
+  uint64_t error_count = 0;
+  uint64_t latency_buckets[kMonitoringLatencyBucketCount] = {};
+};
+
+// One drained entry of the global table.
+struct MonitoringEntry {
+  std::string api;
+  uint32_t key_id;
+  MonitoringStats stats;
+};
+
+// Records one finished operation into the calling thread's aggregates.
+// 'api' identifies the operation (e.g. "aead.encrypt") and must point to
+// a string with static storage duration.
+void RecordMonitoredOp(absl::string_view api, uint32_t key_id,
+                       uint64_t latency_ns, bool ok);
+
+// Merges the calling thread's aggregates into the global table now,
+// regardless of how many operations it has recorded since the last merge.
+void FlushMonitoringStats();
+
+// Returns the contents of the global table and resets it. Operations that
+// other threads have recorded but not yet flushed are not included.
+std::vector<MonitoringEntry> DrainMonitoringStats();
+
+// RAII helper for the wrapper call sites: measures the latency of the
+// enclosing operation and records it on destruction. When monitoring is
+// disabled at compile time all members collapse to no-ops and the
+// optimizer removes the helper entirely.
+class MonitoredOp {
+ public:
+  MonitoredOp(absl::string_view api, uint32_t key_id)
+      : api_(api), key_id_(key_id) {
+    if (kMonitoringEnabled) {
+      start_ns_ = absl::GetCurrentTimeNanos();
+    }
+  }
+
+  // Sets the key id after the fact, e.g. once the matching key of a
+  // decryption or verification is known.
+  void set_key_id(uint32_t key_id) { key_id_ = key_id; }
+
+  void SetFailed() { failed_ = true; }
+
+  ~MonitoredOp() {
+    if (kMonitoringEnabled) {
+      RecordMonitoredOp(api_, key_id_,
+                        absl::GetCurrentTimeNanos() - start_ns_, !failed_);
+    }
+  }
+
+  MonitoredOp(const MonitoredOp&) = delete;
+  MonitoredOp& operator=(const MonitoredOp&) = delete;
+
+ private:
+  const absl::string_view api_;
+  uint32_t key_id_;
+  int64_t start_ns_ = 0;
+  bool failed_ = false;
+};
+
+}  // namespace internal
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_INTERNAL_MONITORING_H_
@@ -0,0 +1,153 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/internal/monitoring.h"
+
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace crypto {
+namespace tink {
+namespace internal {
+namespace {
+
+using ::testing::Eq;
+using ::testing::IsEmpty;
+
+// The tests below exercise the unconditional recording API, so they pass
+// regardless of whether TINK_ENABLE_MONITORING is defined.
+
+TEST(MonitoringTest, RecordedOpsAreDrained) {
+  DrainMonitoringStats();  // Discard stats of earlier tests.
+
+  RecordMonitoredOp("aead.encrypt", /* key_id = */ 42,
+                    /* latency_ns = */ 100, /* ok = */ true);
+  RecordMonitoredOp("aead.encrypt", /* key_id = */ 42,
+                    /* latency_ns = */ 200, /* ok = */ false);
+  FlushMonitoringStats();
+
+  auto entries = DrainMonitoringStats();
+  ASSERT_THAT(entries.size(), Eq(1));
+  EXPECT_THAT(entries[0].api, Eq("aead.encrypt"));
+  EXPECT_THAT(entries[0].key_id, Eq(42));
+  EXPECT_THAT(entries[0].stats.op_count, Eq(2));
+  EXPECT_THAT(entries[0].stats.error_count, Eq(1));
+}
+
+TEST(MonitoringTest, SeparateEntriesPerApiAndKeyId) {
+  DrainMonitoringStats();
+
+  RecordMonitoredOp("aead.encrypt", 1, 100, true);
+  RecordMonitoredOp("aead.decrypt", 1, 100, true);
+  RecordMonitoredOp("aead.encrypt", 2, 100, true);
+  FlushMonitoringStats();
+
+  EXPECT_THAT(DrainMonitoringStats().size(), Eq(3));
+}
+
+TEST(MonitoringTest, LatencyHistogramUsesPowerOfTwoBuckets) {
+  DrainMonitoringStats();
+
+  RecordMonitoredOp("mac.compute", 1, /* latency_ns = */ 1, true);
+  RecordMonitoredOp("mac.compute", 1, /* latency_ns = */ 1024, true);
+  RecordMonitoredOp("mac.compute", 1, /* latency_ns = */ 2047, true);
+  FlushMonitoringStats();
+
+  auto entries = DrainMonitoringStats();
+  ASSERT_THAT(entries.size(), Eq(1));
+  EXPECT_THAT(entries[0].stats.latency_buckets[0], Eq(1));
+  EXPECT_THAT(entries[0].stats.latency_buckets[10], Eq(2));
+}
+
+TEST(MonitoringTest, DrainResetsStats) {
+  DrainMonitoringStats();
+
+  RecordMonitoredOp("aead.encrypt", 1, 100, true);
+  FlushMonitoringStats();
+  EXPECT_THAT(DrainMonitoringStats().size(), Eq(1));
+  EXPECT_THAT(DrainMonitoringStats(), IsEmpty());
+}
+
+TEST(MonitoringTest, OpsAreFlushedAutomaticallyAfterFlushOpCount) {
+  DrainMonitoringStats();
+
+  for (int i = 0; i < kMonitoringFlushOpCount; i++) {
+    RecordMonitoredOp("aead.encrypt", 1, 100, true);
+  }
+  // No explicit flush: the kMonitoringFlushOpCount-th operation triggers one.
+  auto entries = DrainMonitoringStats();
+  ASSERT_THAT(entries.size(), Eq(1));
+  EXPECT_THAT(entries[0].stats.op_count, Eq(kMonitoringFlushOpCount));
+}
+
+TEST(MonitoringTest, ThreadStatsAreFlushedAtThreadExit) {
+  DrainMonitoringStats();
+
+  std::thread worker(
+      []() { RecordMonitoredOp("signature.sign", 17, 100, true); });
+  worker.join();
+
+  auto entries = DrainMonitoringStats();
+  ASSERT_THAT(entries.size(), Eq(1));
+  EXPECT_THAT(entries[0].api, Eq("signature.sign"));
+  EXPECT_THAT(entries[0].key_id, Eq(17));
+  EXPECT_THAT(entries[0].stats.op_count, Eq(1));
+}
+
+TEST(MonitoringTest, StatsOfMultipleThreadsAreMerged) {
+  DrainMonitoringStats();
+
+  std::vector<std::thread> workers;
+  for (int i = 0; i < 4; i++) {
+    workers.push_back(std::thread([]() {
+      for (int j = 0; j < 10; j++) {
+        RecordMonitoredOp("aead.encrypt", 1, 100, true);
+      }
+    }));
+  }
+  for (auto& worker : workers) worker.join();
+
+  auto entries = DrainMonitoringStats();
+  ASSERT_THAT(entries.size(), Eq(1));
+  EXPECT_THAT(entries[0].stats.op_count, Eq(40));
+}
+
+TEST(MonitoringTest, MonitoredOpRecordsOnlyIfEnabled) {
+  DrainMonitoringStats();
+
+  {
+    MonitoredOp op("aead.encrypt", 1);
+    op.SetFailed();
+  }
+  FlushMonitoringStats();
+
+  auto entries = DrainMonitoringStats();
+  if (kMonitoringEnabled) {
+    ASSERT_THAT(entries.size(), Eq(1));
+    EXPECT_THAT(entries[0].stats.op_count, Eq(1));
+    EXPECT_THAT(entries[0].stats.error_count, Eq(1));
+  } else {
+    EXPECT_THAT(entries, IsEmpty());
+  }
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace tink
+}  // namespace crypto
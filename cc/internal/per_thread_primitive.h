@@ -0,0 +1,82 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_INTERNAL_PER_THREAD_PRIMITIVE_H_
+#define TINK_INTERNAL_PER_THREAD_PRIMITIVE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+
+#include "tink/keyset_handle.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace internal {
+
+// Maintains one replica of a wrapped primitive per calling thread, all
+// built from the same keyset. Each thread only ever touches its own
+// replica, so threads share no cache lines through the primitive (neither
+// ownership/refcount words nor any mutable state a primitive holds behind
+// locks).
+//
+// Replicas are built lazily on a thread's first Get() and live until the
+// thread exits. A destroyed PerThreadPrimitive leaves its (inert) replicas
+// behind until then; that memory is bounded by replica size times thread
+// count, which is the deliberate trade for a shared-nothing fast path.
+template <class P>
+class PerThreadPrimitive {
+ public:
+  // The keyset handle is shared by all replicas and must only be used via
+  // const methods, which are thread-safe.
+  explicit PerThreadPrimitive(std::unique_ptr<const KeysetHandle> keyset_handle)
+      : keyset_handle_(std::move(keyset_handle)),
+        instance_id_(NextInstanceId()) {}
+
+  // Returns the calling thread's replica, building it on first use.
+  // The returned pointer stays valid for the lifetime of the thread.
+  crypto::tink::util::StatusOr<P*> Get() const {
+    // Keyed by a unique instance id rather than by 'this': a new instance
+    // reusing a freed instance's address must not see its replicas.
+    thread_local static std::unordered_map<std::uint64_t, std::unique_ptr<P>>
+        replicas;
+    auto it = replicas.find(instance_id_);
+    if (it != replicas.end()) return it->second.get();
+    auto primitive_result = keyset_handle_->template GetPrimitive<P>();
+    if (!primitive_result.ok()) return primitive_result.status();
+    P* replica = primitive_result.ValueOrDie().get();
+    replicas[instance_id_] = std::move(primitive_result.ValueOrDie());
+    return replica;
+  }
+
+ private:
+  static std::uint64_t NextInstanceId() {
+    static std::atomic<std::uint64_t> counter{0};
+    return counter.fetch_add(1);
+  }
+
+  const std::unique_ptr<const KeysetHandle> keyset_handle_;
+  const std::uint64_t instance_id_;
+};
+
+}  // namespace internal
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_INTERNAL_PER_THREAD_PRIMITIVE_H_
@@ -0,0 +1,219 @@
+// Copyright 2021 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/internal/profiling.h"
+
+#include <cstring>
+
+#ifndef _WIN32
+#include <signal.h>
+#include <unistd.h>
+#endif
+
+namespace crypto {
+namespace tink {
+namespace internal {
+
+const char* const kProfilingOpNames[kNumProfilingOps] = {
+    "aead.encrypt",
+    "aead.decrypt",
+    "signature.sign",
+};
+
+constexpr size_t ProfilingThreadLog::kRingBufferSize;
+constexpr int ProfilingThreadLog::kCycleBucketCount;
+
+namespace {
+
+// The head of the append-only list of all thread logs ever created. Logs
+// are never freed, so readers can traverse the list without
+// synchronization; logs of exited threads are recycled via 'in_use'.
+std::atomic<ProfilingThreadLog*> log_list_head{nullptr};
+
+ProfilingThreadLog* AcquireLog() {
+  // Prefer recycling the log of an exited thread.
+  for (ProfilingThreadLog* log = log_list_head.load(std::memory_order_acquire);
+       log != nullptr; log = log->next.load(std::memory_order_acquire)) {
+    bool expected = false;
+    if (log->in_use.compare_exchange_strong(expected, true,
+                                            std::memory_order_acq_rel)) {
+      return log;
+    }
+  }
+  ProfilingThreadLog* log = new ProfilingThreadLog();
+  log->in_use.store(true, std::memory_order_relaxed);
+  ProfilingThreadLog* head = log_list_head.load(std::memory_order_relaxed);
+  do {
+    log->next.store(head, std::memory_order_relaxed);
+  } while (!log_list_head.compare_exchange_weak(head, log,
+                                                std::memory_order_acq_rel));
+  return log;
+}
+
+// Reserves a log for the lifetime of the thread and recycles it on exit.
+// The counters are intentionally not reset: the histograms accumulate
+// across thread generations, and the dump aggregates over all logs anyway.
+struct LogReservation {
+  LogReservation() : log(AcquireLog()) {}
+  ~LogReservation() { log->in_use.store(false, std::memory_order_release); }
+  ProfilingThreadLog* log;
+};
+
+int CycleBucket(uint64_t cycles) {
+#if defined(__GNUC__) || defined(__clang__)
+  return cycles == 0 ? 0 : 63 - __builtin_clzll(cycles);
+#else
+  int bucket = 0;
+  while (cycles > 1 && bucket < ProfilingThreadLog::kCycleBucketCount - 1) {
+    cycles >>= 1;
+    bucket++;
+  }
+  return bucket;
+#endif
+}
+
+#ifndef _WIN32
+
+// Appends the decimal representation of 'value' to 'buf' at 'pos',
+// which must have room for 20 digits. Async-signal-safe.
+void AppendDecimal(char* buf, size_t* pos, uint64_t value) {
+  char digits[20];
+  int n = 0;
+  do {
+    digits[n++] = '0' + static_cast<char>(value % 10);
+    value /= 10;
+  } while (value > 0);
+  while (n > 0) buf[(*pos)++] = digits[--n];
+}
+
+void AppendString(char* buf, size_t* pos, const char* s) {
+  size_t len = strlen(s);
+  memcpy(buf + *pos, s, len);
+  *pos += len;
+}
+
+void WriteAll(int fd, const char* buf, size_t count) {
+  size_t written = 0;
+  while (written < count) {
+    ssize_t result = write(fd, buf + written, count - written);
+    if (result <= 0) return;
+    written += static_cast<size_t>(result);
+  }
+}
+
+void ProfilingSignalHandler(int /* signum */) {
+  DumpProfilingLogs(STDERR_FILENO);
+}
+
+#endif  // !_WIN32
+
+}  // namespace
+
+ProfilingThreadLog* ProfilingLogForCurrentThread() {
+  thread_local static LogReservation reservation;
+  return reservation.log;
+}
+
+ProfilingThreadLog* ProfilingLogListHead() {
+  return log_list_head.load(std::memory_order_acquire);
+}
+
+ProfilingScope::~ProfilingScope() {
+  uint64_t cycles = ProfilingCycleCounter() - start_;
+  uint64_t index = log_->next_entry.load(std::memory_order_relaxed);
+  ProfilingThreadLog::Entry& entry =
+      log_->entries[index % ProfilingThreadLog::kRingBufferSize];
+  entry.op.store(static_cast<uint8_t>(op_), std::memory_order_relaxed);
+  entry.cycles.store(cycles, std::memory_order_relaxed);
+  log_->next_entry.store(index + 1, std::memory_order_relaxed);
+  log_->histogram[op_][CycleBucket(cycles)].fetch_add(
+      1, std::memory_order_relaxed);
+}
+
+#ifndef _WIN32
+
+void DumpProfilingLogs(int fd) {
+  // Aggregate over all thread logs, including recycled ones.
+  uint64_t histogram[kNumProfilingOps][ProfilingThreadLog::kCycleBucketCount] =
+      {};
+  for (ProfilingThreadLog* log = ProfilingLogListHead(); log != nullptr;
+       log = log->next.load(std::memory_order_acquire)) {
+    for (int op = 0; op < kNumProfilingOps; op++) {
+      for (int bucket = 0; bucket < ProfilingThreadLog::kCycleBucketCount;
+           bucket++) {
+        histogram[op][bucket] +=
+            log->histogram[op][bucket].load(std::memory_order_relaxed);
+      }
+    }
+  }
+  // One line per non-empty bucket: "<op> 2^<bucket> cycles: <count>\n".
+  char buf[128];
+  size_t pos = 0;
+  AppendString(buf, &pos, "=== Tink profiling dump (cycles) ===\n");
+  WriteAll(fd, buf, pos);
+  for (int op = 0; op < kNumProfilingOps; op++) {
+    uint64_t total = 0;
+    for (int bucket = 0; bucket < ProfilingThreadLog::kCycleBucketCount;
+         bucket++) {
+      total += histogram[op][bucket];
+    }
+    pos = 0;
+    AppendString(buf, &pos, kProfilingOpNames[op]);
+    AppendString(buf, &pos, ": count=");
+    AppendDecimal(buf, &pos, total);
+    buf[pos++] = '\n';
+    WriteAll(fd, buf, pos);
+    if (total == 0) continue;
+    for (int bucket = 0; bucket < ProfilingThreadLog::kCycleBucketCount;
+         bucket++) {
+      if (histogram[op][bucket] == 0) continue;
+      pos = 0;
+      AppendString(buf, &pos, "  2^");
+      AppendDecimal(buf, &pos, static_cast<uint64_t>(bucket));
+      AppendString(buf, &pos, " cycles: ");
+      AppendDecimal(buf, &pos, histogram[op][bucket]);
+      buf[pos++] = '\n';
+      WriteAll(fd, buf, pos);
+    }
+  }
+}
+
+util::Status InstallProfilingSignalHandler(int signum) {
+  struct sigaction action;
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = ProfilingSignalHandler;
+  sigemptyset(&action.sa_mask);
+  if (sigaction(signum, &action, nullptr) != 0) {
+    return util::Status(util::error::INTERNAL,
+                        "Could not install the profiling signal handler.");
+  }
+  return util::Status::OK;
+}
+
+#else  // _WIN32
+
+void DumpProfilingLogs(int /* fd */) {}
+
+util::Status InstallProfilingSignalHandler(int /* signum */) {
+  return util::Status(util::error::UNIMPLEMENTED,
+                      "Profiling signal handler is not supported on Windows.");
+}
+
+#endif  // !_WIN32
+
+}  // namespace internal
+}  // namespace tink
+}  // namespace crypto
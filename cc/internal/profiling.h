@@ -0,0 +1,147 @@
+// Copyright 2021 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_INTERNAL_PROFILING_H_
+#define TINK_INTERNAL_PROFILING_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "tink/util/status.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace crypto {
+namespace tink {
+namespace internal {
+
+// A cycle-accurate hot-path profiler for chasing tail latency at the
+// wrapper layer, complementing monitoring.h: monitoring aggregates
+// wall-clock latencies for a metrics exporter, while this profiler records
+// raw cycle counts of recent operations into per-thread ring buffers,
+// dumpable on a signal while the process is under load.
+//
+// The call sites compile to nothing unless TINK_PROFILING is defined
+// (--define tink_profiling=1 with Bazel, -DTINK_PROFILING=ON with CMake).
+// When enabled, each wrapped operation costs two cycle-counter reads and a
+// handful of relaxed stores into thread-local memory -- well under 1% of
+// the cost of a crypto operation.
+
+// The profiled operations. Each has its own histogram; the ring buffer
+// tags every sample with its operation.
+enum ProfilingOp {
+  kProfileOpAeadEncrypt = 0,
+  kProfileOpAeadDecrypt,
+  kProfileOpPublicKeySign,
+  kNumProfilingOps,  // must be last
+};
+
+// The dump names of the operations, indexed by ProfilingOp.
+extern const char* const kProfilingOpNames[kNumProfilingOps];
+
+// The per-thread profiling state. All counters are relaxed atomics so that
+// a signal handler (possibly on another thread) can read them while the
+// owning thread keeps recording; the dump is a racy snapshot by design.
+struct ProfilingThreadLog {
+  static constexpr size_t kRingBufferSize = 4096;
+  static constexpr int kCycleBucketCount = 64;
+
+  struct Entry {
+    std::atomic<uint8_t> op{0};
+    std::atomic<uint64_t> cycles{0};
+  };
+
+  // The most recent samples, for inspection from a debugger or core dump.
+  Entry entries[kRingBufferSize];
+  std::atomic<uint64_t> next_entry{0};
+
+  // Bucket i counts operations that took [2^i, 2^(i+1)) cycles.
+  std::atomic<uint64_t> histogram[kNumProfilingOps][kCycleBucketCount] = {};
+
+  // Slot recycling, as in epoch_ptr.h: logs are never freed, a log whose
+  // thread has exited is handed to the next new thread.
+  std::atomic<bool> in_use{false};
+  std::atomic<ProfilingThreadLog*> next{nullptr};
+};
+
+// Reads the CPU cycle counter (TSC on x86, the virtual counter on arm64,
+// a nanosecond clock elsewhere).
+inline uint64_t ProfilingCycleCounter() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#elif defined(__aarch64__)
+  uint64_t virtual_timer;
+  asm volatile("mrs %0, cntvct_el0" : "=r"(virtual_timer));
+  return virtual_timer;
+#else
+  return 0;  // profiling unsupported on this architecture
+#endif
+}
+
+// Returns the calling thread's log, creating and registering it on the
+// first call.
+ProfilingThreadLog* ProfilingLogForCurrentThread();
+
+// The head of the registered logs; for the dump routine and tests.
+ProfilingThreadLog* ProfilingLogListHead();
+
+// Writes the per-operation cycle histograms, aggregated over all thread
+// logs, to the file descriptor 'fd'. Async-signal-safe: formats into a
+// stack buffer and uses only write().
+void DumpProfilingLogs(int fd);
+
+// Installs a handler for 'signum' (typically SIGUSR2) that calls
+// DumpProfilingLogs(STDERR_FILENO).
+crypto::tink::util::Status InstallProfilingSignalHandler(int signum);
+
+// RAII helper for the wrapper call sites; use via TINK_PROFILE_SCOPE.
+class ProfilingScope {
+ public:
+  explicit ProfilingScope(ProfilingOp op)
+      : op_(op),
+        log_(ProfilingLogForCurrentThread()),
+        start_(ProfilingCycleCounter()) {}
+
+  ~ProfilingScope();
+
+  ProfilingScope(const ProfilingScope&) = delete;
+  ProfilingScope& operator=(const ProfilingScope&) = delete;
+
+ private:
+  const ProfilingOp op_;
+  ProfilingThreadLog* const log_;
+  const uint64_t start_;
+};
+
+}  // namespace internal
+}  // namespace tink
+}  // namespace crypto
+
+// Records the cycles spent in the enclosing scope under operation
+// 'op' (e.g. TINK_PROFILE_SCOPE(AeadEncrypt)). Expands to nothing unless
+// the profiling build mode is enabled.
+#ifdef TINK_PROFILING
+#define TINK_PROFILE_SCOPE(op)                           \
+  ::crypto::tink::internal::ProfilingScope tink_profile_scope( \
+      ::crypto::tink::internal::kProfileOp##op)
+#else
+#define TINK_PROFILE_SCOPE(op)
+#endif
+
+#endif  // TINK_INTERNAL_PROFILING_H_
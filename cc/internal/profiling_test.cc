@@ -0,0 +1,106 @@
+// Copyright 2021 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/internal/profiling.h"
+
+#include <csignal>
+#include <string>
+#include <thread>
+
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+
+namespace crypto {
+namespace tink {
+namespace internal {
+namespace {
+
+uint64_t HistogramTotal(const ProfilingThreadLog* log, ProfilingOp op) {
+  uint64_t total = 0;
+  for (int bucket = 0; bucket < ProfilingThreadLog::kCycleBucketCount;
+       bucket++) {
+    total += log->histogram[op][bucket].load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+TEST(ProfilingTest, ScopeRecordsIntoThreadLog) {
+  ProfilingThreadLog* log = ProfilingLogForCurrentThread();
+  ASSERT_NE(nullptr, log);
+  EXPECT_EQ(log, ProfilingLogForCurrentThread());
+
+  uint64_t encrypt_count_before = HistogramTotal(log, kProfileOpAeadEncrypt);
+  uint64_t entry_index = log->next_entry.load(std::memory_order_relaxed);
+  { ProfilingScope scope(kProfileOpAeadEncrypt); }
+  EXPECT_EQ(encrypt_count_before + 1,
+            HistogramTotal(log, kProfileOpAeadEncrypt));
+  EXPECT_EQ(entry_index + 1, log->next_entry.load(std::memory_order_relaxed));
+  const ProfilingThreadLog::Entry& entry =
+      log->entries[entry_index % ProfilingThreadLog::kRingBufferSize];
+  EXPECT_EQ(kProfileOpAeadEncrypt,
+            entry.op.load(std::memory_order_relaxed));
+}
+
+TEST(ProfilingTest, LogOfExitedThreadIsRecycled) {
+  ProfilingThreadLog* first_log = nullptr;
+  std::thread t1([&first_log]() {
+    first_log = ProfilingLogForCurrentThread();
+    ProfilingScope scope(kProfileOpPublicKeySign);
+  });
+  t1.join();
+  ASSERT_NE(nullptr, first_log);
+  EXPECT_FALSE(first_log->in_use.load(std::memory_order_acquire));
+
+  ProfilingThreadLog* second_log = nullptr;
+  std::thread t2(
+      [&second_log]() { second_log = ProfilingLogForCurrentThread(); });
+  t2.join();
+  EXPECT_EQ(first_log, second_log);
+}
+
+TEST(ProfilingTest, DumpContainsOperationNames) {
+  // Record at least one operation so the dump is non-trivial.
+  { ProfilingScope scope(kProfileOpAeadDecrypt); }
+
+  int fds[2];
+  ASSERT_EQ(0, pipe(fds));
+  DumpProfilingLogs(fds[1]);
+  close(fds[1]);
+  std::string dump;
+  char buf[4096];
+  ssize_t n;
+  while ((n = read(fds[0], buf, sizeof(buf))) > 0) {
+    dump.append(buf, n);
+  }
+  close(fds[0]);
+
+  EXPECT_NE(std::string::npos, dump.find("Tink profiling dump"));
+  for (int op = 0; op < kNumProfilingOps; op++) {
+    EXPECT_NE(std::string::npos, dump.find(kProfilingOpNames[op]));
+  }
+  EXPECT_NE(std::string::npos, dump.find("aead.decrypt: count="));
+}
+
+TEST(ProfilingTest, InstallSignalHandler) {
+  auto status = InstallProfilingSignalHandler(SIGUSR2);
+  EXPECT_TRUE(status.ok()) << status;
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace tink
+}  // namespace crypto
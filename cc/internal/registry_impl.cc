@@ -15,6 +15,7 @@
 ///////////////////////////////////////////////////////////////////////////////
 #include "tink/internal/registry_impl.h"
 
+#include "tink/internal/registry_metrics.h"
 #include "tink/util/errors.h"
 #include "tink/util/statusor.h"
 #include "proto/tink.pb.h"
@@ -29,13 +30,99 @@ namespace internal {
 
 StatusOr<const RegistryImpl::KeyTypeInfo*> RegistryImpl::get_key_type_info(
     absl::string_view type_url) const {
-  absl::MutexLock lock(&maps_mutex_);
-  auto it = type_url_to_info_.find(type_url);
-  if (it == type_url_to_info_.end()) {
+  const LookupSnapshot* snapshot = GetLookupSnapshot();
+  if (snapshot != nullptr) {
+    auto it = snapshot->type_url_to_info.find(type_url);
+    if (it != snapshot->type_url_to_info.end()) {
+      RegistryMetrics::Global().RecordLookup(/* found = */ true);
+      return it->second.info;
+    }
+  } else {
+    TimedMutexLock lock(&maps_mutex_);
+    auto it = type_url_to_info_.find(type_url);
+    if (it != type_url_to_info_.end()) {
+      RegistryMetrics::Global().RecordLookup(/* found = */ true);
+      return &it->second;
+    }
+  }
+  if (fallback_registry_ != nullptr) {
+    // The fallback registry records the lookup itself.
+    return fallback_registry_->get_key_type_info(type_url);
+  }
+  RegistryMetrics::Global().RecordLookup(/* found = */ false);
+  return ToStatusF(util::error::NOT_FOUND,
+                   "No manager for type '%s' has been registered.", type_url);
+}
+
+const RegistryImpl::LookupSnapshot* RegistryImpl::GetLookupSnapshot() const {
+  const LookupSnapshot* snapshot =
+      lookup_snapshot_.load(std::memory_order_acquire);
+  if (snapshot != nullptr ||
+      !snapshot_stale_.load(std::memory_order_acquire)) {
+    return snapshot;
+  }
+  TimedMutexLock lock(&maps_mutex_);
+  // Another thread may have rebuilt the snapshot while we waited.
+  snapshot = lookup_snapshot_.load(std::memory_order_acquire);
+  if (snapshot != nullptr) {
+    return snapshot;
+  }
+  RebuildLookupSnapshot();
+  return lookup_snapshot_.load(std::memory_order_acquire);
+}
+
+void RegistryImpl::RebuildLookupSnapshot() const {
+  auto snapshot = absl::make_unique<LookupSnapshot>();
+  snapshot->type_url_to_info.reserve(type_url_to_info_.size());
+  snapshot->info_by_id.resize(type_url_to_info_.size());
+  for (const auto& entry : type_url_to_info_) {
+    // Intern an ID for type_urls seen for the first time; IDs are dense
+    // and stay stable until Reset().
+    auto id_it = type_url_to_id_.find(entry.first);
+    if (id_it == type_url_to_id_.end()) {
+      id_it = type_url_to_id_
+                  .emplace(entry.first,
+                           static_cast<uint32_t>(type_url_to_id_.size()))
+                  .first;
+    }
+    uint32_t id = id_it->second;
+    snapshot->type_url_to_info.emplace(
+        entry.first, LookupSnapshot::TypeUrlEntry{id, &entry.second});
+    if (id >= snapshot->info_by_id.size()) {
+      snapshot->info_by_id.resize(id + 1);
+    }
+    // The string_view references the key of the node_hash_map, which has
+    // pointer stability.
+    snapshot->info_by_id[id] = {absl::string_view(entry.first), &entry.second};
+  }
+  snapshot->primitive_to_wrapper.reserve(primitive_to_wrapper_.size());
+  for (const auto& entry : primitive_to_wrapper_) {
+    snapshot->primitive_to_wrapper.emplace(entry.first, &entry.second);
+  }
+  lookup_snapshot_.store(snapshot.get(), std::memory_order_release);
+  snapshot_stale_.store(false, std::memory_order_release);
+  retired_snapshots_.push_back(std::move(snapshot));
+}
+
+StatusOr<uint32_t> RegistryImpl::GetKeyTypeId(
+    absl::string_view type_url) const {
+  const LookupSnapshot* snapshot = GetLookupSnapshot();
+  if (snapshot != nullptr) {
+    auto it = snapshot->type_url_to_info.find(type_url);
+    if (it == snapshot->type_url_to_info.end()) {
+      return ToStatusF(util::error::NOT_FOUND,
+                       "No manager for type '%s' has been registered.",
+                       type_url);
+    }
+    return it->second.id;
+  }
+  TimedMutexLock lock(&maps_mutex_);
+  auto it = type_url_to_id_.find(type_url);
+  if (it == type_url_to_id_.end()) {
     return ToStatusF(util::error::NOT_FOUND,
                      "No manager for type '%s' has been registered.", type_url);
   }
-  return &it->second;
+  return it->second;
 }
 
 StatusOr<std::unique_ptr<KeyData>> RegistryImpl::NewKeyData(
@@ -107,8 +194,14 @@ RegistryImpl::DeriveKey(const google::crypto::tink::KeyTemplate& key_template,
 }
 
 void RegistryImpl::Reset() {
-  absl::MutexLock lock(&maps_mutex_);
+  TimedMutexLock lock(&maps_mutex_);
+  // Reset() must not be called concurrently with other registry operations;
+  // it is meant for testing only. Hence it is fine to drop all snapshots.
+  lookup_snapshot_.store(nullptr, std::memory_order_release);
+  snapshot_stale_.store(false, std::memory_order_release);
+  retired_snapshots_.clear();
   type_url_to_info_.clear();
+  type_url_to_id_.clear();
   name_to_catalogue_map_.clear();
   primitive_to_wrapper_.clear();
 }
@@ -17,13 +17,19 @@
 #define TINK_INTERNAL_REGISTRY_IMPL_H_
 
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
 #include <tuple>
 #include <typeindex>
 #include <typeinfo>
 #include <utility>
+#include <vector>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/node_hash_map.h"
 #include "absl/memory/memory.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
@@ -38,6 +44,7 @@
 #include "tink/internal/fips_utils.h"
 #include "tink/internal/keyset_wrapper.h"
 #include "tink/internal/keyset_wrapper_impl.h"
+#include "tink/internal/registry_metrics.h"
 #include "tink/key_manager.h"
 #include "tink/primitive_set.h"
 #include "tink/primitive_wrapper.h"
@@ -59,6 +66,28 @@ class RegistryImpl {
   }
 
   RegistryImpl() = default;
+
+  // Creates an overlay registry backed by 'fallback_registry': lookups which
+  // find nothing in this registry fall through to the fallback, while
+  // registrations only ever touch this registry. This gives e.g. a
+  // multi-tenant process one shared base registry (standard configs,
+  // effectively immutable and hence served from its lock-free snapshot) plus
+  // an empty, cheap overlay per tenant for tenant-specific key managers --
+  // without mutating the base under its mutex, and without tenants seeing
+  // each other's registrations. A type url registered in the overlay shadows
+  // the fallback's entry. 'fallback_registry' must outlive this registry and
+  // must not (transitively) use this registry as its own fallback. The
+  // interned-ID fast path (GetKeyTypeId / get_key_manager(id)) does not
+  // traverse the fallback chain; IDs are dense per registry.
+  //
+  // A keyset wrapper found via the fallback resolves its per-key primitives
+  // through the registry it was registered in. An overlay which adds key
+  // managers for a primitive P should therefore also register the (stateless,
+  // standard) wrapper for P with the overlay, which rebinds keyset wrapping
+  // to the overlay's lookup chain.
+  explicit RegistryImpl(const RegistryImpl* fallback_registry)
+      : fallback_registry_(fallback_registry) {}
+
   RegistryImpl(const RegistryImpl&) = delete;
   RegistryImpl& operator=(const RegistryImpl&) = delete;
 
@@ -100,6 +129,21 @@ class RegistryImpl {
   crypto::tink::util::StatusOr<const KeyManager<P>*> get_key_manager(
       absl::string_view type_url) const ABSL_LOCKS_EXCLUDED(maps_mutex_);
 
+  // Returns the small integer ID interned for 'type_url' when its key
+  // manager was registered. IDs are dense (0..N-1) and stay stable until
+  // Reset(); callers can resolve a type_url once and use the ID for
+  // repeated dispatch, keeping the hashing of full type URL strings out
+  // of per-key hot paths (e.g. bulk keyset loads).
+  crypto::tink::util::StatusOr<uint32_t> GetKeyTypeId(
+      absl::string_view type_url) const ABSL_LOCKS_EXCLUDED(maps_mutex_);
+
+  // Like get_key_manager(type_url), with the key type given by its
+  // interned ID; dispatches through a flat array instead of a string
+  // hash lookup.
+  template <class P>
+  crypto::tink::util::StatusOr<const KeyManager<P>*> get_key_manager(
+      uint32_t key_type_id) const ABSL_LOCKS_EXCLUDED(maps_mutex_);
+
   // Takes ownership of 'wrapper', which must be non-nullptr.
   template <class P, class Q>
   crypto::tink::util::Status RegisterPrimitiveWrapper(
@@ -115,6 +159,13 @@ class RegistryImpl {
       absl::string_view type_url, const portable_proto::MessageLite& key) const
       ABSL_LOCKS_EXCLUDED(maps_mutex_);
 
+  // Like GetPrimitive(key_data), with the key type given by its interned ID
+  // (which must match key_data.type_url()).
+  template <class P>
+  crypto::tink::util::StatusOr<std::unique_ptr<P>> GetPrimitive(
+      uint32_t key_type_id, const google::crypto::tink::KeyData& key_data) const
+      ABSL_LOCKS_EXCLUDED(maps_mutex_);
+
   crypto::tink::util::StatusOr<std::unique_ptr<google::crypto::tink::KeyData>>
   NewKeyData(const google::crypto::tink::KeyTemplate& key_template) const
       ABSL_LOCKS_EXCLUDED(maps_mutex_);
@@ -297,14 +348,20 @@ class RegistryImpl {
   class WrapperInfo {
    public:
     template <typename P, typename Q>
-    explicit WrapperInfo(std::unique_ptr<PrimitiveWrapper<P, Q>> wrapper)
+    WrapperInfo(const RegistryImpl& registry,
+                std::unique_ptr<PrimitiveWrapper<P, Q>> wrapper)
         : is_same_primitive_wrapping_(std::is_same<P, Q>::value),
           wrapper_type_index_(std::type_index(typeid(*wrapper))),
           q_type_index_(std::type_index(typeid(Q))) {
+      // The registry owning this WrapperInfo (and hence outliving it)
+      // resolves the per-key primitives, so overlay registries wrap keysets
+      // against their own managers plus their fallback's instead of the
+      // global instance.
       auto keyset_wrapper_unique_ptr =
           absl::make_unique<KeysetWrapperImpl<P, Q>>(
-              wrapper.get(), [](const google::crypto::tink::KeyData& key_data) {
-                return RegistryImpl::GlobalInstance().GetPrimitive<P>(key_data);
+              wrapper.get(),
+              [&registry](const google::crypto::tink::KeyData& key_data) {
+                return registry.GetPrimitive<P>(key_data);
               });
       keyset_wrapper_ = std::move(keyset_wrapper_unique_ptr);
       original_wrapper_ = std::move(wrapper);
@@ -380,6 +437,49 @@ class RegistryImpl {
     const std::string type_id_name;
   };
 
+  // An immutable view of the registered key type infos and wrappers which is
+  // atomically swapped on every successful mutation. Read-only operations
+  // consult the current snapshot without taking maps_mutex_, so lookups are
+  // wait-free once configuration is frozen. The pointed-to KeyTypeInfo and
+  // WrapperInfo objects live in the node_hash_maps below and stay valid for
+  // the lifetime of the registry.
+  struct LookupSnapshot {
+    struct TypeUrlEntry {
+      uint32_t id;
+      const KeyTypeInfo* info;
+    };
+    absl::flat_hash_map<std::string, TypeUrlEntry> type_url_to_info;
+    // Key type infos indexed by their interned ID, paired with the type_url
+    // of the entry. The string_views reference the keys of type_url_to_info_,
+    // which are never erased outside of Reset().
+    std::vector<std::pair<absl::string_view, const KeyTypeInfo*>> info_by_id;
+    absl::flat_hash_map<std::type_index, const WrapperInfo*>
+        primitive_to_wrapper;
+  };
+
+  // Returns the current snapshot, or nullptr if nothing has been registered
+  // yet. Callers must fall back to the mutex-guarded maps on nullptr. If
+  // registrations have invalidated the snapshot, it is rebuilt here, on the
+  // first lookup; this way a batch of registrations (e.g. a whole
+  // TinkConfig::Register) pays for a single rebuild instead of one per
+  // registered key type.
+  const LookupSnapshot* GetLookupSnapshot() const
+      ABSL_LOCKS_EXCLUDED(maps_mutex_);
+
+  // Marks the published snapshot as stale. Must be called after every
+  // mutation of type_url_to_info_ or primitive_to_wrapper_; the rebuild is
+  // deferred until the next lookup.
+  void InvalidateLookupSnapshot() ABSL_EXCLUSIVE_LOCKS_REQUIRED(maps_mutex_) {
+    lookup_snapshot_.store(nullptr, std::memory_order_release);
+    snapshot_stale_.store(true, std::memory_order_release);
+  }
+
+  // Rebuilds the snapshot from the mutex-guarded maps and publishes it. The
+  // previous snapshot is retired rather than freed, as concurrent readers may
+  // still hold a pointer to it; rebuilds are rare (once after each batch of
+  // registrations), so the retired list stays small.
+  void RebuildLookupSnapshot() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(maps_mutex_);
+
   template <class P>
   crypto::tink::util::StatusOr<const PrimitiveWrapper<P, P>*> GetLegacyWrapper()
       const ABSL_LOCKS_EXCLUDED(maps_mutex_);
@@ -401,6 +501,10 @@ class RegistryImpl {
       absl::string_view type_url, const std::type_index& key_manager_type_index,
       bool new_key_allowed) const ABSL_SHARED_LOCKS_REQUIRED(maps_mutex_);
 
+  // Registry consulted when a lookup finds nothing here; see the overlay
+  // constructor. nullptr for ordinary (non-overlay) registries.
+  const RegistryImpl* fallback_registry_ = nullptr;
+
   mutable absl::Mutex maps_mutex_;
   // A map from the type_url to the given KeyTypeInfo. Once emplaced KeyTypeInfo
   // objects must remain valid throughout the life time of the binary. Hence,
@@ -408,15 +512,37 @@ class RegistryImpl {
   // get_key_type_manager() needs to guarantee that the returned
   // key_type_manager remains valid.
   // NOTE: We require pointer stability of the value, as get_key_type_info
-  // returns a pointer which needs to stay alive.
-  absl::flat_hash_map<std::string, KeyTypeInfo> type_url_to_info_
+  // returns a pointer which needs to stay alive, and as LookupSnapshot stores
+  // pointers into this map; hence a node_hash_map.
+  absl::node_hash_map<std::string, KeyTypeInfo> type_url_to_info_
       ABSL_GUARDED_BY(maps_mutex_);
-  // A map from the type_id to the corresponding wrapper.
-  absl::flat_hash_map<std::type_index, WrapperInfo> primitive_to_wrapper_
+  // A map from the type_id to the corresponding wrapper. Requires pointer
+  // stability of the value for the same reason as type_url_to_info_.
+  absl::node_hash_map<std::type_index, WrapperInfo> primitive_to_wrapper_
       ABSL_GUARDED_BY(maps_mutex_);
 
   absl::flat_hash_map<std::string, LabelInfo> name_to_catalogue_map_
       ABSL_GUARDED_BY(maps_mutex_);
+
+  // Interned IDs for the registered type_urls, assigned densely in
+  // registration order by RebuildLookupSnapshot. Entries are never removed
+  // (outside of Reset()), so handed-out IDs stay valid. mutable, as the
+  // deferred rebuild happens in const lookup paths.
+  mutable absl::flat_hash_map<std::string, uint32_t> type_url_to_id_
+      ABSL_GUARDED_BY(maps_mutex_);
+
+  // The currently published snapshot; points into retired_snapshots_.
+  // nullptr if nothing has been registered yet or if registrations have
+  // invalidated the snapshot (snapshot_stale_ distinguishes the two).
+  mutable std::atomic<const LookupSnapshot*> lookup_snapshot_{nullptr};
+  // True while registrations have been applied to the maps but not yet
+  // published in a snapshot.
+  mutable std::atomic<bool> snapshot_stale_{false};
+  // Owns all snapshots ever published. Entries are never freed before the
+  // registry itself is destroyed, since lock-free readers may still be
+  // using them.
+  mutable std::vector<std::unique_ptr<const LookupSnapshot>> retired_snapshots_
+      ABSL_GUARDED_BY(maps_mutex_);
 };
 
 template <class P>
@@ -428,7 +554,7 @@ crypto::tink::util::Status RegistryImpl::AddCatalogue(
         "Parameter 'catalogue' must be non-null.");
   }
   std::shared_ptr<void> entry(catalogue);
-  absl::MutexLock lock(&maps_mutex_);
+  TimedMutexLock lock(&maps_mutex_);
   auto curr_catalogue = name_to_catalogue_map_.find(catalogue_name);
   if (curr_catalogue != name_to_catalogue_map_.end()) {
     auto existing =
@@ -451,7 +577,7 @@ crypto::tink::util::Status RegistryImpl::AddCatalogue(
 template <class P>
 crypto::tink::util::StatusOr<const Catalogue<P>*> RegistryImpl::get_catalogue(
     absl::string_view catalogue_name) const {
-  absl::MutexLock lock(&maps_mutex_);
+  TimedMutexLock lock(&maps_mutex_);
   auto catalogue_entry = name_to_catalogue_map_.find(catalogue_name);
   if (catalogue_entry == name_to_catalogue_map_.end()) {
     return ToStatusF(crypto::tink::util::error::NOT_FOUND,
@@ -481,7 +607,7 @@ crypto::tink::util::Status RegistryImpl::RegisterKeyManager(
     return ToStatusF(crypto::tink::util::error::INVALID_ARGUMENT,
                      "The manager does not support type '%s'.", type_url);
   }
-  absl::MutexLock lock(&maps_mutex_);
+  TimedMutexLock lock(&maps_mutex_);
   crypto::tink::util::Status status = CheckInsertable(
       type_url, std::type_index(typeid(*owned_manager)), new_key_allowed);
   if (!status.ok()) return status;
@@ -493,6 +619,7 @@ crypto::tink::util::Status RegistryImpl::RegisterKeyManager(
     type_url_to_info_.emplace(
         std::piecewise_construct, std::forward_as_tuple(type_url),
         std::forward_as_tuple(owned_manager.release(), new_key_allowed));
+    InvalidateLookupSnapshot();
   }
   return crypto::tink::util::Status::OK;
 }
@@ -508,7 +635,7 @@ crypto::tink::util::Status RegistryImpl::RegisterKeyTypeManager(
         "Parameter 'manager' must be non-null.");
   }
   std::string type_url = owned_manager->get_key_type();
-  absl::MutexLock lock(&maps_mutex_);
+  TimedMutexLock lock(&maps_mutex_);
 
   // Check FIPS status
   internal::FipsCompatibility fips_compatible = owned_manager->FipsStatus();
@@ -532,6 +659,7 @@ crypto::tink::util::Status RegistryImpl::RegisterKeyTypeManager(
     type_url_to_info_.emplace(
         std::piecewise_construct, std::forward_as_tuple(type_url),
         std::forward_as_tuple(owned_manager.release(), new_key_allowed));
+    InvalidateLookupSnapshot();
   }
   return crypto::tink::util::Status::OK;
 }
@@ -559,7 +687,7 @@ crypto::tink::util::Status RegistryImpl::RegisterAsymmetricKeyManagers(
   std::string private_type_url = private_key_manager->get_key_type();
   std::string public_type_url = public_key_manager->get_key_type();
 
-  absl::MutexLock lock(&maps_mutex_);
+  TimedMutexLock lock(&maps_mutex_);
 
   // Check FIPS status
   auto private_fips_status =
@@ -659,6 +787,7 @@ crypto::tink::util::Status RegistryImpl::RegisterAsymmetricKeyManagers(
         std::piecewise_construct, std::forward_as_tuple(public_type_url),
         std::forward_as_tuple(owned_public_key_manager.release(),
                               new_key_allowed));
+    InvalidateLookupSnapshot();
   } else {
     private_it->second.set_new_key_allowed(new_key_allowed);
   }
@@ -676,7 +805,7 @@ crypto::tink::util::Status RegistryImpl::RegisterPrimitiveWrapper(
   }
   std::unique_ptr<PrimitiveWrapper<P, Q>> entry(wrapper);
 
-  absl::MutexLock lock(&maps_mutex_);
+  TimedMutexLock lock(&maps_mutex_);
   auto it = primitive_to_wrapper_.find(std::type_index(typeid(Q)));
   if (it != primitive_to_wrapper_.end()) {
     if (!it->second.HasSameType(*wrapper)) {
@@ -689,20 +818,45 @@ crypto::tink::util::Status RegistryImpl::RegisterPrimitiveWrapper(
   primitive_to_wrapper_.emplace(
       std::piecewise_construct,
       std::forward_as_tuple(std::type_index(typeid(Q))),
-      std::forward_as_tuple(std::move(entry)));
+      std::forward_as_tuple(*this, std::move(entry)));
+  InvalidateLookupSnapshot();
   return crypto::tink::util::Status::OK;
 }
 
 template <class P>
 crypto::tink::util::StatusOr<const KeyManager<P>*>
 RegistryImpl::get_key_manager(absl::string_view type_url) const {
-  absl::MutexLock lock(&maps_mutex_);
-  auto it = type_url_to_info_.find(type_url);
-  if (it == type_url_to_info_.end()) {
+  const LookupSnapshot* snapshot = GetLookupSnapshot();
+  if (snapshot != nullptr) {
+    auto it = snapshot->type_url_to_info.find(type_url);
+    if (it != snapshot->type_url_to_info.end()) {
+      return it->second.info->get_key_manager<P>(type_url);
+    }
+  } else {
+    TimedMutexLock lock(&maps_mutex_);
+    auto it = type_url_to_info_.find(type_url);
+    if (it != type_url_to_info_.end()) {
+      return it->second.get_key_manager<P>(type_url);
+    }
+  }
+  if (fallback_registry_ != nullptr) {
+    return fallback_registry_->get_key_manager<P>(type_url);
+  }
+  return ToStatusF(crypto::tink::util::error::NOT_FOUND,
+                   "No manager for type '%s' has been registered.", type_url);
+}
+
+template <class P>
+crypto::tink::util::StatusOr<const KeyManager<P>*>
+RegistryImpl::get_key_manager(uint32_t key_type_id) const {
+  const LookupSnapshot* snapshot = GetLookupSnapshot();
+  if (snapshot == nullptr || key_type_id >= snapshot->info_by_id.size()) {
     return ToStatusF(crypto::tink::util::error::NOT_FOUND,
-                     "No manager for type '%s' has been registered.", type_url);
+                     "No manager for key type ID %u has been registered.",
+                     key_type_id);
   }
-  return it->second.get_key_manager<P>(type_url);
+  const auto& entry = snapshot->info_by_id[key_type_id];
+  return entry.second->get_key_manager<P>(entry.first);
 }
 
 template <class P>
@@ -715,6 +869,16 @@ crypto::tink::util::StatusOr<std::unique_ptr<P>> RegistryImpl::GetPrimitive(
   return key_manager_result.status();
 }
 
+template <class P>
+crypto::tink::util::StatusOr<std::unique_ptr<P>> RegistryImpl::GetPrimitive(
+    uint32_t key_type_id, const google::crypto::tink::KeyData& key_data) const {
+  auto key_manager_result = get_key_manager<P>(key_type_id);
+  if (key_manager_result.ok()) {
+    return key_manager_result.ValueOrDie()->GetPrimitive(key_data);
+  }
+  return key_manager_result.status();
+}
+
 template <class P>
 crypto::tink::util::StatusOr<std::unique_ptr<P>> RegistryImpl::GetPrimitive(
     absl::string_view type_url, const portable_proto::MessageLite& key) const {
@@ -728,27 +892,49 @@ crypto::tink::util::StatusOr<std::unique_ptr<P>> RegistryImpl::GetPrimitive(
 template <class P>
 crypto::tink::util::StatusOr<const PrimitiveWrapper<P, P>*>
 RegistryImpl::GetLegacyWrapper() const {
-  absl::MutexLock lock(&maps_mutex_);
-  auto it = primitive_to_wrapper_.find(std::type_index(typeid(P)));
-  if (it == primitive_to_wrapper_.end()) {
-    return util::Status(
-        util::error::NOT_FOUND,
-        absl::StrCat("No wrapper registered for type ", typeid(P).name()));
-  }
-  return it->second.GetLegacyWrapper<P>();
+  const LookupSnapshot* snapshot = GetLookupSnapshot();
+  if (snapshot != nullptr) {
+    auto it = snapshot->primitive_to_wrapper.find(std::type_index(typeid(P)));
+    if (it != snapshot->primitive_to_wrapper.end()) {
+      return it->second->GetLegacyWrapper<P>();
+    }
+  } else {
+    TimedMutexLock lock(&maps_mutex_);
+    auto it = primitive_to_wrapper_.find(std::type_index(typeid(P)));
+    if (it != primitive_to_wrapper_.end()) {
+      return it->second.GetLegacyWrapper<P>();
+    }
+  }
+  if (fallback_registry_ != nullptr) {
+    return fallback_registry_->GetLegacyWrapper<P>();
+  }
+  return util::Status(
+      util::error::NOT_FOUND,
+      absl::StrCat("No wrapper registered for type ", typeid(P).name()));
 }
 
 template <class P>
 crypto::tink::util::StatusOr<const KeysetWrapper<P>*>
 RegistryImpl::GetKeysetWrapper() const {
-  absl::MutexLock lock(&maps_mutex_);
-  auto it = primitive_to_wrapper_.find(std::type_index(typeid(P)));
-  if (it == primitive_to_wrapper_.end()) {
-    return util::Status(
-        util::error::NOT_FOUND,
-        absl::StrCat("No wrapper registered for type ", typeid(P).name()));
-  }
-  return it->second.GetKeysetWrapper<P>();
+  const LookupSnapshot* snapshot = GetLookupSnapshot();
+  if (snapshot != nullptr) {
+    auto it = snapshot->primitive_to_wrapper.find(std::type_index(typeid(P)));
+    if (it != snapshot->primitive_to_wrapper.end()) {
+      return it->second->GetKeysetWrapper<P>();
+    }
+  } else {
+    TimedMutexLock lock(&maps_mutex_);
+    auto it = primitive_to_wrapper_.find(std::type_index(typeid(P)));
+    if (it != primitive_to_wrapper_.end()) {
+      return it->second.GetKeysetWrapper<P>();
+    }
+  }
+  if (fallback_registry_ != nullptr) {
+    return fallback_registry_->GetKeysetWrapper<P>();
+  }
+  return util::Status(
+      util::error::NOT_FOUND,
+      absl::StrCat("No wrapper registered for type ", typeid(P).name()));
 }
 
 template <class P>
@@ -783,10 +969,9 @@ crypto::tink::util::StatusOr<std::unique_ptr<P>> RegistryImpl::WrapKeyset(
 }
 
 inline crypto::tink::util::Status RegistryImpl::RestrictToFipsIfEmpty() const {
-  absl::MutexLock lock(&maps_mutex_);
+  TimedMutexLock lock(&maps_mutex_);
   if (type_url_to_info_.empty()) {
-    SetFipsRestricted();
-    return util::OkStatus();
+    return SetFipsRestricted();
   }
   return util::Status(util::error::INTERNAL,
                       "Could not set FIPS only mode. Registry is not empty.");
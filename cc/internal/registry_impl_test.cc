@@ -395,6 +395,30 @@ TEST_F(RegistryTest, testConcurrentRegistration) {
   EXPECT_EQ(util::error::NOT_FOUND, manager_result.status().error_code());
 }
 
+TEST_F(RegistryTest, testConcurrentLookupsAfterRegistration) {
+  std::string key_type_prefix = "key_type_snapshot_";
+  int count = 24;
+
+  // Register the managers up front; afterwards all lookups go through the
+  // lock-free registry snapshot.
+  register_test_managers(key_type_prefix, count);
+
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 8; t++) {
+    readers.push_back(std::thread([&]() {
+      for (int i = 0; i < count; i++) {
+        std::string key_type = key_type_prefix + std::to_string(i);
+        auto manager_result = Registry::get_key_manager<Aead>(key_type);
+        EXPECT_TRUE(manager_result.ok()) << manager_result.status();
+        EXPECT_EQ(key_type, manager_result.ValueOrDie()->get_key_type());
+      }
+    }));
+  }
+  for (auto& reader : readers) {
+    reader.join();
+  }
+}
+
 TEST_F(RegistryTest, testBasic) {
   std::string key_type_1 = "google.crypto.tink.AesCtrHmacAeadKey";
   std::string key_type_2 = "google.crypto.tink.AesGcmKey";
@@ -475,6 +499,69 @@ TEST_F(RegistryTest, GetKeyManagerRemainsValid) {
   EXPECT_THAT(key_manager.ValueOrDie()->get_key_type(), Eq(key_type));
 }
 
+TEST_F(RegistryTest, InternedKeyTypeIds) {
+  std::string key_type_1 = "google.crypto.tink.AesCtrHmacAeadKey";
+  std::string key_type_2 = "google.crypto.tink.AesGcmKey";
+  // Unregistered type_urls have no ID.
+  EXPECT_THAT(RegistryImpl::GlobalInstance().GetKeyTypeId(key_type_1).status(),
+              StatusIs(util::error::NOT_FOUND));
+
+  EXPECT_THAT(Registry::RegisterKeyManager(
+                  absl::make_unique<TestAeadKeyManager>(key_type_1), true),
+              IsOk());
+  EXPECT_THAT(Registry::RegisterKeyManager(
+                  absl::make_unique<TestAeadKeyManager>(key_type_2), true),
+              IsOk());
+
+  auto id_1 = RegistryImpl::GlobalInstance().GetKeyTypeId(key_type_1);
+  auto id_2 = RegistryImpl::GlobalInstance().GetKeyTypeId(key_type_2);
+  ASSERT_THAT(id_1.status(), IsOk());
+  ASSERT_THAT(id_2.status(), IsOk());
+  EXPECT_NE(id_1.ValueOrDie(), id_2.ValueOrDie());
+
+  // ID-based dispatch reaches the same key manager as the string lookup.
+  auto manager_result =
+      RegistryImpl::GlobalInstance().get_key_manager<Aead>(id_1.ValueOrDie());
+  ASSERT_THAT(manager_result.status(), IsOk());
+  EXPECT_EQ(manager_result.ValueOrDie(),
+            Registry::get_key_manager<Aead>(key_type_1).ValueOrDie());
+
+  // Handed-out IDs stay stable across further registrations.
+  std::string key_type_3 = "google.crypto.tink.SomeOtherKey";
+  EXPECT_THAT(Registry::RegisterKeyManager(
+                  absl::make_unique<TestAeadKeyManager>(key_type_3), true),
+              IsOk());
+  EXPECT_EQ(id_1.ValueOrDie(),
+            RegistryImpl::GlobalInstance().GetKeyTypeId(key_type_1)
+                .ValueOrDie());
+
+  // Unknown IDs are rejected.
+  EXPECT_THAT(
+      RegistryImpl::GlobalInstance().get_key_manager<Aead>(12345).status(),
+      StatusIs(util::error::NOT_FOUND));
+}
+
+// Lookups between registrations must observe every entry registered so
+// far; the lookup tables are only rebuilt on the first lookup after a
+// batch of registrations.
+TEST_F(RegistryTest, LookupsInterleavedWithRegistrationsSeeNewEntries) {
+  std::string key_type_1 = "google.crypto.tink.AesCtrHmacAeadKey";
+  std::string key_type_2 = "google.crypto.tink.AesGcmKey";
+
+  EXPECT_THAT(Registry::RegisterKeyManager(
+                  absl::make_unique<TestAeadKeyManager>(key_type_1), true),
+              IsOk());
+  EXPECT_THAT(Registry::get_key_manager<Aead>(key_type_1).status(), IsOk());
+  EXPECT_THAT(Registry::get_key_manager<Aead>(key_type_2).status(),
+              StatusIs(util::error::NOT_FOUND));
+
+  EXPECT_THAT(Registry::RegisterKeyManager(
+                  absl::make_unique<TestAeadKeyManager>(key_type_2), true),
+              IsOk());
+  EXPECT_THAT(Registry::get_key_manager<Aead>(key_type_1).status(), IsOk());
+  EXPECT_THAT(Registry::get_key_manager<Aead>(key_type_2).status(), IsOk());
+}
+
 class TestAeadCatalogue : public Catalogue<Aead> {
  public:
   TestAeadCatalogue() {}
@@ -1970,6 +2057,101 @@ TEST(RegistryImplTest, CanDelegateGetPublicKey) {
                        HasSubstr("GetPublicKey worked")));
 }
 
+TEST(RegistryImplTest, OverlayFallsBackToBase) {
+  if (kUseOnlyFips) {
+    GTEST_SKIP() << "Not supported in FIPS-only mode";
+  }
+
+  RegistryImpl base;
+  ASSERT_THAT(base.RegisterKeyManager(new TestAeadKeyManager("base_type"),
+                                      /* new_key_allowed= */ true),
+              IsOk());
+
+  RegistryImpl overlay(&base);
+  auto manager_result = overlay.get_key_manager<Aead>("base_type");
+  ASSERT_THAT(manager_result.status(), IsOk());
+  EXPECT_EQ(manager_result.ValueOrDie()->get_key_type(), "base_type");
+
+  // Key creation falls through to the base as well.
+  KeyTemplate key_template;
+  key_template.set_type_url("base_type");
+  EXPECT_THAT(overlay.NewKeyData(key_template).status(), IsOk());
+
+  EXPECT_THAT(overlay.get_key_manager<Aead>("unknown_type").status(),
+              StatusIs(util::error::NOT_FOUND));
+}
+
+TEST(RegistryImplTest, OverlayRegistrationsDoNotLeakIntoBase) {
+  if (kUseOnlyFips) {
+    GTEST_SKIP() << "Not supported in FIPS-only mode";
+  }
+
+  RegistryImpl base;
+  RegistryImpl overlay(&base);
+  ASSERT_THAT(overlay.RegisterKeyManager(new TestAeadKeyManager("tenant_type"),
+                                         /* new_key_allowed= */ true),
+              IsOk());
+
+  EXPECT_THAT(overlay.get_key_manager<Aead>("tenant_type").status(), IsOk());
+  // Another tenant sharing the same base must not see the registration.
+  EXPECT_THAT(base.get_key_manager<Aead>("tenant_type").status(),
+              StatusIs(util::error::NOT_FOUND));
+}
+
+TEST(RegistryImplTest, OverlayShadowsBase) {
+  if (kUseOnlyFips) {
+    GTEST_SKIP() << "Not supported in FIPS-only mode";
+  }
+
+  RegistryImpl base;
+  ASSERT_THAT(base.RegisterKeyManager(new TestAeadKeyManager("some_type"),
+                                      /* new_key_allowed= */ true),
+              IsOk());
+  RegistryImpl overlay(&base);
+  ASSERT_THAT(overlay.RegisterKeyManager(new TestAeadKeyManager("some_type"),
+                                         /* new_key_allowed= */ true),
+              IsOk());
+
+  auto base_manager = base.get_key_manager<Aead>("some_type");
+  auto overlay_manager = overlay.get_key_manager<Aead>("some_type");
+  ASSERT_THAT(base_manager.status(), IsOk());
+  ASSERT_THAT(overlay_manager.status(), IsOk());
+  // The overlay's own manager wins over the one in the base.
+  EXPECT_NE(overlay_manager.ValueOrDie(), base_manager.ValueOrDie());
+}
+
+// A wrapper registered with an overlay must resolve the per-key primitives
+// through the overlay's lookup chain, i.e. find key managers that only the
+// shared base provides.
+TEST(RegistryImplTest, OverlayKeysetWrappingSeesBaseKeyManagers) {
+  if (kUseOnlyFips) {
+    GTEST_SKIP() << "Not supported in FIPS-only mode";
+  }
+
+  Keyset keyset;
+  std::string raw_key =
+      AddAesGcmKey(13, OutputPrefixType::TINK, KeyStatusType::ENABLED, keyset);
+  keyset.set_primary_key_id(13);
+
+  RegistryImpl base;
+  ASSERT_THAT(base.RegisterKeyTypeManager<AesGcmKey, AesGcmKeyFormat,
+                                          List<Aead, AeadVariant>>(
+                  absl::make_unique<ExampleKeyTypeManager>(), true),
+              IsOk());
+
+  RegistryImpl overlay(&base);
+  ASSERT_THAT(overlay.RegisterPrimitiveWrapper(
+                  absl::make_unique<AeadVariantWrapper>()),
+              IsOk());
+
+  auto aead_variant = overlay.WrapKeyset<AeadVariant>(keyset);
+  ASSERT_THAT(aead_variant.status(), IsOk());
+  EXPECT_THAT(aead_variant.ValueOrDie()->get(), Eq(raw_key));
+  // The base alone cannot wrap: the wrapper lives only in the overlay.
+  EXPECT_THAT(base.WrapKeyset<AeadVariant>(keyset).status(),
+              StatusIs(util::error::NOT_FOUND));
+}
+
 TEST(RegistryImplTest, FipsSucceedsOnEmptyRegistry) {
   RegistryImpl registry_impl;
   EXPECT_THAT(registry_impl.RestrictToFipsIfEmpty(), IsOk());
@@ -0,0 +1,89 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/internal/registry_metrics.h"
+
+#include <algorithm>
+
+namespace crypto {
+namespace tink {
+namespace internal {
+
+// static
+void RegistryMetrics::AddShard(const Shard& shard,
+                               RegistryMetricsSnapshot* snapshot) {
+  snapshot->registry_lookups +=
+      shard.registry_lookups.load(std::memory_order_relaxed);
+  snapshot->registry_lookup_misses +=
+      shard.registry_lookup_misses.load(std::memory_order_relaxed);
+  snapshot->registry_mutex_acquisitions +=
+      shard.registry_mutex_acquisitions.load(std::memory_order_relaxed);
+  snapshot->registry_mutex_contentions +=
+      shard.registry_mutex_contentions.load(std::memory_order_relaxed);
+  snapshot->registry_mutex_wait_ns +=
+      shard.registry_mutex_wait_ns.load(std::memory_order_relaxed);
+  snapshot->trial_decrypts +=
+      shard.trial_decrypts.load(std::memory_order_relaxed);
+  snapshot->trial_decrypt_attempts +=
+      shard.trial_decrypt_attempts.load(std::memory_order_relaxed);
+  snapshot->trial_decrypt_max_depth =
+      std::max(snapshot->trial_decrypt_max_depth,
+               shard.trial_decrypt_max_depth.load(std::memory_order_relaxed));
+}
+
+RegistryMetrics& RegistryMetrics::Global() {
+  static RegistryMetrics* instance = new RegistryMetrics();
+  return *instance;
+}
+
+RegistryMetrics::ShardHandle::ShardHandle(RegistryMetrics* metrics)
+    : metrics_(metrics), shard_(metrics->RegisterShard()) {}
+
+RegistryMetrics::ShardHandle::~ShardHandle() { metrics_->RetireShard(shard_); }
+
+RegistryMetrics::Shard& RegistryMetrics::LocalShard() {
+  // Only RegistryMetrics::Global() exists (the constructor is private), so
+  // binding the thread-local handle to the first instance seen is safe.
+  thread_local ShardHandle handle(this);
+  return *handle.shard();
+}
+
+RegistryMetrics::Shard* RegistryMetrics::RegisterShard() {
+  Shard* shard = new Shard();
+  absl::MutexLock lock(&shards_mutex_);
+  shards_.push_back(shard);
+  return shard;
+}
+
+void RegistryMetrics::RetireShard(Shard* shard) {
+  absl::MutexLock lock(&shards_mutex_);
+  AddShard(*shard, &retired_);
+  shards_.erase(std::find(shards_.begin(), shards_.end(), shard));
+  delete shard;
+}
+
+RegistryMetricsSnapshot RegistryMetrics::Snapshot() const {
+  absl::MutexLock lock(&shards_mutex_);
+  RegistryMetricsSnapshot snapshot = retired_;
+  for (const Shard* shard : shards_) {
+    AddShard(*shard, &snapshot);
+  }
+  return snapshot;
+}
+
+}  // namespace internal
+}  // namespace tink
+}  // namespace crypto
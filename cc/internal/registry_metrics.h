@@ -0,0 +1,190 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_INTERNAL_REGISTRY_METRICS_H_
+#define TINK_INTERNAL_REGISTRY_METRICS_H_
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "absl/base/optimization.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+
+namespace crypto {
+namespace tink {
+namespace internal {
+
+// Always-on process-wide counters of Tink-internal behavior: registry
+// lookups, contention on the registry mutex, and the depth of the
+// trial-decryption loops over PrimitiveSet entries. They complement
+// monitoring.h, which aggregates per-key operation rates and latencies:
+// these counters expose what happens inside Tink rather than at its API
+// surface.
+//
+// The counters are sharded per thread: every thread records into its own
+// cache-line-aligned shard, so updates never touch a cache line another
+// core writes to and stay cheap even when many cores record concurrently.
+// A metrics exporter (e.g. a Prometheus collector) reads cumulative values
+// at scrape time via RegistryMetrics::Global().Snapshot(), which sums the
+// live shards and the totals folded in from exited threads; all counters
+// increase monotonically over the lifetime of the process.
+struct RegistryMetricsSnapshot {
+  // Key-manager lookups by type_url (RegistryImpl::get_key_type_info),
+  // and those that found no registered manager.
+  uint64_t registry_lookups = 0;
+  uint64_t registry_lookup_misses = 0;
+  // Acquisitions of the registry mutex, how many of them had to wait for
+  // another thread, and the total time spent waiting.
+  uint64_t registry_mutex_acquisitions = 0;
+  uint64_t registry_mutex_contentions = 0;
+  uint64_t registry_mutex_wait_ns = 0;
+  // Trial-decryption loops run by the wrappers, the total number of keys
+  // tried across all loops (attempts / loops is the average depth), and
+  // the deepest loop observed so far.
+  uint64_t trial_decrypts = 0;
+  uint64_t trial_decrypt_attempts = 0;
+  uint64_t trial_decrypt_max_depth = 0;
+};
+
+class RegistryMetrics {
+ public:
+  // Returns the process-wide instance that the registry and the wrappers
+  // record into.
+  static RegistryMetrics& Global();
+
+  void RecordLookup(bool found) {
+    Shard& shard = LocalShard();
+    shard.registry_lookups.fetch_add(1, std::memory_order_relaxed);
+    if (!found) {
+      shard.registry_lookup_misses.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  // Records one acquisition of the registry mutex; 'wait_ns' is the time
+  // spent blocked, or 0 for an uncontended acquisition.
+  void RecordMutexAcquisition(int64_t wait_ns) {
+    Shard& shard = LocalShard();
+    shard.registry_mutex_acquisitions.fetch_add(1, std::memory_order_relaxed);
+    if (wait_ns > 0) {
+      shard.registry_mutex_contentions.fetch_add(1, std::memory_order_relaxed);
+      shard.registry_mutex_wait_ns.fetch_add(wait_ns,
+                                             std::memory_order_relaxed);
+    }
+  }
+
+  // Records one finished trial-decryption loop that tried 'attempts' keys.
+  void RecordTrialDecrypt(int attempts) {
+    Shard& shard = LocalShard();
+    shard.trial_decrypts.fetch_add(1, std::memory_order_relaxed);
+    shard.trial_decrypt_attempts.fetch_add(attempts,
+                                           std::memory_order_relaxed);
+    // Only the owning thread writes to its shard, so the per-shard maximum
+    // needs no compare-and-swap loop.
+    uint64_t depth = attempts;
+    if (depth >
+        shard.trial_decrypt_max_depth.load(std::memory_order_relaxed)) {
+      shard.trial_decrypt_max_depth.store(depth, std::memory_order_relaxed);
+    }
+  }
+
+  RegistryMetricsSnapshot Snapshot() const;
+
+  RegistryMetrics(const RegistryMetrics&) = delete;
+  RegistryMetrics& operator=(const RegistryMetrics&) = delete;
+
+ private:
+  // One thread's counters. The atomics are only ever written by the owning
+  // thread; Snapshot() reads them from other threads with relaxed loads.
+  // The alignment keeps shards of different threads on different cache
+  // lines.
+  struct alignas(ABSL_CACHELINE_SIZE) Shard {
+    std::atomic<uint64_t> registry_lookups{0};
+    std::atomic<uint64_t> registry_lookup_misses{0};
+    std::atomic<uint64_t> registry_mutex_acquisitions{0};
+    std::atomic<uint64_t> registry_mutex_contentions{0};
+    std::atomic<uint64_t> registry_mutex_wait_ns{0};
+    std::atomic<uint64_t> trial_decrypts{0};
+    std::atomic<uint64_t> trial_decrypt_attempts{0};
+    std::atomic<uint64_t> trial_decrypt_max_depth{0};
+  };
+
+  // RAII registration of one thread's shard; the thread_local instance in
+  // LocalShard() folds the shard into retired_ when the thread exits.
+  class ShardHandle {
+   public:
+    explicit ShardHandle(RegistryMetrics* metrics);
+    ~ShardHandle();
+    Shard* shard() const { return shard_; }
+
+   private:
+    RegistryMetrics* const metrics_;
+    Shard* const shard_;
+  };
+
+  RegistryMetrics() = default;
+
+  // Returns the calling thread's shard, creating and registering it on the
+  // first call from that thread.
+  Shard& LocalShard();
+
+  Shard* RegisterShard();
+  void RetireShard(Shard* shard);
+
+  // Adds 'shard' into 'snapshot'; counters are summed, the maximum is
+  // combined as a maximum.
+  static void AddShard(const Shard& shard, RegistryMetricsSnapshot* snapshot);
+
+  mutable absl::Mutex shards_mutex_;
+  // Live shards, one per thread that has recorded anything.
+  std::vector<Shard*> shards_ ABSL_GUARDED_BY(shards_mutex_);
+  // Totals of threads that have exited.
+  RegistryMetricsSnapshot retired_ ABSL_GUARDED_BY(shards_mutex_);
+};
+
+// A scoped lock that feeds the mutex-wait counters: an uncontended
+// acquisition takes the TryLock fast path and costs no clock reads, a
+// contended one times the wait.
+class ABSL_SCOPED_LOCKABLE TimedMutexLock {
+ public:
+  explicit TimedMutexLock(absl::Mutex* mu) ABSL_EXCLUSIVE_LOCK_FUNCTION(mu)
+      : mu_(mu) {
+    if (mu_->TryLock()) {
+      RegistryMetrics::Global().RecordMutexAcquisition(0);
+      return;
+    }
+    int64_t start_ns = absl::GetCurrentTimeNanos();
+    mu_->Lock();
+    RegistryMetrics::Global().RecordMutexAcquisition(
+        absl::GetCurrentTimeNanos() - start_ns);
+  }
+
+  ~TimedMutexLock() ABSL_UNLOCK_FUNCTION() { mu_->Unlock(); }
+
+  TimedMutexLock(const TimedMutexLock&) = delete;
+  TimedMutexLock& operator=(const TimedMutexLock&) = delete;
+
+ private:
+  absl::Mutex* const mu_;
+};
+
+}  // namespace internal
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_INTERNAL_REGISTRY_METRICS_H_
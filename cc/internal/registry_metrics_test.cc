@@ -0,0 +1,128 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/internal/registry_metrics.h"
+
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+
+namespace crypto {
+namespace tink {
+namespace internal {
+namespace {
+
+// The counters are process-wide and cumulative, so all expectations are
+// on deltas relative to a snapshot taken at the start of the test.
+
+TEST(RegistryMetricsTest, RecordLookup) {
+  auto& metrics = RegistryMetrics::Global();
+  RegistryMetricsSnapshot before = metrics.Snapshot();
+  metrics.RecordLookup(/* found = */ true);
+  metrics.RecordLookup(/* found = */ true);
+  metrics.RecordLookup(/* found = */ false);
+  RegistryMetricsSnapshot after = metrics.Snapshot();
+  EXPECT_EQ(3, after.registry_lookups - before.registry_lookups);
+  EXPECT_EQ(1, after.registry_lookup_misses - before.registry_lookup_misses);
+}
+
+TEST(RegistryMetricsTest, RecordTrialDecrypt) {
+  auto& metrics = RegistryMetrics::Global();
+  RegistryMetricsSnapshot before = metrics.Snapshot();
+  metrics.RecordTrialDecrypt(1);
+  metrics.RecordTrialDecrypt(5);
+  metrics.RecordTrialDecrypt(2);
+  RegistryMetricsSnapshot after = metrics.Snapshot();
+  EXPECT_EQ(3, after.trial_decrypts - before.trial_decrypts);
+  EXPECT_EQ(8, after.trial_decrypt_attempts - before.trial_decrypt_attempts);
+  EXPECT_GE(after.trial_decrypt_max_depth, 5);
+}
+
+TEST(RegistryMetricsTest, CountsSurviveThreadExit) {
+  auto& metrics = RegistryMetrics::Global();
+  RegistryMetricsSnapshot before = metrics.Snapshot();
+  std::thread worker([&metrics]() {
+    metrics.RecordLookup(/* found = */ true);
+    metrics.RecordTrialDecrypt(4);
+  });
+  worker.join();
+  // The worker's shard has been retired; its counts must be folded into
+  // the totals.
+  RegistryMetricsSnapshot after = metrics.Snapshot();
+  EXPECT_GE(after.registry_lookups, before.registry_lookups + 1);
+  EXPECT_GE(after.trial_decrypt_attempts, before.trial_decrypt_attempts + 4);
+  EXPECT_GE(after.trial_decrypt_max_depth, 4);
+}
+
+TEST(RegistryMetricsTest, ConcurrentRecordingSumsAcrossShards) {
+  auto& metrics = RegistryMetrics::Global();
+  RegistryMetricsSnapshot before = metrics.Snapshot();
+  constexpr int kThreads = 8;
+  constexpr int kLookupsPerThread = 1000;
+  std::vector<std::thread> workers;
+  for (int t = 0; t < kThreads; t++) {
+    workers.push_back(std::thread([&metrics]() {
+      for (int i = 0; i < kLookupsPerThread; i++) {
+        metrics.RecordLookup(/* found = */ true);
+      }
+    }));
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  RegistryMetricsSnapshot after = metrics.Snapshot();
+  EXPECT_GE(after.registry_lookups,
+            before.registry_lookups + kThreads * kLookupsPerThread);
+}
+
+TEST(RegistryMetricsTest, UncontendedTimedMutexLock) {
+  auto& metrics = RegistryMetrics::Global();
+  RegistryMetricsSnapshot before = metrics.Snapshot();
+  absl::Mutex mu;
+  { TimedMutexLock lock(&mu); }
+  RegistryMetricsSnapshot after = metrics.Snapshot();
+  EXPECT_GE(after.registry_mutex_acquisitions,
+            before.registry_mutex_acquisitions + 1);
+}
+
+TEST(RegistryMetricsTest, ContendedTimedMutexLockRecordsWait) {
+  auto& metrics = RegistryMetrics::Global();
+  RegistryMetricsSnapshot before = metrics.Snapshot();
+  absl::Mutex mu;
+  absl::Notification lock_held;
+  std::thread holder([&mu, &lock_held]() {
+    absl::MutexLock lock(&mu);
+    lock_held.Notify();
+    absl::SleepFor(absl::Milliseconds(50));
+  });
+  lock_held.WaitForNotification();
+  { TimedMutexLock lock(&mu); }
+  holder.join();
+  RegistryMetricsSnapshot after = metrics.Snapshot();
+  EXPECT_GE(after.registry_mutex_contentions,
+            before.registry_mutex_contentions + 1);
+  EXPECT_GT(after.registry_mutex_wait_ns, before.registry_mutex_wait_ns);
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace tink
+}  // namespace crypto
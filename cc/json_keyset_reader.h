@@ -37,6 +37,14 @@ class JsonKeysetReader : public KeysetReader {
   static crypto::tink::util::StatusOr<std::unique_ptr<KeysetReader>> New(
       absl::string_view serialized_keyset);
 
+  // Like New(absl::string_view) above, but does NOT copy the serialized
+  // keyset: the returned reader parses directly from the caller's buffer.
+  // The bytes backing 'serialized_keyset' must remain alive and unmodified
+  // as long as the returned reader is in use (e.g. an mmap'ed region that
+  // stays mapped).
+  static crypto::tink::util::StatusOr<std::unique_ptr<KeysetReader>>
+  NewNonOwning(absl::string_view serialized_keyset);
+
   crypto::tink::util::StatusOr<std::unique_ptr<google::crypto::tink::Keyset>>
   Read() override;
 
@@ -46,11 +54,11 @@ class JsonKeysetReader : public KeysetReader {
 
  private:
   explicit JsonKeysetReader(std::unique_ptr<std::istream> keyset_stream)
-      : serialized_keyset_(""), keyset_stream_(std::move(keyset_stream)) {}
-  explicit JsonKeysetReader(absl::string_view serialized_keyset)
-      : serialized_keyset_(serialized_keyset), keyset_stream_(nullptr) {}
+      : keyset_stream_(std::move(keyset_stream)) {}
+  JsonKeysetReader(absl::string_view serialized_keyset, bool copy_keyset);
 
-  std::string serialized_keyset_;
+  std::string owned_keyset_;  // empty if this reader does not own the bytes
+  absl::string_view serialized_keyset_;
   std::unique_ptr<std::istream> keyset_stream_;
 };
 
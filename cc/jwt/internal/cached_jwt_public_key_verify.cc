@@ -0,0 +1,69 @@
+// Copyright 2021 Google LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/jwt/internal/cached_jwt_public_key_verify.h"
+
+#include <string>
+#include <utility>
+
+#include "absl/types/optional.h"
+#include "tink/util/status.h"
+
+namespace crypto {
+namespace tink {
+namespace jwt_internal {
+
+util::StatusOr<VerifiedJwt> CachedJwtPublicKeyVerify::VerifyAndDecode(
+    absl::string_view compact, const JwtValidator& validator) const {
+  std::string token = std::string(compact);
+  absl::optional<RawJwt> cached_jwt;
+  {
+    absl::MutexLock lock(&mutex_);
+    auto map_it = entries_.find(token);
+    if (map_it != entries_.end()) {
+      lru_.splice(lru_.begin(), lru_, map_it->second);
+      cached_jwt = map_it->second->second;
+    }
+  }
+  if (cached_jwt.has_value()) {
+    // The signature and the header have already been verified; only the
+    // claims need to be validated against the current time and validator.
+    util::Status validate_result = validator.Validate(*cached_jwt);
+    if (!validate_result.ok()) {
+      return validate_result;
+    }
+    return VerifiedJwt(*std::move(cached_jwt));
+  }
+  util::StatusOr<VerifiedJwt> verified_jwt = verify_->VerifyAndDecode(
+      compact, validator);
+  if (!verified_jwt.ok()) {
+    return verified_jwt;
+  }
+  absl::MutexLock lock(&mutex_);
+  if (entries_.count(token) == 0) {
+    lru_.emplace_front(token, verified_jwt.ValueOrDie().raw_jwt_);
+    entries_.insert({std::move(token), lru_.begin()});
+    if (lru_.size() > max_cached_tokens_) {
+      entries_.erase(lru_.back().first);
+      lru_.pop_back();
+    }
+  }
+  return verified_jwt;
+}
+
+}  // namespace jwt_internal
+}  // namespace tink
+}  // namespace crypto
@@ -0,0 +1,88 @@
+// Copyright 2021 Google LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_JWT_INTERNAL_CACHED_JWT_PUBLIC_KEY_VERIFY_H_
+#define TINK_JWT_INTERNAL_CACHED_JWT_PUBLIC_KEY_VERIFY_H_
+
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "tink/jwt/jwt_public_key_verify.h"
+#include "tink/jwt/jwt_validator.h"
+#include "tink/jwt/raw_jwt.h"
+#include "tink/jwt/verified_jwt.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace jwt_internal {
+
+// An opt-in caching decorator around a JwtPublicKeyVerify.
+//
+// Services that sit behind a gateway typically see the same bearer token on
+// many consecutive requests, and each request pays for a base64 decode, a
+// JSON parse and a signature verification. This decorator remembers the
+// parsed claims of tokens whose signature has already been verified, keyed
+// by the compact token itself, so a repeated token costs a hash lookup plus
+// claim validation.
+//
+// The cache deliberately keys on the full compact token and not on a short
+// fingerprint of it: with a fingerprint, a hash collision would serve the
+// claims of a different token. Claim validation (including the expiration
+// and not-before checks, against the current time) still runs on every call,
+// so a cached token stops verifying the moment it expires, and each call may
+// use a different JwtValidator.
+//
+// Only the token bytes that the caller already presented are used as the
+// cache key; no secret material is hashed or compared, so the cache adds no
+// secret-dependent branching.
+class CachedJwtPublicKeyVerify : public JwtPublicKeyVerify {
+ public:
+  // Decorates 'verify'. At most 'max_cached_tokens' verified tokens are
+  // kept; the least recently seen one is evicted first.
+  explicit CachedJwtPublicKeyVerify(
+      std::unique_ptr<crypto::tink::JwtPublicKeyVerify> verify,
+      size_t max_cached_tokens = 100)
+      : verify_(std::move(verify)), max_cached_tokens_(max_cached_tokens) {}
+
+  crypto::tink::util::StatusOr<crypto::tink::VerifiedJwt> VerifyAndDecode(
+      absl::string_view compact,
+      const crypto::tink::JwtValidator& validator) const override;
+
+ private:
+  using Entry = std::pair<std::string, crypto::tink::RawJwt>;
+
+  std::unique_ptr<crypto::tink::JwtPublicKeyVerify> verify_;
+  const size_t max_cached_tokens_;
+
+  mutable absl::Mutex mutex_;
+  // Most recently seen token first.
+  mutable std::list<Entry> lru_ ABSL_GUARDED_BY(mutex_);
+  mutable std::unordered_map<std::string, std::list<Entry>::iterator> entries_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace jwt_internal
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_JWT_INTERNAL_CACHED_JWT_PUBLIC_KEY_VERIFY_H_
@@ -0,0 +1,212 @@
+// Copyright 2021 Google LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/jwt/internal/cached_jwt_public_key_verify.h"
+
+#include <string>
+#include <utility>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "tink/jwt/internal/jwt_public_key_sign_impl.h"
+#include "tink/jwt/internal/jwt_public_key_verify_impl.h"
+#include "tink/jwt/jwt_public_key_sign.h"
+#include "tink/jwt/jwt_public_key_verify.h"
+#include "tink/jwt/jwt_validator.h"
+#include "tink/jwt/raw_jwt.h"
+#include "tink/jwt/verified_jwt.h"
+#include "tink/subtle/ecdsa_sign_boringssl.h"
+#include "tink/subtle/ecdsa_verify_boringssl.h"
+#include "tink/util/test_matchers.h"
+
+using ::crypto::tink::test::IsOk;
+using ::crypto::tink::test::IsOkAndHolds;
+
+namespace crypto {
+namespace tink {
+namespace jwt_internal {
+
+namespace {
+
+// Forwards to an inner JwtPublicKeyVerify and counts the calls, so tests
+// can tell whether a verification was served from the cache.
+class CountingJwtPublicKeyVerify : public JwtPublicKeyVerify {
+ public:
+  explicit CountingJwtPublicKeyVerify(
+      std::unique_ptr<JwtPublicKeyVerify> verify)
+      : verify_(std::move(verify)) {}
+
+  util::StatusOr<VerifiedJwt> VerifyAndDecode(
+      absl::string_view compact,
+      const JwtValidator& validator) const override {
+    call_count_++;
+    return verify_->VerifyAndDecode(compact, validator);
+  }
+
+  int call_count() const { return call_count_; }
+
+ private:
+  std::unique_ptr<JwtPublicKeyVerify> verify_;
+  mutable int call_count_ = 0;
+};
+
+class CachedJwtPublicKeyVerifyTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    auto ec_key_result = subtle::SubtleUtilBoringSSL::GetNewEcKey(
+        subtle::EllipticCurveType::NIST_P256);
+    ASSERT_THAT(ec_key_result.status(), IsOk());
+    auto ec_key = ec_key_result.ValueOrDie();
+
+    auto sign_result = subtle::EcdsaSignBoringSsl::New(
+        ec_key, subtle::HashType::SHA256,
+        subtle::EcdsaSignatureEncoding::IEEE_P1363);
+    ASSERT_THAT(sign_result.status(), IsOk());
+
+    auto verify_result = subtle::EcdsaVerifyBoringSsl::New(
+        ec_key, subtle::HashType::SHA256,
+        subtle::EcdsaSignatureEncoding::IEEE_P1363);
+    ASSERT_THAT(verify_result.status(), IsOk());
+
+    jwt_sign_ = absl::make_unique<JwtPublicKeySignImpl>(
+        std::move(sign_result.ValueOrDie()), "ES256", absl::nullopt);
+    auto counting_verify = absl::make_unique<CountingJwtPublicKeyVerify>(
+        absl::make_unique<JwtPublicKeyVerifyImpl>(
+            std::move(verify_result.ValueOrDie()), "ES256"));
+    counting_verify_ = counting_verify.get();
+    jwt_verify_ = absl::make_unique<CachedJwtPublicKeyVerify>(
+        std::move(counting_verify), /*max_cached_tokens=*/2);
+  }
+
+  util::StatusOr<std::string> CreateToken(absl::string_view jwt_id,
+                                          absl::Time expiration) {
+    util::StatusOr<RawJwt> raw_jwt_or = RawJwtBuilder()
+                                            .SetJwtId(std::string(jwt_id))
+                                            .SetExpiration(expiration)
+                                            .Build();
+    if (!raw_jwt_or.ok()) {
+      return raw_jwt_or.status();
+    }
+    return jwt_sign_->SignAndEncodeWithKid(raw_jwt_or.ValueOrDie(),
+                                           absl::nullopt);
+  }
+
+  std::unique_ptr<JwtPublicKeySignImpl> jwt_sign_;
+  std::unique_ptr<CachedJwtPublicKeyVerify> jwt_verify_;
+  CountingJwtPublicKeyVerify* counting_verify_;
+};
+
+TEST_F(CachedJwtPublicKeyVerifyTest, RepeatedTokenVerifiedOnce) {
+  util::StatusOr<std::string> compact_or =
+      CreateToken("id123", absl::Now() + absl::Seconds(300));
+  ASSERT_THAT(compact_or.status(), IsOk());
+  std::string compact = compact_or.ValueOrDie();
+
+  JwtValidator validator = JwtValidatorBuilder().Build().ValueOrDie();
+
+  util::StatusOr<VerifiedJwt> verified_jwt_or =
+      jwt_verify_->VerifyAndDecode(compact, validator);
+  ASSERT_THAT(verified_jwt_or.status(), IsOk());
+  EXPECT_THAT(verified_jwt_or.ValueOrDie().GetJwtId(), IsOkAndHolds("id123"));
+  EXPECT_EQ(counting_verify_->call_count(), 1);
+
+  verified_jwt_or = jwt_verify_->VerifyAndDecode(compact, validator);
+  ASSERT_THAT(verified_jwt_or.status(), IsOk());
+  EXPECT_THAT(verified_jwt_or.ValueOrDie().GetJwtId(), IsOkAndHolds("id123"));
+  EXPECT_EQ(counting_verify_->call_count(), 1);
+}
+
+TEST_F(CachedJwtPublicKeyVerifyTest, CachedTokenValidatedWithEachValidator) {
+  util::StatusOr<std::string> compact_or =
+      CreateToken("id123", absl::Now() + absl::Seconds(300));
+  ASSERT_THAT(compact_or.status(), IsOk());
+  std::string compact = compact_or.ValueOrDie();
+
+  JwtValidator validator = JwtValidatorBuilder().Build().ValueOrDie();
+  ASSERT_THAT(jwt_verify_->VerifyAndDecode(compact, validator).status(),
+              IsOk());
+
+  // A cache hit must still fail claim validation with a stricter validator.
+  JwtValidator issuer_validator =
+      JwtValidatorBuilder().ExpectIssuer("unknown").Build().ValueOrDie();
+  EXPECT_FALSE(jwt_verify_->VerifyAndDecode(compact, issuer_validator).ok());
+  EXPECT_EQ(counting_verify_->call_count(), 1);
+}
+
+TEST_F(CachedJwtPublicKeyVerifyTest, CachedTokenExpires) {
+  absl::Time now = absl::Now();
+  util::StatusOr<std::string> compact_or =
+      CreateToken("id123", now + absl::Seconds(300));
+  ASSERT_THAT(compact_or.status(), IsOk());
+  std::string compact = compact_or.ValueOrDie();
+
+  JwtValidator validator = JwtValidatorBuilder().Build().ValueOrDie();
+  ASSERT_THAT(jwt_verify_->VerifyAndDecode(compact, validator).status(),
+              IsOk());
+
+  // The cached entry must not outlive the expiration boundary.
+  JwtValidator later_validator = JwtValidatorBuilder()
+                                     .SetFixedNow(now + absl::Seconds(600))
+                                     .Build()
+                                     .ValueOrDie();
+  EXPECT_FALSE(jwt_verify_->VerifyAndDecode(compact, later_validator).ok());
+  EXPECT_EQ(counting_verify_->call_count(), 1);
+}
+
+TEST_F(CachedJwtPublicKeyVerifyTest, ModifiedTokenIsNotServedFromCache) {
+  util::StatusOr<std::string> compact_or =
+      CreateToken("id123", absl::Now() + absl::Seconds(300));
+  ASSERT_THAT(compact_or.status(), IsOk());
+  std::string compact = compact_or.ValueOrDie();
+
+  JwtValidator validator = JwtValidatorBuilder().Build().ValueOrDie();
+  ASSERT_THAT(jwt_verify_->VerifyAndDecode(compact, validator).status(),
+              IsOk());
+
+  std::string modified = compact;
+  modified[modified.size() - 1] ^= 1;
+  EXPECT_FALSE(jwt_verify_->VerifyAndDecode(modified, validator).ok());
+}
+
+TEST_F(CachedJwtPublicKeyVerifyTest, EvictsLeastRecentlySeenToken) {
+  absl::Time expiration = absl::Now() + absl::Seconds(300);
+  std::string token1 = CreateToken("id1", expiration).ValueOrDie();
+  std::string token2 = CreateToken("id2", expiration).ValueOrDie();
+  std::string token3 = CreateToken("id3", expiration).ValueOrDie();
+
+  JwtValidator validator = JwtValidatorBuilder().Build().ValueOrDie();
+  // The cache holds 2 tokens; verifying a third evicts the least recently
+  // seen one.
+  ASSERT_THAT(jwt_verify_->VerifyAndDecode(token1, validator).status(),
+              IsOk());
+  ASSERT_THAT(jwt_verify_->VerifyAndDecode(token2, validator).status(),
+              IsOk());
+  ASSERT_THAT(jwt_verify_->VerifyAndDecode(token3, validator).status(),
+              IsOk());
+  EXPECT_EQ(counting_verify_->call_count(), 3);
+
+  ASSERT_THAT(jwt_verify_->VerifyAndDecode(token1, validator).status(),
+              IsOk());
+  EXPECT_EQ(counting_verify_->call_count(), 4);
+  ASSERT_THAT(jwt_verify_->VerifyAndDecode(token3, validator).status(),
+              IsOk());
+  EXPECT_EQ(counting_verify_->call_count(), 4);
+}
+
+}  // namespace
+}  // namespace jwt_internal
+}  // namespace tink
+}  // namespace crypto
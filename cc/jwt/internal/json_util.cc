@@ -16,9 +16,13 @@
 
 #include "tink/jwt/internal/json_util.h"
 
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
 #include <string>
 
 #include <google/protobuf/util/json_util.h>
+#include "absl/strings/str_cat.h"
 #include "absl/strings/substitute.h"
 
 namespace crypto {
@@ -27,16 +31,381 @@ namespace jwt_internal {
 
 namespace {
 
+// JWT payloads are parsed and serialized on every token operation, and
+// protobuf's reflective json_util processes them byte by byte. The fast
+// paths below handle the JSON that claim sets actually contain -- ASCII
+// strings, integral numbers, booleans, null and flat nesting -- by copying
+// maximal runs of plain characters in bulk. Anything outside that subset
+// (lenient syntax, unicode escapes, non-ASCII bytes, non-integral numbers,
+// deep nesting) falls back to the protobuf-based path, so accepted inputs
+// and produced outputs are unchanged.
+
+constexpr int kMaxFastDepth = 64;
+
 util::Status ConvertProtoStatus(const google::protobuf::util::Status& status) {
   return util::Status(static_cast<util::error::Code>(status.error_code()),
                                     std::string(status.message().data(), status.message().length()));
 }
 
+// True for bytes that may appear verbatim in a JSON string: printable
+// ASCII except '"' and '\'.
+bool IsPlainStringChar(unsigned char c) {
+  return c >= 0x20 && c < 0x7f && c != '"' && c != '\\';
+}
+
+// A recursive-descent parser for the strict-JSON subset described above.
+// Every Parse* method returns false to request a fallback to the protobuf
+// parser; it makes no attempt to distinguish invalid input from merely
+// lenient input, since the fallback handles both.
+class FastJsonParser {
+ public:
+  explicit FastJsonParser(absl::string_view input) : input_(input), pos_(0) {}
+
+  bool ParseStruct(google::protobuf::Struct* out) {
+    SkipWhitespace();
+    if (!ParseObject(out, /*depth=*/1)) {
+      return false;
+    }
+    SkipWhitespace();
+    return pos_ == input_.size();
+  }
+
+  bool ParseList(google::protobuf::ListValue* out) {
+    SkipWhitespace();
+    if (!ParseArray(out, /*depth=*/1)) {
+      return false;
+    }
+    SkipWhitespace();
+    return pos_ == input_.size();
+  }
+
+ private:
+  bool ParseObject(google::protobuf::Struct* out, int depth) {
+    if (depth > kMaxFastDepth || !Consume('{')) {
+      return false;
+    }
+    SkipWhitespace();
+    if (Consume('}')) {
+      return true;
+    }
+    auto* fields = out->mutable_fields();
+    while (true) {
+      SkipWhitespace();
+      std::string key;
+      if (!ParseString(&key)) {
+        return false;
+      }
+      SkipWhitespace();
+      if (!Consume(':')) {
+        return false;
+      }
+      SkipWhitespace();
+      // Leave duplicate-key handling to the protobuf parser.
+      if (fields->count(key) > 0 || !ParseValue(&(*fields)[key], depth)) {
+        return false;
+      }
+      SkipWhitespace();
+      if (Consume(',')) {
+        continue;
+      }
+      return Consume('}');
+    }
+  }
+
+  bool ParseArray(google::protobuf::ListValue* out, int depth) {
+    if (depth > kMaxFastDepth || !Consume('[')) {
+      return false;
+    }
+    SkipWhitespace();
+    if (Consume(']')) {
+      return true;
+    }
+    while (true) {
+      SkipWhitespace();
+      if (!ParseValue(out->add_values(), depth)) {
+        return false;
+      }
+      SkipWhitespace();
+      if (Consume(',')) {
+        continue;
+      }
+      return Consume(']');
+    }
+  }
+
+  bool ParseValue(google::protobuf::Value* out, int depth) {
+    if (pos_ == input_.size()) {
+      return false;
+    }
+    switch (input_[pos_]) {
+      case '{':
+        return ParseObject(out->mutable_struct_value(), depth + 1);
+      case '[':
+        return ParseArray(out->mutable_list_value(), depth + 1);
+      case '"':
+        return ParseString(out->mutable_string_value());
+      case 't':
+        if (!ConsumeLiteral("true")) {
+          return false;
+        }
+        out->set_bool_value(true);
+        return true;
+      case 'f':
+        if (!ConsumeLiteral("false")) {
+          return false;
+        }
+        out->set_bool_value(false);
+        return true;
+      case 'n':
+        if (!ConsumeLiteral("null")) {
+          return false;
+        }
+        out->set_null_value(google::protobuf::NULL_VALUE);
+        return true;
+      default:
+        return ParseNumber(out);
+    }
+  }
+
+  bool ParseString(std::string* out) {
+    if (!Consume('"')) {
+      return false;
+    }
+    while (true) {
+      // Copy the longest run of plain characters in one append.
+      size_t run_start = pos_;
+      while (pos_ < input_.size() &&
+             IsPlainStringChar(static_cast<unsigned char>(input_[pos_]))) {
+        pos_++;
+      }
+      out->append(input_.data() + run_start, pos_ - run_start);
+      if (pos_ == input_.size()) {
+        return false;
+      }
+      char c = input_[pos_];
+      if (c == '"') {
+        pos_++;
+        return true;
+      }
+      if (c != '\\' || pos_ + 1 == input_.size()) {
+        // Control characters, DEL and non-ASCII bytes are left to the
+        // protobuf parser, which validates UTF-8.
+        return false;
+      }
+      pos_++;
+      switch (input_[pos_]) {
+        case '"': out->push_back('"'); break;
+        case '\\': out->push_back('\\'); break;
+        case '/': out->push_back('/'); break;
+        case 'b': out->push_back('\b'); break;
+        case 'f': out->push_back('\f'); break;
+        case 'n': out->push_back('\n'); break;
+        case 'r': out->push_back('\r'); break;
+        case 't': out->push_back('\t'); break;
+        default:
+          // \uXXXX escapes (and invalid escapes) take the fallback.
+          return false;
+      }
+      pos_++;
+    }
+  }
+
+  bool ParseNumber(google::protobuf::Value* out) {
+    size_t start = pos_;
+    if (pos_ < input_.size() && input_[pos_] == '-') {
+      pos_++;
+    }
+    if (!ConsumeDigits()) {
+      return false;
+    }
+    if (pos_ < input_.size() && input_[pos_] == '.') {
+      pos_++;
+      if (!ConsumeDigits()) {
+        return false;
+      }
+    }
+    if (pos_ < input_.size() && (input_[pos_] == 'e' || input_[pos_] == 'E')) {
+      pos_++;
+      if (pos_ < input_.size() &&
+          (input_[pos_] == '+' || input_[pos_] == '-')) {
+        pos_++;
+      }
+      if (!ConsumeDigits()) {
+        return false;
+      }
+    }
+    std::string token(input_.data() + start, pos_ - start);
+    char* end = nullptr;
+    double value = std::strtod(token.c_str(), &end);
+    if (end != token.c_str() + token.size() || !std::isfinite(value)) {
+      return false;
+    }
+    out->set_number_value(value);
+    return true;
+  }
+
+  bool ConsumeDigits() {
+    size_t start = pos_;
+    while (pos_ < input_.size() && input_[pos_] >= '0' && input_[pos_] <= '9') {
+      pos_++;
+    }
+    return pos_ > start;
+  }
+
+  bool Consume(char c) {
+    if (pos_ < input_.size() && input_[pos_] == c) {
+      pos_++;
+      return true;
+    }
+    return false;
+  }
+
+  bool ConsumeLiteral(absl::string_view literal) {
+    if (input_.substr(pos_, literal.size()) != literal) {
+      return false;
+    }
+    pos_ += literal.size();
+    return true;
+  }
+
+  void SkipWhitespace() {
+    while (pos_ < input_.size() &&
+           (input_[pos_] == ' ' || input_[pos_] == '\t' ||
+            input_[pos_] == '\n' || input_[pos_] == '\r')) {
+      pos_++;
+    }
+  }
+
+  absl::string_view input_;
+  size_t pos_;
+};
+
+// The Append* functions below serialize the same subset directly into a
+// string; they return false to request a fallback to MessageToJsonString,
+// leaving 'out' in an unspecified state.
+
+bool AppendJsonString(const std::string& value, std::string* out) {
+  out->push_back('"');
+  size_t pos = 0;
+  while (true) {
+    size_t run_start = pos;
+    while (pos < value.size() &&
+           IsPlainStringChar(static_cast<unsigned char>(value[pos]))) {
+      pos++;
+    }
+    out->append(value, run_start, pos - run_start);
+    if (pos == value.size()) {
+      out->push_back('"');
+      return true;
+    }
+    char c = value[pos];
+    if (c == '"') {
+      out->append("\\\"");
+    } else if (c == '\\') {
+      out->append("\\\\");
+    } else {
+      // Control characters and non-ASCII bytes are escaped by the
+      // protobuf serializer; keep its behavior by falling back.
+      return false;
+    }
+    pos++;
+  }
+}
+
+bool AppendJsonNumber(double value, std::string* out) {
+  // Claim numbers are almost always integral timestamps; print those
+  // directly and leave protobuf's shortest-round-trip formatting to
+  // handle everything else.
+  if (!std::isfinite(value) || value != std::floor(value) ||
+      std::abs(value) > 9007199254740992.0 /* 2^53 */ ||
+      (value == 0 && std::signbit(value))) {
+    return false;
+  }
+  absl::StrAppend(out, static_cast<int64_t>(value));
+  return true;
+}
+
+bool AppendJsonStruct(const google::protobuf::Struct& proto, std::string* out,
+                      int depth);
+
+bool AppendJsonList(const google::protobuf::ListValue& proto, std::string* out,
+                    int depth);
+
+bool AppendJsonValue(const google::protobuf::Value& value, std::string* out,
+                     int depth) {
+  switch (value.kind_case()) {
+    case google::protobuf::Value::kNullValue:
+      out->append("null");
+      return true;
+    case google::protobuf::Value::kBoolValue:
+      out->append(value.bool_value() ? "true" : "false");
+      return true;
+    case google::protobuf::Value::kNumberValue:
+      return AppendJsonNumber(value.number_value(), out);
+    case google::protobuf::Value::kStringValue:
+      return AppendJsonString(value.string_value(), out);
+    case google::protobuf::Value::kStructValue:
+      return AppendJsonStruct(value.struct_value(), out, depth + 1);
+    case google::protobuf::Value::kListValue:
+      return AppendJsonList(value.list_value(), out, depth + 1);
+    default:
+      return false;
+  }
+}
+
+bool AppendJsonStruct(const google::protobuf::Struct& proto, std::string* out,
+                      int depth) {
+  if (depth > kMaxFastDepth) {
+    return false;
+  }
+  out->push_back('{');
+  bool first = true;
+  for (const auto& field : proto.fields()) {
+    if (!first) {
+      out->push_back(',');
+    }
+    first = false;
+    if (!AppendJsonString(field.first, out)) {
+      return false;
+    }
+    out->push_back(':');
+    if (!AppendJsonValue(field.second, out, depth)) {
+      return false;
+    }
+  }
+  out->push_back('}');
+  return true;
+}
+
+bool AppendJsonList(const google::protobuf::ListValue& proto, std::string* out,
+                    int depth) {
+  if (depth > kMaxFastDepth) {
+    return false;
+  }
+  out->push_back('[');
+  bool first = true;
+  for (const google::protobuf::Value& value : proto.values()) {
+    if (!first) {
+      out->push_back(',');
+    }
+    first = false;
+    if (!AppendJsonValue(value, out, depth)) {
+      return false;
+    }
+  }
+  out->push_back(']');
+  return true;
+}
+
 }  // namespace
 
 util::StatusOr<google::protobuf::Struct> JsonStringToProtoStruct(
     absl::string_view json_string) {
   google::protobuf::Struct proto;
+  if (FastJsonParser(json_string).ParseStruct(&proto)) {
+    return proto;
+  }
+  proto.Clear();
   google::protobuf::util::JsonParseOptions json_parse_options;
   auto status = google::protobuf::util::JsonStringToMessage(google::protobuf::StringPiece(json_string.data(), json_string.length()), &proto,
                                                   json_parse_options);
@@ -49,6 +418,10 @@ util::StatusOr<google::protobuf::Struct> JsonStringToProtoStruct(
 util::StatusOr<google::protobuf::ListValue> JsonStringToProtoList(
     absl::string_view json_string) {
   google::protobuf::ListValue proto;
+  if (FastJsonParser(json_string).ParseList(&proto)) {
+    return proto;
+  }
+  proto.Clear();
   google::protobuf::util::JsonParseOptions json_parse_options;
   auto status = google::protobuf::util::JsonStringToMessage(google::protobuf::StringPiece(json_string.data(), json_string.length()), &proto,
                                                   json_parse_options);
@@ -61,6 +434,10 @@ util::StatusOr<google::protobuf::ListValue> JsonStringToProtoList(
 util::StatusOr<std::string> ProtoStructToJsonString(
     const google::protobuf::Struct& proto) {
   std::string output;
+  if (AppendJsonStruct(proto, &output, /*depth=*/1)) {
+    return output;
+  }
+  output.clear();
   auto status = google::protobuf::util::MessageToJsonString(proto, &output);
   if (!status.ok()) {
     return ConvertProtoStatus(status);
@@ -71,6 +448,10 @@ util::StatusOr<std::string> ProtoStructToJsonString(
 util::StatusOr<std::string> ProtoListToJsonString(
     const google::protobuf::ListValue& proto) {
   std::string output;
+  if (AppendJsonList(proto, &output, /*depth=*/1)) {
+    return output;
+  }
+  output.clear();
   auto status = google::protobuf::util::MessageToJsonString(proto, &output);
   if (!status.ok()) {
     return ConvertProtoStatus(status);
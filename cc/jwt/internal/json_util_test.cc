@@ -68,6 +68,65 @@ TEST(JsonUtil, ParseThenSerializeListOk) {
               IsOkAndHolds(R"(["hello","world",42,true])"));
 }
 
+TEST(JsonUtil, ParseThenSerializeStructWithEscapesOk) {
+  util::StatusOr<Struct> proto =
+      JsonStringToProtoStruct(R"({"some_key":"a\"b\\c"})");
+  ASSERT_THAT(proto.status(), IsOk());
+
+  auto it = proto->fields().find("some_key");
+  ASSERT_TRUE(it != proto->fields().end());
+  EXPECT_EQ(it->second.string_value(), "a\"b\\c");
+  ASSERT_THAT(ProtoStructToJsonString(*proto),
+              IsOkAndHolds(R"({"some_key":"a\"b\\c"})"));
+}
+
+TEST(JsonUtil, ParseThenSerializeNestedStructOk) {
+  util::StatusOr<Struct> proto =
+      JsonStringToProtoStruct(R"({"a":{"b":[1,-2,3]}})");
+  ASSERT_THAT(proto.status(), IsOk());
+
+  ASSERT_THAT(ProtoStructToJsonString(*proto),
+              IsOkAndHolds(R"({"a":{"b":[1,-2,3]}})"));
+}
+
+TEST(JsonUtil, ParseStructWithWhitespaceOk) {
+  util::StatusOr<Struct> proto =
+      JsonStringToProtoStruct(" { \"some_key\" :\t42 }\n");
+  ASSERT_THAT(proto.status(), IsOk());
+
+  ASSERT_THAT(ProtoStructToJsonString(*proto),
+              IsOkAndHolds(R"({"some_key":42})"));
+}
+
+TEST(JsonUtil, ParseThenSerializeNonIntegralNumberOk) {
+  util::StatusOr<Struct> proto =
+      JsonStringToProtoStruct(R"({"some_key":123.456})");
+  ASSERT_THAT(proto.status(), IsOk());
+
+  ASSERT_THAT(ProtoStructToJsonString(*proto),
+              IsOkAndHolds(R"({"some_key":123.456})"));
+}
+
+TEST(JsonUtil, UnicodeEscapeRoundTripOk) {
+  util::StatusOr<Struct> proto =
+      JsonStringToProtoStruct(R"({"some_key":"ä"})");
+  ASSERT_THAT(proto.status(), IsOk());
+
+  auto it = proto->fields().find("some_key");
+  ASSERT_TRUE(it != proto->fields().end());
+  EXPECT_EQ(it->second.string_value(), "\xc3\xa4");
+
+  // The escape form of the output is not specified; re-parse it and
+  // compare the decoded value.
+  util::StatusOr<std::string> output = ProtoStructToJsonString(*proto);
+  ASSERT_THAT(output.status(), IsOk());
+  util::StatusOr<Struct> reparsed = JsonStringToProtoStruct(*output);
+  ASSERT_THAT(reparsed.status(), IsOk());
+  it = reparsed->fields().find("some_key");
+  ASSERT_TRUE(it != reparsed->fields().end());
+  EXPECT_EQ(it->second.string_value(), "\xc3\xa4");
+}
+
 TEST(JsonUtil, ParseInvalidStructTokenNotOk) {
   util::StatusOr<Struct> proto =
       JsonStringToProtoStruct(R"({"some_key":false)");
@@ -18,10 +18,11 @@
 
 #include <string>
 
-#include "absl/strings/escaping.h"
+#include "absl/base/internal/endian.h"
 #include "absl/strings/str_split.h"
 #include "tink/crypto_format.h"
 #include "tink/jwt/internal/json_util.h"
+#include "tink/subtle/base64_url.h"
 #include "proto/tink.pb.h"
 
 namespace crypto {
@@ -30,30 +31,12 @@ namespace jwt_internal {
 
 using ::google::crypto::tink::OutputPrefixType;
 
-namespace {
-
-bool isValidUrlsafeBase64Char(char c) {
-  return (((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) ||
-          ((c >= '0') && (c <= '9')) || ((c == '-') || (c == '_')));
-}
-
-bool StrictWebSafeBase64Unescape(absl::string_view src, std::string* dest) {
-  for (char c : src) {
-    if (!isValidUrlsafeBase64Char(c)) {
-      return false;
-    }
-  }
-  return absl::WebSafeBase64Unescape(src, dest);
-}
-
-}  // namespace
-
 std::string EncodeHeader(absl::string_view json_header) {
-  return absl::WebSafeBase64Escape(json_header);
+  return subtle::Base64UrlEncode(json_header);
 }
 
 bool DecodeHeader(absl::string_view header, std::string* json_header) {
-  return StrictWebSafeBase64Unescape(header, json_header);
+  return subtle::Base64UrlDecode(header, json_header);
 }
 
 absl::optional<std::string> GetKid(uint32_t key_id,
@@ -63,12 +46,12 @@ absl::optional<std::string> GetKid(uint32_t key_id,
   }
   char buffer[4];
   absl::big_endian::Store32(buffer, key_id);
-  return absl::WebSafeBase64Escape(absl::string_view(buffer, 4));
+  return subtle::Base64UrlEncode(absl::string_view(buffer, 4));
 }
 
 absl::optional<uint32_t> GetKeyId(absl::string_view kid) {
   std::string decoded_kid;
-  if (!StrictWebSafeBase64Unescape(kid, &decoded_kid)) {
+  if (!subtle::Base64UrlDecode(kid, &decoded_kid)) {
     return absl::nullopt;
   }
   if (decoded_kid.size() != 4) {
@@ -101,7 +84,7 @@ util::StatusOr<std::string> CreateHeader(
 
 util::Status ValidateHeader(const google::protobuf::Struct& header,
                             absl::string_view algorithm) {
-  auto fields = header.fields();
+  const auto& fields = header.fields();
   auto it = fields.find("alg");
   if (it == fields.end()) {
     return util::Status(util::error::INVALID_ARGUMENT, "header is missing alg");
@@ -134,20 +117,20 @@ absl::optional<std::string> GetTypeHeader(
 }
 
 std::string EncodePayload(absl::string_view json_payload) {
-  return absl::WebSafeBase64Escape(json_payload);
+  return subtle::Base64UrlEncode(json_payload);
 }
 
 bool DecodePayload(absl::string_view payload, std::string* json_payload) {
-  return StrictWebSafeBase64Unescape(payload, json_payload);
+  return subtle::Base64UrlDecode(payload, json_payload);
 }
 
 std::string EncodeSignature(absl::string_view signature) {
-  return absl::WebSafeBase64Escape(signature);
+  return subtle::Base64UrlEncode(signature);
 }
 
 bool DecodeSignature(absl::string_view encoded_signature,
                      std::string* signature) {
-  return StrictWebSafeBase64Unescape(encoded_signature, signature);
+  return subtle::Base64UrlDecode(encoded_signature, signature);
 }
 
 util::StatusOr<RawJwt> RawJwtParser::FromJson(
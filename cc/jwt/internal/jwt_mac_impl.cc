@@ -45,10 +45,34 @@ util::StatusOr<std::string> JwtMacImpl::ComputeMacAndEncodeWithKid(
     }
     kid = *custom_kid_;
   }
-  util::StatusOr<std::string> encoded_header =
-      CreateHeader(algorithm_, type_header, kid);
-  if (!encoded_header.ok()) {
-    return encoded_header.status();
+  std::string encoded_header;
+  if (!type_header.has_value()) {
+    // Without a type header the encoded header is a function of alg and
+    // kid only, both fixed per key; serve it from the cache.
+    absl::MutexLock lock(&header_cache_mutex_);
+    if (!header_cache_valid_ || cached_kid_.has_value() != kid.has_value() ||
+        (kid.has_value() && *cached_kid_ != *kid)) {
+      util::StatusOr<std::string> header =
+          CreateHeader(algorithm_, absl::nullopt, kid);
+      if (!header.ok()) {
+        return header.status();
+      }
+      cached_encoded_header_ = *std::move(header);
+      if (kid.has_value()) {
+        cached_kid_ = std::string(*kid);
+      } else {
+        cached_kid_ = absl::nullopt;
+      }
+      header_cache_valid_ = true;
+    }
+    encoded_header = cached_encoded_header_;
+  } else {
+    util::StatusOr<std::string> header =
+        CreateHeader(algorithm_, type_header, kid);
+    if (!header.ok()) {
+      return header.status();
+    }
+    encoded_header = *std::move(header);
   }
   util::StatusOr<std::string> payload = token.GetJsonPayload();
   if (!payload.ok()) {
@@ -56,7 +80,7 @@ util::StatusOr<std::string> JwtMacImpl::ComputeMacAndEncodeWithKid(
   }
   std::string encoded_payload = EncodePayload(*payload);
   std::string unsigned_token =
-      absl::StrCat(*encoded_header, ".", encoded_payload);
+      absl::StrCat(encoded_header, ".", encoded_payload);
   util::StatusOr<std::string> tag = mac_->ComputeMac(unsigned_token);
   if (!tag.ok()) {
     return tag.status();
@@ -20,7 +20,9 @@
 #include <string>
 #include <utility>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "tink/jwt/internal/jwt_mac_internal.h"
 #include "tink/jwt/jwt_mac.h"
 #include "tink/jwt/jwt_validator.h"
@@ -58,6 +60,16 @@ class JwtMacImpl : public JwtMacInternal {
   std::unique_ptr<crypto::tink::Mac> mac_;
   std::string algorithm_;
   absl::optional<std::string> custom_kid_;
+  // Cache of the encoded protected header for tokens without a type
+  // header. The header then only depends on alg and kid, which are fixed
+  // per key, so it is built once instead of per token.
+  mutable absl::Mutex header_cache_mutex_;
+  mutable bool header_cache_valid_ ABSL_GUARDED_BY(header_cache_mutex_) =
+      false;
+  mutable absl::optional<std::string> cached_kid_
+      ABSL_GUARDED_BY(header_cache_mutex_);
+  mutable std::string cached_encoded_header_
+      ABSL_GUARDED_BY(header_cache_mutex_);
 };
 
 }  // namespace jwt_internal
@@ -80,7 +80,11 @@ util::StatusOr<crypto::tink::VerifiedJwt> JwtMacSetWrapper::VerifyMacAndDecode(
     const crypto::tink::JwtValidator& validator) const {
   absl::optional<util::Status> interesting_status;
   for (const auto* mac_entry : jwt_mac_set_->get_all()) {
-    JwtMacInternal& jwt_mac = mac_entry->get_primitive();
+    auto jwt_mac_or = mac_entry->primitive_or_status();
+    // Skip entries whose lazy materialization failed; other keys may still
+    // verify the token.
+    if (!jwt_mac_or.ok()) continue;
+    JwtMacInternal& jwt_mac = *jwt_mac_or.ValueOrDie();
     auto verified_jwt_or = jwt_mac.VerifyMacAndDecode(compact, validator);
     if (verified_jwt_or.ok()) {
       return verified_jwt_or;
@@ -43,10 +43,34 @@ util::StatusOr<std::string> JwtPublicKeySignImpl::SignAndEncodeWithKid(
     }
     kid = *custom_kid_;
   }
-  util::StatusOr<std::string> encoded_header =
-      CreateHeader(algorithm_, type_header, kid);
-  if (!encoded_header.ok()) {
-    return encoded_header.status();
+  std::string encoded_header;
+  if (!type_header.has_value()) {
+    // Without a type header the encoded header is a function of alg and
+    // kid only, both fixed per key; serve it from the cache.
+    absl::MutexLock lock(&header_cache_mutex_);
+    if (!header_cache_valid_ || cached_kid_.has_value() != kid.has_value() ||
+        (kid.has_value() && *cached_kid_ != *kid)) {
+      util::StatusOr<std::string> header =
+          CreateHeader(algorithm_, absl::nullopt, kid);
+      if (!header.ok()) {
+        return header.status();
+      }
+      cached_encoded_header_ = *std::move(header);
+      if (kid.has_value()) {
+        cached_kid_ = std::string(*kid);
+      } else {
+        cached_kid_ = absl::nullopt;
+      }
+      header_cache_valid_ = true;
+    }
+    encoded_header = cached_encoded_header_;
+  } else {
+    util::StatusOr<std::string> header =
+        CreateHeader(algorithm_, type_header, kid);
+    if (!header.ok()) {
+      return header.status();
+    }
+    encoded_header = *std::move(header);
   }
   util::StatusOr<std::string> payload_or = token.GetJsonPayload();
   if (!payload_or.ok()) {
@@ -54,7 +78,7 @@ util::StatusOr<std::string> JwtPublicKeySignImpl::SignAndEncodeWithKid(
   }
   std::string encoded_payload = EncodePayload(payload_or.ValueOrDie());
   std::string unsigned_token =
-      absl::StrCat(*encoded_header, ".", encoded_payload);
+      absl::StrCat(encoded_header, ".", encoded_payload);
   util::StatusOr<std::string> tag_or = sign_->Sign(unsigned_token);
   if (!tag_or.ok()) {
     return tag_or.status();
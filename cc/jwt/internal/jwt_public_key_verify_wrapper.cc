@@ -68,7 +68,11 @@ JwtPublicKeyVerifySetWrapper::VerifyAndDecode(
     const crypto::tink::JwtValidator& validator) const {
   absl::optional<util::Status> interesting_status;
   for (const auto* entry : jwt_verify_set_->get_all()) {
-    JwtPublicKeyVerify& jwt_verify = entry->get_primitive();
+    auto jwt_verify_or = entry->primitive_or_status();
+    // Skip entries whose lazy materialization failed; other keys may still
+    // verify the token.
+    if (!jwt_verify_or.ok()) continue;
+    JwtPublicKeyVerify& jwt_verify = *jwt_verify_or.ValueOrDie();
     auto verified_jwt_or = jwt_verify.VerifyAndDecode(compact, validator);
     if (verified_jwt_or.ok()) {
       return verified_jwt_or;
@@ -16,8 +16,9 @@
 
 #include "tink/jwt/jwt_validator.h"
 
-#include <algorithm>
+#include <cstring>
 #include <string>
+#include <vector>
 
 namespace crypto {
 namespace tink {
@@ -26,20 +27,51 @@ namespace {
 
 static constexpr absl::Duration kJwtMaxClockSkew = absl::Minutes(10);
 
+// Claim equality on the validation hot path. The expected value is interned
+// in the check plan at construction; the actual value is a view into the
+// parsed token, so no per-token strings are allocated. Length first, then a
+// single memcmp.
+bool ClaimEquals(absl::string_view expected, absl::string_view actual) {
+  return expected.size() == actual.size() &&
+         (expected.empty() ||
+          std::memcmp(expected.data(), actual.data(), expected.size()) == 0);
 }
 
+}  // namespace
+
 JwtValidator::JwtValidator(const JwtValidatorBuilder& builder) {
-  expected_type_header_ = builder.expected_type_header_;
-  expected_issuer_ = builder.expected_issuer_;
-  expected_subject_ = builder.expected_subject_;
-  expected_audience_ = builder.expected_audience_;
-  ignore_type_header_ = builder.ignore_type_header_;
-  ignore_issuer_ = builder.ignore_issuer_;
-  ignore_subject_ = builder.ignore_subject_;
-  ignore_audiences_ = builder.ignore_audiences_;
-  allow_missing_expiration_ = builder.allow_missing_expiration_;
   clock_skew_ = builder.clock_skew_;
   fixed_now_ = builder.fixed_now_;
+  // The checks are appended in the order in which they were previously
+  // evaluated, so which error is reported first does not change.
+  if (!builder.allow_missing_expiration_) {
+    plan_.push_back(Check{CheckKind::kRequireExpiration, ""});
+  }
+  plan_.push_back(Check{CheckKind::kExpiration, ""});
+  plan_.push_back(Check{CheckKind::kNotBefore, ""});
+  if (builder.expected_type_header_.has_value()) {
+    plan_.push_back(
+        Check{CheckKind::kExpectTypeHeader, *builder.expected_type_header_});
+  } else if (!builder.ignore_type_header_) {
+    plan_.push_back(Check{CheckKind::kRejectTypeHeader, ""});
+  }
+  if (builder.expected_issuer_.has_value()) {
+    plan_.push_back(Check{CheckKind::kExpectIssuer, *builder.expected_issuer_});
+  } else if (!builder.ignore_issuer_) {
+    plan_.push_back(Check{CheckKind::kRejectIssuer, ""});
+  }
+  if (builder.expected_subject_.has_value()) {
+    plan_.push_back(
+        Check{CheckKind::kExpectSubject, *builder.expected_subject_});
+  } else if (!builder.ignore_subject_) {
+    plan_.push_back(Check{CheckKind::kRejectSubject, ""});
+  }
+  if (builder.expected_audience_.has_value()) {
+    plan_.push_back(
+        Check{CheckKind::kExpectAudience, *builder.expected_audience_});
+  } else if (!builder.ignore_audiences_) {
+    plan_.push_back(Check{CheckKind::kRejectAudiences, ""});
+  }
 }
 
 util::Status JwtValidator::Validate(RawJwt const& raw_jwt) const {
@@ -49,105 +81,131 @@ util::Status JwtValidator::Validate(RawJwt const& raw_jwt) const {
   } else {
     now = absl::Now();
   }
-  if (!raw_jwt.HasExpiration() && !allow_missing_expiration_) {
-    return util::Status(util::error::INVALID_ARGUMENT,
-                        "token does not have an expiration set");
-  }
-  if (raw_jwt.HasExpiration()) {
-    auto expiration_or = raw_jwt.GetExpiration();
-    if (!expiration_or.ok()) {
-      return expiration_or.status();
-    }
-    if (expiration_or.ValueOrDie() <= now - clock_skew_) {
-      return util::Status(util::error::INVALID_ARGUMENT, "token has expired");
-    }
-  }
-  if (raw_jwt.HasNotBefore()) {
-    auto not_before_or = raw_jwt.GetNotBefore();
-    if (!not_before_or.ok()) {
-      return not_before_or.status();
-    }
-    if (not_before_or.ValueOrDie() > now + clock_skew_) {
-      return util::Status(util::error::INVALID_ARGUMENT,
-                        "token cannot yet be used");
-    }
-  }
-  if (expected_type_header_.has_value()) {
-    if (!raw_jwt.HasTypeHeader()) {
-      return util::Status(util::error::INVALID_ARGUMENT,
-                          "missing expected type header");
-    }
-    auto type_header_or = raw_jwt.GetTypeHeader();
-    if (!type_header_or.ok()) {
-      return type_header_or.status();
-    }
-    if (expected_type_header_.value() != type_header_or.ValueOrDie()) {
-      return util::Status(util::error::INVALID_ARGUMENT, "wrong type header");
-    }
-  } else {
-    if (raw_jwt.HasTypeHeader() && !ignore_type_header_) {
-      return util::Status(
-          util::error::INVALID_ARGUMENT,
-          "invalid JWT; token has type header set, but validator not");
-    }
-  }
-  if (expected_issuer_.has_value()){
-    if (!raw_jwt.HasIssuer()) {
-      return util::Status(util::error::INVALID_ARGUMENT,
-                          "missing expected issuer");
-    }
-    auto issuer_or = raw_jwt.GetIssuer();
-    if (!issuer_or.ok()) {
-      return issuer_or.status();
-    }
-    if (expected_issuer_.value() != issuer_or.ValueOrDie()) {
-      return util::Status(util::error::INVALID_ARGUMENT, "wrong issuer");
-    }
-  } else {
-    if (raw_jwt.HasIssuer() && !ignore_issuer_) {
-      return util::Status(
-          util::error::INVALID_ARGUMENT,
-          "invalid JWT; token has issuer set, but validator not");
-    }
-  }
-  if (expected_subject_.has_value()) {
-    if (!raw_jwt.HasSubject()) {
-      return util::Status(util::error::INVALID_ARGUMENT,
-                          "missing expected subject");
-    }
-    auto subject_or = raw_jwt.GetSubject();
-    if (!subject_or.ok()) {
-      return subject_or.status();
-    }
-    if (expected_subject_.value() != subject_or.ValueOrDie()) {
-      return util::Status(util::error::INVALID_ARGUMENT, "wrong subject");
-    }
-  } else {
-    if (raw_jwt.HasSubject() && !ignore_subject_) {
-      return util::Status(
-          util::error::INVALID_ARGUMENT,
-          "invalid JWT; token has subject set, but validator not");
-    }
-  }
-  if (expected_audience_.has_value()) {
-    if (!raw_jwt.HasAudiences()) {
-      return util::Status(util::error::INVALID_ARGUMENT,
-                          "missing expected audiences");
-    }
-    auto audiences_or = raw_jwt.GetAudiences();
-    if (!audiences_or.ok()) {
-      return audiences_or.status();
-    }
-    std::vector<std::string> audiences = audiences_or.ValueOrDie();
-    auto it = std::find(audiences.begin(), audiences.end(), expected_audience_);
-    if (it == audiences.end()) {
-      return util::Status(util::error::INVALID_ARGUMENT, "audience not found");
-    }
-  } else {
-    if (raw_jwt.HasAudiences() && !ignore_audiences_) {
-      return util::Status(
-          util::error::INVALID_ARGUMENT,
-          "invalid JWT; token has audience set, but validator not");
+  // Leeway is applied to the cutoffs once, not per comparison.
+  const absl::Time expiration_cutoff = now - clock_skew_;
+  const absl::Time not_before_cutoff = now + clock_skew_;
+  for (const Check& check : plan_) {
+    switch (check.kind) {
+      case CheckKind::kRequireExpiration:
+        if (!raw_jwt.HasExpiration()) {
+          return util::Status(util::error::INVALID_ARGUMENT,
+                              "token does not have an expiration set");
+        }
+        break;
+      case CheckKind::kExpiration: {
+        if (!raw_jwt.HasExpiration()) {
+          break;
+        }
+        auto expiration_or = raw_jwt.GetExpiration();
+        if (!expiration_or.ok()) {
+          return expiration_or.status();
+        }
+        if (expiration_or.ValueOrDie() <= expiration_cutoff) {
+          return util::Status(util::error::INVALID_ARGUMENT,
+                              "token has expired");
+        }
+        break;
+      }
+      case CheckKind::kNotBefore: {
+        if (!raw_jwt.HasNotBefore()) {
+          break;
+        }
+        auto not_before_or = raw_jwt.GetNotBefore();
+        if (!not_before_or.ok()) {
+          return not_before_or.status();
+        }
+        if (not_before_or.ValueOrDie() > not_before_cutoff) {
+          return util::Status(util::error::INVALID_ARGUMENT,
+                              "token cannot yet be used");
+        }
+        break;
+      }
+      case CheckKind::kExpectTypeHeader: {
+        if (!raw_jwt.HasTypeHeader()) {
+          return util::Status(util::error::INVALID_ARGUMENT,
+                              "missing expected type header");
+        }
+        auto type_header_or = raw_jwt.GetTypeHeaderView();
+        if (!type_header_or.ok()) {
+          return type_header_or.status();
+        }
+        if (!ClaimEquals(check.expected, type_header_or.ValueOrDie())) {
+          return util::Status(util::error::INVALID_ARGUMENT,
+                              "wrong type header");
+        }
+        break;
+      }
+      case CheckKind::kRejectTypeHeader:
+        if (raw_jwt.HasTypeHeader()) {
+          return util::Status(
+              util::error::INVALID_ARGUMENT,
+              "invalid JWT; token has type header set, but validator not");
+        }
+        break;
+      case CheckKind::kExpectIssuer: {
+        if (!raw_jwt.HasIssuer()) {
+          return util::Status(util::error::INVALID_ARGUMENT,
+                              "missing expected issuer");
+        }
+        auto issuer_or = raw_jwt.GetIssuerView();
+        if (!issuer_or.ok()) {
+          return issuer_or.status();
+        }
+        if (!ClaimEquals(check.expected, issuer_or.ValueOrDie())) {
+          return util::Status(util::error::INVALID_ARGUMENT, "wrong issuer");
+        }
+        break;
+      }
+      case CheckKind::kRejectIssuer:
+        if (raw_jwt.HasIssuer()) {
+          return util::Status(
+              util::error::INVALID_ARGUMENT,
+              "invalid JWT; token has issuer set, but validator not");
+        }
+        break;
+      case CheckKind::kExpectSubject: {
+        if (!raw_jwt.HasSubject()) {
+          return util::Status(util::error::INVALID_ARGUMENT,
+                              "missing expected subject");
+        }
+        auto subject_or = raw_jwt.GetSubjectView();
+        if (!subject_or.ok()) {
+          return subject_or.status();
+        }
+        if (!ClaimEquals(check.expected, subject_or.ValueOrDie())) {
+          return util::Status(util::error::INVALID_ARGUMENT, "wrong subject");
+        }
+        break;
+      }
+      case CheckKind::kRejectSubject:
+        if (raw_jwt.HasSubject()) {
+          return util::Status(
+              util::error::INVALID_ARGUMENT,
+              "invalid JWT; token has subject set, but validator not");
+        }
+        break;
+      case CheckKind::kExpectAudience: {
+        if (!raw_jwt.HasAudiences()) {
+          return util::Status(util::error::INVALID_ARGUMENT,
+                              "missing expected audiences");
+        }
+        auto contains_or = raw_jwt.ContainsAudience(check.expected);
+        if (!contains_or.ok()) {
+          return contains_or.status();
+        }
+        if (!contains_or.ValueOrDie()) {
+          return util::Status(util::error::INVALID_ARGUMENT,
+                              "audience not found");
+        }
+        break;
+      }
+      case CheckKind::kRejectAudiences:
+        if (raw_jwt.HasAudiences()) {
+          return util::Status(
+              util::error::INVALID_ARGUMENT,
+              "invalid JWT; token has audience set, but validator not");
+        }
+        break;
     }
   }
   return util::OkStatus();
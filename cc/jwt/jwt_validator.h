@@ -18,6 +18,7 @@
 #define TINK_JWT_JWT_VALIDATOR_H_
 
 #include <string>
+#include <vector>
 
 #include "absl/strings/string_view.h"
 #include "absl/time/clock.h"
@@ -48,15 +49,30 @@ class JwtValidator {
  private:
   explicit JwtValidator(const JwtValidatorBuilder& builder);
   friend class JwtValidatorBuilder;
-  absl::optional<std::string> expected_type_header_;
-  absl::optional<std::string> expected_issuer_;
-  absl::optional<std::string> expected_subject_;
-  absl::optional<std::string> expected_audience_;
-  bool ignore_type_header_;
-  bool ignore_issuer_;
-  bool ignore_subject_;
-  bool ignore_audiences_;
-  bool allow_missing_expiration_;
+
+  // One precompiled claim check. The constructor builds a flat plan of
+  // the checks this validator actually requires, so Validate is a tight
+  // loop over a small vector instead of a chain of optional-field
+  // branches per token.
+  enum class CheckKind {
+    kRequireExpiration,  // token must have an expiration
+    kExpiration,         // a present expiration must not have passed
+    kNotBefore,          // a present not-before must not lie in the future
+    kExpectTypeHeader,   // type header must equal 'expected'
+    kRejectTypeHeader,   // token must not have a type header
+    kExpectIssuer,
+    kRejectIssuer,
+    kExpectSubject,
+    kRejectSubject,
+    kExpectAudience,     // audience list must contain 'expected'
+    kRejectAudiences,
+  };
+  struct Check {
+    CheckKind kind;
+    std::string expected;  // empty for checks without an expected value
+  };
+
+  std::vector<Check> plan_;
   absl::Duration clock_skew_;
   absl::optional<absl::Time> fixed_now_;
 };
@@ -65,7 +65,7 @@ bool HasClaimOfKind(const google::protobuf::Struct& json_proto,
   if (IsRegisteredClaimName(name)) {
     return false;
   }
-  auto fields = json_proto.fields();
+  const auto& fields = json_proto.fields();
   auto it = fields.find(std::string(name));
   if (it == fields.end()) {
     return false;
@@ -77,7 +77,7 @@ bool HasClaimOfKind(const google::protobuf::Struct& json_proto,
 // Returns true if the claim is present but not a string.
 bool ClaimIsNotAString(const google::protobuf::Struct& json_proto,
                        absl::string_view name) {
-  auto fields = json_proto.fields();
+  const auto& fields = json_proto.fields();
   auto it = fields.find(std::string(name));
   if (it == fields.end()) {
     return false;
@@ -89,7 +89,7 @@ bool ClaimIsNotAString(const google::protobuf::Struct& json_proto,
 // Returns true if the claim is present but not a timestamp.
 bool ClaimIsNotATimestamp(const google::protobuf::Struct& json_proto,
                           absl::string_view name) {
-  auto fields = json_proto.fields();
+  const auto& fields = json_proto.fields();
   auto it = fields.find(std::string(name));
   if (it == fields.end()) {
     return false;
@@ -177,8 +177,8 @@ RawJwt::RawJwt() {}
 
 RawJwt::RawJwt(absl::optional<std::string> type_header,
                google::protobuf::Struct json_proto) {
-  type_header_ = type_header;
-  json_proto_ = json_proto;
+  type_header_ = std::move(type_header);
+  json_proto_ = std::move(json_proto);
 }
 
 bool RawJwt::HasTypeHeader() const { return type_header_.has_value(); }
@@ -190,12 +190,19 @@ util::StatusOr<std::string> RawJwt::GetTypeHeader() const {
   return *type_header_;
 }
 
+util::StatusOr<absl::string_view> RawJwt::GetTypeHeaderView() const {
+  if (!type_header_.has_value()) {
+    return util::Status(util::error::INVALID_ARGUMENT, "No type header found");
+  }
+  return absl::string_view(*type_header_);
+}
+
 bool RawJwt::HasIssuer() const {
   return json_proto_.fields().contains(std::string(kJwtClaimIssuer));
 }
 
 util::StatusOr<std::string> RawJwt::GetIssuer() const {
-  auto fields = json_proto_.fields();
+  const auto& fields = json_proto_.fields();
   auto it = fields.find(std::string(kJwtClaimIssuer));
   if (it == fields.end()) {
     return util::Status(util::error::INVALID_ARGUMENT, "No Issuer found");
@@ -208,12 +215,26 @@ util::StatusOr<std::string> RawJwt::GetIssuer() const {
   return value.string_value();
 }
 
+util::StatusOr<absl::string_view> RawJwt::GetIssuerView() const {
+  const auto& fields = json_proto_.fields();
+  auto it = fields.find(std::string(kJwtClaimIssuer));
+  if (it == fields.end()) {
+    return util::Status(util::error::INVALID_ARGUMENT, "No Issuer found");
+  }
+  const google::protobuf::Value& value = it->second;
+  if (value.kind_case() != google::protobuf::Value::kStringValue) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "Issuer is not a string");
+  }
+  return absl::string_view(value.string_value());
+}
+
 bool RawJwt::HasSubject() const {
   return json_proto_.fields().contains(std::string(kJwtClaimSubject));
 }
 
 util::StatusOr<std::string> RawJwt::GetSubject() const {
-  auto fields = json_proto_.fields();
+  const auto& fields = json_proto_.fields();
   auto it = fields.find(std::string(kJwtClaimSubject));
   if (it == fields.end()) {
     return util::Status(util::error::INVALID_ARGUMENT, "No Subject found");
@@ -226,22 +247,37 @@ util::StatusOr<std::string> RawJwt::GetSubject() const {
   return value.string_value();
 }
 
+util::StatusOr<absl::string_view> RawJwt::GetSubjectView() const {
+  const auto& fields = json_proto_.fields();
+  auto it = fields.find(std::string(kJwtClaimSubject));
+  if (it == fields.end()) {
+    return util::Status(util::error::INVALID_ARGUMENT, "No Subject found");
+  }
+  const google::protobuf::Value& value = it->second;
+  if (value.kind_case() != google::protobuf::Value::kStringValue) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "Subject is not a string");
+  }
+  return absl::string_view(value.string_value());
+}
+
 bool RawJwt::HasAudiences() const {
   return json_proto_.fields().contains(std::string(kJwtClaimAudience));
 }
 
 util::StatusOr<std::vector<std::string>> RawJwt::GetAudiences() const {
-  auto fields = json_proto_.fields();
+  const auto& fields = json_proto_.fields();
   auto it = fields.find(std::string(kJwtClaimAudience));
   if (it == fields.end()) {
     return util::Status(util::error::NOT_FOUND, "No Audiences found");
   }
-  google::protobuf::Value list = it->second;
+  const google::protobuf::Value& list = it->second;
   if (list.kind_case() != google::protobuf::Value::kListValue) {
     return util::Status(util::error::INVALID_ARGUMENT,
                         "Audiences is not a list");
   }
   std::vector<std::string> audiences;
+  audiences.reserve(list.list_value().values_size());
   for (const auto& value : list.list_value().values()) {
     if (value.kind_case() != google::protobuf::Value::kStringValue) {
       return util::Status(
@@ -253,13 +289,37 @@ util::StatusOr<std::vector<std::string>> RawJwt::GetAudiences() const {
   return audiences;
 }
 
+util::StatusOr<bool> RawJwt::ContainsAudience(
+    absl::string_view audience) const {
+  const auto& fields = json_proto_.fields();
+  auto it = fields.find(std::string(kJwtClaimAudience));
+  if (it == fields.end()) {
+    return util::Status(util::error::NOT_FOUND, "No Audiences found");
+  }
+  const google::protobuf::Value& list = it->second;
+  if (list.kind_case() != google::protobuf::Value::kListValue) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "Audiences is not a list");
+  }
+  bool found = false;
+  for (const auto& value : list.list_value().values()) {
+    if (value.kind_case() != google::protobuf::Value::kStringValue) {
+      return util::Status(
+          util::error::INVALID_ARGUMENT,
+          "Audiences is not a list of strings");
+    }
+    if (absl::string_view(value.string_value()) == audience) found = true;
+  }
+  return found;
+}
+
 
 bool RawJwt::HasJwtId() const {
   return json_proto_.fields().contains(std::string(kJwtClaimJwtId));
 }
 
 util::StatusOr<std::string> RawJwt::GetJwtId() const {
-  auto fields = json_proto_.fields();
+  const auto& fields = json_proto_.fields();
   auto it = fields.find(std::string(kJwtClaimJwtId));
   if (it == fields.end()) {
     return util::Status(util::error::NOT_FOUND, "No JwtId found");
@@ -276,7 +336,7 @@ bool RawJwt::HasExpiration() const {
 }
 
 util::StatusOr<absl::Time> RawJwt::GetExpiration() const {
-  auto fields = json_proto_.fields();
+  const auto& fields = json_proto_.fields();
   auto it = fields.find(std::string(kJwtClaimExpiration));
   if (it == fields.end()) {
     return util::Status(util::error::NOT_FOUND, "No Expiration found");
@@ -294,7 +354,7 @@ bool RawJwt::HasNotBefore() const {
 }
 
 util::StatusOr<absl::Time> RawJwt::GetNotBefore() const {
-  auto fields = json_proto_.fields();
+  const auto& fields = json_proto_.fields();
   auto it = fields.find(std::string(kJwtClaimNotBefore));
   if (it == fields.end()) {
     return util::Status(util::error::NOT_FOUND, "No NotBefore found");
@@ -312,7 +372,7 @@ bool RawJwt::HasIssuedAt() const {
 }
 
 util::StatusOr<absl::Time> RawJwt::GetIssuedAt() const {
-  auto fields = json_proto_.fields();
+  const auto& fields = json_proto_.fields();
   auto it = fields.find(std::string(kJwtClaimIssuedAt));
   if (it == fields.end()) {
     return util::Status(util::error::NOT_FOUND, "No IssuedAt found");
@@ -339,7 +399,7 @@ util::StatusOr<bool> RawJwt::GetBooleanClaim(
   if (!status.ok()) {
     return status;
   }
-  auto fields = json_proto_.fields();
+  const auto& fields = json_proto_.fields();
   auto it = fields.find(std::string(name));
   if (it == fields.end()) {
     return util::Status(util::error::NOT_FOUND,
@@ -364,7 +424,7 @@ util::StatusOr<std::string> RawJwt::GetStringClaim(
   if (!status.ok()) {
     return status;
   }
-  auto fields = json_proto_.fields();
+  const auto& fields = json_proto_.fields();
   auto it = fields.find(std::string(name));
   if (it == fields.end()) {
     return util::Status(util::error::NOT_FOUND,
@@ -388,7 +448,7 @@ util::StatusOr<double> RawJwt::GetNumberClaim(absl::string_view name) const {
   if (!status.ok()) {
     return status;
   }
-  auto fields = json_proto_.fields();
+  const auto& fields = json_proto_.fields();
   auto it = fields.find(std::string(name));
   if (it == fields.end()) {
     return util::Status(util::error::NOT_FOUND,
@@ -413,7 +473,7 @@ util::StatusOr<std::string> RawJwt::GetJsonObjectClaim(
   if (!status.ok()) {
     return status;
   }
-  auto fields = json_proto_.fields();
+  const auto& fields = json_proto_.fields();
   auto it = fields.find(std::string(name));
   if (it == fields.end()) {
     return util::Status(util::error::NOT_FOUND,
@@ -439,7 +499,7 @@ util::StatusOr<std::string> RawJwt::GetJsonArrayClaim(
   if (!status.ok()) {
     return status;
   }
-  auto fields = json_proto_.fields();
+  const auto& fields = json_proto_.fields();
   auto it = fields.find(std::string(name));
   if (it == fields.end()) {
     return util::Status(util::error::NOT_FOUND,
@@ -455,8 +515,9 @@ util::StatusOr<std::string> RawJwt::GetJsonArrayClaim(
 }
 
 std::vector<std::string> RawJwt::CustomClaimNames() const {
-  auto fields = json_proto_.fields();
+  const auto& fields = json_proto_.fields();
   std::vector<std::string> values;
+  values.reserve(fields.size());
   for (auto it = fields.begin(); it != fields.end(); it++) {
     if (!IsRegisteredClaimName(it->first)) {
       values.push_back(it->first);
@@ -76,6 +76,17 @@ class RawJwt {
 
   util::StatusOr<std::string> GetJsonPayload() const;
 
+  // Zero-copy variants of the claim accessors, for the validation hot path:
+  // the returned views point into this RawJwt and stay valid only as long as
+  // it is alive and unmodified.
+  util::StatusOr<absl::string_view> GetTypeHeaderView() const;
+  util::StatusOr<absl::string_view> GetIssuerView() const;
+  util::StatusOr<absl::string_view> GetSubjectView() const;
+  // Returns true if 'audience' is among the token's audiences, without
+  // copying the audience list. Fails like GetAudiences on a missing or
+  // malformed audience claim.
+  util::StatusOr<bool> ContainsAudience(absl::string_view audience) const;
+
   // RawJwt objects are copiable and movable.
   RawJwt(const RawJwt&) = default;
   RawJwt& operator=(const RawJwt&) = default;
@@ -54,6 +54,37 @@ TEST(RawJwt, GetTypeHeaderIssuerSubjectJwtIdOK) {
   EXPECT_THAT(jwt.GetJwtId(), IsOkAndHolds("jwt_id"));
 }
 
+TEST(RawJwt, ViewAccessorsOK) {
+  util::StatusOr<RawJwt> jwt_or = RawJwtBuilder()
+                                      .SetTypeHeader("typeHeader")
+                                      .SetIssuer("issuer")
+                                      .SetSubject("subject")
+                                      .AddAudience("audience1")
+                                      .AddAudience("audience2")
+                                      .WithoutExpiration()
+                                      .Build();
+  ASSERT_THAT(jwt_or.status(), IsOk());
+  auto jwt = jwt_or.ValueOrDie();
+
+  EXPECT_THAT(jwt.GetTypeHeaderView(), IsOkAndHolds("typeHeader"));
+  EXPECT_THAT(jwt.GetIssuerView(), IsOkAndHolds("issuer"));
+  EXPECT_THAT(jwt.GetSubjectView(), IsOkAndHolds("subject"));
+  EXPECT_THAT(jwt.ContainsAudience("audience1"), IsOkAndHolds(true));
+  EXPECT_THAT(jwt.ContainsAudience("audience2"), IsOkAndHolds(true));
+  EXPECT_THAT(jwt.ContainsAudience("audience3"), IsOkAndHolds(false));
+}
+
+TEST(RawJwt, ViewAccessorsOnEmptyTokenNotOK) {
+  util::StatusOr<RawJwt> jwt_or = RawJwtBuilder().WithoutExpiration().Build();
+  ASSERT_THAT(jwt_or.status(), IsOk());
+  auto jwt = jwt_or.ValueOrDie();
+
+  EXPECT_FALSE(jwt.GetTypeHeaderView().ok());
+  EXPECT_FALSE(jwt.GetIssuerView().ok());
+  EXPECT_FALSE(jwt.GetSubjectView().ok());
+  EXPECT_FALSE(jwt.ContainsAudience("audience").ok());
+}
+
 TEST(RawJwt, TimestampsOK) {
   absl::Time nbf = absl::FromUnixSeconds(1234567890);
   absl::Time iat = absl::FromUnixSeconds(1234567891);
@@ -31,6 +31,7 @@ namespace tink {
 namespace jwt_internal {
 
 // For friend declaration
+class CachedJwtPublicKeyVerify;
 class JwtMacImpl;
 class JwtPublicKeyVerifyImpl;
 
@@ -83,6 +84,7 @@ class VerifiedJwt {
  private:
   VerifiedJwt();
   explicit VerifiedJwt(const RawJwt& raw_jwt);
+  friend class jwt_internal::CachedJwtPublicKeyVerify;
   friend class jwt_internal::JwtMacImpl;
   friend class jwt_internal::JwtPublicKeyVerifyImpl;
   RawJwt raw_jwt_;
@@ -17,7 +17,20 @@
 #ifndef TINK_KEYSET_HANDLE_H_
 #define TINK_KEYSET_HANDLE_H_
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <typeindex>
+#include <utility>
+#include <vector>
+
 #include "absl/base/attributes.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
 #include "tink/aead.h"
 #include "tink/internal/key_info.h"
 #include "tink/key_manager.h"
@@ -25,6 +38,7 @@
 #include "tink/keyset_writer.h"
 #include "tink/primitive_set.h"
 #include "tink/registry.h"
+#include "tink/util/execution_context.h"
 #include "proto/tink.pb.h"
 
 namespace crypto {
@@ -40,6 +54,22 @@ class KeysetHandle {
   static crypto::tink::util::StatusOr<std::unique_ptr<KeysetHandle>> Read(
       std::unique_ptr<KeysetReader> reader, const Aead& master_key_aead);
 
+  // Creates KeysetHandles from the encrypted keysets obtained via the
+  // non-null 'readers', as if by calling Read() on each reader, and returns
+  // one result per reader in order. The master-key decryptions are
+  // distributed across up to 'num_workers' threads, so loading many keysets
+  // from a KMS-backed 'master_key_aead' overlaps the network round trips
+  // instead of serializing them. A failing read or decryption only fails
+  // its own entry; the other handles are still produced.
+  // The workers are scheduled onto 'execution_context' if non-null, onto
+  // the context installed with util::SetGlobalExecutionContext() otherwise,
+  // and onto freshly spawned threads if neither is set.
+  static crypto::tink::util::StatusOr<
+      std::vector<crypto::tink::util::StatusOr<std::unique_ptr<KeysetHandle>>>>
+  ReadBatch(std::vector<std::unique_ptr<KeysetReader>> readers,
+            const Aead& master_key_aead, int num_workers = 8,
+            util::ExecutionContext* execution_context = nullptr);
+
   // Creates a KeysetHandle from a keyset which contains no secret key material.
   // This can be used to load public keysets or envelope encryption keysets.
   static crypto::tink::util::StatusOr<std::unique_ptr<KeysetHandle>>
@@ -56,10 +86,58 @@ class KeysetHandle {
   crypto::tink::util::Status Write(KeysetWriter* writer,
                                    const Aead& master_key_aead) const;
 
+  // Encrypts the keysets of the non-null 'keyset_handles' with
+  // 'master_key_aead', as if by calling Write() on each handle, and writes
+  // the encrypted keysets to 'writer' in the order of the handles. The
+  // handles are processed in bounded chunks whose encryptions are
+  // distributed across up to 'num_workers' threads, so bulk exports of
+  // many keysets are bounded by AEAD throughput instead of sequential
+  // latency, and memory stays bounded regardless of the batch size.
+  // Returns the error of the first failing encryption (by index) or of
+  // the first failing write; keysets preceding the failure may already
+  // have been written.
+  // The workers are scheduled onto 'execution_context' if non-null, onto
+  // the context installed with util::SetGlobalExecutionContext() otherwise,
+  // and onto freshly spawned threads if neither is set.
+  static crypto::tink::util::Status WriteBatch(
+      absl::Span<const KeysetHandle* const> keyset_handles,
+      KeysetWriter* writer, const Aead& master_key_aead, int num_workers = 8,
+      util::ExecutionContext* execution_context = nullptr);
+
   // Returns KeysetInfo, a "safe" Keyset that doesn't contain any actual
   // key material, thus can be used for logging or monitoring.
   google::crypto::tink::KeysetInfo GetKeysetInfo() const;
 
+  // Result of comparing the keysets of two handles key by key; see Diff().
+  struct KeysetDiff {
+    std::vector<uint32_t> added_key_ids;    // present only in 'to'
+    std::vector<uint32_t> removed_key_ids;  // present only in 'from'
+    std::vector<uint32_t> changed_key_ids;  // present in both, but different
+    bool primary_changed = false;
+
+    // True if the two keysets hold the same keys and the same primary.
+    bool unchanged() const {
+      return added_key_ids.empty() && removed_key_ids.empty() &&
+             changed_key_ids.empty() && !primary_changed;
+    }
+  };
+
+  // Returns a 64-bit fingerprint of the keyset held by this handle; computed
+  // on first call and cached, since the keyset held by a handle never
+  // changes. Handles holding equal keysets have equal fingerprints, and
+  // unequal keysets collide only with hash probability, so reload pipelines
+  // that are pushed keysets periodically can compare fingerprints and skip
+  // re-wrapping the keysets that did not change. The value is stable only
+  // within a process (it hashes the non-canonical proto serialization) and
+  // must not be persisted.
+  uint64_t Fingerprint() const;
+
+  // Compares the keysets of 'from' and 'to' key by key (matched on key id)
+  // and reports which key ids were added, removed or changed, and whether
+  // the primary moved. Reload pipelines use this to rebuild primitives only
+  // for the keysets whose effective key material actually changed.
+  static KeysetDiff Diff(const KeysetHandle& from, const KeysetHandle& to);
+
   // Writes the underlying keyset to |writer| only if the keyset does not
   // contain any secret key material.
   // This can be used to persist public keysets or envelope encryption keysets.
@@ -80,6 +158,15 @@ class KeysetHandle {
   template <class P>
   crypto::tink::util::StatusOr<std::unique_ptr<P>> GetPrimitive() const;
 
+  // Like GetPrimitive(), but uses the KeyManager and PrimitiveWrapper
+  // objects registered with the given |registry| instead of the global
+  // registry. This allows multi-tenant servers to resolve primitives
+  // against per-tenant overlay registries (see
+  // internal::RegistryImpl(const RegistryImpl*)).
+  template <class P>
+  crypto::tink::util::StatusOr<std::unique_ptr<P>> GetPrimitive(
+      const internal::RegistryImpl& registry) const;
+
   // Creates a wrapped primitive corresponding to this keyset. Uses the given
   // KeyManager, as well as the KeyManager and PrimitiveWrapper objects in the
   // global registry to create the primitive. The given KeyManager is used for
@@ -89,6 +176,33 @@ class KeysetHandle {
   crypto::tink::util::StatusOr<std::unique_ptr<P>> GetPrimitive(
       const KeyManager<P>* custom_manager) const;
 
+  // Like GetPrimitive(), but memoizes the wrapped primitive in this handle:
+  // repeated calls for the same primitive type return the same instance
+  // without re-parsing the key protos or re-building the subtle primitives.
+  // The keyset held by a handle never changes, so the cached primitive stays
+  // valid for the lifetime of the handle.
+  template <class P>
+  crypto::tink::util::StatusOr<std::shared_ptr<const P>> GetCachedPrimitive()
+      const;
+
+  // Creates one wrapped primitive per handle in 'keyset_handles', as if by
+  // calling GetPrimitive() on each handle, distributing the construction
+  // across up to 'num_workers' threads. The i-th entry of the result
+  // corresponds to the i-th handle; if some keysets fail, the error of the
+  // first failing handle (by index) is returned. This is considerably
+  // faster than a sequential loop when turning many keysets into primitives
+  // (e.g. per-tenant keysets loaded at startup).
+  // The handles must be non-null, and no registry mutations (like key
+  // manager registrations) may happen concurrently with this call.
+  // The workers are scheduled onto 'execution_context' if non-null, onto
+  // the context installed with util::SetGlobalExecutionContext() otherwise,
+  // and onto freshly spawned threads if neither is set.
+  template <class P>
+  static crypto::tink::util::StatusOr<std::vector<std::unique_ptr<P>>>
+  GetPrimitives(absl::Span<const KeysetHandle* const> keyset_handles,
+                int num_workers = 8,
+                util::ExecutionContext* execution_context = nullptr);
+
  private:
   // The classes below need access to get_keyset();
   friend class CleartextKeysetHandle;
@@ -102,6 +216,10 @@ class KeysetHandle {
   explicit KeysetHandle(google::crypto::tink::Keyset keyset);
   // Creates a handle that contains the given keyset.
   explicit KeysetHandle(std::unique_ptr<google::crypto::tink::Keyset> keyset);
+  // Creates a handle that shares the given immutable keyset without
+  // copying it; used by KeysetManager to hand out snapshots.
+  explicit KeysetHandle(
+      std::shared_ptr<const google::crypto::tink::Keyset> keyset);
 
   // Helper function which generates a key from a template, then adds it
   // to the keyset. TODO(tholenst): Change this to a proper member operating
@@ -124,7 +242,20 @@ class KeysetHandle {
   crypto::tink::util::StatusOr<std::unique_ptr<PrimitiveSet<P>>> GetPrimitives(
       const KeyManager<P>* custom_manager) const;
 
-  google::crypto::tink::Keyset keyset_;
+  // The keyset is immutable for the lifetime of the handle, so it can be
+  // shared with other handles and with the KeysetManager that created it
+  // instead of being deep-copied per handle.
+  std::shared_ptr<const google::crypto::tink::Keyset> keyset_;
+
+  // Lazily computed by Fingerprint(); 0 means "not yet computed" (a real
+  // fingerprint of 0 is stored as 1).
+  mutable std::atomic<uint64_t> fingerprint_{0};
+
+  // Cache for GetCachedPrimitive(), keyed by primitive type. The values are
+  // shared_ptr<void> pointing to a const P.
+  mutable absl::Mutex primitive_cache_mutex_;
+  mutable absl::flat_hash_map<std::type_index, std::shared_ptr<void>>
+      primitive_cache_ ABSL_GUARDED_BY(primitive_cache_mutex_);
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -165,7 +296,82 @@ KeysetHandle::GetPrimitives(const KeyManager<P>* custom_manager) const {
 template <class P>
 crypto::tink::util::StatusOr<std::unique_ptr<P>> KeysetHandle::GetPrimitive()
     const {
-  return internal::RegistryImpl::GlobalInstance().WrapKeyset<P>(keyset_);
+  return internal::RegistryImpl::GlobalInstance().WrapKeyset<P>(*keyset_);
+}
+
+template <class P>
+crypto::tink::util::StatusOr<std::unique_ptr<P>> KeysetHandle::GetPrimitive(
+    const internal::RegistryImpl& registry) const {
+  return registry.WrapKeyset<P>(*keyset_);
+}
+
+template <class P>
+crypto::tink::util::StatusOr<std::shared_ptr<const P>>
+KeysetHandle::GetCachedPrimitive() const {
+  absl::MutexLock lock(&primitive_cache_mutex_);
+  auto it = primitive_cache_.find(std::type_index(typeid(P)));
+  if (it != primitive_cache_.end()) {
+    return std::static_pointer_cast<const P>(it->second);
+  }
+  auto primitive_result =
+      internal::RegistryImpl::GlobalInstance().WrapKeyset<P>(*keyset_);
+  if (!primitive_result.ok()) return primitive_result.status();
+  std::shared_ptr<const P> primitive(
+      std::move(primitive_result.ValueOrDie()));
+  primitive_cache_.emplace(std::type_index(typeid(P)),
+                           std::const_pointer_cast<P>(primitive));
+  return primitive;
+}
+
+// static
+template <class P>
+crypto::tink::util::StatusOr<std::vector<std::unique_ptr<P>>>
+KeysetHandle::GetPrimitives(absl::Span<const KeysetHandle* const> keyset_handles,
+                            int num_workers,
+                            util::ExecutionContext* execution_context) {
+  if (num_workers < 1) {
+    return crypto::tink::util::Status(util::error::INVALID_ARGUMENT,
+                                      "num_workers must be positive");
+  }
+  for (const KeysetHandle* handle : keyset_handles) {
+    if (handle == nullptr) {
+      return crypto::tink::util::Status(
+          util::error::INVALID_ARGUMENT,
+          "keyset_handles must not contain nullptr");
+    }
+  }
+  std::vector<std::unique_ptr<P>> primitives(keyset_handles.size());
+  std::vector<crypto::tink::util::Status> statuses(keyset_handles.size());
+  // Handles are claimed via a shared counter, so fast keysets do not
+  // wait for slow ones the way a static partition would make them.
+  std::atomic<size_t> next_index(0);
+  auto work = [&keyset_handles, &primitives, &statuses, &next_index]() {
+    while (true) {
+      size_t i = next_index.fetch_add(1);
+      if (i >= keyset_handles.size()) return;
+      auto primitive_result =
+          internal::RegistryImpl::GlobalInstance().WrapKeyset<P>(
+              *keyset_handles[i]->keyset_);
+      if (primitive_result.ok()) {
+        primitives[i] = std::move(primitive_result.ValueOrDie());
+      } else {
+        statuses[i] = primitive_result.status();
+      }
+    }
+  };
+  size_t worker_count =
+      std::min(static_cast<size_t>(num_workers), keyset_handles.size());
+  util::RunParallelWork(execution_context, static_cast<int>(worker_count),
+                        work);
+  for (size_t i = 0; i < statuses.size(); i++) {
+    if (!statuses[i].ok()) {
+      return crypto::tink::util::Status(
+          statuses[i].error_code(),
+          absl::StrCat("keyset_handles[", i, "]: ",
+                       statuses[i].error_message()));
+    }
+  }
+  return std::move(primitives);
 }
 
 template <class P>
@@ -16,6 +16,9 @@
 #ifndef TINK_KEYSET_MANAGER_H_
 #define TINK_KEYSET_MANAGER_H_
 
+#include <memory>
+#include <vector>
+
 #include "absl/base/thread_annotations.h"
 #include "absl/synchronization/mutex.h"
 #include "tink/util/status.h"
@@ -95,7 +98,10 @@ class KeysetManager {
   // Returns the count of all keys in the keyset.
   int KeyCount() const;
 
-  // Returns a handle with a copy of the managed keyset.
+  // Returns a handle with the managed keyset. The handle shares an
+  // immutable snapshot of the keyset, so no key material is copied;
+  // subsequent mutations of the manager do not affect handles that were
+  // already returned.
   std::unique_ptr<KeysetHandle> GetKeysetHandle()
       ABSL_LOCKS_EXCLUDED(keyset_mutex_);
 
@@ -104,8 +110,23 @@ class KeysetManager {
       const google::crypto::tink::KeyTemplate& key_template, bool as_primary)
       ABSL_LOCKS_EXCLUDED(keyset_mutex_);
 
+  // Returns the index in keys_ of the key with 'key_id', or -1 if there is
+  // no such key.
+  int FindKey(uint32_t key_id) const
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(keyset_mutex_);
+
   mutable absl::Mutex keyset_mutex_;
-  google::crypto::tink::Keyset keyset_ ABSL_GUARDED_BY(keyset_mutex_);
+  // Copy-on-write keyset internals: the keyset is kept as a vector of
+  // immutable, individually shared key entries plus the primary key id.
+  // A mutation copies only the touched entry and invalidates snapshot_;
+  // GetKeysetHandle() hands out a shared snapshot that is rebuilt at most
+  // once per mutation, so neither handle creation nor a mutation deep-copies
+  // the untouched key material.
+  std::vector<std::shared_ptr<const google::crypto::tink::Keyset::Key>> keys_
+      ABSL_GUARDED_BY(keyset_mutex_);
+  uint32_t primary_key_id_ ABSL_GUARDED_BY(keyset_mutex_) = 0;
+  std::shared_ptr<const google::crypto::tink::Keyset> snapshot_
+      ABSL_GUARDED_BY(keyset_mutex_);
 };
 
 }  // namespace tink
@@ -17,6 +17,8 @@
 #ifndef TINK_KEYSET_READER_H_
 #define TINK_KEYSET_READER_H_
 
+#include "google/protobuf/arena.h"
+#include "tink/util/status.h"
 #include "tink/util/statusor.h"
 #include "proto/tink.pb.h"
 
@@ -32,6 +34,27 @@ class KeysetReader {
    std::unique_ptr<google::crypto::tink::Keyset>>
   Read() = 0;
 
+  // Reads a (cleartext) Keyset object from the underlying source into
+  // 'arena', which must be non-null and must outlive the returned message.
+  // Readers which parse a wire format should override this to parse directly
+  // onto the arena, so that loading many keysets costs a few arena bumps
+  // instead of one heap allocation per field. The default implementation
+  // falls back to Read() and moves the result onto the arena.
+  virtual crypto::tink::util::StatusOr<google::crypto::tink::Keyset*>
+  ReadIntoArena(google::protobuf::Arena* arena) {
+    if (arena == nullptr) {
+      return crypto::tink::util::Status(
+          crypto::tink::util::error::INVALID_ARGUMENT,
+          "arena must be non-null.");
+    }
+    auto keyset_result = Read();
+    if (!keyset_result.ok()) return keyset_result.status();
+    auto* keyset = google::protobuf::Arena::CreateMessage<
+        google::crypto::tink::Keyset>(arena);
+    keyset->Swap(keyset_result.ValueOrDie().get());
+    return keyset;
+  }
+
   // Reads and returns an EncryptedKeyset object from the underlying source.
   virtual crypto::tink::util::StatusOr<
     std::unique_ptr<google::crypto::tink::EncryptedKeyset>>
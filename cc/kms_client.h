@@ -18,9 +18,12 @@
 #define TINK_KMS_CLIENT_H_
 
 #include <memory>
+#include <utility>
 
 #include "absl/strings/string_view.h"
 #include "tink/aead.h"
+#include "tink/aead/async_aead_from_aead.h"
+#include "tink/async_aead.h"
 #include "tink/util/statusor.h"
 
 namespace crypto {
@@ -38,6 +41,28 @@ class KmsClient {
   virtual crypto::tink::util::StatusOr<std::unique_ptr<Aead>>
   GetAead(absl::string_view key_uri) const = 0;
 
+  // Returns an AsyncAead-primitive backed by KMS key specified by 'key_uri',
+  // provided that this KmsClient does support 'key_uri'. The default
+  // implementation adapts GetAead() and runs each operation inline, so it
+  // offers the async signature but still one blocking remote call per
+  // operation. Clients whose transport supports request pipelining should
+  // override this so that up to max_in_flight_requests() operations can
+  // share few connections.
+  virtual crypto::tink::util::StatusOr<std::unique_ptr<AsyncAead>>
+  GetAsyncAead(absl::string_view key_uri) const {
+    auto aead_result = GetAead(key_uri);
+    if (!aead_result.ok()) return aead_result.status();
+    return AsyncAeadFromAead::New(std::move(aead_result.ValueOrDie()));
+  }
+
+  // Number of operations this client can usefully have in flight at once,
+  // e.g. the size of its connection pool. Callers performing bulk work
+  // (such as wrapping many DEKs during provisioning) should start up to
+  // this many operations via GetAsyncAead()-primitives before awaiting
+  // results, instead of serializing one call at a time. The default, 1,
+  // matches a client that serializes remote calls.
+  virtual int max_in_flight_requests() const { return 1; }
+
   virtual ~KmsClient() {}
 };
 
@@ -17,6 +17,9 @@
 #ifndef TINK_KMS_CLIENTS_H_
 #define TINK_KMS_CLIENTS_H_
 
+#include <memory>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "absl/base/thread_annotations.h"
@@ -45,6 +48,8 @@ class KmsClients {
   // Returns the first KmsClient that was added previously via Add(),
   // and that does support 'key_uri', which must be non-empty.
   // Retains the ownership of the returned KmsClient.
+  // Successful resolutions are cached, so repeated calls with the same
+  // 'key_uri' are a single hash lookup that does not acquire a mutex.
   static crypto::tink::util::StatusOr<const KmsClient*>
       Get(absl::string_view key_uri) {
     return GlobalInstance().LocalGet(key_uri);
@@ -58,9 +63,16 @@ class KmsClients {
       LocalAdd(std::unique_ptr<KmsClient> kms_client);
   crypto::tink::util::StatusOr<const KmsClient*>
       LocalGet(absl::string_view key_uri);
+  typedef std::unordered_map<std::string, const KmsClient*> UriCache;
+
   absl::Mutex clients_mutex_;
   std::vector<std::unique_ptr<KmsClient>> clients_
       ABSL_GUARDED_BY(clients_mutex_);
+  // Immutable snapshot mapping already-resolved key URIs to their clients.
+  // Lookups load the current snapshot with std::atomic_load and need no
+  // mutex; LocalAdd and cache misses publish a replacement snapshot while
+  // holding clients_mutex_.
+  std::shared_ptr<const UriCache> uri_cache_;
 
   static KmsClients& GlobalInstance();
 };
@@ -17,7 +17,12 @@
 #ifndef TINK_MAC_H_
 #define TINK_MAC_H_
 
+#include <cstring>
+#include <utility>
+#include <vector>
+
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "tink/util/status.h"
 #include "tink/util/statusor.h"
 
@@ -34,12 +39,61 @@ class Mac {
   virtual crypto::tink::util::StatusOr<std::string> ComputeMac(
       absl::string_view data) const = 0;
 
+  // A conservative upper bound on the MAC size (output prefix plus tag) of
+  // all Mac implementations provided by Tink; used by the default
+  // MaxMacSize() below.
+  static constexpr size_t kMaxMacSize = 128;
+
+  // Returns an upper bound on the size of the MAC this primitive computes.
+  // The default bound is conservative; implementations which know their
+  // exact tag size should override this.
+  virtual size_t MaxMacSize() const { return kMaxMacSize; }
+
+  // Computes the message authentication code (MAC) for 'data', writing it
+  // into the caller-provided buffer 'out', and returns the number of bytes
+  // written. 'out' must be at least MaxMacSize() bytes long. The default
+  // implementation falls back to ComputeMac() and copies; implementations
+  // should override it to write the tag directly into 'out' so that callers
+  // computing MACs per record can reuse a preallocated buffer instead of
+  // paying one heap allocation per tag.
+  virtual crypto::tink::util::StatusOr<size_t> ComputeMacInto(
+      absl::string_view data, absl::Span<char> out) const {
+    auto mac_value = ComputeMac(data);
+    if (!mac_value.ok()) return mac_value.status();
+    if (out.size() < mac_value.ValueOrDie().size()) {
+      return crypto::tink::util::Status(
+          crypto::tink::util::error::INVALID_ARGUMENT,
+          "Output buffer too small.");
+    }
+    memcpy(out.data(), mac_value.ValueOrDie().data(),
+           mac_value.ValueOrDie().size());
+    return mac_value.ValueOrDie().size();
+  }
+
   // Verifies if 'mac' is a correct authentication code (MAC) for 'data'.
   // Returns Status::OK if 'mac' is correct, and a non-OK-Status otherwise.
+  // Both arguments are only read as views; implementations must not require
+  // NUL-terminated or heap-backed inputs.
   virtual crypto::tink::util::Status VerifyMac(
       absl::string_view mac_value,
       absl::string_view data) const = 0;
 
+  // Verifies a batch of (mac_value, data) pairs and returns one bool per
+  // pair, in order: true if the pair's MAC is correct, false otherwise.
+  // Callers that verify many MACs in a tight loop should prefer this over
+  // per-pair VerifyMac calls; implementations backed by a keyset amortize
+  // the per-call key resolution over the batch. The default implementation
+  // falls back to VerifyMac on every pair.
+  virtual crypto::tink::util::StatusOr<std::vector<bool>> VerifyMacBatch(
+      absl::Span<const std::pair<absl::string_view, absl::string_view>> items)
+      const {
+    std::vector<bool> results(items.size(), false);
+    for (size_t i = 0; i < items.size(); ++i) {
+      results[i] = VerifyMac(items[i].first, items[i].second).ok();
+    }
+    return results;
+  }
+
   virtual ~Mac() {}
 };
 
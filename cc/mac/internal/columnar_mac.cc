@@ -0,0 +1,92 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/mac/internal/columnar_mac.h"
+
+#include <memory>
+#include <utility>
+
+#include "tink/util/errors.h"
+
+namespace crypto {
+namespace tink {
+namespace internal {
+
+// static
+util::StatusOr<std::unique_ptr<ColumnarMac>> ColumnarMac::New(
+    std::unique_ptr<subtle::StatefulMacFactory> factory) {
+  if (factory == nullptr) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "factory must be non-null");
+  }
+  // Probe the tag size with one throwaway MAC, so that callers do not have
+  // to pass (and possibly get wrong) a size the factory already knows.
+  auto mac_result = factory->Create();
+  if (!mac_result.ok()) return mac_result.status();
+  auto tag_result = mac_result.ValueOrDie()->Finalize();
+  if (!tag_result.ok()) return tag_result.status();
+  size_t tag_size = tag_result.ValueOrDie().size();
+  return std::unique_ptr<ColumnarMac>(
+      new ColumnarMac(std::move(factory), tag_size));
+}
+
+util::Status ColumnarMac::ComputeTags(
+    absl::Span<const absl::string_view> records, absl::Span<char> tags) const {
+  if (tags.size() != records.size() * tag_size_) {
+    return ToStatusF(util::error::INVALID_ARGUMENT,
+                     "tags buffer must hold %d bytes (records * tag size), "
+                     "got %d",
+                     static_cast<int>(records.size() * tag_size_),
+                     static_cast<int>(tags.size()));
+  }
+  if (records.empty()) return util::OkStatus();
+
+  auto mac_result = factory_->Create();
+  if (!mac_result.ok()) return mac_result.status();
+  std::unique_ptr<subtle::StatefulMac> mac = std::move(mac_result.ValueOrDie());
+
+  // Reuse one context across the column where the implementation supports
+  // it; fall back to one context per record otherwise.
+  bool can_reset = true;
+  char* out = tags.data();
+  for (size_t i = 0; i < records.size(); i++) {
+    if (i > 0) {
+      if (can_reset) {
+        util::Status reset_status = mac->Reset();
+        if (reset_status.error_code() == util::error::UNIMPLEMENTED) {
+          can_reset = false;
+        } else if (!reset_status.ok()) {
+          return reset_status;
+        }
+      }
+      if (!can_reset) {
+        auto fresh_mac_result = factory_->Create();
+        if (!fresh_mac_result.ok()) return fresh_mac_result.status();
+        mac = std::move(fresh_mac_result.ValueOrDie());
+      }
+    }
+    util::Status status = mac->Update(records[i]);
+    if (!status.ok()) return status;
+    status = mac->FinalizeInto(absl::Span<char>(out, tag_size_));
+    if (!status.ok()) return status;
+    out += tag_size_;
+  }
+  return util::OkStatus();
+}
+
+}  // namespace internal
+}  // namespace tink
+}  // namespace crypto
@@ -0,0 +1,76 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_MAC_INTERNAL_COLUMNAR_MAC_H_
+#define TINK_MAC_INTERNAL_COLUMNAR_MAC_H_
+
+#include <memory>
+
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "tink/subtle/mac/stateful_mac.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace internal {
+
+// Fused MAC-a-column operator for pipelines that tag whole record batches,
+// e.g. deduplication by MAC tag.
+//
+// ComputeTags() authenticates every record of a column and emits the tags
+// as fixed-width rows of one contiguous caller-provided buffer, in record
+// order, so the result can be fed straight into a radix sort. Compared to
+// calling Mac::ComputeMac per record, one stateful MAC context is reused
+// across the whole column (via StatefulMac::Reset) and no per-record
+// result string is allocated (via StatefulMac::FinalizeInto).
+//
+// Instances are thread-safe: ComputeTags creates its own MAC context per
+// call, so one ColumnarMac can be shared by all workers of a pipeline.
+class ColumnarMac {
+ public:
+  // Creates a ColumnarMac that tags records with MACs from 'factory'.
+  // The tag size is probed from the factory and fixed for the lifetime
+  // of the instance.
+  static crypto::tink::util::StatusOr<std::unique_ptr<ColumnarMac>> New(
+      std::unique_ptr<crypto::tink::subtle::StatefulMacFactory> factory);
+
+  // Width in bytes of one tag row in the output buffer.
+  size_t tag_size() const { return tag_size_; }
+
+  // Computes the tag of every record and writes it at offset
+  // i * tag_size() of 'tags'; 'tags' must hold exactly
+  // records.size() * tag_size() bytes.
+  crypto::tink::util::Status ComputeTags(
+      absl::Span<const absl::string_view> records,
+      absl::Span<char> tags) const;
+
+ private:
+  ColumnarMac(
+      std::unique_ptr<crypto::tink::subtle::StatefulMacFactory> factory,
+      size_t tag_size)
+      : factory_(std::move(factory)), tag_size_(tag_size) {}
+
+  const std::unique_ptr<crypto::tink::subtle::StatefulMacFactory> factory_;
+  const size_t tag_size_;
+};
+
+}  // namespace internal
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_MAC_INTERNAL_COLUMNAR_MAC_H_
@@ -0,0 +1,113 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/mac/internal/columnar_mac.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "tink/subtle/common_enums.h"
+#include "tink/subtle/stateful_hmac_boringssl.h"
+#include "tink/util/secret_data.h"
+#include "tink/util/status.h"
+#include "tink/util/test_matchers.h"
+#include "tink/util/test_util.h"
+
+namespace crypto {
+namespace tink {
+namespace internal {
+namespace {
+
+using crypto::tink::test::IsOk;
+using crypto::tink::test::StatusIs;
+using crypto::tink::subtle::HashType;
+using crypto::tink::subtle::StatefulHmacBoringSslFactory;
+
+constexpr uint32_t kTagSize = 16;
+
+std::unique_ptr<subtle::StatefulMacFactory> NewHmacFactory() {
+  std::string key(
+      test::HexDecodeOrDie("000102030405060708090a0b0c0d0e0f"));
+  return absl::make_unique<StatefulHmacBoringSslFactory>(
+      HashType::SHA256, kTagSize, util::SecretDataFromStringView(key));
+}
+
+// Computes the reference tag of 'record' with a fresh MAC from 'factory'.
+std::string ReferenceTag(const subtle::StatefulMacFactory& factory,
+                         absl::string_view record) {
+  auto mac = factory.Create().ValueOrDie();
+  EXPECT_THAT(mac->Update(record), IsOk());
+  return mac->Finalize().ValueOrDie();
+}
+
+TEST(ColumnarMacTest, TagsMatchPerRecordMac) {
+  auto factory = NewHmacFactory();
+  const subtle::StatefulMacFactory& reference_factory = *factory;
+  auto columnar_result = ColumnarMac::New(std::move(factory));
+  ASSERT_THAT(columnar_result.status(), IsOk());
+  auto columnar = std::move(columnar_result.ValueOrDie());
+  EXPECT_EQ(kTagSize, columnar->tag_size());
+
+  std::vector<std::string> storage;
+  std::vector<absl::string_view> records;
+  for (int i = 0; i < 100; i++) {
+    storage.push_back(absl::StrCat("record number ", i));
+    records.push_back(storage.back());
+  }
+  records.push_back("");  // Empty records are valid too.
+
+  std::vector<char> tags(records.size() * kTagSize);
+  ASSERT_THAT(columnar->ComputeTags(records, absl::MakeSpan(tags)), IsOk());
+
+  for (size_t i = 0; i < records.size(); i++) {
+    std::string row(tags.data() + i * kTagSize, kTagSize);
+    EXPECT_EQ(ReferenceTag(reference_factory, records[i]), row)
+        << "record " << i;
+  }
+}
+
+TEST(ColumnarMacTest, EmptyColumn) {
+  auto columnar_result = ColumnarMac::New(NewHmacFactory());
+  ASSERT_THAT(columnar_result.status(), IsOk());
+  auto columnar = std::move(columnar_result.ValueOrDie());
+  EXPECT_THAT(columnar->ComputeTags({}, absl::Span<char>()), IsOk());
+}
+
+TEST(ColumnarMacTest, RejectsWrongBufferSize) {
+  auto columnar_result = ColumnarMac::New(NewHmacFactory());
+  ASSERT_THAT(columnar_result.status(), IsOk());
+  auto columnar = std::move(columnar_result.ValueOrDie());
+
+  std::vector<absl::string_view> records = {"a", "b"};
+  std::vector<char> too_small(records.size() * kTagSize - 1);
+  EXPECT_THAT(columnar->ComputeTags(records, absl::MakeSpan(too_small)),
+              StatusIs(util::error::INVALID_ARGUMENT));
+}
+
+TEST(ColumnarMacTest, RejectsNullFactory) {
+  EXPECT_THAT(ColumnarMac::New(nullptr).status(),
+              StatusIs(util::error::INVALID_ARGUMENT));
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace tink
+}  // namespace crypto
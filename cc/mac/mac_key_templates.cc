@@ -16,44 +16,51 @@
 
 #include "tink/mac/mac_key_templates.h"
 
-#include "proto/aes_cmac.pb.h"
-#include "proto/common.pb.h"
-#include "proto/hmac.pb.h"
 #include "proto/tink.pb.h"
 
 namespace crypto {
 namespace tink {
 namespace {
 
-using google::crypto::tink::AesCmacKeyFormat;
-using google::crypto::tink::HashType;
-using google::crypto::tink::HmacKeyFormat;
 using google::crypto::tink::KeyTemplate;
 using google::crypto::tink::OutputPrefixType;
 
-KeyTemplate* NewHmacKeyTemplate(int key_size_in_bytes, int tag_size_in_bytes,
-                                HashType hash_type) {
-  KeyTemplate* key_template = new KeyTemplate;
-  key_template->set_type_url("type.googleapis.com/google.crypto.tink.HmacKey");
-  key_template->set_output_prefix_type(OutputPrefixType::TINK);
-  HmacKeyFormat key_format;
-  key_format.set_key_size(key_size_in_bytes);
-  key_format.mutable_params()->set_tag_size(tag_size_in_bytes);
-  key_format.mutable_params()->set_hash(hash_type);
-  key_format.SerializeToString(key_template->mutable_value());
-  return key_template;
-}
+// The key formats of the templates below are fixed, and serialize to short,
+// deterministic byte strings. They are precomputed here as compile-time
+// constants so that first use of a template only fills in a KeyTemplate proto,
+// instead of building and serializing a key format proto as well; binaries
+// that start many short-lived processes pay that cost on every startup.
+// Each constant documents the message it encodes, and mac_key_templates_test.cc
+// checks the constants against the proto serializer.
+
+// Serialized HmacKeyFormat with params.hash = SHA256, params.tag_size = 16,
+// key_size = 32.
+constexpr char kHmacSha256HalfSizeTagKeyFormat[] =
+    "\x0a\x04\x08\x03\x10\x10\x10\x20";
+
+// Serialized HmacKeyFormat with params.hash = SHA256, params.tag_size = 32,
+// key_size = 32.
+constexpr char kHmacSha256KeyFormat[] = "\x0a\x04\x08\x03\x10\x20\x10\x20";
+
+// Serialized HmacKeyFormat with params.hash = SHA512, params.tag_size = 32,
+// key_size = 64.
+constexpr char kHmacSha512HalfSizeTagKeyFormat[] =
+    "\x0a\x04\x08\x04\x10\x20\x10\x40";
+
+// Serialized HmacKeyFormat with params.hash = SHA512, params.tag_size = 64,
+// key_size = 64.
+constexpr char kHmacSha512KeyFormat[] = "\x0a\x04\x08\x04\x10\x40\x10\x40";
+
+// Serialized AesCmacKeyFormat with key_size = 32, params.tag_size = 16.
+constexpr char kAesCmacKeyFormat[] = "\x08\x20\x12\x02\x08\x10";
 
-KeyTemplate* NewAesCmacKeyTemplate(int key_size_in_bytes,
-                                   int tag_size_in_bytes) {
+KeyTemplate* NewKeyTemplate(const char* type_url,
+                            const char* serialized_key_format,
+                            size_t serialized_key_format_size) {
   KeyTemplate* key_template = new KeyTemplate;
-  key_template->set_type_url(
-      "type.googleapis.com/google.crypto.tink.AesCmacKey");
+  key_template->set_type_url(type_url);
   key_template->set_output_prefix_type(OutputPrefixType::TINK);
-  AesCmacKeyFormat key_format;
-  key_format.set_key_size(key_size_in_bytes);
-  key_format.mutable_params()->set_tag_size(tag_size_in_bytes);
-  key_format.SerializeToString(key_template->mutable_value());
+  key_template->set_value(serialized_key_format, serialized_key_format_size);
   return key_template;
 }
 
@@ -61,40 +68,43 @@ KeyTemplate* NewAesCmacKeyTemplate(int key_size_in_bytes,
 
 // static
 const KeyTemplate& MacKeyTemplates::HmacSha256HalfSizeTag() {
-  static const KeyTemplate* key_template =
-      NewHmacKeyTemplate(/* key_size_in_bytes= */ 32,
-                         /* tag_size_in_bytes= */ 16, HashType::SHA256);
+  static const KeyTemplate* key_template = NewKeyTemplate(
+      "type.googleapis.com/google.crypto.tink.HmacKey",
+      kHmacSha256HalfSizeTagKeyFormat,
+      sizeof(kHmacSha256HalfSizeTagKeyFormat) - 1);
   return *key_template;
 }
 
 // static
 const KeyTemplate& MacKeyTemplates::HmacSha256() {
-  static const KeyTemplate* key_template =
-      NewHmacKeyTemplate(/* key_size_in_bytes= */ 32,
-                         /* tag_size_in_bytes= */ 32, HashType::SHA256);
+  static const KeyTemplate* key_template = NewKeyTemplate(
+      "type.googleapis.com/google.crypto.tink.HmacKey", kHmacSha256KeyFormat,
+      sizeof(kHmacSha256KeyFormat) - 1);
   return *key_template;
 }
 
 // static
 const KeyTemplate& MacKeyTemplates::HmacSha512HalfSizeTag() {
-  static const KeyTemplate* key_template =
-      NewHmacKeyTemplate(/* key_size_in_bytes= */ 64,
-                         /* tag_size_in_bytes= */ 32, HashType::SHA512);
+  static const KeyTemplate* key_template = NewKeyTemplate(
+      "type.googleapis.com/google.crypto.tink.HmacKey",
+      kHmacSha512HalfSizeTagKeyFormat,
+      sizeof(kHmacSha512HalfSizeTagKeyFormat) - 1);
   return *key_template;
 }
 
 // static
 const KeyTemplate& MacKeyTemplates::HmacSha512() {
-  static const KeyTemplate* key_template =
-      NewHmacKeyTemplate(/* key_size_in_bytes= */ 64,
-                         /* tag_size_in_bytes= */ 64, HashType::SHA512);
+  static const KeyTemplate* key_template = NewKeyTemplate(
+      "type.googleapis.com/google.crypto.tink.HmacKey", kHmacSha512KeyFormat,
+      sizeof(kHmacSha512KeyFormat) - 1);
   return *key_template;
 }
 
 // static
 const KeyTemplate& MacKeyTemplates::AesCmac() {
-  static const KeyTemplate* key_template = NewAesCmacKeyTemplate(
-      /* key_size_in_bytes= */ 32, /* tag_size_in_bytes= */ 16);
+  static const KeyTemplate* key_template = NewKeyTemplate(
+      "type.googleapis.com/google.crypto.tink.AesCmacKey", kAesCmacKeyFormat,
+      sizeof(kAesCmacKeyFormat) - 1);
   return *key_template;
 }
 
@@ -167,6 +167,33 @@ TEST(AesCmac, CheckValues) {
   EXPECT_THAT(key_format.params().tag_size(), Eq(16));
 }
 
+TEST(MacKeyTemplatesTest, SerializedFormatsMatchProtoSerializer) {
+  // The templates precompute their serialized key formats as compile-time
+  // constants; verify the constants against the proto serializer.
+  HmacKeyFormat hmac_format;
+  hmac_format.set_key_size(32);
+  hmac_format.mutable_params()->set_hash(HashType::SHA256);
+  hmac_format.mutable_params()->set_tag_size(16);
+  EXPECT_EQ(MacKeyTemplates::HmacSha256HalfSizeTag().value(),
+            hmac_format.SerializeAsString());
+  hmac_format.mutable_params()->set_tag_size(32);
+  EXPECT_EQ(MacKeyTemplates::HmacSha256().value(),
+            hmac_format.SerializeAsString());
+  hmac_format.set_key_size(64);
+  hmac_format.mutable_params()->set_hash(HashType::SHA512);
+  EXPECT_EQ(MacKeyTemplates::HmacSha512HalfSizeTag().value(),
+            hmac_format.SerializeAsString());
+  hmac_format.mutable_params()->set_tag_size(64);
+  EXPECT_EQ(MacKeyTemplates::HmacSha512().value(),
+            hmac_format.SerializeAsString());
+
+  AesCmacKeyFormat cmac_format;
+  cmac_format.set_key_size(32);
+  cmac_format.mutable_params()->set_tag_size(16);
+  EXPECT_EQ(MacKeyTemplates::AesCmac().value(),
+            cmac_format.SerializeAsString());
+}
+
 }  // namespace
 }  // namespace tink
 }  // namespace crypto
@@ -16,13 +16,21 @@
 
 #include "tink/mac/mac_wrapper.h"
 
+#include <cstring>
+#include <utility>
+#include <vector>
+
 #include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
 #include "tink/crypto_format.h"
+#include "tink/internal/monitoring.h"
 #include "tink/mac.h"
 #include "tink/primitive_set.h"
 #include "tink/subtle/subtle_util_boringssl.h"
+#include "tink/util/errors.h"
 #include "tink/util/status.h"
 #include "tink/util/statusor.h"
+#include "tink/warmup.h"
 #include "proto/tink.pb.h"
 
 namespace crypto {
@@ -32,7 +40,7 @@ using google::crypto::tink::OutputPrefixType;
 
 namespace {
 
-class MacSetWrapper : public Mac {
+class MacSetWrapper : public Mac, public Warmable {
  public:
   explicit MacSetWrapper(std::unique_ptr<PrimitiveSet<Mac>> mac_set)
       : mac_set_(std::move(mac_set)) {}
@@ -40,12 +48,55 @@ class MacSetWrapper : public Mac {
   crypto::tink::util::StatusOr<std::string> ComputeMac(
       absl::string_view data) const override;
 
+  size_t MaxMacSize() const override {
+    auto primary = mac_set_->get_primary();
+    return primary->get_identifier().size() +
+           primary->get_primitive().MaxMacSize();
+  }
+
+  crypto::tink::util::StatusOr<size_t> ComputeMacInto(
+      absl::string_view data, absl::Span<char> out) const override;
+
   crypto::tink::util::Status VerifyMac(absl::string_view mac_value,
                                        absl::string_view data) const override;
 
+  crypto::tink::util::StatusOr<std::vector<bool>> VerifyMacBatch(
+      absl::Span<const std::pair<absl::string_view, absl::string_view>> items)
+      const override;
+
+  // Computes and verifies one dummy MAC with every key of the set, which
+  // materializes lazily built primitives and faults in the key schedules,
+  // so the first real operation does not pay these one-time costs. Best
+  // effort: all keys are attempted and the first error is returned.
+  util::Status Warmup() const override {
+    util::Status result = util::Status::OK;
+    for (const auto* entry : mac_set_->get_all()) {
+      auto mac_or = entry->primitive_or_status();
+      if (!mac_or.ok()) {
+        if (result.ok()) result = mac_or.status();
+        continue;
+      }
+      Mac& mac = *mac_or.ValueOrDie();
+      auto tag = mac.ComputeMac("warmup");
+      if (!tag.ok()) {
+        if (result.ok()) result = tag.status();
+        continue;
+      }
+      util::Status verified = mac.VerifyMac(tag.ValueOrDie(), "warmup");
+      if (!verified.ok() && result.ok()) result = verified;
+    }
+    return result;
+  }
+
   ~MacSetWrapper() override {}
 
  private:
+  // Tries to verify 'raw_mac_value' over 'data' with every entry in
+  // 'primitives'; returns the matching entry, or nullptr if none verifies.
+  const PrimitiveSet<Mac>::Entry<Mac>* TryVerify(
+      const PrimitiveSet<Mac>::Primitives& primitives,
+      absl::string_view raw_mac_value, absl::string_view data) const;
+
   std::unique_ptr<PrimitiveSet<Mac>> mac_set_;
 };
 
@@ -67,6 +118,7 @@ util::StatusOr<std::string> MacSetWrapper::ComputeMac(
   data = subtle::SubtleUtilBoringSSL::EnsureNonNull(data);
 
   auto primary = mac_set_->get_primary();
+  internal::MonitoredOp monitored_op("mac.compute", primary->get_key_id());
   std::string local_data;
   if (primary->get_output_prefix_type() == OutputPrefixType::LEGACY) {
     local_data = std::string(data);
@@ -75,9 +127,73 @@ util::StatusOr<std::string> MacSetWrapper::ComputeMac(
     data = local_data;
   }
   auto compute_mac_result = primary->get_primitive().ComputeMac(data);
-  if (!compute_mac_result.ok()) return compute_mac_result.status();
-  const std::string& key_id = primary->get_identifier();
-  return key_id + compute_mac_result.ValueOrDie();
+  if (!compute_mac_result.ok()) {
+    monitored_op.SetFailed();
+    return compute_mac_result.status();
+  }
+  primary->IncrementHitCount();
+  absl::string_view key_id = primary->get_identifier();
+  return absl::StrCat(key_id, compute_mac_result.ValueOrDie());
+}
+
+util::StatusOr<size_t> MacSetWrapper::ComputeMacInto(
+    absl::string_view data, absl::Span<char> out) const {
+  data = subtle::SubtleUtilBoringSSL::EnsureNonNull(data);
+
+  auto primary = mac_set_->get_primary();
+  internal::MonitoredOp monitored_op("mac.compute", primary->get_key_id());
+  std::string local_data;
+  if (primary->get_output_prefix_type() == OutputPrefixType::LEGACY) {
+    // The LEGACY suffix byte still costs a copy of the data; no new keys use
+    // this prefix type.
+    local_data = std::string(data);
+    local_data.append(
+        reinterpret_cast<const char*>(&CryptoFormat::kLegacyStartByte), 1);
+    data = local_data;
+  }
+  absl::string_view key_id = primary->get_identifier();
+  if (out.size() < key_id.size()) {
+    monitored_op.SetFailed();
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "Output buffer too small.");
+  }
+  // The output prefix goes in front of the raw tag, both written directly
+  // into the caller's buffer.
+  memcpy(out.data(), key_id.data(), key_id.size());
+  auto tag_size_result = primary->get_primitive().ComputeMacInto(
+      data, out.subspan(key_id.size()));
+  if (!tag_size_result.ok()) {
+    monitored_op.SetFailed();
+    return tag_size_result.status();
+  }
+  primary->IncrementHitCount();
+  return key_id.size() + tag_size_result.ValueOrDie();
+}
+
+const PrimitiveSet<Mac>::Entry<Mac>* MacSetWrapper::TryVerify(
+    const PrimitiveSet<Mac>::Primitives& primitives,
+    absl::string_view raw_mac_value, absl::string_view data) const {
+  for (auto& mac_entry : primitives) {
+    std::string legacy_data;
+    absl::string_view view_on_data_or_legacy_data = data;
+    if (mac_entry->get_output_prefix_type() == OutputPrefixType::LEGACY) {
+      legacy_data = absl::StrCat(data, std::string("\x00", 1));
+      view_on_data_or_legacy_data = legacy_data;
+    }
+    auto mac_or = mac_entry->primitive_or_status();
+    // Skip entries whose lazy materialization failed; other keys may
+    // still succeed.
+    if (!mac_or.ok()) continue;
+    Mac& mac = *mac_or.ValueOrDie();
+    util::Status status =
+        mac.VerifyMac(raw_mac_value, view_on_data_or_legacy_data);
+    if (status.ok()) {
+      return mac_entry;
+    } else {
+      // TODO(przydatek): LOG that a matching key didn't verify the MAC.
+    }
+  }
+  return nullptr;
 }
 
 util::Status MacSetWrapper::VerifyMac(
@@ -86,44 +202,89 @@ util::Status MacSetWrapper::VerifyMac(
   data = subtle::SubtleUtilBoringSSL::EnsureNonNull(data);
   mac_value = subtle::SubtleUtilBoringSSL::EnsureNonNull(mac_value);
 
+  // Until a key matches, failures are attributed to key id 0.
+  internal::MonitoredOp monitored_op("mac.verify", /* key_id = */ 0);
+
   if (mac_value.length() > CryptoFormat::kNonRawPrefixSize) {
     absl::string_view key_id =
         mac_value.substr(0, CryptoFormat::kNonRawPrefixSize);
-    auto primitives_result = mac_set_->get_primitives(key_id);
-    if (primitives_result.ok()) {
-      absl::string_view raw_mac_value =
-          mac_value.substr(CryptoFormat::kNonRawPrefixSize);
-      for (auto& mac_entry : *(primitives_result.ValueOrDie())) {
-        std::string legacy_data;
-        absl::string_view view_on_data_or_legacy_data = data;
-        if (mac_entry->get_output_prefix_type() == OutputPrefixType::LEGACY) {
-          legacy_data = absl::StrCat(data, std::string("\x00", 1));
-          view_on_data_or_legacy_data = legacy_data;
-        }
-        Mac& mac = mac_entry->get_primitive();
-        util::Status status =
-            mac.VerifyMac(raw_mac_value, view_on_data_or_legacy_data);
-        if (status.ok()) {
-          return status;
-        } else {
-          // TODO(przydatek): LOG that a matching key didn't verify the MAC.
-        }
+    const auto* primitives = mac_set_->get_primitives_or_null(key_id);
+    if (primitives != nullptr) {
+      const auto* entry = TryVerify(
+          *primitives, mac_value.substr(CryptoFormat::kNonRawPrefixSize),
+          data);
+      if (entry != nullptr) {
+        entry->IncrementHitCount();
+        monitored_op.set_key_id(entry->get_key_id());
+        return util::Status::OK;
       }
     }
   }
 
   // No matching key succeeded with verification, try all RAW keys.
-  auto raw_primitives_result = mac_set_->get_raw_primitives();
-  if (raw_primitives_result.ok()) {
-    for (auto& mac_entry : *(raw_primitives_result.ValueOrDie())) {
-      Mac& mac = mac_entry->get_primitive();
-      util::Status status = mac.VerifyMac(mac_value, data);
-      if (status.ok()) {
-        return status;
+  const auto* raw_primitives = mac_set_->get_raw_primitives_or_null();
+  if (raw_primitives != nullptr) {
+    const auto* entry = TryVerify(*raw_primitives, mac_value, data);
+    if (entry != nullptr) {
+      entry->IncrementHitCount();
+      monitored_op.set_key_id(entry->get_key_id());
+      return util::Status::OK;
+    }
+  }
+  monitored_op.SetFailed();
+  return VerificationFailedStatus();
+}
+
+util::StatusOr<std::vector<bool>> MacSetWrapper::VerifyMacBatch(
+    absl::Span<const std::pair<absl::string_view, absl::string_view>> items)
+    const {
+  std::vector<bool> results(items.size(), false);
+  internal::MonitoredOp monitored_op("mac.verify_batch", /* key_id = */ 0);
+
+  // Batches typically verify long runs of chunks authenticated with the
+  // same key, so the prefix group is resolved only when the prefix changes
+  // from the previous item; the RAW group is resolved once per batch.
+  absl::string_view cached_prefix;
+  const PrimitiveSet<Mac>::Primitives* cached_primitives = nullptr;
+  bool has_cached_prefix = false;
+  const auto* raw_primitives = mac_set_->get_raw_primitives_or_null();
+
+  bool all_ok = true;
+  for (size_t i = 0; i < items.size(); ++i) {
+    absl::string_view mac_value =
+        subtle::SubtleUtilBoringSSL::EnsureNonNull(items[i].first);
+    absl::string_view data =
+        subtle::SubtleUtilBoringSSL::EnsureNonNull(items[i].second);
+
+    const PrimitiveSet<Mac>::Entry<Mac>* entry = nullptr;
+    if (mac_value.length() > CryptoFormat::kNonRawPrefixSize) {
+      absl::string_view prefix =
+          mac_value.substr(0, CryptoFormat::kNonRawPrefixSize);
+      if (!has_cached_prefix || prefix != cached_prefix) {
+        cached_primitives = mac_set_->get_primitives_or_null(prefix);
+        cached_prefix = prefix;
+        has_cached_prefix = true;
+      }
+      if (cached_primitives != nullptr) {
+        entry = TryVerify(*cached_primitives,
+                          mac_value.substr(CryptoFormat::kNonRawPrefixSize),
+                          data);
       }
     }
+    if (entry == nullptr && raw_primitives != nullptr) {
+      entry = TryVerify(*raw_primitives, mac_value, data);
+    }
+    if (entry != nullptr) {
+      entry->IncrementHitCount();
+      results[i] = true;
+    } else {
+      all_ok = false;
+    }
+  }
+  if (!all_ok) {
+    monitored_op.SetFailed();
   }
-  return util::Status(util::error::INVALID_ARGUMENT, "verification failed");
+  return results;
 }
 
 }  // namespace
@@ -132,6 +293,7 @@ util::StatusOr<std::unique_ptr<Mac>> MacWrapper::Wrap(
       std::unique_ptr<PrimitiveSet<Mac>> mac_set) const {
   util::Status status = Validate(mac_set.get());
   if (!status.ok()) return status;
+  mac_set->Seal();
   std::unique_ptr<Mac> mac(new MacSetWrapper(std::move(mac_set)));
   return std::move(mac);
 }
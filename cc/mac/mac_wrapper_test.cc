@@ -16,14 +16,19 @@
 
 #include "tink/mac/mac_wrapper.h"
 
+#include <utility>
+#include <vector>
+
 #include "gtest/gtest.h"
 #include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
 #include "tink/crypto_format.h"
 #include "tink/mac.h"
 #include "tink/primitive_set.h"
 #include "tink/util/status.h"
 #include "tink/util/test_matchers.h"
 #include "tink/util/test_util.h"
+#include "tink/warmup.h"
 #include "proto/tink.pb.h"
 
 using crypto::tink::test::DummyMac;
@@ -112,6 +117,151 @@ TEST(MacWrapperTest, Basic) {
                       status.error_message());
 }
 
+TEST(MacWrapperTest, Warmup) {
+  KeysetInfo keyset_info;
+  KeysetInfo::KeyInfo* key_info = keyset_info.add_key_info();
+  key_info->set_output_prefix_type(OutputPrefixType::TINK);
+  key_info->set_key_id(1234543);
+  key_info->set_status(KeyStatusType::ENABLED);
+  key_info = keyset_info.add_key_info();
+  key_info->set_output_prefix_type(OutputPrefixType::RAW);
+  key_info->set_key_id(726329);
+  key_info->set_status(KeyStatusType::ENABLED);
+
+  std::unique_ptr<PrimitiveSet<Mac>> mac_set(new PrimitiveSet<Mac>());
+  auto entry_result = mac_set->AddPrimitive(absl::make_unique<DummyMac>("mac0"),
+                                            keyset_info.key_info(0));
+  ASSERT_TRUE(entry_result.ok());
+  ASSERT_THAT(mac_set->set_primary(entry_result.ValueOrDie()), IsOk());
+  entry_result = mac_set->AddPrimitive(absl::make_unique<DummyMac>("mac1"),
+                                       keyset_info.key_info(1));
+  ASSERT_TRUE(entry_result.ok());
+
+  auto mac_result = MacWrapper().Wrap(std::move(mac_set));
+  ASSERT_TRUE(mac_result.ok()) << mac_result.status();
+  std::unique_ptr<Mac> mac = std::move(mac_result.ValueOrDie());
+
+  // The wrapped Mac supports warmup via dynamic_cast; warming computes and
+  // verifies a dummy MAC with every key.
+  auto* warmable = dynamic_cast<const Warmable*>(mac.get());
+  ASSERT_NE(warmable, nullptr);
+  EXPECT_THAT(warmable->Warmup(), IsOk());
+
+  // Real operations still work after warmup.
+  std::string data = "some_data_for_mac";
+  auto compute_mac_result = mac->ComputeMac(data);
+  ASSERT_TRUE(compute_mac_result.ok()) << compute_mac_result.status();
+  EXPECT_TRUE(mac->VerifyMac(compute_mac_result.ValueOrDie(), data).ok());
+}
+
+TEST(MacWrapperTest, ComputeMacInto) {
+  uint32_t key_id = 1234543;
+  KeysetInfo keyset_info;
+  KeysetInfo::KeyInfo* key_info = keyset_info.add_key_info();
+  key_info->set_output_prefix_type(OutputPrefixType::TINK);
+  key_info->set_key_id(key_id);
+  key_info->set_status(KeyStatusType::ENABLED);
+
+  std::unique_ptr<PrimitiveSet<Mac>> mac_set(new PrimitiveSet<Mac>());
+  auto entry_result = mac_set->AddPrimitive(absl::make_unique<DummyMac>("mac0"),
+                                            keyset_info.key_info(0));
+  ASSERT_TRUE(entry_result.ok());
+  ASSERT_THAT(mac_set->set_primary(entry_result.ValueOrDie()), IsOk());
+
+  auto mac_result = MacWrapper().Wrap(std::move(mac_set));
+  ASSERT_TRUE(mac_result.ok()) << mac_result.status();
+  std::unique_ptr<Mac> mac = std::move(mac_result.ValueOrDie());
+  std::string data = "some_data_for_mac";
+
+  std::string expected = mac->ComputeMac(data).ValueOrDie();
+  std::string buffer(expected.size() + 16, '\0');
+  auto size_result =
+      mac->ComputeMacInto(data, absl::Span<char>(&buffer[0], buffer.size()));
+  ASSERT_TRUE(size_result.ok()) << size_result.status();
+  buffer.resize(size_result.ValueOrDie());
+  // Prefix plus tag written into the buffer match the allocating API, and
+  // the result verifies.
+  EXPECT_EQ(buffer, expected);
+  EXPECT_THAT(mac->VerifyMac(buffer, data), IsOk());
+
+  // A buffer that cannot even hold the output prefix is rejected.
+  std::string small_buffer(CryptoFormat::kNonRawPrefixSize - 1, '\0');
+  EXPECT_FALSE(
+      mac->ComputeMacInto(data, absl::Span<char>(&small_buffer[0],
+                                                 small_buffer.size()))
+          .ok());
+}
+
+TEST(MacWrapperTest, VerifyMacBatch) {
+  KeysetInfo::KeyInfo* key_info;
+  KeysetInfo keyset_info;
+
+  key_info = keyset_info.add_key_info();
+  key_info->set_output_prefix_type(OutputPrefixType::TINK);
+  key_info->set_key_id(1234543);
+  key_info->set_status(KeyStatusType::ENABLED);
+
+  key_info = keyset_info.add_key_info();
+  key_info->set_output_prefix_type(OutputPrefixType::LEGACY);
+  key_info->set_key_id(726329);
+  key_info->set_status(KeyStatusType::ENABLED);
+
+  key_info = keyset_info.add_key_info();
+  key_info->set_output_prefix_type(OutputPrefixType::RAW);
+  key_info->set_key_id(7213743);
+  key_info->set_status(KeyStatusType::ENABLED);
+
+  std::string mac_name_0 = "mac0";
+  std::string mac_name_1 = "mac1";
+  std::string mac_name_2 = "mac2";
+  std::unique_ptr<PrimitiveSet<Mac>> mac_set(new PrimitiveSet<Mac>());
+  auto entry_result = mac_set->AddPrimitive(
+      absl::make_unique<DummyMac>(mac_name_0), keyset_info.key_info(0));
+  ASSERT_TRUE(entry_result.ok());
+  ASSERT_THAT(mac_set->set_primary(entry_result.ValueOrDie()), IsOk());
+  entry_result = mac_set->AddPrimitive(absl::make_unique<DummyMac>(mac_name_1),
+                                       keyset_info.key_info(1));
+  ASSERT_TRUE(entry_result.ok());
+  entry_result = mac_set->AddPrimitive(absl::make_unique<DummyMac>(mac_name_2),
+                                       keyset_info.key_info(2));
+  ASSERT_TRUE(entry_result.ok());
+
+  auto mac_result = MacWrapper().Wrap(std::move(mac_set));
+  EXPECT_TRUE(mac_result.ok()) << mac_result.status();
+  std::unique_ptr<Mac> mac = std::move(mac_result.ValueOrDie());
+
+  // A run of tags under the primary (TINK) key, one tag under the RAW key,
+  // one corrupted tag, and one tag over modified data.
+  std::string data_0 = "data piece 0";
+  std::string data_1 = "data piece 1";
+  std::string data_2 = "data piece 2";
+  std::string mac_value_0 = mac->ComputeMac(data_0).ValueOrDie();
+  std::string mac_value_1 = mac->ComputeMac(data_1).ValueOrDie();
+  std::string raw_mac_value_2 =
+      DummyMac(mac_name_2).ComputeMac(data_2).ValueOrDie();
+
+  std::vector<std::pair<absl::string_view, absl::string_view>> items = {
+      {mac_value_0, data_0},
+      {mac_value_1, data_1},
+      {raw_mac_value_2, data_2},
+      {"some bad mac", data_0},
+      {mac_value_0, data_1}};
+  auto results_result = mac->VerifyMacBatch(items);
+  ASSERT_TRUE(results_result.ok()) << results_result.status();
+  std::vector<bool> results = results_result.ValueOrDie();
+  ASSERT_EQ(items.size(), results.size());
+  EXPECT_TRUE(results[0]);
+  EXPECT_TRUE(results[1]);
+  EXPECT_TRUE(results[2]);
+  EXPECT_FALSE(results[3]);
+  EXPECT_FALSE(results[4]);
+
+  // An empty batch is valid and yields an empty result vector.
+  auto empty_results_result = mac->VerifyMacBatch({});
+  ASSERT_TRUE(empty_results_result.ok()) << empty_results_result.status();
+  EXPECT_TRUE(empty_results_result.ValueOrDie().empty());
+}
+
 TEST(MacWrapperTest, testLegacyAuthentication) {
   // Prepare a set for the wrapper.
   KeysetInfo::KeyInfo key_info;
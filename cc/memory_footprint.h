@@ -0,0 +1,57 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_MEMORY_FOOTPRINT_H_
+#define TINK_MEMORY_FOOTPRINT_H_
+
+#include <cstddef>
+
+namespace crypto {
+namespace tink {
+
+///////////////////////////////////////////////////////////////////////////////
+// Optional introspection interface reporting the memory held by a primitive.
+//
+// Primitive implementations which know the size of their internal state
+// (cipher contexts, precomputed tables, key material) implement this
+// interface alongside their primitive interface; callers discover support
+// via dynamic_cast:
+//
+//   auto* provider = dynamic_cast<const MemoryFootprintProvider*>(aead.get());
+//   if (provider != nullptr) {
+//     bytes = provider->MemoryFootprint();
+//   }
+//
+// Primitives obtained through KeysetHandle::GetPrimitive() are wrapper
+// objects; those wrappers implement this interface by summing the footprints
+// of the keyset's individual primitives, so the reported value covers the
+// whole wrapped keyset.
+class MemoryFootprintProvider {
+ public:
+  // Returns an estimate of the number of bytes of memory held alive by this
+  // object, including the object itself and its owned allocations. The value
+  // is intended for capacity planning and admission control; it need not be
+  // byte-exact, but should track the real consumption closely enough that
+  // packing by the reported sizes does not overcommit.
+  virtual size_t MemoryFootprint() const = 0;
+
+  virtual ~MemoryFootprintProvider() {}
+};
+
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_MEMORY_FOOTPRINT_H_
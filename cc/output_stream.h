@@ -17,6 +17,7 @@
 #ifndef TINK_OUTPUT_STREAM_H_
 #define TINK_OUTPUT_STREAM_H_
 
+#include "absl/types/span.h"
 #include "tink/util/status.h"
 #include "tink/util/statusor.h"
 
@@ -94,6 +95,32 @@ class OutputStream {
   //   to non-const methods will fail.
   virtual crypto::tink::util::Status Close() = 0;
 
+  // Writes the given 'chunks' of data to this stream, in order, as if
+  // their concatenation was copied into buffers obtained via Next().
+  // Implementations that support this method hand the chunks to the
+  // destination directly (e.g. via scatter/gather I/O like writev(2)),
+  // skipping the copy into the stream's internal buffer.
+  //
+  // Preconditions:
+  // * All the space obtained via previous calls to Next() (if any) was
+  //   either filled with data to be written or returned via BackUp().
+  // * Each chunk must remain valid until this method returns.
+  //
+  // Postconditions:
+  // * If the returned status is OK, all the bytes of all the chunks will
+  //   eventually be written to the output, after any data written via
+  //   previous calls to Next(), and Position() includes them.
+  // * If the returned status is UNIMPLEMENTED, this stream does not
+  //   support direct writes, no bytes were consumed, and the caller
+  //   should fall back to the Next()/BackUp()-protocol.
+  // * Any other non-OK status indicates a permanent error.
+  virtual crypto::tink::util::Status WriteChunks(
+      absl::Span<const absl::Span<const uint8_t>> /* chunks */) {
+    return crypto::tink::util::Status(
+        crypto::tink::util::error::UNIMPLEMENTED,
+        "WriteChunks is not supported by this output stream");
+  }
+
   // Returns the total number of bytes written since this object was created.
   // Preconditions:
   // * The most recent call to Next() (if any) was successful, or the stream
@@ -16,9 +16,62 @@
 
 #include "tink/prf/prf_set.h"
 
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
 namespace crypto {
 namespace tink {
 
+util::StatusOr<std::vector<std::string>> Prf::ComputeBatch(
+    absl::Span<const absl::string_view> inputs, size_t output_length) const {
+  std::vector<std::string> outputs;
+  outputs.reserve(inputs.size());
+  for (absl::string_view input : inputs) {
+    auto output_result = Compute(input, output_length);
+    if (!output_result.ok()) {
+      return output_result.status();
+    }
+    outputs.push_back(std::move(output_result.ValueOrDie()));
+  }
+  return outputs;
+}
+
+util::Status Prf::ComputeInto(absl::string_view input,
+                              absl::Span<char> output) const {
+  auto output_result = Compute(input, output.size());
+  if (!output_result.ok()) {
+    return output_result.status();
+  }
+  const std::string& bytes = output_result.ValueOrDie();
+  if (bytes.size() != output.size()) {
+    return util::Status(util::error::INTERNAL,
+                        "PRF returned an output of unexpected length.");
+  }
+  std::memcpy(output.data(), bytes.data(), bytes.size());
+  return util::OkStatus();
+}
+
+util::Status Prf::ComputeBatchInto(absl::Span<const absl::string_view> inputs,
+                                   size_t output_length,
+                                   absl::Span<char> outputs) const {
+  if (outputs.size() != inputs.size() * output_length) {
+    return util::Status(
+        util::error::INVALID_ARGUMENT,
+        "outputs must hold exactly output_length bytes per input");
+  }
+  for (size_t i = 0; i < inputs.size(); i++) {
+    auto status =
+        ComputeInto(inputs[i], outputs.subspan(i * output_length,
+                                               output_length));
+    if (!status.ok()) {
+      return status;
+    }
+  }
+  return util::OkStatus();
+}
+
 util::StatusOr<std::string> PrfSet::ComputePrimary(absl::string_view input,
                                                    size_t output_length) const {
   auto prfs = GetPrfs();
@@ -30,5 +83,39 @@ util::StatusOr<std::string> PrfSet::ComputePrimary(absl::string_view input,
   return prf_it->second->Compute(input, output_length);
 }
 
+util::StatusOr<std::vector<std::string>> PrfSet::ComputeBatchPrimary(
+    absl::Span<const absl::string_view> inputs, size_t output_length) const {
+  auto prfs = GetPrfs();
+  auto prf_it = prfs.find(GetPrimaryId());
+  if (prf_it == prfs.end()) {
+    return util::Status(util::error::INTERNAL,
+                        "PrfSet has no PRF for primary ID.");
+  }
+  return prf_it->second->ComputeBatch(inputs, output_length);
+}
+
+util::Status PrfSet::ComputePrimaryInto(absl::string_view input,
+                                        absl::Span<char> output) const {
+  auto prfs = GetPrfs();
+  auto prf_it = prfs.find(GetPrimaryId());
+  if (prf_it == prfs.end()) {
+    return util::Status(util::error::INTERNAL,
+                        "PrfSet has no PRF for primary ID.");
+  }
+  return prf_it->second->ComputeInto(input, output);
+}
+
+util::Status PrfSet::ComputeBatchPrimaryInto(
+    absl::Span<const absl::string_view> inputs, size_t output_length,
+    absl::Span<char> outputs) const {
+  auto prfs = GetPrfs();
+  auto prf_it = prfs.find(GetPrimaryId());
+  if (prf_it == prfs.end()) {
+    return util::Status(util::error::INTERNAL,
+                        "PrfSet has no PRF for primary ID.");
+  }
+  return prf_it->second->ComputeBatchInto(inputs, output_length, outputs);
+}
+
 }  // namespace tink
 }  // namespace crypto
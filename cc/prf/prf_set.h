@@ -18,8 +18,11 @@
 #define TINK_PRF_PRF_SET_H_
 
 #include <map>
+#include <string>
+#include <vector>
 
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "tink/util/statusor.h"
 
 namespace crypto {
@@ -58,6 +61,29 @@ class Prf {
   // algorithm is less than outputLength.
   virtual util::StatusOr<std::string> Compute(absl::string_view input,
                                               size_t output_length) const = 0;
+  // Computes the PRF on every element of inputs and returns the first
+  // output_length bytes of each output, in input order. The result is
+  // equivalent to calling Compute once per input, but implementations may
+  // amortize per-call setup (e.g. MAC context initialization) over the whole
+  // batch, which matters when deriving outputs for many small inputs.
+  virtual util::StatusOr<std::vector<std::string>> ComputeBatch(
+      absl::Span<const absl::string_view> inputs, size_t output_length) const;
+  // Computes the PRF on 'input' and writes the first output.size() bytes of
+  // its output into 'output', without allocating a result string. The
+  // truncation rules of Compute() apply; see there for how to pick the
+  // length. The default implementation funnels through Compute().
+  virtual util::Status ComputeInto(absl::string_view input,
+                                   absl::Span<char> output) const;
+  // Computes the PRF on every element of 'inputs', truncated to
+  // 'output_length' bytes each, and writes the results contiguously into
+  // 'outputs' (the i-th output starts at offset i * output_length); the size
+  // of 'outputs' must be exactly inputs.size() * output_length. Equivalent
+  // to ComputeInto() per input, but implementations may amortize per-call
+  // setup over the batch, and the fixed-width packed layout feeds columnar
+  // consumers (e.g. partition-key derivation) without any per-row strings.
+  virtual util::Status ComputeBatchInto(
+      absl::Span<const absl::string_view> inputs, size_t output_length,
+      absl::Span<char> outputs) const;
 };
 
 // A Tink Keyset can be converted into a set of PRFs using this primitive. Every
@@ -76,6 +102,20 @@ class PrfSet {
   // See PRF.compute for details of the parameters.
   util::StatusOr<std::string> ComputePrimary(absl::string_view input,
                                              size_t output_length) const;
+  // Convenience method to compute the primary PRF on a batch of inputs.
+  // See Prf::ComputeBatch for details of the parameters.
+  util::StatusOr<std::vector<std::string>> ComputeBatchPrimary(
+      absl::Span<const absl::string_view> inputs, size_t output_length) const;
+  // Convenience method to compute the primary PRF into a caller-provided
+  // buffer. See Prf::ComputeInto for details of the parameters.
+  util::Status ComputePrimaryInto(absl::string_view input,
+                                  absl::Span<char> output) const;
+  // Convenience method to compute the primary PRF on a batch of inputs into
+  // a contiguous fixed-width buffer. See Prf::ComputeBatchInto for details
+  // of the parameters.
+  util::Status ComputeBatchPrimaryInto(
+      absl::Span<const absl::string_view> inputs, size_t output_length,
+      absl::Span<char> outputs) const;
 };
 
 }  // namespace tink
@@ -17,12 +17,14 @@
 #include "tink/prf/prf_set.h"
 
 #include <map>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/memory/memory.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "tink/keyset_handle.h"
 #include "tink/keyset_manager.h"
 #include "tink/prf/prf_config.h"
@@ -37,6 +39,7 @@ namespace {
 
 using ::crypto::tink::test::IsOk;
 using ::testing::_;
+using ::testing::ElementsAre;
 using ::testing::Eq;
 using ::testing::Pair;
 using ::testing::SizeIs;
@@ -83,6 +86,48 @@ TEST(PrfSetTest, ComputePrimary) {
       << "Expected broken PrfSet to not be able to compute the primary PRF";
 }
 
+TEST(PrfSetTest, ComputeBatchPrimary) {
+  DummyPrfSet prfset;
+  std::vector<absl::string_view> inputs = {"DummyInput", "DummyInput2"};
+  auto outputs = prfset.ComputeBatchPrimary(absl::MakeConstSpan(inputs), 16);
+  ASSERT_TRUE(outputs.ok()) << outputs.status();
+  EXPECT_THAT(outputs.ValueOrDie(), ElementsAre("DummyPRF", "DummyPRF"));
+  BrokenDummyPrfSet broken_prfset;
+  auto broken_outputs =
+      broken_prfset.ComputeBatchPrimary(absl::MakeConstSpan(inputs), 16);
+  EXPECT_FALSE(broken_outputs.ok())
+      << "Expected broken PrfSet to not be able to compute the primary PRF";
+}
+
+TEST(PrfSetTest, ComputePrimaryInto) {
+  DummyPrfSet prfset;
+  // DummyPrf always produces the 8 bytes "DummyPRF".
+  std::string output(8, '\0');
+  auto status =
+      prfset.ComputePrimaryInto("DummyInput", absl::MakeSpan(&output[0], 8));
+  EXPECT_TRUE(status.ok()) << status;
+  EXPECT_THAT(output, StrEq("DummyPRF"));
+  BrokenDummyPrfSet broken_prfset;
+  auto broken_status = broken_prfset.ComputePrimaryInto(
+      "DummyInput", absl::MakeSpan(&output[0], 8));
+  EXPECT_FALSE(broken_status.ok())
+      << "Expected broken PrfSet to not be able to compute the primary PRF";
+}
+
+TEST(PrfSetTest, ComputeBatchPrimaryInto) {
+  DummyPrfSet prfset;
+  std::vector<absl::string_view> inputs = {"DummyInput", "DummyInput2"};
+  std::string outputs(16, '\0');
+  auto status = prfset.ComputeBatchPrimaryInto(
+      absl::MakeConstSpan(inputs), 8, absl::MakeSpan(&outputs[0], 16));
+  EXPECT_TRUE(status.ok()) << status;
+  EXPECT_THAT(outputs, StrEq("DummyPRFDummyPRF"));
+  // The buffer must hold exactly output_length bytes per input.
+  auto bad_size_status = prfset.ComputeBatchPrimaryInto(
+      absl::MakeConstSpan(inputs), 8, absl::MakeSpan(&outputs[0], 15));
+  EXPECT_FALSE(bad_size_status.ok());
+}
+
 TEST(PrfSetWrapperTest, TestPrimitivesEndToEnd) {
   auto status = PrfConfig::Register();
   ASSERT_TRUE(status.ok()) << status;
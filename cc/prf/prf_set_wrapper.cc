@@ -70,6 +70,14 @@ util::StatusOr<std::unique_ptr<PrfSet>> PrfSetWrapper::Wrap(
     std::unique_ptr<PrimitiveSet<Prf>> prf_set) const {
   util::Status status = Validate(prf_set.get());
   if (!status.ok()) return status;
+  // GetPrfs() hands out raw Prf pointers for all keys, so every entry must be
+  // materialized up front; this also surfaces construction errors of lazily
+  // added entries here rather than at the point of use.
+  for (auto entry : prf_set->get_all()) {
+    auto prf_or = entry->primitive_or_status();
+    if (!prf_or.ok()) return prf_or.status();
+  }
+  prf_set->Seal();
   return {absl::make_unique<PrfSetPrimitiveWrapper>(std::move(prf_set))};
 }
 
@@ -17,12 +17,22 @@
 #ifndef TINK_PRIMITIVE_SET_H_
 #define TINK_PRIMITIVE_SET_H_
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
-#include "absl/memory/memory.h"
+#include "absl/base/call_once.h"
+#include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
 #include "tink/crypto_format.h"
+#include "tink/memory_footprint.h"
 #include "tink/util/errors.h"
 #include "tink/util/statusor.h"
 #include "proto/tink.pb.h"
@@ -48,35 +58,90 @@ namespace tink {
 //
 // PrimitiveSet is a public class to allow its use in implementations
 // of custom primitives.
+//
+// New code should construct sets through PrimitiveSet::Builder, which
+// hands out the finished set already sealed; the mutable AddPrimitive()/
+// set_primary() interface below remains for existing callers.
 template <class P>
 class PrimitiveSet {
  public:
   // Entry-objects hold individual instances of primitives in the set.
+  // They are created only by the Add-methods of the set, which
+  // validate the key info and construct the entry in place in the arena
+  // owned by the set; the ConstructionToken below makes the public
+  // constructors unusable elsewhere.
   template <class P2>
   class Entry {
    public:
-    static crypto::tink::util::StatusOr<std::unique_ptr<Entry<P>>> New(
-        std::unique_ptr<P> primitive,
-        const google::crypto::tink::KeysetInfo::KeyInfo& key_info) {
-      if (key_info.status() != google::crypto::tink::KeyStatusType::ENABLED) {
-        return util::Status(crypto::tink::util::error::INVALID_ARGUMENT,
-                            "The key must be ENABLED.");
-      }
-      auto identifier_result = CryptoFormat::GetOutputPrefix(key_info);
-      if (!identifier_result.ok()) return identifier_result.status();
-      if (primitive == nullptr) {
-        return util::Status(crypto::tink::util::error::INVALID_ARGUMENT,
-                            "The primitive must be non-null.");
+    class ConstructionToken {
+     private:
+      ConstructionToken() {}
+      friend class PrimitiveSet<P>;
+    };
+
+    Entry(ConstructionToken, std::shared_ptr<P2> primitive,
+          absl::string_view identifier,
+          google::crypto::tink::KeyStatusType status, uint32_t key_id,
+          google::crypto::tink::OutputPrefixType output_prefix_type)
+        : primitive_(std::move(primitive)),
+          status_(status),
+          key_id_(key_id),
+          output_prefix_type_(output_prefix_type) {
+      SetIdentifier(identifier);
+    }
+
+    Entry(ConstructionToken,
+          std::function<crypto::tink::util::StatusOr<std::unique_ptr<P2>>()>
+              primitive_factory,
+          absl::string_view identifier,
+          google::crypto::tink::KeyStatusType status, uint32_t key_id,
+          google::crypto::tink::OutputPrefixType output_prefix_type)
+        : primitive_factory_(std::move(primitive_factory)),
+          status_(status),
+          key_id_(key_id),
+          output_prefix_type_(output_prefix_type) {
+      SetIdentifier(identifier);
+    }
+
+    // Returns the primitive, materializing it first if this entry was created
+    // lazily. If the factory fails, the error is sticky and returned on every
+    // subsequent call.
+    crypto::tink::util::StatusOr<P2*> primitive_or_status() const {
+      absl::call_once(primitive_once_, [this]() {
+        if (primitive_ == nullptr && primitive_factory_) {
+          auto result = primitive_factory_();
+          if (result.ok()) {
+            primitive_ = std::move(result.ValueOrDie());
+          } else {
+            materialization_status_ = result.status();
+          }
+        }
+      });
+      if (primitive_ == nullptr) {
+        if (!materialization_status_.ok()) return materialization_status_;
+        return util::Status(crypto::tink::util::error::INTERNAL,
+                            "Primitive is not available.");
       }
-      std::string identifier = identifier_result.ValueOrDie();
-      return absl::WrapUnique(new Entry(std::move(primitive), identifier,
-                                        key_info.status(), key_info.key_id(),
-                                        key_info.output_prefix_type()));
+      return primitive_.get();
     }
 
-    P2& get_primitive() const { return *primitive_; }
+    // Precondition: the entry was created eagerly, or the materialization of
+    // a lazy entry is known to succeed; use primitive_or_status() otherwise.
+    P2& get_primitive() const { return *primitive_or_status().ValueOrDie(); }
 
-    const std::string& get_identifier() const { return identifier_; }
+    // Returns the primitive if it has already been constructed, or nullptr
+    // for a lazy entry that has not materialized yet; never triggers
+    // materialization. Lets wrappers inspect the concrete types of a set at
+    // wrap time without defeating lazy construction.
+    const P* primitive_or_null() const { return primitive_.get(); }
+
+    // Returns the output prefix of this entry's key: empty for RAW keys,
+    // exactly kNonRawPrefixSize bytes otherwise. The bytes live inline in
+    // the entry, so reading the prefix on the per-operation encrypt path
+    // touches no separately allocated string.
+    absl::string_view get_identifier() const {
+      return absl::string_view(identifier_, identifier_size_);
+    }
 
     google::crypto::tink::KeyStatusType get_status() const { return status_; }
 
@@ -86,24 +151,170 @@ class PrimitiveSet {
       return output_prefix_type_;
     }
 
+    // Returns how many operations have used this entry so far; see
+    // IncrementHitCount().
+    uint64_t hit_count() const {
+      return hit_count_.load(std::memory_order_relaxed);
+    }
+
+    // Records that an operation used this entry's primitive; for decryption
+    // and verification the wrappers call this on the entry whose key
+    // matched. A single relaxed atomic increment, so it is thread-safe and
+    // adds no measurable cost to the operation itself.
+    void IncrementHitCount() const {
+      hit_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Returns the bytes attributable to this entry: the entry object itself
+    // plus, if the primitive has been constructed and reports its own size
+    // (see MemoryFootprintProvider), the primitive's footprint. A lazy entry
+    // whose primitive has not been materialized yet counts only itself; a
+    // primitive which does not implement MemoryFootprintProvider contributes
+    // only the entry, making the result a lower bound.
+    size_t MemoryFootprint() const {
+      size_t result = sizeof(*this);
+      // Best-effort read: a lazy primitive materializing concurrently may or
+      // may not be counted. Admission controllers measure sets which are not
+      // serving traffic yet, where this cannot happen.
+      const P* primitive = primitive_.get();
+      if (primitive != nullptr) {
+        auto* provider =
+            dynamic_cast<const MemoryFootprintProvider*>(primitive);
+        if (provider != nullptr) {
+          result += provider->MemoryFootprint();
+        }
+      }
+      return result;
+    }
+
    private:
-    Entry(std::unique_ptr<P2> primitive, const std::string& identifier,
-          google::crypto::tink::KeyStatusType status, uint32_t key_id,
-          google::crypto::tink::OutputPrefixType output_prefix_type)
-        : primitive_(std::move(primitive)),
-          identifier_(identifier),
-          status_(status),
-          key_id_(key_id),
-          output_prefix_type_(output_prefix_type) {}
+    // AddEntryFrom() reads primitive_ and primitive_factory_ of the source
+    // entry when cloning it into another set.
+    friend class PrimitiveSet<P>;
 
-    std::unique_ptr<P> primitive_;
-    std::string identifier_;
+    void SetIdentifier(absl::string_view identifier) {
+      // CryptoFormat produces only empty or kNonRawPrefixSize prefixes.
+      identifier_size_ = std::min(
+          identifier.size(), static_cast<size_t>(CryptoFormat::kNonRawPrefixSize));
+      std::memcpy(identifier_, identifier.data(), identifier_size_);
+    }
+
+    // Guards the one-time materialization of lazy entries; a no-op for eager
+    // entries.
+    mutable absl::once_flag primitive_once_;
+    // Shared so that a set built incrementally from a previous one (see
+    // AddEntryFrom()) can reuse an already-constructed primitive instead
+    // of rebuilding it; entries built normally are the sole owner.
+    mutable std::shared_ptr<P> primitive_;
+    mutable crypto::tink::util::Status materialization_status_;
+    std::function<crypto::tink::util::StatusOr<std::unique_ptr<P>>()>
+        primitive_factory_;
+    // Output prefix, stored inline; see get_identifier().
+    char identifier_[CryptoFormat::kNonRawPrefixSize];
+    uint8_t identifier_size_;
     google::crypto::tink::KeyStatusType status_;
     uint32_t key_id_;
     google::crypto::tink::OutputPrefixType output_prefix_type_;
+    mutable std::atomic<uint64_t> hit_count_{0};
   };
 
-  typedef std::vector<std::unique_ptr<Entry<P>>> Primitives;
+  // The entries themselves are owned by the set and live contiguously in
+  // entries_; the per-prefix groups hold plain pointers, so the trial loops
+  // of the wrappers scan entries whose metadata (prefix bytes, key id,
+  // status) sits in adjacent memory instead of one heap object per key.
+  typedef std::vector<Entry<P>*> Primitives;
+
+  // Separates the construction of a set from its serving: a Builder collects
+  // the entries and hands out the finished set already sealed, so consumers
+  // only ever observe the immutable, mutex-free read path (see Seal()).
+  // Errors of the Add-calls are deferred and reported by Build(), which
+  // keeps call sites free of per-key error plumbing; the first error wins
+  // and later calls are ignored. A Builder is single-use: Build() consumes
+  // it.
+  class Builder {
+   public:
+    Builder() : set_(new PrimitiveSet<P>()) {}
+
+    // Adds 'primitive' to the set under construction for the key described
+    // by 'key_info'.
+    Builder& AddPrimitive(
+        std::unique_ptr<P> primitive,
+        const google::crypto::tink::KeysetInfo::KeyInfo& key_info) {
+      if (!status_.ok()) return *this;
+      auto entry = set_->AddPrimitive(std::move(primitive), key_info);
+      if (!entry.ok()) status_ = entry.status();
+      return *this;
+    }
+
+    // Like AddPrimitive(), and additionally makes the added entry the
+    // primary of the set.
+    Builder& AddPrimaryPrimitive(
+        std::unique_ptr<P> primitive,
+        const google::crypto::tink::KeysetInfo::KeyInfo& key_info) {
+      if (!status_.ok()) return *this;
+      auto entry = set_->AddPrimitive(std::move(primitive), key_info);
+      if (!entry.ok()) {
+        status_ = entry.status();
+        return *this;
+      }
+      status_ = set_->set_primary(entry.ValueOrDie());
+      return *this;
+    }
+
+    // Adds an entry whose primitive is constructed by 'primitive_factory'
+    // on first use; see PrimitiveSet::AddLazyPrimitive().
+    Builder& AddLazyPrimitive(
+        std::function<crypto::tink::util::StatusOr<std::unique_ptr<P>>()>
+            primitive_factory,
+        const google::crypto::tink::KeysetInfo::KeyInfo& key_info) {
+      if (!status_.ok()) return *this;
+      auto entry =
+          set_->AddLazyPrimitive(std::move(primitive_factory), key_info);
+      if (!entry.ok()) status_ = entry.status();
+      return *this;
+    }
+
+    // Adds an entry which reuses the primitive (or pending factory) of
+    // 'source', an entry of a previously built set for the same key; see
+    // PrimitiveSet::AddEntryFrom().
+    Builder& AddEntryFrom(
+        const Entry<P>& source,
+        const google::crypto::tink::KeysetInfo::KeyInfo& key_info) {
+      if (!status_.ok()) return *this;
+      auto entry = set_->AddEntryFrom(source, key_info);
+      if (!entry.ok()) status_ = entry.status();
+      return *this;
+    }
+
+    // Like AddEntryFrom(), and additionally makes the added entry the
+    // primary of the set.
+    Builder& AddPrimaryEntryFrom(
+        const Entry<P>& source,
+        const google::crypto::tink::KeysetInfo::KeyInfo& key_info) {
+      if (!status_.ok()) return *this;
+      auto entry = set_->AddEntryFrom(source, key_info);
+      if (!entry.ok()) {
+        status_ = entry.status();
+        return *this;
+      }
+      status_ = set_->set_primary(entry.ValueOrDie());
+      return *this;
+    }
+
+    // Returns the collected set, sealed, or the first error any Add-call
+    // produced. Whether a primary is required is the business of the
+    // consuming wrapper (signature verification, e.g., serves sets without
+    // one), so Build() does not enforce it.
+    crypto::tink::util::StatusOr<std::unique_ptr<PrimitiveSet<P>>> Build() && {
+      if (!status_.ok()) return status_;
+      set_->Seal();
+      return std::move(set_);
+    }
+
+   private:
+    std::unique_ptr<PrimitiveSet<P>> set_;
+    crypto::tink::util::Status status_;
+  };
 
   // Constructs an empty PrimitiveSet.
   PrimitiveSet<P>() : primary_(nullptr) {}
@@ -112,18 +323,152 @@ class PrimitiveSet {
   crypto::tink::util::StatusOr<Entry<P>*> AddPrimitive(
       std::unique_ptr<P> primitive,
       const google::crypto::tink::KeysetInfo::KeyInfo& key_info) {
-    auto entry_or = Entry<P>::New(std::move(primitive), key_info);
-    if (!entry_or.ok()) return entry_or.status();
+    if (primitive == nullptr) {
+      return util::Status(crypto::tink::util::error::INVALID_ARGUMENT,
+                          "The primitive must be non-null.");
+    }
+    auto identifier_result = ValidateAndGetIdentifier(key_info);
+    if (!identifier_result.ok()) return identifier_result.status();
 
+    if (is_sealed()) {
+      return util::Status(crypto::tink::util::error::FAILED_PRECONDITION,
+                          "Cannot add primitives to a sealed PrimitiveSet.");
+    }
     absl::MutexLock lock(&primitives_mutex_);
-    std::string identifier = entry_or.ValueOrDie()->get_identifier();
-    primitives_[identifier].push_back(std::move(entry_or.ValueOrDie()));
-    return primitives_[identifier].back().get();
+    const std::string& identifier = identifier_result.ValueOrDie();
+    entries_.emplace_back(typename Entry<P>::ConstructionToken(),
+                          std::move(primitive), identifier, key_info.status(),
+                          key_info.key_id(), key_info.output_prefix_type());
+    Entry<P>* entry = &entries_.back();
+    primitives_[identifier].push_back(entry);
+    return entry;
   }
 
+  // Adds an entry for the specified 'key' whose primitive is constructed by
+  // 'primitive_factory' on first use. This lets keyset wrappers avoid paying
+  // the construction cost (key proto parsing, EVP setup) for keys which are
+  // never used. Callers which may see a lazy entry must access the primitive
+  // through Entry::primitive_or_status(), since materialization can fail.
+  crypto::tink::util::StatusOr<Entry<P>*> AddLazyPrimitive(
+      std::function<crypto::tink::util::StatusOr<std::unique_ptr<P>>()>
+          primitive_factory,
+      const google::crypto::tink::KeysetInfo::KeyInfo& key_info) {
+    if (!primitive_factory) {
+      return util::Status(crypto::tink::util::error::INVALID_ARGUMENT,
+                          "The primitive factory must be non-null.");
+    }
+    auto identifier_result = ValidateAndGetIdentifier(key_info);
+    if (!identifier_result.ok()) return identifier_result.status();
+
+    if (is_sealed()) {
+      return util::Status(crypto::tink::util::error::FAILED_PRECONDITION,
+                          "Cannot add primitives to a sealed PrimitiveSet.");
+    }
+    absl::MutexLock lock(&primitives_mutex_);
+    const std::string& identifier = identifier_result.ValueOrDie();
+    entries_.emplace_back(typename Entry<P>::ConstructionToken(),
+                          std::move(primitive_factory), identifier,
+                          key_info.status(), key_info.key_id(),
+                          key_info.output_prefix_type());
+    Entry<P>* entry = &entries_.back();
+    primitives_[identifier].push_back(entry);
+    return entry;
+  }
+
+  // Adds an entry for the specified 'key_info' which reuses the work captured
+  // in 'source', an entry of another set built for the same key earlier: an
+  // already-materialized primitive is shared with the source set, and an
+  // unmaterialized lazy entry carries its factory over unrun. This is the
+  // building block for incremental re-wraps after a key rotation, where all
+  // but a handful of keys are unchanged; the source set stays valid and is
+  // only read. The caller must ensure that 'key_info' still describes the
+  // source entry's key.
+  crypto::tink::util::StatusOr<Entry<P>*> AddEntryFrom(
+      const Entry<P>& source,
+      const google::crypto::tink::KeysetInfo::KeyInfo& key_info) {
+    auto identifier_result = ValidateAndGetIdentifier(key_info);
+    if (!identifier_result.ok()) return identifier_result.status();
+
+    if (is_sealed()) {
+      return util::Status(crypto::tink::util::error::FAILED_PRECONDITION,
+                          "Cannot add primitives to a sealed PrimitiveSet.");
+    }
+    absl::MutexLock lock(&primitives_mutex_);
+    const std::string& identifier = identifier_result.ValueOrDie();
+    if (source.primitive_ != nullptr) {
+      entries_.emplace_back(typename Entry<P>::ConstructionToken(),
+                            source.primitive_, identifier, key_info.status(),
+                            key_info.key_id(), key_info.output_prefix_type());
+    } else if (source.primitive_factory_) {
+      entries_.emplace_back(typename Entry<P>::ConstructionToken(),
+                            source.primitive_factory_, identifier,
+                            key_info.status(), key_info.key_id(),
+                            key_info.output_prefix_type());
+    } else {
+      return util::Status(crypto::tink::util::error::INVALID_ARGUMENT,
+                          "The source entry holds no primitive and no "
+                          "factory.");
+    }
+    Entry<P>* entry = &entries_.back();
+    primitives_[identifier].push_back(entry);
+    return entry;
+  }
+
+  // Seals this set for reading: builds a flat, sorted index over the fixed
+  // 5-byte output prefixes, so that subsequent get_primitives() calls are
+  // answered by a binary search over contiguous memory -- without taking
+  // primitives_mutex_ and without materializing a std::string key. The wrapper
+  // factories call this once all primitives of a keyset have been added;
+  // afterwards AddPrimitive() fails with FAILED_PRECONDITION.
+  void Seal() {
+    absl::MutexLock lock(&primitives_mutex_);
+    if (sealed_.load(std::memory_order_acquire)) return;
+    prefix_index_.clear();
+    prefix_filter_ = 0;
+    prefix_index_.reserve(primitives_.size());
+    for (const auto& prefix_and_vector : primitives_) {
+      if (prefix_and_vector.first.empty()) {
+        // kRawPrefix; served separately so the index holds only fixed-size
+        // prefixes.
+        raw_primitives_ = &prefix_and_vector.second;
+      } else if (prefix_and_vector.first.size() >
+                 CryptoFormat::kNonRawPrefixSize) {
+        // Cannot happen with prefixes produced by CryptoFormat; stay unsealed
+        // rather than risk an ambiguous packed key.
+        prefix_index_.clear();
+        raw_primitives_ = nullptr;
+        return;
+      } else {
+        prefix_index_.emplace_back(PrefixToKey(prefix_and_vector.first),
+                                   &prefix_and_vector.second);
+        prefix_filter_ |= uint64_t{1} << FilterBit(prefix_and_vector.first);
+      }
+    }
+    std::sort(prefix_index_.begin(), prefix_index_.end());
+    sealed_.store(true, std::memory_order_release);
+  }
+
+  // Returns true if Seal() has been called on this set.
+  bool is_sealed() const { return sealed_.load(std::memory_order_acquire); }
+
   // Returns the entries with primitives identifed by 'identifier'.
   crypto::tink::util::StatusOr<const Primitives*> get_primitives(
       absl::string_view identifier) {
+    if (is_sealed()) {
+      if (identifier.empty()) {
+        if (raw_primitives_ != nullptr) return raw_primitives_;
+      } else if (MayContainPrefix(identifier)) {
+        uint64_t key = PrefixToKey(identifier);
+        auto found = std::lower_bound(
+            prefix_index_.begin(), prefix_index_.end(),
+            std::make_pair(key, static_cast<const Primitives*>(nullptr)));
+        if (found != prefix_index_.end() && found->first == key) {
+          return found->second;
+        }
+      }
+      return ToStatusF(crypto::tink::util::error::NOT_FOUND,
+                       "No primitives found for identifier '%s'.", identifier);
+    }
     absl::MutexLock lock(&primitives_mutex_);
     typename CiphertextPrefixToPrimitivesMap::iterator found =
         primitives_.find(std::string(identifier));
@@ -134,11 +479,41 @@ class PrimitiveSet {
     return &(found->second);
   }
 
+  // Like get_primitives(), but returns nullptr instead of a NOT_FOUND status
+  // when no primitives match. This avoids constructing a formatted error
+  // Status -- and hence any allocation -- on the per-operation dispatch path
+  // of the wrappers, where a miss is an expected outcome.
+  const Primitives* get_primitives_or_null(absl::string_view identifier) {
+    if (is_sealed()) {
+      if (identifier.empty()) return raw_primitives_;
+      if (!MayContainPrefix(identifier)) return nullptr;
+      uint64_t key = PrefixToKey(identifier);
+      auto found = std::lower_bound(
+          prefix_index_.begin(), prefix_index_.end(),
+          std::make_pair(key, static_cast<const Primitives*>(nullptr)));
+      if (found != prefix_index_.end() && found->first == key) {
+        return found->second;
+      }
+      return nullptr;
+    }
+    absl::MutexLock lock(&primitives_mutex_);
+    typename CiphertextPrefixToPrimitivesMap::iterator found =
+        primitives_.find(std::string(identifier));
+    if (found == primitives_.end()) return nullptr;
+    return &(found->second);
+  }
+
   // Returns all primitives that use RAW prefix.
   crypto::tink::util::StatusOr<const Primitives*> get_raw_primitives() {
     return get_primitives(CryptoFormat::kRawPrefix);
   }
 
+  // Allocation-free variant of get_raw_primitives(); returns nullptr if there
+  // are no RAW primitives.
+  const Primitives* get_raw_primitives_or_null() {
+    return get_primitives_or_null(CryptoFormat::kRawPrefix);
+  }
+
   // Sets the given 'primary' as the primary primitive of this set.
   crypto::tink::util::Status set_primary(Entry<P>* primary) {
     if (!primary) {
@@ -167,21 +542,112 @@ class PrimitiveSet {
   const std::vector<Entry<P>*> get_all() const {
     absl::MutexLock lock(&primitives_mutex_);
     std::vector<Entry<P>*> result;
+    result.reserve(entries_.size());
     for (const auto& prefix_and_vector : primitives_) {
-      for (const auto& primitive : prefix_and_vector.second) {
-        result.push_back(primitive.get());
+      for (Entry<P>* primitive : prefix_and_vector.second) {
+        result.push_back(primitive);
       }
     }
     return result;
   }
 
+  // Returns for every key id in this set the number of operations that have
+  // used one of its entries (see Entry::IncrementHitCount()); entries
+  // sharing a key id are aggregated. Keys whose count stays at zero over an
+  // observation period no longer serve live traffic and are candidates for
+  // retirement, which shrinks the trial-decryption loops of the wrappers.
+  std::unordered_map<uint32_t, uint64_t> get_hit_counts() const {
+    std::unordered_map<uint32_t, uint64_t> result;
+    for (const Entry<P>* entry : get_all()) {
+      result[entry->get_key_id()] += entry->hit_count();
+    }
+    return result;
+  }
+
+  // Returns an estimate of the bytes held alive by this set: the set object
+  // itself, all entries together with the footprints their primitives report
+  // (see Entry::MemoryFootprint()), and the lookup structures built by the
+  // map and by Seal(). Intended for capacity planning; primitives which do
+  // not implement MemoryFootprintProvider are counted with their entry only,
+  // so for such sets the value is a lower bound.
+  size_t MemoryFootprint() const {
+    absl::MutexLock lock(&primitives_mutex_);
+    size_t result = sizeof(*this);
+    for (const Entry<P>& entry : entries_) {
+      result += entry.MemoryFootprint();
+    }
+    for (const auto& prefix_and_vector : primitives_) {
+      result += prefix_and_vector.first.capacity() +
+                prefix_and_vector.second.capacity() * sizeof(Entry<P>*);
+    }
+    result += prefix_index_.capacity() *
+              sizeof(std::pair<uint64_t, const Primitives*>);
+    return result;
+  }
+
  private:
   typedef std::unordered_map<std::string, Primitives>
       CiphertextPrefixToPrimitivesMap;
-  Entry<P>* primary_;  // the Entry<P> object is owned by primitives_
+
+  // Shared validation for AddPrimitive() and AddLazyPrimitive(); returns the
+  // output prefix of the key on success.
+  static crypto::tink::util::StatusOr<std::string> ValidateAndGetIdentifier(
+      const google::crypto::tink::KeysetInfo::KeyInfo& key_info) {
+    if (key_info.status() != google::crypto::tink::KeyStatusType::ENABLED) {
+      return util::Status(crypto::tink::util::error::INVALID_ARGUMENT,
+                          "The key must be ENABLED.");
+    }
+    return CryptoFormat::GetOutputPrefix(key_info);
+  }
+
+  // Packs an output prefix into an integer key for the flat index. Output
+  // prefixes produced by CryptoFormat are either empty (RAW) or exactly
+  // 5 bytes, so together with the length tag they always fit into 64 bits.
+  static uint64_t PrefixToKey(absl::string_view prefix) {
+    uint64_t key = prefix.size();
+    for (char c : prefix) {
+      key = (key << 8) | static_cast<uint8_t>(c);
+    }
+    return key;
+  }
+
+  // Maps a non-empty output prefix to one of 64 Bloom-filter bits. The
+  // first byte carries the output-prefix type and the second the high byte
+  // of the big-endian key id, so distinct keys spread well over the bits.
+  static int FilterBit(absl::string_view prefix) {
+    uint8_t type_byte = static_cast<uint8_t>(prefix[0]);
+    uint8_t key_id_high =
+        prefix.size() > 1 ? static_cast<uint8_t>(prefix[1]) : 0;
+    return (type_byte * 131 + key_id_high) & 63;
+  }
+
+  // One-bit-per-prefix Bloom pre-filter, consulted on the sealed lookup
+  // path before the packed key is built or the index is searched: a clear
+  // bit proves the prefix is not in the set, so most foreign-keyset
+  // ciphertexts are rejected in a couple of instructions. A set bit may be
+  // a false positive and falls through to the binary search.
+  bool MayContainPrefix(absl::string_view identifier) const {
+    return (prefix_filter_ & (uint64_t{1} << FilterBit(identifier))) != 0;
+  }
+
+  Entry<P>* primary_;  // the Entry<P> object is owned by entries_
   mutable absl::Mutex primitives_mutex_;
+  // Arena owning all entries of this set. A deque stores the entries
+  // contiguously in blocks -- so the trial loops of the wrappers scan
+  // adjacent memory rather than one heap allocation per key -- while
+  // keeping the Entry* handles handed out to callers stable as the set
+  // grows.
+  std::deque<Entry<P>> entries_ ABSL_GUARDED_BY(primitives_mutex_);
   CiphertextPrefixToPrimitivesMap primitives_
       ABSL_GUARDED_BY(primitives_mutex_);
+
+  // Set once by Seal(); after that the fields below are immutable and read
+  // without taking primitives_mutex_. The pointed-to Primitives vectors live
+  // in primitives_, whose nodes are stable.
+  std::atomic<bool> sealed_{false};
+  std::vector<std::pair<uint64_t, const Primitives*>> prefix_index_;
+  uint64_t prefix_filter_ = 0;
+  const Primitives* raw_primitives_ = nullptr;
 };
 
 }  // namespace tink
@@ -17,7 +17,11 @@
 #ifndef TINK_PUBLIC_KEY_SIGN_H_
 #define TINK_PUBLIC_KEY_SIGN_H_
 
+#include <cstring>
+
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "tink/util/status.h"
 #include "tink/util/statusor.h"
 
 namespace crypto {
@@ -37,6 +41,36 @@ class PublicKeySign {
   virtual crypto::tink::util::StatusOr<std::string> Sign(
       absl::string_view data) const = 0;
 
+  // A conservative upper bound on the signature size of all PublicKeySign
+  // implementations provided by Tink; used by the default
+  // MaxSignatureSize() below.
+  static constexpr size_t kMaxSignatureSize = 1024;
+
+  // Returns an upper bound on the size of signatures computed by this
+  // primitive. The default bound is conservative; implementations which
+  // know their exact signature size should override this.
+  virtual size_t MaxSignatureSize() const { return kMaxSignatureSize; }
+
+  // Computes the signature for 'data', writing it into the caller-provided
+  // buffer 'out', and returns the number of bytes written. 'out' must be at
+  // least MaxSignatureSize() bytes long.
+  // The default implementation falls back to Sign() and copies;
+  // implementations should override it to write the signature directly
+  // into 'out' so that callers can reuse preallocated buffers.
+  virtual crypto::tink::util::StatusOr<size_t> SignInto(
+      absl::string_view data, absl::Span<char> out) const {
+    auto signature = Sign(data);
+    if (!signature.ok()) return signature.status();
+    if (out.size() < signature.ValueOrDie().size()) {
+      return crypto::tink::util::Status(
+          crypto::tink::util::error::INVALID_ARGUMENT,
+          "Output buffer too small.");
+    }
+    memcpy(out.data(), signature.ValueOrDie().data(),
+           signature.ValueOrDie().size());
+    return signature.ValueOrDie().size();
+  }
+
   virtual ~PublicKeySign() {}
 };
 
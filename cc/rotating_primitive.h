@@ -0,0 +1,105 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+#ifndef TINK_ROTATING_PRIMITIVE_H_
+#define TINK_ROTATING_PRIMITIVE_H_
+
+#include <memory>
+#include <utility>
+
+#include "tink/internal/epoch_ptr.h"
+#include "tink/keyset_handle.h"
+#include "tink/keyset_manager.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+
+// A holder for a wrapped primitive that can be hot-swapped upon key
+// rotation. Readers obtain the current primitive with a plain atomic load
+// plus an epoch announcement in their own per-thread slot -- there is no
+// shared reference count to contend on -- and are never blocked by a
+// concurrent rotation; the primitive rebuild happens off the serving path
+// and is published with one atomic pointer store. An operation that
+// started before a rotation simply completes with the primitive it already
+// obtained: the replaced primitive is reclaimed via internal::EpochPtr
+// only once every reader that might still hold it has finished.
+//
+// Typical use in a long-lived service:
+//
+//   auto holder = RotatingPrimitive<Aead>::New(keyset_manager).ValueOrDie();
+//   ...
+//   // serving path:
+//   auto aead = holder->get();
+//   auto ciphertext = aead->Encrypt(plaintext, aad);
+//   ...
+//   // rotation path (e.g. a background thread):
+//   keyset_manager->Rotate(key_template);
+//   auto status = holder->Refresh();
+//
+// Refresh() is deliberately explicit rather than hooked into
+// KeysetManager::Rotate: rebuilding the primitive can fail, and the
+// rotating thread is the right place to observe and handle that status.
+// The keyset manager must outlive the holder, and guards returned by get()
+// must not outlive it either.
+template <class P>
+class RotatingPrimitive {
+ public:
+  // Creates a holder bound to 'keyset_manager', initialized with the
+  // primitive built from the manager's current keyset.
+  static crypto::tink::util::StatusOr<std::unique_ptr<RotatingPrimitive<P>>>
+  New(KeysetManager* keyset_manager) {
+    if (keyset_manager == nullptr) {
+      return crypto::tink::util::Status(util::error::INVALID_ARGUMENT,
+                                        "keyset_manager must be non-null");
+    }
+    std::unique_ptr<RotatingPrimitive<P>> holder(
+        new RotatingPrimitive<P>(keyset_manager));
+    auto status = holder->Refresh();
+    if (!status.ok()) return status;
+    return std::move(holder);
+  }
+
+  // Returns a guard for the currently published primitive. Wait-free; safe
+  // to call concurrently with Refresh(). The guard keeps the primitive
+  // alive even if a rotation replaces it mid-operation.
+  typename internal::EpochPtr<P>::ReadGuard get() const {
+    return primitive_.Read();
+  }
+
+  // Rebuilds the primitive from the manager's current keyset and publishes
+  // it with a single atomic pointer store. On failure the previously
+  // published primitive stays in place.
+  crypto::tink::util::Status Refresh() {
+    auto handle = keyset_manager_->GetKeysetHandle();
+    auto primitive_result = handle->template GetPrimitive<P>();
+    if (!primitive_result.ok()) return primitive_result.status();
+    primitive_.Swap(std::move(primitive_result.ValueOrDie()));
+    return crypto::tink::util::Status::OK;
+  }
+
+ private:
+  explicit RotatingPrimitive(KeysetManager* keyset_manager)
+      : keyset_manager_(keyset_manager) {}
+
+  KeysetManager* const keyset_manager_;
+  internal::EpochPtr<P> primitive_;
+};
+
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_ROTATING_PRIMITIVE_H_
@@ -57,6 +57,28 @@ StatusOr<Ed25519PrivateKey> Ed25519SignKeyManager::CreateKey(
   return ed25519_private_key;
 }
 
+StatusOr<std::vector<Ed25519PrivateKey>> Ed25519SignKeyManager::CreateKeyBatch(
+    const Ed25519KeyFormat& key_format, int count) const {
+  if (count < 0) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "count must be non-negative");
+  }
+  auto keys = subtle::SubtleUtilBoringSSL::GetNewEd25519Keys(count);
+
+  std::vector<Ed25519PrivateKey> result;
+  result.reserve(count);
+  for (const auto& key : keys) {
+    Ed25519PrivateKey ed25519_private_key;
+    ed25519_private_key.set_version(get_version());
+    ed25519_private_key.set_key_value(key->private_key);
+    auto ed25519_public_key = ed25519_private_key.mutable_public_key();
+    ed25519_public_key->set_version(get_version());
+    ed25519_public_key->set_key_value(key->public_key);
+    result.push_back(std::move(ed25519_private_key));
+  }
+  return result;
+}
+
 StatusOr<std::unique_ptr<PublicKeySign>>
 Ed25519SignKeyManager::PublicKeySignFactory::Create(
     const Ed25519PrivateKey& private_key) const {
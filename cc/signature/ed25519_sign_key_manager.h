@@ -17,6 +17,7 @@
 #define TINK_SIGNATURE_ED25519_SIGN_KEY_MANAGER_H_
 
 #include <string>
+#include <vector>
 
 #include "absl/memory/memory.h"
 #include "absl/strings/str_cat.h"
@@ -67,6 +68,15 @@ class Ed25519SignKeyManager
   CreateKey(
       const google::crypto::tink::Ed25519KeyFormat& key_format) const override;
 
+  // Creates 'count' new keys at once. The secret seeds for all keys are
+  // drawn from the RNG in a single call, which makes this substantially
+  // cheaper than 'count' calls to CreateKey for services that mint keys in
+  // bulk.
+  crypto::tink::util::StatusOr<
+      std::vector<google::crypto::tink::Ed25519PrivateKey>>
+  CreateKeyBatch(const google::crypto::tink::Ed25519KeyFormat& key_format,
+                 int count) const;
+
   crypto::tink::util::StatusOr<google::crypto::tink::Ed25519PublicKey>
   GetPublicKey(const google::crypto::tink::Ed25519PrivateKey& private_key)
       const override {
@@ -93,6 +93,27 @@ TEST(Ed25519SignKeyManagerTest, CreateKeyAlwaysNew) {
   EXPECT_THAT(keys, SizeIs(num_tests));
 }
 
+TEST(Ed25519SignKeyManagerTest, CreateKeyBatch) {
+  auto keys_or =
+      Ed25519SignKeyManager().CreateKeyBatch(Ed25519KeyFormat(), 50);
+  ASSERT_THAT(keys_or.status(), IsOk());
+  std::vector<Ed25519PrivateKey> keys = keys_or.ValueOrDie();
+  ASSERT_THAT(keys, SizeIs(50));
+  absl::flat_hash_set<std::string> key_values;
+  for (const Ed25519PrivateKey& key : keys) {
+    EXPECT_THAT(Ed25519SignKeyManager().ValidateKey(key), IsOk());
+    key_values.insert(key.key_value());
+  }
+  // All keys in a batch are distinct.
+  EXPECT_THAT(key_values, SizeIs(50));
+}
+
+TEST(Ed25519SignKeyManagerTest, CreateKeyBatchRejectsNegativeCount) {
+  EXPECT_THAT(
+      Ed25519SignKeyManager().CreateKeyBatch(Ed25519KeyFormat(), -1).status(),
+      test::StatusIs(util::error::INVALID_ARGUMENT));
+}
+
 TEST(Ed25519SignKeyManagerTest, GetPublicKey) {
   StatusOr<Ed25519PrivateKey> key_or =
       Ed25519SignKeyManager().CreateKey(Ed25519KeyFormat());
@@ -16,9 +16,15 @@
 
 #include "tink/signature/public_key_sign_wrapper.h"
 
+#include <cstring>
+
+#include "absl/types/span.h"
 #include "tink/crypto_format.h"
+#include "tink/internal/monitoring.h"
+#include "tink/internal/profiling.h"
 #include "tink/primitive_set.h"
 #include "tink/public_key_sign.h"
+#include "tink/subtle/subtle_util.h"
 #include "tink/subtle/subtle_util_boringssl.h"
 #include "tink/util/statusor.h"
 #include "proto/tink.pb.h"
@@ -64,16 +70,33 @@ util::StatusOr<std::string> PublicKeySignSetWrapper::Sign(
   data = subtle::SubtleUtilBoringSSL::EnsureNonNull(data);
 
   auto primary = public_key_sign_set_->get_primary();
+  TINK_PROFILE_SCOPE(PublicKeySign);
+  internal::MonitoredOp monitored_op("signature.sign", primary->get_key_id());
   std::string local_data;
   if (primary->get_output_prefix_type() == OutputPrefixType::LEGACY) {
     local_data = std::string(data);
     local_data.append(1, CryptoFormat::kLegacyStartByte);
     data = local_data;
   }
-  auto sign_result = primary->get_primitive().Sign(data);
-  if (!sign_result.ok()) return sign_result.status();
-  const std::string& key_id = primary->get_identifier();
-  return key_id + sign_result.ValueOrDie();
+  // Write the output prefix and the signature directly into the result
+  // string, instead of signing into a temporary and concatenating it
+  // behind the prefix.
+  const PublicKeySign& primitive = primary->get_primitive();
+  absl::string_view key_id = primary->get_identifier();
+  std::string result;
+  subtle::ResizeStringUninitialized(
+      &result, key_id.size() + primitive.MaxSignatureSize());
+  memcpy(&result[0], key_id.data(), key_id.size());
+  auto size_result = primitive.SignInto(
+      data, absl::Span<char>(&result[key_id.size()],
+                             result.size() - key_id.size()));
+  if (!size_result.ok()) {
+    monitored_op.SetFailed();
+    return size_result.status();
+  }
+  primary->IncrementHitCount();
+  result.resize(key_id.size() + size_result.ValueOrDie());
+  return result;
 }
 
 }  // anonymous namespace
@@ -82,6 +105,7 @@ util::StatusOr<std::unique_ptr<PublicKeySign>> PublicKeySignWrapper::Wrap(
     std::unique_ptr<PrimitiveSet<PublicKeySign>> primitive_set) const {
   util::Status status = Validate(primitive_set.get());
   if (!status.ok()) return status;
+  primitive_set->Seal();
   std::unique_ptr<PublicKeySign> public_key_sign(
       new PublicKeySignSetWrapper(std::move(primitive_set)));
   return std::move(public_key_sign);
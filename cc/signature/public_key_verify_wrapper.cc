@@ -72,20 +72,31 @@ util::Status PublicKeyVerifySetWrapper::Verify(
     // We're not aware of any schemes that output signatures that small.
     return util::Status(util::error::INVALID_ARGUMENT, "Signature too short.");
   }
+  // The 5-byte prefix embeds the key id, so the lookup below only returns
+  // entries whose key id matches the signature; wrong rotated keys are
+  // rejected here without attempting a signature verification.
   absl::string_view key_id =
       signature.substr(0, CryptoFormat::kNonRawPrefixSize);
-  auto primitives_result = public_key_verify_set_->get_primitives(key_id);
-  if (primitives_result.ok()) {
+  const auto* primitives =
+      public_key_verify_set_->get_primitives_or_null(key_id);
+  if (primitives != nullptr) {
     absl::string_view raw_signature =
         signature.substr(CryptoFormat::kNonRawPrefixSize);
-    for (auto& entry : *(primitives_result.ValueOrDie())) {
-      std::string legacy_data;
+    // Built at most once, only if a LEGACY entry is encountered.
+    std::string legacy_data;
+    for (auto& entry : *primitives) {
       absl::string_view view_on_data_or_legacy_data = data;
       if (entry->get_output_prefix_type() == OutputPrefixType::LEGACY) {
-        legacy_data = absl::StrCat(data, std::string("\x00", 1));
+        if (legacy_data.empty()) {
+          legacy_data = absl::StrCat(data, std::string("\x00", 1));
+        }
         view_on_data_or_legacy_data = legacy_data;
       }
-      auto& public_key_verify = entry->get_primitive();
+      auto public_key_verify_or = entry->primitive_or_status();
+      // Skip entries whose lazy materialization failed; RAW keys below may
+      // still succeed.
+      if (!public_key_verify_or.ok()) continue;
+      auto& public_key_verify = *public_key_verify_or.ValueOrDie();
       auto verify_result =
           public_key_verify.Verify(raw_signature, view_on_data_or_legacy_data);
       if (verify_result.ok()) {
@@ -96,12 +107,17 @@ util::Status PublicKeyVerifySetWrapper::Verify(
     }
   }
 
-  // No matching key succeeded with verification, try all RAW keys.
-  auto raw_primitives_result = public_key_verify_set_->get_raw_primitives();
-  if (raw_primitives_result.ok()) {
-    for (auto& public_key_verify_entry :
-             *(raw_primitives_result.ValueOrDie())) {
-      auto& public_key_verify = public_key_verify_entry->get_primitive();
+  // No matching key succeeded with verification, try all RAW keys. RAW
+  // signatures carry no key id, so trial verification against each key is
+  // the only option here.
+  const auto* raw_primitives =
+      public_key_verify_set_->get_raw_primitives_or_null();
+  if (raw_primitives != nullptr) {
+    for (auto& public_key_verify_entry : *raw_primitives) {
+      auto public_key_verify_or =
+          public_key_verify_entry->primitive_or_status();
+      if (!public_key_verify_or.ok()) continue;
+      auto& public_key_verify = *public_key_verify_or.ValueOrDie();
       auto verify_result = public_key_verify.Verify(signature, data);
       if (verify_result.ok()) {
         return util::Status::OK;
@@ -118,6 +134,7 @@ util::StatusOr<std::unique_ptr<PublicKeyVerify>> PublicKeyVerifyWrapper::Wrap(
     const {
   util::Status status = Validate(public_key_verify_set.get());
   if (!status.ok()) return status;
+  public_key_verify_set->Seal();
   std::unique_ptr<PublicKeyVerify> public_key_verify(
       new PublicKeyVerifySetWrapper(std::move(public_key_verify_set)));
   return std::move(public_key_verify);
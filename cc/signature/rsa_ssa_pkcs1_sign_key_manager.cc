@@ -22,6 +22,7 @@
 #include "tink/public_key_verify.h"
 #include "tink/signature/rsa_ssa_pkcs1_verify_key_manager.h"
 #include "tink/signature/sig_util.h"
+#include "tink/subtle/rsa_key_pool.h"
 #include "tink/subtle/rsa_ssa_pkcs1_sign_boringssl.h"
 #include "tink/subtle/subtle_util_boringssl.h"
 #include "tink/util/enums.h"
@@ -79,15 +80,24 @@ subtle::SubtleUtilBoringSSL::RsaPrivateKey RsaPrivateKeyProtoToSubtle(
 
 StatusOr<RsaSsaPkcs1PrivateKey> RsaSsaPkcs1SignKeyManager::CreateKey(
     const RsaSsaPkcs1KeyFormat& rsa_ssa_pkcs1_key_format) const {
-  auto e = subtle::SubtleUtilBoringSSL::str2bn(
-      rsa_ssa_pkcs1_key_format.public_exponent());
-  if (!e.ok()) return e.status();
-
   subtle::SubtleUtilBoringSSL::RsaPrivateKey private_key;
   subtle::SubtleUtilBoringSSL::RsaPublicKey public_key;
-  util::Status status = subtle::SubtleUtilBoringSSL::GetNewRsaKeyPair(
-      rsa_ssa_pkcs1_key_format.modulus_size_in_bits(), e.ValueOrDie().get(),
-      &private_key, &public_key);
+  util::Status status;
+  // An installed key pool serves pre-generated keys, so bursts of key
+  // creations do not serialize on BoringSSL RSA key generation.
+  subtle::RsaKeyPool* key_pool = subtle::RsaKeyPool::GetGlobalInstance();
+  if (key_pool != nullptr) {
+    status = key_pool->GetKeyPair(
+        rsa_ssa_pkcs1_key_format.modulus_size_in_bits(),
+        rsa_ssa_pkcs1_key_format.public_exponent(), &private_key, &public_key);
+  } else {
+    auto e = subtle::SubtleUtilBoringSSL::str2bn(
+        rsa_ssa_pkcs1_key_format.public_exponent());
+    if (!e.ok()) return e.status();
+    status = subtle::SubtleUtilBoringSSL::GetNewRsaKeyPair(
+        rsa_ssa_pkcs1_key_format.modulus_size_in_bits(), e.ValueOrDie().get(),
+        &private_key, &public_key);
+  }
   if (!status.ok()) return status;
 
   RsaSsaPkcs1PrivateKey key_proto = RsaPrivateKeySubtleToProto(private_key);
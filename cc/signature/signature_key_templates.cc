@@ -16,93 +16,84 @@
 
 #include "tink/signature/signature_key_templates.h"
 
-#include "absl/memory/memory.h"
-#include "absl/strings/str_cat.h"
-#include "openssl/bn.h"
-#include "openssl/rsa.h"
-#include "tink/subtle/subtle_util_boringssl.h"
-#include "tink/util/constants.h"
-#include "proto/common.pb.h"
-#include "proto/ecdsa.pb.h"
-#include "proto/ed25519.pb.h"
-#include "proto/rsa_ssa_pkcs1.pb.h"
-#include "proto/rsa_ssa_pss.pb.h"
 #include "proto/tink.pb.h"
 
 namespace crypto {
 namespace tink {
 namespace {
 
-using google::crypto::tink::EcdsaKeyFormat;
-using google::crypto::tink::EcdsaPrivateKey;
-using google::crypto::tink::EcdsaSignatureEncoding;
-using google::crypto::tink::Ed25519PrivateKey;
-using google::crypto::tink::EllipticCurveType;
-using google::crypto::tink::HashType;
 using google::crypto::tink::KeyTemplate;
 using google::crypto::tink::OutputPrefixType;
-using google::crypto::tink::RsaSsaPkcs1KeyFormat;
-using google::crypto::tink::RsaSsaPkcs1PrivateKey;
-using google::crypto::tink::RsaSsaPssKeyFormat;
-using google::crypto::tink::RsaSsaPssPrivateKey;
-
-std::unique_ptr<KeyTemplate> NewEcdsaKeyTemplate(
-    HashType hash_type, EllipticCurveType curve_type,
-    EcdsaSignatureEncoding encoding) {
-  auto key_template = absl::make_unique<KeyTemplate>();
-  key_template->set_type_url(
-      absl::StrCat(kTypeGoogleapisCom, EcdsaPrivateKey().GetTypeName()));
-  key_template->set_output_prefix_type(OutputPrefixType::TINK);
-  EcdsaKeyFormat key_format;
-  auto params = key_format.mutable_params();
-  params->set_hash_type(hash_type);
-  params->set_curve(curve_type);
-  params->set_encoding(encoding);
-  key_format.SerializeToString(key_template->mutable_value());
-  return key_template;
-}
-
-std::unique_ptr<KeyTemplate> NewRsaSsaPkcs1KeyTemplate(HashType hash_type,
-                                                       int modulus_size_in_bits,
-                                                       int public_exponent) {
-  auto key_template = absl::make_unique<KeyTemplate>();
-  key_template->set_type_url(
-      absl::StrCat(kTypeGoogleapisCom, RsaSsaPkcs1PrivateKey().GetTypeName()));
-  key_template->set_output_prefix_type(OutputPrefixType::TINK);
-  RsaSsaPkcs1KeyFormat key_format;
-  auto params = key_format.mutable_params();
-  params->set_hash_type(hash_type);
-  key_format.set_modulus_size_in_bits(modulus_size_in_bits);
-  bssl::UniquePtr<BIGNUM> e(BN_new());
-  BN_set_word(e.get(), public_exponent);
-  key_format.set_public_exponent(
-      subtle::SubtleUtilBoringSSL::bn2str(e.get(), BN_num_bytes(e.get()))
-          .ValueOrDie());
-  key_format.SerializeToString(key_template->mutable_value());
-  return key_template;
-}
 
-std::unique_ptr<KeyTemplate> NewRsaSsaPssKeyTemplate(HashType sig_hash,
-                                                     HashType mgf1_hash,
-                                                     int salt_length,
-                                                     int modulus_size_in_bits,
-                                                     int public_exponent) {
-  auto key_template = absl::make_unique<KeyTemplate>();
-  key_template->set_type_url(
-      absl::StrCat(kTypeGoogleapisCom, RsaSsaPssPrivateKey().GetTypeName()));
-  key_template->set_output_prefix_type(OutputPrefixType::TINK);
-  RsaSsaPssKeyFormat key_format;
-  auto params = key_format.mutable_params();
-  params->set_sig_hash(sig_hash);
-  params->set_mgf1_hash(mgf1_hash);
-  params->set_salt_length(salt_length);
-  key_format.set_modulus_size_in_bits(modulus_size_in_bits);
-  bssl::UniquePtr<BIGNUM> e(BN_new());
-  BN_set_word(e.get(), public_exponent);
-  key_format.set_public_exponent(
-      subtle::SubtleUtilBoringSSL::bn2str(e.get(), BN_num_bytes(e.get()))
-          .ValueOrDie());
-  key_format.SerializeToString(key_template->mutable_value());
+// The key formats of the templates below are fixed, and serialize to short,
+// deterministic byte strings. They are precomputed here as compile-time
+// constants so that first use of a template only fills in a KeyTemplate proto,
+// instead of building and serializing a key format proto as well; binaries
+// that start many short-lived processes pay that cost on every startup.
+// Each constant documents the message it encodes, and
+// signature_key_templates_test.cc checks the constants against the proto
+// serializer.
+
+// Serialized EcdsaKeyFormat with params.hash_type = SHA256,
+// params.curve = NIST_P256, params.encoding = DER.
+constexpr char kEcdsaP256KeyFormat[] = "\x12\x06\x08\x03\x10\x02\x18\x02";
+
+// Serialized EcdsaKeyFormat with params.hash_type = SHA512,
+// params.curve = NIST_P384, params.encoding = DER.
+constexpr char kEcdsaP384KeyFormat[] = "\x12\x06\x08\x04\x10\x03\x18\x02";
+
+// Serialized EcdsaKeyFormat with params.hash_type = SHA512,
+// params.curve = NIST_P521, params.encoding = DER.
+constexpr char kEcdsaP521KeyFormat[] = "\x12\x06\x08\x04\x10\x04\x18\x02";
+
+// Serialized EcdsaKeyFormat with params.hash_type = SHA256,
+// params.curve = NIST_P256, params.encoding = IEEE_P1363.
+constexpr char kEcdsaP256IeeeKeyFormat[] = "\x12\x06\x08\x03\x10\x02\x18\x01";
+
+// Serialized EcdsaKeyFormat with params.hash_type = SHA512,
+// params.curve = NIST_P384, params.encoding = IEEE_P1363.
+constexpr char kEcdsaP384IeeeKeyFormat[] = "\x12\x06\x08\x04\x10\x03\x18\x01";
+
+// Serialized EcdsaKeyFormat with params.hash_type = SHA512,
+// params.curve = NIST_P521, params.encoding = IEEE_P1363.
+constexpr char kEcdsaP521IeeeKeyFormat[] = "\x12\x06\x08\x04\x10\x04\x18\x01";
+
+// Serialized RsaSsaPkcs1KeyFormat with params.hash_type = SHA256,
+// modulus_size_in_bits = 3072, public_exponent = 65537 (F4, "\x01\x00\x01").
+constexpr char kRsaSsaPkcs13072Sha256F4KeyFormat[] =
+    "\x0a\x02\x08\x03\x10\x80\x18\x1a\x03\x01\x00\x01";
+
+// Serialized RsaSsaPkcs1KeyFormat with params.hash_type = SHA512,
+// modulus_size_in_bits = 4096, public_exponent = 65537 (F4, "\x01\x00\x01").
+constexpr char kRsaSsaPkcs14096Sha512F4KeyFormat[] =
+    "\x0a\x02\x08\x04\x10\x80\x20\x1a\x03\x01\x00\x01";
+
+// Serialized RsaSsaPssKeyFormat with params.sig_hash = SHA256,
+// params.mgf1_hash = SHA256, params.salt_length = 32,
+// modulus_size_in_bits = 3072, public_exponent = 65537 (F4, "\x01\x00\x01").
+constexpr char kRsaSsaPss3072Sha256Sha256F4KeyFormat[] =
+    "\x0a\x06\x08\x03\x10\x03\x18\x20\x10\x80\x18\x1a\x03\x01\x00\x01";
+
+// Serialized RsaSsaPssKeyFormat with params.sig_hash = SHA512,
+// params.mgf1_hash = SHA512, params.salt_length = 64,
+// modulus_size_in_bits = 4096, public_exponent = 65537 (F4, "\x01\x00\x01").
+constexpr char kRsaSsaPss4096Sha512Sha512F4KeyFormat[] =
+    "\x0a\x06\x08\x04\x10\x04\x18\x40\x10\x80\x20\x1a\x03\x01\x00\x01";
+
+// Serialized RsaSsaPssKeyFormat with params.sig_hash = SHA384,
+// params.mgf1_hash = SHA384, params.salt_length = 48,
+// modulus_size_in_bits = 4096, public_exponent = 65537 (F4, "\x01\x00\x01").
+constexpr char kRsaSsaPss4096Sha384Sha384F4KeyFormat[] =
+    "\x0a\x06\x08\x02\x10\x02\x18\x30\x10\x80\x20\x1a\x03\x01\x00\x01";
+
+KeyTemplate* NewKeyTemplate(const char* type_url,
+                            OutputPrefixType output_prefix_type,
+                            const char* serialized_key_format,
+                            size_t serialized_key_format_size) {
+  KeyTemplate* key_template = new KeyTemplate;
+  key_template->set_type_url(type_url);
+  key_template->set_output_prefix_type(output_prefix_type);
+  key_template->set_value(serialized_key_format, serialized_key_format_size);
   return key_template;
 }
 
@@ -110,115 +101,119 @@ std::unique_ptr<KeyTemplate> NewRsaSsaPssKeyTemplate(HashType sig_hash,
 
 // static
 const KeyTemplate& SignatureKeyTemplates::EcdsaP256() {
-  static const KeyTemplate* key_template =
-      NewEcdsaKeyTemplate(HashType::SHA256, EllipticCurveType::NIST_P256,
-                          EcdsaSignatureEncoding::DER)
-          .release();
+  static const KeyTemplate* key_template = NewKeyTemplate(
+      "type.googleapis.com/google.crypto.tink.EcdsaPrivateKey",
+      OutputPrefixType::TINK, kEcdsaP256KeyFormat,
+      sizeof(kEcdsaP256KeyFormat) - 1);
   return *key_template;
 }
 
 // static
 const KeyTemplate& SignatureKeyTemplates::EcdsaP384() {
-  static const KeyTemplate* key_template =
-      NewEcdsaKeyTemplate(HashType::SHA512, EllipticCurveType::NIST_P384,
-                          EcdsaSignatureEncoding::DER)
-          .release();
+  static const KeyTemplate* key_template = NewKeyTemplate(
+      "type.googleapis.com/google.crypto.tink.EcdsaPrivateKey",
+      OutputPrefixType::TINK, kEcdsaP384KeyFormat,
+      sizeof(kEcdsaP384KeyFormat) - 1);
   return *key_template;
 }
 
 // static
 const KeyTemplate& SignatureKeyTemplates::EcdsaP521() {
-  static const KeyTemplate* key_template =
-      NewEcdsaKeyTemplate(HashType::SHA512, EllipticCurveType::NIST_P521,
-                          EcdsaSignatureEncoding::DER)
-          .release();
+  static const KeyTemplate* key_template = NewKeyTemplate(
+      "type.googleapis.com/google.crypto.tink.EcdsaPrivateKey",
+      OutputPrefixType::TINK, kEcdsaP521KeyFormat,
+      sizeof(kEcdsaP521KeyFormat) - 1);
   return *key_template;
 }
 
 // static
 const KeyTemplate& SignatureKeyTemplates::EcdsaP256Ieee() {
-  static const KeyTemplate* key_template =
-      NewEcdsaKeyTemplate(HashType::SHA256, EllipticCurveType::NIST_P256,
-                          EcdsaSignatureEncoding::IEEE_P1363)
-          .release();
+  static const KeyTemplate* key_template = NewKeyTemplate(
+      "type.googleapis.com/google.crypto.tink.EcdsaPrivateKey",
+      OutputPrefixType::TINK, kEcdsaP256IeeeKeyFormat,
+      sizeof(kEcdsaP256IeeeKeyFormat) - 1);
   return *key_template;
 }
 
 // static
 const KeyTemplate& SignatureKeyTemplates::EcdsaP384Ieee() {
-  static const KeyTemplate* key_template =
-      NewEcdsaKeyTemplate(HashType::SHA512, EllipticCurveType::NIST_P384,
-                          EcdsaSignatureEncoding::IEEE_P1363)
-          .release();
+  static const KeyTemplate* key_template = NewKeyTemplate(
+      "type.googleapis.com/google.crypto.tink.EcdsaPrivateKey",
+      OutputPrefixType::TINK, kEcdsaP384IeeeKeyFormat,
+      sizeof(kEcdsaP384IeeeKeyFormat) - 1);
   return *key_template;
 }
 
 // static
 const KeyTemplate& SignatureKeyTemplates::EcdsaP521Ieee() {
-  static const KeyTemplate* key_template =
-      NewEcdsaKeyTemplate(HashType::SHA512, EllipticCurveType::NIST_P521,
-                          EcdsaSignatureEncoding::IEEE_P1363)
-          .release();
+  static const KeyTemplate* key_template = NewKeyTemplate(
+      "type.googleapis.com/google.crypto.tink.EcdsaPrivateKey",
+      OutputPrefixType::TINK, kEcdsaP521IeeeKeyFormat,
+      sizeof(kEcdsaP521IeeeKeyFormat) - 1);
   return *key_template;
 }
 
 // static
 const KeyTemplate& SignatureKeyTemplates::RsaSsaPkcs13072Sha256F4() {
-  static const KeyTemplate* key_template =
-      NewRsaSsaPkcs1KeyTemplate(HashType::SHA256, 3072, RSA_F4).release();
+  static const KeyTemplate* key_template = NewKeyTemplate(
+      "type.googleapis.com/google.crypto.tink.RsaSsaPkcs1PrivateKey",
+      OutputPrefixType::TINK, kRsaSsaPkcs13072Sha256F4KeyFormat,
+      sizeof(kRsaSsaPkcs13072Sha256F4KeyFormat) - 1);
   return *key_template;
 }
 
 // static
 const KeyTemplate& SignatureKeyTemplates::RsaSsaPkcs14096Sha512F4() {
-  static const KeyTemplate* key_template =
-      NewRsaSsaPkcs1KeyTemplate(HashType::SHA512, 4096, RSA_F4).release();
+  static const KeyTemplate* key_template = NewKeyTemplate(
+      "type.googleapis.com/google.crypto.tink.RsaSsaPkcs1PrivateKey",
+      OutputPrefixType::TINK, kRsaSsaPkcs14096Sha512F4KeyFormat,
+      sizeof(kRsaSsaPkcs14096Sha512F4KeyFormat) - 1);
   return *key_template;
 }
 
 // static
 const KeyTemplate& SignatureKeyTemplates::RsaSsaPss3072Sha256Sha256F4() {
-  static const KeyTemplate* key_template =
-      NewRsaSsaPssKeyTemplate(HashType::SHA256, HashType::SHA256, 32, 3072,
-                              RSA_F4)
-          .release();
+  static const KeyTemplate* key_template = NewKeyTemplate(
+      "type.googleapis.com/google.crypto.tink.RsaSsaPssPrivateKey",
+      OutputPrefixType::TINK, kRsaSsaPss3072Sha256Sha256F4KeyFormat,
+      sizeof(kRsaSsaPss3072Sha256Sha256F4KeyFormat) - 1);
   return *key_template;
 }
 
 // static
 const KeyTemplate& SignatureKeyTemplates::RsaSsaPss4096Sha512Sha512F4() {
-  static const KeyTemplate* key_template =
-      NewRsaSsaPssKeyTemplate(HashType::SHA512, HashType::SHA512, 64, 4096,
-                              RSA_F4)
-          .release();
+  static const KeyTemplate* key_template = NewKeyTemplate(
+      "type.googleapis.com/google.crypto.tink.RsaSsaPssPrivateKey",
+      OutputPrefixType::TINK, kRsaSsaPss4096Sha512Sha512F4KeyFormat,
+      sizeof(kRsaSsaPss4096Sha512Sha512F4KeyFormat) - 1);
   return *key_template;
 }
 
 // static
 const KeyTemplate& SignatureKeyTemplates::RsaSsaPss4096Sha384Sha384F4() {
-  static const KeyTemplate* key_template =
-      NewRsaSsaPssKeyTemplate(HashType::SHA384, HashType::SHA384, 48, 4096,
-                              RSA_F4)
-          .release();
+  static const KeyTemplate* key_template = NewKeyTemplate(
+      "type.googleapis.com/google.crypto.tink.RsaSsaPssPrivateKey",
+      OutputPrefixType::TINK, kRsaSsaPss4096Sha384Sha384F4KeyFormat,
+      sizeof(kRsaSsaPss4096Sha384Sha384F4KeyFormat) - 1);
   return *key_template;
 }
 
 // static
 const google::crypto::tink::KeyTemplate& SignatureKeyTemplates::Ed25519() {
-  static KeyTemplate* key_template = new KeyTemplate();
-  key_template->set_type_url(
-      absl::StrCat(kTypeGoogleapisCom, Ed25519PrivateKey().GetTypeName()));
-  key_template->set_output_prefix_type(OutputPrefixType::TINK);
+  // Ed25519KeyFormat is empty for new keys, so is its serialization.
+  static const KeyTemplate* key_template = NewKeyTemplate(
+      "type.googleapis.com/google.crypto.tink.Ed25519PrivateKey",
+      OutputPrefixType::TINK, "", 0);
   return *key_template;
 }
 
 // static
 const google::crypto::tink::KeyTemplate&
 SignatureKeyTemplates::Ed25519WithRawOutput() {
-  static KeyTemplate* key_template = new KeyTemplate();
-  key_template->set_type_url(
-      absl::StrCat(kTypeGoogleapisCom, Ed25519PrivateKey().GetTypeName()));
-  key_template->set_output_prefix_type(OutputPrefixType::RAW);
+  // Ed25519KeyFormat is empty for new keys, so is its serialization.
+  static const KeyTemplate* key_template = NewKeyTemplate(
+      "type.googleapis.com/google.crypto.tink.Ed25519PrivateKey",
+      OutputPrefixType::RAW, "", 0);
   return *key_template;
 }
 
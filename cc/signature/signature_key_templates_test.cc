@@ -434,6 +434,75 @@ TEST(SignatureKeyTemplatesTest, KeyTemplatesWithEd25519WithRawOutput) {
   EXPECT_TRUE(new_key_result.ok()) << new_key_result.status();
 }
 
+TEST(SignatureKeyTemplatesTest, SerializedFormatsMatchProtoSerializer) {
+  // The templates precompute their serialized key formats as compile-time
+  // constants; verify the constants against the proto serializer.
+  EcdsaKeyFormat ecdsa_format;
+  auto* ecdsa_params = ecdsa_format.mutable_params();
+  ecdsa_params->set_hash_type(HashType::SHA256);
+  ecdsa_params->set_curve(EllipticCurveType::NIST_P256);
+  ecdsa_params->set_encoding(EcdsaSignatureEncoding::DER);
+  EXPECT_EQ(SignatureKeyTemplates::EcdsaP256().value(),
+            ecdsa_format.SerializeAsString());
+  ecdsa_params->set_encoding(EcdsaSignatureEncoding::IEEE_P1363);
+  EXPECT_EQ(SignatureKeyTemplates::EcdsaP256Ieee().value(),
+            ecdsa_format.SerializeAsString());
+  ecdsa_params->set_hash_type(HashType::SHA512);
+  ecdsa_params->set_curve(EllipticCurveType::NIST_P384);
+  EXPECT_EQ(SignatureKeyTemplates::EcdsaP384Ieee().value(),
+            ecdsa_format.SerializeAsString());
+  ecdsa_params->set_curve(EllipticCurveType::NIST_P521);
+  EXPECT_EQ(SignatureKeyTemplates::EcdsaP521Ieee().value(),
+            ecdsa_format.SerializeAsString());
+  ecdsa_params->set_encoding(EcdsaSignatureEncoding::DER);
+  EXPECT_EQ(SignatureKeyTemplates::EcdsaP521().value(),
+            ecdsa_format.SerializeAsString());
+  ecdsa_params->set_curve(EllipticCurveType::NIST_P384);
+  EXPECT_EQ(SignatureKeyTemplates::EcdsaP384().value(),
+            ecdsa_format.SerializeAsString());
+
+  bssl::UniquePtr<BIGNUM> e(BN_new());
+  BN_set_word(e.get(), RSA_F4);
+  std::string public_exponent =
+      subtle::SubtleUtilBoringSSL::bn2str(e.get(), BN_num_bytes(e.get()))
+          .ValueOrDie();
+
+  RsaSsaPkcs1KeyFormat pkcs1_format;
+  pkcs1_format.mutable_params()->set_hash_type(HashType::SHA256);
+  pkcs1_format.set_modulus_size_in_bits(3072);
+  pkcs1_format.set_public_exponent(public_exponent);
+  EXPECT_EQ(SignatureKeyTemplates::RsaSsaPkcs13072Sha256F4().value(),
+            pkcs1_format.SerializeAsString());
+  pkcs1_format.mutable_params()->set_hash_type(HashType::SHA512);
+  pkcs1_format.set_modulus_size_in_bits(4096);
+  EXPECT_EQ(SignatureKeyTemplates::RsaSsaPkcs14096Sha512F4().value(),
+            pkcs1_format.SerializeAsString());
+
+  RsaSsaPssKeyFormat pss_format;
+  auto* pss_params = pss_format.mutable_params();
+  pss_params->set_sig_hash(HashType::SHA256);
+  pss_params->set_mgf1_hash(HashType::SHA256);
+  pss_params->set_salt_length(32);
+  pss_format.set_modulus_size_in_bits(3072);
+  pss_format.set_public_exponent(public_exponent);
+  EXPECT_EQ(SignatureKeyTemplates::RsaSsaPss3072Sha256Sha256F4().value(),
+            pss_format.SerializeAsString());
+  pss_params->set_sig_hash(HashType::SHA512);
+  pss_params->set_mgf1_hash(HashType::SHA512);
+  pss_params->set_salt_length(64);
+  pss_format.set_modulus_size_in_bits(4096);
+  EXPECT_EQ(SignatureKeyTemplates::RsaSsaPss4096Sha512Sha512F4().value(),
+            pss_format.SerializeAsString());
+  pss_params->set_sig_hash(HashType::SHA384);
+  pss_params->set_mgf1_hash(HashType::SHA384);
+  pss_params->set_salt_length(48);
+  EXPECT_EQ(SignatureKeyTemplates::RsaSsaPss4096Sha384Sha384F4().value(),
+            pss_format.SerializeAsString());
+
+  EXPECT_TRUE(SignatureKeyTemplates::Ed25519().value().empty());
+  EXPECT_TRUE(SignatureKeyTemplates::Ed25519WithRawOutput().value().empty());
+}
+
 }  // namespace
 }  // namespace tink
 }  // namespace crypto
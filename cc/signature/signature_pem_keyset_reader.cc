@@ -16,10 +16,14 @@
 
 #include "tink/signature/signature_pem_keyset_reader.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <memory>
 #include <random>
+#include <thread>
+#include <vector>
 
+#include "absl/container/flat_hash_set.h"
 #include "absl/memory/memory.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
@@ -31,7 +35,6 @@
 #include "tink/subtle/pem_parser_boringssl.h"
 #include "tink/subtle/subtle_util_boringssl.h"
 #include "tink/util/enums.h"
-#include "tink/util/keyset_util.h"
 #include "tink/util/secret_data.h"
 #include "tink/util/status.h"
 #include "tink/util/statusor.h"
@@ -167,8 +170,9 @@ RsaSsaPkcs1PrivateKey NewRsaSsaPkcs1PrivateKey(
   return private_key_proto;
 }
 
-// Adds the PEM-encoded private key `pem_key` to `keyset`.
-util::Status AddRsaSsaPrivateKey(const PemKey& pem_key, Keyset* keyset) {
+// Parses the PEM-encoded private key `pem_key` and returns the resulting
+// Keyset::Key; its key id is assigned later, during keyset assembly.
+util::StatusOr<Keyset::Key> RsaSsaPrivateKeyFromPem(const PemKey& pem_key) {
   // Try to parse the PEM RSA private key.
   auto private_key_subtle_or =
       subtle::PemParser::ParseRsaPrivateKey(pem_key.serialized_key);
@@ -197,11 +201,9 @@ util::Status AddRsaSsaPrivateKey(const PemKey& pem_key, Keyset* keyset) {
       auto key_validation_status = key_manager.ValidateKey(private_key_proto);
       if (!key_validation_status.ok()) return key_validation_status;
 
-      *keyset->add_key() =
-          NewKeysetKey(GenerateUnusedKeyId(*keyset), key_manager.get_key_type(),
-                       key_manager.key_material_type(),
-                       private_key_proto.SerializeAsString());
-      break;
+      return NewKeysetKey(/* key_id = */ 0, key_manager.get_key_type(),
+                          key_manager.key_material_type(),
+                          private_key_proto.SerializeAsString());
     }
     case PemAlgorithm::RSASSA_PKCS1: {
       RsaSsaPkcs1SignKeyManager key_manager;
@@ -212,25 +214,20 @@ util::Status AddRsaSsaPrivateKey(const PemKey& pem_key, Keyset* keyset) {
       auto key_validation_status = key_manager.ValidateKey(private_key_proto);
       if (!key_validation_status.ok()) return key_validation_status;
 
-      *keyset->add_key() =
-          NewKeysetKey(GenerateUnusedKeyId(*keyset), key_manager.get_key_type(),
-                       key_manager.key_material_type(),
-                       private_key_proto.SerializeAsString());
-
-      break;
+      return NewKeysetKey(/* key_id = */ 0, key_manager.get_key_type(),
+                          key_manager.key_material_type(),
+                          private_key_proto.SerializeAsString());
     }
     default:
       return util::Status(
           util::error::INVALID_ARGUMENT,
           absl::StrCat("Invalid RSA algorithm ", pem_key.parameters.algorithm));
   }
-
-  return util::OkStatus();
 }
 
-// Parses a given PEM-encoded RSA public key `pem_key`, and adds it to the
-// keyset `keyset`.
-util::Status AddRsaSsaPublicKey(const PemKey& pem_key, Keyset* keyset) {
+// Parses the PEM-encoded public key `pem_key` and returns the resulting
+// Keyset::Key; its key id is assigned later, during keyset assembly.
+util::StatusOr<Keyset::Key> RsaSsaPublicKeyFromPem(const PemKey& pem_key) {
   // Parse the PEM string into a RSA public key.
   auto public_key_subtle_or =
       subtle::PemParser::ParseRsaPublicKey(pem_key.serialized_key);
@@ -267,12 +264,9 @@ util::Status AddRsaSsaPublicKey(const PemKey& pem_key, Keyset* keyset) {
       auto key_validation_status = key_manager.ValidateKey(public_key_proto);
       if (!key_validation_status.ok()) return key_validation_status;
 
-      *keyset->add_key() =
-          NewKeysetKey(GenerateUnusedKeyId(*keyset), key_manager.get_key_type(),
-                       key_manager.key_material_type(),
-                       public_key_proto.SerializeAsString());
-
-      break;
+      return NewKeysetKey(/* key_id = */ 0, key_manager.get_key_type(),
+                          key_manager.key_material_type(),
+                          public_key_proto.SerializeAsString());
     }
     case PemAlgorithm::RSASSA_PKCS1: {
       RsaSsaPkcs1PublicKey public_key_proto;
@@ -291,18 +285,100 @@ util::Status AddRsaSsaPublicKey(const PemKey& pem_key, Keyset* keyset) {
       auto key_validation_status = key_manager.ValidateKey(public_key_proto);
       if (!key_validation_status.ok()) return key_validation_status;
 
-      *keyset->add_key() =
-          NewKeysetKey(GenerateUnusedKeyId(*keyset), key_manager.get_key_type(),
-                       key_manager.key_material_type(),
-                       public_key_proto.SerializeAsString());
-      break;
+      return NewKeysetKey(/* key_id = */ 0, key_manager.get_key_type(),
+                          key_manager.key_material_type(),
+                          public_key_proto.SerializeAsString());
     }
     default:
       return util::Status(
           util::error::INVALID_ARGUMENT,
           absl::StrCat("Invalid RSA algorithm ", pem_key.parameters.algorithm));
   }
-  return util::OkStatus();
+}
+
+// Parses a single PEM-encoded key into a Keyset::Key.
+util::StatusOr<Keyset::Key> KeyFromPem(const PemKey& pem_key,
+                                       bool private_keys) {
+  switch (pem_key.parameters.key_type) {
+    case PemKeyType::PEM_RSA:
+      return private_keys ? RsaSsaPrivateKeyFromPem(pem_key)
+                          : RsaSsaPublicKeyFromPem(pem_key);
+    default:
+      return util::Status(util::error::UNIMPLEMENTED,
+                          "EC Keys Parsing unimplemented");
+  }
+}
+
+// Number of PEM keys from which parsing is spread over worker threads;
+// below this the thread setup costs more than it saves.
+constexpr size_t kParallelParseThreshold = 32;
+
+// Parses all of 'pem_keys' and assembles them into a keyset, with the first
+// key as primary. Parsing dominates the cost of an import (per-key BIO and
+// EVP_PKEY handling in PemParser), so for bulk imports the keys are parsed
+// in parallel on contiguous slices and the keyset is assembled serially
+// afterwards, preserving the input order and first-error semantics of the
+// sequential path.
+util::StatusOr<std::unique_ptr<Keyset>> AssembleKeyset(
+    const std::vector<PemKey>& pem_keys, bool private_keys) {
+  std::vector<util::Status> statuses(pem_keys.size(), util::OkStatus());
+  std::vector<Keyset::Key> keys(pem_keys.size());
+
+  auto parse_range = [&pem_keys, &statuses, &keys, private_keys](size_t begin,
+                                                                 size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      auto key_or = KeyFromPem(pem_keys[i], private_keys);
+      if (key_or.ok()) {
+        keys[i] = std::move(key_or.ValueOrDie());
+      } else {
+        statuses[i] = key_or.status();
+      }
+    }
+  };
+
+  size_t worker_count = std::thread::hardware_concurrency();
+  if (pem_keys.size() < kParallelParseThreshold || worker_count <= 1) {
+    parse_range(0, pem_keys.size());
+  } else {
+    worker_count = std::min(worker_count, pem_keys.size());
+    size_t slice_size = (pem_keys.size() + worker_count - 1) / worker_count;
+    std::vector<std::thread> workers;
+    for (size_t begin = 0; begin < pem_keys.size(); begin += slice_size) {
+      workers.push_back(std::thread(
+          parse_range, begin,
+          std::min(begin + slice_size, pem_keys.size())));
+    }
+    for (auto& worker : workers) {
+      worker.join();
+    }
+  }
+
+  // Report the first failure in input order, as the sequential path did.
+  for (const auto& status : statuses) {
+    if (!status.ok()) return status;
+  }
+
+  // Assign fresh random key ids, tracking used ids in a set instead of
+  // re-scanning the growing keyset per key, which is quadratic in the
+  // number of imported keys.
+  auto keyset = absl::make_unique<Keyset>();
+  std::random_device rd;
+  std::minstd_rand0 gen(rd());
+  std::uniform_int_distribution<uint32_t> dist;
+  absl::flat_hash_set<uint32_t> used_ids;
+  used_ids.reserve(keys.size());
+  for (auto& key : keys) {
+    uint32_t key_id;
+    do {
+      key_id = dist(gen);
+    } while (!used_ids.insert(key_id).second);
+    key.set_key_id(key_id);
+    *keyset->add_key() = std::move(key);
+  }
+
+  // Set the 1st key as primary.
+  keyset->set_primary_key_id(keyset->key(0).key_id());
+  return std::move(keyset);
 }
 
 }  // namespace
@@ -338,25 +414,7 @@ util::StatusOr<std::unique_ptr<Keyset>> PublicKeySignPemKeysetReader::Read() {
                         "Empty array of PEM-encoded keys");
   }
 
-  auto keyset = absl::make_unique<Keyset>();
-  for (const PemKey& pem_key : pem_serialized_keys_) {
-    // Parse and add the new key to the keyset.
-    switch (pem_key.parameters.key_type) {
-      case PemKeyType::PEM_RSA: {
-        auto add_rsassa_pss_status = AddRsaSsaPrivateKey(pem_key, keyset.get());
-        if (!add_rsassa_pss_status.ok()) return add_rsassa_pss_status;
-        break;
-      }
-      default:
-        return util::Status(util::error::UNIMPLEMENTED,
-                            "EC Keys Parsing unimplemented");
-    }
-  }
-
-  // Set the 1st key as primary.
-  keyset->set_primary_key_id(keyset->key(0).key_id());
-
-  return keyset;
+  return AssembleKeyset(pem_serialized_keys_, /* private_keys = */ true);
 }
 
 util::StatusOr<std::unique_ptr<Keyset>> PublicKeyVerifyPemKeysetReader::Read() {
@@ -365,25 +423,7 @@ util::StatusOr<std::unique_ptr<Keyset>> PublicKeyVerifyPemKeysetReader::Read() {
                         "Empty array of PEM-encoded keys");
   }
 
-  auto keyset = absl::make_unique<Keyset>();
-  for (const PemKey& pem_key : pem_serialized_keys_) {
-    // Parse and add the new key to the keyset.
-    switch (pem_key.parameters.key_type) {
-      case PemKeyType::PEM_RSA: {
-        auto add_rsassa_pss_status = AddRsaSsaPublicKey(pem_key, keyset.get());
-        if (!add_rsassa_pss_status.ok()) return add_rsassa_pss_status;
-        break;
-      }
-      default:
-        return util::Status(util::error::UNIMPLEMENTED,
-                            "EC Keys Parsing unimplemented");
-    }
-  }
-
-  // Set the 1st key as primary.
-  keyset->set_primary_key_id(keyset->key(0).key_id());
-
-  return keyset;
+  return AssembleKeyset(pem_serialized_keys_, /* private_keys = */ false);
 }
 
 util::StatusOr<std::unique_ptr<EncryptedKeyset>>
@@ -16,6 +16,7 @@
 #include "tink/signature/signature_pem_keyset_reader.h"
 
 #include <memory>
+#include <set>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -262,6 +263,42 @@ TEST(SignaturePemKeysetReaderTest, ReadCorrectPublicKey) {
   EXPECT_THAT(keyset->key(1), EqualsKey(expected_key2));
 }
 
+TEST(SignaturePemKeysetReaderTest, ReadManyPublicKeys) {
+  auto builder = SignaturePemKeysetReaderBuilder(
+      SignaturePemKeysetReaderBuilder::PemReaderType::PUBLIC_KEY_VERIFY);
+
+  // Enough keys to exercise the parallel parsing path.
+  constexpr int kNumKeys = 40;
+  for (int i = 0; i < kNumKeys; i++) {
+    builder.Add({.serialized_key = std::string(kRsaPublicKey2048),
+                 .parameters = {.key_type = PemKeyType::PEM_RSA,
+                                .algorithm = PemAlgorithm::RSASSA_PSS,
+                                .key_size_in_bits = 2048,
+                                .hash_type = HashType::SHA256}});
+  }
+
+  auto keyset_reader_or = builder.Build();
+  ASSERT_THAT(keyset_reader_or.status(), IsOk());
+  std::unique_ptr<KeysetReader> keyset_reader =
+      std::move(keyset_reader_or).ValueOrDie();
+
+  auto keyset_or = keyset_reader->Read();
+  ASSERT_THAT(keyset_or.status(), IsOk());
+  std::unique_ptr<Keyset> keyset = std::move(keyset_or).ValueOrDie();
+
+  RsaSsaPssVerifyKeyManager verify_key_manager;
+  ASSERT_THAT(keyset->key(), SizeIs(kNumKeys));
+  EXPECT_EQ(keyset->primary_key_id(), keyset->key(0).key_id());
+  std::set<uint32_t> key_ids;
+  for (const Keyset::Key& key : keyset->key()) {
+    key_ids.insert(key.key_id());
+    EXPECT_EQ(key.status(), KeyStatusType::ENABLED);
+    EXPECT_EQ(key.key_data().type_url(), verify_key_manager.get_key_type());
+  }
+  // Key IDs are unique.
+  EXPECT_THAT(key_ids, SizeIs(kNumKeys));
+}
+
 TEST(SignaturePemKeysetReaderTest, ReadCorrectPrivateKey) {
   auto builder = SignaturePemKeysetReaderBuilder(
       SignaturePemKeysetReaderBuilder::PemReaderType::PUBLIC_KEY_SIGN);
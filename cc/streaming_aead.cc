@@ -0,0 +1,117 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/streaming_aead.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/string_view.h"
+#include "tink/input_stream.h"
+#include "tink/output_stream.h"
+#include "tink/util/cord_input_stream.h"
+#include "tink/util/cord_output_stream.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+
+crypto::tink::util::StatusOr<absl::Cord> StreamingAead::EncryptCord(
+    const absl::Cord& plaintext, absl::string_view associated_data) {
+  absl::Cord ciphertext;
+  auto encrypting_stream_result = NewEncryptingStream(
+      absl::make_unique<util::CordOutputStream>(&ciphertext), associated_data);
+  if (!encrypting_stream_result.ok()) {
+    return encrypting_stream_result.status();
+  }
+  auto encrypting_stream = std::move(encrypting_stream_result.ValueOrDie());
+  for (absl::string_view chunk : plaintext.Chunks()) {
+    while (!chunk.empty()) {
+      void* buffer;
+      auto next_result = encrypting_stream->Next(&buffer);
+      if (!next_result.ok()) return next_result.status();
+      int available = next_result.ValueOrDie();
+      int count =
+          std::min(static_cast<int64_t>(available),
+                   static_cast<int64_t>(chunk.size()));
+      std::memcpy(buffer, chunk.data(), count);
+      if (count < available) {
+        encrypting_stream->BackUp(available - count);
+      }
+      chunk.remove_prefix(count);
+    }
+  }
+  auto close_status = encrypting_stream->Close();
+  if (!close_status.ok()) return close_status;
+  return ciphertext;
+}
+
+crypto::tink::util::StatusOr<absl::Cord> StreamingAead::DecryptCord(
+    const absl::Cord& ciphertext, absl::string_view associated_data) {
+  auto decrypting_stream_result = NewDecryptingStream(
+      absl::make_unique<util::CordInputStream>(ciphertext), associated_data);
+  if (!decrypting_stream_result.ok()) {
+    return decrypting_stream_result.status();
+  }
+  auto decrypting_stream = std::move(decrypting_stream_result.ValueOrDie());
+  absl::Cord plaintext;
+  while (true) {
+    const void* buffer;
+    auto next_result = decrypting_stream->Next(&buffer);
+    if (!next_result.ok()) {
+      if (next_result.status().error_code() == util::error::OUT_OF_RANGE) {
+        break;  // end of plaintext
+      }
+      return next_result.status();
+    }
+    plaintext.Append(absl::string_view(static_cast<const char*>(buffer),
+                                       next_result.ValueOrDie()));
+  }
+  return plaintext;
+}
+
+crypto::tink::util::Status StreamingAead::ValidateCiphertext(
+    std::unique_ptr<InputStream> ciphertext_source,
+    absl::string_view associated_data) {
+  auto decrypting_stream_result =
+      NewDecryptingStream(std::move(ciphertext_source), associated_data);
+  if (!decrypting_stream_result.ok()) {
+    return decrypting_stream_result.status();
+  }
+  auto decrypting_stream = std::move(decrypting_stream_result.ValueOrDie());
+  // Drain the stream without keeping any plaintext: each Next() call
+  // authenticates one segment and returns a view into the stream's internal
+  // buffer, which the next iteration reuses.
+  while (true) {
+    const void* buffer;
+    auto next_result = decrypting_stream->Next(&buffer);
+    if (!next_result.ok()) {
+      if (next_result.status().error_code() == util::error::OUT_OF_RANGE) {
+        // The stream ended with a successfully authenticated last segment.
+        return util::OkStatus();
+      }
+      return next_result.status();
+    }
+  }
+}
+
+}  // namespace tink
+}  // namespace crypto
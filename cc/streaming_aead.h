@@ -19,6 +19,7 @@
 
 #include <memory>
 
+#include "absl/strings/cord.h"
 #include "absl/strings/string_view.h"
 #include "tink/input_stream.h"
 #include "tink/output_stream.h"
@@ -77,6 +78,45 @@ class StreamingAead {
       std::unique_ptr<crypto::tink::RandomAccessStream> ciphertext_source,
       absl::string_view associated_data) = 0;
 
+  // Encrypts 'plaintext' with 'associated_data' as associated authenticated
+  // data, and returns the complete ciphertext (including the stream header)
+  // as an absl::Cord. The default implementation feeds the chunks of
+  // 'plaintext' through NewEncryptingStream() and hands the ciphertext
+  // buffers over to the returned Cord without copying them.
+  virtual crypto::tink::util::StatusOr<absl::Cord> EncryptCord(
+      const absl::Cord& plaintext, absl::string_view associated_data);
+
+  // Decrypts 'ciphertext' (as produced by EncryptCord() or by an encrypting
+  // stream of this primitive) with 'associated_data' as associated
+  // authenticated data, and returns the plaintext as an absl::Cord. The
+  // default implementation walks the chunks of 'ciphertext' in place via
+  // NewDecryptingStream(), without flattening the Cord.
+  virtual crypto::tink::util::StatusOr<absl::Cord> DecryptCord(
+      const absl::Cord& ciphertext, absl::string_view associated_data);
+
+  // Verifies the integrity of the entire 'ciphertext_source' (with
+  // 'associated_data' as associated authenticated data) without surfacing
+  // any plaintext: returns OK iff every segment of the ciphertext
+  // authenticates, including the last one, so truncation is detected.
+  // Integrity-only scans (e.g. storage scrubbing) should prefer this over
+  // reading through NewDecryptingStream() into a sink: the plaintext of
+  // each segment only ever exists in one internal scratch buffer, which is
+  // reused across segments and never copied out. Note that authenticating
+  // a segment still requires running the cipher over it; the savings are
+  // the plaintext copies and the output plumbing, not the cryptography.
+  virtual crypto::tink::util::Status ValidateCiphertext(
+      std::unique_ptr<crypto::tink::InputStream> ciphertext_source,
+      absl::string_view associated_data);
+
+  // Returns the size (in bytes) of the header that this primitive expects
+  // at the beginning of a matching ciphertext stream, or -1 if the size
+  // is not known. A returned value >= 0 must be exact: it allows callers
+  // that hold several candidate primitives (e.g. the keys of a keyset)
+  // to skip, based on the header size declared in the ciphertext stream,
+  // candidates that cannot possibly match, without attempting a full
+  // trial decryption with each of them.
+  virtual int64_t ExpectedCiphertextHeaderSize() const { return -1; }
+
   virtual ~StreamingAead() {}
 };
 
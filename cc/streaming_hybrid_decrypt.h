@@ -0,0 +1,52 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_STREAMING_HYBRID_DECRYPT_H_
+#define TINK_STREAMING_HYBRID_DECRYPT_H_
+
+#include <memory>
+
+#include "absl/strings/string_view.h"
+#include "tink/input_stream.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+
+// The interface for the recipient side of streaming hybrid encryption;
+// see StreamingHybridEncrypt for the sender side and the security
+// properties.
+class StreamingHybridDecrypt {
+ public:
+  // Returns a wrapper around 'ciphertext_source', such that reading via the
+  // wrapper decrypts the underlying ciphertext stream with the recipient's
+  // private key, verifying that it was produced with the same
+  // 'context_info'. The wrapper holds only constant-size state, so
+  // ciphertexts of arbitrary size can be read with constant memory.
+  // ByteCount() of the wrapper returns the number of read plaintext bytes.
+  virtual crypto::tink::util::StatusOr<
+      std::unique_ptr<crypto::tink::InputStream>>
+  NewDecryptingStream(
+      std::unique_ptr<crypto::tink::InputStream> ciphertext_source,
+      absl::string_view context_info) const = 0;
+
+  virtual ~StreamingHybridDecrypt() {}
+};
+
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_STREAMING_HYBRID_DECRYPT_H_
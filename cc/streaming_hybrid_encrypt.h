@@ -0,0 +1,60 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_STREAMING_HYBRID_ENCRYPT_H_
+#define TINK_STREAMING_HYBRID_ENCRYPT_H_
+
+#include <memory>
+
+#include "absl/strings/string_view.h"
+#include "tink/output_stream.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+
+// The interface for the sender side of streaming hybrid encryption:
+// public-key encryption of plaintexts that are too large to be staged
+// in memory, combining a KEM with a streaming DEM.
+//
+// As with HybridEncrypt, 'context_info' is bound to the ciphertext and
+// the same value must be provided upon decryption (cf.
+// StreamingHybridDecrypt). The security properties of the ciphertext
+// stream match those of the underlying streaming AEAD used as DEM;
+// like general hybrid encryption this provides privacy only, not
+// sender authenticity.
+class StreamingHybridEncrypt {
+ public:
+  // Returns a wrapper around 'ciphertext_destination', such that any bytes
+  // written via the wrapper are encrypted under the recipient's public key
+  // with 'context_info' bound to the ciphertext. The wrapper holds only
+  // constant-size state, so plaintexts of arbitrary size can be written
+  // with constant memory. ByteCount() of the wrapper returns the number of
+  // written plaintext bytes; closing the wrapper results in closing of the
+  // wrapped stream.
+  virtual crypto::tink::util::StatusOr<
+      std::unique_ptr<crypto::tink::OutputStream>>
+  NewEncryptingStream(
+      std::unique_ptr<crypto::tink::OutputStream> ciphertext_destination,
+      absl::string_view context_info) const = 0;
+
+  virtual ~StreamingHybridEncrypt() {}
+};
+
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_STREAMING_HYBRID_ENCRYPT_H_
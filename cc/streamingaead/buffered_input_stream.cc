@@ -34,7 +34,9 @@ using util::Status;
 using util::StatusOr;
 
 BufferedInputStream::BufferedInputStream(
-    std::unique_ptr<crypto::tink::InputStream> input_stream) {
+    std::unique_ptr<crypto::tink::InputStream> input_stream,
+    int64_t max_buffered_bytes) :
+    max_buffered_bytes_(max_buffered_bytes) {
   input_stream_ = std::move(input_stream);
   count_in_buffer_ = 0;
   count_backedup_ = 0;
@@ -43,6 +45,7 @@ BufferedInputStream::BufferedInputStream(
   buffer_offset_ = 0;
   after_rewind_ = false;
   rewinding_enabled_ = true;
+  rewind_window_exceeded_ = false;
   direct_access_ = false;
   status_ = Status::OK;
 }
@@ -73,7 +76,7 @@ crypto::tink::util::StatusOr<int> BufferedInputStream::Next(const void** data) {
   // can be discarded, and from now on we go directly to input_stream_
   if (!rewinding_enabled_) {
     direct_access_ = true;
-    buffer_.resize(0);
+    std::vector<uint8_t>().swap(buffer_);  // actually release the memory
     return input_stream_->Next(data);
   }
 
@@ -87,6 +90,17 @@ crypto::tink::util::StatusOr<int> BufferedInputStream::Next(const void** data) {
     return status_;
   }
   size_t count_read = next_result.ValueOrDie();
+  if (max_buffered_bytes_ >= 0 &&
+      static_cast<int64_t>(count_in_buffer_) + count_read >
+          max_buffered_bytes_) {
+    // Reading past the rewind window: rewinding is not possible any more,
+    // so stop buffering, release the buffer, and relay to input_stream_.
+    rewind_window_exceeded_ = true;
+    direct_access_ = true;
+    std::vector<uint8_t>().swap(buffer_);
+    *data = buf;
+    return count_read;
+  }
   if (buffer_.size() < count_in_buffer_ + count_read) {
     buffer_.resize(buffer_.size() + std::max(buffer_.size(), count_read));
   }
@@ -116,9 +130,21 @@ void BufferedInputStream::BackUp(int count) {
 
 void BufferedInputStream::DisableRewinding() {
   rewinding_enabled_ = false;
+  // If all the buffered bytes were returned to the caller already, we can
+  // release the buffer and relay to input_stream_ right away, rather than
+  // waiting for the next refill in Next().
+  if (!direct_access_ && status_.ok() && count_backedup_ == 0 &&
+      !after_rewind_ && position_ == count_in_buffer_) {
+    direct_access_ = true;
+    std::vector<uint8_t>().swap(buffer_);
+  }
 }
 
 crypto::tink::util::Status BufferedInputStream::Rewind() {
+  if (rewind_window_exceeded_) {
+    return util::Status(util::error::FAILED_PRECONDITION,
+                        "stream was read past the rewind window");
+  }
   if (!rewinding_enabled_) {
     return util::Status(util::error::INVALID_ARGUMENT, "rewinding is disabled");
   }
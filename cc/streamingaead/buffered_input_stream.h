@@ -34,10 +34,17 @@ namespace streamingaead {
 class BufferedInputStream : public crypto::tink::InputStream {
  public:
   // Constructs an InputStream that will read from 'input_stream',
-  // buffering all the read bytes in memory, and offering rewinding
+  // buffering the read bytes in memory, and offering rewinding
   // to the beginning of the stream (as long as rewinding is enabled).
+  // If a non-negative 'max_buffered_bytes' is given, at most that many
+  // bytes are buffered: upon reading past this window the stream stops
+  // buffering, releases the buffer, and relays directly to
+  // 'input_stream', and any subsequent Rewind() fails. This bounds the
+  // memory spent on supporting Rewind(), e.g. to a window large enough
+  // for probing which key matches a ciphertext stream.
   explicit BufferedInputStream(
-      std::unique_ptr<crypto::tink::InputStream> input_stream);
+      std::unique_ptr<crypto::tink::InputStream> input_stream,
+      int64_t max_buffered_bytes = -1);
 
   ~BufferedInputStream() override;
 
@@ -47,14 +54,19 @@ class BufferedInputStream : public crypto::tink::InputStream {
 
   int64_t Position() const override;
 
-  // Rewinds this stream to the beginning (if rewinding is still enabled).
+  // Rewinds this stream to the beginning (if rewinding is still enabled,
+  // and the stream was not read past the rewind window).
   crypto::tink::util::Status Rewind();
 
-  // Disables rewinding.
+  // Disables rewinding. If all the buffered bytes have been returned to
+  // the caller already, this also releases the buffer and switches to
+  // relaying directly to input_stream_.
   void DisableRewinding();
 
  private:
   std::unique_ptr<crypto::tink::InputStream> input_stream_;
+  const int64_t max_buffered_bytes_;  // size of the rewind window,
+                                      // or -1 if unbounded
   bool direct_access_;      // true iff we don't buffer any data any more
 
   // The fields below are valid and in use iff direct_access_ is false.
@@ -64,6 +76,8 @@ class BufferedInputStream : public crypto::tink::InputStream {
   std::vector<uint8_t> buffer_;
   bool after_rewind_;       // true iff no Next has been called after rewind
   bool rewinding_enabled_;  // true iff this stream can be rewound
+  bool rewind_window_exceeded_;  // true iff the stream was read past
+                                 // max_buffered_bytes_
   int64_t position_;     // current position in the stream (from the beginning)
 
   // Counters that describe the state of the data in buffer_.
@@ -320,6 +320,52 @@ TEST(BufferedInputStreamTest, DisableRewindingAfterRewind) {
   }
 }
 
+TEST(BufferedInputStreamTest, BoundedRewindWindow) {
+  int input_size = 100000;
+  std::string contents = subtle::Random::GetRandomBytes(input_size);
+  auto buf_stream = absl::make_unique<BufferedInputStream>(
+      GetInputStream(contents), /* max_buffered_bytes = */ 5000);
+
+  // Reads within the window keep rewinding possible.
+  std::string prefix;
+  auto status = ReadFromStream(buf_stream.get(), 3000, &prefix);
+  EXPECT_THAT(status, IsOk());
+  EXPECT_EQ(contents.substr(0, 3000), prefix);
+  status = buf_stream->Rewind();
+  EXPECT_THAT(status, IsOk());
+  EXPECT_EQ(0, buf_stream->Position());
+
+  // Read past the window; the stream contents remain all readable, ...
+  std::string all;
+  status = ReadFromStream(buf_stream.get(), &all);
+  EXPECT_THAT(status, IsOk());
+  EXPECT_EQ(contents, all);
+  EXPECT_EQ(input_size, buf_stream->Position());
+
+  // ... but rewinding is not possible any more.
+  status = buf_stream->Rewind();
+  EXPECT_THAT(status, StatusIs(util::error::FAILED_PRECONDITION,
+                               HasSubstr("rewind window")));
+}
+
+TEST(BufferedInputStreamTest, UnboundedRewindWindowByDefault) {
+  int input_size = 100000;
+  std::string contents = subtle::Random::GetRandomBytes(input_size);
+  auto buf_stream = absl::make_unique<BufferedInputStream>(
+      GetInputStream(contents));
+
+  // Read the entire stream, rewind, and read it again.
+  for (int i = 0; i < 2; i++) {
+    std::string all;
+    auto status = ReadFromStream(buf_stream.get(), &all);
+    EXPECT_THAT(status, IsOk());
+    EXPECT_EQ(contents, all);
+    status = buf_stream->Rewind();
+    EXPECT_THAT(status, IsOk());
+    EXPECT_EQ(0, buf_stream->Position());
+  }
+}
+
 }  // namespace
 }  // namespace streamingaead
 }  // namespace tink
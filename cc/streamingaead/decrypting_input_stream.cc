@@ -69,8 +69,33 @@ util::StatusOr<int> DecryptingInputStream::Next(const void** data) {
   if (!raw_primitives_result.ok()) {
     return Status(util::error::INTERNAL, "No RAW primitives found");
   }
+  // Parse the header size declared in the ciphertext stream (its first
+  // byte) once, so that candidate keys whose expected header size cannot
+  // match are skipped without a trial decryption. Keys with a matching
+  // header size still require a trial decryption, as the salt in the
+  // header is random and not linked to a particular key.
+  int declared_header_size = -1;
+  const void* peek_buffer;
+  auto peek_result = buffered_ct_source_->Next(&peek_buffer);
+  if (peek_result.ok() && peek_result.ValueOrDie() > 0) {
+    declared_header_size = *static_cast<const uint8_t*>(peek_buffer);
+  }
+  Status rewind_status = buffered_ct_source_->Rewind();
+  if (!rewind_status.ok()) return rewind_status;
   for (auto& primitive : *(raw_primitives_result.ValueOrDie())) {
-    StreamingAead& streaming_aead = primitive->get_primitive();
+    auto streaming_aead_or = primitive->primitive_or_status();
+    // Skip entries whose lazy materialization failed; another key may still
+    // match the ciphertext stream.
+    if (!streaming_aead_or.ok()) continue;
+    StreamingAead& streaming_aead = *streaming_aead_or.ValueOrDie();
+    if (declared_header_size >= 0) {
+      int64_t expected_header_size =
+          streaming_aead.ExpectedCiphertextHeaderSize();
+      if (expected_header_size >= 0 &&
+          expected_header_size != declared_header_size) {
+        continue;  // This key cannot match the ciphertext stream.
+      }
+    }
     auto shared_ct = absl::make_unique<SharedInputStream>(
         buffered_ct_source_.get());
     auto decrypting_stream_result = streaming_aead.NewDecryptingStream(
@@ -97,8 +97,35 @@ util::Status DecryptingRandomAccessStream::PRead(
   if (!raw_primitives_result.ok()) {
     return Status(util::error::INTERNAL, "No RAW primitives found");
   }
+  // Parse the header size declared in the ciphertext stream (its first
+  // byte) once, so that candidate keys whose expected header size cannot
+  // match are skipped without a trial decryption. Keys with a matching
+  // header size still require a trial decryption, as the salt in the
+  // header is random and not linked to a particular key.
+  int declared_header_size = -1;
+  auto peek_buffer_result = util::Buffer::New(1);
+  if (peek_buffer_result.ok()) {
+    auto peek_buffer = std::move(peek_buffer_result.ValueOrDie());
+    auto peek_status = ciphertext_source_->PRead(0, 1, peek_buffer.get());
+    if (peek_status.ok() && peek_buffer->size() == 1) {
+      declared_header_size =
+          *reinterpret_cast<const uint8_t*>(peek_buffer->get_mem_block());
+    }
+  }
   for (auto& primitive : *(raw_primitives_result.ValueOrDie())) {
-    StreamingAead& streaming_aead = primitive->get_primitive();
+    auto streaming_aead_or = primitive->primitive_or_status();
+    // Skip entries whose lazy materialization failed; another key may still
+    // match the ciphertext stream.
+    if (!streaming_aead_or.ok()) continue;
+    StreamingAead& streaming_aead = *streaming_aead_or.ValueOrDie();
+    if (declared_header_size >= 0) {
+      int64_t expected_header_size =
+          streaming_aead.ExpectedCiphertextHeaderSize();
+      if (expected_header_size >= 0 &&
+          expected_header_size != declared_header_size) {
+        continue;  // This key cannot match the ciphertext stream.
+      }
+    }
     auto shared_ct = absl::make_unique<SharedRandomAccessStream>(
         ciphertext_source_.get());
     auto decrypting_stream_result =
@@ -0,0 +1,177 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////////
+#include "tink/streamingaead/encrypted_file.h"
+
+#include <fcntl.h>
+
+#include <cerrno>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "tink/subtle/decrypting_random_access_stream.h"
+#include "tink/subtle/nonce_based_streaming_aead.h"
+#include "tink/util/errors.h"
+#include "tink/util/file_output_stream.h"
+#include "tink/util/mmap_random_access_stream.h"
+#include "tink/util/status.h"
+
+namespace crypto {
+namespace tink {
+namespace streamingaead {
+
+namespace {
+
+// An OutputStream that forwards to an encrypting stream and additionally
+// keeps the primitive which produced it alive.
+class OwningEncryptingStream : public crypto::tink::OutputStream {
+ public:
+  OwningEncryptingStream(
+      std::shared_ptr<crypto::tink::StreamingAead> streaming_aead,
+      std::unique_ptr<crypto::tink::OutputStream> stream)
+      : streaming_aead_(std::move(streaming_aead)),
+        stream_(std::move(stream)) {}
+
+  crypto::tink::util::StatusOr<int> Next(void** data) override {
+    return stream_->Next(data);
+  }
+
+  void BackUp(int count) override { stream_->BackUp(count); }
+
+  crypto::tink::util::Status Close() override { return stream_->Close(); }
+
+  crypto::tink::util::Status WriteChunks(
+      absl::Span<const absl::Span<const uint8_t>> chunks) override {
+    return stream_->WriteChunks(chunks);
+  }
+
+  int64_t Position() const override { return stream_->Position(); }
+
+ private:
+  std::shared_ptr<crypto::tink::StreamingAead> streaming_aead_;
+  std::unique_ptr<crypto::tink::OutputStream> stream_;
+};
+
+}  // namespace
+
+// static
+util::StatusOr<std::unique_ptr<EncryptedFile>> EncryptedFile::OpenForRead(
+    const std::string& filename,
+    std::shared_ptr<crypto::tink::StreamingAead> streaming_aead,
+    absl::string_view associated_data) {
+  return OpenForRead(filename, std::move(streaming_aead), associated_data,
+                     Options());
+}
+
+// static
+util::StatusOr<std::unique_ptr<EncryptedFile>> EncryptedFile::OpenForRead(
+    const std::string& filename,
+    std::shared_ptr<crypto::tink::StreamingAead> streaming_aead,
+    absl::string_view associated_data, const Options& options) {
+  if (streaming_aead == nullptr) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "streaming_aead must be non-null");
+  }
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd == -1) {
+    return ToStatusF(util::error::NOT_FOUND, "Error opening file %s: %d",
+                     filename.c_str(), errno);
+  }
+  auto ciphertext_source = absl::make_unique<util::MmapRandomAccessStream>(
+      fd, options.ciphertext_readahead_bytes);
+
+  auto* subtle_streaming_aead =
+      dynamic_cast<subtle::NonceBasedStreamingAead*>(streaming_aead.get());
+  if (subtle_streaming_aead != nullptr) {
+    subtle::DecryptingRandomAccessStream::Options decrypting_options;
+    decrypting_options.readahead_segments = options.readahead_segments;
+    decrypting_options.readahead_workers = options.readahead_workers;
+    decrypting_options.pread_workers = options.pread_workers;
+    decrypting_options.plaintext_cache_max_bytes =
+        options.plaintext_cache_max_bytes;
+    auto stream_result =
+        subtle_streaming_aead->NewDecryptingRandomAccessStreamWithOptions(
+            std::move(ciphertext_source), associated_data, decrypting_options);
+    if (!stream_result.ok()) return stream_result.status();
+    return std::unique_ptr<EncryptedFile>(new EncryptedFile(
+        std::move(streaming_aead), std::move(stream_result.ValueOrDie())));
+  }
+  // A primitive from a keyset handle is a wrapper object which does not
+  // expose the subtle options; it still benefits from the memory-mapped
+  // ciphertext source.
+  auto stream_result = streaming_aead->NewDecryptingRandomAccessStream(
+      std::move(ciphertext_source), associated_data);
+  if (!stream_result.ok()) return stream_result.status();
+  return std::unique_ptr<EncryptedFile>(new EncryptedFile(
+      std::move(streaming_aead), std::move(stream_result.ValueOrDie())));
+}
+
+util::Status EncryptedFile::PRead(int64_t position, int count,
+                                  util::Buffer* dest_buffer) {
+  return plaintext_stream_->PRead(position, count, dest_buffer);
+}
+
+util::StatusOr<std::string> EncryptedFile::PReadString(int64_t position,
+                                                       int count) {
+  if (count < 0) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "count cannot be negative");
+  }
+  if (count == 0) return std::string();
+  auto buffer_result = util::Buffer::New(count);
+  if (!buffer_result.ok()) return buffer_result.status();
+  auto buffer = std::move(buffer_result.ValueOrDie());
+  auto status = plaintext_stream_->PRead(position, count, buffer.get());
+  if (!status.ok() && status.error_code() != util::error::OUT_OF_RANGE) {
+    return status;
+  }
+  return std::string(buffer->get_mem_block(), buffer->size());
+}
+
+util::StatusOr<int64_t> EncryptedFile::size() {
+  return plaintext_stream_->size();
+}
+
+// static
+util::StatusOr<std::unique_ptr<OutputStream>> EncryptedFile::NewWriter(
+    const std::string& filename,
+    std::shared_ptr<crypto::tink::StreamingAead> streaming_aead,
+    absl::string_view associated_data) {
+  if (streaming_aead == nullptr) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "streaming_aead must be non-null");
+  }
+  int fd = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+  if (fd == -1) {
+    return ToStatusF(util::error::INTERNAL, "Error opening file %s: %d",
+                     filename.c_str(), errno);
+  }
+  auto encrypting_stream_result = streaming_aead->NewEncryptingStream(
+      absl::make_unique<util::FileOutputStream>(fd), associated_data);
+  if (!encrypting_stream_result.ok()) {
+    return encrypting_stream_result.status();
+  }
+  std::unique_ptr<OutputStream> result =
+      absl::make_unique<OwningEncryptingStream>(
+          std::move(streaming_aead),
+          std::move(encrypting_stream_result.ValueOrDie()));
+  return std::move(result);
+}
+
+}  // namespace streamingaead
+}  // namespace tink
+}  // namespace crypto
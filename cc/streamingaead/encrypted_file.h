@@ -0,0 +1,137 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////////
+#ifndef TINK_STREAMINGAEAD_ENCRYPTED_FILE_H_
+#define TINK_STREAMINGAEAD_ENCRYPTED_FILE_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "absl/strings/string_view.h"
+#include "tink/output_stream.h"
+#include "tink/random_access_stream.h"
+#include "tink/streaming_aead.h"
+#include "tink/util/buffer.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace streamingaead {
+
+// A high-level utility for files encrypted with a StreamingAead, replacing
+// the glue that callers otherwise hand-roll around
+// NewDecryptingRandomAccessStream: opening the file, memory-mapping the
+// ciphertext, and wiring up readahead, segment caching and buffer pooling.
+// It composes the fast paths of the streaming stack behind a plain
+// pread-style interface:
+//  - the ciphertext is served from a memory mapping with kernel readahead
+//    hints (util::MmapRandomAccessStream), avoiding a read-syscall per
+//    request;
+//  - when the primitive is a concrete subtle streaming AEAD, decryption
+//    runs with background segment readahead, an LRU cache of decrypted
+//    segments and parallel sub-reads for requests spanning several
+//    segments (see subtle::DecryptingRandomAccessStream::Options);
+//    primitives obtained from a keyset handle are wrapper objects without
+//    these knobs, and then get the plain decrypting stream;
+//  - segment buffers come from the pools built into the streaming
+//    implementations, so steady-state reads and writes do not allocate.
+// Instances are thread safe: PRead may be called concurrently.
+class EncryptedFile {
+ public:
+  // Performance knobs of the read path; the defaults suit mostly-sequential
+  // readers of files larger than a few segments.
+  struct Options {
+    // Size (in bytes) of the window of ciphertext following each read that
+    // the memory mapping advises the kernel to prefetch. -1 (the default)
+    // uses the default window of util::MmapRandomAccessStream; 0 disables
+    // the hints.
+    int64_t ciphertext_readahead_bytes = -1;
+    // Number of segments decrypted in the background ahead of the most
+    // recently read one; 0 disables readahead. Effective only with a
+    // concrete subtle streaming AEAD (see class comment).
+    int readahead_segments = 2;
+    // Number of worker threads serving the segment readahead.
+    int readahead_workers = 2;
+    // Maximum number of concurrent sub-reads for a single PRead spanning
+    // several segments; 1 keeps segment reads serial.
+    int pread_workers = 1;
+    // Maximum total size (in bytes) of decrypted segments kept in an LRU
+    // cache; 0 disables the cache.
+    int64_t plaintext_cache_max_bytes = 4 * 1024 * 1024;
+  };
+
+  // Opens the file at 'filename', to be decrypted with 'streaming_aead'
+  // using 'associated_data' as authenticated associated data. The file must
+  // be a complete ciphertext; concurrent writers are not supported.
+  static crypto::tink::util::StatusOr<std::unique_ptr<EncryptedFile>>
+  OpenForRead(const std::string& filename,
+              std::shared_ptr<crypto::tink::StreamingAead> streaming_aead,
+              absl::string_view associated_data);
+
+  // As above, with explicit 'options'.
+  static crypto::tink::util::StatusOr<std::unique_ptr<EncryptedFile>>
+  OpenForRead(const std::string& filename,
+              std::shared_ptr<crypto::tink::StreamingAead> streaming_aead,
+              absl::string_view associated_data, const Options& options);
+
+  // Reads 'count' bytes of plaintext starting at 'position' into
+  // 'dest_buffer'; 'position' and 'count' refer to the plaintext. Returns
+  // OUT_OF_RANGE (with the available bytes in 'dest_buffer') when the read
+  // reaches the end of the plaintext.
+  crypto::tink::util::Status PRead(int64_t position, int count,
+                                   crypto::tink::util::Buffer* dest_buffer);
+
+  // Convenience variant returning the read bytes as a string; a read
+  // reaching the end of the plaintext returns the (possibly empty) bytes
+  // before the end rather than OUT_OF_RANGE.
+  crypto::tink::util::StatusOr<std::string> PReadString(int64_t position,
+                                                        int count);
+
+  // Returns the size of the plaintext. As with
+  // NewDecryptingRandomAccessStream, the value is not authenticated:
+  // reading the last segment verifies it.
+  crypto::tink::util::StatusOr<int64_t> size();
+
+  // Creates (or truncates) the file at 'filename' and returns a stream
+  // encrypting everything written to it with 'streaming_aead', using
+  // 'associated_data' as authenticated associated data. Ciphertext
+  // segments are sequential, so writes are append-only: there is no
+  // pwrite at arbitrary positions, and the file is complete only after
+  // Close(). The returned stream keeps 'streaming_aead' alive.
+  static crypto::tink::util::StatusOr<
+      std::unique_ptr<crypto::tink::OutputStream>>
+  NewWriter(const std::string& filename,
+            std::shared_ptr<crypto::tink::StreamingAead> streaming_aead,
+            absl::string_view associated_data);
+
+ private:
+  EncryptedFile(
+      std::shared_ptr<crypto::tink::StreamingAead> streaming_aead,
+      std::unique_ptr<crypto::tink::RandomAccessStream> plaintext_stream)
+      : streaming_aead_(std::move(streaming_aead)),
+        plaintext_stream_(std::move(plaintext_stream)) {}
+
+  // Keeps the primitive alive for the lifetime of the decrypting stream.
+  std::shared_ptr<crypto::tink::StreamingAead> streaming_aead_;
+  std::unique_ptr<crypto::tink::RandomAccessStream> plaintext_stream_;
+};
+
+}  // namespace streamingaead
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_STREAMINGAEAD_ENCRYPTED_FILE_H_
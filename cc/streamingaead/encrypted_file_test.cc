@@ -0,0 +1,207 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////////
+#include "tink/streamingaead/encrypted_file.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
+#include "tink/output_stream.h"
+#include "tink/streaming_aead.h"
+#include "tink/subtle/aes_gcm_hkdf_streaming.h"
+#include "tink/subtle/common_enums.h"
+#include "tink/subtle/random.h"
+#include "tink/util/buffer.h"
+#include "tink/util/status.h"
+#include "tink/util/test_matchers.h"
+#include "tink/util/test_util.h"
+
+namespace crypto {
+namespace tink {
+namespace streamingaead {
+namespace {
+
+using ::crypto::tink::test::IsOk;
+using ::crypto::tink::test::StatusIs;
+using ::testing::Eq;
+
+constexpr char kAssociatedData[] = "some associated data";
+
+std::shared_ptr<StreamingAead> GetStreamingAead(int ct_segment_size) {
+  subtle::AesGcmHkdfStreaming::Params params;
+  params.ikm = subtle::Random::GetRandomKeyBytes(32);
+  params.hkdf_hash = subtle::SHA256;
+  params.derived_key_size = 32;
+  params.ciphertext_segment_size = ct_segment_size;
+  params.ciphertext_offset = 0;
+  auto result = subtle::AesGcmHkdfStreaming::New(std::move(params));
+  EXPECT_THAT(result.status(), IsOk());
+  return std::move(result.ValueOrDie());
+}
+
+// Writes all of 'data' to 'output' and closes it.
+util::Status WriteAllAndClose(absl::string_view data, OutputStream* output) {
+  size_t pos = 0;
+  while (pos < data.size()) {
+    void* buffer;
+    auto next_result = output->Next(&buffer);
+    if (!next_result.ok()) return next_result.status();
+    size_t available = next_result.ValueOrDie();
+    size_t to_copy = std::min(available, data.size() - pos);
+    std::memcpy(buffer, data.data() + pos, to_copy);
+    if (to_copy < available) {
+      output->BackUp(available - to_copy);
+    }
+    pos += to_copy;
+  }
+  return output->Close();
+}
+
+// Writes 'plaintext' encrypted with 'streaming_aead' to a fresh file in the
+// test tmp dir, and returns the filename.
+std::string WriteEncryptedFile(std::shared_ptr<StreamingAead> streaming_aead,
+                               absl::string_view plaintext,
+                               absl::string_view filename) {
+  std::string full_filename = absl::StrCat(test::TmpDir(), "/", filename);
+  auto writer_result = EncryptedFile::NewWriter(
+      full_filename, std::move(streaming_aead), kAssociatedData);
+  EXPECT_THAT(writer_result.status(), IsOk());
+  auto status =
+      WriteAllAndClose(plaintext, writer_result.ValueOrDie().get());
+  EXPECT_THAT(status, IsOk());
+  return full_filename;
+}
+
+TEST(EncryptedFileTest, WriteAndReadBack) {
+  auto streaming_aead = GetStreamingAead(/* ct_segment_size = */ 4096);
+  std::string plaintext = subtle::Random::GetRandomBytes(100000);
+  std::string filename =
+      WriteEncryptedFile(streaming_aead, plaintext, "encrypted_file_basic");
+
+  auto file_result =
+      EncryptedFile::OpenForRead(filename, streaming_aead, kAssociatedData);
+  ASSERT_THAT(file_result.status(), IsOk());
+  auto file = std::move(file_result.ValueOrDie());
+
+  auto size_result = file->size();
+  ASSERT_THAT(size_result.status(), IsOk());
+  EXPECT_THAT(size_result.ValueOrDie(),
+              Eq(static_cast<int64_t>(plaintext.size())));
+
+  // The whole plaintext in one read.
+  auto contents = file->PReadString(0, plaintext.size());
+  ASSERT_THAT(contents.status(), IsOk());
+  EXPECT_EQ(contents.ValueOrDie(), plaintext);
+
+  // Reads at assorted positions, including within and across segments.
+  for (int64_t position : {0, 1, 4000, 4096, 8200, 99990}) {
+    int count = 100;
+    auto chunk = file->PReadString(position, count);
+    ASSERT_THAT(chunk.status(), IsOk());
+    EXPECT_EQ(chunk.ValueOrDie(),
+              plaintext.substr(position, count));
+  }
+
+  // pread-style access via a caller-owned buffer.
+  auto buffer = std::move(util::Buffer::New(512).ValueOrDie());
+  ASSERT_THAT(file->PRead(1234, 512, buffer.get()), IsOk());
+  EXPECT_EQ(std::string(buffer->get_mem_block(), buffer->size()),
+            plaintext.substr(1234, 512));
+
+  // Reads reaching past the end return the available bytes.
+  auto tail = file->PReadString(plaintext.size() - 10, 100);
+  ASSERT_THAT(tail.status(), IsOk());
+  EXPECT_EQ(tail.ValueOrDie(), plaintext.substr(plaintext.size() - 10));
+  EXPECT_THAT(file->PRead(plaintext.size() - 10, 100, buffer.get()),
+              StatusIs(util::error::OUT_OF_RANGE));
+}
+
+TEST(EncryptedFileTest, ReadWithAllFastPathsEnabled) {
+  auto streaming_aead = GetStreamingAead(/* ct_segment_size = */ 4096);
+  std::string plaintext = subtle::Random::GetRandomBytes(200000);
+  std::string filename =
+      WriteEncryptedFile(streaming_aead, plaintext, "encrypted_file_fast");
+
+  EncryptedFile::Options options;
+  options.readahead_segments = 4;
+  options.readahead_workers = 2;
+  options.pread_workers = 2;
+  options.plaintext_cache_max_bytes = 1 << 20;
+  auto file_result = EncryptedFile::OpenForRead(filename, streaming_aead,
+                                                kAssociatedData, options);
+  ASSERT_THAT(file_result.status(), IsOk());
+  auto file = std::move(file_result.ValueOrDie());
+
+  // A sequential scan in chunks spanning several segments each.
+  std::string read_back;
+  int chunk_size = 10000;
+  for (int64_t position = 0; position < static_cast<int64_t>(plaintext.size());
+       position += chunk_size) {
+    auto chunk = file->PReadString(position, chunk_size);
+    ASSERT_THAT(chunk.status(), IsOk());
+    read_back.append(chunk.ValueOrDie());
+  }
+  EXPECT_EQ(read_back, plaintext);
+
+  // Re-reads of a hot range are served from the plaintext cache and must
+  // return the same bytes.
+  for (int i = 0; i < 3; i++) {
+    auto chunk = file->PReadString(50000, 20000);
+    ASSERT_THAT(chunk.status(), IsOk());
+    EXPECT_EQ(chunk.ValueOrDie(), plaintext.substr(50000, 20000));
+  }
+}
+
+TEST(EncryptedFileTest, WrongAssociatedDataFails) {
+  auto streaming_aead = GetStreamingAead(/* ct_segment_size = */ 4096);
+  std::string plaintext = subtle::Random::GetRandomBytes(10000);
+  std::string filename =
+      WriteEncryptedFile(streaming_aead, plaintext, "encrypted_file_aad");
+
+  auto file_result =
+      EncryptedFile::OpenForRead(filename, streaming_aead, "wrong aad");
+  ASSERT_THAT(file_result.status(), IsOk());
+  auto file = std::move(file_result.ValueOrDie());
+  auto contents = file->PReadString(0, plaintext.size());
+  EXPECT_FALSE(contents.ok());
+}
+
+TEST(EncryptedFileTest, MissingFileFails) {
+  auto streaming_aead = GetStreamingAead(/* ct_segment_size = */ 4096);
+  auto file_result = EncryptedFile::OpenForRead(
+      absl::StrCat(test::TmpDir(), "/no_such_encrypted_file"), streaming_aead,
+      kAssociatedData);
+  EXPECT_THAT(file_result.status(), StatusIs(util::error::NOT_FOUND));
+}
+
+TEST(EncryptedFileTest, NullPrimitiveFails) {
+  auto file_result = EncryptedFile::OpenForRead(
+      absl::StrCat(test::TmpDir(), "/irrelevant"), nullptr, kAssociatedData);
+  EXPECT_THAT(file_result.status(), StatusIs(util::error::INVALID_ARGUMENT));
+  auto writer_result = EncryptedFile::NewWriter(
+      absl::StrCat(test::TmpDir(), "/irrelevant"), nullptr, kAssociatedData);
+  EXPECT_THAT(writer_result.status(), StatusIs(util::error::INVALID_ARGUMENT));
+}
+
+}  // namespace
+}  // namespace streamingaead
+}  // namespace tink
+}  // namespace crypto
@@ -0,0 +1,93 @@
+// Copyright 2021 Google LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/streamingaead/request_merging_random_access_stream.h"
+
+#include <cstring>
+#include <memory>
+#include <utility>
+
+#include "absl/synchronization/mutex.h"
+#include "tink/util/buffer.h"
+#include "tink/util/status.h"
+
+namespace crypto {
+namespace tink {
+namespace streamingaead {
+
+util::Status RequestMergingRandomAccessStream::PRead(
+    int64_t position, int count, util::Buffer* dest_buffer) {
+  if (dest_buffer == nullptr) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "dest_buffer must be non-null");
+  }
+  if (count < 0) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "count cannot be negative");
+  }
+  if (count > dest_buffer->allocated_size()) {
+    return util::Status(util::error::INVALID_ARGUMENT, "buffer too small");
+  }
+  if (position < 0) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "position cannot be negative");
+  }
+
+  std::pair<int64_t, int> key(position, count);
+  std::shared_ptr<Flight> flight;
+  bool is_leader = false;
+  {
+    absl::MutexLock lock(&flights_mutex_);
+    auto it = flights_.find(key);
+    if (it != flights_.end()) {
+      flight = it->second;
+    } else {
+      auto buffer_result = util::Buffer::New(count);
+      if (!buffer_result.ok()) return buffer_result.status();
+      flight = std::make_shared<Flight>();
+      flight->buffer = std::move(buffer_result.ValueOrDie());
+      flights_[key] = flight;
+      is_leader = true;
+    }
+  }
+
+  if (is_leader) {
+    flight->status =
+        random_access_stream_->PRead(position, count, flight->buffer.get());
+    {
+      absl::MutexLock lock(&flight->mutex);
+      flight->done = true;
+    }
+    // New requests for this range after this point start a fresh fetch;
+    // followers already waiting keep the flight alive via their shared_ptr.
+    absl::MutexLock lock(&flights_mutex_);
+    flights_.erase(key);
+  } else {
+    absl::MutexLock lock(&flight->mutex);
+    flight->mutex.Await(absl::Condition(&flight->done));
+  }
+
+  util::Buffer& fetched = *flight->buffer;
+  auto status = dest_buffer->set_size(fetched.size());
+  if (!status.ok()) return status;
+  std::memcpy(dest_buffer->get_mem_block(), fetched.get_mem_block(),
+              fetched.size());
+  return flight->status;
+}
+
+}  // namespace streamingaead
+}  // namespace tink
+}  // namespace crypto
@@ -0,0 +1,84 @@
+// Copyright 2021 Google LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_STREAMINGAEAD_REQUEST_MERGING_RANDOM_ACCESS_STREAM_H_
+#define TINK_STREAMINGAEAD_REQUEST_MERGING_RANDOM_ACCESS_STREAM_H_
+
+#include <map>
+#include <memory>
+#include <utility>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "tink/random_access_stream.h"
+#include "tink/util/buffer.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace streamingaead {
+
+// A RandomAccessStream that wraps another RandomAccessStream (as a non-owned
+// pointer, which must remain alive as long as the wrapper is in use) and
+// merges concurrent identical PRead calls: while a (position, count) request
+// is in flight, further callers asking for the same range wait for and share
+// the one underlying fetch instead of issuing their own.
+//
+// DecryptingRandomAccessStream reads ciphertext in whole segments at
+// segment-aligned positions, so concurrent readers of the same encrypted
+// object request identical ranges whenever they touch the same segment.
+// Layering this wrapper under DecryptingRandomAccessStream therefore fetches
+// each hot segment once per flight of concurrent readers, rather than once
+// per reader.
+class RequestMergingRandomAccessStream
+    : public crypto::tink::RandomAccessStream {
+ public:
+  explicit RequestMergingRandomAccessStream(
+      crypto::tink::RandomAccessStream* random_access_stream)
+      : random_access_stream_(random_access_stream) {}
+
+  ~RequestMergingRandomAccessStream() override {}
+
+  crypto::tink::util::Status PRead(
+      int64_t position, int count,
+      crypto::tink::util::Buffer* dest_buffer) override;
+
+  crypto::tink::util::StatusOr<int64_t> size() override {
+    return random_access_stream_->size();
+  }
+
+ private:
+  // One in-flight underlying PRead; followers wait for 'done' and then copy
+  // the fetched bytes out of 'buffer'.
+  struct Flight {
+    absl::Mutex mutex;
+    bool done ABSL_GUARDED_BY(mutex) = false;
+    crypto::tink::util::Status status;           // written before 'done' is set
+    std::unique_ptr<crypto::tink::util::Buffer> buffer;  // allocated by leader
+  };
+
+  crypto::tink::RandomAccessStream* random_access_stream_;
+  absl::Mutex flights_mutex_;
+  std::map<std::pair<int64_t, int>, std::shared_ptr<Flight>> flights_
+      ABSL_GUARDED_BY(flights_mutex_);
+};
+
+}  // namespace streamingaead
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_STREAMINGAEAD_REQUEST_MERGING_RANDOM_ACCESS_STREAM_H_
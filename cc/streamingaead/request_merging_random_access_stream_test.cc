@@ -0,0 +1,208 @@
+// Copyright 2021 Google LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/streamingaead/request_merging_random_access_stream.h"
+
+#include <algorithm>
+#include <chrono>  // NOLINT(build/c++11)
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "tink/random_access_stream.h"
+#include "tink/util/buffer.h"
+#include "tink/util/file_random_access_stream.h"
+#include "tink/util/status.h"
+#include "tink/util/test_util.h"
+
+namespace crypto {
+namespace tink {
+namespace streamingaead {
+namespace {
+
+// Reads the entire 'ra_stream' in chunks of size 'chunk_size',
+// until no more bytes can be read, and puts the read bytes into 'contents'.
+// Returns the status of the last ra_stream->Next()-operation.
+util::Status ReadAll(RandomAccessStream* ra_stream, int chunk_size,
+                     std::string* contents) {
+  contents->clear();
+  auto buffer = std::move(util::Buffer::New(chunk_size).ValueOrDie());
+  int64_t position = 0;
+  auto status = ra_stream->PRead(position, chunk_size, buffer.get());
+  while (status.ok()) {
+    contents->append(buffer->get_mem_block(), buffer->size());
+    position = contents->size();
+    status = ra_stream->PRead(position, chunk_size, buffer.get());
+  }
+  if (status.error_code() == util::error::OUT_OF_RANGE) {  // EOF
+    EXPECT_EQ(0, buffer->size());
+  }
+  return status;
+}
+
+// A RandomAccessStream that serves from an in-memory string, counts PRead
+// calls, and can hold every PRead until Release() is called, so that a test
+// can pile up concurrent requests on one flight.
+class BlockingRandomAccessStream : public RandomAccessStream {
+ public:
+  explicit BlockingRandomAccessStream(absl::string_view contents)
+      : contents_(contents) {}
+
+  util::Status PRead(int64_t position, int count,
+                     util::Buffer* dest_buffer) override {
+    {
+      absl::MutexLock lock(&mutex_);
+      pread_count_++;
+      mutex_.Await(absl::Condition(&released_));
+    }
+    if (position >= static_cast<int64_t>(contents_.size())) {
+      dest_buffer->set_size(0).IgnoreError();
+      return util::Status(util::error::OUT_OF_RANGE, "EOF");
+    }
+    int available = contents_.size() - position;
+    int read_count = std::min(count, available);
+    auto status = dest_buffer->set_size(read_count);
+    if (!status.ok()) return status;
+    memcpy(dest_buffer->get_mem_block(), contents_.data() + position,
+           read_count);
+    return util::OkStatus();
+  }
+
+  util::StatusOr<int64_t> size() override {
+    return static_cast<int64_t>(contents_.size());
+  }
+
+  void Release() {
+    absl::MutexLock lock(&mutex_);
+    released_ = true;
+  }
+
+  int pread_count() {
+    absl::MutexLock lock(&mutex_);
+    return pread_count_;
+  }
+
+ private:
+  std::string contents_;
+  absl::Mutex mutex_;
+  bool released_ ABSL_GUARDED_BY(mutex_) = false;
+  int pread_count_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+TEST(RequestMergingRandomAccessStreamTest, ReadingStreams) {
+  for (auto stream_size : {0, 10, 100, 1000, 10000, 1000000}) {
+    SCOPED_TRACE(absl::StrCat("stream_size = ", stream_size));
+    std::string file_contents;
+    std::string filename = absl::StrCat(stream_size, "_merging_test.bin");
+    int input_fd = test::GetTestFileDescriptor(
+        filename, stream_size, &file_contents);
+    EXPECT_EQ(stream_size, file_contents.size());
+    auto ra_stream = absl::make_unique<util::FileRandomAccessStream>(input_fd);
+    RequestMergingRandomAccessStream merging_stream(ra_stream.get());
+    std::string stream_contents;
+    auto status = ReadAll(&merging_stream, 1 + (stream_size / 10),
+                          &stream_contents);
+    EXPECT_EQ(util::error::OUT_OF_RANGE, status.error_code());
+    EXPECT_EQ("EOF", status.error_message());
+    EXPECT_EQ(file_contents, stream_contents);
+    EXPECT_EQ(stream_size, merging_stream.size().ValueOrDie());
+  }
+}
+
+TEST(RequestMergingRandomAccessStreamTest, ConcurrentIdenticalReadsMerge) {
+  std::string contents;
+  for (int i = 0; i < 100; i++) contents.append("0123456789");
+  BlockingRandomAccessStream blocking_stream(contents);
+  RequestMergingRandomAccessStream merging_stream(&blocking_stream);
+
+  const int kReaders = 8;
+  const int kCount = 100;
+  const int64_t kPosition = 300;
+  std::vector<std::unique_ptr<util::Buffer>> buffers;
+  std::vector<util::Status> statuses(kReaders);
+  for (int i = 0; i < kReaders; i++) {
+    buffers.push_back(std::move(util::Buffer::New(kCount).ValueOrDie()));
+  }
+  std::vector<std::thread> readers;
+  for (int i = 0; i < kReaders; i++) {
+    readers.push_back(std::thread([&, i]() {
+      statuses[i] = merging_stream.PRead(kPosition, kCount, buffers[i].get());
+    }));
+  }
+  // Give all readers time to either become the flight leader or join it,
+  // then let the one underlying fetch proceed.
+  while (blocking_stream.pread_count() == 0) {
+    std::this_thread::yield();
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  blocking_stream.Release();
+  for (auto& reader : readers) {
+    reader.join();
+  }
+
+  EXPECT_EQ(1, blocking_stream.pread_count());
+  for (int i = 0; i < kReaders; i++) {
+    EXPECT_TRUE(statuses[i].ok()) << statuses[i];
+    EXPECT_EQ(contents.substr(kPosition, kCount),
+              std::string(buffers[i]->get_mem_block(), buffers[i]->size()));
+  }
+}
+
+TEST(RequestMergingRandomAccessStreamTest, DistinctRequestsDoNotMerge) {
+  std::string contents;
+  for (int i = 0; i < 10; i++) contents.append("abcdefghij");
+  BlockingRandomAccessStream blocking_stream(contents);
+  blocking_stream.Release();  // no blocking in this test
+  RequestMergingRandomAccessStream merging_stream(&blocking_stream);
+
+  auto buffer = std::move(util::Buffer::New(10).ValueOrDie());
+  EXPECT_TRUE(merging_stream.PRead(0, 10, buffer.get()).ok());
+  EXPECT_EQ("abcdefghij", std::string(buffer->get_mem_block(), 10));
+  EXPECT_TRUE(merging_stream.PRead(10, 10, buffer.get()).ok());
+  EXPECT_EQ("abcdefghij", std::string(buffer->get_mem_block(), 10));
+  // A repeated request after the first flight completed fetches again.
+  EXPECT_TRUE(merging_stream.PRead(0, 10, buffer.get()).ok());
+  EXPECT_EQ(3, blocking_stream.pread_count());
+}
+
+TEST(RequestMergingRandomAccessStreamTest, InvalidArguments) {
+  std::string contents = "contents";
+  BlockingRandomAccessStream blocking_stream(contents);
+  blocking_stream.Release();
+  RequestMergingRandomAccessStream merging_stream(&blocking_stream);
+  auto buffer = std::move(util::Buffer::New(10).ValueOrDie());
+
+  EXPECT_EQ(util::error::INVALID_ARGUMENT,
+            merging_stream.PRead(0, 10, nullptr).error_code());
+  EXPECT_EQ(util::error::INVALID_ARGUMENT,
+            merging_stream.PRead(0, -1, buffer.get()).error_code());
+  EXPECT_EQ(util::error::INVALID_ARGUMENT,
+            merging_stream.PRead(-1, 10, buffer.get()).error_code());
+  EXPECT_EQ(util::error::INVALID_ARGUMENT,
+            merging_stream.PRead(0, 11, buffer.get()).error_code());
+}
+
+}  // namespace
+}  // namespace streamingaead
+}  // namespace tink
+}  // namespace crypto
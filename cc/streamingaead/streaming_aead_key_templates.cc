@@ -89,6 +89,20 @@ const KeyTemplate& StreamingAeadKeyTemplates::Aes256GcmHkdf1MB() {
   return *key_template;
 }
 
+// static
+const KeyTemplate& StreamingAeadKeyTemplates::Aes256GcmHkdf16MB() {
+  static const KeyTemplate* key_template = NewAesGcmHkdfStreamingKeyTemplate(
+      /* ikm_size_in_bytes= */ 32, /* segment_size_in_bytes= */ 16777216);
+  return *key_template;
+}
+
+// static
+const KeyTemplate& StreamingAeadKeyTemplates::Aes256GcmHkdf64MB() {
+  static const KeyTemplate* key_template = NewAesGcmHkdfStreamingKeyTemplate(
+      /* ikm_size_in_bytes= */ 32, /* segment_size_in_bytes= */ 67108864);
+  return *key_template;
+}
+
 // static
 const KeyTemplate& StreamingAeadKeyTemplates::Aes128CtrHmacSha256Segment4KB() {
   static const KeyTemplate* key_template =
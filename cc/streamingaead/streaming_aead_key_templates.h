@@ -62,6 +62,28 @@ class StreamingAeadKeyTemplates {
   //   - OutputPrefixType: RAW
   static const google::crypto::tink::KeyTemplate& Aes256GcmHkdf1MB();
 
+  // Returns a KeyTemplate that generates new instances of
+  // AesGcmHkdfStreamingKey with the following parameters:
+  //   - main key (ikm) size: 32 bytes
+  //   - HKDF algorithm: HMAC-SHA256
+  //   - size of derived AES-GCM keys: 32 bytes
+  //   - ciphertext segment size: 16777216 bytes (16 MB)
+  //   - OutputPrefixType: RAW
+  // Large segments amortize the per-segment key derivation and tag
+  // computation, which helps on high-bandwidth links; the decrypting party
+  // must be prepared to buffer an entire segment in memory.
+  static const google::crypto::tink::KeyTemplate& Aes256GcmHkdf16MB();
+
+  // Returns a KeyTemplate that generates new instances of
+  // AesGcmHkdfStreamingKey with the following parameters:
+  //   - main key (ikm) size: 32 bytes
+  //   - HKDF algorithm: HMAC-SHA256
+  //   - size of derived AES-GCM keys: 32 bytes
+  //   - ciphertext segment size: 67108864 bytes (64 MB)
+  //   - OutputPrefixType: RAW
+  // See the remark on Aes256GcmHkdf16MB() regarding large segments.
+  static const google::crypto::tink::KeyTemplate& Aes256GcmHkdf64MB();
+
   // Returns a KeyTemplate that generates new instances of
   // AesCtrHmacStreamingKey with the following parameters:
   //   - main key (ikm) size: 16 bytes
@@ -160,6 +160,86 @@ TEST(Aes256GcmHkdf1MBTest, CheckValues) {
   EXPECT_THAT(key_format.params().hkdf_hash_type(), Eq(HashType::SHA256));
 }
 
+TEST(Aes256GcmHkdf16MBTest, TypeUrl) {
+  EXPECT_THAT(
+      StreamingAeadKeyTemplates::Aes256GcmHkdf16MB().type_url(),
+      Eq("type.googleapis.com/google.crypto.tink.AesGcmHkdfStreamingKey"));
+  EXPECT_THAT(StreamingAeadKeyTemplates::Aes256GcmHkdf16MB().type_url(),
+              Eq(AesGcmHkdfStreamingKeyManager().get_key_type()));
+}
+
+TEST(Aes256GcmHkdf16MBTest, OutputPrefixType) {
+  EXPECT_THAT(
+      StreamingAeadKeyTemplates::Aes256GcmHkdf16MB().output_prefix_type(),
+      Eq(OutputPrefixType::RAW));
+}
+
+TEST(Aes256GcmHkdf16MBTest, SameReference) {
+  // Check that reference to the same object is returned.
+  EXPECT_THAT(StreamingAeadKeyTemplates::Aes256GcmHkdf16MB(),
+              Ref(StreamingAeadKeyTemplates::Aes256GcmHkdf16MB()));
+}
+
+TEST(Aes256GcmHkdf16MBTest, WorksWithKeyTypeManager) {
+  const KeyTemplate& key_template =
+      StreamingAeadKeyTemplates::Aes256GcmHkdf16MB();
+  AesGcmHkdfStreamingKeyFormat key_format;
+  EXPECT_TRUE(key_format.ParseFromString(key_template.value()));
+  EXPECT_THAT(AesGcmHkdfStreamingKeyManager().ValidateKeyFormat(key_format),
+              IsOk());
+}
+
+TEST(Aes256GcmHkdf16MBTest, CheckValues) {
+  const KeyTemplate& key_template =
+      StreamingAeadKeyTemplates::Aes256GcmHkdf16MB();
+  AesGcmHkdfStreamingKeyFormat key_format;
+  EXPECT_TRUE(key_format.ParseFromString(key_template.value()));
+  EXPECT_THAT(key_format.key_size(), Eq(32));
+  EXPECT_THAT(key_format.params().derived_key_size(), Eq(32));
+  EXPECT_THAT(key_format.params().ciphertext_segment_size(), Eq(16777216));
+  EXPECT_THAT(key_format.params().hkdf_hash_type(), Eq(HashType::SHA256));
+}
+
+TEST(Aes256GcmHkdf64MBTest, TypeUrl) {
+  EXPECT_THAT(
+      StreamingAeadKeyTemplates::Aes256GcmHkdf64MB().type_url(),
+      Eq("type.googleapis.com/google.crypto.tink.AesGcmHkdfStreamingKey"));
+  EXPECT_THAT(StreamingAeadKeyTemplates::Aes256GcmHkdf64MB().type_url(),
+              Eq(AesGcmHkdfStreamingKeyManager().get_key_type()));
+}
+
+TEST(Aes256GcmHkdf64MBTest, OutputPrefixType) {
+  EXPECT_THAT(
+      StreamingAeadKeyTemplates::Aes256GcmHkdf64MB().output_prefix_type(),
+      Eq(OutputPrefixType::RAW));
+}
+
+TEST(Aes256GcmHkdf64MBTest, SameReference) {
+  // Check that reference to the same object is returned.
+  EXPECT_THAT(StreamingAeadKeyTemplates::Aes256GcmHkdf64MB(),
+              Ref(StreamingAeadKeyTemplates::Aes256GcmHkdf64MB()));
+}
+
+TEST(Aes256GcmHkdf64MBTest, WorksWithKeyTypeManager) {
+  const KeyTemplate& key_template =
+      StreamingAeadKeyTemplates::Aes256GcmHkdf64MB();
+  AesGcmHkdfStreamingKeyFormat key_format;
+  EXPECT_TRUE(key_format.ParseFromString(key_template.value()));
+  EXPECT_THAT(AesGcmHkdfStreamingKeyManager().ValidateKeyFormat(key_format),
+              IsOk());
+}
+
+TEST(Aes256GcmHkdf64MBTest, CheckValues) {
+  const KeyTemplate& key_template =
+      StreamingAeadKeyTemplates::Aes256GcmHkdf64MB();
+  AesGcmHkdfStreamingKeyFormat key_format;
+  EXPECT_TRUE(key_format.ParseFromString(key_template.value()));
+  EXPECT_THAT(key_format.key_size(), Eq(32));
+  EXPECT_THAT(key_format.params().derived_key_size(), Eq(32));
+  EXPECT_THAT(key_format.params().ciphertext_segment_size(), Eq(67108864));
+  EXPECT_THAT(key_format.params().hkdf_hash_type(), Eq(HashType::SHA256));
+}
+
 TEST(Aes128CtrHmacSha256Segment4KBTest, TypeUrl) {
   EXPECT_THAT(
       StreamingAeadKeyTemplates::Aes128CtrHmacSha256Segment4KB().type_url(),
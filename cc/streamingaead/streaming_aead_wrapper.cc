@@ -115,6 +115,7 @@ StatusOr<std::unique_ptr<StreamingAead>> StreamingAeadWrapper::Wrap(
     std::unique_ptr<PrimitiveSet<StreamingAead>> streaming_aead_set) const {
   auto status = Validate(streaming_aead_set.get());
   if (!status.ok()) return status;
+  streaming_aead_set->Seal();
   std::unique_ptr<StreamingAead> streaming_aead =
       absl::make_unique<StreamingAeadSetWrapper>(
           std::move(streaming_aead_set));
@@ -20,6 +20,7 @@
 
 #include "gtest/gtest.h"
 #include "absl/memory/memory.h"
+#include "absl/strings/cord.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "tink/input_stream.h"
@@ -188,6 +189,49 @@ TEST(StreamingAeadSetWrapperTest, BasicEncryptionAndDecryption) {
   }
 }
 
+TEST(StreamingAeadSetWrapperTest, EncryptionAndDecryptionWithCords) {
+  uint32_t key_id_0 = 1234543;
+  uint32_t key_id_1 = 726329;
+  uint32_t key_id_2 = 7213743;
+  std::string saead_name_0 = "streaming_aead0";
+  std::string saead_name_1 = "streaming_aead1";
+  std::string saead_name_2 = "streaming_aead2";
+
+  auto saead_set = GetTestStreamingAeadSet(
+      {{key_id_0, saead_name_0, OutputPrefixType::RAW},
+       {key_id_1, saead_name_1, OutputPrefixType::RAW},
+       {key_id_2, saead_name_2, OutputPrefixType::RAW}});
+
+  // Wrap saead_set and test the Cord entry points of the result.
+  StreamingAeadWrapper wrapper;
+  auto wrap_result = wrapper.Wrap(std::move(saead_set));
+  EXPECT_TRUE(wrap_result.ok()) << wrap_result.status();
+  auto saead = std::move(wrap_result.ValueOrDie());
+  for (int pt_size : {0, 1, 10, 100, 10000}) {
+    std::string plaintext = subtle::Random::GetRandomBytes(pt_size);
+    for (std::string aad : {"some_aad", "", "some other aad"}) {
+      SCOPED_TRACE(absl::StrCat("pt_size = ", pt_size,
+                                ", aad = '", aad, "'"));
+      // Build a fragmented plaintext Cord.
+      absl::Cord plaintext_cord;
+      for (size_t i = 0; i < plaintext.size(); i += 7) {
+        plaintext_cord.Append(plaintext.substr(i, 7));
+      }
+
+      // Encrypt with the primary primitive.
+      auto ct_result = saead->EncryptCord(plaintext_cord, aad);
+      EXPECT_THAT(ct_result.status(), IsOk());
+      EXPECT_EQ(absl::StrCat(saead_name_2, aad, plaintext),
+                std::string(ct_result.ValueOrDie()));
+
+      // Decrypt the ciphertext Cord.
+      auto pt_result = saead->DecryptCord(ct_result.ValueOrDie(), aad);
+      EXPECT_THAT(pt_result.status(), IsOk());
+      EXPECT_EQ(plaintext, std::string(pt_result.ValueOrDie()));
+    }
+  }
+}
+
 TEST(StreamingAeadSetWrapperTest, DecryptionWithRandomAccessStream) {
   uint32_t key_id_0 = 1234543;
   uint32_t key_id_1 = 726329;
@@ -17,9 +17,11 @@
 #include "tink/subtle/aes_cmac_boringssl.h"
 
 #include <string>
+#include <vector>
 
 #include "absl/memory/memory.h"
 #include "openssl/cmac.h"
+#include "openssl/evp.h"
 #include "openssl/mem.h"
 #include "tink/subtle/subtle_util.h"
 #include "tink/subtle/subtle_util_boringssl.h"
@@ -41,7 +43,34 @@ util::StatusOr<std::unique_ptr<Mac>> AesCmacBoringSsl::New(util::SecretData key,
   if (tag_size > kMaxTagSize) {
     return util::Status(util::error::INVALID_ARGUMENT, "invalid tag size");
   }
-  return {absl::WrapUnique(new AesCmacBoringSsl(std::move(key), tag_size))};
+  const EVP_CIPHER* cipher =
+      key.size() == kSmallKeySize ? EVP_aes_128_cbc() : EVP_aes_256_cbc();
+  // Initialize the context with the key once; this expands the AES key
+  // schedule and derives the K1/K2 subkeys, which all operations then reuse.
+  bssl::UniquePtr<CMAC_CTX> ctx(CMAC_CTX_new());
+  if (ctx == nullptr ||
+      CMAC_Init(ctx.get(), key.data(), key.size(), cipher,
+                nullptr /* engine */) != 1) {
+    return util::Status(util::error::INTERNAL,
+                        "BoringSSL failed to initialize CMAC");
+  }
+  return {absl::WrapUnique(new AesCmacBoringSsl(std::move(ctx), tag_size))};
+}
+
+util::Status AesCmacBoringSsl::ComputeMacInternal(CMAC_CTX* ctx,
+                                                  absl::string_view data,
+                                                  uint8_t* out) const {
+  size_t out_len;
+  // CMAC_Reset keeps the key schedule and subkeys copied from the template
+  // context and only clears the running state.
+  if (CMAC_Reset(ctx) != 1 ||
+      CMAC_Update(ctx, reinterpret_cast<const uint8_t*>(data.data()),
+                  data.size()) != 1 ||
+      CMAC_Final(ctx, out, &out_len) != 1) {
+    return util::Status(util::error::INTERNAL,
+                        "BoringSSL failed to compute CMAC");
+  }
+  return util::OkStatus();
 }
 
 util::StatusOr<std::string> AesCmacBoringSsl::ComputeMac(
@@ -50,19 +79,46 @@ util::StatusOr<std::string> AesCmacBoringSsl::ComputeMac(
   // regardless of whether the size is 0.
   data = SubtleUtilBoringSSL::EnsureNonNull(data);
 
+  // Copy the key-initialized template context; this copies the expanded key
+  // schedule and subkeys instead of re-deriving them, and keeps concurrent
+  // operations on the same primitive lock-free.
+  bssl::UniquePtr<CMAC_CTX> ctx(CMAC_CTX_new());
+  if (ctx == nullptr || CMAC_CTX_copy(ctx.get(), template_ctx_.get()) != 1) {
+    return util::Status(util::error::INTERNAL, "CMAC context copy failed");
+  }
   std::string result;
   ResizeStringUninitialized(&result, kMaxTagSize);
-  const int res =
-      AES_CMAC(reinterpret_cast<uint8_t*>(&result[0]), key_.data(), key_.size(),
-               reinterpret_cast<const uint8_t*>(data.data()), data.size());
-  if (res == 0) {
-    return util::Status(util::error::INTERNAL,
-                        "BoringSSL failed to compute CMAC");
+  auto status = ComputeMacInternal(ctx.get(), data,
+                                   reinterpret_cast<uint8_t*>(&result[0]));
+  if (!status.ok()) {
+    return status;
   }
   result.resize(tag_size_);
   return result;
 }
 
+util::StatusOr<std::vector<std::string>> AesCmacBoringSsl::ComputeMacs(
+    absl::Span<const absl::string_view> data_pieces) const {
+  // One context copy amortized over the whole batch; CMAC_Reset in
+  // ComputeMacInternal clears the running state between pieces.
+  bssl::UniquePtr<CMAC_CTX> ctx(CMAC_CTX_new());
+  if (ctx == nullptr || CMAC_CTX_copy(ctx.get(), template_ctx_.get()) != 1) {
+    return util::Status(util::error::INTERNAL, "CMAC context copy failed");
+  }
+  std::vector<std::string> result(data_pieces.size());
+  for (size_t i = 0; i < data_pieces.size(); i++) {
+    absl::string_view data = SubtleUtilBoringSSL::EnsureNonNull(data_pieces[i]);
+    ResizeStringUninitialized(&result[i], kMaxTagSize);
+    auto status = ComputeMacInternal(
+        ctx.get(), data, reinterpret_cast<uint8_t*>(&result[i][0]));
+    if (!status.ok()) {
+      return status;
+    }
+    result[i].resize(tag_size_);
+  }
+  return result;
+}
+
 util::Status AesCmacBoringSsl::VerifyMac(absl::string_view mac,
                                          absl::string_view data) const {
   // BoringSSL expects a non-null pointer for data,
@@ -72,13 +128,14 @@ util::Status AesCmacBoringSsl::VerifyMac(absl::string_view mac,
   if (mac.size() != tag_size_) {
     return util::Status(util::error::INVALID_ARGUMENT, "incorrect tag size");
   }
+  bssl::UniquePtr<CMAC_CTX> ctx(CMAC_CTX_new());
+  if (ctx == nullptr || CMAC_CTX_copy(ctx.get(), template_ctx_.get()) != 1) {
+    return util::Status(util::error::INTERNAL, "CMAC context copy failed");
+  }
   uint8_t buf[kMaxTagSize];
-  const int res =
-      AES_CMAC(buf, key_.data(), key_.size(),
-               reinterpret_cast<const uint8_t*>(data.data()), data.size());
-  if (res == 0) {
-    return util::Status(util::error::INTERNAL,
-                        "BoringSSL failed to compute CMAC");
+  auto status = ComputeMacInternal(ctx.get(), data, buf);
+  if (!status.ok()) {
+    return status;
   }
   if (CRYPTO_memcmp(buf, mac.data(), tag_size_) != 0) {
     return util::Status(util::error::INVALID_ARGUMENT, "verification failed");
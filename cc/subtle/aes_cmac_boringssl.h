@@ -18,8 +18,13 @@
 #define TINK_SUBTLE_AES_CMAC_BORINGSSL_H_
 
 #include <memory>
+#include <string>
 #include <utility>
+#include <vector>
 
+#include "absl/types/span.h"
+#include "openssl/base.h"
+#include "openssl/cmac.h"
 #include "tink/mac.h"
 #include "tink/internal/fips_utils.h"
 #include "tink/util/secret_data.h"
@@ -38,6 +43,12 @@ class AesCmacBoringSsl : public Mac {
   crypto::tink::util::StatusOr<std::string> ComputeMac(
       absl::string_view data) const override;
 
+  // Computes and returns the CMACs for all elements of 'data_pieces', in
+  // order. Amortizes the per-operation context setup over the whole batch,
+  // which helps when many small records are authenticated with the same key.
+  crypto::tink::util::StatusOr<std::vector<std::string>> ComputeMacs(
+      absl::Span<const absl::string_view> data_pieces) const;
+
   // Verifies if 'mac' is a correct CMAC for 'data'.
   // Returns Status::OK if 'mac' is correct, and a non-OK-Status otherwise.
   crypto::tink::util::Status VerifyMac(absl::string_view mac,
@@ -56,10 +67,21 @@ class AesCmacBoringSsl : public Mac {
   static constexpr size_t kBigKeySize = 32;
   static constexpr size_t kMaxTagSize = 16;
 
-  AesCmacBoringSsl(util::SecretData key, uint32_t tag_size)
-      : key_(std::move(key)), tag_size_(tag_size) {}
+  AesCmacBoringSsl(bssl::UniquePtr<CMAC_CTX> ctx, uint32_t tag_size)
+      : template_ctx_(std::move(ctx)), tag_size_(tag_size) {}
+
+  // Computes the full-size CMAC of 'data' on 'ctx' into 'out', which must
+  // have space for kMaxTagSize bytes. 'ctx' must be a copy of template_ctx_;
+  // it is reset first, so it may be reused across calls.
+  crypto::tink::util::Status ComputeMacInternal(CMAC_CTX* ctx,
+                                                absl::string_view data,
+                                                uint8_t* out) const;
 
-  const util::SecretData key_;
+  // Context initialized with the key at construction time, so that the AES
+  // key schedule and the K1/K2 subkeys are derived only once. It is never
+  // used for computations directly; each operation clones it with
+  // CMAC_CTX_copy, which keeps the hot path lock-free.
+  const bssl::UniquePtr<CMAC_CTX> template_ctx_;
   const uint32_t tag_size_;
 };
 
@@ -17,8 +17,10 @@
 #include "tink/subtle/aes_cmac_boringssl.h"
 
 #include <string>
+#include <vector>
 
 #include "gtest/gtest.h"
+#include "absl/types/span.h"
 #include "tink/config/tink_fips.h"
 #include "tink/mac.h"
 #include "tink/subtle/common_enums.h"
@@ -70,6 +72,41 @@ TEST(AesCmacBoringSslTest, Basic) {
   }
 }
 
+TEST(AesCmacBoringSslTest, BatchComputeMacs) {
+  if (IsFipsModeEnabled()) {
+    GTEST_SKIP() << "Not supported in FIPS-only mode";
+  }
+
+  util::SecretData key = util::SecretDataFromStringView(test::HexDecodeOrDie(
+      "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"));
+  auto cmac_result = AesCmacBoringSsl::New(key, kTagSize);
+  EXPECT_TRUE(cmac_result.ok()) << cmac_result.status();
+  auto cmac = std::move(cmac_result.ValueOrDie());
+  // ComputeMacs is an extension of AesCmacBoringSsl, not of the Mac interface.
+  auto* batch_cmac = static_cast<AesCmacBoringSsl*>(cmac.get());
+
+  std::vector<std::string> records;
+  std::vector<absl::string_view> record_views;
+  for (int i = 0; i < 65; i++) {
+    records.push_back(std::string(i, 'x'));
+  }
+  for (const std::string& record : records) {
+    record_views.push_back(record);
+  }
+  auto macs_result = batch_cmac->ComputeMacs(absl::MakeConstSpan(record_views));
+  EXPECT_TRUE(macs_result.ok()) << macs_result.status();
+  auto macs = macs_result.ValueOrDie();
+  EXPECT_EQ(records.size(), macs.size());
+  for (size_t i = 0; i < records.size(); i++) {
+    // Each tag must match the one computed for the record individually.
+    auto res = cmac->ComputeMac(records[i]);
+    EXPECT_TRUE(res.ok()) << res.status().ToString();
+    EXPECT_EQ(res.ValueOrDie(), macs[i]) << i;
+    auto status = cmac->VerifyMac(macs[i], records[i]);
+    EXPECT_TRUE(status.ok()) << status.ToString();
+  }
+}
+
 TEST(AesCmacBoringSslTest, Modification) {
   if (IsFipsModeEnabled()) {
     GTEST_SKIP() << "Not supported in FIPS-only mode";
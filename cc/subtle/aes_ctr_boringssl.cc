@@ -16,9 +16,11 @@
 
 #include "tink/subtle/aes_ctr_boringssl.h"
 
+#include <cstring>
 #include <string>
 
 #include "absl/memory/memory.h"
+#include "absl/types/span.h"
 #include "openssl/evp.h"
 #include "tink/subtle/random.h"
 #include "tink/subtle/subtle_util.h"
@@ -42,8 +44,21 @@ util::StatusOr<std::unique_ptr<IndCpaCipher>> AesCtrBoringSsl::New(
   if (iv_size < kMinIvSizeInBytes || iv_size > kBlockSize) {
     return util::Status(util::error::INVALID_ARGUMENT, "invalid iv size");
   }
-  return {
-      absl::WrapUnique(new AesCtrBoringSsl(std::move(key), iv_size, cipher))};
+  bssl::UniquePtr<EVP_CIPHER_CTX> template_ctx(EVP_CIPHER_CTX_new());
+  if (template_ctx == nullptr) {
+    return util::Status(util::error::INTERNAL,
+                        "could not initialize EVP_CIPHER_CTX");
+  }
+  // Expand the AES key schedule once; the key never changes over the
+  // lifetime of the primitive, so per-operation contexts are cloned from
+  // this template and only set their IV.
+  int ret = EVP_EncryptInit_ex(template_ctx.get(), cipher, nullptr /* engine */,
+                               key.data(), nullptr /* iv */);
+  if (ret != 1) {
+    return util::Status(util::error::INTERNAL, "could not initialize ctx");
+  }
+  return {absl::WrapUnique(
+      new AesCtrBoringSsl(std::move(key), iv_size, std::move(template_ctx)))};
 }
 
 util::StatusOr<std::string> AesCtrBoringSsl::Encrypt(
@@ -57,21 +72,28 @@ util::StatusOr<std::string> AesCtrBoringSsl::Encrypt(
     return util::Status(util::error::INTERNAL,
                         "could not initialize EVP_CIPHER_CTX");
   }
-  std::string ciphertext = Random::GetRandomBytes(iv_size_);
+  // Clone the template context instead of re-running the AES key expansion.
+  if (EVP_CIPHER_CTX_copy(ctx.get(), template_ctx_.get()) != 1) {
+    return util::Status(util::error::INTERNAL,
+                        "could not clone EVP_CIPHER_CTX");
+  }
+  // Allocate the result at its final size right away and generate the IV
+  // directly into it, so the whole encryption allocates exactly once.
+  std::string ciphertext;
+  ResizeStringUninitialized(&ciphertext, iv_size_ + plaintext.size());
+  Random::GetRandomBytes(absl::Span<char>(&ciphertext[0], iv_size_));
   // OpenSSL expects that the IV must be a full block. We pad with zeros.
-  std::string iv_block = ciphertext;
   // Note that kBlockSize >= iv_size_ is checked in the factory method.
-  // We explicitly add the '\0' argument to stress that we need to initialize
-  // the new memory.
-  iv_block.resize(kBlockSize, '\0');
+  SmallBuffer iv_block(kBlockSize);
+  std::memcpy(iv_block.data(), ciphertext.data(), iv_size_);
+  std::memset(iv_block.data() + iv_size_, 0, kBlockSize - iv_size_);
 
-  int ret =
-      EVP_EncryptInit_ex(ctx.get(), cipher_, nullptr /* engine */, key_.data(),
-                         reinterpret_cast<const uint8_t*>(&iv_block[0]));
+  int ret = EVP_EncryptInit_ex(
+      ctx.get(), nullptr /* cipher */, nullptr /* engine */, nullptr /* key */,
+      reinterpret_cast<const uint8_t*>(iv_block.data()));
   if (ret != 1) {
     return util::Status(util::error::INTERNAL, "could not initialize ctx");
   }
-  ResizeStringUninitialized(&ciphertext, iv_size_ + plaintext.size());
   int len;
   ret = EVP_EncryptUpdate(
       ctx.get(), reinterpret_cast<uint8_t*>(&ciphertext[iv_size_]), &len,
@@ -96,13 +118,21 @@ util::StatusOr<std::string> AesCtrBoringSsl::Decrypt(
     return util::Status(util::error::INTERNAL,
                         "could not initialize EVP_CIPHER_CTX");
   }
+  // Clone the template context instead of re-running the AES key expansion.
+  // CTR mode applies the same keystream in both directions, so the
+  // encrypt-direction template serves decryption as well.
+  if (EVP_CIPHER_CTX_copy(ctx.get(), template_ctx_.get()) != 1) {
+    return util::Status(util::error::INTERNAL,
+                        "could not clone EVP_CIPHER_CTX");
+  }
 
-  // Initialise key and IV
-  std::string iv_block = std::string(ciphertext.substr(0, iv_size_));
-  iv_block.resize(kBlockSize, '\0');
-  int ret = EVP_DecryptInit_ex(ctx.get(), cipher_, nullptr /* engine */,
-                               reinterpret_cast<const uint8_t*>(key_.data()),
-                               reinterpret_cast<const uint8_t*>(&iv_block[0]));
+  // Initialise the IV; it is zero-padded to a full block.
+  SmallBuffer iv_block(kBlockSize);
+  std::memcpy(iv_block.data(), ciphertext.data(), iv_size_);
+  std::memset(iv_block.data() + iv_size_, 0, kBlockSize - iv_size_);
+  int ret = EVP_EncryptInit_ex(
+      ctx.get(), nullptr /* cipher */, nullptr /* engine */, nullptr /* key */,
+      reinterpret_cast<const uint8_t*>(iv_block.data()));
   if (ret != 1) {
     return util::Status(util::error::INTERNAL,
                         "could not initialize key or iv");
@@ -113,7 +143,9 @@ util::StatusOr<std::string> AesCtrBoringSsl::Decrypt(
   ResizeStringUninitialized(&plaintext, plaintext_size);
   size_t read = iv_size_;
   int len;
-  ret = EVP_DecryptUpdate(
+  // The cloned context is in the encrypt direction; en- and decryption are
+  // the same XOR with the keystream in CTR mode.
+  ret = EVP_EncryptUpdate(
       ctx.get(), reinterpret_cast<uint8_t*>(&plaintext[0]), &len,
       reinterpret_cast<const uint8_t*>(&ciphertext.data()[read]),
       plaintext_size);
@@ -48,13 +48,20 @@ class AesCtrBoringSsl : public IndCpaCipher {
   static constexpr int kMinIvSizeInBytes = 12;
   static constexpr int kBlockSize = 16;
 
-  AesCtrBoringSsl(util::SecretData key, int iv_size, const EVP_CIPHER* cipher)
-      : key_(std::move(key)), iv_size_(iv_size), cipher_(cipher) {}
+  AesCtrBoringSsl(util::SecretData key, int iv_size,
+                  bssl::UniquePtr<EVP_CIPHER_CTX> template_ctx)
+      : key_(std::move(key)),
+        iv_size_(iv_size),
+        template_ctx_(std::move(template_ctx)) {}
 
   const util::SecretData key_;
   const int iv_size_;
-  // cipher_ is a singleton owned by BoringSsl.
-  const EVP_CIPHER *cipher_;
+  // Holds the cipher and the expanded AES key schedule, set up once in New().
+  // Per-operation contexts are cloned from this template, so an operation
+  // only sets its IV instead of re-running the key expansion. The template
+  // itself is never used for en-/decryption and is only read after
+  // construction, which makes sharing one primitive across threads safe.
+  const bssl::UniquePtr<EVP_CIPHER_CTX> template_ctx_;
 };
 
 }  // namespace subtle
@@ -16,6 +16,7 @@
 
 #include "tink/subtle/aes_ctr_hmac_streaming.h"
 
+#include <algorithm>
 #include <limits>
 #include <string>
 #include <vector>
@@ -60,14 +61,21 @@ static util::Status DeriveKeys(const util::SecretData& ikm, HashType hkdf_algo,
                                util::SecretData* hmac_key_value) {
   int derived_key_material_size =
       key_size + AesCtrHmacStreaming::kHmacKeySizeInBytes;
+  // The outputs outlive the arena scope below, so their storage must be
+  // allocated before it is opened.
+  key_value->resize(key_size);
+  hmac_key_value->resize(AesCtrHmacStreaming::kHmacKeySizeInBytes);
+  // The HKDF output and any temporaries inside ComputeHkdf() are
+  // bump-allocated from one region and wiped together at scope end.
+  util::ScopedSecretArena arena(/* capacity = */ 512);
   auto hkdf_result = Hkdf::ComputeHkdf(hkdf_algo, ikm, salt, associated_data,
                                        derived_key_material_size);
   if (!hkdf_result.ok()) return hkdf_result.status();
   util::SecretData key_material = std::move(hkdf_result.ValueOrDie());
-  *key_value =
-      util::SecretData(key_material.begin(), key_material.begin() + key_size);
-  *hmac_key_value =
-      util::SecretData(key_material.begin() + key_size, key_material.end());
+  std::copy(key_material.begin(), key_material.begin() + key_size,
+            key_value->begin());
+  std::copy(key_material.begin() + key_size, key_material.end(),
+            hmac_key_value->begin());
   return util::OkStatus();
 }
 
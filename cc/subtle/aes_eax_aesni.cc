@@ -25,6 +25,10 @@
 #include <wmmintrin.h>  // AES_NI instructions.
 #include <xmmintrin.h>  // Datatype _mm128i
 
+#if defined(__VAES__) && defined(__AVX512F__)
+#include <immintrin.h>  // VAES: _mm512_aesenc_epi128 etc.
+#endif
+
 #include <algorithm>
 #include <array>
 #include <memory>
@@ -220,6 +224,22 @@ void Aes256KeyExpansion(const uint8_t* key, __m128i *round_key) {
   }
 }
 
+#if defined(__VAES__) && defined(__AVX512F__)
+// Encrypts 4 independent blocks held in one 512-bit register with plain AES,
+// using the VAES instructions. Each 128-bit lane is encrypted with the same
+// round keys.
+inline __m512i Encrypt4Blocks(__m512i blocks, const __m128i* round_key,
+                              int rounds) {
+  __m512i tmp =
+      _mm512_xor_si512(blocks, _mm512_broadcast_i32x4(round_key[0]));
+  for (int i = 1; i < rounds; i++) {
+    tmp = _mm512_aesenc_epi128(tmp, _mm512_broadcast_i32x4(round_key[i]));
+  }
+  return _mm512_aesenclast_epi128(tmp,
+                                  _mm512_broadcast_i32x4(round_key[rounds]));
+}
+#endif
+
 bool IsValidNonceSize(size_t nonce_size) {
   return nonce_size == 12 || nonce_size == 16;
 }
@@ -232,6 +252,9 @@ bool IsValidKeySize(size_t key_size) {
 
 crypto::tink::util::StatusOr<std::unique_ptr<Aead>> AesEaxAesni::New(
     const util::SecretData& key, size_t nonce_size_in_bytes) {
+  auto status = internal::CheckFipsCompatibility<AesEaxAesni>();
+  if (!status.ok()) return status;
+
   if (!IsValidKeySize(key.size())) {
     return util::Status(util::error::INVALID_ARGUMENT, "Invalid key size");
   }
@@ -383,6 +406,43 @@ bool AesEaxAesni::RawEncrypt(absl::string_view nonce, absl::string_view in,
   uint8_t* out = ciphertext.data();
   size_t idx = 0;
   __m128i key_stream;
+#if defined(__VAES__) && defined(__AVX512F__)
+  // Wide codepath: computes the key stream for 4 counter blocks with a single
+  // sequence of VAES instructions. The OMAC over the ciphertext is a serial
+  // CBC chain and hence stays on 128-bit registers; only the absorption of the
+  // 4 fresh ciphertext blocks is unrolled here.
+  while (in.size() - idx > 4 * kBlockSize) {
+    __m128i ctr0 = Reverse(ctr);
+    ctr = Increment(ctr);
+    __m128i ctr1 = Reverse(ctr);
+    ctr = Increment(ctr);
+    __m128i ctr2 = Reverse(ctr);
+    ctr = Increment(ctr);
+    __m128i ctr3 = Reverse(ctr);
+    ctr = Increment(ctr);
+    __m512i ctr_blocks = _mm512_castsi128_si512(ctr0);
+    ctr_blocks = _mm512_inserti32x4(ctr_blocks, ctr1, 1);
+    ctr_blocks = _mm512_inserti32x4(ctr_blocks, ctr2, 2);
+    ctr_blocks = _mm512_inserti32x4(ctr_blocks, ctr3, 3);
+    __m512i wide_key_stream =
+        Encrypt4Blocks(ctr_blocks, round_key_->data(), rounds_);
+    __m512i pt = _mm512_loadu_si512(plaintext);
+    __m512i ct = _mm512_xor_si512(pt, wide_key_stream);
+    _mm512_storeu_si512(out, ct);
+    // Absorb the 4 ciphertext blocks into the OMAC chain.
+    mac = EncryptBlock(mac);
+    mac = _mm_xor_si128(mac, _mm512_extracti32x4_epi32(ct, 0));
+    mac = EncryptBlock(mac);
+    mac = _mm_xor_si128(mac, _mm512_extracti32x4_epi32(ct, 1));
+    mac = EncryptBlock(mac);
+    mac = _mm_xor_si128(mac, _mm512_extracti32x4_epi32(ct, 2));
+    mac = EncryptBlock(mac);
+    mac = _mm_xor_si128(mac, _mm512_extracti32x4_epi32(ct, 3));
+    plaintext += 4 * kBlockSize;
+    out += 4 * kBlockSize;
+    idx += 4 * kBlockSize;
+  }
+#endif
   while (idx + kBlockSize < in.size()) {
     __m128i ctr_big_endian = Reverse(ctr);
     // Get the key stream for one message block and compute
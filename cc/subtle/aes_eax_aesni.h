@@ -29,6 +29,7 @@
 #include "absl/strings/string_view.h"
 #include "absl/types/span.h"
 #include "tink/aead.h"
+#include "tink/internal/fips_utils.h"
 #include "tink/util/secret_data.h"
 #include "tink/util/status.h"
 #include "tink/util/statusor.h"
@@ -42,6 +43,8 @@ namespace subtle {
 // Currently the implementation supports 128 and 256 bit keys and 96 or 128 bit
 // nonces. AES-EAX allows arbitrary nonce sizes. Allowing only 96 or 128 bits
 // is a tink specific restriction.
+// When compiled for a target with VAES and AVX-512 (e.g. -march=icelake-server)
+// the CTR key stream is computed 4 blocks at a time with 512-bit registers.
 class AesEaxAesni : public Aead {
  public:
   static crypto::tink::util::StatusOr<std::unique_ptr<Aead>> New(
@@ -55,6 +58,9 @@ class AesEaxAesni : public Aead {
       absl::string_view ciphertext,
       absl::string_view additional_data) const override;
 
+  static constexpr crypto::tink::internal::FipsCompatibility kFipsStatus =
+      crypto::tink::internal::FipsCompatibility::kNotFips;
+
  protected:
   // The tag size is fixed for this implementation.
   // Using the full 128-bits of the tag allows an efficient verification.
@@ -16,6 +16,7 @@
 
 #include "tink/subtle/aes_gcm_boringssl.h"
 
+#include <cstring>
 #include <utility>
 
 #include "absl/memory/memory.h"
@@ -23,12 +24,43 @@
 #include "tink/subtle/random.h"
 #include "tink/subtle/subtle_util.h"
 #include "tink/subtle/subtle_util_boringssl.h"
+#include "tink/util/errors.h"
 #include "tink/util/status.h"
 
 namespace crypto {
 namespace tink {
 namespace subtle {
 
+namespace {
+
+// Returns a contiguous view of the concatenation of 'fragments'. With at
+// most one fragment the view aliases the fragment itself; otherwise the
+// concatenation is assembled in 'scratch', whose size must equal the total
+// fragment size.
+absl::string_view FlattenFragments(
+    absl::Span<const absl::string_view> fragments, SmallBuffer* scratch) {
+  if (fragments.empty()) return absl::string_view();
+  if (fragments.size() == 1) return fragments[0];
+  char* write_pos = scratch->data();
+  for (absl::string_view fragment : fragments) {
+    if (!fragment.empty()) {
+      std::memcpy(write_pos, fragment.data(), fragment.size());
+      write_pos += fragment.size();
+    }
+  }
+  return absl::string_view(scratch->data(), scratch->size());
+}
+
+size_t TotalSize(absl::Span<const absl::string_view> fragments) {
+  size_t total_size = 0;
+  for (absl::string_view fragment : fragments) {
+    total_size += fragment.size();
+  }
+  return total_size;
+}
+
+}  // namespace
+
 util::StatusOr<std::unique_ptr<Aead>> AesGcmBoringSsl::New(
     const util::SecretData& key) {
   auto status = internal::CheckFipsCompatibility<AesGcmBoringSsl>();
@@ -50,9 +82,12 @@ util::StatusOr<std::unique_ptr<Aead>> AesGcmBoringSsl::New(
 
 util::StatusOr<std::string> AesGcmBoringSsl::Encrypt(
     absl::string_view plaintext, absl::string_view additional_data) const {
-  std::string result = Random::GetRandomBytes(kIvSizeInBytes);
+  // Allocate the result at its final size right away and generate the IV
+  // directly into it, so the whole encryption allocates exactly once.
+  std::string result;
   ResizeStringUninitialized(
       &result, kIvSizeInBytes + plaintext.size() + kTagSizeInBytes);
+  Random::GetRandomBytes(absl::Span<char>(&result[0], kIvSizeInBytes));
   size_t len;
   if (EVP_AEAD_CTX_seal(
           ctx_.get(), reinterpret_cast<uint8_t*>(&result[kIvSizeInBytes]), &len,
@@ -66,6 +101,132 @@ util::StatusOr<std::string> AesGcmBoringSsl::Encrypt(
   return result;
 }
 
+util::StatusOr<std::string> AesGcmBoringSsl::EncryptFragments(
+    absl::Span<const absl::string_view> plaintext,
+    absl::Span<const absl::string_view> additional_data) const {
+  // Gather the plaintext fragments directly into the result buffer, where
+  // the ciphertext then overwrites them in place; EVP_AEAD_CTX_seal
+  // supports fully overlapping input and output.
+  std::string result;
+  ResizeStringUninitialized(
+      &result, kIvSizeInBytes + TotalSize(plaintext) + kTagSizeInBytes);
+  char* write_pos = &result[kIvSizeInBytes];
+  for (absl::string_view fragment : plaintext) {
+    if (!fragment.empty()) {
+      std::memcpy(write_pos, fragment.data(), fragment.size());
+      write_pos += fragment.size();
+    }
+  }
+  size_t plaintext_size = write_pos - &result[kIvSizeInBytes];
+  Random::GetRandomBytes(absl::Span<char>(&result[0], kIvSizeInBytes));
+  SmallBuffer additional_data_scratch(TotalSize(additional_data));
+  absl::string_view flat_additional_data =
+      FlattenFragments(additional_data, &additional_data_scratch);
+  size_t len;
+  if (EVP_AEAD_CTX_seal(
+          ctx_.get(), reinterpret_cast<uint8_t*>(&result[kIvSizeInBytes]), &len,
+          plaintext_size + kTagSizeInBytes,
+          reinterpret_cast<const uint8_t*>(&result[0]), kIvSizeInBytes,
+          reinterpret_cast<const uint8_t*>(&result[kIvSizeInBytes]),
+          plaintext_size,
+          reinterpret_cast<const uint8_t*>(flat_additional_data.data()),
+          flat_additional_data.size()) != 1) {
+    return util::Status(util::error::INTERNAL, "Encryption failed");
+  }
+  return result;
+}
+
+util::StatusOr<std::string> AesGcmBoringSsl::DecryptFragments(
+    absl::string_view ciphertext,
+    absl::Span<const absl::string_view> additional_data) const {
+  if (ciphertext.size() < kIvSizeInBytes + kTagSizeInBytes) {
+    return util::Status(util::error::INVALID_ARGUMENT, "Ciphertext too short");
+  }
+  SmallBuffer additional_data_scratch(TotalSize(additional_data));
+  absl::string_view flat_additional_data =
+      FlattenFragments(additional_data, &additional_data_scratch);
+
+  std::string result;
+  ResizeStringUninitialized(
+      &result, ciphertext.size() - kIvSizeInBytes - kTagSizeInBytes);
+  size_t len;
+  ErrorQueueMark error_queue_mark;
+  if (EVP_AEAD_CTX_open(
+          ctx_.get(), reinterpret_cast<uint8_t*>(&result[0]), &len,
+          result.size(),
+          reinterpret_cast<const uint8_t*>(ciphertext.data()), kIvSizeInBytes,
+          reinterpret_cast<const uint8_t*>(ciphertext.data()) + kIvSizeInBytes,
+          ciphertext.size() - kIvSizeInBytes,
+          reinterpret_cast<const uint8_t*>(flat_additional_data.data()),
+          flat_additional_data.size()) != 1) {
+    return AuthenticationFailedStatus();
+  }
+  return result;
+}
+
+util::StatusOr<size_t> AesGcmBoringSsl::EncryptInto(
+    absl::string_view plaintext, absl::string_view additional_data,
+    absl::Span<char> out) const {
+  if (out.size() < kIvSizeInBytes + plaintext.size() + kTagSizeInBytes) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "Output buffer too small");
+  }
+  // Writing the IV into 'out' does not clobber the plaintext in the
+  // supported in-place layout, where the plaintext starts at
+  // out.data() + kIvSizeInBytes.
+  Random::GetRandomBytes(out.subspan(0, kIvSizeInBytes));
+  size_t len;
+  if (EVP_AEAD_CTX_seal(
+          ctx_.get(), reinterpret_cast<uint8_t*>(out.data() + kIvSizeInBytes),
+          &len, plaintext.size() + kTagSizeInBytes,
+          reinterpret_cast<const uint8_t*>(out.data()), kIvSizeInBytes,
+          reinterpret_cast<const uint8_t*>(plaintext.data()), plaintext.size(),
+          reinterpret_cast<const uint8_t*>(additional_data.data()),
+          additional_data.size()) != 1) {
+    return util::Status(util::error::INTERNAL, "Encryption failed");
+  }
+  return kIvSizeInBytes + len;
+}
+
+util::Status AesGcmBoringSsl::EncryptBatch(
+    absl::Span<const absl::string_view> plaintexts,
+    absl::string_view additional_data, absl::Span<const absl::Span<char>> outs,
+    absl::Span<size_t> ciphertext_sizes) const {
+  if (plaintexts.size() != outs.size() ||
+      plaintexts.size() != ciphertext_sizes.size()) {
+    return util::Status(
+        util::error::INVALID_ARGUMENT,
+        "plaintexts, outs and ciphertext_sizes must have the same length.");
+  }
+  for (size_t i = 0; i < plaintexts.size(); i++) {
+    if (outs[i].size() <
+        kIvSizeInBytes + plaintexts[i].size() + kTagSizeInBytes) {
+      return util::Status(util::error::INVALID_ARGUMENT,
+                          "Output buffer too small");
+    }
+  }
+  // One RNG call for all IVs of the batch.
+  const std::string ivs =
+      Random::GetRandomBytes(plaintexts.size() * kIvSizeInBytes);
+  for (size_t i = 0; i < plaintexts.size(); i++) {
+    std::memcpy(outs[i].data(), &ivs[i * kIvSizeInBytes], kIvSizeInBytes);
+    size_t len;
+    if (EVP_AEAD_CTX_seal(
+            ctx_.get(),
+            reinterpret_cast<uint8_t*>(outs[i].data() + kIvSizeInBytes), &len,
+            plaintexts[i].size() + kTagSizeInBytes,
+            reinterpret_cast<const uint8_t*>(outs[i].data()), kIvSizeInBytes,
+            reinterpret_cast<const uint8_t*>(plaintexts[i].data()),
+            plaintexts[i].size(),
+            reinterpret_cast<const uint8_t*>(additional_data.data()),
+            additional_data.size()) != 1) {
+      return util::Status(util::error::INTERNAL, "Encryption failed");
+    }
+    ciphertext_sizes[i] = kIvSizeInBytes + len;
+  }
+  return util::Status::OK;
+}
+
 util::StatusOr<std::string> AesGcmBoringSsl::Decrypt(
     absl::string_view ciphertext, absl::string_view additional_data) const {
   if (ciphertext.size() < kIvSizeInBytes + kTagSizeInBytes) {
@@ -76,6 +237,7 @@ util::StatusOr<std::string> AesGcmBoringSsl::Decrypt(
   ResizeStringUninitialized(
       &result, ciphertext.size() - kIvSizeInBytes - kTagSizeInBytes);
   size_t len;
+  ErrorQueueMark error_queue_mark;
   if (EVP_AEAD_CTX_open(
           ctx_.get(), reinterpret_cast<uint8_t*>(&result[0]), &len,
           result.size(),
@@ -86,7 +248,7 @@ util::StatusOr<std::string> AesGcmBoringSsl::Decrypt(
           ciphertext.size() - kIvSizeInBytes,
           reinterpret_cast<const uint8_t*>(additional_data.data()),
           additional_data.size()) != 1) {
-    return util::Status(util::error::INTERNAL, "Authentication failed");
+    return AuthenticationFailedStatus();
   }
   return result;
 }
@@ -24,6 +24,7 @@
 #include "openssl/aead.h"
 #include "tink/aead.h"
 #include "tink/internal/fips_utils.h"
+#include "tink/memory_footprint.h"
 #include "tink/util/secret_data.h"
 #include "tink/util/statusor.h"
 
@@ -31,7 +32,7 @@ namespace crypto {
 namespace tink {
 namespace subtle {
 
-class AesGcmBoringSsl : public Aead {
+class AesGcmBoringSsl : public Aead, public MemoryFootprintProvider {
  public:
   ABSL_DEPRECATED("Use AesGcmBoringSsl::New(const util::SecretData&) instead.")
   static crypto::tink::util::StatusOr<std::unique_ptr<Aead>> New(
@@ -49,6 +50,48 @@ class AesGcmBoringSsl : public Aead {
       absl::string_view ciphertext,
       absl::string_view additional_data) const override;
 
+  size_t MaxEncryptionSize(size_t plaintext_size) const override {
+    return kIvSizeInBytes + plaintext_size + kTagSizeInBytes;
+  }
+
+  // Writes IV, ciphertext and tag directly into 'out' without intermediate
+  // allocations. Supports in-place encryption: 'plaintext' may overlap 'out'
+  // if plaintext.data() == out.data() + kIvSizeInBytes, i.e. if the plaintext
+  // already sits where the ciphertext will be written.
+  crypto::tink::util::StatusOr<size_t> EncryptInto(
+      absl::string_view plaintext, absl::string_view additional_data,
+      absl::Span<char> out) const override;
+
+  // Gathers the plaintext fragments directly into the result buffer and
+  // encrypts them in place, so fragmented plaintexts cost no extra copy;
+  // fragmented associated data is assembled in a stack-backed scratch
+  // buffer, since BoringSSL's one-shot EVP_AEAD interface needs it
+  // contiguous.
+  crypto::tink::util::StatusOr<std::string> EncryptFragments(
+      absl::Span<const absl::string_view> plaintext,
+      absl::Span<const absl::string_view> additional_data) const override;
+
+  // See EncryptFragments() for how the associated-data fragments are fed to
+  // the cipher.
+  crypto::tink::util::StatusOr<std::string> DecryptFragments(
+      absl::string_view ciphertext,
+      absl::Span<const absl::string_view> additional_data) const override;
+
+  // Draws the IVs for the whole batch with a single RNG call, amortizing the
+  // cost of the (locked) BoringSSL RNG over all entries.
+  crypto::tink::util::Status EncryptBatch(
+      absl::Span<const absl::string_view> plaintexts,
+      absl::string_view additional_data,
+      absl::Span<const absl::Span<char>> outs,
+      absl::Span<size_t> ciphertext_sizes) const override;
+
+  // The whole state of this primitive is the object itself plus the one
+  // BoringSSL AEAD context it owns; the expanded AES key schedule lives
+  // inside the context.
+  size_t MemoryFootprint() const override {
+    return sizeof(*this) + sizeof(EVP_AEAD_CTX);
+  }
+
   static constexpr crypto::tink::internal::FipsCompatibility kFipsStatus =
       crypto::tink::internal::FipsCompatibility::kRequiresBoringCrypto;
 
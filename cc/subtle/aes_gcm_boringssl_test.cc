@@ -16,12 +16,14 @@
 
 #include "tink/subtle/aes_gcm_boringssl.h"
 
+#include <cstring>
 #include <string>
 #include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
 #include "openssl/err.h"
 #include "include/rapidjson/document.h"
 #include "tink/config/tink_fips.h"
@@ -62,6 +64,170 @@ TEST(AesGcmBoringSslTest, testBasic) {
   EXPECT_EQ(pt.ValueOrDie(), message);
 }
 
+TEST(AesGcmBoringSslTest, testEncryptInto) {
+  if (IsFipsModeEnabled() && !FIPS_mode()) {
+    GTEST_SKIP()
+        << "Test should not run in FIPS mode when BoringCrypto is unavailable.";
+  }
+
+  util::SecretData key = util::SecretDataFromStringView(
+      test::HexDecodeOrDie("000102030405060708090a0b0c0d0e0f"));
+  auto cipher = std::move(AesGcmBoringSsl::New(key).ValueOrDie());
+  std::string message = "Some data to encrypt.";
+  std::string aad = "Some data to authenticate.";
+
+  std::string buffer;
+  buffer.resize(cipher->MaxEncryptionSize(message.size()));
+  EXPECT_EQ(buffer.size(), message.size() + 12 + 16);
+  auto written = cipher->EncryptInto(message, aad, absl::MakeSpan(&buffer[0],
+                                                                  buffer.size()));
+  EXPECT_TRUE(written.ok()) << written.status();
+  EXPECT_EQ(written.ValueOrDie(), buffer.size());
+  auto pt = cipher->Decrypt(buffer, aad);
+  EXPECT_TRUE(pt.ok()) << pt.status();
+  EXPECT_EQ(pt.ValueOrDie(), message);
+
+  // A buffer that is too small is rejected.
+  auto too_small = cipher->EncryptInto(
+      message, aad, absl::MakeSpan(&buffer[0], message.size()));
+  EXPECT_THAT(too_small.status(),
+              StatusIs(util::error::INVALID_ARGUMENT));
+
+  // In-place: the plaintext sits where the ciphertext will be written.
+  std::string in_place_buffer;
+  in_place_buffer.resize(cipher->MaxEncryptionSize(message.size()));
+  std::memcpy(&in_place_buffer[12], message.data(), message.size());
+  auto in_place_written = cipher->EncryptInto(
+      absl::string_view(in_place_buffer).substr(12, message.size()), aad,
+      absl::MakeSpan(&in_place_buffer[0], in_place_buffer.size()));
+  EXPECT_TRUE(in_place_written.ok()) << in_place_written.status();
+  auto in_place_pt = cipher->Decrypt(in_place_buffer, aad);
+  EXPECT_TRUE(in_place_pt.ok()) << in_place_pt.status();
+  EXPECT_EQ(in_place_pt.ValueOrDie(), message);
+}
+
+TEST(AesGcmBoringSslTest, testEncryptDecryptFragments) {
+  if (IsFipsModeEnabled() && !FIPS_mode()) {
+    GTEST_SKIP()
+        << "Test should not run in FIPS mode when BoringCrypto is unavailable.";
+  }
+
+  util::SecretData key = util::SecretDataFromStringView(
+      test::HexDecodeOrDie("000102030405060708090a0b0c0d0e0f"));
+  auto cipher = std::move(AesGcmBoringSsl::New(key).ValueOrDie());
+  std::string message = "Some data to encrypt.";
+  std::string aad = "Some data to authenticate.";
+
+  // Fragmented inputs must be fully interchangeable with their
+  // concatenation.
+  absl::string_view message_view = message;
+  absl::string_view aad_view = aad;
+  std::vector<absl::string_view> message_fragments = {
+      message_view.substr(0, 5), "", message_view.substr(5)};
+  std::vector<absl::string_view> aad_fragments = {aad_view.substr(0, 10),
+                                                  aad_view.substr(10)};
+  auto ct = cipher->EncryptFragments(message_fragments, aad_fragments);
+  EXPECT_TRUE(ct.ok()) << ct.status();
+  EXPECT_EQ(ct.ValueOrDie().size(), message.size() + 12 + 16);
+  auto pt = cipher->Decrypt(ct.ValueOrDie(), aad);
+  EXPECT_TRUE(pt.ok()) << pt.status();
+  EXPECT_EQ(pt.ValueOrDie(), message);
+
+  auto fragment_pt = cipher->DecryptFragments(ct.ValueOrDie(), aad_fragments);
+  EXPECT_TRUE(fragment_pt.ok()) << fragment_pt.status();
+  EXPECT_EQ(fragment_pt.ValueOrDie(), message);
+
+  // A contiguous ciphertext decrypts against fragmented associated data, and
+  // differently fragmented associated data authenticates as long as the
+  // concatenation matches.
+  auto contiguous_ct = cipher->Encrypt(message, aad);
+  EXPECT_TRUE(contiguous_ct.ok()) << contiguous_ct.status();
+  std::vector<absl::string_view> other_aad_fragments = {
+      aad_view.substr(0, 3), aad_view.substr(3)};
+  fragment_pt = cipher->DecryptFragments(contiguous_ct.ValueOrDie(),
+                                         other_aad_fragments);
+  EXPECT_TRUE(fragment_pt.ok()) << fragment_pt.status();
+  EXPECT_EQ(fragment_pt.ValueOrDie(), message);
+
+  // Wrong associated data is rejected.
+  std::vector<absl::string_view> wrong_aad_fragments = {
+      aad_view.substr(0, 10), "tampered"};
+  auto failed_pt =
+      cipher->DecryptFragments(ct.ValueOrDie(), wrong_aad_fragments);
+  EXPECT_FALSE(failed_pt.ok());
+
+  // Empty fragment lists behave like empty inputs.
+  auto empty_ct = cipher->EncryptFragments({}, {});
+  EXPECT_TRUE(empty_ct.ok()) << empty_ct.status();
+  auto empty_pt = cipher->Decrypt(empty_ct.ValueOrDie(), "");
+  EXPECT_TRUE(empty_pt.ok()) << empty_pt.status();
+  EXPECT_EQ(empty_pt.ValueOrDie(), "");
+}
+
+TEST(AesGcmBoringSslTest, testEncryptBatch) {
+  if (IsFipsModeEnabled() && !FIPS_mode()) {
+    GTEST_SKIP()
+        << "Test should not run in FIPS mode when BoringCrypto is unavailable.";
+  }
+
+  util::SecretData key = util::SecretDataFromStringView(
+      test::HexDecodeOrDie("000102030405060708090a0b0c0d0e0f"));
+  auto cipher = std::move(AesGcmBoringSsl::New(key).ValueOrDie());
+  std::string aad = "Some data to authenticate.";
+
+  std::vector<std::string> messages = {"first record", "", "a third record"};
+  std::vector<absl::string_view> plaintexts(messages.begin(), messages.end());
+  std::vector<std::string> buffers(messages.size());
+  std::vector<absl::Span<char>> outs;
+  for (size_t i = 0; i < messages.size(); i++) {
+    buffers[i].resize(cipher->MaxEncryptionSize(messages[i].size()));
+    outs.push_back(absl::MakeSpan(&buffers[i][0], buffers[i].size()));
+  }
+  std::vector<size_t> ciphertext_sizes(messages.size());
+
+  auto status = cipher->EncryptBatch(absl::MakeConstSpan(plaintexts), aad,
+                                     absl::MakeConstSpan(outs),
+                                     absl::MakeSpan(ciphertext_sizes));
+  EXPECT_TRUE(status.ok()) << status;
+  for (size_t i = 0; i < messages.size(); i++) {
+    EXPECT_EQ(ciphertext_sizes[i], messages[i].size() + 12 + 16);
+    auto pt = cipher->Decrypt(
+        absl::string_view(buffers[i]).substr(0, ciphertext_sizes[i]), aad);
+    EXPECT_TRUE(pt.ok()) << pt.status();
+    EXPECT_EQ(pt.ValueOrDie(), messages[i]);
+  }
+
+  // IVs within a batch must be distinct.
+  EXPECT_NE(buffers[0].substr(0, 12), buffers[1].substr(0, 12));
+
+  // Mismatched span lengths are rejected.
+  std::vector<size_t> short_sizes(messages.size() - 1);
+  EXPECT_THAT(cipher
+                  ->EncryptBatch(absl::MakeConstSpan(plaintexts), aad,
+                                 absl::MakeConstSpan(outs),
+                                 absl::MakeSpan(short_sizes)),
+              StatusIs(util::error::INVALID_ARGUMENT));
+}
+
+TEST(AesGcmBoringSslTest, testFailedDecryptionLeavesErrorQueueClean) {
+  if (IsFipsModeEnabled() && !FIPS_mode()) {
+    GTEST_SKIP()
+        << "Test should not run in FIPS mode when BoringCrypto is unavailable.";
+  }
+
+  util::SecretData key = util::SecretDataFromStringView(
+      test::HexDecodeOrDie("000102030405060708090a0b0c0d0e0f"));
+  auto cipher = std::move(AesGcmBoringSsl::New(key).ValueOrDie());
+  std::string ct = cipher->Encrypt("message", "aad").ValueOrDie();
+  std::string modified_ct = ct;
+  modified_ct[modified_ct.size() - 1] ^= 1;
+  ERR_clear_error();
+  // A failed tag check must not leave entries on BoringSSL's thread-local
+  // error queue; raw-key scanning hits this path once per non-matching key.
+  EXPECT_FALSE(cipher->Decrypt(modified_ct, "aad").ok());
+  EXPECT_EQ(ERR_peek_error(), 0);
+}
+
 TEST(AesGcmBoringSslTest, testModification) {
   if (IsFipsModeEnabled() && !FIPS_mode()) {
     GTEST_SKIP()
@@ -265,57 +431,61 @@ static std::string GetError() {
   return lib + ":" + func + ":" + reason;
 }
 
-// Test with test vectors from Wycheproof project.
-bool WycheproofTest(const rapidjson::Document &root) {
+// Verifies one Wycheproof test group; returns the number of errors.
+int WycheproofTestGroup(const rapidjson::Value& test_group) {
   int errors = 0;
-  for (const rapidjson::Value& test_group : root["testGroups"].GetArray()) {
-    const size_t iv_size = test_group["ivSize"].GetInt();
-    const size_t key_size = test_group["keySize"].GetInt();
-    const size_t tag_size = test_group["tagSize"].GetInt();
-    // AesGcmBoringSsl only supports 12-byte IVs and 16-byte authentication tag.
-    // Also 24-byte keys are not supported.
-    if (iv_size != 96 || tag_size != 128 || key_size == 192) {
-      // Not supported
-      continue;
-    }
-    for (const rapidjson::Value& test : test_group["tests"].GetArray()) {
-      std::string comment = test["comment"].GetString();
-      util::SecretData key =
-          util::SecretDataFromStringView(WycheproofUtil::GetBytes(test["key"]));
-      std::string iv = WycheproofUtil::GetBytes(test["iv"]);
-      std::string msg = WycheproofUtil::GetBytes(test["msg"]);
-      std::string ct = WycheproofUtil::GetBytes(test["ct"]);
-      std::string aad = WycheproofUtil::GetBytes(test["aad"]);
-      std::string tag = WycheproofUtil::GetBytes(test["tag"]);
-      std::string id = absl::StrCat(test["tcId"].GetInt());
-      std::string expected = test["result"].GetString();
-      auto cipher =
-         std::move(AesGcmBoringSsl::New(key).ValueOrDie());
-      auto result = cipher->Decrypt(iv + ct + tag, aad);
-      bool success = result.ok();
-      if (success) {
-        std::string decrypted = result.ValueOrDie();
-        if (expected == "invalid") {
-          ADD_FAILURE() << "decrypted invalid ciphertext:" << id;
-          errors++;
-        } else if (msg != decrypted) {
-          ADD_FAILURE() << "Incorrect decryption:" << id;
-          errors++;
-        }
-      } else {
-        if (expected == "valid" || expected == "acceptable") {
-          ADD_FAILURE()
-              << "Could not decrypt test with tcId:" << id
-              << " iv_size:" << iv_size
-              << " tag_size:" << tag_size
-              << " key_size:" << key_size
-              << " error:" << GetError();
-          errors++;
-        }
+  const size_t iv_size = test_group["ivSize"].GetInt();
+  const size_t key_size = test_group["keySize"].GetInt();
+  const size_t tag_size = test_group["tagSize"].GetInt();
+  // AesGcmBoringSsl only supports 12-byte IVs and 16-byte authentication tag.
+  // Also 24-byte keys are not supported.
+  if (iv_size != 96 || tag_size != 128 || key_size == 192) {
+    // Not supported
+    return 0;
+  }
+  for (const rapidjson::Value& test : test_group["tests"].GetArray()) {
+    std::string comment = test["comment"].GetString();
+    util::SecretData key =
+        util::SecretDataFromStringView(WycheproofUtil::GetBytes(test["key"]));
+    std::string iv = WycheproofUtil::GetBytes(test["iv"]);
+    std::string msg = WycheproofUtil::GetBytes(test["msg"]);
+    std::string ct = WycheproofUtil::GetBytes(test["ct"]);
+    std::string aad = WycheproofUtil::GetBytes(test["aad"]);
+    std::string tag = WycheproofUtil::GetBytes(test["tag"]);
+    std::string id = absl::StrCat(test["tcId"].GetInt());
+    std::string expected = test["result"].GetString();
+    auto cipher =
+       std::move(AesGcmBoringSsl::New(key).ValueOrDie());
+    auto result = cipher->Decrypt(iv + ct + tag, aad);
+    bool success = result.ok();
+    if (success) {
+      std::string decrypted = result.ValueOrDie();
+      if (expected == "invalid") {
+        ADD_FAILURE() << "decrypted invalid ciphertext:" << id;
+        errors++;
+      } else if (msg != decrypted) {
+        ADD_FAILURE() << "Incorrect decryption:" << id;
+        errors++;
+      }
+    } else {
+      if (expected == "valid" || expected == "acceptable") {
+        ADD_FAILURE()
+            << "Could not decrypt test with tcId:" << id
+            << " iv_size:" << iv_size
+            << " tag_size:" << tag_size
+            << " key_size:" << key_size
+            << " error:" << GetError();
+        errors++;
       }
     }
   }
-  return errors == 0;
+  return errors;
+}
+
+// Test with test vectors from Wycheproof project, running the independent
+// test groups in parallel.
+bool WycheproofTest(const rapidjson::Document &root) {
+  return WycheproofUtil::RunTestGroups(root, WycheproofTestGroup) == 0;
 }
 
 TEST(AesGcmBoringSslTest, TestVectors) {
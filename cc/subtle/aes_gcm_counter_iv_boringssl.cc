@@ -0,0 +1,122 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/subtle/aes_gcm_counter_iv_boringssl.h"
+
+#include <cstring>
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "openssl/aead.h"
+#include "tink/subtle/subtle_util.h"
+#include "tink/subtle/subtle_util_boringssl.h"
+#include "tink/util/errors.h"
+#include "tink/util/status.h"
+
+namespace crypto {
+namespace tink {
+namespace subtle {
+
+util::StatusOr<std::unique_ptr<Aead>> AesGcmCounterIvBoringSsl::New(
+    const util::SecretData& key) {
+  return New(key, /* next_sequence = */ 0);
+}
+
+util::StatusOr<std::unique_ptr<Aead>> AesGcmCounterIvBoringSsl::New(
+    const util::SecretData& key, uint64_t next_sequence) {
+  auto status = internal::CheckFipsCompatibility<AesGcmCounterIvBoringSsl>();
+  if (!status.ok()) return status;
+
+  if (next_sequence >= kMessageLimit) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "next_sequence exceeds the message limit");
+  }
+  const EVP_AEAD* aead =
+      SubtleUtilBoringSSL::GetAesGcmAeadForKeySize(key.size());
+  if (aead == nullptr) {
+    return util::Status(util::error::INVALID_ARGUMENT, "invalid key size");
+  }
+  bssl::UniquePtr<EVP_AEAD_CTX> ctx(EVP_AEAD_CTX_new(
+      aead, key.data(), key.size(), EVP_AEAD_DEFAULT_TAG_LENGTH));
+  if (!ctx) {
+    return util::Status(util::error::INTERNAL,
+                        "could not initialize EVP_AEAD_CTX");
+  }
+  return {absl::WrapUnique(
+      new AesGcmCounterIvBoringSsl(std::move(ctx), next_sequence))};
+}
+
+util::StatusOr<std::string> AesGcmCounterIvBoringSsl::Encrypt(
+    absl::string_view plaintext, absl::string_view additional_data) const {
+  // Claim the sequence number first; with concurrent writers every message
+  // then has its own IV even if some of them fail later.
+  uint64_t sequence = next_sequence_.fetch_add(1, std::memory_order_relaxed);
+  if (sequence >= kMessageLimit) {
+    return util::Status(
+        util::error::RESOURCE_EXHAUSTED,
+        "Message limit of this key reached; rekey the channel.");
+  }
+  std::string result;
+  ResizeStringUninitialized(
+      &result, kIvSizeInBytes + plaintext.size() + kTagSizeInBytes);
+  // IV is the 96-bit big-endian encoding of the sequence number.
+  std::memset(&result[0], 0, kIvSizeInBytes - sizeof(sequence));
+  for (size_t i = 0; i < sizeof(sequence); i++) {
+    result[kIvSizeInBytes - 1 - i] =
+        static_cast<char>((sequence >> (8 * i)) & 0xff);
+  }
+  size_t len;
+  if (EVP_AEAD_CTX_seal(
+          ctx_.get(), reinterpret_cast<uint8_t*>(&result[kIvSizeInBytes]), &len,
+          plaintext.size() + kTagSizeInBytes,
+          reinterpret_cast<const uint8_t*>(&result[0]), kIvSizeInBytes,
+          reinterpret_cast<const uint8_t*>(plaintext.data()), plaintext.size(),
+          reinterpret_cast<const uint8_t*>(additional_data.data()),
+          additional_data.size()) != 1) {
+    return util::Status(util::error::INTERNAL, "Encryption failed");
+  }
+  return result;
+}
+
+util::StatusOr<std::string> AesGcmCounterIvBoringSsl::Decrypt(
+    absl::string_view ciphertext, absl::string_view additional_data) const {
+  if (ciphertext.size() < kIvSizeInBytes + kTagSizeInBytes) {
+    return util::Status(util::error::INVALID_ARGUMENT, "Ciphertext too short");
+  }
+
+  std::string result;
+  ResizeStringUninitialized(
+      &result, ciphertext.size() - kIvSizeInBytes - kTagSizeInBytes);
+  size_t len;
+  ErrorQueueMark error_queue_mark;
+  if (EVP_AEAD_CTX_open(
+          ctx_.get(), reinterpret_cast<uint8_t*>(&result[0]), &len,
+          result.size(),
+          // The nonce is the first |kIvSizeInBytes| bytes of |ciphertext|.
+          reinterpret_cast<const uint8_t*>(ciphertext.data()), kIvSizeInBytes,
+          // The input is the remainder.
+          reinterpret_cast<const uint8_t*>(ciphertext.data()) + kIvSizeInBytes,
+          ciphertext.size() - kIvSizeInBytes,
+          reinterpret_cast<const uint8_t*>(additional_data.data()),
+          additional_data.size()) != 1) {
+    return AuthenticationFailedStatus();
+  }
+  return result;
+}
+
+}  // namespace subtle
+}  // namespace tink
+}  // namespace crypto
@@ -0,0 +1,104 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_SUBTLE_AES_GCM_COUNTER_IV_BORINGSSL_H_
+#define TINK_SUBTLE_AES_GCM_COUNTER_IV_BORINGSSL_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "openssl/aead.h"
+#include "tink/aead.h"
+#include "tink/internal/fips_utils.h"
+#include "tink/util/secret_data.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace subtle {
+
+// AES-GCM with deterministic, counter-based IVs, for high-frequency
+// single-writer channels where drawing 12 random bytes per message from the
+// (locked) RNG dominates the cost of encrypting small records. Each
+// Encrypt() consumes the next value of a 64-bit sequence number, encoded
+// big-endian into the IV, so encryption performs no RNG call at all.
+//
+// MISUSE WARNING. IV uniqueness -- on which all of GCM's security rests --
+// is guaranteed only within a single instance: the key MUST be used by
+// exactly one writer, i.e. one AesGcmCounterIvBoringSsl instance in one
+// process. Never use a long-term or shared key here; bind a fresh key to
+// the connection (e.g. from the handshake). For anything but such
+// single-writer channels, use AesGcmBoringSsl with its random IVs.
+//
+// The sequence number is drawn from one atomic counter, so a single
+// instance may be shared by several threads. Encryption fails with
+// RESOURCE_EXHAUSTED once kMessageLimit messages have been produced; the
+// connection then has to rekey.
+//
+// The wire format (IV || ciphertext || tag) is the same as that of
+// AesGcmBoringSsl, so either side of a connection can decrypt records
+// produced by the other variant.
+class AesGcmCounterIvBoringSsl : public Aead {
+ public:
+  // Upper bound on the number of messages a single key may encrypt.
+  static constexpr uint64_t kMessageLimit = uint64_t{1} << 32;
+
+  static crypto::tink::util::StatusOr<std::unique_ptr<Aead>> New(
+      const util::SecretData& key);
+
+  // Like New(), but starts the IV sequence at 'next_sequence' instead of 0;
+  // for resuming a connection whose writer already produced that many
+  // messages under 'key'. The caller must guarantee that no IV below
+  // 'next_sequence' is ever produced again with this key.
+  static crypto::tink::util::StatusOr<std::unique_ptr<Aead>> New(
+      const util::SecretData& key, uint64_t next_sequence);
+
+  crypto::tink::util::StatusOr<std::string> Encrypt(
+      absl::string_view plaintext,
+      absl::string_view additional_data) const override;
+
+  crypto::tink::util::StatusOr<std::string> Decrypt(
+      absl::string_view ciphertext,
+      absl::string_view additional_data) const override;
+
+  size_t MaxEncryptionSize(size_t plaintext_size) const override {
+    return kIvSizeInBytes + plaintext_size + kTagSizeInBytes;
+  }
+
+  static constexpr crypto::tink::internal::FipsCompatibility kFipsStatus =
+      crypto::tink::internal::FipsCompatibility::kRequiresBoringCrypto;
+
+ private:
+  static constexpr int kIvSizeInBytes = 12;
+  static constexpr int kTagSizeInBytes = 16;
+
+  AesGcmCounterIvBoringSsl(bssl::UniquePtr<EVP_AEAD_CTX> ctx,
+                           uint64_t next_sequence)
+      : ctx_(std::move(ctx)), next_sequence_(next_sequence) {}
+
+  bssl::UniquePtr<EVP_AEAD_CTX> ctx_;
+  // Sequence number of the next message; incremented atomically so that
+  // concurrent writers through one instance never share an IV.
+  mutable std::atomic<uint64_t> next_sequence_;
+};
+
+}  // namespace subtle
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_SUBTLE_AES_GCM_COUNTER_IV_BORINGSSL_H_
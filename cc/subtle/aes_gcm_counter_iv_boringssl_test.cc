@@ -0,0 +1,147 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/subtle/aes_gcm_counter_iv_boringssl.h"
+
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "openssl/crypto.h"
+#include "tink/config/tink_fips.h"
+#include "tink/subtle/aes_gcm_boringssl.h"
+#include "tink/util/secret_data.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+#include "tink/util/test_matchers.h"
+#include "tink/util/test_util.h"
+
+namespace crypto {
+namespace tink {
+namespace subtle {
+namespace {
+
+using ::crypto::tink::test::StatusIs;
+
+TEST(AesGcmCounterIvBoringSslTest, testBasic) {
+  if (IsFipsModeEnabled() && !FIPS_mode()) {
+    GTEST_SKIP()
+        << "Test should not run in FIPS mode when BoringCrypto is unavailable.";
+  }
+
+  util::SecretData key = util::SecretDataFromStringView(
+      test::HexDecodeOrDie("000102030405060708090a0b0c0d0e0f"));
+  auto res = AesGcmCounterIvBoringSsl::New(key);
+  EXPECT_TRUE(res.ok()) << res.status();
+  auto cipher = std::move(res.ValueOrDie());
+  std::string message = "Some data to encrypt.";
+  std::string aad = "Some data to authenticate.";
+  auto ct = cipher->Encrypt(message, aad);
+  EXPECT_TRUE(ct.ok()) << ct.status();
+  EXPECT_EQ(ct.ValueOrDie().size(), message.size() + 12 + 16);
+  auto pt = cipher->Decrypt(ct.ValueOrDie(), aad);
+  EXPECT_TRUE(pt.ok()) << pt.status();
+  EXPECT_EQ(pt.ValueOrDie(), message);
+}
+
+TEST(AesGcmCounterIvBoringSslTest, testIvsAreSequential) {
+  if (IsFipsModeEnabled() && !FIPS_mode()) {
+    GTEST_SKIP()
+        << "Test should not run in FIPS mode when BoringCrypto is unavailable.";
+  }
+
+  util::SecretData key = util::SecretDataFromStringView(
+      test::HexDecodeOrDie("000102030405060708090a0b0c0d0e0f"));
+  auto cipher = std::move(AesGcmCounterIvBoringSsl::New(key).ValueOrDie());
+  for (uint64_t i = 0; i < 4; i++) {
+    auto ct = cipher->Encrypt("message", "aad");
+    ASSERT_TRUE(ct.ok()) << ct.status();
+    // The IV is the 96-bit big-endian sequence number.
+    std::string expected_iv(12, '\0');
+    expected_iv[11] = static_cast<char>(i);
+    EXPECT_EQ(ct.ValueOrDie().substr(0, 12), expected_iv);
+  }
+}
+
+TEST(AesGcmCounterIvBoringSslTest, testSameWireFormatAsRandomIvVariant) {
+  if (IsFipsModeEnabled() && !FIPS_mode()) {
+    GTEST_SKIP()
+        << "Test should not run in FIPS mode when BoringCrypto is unavailable.";
+  }
+
+  util::SecretData key = util::SecretDataFromStringView(
+      test::HexDecodeOrDie("000102030405060708090a0b0c0d0e0f"));
+  auto counter_cipher =
+      std::move(AesGcmCounterIvBoringSsl::New(key).ValueOrDie());
+  auto random_cipher = std::move(AesGcmBoringSsl::New(key).ValueOrDie());
+  std::string message = "Some data to encrypt.";
+  std::string aad = "Some data to authenticate.";
+
+  auto ct = counter_cipher->Encrypt(message, aad);
+  ASSERT_TRUE(ct.ok()) << ct.status();
+  auto pt = random_cipher->Decrypt(ct.ValueOrDie(), aad);
+  EXPECT_TRUE(pt.ok()) << pt.status();
+  EXPECT_EQ(pt.ValueOrDie(), message);
+
+  ct = random_cipher->Encrypt(message, aad);
+  ASSERT_TRUE(ct.ok()) << ct.status();
+  pt = counter_cipher->Decrypt(ct.ValueOrDie(), aad);
+  EXPECT_TRUE(pt.ok()) << pt.status();
+  EXPECT_EQ(pt.ValueOrDie(), message);
+}
+
+TEST(AesGcmCounterIvBoringSslTest, testMessageLimit) {
+  if (IsFipsModeEnabled() && !FIPS_mode()) {
+    GTEST_SKIP()
+        << "Test should not run in FIPS mode when BoringCrypto is unavailable.";
+  }
+
+  util::SecretData key = util::SecretDataFromStringView(
+      test::HexDecodeOrDie("000102030405060708090a0b0c0d0e0f"));
+  // Resume one message before the limit.
+  auto cipher = std::move(
+      AesGcmCounterIvBoringSsl::New(
+          key, AesGcmCounterIvBoringSsl::kMessageLimit - 1)
+          .ValueOrDie());
+  auto ct = cipher->Encrypt("message", "aad");
+  EXPECT_TRUE(ct.ok()) << ct.status();
+  // The limit is reached; further encryptions must fail.
+  ct = cipher->Encrypt("message", "aad");
+  EXPECT_THAT(ct.status(), StatusIs(util::error::RESOURCE_EXHAUSTED));
+
+  // A sequence number at or beyond the limit is rejected up front.
+  auto res = AesGcmCounterIvBoringSsl::New(
+      key, AesGcmCounterIvBoringSsl::kMessageLimit);
+  EXPECT_THAT(res.status(), StatusIs(util::error::INVALID_ARGUMENT));
+}
+
+TEST(AesGcmCounterIvBoringSslTest, testInvalidKeySizes) {
+  if (IsFipsModeEnabled() && !FIPS_mode()) {
+    GTEST_SKIP()
+        << "Test should not run in FIPS mode when BoringCrypto is unavailable.";
+  }
+
+  for (int keysize = 0; keysize < 65; keysize++) {
+    util::SecretData key(keysize, 'x');
+    auto cipher = AesGcmCounterIvBoringSsl::New(key);
+    EXPECT_EQ(cipher.ok(), keysize == 16 || keysize == 32);
+  }
+}
+
+}  // namespace
+}  // namespace subtle
+}  // namespace tink
+}  // namespace crypto
@@ -93,7 +93,9 @@ AesGcmHkdfStreamSegmentDecrypter::AesGcmHkdfStreamSegmentDecrypter(
       ciphertext_segment_size_(params.ciphertext_segment_size),
       associated_data_(std::move(params.associated_data)),
       header_size_(1 + derived_key_size_ +
-                   AesGcmHkdfStreamSegmentEncrypter::kNoncePrefixSizeInBytes) {}
+                   AesGcmHkdfStreamSegmentEncrypter::kNoncePrefixSizeInBytes),
+      use_huge_page_buffers_(params.use_huge_page_buffers),
+      key_cache_(std::move(params.key_cache)) {}
 
 // static
 util::StatusOr<std::unique_ptr<StreamSegmentDecrypter>>
@@ -129,6 +131,24 @@ util::Status AesGcmHkdfStreamSegmentDecrypter::Init(
                    AesGcmHkdfStreamSegmentEncrypter::kNoncePrefixSizeInBytes),
                nonce_prefix_.begin());
 
+  // Streams of the same encrypted file carry the same salt (and their
+  // decrypters the same associated data), so when a key cache is configured
+  // a re-open finds the ready-made context of a previous open and skips the
+  // key derivation and cipher setup below. The derived key depends on the
+  // salt and the associated data; both go into the cache key.
+  std::string cache_key;
+  if (key_cache_ != nullptr) {
+    cache_key = absl::StrCat(
+        absl::string_view(reinterpret_cast<const char*>(salt_.data()),
+                          salt_.size()),
+        associated_data_);
+    ctx_ = key_cache_->Get(cache_key);
+    if (ctx_ != nullptr) {
+      is_initialized_ = true;
+      return util::OkStatus();
+    }
+  }
+
   // Derive symmetric key.
   auto hkdf_result = Hkdf::ComputeHkdf(
       hkdf_hash_, ikm_,
@@ -146,11 +166,15 @@ util::Status AesGcmHkdfStreamSegmentDecrypter::Init(
   }
   ctx_.reset(
       EVP_AEAD_CTX_new(aead, key.data(), key.size(),
-                       AesGcmHkdfStreamSegmentEncrypter::kTagSizeInBytes));
+                       AesGcmHkdfStreamSegmentEncrypter::kTagSizeInBytes),
+      EVP_AEAD_CTX_free);
   if (!ctx_) {
     return util::Status(util::error::INTERNAL,
                         "could not initialize EVP_AEAD_CTX");
   }
+  if (key_cache_ != nullptr) {
+    key_cache_->Insert(cache_key, ctx_);
+  }
   is_initialized_ = true;
   return util::OkStatus();
 }
@@ -165,6 +189,35 @@ util::Status AesGcmHkdfStreamSegmentDecrypter::DecryptSegment(
     int64_t segment_number,
     bool is_last_segment,
     std::vector<uint8_t>* plaintext_buffer) {
+  return DecryptSegment(absl::MakeConstSpan(ciphertext), segment_number,
+                        is_last_segment, plaintext_buffer);
+}
+
+util::Status AesGcmHkdfStreamSegmentDecrypter::DecryptSegment(
+    absl::Span<const uint8_t> ciphertext,
+    int64_t segment_number,
+    bool is_last_segment,
+    std::vector<uint8_t>* plaintext_buffer) {
+  if (plaintext_buffer == nullptr) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "plaintext_buffer must be non-null");
+  }
+  if (ciphertext.size() < AesGcmHkdfStreamSegmentEncrypter::kTagSizeInBytes) {
+    return util::Status(util::error::INVALID_ARGUMENT, "ciphertext too short");
+  }
+  plaintext_buffer->resize(
+      ciphertext.size() - AesGcmHkdfStreamSegmentEncrypter::kTagSizeInBytes);
+  auto result = DecryptSegmentInto(ciphertext, segment_number, is_last_segment,
+                                   absl::MakeSpan(*plaintext_buffer));
+  if (!result.ok()) return result.status();
+  return util::OkStatus();
+}
+
+util::StatusOr<int> AesGcmHkdfStreamSegmentDecrypter::DecryptSegmentInto(
+    absl::Span<const uint8_t> ciphertext,
+    int64_t segment_number,
+    bool is_last_segment,
+    absl::Span<uint8_t> plaintext_buffer) {
   if (!is_initialized_) {
     return util::Status(util::error::FAILED_PRECONDITION,
                         "decrypter not initialized");
@@ -175,19 +228,18 @@ util::Status AesGcmHkdfStreamSegmentDecrypter::DecryptSegment(
   if (ciphertext.size() < AesGcmHkdfStreamSegmentEncrypter::kTagSizeInBytes) {
     return util::Status(util::error::INVALID_ARGUMENT, "ciphertext too short");
   }
-  if (plaintext_buffer == nullptr) {
-    return util::Status(util::error::INVALID_ARGUMENT,
-                        "plaintext_buffer must be non-null");
-  }
   if (segment_number > std::numeric_limits<uint32_t>::max() ||
       (segment_number == std::numeric_limits<uint32_t>::max() &&
        !is_last_segment)) {
     return util::Status(util::error::INVALID_ARGUMENT, "too many segments");
   }
 
-  int pt_size =
+  size_t pt_size =
       ciphertext.size() - AesGcmHkdfStreamSegmentEncrypter::kTagSizeInBytes;
-  plaintext_buffer->resize(pt_size);
+  if (pt_size > plaintext_buffer.size()) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "plaintext_buffer too small");
+  }
 
   // Construct IV.
   std::vector<uint8_t> iv(AesGcmHkdfStreamSegmentEncrypter::kNonceSizeInBytes);
@@ -200,8 +252,8 @@ util::Status AesGcmHkdfStreamSegmentDecrypter::DecryptSegment(
   // Decrypt.
   size_t out_len;
   if (!EVP_AEAD_CTX_open(
-          ctx_.get(), plaintext_buffer->data(), &out_len,
-          plaintext_buffer->size(),
+          ctx_.get(), plaintext_buffer.data(), &out_len,
+          pt_size,
           iv.data(), iv.size(),
           ciphertext.data(), ciphertext.size(),
           /* ad = */ nullptr, /* ad.length() = */ 0)) {
@@ -209,10 +261,10 @@ util::Status AesGcmHkdfStreamSegmentDecrypter::DecryptSegment(
                         absl::StrCat("Decryption failed: ",
                                      SubtleUtilBoringSSL::GetErrors()));
   }
-  if (out_len != plaintext_buffer->size()) {
+  if (out_len != pt_size) {
     return util::Status(util::error::INTERNAL, "incorrect plaintext size");
   }
-  return util::OkStatus();
+  return static_cast<int>(pt_size);
 }
 
 
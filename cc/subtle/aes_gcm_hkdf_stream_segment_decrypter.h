@@ -22,9 +22,11 @@
 #include <string>
 #include <vector>
 
+#include "absl/types/span.h"
 #include "openssl/aead.h"
 #include "tink/subtle/common_enums.h"
 #include "tink/subtle/stream_segment_decrypter.h"
+#include "tink/subtle/streaming_key_cache.h"
 #include "tink/util/secret_data.h"
 #include "tink/util/statusor.h"
 
@@ -67,6 +69,17 @@ class AesGcmHkdfStreamSegmentDecrypter : public StreamSegmentDecrypter {
     int ciphertext_offset;
     int ciphertext_segment_size;
     std::string associated_data;
+    // If true, decrypting streams allocate their segment-sized buffers in
+    // huge-page-backed memory (see tink/util/huge_page_allocator.h), which
+    // avoids TLB misses on large (e.g. 1MB) segments.
+    bool use_huge_page_buffers = false;
+    // Optional cache of AEAD contexts shared between the decrypters built
+    // from the same key material. When set, Init() looks the header salt up
+    // before deriving the key, so re-opening a previously opened stream
+    // skips the HKDF derivation and the cipher setup; on a miss the freshly
+    // built context is added. The same cache instance must not be used with
+    // different key material; see StreamingKeyCache.
+    std::shared_ptr<StreamingKeyCache> key_cache;
   };
 
   // A factory.
@@ -82,6 +95,22 @@ class AesGcmHkdfStreamSegmentDecrypter : public StreamSegmentDecrypter {
       bool is_last_segment,
       std::vector<uint8_t>* plaintext_buffer) override;
 
+  // Decrypts the ciphertext directly from the caller-owned buffer,
+  // without copying it into a temporary vector.
+  util::Status DecryptSegment(
+      absl::Span<const uint8_t> ciphertext,
+      int64_t segment_number,
+      bool is_last_segment,
+      std::vector<uint8_t>* plaintext_buffer) override;
+
+  // Decrypts directly into the caller-provided buffer, without any
+  // intermediate plaintext copy.
+  util::StatusOr<int> DecryptSegmentInto(
+      absl::Span<const uint8_t> ciphertext,
+      int64_t segment_number,
+      bool is_last_segment,
+      absl::Span<uint8_t> plaintext_buffer) override;
+
   int get_header_size() const override {
     return header_size_;
   }
@@ -94,6 +123,9 @@ class AesGcmHkdfStreamSegmentDecrypter : public StreamSegmentDecrypter {
   int get_ciphertext_offset() const override {
     return ciphertext_offset_;
   }
+  bool use_huge_page_buffers() const override {
+    return use_huge_page_buffers_;
+  }
 
  private:
   explicit AesGcmHkdfStreamSegmentDecrypter(Params params);
@@ -107,12 +139,16 @@ class AesGcmHkdfStreamSegmentDecrypter : public StreamSegmentDecrypter {
   const int ciphertext_segment_size_;
   const std::string associated_data_;
   const int header_size_;
+  const bool use_huge_page_buffers_;
+  const std::shared_ptr<StreamingKeyCache> key_cache_;
 
   // Parameters set when initializing with data from stream header.
   bool is_initialized_ = false;
   std::vector<uint8_t> salt_;
   std::vector<uint8_t> nonce_prefix_;
-  bssl::UniquePtr<EVP_AEAD_CTX> ctx_;
+  // Shared with key_cache_ (and through it with other decrypters of the
+  // same stream) when a cache is configured; sole owner otherwise.
+  std::shared_ptr<EVP_AEAD_CTX> ctx_;
 };
 
 }  // namespace subtle
@@ -25,6 +25,7 @@
 #include "absl/memory/memory.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "openssl/aead.h"
 #include "tink/subtle/random.h"
 #include "tink/subtle/subtle_util_boringssl.h"
@@ -72,6 +73,18 @@ util::Status Validate(const AesGcmHkdfStreamSegmentEncrypter::Params& params) {
     return util::Status(util::error::INVALID_ARGUMENT,
                         "ciphertext_segment_size too small");
   }
+  if (!params.nonce_prefix.empty() &&
+      params.nonce_prefix.size() !=
+          AesGcmHkdfStreamSegmentEncrypter::kNoncePrefixSizeInBytes) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "nonce_prefix must be empty or have "
+                        "kNoncePrefixSizeInBytes bytes");
+  }
+  if (params.segment_number < 0 ||
+      params.segment_number > std::numeric_limits<uint32_t>::max()) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "segment_number out of range");
+  }
   return util::OkStatus();
 }
 
@@ -113,10 +126,14 @@ int AesGcmHkdfStreamSegmentEncrypter::get_plaintext_segment_size() const {
 AesGcmHkdfStreamSegmentEncrypter::AesGcmHkdfStreamSegmentEncrypter(
     bssl::UniquePtr<EVP_AEAD_CTX> ctx, const Params& params)
     : ctx_(std::move(ctx)),
-      nonce_prefix_(Random::GetRandomBytes(kNoncePrefixSizeInBytes)),
+      nonce_prefix_(params.nonce_prefix.empty()
+                        ? Random::GetRandomBytes(kNoncePrefixSizeInBytes)
+                        : params.nonce_prefix),
       header_(CreateHeader(params.salt, nonce_prefix_)),
       ciphertext_segment_size_(params.ciphertext_segment_size),
-      ciphertext_offset_(params.ciphertext_offset) {}
+      ciphertext_offset_(params.ciphertext_offset),
+      use_huge_page_buffers_(params.use_huge_page_buffers),
+      segment_number_(params.segment_number) {}
 
 // static
 util::StatusOr<std::unique_ptr<StreamSegmentEncrypter>>
@@ -134,32 +151,90 @@ util::Status AesGcmHkdfStreamSegmentEncrypter::EncryptSegment(
     const std::vector<uint8_t>& plaintext,
     bool is_last_segment,
     std::vector<uint8_t>* ciphertext_buffer) {
-  if (plaintext.size() > get_plaintext_segment_size()) {
-    return util::Status(util::error::INVALID_ARGUMENT, "plaintext too long");
-  }
+  return EncryptSegment(absl::MakeConstSpan(plaintext), is_last_segment,
+                        ciphertext_buffer);
+}
+
+util::Status AesGcmHkdfStreamSegmentEncrypter::EncryptSegment(
+    absl::Span<const uint8_t> plaintext,
+    bool is_last_segment,
+    std::vector<uint8_t>* ciphertext_buffer) {
+  auto status = EncryptSegmentAt(get_segment_number(), plaintext,
+                                 is_last_segment, ciphertext_buffer);
+  if (!status.ok()) return status;
+  IncSegmentNumber();
+  return util::OkStatus();
+}
+
+util::Status AesGcmHkdfStreamSegmentEncrypter::EncryptSegmentAt(
+    int64_t segment_number,
+    const std::vector<uint8_t>& plaintext,
+    bool is_last_segment,
+    std::vector<uint8_t>* ciphertext_buffer) const {
+  return EncryptSegmentAt(segment_number, absl::MakeConstSpan(plaintext),
+                          is_last_segment, ciphertext_buffer);
+}
+
+util::StatusOr<int> AesGcmHkdfStreamSegmentEncrypter::EncryptSegmentInto(
+    absl::Span<const uint8_t> plaintext,
+    bool is_last_segment,
+    absl::Span<uint8_t> ciphertext_buffer) {
+  auto result = SealSegmentAt(get_segment_number(), plaintext, is_last_segment,
+                              ciphertext_buffer);
+  if (!result.ok()) return result.status();
+  IncSegmentNumber();
+  return result;
+}
+
+util::Status AesGcmHkdfStreamSegmentEncrypter::EncryptSegmentAt(
+    int64_t segment_number,
+    absl::Span<const uint8_t> plaintext,
+    bool is_last_segment,
+    std::vector<uint8_t>* ciphertext_buffer) const {
   if (ciphertext_buffer == nullptr) {
     return util::Status(util::error::INVALID_ARGUMENT,
                         "ciphertext_buffer must be non-null");
   }
-  if (get_segment_number() > std::numeric_limits<uint32_t>::max() ||
-      (get_segment_number() == std::numeric_limits<uint32_t>::max() &&
+  if (plaintext.size() > get_plaintext_segment_size()) {
+    return util::Status(util::error::INVALID_ARGUMENT, "plaintext too long");
+  }
+  ciphertext_buffer->resize(plaintext.size() + kTagSizeInBytes);
+  auto result = SealSegmentAt(segment_number, plaintext, is_last_segment,
+                              absl::MakeSpan(*ciphertext_buffer));
+  if (!result.ok()) return result.status();
+  return util::OkStatus();
+}
+
+util::StatusOr<int> AesGcmHkdfStreamSegmentEncrypter::SealSegmentAt(
+    int64_t segment_number,
+    absl::Span<const uint8_t> plaintext,
+    bool is_last_segment,
+    absl::Span<uint8_t> ciphertext_buffer) const {
+  if (plaintext.size() > get_plaintext_segment_size()) {
+    return util::Status(util::error::INVALID_ARGUMENT, "plaintext too long");
+  }
+  if (segment_number > std::numeric_limits<uint32_t>::max() ||
+      (segment_number == std::numeric_limits<uint32_t>::max() &&
        !is_last_segment)) {
     return util::Status(util::error::INVALID_ARGUMENT, "too many segments");
   }
 
-  int ct_size = plaintext.size() + kTagSizeInBytes;
-  ciphertext_buffer->resize(ct_size);
+  size_t ct_size = plaintext.size() + kTagSizeInBytes;
+  if (ct_size > ciphertext_buffer.size()) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "ciphertext_buffer too small");
+  }
 
   // Construct IV.
   std::vector<uint8_t> iv(kNonceSizeInBytes);
   memcpy(iv.data(), nonce_prefix_.data(), kNoncePrefixSizeInBytes);
   BigEndianStore32(iv.data() + kNoncePrefixSizeInBytes,
-                   static_cast<uint32_t>(get_segment_number()));
+                   static_cast<uint32_t>(segment_number));
   iv.back() = is_last_segment ? 1 : 0;
   size_t out_len;
   if (!EVP_AEAD_CTX_seal(
-          ctx_.get(), ciphertext_buffer->data(), &out_len,
-          ciphertext_buffer->size(),
+          ctx_.get(), ciphertext_buffer.data(), &out_len,
+          ct_size,
           iv.data(), iv.size(),
           plaintext.data(), plaintext.size(),
           /* ad = */ nullptr, /* ad.length() = */ 0)) {
@@ -167,8 +242,7 @@ util::Status AesGcmHkdfStreamSegmentEncrypter::EncryptSegment(
                         absl::StrCat("Encryption failed: ",
                                      SubtleUtilBoringSSL::GetErrors()));
   }
-  IncSegmentNumber();
-  return util::OkStatus();
+  return static_cast<int>(ct_size);
 }
 
 
@@ -21,6 +21,7 @@
 #include <string>
 #include <vector>
 
+#include "absl/types/span.h"
 #include "openssl/aead.h"
 #include "tink/subtle/stream_segment_encrypter.h"
 #include "tink/util/secret_data.h"
@@ -71,11 +72,39 @@ class AesGcmHkdfStreamSegmentEncrypter : public StreamSegmentEncrypter {
   // The size of the tags of each ciphertext segment.
   static constexpr int kTagSizeInBytes = 16;
 
+  // Params fully determine the ciphertext stream an encrypter produces, so
+  // they double as persistable resumption state: to continue appending to a
+  // partially written ciphertext (e.g. after a crash), reconstruct the
+  // derived key, read 'salt' and 'nonce_prefix' back from the stream header,
+  // set 'segment_number' to the number of complete segments already written,
+  // and pass the encrypter to StreamingAeadEncryptingStream::NewResumed().
+  //
+  // SECURITY WARNING: per-segment nonces are derived deterministically from
+  // 'nonce_prefix' and the segment index. Resuming re-derives the nonce of
+  // the segment at the truncation point, so if a crashed writer emitted a
+  // partial segment at that index, encrypting different plaintext there
+  // reuses the AES-GCM keystream against the discarded bytes -- which
+  // breaks confidentiality and authenticity for both segments. Resume only
+  // if the truncated partial segment's bytes are guaranteed never to have
+  // left the writer (no backups, replication or un-erased disk blocks), or
+  // have been securely erased; otherwise encrypt the stream afresh with a
+  // new nonce prefix.
   struct Params {
     util::SecretData key;
     std::string salt;
     int ciphertext_offset;
     int ciphertext_segment_size;
+    // The per-stream nonce prefix; must be empty (a fresh random prefix is
+    // then drawn, the common case) or kNoncePrefixSizeInBytes bytes long
+    // (when resuming the stream that used this prefix).
+    std::string nonce_prefix;
+    // The number of the first segment this encrypter will encrypt; non-zero
+    // only when resuming.
+    int64_t segment_number = 0;
+    // If true, encrypting streams allocate their segment-sized buffers in
+    // huge-page-backed memory (see tink/util/huge_page_allocator.h), which
+    // avoids TLB misses on large (e.g. 1MB) segments.
+    bool use_huge_page_buffers = false;
   };
 
   // A factory.
@@ -88,6 +117,36 @@ class AesGcmHkdfStreamSegmentEncrypter : public StreamSegmentEncrypter {
       bool is_last_segment,
       std::vector<uint8_t>* ciphertext_buffer) override;
 
+  // Encrypts the plaintext directly from the caller-owned buffer,
+  // without copying it into a temporary vector.
+  util::Status EncryptSegment(
+      absl::Span<const uint8_t> plaintext,
+      bool is_last_segment,
+      std::vector<uint8_t>* ciphertext_buffer) override;
+
+  // Encrypts directly into the caller-provided buffer, without any
+  // intermediate ciphertext copy.
+  util::StatusOr<int> EncryptSegmentInto(
+      absl::Span<const uint8_t> plaintext,
+      bool is_last_segment,
+      absl::Span<uint8_t> ciphertext_buffer) override;
+
+  // The per-segment nonce is a pure function of the segment number, and
+  // EVP_AEAD_CTX is safe for concurrent sealing, so segments can be
+  // encrypted at arbitrary positions and in parallel.
+  util::Status EncryptSegmentAt(
+      int64_t segment_number,
+      const std::vector<uint8_t>& plaintext,
+      bool is_last_segment,
+      std::vector<uint8_t>* ciphertext_buffer) const override;
+
+  // As above, with the plaintext given as a view into a caller-owned buffer.
+  util::Status EncryptSegmentAt(
+      int64_t segment_number,
+      absl::Span<const uint8_t> plaintext,
+      bool is_last_segment,
+      std::vector<uint8_t>* ciphertext_buffer) const override;
+
   const std::vector<uint8_t>& get_header() const override {
     return header_;
   }
@@ -101,6 +160,9 @@ class AesGcmHkdfStreamSegmentEncrypter : public StreamSegmentEncrypter {
   int get_ciphertext_offset() const override {
     return ciphertext_offset_;
   }
+  bool use_huge_page_buffers() const override {
+    return use_huge_page_buffers_;
+  }
 
  protected:
   void IncSegmentNumber() override {
@@ -111,13 +173,23 @@ class AesGcmHkdfStreamSegmentEncrypter : public StreamSegmentEncrypter {
   AesGcmHkdfStreamSegmentEncrypter(bssl::UniquePtr<EVP_AEAD_CTX> ctx,
                                    const Params& params);
 
+  // Shared implementation of the encryption methods: encrypts 'plaintext'
+  // as segment 'segment_number' into 'ciphertext_buffer', and returns the
+  // number of ciphertext bytes written.
+  util::StatusOr<int> SealSegmentAt(
+      int64_t segment_number,
+      absl::Span<const uint8_t> plaintext,
+      bool is_last_segment,
+      absl::Span<uint8_t> ciphertext_buffer) const;
+
   bssl::UniquePtr<EVP_AEAD_CTX> ctx_;
   const std::string nonce_prefix_;
   const std::vector<uint8_t> header_;
   const int ciphertext_segment_size_;
   const int ciphertext_offset_;
+  const bool use_huge_page_buffers_;
 
-  int64_t segment_number_ = 0;
+  int64_t segment_number_;
 };
 
 }  // namespace subtle
@@ -22,6 +22,7 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
 #include "tink/subtle/random.h"
 #include "tink/util/status.h"
 #include "tink/util/statusor.h"
@@ -192,6 +193,108 @@ TEST(AesGcmHkdfStreamSegmentEncrypterTest, testWrongCiphertextSegmentSize) {
   }
 }
 
+TEST(AesGcmHkdfStreamSegmentEncrypterTest, testResumedEncrypter) {
+  AesGcmHkdfStreamSegmentEncrypter::Params params;
+  params.key = Random::GetRandomKeyBytes(16);
+  params.salt = Random::GetRandomBytes(16);
+  params.ciphertext_offset = 0;
+  params.ciphertext_segment_size = 128;
+  auto enc =
+      std::move(AesGcmHkdfStreamSegmentEncrypter::New(params).ValueOrDie());
+
+  // Encrypt segments 0 and 1 with the original encrypter.
+  std::vector<uint8_t> pt(enc->get_plaintext_segment_size(), 'p');
+  std::vector<uint8_t> ct;
+  ASSERT_TRUE(enc->EncryptSegment(pt, false, &ct).ok());
+  ASSERT_TRUE(enc->EncryptSegment(pt, false, &ct).ok());
+  ASSERT_EQ(2, enc->get_segment_number());
+
+  // Resume with the nonce prefix read back from the header, as a crashed
+  // writer would read it from the partially written ciphertext.
+  const std::vector<uint8_t>& header = enc->get_header();
+  params.nonce_prefix = std::string(
+      reinterpret_cast<const char*>(header.data()) + 1 + params.salt.size(),
+      AesGcmHkdfStreamSegmentEncrypter::kNoncePrefixSizeInBytes);
+  params.segment_number = 2;
+  auto resumed =
+      std::move(AesGcmHkdfStreamSegmentEncrypter::New(params).ValueOrDie());
+  EXPECT_EQ(2, resumed->get_segment_number());
+  EXPECT_EQ(header, resumed->get_header());
+
+  // The resumed encrypter continues exactly where the original stands.
+  std::vector<uint8_t> ct_original;
+  std::vector<uint8_t> ct_resumed;
+  ASSERT_TRUE(enc->EncryptSegment(pt, true, &ct_original).ok());
+  ASSERT_TRUE(resumed->EncryptSegment(pt, true, &ct_resumed).ok());
+  EXPECT_EQ(ct_original, ct_resumed);
+}
+
+TEST(AesGcmHkdfStreamSegmentEncrypterTest, testEncryptSegmentInto) {
+  AesGcmHkdfStreamSegmentEncrypter::Params params;
+  params.key = Random::GetRandomKeyBytes(16);
+  params.salt = Random::GetRandomBytes(16);
+  params.ciphertext_offset = 0;
+  params.ciphertext_segment_size = 128;
+  auto enc =
+      std::move(AesGcmHkdfStreamSegmentEncrypter::New(params).ValueOrDie());
+
+  // A second encrypter with the same nonce prefix, so that both produce
+  // identical ciphertexts.
+  const std::vector<uint8_t>& header = enc->get_header();
+  params.nonce_prefix = std::string(
+      reinterpret_cast<const char*>(header.data()) + 1 + params.salt.size(),
+      AesGcmHkdfStreamSegmentEncrypter::kNoncePrefixSizeInBytes);
+  auto enc_into =
+      std::move(AesGcmHkdfStreamSegmentEncrypter::New(params).ValueOrDie());
+
+  std::vector<uint8_t> pt(enc->get_plaintext_segment_size(), 'p');
+  for (bool is_last_segment : {false, true}) {
+    std::vector<uint8_t> ct;
+    ASSERT_TRUE(enc->EncryptSegment(pt, is_last_segment, &ct).ok());
+
+    std::vector<uint8_t> ct_buffer(enc_into->get_ciphertext_segment_size());
+    auto result = enc_into->EncryptSegmentInto(
+        absl::MakeConstSpan(pt), is_last_segment, absl::MakeSpan(ct_buffer));
+    ASSERT_TRUE(result.ok()) << result.status();
+    ASSERT_EQ(ct.size(), static_cast<size_t>(result.ValueOrDie()));
+    ct_buffer.resize(result.ValueOrDie());
+    EXPECT_EQ(ct, ct_buffer);
+  }
+  EXPECT_EQ(enc->get_segment_number(), enc_into->get_segment_number());
+
+  // A buffer smaller than the ciphertext of the segment is rejected.
+  std::vector<uint8_t> small_buffer(pt.size());
+  auto result = enc_into->EncryptSegmentInto(
+      absl::MakeConstSpan(pt), /* is_last_segment = */ true,
+      absl::MakeSpan(small_buffer));
+  EXPECT_FALSE(result.ok());
+  EXPECT_EQ(util::error::INVALID_ARGUMENT, result.status().error_code());
+  EXPECT_PRED_FORMAT2(testing::IsSubstring, "too small",
+                      result.status().error_message());
+}
+
+TEST(AesGcmHkdfStreamSegmentEncrypterTest, testWrongResumptionParams) {
+  AesGcmHkdfStreamSegmentEncrypter::Params params;
+  params.key = Random::GetRandomKeyBytes(16);
+  params.salt = Random::GetRandomBytes(16);
+  params.ciphertext_offset = 0;
+  params.ciphertext_segment_size = 128;
+
+  params.nonce_prefix = "too long to be a nonce prefix";
+  auto result = AesGcmHkdfStreamSegmentEncrypter::New(params);
+  EXPECT_FALSE(result.ok());
+  EXPECT_EQ(util::error::INVALID_ARGUMENT, result.status().error_code());
+  EXPECT_THAT(result.status().error_message(), HasSubstr("nonce_prefix"));
+
+  params.nonce_prefix = "";
+  params.segment_number = -1;
+  result = AesGcmHkdfStreamSegmentEncrypter::New(params);
+  EXPECT_FALSE(result.ok());
+  EXPECT_EQ(util::error::INVALID_ARGUMENT, result.status().error_code());
+  EXPECT_THAT(result.status().error_message(),
+              HasSubstr("segment_number out of range"));
+}
+
 }  // namespace
 }  // namespace subtle
 }  // namespace tink
@@ -18,8 +18,10 @@
 
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/memory/memory.h"
+#include "absl/types/span.h"
 #include "tink/subtle/aes_gcm_hkdf_stream_segment_decrypter.h"
 #include "tink/subtle/aes_gcm_hkdf_stream_segment_encrypter.h"
 #include "tink/subtle/common_enums.h"
@@ -79,9 +81,45 @@ AesGcmHkdfStreaming::NewSegmentEncrypter(
   params.key = std::move(hkdf_result).ValueOrDie();
   params.ciphertext_offset = ciphertext_offset_;
   params.ciphertext_segment_size = ciphertext_segment_size_;
+  params.use_huge_page_buffers = use_huge_page_buffers_;
   return AesGcmHkdfStreamSegmentEncrypter::New(std::move(params));
 }
 
+util::StatusOr<std::vector<std::unique_ptr<StreamSegmentEncrypter>>>
+AesGcmHkdfStreaming::NewSegmentEncrypters(absl::string_view associated_data,
+                                          size_t count) const {
+  // One RNG call for all salts of the batch.
+  const std::string salts =
+      Random::GetRandomBytes(count * derived_key_size_);
+  std::vector<absl::string_view> salt_views;
+  salt_views.reserve(count);
+  for (size_t i = 0; i < count; i++) {
+    salt_views.push_back(absl::string_view(salts).substr(
+        i * derived_key_size_, derived_key_size_));
+  }
+  auto keys_result =
+      Hkdf::ComputeHkdfBatch(hkdf_hash_, ikm_, absl::MakeConstSpan(salt_views),
+                             associated_data, derived_key_size_);
+  if (!keys_result.ok()) return keys_result.status();
+  auto& keys = keys_result.ValueOrDie();
+
+  std::vector<std::unique_ptr<StreamSegmentEncrypter>> encrypters;
+  encrypters.reserve(count);
+  for (size_t i = 0; i < count; i++) {
+    AesGcmHkdfStreamSegmentEncrypter::Params params;
+    params.salt = std::string(salt_views[i]);
+    params.key = std::move(keys[i]);
+    params.ciphertext_offset = ciphertext_offset_;
+    params.ciphertext_segment_size = ciphertext_segment_size_;
+    params.use_huge_page_buffers = use_huge_page_buffers_;
+    auto encrypter_result =
+        AesGcmHkdfStreamSegmentEncrypter::New(std::move(params));
+    if (!encrypter_result.ok()) return encrypter_result.status();
+    encrypters.push_back(std::move(encrypter_result.ValueOrDie()));
+  }
+  return encrypters;
+}
+
 util::StatusOr<std::unique_ptr<StreamSegmentDecrypter>>
 AesGcmHkdfStreaming::NewSegmentDecrypter(
     absl::string_view associated_data) const {
@@ -92,6 +130,8 @@ AesGcmHkdfStreaming::NewSegmentDecrypter(
   params.ciphertext_offset = ciphertext_offset_;
   params.ciphertext_segment_size = ciphertext_segment_size_;
   params.associated_data = std::string(associated_data);
+  params.use_huge_page_buffers = use_huge_page_buffers_;
+  params.key_cache = decrypter_key_cache_;
   return AesGcmHkdfStreamSegmentDecrypter::New(std::move(params));
 }
 
@@ -19,10 +19,12 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "tink/internal/fips_utils.h"
 #include "tink/subtle/common_enums.h"
 #include "tink/subtle/nonce_based_streaming_aead.h"
+#include "tink/subtle/streaming_key_cache.h"
 #include "tink/util/secret_data.h"
 #include "tink/util/statusor.h"
 
@@ -38,11 +40,31 @@ class AesGcmHkdfStreaming : public NonceBasedStreamingAead {
     int derived_key_size;
     int ciphertext_segment_size;
     int ciphertext_offset;
+    // If true, the streams of this primitive allocate their segment-sized
+    // buffers in huge-page-backed memory (see
+    // tink/util/huge_page_allocator.h), which avoids TLB misses on large
+    // (e.g. 1MB) segments.
+    bool use_huge_page_buffers = false;
+    // Optional cache shared by the segment decrypters of this primitive:
+    // re-opening a previously opened stream then reuses its derived key and
+    // AEAD context instead of re-running HKDF and cipher setup. Worthwhile
+    // for workloads which open the same few encrypted files over and over;
+    // see StreamingKeyCache for the sharing and bounding rules.
+    std::shared_ptr<StreamingKeyCache> decrypter_key_cache;
   };
 
   static util::StatusOr<std::unique_ptr<AesGcmHkdfStreaming>> New(
       Params params);
 
+  // Creates segment encrypters for 'count' fresh streams at once, all bound
+  // to the same associated data. Equivalent to 'count' single streams, but
+  // generates all salts with one RNG call and derives all stream keys with
+  // a single HMAC context (the per-stream salt keys the HKDF-extract step,
+  // so extract state cannot be shared beyond that). Useful for workloads
+  // that open many encrypted streams per second.
+  util::StatusOr<std::vector<std::unique_ptr<StreamSegmentEncrypter>>>
+  NewSegmentEncrypters(absl::string_view associated_data, size_t count) const;
+
   static constexpr crypto::tink::internal::FipsCompatibility kFipsStatus =
       crypto::tink::internal::FipsCompatibility::kNotFips;
 
@@ -59,13 +81,17 @@ class AesGcmHkdfStreaming : public NonceBasedStreamingAead {
         hkdf_hash_(params.hkdf_hash),
         derived_key_size_(params.derived_key_size),
         ciphertext_segment_size_(params.ciphertext_segment_size),
-        ciphertext_offset_(params.ciphertext_offset) {}
+        ciphertext_offset_(params.ciphertext_offset),
+        use_huge_page_buffers_(params.use_huge_page_buffers),
+        decrypter_key_cache_(std::move(params.decrypter_key_cache)) {}
 
   const util::SecretData ikm_;
   const HashType hkdf_hash_;
   const int derived_key_size_;
   const int ciphertext_segment_size_;
   const int ciphertext_offset_;
+  const bool use_huge_page_buffers_;
+  const std::shared_ptr<StreamingKeyCache> decrypter_key_cache_;
 };
 
 }  // namespace subtle
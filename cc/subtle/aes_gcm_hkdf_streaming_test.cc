@@ -16,17 +16,21 @@
 
 #include "tink/subtle/aes_gcm_hkdf_streaming.h"
 
+#include <set>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "absl/memory/memory.h"
+#include "absl/strings/cord.h"
 #include "absl/strings/str_cat.h"
 #include "tink/config/tink_fips.h"
 #include "tink/output_stream.h"
 #include "tink/subtle/common_enums.h"
 #include "tink/subtle/random.h"
 #include "tink/subtle/streaming_aead_test_util.h"
+#include "tink/subtle/streaming_key_cache.h"
 #include "tink/subtle/test_util.h"
 #include "tink/util/istream_input_stream.h"
 #include "tink/util/ostream_output_stream.h"
@@ -95,6 +99,205 @@ TEST(AesGcmHkdfStreamingTest, testBasic) {
   }
 }
 
+TEST(AesGcmHkdfStreamingTest, testHugePageBuffers) {
+  if (IsFipsModeEnabled()) {
+    GTEST_SKIP() << "Not supported in FIPS-only mode";
+  }
+  // Large segments with huge-page-backed stream buffers; the ciphertext
+  // format is independent of the buffer allocation mode, so a regular
+  // reader can decrypt what a huge-page-buffered writer produced and vice
+  // versa.
+  AesGcmHkdfStreaming::Params params;
+  params.ikm = Random::GetRandomKeyBytes(32);
+  params.hkdf_hash = SHA256;
+  params.derived_key_size = 32;
+  params.ciphertext_segment_size = 1024 * 1024;
+  params.ciphertext_offset = 0;
+  params.use_huge_page_buffers = true;
+  auto huge_page_result = AesGcmHkdfStreaming::New(params);
+  ASSERT_THAT(huge_page_result.status(), IsOk());
+  auto huge_page_streaming_aead = std::move(huge_page_result.ValueOrDie());
+
+  params.use_huge_page_buffers = false;
+  auto regular_result = AesGcmHkdfStreaming::New(std::move(params));
+  ASSERT_THAT(regular_result.status(), IsOk());
+  auto regular_streaming_aead = std::move(regular_result.ValueOrDie());
+
+  std::string associated_data = "some associated data";
+  for (int pt_size : {0, 100, 3 * 1024 * 1024}) {
+    SCOPED_TRACE(absl::StrCat("pt_size = ", pt_size));
+    std::string pt = Random::GetRandomBytes(pt_size);
+    EXPECT_THAT(EncryptThenDecrypt(huge_page_streaming_aead.get(),
+                                   huge_page_streaming_aead.get(), pt,
+                                   associated_data, /* ct_offset = */ 0),
+                IsOk());
+    EXPECT_THAT(EncryptThenDecrypt(huge_page_streaming_aead.get(),
+                                   regular_streaming_aead.get(), pt,
+                                   associated_data, /* ct_offset = */ 0),
+                IsOk());
+    EXPECT_THAT(EncryptThenDecrypt(regular_streaming_aead.get(),
+                                   huge_page_streaming_aead.get(), pt,
+                                   associated_data, /* ct_offset = */ 0),
+                IsOk());
+  }
+}
+
+TEST(AesGcmHkdfStreamingTest, testDecrypterKeyCache) {
+  if (IsFipsModeEnabled()) {
+    GTEST_SKIP() << "Not supported in FIPS-only mode";
+  }
+  auto key_cache = std::make_shared<StreamingKeyCache>();
+  AesGcmHkdfStreaming::Params params;
+  params.ikm = Random::GetRandomKeyBytes(32);
+  params.hkdf_hash = SHA256;
+  params.derived_key_size = 32;
+  params.ciphertext_segment_size = 128;
+  params.ciphertext_offset = 0;
+  params.decrypter_key_cache = key_cache;
+  auto streaming_aead =
+      std::move(AesGcmHkdfStreaming::New(std::move(params)).ValueOrDie());
+
+  std::string associated_data = "some associated data";
+  std::string pt = Random::GetRandomBytes(1000);
+  absl::Cord pt_cord(pt);
+  auto ct_result = streaming_aead->EncryptCord(pt_cord, associated_data);
+  ASSERT_THAT(ct_result.status(), IsOk());
+  absl::Cord ct = ct_result.ValueOrDie();
+
+  // The first open of the stream derives the key and populates the cache;
+  // re-opens of the same ciphertext (same salt) hit it. Either way the
+  // plaintext must come back intact.
+  for (int open = 0; open < 3; open++) {
+    SCOPED_TRACE(absl::StrCat("open = ", open));
+    auto decrypted = streaming_aead->DecryptCord(ct, associated_data);
+    ASSERT_THAT(decrypted.status(), IsOk());
+    EXPECT_EQ(pt, std::string(decrypted.ValueOrDie()));
+  }
+  EXPECT_EQ(key_cache->size(), 1);
+  EXPECT_EQ(key_cache->hit_count(), 2);
+
+  // A second stream brings its own salt and gets its own cache entry.
+  auto ct2_result = streaming_aead->EncryptCord(pt_cord, associated_data);
+  ASSERT_THAT(ct2_result.status(), IsOk());
+  auto decrypted = streaming_aead->DecryptCord(ct2_result.ValueOrDie(),
+                                               associated_data);
+  ASSERT_THAT(decrypted.status(), IsOk());
+  EXPECT_EQ(pt, std::string(decrypted.ValueOrDie()));
+  EXPECT_EQ(key_cache->size(), 2);
+}
+
+TEST(AesGcmHkdfStreamingTest, testExpectedCiphertextHeaderSize) {
+  if (IsFipsModeEnabled()) {
+    GTEST_SKIP() << "Not supported in FIPS-only mode";
+  }
+  for (int derived_key_size : {16, 32}) {
+    SCOPED_TRACE(absl::StrCat("derived_key_size = ", derived_key_size));
+    AesGcmHkdfStreaming::Params params;
+    params.ikm = Random::GetRandomKeyBytes(derived_key_size);
+    params.hkdf_hash = SHA256;
+    params.derived_key_size = derived_key_size;
+    params.ciphertext_segment_size = 128;
+    params.ciphertext_offset = 0;
+    auto result = AesGcmHkdfStreaming::New(std::move(params));
+    EXPECT_TRUE(result.ok()) << result.status();
+    // header_size (1 byte) || salt (derived_key_size) || nonce_prefix (7).
+    EXPECT_EQ(1 + derived_key_size + 7,
+              result.ValueOrDie()->ExpectedCiphertextHeaderSize());
+  }
+}
+
+TEST(AesGcmHkdfStreamingTest, testValidateCiphertext) {
+  if (IsFipsModeEnabled()) {
+    GTEST_SKIP() << "Not supported in FIPS-only mode";
+  }
+  AesGcmHkdfStreaming::Params params;
+  params.ikm = Random::GetRandomKeyBytes(32);
+  params.hkdf_hash = SHA256;
+  params.derived_key_size = 32;
+  params.ciphertext_segment_size = 128;
+  params.ciphertext_offset = 0;
+  auto streaming_aead =
+      std::move(AesGcmHkdfStreaming::New(std::move(params)).ValueOrDie());
+
+  std::string associated_data = "some associated data";
+  std::string pt = Random::GetRandomBytes(1000);
+  absl::Cord pt_cord(pt);
+  auto ct_result = streaming_aead->EncryptCord(pt_cord, associated_data);
+  ASSERT_THAT(ct_result.status(), IsOk());
+  std::string ct(ct_result.ValueOrDie());
+
+  auto as_input_stream = [](const std::string& contents) {
+    return std::unique_ptr<InputStream>(
+        absl::make_unique<util::IstreamInputStream>(
+            absl::make_unique<std::istringstream>(contents)));
+  };
+
+  // An intact ciphertext validates.
+  EXPECT_THAT(streaming_aead->ValidateCiphertext(as_input_stream(ct),
+                                                 associated_data),
+              IsOk());
+
+  // A flipped bit in any segment is detected.
+  for (size_t position : {ct.size() / 2, ct.size() - 1}) {
+    std::string corrupt_ct = ct;
+    corrupt_ct[position] ^= 1;
+    EXPECT_FALSE(streaming_aead
+                     ->ValidateCiphertext(as_input_stream(corrupt_ct),
+                                          associated_data)
+                     .ok());
+  }
+
+  // Truncation (a missing last segment) is detected.
+  EXPECT_FALSE(streaming_aead
+                   ->ValidateCiphertext(
+                       as_input_stream(ct.substr(0, ct.size() - 20)),
+                       associated_data)
+                   .ok());
+
+  // Wrong associated data is detected.
+  EXPECT_FALSE(streaming_aead
+                   ->ValidateCiphertext(as_input_stream(ct), "wrong aad")
+                   .ok());
+}
+
+TEST(AesGcmHkdfStreamingTest, testNewSegmentEncryptersBatch) {
+  if (IsFipsModeEnabled()) {
+    GTEST_SKIP() << "Not supported in FIPS-only mode";
+  }
+  const int derived_key_size = 32;
+  AesGcmHkdfStreaming::Params params;
+  params.ikm = Random::GetRandomKeyBytes(derived_key_size);
+  params.hkdf_hash = SHA256;
+  params.derived_key_size = derived_key_size;
+  params.ciphertext_segment_size = 128;
+  params.ciphertext_offset = 0;
+  auto result = AesGcmHkdfStreaming::New(std::move(params));
+  ASSERT_TRUE(result.ok()) << result.status();
+
+  const size_t kCount = 5;
+  auto encrypters_result =
+      result.ValueOrDie()->NewSegmentEncrypters("associated data", kCount);
+  ASSERT_THAT(encrypters_result.status(), IsOk());
+  auto& encrypters = encrypters_result.ValueOrDie();
+  ASSERT_EQ(kCount, encrypters.size());
+
+  std::set<std::string> headers;
+  for (auto& encrypter : encrypters) {
+    const std::vector<uint8_t>& header = encrypter->get_header();
+    // header_size (1 byte) || salt (derived_key_size) || nonce_prefix (7).
+    EXPECT_EQ(1 + derived_key_size + 7, header.size());
+    headers.insert(std::string(header.begin(), header.end()));
+
+    std::vector<uint8_t> pt(42, 'p');
+    std::vector<uint8_t> ct;
+    EXPECT_THAT(encrypter->EncryptSegment(pt, /* is_last_segment = */ true,
+                                          &ct),
+                IsOk());
+  }
+  // Every stream of the batch must get its own salt.
+  EXPECT_EQ(kCount, headers.size());
+}
+
 TEST(AesGcmHkdfStreamingTest, testIkmSmallerThanDerivedKey) {
   if (IsFipsModeEnabled()) {
     GTEST_SKIP() << "Not supported in FIPS-only mode";
@@ -16,6 +16,7 @@
 
 #include "tink/subtle/aes_gcm_siv_boringssl.h"
 
+#include <cstring>
 #include <string>
 #include <vector>
 
@@ -23,6 +24,8 @@
 #include "openssl/aead.h"
 #include "tink/subtle/random.h"
 #include "tink/subtle/subtle_util.h"
+#include "tink/subtle/subtle_util_boringssl.h"
+#include "tink/util/errors.h"
 #include "tink/util/status.h"
 
 namespace crypto {
@@ -81,6 +84,69 @@ util::StatusOr<std::string> AesGcmSivBoringSsl::Encrypt(
   return ciphertext;
 }
 
+util::StatusOr<size_t> AesGcmSivBoringSsl::EncryptInto(
+    absl::string_view plaintext, absl::string_view additional_data,
+    absl::Span<char> out) const {
+  if (out.size() < kIvSizeInBytes + plaintext.size() + kTagSizeInBytes) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "Output buffer too small");
+  }
+  // Writing the IV into 'out' does not clobber the plaintext in the
+  // supported in-place layout, where the plaintext starts at
+  // out.data() + kIvSizeInBytes.
+  Random::GetRandomBytes(out.subspan(0, kIvSizeInBytes));
+  size_t len;
+  if (EVP_AEAD_CTX_seal(
+          ctx_.get(), reinterpret_cast<uint8_t*>(out.data() + kIvSizeInBytes),
+          &len, plaintext.size() + kTagSizeInBytes,
+          reinterpret_cast<const uint8_t*>(out.data()), kIvSizeInBytes,
+          reinterpret_cast<const uint8_t*>(plaintext.data()), plaintext.size(),
+          reinterpret_cast<const uint8_t*>(additional_data.data()),
+          additional_data.size()) != 1) {
+    return util::Status(util::error::INTERNAL, "Encryption failed");
+  }
+  return kIvSizeInBytes + len;
+}
+
+util::Status AesGcmSivBoringSsl::EncryptBatch(
+    absl::Span<const absl::string_view> plaintexts,
+    absl::string_view additional_data, absl::Span<const absl::Span<char>> outs,
+    absl::Span<size_t> ciphertext_sizes) const {
+  if (plaintexts.size() != outs.size() ||
+      plaintexts.size() != ciphertext_sizes.size()) {
+    return util::Status(
+        util::error::INVALID_ARGUMENT,
+        "plaintexts, outs and ciphertext_sizes must have the same length.");
+  }
+  for (size_t i = 0; i < plaintexts.size(); i++) {
+    if (outs[i].size() <
+        kIvSizeInBytes + plaintexts[i].size() + kTagSizeInBytes) {
+      return util::Status(util::error::INVALID_ARGUMENT,
+                          "Output buffer too small");
+    }
+  }
+  // One RNG call for all IVs of the batch.
+  const std::string ivs =
+      Random::GetRandomBytes(plaintexts.size() * kIvSizeInBytes);
+  for (size_t i = 0; i < plaintexts.size(); i++) {
+    std::memcpy(outs[i].data(), &ivs[i * kIvSizeInBytes], kIvSizeInBytes);
+    size_t len;
+    if (EVP_AEAD_CTX_seal(
+            ctx_.get(),
+            reinterpret_cast<uint8_t*>(outs[i].data() + kIvSizeInBytes), &len,
+            plaintexts[i].size() + kTagSizeInBytes,
+            reinterpret_cast<const uint8_t*>(outs[i].data()), kIvSizeInBytes,
+            reinterpret_cast<const uint8_t*>(plaintexts[i].data()),
+            plaintexts[i].size(),
+            reinterpret_cast<const uint8_t*>(additional_data.data()),
+            additional_data.size()) != 1) {
+      return util::Status(util::error::INTERNAL, "Encryption failed");
+    }
+    ciphertext_sizes[i] = kIvSizeInBytes + len;
+  }
+  return util::Status::OK;
+}
+
 util::StatusOr<std::string> AesGcmSivBoringSsl::Decrypt(
     absl::string_view ciphertext, absl::string_view additional_data) const {
   if (ciphertext.size() < kIvSizeInBytes + kTagSizeInBytes) {
@@ -91,6 +157,7 @@ util::StatusOr<std::string> AesGcmSivBoringSsl::Decrypt(
   ResizeStringUninitialized(
       &plaintext, ciphertext.size() - kIvSizeInBytes - kTagSizeInBytes);
   size_t len;
+  ErrorQueueMark error_queue_mark;
   if (EVP_AEAD_CTX_open(
           ctx_.get(), reinterpret_cast<uint8_t*>(&plaintext[0]), &len,
           plaintext.size(),
@@ -101,7 +168,7 @@ util::StatusOr<std::string> AesGcmSivBoringSsl::Decrypt(
           ciphertext.size() - kIvSizeInBytes,
           reinterpret_cast<const uint8_t*>(additional_data.data()),
           additional_data.size()) != 1) {
-    return util::Status(util::error::INTERNAL, "Authentication failed");
+    return AuthenticationFailedStatus();
   }
   if (len != plaintext.size()) {
     return util::Status(util::error::INTERNAL, "incorrect ciphertext size");
@@ -61,6 +61,27 @@ class AesGcmSivBoringSsl : public Aead {
       absl::string_view ciphertext,
       absl::string_view additional_data) const override;
 
+  size_t MaxEncryptionSize(size_t plaintext_size) const override {
+    return kIvSizeInBytes + plaintext_size + kTagSizeInBytes;
+  }
+
+  // Writes IV, ciphertext and tag directly into 'out' without intermediate
+  // allocations. Supports in-place encryption: 'plaintext' may overlap 'out'
+  // if plaintext.data() == out.data() + kIvSizeInBytes, i.e. if the plaintext
+  // already sits where the ciphertext will be written.
+  crypto::tink::util::StatusOr<size_t> EncryptInto(
+      absl::string_view plaintext, absl::string_view additional_data,
+      absl::Span<char> out) const override;
+
+  // Draws the IVs for the whole batch with a single RNG call and reuses the
+  // EVP_AEAD context across all entries; the per-nonce record-key derivation
+  // of GCM-SIV still happens inside each seal operation.
+  crypto::tink::util::Status EncryptBatch(
+      absl::Span<const absl::string_view> plaintexts,
+      absl::string_view additional_data,
+      absl::Span<const absl::Span<char>> outs,
+      absl::Span<size_t> ciphertext_sizes) const override;
+
   static constexpr crypto::tink::internal::FipsCompatibility kFipsStatus =
       crypto::tink::internal::FipsCompatibility::kNotFips;
 
@@ -16,11 +16,13 @@
 
 #include "tink/subtle/aes_gcm_siv_boringssl.h"
 
+#include <cstring>
 #include <string>
 #include <vector>
 
 #include "gtest/gtest.h"
 #include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
 #include "openssl/err.h"
 #include "include/rapidjson/document.h"
 #include "tink/config/tink_fips.h"
@@ -62,6 +64,89 @@ TEST(AesGcmSivBoringSslTest, Basic) {
   EXPECT_EQ(pt.ValueOrDie(), message);
 }
 
+TEST(AesGcmSivBoringSslTest, EncryptInto) {
+  if (IsFipsModeEnabled()) {
+    GTEST_SKIP() << "Not supported in FIPS-only mode";
+  }
+
+  util::SecretData key = util::SecretDataFromStringView(
+      test::HexDecodeOrDie("000102030405060708090a0b0c0d0e0f"));
+  auto cipher = std::move(AesGcmSivBoringSsl::New(key).ValueOrDie());
+  std::string message = "Some data to encrypt.";
+  std::string aad = "Some data to authenticate.";
+
+  std::string buffer;
+  buffer.resize(cipher->MaxEncryptionSize(message.size()));
+  EXPECT_EQ(buffer.size(), message.size() + 12 + 16);
+  auto written = cipher->EncryptInto(
+      message, aad, absl::MakeSpan(&buffer[0], buffer.size()));
+  EXPECT_TRUE(written.ok()) << written.status();
+  EXPECT_EQ(written.ValueOrDie(), buffer.size());
+  auto pt = cipher->Decrypt(buffer, aad);
+  EXPECT_TRUE(pt.ok()) << pt.status();
+  EXPECT_EQ(pt.ValueOrDie(), message);
+
+  // A buffer that is too small is rejected.
+  auto too_small = cipher->EncryptInto(
+      message, aad, absl::MakeSpan(&buffer[0], message.size()));
+  EXPECT_THAT(too_small.status(), StatusIs(util::error::INVALID_ARGUMENT));
+
+  // In-place: the plaintext sits where the ciphertext will be written.
+  std::string in_place_buffer;
+  in_place_buffer.resize(cipher->MaxEncryptionSize(message.size()));
+  std::memcpy(&in_place_buffer[12], message.data(), message.size());
+  auto in_place_written = cipher->EncryptInto(
+      absl::string_view(in_place_buffer).substr(12, message.size()), aad,
+      absl::MakeSpan(&in_place_buffer[0], in_place_buffer.size()));
+  EXPECT_TRUE(in_place_written.ok()) << in_place_written.status();
+  auto in_place_pt = cipher->Decrypt(in_place_buffer, aad);
+  EXPECT_TRUE(in_place_pt.ok()) << in_place_pt.status();
+  EXPECT_EQ(in_place_pt.ValueOrDie(), message);
+}
+
+TEST(AesGcmSivBoringSslTest, EncryptBatch) {
+  if (IsFipsModeEnabled()) {
+    GTEST_SKIP() << "Not supported in FIPS-only mode";
+  }
+
+  util::SecretData key = util::SecretDataFromStringView(
+      test::HexDecodeOrDie("000102030405060708090a0b0c0d0e0f"));
+  auto cipher = std::move(AesGcmSivBoringSsl::New(key).ValueOrDie());
+  std::string aad = "Some data to authenticate.";
+
+  std::vector<std::string> messages = {"first chunk", "", "a third chunk"};
+  std::vector<absl::string_view> plaintexts(messages.begin(), messages.end());
+  std::vector<std::string> buffers(messages.size());
+  std::vector<absl::Span<char>> outs;
+  for (size_t i = 0; i < messages.size(); i++) {
+    buffers[i].resize(cipher->MaxEncryptionSize(messages[i].size()));
+    outs.push_back(absl::MakeSpan(&buffers[i][0], buffers[i].size()));
+  }
+  std::vector<size_t> ciphertext_sizes(messages.size());
+
+  auto status = cipher->EncryptBatch(absl::MakeConstSpan(plaintexts), aad,
+                                     absl::MakeConstSpan(outs),
+                                     absl::MakeSpan(ciphertext_sizes));
+  EXPECT_TRUE(status.ok()) << status;
+  for (size_t i = 0; i < messages.size(); i++) {
+    EXPECT_EQ(ciphertext_sizes[i], messages[i].size() + 12 + 16);
+    auto pt = cipher->Decrypt(
+        absl::string_view(buffers[i]).substr(0, ciphertext_sizes[i]), aad);
+    EXPECT_TRUE(pt.ok()) << pt.status();
+    EXPECT_EQ(pt.ValueOrDie(), messages[i]);
+  }
+
+  // IVs within a batch must be distinct.
+  EXPECT_NE(buffers[0].substr(0, 12), buffers[1].substr(0, 12));
+
+  // Mismatched span lengths are rejected.
+  std::vector<size_t> short_sizes(messages.size() - 1);
+  auto mismatch = cipher->EncryptBatch(absl::MakeConstSpan(plaintexts), aad,
+                                       absl::MakeConstSpan(outs),
+                                       absl::MakeSpan(short_sizes));
+  EXPECT_THAT(mismatch, StatusIs(util::error::INVALID_ARGUMENT));
+}
+
 TEST(AesGcmSivBoringSslTest, Sizes) {
   if (IsFipsModeEnabled()) {
     GTEST_SKIP() << "Not supported in FIPS-only mode";
@@ -23,6 +23,7 @@
 #include "openssl/aes.h"
 #include "openssl/mem.h"
 #include "tink/deterministic_aead.h"
+#include "tink/subtle/subtle_util.h"
 #include "tink/util/errors.h"
 #include "tink/util/status.h"
 #include "tink/util/statusor.h"
@@ -79,6 +80,13 @@ util::SecretData AesSivBoringSsl::ComputeCmacK2() const {
   return cmac_k2;
 }
 
+util::SecretData AesSivBoringSsl::ComputeS2vZeroCmac() const {
+  util::SecretData zero_cmac(kBlockSize, 0);
+  Cmac(absl::MakeSpan(zero_cmac.data(), kBlockSize), zero_cmac.data());
+  MultiplyByX(zero_cmac.data());
+  return zero_cmac;
+}
+
 void AesSivBoringSsl::CtrCrypt(const uint8_t siv[kBlockSize],
                                absl::Span<const uint8_t> in,
                                uint8_t* out) const {
@@ -175,19 +183,30 @@ void AesSivBoringSsl::CmacLong(absl::Span<const uint8_t> data,
 void AesSivBoringSsl::S2v(absl::Span<const uint8_t> aad,
                           absl::Span<const uint8_t> msg,
                           uint8_t siv[kBlockSize]) const {
-  // This stuff could be precomputed.
-  uint8_t block[kBlockSize];
-  std::fill(std::begin(block), std::end(block), 0);
-  Cmac(block, block);
-  MultiplyByX(block);
+  uint8_t chain[kBlockSize];
+  S2vStart(aad, chain);
+  S2vFinish(chain, msg, siv);
+}
+
+void AesSivBoringSsl::S2vStart(absl::Span<const uint8_t> aad,
+                               uint8_t chain[kBlockSize]) const {
+  // dbl(CMAC(0^128)) does not depend on the inputs and is precomputed once
+  // in the constructor.
+  std::copy_n(s2v_zero_cmac_.data(), kBlockSize, chain);
 
   uint8_t aad_mac[kBlockSize];
   Cmac(aad, aad_mac);
-  XorBlock(block, aad_mac, block);
+  XorBlock(chain, aad_mac, chain);
+}
 
+void AesSivBoringSsl::S2vFinish(const uint8_t chain[kBlockSize],
+                                absl::Span<const uint8_t> msg,
+                                uint8_t siv[kBlockSize]) const {
   if (msg.size() >= kBlockSize) {
-    CmacLong(msg, block, siv);
+    CmacLong(msg, chain, siv);
   } else {
+    uint8_t block[kBlockSize];
+    std::copy_n(chain, kBlockSize, block);
     MultiplyByX(block);
     for (size_t i = 0; i < msg.size(); ++i) {
       block[i] ^= msg[i];
@@ -199,20 +218,83 @@ void AesSivBoringSsl::S2v(absl::Span<const uint8_t> aad,
 
 util::StatusOr<std::string> AesSivBoringSsl::EncryptDeterministically(
     absl::string_view plaintext, absl::string_view additional_data) const {
+  // A single allocation: SIV and ciphertext are written directly into the
+  // returned string.
+  std::string ciphertext;
+  ResizeStringUninitialized(&ciphertext, kBlockSize + plaintext.size());
+  auto written = EncryptDeterministicallyInto(
+      plaintext, additional_data,
+      absl::MakeSpan(&ciphertext[0], ciphertext.size()));
+  if (!written.ok()) {
+    return written.status();
+  }
+  return ciphertext;
+}
+
+util::StatusOr<size_t> AesSivBoringSsl::EncryptDeterministicallyInto(
+    absl::string_view plaintext, absl::string_view additional_data,
+    absl::Span<char> out) const {
+  if (out.size() < kBlockSize + plaintext.size()) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "Output buffer too small");
+  }
   uint8_t siv[kBlockSize];
   S2v(absl::MakeSpan(reinterpret_cast<const uint8_t*>(additional_data.data()),
                      additional_data.size()),
       absl::MakeSpan(reinterpret_cast<const uint8_t*>(plaintext.data()),
                      plaintext.size()),
       siv);
-  size_t ciphertext_size = plaintext.size() + kBlockSize;
-  std::vector<uint8_t> ct(ciphertext_size);
-  std::copy(std::begin(siv), std::end(siv), ct.begin());
+  std::copy(std::begin(siv), std::end(siv),
+            reinterpret_cast<uint8_t*>(out.data()));
   CtrCrypt(siv,
            absl::MakeSpan(reinterpret_cast<const uint8_t*>(plaintext.data()),
                           plaintext.size()),
-           ct.data() + kBlockSize);
-  return std::string(reinterpret_cast<const char*>(ct.data()), ciphertext_size);
+           reinterpret_cast<uint8_t*>(out.data()) + kBlockSize);
+  return kBlockSize + plaintext.size();
+}
+
+util::StatusOr<size_t> AesSivBoringSsl::EncryptDeterministicallyBatch(
+    absl::Span<const absl::string_view> plaintexts,
+    absl::string_view additional_data, absl::Span<char> out,
+    absl::Span<size_t> ciphertext_sizes) const {
+  if (ciphertext_sizes.size() < plaintexts.size()) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "ciphertext_sizes buffer too small");
+  }
+  size_t required = 0;
+  for (absl::string_view plaintext : plaintexts) {
+    required += kBlockSize + plaintext.size();
+  }
+  if (out.size() < required) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "Output buffer too small");
+  }
+  // The additional data is shared by the whole column, so its S2V chaining
+  // value is computed once; each value then only pays for its message CMAC
+  // and CTR pass. The ciphertexts are written back to back into 'out'.
+  uint8_t chain[kBlockSize];
+  S2vStart(absl::MakeSpan(
+               reinterpret_cast<const uint8_t*>(additional_data.data()),
+               additional_data.size()),
+           chain);
+  size_t written = 0;
+  for (size_t i = 0; i < plaintexts.size(); ++i) {
+    absl::string_view plaintext = plaintexts[i];
+    uint8_t* ciphertext = reinterpret_cast<uint8_t*>(out.data()) + written;
+    uint8_t siv[kBlockSize];
+    S2vFinish(chain,
+              absl::MakeSpan(reinterpret_cast<const uint8_t*>(plaintext.data()),
+                             plaintext.size()),
+              siv);
+    std::copy(std::begin(siv), std::end(siv), ciphertext);
+    CtrCrypt(siv,
+             absl::MakeSpan(reinterpret_cast<const uint8_t*>(plaintext.data()),
+                            plaintext.size()),
+             ciphertext + kBlockSize);
+    ciphertext_sizes[i] = kBlockSize + plaintext.size();
+    written += ciphertext_sizes[i];
+  }
+  return written;
 }
 
 util::StatusOr<std::string> AesSivBoringSsl::DecryptDeterministically(
@@ -67,6 +67,25 @@ class AesSivBoringSsl : public DeterministicAead {
       absl::string_view ciphertext,
       absl::string_view additional_data) const override;
 
+  size_t MaxEncryptionSize(size_t plaintext_size) const override {
+    return kBlockSize + plaintext_size;
+  }
+
+  // Writes SIV and ciphertext directly into 'out' without intermediate
+  // allocations. 'plaintext' must not overlap 'out'.
+  crypto::tink::util::StatusOr<size_t> EncryptDeterministicallyInto(
+      absl::string_view plaintext, absl::string_view additional_data,
+      absl::Span<char> out) const override;
+
+  // Encrypts a whole column of values sharing one additional-data string.
+  // The S2V chaining value after absorbing the additional data is computed
+  // once and reused for every value, so per-value work is reduced to the
+  // message CMAC and the CTR pass.
+  crypto::tink::util::StatusOr<size_t> EncryptDeterministicallyBatch(
+      absl::Span<const absl::string_view> plaintexts,
+      absl::string_view additional_data, absl::Span<char> out,
+      absl::Span<size_t> ciphertext_sizes) const override;
+
   static bool IsValidKeySizeInBytes(size_t size) {
     return size == 64;
   }
@@ -82,12 +101,16 @@ class AesSivBoringSsl : public DeterministicAead {
       : k1_(std::move(k1)),
         k2_(std::move(k2)),
         cmac_k1_(ComputeCmacK1()),
-        cmac_k2_(ComputeCmacK2()) {}
+        cmac_k2_(ComputeCmacK2()),
+        s2v_zero_cmac_(ComputeS2vZeroCmac()) {}
 
   // Precomputes cmac_k1
   util::SecretData ComputeCmacK1() const;
   // Precomputes cmac_k2
   util::SecretData ComputeCmacK2() const;
+  // Precomputes dbl(CMAC(0^128)), the first chaining value of S2V
+  // (RFC 5297, Section 2.4), which does not depend on the message.
+  util::SecretData ComputeS2vZeroCmac() const;
 
   // Encrypts (or decrypts) the bytes in in using an SIV and
   // writes the result to out.
@@ -120,10 +143,23 @@ class AesSivBoringSsl : public DeterministicAead {
   void S2v(absl::Span<const uint8_t> aad, absl::Span<const uint8_t> msg,
            uint8_t siv[kBlockSize]) const;
 
+  // Computes the S2V chaining value after absorbing 'aad' (RFC 5297,
+  // Section 2.4). It depends only on the additional data, so batch
+  // encryption computes it once per column.
+  void S2vStart(absl::Span<const uint8_t> aad,
+                uint8_t chain[kBlockSize]) const;
+
+  // Completes S2V for 'msg', starting from the chaining value produced by
+  // S2vStart(); 'chain' is left unmodified.
+  void S2vFinish(const uint8_t chain[kBlockSize],
+                 absl::Span<const uint8_t> msg,
+                 uint8_t siv[kBlockSize]) const;
+
   const util::SecretUniquePtr<AES_KEY> k1_;
   const util::SecretUniquePtr<AES_KEY> k2_;
   const util::SecretData cmac_k1_;
   const util::SecretData cmac_k2_;
+  const util::SecretData s2v_zero_cmac_;
 };
 
 }  // namespace subtle
@@ -20,6 +20,8 @@
 #include <vector>
 
 #include "gtest/gtest.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "tink/config/tink_fips.h"
 #include "tink/subtle/wycheproof_util.h"
 #include "tink/util/secret_data.h"
@@ -70,6 +72,98 @@ TEST(AesSivBoringSslTest, testEncryptDecrypt) {
   EXPECT_EQ(pt.ValueOrDie(), message);
 }
 
+TEST(AesSivBoringSslTest, testEncryptDeterministicallyInto) {
+  if (IsFipsModeEnabled()) {
+    GTEST_SKIP() << "Not supported in FIPS-only mode";
+  }
+  util::SecretData key = util::SecretDataFromStringView(test::HexDecodeOrDie(
+      "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"
+      "00112233445566778899aabbccddeefff0f1f2f3f4f5f6f7f8f9fafbfcfdfeff"));
+  auto cipher = std::move(AesSivBoringSsl::New(key).ValueOrDie());
+  std::string aad = "Additional data";
+  std::string message = "Some data to encrypt.";
+
+  std::string buffer;
+  buffer.resize(cipher->MaxEncryptionSize(message.size()));
+  EXPECT_EQ(buffer.size(), message.size() + 16);
+  auto written = cipher->EncryptDeterministicallyInto(
+      message, aad, absl::MakeSpan(&buffer[0], buffer.size()));
+  EXPECT_TRUE(written.ok()) << written.status();
+  EXPECT_EQ(written.ValueOrDie(), buffer.size());
+
+  // Deterministic: the buffer matches the allocating API byte for byte.
+  auto ct = cipher->EncryptDeterministically(message, aad);
+  EXPECT_TRUE(ct.ok()) << ct.status();
+  EXPECT_EQ(buffer, ct.ValueOrDie());
+
+  auto pt = cipher->DecryptDeterministically(buffer, aad);
+  EXPECT_TRUE(pt.ok()) << pt.status();
+  EXPECT_EQ(pt.ValueOrDie(), message);
+
+  // A buffer that is too small is rejected.
+  auto too_small = cipher->EncryptDeterministicallyInto(
+      message, aad, absl::MakeSpan(&buffer[0], message.size()));
+  EXPECT_THAT(too_small.status(), StatusIs(util::error::INVALID_ARGUMENT));
+}
+
+TEST(AesSivBoringSslTest, testEncryptDeterministicallyBatch) {
+  if (IsFipsModeEnabled()) {
+    GTEST_SKIP() << "Not supported in FIPS-only mode";
+  }
+  util::SecretData key = util::SecretDataFromStringView(test::HexDecodeOrDie(
+      "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"
+      "00112233445566778899aabbccddeefff0f1f2f3f4f5f6f7f8f9fafbfcfdfeff"));
+  auto cipher = std::move(AesSivBoringSsl::New(key).ValueOrDie());
+  std::string aad = "Additional data";
+
+  // A mix of sizes around the block size, including empty and the
+  // 16-byte join-key case.
+  std::vector<std::string> values = {"", "short", "sixteen bytes..!",
+                                     "value longer than a single block",
+                                     "x"};
+  std::vector<absl::string_view> plaintexts(values.begin(), values.end());
+  size_t buffer_size = 0;
+  for (const std::string& value : values) {
+    buffer_size += cipher->MaxEncryptionSize(value.size());
+  }
+  std::string buffer(buffer_size, '\0');
+  std::vector<size_t> ciphertext_sizes(plaintexts.size());
+
+  auto written = cipher->EncryptDeterministicallyBatch(
+      absl::MakeSpan(plaintexts), aad,
+      absl::MakeSpan(&buffer[0], buffer.size()),
+      absl::MakeSpan(ciphertext_sizes));
+  EXPECT_TRUE(written.ok()) << written.status();
+  EXPECT_EQ(written.ValueOrDie(), buffer.size());
+
+  // Deterministic: every slice matches the single-value API byte for byte.
+  size_t offset = 0;
+  for (size_t i = 0; i < values.size(); ++i) {
+    EXPECT_EQ(ciphertext_sizes[i], values[i].size() + 16);
+    absl::string_view slice =
+        absl::string_view(buffer).substr(offset, ciphertext_sizes[i]);
+    auto ct = cipher->EncryptDeterministically(values[i], aad);
+    EXPECT_TRUE(ct.ok()) << ct.status();
+    EXPECT_EQ(slice, ct.ValueOrDie());
+    auto pt = cipher->DecryptDeterministically(slice, aad);
+    EXPECT_TRUE(pt.ok()) << pt.status();
+    EXPECT_EQ(pt.ValueOrDie(), values[i]);
+    offset += ciphertext_sizes[i];
+  }
+
+  // Undersized output and offsets buffers are rejected.
+  auto too_small = cipher->EncryptDeterministicallyBatch(
+      absl::MakeSpan(plaintexts), aad,
+      absl::MakeSpan(&buffer[0], buffer.size() - 1),
+      absl::MakeSpan(ciphertext_sizes));
+  EXPECT_THAT(too_small.status(), StatusIs(util::error::INVALID_ARGUMENT));
+  auto too_few = cipher->EncryptDeterministicallyBatch(
+      absl::MakeSpan(plaintexts), aad,
+      absl::MakeSpan(&buffer[0], buffer.size()),
+      absl::MakeSpan(ciphertext_sizes).subspan(1));
+  EXPECT_THAT(too_few.status(), StatusIs(util::error::INVALID_ARGUMENT));
+}
+
 TEST(AesSivBoringSslTest, testNullPtrStringView) {
   if (IsFipsModeEnabled()) {
     GTEST_SKIP() << "Not supported in FIPS-only mode";
@@ -0,0 +1,234 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/subtle/base64_url.h"
+
+#include <cstdint>
+#include <string>
+
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
+
+#include "tink/subtle/subtle_util.h"
+
+namespace crypto {
+namespace tink {
+namespace subtle {
+
+namespace {
+
+const char kEncodeTable[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+// Maps a base64url character to its 6-bit value; -1 marks characters
+// outside the alphabet.
+const int8_t kDecodeTable[256] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1,
+    52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,
+    -1,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
+    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, 63,
+    -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+    41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+};
+
+#ifdef __SSSE3__
+
+// Splits 12 input bytes (in the low bytes of 'in') into 16 bytes holding
+// one 6-bit value each, see https://arxiv.org/abs/1704.00605.
+inline __m128i EncodeReshuffle(__m128i in) {
+  in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3,
+                                         4, 1, 2, 0, 1));
+  const __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+  const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+  const __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+  const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+  return _mm_or_si128(t1, t3);
+}
+
+// Maps 16 6-bit values to their base64url characters.
+inline __m128i EncodeTranslate(__m128i in) {
+  // Offsets added to a 6-bit value, selected by its range: 0..25 -> 'A',
+  // 26..51 -> 'a'-26, 52..61 -> '0'-52, 62 -> '-'-62, 63 -> '_'-63.
+  const __m128i lut = _mm_setr_epi8(65, 71, -4, -4, -4, -4, -4, -4, -4, -4,
+                                    -4, -4, -17, 32, 0, 0);
+  __m128i indices = _mm_subs_epu8(in, _mm_set1_epi8(51));
+  const __m128i mask = _mm_cmpgt_epi8(in, _mm_set1_epi8(25));
+  indices = _mm_sub_epi8(indices, mask);
+  return _mm_add_epi8(in, _mm_shuffle_epi8(lut, indices));
+}
+
+// Decodes 16 base64url characters into 12 bytes (in the low bytes of
+// '*out'). Returns false if any character is outside the alphabet.
+// Validation classifies each byte by its nibbles: the low-nibble table
+// holds the classes a low nibble is invalid for, the high-nibble table
+// the class of the high nibble; a byte is valid iff the bitwise AND of
+// its two table entries is zero.
+inline bool DecodeBlock(__m128i in, __m128i* out) {
+  const __m128i lut_lo =
+      _mm_setr_epi8(0x19, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18,
+                    0x18, 0x1C, 0x3E, 0x3E, 0x36, 0x3E, 0x3C);
+  const __m128i lut_hi =
+      _mm_setr_epi8(0x10, 0x10, 0x08, 0x04, 0x01, 0x02, 0x01, 0x20, 0x10,
+                    0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+  // Offset from a character to its 6-bit value, by high nibble; '_' is
+  // special-cased below as it shares the high nibble with 'P'..'Z'.
+  const __m128i lut_roll = _mm_setr_epi8(0, 0, 17, 4, -65, -65, -71, -71, 0,
+                                         0, 0, 0, 0, 0, 0, 0);
+  const __m128i mask_0f = _mm_set1_epi8(0x0F);
+  const __m128i lo_nibbles = _mm_and_si128(in, mask_0f);
+  const __m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(in, 4), mask_0f);
+  const __m128i lo = _mm_shuffle_epi8(lut_lo, lo_nibbles);
+  const __m128i hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+  if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(lo, hi),
+                                       _mm_setzero_si128())) != 0xFFFF) {
+    return false;
+  }
+  const __m128i eq_5f = _mm_cmpeq_epi8(in, _mm_set1_epi8(0x5F));
+  __m128i roll = _mm_shuffle_epi8(lut_roll, hi_nibbles);
+  roll = _mm_add_epi8(roll, _mm_and_si128(eq_5f, _mm_set1_epi8(33)));
+  const __m128i values = _mm_add_epi8(in, roll);
+  // Pack the 16 6-bit values into 12 bytes.
+  const __m128i merged =
+      _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+  const __m128i packed = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+  *out = _mm_shuffle_epi8(packed, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8,
+                                                14, 13, 12, -1, -1, -1, -1));
+  return true;
+}
+
+#endif  // __SSSE3__
+
+}  // namespace
+
+std::string Base64UrlEncode(absl::string_view input) {
+  size_t n = input.size();
+  size_t out_size = (n / 3) * 4;
+  if (n % 3 != 0) out_size += n % 3 + 1;
+  std::string result;
+  ResizeStringUninitialized(&result, out_size);
+  if (out_size == 0) return result;
+  const uint8_t* in = reinterpret_cast<const uint8_t*>(input.data());
+  char* out = &result[0];
+
+#ifdef __SSSE3__
+  // Each iteration consumes 12 bytes and emits 16 characters, but loads a
+  // full register, so stop while 16 input bytes are readable.
+  while (n >= 16) {
+    const __m128i block =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out),
+                     EncodeTranslate(EncodeReshuffle(block)));
+    in += 12;
+    out += 16;
+    n -= 12;
+  }
+#endif
+
+  while (n >= 3) {
+    const uint32_t v = (static_cast<uint32_t>(in[0]) << 16) |
+                       (static_cast<uint32_t>(in[1]) << 8) | in[2];
+    out[0] = kEncodeTable[v >> 18];
+    out[1] = kEncodeTable[(v >> 12) & 0x3F];
+    out[2] = kEncodeTable[(v >> 6) & 0x3F];
+    out[3] = kEncodeTable[v & 0x3F];
+    in += 3;
+    out += 4;
+    n -= 3;
+  }
+  if (n == 1) {
+    out[0] = kEncodeTable[in[0] >> 2];
+    out[1] = kEncodeTable[(in[0] << 4) & 0x3F];
+  } else if (n == 2) {
+    out[0] = kEncodeTable[in[0] >> 2];
+    out[1] = kEncodeTable[((in[0] << 4) | (in[1] >> 4)) & 0x3F];
+    out[2] = kEncodeTable[(in[1] << 2) & 0x3F];
+  }
+  return result;
+}
+
+bool Base64UrlDecode(absl::string_view input, std::string* output) {
+  size_t n = input.size();
+  const size_t tail = n % 4;
+  // No encoding yields a single leftover character.
+  if (tail == 1) return false;
+  const size_t out_size = (n / 4) * 3 + (tail == 0 ? 0 : tail - 1);
+  ResizeStringUninitialized(output, out_size);
+  const uint8_t* in = reinterpret_cast<const uint8_t*>(input.data());
+  char* out = out_size == 0 ? nullptr : &(*output)[0];
+  size_t out_left = out_size;
+
+#ifdef __SSSE3__
+  // Each iteration consumes 16 characters and emits 12 bytes, but stores
+  // a full register, so stop while 16 output bytes are writable.
+  while (n >= 16 && out_left >= 16) {
+    const __m128i block =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+    __m128i decoded;
+    if (!DecodeBlock(block, &decoded)) return false;
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), decoded);
+    in += 16;
+    out += 12;
+    n -= 16;
+    out_left -= 12;
+  }
+#endif
+
+  while (n >= 4) {
+    const int8_t a = kDecodeTable[in[0]];
+    const int8_t b = kDecodeTable[in[1]];
+    const int8_t c = kDecodeTable[in[2]];
+    const int8_t d = kDecodeTable[in[3]];
+    if ((a | b | c | d) < 0) return false;
+    const uint32_t v = (static_cast<uint32_t>(a) << 18) |
+                       (static_cast<uint32_t>(b) << 12) |
+                       (static_cast<uint32_t>(c) << 6) | d;
+    out[0] = static_cast<char>(v >> 16);
+    out[1] = static_cast<char>(v >> 8);
+    out[2] = static_cast<char>(v);
+    in += 4;
+    out += 3;
+    n -= 4;
+  }
+  if (n == 2) {
+    const int8_t a = kDecodeTable[in[0]];
+    const int8_t b = kDecodeTable[in[1]];
+    if ((a | b) < 0) return false;
+    out[0] = static_cast<char>((a << 2) | (b >> 4));
+  } else if (n == 3) {
+    const int8_t a = kDecodeTable[in[0]];
+    const int8_t b = kDecodeTable[in[1]];
+    const int8_t c = kDecodeTable[in[2]];
+    if ((a | b | c) < 0) return false;
+    out[0] = static_cast<char>((a << 2) | (b >> 4));
+    out[1] = static_cast<char>((b << 4) | (c >> 2));
+  }
+  return true;
+}
+
+}  // namespace subtle
+}  // namespace tink
+}  // namespace crypto
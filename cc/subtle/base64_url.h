@@ -0,0 +1,47 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_SUBTLE_BASE64_URL_H_
+#define TINK_SUBTLE_BASE64_URL_H_
+
+#include <string>
+
+#include "absl/strings/string_view.h"
+
+namespace crypto {
+namespace tink {
+namespace subtle {
+
+// Unpadded base64url coding (RFC 4648 section 5), as used by the JWT
+// compact serialization. When compiled for a CPU with SSSE3 the bulk of
+// the input is processed with a vectorized kernel; otherwise a
+// table-driven scalar implementation is used.
+
+// Returns the unpadded base64url encoding of 'input'.
+std::string Base64UrlEncode(absl::string_view input);
+
+// Decodes the unpadded base64url string 'input' into 'output'.
+// Returns false if 'input' contains a character outside the base64url
+// alphabet (this includes '=' padding and whitespace) or has a length
+// that no encoding produces; the contents of 'output' are unspecified
+// in that case.
+bool Base64UrlDecode(absl::string_view input, std::string* output);
+
+}  // namespace subtle
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_SUBTLE_BASE64_URL_H_
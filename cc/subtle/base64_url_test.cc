@@ -0,0 +1,90 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/subtle/base64_url.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "absl/strings/escaping.h"
+#include "tink/subtle/random.h"
+
+namespace crypto {
+namespace tink {
+namespace subtle {
+namespace {
+
+TEST(Base64UrlTest, EncodeMatchesWebSafeBase64Escape) {
+  // Lengths cover the empty string, all tail sizes and, where available,
+  // the vectorized bulk path.
+  for (int len = 0; len < 200; len++) {
+    const std::string data = Random::GetRandomBytes(len);
+    EXPECT_EQ(absl::WebSafeBase64Escape(data), Base64UrlEncode(data))
+        << "length " << len;
+  }
+}
+
+TEST(Base64UrlTest, EncodeDecodeRoundtrip) {
+  for (int len = 0; len < 200; len++) {
+    const std::string data = Random::GetRandomBytes(len);
+    std::string decoded;
+    ASSERT_TRUE(Base64UrlDecode(Base64UrlEncode(data), &decoded))
+        << "length " << len;
+    EXPECT_EQ(data, decoded) << "length " << len;
+  }
+}
+
+TEST(Base64UrlTest, DecodeRejectsInvalidInput) {
+  std::string decoded;
+  // A single leftover character cannot occur in valid input.
+  EXPECT_FALSE(Base64UrlDecode("A", &decoded));
+  EXPECT_FALSE(Base64UrlDecode("AAAAA", &decoded));
+  // Padding and whitespace are not part of the base64url alphabet.
+  EXPECT_FALSE(Base64UrlDecode("QUJD=", &decoded));
+  EXPECT_FALSE(Base64UrlDecode("QU==", &decoded));
+  EXPECT_FALSE(Base64UrlDecode("QU JD", &decoded));
+  EXPECT_FALSE(Base64UrlDecode("QUJD\n", &decoded));
+  // The standard-alphabet characters for 62 and 63 are rejected.
+  EXPECT_FALSE(Base64UrlDecode("QUJ+", &decoded));
+  EXPECT_FALSE(Base64UrlDecode("QUJ/", &decoded));
+  // Bytes outside the ASCII range are rejected.
+  EXPECT_FALSE(Base64UrlDecode(std::string("QU\x80J", 4), &decoded));
+  // An invalid character beyond the first block is found by the bulk path.
+  std::string long_input(32, 'A');
+  long_input += "*AAA";
+  EXPECT_FALSE(Base64UrlDecode(long_input, &decoded));
+}
+
+TEST(Base64UrlTest, DecodeKnownValues) {
+  std::string decoded;
+  ASSERT_TRUE(Base64UrlDecode("", &decoded));
+  EXPECT_EQ("", decoded);
+  ASSERT_TRUE(Base64UrlDecode("YQ", &decoded));
+  EXPECT_EQ("a", decoded);
+  ASSERT_TRUE(Base64UrlDecode("YWI", &decoded));
+  EXPECT_EQ("ab", decoded);
+  ASSERT_TRUE(Base64UrlDecode("YWJj", &decoded));
+  EXPECT_EQ("abc", decoded);
+  // '-' and '_' decode to the values that '+' and '/' have in the
+  // standard alphabet.
+  ASSERT_TRUE(Base64UrlDecode("-_8", &decoded));
+  EXPECT_EQ("\xfb\xff", decoded);
+}
+
+}  // namespace
+}  // namespace subtle
+}  // namespace tink
+}  // namespace crypto
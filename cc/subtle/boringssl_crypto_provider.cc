@@ -0,0 +1,62 @@
+// Copyright 2021 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/subtle/boringssl_crypto_provider.h"
+
+#include <utility>
+
+#include "tink/subtle/aes_gcm_boringssl.h"
+#include "tink/subtle/ecdsa_sign_boringssl.h"
+#include "tink/subtle/ecdsa_verify_boringssl.h"
+
+namespace crypto {
+namespace tink {
+namespace subtle {
+
+CryptoProvider::Capabilities BoringSslCryptoProvider::GetCapabilities() const {
+  Capabilities capabilities;
+  capabilities.aes_gcm = true;
+  capabilities.ecdsa = true;
+  capabilities.min_efficient_payload_size = 0;
+  return capabilities;
+}
+
+util::StatusOr<std::unique_ptr<Aead>> BoringSslCryptoProvider::NewAesGcmAead(
+    const util::SecretData& key) const {
+  return AesGcmBoringSsl::New(key);
+}
+
+util::StatusOr<std::unique_ptr<PublicKeySign>>
+BoringSslCryptoProvider::NewEcdsaSign(const SubtleUtilBoringSSL::EcKey& ec_key,
+                                      HashType hash_type,
+                                      EcdsaSignatureEncoding encoding) const {
+  auto sign_result = EcdsaSignBoringSsl::New(ec_key, hash_type, encoding);
+  if (!sign_result.ok()) return sign_result.status();
+  return {std::move(sign_result.ValueOrDie())};
+}
+
+util::StatusOr<std::unique_ptr<PublicKeyVerify>>
+BoringSslCryptoProvider::NewEcdsaVerify(
+    const SubtleUtilBoringSSL::EcKey& ec_key, HashType hash_type,
+    EcdsaSignatureEncoding encoding) const {
+  auto verify_result = EcdsaVerifyBoringSsl::New(ec_key, hash_type, encoding);
+  if (!verify_result.ok()) return verify_result.status();
+  return {std::move(verify_result.ValueOrDie())};
+}
+
+}  // namespace subtle
+}  // namespace tink
+}  // namespace crypto
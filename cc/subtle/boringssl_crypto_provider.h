@@ -0,0 +1,62 @@
+// Copyright 2021 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_SUBTLE_BORINGSSL_CRYPTO_PROVIDER_H_
+#define TINK_SUBTLE_BORINGSSL_CRYPTO_PROVIDER_H_
+
+#include <memory>
+
+#include "absl/strings/string_view.h"
+#include "tink/aead.h"
+#include "tink/public_key_sign.h"
+#include "tink/public_key_verify.h"
+#include "tink/subtle/common_enums.h"
+#include "tink/subtle/crypto_provider.h"
+#include "tink/subtle/subtle_util_boringssl.h"
+#include "tink/util/secret_data.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace subtle {
+
+// The default CryptoProvider, backed by the BoringSSL-based subtle
+// implementations (AesGcmBoringSsl, EcdsaSignBoringSsl, ...). It is always
+// present in the CryptoProviderRegistry and serves as the fallback when no
+// registered offload engine is a better fit.
+class BoringSslCryptoProvider : public CryptoProvider {
+ public:
+  absl::string_view name() const override { return "BoringSSL"; }
+
+  Capabilities GetCapabilities() const override;
+
+  crypto::tink::util::StatusOr<std::unique_ptr<Aead>> NewAesGcmAead(
+      const util::SecretData& key) const override;
+
+  crypto::tink::util::StatusOr<std::unique_ptr<PublicKeySign>> NewEcdsaSign(
+      const SubtleUtilBoringSSL::EcKey& ec_key, HashType hash_type,
+      EcdsaSignatureEncoding encoding) const override;
+
+  crypto::tink::util::StatusOr<std::unique_ptr<PublicKeyVerify>> NewEcdsaVerify(
+      const SubtleUtilBoringSSL::EcKey& ec_key, HashType hash_type,
+      EcdsaSignatureEncoding encoding) const override;
+};
+
+}  // namespace subtle
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_SUBTLE_BORINGSSL_CRYPTO_PROVIDER_H_
@@ -0,0 +1,124 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/subtle/cpu_features.h"
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+#if defined(__arm__) && defined(__linux__)
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#endif
+
+namespace crypto {
+namespace tink {
+namespace subtle {
+
+namespace {
+
+#if defined(__x86_64__) || defined(__i386__)
+
+// CPUID leaf 1, ECX.
+constexpr uint32_t kSse41Bit = 1 << 19;
+constexpr uint32_t kAesBit = 1 << 25;
+constexpr uint32_t kOsXsaveBit = 1 << 27;
+// CPUID leaf 7 (subleaf 0), EBX.
+constexpr uint32_t kAvx512fBit = 1 << 16;
+// CPUID leaf 7 (subleaf 0), ECX.
+constexpr uint32_t kVaesBit = 1 << 9;
+// XCR0 bits that must be set before 512-bit registers may be used:
+// SSE (1), AVX (2), opmask (5), ZMM0-15 upper halves (6), ZMM16-31 (7).
+constexpr uint32_t kXcr0Avx512State = 0xe6;
+
+struct X86Features {
+  bool aesni;
+  bool vaes;
+};
+
+X86Features ReadX86Features() {
+  X86Features features = {false, false};
+  uint32_t eax;
+  uint32_t ebx;
+  uint32_t ecx;
+  uint32_t edx;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+    return features;
+  }
+  features.aesni = (ecx & kAesBit) != 0 && (ecx & kSse41Bit) != 0;
+  // VAES additionally requires AVX-512 state support from the OS.
+  if ((ecx & kOsXsaveBit) == 0) {
+    return features;
+  }
+  uint32_t xcr0_lo;
+  uint32_t xcr0_hi;
+  __asm__("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+  if ((xcr0_lo & kXcr0Avx512State) != kXcr0Avx512State) {
+    return features;
+  }
+  if (__get_cpuid_max(0, nullptr) < 7) {
+    return features;
+  }
+  __cpuid_count(7, 0, eax, ebx, ecx, edx);
+  features.vaes = (ebx & kAvx512fBit) != 0 && (ecx & kVaesBit) != 0;
+  return features;
+}
+
+const X86Features& GetX86Features() {
+  static const X86Features features = ReadX86Features();
+  return features;
+}
+
+#endif  // defined(__x86_64__) || defined(__i386__)
+
+}  // namespace
+
+// static
+bool CpuFeatures::HasAesni() {
+#if defined(__x86_64__) || defined(__i386__)
+  return GetX86Features().aesni;
+#else
+  return false;
+#endif
+}
+
+// static
+bool CpuFeatures::HasVaes() {
+#if defined(__x86_64__) || defined(__i386__)
+  return GetX86Features().vaes;
+#else
+  return false;
+#endif
+}
+
+// static
+bool CpuFeatures::HasNeon() {
+#if defined(__aarch64__)
+  // Advanced SIMD support is mandatory on AArch64.
+  return true;
+#elif defined(__arm__) && defined(__linux__)
+  return (getauxval(AT_HWCAP) & HWCAP_NEON) != 0;
+#else
+  return false;
+#endif
+}
+
+}  // namespace subtle
+}  // namespace tink
+}  // namespace crypto
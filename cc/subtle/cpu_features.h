@@ -0,0 +1,54 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_SUBTLE_CPU_FEATURES_H_
+#define TINK_SUBTLE_CPU_FEATURES_H_
+
+namespace crypto {
+namespace tink {
+namespace subtle {
+
+// Runtime detection of the CPU capabilities that the hand-optimized
+// implementations in this directory rely on. A binary that is shipped to a
+// heterogeneous fleet may have an optimized implementation compiled in even
+// though not every machine supports the required instructions; key managers
+// consult these predicates to pick the fastest implementation that the
+// machine running the binary actually supports.
+//
+// The feature flags are read once and cached, so all predicates are cheap
+// after the first call. All predicates return false on architectures where
+// the corresponding instructions do not exist.
+class CpuFeatures {
+ public:
+  // Returns true if the CPU supports the AES-NI and SSE4.1 instruction sets
+  // (used by AesEaxAesni).
+  static bool HasAesni();
+
+  // Returns true if the CPU supports the VAES and AVX-512F instruction sets
+  // and the OS saves the 512-bit register state (used by the wide codepath
+  // of AesEaxAesni).
+  static bool HasVaes();
+
+  // Returns true if the CPU supports the ARM Advanced SIMD (NEON)
+  // instructions.
+  static bool HasNeon();
+};
+
+}  // namespace subtle
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_SUBTLE_CPU_FEATURES_H_
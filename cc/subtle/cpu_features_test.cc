@@ -0,0 +1,63 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/subtle/cpu_features.h"
+
+#include "gtest/gtest.h"
+
+namespace crypto {
+namespace tink {
+namespace subtle {
+namespace {
+
+// The actual feature set depends on the machine running the test, so the
+// tests below mainly check that the detection is stable and consistent with
+// what the binary was compiled for.
+
+TEST(CpuFeaturesTest, StableAcrossCalls) {
+  EXPECT_EQ(CpuFeatures::HasAesni(), CpuFeatures::HasAesni());
+  EXPECT_EQ(CpuFeatures::HasVaes(), CpuFeatures::HasVaes());
+  EXPECT_EQ(CpuFeatures::HasNeon(), CpuFeatures::HasNeon());
+}
+
+TEST(CpuFeaturesTest, ConsistentWithCompileTimeTarget) {
+  // A binary compiled for AES-NI (resp. VAES) can only run on a machine that
+  // supports it, so runtime detection must agree.
+#if defined(__AES__) && defined(__SSE4_1__)
+  EXPECT_TRUE(CpuFeatures::HasAesni());
+#endif
+#if defined(__VAES__) && defined(__AVX512F__)
+  EXPECT_TRUE(CpuFeatures::HasVaes());
+#endif
+#if defined(__aarch64__)
+  EXPECT_TRUE(CpuFeatures::HasNeon());
+#endif
+}
+
+TEST(CpuFeaturesTest, FeaturesImplyArchitecture) {
+#if !defined(__x86_64__) && !defined(__i386__)
+  EXPECT_FALSE(CpuFeatures::HasAesni());
+  EXPECT_FALSE(CpuFeatures::HasVaes());
+#endif
+#if !defined(__aarch64__) && !defined(__arm__)
+  EXPECT_FALSE(CpuFeatures::HasNeon());
+#endif
+}
+
+}  // namespace
+}  // namespace subtle
+}  // namespace tink
+}  // namespace crypto
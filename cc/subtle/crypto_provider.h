@@ -0,0 +1,89 @@
+// Copyright 2021 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_SUBTLE_CRYPTO_PROVIDER_H_
+#define TINK_SUBTLE_CRYPTO_PROVIDER_H_
+
+#include <memory>
+
+#include "absl/strings/string_view.h"
+#include "tink/aead.h"
+#include "tink/public_key_sign.h"
+#include "tink/public_key_verify.h"
+#include "tink/subtle/common_enums.h"
+#include "tink/subtle/subtle_util_boringssl.h"
+#include "tink/util/secret_data.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace subtle {
+
+// An engine that can back subtle primitives, as an alternative to the
+// built-in BoringSSL implementations (e.g. a hardware offload engine).
+// A provider creates primitives that are wire-compatible with their
+// BoringSSL counterparts: a ciphertext produced by one provider's Aead must
+// decrypt under any other provider's Aead for the same key, and likewise
+// for signatures. The registered providers are managed by
+// CryptoProviderRegistry, which also selects among them by payload size.
+//
+// Implementations must be thread-safe, as must the primitives they create.
+class CryptoProvider {
+ public:
+  // The operations a provider can back, discovered once at registration,
+  // and the payload size from which on the provider is worth selecting.
+  struct Capabilities {
+    // Seal/open: AES-GCM Aeads via NewAesGcmAead().
+    bool aes_gcm = false;
+    // Sign/verify: ECDSA via NewEcdsaSign() and NewEcdsaVerify().
+    bool ecdsa = false;
+    // The payload size in bytes from which on this provider is expected to
+    // be faster than the built-in CPU implementation; 0 means "always".
+    // Offload engines typically set this to their break-even size, so that
+    // small payloads stay on the CPU.
+    size_t min_efficient_payload_size = 0;
+  };
+
+  virtual ~CryptoProvider() {}
+
+  // The name of this provider; must be unique among registered providers.
+  virtual absl::string_view name() const = 0;
+
+  virtual Capabilities GetCapabilities() const = 0;
+
+  // Returns an Aead equivalent to AesGcmBoringSsl::New(key).
+  // Must be implemented if Capabilities::aes_gcm is set.
+  virtual crypto::tink::util::StatusOr<std::unique_ptr<Aead>> NewAesGcmAead(
+      const util::SecretData& key) const = 0;
+
+  // Returns a PublicKeySign equivalent to EcdsaSignBoringSsl::New(...).
+  // Must be implemented if Capabilities::ecdsa is set.
+  virtual crypto::tink::util::StatusOr<std::unique_ptr<PublicKeySign>>
+  NewEcdsaSign(const SubtleUtilBoringSSL::EcKey& ec_key, HashType hash_type,
+               EcdsaSignatureEncoding encoding) const = 0;
+
+  // Returns a PublicKeyVerify equivalent to EcdsaVerifyBoringSsl::New(...).
+  // Must be implemented if Capabilities::ecdsa is set.
+  virtual crypto::tink::util::StatusOr<std::unique_ptr<PublicKeyVerify>>
+  NewEcdsaVerify(const SubtleUtilBoringSSL::EcKey& ec_key, HashType hash_type,
+                 EcdsaSignatureEncoding encoding) const = 0;
+};
+
+}  // namespace subtle
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_SUBTLE_CRYPTO_PROVIDER_H_
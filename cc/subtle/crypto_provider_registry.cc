@@ -0,0 +1,192 @@
+// Copyright 2021 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/subtle/crypto_provider_registry.h"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "tink/subtle/boringssl_crypto_provider.h"
+#include "tink/util/errors.h"
+
+namespace crypto {
+namespace tink {
+namespace subtle {
+
+namespace {
+
+// An Aead that routes each operation by payload size to one of several
+// provider-created Aeads for the same key. All candidates are
+// wire-compatible (see CryptoProvider), so the routing affects only where
+// the work is done, not the result.
+class PayloadSizeDispatchingAead : public Aead {
+ public:
+  struct Entry {
+    size_t threshold;  // the provider's min_efficient_payload_size
+    std::unique_ptr<Aead> aead;
+  };
+
+  // 'entries' must be non-empty, sorted by threshold, and start at
+  // threshold 0.
+  explicit PayloadSizeDispatchingAead(std::vector<Entry> entries)
+      : entries_(std::move(entries)) {}
+
+  crypto::tink::util::StatusOr<std::string> Encrypt(
+      absl::string_view plaintext,
+      absl::string_view associated_data) const override {
+    return Select(plaintext.size())->Encrypt(plaintext, associated_data);
+  }
+
+  crypto::tink::util::StatusOr<std::string> Decrypt(
+      absl::string_view ciphertext,
+      absl::string_view associated_data) const override {
+    // Routed by ciphertext size; the few dozen bytes of IV and tag do not
+    // matter relative to the thresholds of bulk offload engines.
+    return Select(ciphertext.size())->Decrypt(ciphertext, associated_data);
+  }
+
+  size_t MaxEncryptionSize(size_t plaintext_size) const override {
+    return Select(plaintext_size)->MaxEncryptionSize(plaintext_size);
+  }
+
+  crypto::tink::util::StatusOr<size_t> EncryptInto(
+      absl::string_view plaintext, absl::string_view associated_data,
+      absl::Span<char> out) const override {
+    return Select(plaintext.size())
+        ->EncryptInto(plaintext, associated_data, out);
+  }
+
+  crypto::tink::util::StatusOr<size_t> DecryptInto(
+      absl::string_view ciphertext, absl::string_view associated_data,
+      absl::Span<char> out) const override {
+    return Select(ciphertext.size())
+        ->DecryptInto(ciphertext, associated_data, out);
+  }
+
+ private:
+  // The Aead with the largest threshold that does not exceed payload_size.
+  const Aead* Select(size_t payload_size) const {
+    for (auto it = entries_.rbegin(); it != entries_.rend(); ++it) {
+      if (it->threshold <= payload_size) return it->aead.get();
+    }
+    return entries_.front().aead.get();
+  }
+
+  std::vector<Entry> entries_;
+};
+
+bool SupportsAesGcm(const CryptoProvider::Capabilities& capabilities) {
+  return capabilities.aes_gcm;
+}
+
+bool SupportsEcdsa(const CryptoProvider::Capabilities& capabilities) {
+  return capabilities.ecdsa;
+}
+
+}  // namespace
+
+// static
+CryptoProviderRegistry& CryptoProviderRegistry::GlobalInstance() {
+  static CryptoProviderRegistry* instance = new CryptoProviderRegistry();
+  return *instance;
+}
+
+CryptoProviderRegistry::CryptoProviderRegistry() {
+  providers_.push_back(absl::make_unique<BoringSslCryptoProvider>());
+}
+
+util::Status CryptoProviderRegistry::RegisterProvider(
+    std::unique_ptr<CryptoProvider> provider) {
+  if (provider == nullptr) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "provider must be non-null.");
+  }
+  absl::MutexLock lock(&mu_);
+  for (const auto& registered : providers_) {
+    if (registered->name() == provider->name()) {
+      return ToStatusF(util::error::ALREADY_EXISTS,
+                       "A provider named '%s' has already been registered.",
+                       std::string(provider->name()).c_str());
+    }
+  }
+  providers_.push_back(std::move(provider));
+  return util::Status::OK;
+}
+
+const CryptoProvider* CryptoProviderRegistry::Select(
+    size_t payload_size,
+    bool (*supports)(const CryptoProvider::Capabilities&)) const {
+  absl::MutexLock lock(&mu_);
+  // providers_[0] is the built-in BoringSSL provider, which supports all
+  // operations with threshold 0, so 'best' is never left null.
+  const CryptoProvider* best = providers_[0].get();
+  size_t best_threshold = 0;
+  for (const auto& provider : providers_) {
+    auto capabilities = provider->GetCapabilities();
+    if (!supports(capabilities)) continue;
+    if (capabilities.min_efficient_payload_size <= payload_size &&
+        capabilities.min_efficient_payload_size >= best_threshold) {
+      best = provider.get();
+      best_threshold = capabilities.min_efficient_payload_size;
+    }
+  }
+  return best;
+}
+
+const CryptoProvider& CryptoProviderRegistry::SelectAesGcm(
+    size_t payload_size) const {
+  return *Select(payload_size, SupportsAesGcm);
+}
+
+const CryptoProvider& CryptoProviderRegistry::SelectEcdsa(
+    size_t payload_size) const {
+  return *Select(payload_size, SupportsEcdsa);
+}
+
+util::StatusOr<std::unique_ptr<Aead>> CryptoProviderRegistry::NewAesGcmAead(
+    const util::SecretData& key) const {
+  std::vector<PayloadSizeDispatchingAead::Entry> entries;
+  {
+    absl::MutexLock lock(&mu_);
+    for (const auto& provider : providers_) {
+      auto capabilities = provider->GetCapabilities();
+      if (!capabilities.aes_gcm) continue;
+      auto aead_result = provider->NewAesGcmAead(key);
+      if (!aead_result.ok()) return aead_result.status();
+      PayloadSizeDispatchingAead::Entry entry;
+      entry.threshold = capabilities.min_efficient_payload_size;
+      entry.aead = std::move(aead_result.ValueOrDie());
+      entries.push_back(std::move(entry));
+    }
+  }
+  // Just the built-in BoringSSL provider: no dispatch layer needed.
+  if (entries.size() == 1) return std::move(entries[0].aead);
+  std::sort(entries.begin(), entries.end(),
+            [](const PayloadSizeDispatchingAead::Entry& a,
+               const PayloadSizeDispatchingAead::Entry& b) {
+              return a.threshold < b.threshold;
+            });
+  return {absl::make_unique<PayloadSizeDispatchingAead>(std::move(entries))};
+}
+
+}  // namespace subtle
+}  // namespace tink
+}  // namespace crypto
@@ -0,0 +1,93 @@
+// Copyright 2021 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_SUBTLE_CRYPTO_PROVIDER_REGISTRY_H_
+#define TINK_SUBTLE_CRYPTO_PROVIDER_REGISTRY_H_
+
+#include <memory>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "tink/aead.h"
+#include "tink/subtle/crypto_provider.h"
+#include "tink/util/secret_data.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace subtle {
+
+// A registry of CryptoProviders, with selection by payload size: among the
+// providers that support an operation, the one with the largest
+// min_efficient_payload_size not exceeding the payload at hand is selected.
+// The built-in BoringSslCryptoProvider (threshold 0) is always present, so
+// selection never fails and small payloads stay on the CPU unless an
+// offload engine claims them.
+//
+// Offload engines register themselves once at startup, before keys are
+// loaded, via
+//   CryptoProviderRegistry::GlobalInstance().RegisterProvider(...);
+// Thread-safe.
+class CryptoProviderRegistry {
+ public:
+  // The process-wide registry used by the key managers.
+  static CryptoProviderRegistry& GlobalInstance();
+
+  // A registry that contains only the built-in BoringSSL provider.
+  CryptoProviderRegistry();
+
+  // Registers 'provider', taking ownership. Returns ALREADY_EXISTS if a
+  // provider with the same name is registered. Providers cannot be
+  // unregistered; primitives created before a registration keep routing
+  // among the providers that were present at their creation.
+  crypto::tink::util::Status RegisterProvider(
+      std::unique_ptr<CryptoProvider> provider);
+
+  // Returns the provider selected for AES-GCM payloads of 'payload_size'
+  // bytes. The returned reference stays valid for the lifetime of the
+  // registry.
+  const CryptoProvider& SelectAesGcm(size_t payload_size) const;
+
+  // Returns the provider selected for ECDSA over messages of
+  // 'payload_size' bytes.
+  const CryptoProvider& SelectEcdsa(size_t payload_size) const;
+
+  // Returns an Aead for 'key' that routes every operation to the provider
+  // selected for the payload at hand (plaintext size on encryption,
+  // ciphertext size on decryption). If only one registered provider
+  // supports AES-GCM, its Aead is returned directly, without a dispatch
+  // layer.
+  crypto::tink::util::StatusOr<std::unique_ptr<Aead>> NewAesGcmAead(
+      const util::SecretData& key) const;
+
+ private:
+  // The provider with the largest threshold <= payload_size among those
+  // for which 'supports' is true; never null.
+  const CryptoProvider* Select(size_t payload_size,
+                               bool (*supports)(
+                                   const CryptoProvider::Capabilities&)) const;
+
+  mutable absl::Mutex mu_;
+  std::vector<std::unique_ptr<CryptoProvider>> providers_ ABSL_GUARDED_BY(mu_);
+};
+
+}  // namespace subtle
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_SUBTLE_CRYPTO_PROVIDER_REGISTRY_H_
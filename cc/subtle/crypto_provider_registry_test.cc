@@ -0,0 +1,197 @@
+// Copyright 2021 Google Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/subtle/crypto_provider_registry.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "gtest/gtest.h"
+#include "absl/memory/memory.h"
+#include "absl/strings/string_view.h"
+#include "tink/aead.h"
+#include "tink/subtle/aes_gcm_boringssl.h"
+#include "tink/subtle/crypto_provider.h"
+#include "tink/subtle/random.h"
+#include "tink/util/secret_data.h"
+
+namespace crypto {
+namespace tink {
+namespace subtle {
+namespace {
+
+// An Aead that counts its operations and forwards them to AesGcmBoringSsl,
+// standing in for an offload engine in the tests below.
+class CountingAead : public Aead {
+ public:
+  CountingAead(std::unique_ptr<Aead> aead, std::atomic<int>* op_count)
+      : aead_(std::move(aead)), op_count_(op_count) {}
+
+  crypto::tink::util::StatusOr<std::string> Encrypt(
+      absl::string_view plaintext,
+      absl::string_view associated_data) const override {
+    (*op_count_)++;
+    return aead_->Encrypt(plaintext, associated_data);
+  }
+
+  crypto::tink::util::StatusOr<std::string> Decrypt(
+      absl::string_view ciphertext,
+      absl::string_view associated_data) const override {
+    (*op_count_)++;
+    return aead_->Decrypt(ciphertext, associated_data);
+  }
+
+ private:
+  std::unique_ptr<Aead> aead_;
+  std::atomic<int>* op_count_;
+};
+
+// A provider that claims AES-GCM payloads of at least 'threshold' bytes and
+// counts the operations routed to it.
+class FakeOffloadProvider : public CryptoProvider {
+ public:
+  FakeOffloadProvider(absl::string_view name, size_t threshold,
+                      std::atomic<int>* op_count)
+      : name_(name), threshold_(threshold), op_count_(op_count) {}
+
+  absl::string_view name() const override { return name_; }
+
+  Capabilities GetCapabilities() const override {
+    Capabilities capabilities;
+    capabilities.aes_gcm = true;
+    capabilities.min_efficient_payload_size = threshold_;
+    return capabilities;
+  }
+
+  crypto::tink::util::StatusOr<std::unique_ptr<Aead>> NewAesGcmAead(
+      const util::SecretData& key) const override {
+    auto aead_result = AesGcmBoringSsl::New(key);
+    if (!aead_result.ok()) return aead_result.status();
+    return {absl::make_unique<CountingAead>(
+        std::move(aead_result.ValueOrDie()), op_count_)};
+  }
+
+  crypto::tink::util::StatusOr<std::unique_ptr<PublicKeySign>> NewEcdsaSign(
+      const SubtleUtilBoringSSL::EcKey& ec_key, HashType hash_type,
+      EcdsaSignatureEncoding encoding) const override {
+    return util::Status(util::error::UNIMPLEMENTED, "sign not supported");
+  }
+
+  crypto::tink::util::StatusOr<std::unique_ptr<PublicKeyVerify>> NewEcdsaVerify(
+      const SubtleUtilBoringSSL::EcKey& ec_key, HashType hash_type,
+      EcdsaSignatureEncoding encoding) const override {
+    return util::Status(util::error::UNIMPLEMENTED, "verify not supported");
+  }
+
+ private:
+  std::string name_;
+  size_t threshold_;
+  std::atomic<int>* op_count_;
+};
+
+TEST(CryptoProviderRegistryTest, DefaultRegistryHasBoringSsl) {
+  CryptoProviderRegistry registry;
+  EXPECT_EQ("BoringSSL", registry.SelectAesGcm(0).name());
+  EXPECT_EQ("BoringSSL", registry.SelectAesGcm(1 << 20).name());
+  EXPECT_EQ("BoringSSL", registry.SelectEcdsa(1 << 20).name());
+}
+
+TEST(CryptoProviderRegistryTest, RejectsDuplicateName) {
+  CryptoProviderRegistry registry;
+  std::atomic<int> op_count(0);
+  auto status = registry.RegisterProvider(
+      absl::make_unique<FakeOffloadProvider>("offload", 64, &op_count));
+  EXPECT_TRUE(status.ok()) << status;
+  status = registry.RegisterProvider(
+      absl::make_unique<FakeOffloadProvider>("offload", 128, &op_count));
+  EXPECT_FALSE(status.ok());
+  EXPECT_EQ(util::error::ALREADY_EXISTS, status.error_code());
+}
+
+TEST(CryptoProviderRegistryTest, SelectsByPayloadSize) {
+  CryptoProviderRegistry registry;
+  std::atomic<int> op_count(0);
+  auto status = registry.RegisterProvider(
+      absl::make_unique<FakeOffloadProvider>("offload", 64 * 1024, &op_count));
+  ASSERT_TRUE(status.ok()) << status;
+  EXPECT_EQ("BoringSSL", registry.SelectAesGcm(0).name());
+  EXPECT_EQ("BoringSSL", registry.SelectAesGcm(64 * 1024 - 1).name());
+  EXPECT_EQ("offload", registry.SelectAesGcm(64 * 1024).name());
+  EXPECT_EQ("offload", registry.SelectAesGcm(1 << 24).name());
+  // The fake does not support ECDSA, so sign/verify stays on the CPU.
+  EXPECT_EQ("BoringSSL", registry.SelectEcdsa(1 << 24).name());
+}
+
+TEST(CryptoProviderRegistryTest, DispatchingAeadRoutesByPayloadSize) {
+  CryptoProviderRegistry registry;
+  std::atomic<int> op_count(0);
+  auto status = registry.RegisterProvider(
+      absl::make_unique<FakeOffloadProvider>("offload", 1024, &op_count));
+  ASSERT_TRUE(status.ok()) << status;
+
+  util::SecretData key = Random::GetRandomKeyBytes(16);
+  auto aead_result = registry.NewAesGcmAead(key);
+  ASSERT_TRUE(aead_result.ok()) << aead_result.status();
+  auto aead = std::move(aead_result.ValueOrDie());
+
+  // Small payload: stays on the CPU.
+  std::string small_pt = "short plaintext";
+  auto small_ct_result = aead->Encrypt(small_pt, "aad");
+  ASSERT_TRUE(small_ct_result.ok()) << small_ct_result.status();
+  EXPECT_EQ(0, op_count.load());
+
+  // Bulk payload: routed to the offload provider.
+  std::string bulk_pt = Random::GetRandomBytes(4096);
+  auto bulk_ct_result = aead->Encrypt(bulk_pt, "aad");
+  ASSERT_TRUE(bulk_ct_result.ok()) << bulk_ct_result.status();
+  EXPECT_EQ(1, op_count.load());
+  auto bulk_pt_result = aead->Decrypt(bulk_ct_result.ValueOrDie(), "aad");
+  ASSERT_TRUE(bulk_pt_result.ok()) << bulk_pt_result.status();
+  EXPECT_EQ(bulk_pt, bulk_pt_result.ValueOrDie());
+  EXPECT_EQ(2, op_count.load());
+
+  // Wire compatibility: both routes decrypt under a plain AesGcmBoringSsl.
+  auto reference_result = AesGcmBoringSsl::New(key);
+  ASSERT_TRUE(reference_result.ok()) << reference_result.status();
+  auto reference = std::move(reference_result.ValueOrDie());
+  auto decrypted_small =
+      reference->Decrypt(small_ct_result.ValueOrDie(), "aad");
+  ASSERT_TRUE(decrypted_small.ok()) << decrypted_small.status();
+  EXPECT_EQ(small_pt, decrypted_small.ValueOrDie());
+  auto decrypted_bulk = reference->Decrypt(bulk_ct_result.ValueOrDie(), "aad");
+  ASSERT_TRUE(decrypted_bulk.ok()) << decrypted_bulk.status();
+  EXPECT_EQ(bulk_pt, decrypted_bulk.ValueOrDie());
+}
+
+TEST(CryptoProviderRegistryTest, SingleProviderAeadHasNoDispatchLayer) {
+  CryptoProviderRegistry registry;
+  util::SecretData key = Random::GetRandomKeyBytes(16);
+  auto aead_result = registry.NewAesGcmAead(key);
+  ASSERT_TRUE(aead_result.ok()) << aead_result.status();
+  auto aead = std::move(aead_result.ValueOrDie());
+  auto ct_result = aead->Encrypt("plaintext", "aad");
+  ASSERT_TRUE(ct_result.ok()) << ct_result.status();
+  auto pt_result = aead->Decrypt(ct_result.ValueOrDie(), "aad");
+  ASSERT_TRUE(pt_result.ok()) << pt_result.status();
+  EXPECT_EQ("plaintext", pt_result.ValueOrDie());
+}
+
+}  // namespace
+}  // namespace subtle
+}  // namespace tink
+}  // namespace crypto
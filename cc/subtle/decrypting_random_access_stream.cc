@@ -17,17 +17,23 @@
 #include "tink/subtle/decrypting_random_access_stream.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <vector>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/memory/memory.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
 #include "tink/random_access_stream.h"
+#include "tink/subtle/stream_index_footer.h"
 #include "tink/subtle/stream_segment_decrypter.h"
 #include "tink/util/buffer.h"
+#include "tink/util/buffer_pool.h"
 #include "tink/util/errors.h"
+#include "tink/util/execution_context.h"
 #include "tink/util/status.h"
 #include "tink/util/statusor.h"
 
@@ -45,6 +51,15 @@ using crypto::tink::util::StatusOr;
 StatusOr<std::unique_ptr<RandomAccessStream>> DecryptingRandomAccessStream::New(
     std::unique_ptr<StreamSegmentDecrypter> segment_decrypter,
     std::unique_ptr<RandomAccessStream> ciphertext_source) {
+  return New(std::move(segment_decrypter), std::move(ciphertext_source),
+             Options());
+}
+
+// static
+StatusOr<std::unique_ptr<RandomAccessStream>> DecryptingRandomAccessStream::New(
+    std::unique_ptr<StreamSegmentDecrypter> segment_decrypter,
+    std::unique_ptr<RandomAccessStream> ciphertext_source,
+    const Options& options) {
   if (segment_decrypter == nullptr) {
     return Status(util::error::INVALID_ARGUMENT,
                   "segment_decrypter must be non-null");
@@ -53,11 +68,40 @@ StatusOr<std::unique_ptr<RandomAccessStream>> DecryptingRandomAccessStream::New(
     return Status(util::error::INVALID_ARGUMENT,
                   "cipertext_source must be non-null");
   }
+  if (options.readahead_segments < 0) {
+    return Status(util::error::INVALID_ARGUMENT,
+                  "readahead_segments must be non-negative");
+  }
+  if (options.readahead_segments > 0 && options.readahead_workers < 1) {
+    return Status(util::error::INVALID_ARGUMENT,
+                  "readahead_workers must be positive");
+  }
+  if (options.pread_workers < 1) {
+    return Status(util::error::INVALID_ARGUMENT,
+                  "pread_workers must be positive");
+  }
+  if (options.plaintext_cache_max_bytes < 0) {
+    return Status(util::error::INVALID_ARGUMENT,
+                  "plaintext_cache_max_bytes must be non-negative");
+  }
   std::unique_ptr<DecryptingRandomAccessStream> dec_stream(
       new DecryptingRandomAccessStream());
   absl::MutexLock lock(&(dec_stream->status_mutex_));
   dec_stream->segment_decrypter_ = std::move(segment_decrypter);
   dec_stream->ct_source_ = std::move(ciphertext_source);
+  dec_stream->pread_workers_ = options.pread_workers;
+  dec_stream->readahead_segments_ = options.readahead_segments;
+  {
+    absl::MutexLock readahead_lock(&(dec_stream->readahead_mutex_));
+    dec_stream->shutting_down_ = false;
+  }
+  dec_stream->plaintext_cache_max_bytes_ = options.plaintext_cache_max_bytes;
+  dec_stream->ciphertext_size_ = options.ciphertext_size;
+  dec_stream->use_index_footer_ = options.use_index_footer;
+  {
+    absl::MutexLock cache_lock(&(dec_stream->cache_mutex_));
+    dec_stream->cache_bytes_ = 0;
+  }
 
   if (dec_stream->segment_decrypter_->get_ciphertext_offset() < 0) {
     return util::Status(util::error::INVALID_ARGUMENT,
@@ -73,9 +117,26 @@ StatusOr<std::unique_ptr<RandomAccessStream>> DecryptingRandomAccessStream::New(
   }
   dec_stream->status_ =
       Status(util::error::UNAVAILABLE, "The header hasn't been read yet.");
+  if (options.readahead_segments > 0) {
+    DecryptingRandomAccessStream* raw_stream = dec_stream.get();
+    for (int i = 0; i < options.readahead_workers; i++) {
+      dec_stream->readahead_workers_.emplace_back(
+          [raw_stream]() { raw_stream->ReadaheadWorkerLoop(); });
+    }
+  }
   return {std::move(dec_stream)};
 }
 
+DecryptingRandomAccessStream::~DecryptingRandomAccessStream() {
+  {
+    absl::MutexLock lock(&readahead_mutex_);
+    shutting_down_ = true;
+  }
+  for (auto& worker : readahead_workers_) {
+    if (worker.joinable()) worker.join();
+  }
+}
+
 util::Status DecryptingRandomAccessStream::PRead(int64_t position, int count,
                                                  Buffer* dest_buffer) {
   if (dest_buffer == nullptr) {
@@ -144,14 +205,42 @@ void DecryptingRandomAccessStream::InitializeIfNeeded()
   ct_segment_size_ = segment_decrypter_->get_ciphertext_segment_size();
   pt_segment_size_ = segment_decrypter_->get_plaintext_segment_size();
   ct_segment_overhead_ = ct_segment_size_ - pt_segment_size_;
-
-  // Calculate the number of segments and the plaintext size.
-  StatusOr<int64_t> ct_size_result = ct_source_->size();
-  if (!ct_size_result.ok()) {
-    status_ = ct_size_result.status();
+  auto pool_result = util::BufferPool::New(ct_segment_size_);
+  if (!pool_result.ok()) {
+    status_ = ToStatusF(util::error::INVALID_ARGUMENT,
+                        "Invalid ciphertext segment size %d.",
+                        ct_segment_size_);
     return;
   }
-  int64_t ct_size = ct_size_result.ValueOrDie();
+  ct_buffer_pool_ = std::move(pool_result.ValueOrDie());
+
+  // Calculate the number of segments and the plaintext size. A caller that
+  // already knows the ciphertext size (e.g. from object-store metadata)
+  // passes it via Options, which skips the size()-probe of the source.
+  int64_t ct_size;
+  if (ciphertext_size_ >= 0) {
+    ct_size = ciphertext_size_;
+  } else {
+    StatusOr<int64_t> ct_size_result = ct_source_->size();
+    if (!ct_size_result.ok()) {
+      status_ = ct_size_result.status();
+      return;
+    }
+    ct_size = ct_size_result.ValueOrDie();
+  }
+
+  // If the stream carries an index footer, read it and exclude its bytes
+  // from the ciphertext; its contents are cross-checked against the
+  // geometry derived from the ciphertext size below.
+  StreamIndexFooter footer;
+  if (use_index_footer_) {
+    auto footer_size_result = ReadIndexFooter(ct_size, &footer);
+    if (!footer_size_result.ok()) {
+      status_ = footer_size_result.status();
+      return;
+    }
+    ct_size -= footer_size_result.ValueOrDie();
+  }
   // ct_segment_size_ is always larger than 1, thus full_segment_count is always
   // smaller than std::numeric_limits<int64_t>::max().
   int64_t full_segment_count = ct_size / ct_segment_size_;
@@ -181,6 +270,58 @@ void DecryptingRandomAccessStream::InitializeIfNeeded()
     return;
   }
   pt_size_ = ct_size - overhead;
+  ct_data_size_ = ct_size;
+
+  // The footer is not covered by the AEAD authentication; accept it only
+  // if it agrees with the geometry derived from the ciphertext size.
+  if (use_index_footer_ && (footer.segment_count != segment_count_ ||
+                            footer.plaintext_size != pt_size_)) {
+    status_ = Status(util::error::INVALID_ARGUMENT,
+                     "index footer does not match the ciphertext");
+    return;
+  }
+}
+
+StatusOr<int> DecryptingRandomAccessStream::ReadIndexFooter(
+    int64_t ct_size, StreamIndexFooter* footer) {
+  if (ct_size < kStreamIndexFooterTailSize) {
+    return Status(util::error::INVALID_ARGUMENT,
+                  "ciphertext too short to hold an index footer");
+  }
+  auto tail_buf_result = Buffer::New(kStreamIndexFooterTailSize);
+  if (!tail_buf_result.ok()) return tail_buf_result.status();
+  auto tail_buf = std::move(tail_buf_result.ValueOrDie());
+  auto pread_status = ct_source_->PRead(ct_size - kStreamIndexFooterTailSize,
+                                        kStreamIndexFooterTailSize,
+                                        tail_buf.get());
+  if (!pread_status.ok() &&
+      !(pread_status.error_code() == util::error::OUT_OF_RANGE &&
+        tail_buf->size() == kStreamIndexFooterTailSize)) {
+    return pread_status;
+  }
+  auto footer_size_result = GetStreamIndexFooterSize(absl::string_view(
+      tail_buf->get_mem_block(), tail_buf->size()));
+  if (!footer_size_result.ok()) return footer_size_result.status();
+  int footer_size = footer_size_result.ValueOrDie();
+  if (footer_size > ct_size) {
+    return Status(util::error::INVALID_ARGUMENT,
+                  "invalid index footer size");
+  }
+  auto footer_buf_result = Buffer::New(footer_size);
+  if (!footer_buf_result.ok()) return footer_buf_result.status();
+  auto footer_buf = std::move(footer_buf_result.ValueOrDie());
+  pread_status =
+      ct_source_->PRead(ct_size - footer_size, footer_size, footer_buf.get());
+  if (!pread_status.ok() &&
+      !(pread_status.error_code() == util::error::OUT_OF_RANGE &&
+        footer_buf->size() == footer_size)) {
+    return pread_status;
+  }
+  auto footer_result = ParseStreamIndexFooter(absl::string_view(
+      footer_buf->get_mem_block(), footer_buf->size()));
+  if (!footer_result.ok()) return footer_result.status();
+  *footer = std::move(footer_result.ValueOrDie());
+  return footer_size;
 }
 
 int DecryptingRandomAccessStream::GetPlaintextOffset(int64_t pt_position) {
@@ -214,14 +355,23 @@ util::Status DecryptingRandomAccessStream::ReadAndDecryptSegment(
     segment_size = ct_segment_size_ - ct_position;
   }
   bool is_last_segment = (segment_nr == segment_count_ - 1);
+  if (use_index_footer_ && ct_position + segment_size > ct_data_size_) {
+    // The index footer follows the last segment; read exactly the
+    // remaining ciphertext bytes so the footer is not fed to decryption.
+    if (ct_position >= ct_data_size_) {
+      return Status(util::error::OUT_OF_RANGE, "EOF");
+    }
+    segment_size = ct_data_size_ - ct_position;
+  }
   auto pread_status = ct_source_->PRead(ct_position, segment_size, ct_buffer);
   if (pread_status.ok() ||
       (is_last_segment && ct_buffer->size() > 0 &&
        pread_status.error_code() == util::error::OUT_OF_RANGE)) {
     // some bytes were read
     auto dec_status = segment_decrypter_->DecryptSegment(
-        std::vector<uint8_t>(ct_buffer->get_mem_block(),
-                             ct_buffer->get_mem_block() + ct_buffer->size()),
+        absl::MakeConstSpan(
+            reinterpret_cast<const uint8_t*>(ct_buffer->get_mem_block()),
+            ct_buffer->size()),
         segment_nr, is_last_segment, pt_segment);
     if (dec_status.ok()) {
       return is_last_segment ?
@@ -232,6 +382,135 @@ util::Status DecryptingRandomAccessStream::ReadAndDecryptSegment(
   return pread_status;
 }
 
+bool DecryptingRandomAccessStream::ReadaheadWorkerHasWork() const {
+  return !readahead_queue_.empty() || shutting_down_;
+}
+
+// static
+bool DecryptingRandomAccessStream::SegmentNotInProgress(ReadaheadWait* arg) {
+  const auto& in_progress = arg->stream->readahead_in_progress_;
+  return std::find(in_progress.begin(), in_progress.end(), arg->segment_nr) ==
+         in_progress.end();
+}
+
+void DecryptingRandomAccessStream::ScheduleReadahead(int64_t segment_nr) {
+  if (readahead_segments_ == 0) return;
+  absl::MutexLock lock(&readahead_mutex_);
+  for (int i = 1; i <= readahead_segments_; i++) {
+    int64_t next = segment_nr + i;
+    // The last segment is not prefetched, as ReadAndDecryptSegment uses
+    // an OUT_OF_RANGE status both for EOF and for read failures there.
+    if (next >= segment_count_ - 1) break;
+    if (CacheContains(next)) continue;
+    if (prefetched_segments_.count(next) > 0) continue;
+    if (std::find(readahead_in_progress_.begin(),
+                  readahead_in_progress_.end(),
+                  next) != readahead_in_progress_.end()) {
+      continue;
+    }
+    if (std::find(readahead_queue_.begin(), readahead_queue_.end(), next) !=
+        readahead_queue_.end()) {
+      continue;
+    }
+    readahead_queue_.push_back(next);
+  }
+}
+
+bool DecryptingRandomAccessStream::TakePrefetchedSegment(
+    int64_t segment_nr, std::vector<uint8_t>* pt_segment) {
+  if (readahead_segments_ == 0) return false;
+  absl::MutexLock lock(&readahead_mutex_);
+  // If a worker is prefetching this very segment right now, wait for it
+  // rather than decrypting the same segment a second time.
+  ReadaheadWait wait_arg = {this, segment_nr};
+  readahead_mutex_.Await(absl::Condition(&SegmentNotInProgress, &wait_arg));
+  auto it = prefetched_segments_.find(segment_nr);
+  if (it == prefetched_segments_.end()) return false;
+  *pt_segment = std::move(it->second);
+  prefetched_segments_.erase(it);
+  return true;
+}
+
+void DecryptingRandomAccessStream::ReadaheadWorkerLoop() {
+  while (true) {
+    int64_t segment_nr;
+    {
+      absl::MutexLock lock(&readahead_mutex_);
+      readahead_mutex_.Await(absl::Condition(
+          this, &DecryptingRandomAccessStream::ReadaheadWorkerHasWork));
+      if (shutting_down_) return;
+      segment_nr = readahead_queue_.front();
+      readahead_queue_.pop_front();
+      readahead_in_progress_.push_back(segment_nr);
+    }
+
+    auto ct_buffer = ct_buffer_pool_->Rent();
+    std::vector<uint8_t> pt_segment;
+    util::Status status =
+        ReadAndDecryptSegment(segment_nr, ct_buffer.get(), &pt_segment);
+
+    absl::MutexLock lock(&readahead_mutex_);
+    readahead_in_progress_.erase(
+        std::find(readahead_in_progress_.begin(),
+                  readahead_in_progress_.end(), segment_nr));
+    // Errors are not cached; the next foreground read of this segment
+    // retries and surfaces them.
+    if (status.ok()) {
+      prefetched_segments_[segment_nr] = std::move(pt_segment);
+      // Keep the number of buffered segments bounded; evict the lowest
+      // segment numbers, which a mostly-sequential reader has passed by.
+      while (prefetched_segments_.size() >
+             static_cast<size_t>(2 * readahead_segments_)) {
+        prefetched_segments_.erase(prefetched_segments_.begin());
+      }
+    }
+  }
+}
+
+bool DecryptingRandomAccessStream::CacheLookup(
+    int64_t segment_nr, std::vector<uint8_t>* pt_segment) {
+  if (plaintext_cache_max_bytes_ == 0) return false;
+  absl::MutexLock lock(&cache_mutex_);
+  auto it = plaintext_cache_.find(segment_nr);
+  if (it == plaintext_cache_.end()) return false;
+  pt_segment->assign(it->second.plaintext.begin(), it->second.plaintext.end());
+  // Move the segment to the front of the LRU order.
+  cache_lru_order_.erase(it->second.lru_it);
+  cache_lru_order_.push_front(segment_nr);
+  it->second.lru_it = cache_lru_order_.begin();
+  return true;
+}
+
+void DecryptingRandomAccessStream::CacheInsert(
+    int64_t segment_nr, const std::vector<uint8_t>& pt_segment) {
+  if (plaintext_cache_max_bytes_ == 0 ||
+      static_cast<int64_t>(pt_segment.size()) > plaintext_cache_max_bytes_) {
+    return;
+  }
+  absl::MutexLock lock(&cache_mutex_);
+  if (plaintext_cache_.count(segment_nr) > 0) return;
+  cache_lru_order_.push_front(segment_nr);
+  CacheEntry& entry = plaintext_cache_[segment_nr];
+  entry.plaintext.assign(pt_segment.begin(), pt_segment.end());
+  entry.lru_it = cache_lru_order_.begin();
+  cache_bytes_ += pt_segment.size();
+  // Evict the least recently used segments while over the limit;
+  // their SecretData zeroizes the plaintext upon destruction.
+  while (cache_bytes_ > plaintext_cache_max_bytes_) {
+    int64_t evicted_nr = cache_lru_order_.back();
+    cache_lru_order_.pop_back();
+    auto evicted_it = plaintext_cache_.find(evicted_nr);
+    cache_bytes_ -= evicted_it->second.plaintext.size();
+    plaintext_cache_.erase(evicted_it);
+  }
+}
+
+bool DecryptingRandomAccessStream::CacheContains(int64_t segment_nr) const {
+  if (plaintext_cache_max_bytes_ == 0) return false;
+  absl::MutexLock lock(&cache_mutex_);
+  return plaintext_cache_.count(segment_nr) > 0;
+}
+
 util::Status DecryptingRandomAccessStream::PReadAndDecrypt(
     int64_t position, int count, Buffer* dest_buffer) {
   if (position < 0 || count < 0 || dest_buffer == nullptr
@@ -256,21 +535,37 @@ util::Status DecryptingRandomAccessStream::PReadAndDecrypt(
                     "position is larger than stream size");
     }
   }
-  auto ct_buffer_result = Buffer::New(ct_segment_size_);
-  if (!ct_buffer_result.ok()) {
-    return ToStatusF(util::error::INVALID_ARGUMENT,
-                     "Invalid ciphertext segment size %d.",
-                     ct_segment_size_);
+  // A request spanning several segments is fanned out across concurrent
+  // sub-reads of the ciphertext source, so that storage with queue depth
+  // serves the segments in parallel instead of one round trip at a time.
+  if (pread_workers_ > 1 && count > 0) {
+    int64_t last_segment_nr =
+        std::min(GetSegmentNr(position + count - 1), segment_count_ - 1);
+    if (last_segment_nr > GetSegmentNr(position)) {
+      return PReadAndDecryptParallel(position, count, dest_buffer);
+    }
   }
-  auto ct_buffer = std::move(ct_buffer_result.ValueOrDie());
+
+  auto ct_buffer = ct_buffer_pool_->Rent();
   std::vector<uint8_t> pt_segment;
   int remaining = count;
   int read_count = 0;
   int pt_offset = GetPlaintextOffset(position);
   while (remaining > 0) {
     auto segment_nr = GetSegmentNr(position + read_count);
-    auto status =
-        ReadAndDecryptSegment(segment_nr, ct_buffer.get(), &pt_segment);
+    util::Status status;
+    if (CacheLookup(segment_nr, &pt_segment)) {
+      // Only successfully decrypted non-last segments are cached.
+      status = util::Status::OK;
+    } else if (TakePrefetchedSegment(segment_nr, &pt_segment)) {
+      // Prefetched segments are never the last one, see ScheduleReadahead.
+      status = util::Status::OK;
+      CacheInsert(segment_nr, pt_segment);
+    } else {
+      status = ReadAndDecryptSegment(segment_nr, ct_buffer.get(), &pt_segment);
+      if (status.ok()) CacheInsert(segment_nr, pt_segment);
+    }
+    ScheduleReadahead(segment_nr);
     if (status.ok() || status.error_code() == util::error::OUT_OF_RANGE) {
       int pt_count = pt_segment.size() - pt_offset;
       int to_copy_count = std::min(pt_count, remaining);
@@ -291,6 +586,71 @@ util::Status DecryptingRandomAccessStream::PReadAndDecrypt(
   return util::Status::OK;
 }
 
+util::Status DecryptingRandomAccessStream::PReadAndDecryptParallel(
+    int64_t position, int count, Buffer* dest_buffer) {
+  int64_t first_segment_nr = GetSegmentNr(position);
+  int64_t last_segment_nr =
+      std::min(GetSegmentNr(position + count - 1), segment_count_ - 1);
+  // One slot per covered segment; slot i holds segment first_segment_nr + i.
+  struct SegmentResult {
+    util::Status status;
+    std::vector<uint8_t> plaintext;
+  };
+  std::vector<SegmentResult> results(last_segment_nr - first_segment_nr + 1);
+  std::atomic<size_t> next_slot(0);
+  // Workers claim slots through next_slot; each fetches and decrypts its
+  // segment with its own pooled ciphertext buffer. Cache and readahead are
+  // consulted exactly as on the serial path.
+  auto work = [this, first_segment_nr, &results, &next_slot]() {
+    while (true) {
+      size_t slot = next_slot.fetch_add(1);
+      if (slot >= results.size()) return;
+      int64_t segment_nr = first_segment_nr + static_cast<int64_t>(slot);
+      std::vector<uint8_t>* pt_segment = &results[slot].plaintext;
+      if (CacheLookup(segment_nr, pt_segment)) continue;
+      if (TakePrefetchedSegment(segment_nr, pt_segment)) {
+        CacheInsert(segment_nr, *pt_segment);
+        continue;
+      }
+      auto ct_buffer = ct_buffer_pool_->Rent();
+      results[slot].status =
+          ReadAndDecryptSegment(segment_nr, ct_buffer.get(), pt_segment);
+      if (results[slot].status.ok()) CacheInsert(segment_nr, *pt_segment);
+    }
+  };
+  int worker_count = static_cast<int>(std::min(
+      static_cast<size_t>(pread_workers_), results.size()));
+  util::RunParallelWork(/* context= */ nullptr, worker_count, work);
+  ScheduleReadahead(last_segment_nr);
+
+  // Assemble the plaintext in segment order, with the same status
+  // semantics as the serial loop in PReadAndDecrypt.
+  int remaining = count;
+  int read_count = 0;
+  int pt_offset = GetPlaintextOffset(position);
+  for (SegmentResult& result : results) {
+    if (remaining <= 0) break;
+    if (!result.status.ok() &&
+        result.status.error_code() != util::error::OUT_OF_RANGE) {
+      return result.status;
+    }
+    int pt_count = result.plaintext.size() - pt_offset;
+    int to_copy_count = std::min(pt_count, remaining);
+    auto s = dest_buffer->set_size(read_count + to_copy_count);
+    if (!s.ok()) return s;
+    std::memcpy(dest_buffer->get_mem_block() + read_count,
+                result.plaintext.data() + pt_offset, to_copy_count);
+    pt_offset = 0;
+    if (result.status.error_code() == util::error::OUT_OF_RANGE &&
+        to_copy_count == pt_count) {
+      return result.status;
+    }
+    read_count += to_copy_count;
+    remaining = count - dest_buffer->size();
+  }
+  return util::Status::OK;
+}
+
 StatusOr<int64_t> DecryptingRandomAccessStream::size() {
   {  // Initialize, if not initialized yet.
     absl::MutexLock lock(&status_mutex_);
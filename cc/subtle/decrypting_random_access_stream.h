@@ -17,12 +17,20 @@
 #ifndef TINK_SUBTLE_DECRYPTING_RANDOM_ACCESS_STREAM_H_
 #define TINK_SUBTLE_DECRYPTING_RANDOM_ACCESS_STREAM_H_
 
+#include <deque>
+#include <list>
+#include <map>
 #include <memory>
+#include <thread>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/synchronization/mutex.h"
 #include "tink/random_access_stream.h"
+#include "tink/subtle/stream_index_footer.h"
 #include "tink/subtle/stream_segment_decrypter.h"
+#include "tink/util/buffer_pool.h"
+#include "tink/util/secret_data.h"
 #include "tink/util/statusor.h"
 
 namespace crypto {
@@ -41,6 +49,49 @@ namespace subtle {
 // Instances of this class are thread safe.
 class DecryptingRandomAccessStream : public crypto::tink::RandomAccessStream {
  public:
+  // Options that control optional performance features of the stream.
+  struct Options {
+    // Number of segments following the most recently read one that are
+    // fetched and decrypted in the background, so that mostly-sequential
+    // readers do not stall on a pread+decrypt round trip per segment.
+    // 0 (the default) disables readahead.
+    int readahead_segments = 0;
+    // Number of worker threads used for readahead; relevant only if
+    // readahead_segments > 0. With readahead enabled, 'ciphertext_source'
+    // and 'segment_decrypter' must support concurrent PRead- resp.
+    // DecryptSegment-calls (both are thread-safe for the standard Tink
+    // implementations).
+    int readahead_workers = 2;
+    // Maximum number of concurrent sub-reads a single PRead spanning
+    // several segments issues against 'ciphertext_source', so that storage
+    // with queue depth (NVMe, object stores) serves the segments in
+    // parallel instead of one round trip at a time. With a value above 1,
+    // 'ciphertext_source' and 'segment_decrypter' must support concurrent
+    // PRead- resp. DecryptSegment-calls (both are thread-safe for the
+    // standard Tink implementations). 1 (the default) keeps segment reads
+    // serial.
+    int pread_workers = 1;
+    // Maximum total size (in bytes) of decrypted segments kept in an LRU
+    // cache, so that repeated reads of hot segments become a plain copy
+    // instead of a pread+decrypt round trip. The cached plaintext is stored
+    // in SecretData and thus zeroized upon eviction.
+    // 0 (the default) disables the cache.
+    int64_t plaintext_cache_max_bytes = 0;
+    // Size of the ciphertext stream in bytes, if the caller already knows
+    // it (e.g. from object-store metadata); initialization then skips the
+    // size()-probe of 'ciphertext_source'. A negative value (the default)
+    // means unknown, and the size is queried from the source.
+    int64_t ciphertext_size = -1;
+    // Whether the ciphertext ends in a stream index footer (see
+    // tink/subtle/stream_index_footer.h), i.e. was written with
+    // StreamingAeadEncryptingStream::NewWithIndexFooter(). The stream
+    // geometry is then taken from the footer (cross-checked against the
+    // ciphertext size) and the footer bytes are excluded from decryption.
+    // Must match the writer: a ciphertext without a footer fails to
+    // initialize when this is set, and vice versa.
+    bool use_index_footer = false;
+  };
+
   // A factory that produces decrypting random access streams.
   // The returned stream is a wrapper around 'ciphertext_source',
   // such that any bytes written via the wrapper are AEAD-decrypted
@@ -51,6 +102,13 @@ class DecryptingRandomAccessStream : public crypto::tink::RandomAccessStream {
   New(std::unique_ptr<StreamSegmentDecrypter> segment_decrypter,
       std::unique_ptr<crypto::tink::RandomAccessStream> ciphertext_source);
 
+  // As above, with explicit 'options' (see Options above).
+  static crypto::tink::util::StatusOr<
+      std::unique_ptr<crypto::tink::RandomAccessStream>>
+  New(std::unique_ptr<StreamSegmentDecrypter> segment_decrypter,
+      std::unique_ptr<crypto::tink::RandomAccessStream> ciphertext_source,
+      const Options& options);
+
   // -----------------------
   // Methods of RandomAccessStream-interface implemented by this class.
   crypto::tink::util::Status PRead(
@@ -58,10 +116,18 @@ class DecryptingRandomAccessStream : public crypto::tink::RandomAccessStream {
       crypto::tink::util::Buffer* dest_buffer) override;
   crypto::tink::util::StatusOr<int64_t> size() override;
 
+  ~DecryptingRandomAccessStream() override;
+
  private:
   DecryptingRandomAccessStream() {}
   crypto::tink::util::Status PReadAndDecrypt(
       int64_t position, int count, crypto::tink::util::Buffer* dest_buffer);
+  // Variant of PReadAndDecrypt for requests spanning more than one segment:
+  // fetches and decrypts the covered segments concurrently (with up to
+  // pread_workers_ sub-reads of ct_source_ in flight) and assembles the
+  // plaintext in segment order. Used only if pread_workers_ > 1.
+  crypto::tink::util::Status PReadAndDecryptParallel(
+      int64_t position, int count, crypto::tink::util::Buffer* dest_buffer);
   // Reads the specified ciphertext segment from ct_source_, decrypts it,
   // and writes the resulting plaintext bytes to pt_segment.
   // Uses the provided ct_buffer as a buffer for the ciphertext segment.
@@ -76,6 +142,40 @@ class DecryptingRandomAccessStream : public crypto::tink::RandomAccessStream {
   // by reading the stream header from ct_source_ and using it initialize
   // segment_decrypter_.
   void InitializeIfNeeded();
+  // Reads and parses the index footer at the end of the ciphertext stream
+  // of total size 'ct_size'; on success fills '*footer' and returns the
+  // size of the serialized footer in bytes.
+  crypto::tink::util::StatusOr<int> ReadIndexFooter(int64_t ct_size,
+                                                    StreamIndexFooter* footer);
+
+  // Readahead machinery; used only if readahead_segments_ > 0.
+  // Schedules background read+decrypt of up to readahead_segments_ segments
+  // following 'segment_nr'.
+  void ScheduleReadahead(int64_t segment_nr);
+  // If 'segment_nr' has been prefetched, moves its plaintext to 'pt_segment'
+  // and returns true.
+  bool TakePrefetchedSegment(int64_t segment_nr,
+                             std::vector<uint8_t>* pt_segment);
+  void ReadaheadWorkerLoop();
+  bool ReadaheadWorkerHasWork() const
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(readahead_mutex_);
+  // Argument of the condition used to wait until a worker has finished
+  // prefetching a specific segment.
+  struct ReadaheadWait {
+    DecryptingRandomAccessStream* stream;
+    int64_t segment_nr;
+  };
+  static bool SegmentNotInProgress(ReadaheadWait* arg);
+
+  // Plaintext-segment LRU cache; used only if plaintext_cache_max_bytes_ > 0.
+  // If 'segment_nr' is cached, copies its plaintext to 'pt_segment', marks
+  // the segment as most recently used, and returns true.
+  bool CacheLookup(int64_t segment_nr, std::vector<uint8_t>* pt_segment);
+  // Caches the plaintext of 'segment_nr', evicting the least recently used
+  // segments while the cache exceeds plaintext_cache_max_bytes_.
+  void CacheInsert(int64_t segment_nr, const std::vector<uint8_t>& pt_segment);
+  bool CacheContains(int64_t segment_nr) const;
+
   std::unique_ptr<StreamSegmentDecrypter> segment_decrypter_;
   std::unique_ptr<crypto::tink::RandomAccessStream> ct_source_;
 
@@ -88,6 +188,42 @@ class DecryptingRandomAccessStream : public crypto::tink::RandomAccessStream {
   int ct_segment_overhead_;
   int64_t segment_count_;
   int64_t pt_size_;
+  // Size of the ciphertext up to (and excluding) the index footer; equal to
+  // the full ciphertext size for streams without a footer.
+  int64_t ct_data_size_;
+  // Ciphertext size provided by the caller, or -1 if unknown.
+  int64_t ciphertext_size_;
+  bool use_index_footer_;
+  // Pool of reusable ciphertext-segment buffers, shared by the foreground
+  // reads and the readahead workers; created upon initialization.
+  std::unique_ptr<crypto::tink::util::BufferPool> ct_buffer_pool_;
+
+  int pread_workers_;
+  int readahead_segments_;
+  mutable absl::Mutex readahead_mutex_;
+  // Segments scheduled for prefetching, in scheduling order.
+  std::deque<int64_t> readahead_queue_ ABSL_GUARDED_BY(readahead_mutex_);
+  // Segments currently being prefetched by a worker.
+  std::vector<int64_t> readahead_in_progress_ ABSL_GUARDED_BY(readahead_mutex_);
+  // Prefetched plaintext segments, keyed by segment number.
+  std::map<int64_t, std::vector<uint8_t>> prefetched_segments_
+      ABSL_GUARDED_BY(readahead_mutex_);
+  bool shutting_down_ ABSL_GUARDED_BY(readahead_mutex_);
+  std::vector<std::thread> readahead_workers_;
+
+  struct CacheEntry {
+    crypto::tink::util::SecretData plaintext;
+    // Position of the segment in cache_lru_order_.
+    std::list<int64_t>::iterator lru_it;
+  };
+  int64_t plaintext_cache_max_bytes_;
+  mutable absl::Mutex cache_mutex_;
+  // Cached plaintext segments, keyed by segment number.
+  std::map<int64_t, CacheEntry> plaintext_cache_ ABSL_GUARDED_BY(cache_mutex_);
+  // Segment numbers in LRU order; the most recently used one is at the front.
+  std::list<int64_t> cache_lru_order_ ABSL_GUARDED_BY(cache_mutex_);
+  // Total size (in bytes) of the cached plaintext segments.
+  int64_t cache_bytes_ ABSL_GUARDED_BY(cache_mutex_);
 };
 
 }  // namespace subtle
@@ -27,6 +27,7 @@
 #include "tink/random_access_stream.h"
 #include "tink/streaming_aead.h"
 #include "tink/subtle/random.h"
+#include "tink/subtle/streaming_aead_encrypting_stream.h"
 #include "tink/subtle/test_util.h"
 #include "tink/util/file_random_access_stream.h"
 #include "tink/util/ostream_output_stream.h"
@@ -41,6 +42,7 @@ namespace {
 
 using crypto::tink::subtle::test::DummyStreamingAead;
 using crypto::tink::subtle::test::DummyStreamSegmentDecrypter;
+using crypto::tink::subtle::test::DummyStreamSegmentEncrypter;
 using crypto::tink::test::GetTestFileDescriptor;
 using crypto::tink::test::IsOk;
 using crypto::tink::test::StatusIs;
@@ -226,6 +228,316 @@ TEST(DecryptingRandomAccessStreamTest, BasicDecryption) {
   }
 }
 
+TEST(DecryptingRandomAccessStreamTest, BasicDecryptionWithReadahead) {
+  DecryptingRandomAccessStream::Options options;
+  options.readahead_segments = 4;
+  options.readahead_workers = 2;
+  for (int pt_size : {1, 5, 20, 42, 100, 1000, 10000}) {
+    std::string plaintext = subtle::Random::GetRandomBytes(pt_size);
+    for (int pt_segment_size : {50, 100, 123}) {
+      for (int header_size : {5, 10, 15}) {
+        for (int ct_offset : {0, 1, 5, 12}) {
+          SCOPED_TRACE(absl::StrCat(
+              "pt_size = ", pt_size, ", pt_segment_size = ", pt_segment_size,
+              ", header_size = ", header_size, ", ct_offset = ", ct_offset));
+          DummyStreamingAead saead(pt_segment_size, header_size, ct_offset);
+          // Pre-compute the ciphertext.
+          auto ciphertext =
+              GetCiphertextSource(&saead, plaintext, "some aad", ct_offset);
+          // Check the decryption of the pre-computed ciphertext.
+          auto seg_decrypter = absl::make_unique<DummyStreamSegmentDecrypter>(
+              pt_segment_size, header_size, ct_offset);
+          auto dec_stream_result = DecryptingRandomAccessStream::New(
+              std::move(seg_decrypter), std::move(ciphertext), options);
+          EXPECT_THAT(dec_stream_result.status(), IsOk());
+          auto dec_stream = std::move(dec_stream_result.ValueOrDie());
+          EXPECT_EQ(pt_size, dec_stream->size().ValueOrDie());
+          std::string decrypted;
+          auto status = ReadAll(dec_stream.get(), &decrypted);
+          EXPECT_THAT(status,
+                      StatusIs(util::error::OUT_OF_RANGE, HasSubstr("EOF")));
+          EXPECT_EQ(plaintext, decrypted);
+        }
+      }
+    }
+  }
+}
+
+TEST(DecryptingRandomAccessStreamTest, ParallelMultiSegmentPRead) {
+  DecryptingRandomAccessStream::Options options;
+  options.pread_workers = 4;
+  int pt_size = 10000;
+  std::string plaintext = subtle::Random::GetRandomBytes(pt_size);
+  for (int pt_segment_size : {100, 123}) {
+    for (int ct_offset : {0, 5}) {
+      SCOPED_TRACE(absl::StrCat("pt_segment_size = ", pt_segment_size,
+                                ", ct_offset = ", ct_offset));
+      int header_size = 5;
+      DummyStreamingAead saead(pt_segment_size, header_size, ct_offset);
+      auto ciphertext =
+          GetCiphertextSource(&saead, plaintext, "some aad", ct_offset);
+      auto seg_decrypter = absl::make_unique<DummyStreamSegmentDecrypter>(
+          pt_segment_size, header_size, ct_offset);
+      auto dec_stream_result = DecryptingRandomAccessStream::New(
+          std::move(seg_decrypter), std::move(ciphertext), options);
+      ASSERT_THAT(dec_stream_result.status(), IsOk());
+      auto dec_stream = std::move(dec_stream_result.ValueOrDie());
+
+      // A single PRead spanning all segments, served by concurrent
+      // sub-reads, yields the same bytes and EOF status as serial reads.
+      auto buffer = std::move(util::Buffer::New(pt_size).ValueOrDie());
+      auto status = dec_stream->PRead(0, pt_size, buffer.get());
+      EXPECT_THAT(status, StatusIs(util::error::OUT_OF_RANGE,
+                                   HasSubstr("EOF")));
+      EXPECT_EQ(plaintext,
+                std::string(buffer->get_mem_block(), buffer->size()));
+
+      // A multi-segment slice in the middle of the stream.
+      int position = pt_segment_size / 2;
+      int count = 3 * pt_segment_size;
+      auto slice_buffer = std::move(util::Buffer::New(count).ValueOrDie());
+      EXPECT_THAT(dec_stream->PRead(position, count, slice_buffer.get()),
+                  IsOk());
+      EXPECT_EQ(plaintext.substr(position, count),
+                std::string(slice_buffer->get_mem_block(),
+                            slice_buffer->size()));
+    }
+  }
+}
+
+TEST(DecryptingRandomAccessStreamTest, InvalidPReadWorkersOption) {
+  DecryptingRandomAccessStream::Options options;
+  options.pread_workers = 0;
+  EXPECT_THAT(
+      DecryptingRandomAccessStream::New(
+          absl::make_unique<DummyStreamSegmentDecrypter>(
+              /* pt_segment_size = */ 100, /* header_size = */ 20,
+              /* ct_offset = */ 0),
+          absl::make_unique<DummyRandomAccessStream>(
+              /* stream_size = */ 100, /* ct_offset = */ 0),
+          options)
+          .status(),
+      StatusIs(util::error::INVALID_ARGUMENT, HasSubstr("pread_workers")));
+}
+
+TEST(DecryptingRandomAccessStreamTest, PlaintextCache) {
+  int pt_size = 10000;
+  int pt_segment_size = 100;
+  int header_size = 10;
+  int ct_offset = 0;
+  std::string plaintext = subtle::Random::GetRandomBytes(pt_size);
+  DummyStreamingAead saead(pt_segment_size, header_size, ct_offset);
+  auto ciphertext =
+      GetCiphertextSource(&saead, plaintext, "some aad", ct_offset);
+  auto seg_decrypter = absl::make_unique<DummyStreamSegmentDecrypter>(
+      pt_segment_size, header_size, ct_offset);
+  // A reference to the segment decrypter, to observe the decrypted volume.
+  DummyStreamSegmentDecrypter* seg_decrypter_ref = seg_decrypter.get();
+  DecryptingRandomAccessStream::Options options;
+  options.plaintext_cache_max_bytes = 1 << 20;  // holds all segments
+  auto dec_stream_result = DecryptingRandomAccessStream::New(
+      std::move(seg_decrypter), std::move(ciphertext), options);
+  EXPECT_THAT(dec_stream_result.status(), IsOk());
+  auto dec_stream = std::move(dec_stream_result.ValueOrDie());
+
+  int chunk_size = 250;
+  auto buffer = std::move(util::Buffer::New(chunk_size).ValueOrDie());
+  int64_t position = 4200;
+  EXPECT_THAT(dec_stream->PRead(position, chunk_size, buffer.get()), IsOk());
+  EXPECT_EQ(0, std::memcmp(plaintext.data() + position,
+                           buffer->get_mem_block(), buffer->size()));
+  int64_t decrypted_after_first_read =
+      seg_decrypter_ref->get_generated_output_size();
+
+  // Repeated reads of the same region must be served from the cache,
+  // without further decryption work.
+  for (int i = 0; i < 10; i++) {
+    EXPECT_THAT(dec_stream->PRead(position, chunk_size, buffer.get()), IsOk());
+    EXPECT_EQ(0, std::memcmp(plaintext.data() + position,
+                             buffer->get_mem_block(), buffer->size()));
+  }
+  EXPECT_EQ(decrypted_after_first_read,
+            seg_decrypter_ref->get_generated_output_size());
+}
+
+TEST(DecryptingRandomAccessStreamTest, PlaintextCacheEviction) {
+  int pt_size = 10000;
+  int pt_segment_size = 100;
+  int header_size = 10;
+  int ct_offset = 0;
+  std::string plaintext = subtle::Random::GetRandomBytes(pt_size);
+  DummyStreamingAead saead(pt_segment_size, header_size, ct_offset);
+  auto ciphertext =
+      GetCiphertextSource(&saead, plaintext, "some aad", ct_offset);
+  auto seg_decrypter = absl::make_unique<DummyStreamSegmentDecrypter>(
+      pt_segment_size, header_size, ct_offset);
+  DecryptingRandomAccessStream::Options options;
+  // Room for only a few segments, so most reads evict older entries.
+  options.plaintext_cache_max_bytes = 3 * pt_segment_size;
+  auto dec_stream_result = DecryptingRandomAccessStream::New(
+      std::move(seg_decrypter), std::move(ciphertext), options);
+  EXPECT_THAT(dec_stream_result.status(), IsOk());
+  auto dec_stream = std::move(dec_stream_result.ValueOrDie());
+
+  // Read the stream back and forth; the results must be unaffected
+  // by cache hits and evictions.
+  int chunk_size = 150;
+  auto buffer = std::move(util::Buffer::New(chunk_size).ValueOrDie());
+  for (int round = 0; round < 2; round++) {
+    for (int64_t position : {0, 9000, 4200, 150, 4250, 8888, 0, 9000}) {
+      SCOPED_TRACE(absl::StrCat("position = ", position));
+      EXPECT_THAT(dec_stream->PRead(position, chunk_size, buffer.get()),
+                  IsOk());
+      EXPECT_EQ(0, std::memcmp(plaintext.data() + position,
+                               buffer->get_mem_block(), buffer->size()));
+    }
+  }
+}
+
+TEST(DecryptingRandomAccessStreamTest, InvalidReadaheadOptions) {
+  int pt_segment_size = 100;
+  int header_size = 20;
+  int ct_offset = 0;
+  int64_t ciphertext_size = 100;
+
+  DecryptingRandomAccessStream::Options options;
+  options.readahead_segments = -1;
+  EXPECT_THAT(
+      DecryptingRandomAccessStream::New(
+          absl::make_unique<DummyStreamSegmentDecrypter>(
+              pt_segment_size, header_size, ct_offset),
+          absl::make_unique<DummyRandomAccessStream>(ciphertext_size,
+                                                     ct_offset),
+          options)
+          .status(),
+      StatusIs(util::error::INVALID_ARGUMENT,
+               HasSubstr("readahead_segments")));
+
+  options.readahead_segments = 2;
+  options.readahead_workers = 0;
+  EXPECT_THAT(
+      DecryptingRandomAccessStream::New(
+          absl::make_unique<DummyStreamSegmentDecrypter>(
+              pt_segment_size, header_size, ct_offset),
+          absl::make_unique<DummyRandomAccessStream>(ciphertext_size,
+                                                     ct_offset),
+          options)
+          .status(),
+      StatusIs(util::error::INVALID_ARGUMENT, HasSubstr("readahead_workers")));
+}
+
+TEST(DecryptingRandomAccessStreamTest, InvalidCacheOptions) {
+  int pt_segment_size = 100;
+  int header_size = 20;
+  int ct_offset = 0;
+  int64_t ciphertext_size = 100;
+
+  DecryptingRandomAccessStream::Options options;
+  options.plaintext_cache_max_bytes = -1;
+  EXPECT_THAT(
+      DecryptingRandomAccessStream::New(
+          absl::make_unique<DummyStreamSegmentDecrypter>(
+              pt_segment_size, header_size, ct_offset),
+          absl::make_unique<DummyRandomAccessStream>(ciphertext_size,
+                                                     ct_offset),
+          options)
+          .status(),
+      StatusIs(util::error::INVALID_ARGUMENT,
+               HasSubstr("plaintext_cache_max_bytes")));
+}
+
+// Returns a ciphertext ending in a stream index footer, resulting from
+// encryption of 'pt' with the dummy segment encrypter.
+std::string GetCiphertextWithFooter(int pt_segment_size, int header_size,
+                                    absl::string_view pt) {
+  auto ct_stream = absl::make_unique<std::stringstream>();
+  auto ct_buf = ct_stream->rdbuf();
+  std::unique_ptr<OutputStream> ct_destination(
+      absl::make_unique<util::OstreamOutputStream>(std::move(ct_stream)));
+  auto enc_stream_result = StreamingAeadEncryptingStream::NewWithIndexFooter(
+      absl::make_unique<DummyStreamSegmentEncrypter>(
+          pt_segment_size, header_size, /* ct_offset = */ 0),
+      std::move(ct_destination));
+  EXPECT_THAT(enc_stream_result.status(), IsOk());
+  EXPECT_THAT(WriteToStream(enc_stream_result.ValueOrDie().get(), pt), IsOk());
+  return ct_buf->str();
+}
+
+TEST(DecryptingRandomAccessStreamTest, DecryptionWithIndexFooter) {
+  DecryptingRandomAccessStream::Options options;
+  options.use_index_footer = true;
+  for (int pt_size : {1, 20, 42, 100, 1000, 10000}) {
+    std::string plaintext = subtle::Random::GetRandomBytes(pt_size);
+    for (int pt_segment_size : {50, 100, 123}) {
+      for (int header_size : {5, 10, 15}) {
+        SCOPED_TRACE(absl::StrCat(
+            "pt_size = ", pt_size, ", pt_segment_size = ", pt_segment_size,
+            ", header_size = ", header_size));
+        std::string ciphertext =
+            GetCiphertextWithFooter(pt_segment_size, header_size, plaintext);
+        auto seg_decrypter = absl::make_unique<DummyStreamSegmentDecrypter>(
+            pt_segment_size, header_size, /* ct_offset = */ 0);
+        auto dec_stream_result = DecryptingRandomAccessStream::New(
+            std::move(seg_decrypter), GetRandomAccessStream(ciphertext),
+            options);
+        EXPECT_THAT(dec_stream_result.status(), IsOk());
+        auto dec_stream = std::move(dec_stream_result.ValueOrDie());
+        EXPECT_EQ(pt_size, dec_stream->size().ValueOrDie());
+        std::string decrypted;
+        auto status = ReadAll(dec_stream.get(), &decrypted);
+        EXPECT_THAT(status,
+                    StatusIs(util::error::OUT_OF_RANGE, HasSubstr("EOF")));
+        EXPECT_EQ(plaintext, decrypted);
+      }
+    }
+  }
+}
+
+TEST(DecryptingRandomAccessStreamTest, IndexFooterWithKnownCiphertextSize) {
+  int pt_segment_size = 100;
+  int header_size = 10;
+  std::string plaintext = subtle::Random::GetRandomBytes(1000);
+  std::string ciphertext =
+      GetCiphertextWithFooter(pt_segment_size, header_size, plaintext);
+
+  // Pass the ciphertext size via options, as a caller with object-store
+  // metadata would; initialization then does not probe the source's size().
+  DecryptingRandomAccessStream::Options options;
+  options.use_index_footer = true;
+  options.ciphertext_size = ciphertext.size();
+  auto dec_stream_result = DecryptingRandomAccessStream::New(
+      absl::make_unique<DummyStreamSegmentDecrypter>(
+          pt_segment_size, header_size, /* ct_offset = */ 0),
+      GetRandomAccessStream(ciphertext), options);
+  EXPECT_THAT(dec_stream_result.status(), IsOk());
+  auto dec_stream = std::move(dec_stream_result.ValueOrDie());
+  EXPECT_EQ(plaintext.size(), dec_stream->size().ValueOrDie());
+  std::string decrypted;
+  auto status = ReadAll(dec_stream.get(), &decrypted);
+  EXPECT_THAT(status, StatusIs(util::error::OUT_OF_RANGE, HasSubstr("EOF")));
+  EXPECT_EQ(plaintext, decrypted);
+}
+
+TEST(DecryptingRandomAccessStreamTest, MissingIndexFooterIsRejected) {
+  int pt_segment_size = 100;
+  int header_size = 10;
+  int ct_offset = 0;
+  std::string plaintext = subtle::Random::GetRandomBytes(1000);
+  DummyStreamingAead saead(pt_segment_size, header_size, ct_offset);
+  // A ciphertext without a footer, read with use_index_footer set.
+  auto ciphertext = GetCiphertextSource(&saead, plaintext, "aad", ct_offset);
+  DecryptingRandomAccessStream::Options options;
+  options.use_index_footer = true;
+  auto dec_stream_result = DecryptingRandomAccessStream::New(
+      absl::make_unique<DummyStreamSegmentDecrypter>(
+          pt_segment_size, header_size, ct_offset),
+      std::move(ciphertext), options);
+  EXPECT_THAT(dec_stream_result.status(), IsOk());
+  auto dec_stream = std::move(dec_stream_result.ValueOrDie());
+  EXPECT_THAT(dec_stream->size().status(),
+              StatusIs(util::error::INVALID_ARGUMENT));
+}
+
 TEST(DecryptingRandomAccessStreamTest, SelectiveDecryption) {
   for (int pt_size : {1, 20, 42, 100, 1000, 10000}) {
     std::string plaintext = subtle::Random::GetRandomBytes(pt_size);
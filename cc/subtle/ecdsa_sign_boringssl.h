@@ -20,6 +20,7 @@
 #include <memory>
 
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "tink/internal/fips_utils.h"
 #include "tink/subtle/common_enums.h"
 #include "tink/subtle/subtle_util_boringssl.h"
@@ -43,6 +44,16 @@ class EcdsaSignBoringSsl : public PublicKeySign {
   crypto::tink::util::StatusOr<std::string> Sign(
       absl::string_view data) const override;
 
+  // The exact DER bound resp. IEEE_P1363 size for the key's curve,
+  // precomputed at construction.
+  size_t MaxSignatureSize() const override { return max_signature_size_; }
+
+  // Writes the signature directly into 'out'. Apart from BoringSSL's
+  // internal workings, signing into a caller-provided buffer does not
+  // allocate in either encoding.
+  crypto::tink::util::StatusOr<size_t> SignInto(
+      absl::string_view data, absl::Span<char> out) const override;
+
   static constexpr crypto::tink::internal::FipsCompatibility kFipsStatus =
       crypto::tink::internal::FipsCompatibility::kRequiresBoringCrypto;
 
@@ -53,6 +64,12 @@ class EcdsaSignBoringSsl : public PublicKeySign {
   bssl::UniquePtr<EC_KEY> key_;
   const EVP_MD* hash_;  // Owned by BoringSSL.
   EcdsaSignatureEncoding encoding_;
+  // Size of the curve's field elements, derived from key_ once so the
+  // IEEE_P1363 encoding path does not recompute it per signature.
+  const size_t field_size_in_bytes_;
+  // Upper bound on the signature size in the configured encoding, derived
+  // from key_ once at construction.
+  const size_t max_signature_size_;
 };
 
 }  // namespace subtle
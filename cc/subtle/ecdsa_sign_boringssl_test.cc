@@ -19,6 +19,7 @@
 #include <string>
 
 #include "gtest/gtest.h"
+#include "absl/types/span.h"
 #include "tink/public_key_sign.h"
 #include "tink/public_key_verify.h"
 #include "tink/config/tink_fips.h"
@@ -145,6 +146,51 @@ TEST_F(EcdsaSignBoringSslTest, testSignatureSizesWithIEEE_P1364Encoding) {
   }
 }
 
+TEST_F(EcdsaSignBoringSslTest, testSignInto) {
+  if (IsFipsModeEnabled() && !FIPS_mode()) {
+    GTEST_SKIP()
+        << "Test is skipped if kOnlyUseFips but BoringCrypto is unavailable.";
+  }
+  subtle::EcdsaSignatureEncoding encodings[2] = {
+      EcdsaSignatureEncoding::DER, EcdsaSignatureEncoding::IEEE_P1363};
+  for (EcdsaSignatureEncoding encoding : encodings) {
+    auto ec_key = SubtleUtilBoringSSL::GetNewEcKey(EllipticCurveType::NIST_P256)
+                      .ValueOrDie();
+    auto signer_result =
+        EcdsaSignBoringSsl::New(ec_key, HashType::SHA256, encoding);
+    ASSERT_TRUE(signer_result.ok()) << signer_result.status();
+    auto signer = std::move(signer_result.ValueOrDie());
+
+    auto verifier_result =
+        EcdsaVerifyBoringSsl::New(ec_key, HashType::SHA256, encoding);
+    ASSERT_TRUE(verifier_result.ok()) << verifier_result.status();
+    auto verifier = std::move(verifier_result.ValueOrDie());
+
+    std::string message = "some data to be signed";
+    std::string buffer(signer->MaxSignatureSize(), '\0');
+    auto size_result =
+        signer->SignInto(message, absl::Span<char>(&buffer[0], buffer.size()));
+    ASSERT_TRUE(size_result.ok()) << size_result.status();
+    size_t signature_size = size_result.ValueOrDie();
+    EXPECT_LE(signature_size, signer->MaxSignatureSize());
+    if (encoding == EcdsaSignatureEncoding::IEEE_P1363) {
+      // IEEE_P1363 signatures have the exact size 2 * field_size.
+      EXPECT_EQ(signature_size, signer->MaxSignatureSize());
+    }
+    auto status = verifier->Verify(buffer.substr(0, signature_size), message);
+    EXPECT_TRUE(status.ok()) << status;
+
+    // A buffer smaller than MaxSignatureSize() is rejected.
+    std::string small_buffer(signer->MaxSignatureSize() - 1, '\0');
+    EXPECT_THAT(
+        signer
+            ->SignInto(message, absl::Span<char>(&small_buffer[0],
+                                                 small_buffer.size()))
+            .status(),
+        StatusIs(util::error::INVALID_ARGUMENT));
+  }
+}
+
 TEST_F(EcdsaSignBoringSslTest, testNewErrors) {
   if (IsFipsModeEnabled() && !FIPS_mode()) {
     GTEST_SKIP()
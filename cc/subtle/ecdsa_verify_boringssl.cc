@@ -79,6 +79,7 @@ util::Status EcdsaVerifyBoringSsl::Verify(absl::string_view signature,
   // BoringSSL expects a non-null pointer for data,
   // regardless of whether the size is 0.
   data = SubtleUtilBoringSSL::EnsureNonNull(data);
+  signature = SubtleUtilBoringSSL::EnsureNonNull(signature);
 
   // Compute the digest.
   unsigned int digest_size;
@@ -88,22 +89,36 @@ util::Status EcdsaVerifyBoringSsl::Verify(absl::string_view signature,
     return util::Status(util::error::INTERNAL, "Could not compute digest.");
   }
 
-  std::string derSig(signature);
   if (encoding_ == subtle::EcdsaSignatureEncoding::IEEE_P1363) {
-    const EC_GROUP* group = EC_KEY_get0_group(key_.get());
-    auto status_or_der =
-        SubtleUtilBoringSSL::EcSignatureIeeeToDer(group, signature);
-
-    if (!status_or_der.ok()) {
-      return status_or_der.status();
+    // Parse r and s directly and verify the raw signature; no intermediate
+    // DER encoding that ECDSA_verify would only parse again.
+    if (signature.size() != 2 * field_size_in_bytes_) {
+      return util::Status(util::error::INVALID_ARGUMENT,
+                          "Signature is not valid.");
+    }
+    bssl::UniquePtr<ECDSA_SIG> sig(ECDSA_SIG_new());
+    const uint8_t* sig_bytes =
+        reinterpret_cast<const uint8_t*>(signature.data());
+    if (sig.get() == nullptr ||
+        nullptr == BN_bin2bn(sig_bytes, field_size_in_bytes_, sig->r) ||
+        nullptr == BN_bin2bn(sig_bytes + field_size_in_bytes_,
+                             field_size_in_bytes_, sig->s)) {
+      return util::Status(util::error::INTERNAL,
+                          "Internal BoringSSL BN_bin2bn's error");
+    }
+    if (1 != ECDSA_do_verify(digest, digest_size, sig.get(), key_.get())) {
+      // signature is invalid
+      return util::Status(util::error::INVALID_ARGUMENT,
+                          "Signature is not valid.");
     }
-    derSig = status_or_der.ValueOrDie();
+    // signature is valid
+    return util::Status::OK;
   }
 
-  // Verify the signature.
+  // Verify the DER signature straight from the input; no copy.
   if (1 != ECDSA_verify(0 /* unused */, digest, digest_size,
-                        reinterpret_cast<const uint8_t*>(derSig.data()),
-                        derSig.size(), key_.get())) {
+                        reinterpret_cast<const uint8_t*>(signature.data()),
+                        signature.size(), key_.get())) {
     // signature is invalid
     return util::Status(util::error::INVALID_ARGUMENT,
                         "Signature is not valid.");
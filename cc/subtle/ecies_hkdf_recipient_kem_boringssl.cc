@@ -73,6 +73,8 @@ EciesHkdfNistPCurveRecipientKemBoringSsl::
                                              EC_GROUP* ec_group)
     : curve_(curve),
       priv_key_value_(std::move(priv_key_value)),
+      priv_key_bn_(BN_bin2bn(priv_key_value_.data(), priv_key_value_.size(),
+                             nullptr)),
       ec_group_(ec_group) {}
 
 util::StatusOr<util::SecretData>
@@ -88,10 +90,11 @@ EciesHkdfNistPCurveRecipientKemBoringSsl::GenerateKey(
   }
   bssl::UniquePtr<EC_POINT> pub_key =
       std::move(status_or_ec_point.ValueOrDie());
-  bssl::UniquePtr<BIGNUM> priv_key(
-      BN_bin2bn(priv_key_value_.data(), priv_key_value_.size(), nullptr));
+  if (priv_key_bn_ == nullptr) {
+    return util::Status(util::error::INTERNAL, "invalid private key");
+  }
   auto shared_secret_or = SubtleUtilBoringSSL::ComputeEcdhSharedSecret(
-      curve_, priv_key.get(), pub_key.get());
+      curve_, priv_key_bn_.get(), pub_key.get());
   if (!shared_secret_or.ok()) {
     return shared_secret_or.status();
   }
@@ -18,6 +18,7 @@
 #define TINK_SUBTLE_ECIES_HKDF_RECIPIENT_KEM_BORINGSSL_H_
 
 #include "absl/strings/string_view.h"
+#include "openssl/bn.h"
 #include "openssl/curve25519.h"
 #include "openssl/ec.h"
 #include "tink/internal/fips_utils.h"
@@ -78,6 +79,10 @@ class EciesHkdfNistPCurveRecipientKemBoringSsl
 
   EllipticCurveType curve_;
   util::SecretData priv_key_value_;
+  // The private key as a BIGNUM, converted once at construction so that
+  // repeated KEM operations with the same key don't re-parse the
+  // big-endian bytes.
+  bssl::UniquePtr<BIGNUM> priv_key_bn_;
   bssl::UniquePtr<EC_GROUP> ec_group_;
 };
 
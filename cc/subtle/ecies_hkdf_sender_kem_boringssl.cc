@@ -172,7 +172,8 @@ EciesHkdfX25519SendKemBoringSsl::GenerateKey(
     return symmetric_key_or.status();
   }
   util::SecretData symmetric_key = symmetric_key_or.ValueOrDie();
-  return absl::make_unique<const KemKey>(kem_bytes, symmetric_key);
+  return absl::make_unique<const KemKey>(std::move(kem_bytes),
+                                         std::move(symmetric_key));
 }
 
 }  // namespace subtle
@@ -16,14 +16,12 @@
 
 #include "tink/subtle/ed25519_sign_boringssl.h"
 
-#include <algorithm>
-#include <iterator>
-
 #include "absl/memory/memory.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
 #include "openssl/curve25519.h"
 #include "tink/public_key_sign.h"
+#include "tink/subtle/subtle_util.h"
 #include "tink/subtle/subtle_util_boringssl.h"
 #include "tink/util/statusor.h"
 
@@ -51,16 +49,19 @@ util::StatusOr<std::string> Ed25519SignBoringSsl::Sign(
     absl::string_view data) const {
   data = SubtleUtilBoringSSL::EnsureNonNull(data);
 
-  uint8_t out_sig[ED25519_SIGNATURE_LEN];
-  std::fill(std::begin(out_sig), std::end(out_sig), 0);
-
-  if (ED25519_sign(
-          out_sig, reinterpret_cast<const uint8_t *>(data.data()), data.size(),
-          reinterpret_cast<const uint8_t *>(private_key_.data())) != 1) {
+  // ED25519_sign re-derives the expanded scalar from the seed internally on
+  // every call; BoringSSL's public API has no entry point that accepts a
+  // precomputed expansion (those helpers live in its internal FIPS module),
+  // so signing the 64-byte output directly into the result string is all the
+  // per-call work we can shed here.
+  std::string signature;
+  ResizeStringUninitialized(&signature, ED25519_SIGNATURE_LEN);
+  if (ED25519_sign(reinterpret_cast<uint8_t *>(&signature[0]),
+                   reinterpret_cast<const uint8_t *>(data.data()), data.size(),
+                   private_key_.data()) != 1) {
     return util::Status(util::error::INTERNAL, "Signing failed.");
   }
-
-  return std::string(reinterpret_cast<char *>(out_sig), ED25519_SIGNATURE_LEN);
+  return signature;
 }
 
 }  // namespace subtle
@@ -20,6 +20,7 @@
 
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "openssl/curve25519.h"
 #include "tink/public_key_verify.h"
 #include "tink/subtle/subtle_util_boringssl.h"
@@ -71,6 +72,39 @@ util::Status Ed25519VerifyBoringSsl::Verify(absl::string_view signature,
   return util::Status::OK;
 }
 
+util::Status Ed25519VerifyBoringSsl::VerifyBatch(
+    absl::Span<const SignatureAndData> batch) const {
+  // Validate all signature sizes before doing any expensive curve
+  // operations, so malformed batches are rejected cheaply.
+  for (size_t i = 0; i < batch.size(); i++) {
+    if (batch[i].signature.size() != ED25519_SIGNATURE_LEN) {
+      return util::Status(
+          util::error::INVALID_ARGUMENT,
+          absl::StrFormat("Invalid ED25519 signature size (%d) at index %d. "
+                          "The signature must be %d bytes long.",
+                          batch[i].signature.size(), i, ED25519_SIGNATURE_LEN));
+    }
+  }
+  // BoringSSL does not expose a batch verification entry point with shared
+  // scalar accumulation, so the signatures are verified one by one; keeping
+  // the batch in a single call still saves the per-signature dispatch and
+  // size validation, and lets a batched implementation slot in later.
+  const uint8_t* public_key =
+      reinterpret_cast<const uint8_t*>(public_key_.data());
+  for (size_t i = 0; i < batch.size(); i++) {
+    absl::string_view data = SubtleUtilBoringSSL::EnsureNonNull(batch[i].data);
+    if (1 != ED25519_verify(
+                 reinterpret_cast<const uint8_t*>(data.data()), data.size(),
+                 reinterpret_cast<const uint8_t*>(batch[i].signature.data()),
+                 public_key)) {
+      return util::Status(
+          util::error::INVALID_ARGUMENT,
+          absl::StrFormat("Signature at index %d is not valid.", i));
+    }
+  }
+  return util::Status::OK;
+}
+
 }  // namespace subtle
 }  // namespace tink
 }  // namespace crypto
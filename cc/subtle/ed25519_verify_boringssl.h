@@ -21,6 +21,7 @@
 #include <string>
 
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "tink/internal/fips_utils.h"
 #include "tink/public_key_verify.h"
 #include "tink/util/statusor.h"
@@ -38,6 +39,20 @@ class Ed25519VerifyBoringSsl : public PublicKeyVerify {
   crypto::tink::util::Status Verify(absl::string_view signature,
                                     absl::string_view data) const override;
 
+  // A (signature, data) pair for VerifyBatch.
+  struct SignatureAndData {
+    absl::string_view signature;
+    absl::string_view data;
+  };
+
+  // Verifies all pairs in 'batch' under this verifier's public key.
+  // Returns OK only if every signature is valid for its data, and fails
+  // fast on the first invalid entry. All signature sizes are validated
+  // up front, so a malformed entry is reported before any verification
+  // work is done.
+  crypto::tink::util::Status VerifyBatch(
+      absl::Span<const SignatureAndData> batch) const;
+
   static constexpr crypto::tink::internal::FipsCompatibility kFipsStatus =
       crypto::tink::internal::FipsCompatibility::kNotFips;
 
@@ -17,9 +17,11 @@
 #include "tink/subtle/ed25519_verify_boringssl.h"
 
 #include <string>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
 #include "openssl/curve25519.h"
 #include "tink/public_key_sign.h"
 #include "tink/public_key_verify.h"
@@ -84,6 +86,62 @@ TEST_F(Ed25519VerifyBoringSslTest, testBasicSign) {
   EXPECT_FALSE(status.ok());
 }
 
+TEST_F(Ed25519VerifyBoringSslTest, testVerifyBatch) {
+  if (IsFipsModeEnabled()) {
+    GTEST_SKIP()
+        << "Test assumes kOnlyUseFips is false.";
+  }
+
+  // Generate a new key pair.
+  uint8_t out_public_key[ED25519_PUBLIC_KEY_LEN];
+  uint8_t out_private_key[ED25519_PRIVATE_KEY_LEN];
+
+  ED25519_keypair(out_public_key, out_private_key);
+
+  std::string public_key(reinterpret_cast<const char*>(out_public_key),
+                         ED25519_PUBLIC_KEY_LEN);
+  util::SecretData private_key(out_private_key,
+                               out_private_key + ED25519_PRIVATE_KEY_LEN);
+
+  auto signer = std::move(Ed25519SignBoringSsl::New(private_key).ValueOrDie());
+  auto verifier =
+      std::move(Ed25519VerifyBoringSsl::New(public_key).ValueOrDie());
+  // VerifyBatch is an extension of Ed25519VerifyBoringSsl and not part of
+  // the PublicKeyVerify interface.
+  auto* batch_verifier = static_cast<Ed25519VerifyBoringSsl*>(verifier.get());
+
+  std::vector<std::string> messages;
+  std::vector<std::string> signatures;
+  for (int i = 0; i < 16; i++) {
+    messages.push_back(std::string(i * 7, 'a' + i));
+    signatures.push_back(signer->Sign(messages.back()).ValueOrDie());
+  }
+  std::vector<Ed25519VerifyBoringSsl::SignatureAndData> batch;
+  for (int i = 0; i < 16; i++) {
+    batch.push_back({signatures[i], messages[i]});
+  }
+
+  // An empty batch and a batch of valid signatures verify.
+  EXPECT_TRUE(batch_verifier
+                  ->VerifyBatch(absl::Span<
+                                const Ed25519VerifyBoringSsl::SignatureAndData>(
+                      batch.data(), 0))
+                  .ok());
+  auto status = batch_verifier->VerifyBatch(batch);
+  EXPECT_TRUE(status.ok()) << status;
+
+  // A single invalid signature fails the whole batch.
+  std::string modified_signature = signatures[7];
+  modified_signature[0] ^= 1;
+  batch[7].signature = modified_signature;
+  EXPECT_FALSE(batch_verifier->VerifyBatch(batch).ok());
+  batch[7].signature = signatures[7];
+
+  // A malformed signature size is rejected.
+  batch[3].signature = "too short";
+  EXPECT_FALSE(batch_verifier->VerifyBatch(batch).ok());
+}
+
 TEST_F(Ed25519VerifyBoringSslTest, testInvalidPublicKeys) {
   if (IsFipsModeEnabled()) {
     GTEST_SKIP()
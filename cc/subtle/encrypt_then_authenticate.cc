@@ -17,31 +17,54 @@
 #include "tink/subtle/encrypt_then_authenticate.h"
 
 #include <cstdint>
+#include <cstring>
 #include <string>
 #include <vector>
 
 #include "absl/strings/string_view.h"
-#include "absl/strings/str_cat.h"
 #include "tink/aead.h"
 #include "tink/mac.h"
 #include "tink/subtle/ind_cpa_cipher.h"
+#include "tink/subtle/mac/stateful_mac.h"
+#include "tink/subtle/subtle_util.h"
 #include "tink/subtle/subtle_util_boringssl.h"
 #include "tink/util/errors.h"
 #include "tink/util/status.h"
 #include "tink/util/statusor.h"
+#include "openssl/mem.h"
 
 
 namespace crypto {
 namespace tink {
 namespace subtle {
 
-static const std::string longToBigEndianStr(uint64_t value) {
-  uint8_t bytes[8];
-  for (int i = sizeof(bytes) - 1; i >= 0; i--) {
+static void longToBigEndian(uint64_t value, char* bytes) {
+  for (int i = 7; i >= 0; i--) {
     bytes[i] = value & 0xff;
     value >>= 8;
   }
-  return std::string(reinterpret_cast<const char*>(&bytes[0]), sizeof(bytes));
+}
+
+static const std::string longToBigEndianStr(uint64_t value) {
+  std::string bytes(8, '\0');
+  longToBigEndian(value, &bytes[0]);
+  return bytes;
+}
+
+// Assembles additional_data || ciphertext || big-endian aad size in bits --
+// the data the legacy (non-stateful) MAC is computed over -- into 'buffer',
+// which stays on the stack for small payloads.
+static absl::string_view assembleToAuthData(absl::string_view additional_data,
+                                            absl::string_view ciphertext,
+                                            uint64_t aad_size_in_bits,
+                                            SmallBuffer* buffer) {
+  char* out = buffer->data();
+  std::memcpy(out, additional_data.data(), additional_data.size());
+  std::memcpy(out + additional_data.size(), ciphertext.data(),
+              ciphertext.size());
+  longToBigEndian(aad_size_in_bits,
+                  out + additional_data.size() + ciphertext.size());
+  return absl::string_view(buffer->data(), buffer->size());
 }
 
 util::StatusOr<std::unique_ptr<Aead>> EncryptThenAuthenticate::New(
@@ -55,6 +78,41 @@ util::StatusOr<std::unique_ptr<Aead>> EncryptThenAuthenticate::New(
   return std::move(aead);
 }
 
+util::StatusOr<std::unique_ptr<Aead>> EncryptThenAuthenticate::New(
+    std::unique_ptr<IndCpaCipher> ind_cpa_cipher,
+    std::unique_ptr<StatefulMacFactory> stateful_mac_factory,
+    uint8_t tag_size) {
+  if (tag_size < kMinTagSizeInBytes) {
+    return util::Status(util::error::INVALID_ARGUMENT, "tag size too small");
+  }
+  std::unique_ptr<Aead> aead(new EncryptThenAuthenticate(
+      std::move(ind_cpa_cipher), std::move(stateful_mac_factory), tag_size));
+  return std::move(aead);
+}
+
+util::StatusOr<std::string> EncryptThenAuthenticate::ComputeTag(
+    absl::string_view additional_data, absl::string_view ciphertext,
+    uint64_t aad_size_in_bits) const {
+  auto stateful_mac = stateful_mac_factory_->Create();
+  if (!stateful_mac.ok()) {
+    return stateful_mac.status();
+  }
+  auto status = stateful_mac.ValueOrDie()->Update(additional_data);
+  if (!status.ok()) {
+    return status;
+  }
+  status = stateful_mac.ValueOrDie()->Update(ciphertext);
+  if (!status.ok()) {
+    return status;
+  }
+  status = stateful_mac.ValueOrDie()->Update(longToBigEndianStr(
+      aad_size_in_bits));
+  if (!status.ok()) {
+    return status;
+  }
+  return stateful_mac.ValueOrDie()->Finalize();
+}
+
 util::StatusOr<std::string> EncryptThenAuthenticate::Encrypt(
     absl::string_view plaintext, absl::string_view additional_data) const {
   // BoringSSL expects a non-null pointer for plaintext and additional_data,
@@ -73,11 +131,25 @@ util::StatusOr<std::string> EncryptThenAuthenticate::Encrypt(
   if (!ct.ok()) {
     return ct.status();
   }
-  std::string ciphertext(ct.ValueOrDie());
-  std::string toAuthData = absl::StrCat(additional_data, ciphertext,
-                                        longToBigEndianStr(aad_size_in_bits));
+  std::string ciphertext(std::move(ct.ValueOrDie()));
+
+  if (stateful_mac_factory_ != nullptr) {
+    // Feed the parts of the authenticated data into the MAC incrementally,
+    // without concatenating them into a temporary string first.
+    auto tag = ComputeTag(additional_data, ciphertext, aad_size_in_bits);
+    if (!tag.ok()) {
+      return tag.status();
+    }
+    if (tag.ValueOrDie().size() != tag_size_) {
+      return util::Status(util::error::INTERNAL, "invalid tag size");
+    }
+    return ciphertext.append(tag.ValueOrDie());
+  }
 
-  auto tag = mac_->ComputeMac(toAuthData);
+  SmallBuffer to_auth_data_buffer(additional_data.size() + ciphertext.size() +
+                                  8);
+  auto tag = mac_->ComputeMac(assembleToAuthData(
+      additional_data, ciphertext, aad_size_in_bits, &to_auth_data_buffer));
   if (!tag.ok()) {
     return tag.status();
   }
@@ -106,12 +178,28 @@ util::StatusOr<std::string> EncryptThenAuthenticate::Decrypt(
 
   auto payload = ciphertext.substr(0, ciphertext.size() - tag_size_);
   auto tag = ciphertext.substr(ciphertext.size() - tag_size_, tag_size_);
-  std::string toAuthData = absl::StrCat(additional_data, payload,
-                                        longToBigEndianStr(aad_size_in_bits));
 
-  auto verified = mac_->VerifyMac(tag, toAuthData);
-  if (!verified.ok()) {
-    return verified;
+  if (stateful_mac_factory_ != nullptr) {
+    // Recompute the tag incrementally and compare in constant time.
+    auto computed_tag = ComputeTag(additional_data, payload, aad_size_in_bits);
+    if (!computed_tag.ok()) {
+      return computed_tag.status();
+    }
+    if (computed_tag.ValueOrDie().size() != tag_size_ ||
+        CRYPTO_memcmp(computed_tag.ValueOrDie().data(), tag.data(),
+                      tag_size_) != 0) {
+      return util::Status(util::error::INVALID_ARGUMENT,
+                          "verification failed");
+    }
+  } else {
+    SmallBuffer to_auth_data_buffer(additional_data.size() + payload.size() +
+                                    8);
+    auto verified = mac_->VerifyMac(
+        tag, assembleToAuthData(additional_data, payload, aad_size_in_bits,
+                                &to_auth_data_buffer));
+    if (!verified.ok()) {
+      return verified;
+    }
   }
 
   auto pt = ind_cpa_cipher_->Decrypt(payload);
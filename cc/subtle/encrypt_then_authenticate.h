@@ -23,6 +23,7 @@
 #include "tink/aead.h"
 #include "tink/mac.h"
 #include "tink/subtle/ind_cpa_cipher.h"
+#include "tink/subtle/mac/stateful_mac.h"
 #include "tink/util/status.h"
 #include "tink/util/statusor.h"
 
@@ -40,6 +41,15 @@ class EncryptThenAuthenticate : public Aead {
       std::unique_ptr<IndCpaCipher> ind_cpa_cipher, std::unique_ptr<Mac> mac,
       uint8_t tag_size);
 
+  // Like the overload above, but authenticates with StatefulMac instances
+  // obtained from 'stateful_mac_factory'. This avoids concatenating
+  // (additional_data || ciphertext || size of additional_data) into a
+  // temporary string before computing the MAC, saving a pass over the data.
+  static crypto::tink::util::StatusOr<std::unique_ptr<Aead>> New(
+      std::unique_ptr<IndCpaCipher> ind_cpa_cipher,
+      std::unique_ptr<StatefulMacFactory> stateful_mac_factory,
+      uint8_t tag_size);
+
   // Encrypts 'plaintext' with 'additional_data' as additional authenticated
   // data. The resulting ciphertext allows for checking authenticity and
   // integrity of additional data ({@code aad}), but does not guarantee its
@@ -66,8 +76,25 @@ class EncryptThenAuthenticate : public Aead {
         mac_(std::move(mac)),
         tag_size_(tag_size) {}
 
+  EncryptThenAuthenticate(
+      std::unique_ptr<IndCpaCipher> ind_cpa_cipher,
+      std::unique_ptr<StatefulMacFactory> stateful_mac_factory,
+      uint8_t tag_size)
+      : ind_cpa_cipher_(std::move(ind_cpa_cipher)),
+        stateful_mac_factory_(std::move(stateful_mac_factory)),
+        tag_size_(tag_size) {}
+
+  // Computes the MAC over (additional_data || ciphertext || t), where t is
+  // additional_data's length in bits, with a StatefulMac obtained from
+  // stateful_mac_factory_, i.e. without concatenating the three parts.
+  crypto::tink::util::StatusOr<std::string> ComputeTag(
+      absl::string_view additional_data, absl::string_view ciphertext,
+      uint64_t aad_size_in_bits) const;
+
   const std::unique_ptr<IndCpaCipher> ind_cpa_cipher_;
+  // Exactly one of mac_ and stateful_mac_factory_ is non-null.
   const std::unique_ptr<Mac> mac_;
+  const std::unique_ptr<StatefulMacFactory> stateful_mac_factory_;
   const uint8_t tag_size_;
 };
 
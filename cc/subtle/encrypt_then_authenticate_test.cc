@@ -20,11 +20,13 @@
 #include <vector>
 
 #include "gtest/gtest.h"
+#include "absl/memory/memory.h"
 #include "absl/strings/string_view.h"
 #include "tink/subtle/aes_ctr_boringssl.h"
 #include "tink/subtle/common_enums.h"
 #include "tink/subtle/hmac_boringssl.h"
 #include "tink/subtle/random.h"
+#include "tink/subtle/stateful_hmac_boringssl.h"
 #include "tink/util/secret_data.h"
 #include "tink/util/status.h"
 #include "tink/util/statusor.h"
@@ -109,6 +111,27 @@ util::StatusOr<std::unique_ptr<Aead>> createAead2(
   return std::move(cipher_res.ValueOrDie());
 }
 
+// Like createAead2, but authenticates with the StatefulMac-based codepath.
+util::StatusOr<std::unique_ptr<Aead>> createStatefulAead2(
+    util::SecretData encryption_key, int iv_size, util::SecretData mac_key,
+    uint8_t tag_size, HashType hash_type) {
+  auto ind_cipher_res =
+      AesCtrBoringSsl::New(std::move(encryption_key), iv_size);
+  if (!ind_cipher_res.ok()) {
+    return ind_cipher_res.status();
+  }
+
+  auto cipher_res = EncryptThenAuthenticate::New(
+      std::move(ind_cipher_res.ValueOrDie()),
+      absl::make_unique<StatefulHmacBoringSslFactory>(hash_type, tag_size,
+                                                      std::move(mac_key)),
+      tag_size);
+  if (!cipher_res.ok()) {
+    return cipher_res.status();
+  }
+  return std::move(cipher_res.ValueOrDie());
+}
+
 util::StatusOr<std::unique_ptr<Aead>> createAead(int encryption_key_size,
                                                  int iv_size, int mac_key_size,
                                                  int tag_size,
@@ -137,6 +160,83 @@ TEST(AesGcmBoringSslTest, testRfcVectors) {
   }
 }
 
+TEST(EncryptThenAuthenticateTest, testRfcVectorsWithStatefulMac) {
+  for (const TestVector& test : test_vectors) {
+    util::SecretData mac_key =
+        util::SecretDataFromStringView(test::HexDecodeOrDie(test.mac_key));
+    util::SecretData enc_key =
+        util::SecretDataFromStringView(test::HexDecodeOrDie(test.enc_key));
+    std::string ct = test::HexDecodeOrDie(test.ciphertext);
+    std::string aad = test::HexDecodeOrDie(test.aad);
+    auto res = createStatefulAead2(std::move(enc_key), test.iv_size,
+                                   std::move(mac_key), test.tag_size,
+                                   test.hash_type);
+    EXPECT_TRUE(res.ok()) << res.status();
+    auto cipher = std::move(res.ValueOrDie());
+    auto pt = cipher->Decrypt(ct, aad);
+    EXPECT_TRUE(pt.ok()) << pt.status();
+  }
+}
+
+TEST(EncryptThenAuthenticateTest, testStatefulMacInteroperability) {
+  // Ciphertexts produced with the one-shot Mac codepath must decrypt with
+  // the StatefulMac codepath and vice versa.
+  int iv_size = 12;
+  int tag_size = 16;
+  util::SecretData encryption_key = Random::GetRandomKeyBytes(16);
+  util::SecretData mac_key = Random::GetRandomKeyBytes(16);
+  auto res = createAead2(encryption_key, iv_size, mac_key, tag_size,
+                         HashType::SHA256);
+  EXPECT_TRUE(res.ok()) << res.status();
+  auto cipher = std::move(res.ValueOrDie());
+  res = createStatefulAead2(std::move(encryption_key), iv_size,
+                            std::move(mac_key), tag_size, HashType::SHA256);
+  EXPECT_TRUE(res.ok()) << res.status();
+  auto stateful_cipher = std::move(res.ValueOrDie());
+
+  for (int i = 0; i < 256; i += 17) {
+    std::string message = Random::GetRandomBytes(i);
+    std::string aad = Random::GetRandomBytes(i);
+    auto ct = cipher->Encrypt(message, aad);
+    EXPECT_TRUE(ct.ok()) << ct.status();
+    auto pt = stateful_cipher->Decrypt(ct.ValueOrDie(), aad);
+    EXPECT_TRUE(pt.ok()) << pt.status();
+    EXPECT_EQ(pt.ValueOrDie(), message);
+
+    ct = stateful_cipher->Encrypt(message, aad);
+    EXPECT_TRUE(ct.ok()) << ct.status();
+    pt = cipher->Decrypt(ct.ValueOrDie(), aad);
+    EXPECT_TRUE(pt.ok()) << pt.status();
+    EXPECT_EQ(pt.ValueOrDie(), message);
+  }
+}
+
+TEST(EncryptThenAuthenticateTest, testStatefulMacModifiedCiphertext) {
+  auto res = createStatefulAead2(Random::GetRandomKeyBytes(16), 12,
+                                 Random::GetRandomKeyBytes(16), 16,
+                                 HashType::SHA256);
+  EXPECT_TRUE(res.ok()) << res.status();
+  auto cipher = std::move(res.ValueOrDie());
+
+  std::string message = "Some data to encrypt.";
+  std::string aad = "Some data to authenticate.";
+  std::string ct = cipher->Encrypt(message, aad).ValueOrDie();
+  EXPECT_TRUE(cipher->Decrypt(ct, aad).ok());
+  // Modify the ciphertext
+  for (size_t i = 0; i < ct.size() * 8; i++) {
+    std::string modified_ct = ct;
+    modified_ct[i / 8] ^= 1 << (i % 8);
+    EXPECT_FALSE(cipher->Decrypt(modified_ct, aad).ok()) << i;
+  }
+  // Modify the additional data
+  for (size_t i = 0; i < aad.size() * 8; i++) {
+    std::string modified_aad = aad;
+    modified_aad[i / 8] ^= 1 << (i % 8);
+    auto decrypted = cipher->Decrypt(ct, modified_aad);
+    EXPECT_FALSE(decrypted.ok()) << i << " pt:" << decrypted.ValueOrDie();
+  }
+}
+
 TEST(EncryptThenAuthenticateTest, testEncryptDecrypt) {
   int encryption_key_size = 16;
   int iv_size = 12;
@@ -16,10 +16,16 @@
 
 #include "tink/subtle/hkdf.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
 #include "absl/algorithm/container.h"
 #include "absl/strings/str_cat.h"
 #include "openssl/evp.h"
 #include "openssl/hkdf.h"
+#include "openssl/hmac.h"
 #include "tink/subtle/common_enums.h"
 #include "tink/subtle/subtle_util_boringssl.h"
 #include "tink/util/status.h"
@@ -69,6 +75,108 @@ util::StatusOr<std::string> Hkdf::ComputeHkdf(HashType hash,
   return out_key;
 }
 
+// static
+util::StatusOr<util::SecretData> Hkdf::Extract(HashType hash,
+                                               const util::SecretData &ikm,
+                                               absl::string_view salt) {
+  auto status_or_evp_md = SubtleUtilBoringSSL::EvpHash(hash);
+  if (!status_or_evp_md.ok()) {
+    return status_or_evp_md.status();
+  }
+  util::SecretData prk(EVP_MAX_MD_SIZE);
+  size_t prk_len;
+  if (1 != HKDF_extract(prk.data(), &prk_len, status_or_evp_md.ValueOrDie(),
+                        ikm.data(), ikm.size(),
+                        reinterpret_cast<const uint8_t *>(salt.data()),
+                        salt.size())) {
+    return util::Status(util::error::INTERNAL,
+                        "BoringSSL's HKDF_extract failed");
+  }
+  prk.resize(prk_len);
+  return prk;
+}
+
+// static
+util::StatusOr<util::SecretData> Hkdf::Expand(HashType hash,
+                                              const util::SecretData &prk,
+                                              absl::string_view info,
+                                              size_t out_len) {
+  auto status_or_evp_md = SubtleUtilBoringSSL::EvpHash(hash);
+  if (!status_or_evp_md.ok()) {
+    return status_or_evp_md.status();
+  }
+  util::SecretData out_key(out_len);
+  if (1 != HKDF_expand(out_key.data(), out_len, status_or_evp_md.ValueOrDie(),
+                       prk.data(), prk.size(),
+                       reinterpret_cast<const uint8_t *>(info.data()),
+                       info.size())) {
+    return util::Status(util::error::INTERNAL,
+                        "BoringSSL's HKDF_expand failed");
+  }
+  return out_key;
+}
+
+// static
+util::StatusOr<std::vector<util::SecretData>> Hkdf::ComputeHkdfBatch(
+    HashType hash, const util::SecretData &ikm,
+    absl::Span<const absl::string_view> salts, absl::string_view info,
+    size_t out_len) {
+  auto status_or_evp_md = SubtleUtilBoringSSL::EvpHash(hash);
+  if (!status_or_evp_md.ok()) {
+    return status_or_evp_md.status();
+  }
+  const EVP_MD *md = status_or_evp_md.ValueOrDie();
+  const size_t digest_size = EVP_MD_size(md);
+  // By RFC 5869, Section 2.3, at most 255 output blocks can be expanded.
+  if (digest_size == 0 || out_len > 255 * digest_size) {
+    return util::Status(util::error::INVALID_ARGUMENT, "out_len too large");
+  }
+  bssl::UniquePtr<HMAC_CTX> hmac_ctx(HMAC_CTX_new());
+  if (!hmac_ctx) {
+    return util::Status(util::error::INTERNAL,
+                        "BoringSSL's HMAC_CTX_new failed");
+  }
+  std::vector<util::SecretData> out_keys;
+  out_keys.reserve(salts.size());
+  util::SecretData prk(digest_size);
+  util::SecretData ti(digest_size);
+  for (absl::string_view salt : salts) {
+    // Extract as by RFC 5869, Section 2.2: PRK = HMAC-Hash(salt, ikm).
+    // The single HMAC context is re-keyed instead of reallocated per salt.
+    if (!HMAC_Init_ex(hmac_ctx.get(), salt.data(), salt.size(), md, nullptr) ||
+        !HMAC_Update(hmac_ctx.get(), ikm.data(), ikm.size()) ||
+        !HMAC_Final(hmac_ctx.get(), prk.data(), nullptr)) {
+      return util::Status(util::error::INTERNAL, "BoringSSL's HMAC failed");
+    }
+    // Expand as by RFC 5869, Section 2.3.
+    util::SecretData out_key(out_len);
+    size_t offset = 0;
+    uint8_t i = 0;
+    while (offset < out_len) {
+      if (!HMAC_Init_ex(hmac_ctx.get(), prk.data(), prk.size(), md, nullptr)) {
+        return util::Status(util::error::INTERNAL, "BoringSSL's HMAC failed");
+      }
+      if (i != 0 && !HMAC_Update(hmac_ctx.get(), ti.data(), ti.size())) {
+        return util::Status(util::error::INTERNAL, "BoringSSL's HMAC failed");
+      }
+      uint8_t i_as_uint8 = i + 1;
+      if (!HMAC_Update(hmac_ctx.get(),
+                       reinterpret_cast<const uint8_t *>(info.data()),
+                       info.size()) ||
+          !HMAC_Update(hmac_ctx.get(), &i_as_uint8, 1) ||
+          !HMAC_Final(hmac_ctx.get(), ti.data(), nullptr)) {
+        return util::Status(util::error::INTERNAL, "BoringSSL's HMAC failed");
+      }
+      i++;
+      size_t to_copy = std::min(digest_size, out_len - offset);
+      std::copy(ti.begin(), ti.begin() + to_copy, out_key.begin() + offset);
+      offset += to_copy;
+    }
+    out_keys.push_back(std::move(out_key));
+  }
+  return out_keys;
+}
+
 util::StatusOr<util::SecretData> Hkdf::ComputeEciesHkdfSymmetricKey(
     HashType hash, absl::string_view kem_bytes,
     const util::SecretData &shared_secret, absl::string_view salt,
@@ -17,7 +17,10 @@
 #ifndef TINK_SUBTLE_HKDF_H_
 #define TINK_SUBTLE_HKDF_H_
 
+#include <vector>
+
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "tink/subtle/common_enums.h"
 #include "tink/util/secret_data.h"
 #include "tink/util/status.h"
@@ -38,6 +41,31 @@ class Hkdf {
       HashType hash, const util::SecretData& ikm, absl::string_view salt,
       absl::string_view info, size_t out_len);
 
+  // The two steps of RFC 5869 exposed separately: Extract computes the
+  // pseudorandom key PRK = HMAC-Hash(salt, ikm), Expand derives out_len
+  // bytes of output keying material from a PRK and info. Extract followed by
+  // Expand is equivalent to ComputeHkdf, but callers whose ikm and salt are
+  // both fixed (e.g. a streaming PRF keyed once per primitive) can compute
+  // the PRK once and reuse it across Expand calls, saving one HMAC key
+  // schedule plus a hash per derivation. The salt is the HMAC key of the
+  // extract step, so a PRK is only reusable while ikm AND salt are
+  // unchanged; primitives that randomize the salt per stream (such as
+  // AesGcmHkdfStreaming) cannot cache it.
+  static crypto::tink::util::StatusOr<util::SecretData> Extract(
+      HashType hash, const util::SecretData& ikm, absl::string_view salt);
+  static crypto::tink::util::StatusOr<util::SecretData> Expand(
+      HashType hash, const util::SecretData& prk, absl::string_view info,
+      size_t out_len);
+
+  // Computes one hkdf per salt, all from the same ikm and info. Equivalent
+  // to calling ComputeHkdf once per salt, but reuses a single HMAC context
+  // for all extract and expand steps, which is cheaper for workloads that
+  // derive many short keys at once (e.g. opening many encrypted streams).
+  static crypto::tink::util::StatusOr<std::vector<util::SecretData>>
+  ComputeHkdfBatch(HashType hash, const util::SecretData& ikm,
+                   absl::Span<const absl::string_view> salts,
+                   absl::string_view info, size_t out_len);
+
   // Computes symmetric key for ECIES with HKDF from the provided parameters.
   // This function follows Shoup's recommendation of including ECIES
   // ephemeral KEM bytes into the commputation of the symmetric key
@@ -116,6 +116,85 @@ TEST_F(HkdfTest, testBasicSecretData) {
   }
 }
 
+TEST_F(HkdfTest, ExtractThenExpandMatchesCompute) {
+  for (const TestVector& test : test_vector) {
+    util::SecretData ikm =
+        util::SecretDataFromStringView(test::HexDecodeOrDie(test.ikm_hex));
+    auto prk_or =
+        Hkdf::Extract(test.hash_type, ikm, test::HexDecodeOrDie(test.salt_hex));
+    ASSERT_TRUE(prk_or.ok()) << prk_or.status();
+    auto out_key_or = Hkdf::Expand(test.hash_type, prk_or.ValueOrDie(),
+                                   test::HexDecodeOrDie(test.info_hex),
+                                   test.out_len);
+    ASSERT_TRUE(out_key_or.ok()) << out_key_or.status();
+    EXPECT_EQ(
+        test::HexEncode(util::SecretDataAsStringView(out_key_or.ValueOrDie())),
+        test.out_key_hex);
+  }
+}
+
+TEST_F(HkdfTest, ExpandReusesPrkForDifferentInfos) {
+  util::SecretData ikm = util::SecretDataFromStringView("0123456789abcdef");
+  auto prk_or = Hkdf::Extract(HashType::SHA256, ikm, "salt");
+  ASSERT_TRUE(prk_or.ok());
+  const util::SecretData& prk = prk_or.ValueOrDie();
+  for (std::string info : {"info one", "info two"}) {
+    auto expanded_or = Hkdf::Expand(HashType::SHA256, prk, info, 32);
+    ASSERT_TRUE(expanded_or.ok());
+    auto computed_or = Hkdf::ComputeHkdf(HashType::SHA256, ikm, "salt", info,
+                                         32);
+    ASSERT_TRUE(computed_or.ok());
+    EXPECT_EQ(test::HexEncode(
+                  util::SecretDataAsStringView(expanded_or.ValueOrDie())),
+              test::HexEncode(
+                  util::SecretDataAsStringView(computed_or.ValueOrDie())));
+  }
+}
+
+TEST_F(HkdfTest, ExpandTooLongOutput) {
+  util::SecretData ikm = util::SecretDataFromStringView("0123456789abcdef");
+  auto prk_or = Hkdf::Extract(HashType::SHA256, ikm, "salt");
+  ASSERT_TRUE(prk_or.ok());
+  auto expanded_or =
+      Hkdf::Expand(HashType::SHA256, prk_or.ValueOrDie(), "info",
+                   255 * 32 + 1 /* 255 * hashLength + 1 */);
+  EXPECT_FALSE(expanded_or.ok());
+}
+
+TEST_F(HkdfTest, ComputeHkdfBatchMatchesSingle) {
+  for (const TestVector& test : test_vector) {
+    util::SecretData ikm =
+        util::SecretDataFromStringView(test::HexDecodeOrDie(test.ikm_hex));
+    std::string salt = test::HexDecodeOrDie(test.salt_hex);
+    std::string other_salt = "some other salt";
+    std::string info = test::HexDecodeOrDie(test.info_hex);
+    std::vector<absl::string_view> salts = {salt, other_salt, salt};
+
+    auto batch_or =
+        Hkdf::ComputeHkdfBatch(test.hash_type, ikm, salts, info, test.out_len);
+    ASSERT_TRUE(batch_or.ok()) << batch_or.status();
+    auto& batch = batch_or.ValueOrDie();
+    ASSERT_EQ(salts.size(), batch.size());
+
+    for (size_t i = 0; i < salts.size(); i++) {
+      auto single_or =
+          Hkdf::ComputeHkdf(test.hash_type, ikm, salts[i], info, test.out_len);
+      ASSERT_TRUE(single_or.ok());
+      EXPECT_EQ(test::HexEncode(util::SecretDataAsStringView(batch[i])),
+                test::HexEncode(
+                    util::SecretDataAsStringView(single_or.ValueOrDie())));
+    }
+  }
+}
+
+TEST_F(HkdfTest, ComputeHkdfBatchTooLongOutput) {
+  std::vector<absl::string_view> salts = {"salt"};
+  auto batch_or = Hkdf::ComputeHkdfBatch(
+      HashType::SHA256, util::SecretDataFromStringView("0123456789abcdef"),
+      salts, "info", 255 * 32 + 1 /* 255 * hashLength + 1 */);
+  EXPECT_FALSE(batch_or.ok());
+}
+
 TEST_F(HkdfTest, testLongOutput) {
   TestVector test = test_vector[0];
   auto status_or_string = Hkdf::ComputeHkdf(
@@ -16,6 +16,7 @@
 
 #include "tink/subtle/hmac_boringssl.h"
 
+#include <cstring>
 #include <string>
 
 #include "absl/memory/memory.h"
@@ -36,6 +37,31 @@ namespace crypto {
 namespace tink {
 namespace subtle {
 
+namespace {
+
+// Computes the full digest of 'data' into 'buf', which must hold
+// EVP_MAX_MD_SIZE bytes, by cloning 'template_ctx'. Shared by all three
+// MAC operations; none of them allocates on the heap for the tag.
+util::Status ComputeRawDigest(const HMAC_CTX* template_ctx,
+                              absl::string_view data, uint8_t* buf) {
+  // BoringSSL expects a non-null pointer for data,
+  // regardless of whether the size is 0.
+  data = SubtleUtilBoringSSL::EnsureNonNull(data);
+
+  unsigned int out_len;
+  bssl::UniquePtr<HMAC_CTX> ctx(HMAC_CTX_new());
+  if (ctx == nullptr || HMAC_CTX_copy_ex(ctx.get(), template_ctx) != 1 ||
+      HMAC_Update(ctx.get(), reinterpret_cast<const uint8_t*>(data.data()),
+                  data.size()) != 1 ||
+      HMAC_Final(ctx.get(), buf, &out_len) != 1) {
+    return util::Status(util::error::INTERNAL,
+                        "BoringSSL failed to compute HMAC");
+  }
+  return util::Status::OK;
+}
+
+}  // namespace
+
 // static
 util::StatusOr<std::unique_ptr<Mac>> HmacBoringSsl::New(HashType hash_type,
                                                         uint32_t tag_size,
@@ -57,55 +83,53 @@ util::StatusOr<std::unique_ptr<Mac>> HmacBoringSsl::New(HashType hash_type,
   if (key.size() < kMinKeySize) {
     return util::Status(util::error::INVALID_ARGUMENT, "invalid key size");
   }
-  return {absl::WrapUnique(new HmacBoringSsl(md, tag_size, std::move(key)))};
+  // Initialize a template context with the key once; this derives the inner
+  // and outer key pads, which each operation then reuses via HMAC_CTX_copy_ex.
+  bssl::UniquePtr<HMAC_CTX> ctx(HMAC_CTX_new());
+  if (ctx == nullptr ||
+      HMAC_Init_ex(ctx.get(), key.data(), key.size(), md, nullptr) != 1) {
+    return util::Status(util::error::INTERNAL,
+                        "BoringSSL failed to initialize HMAC");
+  }
+  return {absl::WrapUnique(new HmacBoringSsl(tag_size, std::move(ctx)))};
 }
 
 util::StatusOr<std::string> HmacBoringSsl::ComputeMac(
     absl::string_view data) const {
-  // BoringSSL expects a non-null pointer for data,
-  // regardless of whether the size is 0.
-  data = SubtleUtilBoringSSL::EnsureNonNull(data);
-
   uint8_t buf[EVP_MAX_MD_SIZE];
-  unsigned int out_len;
-  const uint8_t* res = HMAC(md_, key_.data(), key_.size(),
-                            reinterpret_cast<const uint8_t*>(data.data()),
-                            data.size(), buf, &out_len);
-  if (res == nullptr) {
-    // TODO(bleichen): We expect that BoringSSL supports the
-    //   hashes that we use. Maybe we should have a status that indicates
-    //   such mismatches between expected and actual behaviour.
-    return util::Status(util::error::INTERNAL,
-                        "BoringSSL failed to compute HMAC");
-  }
+  util::Status status = ComputeRawDigest(template_ctx_.get(), data, buf);
+  if (!status.ok()) return status;
   return std::string(reinterpret_cast<char*>(buf), tag_size_);
 }
 
 util::Status HmacBoringSsl::VerifyMac(
     absl::string_view mac,
     absl::string_view data) const {
-  // BoringSSL expects a non-null pointer for data,
-  // regardless of whether the size is 0.
-  data = SubtleUtilBoringSSL::EnsureNonNull(data);
-
   if (mac.size() != tag_size_) {
     return util::Status(util::error::INVALID_ARGUMENT, "incorrect tag size");
   }
   uint8_t buf[EVP_MAX_MD_SIZE];
-  unsigned int out_len;
-  const uint8_t* res = HMAC(md_, key_.data(), key_.size(),
-                            reinterpret_cast<const uint8_t*>(data.data()),
-                            data.size(), buf, &out_len);
-  if (res == nullptr) {
-    return util::Status(util::error::INTERNAL,
-                        "BoringSSL failed to compute HMAC");
-  }
+  util::Status status = ComputeRawDigest(template_ctx_.get(), data, buf);
+  if (!status.ok()) return status;
   if (CRYPTO_memcmp(buf, mac.data(), tag_size_) != 0) {
     return util::Status(util::error::INVALID_ARGUMENT, "verification failed");
   }
   return util::Status::OK;
 }
 
+util::StatusOr<size_t> HmacBoringSsl::ComputeMacInto(
+    absl::string_view data, absl::Span<char> out) const {
+  if (out.size() < tag_size_) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "Output buffer too small.");
+  }
+  uint8_t buf[EVP_MAX_MD_SIZE];
+  util::Status status = ComputeRawDigest(template_ctx_.get(), data, buf);
+  if (!status.ok()) return status;
+  memcpy(out.data(), buf, tag_size_);
+  return tag_size_;
+}
+
 }  // namespace subtle
 }  // namespace tink
 }  // namespace crypto
@@ -21,7 +21,10 @@
 #include <utility>
 
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "openssl/base.h"
 #include "openssl/evp.h"
+#include "openssl/hmac.h"
 #include "tink/mac.h"
 #include "tink/internal/fips_utils.h"
 #include "tink/subtle/common_enums.h"
@@ -48,6 +51,13 @@ class HmacBoringSsl : public Mac {
       absl::string_view mac,
       absl::string_view data) const override;
 
+  size_t MaxMacSize() const override { return tag_size_; }
+
+  // Computes the HMAC for 'data' directly into 'out' without allocating;
+  // 'out' must be at least tag_size_ bytes long.
+  crypto::tink::util::StatusOr<size_t> ComputeMacInto(
+      absl::string_view data, absl::Span<char> out) const override;
+
   static constexpr crypto::tink::internal::FipsCompatibility kFipsStatus =
       crypto::tink::internal::FipsCompatibility::kRequiresBoringCrypto;
 
@@ -55,13 +65,16 @@ class HmacBoringSsl : public Mac {
   // Minimum HMAC key size in bytes.
   static constexpr size_t kMinKeySize = 16;
 
-  HmacBoringSsl(const EVP_MD* md, uint32_t tag_size, util::SecretData key)
-      : md_(md), tag_size_(tag_size), key_(std::move(key)) {}
+  HmacBoringSsl(uint32_t tag_size, bssl::UniquePtr<HMAC_CTX> ctx)
+      : tag_size_(tag_size), template_ctx_(std::move(ctx)) {}
 
-  // HmacBoringSsl is not owner of md (it is owned by BoringSSL).
-  const EVP_MD* const md_;
   const uint32_t tag_size_;
-  const util::SecretData key_;
+  // Context that was initialized with the key once, so that the inner and
+  // outer key pads are derived only at construction time. Each operation
+  // clones this context with HMAC_CTX_copy_ex instead of re-deriving the
+  // pads from the raw key. The template context is never mutated after
+  // construction, so it can be cloned concurrently.
+  const bssl::UniquePtr<HMAC_CTX> template_ctx_;
 };
 
 }  // namespace subtle
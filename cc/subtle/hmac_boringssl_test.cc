@@ -19,6 +19,7 @@
 #include <string>
 
 #include "gtest/gtest.h"
+#include "absl/types/span.h"
 #include "tink/mac.h"
 #include "tink/config/tink_fips.h"
 #include "tink/subtle/common_enums.h"
@@ -90,6 +91,35 @@ TEST_F(HmacBoringSslTest, testBasic) {
   }
 }
 
+TEST_F(HmacBoringSslTest, testComputeMacInto) {
+  if (IsFipsModeEnabled() && !FIPS_mode()) {
+    GTEST_SKIP()
+        << "Test should not run in FIPS mode when BoringCrypto is unavailable.";
+  }
+
+  util::SecretData key = util::SecretDataFromStringView(
+      test::HexDecodeOrDie("000102030405060708090a0b0c0d0e0f"));
+  size_t tag_size = 16;
+  auto hmac_result = HmacBoringSsl::New(HashType::SHA1, tag_size, key);
+  EXPECT_TRUE(hmac_result.ok()) << hmac_result.status();
+  auto hmac = std::move(hmac_result.ValueOrDie());
+  EXPECT_EQ(hmac->MaxMacSize(), tag_size);
+  std::string data = "Some data to test.";
+  std::string buffer(hmac->MaxMacSize(), '\0');
+  auto size_result =
+      hmac->ComputeMacInto(data, absl::Span<char>(&buffer[0], buffer.size()));
+  EXPECT_TRUE(size_result.ok()) << size_result.status().ToString();
+  EXPECT_EQ(size_result.ValueOrDie(), tag_size);
+  // The tag written into the buffer matches the allocating API.
+  EXPECT_EQ(buffer, hmac->ComputeMac(data).ValueOrDie());
+  // A buffer smaller than the tag is rejected.
+  std::string small_buffer(tag_size - 1, '\0');
+  EXPECT_FALSE(hmac->ComputeMacInto(
+                       data, absl::Span<char>(&small_buffer[0],
+                                              small_buffer.size()))
+                   .ok());
+}
+
 TEST_F(HmacBoringSslTest, testModification) {
   if (IsFipsModeEnabled() && !FIPS_mode()) {
     GTEST_SKIP()
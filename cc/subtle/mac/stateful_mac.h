@@ -27,9 +27,14 @@
 #ifndef TINK_SUBTLE_MAC_STATEFUL_MAC_H_
 #define TINK_SUBTLE_MAC_STATEFUL_MAC_H_
 
+#include <cstring>
+#include <memory>
+#include <string>
+
 #include "tink/util/status.h"
 #include "tink/util/statusor.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 
 namespace crypto {
 namespace tink {
@@ -42,6 +47,60 @@ class StatefulMac {
 
   virtual util::Status Update(absl::string_view data) = 0;
   virtual util::StatusOr<std::string> Finalize() = 0;
+
+  // Writes the authentication tag into 'output', which must hold exactly
+  // the tag size. Unlike Finalize(), no result string is allocated, so
+  // batch callers can emit tags directly into a contiguous array. The
+  // default implementation funnels through Finalize().
+  virtual util::Status FinalizeInto(absl::Span<char> output) {
+    auto result = Finalize();
+    if (!result.ok()) return result.status();
+    const std::string& tag = result.ValueOrDie();
+    if (output.size() != tag.size()) {
+      return util::Status(util::error::INVALID_ARGUMENT,
+                          "output size does not match the tag size");
+    }
+    std::memcpy(output.data(), tag.data(), tag.size());
+    return util::Status::OK;
+  }
+
+  // Like FinalizeInto(), but 'output' may be shorter than the tag: the tag
+  // is truncated to output.size() bytes. Lets PRF-style callers (e.g.
+  // partition-key derivation) take a few bytes of the digest without a
+  // full-size intermediate. The default implementation funnels through
+  // Finalize().
+  virtual util::Status FinalizeTruncatedInto(absl::Span<char> output) {
+    auto result = Finalize();
+    if (!result.ok()) return result.status();
+    const std::string& tag = result.ValueOrDie();
+    if (output.size() > tag.size()) {
+      return util::Status(util::error::INVALID_ARGUMENT,
+                          "output size exceeds the tag size");
+    }
+    std::memcpy(output.data(), tag.data(), output.size());
+    return util::Status::OK;
+  }
+
+  // Re-initializes the MAC for a new message with the same key, so that the
+  // underlying context can be reused after Finalize() instead of being set up
+  // from scratch. Implementations that do not support reuse return
+  // UNIMPLEMENTED; callers should then create a fresh StatefulMac from the
+  // factory.
+  virtual util::Status Reset() {
+    return util::Status(util::error::UNIMPLEMENTED,
+                        "Reset is not supported by this StatefulMac");
+  }
+
+  // Returns a new StatefulMac whose digest state is a snapshot of this one;
+  // the two can then be updated and finalized independently. When many
+  // messages share a long common prefix, feed the prefix once, checkpoint
+  // with Clone() and branch per message, so that each message only pays for
+  // its unique suffix. Implementations that cannot copy their state return
+  // UNIMPLEMENTED.
+  virtual util::StatusOr<std::unique_ptr<StatefulMac>> Clone() const {
+    return util::Status(util::error::UNIMPLEMENTED,
+                        "Clone is not supported by this StatefulMac");
+  }
 };
 
 class StatefulMacFactory {
@@ -40,7 +40,7 @@ crypto::tink::util::StatusOr<std::unique_ptr<crypto::tink::OutputStream>>
   if (!segment_encrypter_result.ok()) return segment_encrypter_result.status();
   return StreamingAeadEncryptingStream::New(
       std::move(segment_encrypter_result.ValueOrDie()),
-      std::move(ciphertext_destination));
+      std::move(ciphertext_destination), encrypting_buffer_pool_);
 }
 
 crypto::tink::util::StatusOr<std::unique_ptr<crypto::tink::InputStream>>
@@ -65,6 +65,27 @@ crypto::tink::util::StatusOr<std::unique_ptr<crypto::tink::RandomAccessStream>>
       std::move(ciphertext_source));
 }
 
+crypto::tink::util::StatusOr<std::unique_ptr<crypto::tink::RandomAccessStream>>
+    NonceBasedStreamingAead::NewDecryptingRandomAccessStreamWithOptions(
+        std::unique_ptr<crypto::tink::RandomAccessStream> ciphertext_source,
+        absl::string_view associated_data,
+        const DecryptingRandomAccessStream::Options& options) {
+  auto segment_decrypter_result = NewSegmentDecrypter(associated_data);
+  if (!segment_decrypter_result.ok()) return segment_decrypter_result.status();
+  return DecryptingRandomAccessStream::New(
+      std::move(segment_decrypter_result.ValueOrDie()),
+      std::move(ciphertext_source), options);
+}
+
+int64_t NonceBasedStreamingAead::ExpectedCiphertextHeaderSize() const {
+  // The header size does not depend on the associated data, so an empty
+  // associated data suffices here. Constructing a segment decrypter is
+  // cheap, as key derivation happens only upon its Init().
+  auto segment_decrypter_result = NewSegmentDecrypter(/* associated_data = */"");
+  if (!segment_decrypter_result.ok()) return -1;
+  return segment_decrypter_result.ValueOrDie()->get_header_size();
+}
+
 }  // namespace subtle
 }  // namespace tink
 }  // namespace crypto
@@ -17,13 +17,17 @@
 #ifndef TINK_SUBTLE_NONCE_BASED_STREAMING_AEAD_H_
 #define TINK_SUBTLE_NONCE_BASED_STREAMING_AEAD_H_
 
+#include <memory>
+
 #include "absl/strings/string_view.h"
 #include "tink/input_stream.h"
 #include "tink/output_stream.h"
 #include "tink/random_access_stream.h"
 #include "tink/streaming_aead.h"
+#include "tink/subtle/decrypting_random_access_stream.h"
 #include "tink/subtle/stream_segment_decrypter.h"
 #include "tink/subtle/stream_segment_encrypter.h"
+#include "tink/subtle/streaming_aead_encrypting_stream.h"
 #include "tink/util/statusor.h"
 
 namespace crypto {
@@ -53,6 +57,21 @@ class NonceBasedStreamingAead : public StreamingAead {
       std::unique_ptr<crypto::tink::RandomAccessStream> ciphertext_source,
       absl::string_view associated_data) override;
 
+  // As NewDecryptingRandomAccessStream(), with explicit 'options'
+  // controlling the optional performance features of the returned stream
+  // (readahead, plaintext-segment caching, parallel sub-reads; see
+  // DecryptingRandomAccessStream::Options). Not part of the
+  // StreamingAead-interface; callers holding a concrete subtle primitive
+  // (or discovering it via dynamic_cast) can use this entry point directly.
+  crypto::tink::util::StatusOr<
+      std::unique_ptr<crypto::tink::RandomAccessStream>>
+  NewDecryptingRandomAccessStreamWithOptions(
+      std::unique_ptr<crypto::tink::RandomAccessStream> ciphertext_source,
+      absl::string_view associated_data,
+      const DecryptingRandomAccessStream::Options& options);
+
+  int64_t ExpectedCiphertextHeaderSize() const override;
+
  protected:
   // Methods to be implemented by a subclass of this class.
 
@@ -63,6 +82,14 @@ class NonceBasedStreamingAead : public StreamingAead {
   // Returns a new StreamSegmentDecrypter that uses `associated_data` for AEAD.
   virtual crypto::tink::util::StatusOr<std::unique_ptr<StreamSegmentDecrypter>>
   NewSegmentDecrypter(absl::string_view associated_data) const = 0;
+
+ private:
+  // Buffer storage shared by all encrypting streams of this primitive, so
+  // that opening many short streams does not reallocate segment-sized
+  // buffers each time. Shared ownership: streams may outlive the primitive.
+  std::shared_ptr<StreamingAeadEncryptingStream::BufferPool>
+      encrypting_buffer_pool_ =
+          std::make_shared<StreamingAeadEncryptingStream::BufferPool>();
 };
 
 }  // namespace subtle
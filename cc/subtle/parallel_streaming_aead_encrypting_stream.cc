@@ -0,0 +1,365 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/subtle/parallel_streaming_aead_encrypting_stream.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "tink/output_stream.h"
+#include "tink/subtle/stream_segment_encrypter.h"
+#include "tink/util/statusor.h"
+
+using crypto::tink::OutputStream;
+using crypto::tink::util::Status;
+using crypto::tink::util::StatusOr;
+
+namespace crypto {
+namespace tink {
+namespace subtle {
+
+namespace {
+
+// Writes 'contents' to the specified 'output_stream', which must be non-null.
+// In case of errors returns the first non-OK status of
+// output_stream->Next()-operation.
+
+util::Status WriteToStream(const std::vector<uint8_t>& contents,
+                           OutputStream* output_stream) {
+  void* buffer;
+  int pos = 0;
+  int remaining = contents.size();
+  int available_space = 0;
+  int available_bytes = 0;
+  while (remaining > 0) {
+    auto next_result = output_stream->Next(&buffer);
+    if (!next_result.ok()) return next_result.status();
+    available_space = next_result.ValueOrDie();
+    available_bytes = std::min(available_space, remaining);
+    memcpy(buffer, contents.data() + pos, available_bytes);
+    remaining -= available_bytes;
+    pos += available_bytes;
+  }
+  if (available_space > available_bytes) {
+    output_stream->BackUp(available_space - available_bytes);
+  }
+  return Status::OK;
+}
+
+}  // anonymous namespace
+
+// static
+StatusOr<std::unique_ptr<OutputStream>>
+ParallelStreamingAeadEncryptingStream::New(
+    std::unique_ptr<StreamSegmentEncrypter> segment_encrypter,
+    std::unique_ptr<OutputStream> ciphertext_destination,
+    int num_workers, ThreadStartHook thread_start_hook) {
+  if (segment_encrypter == nullptr) {
+    return Status(util::error::INVALID_ARGUMENT,
+                  "segment_encrypter must be non-null");
+  }
+  if (ciphertext_destination == nullptr) {
+    return Status(util::error::INVALID_ARGUMENT,
+                  "cipertext_destination must be non-null");
+  }
+  if (num_workers < 1) {
+    return Status(util::error::INVALID_ARGUMENT,
+                  "num_workers must be positive");
+  }
+  std::unique_ptr<ParallelStreamingAeadEncryptingStream> enc_stream(
+      new ParallelStreamingAeadEncryptingStream());
+  enc_stream->segment_encrypter_ = std::move(segment_encrypter);
+  enc_stream->ct_destination_ = std::move(ciphertext_destination);
+  int first_segment_size =
+      enc_stream->segment_encrypter_->get_plaintext_segment_size() -
+      enc_stream->segment_encrypter_->get_ciphertext_offset() -
+      enc_stream->segment_encrypter_->get_header().size();
+
+  if (first_segment_size <= 0) {
+    return Status(util::error::INTERNAL,
+                  "Size of the first segment must be greater than 0.");
+  }
+  enc_stream->pt_buffer_.resize(first_segment_size);
+  enc_stream->pt_to_encrypt_.resize(0);
+  enc_stream->position_ = 0;
+  enc_stream->next_segment_number_ = 0;
+  enc_stream->is_first_segment_ = true;
+  enc_stream->count_backedup_ = first_segment_size;
+  enc_stream->pt_buffer_offset_ = 0;
+  enc_stream->status_ = Status::OK;
+  enc_stream->next_segment_to_write_ = 0;
+  enc_stream->jobs_in_flight_ = 0;
+  // A small multiple of the worker count keeps every worker busy while
+  // bounding the number of buffered segments.
+  enc_stream->max_jobs_in_flight_ = 2 * num_workers + 2;
+  enc_stream->shutting_down_ = false;
+  enc_stream->pipeline_status_ = Status::OK;
+  ParallelStreamingAeadEncryptingStream* raw_stream = enc_stream.get();
+  // Each pipeline thread runs the hook before any segment work; workers also
+  // allocate their ciphertext buffers themselves, so under first-touch
+  // placement a hook that pins the thread keeps those buffers node-local.
+  for (int i = 0; i < num_workers; i++) {
+    enc_stream->workers_.emplace_back([raw_stream, thread_start_hook, i,
+                                       num_workers]() {
+      if (thread_start_hook != nullptr) thread_start_hook(i, num_workers);
+      raw_stream->WorkerLoop();
+    });
+  }
+  enc_stream->writer_ =
+      std::thread([raw_stream, thread_start_hook, num_workers]() {
+        if (thread_start_hook != nullptr) {
+          thread_start_hook(num_workers, num_workers);
+        }
+        raw_stream->WriterLoop();
+      });
+  return {std::move(enc_stream)};
+}
+
+ParallelStreamingAeadEncryptingStream::
+    ~ParallelStreamingAeadEncryptingStream() {
+  ShutDownThreads();
+}
+
+bool ParallelStreamingAeadEncryptingStream::WorkerHasWork() const {
+  return !job_queue_.empty() || shutting_down_ || !pipeline_status_.ok();
+}
+
+bool ParallelStreamingAeadEncryptingStream::WriterHasWork() const {
+  return (!completed_segments_.empty() &&
+          completed_segments_.begin()->first == next_segment_to_write_) ||
+         shutting_down_ || !pipeline_status_.ok();
+}
+
+bool ParallelStreamingAeadEncryptingStream::HasCapacity() const {
+  return jobs_in_flight_ < max_jobs_in_flight_ || !pipeline_status_.ok();
+}
+
+bool ParallelStreamingAeadEncryptingStream::IsDrained() const {
+  return jobs_in_flight_ == 0 || !pipeline_status_.ok();
+}
+
+void ParallelStreamingAeadEncryptingStream::WorkerLoop() {
+  while (true) {
+    mu_.Lock();
+    mu_.Await(absl::Condition(
+        this, &ParallelStreamingAeadEncryptingStream::WorkerHasWork));
+    if (!pipeline_status_.ok() ||
+        (shutting_down_ && job_queue_.empty())) {
+      mu_.Unlock();
+      return;
+    }
+    Job job = std::move(job_queue_.front());
+    job_queue_.pop_front();
+    mu_.Unlock();
+
+    std::vector<uint8_t> ct_segment;
+    auto status = segment_encrypter_->EncryptSegmentAt(
+        job.segment_number, job.plaintext, job.is_last_segment, &ct_segment);
+
+    mu_.Lock();
+    if (!status.ok()) {
+      if (pipeline_status_.ok()) pipeline_status_ = status;
+    } else {
+      completed_segments_[job.segment_number] = std::move(ct_segment);
+    }
+    mu_.Unlock();
+  }
+}
+
+void ParallelStreamingAeadEncryptingStream::WriterLoop() {
+  while (true) {
+    mu_.Lock();
+    mu_.Await(absl::Condition(
+        this, &ParallelStreamingAeadEncryptingStream::WriterHasWork));
+    if (!pipeline_status_.ok()) {
+      mu_.Unlock();
+      return;
+    }
+    auto it = completed_segments_.find(next_segment_to_write_);
+    if (it == completed_segments_.end()) {
+      // Shutting down, and no further segment is ready.
+      mu_.Unlock();
+      return;
+    }
+    std::vector<uint8_t> ct_segment = std::move(it->second);
+    completed_segments_.erase(it);
+    mu_.Unlock();
+
+    auto status = WriteToStream(ct_segment, ct_destination_.get());
+
+    mu_.Lock();
+    if (!status.ok()) {
+      if (pipeline_status_.ok()) pipeline_status_ = status;
+      mu_.Unlock();
+      return;
+    }
+    next_segment_to_write_++;
+    jobs_in_flight_--;
+    mu_.Unlock();
+  }
+}
+
+Status ParallelStreamingAeadEncryptingStream::EnqueueSegment(
+    std::vector<uint8_t> plaintext, bool is_last_segment) {
+  absl::MutexLock lock(&mu_);
+  mu_.Await(absl::Condition(
+      this, &ParallelStreamingAeadEncryptingStream::HasCapacity));
+  if (!pipeline_status_.ok()) return pipeline_status_;
+  Job job;
+  job.segment_number = next_segment_number_++;
+  job.plaintext = std::move(plaintext);
+  job.is_last_segment = is_last_segment;
+  job_queue_.push_back(std::move(job));
+  jobs_in_flight_++;
+  return Status::OK;
+}
+
+Status ParallelStreamingAeadEncryptingStream::AwaitDrained() {
+  absl::MutexLock lock(&mu_);
+  mu_.Await(absl::Condition(
+      this, &ParallelStreamingAeadEncryptingStream::IsDrained));
+  return pipeline_status_;
+}
+
+void ParallelStreamingAeadEncryptingStream::ShutDownThreads() {
+  {
+    absl::MutexLock lock(&mu_);
+    shutting_down_ = true;
+  }
+  for (auto& worker : workers_) {
+    if (worker.joinable()) worker.join();
+  }
+  workers_.clear();
+  if (writer_.joinable()) writer_.join();
+}
+
+StatusOr<int> ParallelStreamingAeadEncryptingStream::Next(void** data) {
+  if (!status_.ok()) return status_;
+
+  // The first call to Next().
+  if (is_first_segment_) {
+    is_first_segment_ = false;
+    count_backedup_ = 0;
+    // The writer thread touches ct_destination_ only after the first segment
+    // has been enqueued, so writing the header here is safe.
+    status_ =
+        WriteToStream(segment_encrypter_->get_header(), ct_destination_.get());
+    if (!status_.ok()) return status_;
+    *data = pt_buffer_.data();
+    position_ = pt_buffer_.size();
+    return pt_buffer_.size();
+  }
+
+  // If some space was backed up, return it first.
+  if (count_backedup_ > 0) {
+    position_ += count_backedup_;
+    pt_buffer_offset_ = pt_buffer_.size() - count_backedup_;
+    int backedup = count_backedup_;
+    count_backedup_ = 0;
+    *data = pt_buffer_.data() + pt_buffer_offset_;
+    return backedup;
+  }
+
+  // We're past the first segment, and no space was backed up, so we:
+  // 1. hand pt_to_encrypt_ (if non-empty) to the worker pool as a not-last
+  //    segment; the writer thread takes care of writing the ciphertext
+  //    to ct_destination_ in segment order.
+  // 2. move contents of pt_buffer_ to pt_to_encrypt_ (for later encryption,
+  //    as we don't know yet whether it will be the last segment or not.
+  // 3. prepare and return "fresh" pt_buffer_.
+  //
+  // Step 1.
+  if (!pt_to_encrypt_.empty()) {
+    status_ = EnqueueSegment(std::move(pt_to_encrypt_),
+                             /* is_last_segment = */ false);
+    if (!status_.ok()) return status_;
+    pt_to_encrypt_.clear();
+  }
+  // Step 2.
+  pt_buffer_.swap(pt_to_encrypt_);
+  // Step 3.
+  pt_buffer_.resize(segment_encrypter_->get_plaintext_segment_size());
+  *data = pt_buffer_.data();
+  pt_buffer_offset_ = 0;
+  position_ += pt_buffer_.size();
+  return pt_buffer_.size();
+}
+
+void ParallelStreamingAeadEncryptingStream::BackUp(int count) {
+  if (is_first_segment_ || !status_.ok() || count < 1) return;
+  int curr_buffer_size = pt_buffer_.size() - pt_buffer_offset_;
+  int actual_count = std::min(count, curr_buffer_size - count_backedup_);
+  count_backedup_ += actual_count;
+  position_ -= actual_count;
+}
+
+Status ParallelStreamingAeadEncryptingStream::Close() {
+  if (!status_.ok()) return status_;
+  if (is_first_segment_) {  // Next() was never called.
+    status_ =
+        WriteToStream(segment_encrypter_->get_header(), ct_destination_.get());
+    if (!status_.ok()) {
+      ShutDownThreads();
+      return status_;
+    }
+  }
+
+  // The last segment encrypts plaintext from pt_to_encrypt_,
+  // unless the current pt_buffer_ has some plaintext bytes.
+  std::vector<uint8_t>* pt_last_segment = &pt_to_encrypt_;
+  if ((!pt_buffer_.empty()) && count_backedup_ < pt_buffer_.size()) {
+    // The last segment encrypts plaintext from pt_buffer_.
+    pt_buffer_.resize(pt_buffer_.size() - count_backedup_);
+    pt_last_segment = &pt_buffer_;
+  }
+  if (pt_last_segment != &pt_to_encrypt_ && (!pt_to_encrypt_.empty())) {
+    // Before the last segment we must encrypt pt_to_encrypt_.
+    status_ = EnqueueSegment(std::move(pt_to_encrypt_),
+                             /* is_last_segment = */ false);
+    if (!status_.ok()) {
+      ShutDownThreads();
+      ct_destination_->Close().IgnoreError();
+      return status_;
+    }
+  }
+
+  // Enqueue pt_last_segment, wait until all ciphertext segments have been
+  // written, and close the stream.
+  status_ = EnqueueSegment(std::move(*pt_last_segment),
+                           /* is_last_segment = */ true);
+  if (!status_.ok()) {
+    ShutDownThreads();
+    ct_destination_->Close().IgnoreError();
+    return status_;
+  }
+  status_ = AwaitDrained();
+  ShutDownThreads();
+  if (!status_.ok()) {
+    ct_destination_->Close().IgnoreError();
+    return status_;
+  }
+  status_ = Status(util::error::FAILED_PRECONDITION, "Stream closed");
+  return ct_destination_->Close();
+}
+
+int64_t ParallelStreamingAeadEncryptingStream::Position() const {
+  return position_;
+}
+
+}  // namespace subtle
+}  // namespace tink
+}  // namespace crypto
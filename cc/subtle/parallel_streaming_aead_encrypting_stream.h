@@ -0,0 +1,150 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_SUBTLE_PARALLEL_STREAMING_AEAD_ENCRYPTING_STREAM_H_
+#define TINK_SUBTLE_PARALLEL_STREAMING_AEAD_ENCRYPTING_STREAM_H_
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "tink/output_stream.h"
+#include "tink/subtle/stream_segment_encrypter.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace subtle {
+
+// An encrypting stream that pipelines segment encryption over a pool of
+// worker threads, for workloads that push large volumes through a single
+// stream and are bottlenecked by one core of AEAD work.
+//
+// Full segments are handed to the workers, which encrypt them concurrently
+// via StreamSegmentEncrypter::EncryptSegmentAt(); a dedicated writer thread
+// restores segment order before writing to the ciphertext destination, so the
+// wire format is identical to that of StreamingAeadEncryptingStream. Memory
+// is bounded: at most a few segments per worker are in flight, and Next()
+// blocks once that limit is reached.
+//
+// The provided segment encrypter must support EncryptSegmentAt(); otherwise
+// the stream fails with UNIMPLEMENTED on the first segment.
+class ParallelStreamingAeadEncryptingStream : public OutputStream {
+ public:
+  // Called once on each pipeline thread right after it starts, before it
+  // processes any segment: on encryption workers with their index in
+  // [0, num_workers), and on the writer thread with index num_workers.
+  // Applications with NUMA-sensitive workloads use this to pin the threads
+  // of a stream to a socket (e.g. via pthread_setaffinity_np); ciphertext
+  // segment buffers are allocated by the worker threads themselves, so
+  // with first-touch placement the pages then stay node-local. Tink itself
+  // takes no dependency on a NUMA library and performs no pinning.
+  using ThreadStartHook = std::function<void(int thread_index,
+                                             int num_workers)>;
+
+  // Returns an encrypting wrapper around 'ciphertext_destination' that uses
+  // 'num_workers' threads for segment encryption. 'num_workers' must be
+  // at least 1. 'thread_start_hook' may be null.
+  static crypto::tink::util::StatusOr<
+      std::unique_ptr<crypto::tink::OutputStream>>
+  New(std::unique_ptr<StreamSegmentEncrypter> segment_encrypter,
+      std::unique_ptr<crypto::tink::OutputStream> ciphertext_destination,
+      int num_workers, ThreadStartHook thread_start_hook = nullptr);
+
+  // -----------------------
+  // Methods of OutputStream-interface implemented by this class.
+  crypto::tink::util::StatusOr<int> Next(void** data) override;
+  void BackUp(int count) override;
+  crypto::tink::util::Status Close() override;
+  int64_t Position() const override;
+
+  ~ParallelStreamingAeadEncryptingStream() override;
+
+ private:
+  // A segment waiting to be encrypted.
+  struct Job {
+    int64_t segment_number;
+    std::vector<uint8_t> plaintext;
+    bool is_last_segment;
+  };
+
+  ParallelStreamingAeadEncryptingStream() {}
+
+  void WorkerLoop();
+  void WriterLoop();
+
+  // Hands 'plaintext' to the worker pool as the next segment, blocking while
+  // the pipeline is at capacity. Returns the pipeline status.
+  crypto::tink::util::Status EnqueueSegment(std::vector<uint8_t> plaintext,
+                                            bool is_last_segment);
+
+  // Blocks until every enqueued segment has been written (or the pipeline
+  // failed), and returns the pipeline status.
+  crypto::tink::util::Status AwaitDrained();
+
+  // Signals the threads to finish and joins them. May be called repeatedly.
+  void ShutDownThreads();
+
+  // Predicates for mu_.Await(); all require mu_ to be held.
+  bool WorkerHasWork() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  bool WriterHasWork() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  bool HasCapacity() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  bool IsDrained() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  std::unique_ptr<StreamSegmentEncrypter> segment_encrypter_;
+
+  // Written by the caller thread for the header (before any job exists), and
+  // by the writer thread for ciphertext segments afterwards.
+  std::unique_ptr<crypto::tink::OutputStream> ct_destination_;
+
+  // Buffering state; accessed only by the caller thread. Mirrors
+  // StreamingAeadEncryptingStream.
+  std::vector<uint8_t> pt_buffer_;      // plaintext buffer
+  std::vector<uint8_t> pt_to_encrypt_;  // plaintext of the pending segment
+  int64_t position_;      // number of plaintext bytes written to this stream
+  int64_t next_segment_number_;        // number of the next enqueued segment
+  crypto::tink::util::Status status_;  // status of the stream
+  int count_backedup_;    // # bytes in pt_buffer_ that were backed up
+  int pt_buffer_offset_;  // offset at which *data starts in pt_buffer_
+  bool is_first_segment_;
+
+  // Pipeline state, shared with the threads.
+  mutable absl::Mutex mu_;
+  std::deque<Job> job_queue_ ABSL_GUARDED_BY(mu_);
+  std::map<int64_t, std::vector<uint8_t>> completed_segments_
+      ABSL_GUARDED_BY(mu_);
+  int64_t next_segment_to_write_ ABSL_GUARDED_BY(mu_);
+  int jobs_in_flight_ ABSL_GUARDED_BY(mu_);  // queued, encrypting or completed
+  int max_jobs_in_flight_;                   // set once in New()
+  bool shutting_down_ ABSL_GUARDED_BY(mu_);
+  crypto::tink::util::Status pipeline_status_ ABSL_GUARDED_BY(mu_);
+
+  std::vector<std::thread> workers_;
+  std::thread writer_;
+};
+
+}  // namespace subtle
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_SUBTLE_PARALLEL_STREAMING_AEAD_ENCRYPTING_STREAM_H_
@@ -0,0 +1,263 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/subtle/parallel_streaming_aead_encrypting_stream.h"
+
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "tink/output_stream.h"
+#include "tink/subtle/stream_segment_encrypter.h"
+#include "tink/subtle/random.h"
+#include "tink/subtle/test_util.h"
+#include "tink/util/ostream_output_stream.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace subtle {
+
+using crypto::tink::OutputStream;
+using crypto::tink::subtle::test::DummyStreamSegmentEncrypter;
+using crypto::tink::util::OstreamOutputStream;
+
+namespace {
+
+// References to objects used for test validation.
+// The objects pointed to are not owned by this structure.
+struct ValidationRefs {
+  std::stringbuf* ct_buf;  // buffer that contains the resulting ciphertext
+  DummyStreamSegmentEncrypter* seg_enc;  // segment encrypter
+};
+
+// A helper for creating ParallelStreamingAeadEncryptingStream together
+// with references to internal objects, used for test validation.
+std::unique_ptr<OutputStream> GetEncryptingStream(
+    int pt_segment_size, int header_size, int ct_offset, int num_workers,
+    ValidationRefs* refs) {
+  // Prepare ciphertext destination stream.
+  auto ct_stream = absl::make_unique<std::stringstream>();
+  // A reference to the ciphertext buffer, for later validation.
+  refs->ct_buf = ct_stream->rdbuf();
+  std::unique_ptr<OutputStream> ct_destination(
+      absl::make_unique<OstreamOutputStream>(std::move(ct_stream)));
+  auto seg_enc = absl::make_unique<DummyStreamSegmentEncrypter>(
+          pt_segment_size, header_size, ct_offset);
+  // A reference to the segment encrypter, for later validation.
+  refs->seg_enc = seg_enc.get();
+  auto enc_stream = std::move(ParallelStreamingAeadEncryptingStream::New(
+      std::move(seg_enc), std::move(ct_destination),
+      num_workers).ValueOrDie());
+  EXPECT_EQ(0, enc_stream->Position());
+  return enc_stream;
+}
+
+// A segment encrypter that does not override EncryptSegmentAt(), so it
+// cannot be used for parallel encryption.
+class SequentialOnlySegmentEncrypter : public StreamSegmentEncrypter {
+ public:
+  SequentialOnlySegmentEncrypter(int pt_segment_size, int header_size,
+                                 int ct_offset)
+      : dummy_(pt_segment_size, header_size, ct_offset) {}
+
+  util::Status EncryptSegment(
+      const std::vector<uint8_t>& plaintext,
+      bool is_last_segment,
+      std::vector<uint8_t>* ciphertext_buffer) override {
+    return dummy_.EncryptSegment(plaintext, is_last_segment,
+                                 ciphertext_buffer);
+  }
+  const std::vector<uint8_t>& get_header() const override {
+    return dummy_.get_header();
+  }
+  int64_t get_segment_number() const override {
+    return dummy_.get_segment_number();
+  }
+  int get_plaintext_segment_size() const override {
+    return dummy_.get_plaintext_segment_size();
+  }
+  int get_ciphertext_segment_size() const override {
+    return dummy_.get_ciphertext_segment_size();
+  }
+  int get_ciphertext_offset() const override {
+    return dummy_.get_ciphertext_offset();
+  }
+
+ protected:
+  void IncSegmentNumber() override {}
+
+ private:
+  DummyStreamSegmentEncrypter dummy_;
+};
+
+class ParallelStreamingAeadEncryptingStreamTest : public ::testing::Test {
+};
+
+TEST_F(ParallelStreamingAeadEncryptingStreamTest, WritingStreams) {
+  std::vector<int> pt_sizes = {0, 10, 100, 1000, 10000, 100000, 1000000};
+  std::vector<int> pt_segment_sizes = {64, 100, 128, 1000, 1024};
+  std::vector<int> header_sizes = {5, 10, 32};
+  std::vector<int> num_workers_options = {1, 2, 4};
+  for (auto pt_size : pt_sizes) {
+    for (auto pt_segment_size : pt_segment_sizes) {
+      for (auto header_size : header_sizes) {
+        for (auto num_workers : num_workers_options) {
+          SCOPED_TRACE(absl::StrCat("pt_size = ", pt_size,
+                                    ", pt_segment_size = ", pt_segment_size,
+                                    ", header_size = ", header_size,
+                                    ", num_workers = ", num_workers));
+          // Get an encrypting stream.
+          ValidationRefs refs;
+          auto enc_stream = GetEncryptingStream(pt_segment_size, header_size,
+              /* ct_offset = */ 0, num_workers, &refs);
+
+          // First buffer returned by Next();
+          void* buffer;
+          auto next_result = enc_stream->Next(&buffer);
+          EXPECT_TRUE(next_result.ok()) << next_result.status();
+          int buffer_size = next_result.ValueOrDie();
+          EXPECT_EQ(pt_segment_size - header_size, buffer_size);
+          EXPECT_EQ(buffer_size, enc_stream->Position());
+
+          // Backup the entire first buffer.
+          enc_stream->BackUp(buffer_size);
+          EXPECT_EQ(0, enc_stream->Position());
+
+          // Write plaintext to the stream, and close the stream.
+          std::string pt = Random::GetRandomBytes(pt_size);
+          auto status = test::WriteToStream(enc_stream.get(), pt);
+          EXPECT_TRUE(status.ok()) << status;
+          EXPECT_EQ(enc_stream->Position(), pt.size());
+          EXPECT_EQ(refs.seg_enc->get_generated_output_size(),
+                    refs.ct_buf->str().size());
+          // The ciphertext must be byte-identical to the sequential one.
+          auto exp_ciphertext = refs.seg_enc->GenerateCiphertext(pt);
+          EXPECT_EQ(exp_ciphertext.size(), refs.ct_buf->str().size());
+          EXPECT_EQ(exp_ciphertext, refs.ct_buf->str());
+
+          // Try closing the stream again.
+          status = enc_stream->Close();
+          EXPECT_FALSE(status.ok());
+          EXPECT_EQ(util::error::FAILED_PRECONDITION, status.error_code());
+        }
+      }
+    }
+  }
+}
+
+TEST_F(ParallelStreamingAeadEncryptingStreamTest, EmptyPlaintext) {
+  int pt_segment_size = 512;
+  int header_size = 64;
+
+  // Get an encrypting stream.
+  ValidationRefs refs;
+  auto enc_stream = GetEncryptingStream(
+      pt_segment_size, header_size, /* ct_offset = */ 0,
+      /* num_workers = */ 2, &refs);
+
+  // Close the stream.
+  auto close_status = enc_stream->Close();
+  EXPECT_TRUE(close_status.ok()) << close_status;
+  EXPECT_EQ(refs.seg_enc->get_generated_output_size(),
+            refs.ct_buf->str().size());
+  // Ciphertext contains only the header and an "empty" first segment.
+  EXPECT_EQ(header_size + DummyStreamSegmentEncrypter::kSegmentTagSize,
+            refs.ct_buf->str().size());
+  // The last segment is marked as such.
+  EXPECT_EQ(DummyStreamSegmentEncrypter::kLastSegment,
+            refs.ct_buf->str().back());
+
+  // Try closing the stream again.
+  close_status = enc_stream->Close();
+  EXPECT_FALSE(close_status.ok());
+  EXPECT_EQ(util::error::FAILED_PRECONDITION, close_status.error_code());
+}
+
+TEST_F(ParallelStreamingAeadEncryptingStreamTest, InvalidNumWorkers) {
+  auto ct_stream = absl::make_unique<std::stringstream>();
+  std::unique_ptr<OutputStream> ct_destination(
+      absl::make_unique<OstreamOutputStream>(std::move(ct_stream)));
+  auto seg_enc = absl::make_unique<DummyStreamSegmentEncrypter>(
+      /* pt_segment_size = */ 512, /* header_size = */ 64,
+      /* ct_offset = */ 0);
+  auto result = ParallelStreamingAeadEncryptingStream::New(
+      std::move(seg_enc), std::move(ct_destination), /* num_workers = */ 0);
+  EXPECT_FALSE(result.ok());
+  EXPECT_EQ(util::error::INVALID_ARGUMENT, result.status().error_code());
+}
+
+TEST_F(ParallelStreamingAeadEncryptingStreamTest,
+       EncrypterWithoutEncryptSegmentAt) {
+  auto ct_stream = absl::make_unique<std::stringstream>();
+  std::unique_ptr<OutputStream> ct_destination(
+      absl::make_unique<OstreamOutputStream>(std::move(ct_stream)));
+  auto seg_enc = absl::make_unique<SequentialOnlySegmentEncrypter>(
+      /* pt_segment_size = */ 512, /* header_size = */ 64,
+      /* ct_offset = */ 0);
+  auto enc_stream = std::move(ParallelStreamingAeadEncryptingStream::New(
+      std::move(seg_enc), std::move(ct_destination),
+      /* num_workers = */ 2).ValueOrDie());
+
+  // The first segment reaches the worker pool upon Close(), which must
+  // surface the UNIMPLEMENTED error of the default EncryptSegmentAt().
+  auto close_status = enc_stream->Close();
+  EXPECT_FALSE(close_status.ok());
+  EXPECT_EQ(util::error::UNIMPLEMENTED, close_status.error_code());
+}
+
+TEST_F(ParallelStreamingAeadEncryptingStreamTest, ThreadStartHook) {
+  int num_workers = 3;
+  std::mutex hook_mutex;
+  std::multiset<int> hook_indices;
+  auto ct_stream = absl::make_unique<std::stringstream>();
+  std::unique_ptr<OutputStream> ct_destination(
+      absl::make_unique<OstreamOutputStream>(std::move(ct_stream)));
+  auto seg_enc = absl::make_unique<DummyStreamSegmentEncrypter>(
+      /* pt_segment_size = */ 512, /* header_size = */ 64,
+      /* ct_offset = */ 0);
+  auto enc_stream = std::move(
+      ParallelStreamingAeadEncryptingStream::New(
+          std::move(seg_enc), std::move(ct_destination), num_workers,
+          [&hook_mutex, &hook_indices, num_workers](int thread_index,
+                                                    int hook_num_workers) {
+            std::unique_lock<std::mutex> lock(hook_mutex);
+            EXPECT_EQ(num_workers, hook_num_workers);
+            hook_indices.insert(thread_index);
+          })
+          .ValueOrDie());
+  auto close_status = enc_stream->Close();
+  EXPECT_TRUE(close_status.ok()) << close_status;
+
+  // The hook must have run exactly once on every worker (indices
+  // 0..num_workers-1) and once on the writer thread (index num_workers).
+  std::unique_lock<std::mutex> lock(hook_mutex);
+  EXPECT_EQ(num_workers + 1, hook_indices.size());
+  for (int i = 0; i <= num_workers; i++) {
+    EXPECT_EQ(1, hook_indices.count(i));
+  }
+}
+
+}  // namespace
+}  // namespace subtle
+}  // namespace tink
+}  // namespace crypto
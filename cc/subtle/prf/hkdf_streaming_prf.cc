@@ -17,13 +17,16 @@
 #include "tink/subtle/prf/hkdf_streaming_prf.h"
 
 #include <algorithm>
+#include <cstring>
 #include <utility>
 
+#include "absl/types/span.h"
+
 #include "absl/memory/memory.h"
 #include "absl/strings/str_cat.h"
 #include "openssl/base.h"
-#include "openssl/hkdf.h"
 #include "openssl/hmac.h"
+#include "tink/subtle/hkdf.h"
 #include "tink/subtle/subtle_util.h"
 #include "tink/subtle/subtle_util_boringssl.h"
 #include "tink/util/secret_data.h"
@@ -38,10 +41,10 @@ namespace {
 
 class HkdfInputStream : public InputStream {
  public:
-  HkdfInputStream(const EVP_MD *digest, const util::SecretData &secret,
-                  absl::string_view salt, absl::string_view input)
+  HkdfInputStream(const EVP_MD *digest, const util::SecretData &prk,
+                  absl::string_view input)
       : input_(input) {
-    stream_status_ = Init(digest, secret, salt);
+    stream_status_ = Init(digest, prk);
   }
 
   crypto::tink::util::StatusOr<int> Next(const void **data) override {
@@ -73,12 +76,7 @@ class HkdfInputStream : public InputStream {
   }
 
  private:
-  util::Status Init(const EVP_MD *digest, const util::SecretData &secret,
-                    absl::string_view salt) {
-    // PRK as by RFC 5869, Section 2.2
-    util::SecretData prk(EVP_MAX_MD_SIZE);
-    size_t prk_len;
-
+  util::Status Init(const EVP_MD *digest, const util::SecretData &prk) {
     if (!digest) {
       return util::Status(util::error::INVALID_ARGUMENT, "Invalid digest");
     }
@@ -88,12 +86,6 @@ class HkdfInputStream : public InputStream {
                           "Invalid digest size (0)");
     }
     ti_.resize(digest_size);
-    if (1 != HKDF_extract(
-                 prk.data(), &prk_len, digest, secret.data(), secret.size(),
-                 reinterpret_cast<const uint8_t *>(salt.data()), salt.size())) {
-      return util::Status(util::error::INTERNAL, "BoringSSL's HKDF failed");
-    }
-    prk.resize(prk_len);
     if (!hmac_ctx_) {
       return util::Status(util::error::INTERNAL,
                           "BoringSSL's HMAC_CTX_new failed");
@@ -168,7 +160,84 @@ class HkdfInputStream : public InputStream {
 
 std::unique_ptr<InputStream> HkdfStreamingPrf::ComputePrf(
     absl::string_view input) const {
-  return absl::make_unique<HkdfInputStream>(hash_, secret_, salt_, input);
+  return absl::make_unique<HkdfInputStream>(hash_, prk_, input);
+}
+
+crypto::tink::util::Status HkdfStreamingPrf::ComputePrfInto(
+    absl::string_view input, absl::Span<char> out) const {
+  const size_t digest_size = EVP_MD_size(hash_);
+  if (digest_size == 0) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "Invalid digest size (0)");
+  }
+  // By RFC 5869, Section 2.3, at most 255 output blocks can be expanded.
+  if (out.size() > 255 * digest_size) {
+    return util::Status(
+        util::error::OUT_OF_RANGE,
+        absl::StrCat("Length ", out.size(), " exceeds maximum HKDF output of ",
+                     255 * digest_size, " bytes"));
+  }
+  bssl::UniquePtr<HMAC_CTX> hmac_ctx(HMAC_CTX_new());
+  if (!hmac_ctx) {
+    return util::Status(util::error::INTERNAL,
+                        "BoringSSL's HMAC_CTX_new failed");
+  }
+  // Set up the context with the PRK once; the per-block resets below with a
+  // null key reuse the precomputed key state.
+  if (!HMAC_Init_ex(hmac_ctx.get(), prk_.data(), prk_.size(), hash_,
+                    nullptr)) {
+    return util::Status(util::error::INTERNAL,
+                        "BoringSSL's HMAC_Init_ex failed");
+  }
+  const std::string input_copy(input);
+  util::SecretData ti(digest_size);
+  uint8_t i = 0;
+  size_t offset = 0;
+  while (offset < out.size()) {
+    // T(i+1) = HMAC-Hash(PRK, T(i) | info | i + 1) as in RFC 5869,
+    // Section 2.3.
+    if (!HMAC_Init_ex(hmac_ctx.get(), nullptr, 0, nullptr, nullptr)) {
+      return util::Status(util::error::INTERNAL,
+                          "BoringSSL's HMAC_Init_ex failed");
+    }
+    if (i != 0 && !HMAC_Update(hmac_ctx.get(), ti.data(), ti.size())) {
+      return util::Status(util::error::INTERNAL,
+                          "BoringSSL's HMAC_Update failed on ti");
+    }
+    if (!HMAC_Update(hmac_ctx.get(),
+                     reinterpret_cast<const uint8_t *>(&input_copy[0]),
+                     input_copy.size())) {
+      return util::Status(util::error::INTERNAL,
+                          "BoringSSL's HMAC_Update failed on input");
+    }
+    uint8_t i_as_uint8 = i + 1;
+    if (!HMAC_Update(hmac_ctx.get(), &i_as_uint8, 1)) {
+      return util::Status(util::error::INTERNAL,
+                          "BoringSSL's HMAC_Update failed on i");
+    }
+    if (!HMAC_Final(hmac_ctx.get(), ti.data(), nullptr)) {
+      return util::Status(util::error::INTERNAL,
+                          "BoringSSL's HMAC_Final failed");
+    }
+    i++;
+    size_t to_copy = std::min(digest_size, out.size() - offset);
+    std::memcpy(out.data() + offset, ti.data(), to_copy);
+    offset += to_copy;
+  }
+  return util::OkStatus();
+}
+
+crypto::tink::util::StatusOr<util::SecretData>
+HkdfStreamingPrf::ComputePrfBytes(absl::string_view input,
+                                  size_t length) const {
+  util::SecretData result(length);
+  auto status = ComputePrfInto(
+      input,
+      absl::Span<char>(reinterpret_cast<char*>(result.data()), result.size()));
+  if (!status.ok()) {
+    return status;
+  }
+  return result;
 }
 
 // static
@@ -192,9 +261,18 @@ HkdfStreamingPrf::New(HashType hash, util::SecretData secret,
   if (!evp_md_or.ok()) {
     return util::Status(util::error::UNIMPLEMENTED, "Unsupported hash");
   }
+  const EVP_MD* digest = evp_md_or.ValueOrDie();
+
+  // PRK as by RFC 5869, Section 2.2. The extraction depends only on the
+  // secret and the salt, so it is done once here instead of for every stream
+  // returned by ComputePrf.
+  auto prk_or = Hkdf::Extract(hash, secret, salt);
+  if (!prk_or.ok()) {
+    return prk_or.status();
+  }
 
   return {absl::WrapUnique(
-      new HkdfStreamingPrf(evp_md_or.ValueOrDie(), std::move(secret), salt))};
+      new HkdfStreamingPrf(digest, std::move(prk_or.ValueOrDie())))};
 }
 
 }  // namespace subtle
@@ -41,17 +41,29 @@ class HkdfStreamingPrf : public StreamingPrf {
   std::unique_ptr<InputStream> ComputePrf(
       absl::string_view input) const override;
 
+  // Expands all required output blocks with a single HMAC context setup and
+  // no stream object. Returns OUT_OF_RANGE if out.size() exceeds the maximum
+  // HKDF output of 255 * HashLen bytes (RFC 5869).
+  crypto::tink::util::Status ComputePrfInto(absl::string_view input,
+                                            absl::Span<char> out) const override;
+
+  // Computes the first 'length' bytes of the PRF output for 'input' in bulk,
+  // into a SecretData. Same limits as ComputePrfInto.
+  crypto::tink::util::StatusOr<util::SecretData> ComputePrfBytes(
+      absl::string_view input, size_t length) const;
+
   static constexpr crypto::tink::internal::FipsCompatibility kFipsStatus =
       crypto::tink::internal::FipsCompatibility::kNotFips;
 
  private:
-  HkdfStreamingPrf(const EVP_MD* hash, util::SecretData secret,
-                   absl::string_view salt)
-      : hash_(hash), secret_(std::move(secret)), salt_(salt) {}
+  // 'prk' is the already extracted pseudorandom key as by RFC 5869,
+  // Section 2.2. HKDF-Extract depends only on the secret and the salt, so New
+  // computes it once per primitive instead of once per stream.
+  HkdfStreamingPrf(const EVP_MD* hash, util::SecretData prk)
+      : hash_(hash), prk_(std::move(prk)) {}
 
   const EVP_MD* hash_;
-  const util::SecretData secret_;
-  const std::string salt_;
+  const util::SecretData prk_;
 };
 
 }  // namespace subtle
@@ -18,9 +18,11 @@
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "absl/types/span.h"
 #include "tink/config/tink_fips.h"
 #include "tink/subtle/hkdf.h"
 #include "tink/subtle/random.h"
+#include "tink/subtle/subtle_util.h"
 #include "tink/util/input_stream_util.h"
 #include "tink/util/secret_data.h"
 #include "tink/util/test_matchers.h"
@@ -539,6 +541,117 @@ TEST(HkdfStreamingPrf, TestAgainstHkdfUtil) {
               Eq(util::SecretDataAsStringView(compute_hkdf_result)));
 }
 
+// BULK COMPUTATION TESTS ======================================================
+// Tests for ComputePrfBytes, which is specific to HkdfStreamingPrf.
+
+TEST(HkdfStreamingPrf, ComputePrfBytesTestVector1) {
+  if (IsFipsModeEnabled()) {
+    GTEST_SKIP() << "Not supported in FIPS-only mode";
+  }
+  // https://tools.ietf.org/html/rfc5869#appendix-A.1
+  util::SecretData ikm = util::SecretDataFromStringView(
+      HexDecodeOrDie("0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b"));
+  std::string salt = HexDecodeOrDie("000102030405060708090a0b0c");
+  std::string info = HexDecodeOrDie("f0f1f2f3f4f5f6f7f8f9");
+  std::string expected_result = HexDecodeOrDie(
+      "3cb25f25faacd57a90434f64d0362f2a"
+      "2d2d0a90cf1a5a4c5db02d56ecc4c5bf"
+      "34007208d5b887185865");
+
+  auto streaming_prf_or = HkdfStreamingPrf::New(SHA256, ikm, salt);
+  ASSERT_THAT(streaming_prf_or.status(), IsOk());
+  auto* hkdf_prf =
+      dynamic_cast<HkdfStreamingPrf*>(streaming_prf_or.ValueOrDie().get());
+  ASSERT_THAT(hkdf_prf, Ne(nullptr));
+
+  auto result_or = hkdf_prf->ComputePrfBytes(info, expected_result.size());
+  ASSERT_THAT(result_or.status(), IsOk());
+  EXPECT_THAT(util::SecretDataAsStringView(result_or.ValueOrDie()),
+              Eq(expected_result));
+}
+
+TEST(HkdfStreamingPrf, ComputePrfBytesMatchesStream) {
+  if (IsFipsModeEnabled()) {
+    GTEST_SKIP() << "Not supported in FIPS-only mode";
+  }
+  auto streaming_prf_or = HkdfStreamingPrf::New(
+      SHA512, util::SecretDataFromStringView("key0123456"), "salt");
+  ASSERT_THAT(streaming_prf_or.status(), IsOk());
+  auto* hkdf_prf =
+      dynamic_cast<HkdfStreamingPrf*>(streaming_prf_or.ValueOrDie().get());
+  ASSERT_THAT(hkdf_prf, Ne(nullptr));
+
+  // Lengths around the block boundaries of SHA512.
+  for (int length : {0, 1, 10, 63, 64, 65, 128, 1000}) {
+    auto bulk_result_or = hkdf_prf->ComputePrfBytes("input", length);
+    ASSERT_THAT(bulk_result_or.status(), IsOk());
+
+    std::unique_ptr<InputStream> stream = hkdf_prf->ComputePrf("input");
+    auto stream_result_or = ReadBytesFromStream(length, stream.get());
+    ASSERT_THAT(stream_result_or.status(), IsOk());
+    EXPECT_THAT(
+        util::SecretDataAsStringView(bulk_result_or.ValueOrDie()),
+        Eq(stream_result_or.ValueOrDie()));
+  }
+}
+
+TEST(HkdfStreamingPrf, ComputePrfBytesTooLong) {
+  if (IsFipsModeEnabled()) {
+    GTEST_SKIP() << "Not supported in FIPS-only mode";
+  }
+  auto streaming_prf_or = HkdfStreamingPrf::New(
+      SHA512, util::SecretDataFromStringView("key0123456"), "salt");
+  ASSERT_THAT(streaming_prf_or.status(), IsOk());
+  auto* hkdf_prf =
+      dynamic_cast<HkdfStreamingPrf*>(streaming_prf_or.ValueOrDie().get());
+  ASSERT_THAT(hkdf_prf, Ne(nullptr));
+
+  const int max_output_length = 255 * (512 / 8);
+  EXPECT_THAT(
+      hkdf_prf->ComputePrfBytes("input", max_output_length).status(), IsOk());
+  EXPECT_THAT(
+      hkdf_prf->ComputePrfBytes("input", max_output_length + 1).status(),
+      StatusIs(util::error::OUT_OF_RANGE));
+}
+
+TEST(HkdfStreamingPrf, ComputePrfIntoMatchesStream) {
+  if (IsFipsModeEnabled()) {
+    GTEST_SKIP() << "Not supported in FIPS-only mode";
+  }
+  auto streaming_prf_or = HkdfStreamingPrf::New(
+      SHA256, util::SecretDataFromStringView("key0123456"), "salt");
+  ASSERT_THAT(streaming_prf_or.status(), IsOk());
+  auto& streaming_prf = *streaming_prf_or.ValueOrDie();
+
+  // Lengths around the block boundaries of SHA256.
+  for (int length : {0, 1, 10, 31, 32, 33, 64, 1000}) {
+    std::string output;
+    ResizeStringUninitialized(&output, length);
+    ASSERT_THAT(streaming_prf.ComputePrfInto(
+                    "input", absl::Span<char>(&output[0], output.size())),
+                IsOk());
+
+    std::unique_ptr<InputStream> stream = streaming_prf.ComputePrf("input");
+    auto stream_result_or = ReadBytesFromStream(length, stream.get());
+    ASSERT_THAT(stream_result_or.status(), IsOk());
+    EXPECT_THAT(output, Eq(stream_result_or.ValueOrDie()));
+  }
+}
+
+TEST(HkdfStreamingPrf, ComputePrfIntoTooLong) {
+  if (IsFipsModeEnabled()) {
+    GTEST_SKIP() << "Not supported in FIPS-only mode";
+  }
+  auto streaming_prf_or = HkdfStreamingPrf::New(
+      SHA256, util::SecretDataFromStringView("key0123456"), "salt");
+  ASSERT_THAT(streaming_prf_or.status(), IsOk());
+
+  std::string output(255 * (256 / 8) + 1, '\0');
+  EXPECT_THAT(streaming_prf_or.ValueOrDie()->ComputePrfInto(
+                  "input", absl::Span<char>(&output[0], output.size())),
+              StatusIs(util::error::OUT_OF_RANGE));
+}
+
 TEST(HkdfStreamingPrf, TestFipsOnly) {
   if (!IsFipsModeEnabled()) {
     GTEST_SKIP() << "Only supported in FIPS-only mode";
@@ -16,11 +16,15 @@
 #include "tink/subtle/prf/prf_set_util.h"
 
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "absl/memory/memory.h"
 #include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
 #include "tink/subtle/mac/stateful_mac.h"
-#include "tink/util/input_stream_util.h"
+#include "tink/subtle/subtle_util.h"
 #include "tink/util/status.h"
 #include "tink/util/statusor.h"
 
@@ -35,15 +39,22 @@ class PrfFromStreamingPrf : public Prf {
       : streaming_prf_(std::move(streaming_prf)) {}
   util::StatusOr<std::string> Compute(absl::string_view input,
                                       size_t output_length) const override {
-    auto inputstream = streaming_prf_->ComputePrf(input);
-    auto output_result = ReadBytesFromStream(output_length, inputstream.get());
-    if (!output_result.ok()) {
-      return output_result.status();
+    // The one-shot API avoids the stream object and its virtual calls.
+    std::string output;
+    ResizeStringUninitialized(&output, output_length);
+    auto status = streaming_prf_->ComputePrfInto(
+        input, absl::Span<char>(&output[0], output.size()));
+    if (!status.ok()) {
+      return status;
     }
-    std::string output = output_result.ValueOrDie();
     return output;
   }
 
+  util::Status ComputeInto(absl::string_view input,
+                           absl::Span<char> output) const override {
+    return streaming_prf_->ComputePrfInto(input, output);
+  }
+
  private:
   std::unique_ptr<StreamingPrf> streaming_prf_;
 };
@@ -78,6 +89,91 @@ class PrfFromStatefulMacFactory : public Prf {
     return output.substr(0, output_length);
   }
 
+  util::StatusOr<std::vector<std::string>> ComputeBatch(
+      absl::Span<const absl::string_view> inputs,
+      size_t output_length) const override {
+    std::vector<std::string> outputs;
+    outputs.reserve(inputs.size());
+    std::unique_ptr<StatefulMac> stateful_mac;
+    for (absl::string_view input : inputs) {
+      // Reuse the MAC context of the previous input where the implementation
+      // supports it (e.g. StatefulHmacBoringSsl), so that the per-input cost
+      // is a reset instead of a full key setup.
+      if (stateful_mac == nullptr || !stateful_mac->Reset().ok()) {
+        auto stateful_mac_result = stateful_mac_factory_->Create();
+        if (!stateful_mac_result.ok()) {
+          return stateful_mac_result.status();
+        }
+        stateful_mac = std::move(stateful_mac_result.ValueOrDie());
+      }
+      auto status = stateful_mac->Update(input);
+      if (!status.ok()) {
+        return status;
+      }
+      auto output_result = stateful_mac->Finalize();
+      if (!output_result.ok()) {
+        return output_result.status();
+      }
+      std::string output = std::move(output_result.ValueOrDie());
+      if (output.size() < output_length) {
+        return util::Status(
+            util::error::INVALID_ARGUMENT,
+            absl::StrCat("PRF only supports outputs up to ", output.size(),
+                         " bytes, but ", output_length,
+                         " bytes were requested"));
+      }
+      outputs.push_back(output.substr(0, output_length));
+    }
+    return outputs;
+  }
+
+  util::Status ComputeInto(absl::string_view input,
+                           absl::Span<char> output) const override {
+    auto stateful_mac_result = stateful_mac_factory_->Create();
+    if (!stateful_mac_result.ok()) {
+      return stateful_mac_result.status();
+    }
+    auto stateful_mac = std::move(stateful_mac_result.ValueOrDie());
+    auto status = stateful_mac->Update(input);
+    if (!status.ok()) {
+      return status;
+    }
+    return stateful_mac->FinalizeTruncatedInto(output);
+  }
+
+  util::Status ComputeBatchInto(absl::Span<const absl::string_view> inputs,
+                                size_t output_length,
+                                absl::Span<char> outputs) const override {
+    if (outputs.size() != inputs.size() * output_length) {
+      return util::Status(
+          util::error::INVALID_ARGUMENT,
+          "outputs must hold exactly output_length bytes per input");
+    }
+    std::unique_ptr<StatefulMac> stateful_mac;
+    for (size_t i = 0; i < inputs.size(); i++) {
+      // As in ComputeBatch(), reuse the MAC context across inputs where the
+      // implementation supports it; the truncated outputs land directly in
+      // their fixed-width slots of the caller's buffer.
+      if (stateful_mac == nullptr || !stateful_mac->Reset().ok()) {
+        auto stateful_mac_result = stateful_mac_factory_->Create();
+        if (!stateful_mac_result.ok()) {
+          return stateful_mac_result.status();
+        }
+        stateful_mac = std::move(stateful_mac_result.ValueOrDie());
+      }
+      auto status = stateful_mac->Update(inputs[i]);
+      if (!status.ok()) {
+        return status;
+      }
+      status = stateful_mac->FinalizeTruncatedInto(
+          outputs.subspan(i * output_length, output_length));
+      if (!status.ok()) {
+        return status;
+      }
+    }
+    return util::OkStatus();
+  }
+
  private:
   std::unique_ptr<StatefulMacFactory> stateful_mac_factory_;
 };
@@ -19,11 +19,13 @@
 #include <memory>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/memory/memory.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "tink/input_stream.h"
 #include "tink/subtle/prf/streaming_prf.h"
 #include "tink/util/istream_input_stream.h"
@@ -41,6 +43,7 @@ using ::testing::_;
 using ::testing::AnyNumber;
 using ::testing::Contains;
 using ::testing::DefaultValue;
+using ::testing::ElementsAre;
 using ::testing::Eq;
 using ::testing::Gt;
 using ::testing::NiceMock;
@@ -79,6 +82,37 @@ class FakeStatefulMacFactory : public StatefulMacFactory {
   util::StatusOr<std::string> finalize_result_;
 };
 
+// A resettable StatefulMac whose tag is the concatenated input, used to check
+// that ComputeBatch reuses one context across the batch.
+class FakeResettableStatefulMac : public StatefulMac {
+ public:
+  util::Status Update(absl::string_view data) override {
+    data_.append(std::string(data));
+    return util::OkStatus();
+  }
+  util::StatusOr<std::string> Finalize() override { return data_; }
+  util::Status Reset() override {
+    data_.clear();
+    return util::OkStatus();
+  }
+
+ private:
+  std::string data_;
+};
+
+class CountingStatefulMacFactory : public StatefulMacFactory {
+ public:
+  explicit CountingStatefulMacFactory(int* create_count)
+      : create_count_(create_count) {}
+  util::StatusOr<std::unique_ptr<StatefulMac>> Create() const override {
+    ++*create_count_;
+    return {absl::make_unique<FakeResettableStatefulMac>()};
+  }
+
+ private:
+  int* create_count_;
+};
+
 class MockStreamingPrf : public StreamingPrf {
  public:
   MOCK_METHOD(std::unique_ptr<InputStream>, ComputePrf,
@@ -133,6 +167,62 @@ TEST_F(PrfFromStatefulMacFactoryTest, ComputePrfTooMuchOutputRequested) {
   EXPECT_FALSE(output_result.ok());
 }
 
+TEST_F(PrfFromStatefulMacFactoryTest, ComputeBatch) {
+  SetUpWithResult(util::OkStatus(), std::string("mock_stateful_mac"));
+  std::vector<absl::string_view> inputs = {"test_input", "test_input2"};
+  auto outputs_result = prf()->ComputeBatch(absl::MakeConstSpan(inputs), 5);
+  ASSERT_TRUE(outputs_result.ok()) << outputs_result.status();
+  EXPECT_THAT(outputs_result.ValueOrDie(), ElementsAre("mock_", "mock_"));
+}
+
+TEST_F(PrfFromStatefulMacFactoryTest, ComputeBatchUpdateFails) {
+  SetUpWithResult(util::Status(util::error::INTERNAL, "UpdateFailed"),
+                  std::string("mock_stateful_mac"));
+  std::vector<absl::string_view> inputs = {"test_input"};
+  auto outputs_result = prf()->ComputeBatch(absl::MakeConstSpan(inputs), 5);
+  EXPECT_FALSE(outputs_result.ok());
+  EXPECT_THAT(outputs_result.status().error_message(), StrEq("UpdateFailed"));
+}
+
+TEST(PrfFromStatefulMacFactoryBatchTest, ComputeBatchReusesContext) {
+  int create_count = 0;
+  auto prf = CreatePrfFromStatefulMacFactory(
+      absl::make_unique<CountingStatefulMacFactory>(&create_count));
+  std::vector<absl::string_view> inputs = {"aaaaa", "bbbbb", "ccccc"};
+  auto outputs_result = prf->ComputeBatch(absl::MakeConstSpan(inputs), 5);
+  ASSERT_TRUE(outputs_result.ok()) << outputs_result.status();
+  EXPECT_THAT(outputs_result.ValueOrDie(),
+              ElementsAre("aaaaa", "bbbbb", "ccccc"));
+  // The fake MAC supports Reset, so a single context serves the whole batch.
+  EXPECT_THAT(create_count, Eq(1));
+}
+
+TEST_F(PrfFromStatefulMacFactoryTest, ComputePrfInto) {
+  SetUpWithResult(util::OkStatus(), std::string("mock_stateful_mac"));
+  std::string output(5, '\0');
+  EXPECT_THAT(prf()->ComputeInto("test_input", absl::MakeSpan(&output[0], 5)),
+              IsOk());
+  EXPECT_THAT(output, StrEq("mock_"));
+}
+
+TEST(PrfFromStatefulMacFactoryBatchTest, ComputeBatchIntoPacksOutputs) {
+  int create_count = 0;
+  auto prf = CreatePrfFromStatefulMacFactory(
+      absl::make_unique<CountingStatefulMacFactory>(&create_count));
+  std::vector<absl::string_view> inputs = {"aaaaa", "bbbbb", "ccccc"};
+  std::string outputs(15, '\0');
+  EXPECT_THAT(prf->ComputeBatchInto(absl::MakeConstSpan(inputs), 5,
+                                    absl::MakeSpan(&outputs[0], 15)),
+              IsOk());
+  // The truncated outputs land back to back in their fixed-width slots.
+  EXPECT_THAT(outputs, StrEq("aaaaabbbbbccccc"));
+  EXPECT_THAT(create_count, Eq(1));
+  // The buffer must hold exactly output_length bytes per input.
+  EXPECT_THAT(prf->ComputeBatchInto(absl::MakeConstSpan(inputs), 5,
+                                    absl::MakeSpan(&outputs[0], 14)),
+              StatusIs(util::error::INVALID_ARGUMENT));
+}
+
 class PrfFromStreamingPrfTest : public ::testing::Test {
  protected:
   void SetUp() override {
@@ -175,6 +265,20 @@ TEST_F(PrfFromStreamingPrfTest, ComputeSubstring) {
   EXPECT_THAT(output_result.ValueOrDie(), StrEq("ou"));
 }
 
+TEST_F(PrfFromStreamingPrfTest, ComputePrfInto) {
+  std::string output(5, '\0');
+  EXPECT_THAT(prf()->ComputeInto("input", absl::MakeSpan(&output[0], 5)),
+              IsOk());
+  EXPECT_THAT(output, StrEq("outpu"));
+}
+
+TEST_F(PrfFromStreamingPrfTest, ComputeBatch) {
+  std::vector<absl::string_view> inputs = {"input", "input"};
+  auto outputs_result = prf()->ComputeBatch(absl::MakeConstSpan(inputs), 5);
+  ASSERT_THAT(outputs_result.status(), IsOk());
+  EXPECT_THAT(outputs_result.ValueOrDie(), ElementsAre("outpu", "outpu"));
+}
+
 TEST_F(PrfFromStreamingPrfTest, ComputeTooMuch) {
   auto output_result = prf()->Compute("input", 5);
   ASSERT_THAT(output_result.status(), IsOk());
@@ -0,0 +1,46 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////////
+#include "tink/subtle/prf/streaming_prf.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+#include "tink/input_stream.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+
+util::Status StreamingPrf::ComputePrfInto(absl::string_view input,
+                                          absl::Span<char> out) const {
+  std::unique_ptr<InputStream> stream = ComputePrf(input);
+  size_t offset = 0;
+  while (offset < out.size()) {
+    const void* data;
+    auto next_result = stream->Next(&data);
+    if (!next_result.ok()) return next_result.status();
+    size_t read = std::min(static_cast<size_t>(next_result.ValueOrDie()),
+                           out.size() - offset);
+    std::memcpy(out.data() + offset, data, read);
+    offset += read;
+  }
+  return util::OkStatus();
+}
+
+}  // namespace tink
+}  // namespace crypto
@@ -19,7 +19,9 @@
 #include <memory>
 
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "tink/input_stream.h"
+#include "tink/util/status.h"
 
 namespace crypto {
 namespace tink {
@@ -38,6 +40,15 @@ class StreamingPrf {
   virtual std::unique_ptr<InputStream> ComputePrf(
       absl::string_view input) const = 0;
 
+  // Writes out.size() bytes of the PRF output for this input into 'out'.
+  // The result equals reading out.size() bytes from the stream returned by
+  // ComputePrf, but implementations can skip the stream object when the
+  // needed length is known up front; the default implementation drains such
+  // a stream. Returns OUT_OF_RANGE if the PRF cannot produce out.size()
+  // bytes.
+  virtual crypto::tink::util::Status ComputePrfInto(absl::string_view input,
+                                                    absl::Span<char> out) const;
+
   virtual ~StreamingPrf() {}
 };
 
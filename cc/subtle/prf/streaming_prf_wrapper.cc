@@ -33,6 +33,12 @@ class StreamingPrfSetWrapper : public StreamingPrf {
     return streaming_prf_set_->get_primary()->get_primitive().ComputePrf(input);
   }
 
+  crypto::tink::util::Status ComputePrfInto(
+      absl::string_view input, absl::Span<char> out) const override {
+    return streaming_prf_set_->get_primary()->get_primitive().ComputePrfInto(
+        input, out);
+  }
+
   ~StreamingPrfSetWrapper() override {}
 
  private:
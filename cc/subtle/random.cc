@@ -19,48 +19,116 @@
 #include <cstring>
 #include <string>
 
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include "openssl/mem.h"
 #include "openssl/rand.h"
 
 namespace crypto {
 namespace tink {
 namespace subtle {
 
+namespace {
+
+int64_t CurrentProcessId() {
+#ifdef _WIN32
+  // There is no fork() on Windows, so no refill tagging is needed.
+  return 0;
+#else
+  return static_cast<int64_t>(getpid());
+#endif
+}
+
+// A thread-local pool of random bytes which is refilled from RAND_bytes in
+// large chunks. It amortizes the cost of the (locked) BoringSSL RNG over many
+// small draws such as IVs and nonces. The pool is fork-safe: the buffer is
+// tagged with the process id at refill time and discarded on mismatch, so a
+// child process never re-serves bytes drawn in its parent. Served bytes are
+// cleansed immediately and the whole buffer is zeroized when the thread exits.
+class RandomBytesPool {
+ public:
+  ~RandomBytesPool() { OPENSSL_cleanse(buffer_, sizeof(buffer_)); }
+
+  void Fill(uint8_t* out, size_t length) {
+    if (length > kMaxPooledRequest) {
+      // Large requests (e.g. key material helpers) go straight to the RNG.
+      //
+      // BoringSSL documentation says that RAND_bytes always returns 1; while
+      // OpenSSL documentation says that it returns 1 on success, 0 otherwise.
+      // We use BoringSSL, so we don't check the return value.
+      //
+      // In case of insufficient entropy at the time of the call, BoringSSL's
+      // RAND_bytes will behave in different ways depending on the operating
+      // system, version, and FIPS mode. For Linux with a semi-recent kernel,
+      // it will block until the system has collected at least 128 bits since
+      // boot. For old kernels without getrandom support (and not in FIPS
+      // mode), it will resort to /dev/urandom.
+      RAND_bytes(out, length);
+      return;
+    }
+    const int64_t process_id = CurrentProcessId();
+    if (process_id != process_id_) {
+      // First use in this thread, or first use after fork().
+      position_ = sizeof(buffer_);
+      process_id_ = process_id;
+    }
+    if (sizeof(buffer_) - position_ < length) {
+      RAND_bytes(buffer_, sizeof(buffer_));
+      position_ = 0;
+    }
+    std::memcpy(out, buffer_ + position_, length);
+    // Never keep served bytes around.
+    OPENSSL_cleanse(buffer_ + position_, length);
+    position_ += length;
+  }
+
+ private:
+  static constexpr size_t kMaxPooledRequest = 256;
+
+  uint8_t buffer_[4096];
+  size_t position_ = sizeof(buffer_);
+  int64_t process_id_ = -1;
+};
+
+RandomBytesPool& GetRandomBytesPool() {
+  thread_local RandomBytesPool pool;
+  return pool;
+}
+
+}  // namespace
+
 // static
 std::string Random::GetRandomBytes(size_t length) {
-  std::unique_ptr<uint8_t[]> buf(new uint8_t[length]);
-  // BoringSSL documentation says that it always returns 1; while
-  // OpenSSL documentation says that it returns 1 on success, 0 otherwise. We
-  // use BoringSSL, so we don't check the return value.
-  //
-  // In case of insufficient entropy at the time of the call, BoringSSL's
-  // RAND_bytes will behave in different ways depending on the operating system,
-  // version, and FIPS mode. For Linux with a semi-recent kernel, it will block
-  // until the system has collected at least 128 bits since boot. For old
-  // kernels without getrandom support (and not in FIPS mode), it will resort to
-  // /dev/urandom.
-  RAND_bytes(buf.get(), length);
-  return std::string(reinterpret_cast<const char *>(buf.get()), length);
+  std::string result(length, '\0');
+  GetRandomBytesPool().Fill(reinterpret_cast<uint8_t*>(&result[0]), length);
+  return result;
+}
+
+// static
+void Random::GetRandomBytes(absl::Span<char> out) {
+  GetRandomBytesPool().Fill(reinterpret_cast<uint8_t*>(out.data()),
+                            out.size());
 }
 
 uint32_t Random::GetRandomUInt32() {
-  uint8_t buf[sizeof(uint32_t)];
-  RAND_bytes(buf, sizeof(uint32_t));
   uint32_t result;
-  std::memcpy(&result, buf, sizeof(uint32_t));
+  GetRandomBytesPool().Fill(reinterpret_cast<uint8_t*>(&result),
+                            sizeof(uint32_t));
   return result;
 }
 
 uint16_t Random::GetRandomUInt16() {
-  uint8_t buf[sizeof(uint16_t)];
-  RAND_bytes(buf, sizeof(uint16_t));
   uint16_t result;
-  std::memcpy(&result, buf, sizeof(uint16_t));
+  GetRandomBytesPool().Fill(reinterpret_cast<uint8_t*>(&result),
+                            sizeof(uint16_t));
   return result;
 }
 
 uint8_t Random::GetRandomUInt8() {
   uint8_t result;
-  RAND_bytes(&result, 1);
+  GetRandomBytesPool().Fill(&result, 1);
   return result;
 }
 
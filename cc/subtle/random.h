@@ -20,6 +20,7 @@
 #include <memory>
 #include <string>
 
+#include "absl/types/span.h"
 #include "tink/util/secret_data.h"
 
 namespace crypto {
@@ -30,10 +31,17 @@ class Random {
  public:
   // Returns a random string of desired length.
   static std::string GetRandomBytes(size_t length);
+  // Fills 'out' with random bytes without allocating. Small requests (IVs,
+  // nonces) are served from a thread-local pool which is refilled from the
+  // underlying RNG in large chunks, so they do not contend on the BoringSSL
+  // RNG lock.
+  static void GetRandomBytes(absl::Span<char> out);
   static uint32_t GetRandomUInt32();
   static uint16_t GetRandomUInt16();
   static uint8_t GetRandomUInt8();
   // Returns length bytes of random data stored in specialized key container.
+  // Key material is always drawn directly from the underlying RNG, never from
+  // the thread-local pool.
   static util::SecretData GetRandomKeyBytes(size_t length);
 };
 
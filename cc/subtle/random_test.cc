@@ -23,6 +23,7 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/types/span.h"
 #include "tink/util/secret_data.h"
 
 namespace crypto {
@@ -45,6 +46,26 @@ TEST(RandomTest, testBasic) {
   EXPECT_THAT(rand_strings, SizeIs(numTests));
 }
 
+TEST(RandomTest, SpanFillTest) {
+  int numTests = 32;
+  absl::flat_hash_set<std::string> rand_strings;
+  for (int i = 0; i < numTests; i++) {
+    std::string s(16, '\0');
+    Random::GetRandomBytes(absl::MakeSpan(&s[0], s.size()));
+    rand_strings.insert(s);
+  }
+  EXPECT_THAT(rand_strings, SizeIs(numTests));
+}
+
+TEST(RandomTest, LargeRequestBypassesPoolTest) {
+  // Requests larger than the thread-local pool chunk still work and are
+  // distinct.
+  std::string a = Random::GetRandomBytes(8192);
+  std::string b = Random::GetRandomBytes(8192);
+  EXPECT_THAT(a, SizeIs(8192));
+  EXPECT_NE(a, b);
+}
+
 TEST(RandomTest, KeyBytesTest) {
   util::SecretData key = Random::GetRandomKeyBytes(16);
   EXPECT_THAT(key, SizeIs(16));
@@ -0,0 +1,166 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/subtle/rsa_key_pool.h"
+
+#include <utility>
+
+#include "absl/synchronization/mutex.h"
+
+namespace crypto {
+namespace tink {
+namespace subtle {
+
+namespace {
+
+absl::Mutex* GlobalInstanceMutex() {
+  static absl::Mutex* mutex = new absl::Mutex();
+  return mutex;
+}
+
+RsaKeyPool** GlobalInstanceSlot() {
+  static RsaKeyPool** slot = new RsaKeyPool*(nullptr);
+  return slot;
+}
+
+}  // namespace
+
+// static
+std::unique_ptr<RsaKeyPool> RsaKeyPool::New(Options options) {
+  if (options.keys_per_spec < 1) {
+    options.keys_per_spec = 1;
+  }
+  std::unique_ptr<RsaKeyPool> pool(new RsaKeyPool(options));
+  pool->generator_ = std::thread(&RsaKeyPool::GeneratorLoop, pool.get());
+  return pool;
+}
+
+RsaKeyPool::~RsaKeyPool() {
+  {
+    absl::MutexLock lock(&mu_);
+    stopped_ = true;
+  }
+  if (generator_.joinable()) {
+    generator_.join();
+  }
+}
+
+// static
+util::Status RsaKeyPool::GenerateOne(int modulus_size_in_bits,
+                                     absl::string_view public_exponent,
+                                     KeyPair* key_pair) {
+  auto e = SubtleUtilBoringSSL::str2bn(public_exponent);
+  if (!e.ok()) return e.status();
+  return SubtleUtilBoringSSL::GetNewRsaKeyPair(
+      modulus_size_in_bits, e.ValueOrDie().get(), &key_pair->private_key,
+      &key_pair->public_key);
+}
+
+util::Status RsaKeyPool::GetKeyPair(
+    int modulus_size_in_bits, absl::string_view public_exponent,
+    SubtleUtilBoringSSL::RsaPrivateKey* private_key,
+    SubtleUtilBoringSSL::RsaPublicKey* public_key) {
+  KeySpec spec(modulus_size_in_bits, std::string(public_exponent));
+  {
+    absl::MutexLock lock(&mu_);
+    // operator[] registers the spec, so the background thread starts
+    // keeping keys ready for it even if the pool is empty right now.
+    std::vector<KeyPair>& bucket = keys_[spec];
+    if (!bucket.empty()) {
+      *private_key = std::move(bucket.back().private_key);
+      *public_key = std::move(bucket.back().public_key);
+      bucket.pop_back();
+      return util::OkStatus();
+    }
+  }
+  // Nothing ready: generate on the calling thread, as without a pool.
+  KeyPair key_pair;
+  auto status = GenerateOne(modulus_size_in_bits, public_exponent, &key_pair);
+  if (!status.ok()) return status;
+  *private_key = std::move(key_pair.private_key);
+  *public_key = std::move(key_pair.public_key);
+  return util::OkStatus();
+}
+
+int RsaKeyPool::keys_ready(int modulus_size_in_bits,
+                           absl::string_view public_exponent) {
+  KeySpec spec(modulus_size_in_bits, std::string(public_exponent));
+  absl::MutexLock lock(&mu_);
+  auto found = keys_.find(spec);
+  if (found == keys_.end()) return 0;
+  return found->second.size();
+}
+
+bool RsaKeyPool::GeneratorHasWork() const {
+  if (stopped_) return true;
+  for (const auto& spec_and_bucket : keys_) {
+    if (spec_and_bucket.second.size() <
+        static_cast<size_t>(options_.keys_per_spec)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void RsaKeyPool::GeneratorLoop() {
+  while (true) {
+    KeySpec spec;
+    {
+      absl::MutexLock lock(&mu_);
+      mu_.Await(absl::Condition(this, &RsaKeyPool::GeneratorHasWork));
+      if (stopped_) return;
+      for (const auto& spec_and_bucket : keys_) {
+        if (spec_and_bucket.second.size() <
+            static_cast<size_t>(options_.keys_per_spec)) {
+          spec = spec_and_bucket.first;
+          break;
+        }
+      }
+    }
+    // The expensive generation runs without holding mu_, so callers can
+    // drain the pool concurrently.
+    KeyPair key_pair;
+    auto status = GenerateOne(spec.first, spec.second, &key_pair);
+    absl::MutexLock lock(&mu_);
+    if (stopped_) return;
+    if (!status.ok()) {
+      // Stop replenishing this spec rather than retrying in a tight loop;
+      // callers fall back to synchronous generation, which surfaces the
+      // error to them.
+      keys_.erase(spec);
+      continue;
+    }
+    keys_[spec].push_back(std::move(key_pair));
+  }
+}
+
+// static
+void RsaKeyPool::SetGlobalInstance(std::unique_ptr<RsaKeyPool> pool) {
+  absl::MutexLock lock(GlobalInstanceMutex());
+  RsaKeyPool** slot = GlobalInstanceSlot();
+  delete *slot;
+  *slot = pool.release();
+}
+
+// static
+RsaKeyPool* RsaKeyPool::GetGlobalInstance() {
+  absl::MutexLock lock(GlobalInstanceMutex());
+  return *GlobalInstanceSlot();
+}
+
+}  // namespace subtle
+}  // namespace tink
+}  // namespace crypto
@@ -0,0 +1,116 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_SUBTLE_RSA_KEY_POOL_H_
+#define TINK_SUBTLE_RSA_KEY_POOL_H_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "tink/subtle/subtle_util_boringssl.h"
+#include "tink/util/status.h"
+
+namespace crypto {
+namespace tink {
+namespace subtle {
+
+// A pool of pre-generated RSA key pairs, replenished by a background
+// thread. BoringSSL RSA key generation blocks the calling thread for
+// hundreds of milliseconds to seconds for 3072/4096-bit moduli; services
+// that create keys in bursts can install a pool so that key creation
+// drains pre-generated pairs instead.
+//
+// The pool learns the requested (modulus size, public exponent)
+// combinations on first use: the first request for a combination is served
+// by generating a key on the calling thread, and the background thread
+// then keeps 'keys_per_spec' pairs ready for subsequent requests.
+//
+// The RSA signature key managers consult the pool installed with
+// SetGlobalInstance() in their CreateKey; KeysetManager::GenerateNewKey
+// goes through those managers and benefits automatically.
+class RsaKeyPool {
+ public:
+  struct Options {
+    // Number of pre-generated key pairs kept ready per requested
+    // (modulus size, public exponent) combination.
+    int keys_per_spec = 2;
+  };
+
+  // Creates a pool and starts its background generator thread.
+  static std::unique_ptr<RsaKeyPool> New(Options options);
+
+  // Stops the background thread; keys still pooled are discarded.
+  ~RsaKeyPool();
+
+  // Fills 'private_key' and 'public_key' with a new key pair of the given
+  // modulus size and public exponent (unsigned bigendian bytes), taking a
+  // pre-generated pair when one is ready and generating one on the calling
+  // thread otherwise.
+  crypto::tink::util::Status GetKeyPair(
+      int modulus_size_in_bits, absl::string_view public_exponent,
+      SubtleUtilBoringSSL::RsaPrivateKey* private_key,
+      SubtleUtilBoringSSL::RsaPublicKey* public_key);
+
+  // Returns the number of pre-generated key pairs currently ready for the
+  // given combination; mainly useful for monitoring and tests.
+  int keys_ready(int modulus_size_in_bits, absl::string_view public_exponent);
+
+  // Installs 'pool' as the process-wide instance consulted by the RSA
+  // signature key managers, or removes it again if 'pool' is nullptr.
+  // A previously installed pool is destroyed; this must not race with
+  // threads that are still creating keys.
+  static void SetGlobalInstance(std::unique_ptr<RsaKeyPool> pool);
+
+  // Returns the installed process-wide pool, or nullptr if none is set.
+  static RsaKeyPool* GetGlobalInstance();
+
+ private:
+  struct KeyPair {
+    SubtleUtilBoringSSL::RsaPrivateKey private_key;
+    SubtleUtilBoringSSL::RsaPublicKey public_key;
+  };
+  // Modulus size in bits and public exponent bytes.
+  typedef std::pair<int, std::string> KeySpec;
+
+  explicit RsaKeyPool(Options options) : options_(options) {}
+
+  static crypto::tink::util::Status GenerateOne(
+      int modulus_size_in_bits, absl::string_view public_exponent,
+      KeyPair* key_pair);
+
+  void GeneratorLoop();
+  // Predicate for mu_.Await(); requires mu_ to be held.
+  bool GeneratorHasWork() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  const Options options_;
+  absl::Mutex mu_;
+  bool stopped_ ABSL_GUARDED_BY(mu_) = false;
+  std::map<KeySpec, std::vector<KeyPair>> keys_ ABSL_GUARDED_BY(mu_);
+  std::thread generator_;
+};
+
+}  // namespace subtle
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_SUBTLE_RSA_KEY_POOL_H_
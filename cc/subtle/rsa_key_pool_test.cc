@@ -0,0 +1,116 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/subtle/rsa_key_pool.h"
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "openssl/bn.h"
+#include "openssl/rsa.h"
+#include "tink/config/tink_fips.h"
+#include "tink/subtle/subtle_util_boringssl.h"
+
+namespace crypto {
+namespace tink {
+namespace subtle {
+namespace {
+
+constexpr int kModulusSizeInBits = 2048;
+
+std::string DefaultPublicExponent() {
+  bssl::UniquePtr<BIGNUM> e(BN_new());
+  BN_set_word(e.get(), RSA_F4);
+  return SubtleUtilBoringSSL::bn2str(e.get(), BN_num_bytes(e.get()))
+      .ValueOrDie();
+}
+
+TEST(RsaKeyPoolTest, GetKeyPairWorksOnEmptyPool) {
+  if (IsFipsModeEnabled()) {
+    GTEST_SKIP() << "Test assumes kOnlyUseFips is false.";
+  }
+  RsaKeyPool::Options options;
+  options.keys_per_spec = 1;
+  auto pool = RsaKeyPool::New(options);
+
+  // The first request finds no pre-generated key and generates one on the
+  // calling thread.
+  SubtleUtilBoringSSL::RsaPrivateKey private_key;
+  SubtleUtilBoringSSL::RsaPublicKey public_key;
+  auto status = pool->GetKeyPair(kModulusSizeInBits, DefaultPublicExponent(),
+                                 &private_key, &public_key);
+  ASSERT_TRUE(status.ok()) << status;
+  EXPECT_EQ(private_key.n, public_key.n);
+  EXPECT_EQ(private_key.e, public_key.e);
+  EXPECT_FALSE(private_key.n.empty());
+}
+
+TEST(RsaKeyPoolTest, BackgroundThreadReplenishesPool) {
+  if (IsFipsModeEnabled()) {
+    GTEST_SKIP() << "Test assumes kOnlyUseFips is false.";
+  }
+  RsaKeyPool::Options options;
+  options.keys_per_spec = 2;
+  auto pool = RsaKeyPool::New(options);
+  std::string public_exponent = DefaultPublicExponent();
+
+  // Registers the spec with the pool.
+  SubtleUtilBoringSSL::RsaPrivateKey private_key;
+  SubtleUtilBoringSSL::RsaPublicKey public_key;
+  ASSERT_TRUE(pool->GetKeyPair(kModulusSizeInBits, public_exponent,
+                               &private_key, &public_key)
+                  .ok());
+
+  // Wait for the background thread to fill the pool.
+  for (int i = 0; i < 600; i++) {
+    if (pool->keys_ready(kModulusSizeInBits, public_exponent) >=
+        options.keys_per_spec) {
+      break;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+  ASSERT_EQ(pool->keys_ready(kModulusSizeInBits, public_exponent),
+            options.keys_per_spec);
+
+  // Draining a pre-generated key yields a different, valid key pair.
+  SubtleUtilBoringSSL::RsaPrivateKey pooled_private_key;
+  SubtleUtilBoringSSL::RsaPublicKey pooled_public_key;
+  auto status = pool->GetKeyPair(kModulusSizeInBits, public_exponent,
+                                 &pooled_private_key, &pooled_public_key);
+  ASSERT_TRUE(status.ok()) << status;
+  EXPECT_EQ(pooled_private_key.n, pooled_public_key.n);
+  EXPECT_NE(pooled_private_key.n, private_key.n);
+  EXPECT_EQ(pool->keys_ready(kModulusSizeInBits, public_exponent),
+            options.keys_per_spec - 1);
+}
+
+TEST(RsaKeyPoolTest, GlobalInstance) {
+  if (IsFipsModeEnabled()) {
+    GTEST_SKIP() << "Test assumes kOnlyUseFips is false.";
+  }
+  EXPECT_EQ(RsaKeyPool::GetGlobalInstance(), nullptr);
+  RsaKeyPool::SetGlobalInstance(RsaKeyPool::New(RsaKeyPool::Options()));
+  EXPECT_NE(RsaKeyPool::GetGlobalInstance(), nullptr);
+  RsaKeyPool::SetGlobalInstance(nullptr);
+  EXPECT_EQ(RsaKeyPool::GetGlobalInstance(), nullptr);
+}
+
+}  // namespace
+}  // namespace subtle
+}  // namespace tink
+}  // namespace crypto
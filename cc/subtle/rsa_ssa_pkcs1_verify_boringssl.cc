@@ -28,6 +28,28 @@ namespace crypto {
 namespace tink {
 namespace subtle {
 
+namespace {
+
+// Hashes 'data' with 'hasher' into 'digest', reusing a thread-local digest
+// context instead of allocating a fresh EVP_MD_CTX on every call the way
+// EVP_Digest() does.
+util::Status ComputeHashWithReusedContext(absl::string_view data,
+                                          const EVP_MD* hasher,
+                                          uint8_t digest[EVP_MAX_MD_SIZE],
+                                          unsigned int* digest_size) {
+  thread_local static bssl::ScopedEVP_MD_CTX md_ctx;
+  if (EVP_DigestInit_ex(md_ctx.get(), hasher, /*engine=*/nullptr) != 1 ||
+      EVP_DigestUpdate(md_ctx.get(), data.data(), data.size()) != 1 ||
+      EVP_DigestFinal_ex(md_ctx.get(), digest, digest_size) != 1) {
+    return util::Status(util::error::INTERNAL,
+                        absl::StrCat("Openssl internal error computing hash: ",
+                                     SubtleUtilBoringSSL::GetErrors()));
+  }
+  return util::Status::OK;
+}
+
+}  // namespace
+
 // static
 util::StatusOr<std::unique_ptr<RsaSsaPkcs1VerifyBoringSsl>>
 RsaSsaPkcs1VerifyBoringSsl::New(
@@ -55,6 +77,11 @@ RsaSsaPkcs1VerifyBoringSsl::New(
   std::unique_ptr<RsaSsaPkcs1VerifyBoringSsl> verify(
       new RsaSsaPkcs1VerifyBoringSsl(std::move(rsa).ValueOrDie(),
                                      sig_hash_result.ValueOrDie()));
+  // One throwaway verification warms BoringSSL's lazily built Montgomery
+  // context for the public modulus, so that the first real Verify() calls
+  // neither pay for its construction nor serialize on it.
+  std::string dummy_signature(RSA_size(verify->rsa_.get()), '\0');
+  verify->Verify(dummy_signature, "").IgnoreError();
   return std::move(verify);
 }
 
@@ -64,14 +91,16 @@ util::Status RsaSsaPkcs1VerifyBoringSsl::Verify(absl::string_view signature,
   // regardless of whether the size is 0.
   data = SubtleUtilBoringSSL::EnsureNonNull(data);
 
-  auto digest_result = boringssl::ComputeHash(data, *sig_hash_);
-  if (!digest_result.ok()) return digest_result.status();
-  auto digest = std::move(digest_result.ValueOrDie());
+  uint8_t digest[EVP_MAX_MD_SIZE];
+  unsigned int digest_size = 0;
+  auto hash_status =
+      ComputeHashWithReusedContext(data, sig_hash_, digest, &digest_size);
+  if (!hash_status.ok()) return hash_status;
 
   if (1 !=
       RSA_verify(EVP_MD_type(sig_hash_),
-                 /*msg=*/digest.data(),
-                 /*msg_len=*/digest.size(),
+                 /*msg=*/digest,
+                 /*msg_len=*/digest_size,
                  /*sig=*/reinterpret_cast<const uint8_t*>(signature.data()),
                  /*sig_len=*/signature.length(),
                  /*rsa=*/rsa_.get())) {
@@ -17,6 +17,7 @@
 #include "tink/subtle/rsa_ssa_pss_verify_boringssl.h"
 #include "absl/strings/str_cat.h"
 #include "openssl/bn.h"
+#include "openssl/digest.h"
 #include "openssl/evp.h"
 #include "openssl/rsa.h"
 #include "tink/subtle/common_enums.h"
@@ -27,6 +28,28 @@ namespace crypto {
 namespace tink {
 namespace subtle {
 
+namespace {
+
+// Hashes 'data' with 'hasher' into 'digest', reusing a thread-local digest
+// context instead of allocating a fresh EVP_MD_CTX on every call the way
+// EVP_Digest() does.
+util::Status ComputeHashWithReusedContext(absl::string_view data,
+                                          const EVP_MD* hasher,
+                                          uint8_t digest[EVP_MAX_MD_SIZE],
+                                          unsigned int* digest_size) {
+  thread_local static bssl::ScopedEVP_MD_CTX md_ctx;
+  if (EVP_DigestInit_ex(md_ctx.get(), hasher, /*engine=*/nullptr) != 1 ||
+      EVP_DigestUpdate(md_ctx.get(), data.data(), data.size()) != 1 ||
+      EVP_DigestFinal_ex(md_ctx.get(), digest, digest_size) != 1) {
+    return util::Status(util::error::INTERNAL,
+                        absl::StrCat("Openssl internal error computing hash: ",
+                                     SubtleUtilBoringSSL::GetErrors()));
+  }
+  return util::Status::OK;
+}
+
+}  // namespace
+
 // static
 util::StatusOr<std::unique_ptr<RsaSsaPssVerifyBoringSsl>>
 RsaSsaPssVerifyBoringSsl::New(
@@ -58,6 +81,11 @@ RsaSsaPssVerifyBoringSsl::New(
   std::unique_ptr<RsaSsaPssVerifyBoringSsl> verify(new RsaSsaPssVerifyBoringSsl(
       std::move(rsa).ValueOrDie(), sig_hash_result.ValueOrDie(),
       mgf1_hash_result.ValueOrDie(), params.salt_length));
+  // One throwaway verification warms BoringSSL's lazily built Montgomery
+  // context for the public modulus, so that the first real Verify() calls
+  // neither pay for its construction nor serialize on it.
+  std::string dummy_signature(RSA_size(verify->rsa_.get()), '\0');
+  verify->Verify(dummy_signature, "").IgnoreError();
   return std::move(verify);
 }
 
@@ -67,12 +95,14 @@ util::Status RsaSsaPssVerifyBoringSsl::Verify(absl::string_view signature,
   // regardless of whether the size is 0.
   data = SubtleUtilBoringSSL::EnsureNonNull(data);
 
-  auto digest_result = boringssl::ComputeHash(data, *sig_hash_);
-  if (!digest_result.ok()) return digest_result.status();
-  auto digest = std::move(digest_result.ValueOrDie());
+  uint8_t digest[EVP_MAX_MD_SIZE];
+  unsigned int digest_size = 0;
+  auto hash_status =
+      ComputeHashWithReusedContext(data, sig_hash_, digest, &digest_size);
+  if (!hash_status.ok()) return hash_status;
 
   if (1 != RSA_verify_pss_mgf1(
-               rsa_.get(), digest.data(), digest.size(), sig_hash_, mgf1_hash_,
+               rsa_.get(), digest, digest_size, sig_hash_, mgf1_hash_,
                salt_length_, reinterpret_cast<const uint8_t*>(signature.data()),
                signature.length())) {
     // Signature is invalid.
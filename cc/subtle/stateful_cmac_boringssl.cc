@@ -25,8 +25,11 @@ namespace crypto {
 namespace tink {
 namespace subtle {
 
-util::StatusOr<std::unique_ptr<StatefulMac>> StatefulCmacBoringSsl::New(
-    uint32_t tag_size, const util::SecretData& key_value) {
+namespace {
+
+// Returns an initialized CMAC context for 'key_value', or nullptr if the
+// key size is unsupported or initialization fails.
+bssl::UniquePtr<CMAC_CTX> NewCmacContext(const util::SecretData& key_value) {
   const EVP_CIPHER* cipher;
   switch (key_value.size()) {
     case 16:
@@ -36,18 +39,30 @@ util::StatusOr<std::unique_ptr<StatefulMac>> StatefulCmacBoringSsl::New(
       cipher = EVP_aes_256_cbc();
       break;
     default:
-      return util::Status(util::error::INVALID_ARGUMENT, "invalid key size");
+      return nullptr;
+  }
+  bssl::UniquePtr<CMAC_CTX> ctx(CMAC_CTX_new());
+  if (!CMAC_Init(ctx.get(), key_value.data(), key_value.size(), cipher,
+                 nullptr /* engine */)) {
+    return nullptr;
+  }
+  return ctx;
+}
+
+}  // namespace
+
+util::StatusOr<std::unique_ptr<StatefulMac>> StatefulCmacBoringSsl::New(
+    uint32_t tag_size, const util::SecretData& key_value) {
+  if (key_value.size() != kSmallKeySize && key_value.size() != kBigKeySize) {
+    return util::Status(util::error::INVALID_ARGUMENT, "invalid key size");
   }
   if (tag_size > kMaxTagSize) {
     return util::Status(util::error::INVALID_ARGUMENT, "invalid tag size");
   }
 
   // Create and initialize the CMAC context
-  bssl::UniquePtr<CMAC_CTX> ctx(CMAC_CTX_new());
-
-  // Initialize the CMAC
-  if (!CMAC_Init(ctx.get(), key_value.data(), key_value.size(), cipher,
-                 nullptr /* engine */)) {
+  bssl::UniquePtr<CMAC_CTX> ctx = NewCmacContext(key_value);
+  if (ctx == nullptr) {
     return util::Status(util::error::FAILED_PRECONDITION,
                         "CMAC initialization failed");
   }
@@ -56,6 +71,35 @@ util::StatusOr<std::unique_ptr<StatefulMac>> StatefulCmacBoringSsl::New(
       absl::WrapUnique(new StatefulCmacBoringSsl(tag_size, std::move(ctx)))};
 }
 
+util::StatusOr<std::unique_ptr<StatefulMac>>
+StatefulCmacBoringSsl::NewFromTemplate(uint32_t tag_size,
+                                       const CMAC_CTX* template_ctx) {
+  if (template_ctx == nullptr) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "template_ctx must be non-null");
+  }
+  if (tag_size > kMaxTagSize) {
+    return util::Status(util::error::INVALID_ARGUMENT, "invalid tag size");
+  }
+
+  // Clone the template: copies the expanded key schedule instead of
+  // re-running it.
+  bssl::UniquePtr<CMAC_CTX> ctx(CMAC_CTX_new());
+  if (!CMAC_CTX_copy(ctx.get(), template_ctx)) {
+    return util::Status(util::error::INTERNAL, "CMAC context copy failed");
+  }
+
+  return {
+      absl::WrapUnique(new StatefulCmacBoringSsl(tag_size, std::move(ctx)))};
+}
+
+util::StatusOr<std::unique_ptr<StatefulMac>> StatefulCmacBoringSsl::Clone()
+    const {
+  // CMAC_CTX_copy also copies the data accumulated so far, so this works on
+  // mid-stream contexts, not just pristine templates.
+  return NewFromTemplate(tag_size_, cmac_context_.get());
+}
+
 util::Status StatefulCmacBoringSsl::Update(absl::string_view data) {
   // BoringSSL expects a non-null pointer for data,
   // regardless of whether the size is 0.
@@ -81,10 +125,17 @@ util::StatusOr<std::string> StatefulCmacBoringSsl::Finalize() {
 
 StatefulCmacBoringSslFactory::StatefulCmacBoringSslFactory(
     uint32_t tag_size, const util::SecretData& key_value)
-    : tag_size_(tag_size), key_value_(key_value) {}
+    : tag_size_(tag_size),
+      key_value_(key_value),
+      template_context_(NewCmacContext(key_value)) {}
 
 util::StatusOr<std::unique_ptr<StatefulMac>>
 StatefulCmacBoringSslFactory::Create() const {
+  if (template_context_ != nullptr) {
+    return StatefulCmacBoringSsl::NewFromTemplate(tag_size_,
+                                                  template_context_.get());
+  }
+  // The key was rejected at construction; New() reports the precise error.
   return StatefulCmacBoringSsl::New(tag_size_, key_value_);
 }
 
@@ -39,8 +39,16 @@ class StatefulCmacBoringSsl : public subtle::StatefulMac {
   // Key must be 16 or 32 bytes, all other sizes will be rejected.
   static util::StatusOr<std::unique_ptr<StatefulMac>> New(
       uint32_t tag_size, const util::SecretData& key_value);
+  // Like New(), but clones 'template_ctx' -- a context that has been
+  // initialized with the key -- instead of running the AES key schedule
+  // again, so creating a stream over an existing key is a context copy.
+  // Any data already fed into 'template_ctx' is part of the clone's state.
+  // 'template_ctx' is only read and may be shared by concurrent calls.
+  static util::StatusOr<std::unique_ptr<StatefulMac>> NewFromTemplate(
+      uint32_t tag_size, const CMAC_CTX* template_ctx);
   util::Status Update(absl::string_view data) override;
   util::StatusOr<std::string> Finalize() override;
+  util::StatusOr<std::unique_ptr<StatefulMac>> Clone() const override;
 
  private:
   static constexpr size_t kSmallKeySize = 16;
@@ -63,6 +71,10 @@ class StatefulCmacBoringSslFactory : public subtle::StatefulMacFactory {
  private:
   const uint32_t tag_size_;
   const util::SecretData key_value_;
+  // Initialized once with the expanded key and cloned by every Create()
+  // call; null if the key was rejected, in which case Create() reports the
+  // error via StatefulCmacBoringSsl::New().
+  const bssl::UniquePtr<CMAC_CTX> template_context_;
 };
 
 }  // namespace subtle
@@ -96,6 +96,38 @@ TEST(StatefulCmacBoringSslTest, testBasic) {
   BasicCmac(kSmallTagSize, key, data, expected_small);
 }
 
+TEST(StatefulCmacBoringSslTest, testClone) {
+  std::string key(test::HexDecodeOrDie("000102030405060708090a0b0c0d0e0f"));
+  std::string prefix = "Some data ", suffix = "to test.";
+
+  // The tag is the same as in testBasic, since prefix + suffix is the same
+  // input; the clone branches off the digest state after the prefix.
+  std::string expected(
+      test::HexDecodeOrDie("c856e183e8dee9bb99402d54c34f3222"));
+
+  auto cmac_result = StatefulCmacBoringSsl::New(
+      kTagSize, util::SecretDataFromStringView(key));
+  ASSERT_THAT(cmac_result.status(), IsOk());
+  auto cmac = std::move(cmac_result.ValueOrDie());
+  EXPECT_THAT(cmac->Update(prefix), IsOk());
+
+  for (int i = 0; i < 2; i++) {
+    auto clone_result = cmac->Clone();
+    ASSERT_THAT(clone_result.status(), IsOk());
+    auto clone = std::move(clone_result.ValueOrDie());
+    EXPECT_THAT(clone->Update(suffix), IsOk());
+    auto result = clone->Finalize();
+    EXPECT_THAT(result.status(), IsOk());
+    EXPECT_EQ(result.ValueOrDie(), expected);
+  }
+
+  // Branching must not disturb the checkpoint itself.
+  EXPECT_THAT(cmac->Update(suffix), IsOk());
+  auto result = cmac->Finalize();
+  EXPECT_THAT(result.status(), IsOk());
+  EXPECT_EQ(result.ValueOrDie(), expected);
+}
+
 void MultipleUpdateCmac(uint32_t tag_size, std::string key, std::string data1,
                         std::string data2, std::string data3, std::string data4,
                         std::string expected) {
@@ -173,6 +205,35 @@ TEST(StatefulCmacFactoryTest, createsObjects) {
   EXPECT_THAT(output, StrEq(expected));
 }
 
+TEST(StatefulCmacFactoryTest, StreamsFromOneFactoryAreIndependent) {
+  std::string key(test::HexDecodeOrDie("000102030405060708090a0b0c0d0e0f"));
+  std::string data = "Some data to test.";
+  std::string expected(
+      test::HexDecodeOrDie("c856e183e8dee9bb99402d54c34f3222"));
+
+  // The factory clones one template context per stream; streams created
+  // from it must not share state with each other.
+  auto factory = absl::make_unique<StatefulCmacBoringSslFactory>(
+      kTagSize, util::SecretDataFromStringView(key));
+  for (int i = 0; i < 3; i++) {
+    auto stateful_cmac_or = factory->Create();
+    ASSERT_THAT(stateful_cmac_or.status(), IsOk());
+    auto stateful_cmac = std::move(stateful_cmac_or.ValueOrDie());
+    EXPECT_THAT(stateful_cmac->Update(data), IsOk());
+    auto output_or = stateful_cmac->Finalize();
+    ASSERT_THAT(output_or.status(), IsOk());
+    EXPECT_THAT(output_or.ValueOrDie(), StrEq(expected));
+  }
+}
+
+TEST(StatefulCmacFactoryTest, InvalidKeySizeReportedByCreate) {
+  auto factory = absl::make_unique<StatefulCmacBoringSslFactory>(
+      kTagSize, util::SecretDataFromStringView(std::string(17, 'x')));
+  EXPECT_THAT(factory->Create().status(),
+              StatusIs(util::error::INVALID_ARGUMENT,
+                       HasSubstr("invalid key size")));
+}
+
 // Test with test vectors from Wycheproof project.
 bool WycheproofTest(const rapidjson::Document &root) {
   int errors = 0;
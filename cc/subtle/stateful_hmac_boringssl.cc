@@ -16,6 +16,8 @@
 
 #include "tink/subtle/stateful_hmac_boringssl.h"
 
+#include <cstring>
+
 #include "absl/memory/memory.h"
 #include "openssl/base.h"
 #include "tink/subtle/subtle_util_boringssl.h"
@@ -78,6 +80,60 @@ util::StatusOr<std::string> StatefulHmacBoringSsl::Finalize() {
   return std::string(reinterpret_cast<char*>(buf), tag_size_);
 }
 
+util::Status StatefulHmacBoringSsl::FinalizeInto(absl::Span<char> output) {
+  if (output.size() != tag_size_) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "output size does not match the tag size");
+  }
+  uint8_t buf[EVP_MAX_MD_SIZE];
+  unsigned int out_len;
+
+  if (!HMAC_Final(hmac_context_.get(), buf, &out_len)) {
+    return util::Status(util::error::INTERNAL, "HMAC finalization failed");
+  }
+  std::memcpy(output.data(), buf, tag_size_);
+  return util::OkStatus();
+}
+
+util::Status StatefulHmacBoringSsl::FinalizeTruncatedInto(
+    absl::Span<char> output) {
+  if (output.size() > tag_size_) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "output size exceeds the tag size");
+  }
+  uint8_t buf[EVP_MAX_MD_SIZE];
+  unsigned int out_len;
+
+  if (!HMAC_Final(hmac_context_.get(), buf, &out_len)) {
+    return util::Status(util::error::INTERNAL, "HMAC finalization failed");
+  }
+  std::memcpy(output.data(), buf, output.size());
+  return util::OkStatus();
+}
+
+util::StatusOr<std::unique_ptr<StatefulMac>> StatefulHmacBoringSsl::Clone()
+    const {
+  // Copies the digest state accumulated so far, so MACing many messages
+  // with a common prefix only has to hash the prefix once.
+  bssl::UniquePtr<HMAC_CTX> ctx(HMAC_CTX_new());
+  if (!HMAC_CTX_copy_ex(ctx.get(), hmac_context_.get())) {
+    return util::Status(util::error::INTERNAL, "HMAC context copy failed");
+  }
+  return std::unique_ptr<StatefulMac>(
+      new StatefulHmacBoringSsl(tag_size_, std::move(ctx)));
+}
+
+util::Status StatefulHmacBoringSsl::Reset() {
+  // Re-initializing with a null key and digest reuses the precomputed key
+  // state of the context, which is cheaper than deriving it again with
+  // HMAC_Init.
+  if (!HMAC_Init_ex(hmac_context_.get(), nullptr, 0, nullptr, nullptr)) {
+    return util::Status(util::error::FAILED_PRECONDITION,
+                        "HMAC re-initialization failed");
+  }
+  return util::OkStatus();
+}
+
 StatefulHmacBoringSslFactory::StatefulHmacBoringSslFactory(
     HashType hash_type, uint32_t tag_size, const util::SecretData& key_value)
     : hash_type_(hash_type), tag_size_(tag_size), key_value_(key_value) {}
@@ -37,6 +37,10 @@ class StatefulHmacBoringSsl : public subtle::StatefulMac {
       HashType hash_type, uint32_t tag_size, const util::SecretData& key_value);
   util::Status Update(absl::string_view data) override;
   util::StatusOr<std::string> Finalize() override;
+  util::Status FinalizeInto(absl::Span<char> output) override;
+  util::Status FinalizeTruncatedInto(absl::Span<char> output) override;
+  util::Status Reset() override;
+  util::StatusOr<std::unique_ptr<StatefulMac>> Clone() const override;
 
  private:
   // Minimum HMAC key size in bytes.
@@ -22,6 +22,7 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/memory/memory.h"
+#include "absl/types/span.h"
 #include "tink/subtle/common_enums.h"
 #include "tink/subtle/wycheproof_util.h"
 #include "tink/util/secret_data.h"
@@ -111,6 +112,134 @@ TEST(StatefulHmacBoringSslTest, testBasic) {
   BasicHmac(HashType::SHA512, kSmallTagSize, key, data, expected_512_small);
 }
 
+void TruncatedHmac(HashType hash_type, uint32_t tag_size, std::string key,
+                   std::string data, std::string expected) {
+  auto hmac_result = StatefulHmacBoringSsl::New(
+      hash_type, tag_size, util::SecretDataFromStringView(key));
+  EXPECT_THAT(hmac_result.status(), IsOk());
+  auto hmac = std::move(hmac_result.ValueOrDie());
+
+  EXPECT_THAT(hmac->Update(data), IsOk());
+  std::string tag(expected.size(), '\0');
+  EXPECT_THAT(
+      hmac->FinalizeTruncatedInto(absl::MakeSpan(&tag[0], tag.size())),
+      IsOk());
+  EXPECT_EQ(tag, expected);
+}
+
+TEST(StatefulHmacBoringSslTest, testFinalizeTruncatedInto) {
+  std::string key(test::HexDecodeOrDie("000102030405060708090a0b0c0d0e0f"));
+  std::string data = "Some data to test.";
+
+  // The truncated tags are prefixes of the tags in testBasic.
+  std::string expected_256_small(test::HexDecodeOrDie("1d6eb74bc283f7947e92"));
+  TruncatedHmac(HashType::SHA256, kTagSize, key, data, expected_256_small);
+
+  std::string expected_512_small(test::HexDecodeOrDie("72b8ff800f57f9aeec41"));
+  TruncatedHmac(HashType::SHA512, kTagSize, key, data, expected_512_small);
+
+  // Requesting more than the configured tag size must fail.
+  auto hmac_result = StatefulHmacBoringSsl::New(
+      HashType::SHA256, kTagSize, util::SecretDataFromStringView(key));
+  EXPECT_THAT(hmac_result.status(), IsOk());
+  auto hmac = std::move(hmac_result.ValueOrDie());
+  EXPECT_THAT(hmac->Update(data), IsOk());
+  std::string too_long(kTagSize + 1, '\0');
+  EXPECT_THAT(hmac->FinalizeTruncatedInto(
+                  absl::MakeSpan(&too_long[0], too_long.size())),
+              StatusIs(util::error::INVALID_ARGUMENT));
+}
+
+void ResetHmac(HashType hash_type, uint32_t tag_size, std::string key,
+               std::string data, std::string expected_data,
+               std::string expected_empty) {
+  auto hmac_result = StatefulHmacBoringSsl::New(
+      hash_type, tag_size, util::SecretDataFromStringView(key));
+  EXPECT_THAT(hmac_result.status(), IsOk());
+  auto hmac = std::move(hmac_result.ValueOrDie());
+
+  auto update_result = hmac->Update(data);
+  EXPECT_THAT(update_result, IsOk());
+  auto result = hmac->Finalize();
+  EXPECT_THAT(result.status(), IsOk());
+  EXPECT_EQ(result.ValueOrDie(), expected_data);
+
+  // After a Reset the same context computes the MAC of a fresh message.
+  EXPECT_THAT(hmac->Reset(), IsOk());
+  result = hmac->Finalize();
+  EXPECT_THAT(result.status(), IsOk());
+  EXPECT_EQ(result.ValueOrDie(), expected_empty);
+
+  EXPECT_THAT(hmac->Reset(), IsOk());
+  update_result = hmac->Update(data);
+  EXPECT_THAT(update_result, IsOk());
+  result = hmac->Finalize();
+  EXPECT_THAT(result.status(), IsOk());
+  EXPECT_EQ(result.ValueOrDie(), expected_data);
+}
+
+TEST(StatefulHmacBoringSslTest, testReset) {
+  std::string key(test::HexDecodeOrDie("000102030405060708090a0b0c0d0e0f"));
+  std::string data = "Some data to test.";
+
+  std::string expected_data_256(
+      test::HexDecodeOrDie("1d6eb74bc283f7947e92c72bd985ce6e"));
+  std::string expected_empty_256(
+      test::HexDecodeOrDie("07eff8b326b7798c9ccfcbdbe579489a"));
+  ResetHmac(HashType::SHA256, kTagSize, key, data, expected_data_256,
+            expected_empty_256);
+
+  std::string expected_data_512(
+      test::HexDecodeOrDie("72b8ff800f57f9aeec41265a29b69b6a"));
+  std::string expected_empty_512(
+      test::HexDecodeOrDie("2fec800ca276c44985a35aec92067e5e"));
+  ResetHmac(HashType::SHA512, kTagSize, key, data, expected_data_512,
+            expected_empty_512);
+}
+
+void CloneHmac(HashType hash_type, uint32_t tag_size, std::string key,
+               std::string prefix, std::string suffix, std::string expected) {
+  auto hmac_result = StatefulHmacBoringSsl::New(
+      hash_type, tag_size, util::SecretDataFromStringView(key));
+  EXPECT_THAT(hmac_result.status(), IsOk());
+  auto hmac = std::move(hmac_result.ValueOrDie());
+
+  // Checkpoint the digest state after the common prefix, then branch one
+  // clone per message; each clone only hashes its unique suffix.
+  EXPECT_THAT(hmac->Update(prefix), IsOk());
+  for (int i = 0; i < 2; i++) {
+    auto clone_result = hmac->Clone();
+    ASSERT_THAT(clone_result.status(), IsOk());
+    auto clone = std::move(clone_result.ValueOrDie());
+    EXPECT_THAT(clone->Update(suffix), IsOk());
+    auto result = clone->Finalize();
+    EXPECT_THAT(result.status(), IsOk());
+    EXPECT_EQ(result.ValueOrDie(), expected);
+  }
+
+  // Branching must not disturb the checkpoint itself.
+  EXPECT_THAT(hmac->Update(suffix), IsOk());
+  auto result = hmac->Finalize();
+  EXPECT_THAT(result.status(), IsOk());
+  EXPECT_EQ(result.ValueOrDie(), expected);
+}
+
+TEST(StatefulHmacBoringSslTest, testClone) {
+  std::string key(test::HexDecodeOrDie("000102030405060708090a0b0c0d0e0f"));
+  std::string prefix = "Some data ", suffix = "to test.";
+
+  // The tags are the same as the tags in testBasic, since prefix + suffix
+  // is the same input.
+
+  std::string expected_256(
+      test::HexDecodeOrDie("1d6eb74bc283f7947e92c72bd985ce6e"));
+  CloneHmac(HashType::SHA256, kTagSize, key, prefix, suffix, expected_256);
+
+  std::string expected_512(
+      test::HexDecodeOrDie("72b8ff800f57f9aeec41265a29b69b6a"));
+  CloneHmac(HashType::SHA512, kTagSize, key, prefix, suffix, expected_512);
+}
+
 void MultipleUpdateHmac(HashType hash_type, uint32_t tag_size, std::string key,
                         std::string data1, std::string data2, std::string data3,
                         std::string data4, std::string expected) {
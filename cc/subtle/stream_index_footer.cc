@@ -0,0 +1,115 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/subtle/stream_index_footer.h"
+
+#include <limits>
+
+#include "absl/base/internal/endian.h"
+#include "tink/util/status.h"
+
+namespace crypto {
+namespace tink {
+namespace subtle {
+
+namespace {
+
+const uint32_t kStreamIndexFooterMagic = 0x54496478;  // 'TIdx'
+
+// plaintext size + segment count + offset count + size + magic.
+const int kStreamIndexFooterMinSize = 8 + 8 + 4 + 4 + 4;
+
+}  // namespace
+
+std::vector<uint8_t> SerializeStreamIndexFooter(
+    const StreamIndexFooter& footer) {
+  std::vector<uint8_t> serialized(kStreamIndexFooterMinSize +
+                                  8 * footer.segment_offsets.size());
+  uint8_t* out = serialized.data();
+  absl::big_endian::Store64(out, footer.plaintext_size);
+  absl::big_endian::Store64(out + 8, footer.segment_count);
+  absl::big_endian::Store32(out + 16, footer.segment_offsets.size());
+  out += 20;
+  for (int64_t offset : footer.segment_offsets) {
+    absl::big_endian::Store64(out, offset);
+    out += 8;
+  }
+  absl::big_endian::Store32(out, serialized.size());
+  absl::big_endian::Store32(out + 4, kStreamIndexFooterMagic);
+  return serialized;
+}
+
+util::StatusOr<int> GetStreamIndexFooterSize(absl::string_view footer_tail) {
+  if (footer_tail.size() != kStreamIndexFooterTailSize) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "footer tail must be 8 bytes");
+  }
+  const uint8_t* tail =
+      reinterpret_cast<const uint8_t*>(footer_tail.data());
+  if (absl::big_endian::Load32(tail + 4) != kStreamIndexFooterMagic) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "stream index footer not found");
+  }
+  uint32_t footer_size = absl::big_endian::Load32(tail);
+  if (footer_size < kStreamIndexFooterMinSize ||
+      footer_size > static_cast<uint32_t>(std::numeric_limits<int>::max())) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "invalid stream index footer size");
+  }
+  return footer_size;
+}
+
+util::StatusOr<StreamIndexFooter> ParseStreamIndexFooter(
+    absl::string_view serialized_footer) {
+  if (serialized_footer.size() <
+      static_cast<size_t>(kStreamIndexFooterMinSize)) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "stream index footer too short");
+  }
+  auto size_result = GetStreamIndexFooterSize(serialized_footer.substr(
+      serialized_footer.size() - kStreamIndexFooterTailSize));
+  if (!size_result.ok()) return size_result.status();
+  if (serialized_footer.size() !=
+      static_cast<size_t>(size_result.ValueOrDie())) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "stream index footer has wrong size");
+  }
+  const uint8_t* data =
+      reinterpret_cast<const uint8_t*>(serialized_footer.data());
+  StreamIndexFooter footer;
+  footer.plaintext_size = absl::big_endian::Load64(data);
+  footer.segment_count = absl::big_endian::Load64(data + 8);
+  uint32_t num_offsets = absl::big_endian::Load32(data + 16);
+  if (serialized_footer.size() !=
+      kStreamIndexFooterMinSize + size_t{8} * num_offsets) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "stream index footer has inconsistent offset count");
+  }
+  if (footer.plaintext_size < 0 || footer.segment_count < 0) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "invalid stream index footer");
+  }
+  footer.segment_offsets.reserve(num_offsets);
+  for (uint32_t i = 0; i < num_offsets; ++i) {
+    footer.segment_offsets.push_back(
+        absl::big_endian::Load64(data + 20 + size_t{8} * i));
+  }
+  return footer;
+}
+
+}  // namespace subtle
+}  // namespace tink
+}  // namespace crypto
@@ -0,0 +1,85 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_SUBTLE_STREAM_INDEX_FOOTER_H_
+#define TINK_SUBTLE_STREAM_INDEX_FOOTER_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace subtle {
+
+// An optional index appended after the last ciphertext segment of a
+// streaming AEAD ciphertext. It records the stream geometry, so a
+// random-access reader learns the plaintext size and the segment layout
+// from one ranged read at the end of the object instead of deriving them
+// from the ciphertext length.
+//
+// The footer is parsed back to front: the last kStreamIndexFooterTailSize
+// bytes hold the total footer size and a magic value, from which the full
+// footer can be located. The serialized layout is (all integers big-endian):
+//
+//   8 bytes  plaintext size
+//   8 bytes  segment count
+//   4 bytes  number of per-segment offsets
+//   8 bytes  per offset: ciphertext offset of the segment; empty while all
+//            segments have a fixed size, reserved for variable-size segments
+//   4 bytes  total footer size in bytes
+//   4 bytes  magic value 'TIdx'
+//
+// The footer is not covered by the AEAD authentication, so readers must
+// cross-check its contents against the ciphertext (the random-access
+// decrypter verifies it against the geometry derived from the ciphertext
+// size); a tampered footer is then rejected as INVALID_ARGUMENT, and
+// truncation of the ciphertext itself is still detected by the last
+// segment's authentication tag.
+struct StreamIndexFooter {
+  int64_t plaintext_size = 0;
+  int64_t segment_count = 0;
+  // Ciphertext offsets of the individual segments; empty while segments
+  // have a fixed size.
+  std::vector<int64_t> segment_offsets;
+};
+
+// Size of the fixed footer trailer (total size + magic) that a reader must
+// fetch from the end of the stream to locate the footer.
+constexpr int kStreamIndexFooterTailSize = 8;
+
+// Serializes 'footer' into the byte layout described above.
+std::vector<uint8_t> SerializeStreamIndexFooter(
+    const StreamIndexFooter& footer);
+
+// Given the last kStreamIndexFooterTailSize bytes of a stream, returns the
+// total size of the serialized footer, or INVALID_ARGUMENT if the bytes do
+// not end in a stream index footer.
+crypto::tink::util::StatusOr<int> GetStreamIndexFooterSize(
+    absl::string_view footer_tail);
+
+// Parses a complete serialized footer (as returned by
+// SerializeStreamIndexFooter).
+crypto::tink::util::StatusOr<StreamIndexFooter> ParseStreamIndexFooter(
+    absl::string_view serialized_footer);
+
+}  // namespace subtle
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_SUBTLE_STREAM_INDEX_FOOTER_H_
@@ -0,0 +1,124 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/subtle/stream_index_footer.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/strings/string_view.h"
+#include "tink/util/status.h"
+#include "tink/util/test_matchers.h"
+
+namespace crypto {
+namespace tink {
+namespace subtle {
+namespace {
+
+using ::crypto::tink::test::IsOk;
+using ::crypto::tink::test::StatusIs;
+
+absl::string_view ToStringView(const std::vector<uint8_t>& bytes) {
+  return absl::string_view(reinterpret_cast<const char*>(bytes.data()),
+                           bytes.size());
+}
+
+TEST(StreamIndexFooterTest, RoundTrip) {
+  StreamIndexFooter footer;
+  footer.plaintext_size = 123456789;
+  footer.segment_count = 42;
+  std::vector<uint8_t> serialized = SerializeStreamIndexFooter(footer);
+  EXPECT_EQ(28, serialized.size());
+
+  auto size_result = GetStreamIndexFooterSize(ToStringView(serialized).substr(
+      serialized.size() - kStreamIndexFooterTailSize));
+  ASSERT_THAT(size_result.status(), IsOk());
+  EXPECT_EQ(serialized.size(), size_result.ValueOrDie());
+
+  auto parse_result = ParseStreamIndexFooter(ToStringView(serialized));
+  ASSERT_THAT(parse_result.status(), IsOk());
+  auto parsed = parse_result.ValueOrDie();
+  EXPECT_EQ(footer.plaintext_size, parsed.plaintext_size);
+  EXPECT_EQ(footer.segment_count, parsed.segment_count);
+  EXPECT_TRUE(parsed.segment_offsets.empty());
+}
+
+TEST(StreamIndexFooterTest, RoundTripWithOffsets) {
+  StreamIndexFooter footer;
+  footer.plaintext_size = 1000;
+  footer.segment_count = 3;
+  footer.segment_offsets = {0, 300, 700};
+  std::vector<uint8_t> serialized = SerializeStreamIndexFooter(footer);
+  EXPECT_EQ(28 + 8 * footer.segment_offsets.size(), serialized.size());
+
+  auto parse_result = ParseStreamIndexFooter(ToStringView(serialized));
+  ASSERT_THAT(parse_result.status(), IsOk());
+  auto parsed = parse_result.ValueOrDie();
+  EXPECT_EQ(footer.plaintext_size, parsed.plaintext_size);
+  EXPECT_EQ(footer.segment_count, parsed.segment_count);
+  EXPECT_EQ(footer.segment_offsets, parsed.segment_offsets);
+}
+
+TEST(StreamIndexFooterTest, WrongMagicIsRejected) {
+  StreamIndexFooter footer;
+  std::vector<uint8_t> serialized = SerializeStreamIndexFooter(footer);
+  serialized.back() ^= 1;
+  EXPECT_THAT(GetStreamIndexFooterSize(
+                  ToStringView(serialized).substr(
+                      serialized.size() - kStreamIndexFooterTailSize))
+                  .status(),
+              StatusIs(util::error::INVALID_ARGUMENT));
+  EXPECT_THAT(ParseStreamIndexFooter(ToStringView(serialized)).status(),
+              StatusIs(util::error::INVALID_ARGUMENT));
+}
+
+TEST(StreamIndexFooterTest, WrongTailSizeIsRejected) {
+  EXPECT_THAT(GetStreamIndexFooterSize("too short").status(),
+              StatusIs(util::error::INVALID_ARGUMENT));
+}
+
+TEST(StreamIndexFooterTest, TruncatedFooterIsRejected) {
+  StreamIndexFooter footer;
+  footer.plaintext_size = 1;
+  std::vector<uint8_t> serialized = SerializeStreamIndexFooter(footer);
+  EXPECT_THAT(
+      ParseStreamIndexFooter(ToStringView(serialized).substr(1)).status(),
+      StatusIs(util::error::INVALID_ARGUMENT));
+}
+
+TEST(StreamIndexFooterTest, InconsistentOffsetCountIsRejected) {
+  StreamIndexFooter footer;
+  footer.segment_offsets = {0, 100};
+  std::vector<uint8_t> serialized = SerializeStreamIndexFooter(footer);
+  // Claim 3 offsets while the footer size accounts for 2.
+  serialized[19] = 3;
+  EXPECT_THAT(ParseStreamIndexFooter(ToStringView(serialized)).status(),
+              StatusIs(util::error::INVALID_ARGUMENT));
+}
+
+TEST(StreamIndexFooterTest, NegativeValuesAreRejected) {
+  StreamIndexFooter footer;
+  footer.plaintext_size = -1;
+  std::vector<uint8_t> serialized = SerializeStreamIndexFooter(footer);
+  EXPECT_THAT(ParseStreamIndexFooter(ToStringView(serialized)).status(),
+              StatusIs(util::error::INVALID_ARGUMENT));
+}
+
+}  // namespace
+}  // namespace subtle
+}  // namespace tink
+}  // namespace crypto
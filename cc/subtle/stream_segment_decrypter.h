@@ -18,9 +18,12 @@
 #define TINK_SUBTLE_STREAM_SEGMENT_DECRYPTER_H_
 
 #include <cstdint>
+#include <cstring>
 #include <vector>
 
+#include "absl/types/span.h"
 #include "tink/util/status.h"
+#include "tink/util/statusor.h"
 
 namespace crypto {
 namespace tink {
@@ -50,6 +53,46 @@ class StreamSegmentDecrypter {
       bool is_last_segment,
       std::vector<uint8_t>* plaintext_buffer) = 0;
 
+  // As above, with the ciphertext given as a view into a caller-owned
+  // buffer, which allows the caller to reuse one buffer across segments.
+  // Segment decrypters should override this method to read the ciphertext
+  // in place; the default implementation copies it into a temporary vector.
+  virtual util::Status DecryptSegment(
+      absl::Span<const uint8_t> ciphertext,
+      int64_t segment_number,
+      bool is_last_segment,
+      std::vector<uint8_t>* plaintext_buffer) {
+    return DecryptSegment(
+        std::vector<uint8_t>(ciphertext.begin(), ciphertext.end()),
+        segment_number, is_last_segment, plaintext_buffer);
+  }
+
+  // As above, but writes the plaintext into the caller-provided
+  // 'plaintext_buffer' instead of a resizable vector, and returns the number
+  // of plaintext bytes written. 'plaintext_buffer' must be large enough for
+  // the plaintext of the segment (ciphertext.size() is always enough).
+  // This lets callers decrypt several segments into adjacent regions of one
+  // large buffer, coalescing their plaintext without intermediate copies.
+  // Segment decrypters should override this method to write the plaintext
+  // in place; the default implementation decrypts into a temporary vector
+  // and copies it.
+  virtual util::StatusOr<int> DecryptSegmentInto(
+      absl::Span<const uint8_t> ciphertext,
+      int64_t segment_number,
+      bool is_last_segment,
+      absl::Span<uint8_t> plaintext_buffer) {
+    std::vector<uint8_t> plaintext;
+    auto status = DecryptSegment(ciphertext, segment_number, is_last_segment,
+                                 &plaintext);
+    if (!status.ok()) return status;
+    if (plaintext.size() > plaintext_buffer.size()) {
+      return util::Status(util::error::INVALID_ARGUMENT,
+                          "plaintext_buffer too small");
+    }
+    std::memcpy(plaintext_buffer.data(), plaintext.data(), plaintext.size());
+    return static_cast<int>(plaintext.size());
+  }
+
   // Initializes this decrypter, using the information from 'header',
   // which must be of size exactly get_header_size().
   virtual util::Status Init(const std::vector<uint8_t>& header) = 0;
@@ -72,6 +115,12 @@ class StreamSegmentDecrypter {
   //   segment_overhead = ciphertext_segment_size - get_plaintext_segment_size()
   virtual int get_ciphertext_offset() const = 0;
 
+  // True if streams using this decrypter should allocate their
+  // segment-sized buffers in huge-page-backed memory (see
+  // tink/util/huge_page_allocator.h). Selected via the params of
+  // primitives that support it.
+  virtual bool use_huge_page_buffers() const { return false; }
+
   virtual ~StreamSegmentDecrypter() {}
 };
 
@@ -18,9 +18,12 @@
 #define TINK_SUBTLE_STREAM_SEGMENT_ENCRYPTER_H_
 
 #include <cstdint>
+#include <cstring>
 #include <vector>
 
+#include "absl/types/span.h"
 #include "tink/util/status.h"
+#include "tink/util/statusor.h"
 
 namespace crypto {
 namespace tink {
@@ -76,6 +79,74 @@ class StreamSegmentEncrypter {
       bool is_last_segment,
       std::vector<uint8_t>* ciphertext_buffer) = 0;
 
+  // As above, with the plaintext given as a view into a caller-owned
+  // buffer, which allows the caller to reuse one buffer across segments.
+  // Segment encrypters should override this method to read the plaintext
+  // in place; the default implementation copies it into a temporary vector.
+  virtual util::Status EncryptSegment(
+      absl::Span<const uint8_t> plaintext,
+      bool is_last_segment,
+      std::vector<uint8_t>* ciphertext_buffer) {
+    return EncryptSegment(
+        std::vector<uint8_t>(plaintext.begin(), plaintext.end()),
+        is_last_segment, ciphertext_buffer);
+  }
+
+  // As above, but writes the ciphertext into the caller-provided
+  // 'ciphertext_buffer' instead of a resizable vector, and returns the
+  // number of ciphertext bytes written. 'ciphertext_buffer' must be large
+  // enough for the ciphertext of the segment (get_ciphertext_segment_size()
+  // bytes is always enough). This leaves the allocation of the ciphertext
+  // buffer entirely to the caller, which e.g. lets encrypting streams place
+  // it in huge-page-backed memory (see use_huge_page_buffers()).
+  // Segment encrypters should override this method to write the ciphertext
+  // in place; the default implementation encrypts into a temporary vector
+  // and copies it.
+  virtual util::StatusOr<int> EncryptSegmentInto(
+      absl::Span<const uint8_t> plaintext,
+      bool is_last_segment,
+      absl::Span<uint8_t> ciphertext_buffer) {
+    std::vector<uint8_t> ciphertext;
+    auto status = EncryptSegment(plaintext, is_last_segment, &ciphertext);
+    if (!status.ok()) return status;
+    if (ciphertext.size() > ciphertext_buffer.size()) {
+      return util::Status(util::error::INVALID_ARGUMENT,
+                          "ciphertext_buffer too small");
+    }
+    std::memcpy(ciphertext_buffer.data(), ciphertext.data(),
+                ciphertext.size());
+    return static_cast<int>(ciphertext.size());
+  }
+
+  // Encrypts 'plaintext' as the segment with the given 'segment_number',
+  // without using or modifying the internal segment counter.
+  // Segment encrypters whose per-segment parameters are a pure function of
+  // the segment number should override this method; overrides must be safe
+  // for concurrent calls, which allows encrypting streams to process several
+  // segments in parallel. The default implementation reports UNIMPLEMENTED.
+  virtual util::Status EncryptSegmentAt(
+      int64_t segment_number,
+      const std::vector<uint8_t>& plaintext,
+      bool is_last_segment,
+      std::vector<uint8_t>* ciphertext_buffer) const {
+    return util::Status(
+        util::error::UNIMPLEMENTED,
+        "EncryptSegmentAt is not supported by this segment encrypter");
+  }
+
+  // As above, with the plaintext given as a view into a caller-owned
+  // buffer; the default implementation copies it into a temporary vector.
+  virtual util::Status EncryptSegmentAt(
+      int64_t segment_number,
+      absl::Span<const uint8_t> plaintext,
+      bool is_last_segment,
+      std::vector<uint8_t>* ciphertext_buffer) const {
+    return EncryptSegmentAt(
+        segment_number,
+        std::vector<uint8_t>(plaintext.begin(), plaintext.end()),
+        is_last_segment, ciphertext_buffer);
+  }
+
   // Returns the header of the ciphertext stream.
   virtual const std::vector<uint8_t>& get_header() const = 0;
 
@@ -98,6 +169,12 @@ class StreamSegmentEncrypter {
   //   segment_overhead = ciphertext_segment_size - get_plaintext_segment_size()
   virtual int get_ciphertext_offset() const = 0;
 
+  // True if streams using this encrypter should allocate their
+  // segment-sized buffers in huge-page-backed memory (see
+  // tink/util/huge_page_allocator.h). Selected via the params of
+  // primitives that support it.
+  virtual bool use_huge_page_buffers() const { return false; }
+
   virtual ~StreamSegmentEncrypter() {}
 
  protected:
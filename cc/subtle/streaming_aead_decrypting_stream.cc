@@ -20,6 +20,7 @@
 #include <cstring>
 
 #include "absl/memory/memory.h"
+#include "absl/types/span.h"
 #include "tink/input_stream.h"
 #include "tink/subtle/stream_segment_decrypter.h"
 #include "tink/util/status.h"
@@ -44,8 +45,9 @@ namespace {
 // Before returning, resizes 'output' accordingly, to reflect
 // the actual number of bytes read.
 
+template <typename Vector>
 util::Status ReadFromStream(InputStream* input_stream, int count,
-                            std::vector<uint8_t>* output) {
+                            Vector* output) {
   if (count <= 0 || input_stream == nullptr || output == nullptr) {
     return Status(util::error::INTERNAL, "Illegal read from a stream");
   }
@@ -79,6 +81,18 @@ util::Status ReadFromStream(InputStream* input_stream, int count,
 StatusOr<std::unique_ptr<InputStream>> StreamingAeadDecryptingStream::New(
     std::unique_ptr<StreamSegmentDecrypter> segment_decrypter,
     std::unique_ptr<InputStream> ciphertext_source) {
+  return New(std::move(segment_decrypter), std::move(ciphertext_source),
+             /* target_buffer_size = */ 0);
+}
+
+// static
+StatusOr<std::unique_ptr<InputStream>> StreamingAeadDecryptingStream::New(
+    std::unique_ptr<StreamSegmentDecrypter> segment_decrypter,
+    std::unique_ptr<InputStream> ciphertext_source, int target_buffer_size) {
+  if (target_buffer_size < 0) {
+    return Status(util::error::INVALID_ARGUMENT,
+                  "target_buffer_size must be non-negative");
+  }
   if (segment_decrypter == nullptr) {
     return Status(util::error::INVALID_ARGUMENT,
                   "segment_decrypter must be non-null");
@@ -91,6 +105,11 @@ StatusOr<std::unique_ptr<InputStream>> StreamingAeadDecryptingStream::New(
       new StreamingAeadDecryptingStream());
   dec_stream->segment_decrypter_ = std::move(segment_decrypter);
   dec_stream->ct_source_ = std::move(ciphertext_source);
+  if (dec_stream->segment_decrypter_->use_huge_page_buffers()) {
+    util::HugePageAllocator<uint8_t> allocator(true);
+    dec_stream->ct_buffer_ = util::HugePageVector(allocator);
+    dec_stream->pt_buffer_ = util::HugePageVector(allocator);
+  }
   int first_segment_size =
       dec_stream->segment_decrypter_->get_ciphertext_segment_size() -
       dec_stream->segment_decrypter_->get_ciphertext_offset() -
@@ -100,6 +119,7 @@ StatusOr<std::unique_ptr<InputStream>> StreamingAeadDecryptingStream::New(
                   "Size of the first segment must be greater than 0.");
   }
   dec_stream->ct_buffer_.resize(first_segment_size);
+  dec_stream->target_buffer_size_ = target_buffer_size;
   dec_stream->position_ = 0;
   dec_stream->segment_number_ = 0;
   dec_stream->is_initialized_ = false;
@@ -110,6 +130,52 @@ StatusOr<std::unique_ptr<InputStream>> StreamingAeadDecryptingStream::New(
   return {std::move(dec_stream)};
 }
 
+Status StreamingAeadDecryptingStream::FillPlaintextBuffer() {
+  int pt_segment_size = segment_decrypter_->get_plaintext_segment_size();
+  // With a large target_buffer_size_, several segments are decrypted into
+  // adjacent regions of pt_buffer_, so that bulk readers see one large
+  // contiguous plaintext run per Next() call.
+  int capacity = std::max(pt_segment_size, target_buffer_size_);
+  pt_buffer_.resize(capacity);
+  int filled = 0;
+  do {
+    if (segment_number_ == 0) {
+      // Segment 0 is shorter, so that it aligns with the segment size
+      // together with the header and the ciphertext offset.
+      ct_buffer_.resize(segment_decrypter_->get_ciphertext_segment_size() -
+                        segment_decrypter_->get_ciphertext_offset() -
+                        segment_decrypter_->get_header_size());
+    } else {
+      ct_buffer_.resize(segment_decrypter_->get_ciphertext_segment_size());
+    }
+    auto status =
+        ReadFromStream(ct_source_.get(), ct_buffer_.size(), &ct_buffer_);
+    if (!status.ok() && (status.error_code() != util::error::OUT_OF_RANGE)) {
+      return status;
+    }
+    read_last_segment_ = (status.error_code() == util::error::OUT_OF_RANGE);
+    auto decrypt_result = segment_decrypter_->DecryptSegmentInto(
+        absl::MakeConstSpan(ct_buffer_),
+        /* segment_number = */ segment_number_,
+        /* is_last_segment = */ read_last_segment_,
+        absl::MakeSpan(pt_buffer_).subspan(filled));
+    if (!decrypt_result.ok() && !read_last_segment_) {
+      // Try decrypting as the last segment, if haven't tried yet.
+      read_last_segment_ = true;
+      decrypt_result = segment_decrypter_->DecryptSegmentInto(
+          absl::MakeConstSpan(ct_buffer_),
+          /* segment_number = */ segment_number_,
+          /* is_last_segment = */ read_last_segment_,
+          absl::MakeSpan(pt_buffer_).subspan(filled));
+    }
+    if (!decrypt_result.ok()) return decrypt_result.status();
+    filled += decrypt_result.ValueOrDie();
+    segment_number_++;
+  } while (!read_last_segment_ && filled + pt_segment_size <= capacity);
+  pt_buffer_.resize(filled);
+  return Status::OK;
+}
+
 StatusOr<int> StreamingAeadDecryptingStream::Next(const void** data) {
   if (!status_.ok()) return status_;
 
@@ -127,25 +193,7 @@ StatusOr<int> StreamingAeadDecryptingStream::Next(const void** data) {
     if (!status_.ok()) return status_;
     is_initialized_ = true;
     count_backedup_ = 0;
-    status_ = ReadFromStream(ct_source_.get(), ct_buffer_.size(), &ct_buffer_);
-    if (!status_.ok() && (status_.error_code() != util::error::OUT_OF_RANGE)) {
-      return status_;
-    }
-    read_last_segment_ = (status_.error_code() == util::error::OUT_OF_RANGE);
-    status_ = segment_decrypter_->DecryptSegment(
-        ct_buffer_,
-        /* segment_number = */ segment_number_,
-        /* is_last_segment = */ read_last_segment_,
-        &pt_buffer_);
-    if (!status_.ok() && !read_last_segment_) {
-      // Try decrypting as the last segment, if haven't tried yet.
-      read_last_segment_ = true;
-      status_ = segment_decrypter_->DecryptSegment(
-          ct_buffer_,
-          /* segment_number = */ segment_number_,
-          /* is_last_segment = */ read_last_segment_,
-          &pt_buffer_);
-    }
+    status_ = FillPlaintextBuffer();
     if (!status_.ok()) return status_;
     *data = pt_buffer_.data();
     position_ = pt_buffer_.size();
@@ -162,33 +210,13 @@ StatusOr<int> StreamingAeadDecryptingStream::Next(const void** data) {
     return backedup;
   }
 
-  // We're past the first segment, and no space was backed up, so we
-  // try to get and decrypt the next ciphertext segment, if any.
+  // We're past the first segment(s), and no space was backed up, so we
+  // try to get and decrypt the next ciphertext segment(s), if any.
   if (read_last_segment_) {
     status_ = Status(util::error::OUT_OF_RANGE, "Reached end of stream.");
     return status_;
   }
-  segment_number_++;
-  ct_buffer_.resize(segment_decrypter_->get_ciphertext_segment_size());
-  status_ = ReadFromStream(ct_source_.get(), ct_buffer_.size(), &ct_buffer_);
-  if (!status_.ok() && (status_.error_code() != util::error::OUT_OF_RANGE)) {
-    return status_;
-  }
-  read_last_segment_ = (status_.error_code() == util::error::OUT_OF_RANGE);
-  status_ = segment_decrypter_->DecryptSegment(
-      ct_buffer_,
-      /* segment_number = */ segment_number_,
-      /* is_last_segment = */ read_last_segment_,
-      &pt_buffer_);
-  if (!status_.ok() && !read_last_segment_) {
-    // Try decrypting as the last segment, if haven't tried yet.
-    read_last_segment_ = true;
-    status_ = segment_decrypter_->DecryptSegment(
-        ct_buffer_,
-        /* segment_number = */ segment_number_,
-        /* is_last_segment = */ read_last_segment_,
-        &pt_buffer_);
-  }
+  status_ = FillPlaintextBuffer();
   if (!status_.ok()) return status_;
   *data = pt_buffer_.data();
   pt_buffer_offset_ = 0;
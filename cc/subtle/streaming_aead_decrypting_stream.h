@@ -22,6 +22,7 @@
 
 #include "tink/input_stream.h"
 #include "tink/subtle/stream_segment_decrypter.h"
+#include "tink/util/huge_page_allocator.h"
 #include "tink/util/statusor.h"
 
 namespace crypto {
@@ -41,6 +42,19 @@ class StreamingAeadDecryptingStream : public InputStream {
       New(std::unique_ptr<StreamSegmentDecrypter> segment_decrypter,
           std::unique_ptr<crypto::tink::InputStream> ciphertext_source);
 
+  // Like above, but each Next() call decrypts as many consecutive segments
+  // as fit into a plaintext buffer of (roughly) 'target_buffer_size' bytes
+  // and returns their plaintext as one contiguous run. Bulk readers that
+  // are dominated by per-buffer overhead (e.g. memcpy-bound sinks) see
+  // fewer, larger buffers this way; retained memory grows to about
+  // 'target_buffer_size' per stream. A 'target_buffer_size' of at most one
+  // plaintext segment is equivalent to the two-argument overload.
+  static
+  crypto::tink::util::StatusOr<std::unique_ptr<crypto::tink::InputStream>>
+      New(std::unique_ptr<StreamSegmentDecrypter> segment_decrypter,
+          std::unique_ptr<crypto::tink::InputStream> ciphertext_source,
+          int target_buffer_size);
+
   // -----------------------
   // Methods of InputStream-interface implemented by this class.
   crypto::tink::util::StatusOr<int> Next(const void** data) override;
@@ -49,12 +63,24 @@ class StreamingAeadDecryptingStream : public InputStream {
 
  private:
   StreamingAeadDecryptingStream() {}
+
+  // Reads and decrypts the next ciphertext segment(s) into pt_buffer_:
+  // one segment, or, if target_buffer_size_ allows for more, as many
+  // consecutive segments as fit. Upon return pt_buffer_ holds exactly the
+  // decrypted plaintext, and read_last_segment_ is true iff the last
+  // segment of the stream was consumed.
+  crypto::tink::util::Status FillPlaintextBuffer();
+
   std::unique_ptr<StreamSegmentDecrypter> segment_decrypter_;
   std::unique_ptr<crypto::tink::InputStream> ct_source_;
-  std::vector<uint8_t> ct_buffer_;  // ciphertext buffer
-  std::vector<uint8_t> pt_buffer_;  // plaintext buffer
+  // The segment-sized stream buffers; huge-page-backed if the segment
+  // decrypter asks for it (see StreamSegmentDecrypter::
+  // use_huge_page_buffers()).
+  util::HugePageVector ct_buffer_;  // ciphertext buffer
+  util::HugePageVector pt_buffer_;  // plaintext buffer
+  int target_buffer_size_;  // desired plaintext bytes per Next() call
   int64_t position_;  // number of plaintext bytes read from this stream
-  int64_t segment_number_;  // current segment number
+  int64_t segment_number_;  // number of the next segment to decrypt
   crypto::tink::util::Status status_;  // status of the stream
 
   // Counters that describe the state of the data in pt_buffer_.
@@ -406,6 +406,80 @@ TEST_F(StreamingAeadDecryptingStreamTest, BackupAndPosition) {
   EXPECT_EQ(pt, decrypted_first_segment + decrypted_rest);
 }
 
+TEST_F(StreamingAeadDecryptingStreamTest, CoalescingStream) {
+  int pt_segment_size = 100;
+  int header_size = 5;
+  int pt_size = 1000;
+
+  std::string pt = Random::GetRandomBytes(pt_size);
+  DummyStreamSegmentEncrypter seg_enc(pt_segment_size, header_size,
+                                      /* ct_offset = */ 0);
+  std::string ct = seg_enc.GenerateCiphertext(pt);
+
+  // A decrypting stream with a target buffer of 3 plaintext segments.
+  auto ct_stream = absl::make_unique<std::stringstream>(ct);
+  std::unique_ptr<InputStream> ct_source(
+      absl::make_unique<IstreamInputStream>(std::move(ct_stream)));
+  auto dec_stream = std::move(
+      StreamingAeadDecryptingStream::New(
+          absl::make_unique<DummyStreamSegmentDecrypter>(
+              pt_segment_size, header_size, /* ct_offset = */ 0),
+          std::move(ct_source),
+          /* target_buffer_size = */ 3 * pt_segment_size)
+          .ValueOrDie());
+
+  // The first buffer coalesces the (shorter) first segment and two full
+  // segments into one contiguous run.
+  const void* buffer;
+  auto next_result = dec_stream->Next(&buffer);
+  ASSERT_TRUE(next_result.ok()) << next_result.status();
+  EXPECT_EQ((pt_segment_size - header_size) + 2 * pt_segment_size,
+            next_result.ValueOrDie());
+  EXPECT_EQ(next_result.ValueOrDie(), dec_stream->Position());
+
+  // Backing up within the coalesced run works as usual.
+  dec_stream->BackUp(10);
+  EXPECT_EQ(next_result.ValueOrDie() - 10, dec_stream->Position());
+
+  // Reading the rest of the stream yields the full plaintext.
+  std::string decrypted;
+  auto status = test::ReadFromStream(dec_stream.get(), &decrypted);
+  EXPECT_TRUE(status.ok()) << status;
+  EXPECT_EQ(pt_size, dec_stream->Position());
+  EXPECT_EQ(pt.substr(pt.size() - decrypted.size()), decrypted);
+}
+
+TEST_F(StreamingAeadDecryptingStreamTest, CoalescingStreamContents) {
+  // Decrypting with various target buffer sizes must reproduce the
+  // plaintext exactly, for any relation of target to segment size.
+  int pt_segment_size = 100;
+  int header_size = 5;
+  for (int pt_size : {0, 10, 95, 300, 1000, 10000}) {
+    for (int target_buffer_size : {0, 1, 100, 250, 1 << 20}) {
+      SCOPED_TRACE(absl::StrCat("pt_size = ", pt_size,
+                                ", target_buffer_size = ", target_buffer_size));
+      std::string pt = Random::GetRandomBytes(pt_size);
+      DummyStreamSegmentEncrypter seg_enc(pt_segment_size, header_size,
+                                          /* ct_offset = */ 0);
+      std::string ct = seg_enc.GenerateCiphertext(pt);
+
+      auto ct_stream = absl::make_unique<std::stringstream>(ct);
+      std::unique_ptr<InputStream> ct_source(
+          absl::make_unique<IstreamInputStream>(std::move(ct_stream)));
+      auto dec_stream = std::move(
+          StreamingAeadDecryptingStream::New(
+              absl::make_unique<DummyStreamSegmentDecrypter>(
+                  pt_segment_size, header_size, /* ct_offset = */ 0),
+              std::move(ct_source), target_buffer_size)
+              .ValueOrDie());
+      std::string decrypted;
+      auto status = test::ReadFromStream(dec_stream.get(), &decrypted);
+      EXPECT_TRUE(status.ok()) << status;
+      EXPECT_EQ(pt, decrypted);
+    }
+  }
+}
+
 }  // namespace
 }  // namespace subtle
 }  // namespace tink
@@ -20,7 +20,9 @@
 #include <cstring>
 
 #include "absl/memory/memory.h"
+#include "absl/types/span.h"
 #include "tink/output_stream.h"
+#include "tink/subtle/stream_index_footer.h"
 #include "tink/subtle/stream_segment_encrypter.h"
 #include "tink/util/statusor.h"
 
@@ -38,7 +40,7 @@ namespace {
 // In case of errors returns the first non-OK status of
 // output_stream->Next()-operation.
 
-util::Status WriteToStream(const std::vector<uint8_t>& contents,
+util::Status WriteToStream(absl::Span<const uint8_t> contents,
                            OutputStream* output_stream) {
   void* buffer;
   int pos = 0;
@@ -60,12 +62,111 @@ util::Status WriteToStream(const std::vector<uint8_t>& contents,
   return Status::OK;
 }
 
+// Writes 'contents' to the specified 'output_stream', using the stream's
+// direct scatter/gather path if it has one (which skips the copy into the
+// stream's internal buffer), and the Next()/BackUp()-protocol otherwise.
+util::Status WriteSegmentToStream(absl::Span<const uint8_t> contents,
+                                  OutputStream* output_stream) {
+  absl::Span<const uint8_t> chunk(contents.data(), contents.size());
+  auto status = output_stream->WriteChunks(absl::MakeConstSpan(&chunk, 1));
+  if (status.error_code() != util::error::UNIMPLEMENTED) return status;
+  return WriteToStream(contents, output_stream);
+}
+
 }  // anonymous namespace
 
+constexpr size_t StreamingAeadEncryptingStream::BufferPool::kMaxBufferSets;
+
+void StreamingAeadEncryptingStream::BufferPool::Get(
+    util::HugePageVector* pt_buffer, util::HugePageVector* ct_buffer,
+    util::HugePageVector* pt_to_encrypt) {
+  absl::MutexLock lock(&mu_);
+  if (buffer_sets_.empty()) return;
+  BufferSet set = std::move(buffer_sets_.back());
+  buffer_sets_.pop_back();
+  // Clearing keeps the capacity but makes the later resize value-initialize
+  // all elements, exactly as with freshly allocated buffers.
+  set.pt_buffer.clear();
+  set.ct_buffer.clear();
+  set.pt_to_encrypt.clear();
+  *pt_buffer = std::move(set.pt_buffer);
+  *ct_buffer = std::move(set.ct_buffer);
+  *pt_to_encrypt = std::move(set.pt_to_encrypt);
+}
+
+void StreamingAeadEncryptingStream::BufferPool::Put(
+    util::HugePageVector pt_buffer, util::HugePageVector ct_buffer,
+    util::HugePageVector pt_to_encrypt) {
+  absl::MutexLock lock(&mu_);
+  if (buffer_sets_.size() >= kMaxBufferSets) return;
+  BufferSet set;
+  set.pt_buffer = std::move(pt_buffer);
+  set.ct_buffer = std::move(ct_buffer);
+  set.pt_to_encrypt = std::move(pt_to_encrypt);
+  buffer_sets_.push_back(std::move(set));
+}
+
+size_t StreamingAeadEncryptingStream::BufferPool::size() const {
+  absl::MutexLock lock(&mu_);
+  return buffer_sets_.size();
+}
+
+StreamingAeadEncryptingStream::~StreamingAeadEncryptingStream() {
+  if (buffer_pool_ != nullptr) {
+    // Hand the buffer storage back for the next stream; the sizes are reset
+    // when the buffers are taken out again.
+    buffer_pool_->Put(std::move(pt_buffer_), std::move(ct_buffer_),
+                      std::move(pt_to_encrypt_));
+  }
+}
+
 // static
 StatusOr<std::unique_ptr<OutputStream>> StreamingAeadEncryptingStream::New(
     std::unique_ptr<StreamSegmentEncrypter> segment_encrypter,
     std::unique_ptr<OutputStream> ciphertext_destination) {
+  return New(std::move(segment_encrypter), std::move(ciphertext_destination),
+             /* buffer_pool = */ nullptr);
+}
+
+// static
+StatusOr<std::unique_ptr<OutputStream>> StreamingAeadEncryptingStream::New(
+    std::unique_ptr<StreamSegmentEncrypter> segment_encrypter,
+    std::unique_ptr<OutputStream> ciphertext_destination,
+    std::shared_ptr<BufferPool> buffer_pool) {
+  return NewInternal(std::move(segment_encrypter),
+                     std::move(ciphertext_destination), std::move(buffer_pool),
+                     /* resumed = */ false, /* append_index_footer = */ false);
+}
+
+// static
+StatusOr<std::unique_ptr<OutputStream>>
+StreamingAeadEncryptingStream::NewResumed(
+    std::unique_ptr<StreamSegmentEncrypter> segment_encrypter,
+    std::unique_ptr<OutputStream> ciphertext_destination,
+    std::shared_ptr<BufferPool> buffer_pool) {
+  return NewInternal(std::move(segment_encrypter),
+                     std::move(ciphertext_destination), std::move(buffer_pool),
+                     /* resumed = */ true, /* append_index_footer = */ false);
+}
+
+// static
+StatusOr<std::unique_ptr<OutputStream>>
+StreamingAeadEncryptingStream::NewWithIndexFooter(
+    std::unique_ptr<StreamSegmentEncrypter> segment_encrypter,
+    std::unique_ptr<OutputStream> ciphertext_destination,
+    std::shared_ptr<BufferPool> buffer_pool) {
+  return NewInternal(std::move(segment_encrypter),
+                     std::move(ciphertext_destination), std::move(buffer_pool),
+                     /* resumed = */ false, /* append_index_footer = */ true);
+}
+
+// static
+StatusOr<std::unique_ptr<OutputStream>>
+StreamingAeadEncryptingStream::NewInternal(
+    std::unique_ptr<StreamSegmentEncrypter> segment_encrypter,
+    std::unique_ptr<OutputStream> ciphertext_destination,
+    std::shared_ptr<BufferPool> buffer_pool, bool resumed,
+    bool append_index_footer) {
   if (segment_encrypter == nullptr) {
     return Status(util::error::INVALID_ARGUMENT,
                   "segment_encrypter must be non-null");
@@ -78,10 +179,36 @@ StatusOr<std::unique_ptr<OutputStream>> StreamingAeadEncryptingStream::New(
       new StreamingAeadEncryptingStream());
   enc_stream->segment_encrypter_ = std::move(segment_encrypter);
   enc_stream->ct_destination_ = std::move(ciphertext_destination);
-  int first_segment_size =
-      enc_stream->segment_encrypter_->get_plaintext_segment_size() -
-      enc_stream->segment_encrypter_->get_ciphertext_offset() -
-      enc_stream->segment_encrypter_->get_header().size();
+  enc_stream->buffer_pool_ = std::move(buffer_pool);
+  if (enc_stream->buffer_pool_ != nullptr) {
+    // Take over the storage of a previously closed stream's buffers, if any;
+    // the resize calls below then reuse its capacity.
+    enc_stream->buffer_pool_->Get(&enc_stream->pt_buffer_,
+                                  &enc_stream->ct_buffer_,
+                                  &enc_stream->pt_to_encrypt_);
+  }
+  // A pooled buffer set keeps the allocation mode of the stream that
+  // returned it; if it does not match the mode this encrypter asks for,
+  // start over with empty buffers in the desired mode.
+  util::HugePageAllocator<uint8_t> allocator(
+      enc_stream->segment_encrypter_->use_huge_page_buffers());
+  if (enc_stream->pt_buffer_.get_allocator() != allocator) {
+    enc_stream->pt_buffer_ = util::HugePageVector(allocator);
+    enc_stream->ct_buffer_ = util::HugePageVector(allocator);
+    enc_stream->pt_to_encrypt_ = util::HugePageVector(allocator);
+  }
+  int first_segment_size;
+  if (resumed && enc_stream->segment_encrypter_->get_segment_number() > 0) {
+    // Appending mid-stream: only segment 0 is shortened by the header and
+    // the ciphertext offset.
+    first_segment_size =
+        enc_stream->segment_encrypter_->get_plaintext_segment_size();
+  } else {
+    first_segment_size =
+        enc_stream->segment_encrypter_->get_plaintext_segment_size() -
+        enc_stream->segment_encrypter_->get_ciphertext_offset() -
+        enc_stream->segment_encrypter_->get_header().size();
+  }
 
   if (first_segment_size <= 0) {
     return Status(util::error::INTERNAL,
@@ -91,8 +218,10 @@ StatusOr<std::unique_ptr<OutputStream>> StreamingAeadEncryptingStream::New(
   enc_stream->pt_to_encrypt_.resize(0);
   enc_stream->position_ = 0;
   enc_stream->is_first_segment_ = true;
+  enc_stream->write_header_ = !resumed;
   enc_stream->count_backedup_ = first_segment_size;
   enc_stream->pt_buffer_offset_ = 0;
+  enc_stream->append_index_footer_ = append_index_footer;
   enc_stream->status_ = Status::OK;
   return {std::move(enc_stream)};
 }
@@ -104,9 +233,11 @@ StatusOr<int> StreamingAeadEncryptingStream::Next(void** data) {
   if (is_first_segment_) {
     is_first_segment_ = false;
     count_backedup_ = 0;
-    status_ =
-        WriteToStream(segment_encrypter_->get_header(), ct_destination_.get());
-    if (!status_.ok()) return status_;
+    if (write_header_) {
+      status_ = WriteToStream(segment_encrypter_->get_header(),
+                              ct_destination_.get());
+      if (!status_.ok()) return status_;
+    }
     *data = pt_buffer_.data();
     position_ = pt_buffer_.size();
     return pt_buffer_.size();
@@ -131,10 +262,18 @@ StatusOr<int> StreamingAeadEncryptingStream::Next(void** data) {
   //
   // Step 1.
   if (!pt_to_encrypt_.empty()) {
-    status_ = segment_encrypter_->EncryptSegment(
-        pt_to_encrypt_, /* is_last_segment = */ false, &ct_buffer_);
-    if (!status_.ok()) return status_;
-    status_ = WriteToStream(ct_buffer_, ct_destination_.get());
+    ct_buffer_.resize(segment_encrypter_->get_ciphertext_segment_size());
+    auto encrypt_result = segment_encrypter_->EncryptSegmentInto(
+        absl::MakeConstSpan(pt_to_encrypt_), /* is_last_segment = */ false,
+        absl::MakeSpan(ct_buffer_));
+    if (!encrypt_result.ok()) {
+      status_ = encrypt_result.status();
+      return status_;
+    }
+    status_ = WriteSegmentToStream(
+        absl::MakeConstSpan(ct_buffer_)
+            .subspan(0, encrypt_result.ValueOrDie()),
+        ct_destination_.get());
     if (!status_.ok()) return status_;
   }
   // Step 2.
@@ -157,7 +296,7 @@ void StreamingAeadEncryptingStream::BackUp(int count) {
 
 Status StreamingAeadEncryptingStream::Close() {
   if (!status_.ok()) return status_;
-  if (is_first_segment_) {  // Next() was never called.
+  if (is_first_segment_ && write_header_) {  // Next() was never called.
     status_ =
         WriteToStream(segment_encrypter_->get_header(), ct_destination_.get());
     if (!status_.ok()) return status_;
@@ -165,21 +304,27 @@ Status StreamingAeadEncryptingStream::Close() {
 
   // The last segment encrypts plaintext from pt_to_encrypt_,
   // unless the current pt_buffer_ has some plaintext bytes.
-  std::vector<uint8_t>* pt_last_segment = &pt_to_encrypt_;
+  util::HugePageVector* pt_last_segment = &pt_to_encrypt_;
   if ((!pt_buffer_.empty()) && count_backedup_ < pt_buffer_.size()) {
     // The last segment encrypts plaintext from pt_buffer_.
     pt_buffer_.resize(pt_buffer_.size() - count_backedup_);
     pt_last_segment = &pt_buffer_;
   }
+  ct_buffer_.resize(segment_encrypter_->get_ciphertext_segment_size());
   if (pt_last_segment != &pt_to_encrypt_ && (!pt_to_encrypt_.empty())) {
     // Before writing the last segment we must encrypt pt_to_encrypt_.
-    status_ = segment_encrypter_->EncryptSegment(
-        pt_to_encrypt_, /* is_last_segment = */ false, &ct_buffer_);
-    if (!status_.ok()) {
+    auto encrypt_result = segment_encrypter_->EncryptSegmentInto(
+        absl::MakeConstSpan(pt_to_encrypt_), /* is_last_segment = */ false,
+        absl::MakeSpan(ct_buffer_));
+    if (!encrypt_result.ok()) {
+      status_ = encrypt_result.status();
       ct_destination_->Close().IgnoreError();
       return status_;
     }
-    status_ = WriteToStream(ct_buffer_, ct_destination_.get());
+    status_ = WriteSegmentToStream(
+        absl::MakeConstSpan(ct_buffer_)
+            .subspan(0, encrypt_result.ValueOrDie()),
+        ct_destination_.get());
     if (!status_.ok()) {
       ct_destination_->Close().IgnoreError();
       return status_;
@@ -187,17 +332,37 @@ Status StreamingAeadEncryptingStream::Close() {
   }
 
   // Encrypt pt_last_segment, write the ciphertext, and close the stream.
-  status_ = segment_encrypter_->EncryptSegment(
-      *pt_last_segment, /* is_last_segment = */ true, &ct_buffer_);
-  if (!status_.ok()) {
+  auto encrypt_result = segment_encrypter_->EncryptSegmentInto(
+      absl::MakeConstSpan(*pt_last_segment), /* is_last_segment = */ true,
+      absl::MakeSpan(ct_buffer_));
+  if (!encrypt_result.ok()) {
+    status_ = encrypt_result.status();
     ct_destination_->Close().IgnoreError();
     return status_;
   }
-  status_ = WriteToStream(ct_buffer_, ct_destination_.get());
+  status_ = WriteSegmentToStream(
+      absl::MakeConstSpan(ct_buffer_).subspan(0, encrypt_result.ValueOrDie()),
+      ct_destination_.get());
   if (!status_.ok()) {
     ct_destination_->Close().IgnoreError();
     return status_;
   }
+
+  // Optionally append the index footer after the last ciphertext segment.
+  if (append_index_footer_) {
+    StreamIndexFooter footer;
+    footer.plaintext_size = position_;
+    // EncryptSegment increments the segment number, so after the last
+    // segment it equals the number of segments written.
+    footer.segment_count = segment_encrypter_->get_segment_number();
+    status_ =
+        WriteToStream(SerializeStreamIndexFooter(footer),
+                      ct_destination_.get());
+    if (!status_.ok()) {
+      ct_destination_->Close().IgnoreError();
+      return status_;
+    }
+  }
   status_ = Status(util::error::FAILED_PRECONDITION, "Stream closed");
   return ct_destination_->Close();
 }
@@ -18,10 +18,14 @@
 #define TINK_SUBTLE_STREAMING_AEAD_ENCRYPTING_STREAM_H_
 
 #include <memory>
+#include <utility>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
 #include "tink/output_stream.h"
 #include "tink/subtle/stream_segment_encrypter.h"
+#include "tink/util/huge_page_allocator.h"
 #include "tink/util/statusor.h"
 
 namespace crypto {
@@ -30,6 +34,42 @@ namespace subtle {
 
 class StreamingAeadEncryptingStream : public OutputStream {
  public:
+  // A freelist of the internal stream buffers, for workloads that open many
+  // short streams: a stream created with a pool takes its buffers from the
+  // pool and returns them on destruction, so the buffer storage (up to one
+  // segment each) is retained across streams instead of being reallocated
+  // per stream. Thread-safe; holds at most kMaxBufferSets buffer sets, so
+  // retained memory is bounded. Buffers are not wiped between streams; they
+  // never leave the process.
+  class BufferPool {
+   public:
+    static constexpr size_t kMaxBufferSets = 8;
+
+    // Moves a pooled buffer set into the given vectors, if one is
+    // available; otherwise leaves them empty. The vectors carry the
+    // allocation mode of the stream that returned them (see
+    // tink/util/huge_page_allocator.h).
+    void Get(util::HugePageVector* pt_buffer, util::HugePageVector* ct_buffer,
+             util::HugePageVector* pt_to_encrypt);
+
+    // Returns a buffer set to the pool. Dropped if the pool is full.
+    void Put(util::HugePageVector pt_buffer, util::HugePageVector ct_buffer,
+             util::HugePageVector pt_to_encrypt);
+
+    // The number of buffer sets currently pooled.
+    size_t size() const;
+
+   private:
+    struct BufferSet {
+      util::HugePageVector pt_buffer;
+      util::HugePageVector ct_buffer;
+      util::HugePageVector pt_to_encrypt;
+    };
+
+    mutable absl::Mutex mu_;
+    std::vector<BufferSet> buffer_sets_ ABSL_GUARDED_BY(mu_);
+  };
+
   // A factory that produces encrypting streams.
   // The returned stream is a wrapper around 'ciphertext_destination',
   // such that any bytes written via the wrapper are AEAD-encrypted
@@ -40,6 +80,61 @@ class StreamingAeadEncryptingStream : public OutputStream {
       New(std::unique_ptr<StreamSegmentEncrypter> segment_encrypter,
           std::unique_ptr<crypto::tink::OutputStream> ciphertext_destination);
 
+  // Like above, but the stream draws its internal buffers from
+  // 'buffer_pool' and gives them back when it is destroyed. 'buffer_pool'
+  // may be null, which is equivalent to the two-argument overload.
+  static
+  crypto::tink::util::StatusOr<std::unique_ptr<crypto::tink::OutputStream>>
+      New(std::unique_ptr<StreamSegmentEncrypter> segment_encrypter,
+          std::unique_ptr<crypto::tink::OutputStream> ciphertext_destination,
+          std::shared_ptr<BufferPool> buffer_pool);
+
+  // A factory that produces a stream which appends to an existing, partially
+  // written ciphertext stream instead of starting a new one: no header is
+  // written, and encryption continues with the segment number at which
+  // 'segment_encrypter' is positioned (see get_segment_number()).
+  //
+  // This supports crash recovery of append-only ciphertexts (e.g. encrypted
+  // log files): truncate the damaged file to the last complete segment
+  // boundary, reconstruct a segment encrypter with the stream-bound key
+  // material and the number of complete segments (see, e.g.,
+  // AesGcmHkdfStreamSegmentEncrypter::Params), and open
+  // 'ciphertext_destination' positioned at the truncation point. The caller
+  // must guarantee that all previously written segments were encrypted as
+  // non-last segments; closing this stream writes the last segment.
+  //
+  // SECURITY WARNING: segment nonces are deterministic in the segment
+  // index, so the truncated-away partial segment and the segment this
+  // stream writes in its place share a nonce. If the partial segment's
+  // bytes could have been observed or retained anywhere (backups,
+  // replication, un-erased disk blocks), resuming reuses the keystream
+  // against them and is catastrophically insecure; see the warning on
+  // AesGcmHkdfStreamSegmentEncrypter::Params. When in doubt, re-encrypt
+  // the stream from the start instead of resuming.
+  static
+  crypto::tink::util::StatusOr<std::unique_ptr<crypto::tink::OutputStream>>
+      NewResumed(
+          std::unique_ptr<StreamSegmentEncrypter> segment_encrypter,
+          std::unique_ptr<crypto::tink::OutputStream> ciphertext_destination,
+          std::shared_ptr<BufferPool> buffer_pool = nullptr);
+
+  // Like New(), but Close() appends a stream index footer (see
+  // tink/subtle/stream_index_footer.h) with the plaintext size and segment
+  // count after the last ciphertext segment. Random-access readers that
+  // were told to expect the footer (see
+  // DecryptingRandomAccessStream::Options::use_index_footer) then learn the
+  // stream geometry from the footer; readers unaware of the footer cannot
+  // decrypt such ciphertexts, so this must only be enabled when all
+  // consumers of the ciphertext expect it.
+  static
+  crypto::tink::util::StatusOr<std::unique_ptr<crypto::tink::OutputStream>>
+      NewWithIndexFooter(
+          std::unique_ptr<StreamSegmentEncrypter> segment_encrypter,
+          std::unique_ptr<crypto::tink::OutputStream> ciphertext_destination,
+          std::shared_ptr<BufferPool> buffer_pool = nullptr);
+
+  ~StreamingAeadEncryptingStream() override;
+
   // -----------------------
   // Methods of OutputStream-interface implemented by this class.
   crypto::tink::util::StatusOr<int> Next(void** data) override;
@@ -49,11 +144,25 @@ class StreamingAeadEncryptingStream : public OutputStream {
 
  private:
   StreamingAeadEncryptingStream() {}
+
+  // Shared implementation of the factories above.
+  static
+  crypto::tink::util::StatusOr<std::unique_ptr<crypto::tink::OutputStream>>
+      NewInternal(
+          std::unique_ptr<StreamSegmentEncrypter> segment_encrypter,
+          std::unique_ptr<crypto::tink::OutputStream> ciphertext_destination,
+          std::shared_ptr<BufferPool> buffer_pool, bool resumed,
+          bool append_index_footer);
+
   std::unique_ptr<StreamSegmentEncrypter> segment_encrypter_;
   std::unique_ptr<crypto::tink::OutputStream> ct_destination_;
-  std::vector<uint8_t> pt_buffer_;  // plaintext buffer
-  std::vector<uint8_t> ct_buffer_;  // ciphertext buffer
-  std::vector<uint8_t> pt_to_encrypt_;  // plaintext to be encrypted
+  std::shared_ptr<BufferPool> buffer_pool_;  // may be null
+  // The segment-sized stream buffers; huge-page-backed if the segment
+  // encrypter asks for it (see StreamSegmentEncrypter::
+  // use_huge_page_buffers()).
+  util::HugePageVector pt_buffer_;  // plaintext buffer
+  util::HugePageVector ct_buffer_;  // ciphertext buffer
+  util::HugePageVector pt_to_encrypt_;  // plaintext to be encrypted
   int64_t position_;  // number of plaintext bytes written to this stream
   crypto::tink::util::Status status_;  // status of the stream
 
@@ -67,6 +176,14 @@ class StreamingAeadEncryptingStream : public OutputStream {
   // header has been written to ct_destination_, nor the user had
   // a chance to write any data to this stream.
   bool is_first_segment_;
+
+  // False for streams created with NewResumed(), which append to a
+  // ciphertext stream whose header was already written.
+  bool write_header_;
+
+  // True for streams created with NewWithIndexFooter(); Close() then
+  // appends a stream index footer after the last ciphertext segment.
+  bool append_index_footer_;
 };
 
 }  // namespace subtle
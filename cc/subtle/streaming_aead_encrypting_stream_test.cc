@@ -16,7 +16,9 @@
 
 #include "tink/subtle/streaming_aead_encrypting_stream.h"
 
+#include <memory>
 #include <sstream>
+#include <string>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -24,6 +26,7 @@
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "tink/output_stream.h"
+#include "tink/subtle/stream_index_footer.h"
 #include "tink/subtle/stream_segment_encrypter.h"
 #include "tink/subtle/random.h"
 #include "tink/subtle/test_util.h"
@@ -562,6 +565,120 @@ TEST_F(StreamingAeadEncryptingStreamTest, BackupAndPosition) {
   EXPECT_EQ(util::error::FAILED_PRECONDITION, close_status.error_code());
 }
 
+TEST_F(StreamingAeadEncryptingStreamTest, ResumedStream) {
+  int pt_segment_size = 100;
+  int header_size = 5;
+  int seg_tag_size = DummyStreamSegmentEncrypter::kSegmentTagSize;
+  int first_segment_size = pt_segment_size - header_size;  // ct_offset = 0
+
+  // Reference: the full plaintext written through a single stream.
+  std::string pt =
+      Random::GetRandomBytes(first_segment_size + 2 * pt_segment_size + 30);
+  std::string full_ct =
+      DummyStreamSegmentEncrypter(pt_segment_size, header_size,
+                                  /* ct_offset = */ 0)
+          .GenerateCiphertext(pt);
+
+  // Resume after various numbers of complete segments already written, as
+  // after truncating a damaged ciphertext to a segment boundary.
+  for (int complete_segments : {0, 1, 2}) {
+    SCOPED_TRACE(absl::StrCat("complete_segments = ", complete_segments));
+    int pt_written =
+        complete_segments == 0
+            ? 0
+            : first_segment_size + (complete_segments - 1) * pt_segment_size;
+    int ct_written = header_size + pt_written + complete_segments * seg_tag_size;
+
+    auto ct_stream = absl::make_unique<std::stringstream>();
+    std::stringbuf* ct_buf = ct_stream->rdbuf();
+    std::unique_ptr<OutputStream> ct_destination(
+        absl::make_unique<OstreamOutputStream>(std::move(ct_stream)));
+    auto enc_stream = std::move(
+        StreamingAeadEncryptingStream::NewResumed(
+            absl::make_unique<DummyStreamSegmentEncrypter>(
+                pt_segment_size, header_size, /* ct_offset = */ 0,
+                /* segment_number = */ complete_segments),
+            std::move(ct_destination))
+            .ValueOrDie());
+
+    auto status = test::WriteToStream(enc_stream.get(), pt.substr(pt_written));
+    EXPECT_TRUE(status.ok()) << status;
+    // The resumed stream writes no header; together with the ciphertext
+    // prefix already on disk it reproduces the single-stream ciphertext.
+    EXPECT_EQ(full_ct, full_ct.substr(0, ct_written) + ct_buf->str());
+  }
+}
+
+TEST_F(StreamingAeadEncryptingStreamTest, BufferPoolReusesBuffers) {
+  int pt_segment_size = 512;
+  int header_size = 64;
+  auto pool =
+      std::make_shared<StreamingAeadEncryptingStream::BufferPool>();
+  std::string pt = Random::GetRandomBytes(1000);
+
+  for (int round = 0; round < 3; round++) {
+    SCOPED_TRACE(absl::StrCat("round = ", round));
+    auto ct_stream = absl::make_unique<std::stringstream>();
+    std::stringbuf* ct_buf = ct_stream->rdbuf();
+    std::unique_ptr<OutputStream> ct_destination(
+        absl::make_unique<OstreamOutputStream>(std::move(ct_stream)));
+    auto seg_enc = absl::make_unique<DummyStreamSegmentEncrypter>(
+        pt_segment_size, header_size, /* ct_offset = */ 0);
+    auto* seg_enc_ref = seg_enc.get();
+    auto enc_stream = std::move(
+        StreamingAeadEncryptingStream::New(std::move(seg_enc),
+                                           std::move(ct_destination), pool)
+            .ValueOrDie());
+    // The stream of the previous round returned its buffers to the pool,
+    // and this round's stream took them out again.
+    EXPECT_EQ(0, pool->size());
+
+    auto status = test::WriteToStream(enc_stream.get(), pt);
+    EXPECT_TRUE(status.ok()) << status;
+    EXPECT_EQ(seg_enc_ref->GenerateCiphertext(pt), ct_buf->str());
+
+    enc_stream.reset();
+    EXPECT_EQ(1, pool->size());
+  }
+}
+
+TEST_F(StreamingAeadEncryptingStreamTest, StreamWithIndexFooter) {
+  int pt_segment_size = 100;
+  int header_size = 5;
+  for (int pt_size : {0, 10, 95, 195, 1000}) {
+    SCOPED_TRACE(absl::StrCat("pt_size = ", pt_size));
+    auto ct_stream = absl::make_unique<std::stringstream>();
+    std::stringbuf* ct_buf = ct_stream->rdbuf();
+    std::unique_ptr<OutputStream> ct_destination(
+        absl::make_unique<OstreamOutputStream>(std::move(ct_stream)));
+    auto seg_enc = absl::make_unique<DummyStreamSegmentEncrypter>(
+        pt_segment_size, header_size, /* ct_offset = */ 0);
+    auto* seg_enc_ref = seg_enc.get();
+    auto enc_stream = std::move(
+        StreamingAeadEncryptingStream::NewWithIndexFooter(
+            std::move(seg_enc), std::move(ct_destination))
+            .ValueOrDie());
+
+    std::string pt = Random::GetRandomBytes(pt_size);
+    auto status = test::WriteToStream(enc_stream.get(), pt);
+    EXPECT_TRUE(status.ok()) << status;
+
+    // The ciphertext is the regular ciphertext followed by the footer.
+    std::string ct = ct_buf->str();
+    std::string regular_ct = seg_enc_ref->GenerateCiphertext(pt);
+    ASSERT_LT(regular_ct.size(), ct.size());
+    EXPECT_EQ(regular_ct, ct.substr(0, regular_ct.size()));
+
+    auto footer_result =
+        ParseStreamIndexFooter(absl::string_view(ct).substr(regular_ct.size()));
+    ASSERT_TRUE(footer_result.ok()) << footer_result.status();
+    auto footer = footer_result.ValueOrDie();
+    EXPECT_EQ(pt_size, footer.plaintext_size);
+    EXPECT_EQ(seg_enc_ref->get_segment_number(), footer.segment_count);
+    EXPECT_TRUE(footer.segment_offsets.empty());
+  }
+}
+
 }  // namespace
 }  // namespace subtle
 }  // namespace tink
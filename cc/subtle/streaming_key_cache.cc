@@ -0,0 +1,55 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/subtle/streaming_key_cache.h"
+
+#include <utility>
+
+namespace crypto {
+namespace tink {
+namespace subtle {
+
+std::shared_ptr<EVP_AEAD_CTX> StreamingKeyCache::Get(
+    absl::string_view cache_key) const {
+  absl::MutexLock lock(&mu_);
+  auto it = contexts_.find(std::string(cache_key));
+  if (it == contexts_.end()) return nullptr;
+  hit_count_.fetch_add(1, std::memory_order_relaxed);
+  return it->second;
+}
+
+void StreamingKeyCache::Insert(absl::string_view cache_key,
+                               std::shared_ptr<EVP_AEAD_CTX> ctx) {
+  if (ctx == nullptr) return;
+  std::string key(cache_key);
+  absl::MutexLock lock(&mu_);
+  if (contexts_.size() >= max_entries_ && contexts_.count(key) == 0) {
+    // The working sets this cache serves fit well below max_entries_, so a
+    // full cache means untracked churn; dropping an arbitrary entry keeps
+    // the common case free of bookkeeping.
+    contexts_.erase(contexts_.begin());
+  }
+  contexts_[std::move(key)] = std::move(ctx);
+}
+
+size_t StreamingKeyCache::size() const {
+  absl::MutexLock lock(&mu_);
+  return contexts_.size();
+}
+
+}  // namespace subtle
+}  // namespace tink
+}  // namespace crypto
@@ -0,0 +1,90 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_SUBTLE_STREAMING_KEY_CACHE_H_
+#define TINK_SUBTLE_STREAMING_KEY_CACHE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "openssl/aead.h"
+
+namespace crypto {
+namespace tink {
+namespace subtle {
+
+// A cache of ready-to-use AEAD contexts for streaming decryption, keyed by
+// the per-stream salt from the ciphertext header. Every stream encrypted
+// under the same key derivation key carries a salt that determines its
+// derived segment key, so re-opening the same encrypted file re-runs the
+// header parse, the HKDF derivation and the cipher setup only to arrive at
+// a context that was already built for the previous open. A decrypter
+// handed a cache (see AesGcmHkdfStreamSegmentDecrypter::Params::key_cache)
+// shares the context of previously opened streams instead.
+//
+// A cache instance is implicitly bound to one key derivation key and one
+// salt size: the cache key is the raw salt (plus the associated data of the
+// stream), so a cache must never be shared between primitives holding
+// different key material -- a salt collision across keys would hand out the
+// wrong segment key. Create one cache per streaming primitive.
+//
+// The cache is bounded: when full, an insert evicts an arbitrary entry.
+// Cached contexts embed derived (not master) key material and live on the
+// normal heap; callers for whom this is unacceptable should not enable the
+// cache. Thread-safe.
+class StreamingKeyCache {
+ public:
+  // 'max_entries' bounds the number of cached contexts; with the default,
+  // a typical "hot config files" working set stays fully cached.
+  explicit StreamingKeyCache(size_t max_entries = 128)
+      : max_entries_(max_entries) {}
+
+  // Returns the context cached under 'cache_key', or nullptr. Counts a hit
+  // when a context is found.
+  std::shared_ptr<EVP_AEAD_CTX> Get(absl::string_view cache_key) const;
+
+  // Caches 'ctx' under 'cache_key', replacing an existing entry for the
+  // same key and evicting an arbitrary entry if the cache is full.
+  void Insert(absl::string_view cache_key, std::shared_ptr<EVP_AEAD_CTX> ctx);
+
+  // Returns the number of currently cached contexts.
+  size_t size() const;
+
+  // Returns how many Get() calls found a cached context; useful for
+  // verifying that a deployment actually benefits from the cache.
+  uint64_t hit_count() const {
+    return hit_count_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  const size_t max_entries_;
+  mutable absl::Mutex mu_;
+  std::unordered_map<std::string, std::shared_ptr<EVP_AEAD_CTX>> contexts_
+      ABSL_GUARDED_BY(mu_);
+  mutable std::atomic<uint64_t> hit_count_{0};
+};
+
+}  // namespace subtle
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_SUBTLE_STREAMING_KEY_CACHE_H_
@@ -17,10 +17,72 @@
 #include "tink/subtle/subtle_util.h"
 // placeholder_subtle_util_cc
 
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
+
+#include "tink/util/status.h"
+
 namespace crypto {
 namespace tink {
 namespace subtle {
 
+namespace {
+
+const char kHexChars[] = "0123456789abcdef";
+
+// Maps a hex digit to its value; -1 marks other characters.
+const int8_t kHexDecodeTable[256] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+     0,  1,  2,  3,  4,  5,  6,  7,  8,  9, -1, -1, -1, -1, -1, -1,
+    -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+};
+
+const char kBase64EncodeTable[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Maps a standard-base64 character to its 6-bit value; -1 marks
+// characters outside the alphabet (including '=', which only the
+// padding handling accepts).
+const int8_t kBase64DecodeTable[256] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1, -1, 63,
+    52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,
+    -1,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
+    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1,
+    -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+    41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+};
+
+}  // namespace
+
 std::string BigEndian32(uint32_t val) {
   std::string result(4, '\0');
   result[0] = (val >> 24) & 0xff;
@@ -34,6 +96,210 @@ void ResizeStringUninitialized(std::string* s, size_t new_size) {
   s->resize(new_size);
 }
 
+constexpr size_t SmallBuffer::kInlineCapacity;
+
+std::string HexEncode(absl::string_view bytes) {
+  std::string result;
+  ResizeStringUninitialized(&result, bytes.size() * 2);
+  const uint8_t* in = reinterpret_cast<const uint8_t*>(bytes.data());
+  char* out = &result[0];
+  size_t n = bytes.size();
+#ifdef __SSSE3__
+  // 16 input bytes per iteration: split each byte into its nibbles and map
+  // both halves to their characters with one table shuffle each.
+  const __m128i lut = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+                                    '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+  const __m128i mask_0f = _mm_set1_epi8(0x0F);
+  while (n >= 16) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+    const __m128i hi =
+        _mm_and_si128(_mm_srli_epi32(v, 4), mask_0f);
+    const __m128i lo = _mm_and_si128(v, mask_0f);
+    const __m128i chars_hi = _mm_shuffle_epi8(lut, hi);
+    const __m128i chars_lo = _mm_shuffle_epi8(lut, lo);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out),
+                     _mm_unpacklo_epi8(chars_hi, chars_lo));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16),
+                     _mm_unpackhi_epi8(chars_hi, chars_lo));
+    in += 16;
+    out += 32;
+    n -= 16;
+  }
+#endif
+  for (size_t i = 0; i < n; i++) {
+    out[2 * i] = kHexChars[in[i] >> 4];
+    out[2 * i + 1] = kHexChars[in[i] & 0x0F];
+  }
+  return result;
+}
+
+util::StatusOr<std::string> HexDecode(absl::string_view hex) {
+  if (hex.size() % 2 != 0) {
+    return util::Status(util::error::INVALID_ARGUMENT, "Input has odd size.");
+  }
+  std::string result;
+  ResizeStringUninitialized(&result, hex.size() / 2);
+  const uint8_t* in = reinterpret_cast<const uint8_t*>(hex.data());
+  // Invalid characters are detected via the accumulated sign bit, so the
+  // loop carries no branch per character.
+  int bad = 0;
+  for (size_t i = 0; i < result.size(); i++) {
+    int hi = kHexDecodeTable[in[2 * i]];
+    int lo = kHexDecodeTable[in[2 * i + 1]];
+    bad |= hi | lo;
+    result[i] = static_cast<char>((hi << 4) | lo);
+  }
+  if (bad < 0) {
+    return util::Status(util::error::INVALID_ARGUMENT, "Not hexadecimal");
+  }
+  return result;
+}
+
+std::string Base64Encode(absl::string_view input) {
+  std::string result;
+  ResizeStringUninitialized(&result, (input.size() + 2) / 3 * 4);
+  const uint8_t* in = reinterpret_cast<const uint8_t*>(input.data());
+  char* out = &result[0];
+  size_t n = input.size();
+  while (n >= 3) {
+    uint32_t v = (static_cast<uint32_t>(in[0]) << 16) |
+                 (static_cast<uint32_t>(in[1]) << 8) | in[2];
+    out[0] = kBase64EncodeTable[v >> 18];
+    out[1] = kBase64EncodeTable[(v >> 12) & 0x3F];
+    out[2] = kBase64EncodeTable[(v >> 6) & 0x3F];
+    out[3] = kBase64EncodeTable[v & 0x3F];
+    in += 3;
+    out += 4;
+    n -= 3;
+  }
+  if (n == 1) {
+    out[0] = kBase64EncodeTable[in[0] >> 2];
+    out[1] = kBase64EncodeTable[(in[0] & 0x03) << 4];
+    out[2] = '=';
+    out[3] = '=';
+  } else if (n == 2) {
+    uint32_t v = (static_cast<uint32_t>(in[0]) << 8) | in[1];
+    out[0] = kBase64EncodeTable[v >> 10];
+    out[1] = kBase64EncodeTable[(v >> 4) & 0x3F];
+    out[2] = kBase64EncodeTable[(v & 0x0F) << 2];
+    out[3] = '=';
+  }
+  return result;
+}
+
+bool Base64Decode(absl::string_view input, std::string* output) {
+  // Strip optional padding; it is only valid at the very end of an input
+  // whose length is a multiple of four.
+  if (!input.empty() && input.back() == '=') {
+    if (input.size() % 4 != 0) return false;
+    input.remove_suffix(1);
+    if (!input.empty() && input.back() == '=') input.remove_suffix(1);
+  }
+  const size_t remainder = input.size() % 4;
+  if (remainder == 1) return false;
+  ResizeStringUninitialized(
+      output, input.size() / 4 * 3 + (remainder == 0 ? 0 : remainder - 1));
+  const uint8_t* in = reinterpret_cast<const uint8_t*>(input.data());
+  char* out = output->empty() ? nullptr : &(*output)[0];
+  size_t n = input.size();
+  while (n >= 4) {
+    const int8_t a = kBase64DecodeTable[in[0]];
+    const int8_t b = kBase64DecodeTable[in[1]];
+    const int8_t c = kBase64DecodeTable[in[2]];
+    const int8_t d = kBase64DecodeTable[in[3]];
+    if ((a | b | c | d) < 0) return false;
+    const uint32_t v = (static_cast<uint32_t>(a) << 18) |
+                       (static_cast<uint32_t>(b) << 12) |
+                       (static_cast<uint32_t>(c) << 6) | d;
+    out[0] = static_cast<char>(v >> 16);
+    out[1] = static_cast<char>(v >> 8);
+    out[2] = static_cast<char>(v);
+    in += 4;
+    out += 3;
+    n -= 4;
+  }
+  if (n == 2) {
+    const int8_t a = kBase64DecodeTable[in[0]];
+    const int8_t b = kBase64DecodeTable[in[1]];
+    if ((a | b) < 0) return false;
+    out[0] = static_cast<char>((a << 2) | (b >> 4));
+  } else if (n == 3) {
+    const int8_t a = kBase64DecodeTable[in[0]];
+    const int8_t b = kBase64DecodeTable[in[1]];
+    const int8_t c = kBase64DecodeTable[in[2]];
+    if ((a | b | c) < 0) return false;
+    out[0] = static_cast<char>((a << 2) | (b >> 4));
+    out[1] = static_cast<char>((b << 4) | (c >> 2));
+  }
+  return true;
+}
+
+util::StatusOr<uint64_t> ConstantTimeCompareBatch(absl::string_view tags,
+                                                  absl::string_view expected,
+                                                  size_t tag_size) {
+  if (tag_size == 0) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "tag_size must be positive");
+  }
+  if (tags.size() != expected.size() || tags.size() % tag_size != 0) {
+    return util::Status(
+        util::error::INVALID_ARGUMENT,
+        "tags and expected must hold the same whole number of tags");
+  }
+  const size_t count = tags.size() / tag_size;
+  if (count > 64) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "batch may hold at most 64 tags");
+  }
+
+  const uint8_t* a = reinterpret_cast<const uint8_t*>(tags.data());
+  const uint8_t* b = reinterpret_cast<const uint8_t*>(expected.data());
+  uint64_t bitmap = 0;
+  // Every tag of the batch is compared in full regardless of earlier
+  // results, and each per-tag verdict is computed branchlessly, so the
+  // running time depends only on count and tag_size.
+#ifdef __SSE2__
+  if (tag_size == 16) {
+    for (size_t i = 0; i < count; i++) {
+      const __m128i va =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + 16 * i));
+      const __m128i vb =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + 16 * i));
+      const uint64_t eq = _mm_movemask_epi8(_mm_cmpeq_epi8(va, vb));
+      // eq == 0xFFFF iff all 16 bytes matched.
+      bitmap |= ((eq + 1) >> 16) << i;
+    }
+    return bitmap;
+  }
+  if (tag_size == 32) {
+    for (size_t i = 0; i < count; i++) {
+      const __m128i lo_a =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + 32 * i));
+      const __m128i lo_b =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + 32 * i));
+      const __m128i hi_a =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + 32 * i + 16));
+      const __m128i hi_b =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + 32 * i + 16));
+      const __m128i eq128 = _mm_and_si128(_mm_cmpeq_epi8(lo_a, lo_b),
+                                          _mm_cmpeq_epi8(hi_a, hi_b));
+      const uint64_t eq = _mm_movemask_epi8(eq128);
+      bitmap |= ((eq + 1) >> 16) << i;
+    }
+    return bitmap;
+  }
+#endif
+  for (size_t i = 0; i < count; i++) {
+    uint32_t acc = 0;
+    for (size_t j = 0; j < tag_size; j++) {
+      acc |= static_cast<uint32_t>(a[i * tag_size + j] ^ b[i * tag_size + j]);
+    }
+    // acc is 0 iff the tags are equal; (acc - 1) >> 8 has its low bit set
+    // exactly in that case (acc is at most 255).
+    bitmap |= static_cast<uint64_t>(((acc - 1) >> 8) & 1) << i;
+  }
+  return bitmap;
+}
 
 }  // namespace subtle
 }  // namespace tink
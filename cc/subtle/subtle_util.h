@@ -18,8 +18,12 @@
 #define TINK_SUBTLE_SUBTLE_UTIL_H_
 
 #include <cstdint>
+#include <memory>
 #include <string>
 
+#include "absl/strings/string_view.h"
+#include "tink/util/statusor.h"
+
 namespace crypto {
 namespace tink {
 namespace subtle {
@@ -27,11 +31,80 @@ namespace subtle {
 // Returnes big endian order representation of |val|.
 std::string BigEndian32(uint32_t val);
 
+// Fast hex and standard base64 codecs for bulk paths: the JSON keyset
+// reader base64-decodes every key blob on load, and the Wycheproof loader
+// hex-decodes whole test-vector files; with many keysets the byte-at-a-time
+// conversions they used are a measurable share of startup. The codecs
+// below are table-driven with one validity check per input (no branch per
+// character), and hex encoding uses an SSSE3 kernel where available. The
+// unpadded base64url variant used by JWT lives in
+// tink/subtle/base64_url.h.
+
+// Returns the lower-case hex encoding of 'bytes'.
+std::string HexEncode(absl::string_view bytes);
+
+// Decodes the hex string 'hex' (upper- or lower-case digits).
+crypto::tink::util::StatusOr<std::string> HexDecode(absl::string_view hex);
+
+// Returns the padded standard base64 encoding (RFC 4648 section 4) of
+// 'input'.
+std::string Base64Encode(absl::string_view input);
+
+// Decodes the standard base64 string 'input' into 'output'. Padding is
+// optional. Returns false if 'input' contains a character outside the
+// base64 alphabet (this includes whitespace) or has a length that no
+// encoding produces; the contents of 'output' are unspecified in that
+// case.
+bool Base64Decode(absl::string_view input, std::string* output);
+
+// Constant-time batch tag comparison for batch-verify paths. 'tags' and
+// 'expected' are contiguous arrays of fixed-width tags, 'tag_size' bytes
+// each; the returned bitmap has bit i set iff tag i equals its
+// expectation. The comparison is constant time within the batch: the
+// running time depends only on the batch size and tag width, not on
+// where or whether mismatches occur. The batch may hold at most 64 tags
+// (one bitmap word); callers with larger batches compare in chunks.
+// 16- and 32-byte tags (the widths of the MAC and AEAD verify paths) use
+// an SSE2 kernel where available, so batch verification does not pay a
+// CRYPTO_memcmp-style call per tag.
+crypto::tink::util::StatusOr<uint64_t> ConstantTimeCompareBatch(
+    absl::string_view tags, absl::string_view expected, size_t tag_size);
+
 // Like string::resize, but the newly allocated storage may be left
 // uninitialized. C++11 provides no portable way to do this. Using this function
 // allows us to do this on a per compiler/library version basis.
 void ResizeStringUninitialized(std::string* s, size_t new_size);
 
+// A fixed-size byte buffer whose storage is inline for sizes up to
+// kInlineCapacity and heap-allocated beyond that. The cipher
+// implementations use it for bounded intermediates (padded IV blocks, MAC
+// input assembly), so that operations on small payloads do not pay a heap
+// allocation for intermediates that exceed std::string's SSO threshold.
+// The storage starts out uninitialized.
+class SmallBuffer {
+ public:
+  static constexpr size_t kInlineCapacity = 128;
+
+  explicit SmallBuffer(size_t size)
+      : size_(size),
+        heap_(size > kInlineCapacity ? new char[size] : nullptr) {}
+
+  // Neither copyable nor movable; it is a scoped scratch buffer.
+  SmallBuffer(const SmallBuffer&) = delete;
+  SmallBuffer& operator=(const SmallBuffer&) = delete;
+
+  char* data() { return heap_ != nullptr ? heap_.get() : inline_storage_; }
+  const char* data() const {
+    return heap_ != nullptr ? heap_.get() : inline_storage_;
+  }
+  size_t size() const { return size_; }
+
+ private:
+  size_t size_;
+  std::unique_ptr<char[]> heap_;
+  char inline_storage_[kInlineCapacity];
+};
+
 }  // namespace subtle
 }  // namespace tink
 }  // namespace crypto
@@ -18,6 +18,7 @@
 
 #include <algorithm>
 #include <iterator>
+#include <utility>
 
 #include "absl/memory/memory.h"
 #include "absl/strings/str_cat.h"
@@ -313,6 +314,31 @@ SubtleUtilBoringSSL::GetNewEd25519KeyFromSeed(
   return key;
 }
 
+// static
+std::vector<std::unique_ptr<SubtleUtilBoringSSL::Ed25519Key>>
+SubtleUtilBoringSSL::GetNewEd25519Keys(size_t count) {
+  // Draw all secret seeds at once; each RNG call takes the BoringSSL RNG
+  // lock, so per-key draws dominate bulk key generation.
+  constexpr size_t kSeedSize = 32;
+  util::SecretData secret_seeds =
+      crypto::tink::subtle::Random::GetRandomKeyBytes(kSeedSize * count);
+  std::vector<std::unique_ptr<Ed25519Key>> keys;
+  keys.reserve(count);
+  for (size_t i = 0; i < count; i++) {
+    uint8_t out_public_key[ED25519_PUBLIC_KEY_LEN];
+    uint8_t out_private_key[ED25519_PRIVATE_KEY_LEN];
+    ED25519_keypair_from_seed(out_public_key, out_private_key,
+                              secret_seeds.data() + kSeedSize * i);
+    auto key = absl::make_unique<Ed25519Key>();
+    key->public_key = std::string(
+        reinterpret_cast<const char *>(out_public_key), ED25519_PUBLIC_KEY_LEN);
+    key->private_key = std::string(
+        reinterpret_cast<const char *>(out_private_key), kSeedSize);
+    keys.push_back(std::move(key));
+  }
+  return keys;
+}
+
 // static
 util::StatusOr<const EVP_MD *> SubtleUtilBoringSSL::EvpHash(
     HashType hash_type) {
@@ -161,6 +161,12 @@ class SubtleUtilBoringSSL {
   static std::unique_ptr<Ed25519Key> GetNewEd25519KeyFromSeed(
       const util::SecretData &secret_seed);
 
+  // Returns 'count' new ED25519 keys. All secret seeds are drawn from the
+  // RNG in a single call, so bulk key generation pays for one RNG draw
+  // instead of one per key.
+  static std::vector<std::unique_ptr<Ed25519Key>> GetNewEd25519Keys(
+      size_t count);
+
   // Returns BoringSSL's EC_POINT constructed from curve type, point format and
   // encoded public key's point. The uncompressed point is encoded as
   // 0x04 || x || y where x, y are curve_size_in_bytes big-endian byte array.
@@ -259,6 +265,21 @@ class SubtleUtilBoringSSL {
   static const EVP_AEAD *GetAesGcmAeadForKeySize(uint32_t size_in_bytes);
 };
 
+// Scoped mark on BoringSSL's thread-local error queue. A failed trial
+// operation -- e.g. an AEAD open against the wrong key while a wrapper
+// scans raw-prefix keys -- pushes entries onto the queue that would
+// otherwise accumulate until something clears them. Popping back to the
+// mark on scope exit discards exactly the entries the guarded operation
+// pushed, and costs nothing when it pushed none.
+class ErrorQueueMark {
+ public:
+  ErrorQueueMark() { ERR_set_mark(); }
+  ~ErrorQueueMark() { ERR_pop_to_mark(); }
+
+  ErrorQueueMark(const ErrorQueueMark &) = delete;
+  ErrorQueueMark &operator=(const ErrorQueueMark &) = delete;
+};
+
 namespace boringssl {
 
 // Computes hash of 'input' using the hash function 'hasher'.
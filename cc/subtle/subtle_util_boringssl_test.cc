@@ -17,6 +17,7 @@
 #include "tink/subtle/subtle_util_boringssl.h"
 
 #include <algorithm>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -27,6 +28,7 @@
 #include "openssl/curve25519.h"
 #include "openssl/digest.h"
 #include "openssl/ec.h"
+#include "openssl/err.h"
 #include "openssl/evp.h"
 #include "openssl/x509.h"
 #include "include/rapidjson/document.h"
@@ -504,6 +506,49 @@ TEST(CreatesNewEd25519KeyPairTest, GeneratesDifferentKeysEveryTime) {
   ASSERT_NE(keypair1->public_key, keypair1->private_key);
 }
 
+TEST(ErrorQueueMarkTest, DiscardsErrorsPushedInScope) {
+  ERR_clear_error();
+  {
+    ErrorQueueMark mark;
+    ERR_put_error(ERR_LIB_EVP, 0, ERR_R_INTERNAL_ERROR, __FILE__, __LINE__);
+    EXPECT_NE(ERR_peek_error(), 0);
+  }
+  // The entry pushed inside the marked scope is gone.
+  EXPECT_EQ(ERR_peek_error(), 0);
+}
+
+TEST(ErrorQueueMarkTest, KeepsErrorsPushedBeforeMark) {
+  ERR_clear_error();
+  ERR_put_error(ERR_LIB_EVP, 0, ERR_R_INTERNAL_ERROR, __FILE__, __LINE__);
+  {
+    ErrorQueueMark mark;
+    ERR_put_error(ERR_LIB_EVP, 0, ERR_R_OVERFLOW, __FILE__, __LINE__);
+  }
+  EXPECT_NE(ERR_peek_error(), 0);
+  ERR_clear_error();
+}
+
+TEST(CreatesNewEd25519KeyPairTest, BatchGeneratesDistinctValidKeys) {
+  auto keys = SubtleUtilBoringSSL::GetNewEd25519Keys(25);
+  ASSERT_EQ(keys.size(), 25);
+  std::set<std::string> private_keys;
+  for (const auto& key : keys) {
+    ASSERT_EQ(key->public_key.length(), 32);
+    ASSERT_EQ(key->private_key.length(), 32);
+    // A key from the batch must match what seed-based generation produces
+    // for its seed.
+    auto reference = SubtleUtilBoringSSL::GetNewEd25519KeyFromSeed(
+        util::SecretDataFromStringView(key->private_key));
+    ASSERT_EQ(reference->public_key, key->public_key);
+    private_keys.insert(key->private_key);
+  }
+  EXPECT_EQ(private_keys.size(), 25);
+}
+
+TEST(CreatesNewEd25519KeyPairTest, EmptyBatch) {
+  EXPECT_TRUE(SubtleUtilBoringSSL::GetNewEd25519Keys(0).empty());
+}
+
 TEST(CreateNewX25519KeyTest, KeyIsWellFormed) {
   auto ec_key_or_status =
       SubtleUtilBoringSSL::GetNewEcKey(EllipticCurveType::CURVE25519);
@@ -16,6 +16,7 @@
 
 #include "tink/subtle/subtle_util.h"
 
+#include <cstring>
 #include <string>
 
 #include "gmock/gmock.h"
@@ -51,6 +52,137 @@ TEST(SubtleUtilTest, ResizeStringUninitialized) {
   }
 }
 
+TEST(SubtleUtilTest, SmallBufferInline) {
+  SmallBuffer buffer(SmallBuffer::kInlineCapacity);
+  EXPECT_EQ(buffer.size(), SmallBuffer::kInlineCapacity);
+  std::memset(buffer.data(), 'a', buffer.size());
+  EXPECT_THAT(std::string(buffer.data(), buffer.size()),
+              Eq(std::string(SmallBuffer::kInlineCapacity, 'a')));
+}
+
+TEST(SubtleUtilTest, HexEncodeAndDecode) {
+  // Cover all lengths up to a few SSSE3 blocks so that the vectorized
+  // encoder and the scalar tail are both exercised.
+  std::string bytes;
+  for (int len = 0; len <= 40; len++) {
+    std::string hex = HexEncode(bytes);
+    ASSERT_EQ(hex.size(), bytes.size() * 2);
+    auto decoded = HexDecode(hex);
+    ASSERT_TRUE(decoded.ok()) << decoded.status();
+    EXPECT_THAT(decoded.ValueOrDie(), Eq(bytes));
+    bytes.push_back(static_cast<char>(len * 7 + 1));
+  }
+}
+
+TEST(SubtleUtilTest, HexEncodeKnownValue) {
+  EXPECT_THAT(HexEncode(std::string("\x00\x01\x7f\x80\xff", 5)),
+              Eq("00017f80ff"));
+}
+
+TEST(SubtleUtilTest, HexDecodeAcceptsUpperCase) {
+  auto decoded = HexDecode("DEADBEEF");
+  ASSERT_TRUE(decoded.ok()) << decoded.status();
+  EXPECT_THAT(decoded.ValueOrDie(), Eq(std::string("\xde\xad\xbe\xef", 4)));
+}
+
+TEST(SubtleUtilTest, HexDecodeRejectsBadInput) {
+  EXPECT_FALSE(HexDecode("abc").ok());
+  EXPECT_FALSE(HexDecode("abcg").ok());
+  EXPECT_FALSE(HexDecode("ab cd").ok());
+}
+
+TEST(SubtleUtilTest, Base64EncodeAndDecode) {
+  std::string bytes;
+  for (int len = 0; len <= 30; len++) {
+    std::string encoded = Base64Encode(bytes);
+    EXPECT_EQ(encoded.size(), (bytes.size() + 2) / 3 * 4);
+    std::string decoded;
+    ASSERT_TRUE(Base64Decode(encoded, &decoded));
+    EXPECT_THAT(decoded, Eq(bytes));
+    bytes.push_back(static_cast<char>(255 - len));
+  }
+}
+
+TEST(SubtleUtilTest, Base64EncodeKnownValues) {
+  // RFC 4648 section 10 test vectors.
+  EXPECT_THAT(Base64Encode(""), Eq(""));
+  EXPECT_THAT(Base64Encode("f"), Eq("Zg=="));
+  EXPECT_THAT(Base64Encode("fo"), Eq("Zm8="));
+  EXPECT_THAT(Base64Encode("foo"), Eq("Zm9v"));
+  EXPECT_THAT(Base64Encode("foob"), Eq("Zm9vYg=="));
+  EXPECT_THAT(Base64Encode("fooba"), Eq("Zm9vYmE="));
+  EXPECT_THAT(Base64Encode("foobar"), Eq("Zm9vYmFy"));
+}
+
+TEST(SubtleUtilTest, Base64DecodeAcceptsUnpaddedInput) {
+  std::string decoded;
+  ASSERT_TRUE(Base64Decode("Zm9vYg", &decoded));
+  EXPECT_THAT(decoded, Eq("foob"));
+  ASSERT_TRUE(Base64Decode("Zm9vYmE", &decoded));
+  EXPECT_THAT(decoded, Eq("fooba"));
+}
+
+TEST(SubtleUtilTest, Base64DecodeRejectsBadInput) {
+  std::string decoded;
+  // A single leftover character encodes fewer than 8 bits.
+  EXPECT_FALSE(Base64Decode("Zm9vY", &decoded));
+  // Characters outside the alphabet, including whitespace and the
+  // base64url characters '-' and '_'.
+  EXPECT_FALSE(Base64Decode("Zm9v YmFy", &decoded));
+  EXPECT_FALSE(Base64Decode("Zm9-", &decoded));
+  EXPECT_FALSE(Base64Decode("Zm9_", &decoded));
+  // Padding in the middle of the input or on an unpadded-length input.
+  EXPECT_FALSE(Base64Decode("Zg==Zm8=", &decoded));
+  EXPECT_FALSE(Base64Decode("Zm8==", &decoded));
+}
+
+TEST(SubtleUtilTest, SmallBufferHeap) {
+  SmallBuffer buffer(SmallBuffer::kInlineCapacity + 1);
+  EXPECT_EQ(buffer.size(), SmallBuffer::kInlineCapacity + 1);
+  std::memset(buffer.data(), 'b', buffer.size());
+  EXPECT_THAT(std::string(buffer.data(), buffer.size()),
+              Eq(std::string(SmallBuffer::kInlineCapacity + 1, 'b')));
+}
+
+TEST(SubtleUtilTest, ConstantTimeCompareBatchBitmap) {
+  // Cover the SSE2 widths of the verify paths and an odd scalar width.
+  for (size_t tag_size : {16, 32, 10}) {
+    const size_t count = 5;
+    std::string tags;
+    for (size_t i = 0; i < count * tag_size; i++) {
+      tags.push_back(static_cast<char>(i * 13 + 7));
+    }
+    std::string expected = tags;
+    // Corrupt tag 1 in its first byte and tag 3 in its last byte.
+    expected[1 * tag_size] ^= 0x01;
+    expected[4 * tag_size - 1] ^= 0x80;
+
+    auto result = ConstantTimeCompareBatch(tags, expected, tag_size);
+    ASSERT_TRUE(result.ok()) << result.status();
+    EXPECT_EQ(0x15u, result.ValueOrDie()) << "tag_size " << tag_size;
+
+    auto all_match = ConstantTimeCompareBatch(tags, tags, tag_size);
+    ASSERT_TRUE(all_match.ok()) << all_match.status();
+    EXPECT_EQ((1u << count) - 1, all_match.ValueOrDie());
+  }
+}
+
+TEST(SubtleUtilTest, ConstantTimeCompareBatchFullBitmapWord) {
+  std::string tags(64 * 16, 'x');
+  auto result = ConstantTimeCompareBatch(tags, tags, 16);
+  ASSERT_TRUE(result.ok()) << result.status();
+  EXPECT_EQ(~static_cast<uint64_t>(0), result.ValueOrDie());
+}
+
+TEST(SubtleUtilTest, ConstantTimeCompareBatchRejectsBadInput) {
+  std::string tags(32, 'x');
+  EXPECT_FALSE(ConstantTimeCompareBatch(tags, tags, 0).ok());
+  EXPECT_FALSE(ConstantTimeCompareBatch(tags, std::string(16, 'x'), 16).ok());
+  EXPECT_FALSE(ConstantTimeCompareBatch(tags, tags, 7).ok());
+  std::string too_many(65 * 16, 'x');
+  EXPECT_FALSE(ConstantTimeCompareBatch(too_many, too_many, 16).ok());
+}
+
 }  // namespace subtle
 }  // namespace tink
 }  // namespace crypto
@@ -17,6 +17,7 @@
 #ifndef TINK_SUBTLE_TEST_UTIL_H_
 #define TINK_SUBTLE_TEST_UTIL_H_
 
+#include <atomic>
 #include <string>
 #include <vector>
 
@@ -66,12 +67,16 @@ class DummyStreamSegmentEncrypter : public StreamSegmentEncrypter {
   static constexpr char kLastSegment = 'l';
   static constexpr char kNotLastSegment = 'n';
 
+  // 'segment_number' gives the number of the first segment this encrypter
+  // will encrypt; values > 0 position the encrypter mid-stream, as when
+  // resuming a partially written ciphertext.
   DummyStreamSegmentEncrypter(int pt_segment_size,
                               int header_size,
-                              int ct_offset) :
+                              int ct_offset,
+                              int64_t segment_number = 0) :
       pt_segment_size_(pt_segment_size),
       ct_offset_(ct_offset),
-      segment_number_(0) {
+      segment_number_(segment_number) {
     // Fill the header with 'header_size' copies of letter 'h'
     header_.resize(0);
     header_.resize(header_size, static_cast<uint8_t>('h'));
@@ -104,15 +109,26 @@ class DummyStreamSegmentEncrypter : public StreamSegmentEncrypter {
       const std::vector<uint8_t>& plaintext,
       bool is_last_segment,
       std::vector<uint8_t>* ciphertext_buffer) override {
+    auto status = EncryptSegmentAt(segment_number_, plaintext, is_last_segment,
+                                   ciphertext_buffer);
+    if (!status.ok()) return status;
+    IncSegmentNumber();
+    return util::Status::OK;
+  }
+
+  util::Status EncryptSegmentAt(
+      int64_t segment_number,
+      const std::vector<uint8_t>& plaintext,
+      bool is_last_segment,
+      std::vector<uint8_t>* ciphertext_buffer) const override {
     ciphertext_buffer->resize(plaintext.size() + kSegmentTagSize);
     memcpy(ciphertext_buffer->data(), plaintext.data(), plaintext.size());
     memcpy(ciphertext_buffer->data() + plaintext.size(),
-           &segment_number_, sizeof(segment_number_));
+           &segment_number, sizeof(segment_number));
     // The last byte of the a ciphertext segment.
     ciphertext_buffer->back() =
         is_last_segment ? kLastSegment : kNotLastSegment;
     generated_output_size_ += ciphertext_buffer->size();
-    IncSegmentNumber();
     return util::Status::OK;
   }
 
@@ -152,7 +168,8 @@ class DummyStreamSegmentEncrypter : public StreamSegmentEncrypter {
   int pt_segment_size_;
   int ct_offset_;
   int64_t segment_number_;
-  int64_t generated_output_size_;
+  // Atomic, as EncryptSegmentAt() may be called concurrently.
+  mutable std::atomic<int64_t> generated_output_size_;
 };   // class DummyStreamSegmentEncrypter
 
 // A dummy decrypter that "decrypts" segments encrypted by
@@ -235,7 +252,8 @@ class DummyStreamSegmentDecrypter : public StreamSegmentDecrypter {
   std::vector<uint8_t> header_;
   int pt_segment_size_;
   int ct_offset_;
-  int64_t generated_output_size_;
+  // Atomic, as DecryptSegment() may be called concurrently.
+  std::atomic<int64_t> generated_output_size_;
 };   // class DummyStreamSegmentDecrypter
 
 class DummyStreamingAead : public NonceBasedStreamingAead {
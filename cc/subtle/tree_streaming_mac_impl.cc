@@ -0,0 +1,560 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/subtle/tree_streaming_mac_impl.h"
+
+#include <deque>
+#include <thread>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "tink/util/status.h"
+
+namespace crypto {
+namespace tink {
+namespace subtle {
+
+namespace {
+
+constexpr size_t kBufferSize = 4096;
+
+// Computes the tag of a single leaf with a freshly created StatefulMac.
+util::StatusOr<std::string> ComputeTagWithFreshMac(
+    const StatefulMacFactory* mac_factory, absl::string_view data) {
+  auto mac_result = mac_factory->Create();
+  if (!mac_result.ok()) {
+    return mac_result.status();
+  }
+  std::unique_ptr<StatefulMac> mac = std::move(mac_result.ValueOrDie());
+  util::Status update_status = mac->Update(data);
+  if (!update_status.ok()) {
+    return update_status;
+  }
+  return mac->Finalize();
+}
+
+}  // namespace
+
+// Computes leaf MACs on a pool of worker threads while the stream keeps
+// delivering data, and derives the root MAC over the ordered leaf tags when
+// the stream is closed. The number of queued leaves is bounded, so memory
+// use stays proportional to the worker count, not the input size.
+class TreeMacComputation {
+ public:
+  TreeMacComputation(const StatefulMacFactory* mac_factory, size_t leaf_size,
+                     int num_threads)
+      : mac_factory_(mac_factory), leaf_size_(leaf_size) {
+    current_leaf_.reserve(leaf_size_);
+    workers_.reserve(num_threads);
+    for (int i = 0; i < num_threads; i++) {
+      workers_.emplace_back(&TreeMacComputation::WorkerLoop, this);
+    }
+  }
+
+  ~TreeMacComputation() { JoinWorkers(); }
+
+  // Appends data to the current leaf; every completed leaf is handed to the
+  // worker pool.
+  void Append(absl::string_view data) {
+    while (!data.empty()) {
+      size_t count = std::min(leaf_size_ - current_leaf_.size(), data.size());
+      current_leaf_.append(data.data(), count);
+      data.remove_prefix(count);
+      if (current_leaf_.size() == leaf_size_) {
+        SubmitLeaf();
+      }
+    }
+  }
+
+  // Submits the trailing partial leaf, waits for all leaf MACs, and returns
+  // the MAC over the concatenated leaf tags in leaf order.
+  util::StatusOr<std::string> Finish() {
+    if (!current_leaf_.empty()) {
+      SubmitLeaf();
+    }
+    JoinWorkers();
+    // All workers are joined; the lock is only needed to satisfy the
+    // thread-safety analysis.
+    absl::MutexLock lock(&mutex_);
+    if (!status_.ok()) {
+      return status_;
+    }
+    auto root_mac_result = mac_factory_->Create();
+    if (!root_mac_result.ok()) {
+      return root_mac_result.status();
+    }
+    std::unique_ptr<StatefulMac> root_mac =
+        std::move(root_mac_result.ValueOrDie());
+    for (const std::string& leaf_tag : leaf_tags_) {
+      util::Status update_status = root_mac->Update(leaf_tag);
+      if (!update_status.ok()) {
+        return update_status;
+      }
+    }
+    return root_mac->Finalize();
+  }
+
+ private:
+  struct PendingLeaf {
+    size_t index;
+    std::string data;
+  };
+
+  bool HasQueueRoom() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return pending_leaves_.size() < 2 * workers_.size() || !status_.ok();
+  }
+
+  bool WorkAvailableOrDone() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return !pending_leaves_.empty() || done_ || !status_.ok();
+  }
+
+  void SubmitLeaf() {
+    absl::MutexLock lock(&mutex_);
+    mutex_.Await(absl::Condition(this, &TreeMacComputation::HasQueueRoom));
+    leaf_tags_.resize(next_leaf_index_ + 1);
+    pending_leaves_.push_back({next_leaf_index_, std::move(current_leaf_)});
+    next_leaf_index_++;
+    current_leaf_ = std::string();
+    current_leaf_.reserve(leaf_size_);
+  }
+
+  void WorkerLoop() {
+    while (true) {
+      PendingLeaf leaf;
+      {
+        absl::MutexLock lock(&mutex_);
+        mutex_.Await(
+            absl::Condition(this, &TreeMacComputation::WorkAvailableOrDone));
+        if (pending_leaves_.empty() || !status_.ok()) {
+          return;
+        }
+        leaf = std::move(pending_leaves_.front());
+        pending_leaves_.pop_front();
+      }
+      util::StatusOr<std::string> leaf_tag = ComputeLeafTag(leaf.data);
+      // Clear the leaf, so that any sensitive information that was written
+      // to it cannot be accessed later.
+      leaf.data.replace(0, leaf.data.size(), leaf.data.size(), 0);
+      absl::MutexLock lock(&mutex_);
+      if (!leaf_tag.ok()) {
+        if (status_.ok()) {
+          status_ = leaf_tag.status();
+        }
+        return;
+      }
+      leaf_tags_[leaf.index] = std::move(leaf_tag.ValueOrDie());
+    }
+  }
+
+  util::StatusOr<std::string> ComputeLeafTag(const std::string& leaf) const {
+    auto leaf_mac_result = mac_factory_->Create();
+    if (!leaf_mac_result.ok()) {
+      return leaf_mac_result.status();
+    }
+    std::unique_ptr<StatefulMac> leaf_mac =
+        std::move(leaf_mac_result.ValueOrDie());
+    util::Status update_status = leaf_mac->Update(leaf);
+    if (!update_status.ok()) {
+      return update_status;
+    }
+    return leaf_mac->Finalize();
+  }
+
+  void JoinWorkers() {
+    {
+      absl::MutexLock lock(&mutex_);
+      if (done_) {
+        return;
+      }
+      done_ = true;
+    }
+    for (std::thread& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  const StatefulMacFactory* mac_factory_;
+  const size_t leaf_size_;
+  std::string current_leaf_;
+  size_t next_leaf_index_ = 0;
+  std::vector<std::thread> workers_;
+  mutable absl::Mutex mutex_;
+  std::deque<PendingLeaf> pending_leaves_ ABSL_GUARDED_BY(mutex_);
+  std::vector<std::string> leaf_tags_ ABSL_GUARDED_BY(mutex_);
+  util::Status status_ ABSL_GUARDED_BY(mutex_) = util::OkStatus();
+  bool done_ ABSL_GUARDED_BY(mutex_) = false;
+};
+
+class ComputeTreeMacOutputStream : public OutputStreamWithResult<std::string> {
+ public:
+  ComputeTreeMacOutputStream(const StatefulMacFactory* mac_factory,
+                             size_t leaf_size, int num_threads)
+      : status_(util::OkStatus()),
+        tree_mac_(mac_factory, leaf_size, num_threads),
+        position_(0),
+        buffer_position_(0),
+        buffer_("") {
+    buffer_.resize(kBufferSize);
+  }
+
+  util::StatusOr<int> NextBuffer(void** buffer) override;
+  util::StatusOr<std::string> CloseStreamAndComputeResult() override;
+  void BackUp(int count) override;
+  int64_t Position() const override { return position_; }
+
+ private:
+  void WriteIntoMac();
+
+  util::Status status_;
+  TreeMacComputation tree_mac_;
+  int64_t position_;
+  int buffer_position_;
+  std::string buffer_;
+};
+
+util::StatusOr<int> ComputeTreeMacOutputStream::NextBuffer(void** buffer) {
+  if (!status_.ok()) {
+    return status_;
+  }
+  WriteIntoMac();
+  *buffer = &buffer_[0];
+  position_ += kBufferSize;
+  buffer_position_ = kBufferSize;
+  return buffer_position_;
+}
+
+util::StatusOr<std::string>
+ComputeTreeMacOutputStream::CloseStreamAndComputeResult() {
+  if (!status_.ok()) {
+    return status_;
+  }
+  WriteIntoMac();
+  status_ = util::Status(util::error::FAILED_PRECONDITION, "Stream Closed");
+  return tree_mac_.Finish();
+}
+
+void ComputeTreeMacOutputStream::BackUp(int count) {
+  count = std::min(count, buffer_position_);
+  buffer_position_ -= count;
+  position_ -= count;
+}
+
+// Writes the data in buffer_ into tree_mac_, and clears buffer_.
+void ComputeTreeMacOutputStream::WriteIntoMac() {
+  tree_mac_.Append(absl::string_view(buffer_.data(), buffer_position_));
+
+  // Clear the buffer, so that any sensitive information that
+  // was written to the buffer cannot be accessed later.
+  buffer_.replace(0, buffer_position_, buffer_position_, 0);
+}
+
+class VerifyTreeMacOutputStream
+    : public OutputStreamWithResult<util::Status> {
+ public:
+  VerifyTreeMacOutputStream(const std::string& expected,
+                            const StatefulMacFactory* mac_factory,
+                            size_t leaf_size, int num_threads)
+      : status_(util::OkStatus()),
+        tree_mac_(mac_factory, leaf_size, num_threads),
+        position_(0),
+        buffer_position_(0),
+        buffer_(""),
+        expected_(expected) {
+    buffer_.resize(kBufferSize);
+  }
+
+  util::StatusOr<int> NextBuffer(void** buffer) override;
+  util::Status CloseStreamAndComputeResult() override;
+  void BackUp(int count) override;
+  int64_t Position() const override { return position_; }
+
+ private:
+  void WriteIntoMac();
+
+  // Stream status: Initialized as OK, and
+  // changed to ERROR:FAILED_PRECONDITION when the stream is closed.
+  util::Status status_;
+  TreeMacComputation tree_mac_;
+  int64_t position_;
+  int buffer_position_;
+  std::string buffer_;
+  std::string expected_;
+};
+
+util::StatusOr<int> VerifyTreeMacOutputStream::NextBuffer(void** buffer) {
+  if (!status_.ok()) {
+    return status_;
+  }
+  WriteIntoMac();
+  *buffer = &buffer_[0];
+  position_ += kBufferSize;
+  buffer_position_ = kBufferSize;
+  return buffer_position_;
+}
+
+util::Status VerifyTreeMacOutputStream::CloseStreamAndComputeResult() {
+  if (!status_.ok()) {
+    return status_;
+  }
+  WriteIntoMac();
+  status_ = util::Status(util::error::FAILED_PRECONDITION, "Stream Closed");
+  util::StatusOr<std::string> mac_actual = tree_mac_.Finish();
+  if (!mac_actual.ok()) {
+    return mac_actual.status();
+  }
+  if (mac_actual.ValueOrDie() == expected_) {
+    return util::OkStatus();
+  }
+  return util::Status(util::error::INVALID_ARGUMENT, "Incorrect MAC");
+}
+
+void VerifyTreeMacOutputStream::BackUp(int count) {
+  count = std::min(count, buffer_position_);
+  buffer_position_ -= count;
+  position_ -= count;
+}
+
+// Writes the data in buffer_ into tree_mac_, and clears buffer_.
+void VerifyTreeMacOutputStream::WriteIntoMac() {
+  tree_mac_.Append(absl::string_view(buffer_.data(), buffer_position_));
+
+  // Clear the buffer, so that any sensitive information that
+  // was written to the buffer cannot be accessed later.
+  buffer_.replace(0, buffer_position_, buffer_position_, 0);
+}
+
+class ChunkedTreeMacComputerImpl : public ChunkedTreeMacComputer {
+ public:
+  ChunkedTreeMacComputerImpl(const StatefulMacFactory* mac_factory,
+                             size_t leaf_size)
+      : mac_factory_(mac_factory), leaf_size_(leaf_size) {
+    current_leaf_.reserve(leaf_size_);
+  }
+
+  util::Status Update(absl::string_view chunk) override {
+    if (!status_.ok()) {
+      return status_;
+    }
+    while (!chunk.empty()) {
+      size_t count = std::min(leaf_size_ - current_leaf_.size(), chunk.size());
+      current_leaf_.append(chunk.data(), count);
+      chunk.remove_prefix(count);
+      if (current_leaf_.size() == leaf_size_) {
+        util::Status leaf_status = CloseLeaf();
+        if (!leaf_status.ok()) {
+          return leaf_status;
+        }
+      }
+    }
+    return util::OkStatus();
+  }
+
+  util::StatusOr<TreeMacTags> Finish() override {
+    if (!status_.ok()) {
+      return status_;
+    }
+    if (!current_leaf_.empty()) {
+      util::Status leaf_status = CloseLeaf();
+      if (!leaf_status.ok()) {
+        return leaf_status;
+      }
+    }
+    status_ =
+        util::Status(util::error::FAILED_PRECONDITION, "Already finished");
+    auto root_mac_result = mac_factory_->Create();
+    if (!root_mac_result.ok()) {
+      return root_mac_result.status();
+    }
+    std::unique_ptr<StatefulMac> root_mac =
+        std::move(root_mac_result.ValueOrDie());
+    for (const std::string& leaf_tag : leaf_tags_) {
+      util::Status update_status = root_mac->Update(leaf_tag);
+      if (!update_status.ok()) {
+        return update_status;
+      }
+    }
+    util::StatusOr<std::string> root_tag = root_mac->Finalize();
+    if (!root_tag.ok()) {
+      return root_tag.status();
+    }
+    TreeMacTags tags;
+    tags.root_tag = std::move(root_tag.ValueOrDie());
+    tags.leaf_tags = std::move(leaf_tags_);
+    return tags;
+  }
+
+ private:
+  // Computes the tag of the buffered leaf, and clears the buffer.
+  util::Status CloseLeaf() {
+    util::StatusOr<std::string> leaf_tag =
+        ComputeTagWithFreshMac(mac_factory_, current_leaf_);
+    // Clear the leaf, so that any sensitive information that was written
+    // to it cannot be accessed later.
+    current_leaf_.replace(0, current_leaf_.size(), current_leaf_.size(), 0);
+    current_leaf_.clear();
+    if (!leaf_tag.ok()) {
+      status_ = leaf_tag.status();
+      return status_;
+    }
+    leaf_tags_.push_back(std::move(leaf_tag.ValueOrDie()));
+    return util::OkStatus();
+  }
+
+  const StatefulMacFactory* mac_factory_;
+  const size_t leaf_size_;
+  std::string current_leaf_;
+  std::vector<std::string> leaf_tags_;
+  util::Status status_ = util::OkStatus();
+};
+
+class ChunkedTreeMacVerifierImpl : public ChunkedTreeMacVerifier {
+ public:
+  ChunkedTreeMacVerifierImpl(const StatefulMacFactory* mac_factory,
+                             size_t leaf_size,
+                             std::vector<std::string> leaf_tags)
+      : mac_factory_(mac_factory),
+        leaf_size_(leaf_size),
+        leaf_tags_(std::move(leaf_tags)) {
+    current_leaf_.reserve(leaf_size_);
+  }
+
+  util::Status Update(absl::string_view chunk) override {
+    if (!status_.ok()) {
+      return status_;
+    }
+    while (!chunk.empty()) {
+      size_t count = std::min(leaf_size_ - current_leaf_.size(), chunk.size());
+      current_leaf_.append(chunk.data(), count);
+      chunk.remove_prefix(count);
+      if (current_leaf_.size() == leaf_size_) {
+        util::Status leaf_status = CheckLeaf();
+        if (!leaf_status.ok()) {
+          return leaf_status;
+        }
+      }
+    }
+    return util::OkStatus();
+  }
+
+  util::Status Finish() override {
+    if (!status_.ok()) {
+      return status_;
+    }
+    if (!current_leaf_.empty()) {
+      util::Status leaf_status = CheckLeaf();
+      if (!leaf_status.ok()) {
+        return leaf_status;
+      }
+    }
+    status_ =
+        util::Status(util::error::FAILED_PRECONDITION, "Already finished");
+    if (next_leaf_index_ != leaf_tags_.size()) {
+      // The message is shorter than the manifest says; it was truncated.
+      return util::Status(util::error::INVALID_ARGUMENT, "Incorrect MAC");
+    }
+    return util::OkStatus();
+  }
+
+ private:
+  // Checks the buffered leaf against the manifest, and clears the buffer.
+  util::Status CheckLeaf() {
+    if (next_leaf_index_ >= leaf_tags_.size()) {
+      // The message is longer than the manifest says.
+      status_ = util::Status(util::error::INVALID_ARGUMENT, "Incorrect MAC");
+      return status_;
+    }
+    util::StatusOr<std::string> leaf_tag =
+        ComputeTagWithFreshMac(mac_factory_, current_leaf_);
+    // Clear the leaf, so that any sensitive information that was written
+    // to it cannot be accessed later.
+    current_leaf_.replace(0, current_leaf_.size(), current_leaf_.size(), 0);
+    current_leaf_.clear();
+    if (!leaf_tag.ok()) {
+      status_ = leaf_tag.status();
+      return status_;
+    }
+    if (leaf_tag.ValueOrDie() != leaf_tags_[next_leaf_index_]) {
+      status_ = util::Status(util::error::INVALID_ARGUMENT, "Incorrect MAC");
+      return status_;
+    }
+    next_leaf_index_++;
+    return util::OkStatus();
+  }
+
+  const StatefulMacFactory* mac_factory_;
+  const size_t leaf_size_;
+  std::string current_leaf_;
+  std::vector<std::string> leaf_tags_;
+  size_t next_leaf_index_ = 0;
+  util::Status status_ = util::OkStatus();
+};
+
+util::StatusOr<std::unique_ptr<OutputStreamWithResult<std::string>>>
+TreeStreamingMacImpl::NewComputeMacOutputStream() const {
+  return std::unique_ptr<OutputStreamWithResult<std::string>>(
+      absl::make_unique<ComputeTreeMacOutputStream>(
+          mac_factory_.get(), leaf_size_, num_threads_));
+}
+
+util::StatusOr<std::unique_ptr<OutputStreamWithResult<util::Status>>>
+TreeStreamingMacImpl::NewVerifyMacOutputStream(
+    const std::string& mac_value) const {
+  return std::unique_ptr<OutputStreamWithResult<util::Status>>(
+      absl::make_unique<VerifyTreeMacOutputStream>(
+          mac_value, mac_factory_.get(), leaf_size_, num_threads_));
+}
+
+util::StatusOr<std::unique_ptr<ChunkedTreeMacComputer>>
+TreeStreamingMacImpl::NewChunkedComputer() const {
+  return std::unique_ptr<ChunkedTreeMacComputer>(
+      absl::make_unique<ChunkedTreeMacComputerImpl>(mac_factory_.get(),
+                                                    leaf_size_));
+}
+
+util::StatusOr<std::unique_ptr<ChunkedTreeMacVerifier>>
+TreeStreamingMacImpl::NewChunkedVerifier(
+    const std::string& mac_value, std::vector<std::string> leaf_tags) const {
+  // Authenticate the manifest before accepting any data: the tree MAC is
+  // exactly the MAC over the concatenated leaf tags.
+  auto root_mac_result = mac_factory_->Create();
+  if (!root_mac_result.ok()) {
+    return root_mac_result.status();
+  }
+  std::unique_ptr<StatefulMac> root_mac =
+      std::move(root_mac_result.ValueOrDie());
+  for (const std::string& leaf_tag : leaf_tags) {
+    util::Status update_status = root_mac->Update(leaf_tag);
+    if (!update_status.ok()) {
+      return update_status;
+    }
+  }
+  util::StatusOr<std::string> root_tag = root_mac->Finalize();
+  if (!root_tag.ok()) {
+    return root_tag.status();
+  }
+  if (root_tag.ValueOrDie() != mac_value) {
+    return util::Status(util::error::INVALID_ARGUMENT, "Incorrect MAC");
+  }
+  return std::unique_ptr<ChunkedTreeMacVerifier>(
+      absl::make_unique<ChunkedTreeMacVerifierImpl>(
+          mac_factory_.get(), leaf_size_, std::move(leaf_tags)));
+}
+
+}  // namespace subtle
+}  // namespace tink
+}  // namespace crypto
@@ -0,0 +1,135 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_SUBTLE_TREE_STREAMING_MAC_IMPL_H_
+#define TINK_SUBTLE_TREE_STREAMING_MAC_IMPL_H_
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "tink/streaming_mac.h"
+#include "tink/subtle/mac/stateful_mac.h"
+
+namespace crypto {
+namespace tink {
+namespace subtle {
+
+// Incrementally computes a tree MAC and additionally returns the leaf tag
+// manifest, which a ChunkedTreeMacVerifier needs for early-abort
+// verification. Obtained from TreeStreamingMacImpl::NewChunkedComputer().
+class ChunkedTreeMacComputer {
+ public:
+  struct TreeMacTags {
+    // The tree MAC, as also computed by NewComputeMacOutputStream().
+    std::string root_tag;
+    // The tags of the individual leaves, in leaf order.
+    std::vector<std::string> leaf_tags;
+  };
+
+  virtual ~ChunkedTreeMacComputer() = default;
+
+  // Feeds the next chunk of the message; chunks may have arbitrary sizes.
+  virtual util::Status Update(absl::string_view chunk) = 0;
+
+  // Must be called exactly once after the last chunk.
+  virtual util::StatusOr<TreeMacTags> Finish() = 0;
+};
+
+// Incrementally verifies a tree MAC with early abort. Obtained from
+// TreeStreamingMacImpl::NewChunkedVerifier().
+class ChunkedTreeMacVerifier {
+ public:
+  virtual ~ChunkedTreeMacVerifier() = default;
+
+  // Feeds the next chunk of the message; chunks may have arbitrary sizes.
+  // Returns INVALID_ARGUMENT with "Incorrect MAC" as soon as a completed
+  // leaf contradicts the leaf tag manifest; callers should then abort the
+  // transfer instead of fetching the rest of the message.
+  virtual util::Status Update(absl::string_view chunk) = 0;
+
+  // Must be called exactly once after the last chunk; verifies the trailing
+  // (possibly partial) leaf and that the message has exactly as many leaves
+  // as the manifest.
+  virtual util::Status Finish() = 0;
+};
+
+// A StreamingMac that computes a two-level tree MAC: the input is split into
+// leaves of leaf_size bytes (the last leaf may be shorter), every leaf is
+// MACed independently on a pool of num_threads worker threads, and the
+// resulting tag is the MAC of the concatenation of the leaf tags in leaf
+// order. This makes MACing large inputs scale with the number of cores
+// instead of being single-core bound.
+//
+// The tag depends only on the key, the input, and leaf_size -- not on
+// num_threads -- so tags computed with different worker counts are
+// interoperable. Tags are NOT compatible with the sequential
+// StreamingMacImpl for the same key; both parties must agree on the tree
+// mode and on leaf_size.
+//
+// The TreeStreamingMacImpl must outlive all streams, computers and
+// verifiers it has returned.
+class TreeStreamingMacImpl : public StreamingMac {
+ public:
+  explicit TreeStreamingMacImpl(std::unique_ptr<StatefulMacFactory> mac_factory,
+                                size_t leaf_size = 1 << 20,
+                                int num_threads = 8)
+      : mac_factory_(std::move(mac_factory)),
+        leaf_size_(std::max(leaf_size, static_cast<size_t>(1))),
+        num_threads_(std::max(num_threads, 1)) {}
+
+  // Returns an ComputeMacOutputStream, which when closed will return the
+  // tree MAC of the data put into the stream.
+  util::StatusOr<std::unique_ptr<OutputStreamWithResult<std::string>>>
+  NewComputeMacOutputStream() const override;
+
+  // Returns an VerifyMacOutputStream which verifies if 'mac_value' is a
+  // correct tree MAC for the data written to it.
+  util::StatusOr<std::unique_ptr<OutputStreamWithResult<util::Status>>>
+  NewVerifyMacOutputStream(const std::string& mac_value) const override;
+
+  // Returns a computer for chunked tree MAC computation that also returns
+  // the leaf tag manifest needed by NewChunkedVerifier(). Leaf MACs are
+  // computed inline on the caller's thread.
+  util::StatusOr<std::unique_ptr<ChunkedTreeMacComputer>> NewChunkedComputer()
+      const;
+
+  // Returns a verifier for chunked tree MAC verification with early abort.
+  // 'leaf_tags' is the leaf tag manifest produced with the same key and leaf
+  // size (e.g. stored next to the artifact); 'mac_value' is the tree MAC.
+  // The manifest is authenticated against 'mac_value' before any data is
+  // accepted, so a forged manifest is rejected here with INVALID_ARGUMENT;
+  // afterwards every completed leaf is checked against the manifest, so
+  // corruption surfaces after at most leaf_size further bytes instead of at
+  // the end of the message.
+  util::StatusOr<std::unique_ptr<ChunkedTreeMacVerifier>> NewChunkedVerifier(
+      const std::string& mac_value,
+      std::vector<std::string> leaf_tags) const;
+
+ private:
+  std::unique_ptr<StatefulMacFactory> mac_factory_;
+  const size_t leaf_size_;
+  const int num_threads_;
+};
+
+}  // namespace subtle
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_SUBTLE_TREE_STREAMING_MAC_IMPL_H_
@@ -0,0 +1,342 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/subtle/tree_streaming_mac_impl.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
+#include "tink/subtle/random.h"
+#include "tink/subtle/test_util.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+#include "tink/util/test_matchers.h"
+#include "tink/util/test_util.h"
+
+namespace crypto {
+namespace tink {
+namespace subtle {
+namespace {
+
+using ::crypto::tink::test::DummyStatefulMac;
+using ::crypto::tink::test::IsOk;
+using ::crypto::tink::test::StatusIs;
+using ::testing::HasSubstr;
+
+constexpr size_t kLeafSize = 256;
+constexpr int kNumThreads = 4;
+
+class DummyStatefulMacFactory : public StatefulMacFactory {
+ public:
+  DummyStatefulMacFactory() {}
+  ~DummyStatefulMacFactory() override {}
+
+  util::StatusOr<std::unique_ptr<StatefulMac>> Create() const override {
+    return std::unique_ptr<StatefulMac>(
+        absl::make_unique<DummyStatefulMac>("tree mac:"));
+  }
+};
+
+// The tag a DummyStatefulMac("tree mac:") computes over data.
+std::string DummyTag(absl::string_view data) {
+  return absl::StrCat("18:", data.size(), ":DummyMac:tree mac:", data);
+}
+
+// The expected tree MAC: a dummy tag over the concatenated dummy leaf tags.
+std::string ExpectedTreeMac(absl::string_view data, size_t leaf_size) {
+  std::string leaf_tags;
+  for (size_t pos = 0; pos < data.size(); pos += leaf_size) {
+    leaf_tags += DummyTag(data.substr(pos, leaf_size));
+  }
+  return DummyTag(leaf_tags);
+}
+
+std::unique_ptr<TreeStreamingMacImpl> GetTreeStreamingMac(
+    size_t leaf_size = kLeafSize, int num_threads = kNumThreads) {
+  auto mac_factory = std::unique_ptr<StatefulMacFactory>(
+      absl::make_unique<DummyStatefulMacFactory>());
+  return absl::make_unique<TreeStreamingMacImpl>(std::move(mac_factory),
+                                                 leaf_size, num_threads);
+}
+
+// A helper for creating an OutputStreamWithResult<std::string>,
+// used for test validation for mac computation.
+std::unique_ptr<OutputStreamWithResult<std::string>> GetComputeMacOutputStream(
+    size_t leaf_size = kLeafSize, int num_threads = kNumThreads) {
+  auto streaming_mac = GetTreeStreamingMac(leaf_size, num_threads);
+  util::StatusOr<std::unique_ptr<OutputStreamWithResult<std::string>>>
+      stream_status = streaming_mac->NewComputeMacOutputStream();
+  EXPECT_THAT(stream_status.status(), IsOk());
+  return std::move(stream_status.ValueOrDie());
+}
+
+// A helper for creating an OutputStreamWithResult<util::Status>,
+// used for test validation for mac verification.
+std::unique_ptr<OutputStreamWithResult<util::Status>> GetVerifyMacOutputStream(
+    std::string expected_mac) {
+  auto streaming_mac = GetTreeStreamingMac();
+  util::StatusOr<std::unique_ptr<OutputStreamWithResult<util::Status>>>
+      stream_status = streaming_mac->NewVerifyMacOutputStream(expected_mac);
+  EXPECT_THAT(stream_status.status(), IsOk());
+  return std::move(stream_status.ValueOrDie());
+}
+
+TEST(TreeStreamingMacImplTest, ComputeEmptyMac) {
+  auto output_stream = GetComputeMacOutputStream();
+
+  // Close stream and check result: no leaves, so the root MAC is computed
+  // over an empty tag sequence.
+  auto close_status = output_stream->CloseAndGetResult();
+  EXPECT_THAT(close_status.status(), IsOk());
+  EXPECT_EQ(close_status.ValueOrDie(), ExpectedTreeMac("", kLeafSize));
+}
+
+TEST(TreeStreamingMacImplTest, ComputeSmallMac) {
+  std::string text = "I am a small message";
+  // A leaf size smaller than the message, to get several leaves.
+  auto output_stream = GetComputeMacOutputStream(/* leaf_size= */ 8);
+
+  auto status = test::WriteToStream(output_stream.get(), text, false);
+  EXPECT_THAT(status, IsOk());
+  EXPECT_EQ(output_stream->Position(), text.size());
+
+  auto close_status = output_stream->CloseAndGetResult();
+  EXPECT_THAT(close_status.status(), IsOk());
+  EXPECT_EQ(close_status.ValueOrDie(), ExpectedTreeMac(text, 8));
+}
+
+TEST(TreeStreamingMacImplTest, ComputeRandMac) {
+  std::vector<int> text_sizes = {0, 10, 100, 1000, 10000, 1000000};
+
+  for (auto text_size : text_sizes) {
+    std::string text = Random::GetRandomBytes(text_size);
+    auto output_stream = GetComputeMacOutputStream();
+
+    auto status = test::WriteToStream(output_stream.get(), text, false);
+    EXPECT_THAT(status, IsOk());
+    EXPECT_EQ(output_stream->Position(), text.size());
+
+    auto close_status = output_stream->CloseAndGetResult();
+    EXPECT_THAT(close_status.status(), IsOk());
+    EXPECT_EQ(close_status.ValueOrDie(), ExpectedTreeMac(text, kLeafSize));
+  }
+}
+
+TEST(TreeStreamingMacImplTest, SameTagForAllThreadCounts) {
+  // The tag must depend only on the input and the leaf size, so tags
+  // computed with different worker counts are interoperable.
+  std::string text = Random::GetRandomBytes(100000);
+
+  std::vector<std::string> tags;
+  for (int num_threads : {1, 2, 8}) {
+    auto output_stream =
+        GetComputeMacOutputStream(kLeafSize, num_threads);
+    auto status = test::WriteToStream(output_stream.get(), text, false);
+    EXPECT_THAT(status, IsOk());
+    auto close_status = output_stream->CloseAndGetResult();
+    EXPECT_THAT(close_status.status(), IsOk());
+    tags.push_back(close_status.ValueOrDie());
+  }
+  EXPECT_EQ(tags[0], tags[1]);
+  EXPECT_EQ(tags[0], tags[2]);
+  EXPECT_EQ(tags[0], ExpectedTreeMac(text, kLeafSize));
+}
+
+TEST(TreeStreamingMacImplTest, ComputeCloseTwiceError) {
+  auto output_stream = GetComputeMacOutputStream();
+
+  // Close stream
+  auto close_status = output_stream->CloseAndGetResult();
+
+  // Try closing the stream again.
+  auto reclose_status = output_stream->Close();
+  EXPECT_FALSE(reclose_status.ok());
+  EXPECT_EQ(util::error::FAILED_PRECONDITION, reclose_status.error_code());
+}
+
+TEST(TreeStreamingMacImplTest, VerifyRandMac) {
+  std::vector<int> text_sizes = {0, 10, 100, 1000, 10000, 1000000};
+
+  for (auto text_size : text_sizes) {
+    std::string text = Random::GetRandomBytes(text_size);
+    auto output_stream =
+        GetVerifyMacOutputStream(ExpectedTreeMac(text, kLeafSize));
+
+    auto status = test::WriteToStream(output_stream.get(), text, false);
+    EXPECT_TRUE(status.ok()) << status;
+    EXPECT_EQ(output_stream->Position(), text.size());
+
+    auto close_status = output_stream->CloseAndGetResult();
+    EXPECT_TRUE(close_status.ok());
+  }
+}
+
+TEST(TreeStreamingMacImplTest, VerifyMacFail) {
+  std::string text = "I am a small message";
+  auto output_stream =
+      GetVerifyMacOutputStream(ExpectedTreeMac("I am wrong message", kLeafSize));
+
+  auto status = test::WriteToStream(output_stream.get(), text, false);
+  EXPECT_TRUE(status.ok()) << status;
+  EXPECT_EQ(output_stream->Position(), text.size());
+
+  EXPECT_THAT(
+      output_stream->CloseAndGetResult(),
+      StatusIs(util::error::INVALID_ARGUMENT, HasSubstr("Incorrect MAC")));
+}
+
+TEST(TreeStreamingMacImplTest, VerifySequentialMacFail) {
+  // A tag computed in sequential (non-tree) mode must not verify.
+  std::string text = "I am a small message";
+  auto output_stream = GetVerifyMacOutputStream(DummyTag(text));
+
+  auto status = test::WriteToStream(output_stream.get(), text, false);
+  EXPECT_TRUE(status.ok()) << status;
+
+  EXPECT_THAT(
+      output_stream->CloseAndGetResult(),
+      StatusIs(util::error::INVALID_ARGUMENT, HasSubstr("Incorrect MAC")));
+}
+
+TEST(TreeStreamingMacImplTest, ChunkedComputeMatchesStream) {
+  std::string text = Random::GetRandomBytes(10000);
+  auto streaming_mac = GetTreeStreamingMac();
+  auto computer = std::move(
+      streaming_mac->NewChunkedComputer().ValueOrDie());
+
+  // Feed chunks of varying sizes that do not align with leaf boundaries.
+  size_t pos = 0;
+  size_t chunk_size = 1;
+  while (pos < text.size()) {
+    size_t count = std::min(chunk_size, text.size() - pos);
+    EXPECT_THAT(computer->Update(absl::string_view(text).substr(pos, count)),
+                IsOk());
+    pos += count;
+    chunk_size = chunk_size * 2 + 1;
+  }
+
+  auto tags_result = computer->Finish();
+  EXPECT_THAT(tags_result.status(), IsOk());
+  auto tags = std::move(tags_result.ValueOrDie());
+  EXPECT_EQ(tags.root_tag, ExpectedTreeMac(text, kLeafSize));
+  ASSERT_EQ(tags.leaf_tags.size(), (text.size() + kLeafSize - 1) / kLeafSize);
+  for (size_t i = 0; i < tags.leaf_tags.size(); i++) {
+    EXPECT_EQ(tags.leaf_tags[i],
+              DummyTag(absl::string_view(text).substr(i * kLeafSize,
+                                                      kLeafSize)));
+  }
+}
+
+TEST(TreeStreamingMacImplTest, ChunkedVerifyOk) {
+  std::string text = Random::GetRandomBytes(10000);
+  auto streaming_mac = GetTreeStreamingMac();
+  auto computer = std::move(
+      streaming_mac->NewChunkedComputer().ValueOrDie());
+  EXPECT_THAT(computer->Update(text), IsOk());
+  auto tags = std::move(computer->Finish().ValueOrDie());
+
+  auto verifier_result =
+      streaming_mac->NewChunkedVerifier(tags.root_tag, tags.leaf_tags);
+  EXPECT_THAT(verifier_result.status(), IsOk());
+  auto verifier = std::move(verifier_result.ValueOrDie());
+  EXPECT_THAT(verifier->Update(text), IsOk());
+  EXPECT_THAT(verifier->Finish(), IsOk());
+}
+
+TEST(TreeStreamingMacImplTest, ChunkedVerifyAbortsEarly) {
+  std::string text = Random::GetRandomBytes(10 * kLeafSize);
+  auto streaming_mac = GetTreeStreamingMac();
+  auto computer = std::move(
+      streaming_mac->NewChunkedComputer().ValueOrDie());
+  EXPECT_THAT(computer->Update(text), IsOk());
+  auto tags = std::move(computer->Finish().ValueOrDie());
+
+  // Corrupt one byte in the third leaf.
+  std::string corrupt = text;
+  corrupt[2 * kLeafSize + 7] ^= 1;
+
+  auto verifier = std::move(
+      streaming_mac->NewChunkedVerifier(tags.root_tag, tags.leaf_tags)
+          .ValueOrDie());
+  absl::string_view corrupt_view(corrupt);
+  EXPECT_THAT(verifier->Update(corrupt_view.substr(0, kLeafSize)), IsOk());
+  EXPECT_THAT(verifier->Update(corrupt_view.substr(kLeafSize, kLeafSize)),
+              IsOk());
+  // The corrupt leaf is reported as soon as it completes; the remaining
+  // seven leaves never have to be fetched.
+  EXPECT_THAT(
+      verifier->Update(corrupt_view.substr(2 * kLeafSize, kLeafSize)),
+      StatusIs(util::error::INVALID_ARGUMENT, HasSubstr("Incorrect MAC")));
+  // Later calls keep failing.
+  EXPECT_FALSE(verifier->Update(corrupt_view.substr(3 * kLeafSize)).ok());
+  EXPECT_FALSE(verifier->Finish().ok());
+}
+
+TEST(TreeStreamingMacImplTest, ChunkedVerifyForgedManifestFails) {
+  std::string text = Random::GetRandomBytes(10000);
+  auto streaming_mac = GetTreeStreamingMac();
+  auto computer = std::move(
+      streaming_mac->NewChunkedComputer().ValueOrDie());
+  EXPECT_THAT(computer->Update(text), IsOk());
+  auto tags = std::move(computer->Finish().ValueOrDie());
+
+  // A tampered manifest is rejected before any data is read.
+  auto forged_leaf_tags = tags.leaf_tags;
+  forged_leaf_tags[1][0] ^= 1;
+  EXPECT_THAT(
+      streaming_mac->NewChunkedVerifier(tags.root_tag, forged_leaf_tags)
+          .status(),
+      StatusIs(util::error::INVALID_ARGUMENT, HasSubstr("Incorrect MAC")));
+
+  // So is a manifest that does not match the expected tag.
+  EXPECT_THAT(
+      streaming_mac->NewChunkedVerifier("wrong tag", tags.leaf_tags).status(),
+      StatusIs(util::error::INVALID_ARGUMENT, HasSubstr("Incorrect MAC")));
+}
+
+TEST(TreeStreamingMacImplTest, ChunkedVerifyWrongLengthFails) {
+  std::string text = Random::GetRandomBytes(4 * kLeafSize);
+  auto streaming_mac = GetTreeStreamingMac();
+  auto computer = std::move(
+      streaming_mac->NewChunkedComputer().ValueOrDie());
+  EXPECT_THAT(computer->Update(text), IsOk());
+  auto tags = std::move(computer->Finish().ValueOrDie());
+
+  // Truncated message: the missing trailing leaf is caught by Finish().
+  auto verifier = std::move(
+      streaming_mac->NewChunkedVerifier(tags.root_tag, tags.leaf_tags)
+          .ValueOrDie());
+  EXPECT_THAT(
+      verifier->Update(absl::string_view(text).substr(0, 3 * kLeafSize)),
+      IsOk());
+  EXPECT_THAT(
+      verifier->Finish(),
+      StatusIs(util::error::INVALID_ARGUMENT, HasSubstr("Incorrect MAC")));
+
+  // Extended message: the extra leaf is caught as soon as it completes.
+  verifier = std::move(
+      streaming_mac->NewChunkedVerifier(tags.root_tag, tags.leaf_tags)
+          .ValueOrDie());
+  EXPECT_THAT(verifier->Update(text), IsOk());
+  EXPECT_THAT(
+      verifier->Update(Random::GetRandomBytes(kLeafSize)),
+      StatusIs(util::error::INVALID_ARGUMENT, HasSubstr("Incorrect MAC")));
+}
+
+}  // namespace
+}  // namespace subtle
+}  // namespace tink
+}  // namespace crypto
@@ -16,14 +16,19 @@
 
 #include "tink/subtle/wycheproof_util.h"
 
+#include <algorithm>
+#include <atomic>
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <thread>
+#include <vector>
 
 #include "absl/strings/string_view.h"
 #include "include/rapidjson/document.h"
 #include "include/rapidjson/istreamwrapper.h"
 #include "tink/subtle/common_enums.h"
+#include "tink/subtle/subtle_util.h"
 #include "tink/util/status.h"
 #include "tink/util/statusor.h"
 
@@ -33,28 +38,6 @@ namespace subtle {
 
 namespace {
 
-// TODO: factor these helpers out to an "util"-class.
-util::StatusOr<std::string> HexDecode(absl::string_view hex) {
-  if (hex.size() % 2 != 0) {
-    return util::Status(util::error::INVALID_ARGUMENT, "Input has odd size.");
-  }
-  std::string decoded(hex.size() / 2, static_cast<char>(0));
-  for (size_t i = 0; i < hex.size(); ++i) {
-    char c = hex[i];
-    char val;
-    if ('0' <= c && c <= '9')
-      val = c - '0';
-    else if ('a' <= c && c <= 'f')
-      val = c - 'a' + 10;
-    else if ('A' <= c && c <= 'F')
-      val = c - 'A' + 10;
-    else
-      return util::Status(util::error::INVALID_ARGUMENT, "Not hexadecimal");
-    decoded[i / 2] = (decoded[i / 2] << 4) | val;
-  }
-  return decoded;
-}
-
 std::string HexDecodeOrDie(absl::string_view hex) {
   return HexDecode(hex).ValueOrDie();
 }
@@ -115,6 +98,43 @@ EllipticCurveType WycheproofUtil::GetEllipticCurveType(
   }
 }
 
+int WycheproofUtil::RunTestGroups(
+    const rapidjson::Document &root,
+    const std::function<int(const rapidjson::Value &)> &run_group,
+    int num_threads) {
+  std::vector<const rapidjson::Value *> groups;
+  for (const rapidjson::Value &group : root["testGroups"].GetArray()) {
+    groups.push_back(&group);
+  }
+  // Workers claim groups through a shared counter, so a few slow groups do
+  // not leave threads idle. Concurrent const access to the parsed document
+  // is safe.
+  std::atomic<size_t> next_group(0);
+  std::atomic<int> errors(0);
+  auto worker = [&groups, &next_group, &errors, &run_group]() {
+    while (true) {
+      size_t i = next_group.fetch_add(1);
+      if (i >= groups.size()) return;
+      errors += run_group(*groups[i]);
+    }
+  };
+  size_t thread_count = std::min(
+      static_cast<size_t>(std::max(num_threads, 1)), groups.size());
+  if (thread_count <= 1) {
+    worker();
+  } else {
+    std::vector<std::thread> threads;
+    threads.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i) {
+      threads.emplace_back(worker);
+    }
+    for (std::thread &thread : threads) {
+      thread.join();
+    }
+  }
+  return errors;
+}
+
 std::string WycheproofUtil::GetInteger(const rapidjson::Value &val) {
   std::string hex(val.GetString());
   // Since val is a hexadecimal integer it can have an odd length.
@@ -17,6 +17,7 @@
 #ifndef TINK_SUBTLE_WYCHEPROOF_UTIL_H_
 #define TINK_SUBTLE_WYCHEPROOF_UTIL_H_
 
+#include <functional>
 #include <memory>
 #include "include/rapidjson/document.h"
 #include "tink/subtle/common_enums.h"
@@ -52,6 +53,18 @@ class WycheproofUtil {
   // in the test group are valid, only values in the test vector itself may
   // be invalid.
   static std::string GetInteger(const rapidjson::Value &val);
+
+  // Applies `run_group` to every element of root["testGroups"], distributing
+  // the groups over up to `num_threads` worker threads, and returns the sum
+  // of the error counts returned by the callbacks. The large test vector
+  // files take minutes to verify sequentially; the groups are independent,
+  // so running them in parallel cuts the wall time of the big subtle tests.
+  // `run_group` must be thread-safe; Google Test assertions may be used (they
+  // are thread-safe on systems with pthreads).
+  static int RunTestGroups(
+      const rapidjson::Document &root,
+      const std::function<int(const rapidjson::Value &)> &run_group,
+      int num_threads = 8);
 };
 
 }  // namespace subtle
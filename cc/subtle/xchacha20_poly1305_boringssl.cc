@@ -20,6 +20,7 @@
 #include <string>
 #include <vector>
 
+#include "absl/memory/memory.h"
 #include "openssl/err.h"
 #include "openssl/evp.h"
 #include "tink/aead.h"
@@ -53,59 +54,82 @@ util::StatusOr<std::unique_ptr<Aead>> XChacha20Poly1305BoringSsl::New(
   if (cipher == nullptr) {
     return util::Status(util::error::INTERNAL, "Failed to get EVP_AEAD");
   }
-  return std::unique_ptr<Aead>(
-      new XChacha20Poly1305BoringSsl(std::move(key), cipher));
-}
-
-util::StatusOr<std::string> XChacha20Poly1305BoringSsl::Encrypt(
-    absl::string_view plaintext, absl::string_view additional_data) const {
+  // Set up the context once; EVP_AEAD contexts are stateless after
+  // initialization, so seal/open calls can share it across threads.
   bssl::UniquePtr<EVP_AEAD_CTX> ctx(
-      EVP_AEAD_CTX_new(aead_, reinterpret_cast<const uint8_t*>(key_.data()),
-                       key_.size(), kTagSize));
-  if (ctx.get() == nullptr) {
+      EVP_AEAD_CTX_new(cipher, reinterpret_cast<const uint8_t*>(key.data()),
+                       key.size(), kTagSize));
+  if (!ctx) {
     return util::Status(util::error::INTERNAL,
                         "could not initialize EVP_AEAD_CTX");
   }
+  return {absl::WrapUnique(new XChacha20Poly1305BoringSsl(std::move(ctx)))};
+}
 
+util::StatusOr<std::string> XChacha20Poly1305BoringSsl::Encrypt(
+    absl::string_view plaintext, absl::string_view additional_data) const {
   // BoringSSL expects a non-null pointer for plaintext and additional_data,
   // regardless of whether the size is 0.
   plaintext = SubtleUtilBoringSSL::EnsureNonNull(plaintext);
   additional_data = SubtleUtilBoringSSL::EnsureNonNull(additional_data);
 
-  const std::string nonce = Random::GetRandomBytes(kNonceSize);
-  if (nonce.size() != kNonceSize) {
+  // Write the nonce in the output buffer.
+  std::string ct = Random::GetRandomBytes(kNonceSize);
+  if (ct.size() != kNonceSize) {
     return util::Status(util::error::INTERNAL,
                         "Failed to get enough random bytes for nonce");
   }
-
-  size_t ciphertext_size = nonce.size() + plaintext.size() + kTagSize;
-
-  // Write the nonce in the output buffer.
-  std::string ct = nonce;
+  size_t ciphertext_size = kNonceSize + plaintext.size() + kTagSize;
   ResizeStringUninitialized(&ct, ciphertext_size);
-  size_t written = nonce.size();
 
   // Encrypt the plaintext and store it after the nonce.
   size_t out_len = 0;
   int ret = EVP_AEAD_CTX_seal(
-      ctx.get(), reinterpret_cast<uint8_t*>(&ct[written]), &out_len,
-      ciphertext_size - written, reinterpret_cast<const uint8_t*>(nonce.data()),
-      nonce.size(), reinterpret_cast<const uint8_t*>(plaintext.data()),
-      plaintext.size(),
+      ctx_.get(), reinterpret_cast<uint8_t*>(&ct[kNonceSize]), &out_len,
+      ciphertext_size - kNonceSize,
+      reinterpret_cast<const uint8_t*>(&ct[0]), kNonceSize,
+      reinterpret_cast<const uint8_t*>(plaintext.data()), plaintext.size(),
       reinterpret_cast<const uint8_t*>(additional_data.data()),
       additional_data.size());
   if (ret != 1) {
     return util::Status(util::error::INTERNAL, "EVP_AEAD_CTX_seal failed");
   }
-  written += out_len;
 
   // Verify that all the expected data has been written.
-  if (written != ciphertext_size) {
+  if (out_len != ciphertext_size - kNonceSize) {
     return util::Status(util::error::INTERNAL, "Incorrect ciphertext size");
   }
   return ct;
 }
 
+util::StatusOr<size_t> XChacha20Poly1305BoringSsl::EncryptInto(
+    absl::string_view plaintext, absl::string_view additional_data,
+    absl::Span<char> out) const {
+  plaintext = SubtleUtilBoringSSL::EnsureNonNull(plaintext);
+  additional_data = SubtleUtilBoringSSL::EnsureNonNull(additional_data);
+
+  if (out.size() < kNonceSize + plaintext.size() + kTagSize) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "Output buffer too small");
+  }
+  // Writing the nonce into 'out' does not clobber the plaintext in the
+  // supported in-place layout, where the plaintext starts at
+  // out.data() + kNonceSize.
+  Random::GetRandomBytes(out.subspan(0, kNonceSize));
+  size_t out_len = 0;
+  int ret = EVP_AEAD_CTX_seal(
+      ctx_.get(), reinterpret_cast<uint8_t*>(out.data() + kNonceSize),
+      &out_len, plaintext.size() + kTagSize,
+      reinterpret_cast<const uint8_t*>(out.data()), kNonceSize,
+      reinterpret_cast<const uint8_t*>(plaintext.data()), plaintext.size(),
+      reinterpret_cast<const uint8_t*>(additional_data.data()),
+      additional_data.size());
+  if (ret != 1) {
+    return util::Status(util::error::INTERNAL, "EVP_AEAD_CTX_seal failed");
+  }
+  return kNonceSize + out_len;
+}
+
 util::StatusOr<std::string> XChacha20Poly1305BoringSsl::Decrypt(
     absl::string_view ciphertext, absl::string_view additional_data) const {
   // BoringSSL expects a non-null pointer for additional_data,
@@ -116,14 +140,6 @@ util::StatusOr<std::string> XChacha20Poly1305BoringSsl::Decrypt(
     return util::Status(util::error::INVALID_ARGUMENT, "Ciphertext too short");
   }
 
-  bssl::UniquePtr<EVP_AEAD_CTX> ctx(
-      EVP_AEAD_CTX_new(aead_, reinterpret_cast<const uint8_t*>(key_.data()),
-                       key_.size(), kTagSize));
-  if (ctx.get() == nullptr) {
-    return util::Status(util::error::INTERNAL,
-                        "could not initialize EVP_AEAD_CTX");
-  }
-
   std::string out;
   size_t out_size = ciphertext.size() - kNonceSize - kTagSize;
   ResizeStringUninitialized(&out, out_size);
@@ -133,8 +149,9 @@ util::StatusOr<std::string> XChacha20Poly1305BoringSsl::Decrypt(
       ciphertext.substr(kNonceSize, out_size + kTagSize);
 
   size_t len = 0;
+  ErrorQueueMark error_queue_mark;
   int ret = EVP_AEAD_CTX_open(
-      ctx.get(), reinterpret_cast<uint8_t*>(&out[0]), &len, out_size,
+      ctx_.get(), reinterpret_cast<uint8_t*>(&out[0]), &len, out_size,
       reinterpret_cast<const uint8_t*>(nonce.data()), nonce.size(),
       reinterpret_cast<const uint8_t*>(encrypted.data()), encrypted.size(),
       reinterpret_cast<const uint8_t*>(additional_data.data()),
@@ -21,7 +21,8 @@
 #include <utility>
 
 #include "absl/strings/string_view.h"
-#include "openssl/base.h"
+#include "absl/types/span.h"
+#include "openssl/aead.h"
 #include "tink/aead.h"
 #include "tink/internal/fips_utils.h"
 #include "tink/util/secret_data.h"
@@ -32,6 +33,12 @@ namespace crypto {
 namespace tink {
 namespace subtle {
 
+// An Aead cipher for XChacha20-Poly1305. The cipher runs entirely in
+// software; BoringSSL dispatches its ChaCha20 and Poly1305 kernels at
+// runtime to the widest vector unit the CPU offers (AVX2 on x86_64, NEON
+// on ARM), which makes it the template of choice for fleets without AES
+// hardware. The EVP_AEAD context is set up once per instance, so the
+// per-operation cost is the seal/open call itself.
 class XChacha20Poly1305BoringSsl : public Aead {
  public:
   // Constructs a new Aead cipher for XChacha20-Poly1305.
@@ -49,6 +56,18 @@ class XChacha20Poly1305BoringSsl : public Aead {
       absl::string_view ciphertext,
       absl::string_view additional_data) const override;
 
+  size_t MaxEncryptionSize(size_t plaintext_size) const override {
+    return kNonceSize + plaintext_size + kTagSize;
+  }
+
+  // Writes nonce, ciphertext and tag directly into 'out' without
+  // intermediate allocations. Supports in-place encryption: 'plaintext' may
+  // overlap 'out' if plaintext.data() == out.data() + kNonceSize, i.e. if
+  // the plaintext already sits where the ciphertext will be written.
+  crypto::tink::util::StatusOr<size_t> EncryptInto(
+      absl::string_view plaintext, absl::string_view additional_data,
+      absl::Span<char> out) const override;
+
   static constexpr crypto::tink::internal::FipsCompatibility kFipsStatus =
       crypto::tink::internal::FipsCompatibility::kNotFips;
 
@@ -57,11 +76,10 @@ class XChacha20Poly1305BoringSsl : public Aead {
   static constexpr int kNonceSize = 24;
   static constexpr int kTagSize = 16;
 
-  XChacha20Poly1305BoringSsl(util::SecretData key, const EVP_AEAD* aead)
-      : key_(std::move(key)), aead_(aead) {}
+  explicit XChacha20Poly1305BoringSsl(bssl::UniquePtr<EVP_AEAD_CTX> ctx)
+      : ctx_(std::move(ctx)) {}
 
-  const util::SecretData key_;
-  const EVP_AEAD* const aead_;
+  const bssl::UniquePtr<EVP_AEAD_CTX> ctx_;
 };
 
 }  // namespace subtle
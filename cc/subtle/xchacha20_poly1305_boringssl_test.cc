@@ -16,11 +16,13 @@
 
 #include "tink/subtle/xchacha20_poly1305_boringssl.h"
 
+#include <cstring>
 #include <string>
 #include <vector>
 
 #include "gtest/gtest.h"
 #include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
 #include "openssl/err.h"
 #include "tink/config/tink_fips.h"
 #include "tink/util/status.h"
@@ -56,6 +58,46 @@ TEST(XChacha20Poly1305BoringSslTest, TestBasic) {
   EXPECT_EQ(pt.ValueOrDie(), message);
 }
 
+TEST(XChacha20Poly1305BoringSslTest, EncryptInto) {
+  if (IsFipsModeEnabled()) {
+    GTEST_SKIP() << "Not supported in FIPS-only mode";
+  }
+
+  util::SecretData key = util::SecretDataFromStringView(test::HexDecodeOrDie(
+      "000102030405060708090a0b0c0d0e0f000102030405060708090a0b0c0d0e0f"));
+  auto cipher = std::move(XChacha20Poly1305BoringSsl::New(key).ValueOrDie());
+  std::string message = "Some data to encrypt.";
+  std::string aad = "Some data to authenticate.";
+
+  std::string buffer;
+  buffer.resize(cipher->MaxEncryptionSize(message.size()));
+  EXPECT_EQ(buffer.size(), message.size() + 24 /* nonce */ + 16 /* tag */);
+  auto written = cipher->EncryptInto(
+      message, aad, absl::MakeSpan(&buffer[0], buffer.size()));
+  EXPECT_TRUE(written.ok()) << written.status();
+  EXPECT_EQ(written.ValueOrDie(), buffer.size());
+  auto pt = cipher->Decrypt(buffer, aad);
+  EXPECT_TRUE(pt.ok()) << pt.status();
+  EXPECT_EQ(pt.ValueOrDie(), message);
+
+  // A buffer that is too small is rejected.
+  auto too_small = cipher->EncryptInto(
+      message, aad, absl::MakeSpan(&buffer[0], message.size()));
+  EXPECT_THAT(too_small.status(), StatusIs(util::error::INVALID_ARGUMENT));
+
+  // In-place: the plaintext sits where the ciphertext will be written.
+  std::string in_place_buffer;
+  in_place_buffer.resize(cipher->MaxEncryptionSize(message.size()));
+  std::memcpy(&in_place_buffer[24], message.data(), message.size());
+  auto in_place_written = cipher->EncryptInto(
+      absl::string_view(in_place_buffer).substr(24, message.size()), aad,
+      absl::MakeSpan(&in_place_buffer[0], in_place_buffer.size()));
+  EXPECT_TRUE(in_place_written.ok()) << in_place_written.status();
+  auto in_place_pt = cipher->Decrypt(in_place_buffer, aad);
+  EXPECT_TRUE(in_place_pt.ok()) << in_place_pt.status();
+  EXPECT_EQ(in_place_pt.ValueOrDie(), message);
+}
+
 TEST(XChacha20Poly1305BoringSslTest, TestModification) {
   if (IsFipsModeEnabled()) {
     GTEST_SKIP() << "Not supported in FIPS-only mode";
@@ -37,6 +37,16 @@ def tink_cc_deps():
             sha256 = "54a139559cc46a68cf79e55d5c22dc9d48e647a66827342520ce0441402430fe",
         )
 
+    # Google Benchmark framework. Used by the microbenchmarks in //benchmarks.
+    if not native.existing_rule("com_github_google_benchmark"):
+        # Release from 2019-05-28
+        http_archive(
+            name = "com_github_google_benchmark",
+            strip_prefix = "benchmark-1.5.0",
+            url = "https://github.com/google/benchmark/archive/v1.5.0.tar.gz",
+            sha256 = "3c6a165b6ecc948967a1ead710d4a181d7b0fbcaa183ef7ea84604994966221a",
+        )
+
     if not native.existing_rule("rapidjson"):
         # Release from 2016-08-25; still the latest release on 2019-10-18
         http_archive(
@@ -0,0 +1,93 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/util/array_input_stream.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "absl/types/span.h"
+#include "tink/input_stream.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace util {
+
+ArrayInputStream::ArrayInputStream(absl::Span<const char> data,
+                                   int block_size) :
+    data_(data), block_size_(block_size) {
+  position_ = 0;
+  last_returned_size_ = 0;
+  count_backedup_ = 0;
+}
+
+crypto::tink::util::StatusOr<int> ArrayInputStream::Next(const void** data) {
+  if (count_backedup_ > 0) {  // Return the backed-up bytes.
+    *data = data_.data() + position_;
+    int count = count_backedup_;
+    position_ = position_ + count;
+    count_backedup_ = 0;
+    last_returned_size_ = count;
+    return count;
+  }
+  if (position_ >= static_cast<int64_t>(data_.size())) {
+    return Status(util::error::OUT_OF_RANGE, "EOF");
+  }
+  int64_t remaining = data_.size() - position_;
+  int64_t block = (block_size_ > 0 ?
+                   block_size_ : std::numeric_limits<int>::max());
+  int count = std::min(block, remaining);
+  *data = data_.data() + position_;
+  position_ = position_ + count;
+  last_returned_size_ = count;
+  return count;
+}
+
+void ArrayInputStream::BackUp(int count) {
+  if (count < 1 || count_backedup_ == last_returned_size_) return;
+  int actual_count = std::min(count, last_returned_size_ - count_backedup_);
+  count_backedup_ = count_backedup_ + actual_count;
+  position_ = position_ - actual_count;
+}
+
+crypto::tink::util::Status ArrayInputStream::ReadExact(absl::Span<char> out) {
+  int64_t remaining = data_.size() - position_;
+  if (static_cast<int64_t>(out.size()) > remaining) {
+    // Mirror the Next()-loop behavior: consume what is left, then fail.
+    std::memcpy(out.data(), data_.data() + position_, remaining);
+    position_ = data_.size();
+    last_returned_size_ = 0;
+    count_backedup_ = 0;
+    return Status(util::error::OUT_OF_RANGE, "EOF");
+  }
+  std::memcpy(out.data(), data_.data() + position_, out.size());
+  position_ = position_ + out.size();
+  // Bytes served by ReadExact() cannot be backed up.
+  last_returned_size_ = 0;
+  count_backedup_ = 0;
+  return util::OkStatus();
+}
+
+int64_t ArrayInputStream::Position() const {
+  return position_;
+}
+
+}  // namespace util
+}  // namespace tink
+}  // namespace crypto
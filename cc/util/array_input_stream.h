@@ -0,0 +1,65 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_UTIL_ARRAY_INPUT_STREAM_H_
+#define TINK_UTIL_ARRAY_INPUT_STREAM_H_
+
+#include "absl/types/span.h"
+#include "tink/input_stream.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace util {
+
+// An InputStream that reads directly from a caller-owned memory region,
+// without any buffering or copying: Next() hands out pointers into the
+// region itself. Useful when the entire input (e.g. a ciphertext) is
+// already in memory and the copies made by IstreamInputStream would be
+// pure overhead. The caller must ensure that the region outlives the
+// stream and all uses of the pointers returned by Next().
+class ArrayInputStream : public crypto::tink::InputStream {
+ public:
+  // Constructs an InputStream that will read from 'data', returning
+  // at most 'block_size' bytes per call to Next(), if a positive
+  // 'block_size' is given (otherwise all the remaining bytes are
+  // returned in one call).
+  explicit ArrayInputStream(absl::Span<const char> data, int block_size = -1);
+
+  crypto::tink::util::StatusOr<int> Next(const void** data) override;
+
+  void BackUp(int count) override;
+
+  // Serves the whole read with a single copy from the backing region,
+  // ignoring 'block_size'.
+  crypto::tink::util::Status ReadExact(absl::Span<char> out) override;
+
+  int64_t Position() const override;
+
+ private:
+  const absl::Span<const char> data_;
+  const int block_size_;
+  int64_t position_;       // # of bytes of data_ already consumed
+  int last_returned_size_;  // # of bytes returned by the last Next()
+  int count_backedup_;      // # of those bytes that were backed up
+};
+
+}  // namespace util
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_UTIL_ARRAY_INPUT_STREAM_H_
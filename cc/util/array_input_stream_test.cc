@@ -0,0 +1,183 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/util/array_input_stream.h"
+
+#include "gtest/gtest.h"
+#include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
+#include "tink/subtle/random.h"
+
+namespace crypto {
+namespace tink {
+namespace {
+
+// Reads the specified 'input_stream' until no more bytes can be read,
+// and puts the read bytes into 'contents'.
+// Returns the status of the last input_stream->Next()-operation.
+util::Status ReadTillEnd(util::ArrayInputStream* input_stream,
+                         std::string* contents) {
+  contents->clear();
+  const void* buffer;
+  auto next_result = input_stream->Next(&buffer);
+  while (next_result.ok()) {
+    contents->append(static_cast<const char*>(buffer),
+                     next_result.ValueOrDie());
+    next_result = input_stream->Next(&buffer);
+  }
+  return next_result.status();
+}
+
+class ArrayInputStreamTest : public ::testing::Test {
+};
+
+TEST_F(ArrayInputStreamTest, ReadingStreams) {
+  for (auto stream_size : {0, 10, 100, 1000, 10000, 100000}) {
+    for (auto block_size : {-1, 1, 10, 1234}) {
+      SCOPED_TRACE(absl::StrCat("stream_size = ", stream_size,
+                                " block_size = ", block_size));
+      std::string contents = subtle::Random::GetRandomBytes(stream_size);
+      auto input_stream = absl::make_unique<util::ArrayInputStream>(
+          absl::Span<const char>(contents.data(), contents.size()),
+          block_size);
+      std::string stream_contents;
+      auto status = ReadTillEnd(input_stream.get(), &stream_contents);
+      EXPECT_EQ(util::error::OUT_OF_RANGE, status.error_code());
+      EXPECT_EQ("EOF", status.error_message());
+      EXPECT_EQ(contents, stream_contents);
+      EXPECT_EQ(stream_size, input_stream->Position());
+    }
+  }
+}
+
+TEST_F(ArrayInputStreamTest, ZeroCopy) {
+  std::string contents = subtle::Random::GetRandomBytes(1000);
+  auto input_stream = absl::make_unique<util::ArrayInputStream>(
+      absl::Span<const char>(contents.data(), contents.size()));
+  const void* buffer;
+  auto next_result = input_stream->Next(&buffer);
+  EXPECT_TRUE(next_result.ok()) << next_result.status();
+  // The returned bytes are the caller's buffer itself, not a copy.
+  EXPECT_EQ(contents.data(), static_cast<const char*>(buffer));
+  EXPECT_EQ(contents.size(), next_result.ValueOrDie());
+}
+
+TEST_F(ArrayInputStreamTest, BackupAndPosition) {
+  int stream_size = 100000;
+  int block_size = 1234;
+  const void* buffer;
+  std::string contents = subtle::Random::GetRandomBytes(stream_size);
+
+  // Prepare the stream and do the first call to Next().
+  auto input_stream = absl::make_unique<util::ArrayInputStream>(
+      absl::Span<const char>(contents.data(), contents.size()), block_size);
+  EXPECT_EQ(0, input_stream->Position());
+  auto next_result = input_stream->Next(&buffer);
+  EXPECT_TRUE(next_result.ok()) << next_result.status();
+  EXPECT_EQ(block_size, next_result.ValueOrDie());
+  EXPECT_EQ(block_size, input_stream->Position());
+  EXPECT_EQ(contents.data(), static_cast<const char*>(buffer));
+
+  // BackUp several times, but in total fewer bytes than returned by Next().
+  int total_backup_size = 0;
+  for (auto backup_size : {0, 1, 5, 0, 10, 100, -42, 400, 20, -100}) {
+    SCOPED_TRACE(absl::StrCat("backup_size = ", backup_size));
+    input_stream->BackUp(backup_size);
+    total_backup_size += std::max(0, backup_size);
+    EXPECT_EQ(block_size - total_backup_size, input_stream->Position());
+  }
+  // Call Next(), it should return exactly the backed up bytes.
+  next_result = input_stream->Next(&buffer);
+  EXPECT_TRUE(next_result.ok()) << next_result.status();
+  EXPECT_EQ(total_backup_size, next_result.ValueOrDie());
+  EXPECT_EQ(block_size, input_stream->Position());
+  EXPECT_EQ(contents.data() + block_size - total_backup_size,
+            static_cast<const char*>(buffer));
+
+  // Call Next() again, it should return the second block.
+  next_result = input_stream->Next(&buffer);
+  EXPECT_TRUE(next_result.ok()) << next_result.status();
+  EXPECT_EQ(block_size, next_result.ValueOrDie());
+  EXPECT_EQ(2 * block_size, input_stream->Position());
+  EXPECT_EQ(contents.data() + block_size, static_cast<const char*>(buffer));
+
+  // BackUp a few times, with total over the returned block_size;
+  // the BackUps should be capped at the last returned count.
+  total_backup_size = 0;
+  for (auto backup_size :
+           {0, 72, -100, block_size / 2, 200, -25, block_size, 42}) {
+    SCOPED_TRACE(absl::StrCat("backup_size = ", backup_size));
+    input_stream->BackUp(backup_size);
+    total_backup_size = std::min(block_size,
+                                 total_backup_size + std::max(0, backup_size));
+    EXPECT_EQ(2 * block_size - total_backup_size, input_stream->Position());
+  }
+
+  // Call Next() again, it should return the second block again.
+  next_result = input_stream->Next(&buffer);
+  EXPECT_TRUE(next_result.ok()) << next_result.status();
+  EXPECT_EQ(block_size, next_result.ValueOrDie());
+  EXPECT_EQ(2 * block_size, input_stream->Position());
+  EXPECT_EQ(contents.data() + block_size, static_cast<const char*>(buffer));
+}
+
+TEST_F(ArrayInputStreamTest, ReadExact) {
+  std::string contents = subtle::Random::GetRandomBytes(1000);
+  auto input_stream = absl::make_unique<util::ArrayInputStream>(
+      absl::Span<const char>(contents.data(), contents.size()),
+      /* block_size = */ 13);
+
+  // The whole read is served in one call, regardless of block_size.
+  std::string buffer(100, '\0');
+  auto status = input_stream->ReadExact(absl::MakeSpan(&buffer[0], 100));
+  EXPECT_TRUE(status.ok()) << status;
+  EXPECT_EQ(contents.substr(0, 100), buffer);
+  EXPECT_EQ(100, input_stream->Position());
+
+  // Backed-up bytes are served first.
+  const void* data;
+  auto next_result = input_stream->Next(&data);
+  ASSERT_TRUE(next_result.ok()) << next_result.status();
+  EXPECT_EQ(13, next_result.ValueOrDie());
+  input_stream->BackUp(5);
+  std::string second(50, '\0');
+  status = input_stream->ReadExact(absl::MakeSpan(&second[0], 50));
+  EXPECT_TRUE(status.ok()) << status;
+  EXPECT_EQ(contents.substr(108, 50), second);
+  EXPECT_EQ(158, input_stream->Position());
+
+  // Reading past the end of the stream fails with OUT_OF_RANGE.
+  std::string rest(contents.size() - 158 + 1, '\0');
+  status = input_stream->ReadExact(absl::MakeSpan(&rest[0], rest.size()));
+  EXPECT_EQ(util::error::OUT_OF_RANGE, status.error_code());
+  EXPECT_EQ(contents.size(), input_stream->Position());
+}
+
+TEST_F(ArrayInputStreamTest, EmptyInput) {
+  std::string contents = "";
+  auto input_stream = absl::make_unique<util::ArrayInputStream>(
+      absl::Span<const char>(contents.data(), contents.size()));
+  const void* buffer;
+  auto next_result = input_stream->Next(&buffer);
+  EXPECT_EQ(util::error::OUT_OF_RANGE, next_result.status().error_code());
+  EXPECT_EQ("EOF", next_result.status().error_message());
+  EXPECT_EQ(0, input_stream->Position());
+}
+
+}  // namespace
+}  // namespace tink
+}  // namespace crypto
@@ -0,0 +1,89 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/util/array_output_stream.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "absl/types/span.h"
+#include "tink/output_stream.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace util {
+
+ArrayOutputStream::ArrayOutputStream(absl::Span<char> destination,
+                                     int block_size) :
+    destination_(destination), block_size_(block_size) {
+  position_ = 0;
+  last_returned_size_ = 0;
+  count_backedup_ = 0;
+  status_ = Status::OK;
+}
+
+crypto::tink::util::StatusOr<int> ArrayOutputStream::Next(void** data) {
+  if (!status_.ok()) return status_;
+  if (count_backedup_ > 0) {  // Return the backed-up bytes.
+    *data = destination_.data() + position_;
+    int count = count_backedup_;
+    position_ = position_ + count;
+    count_backedup_ = 0;
+    last_returned_size_ = count;
+    return count;
+  }
+  if (position_ >= static_cast<int64_t>(destination_.size())) {
+    return Status(util::error::OUT_OF_RANGE, "destination buffer exhausted");
+  }
+  int64_t remaining = destination_.size() - position_;
+  int64_t block = (block_size_ > 0 ?
+                   block_size_ : std::numeric_limits<int>::max());
+  int count = std::min(block, remaining);
+  *data = destination_.data() + position_;
+  position_ = position_ + count;
+  last_returned_size_ = count;
+  return count;
+}
+
+void ArrayOutputStream::BackUp(int count) {
+  if (!status_.ok() || count < 1 ||
+      count_backedup_ == last_returned_size_) {
+    return;
+  }
+  int actual_count = std::min(count, last_returned_size_ - count_backedup_);
+  count_backedup_ = count_backedup_ + actual_count;
+  position_ = position_ - actual_count;
+}
+
+ArrayOutputStream::~ArrayOutputStream() {
+  Close().IgnoreError();
+}
+
+Status ArrayOutputStream::Close() {
+  if (!status_.ok()) return status_;
+  status_ = Status(util::error::FAILED_PRECONDITION, "Stream closed");
+  return Status::OK;
+}
+
+int64_t ArrayOutputStream::Position() const {
+  return position_;
+}
+
+}  // namespace util
+}  // namespace tink
+}  // namespace crypto
@@ -0,0 +1,69 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_UTIL_ARRAY_OUTPUT_STREAM_H_
+#define TINK_UTIL_ARRAY_OUTPUT_STREAM_H_
+
+#include "absl/types/span.h"
+#include "tink/output_stream.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace util {
+
+// An OutputStream that writes directly to a caller-owned memory region,
+// without any buffering or copying: Next() hands out pointers into the
+// region itself. Useful when the output (e.g. a ciphertext of known
+// maximal size) should end up in caller-provided memory and the copies
+// made by OstreamOutputStream would be pure overhead. Once the region is
+// exhausted, Next() returns OUT_OF_RANGE. After Close(), Position()
+// gives the total number of bytes written. The caller must ensure that
+// the region outlives the stream.
+class ArrayOutputStream : public crypto::tink::OutputStream {
+ public:
+  // Constructs an OutputStream that will write to 'destination',
+  // handing out at most 'block_size' bytes of it per call to Next(),
+  // if a positive 'block_size' is given (otherwise all the remaining
+  // bytes are handed out in one call).
+  explicit ArrayOutputStream(absl::Span<char> destination,
+                             int block_size = -1);
+
+  ~ArrayOutputStream() override;
+
+  crypto::tink::util::StatusOr<int> Next(void** data) override;
+
+  void BackUp(int count) override;
+
+  crypto::tink::util::Status Close() override;
+
+  int64_t Position() const override;
+
+ private:
+  util::Status status_;
+  const absl::Span<char> destination_;
+  const int block_size_;
+  int64_t position_;       // # of bytes of destination_ already written
+  int last_returned_size_;  // # of bytes returned by the last Next()
+  int count_backedup_;      // # of those bytes that were backed up
+};
+
+}  // namespace util
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_UTIL_ARRAY_OUTPUT_STREAM_H_
@@ -0,0 +1,158 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/util/array_output_stream.h"
+
+#include "gtest/gtest.h"
+#include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "tink/subtle/random.h"
+
+namespace crypto {
+namespace tink {
+namespace {
+
+// Writes 'contents' to the specified 'output_stream', and closes the stream.
+// Returns the status of output_stream->Close()-operation, or a non-OK status
+// of a prior output_stream->Next()-operation, if any.
+util::Status WriteToStream(util::ArrayOutputStream* output_stream,
+                           absl::string_view contents) {
+  void* buffer;
+  int pos = 0;
+  int remaining = contents.length();
+  int available_space = 0;
+  int available_bytes = 0;
+  while (remaining > 0) {
+    auto next_result = output_stream->Next(&buffer);
+    if (!next_result.ok()) return next_result.status();
+    available_space = next_result.ValueOrDie();
+    available_bytes = std::min(available_space, remaining);
+    memcpy(buffer, contents.data() + pos, available_bytes);
+    remaining -= available_bytes;
+    pos += available_bytes;
+  }
+  if (available_space > available_bytes) {
+    output_stream->BackUp(available_space - available_bytes);
+  }
+  return output_stream->Close();
+}
+
+class ArrayOutputStreamTest : public ::testing::Test {
+};
+
+TEST_F(ArrayOutputStreamTest, WritingStreams) {
+  for (auto stream_size : {0, 10, 100, 1000, 10000, 100000}) {
+    for (auto block_size : {-1, 1, 10, 1234}) {
+      SCOPED_TRACE(absl::StrCat("stream_size = ", stream_size,
+                                " block_size = ", block_size));
+      std::string stream_contents = subtle::Random::GetRandomBytes(stream_size);
+      std::string destination(stream_size, 0);
+      auto output_stream = absl::make_unique<util::ArrayOutputStream>(
+          absl::Span<char>(&destination[0], destination.size()), block_size);
+      auto status = WriteToStream(output_stream.get(), stream_contents);
+      EXPECT_TRUE(status.ok()) << status;
+      EXPECT_EQ(stream_size, output_stream->Position());
+      EXPECT_EQ(stream_contents, destination);
+    }
+  }
+}
+
+TEST_F(ArrayOutputStreamTest, ZeroCopy) {
+  std::string destination(1000, 0);
+  auto output_stream = absl::make_unique<util::ArrayOutputStream>(
+      absl::Span<char>(&destination[0], destination.size()));
+  void* buffer;
+  auto next_result = output_stream->Next(&buffer);
+  EXPECT_TRUE(next_result.ok()) << next_result.status();
+  // The returned space is the caller's buffer itself, not a copy.
+  EXPECT_EQ(&destination[0], static_cast<char*>(buffer));
+  EXPECT_EQ(destination.size(), next_result.ValueOrDie());
+}
+
+TEST_F(ArrayOutputStreamTest, DestinationExhausted) {
+  int destination_size = 1000;
+  std::string stream_contents =
+      subtle::Random::GetRandomBytes(destination_size + 1);
+  std::string destination(destination_size, 0);
+  auto output_stream = absl::make_unique<util::ArrayOutputStream>(
+      absl::Span<char>(&destination[0], destination.size()));
+  auto status = WriteToStream(output_stream.get(), stream_contents);
+  EXPECT_EQ(util::error::OUT_OF_RANGE, status.error_code());
+  // The prefix that fits has been written.
+  EXPECT_EQ(stream_contents.substr(0, destination_size), destination);
+}
+
+TEST_F(ArrayOutputStreamTest, BackupAndPosition) {
+  int stream_size = 100000;
+  int block_size = 1234;
+  void* buffer;
+  std::string stream_contents = subtle::Random::GetRandomBytes(stream_size);
+  std::string destination(stream_size, 0);
+
+  // Prepare the stream and do the first call to Next().
+  auto output_stream = absl::make_unique<util::ArrayOutputStream>(
+      absl::Span<char>(&destination[0], destination.size()), block_size);
+  EXPECT_EQ(0, output_stream->Position());
+  auto next_result = output_stream->Next(&buffer);
+  EXPECT_TRUE(next_result.ok()) << next_result.status();
+  EXPECT_EQ(block_size, next_result.ValueOrDie());
+  EXPECT_EQ(block_size, output_stream->Position());
+  EXPECT_EQ(&destination[0], static_cast<char*>(buffer));
+  std::memcpy(buffer, stream_contents.data(), block_size);
+
+  // BackUp several times, but in total fewer bytes than returned by Next().
+  int total_backup_size = 0;
+  for (auto backup_size : {0, 1, 5, 0, 10, 100, -42, 400, 20, -100}) {
+    SCOPED_TRACE(absl::StrCat("backup_size = ", backup_size));
+    output_stream->BackUp(backup_size);
+    total_backup_size += std::max(0, backup_size);
+    EXPECT_EQ(block_size - total_backup_size, output_stream->Position());
+  }
+  EXPECT_LT(total_backup_size, block_size);
+
+  // Call Next(), it should return exactly the backed up bytes.
+  next_result = output_stream->Next(&buffer);
+  EXPECT_TRUE(next_result.ok()) << next_result.status();
+  EXPECT_EQ(total_backup_size, next_result.ValueOrDie());
+  EXPECT_EQ(block_size, output_stream->Position());
+  EXPECT_EQ(&destination[0] + block_size - total_backup_size,
+            static_cast<char*>(buffer));
+  std::memcpy(buffer, stream_contents.data() + block_size - total_backup_size,
+              total_backup_size);
+
+  // Write the remaining stream contents, and close the stream.
+  auto status = WriteToStream(
+      output_stream.get(), stream_contents.substr(block_size));
+  EXPECT_TRUE(status.ok()) << status;
+  EXPECT_EQ(stream_contents, destination);
+}
+
+TEST_F(ArrayOutputStreamTest, NextAfterClose) {
+  std::string destination(100, 0);
+  auto output_stream = absl::make_unique<util::ArrayOutputStream>(
+      absl::Span<char>(&destination[0], destination.size()));
+  EXPECT_TRUE(output_stream->Close().ok());
+  void* buffer;
+  auto next_result = output_stream->Next(&buffer);
+  EXPECT_EQ(util::error::FAILED_PRECONDITION,
+            next_result.status().error_code());
+}
+
+}  // namespace
+}  // namespace tink
+}  // namespace crypto
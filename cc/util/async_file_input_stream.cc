@@ -0,0 +1,165 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/util/async_file_input_stream.h"
+
+#include <unistd.h>
+#include <algorithm>
+
+#include "absl/memory/memory.h"
+#include "tink/input_stream.h"
+#include "tink/util/errors.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace util {
+
+namespace {
+
+// Attempts to close file descriptor fd, while ignoring EINTR.
+// (code borrowed from ZeroCopy-streams)
+int close_ignoring_eintr(int fd) {
+  int result;
+  do {
+    result = close(fd);
+  } while (result < 0 && errno == EINTR);
+  return result;
+}
+
+
+// Attempts to read 'count' bytes of data data from file descriptor fd
+// to 'buf' while ignoring EINTR.
+int read_ignoring_eintr(int fd, void *buf, size_t count) {
+  int result;
+  do {
+    result = read(fd, buf, count);
+  } while (result < 0 && errno == EINTR);
+  return result;
+}
+
+}  // anonymous namespace
+
+AsyncFileInputStream::AsyncFileInputStream(int file_descriptor,
+                                           int buffer_size) :
+    buffer_size_(buffer_size > 0 ? buffer_size : 128 * 1024) {  // 128 KB
+  fd_ = file_descriptor;
+  count_in_buffer_ = 0;
+  count_backedup_ = 0;
+  position_ = 0;
+  buffer_ = absl::make_unique<uint8_t[]>(buffer_size_);
+  next_buffer_ = absl::make_unique<uint8_t[]>(buffer_size_);
+  buffer_offset_ = 0;
+  status_ = Status::OK;
+  {
+    absl::MutexLock lock(&mu_);
+    next_count_ = 0;
+    next_status_ = Status::OK;
+    fetch_requested_ = true;  // start fetching the first buffer right away
+    next_ready_ = false;
+    shutting_down_ = false;
+  }
+  fetcher_ = std::thread([this]() { FetcherLoop(); });
+}
+
+bool AsyncFileInputStream::FetcherHasWork() const {
+  return fetch_requested_ || shutting_down_;
+}
+
+bool AsyncFileInputStream::FetchDone() const {
+  return next_ready_;
+}
+
+void AsyncFileInputStream::FetcherLoop() {
+  while (true) {
+    {
+      absl::MutexLock lock(&mu_);
+      mu_.Await(absl::Condition(this, &AsyncFileInputStream::FetcherHasWork));
+      if (shutting_down_) return;
+    }
+    int read_result = read_ignoring_eintr(fd_, next_buffer_.get(),
+                                          buffer_size_);
+    absl::MutexLock lock(&mu_);
+    if (read_result <= 0) {  // EOF or an I/O error.
+      if (read_result == 0) {
+        next_status_ = Status(util::error::OUT_OF_RANGE, "EOF");
+      } else {
+        next_status_ =
+            ToStatusF(util::error::INTERNAL, "I/O error: %d", read_result);
+      }
+    } else {
+      next_count_ = read_result;
+      next_status_ = Status::OK;
+    }
+    fetch_requested_ = false;
+    next_ready_ = true;
+  }
+}
+
+crypto::tink::util::StatusOr<int> AsyncFileInputStream::Next(
+    const void** data) {
+  if (!status_.ok()) return status_;
+  if (count_backedup_ > 0) {  // Return the backed-up bytes.
+    buffer_offset_ = buffer_offset_ + (count_in_buffer_ - count_backedup_);
+    count_in_buffer_ = count_backedup_;
+    count_backedup_ = 0;
+    *data = buffer_.get() + buffer_offset_;
+    position_ = position_ + count_in_buffer_;
+    return count_in_buffer_;
+  }
+  // Wait for the prefetched buffer and swap it in.
+  absl::MutexLock lock(&mu_);
+  mu_.Await(absl::Condition(this, &AsyncFileInputStream::FetchDone));
+  if (!next_status_.ok()) {  // EOF or an I/O error.
+    status_ = next_status_;
+    return status_;
+  }
+  buffer_.swap(next_buffer_);
+  buffer_offset_ = 0;
+  count_backedup_ = 0;
+  count_in_buffer_ = next_count_;
+  position_ = position_ + count_in_buffer_;
+  *data = buffer_.get();
+  // Start fetching the next buffer in the background.
+  next_ready_ = false;
+  fetch_requested_ = true;
+  return count_in_buffer_;
+}
+
+void AsyncFileInputStream::BackUp(int count) {
+  if (!status_.ok() || count < 1 || count_backedup_ == count_in_buffer_) return;
+  int actual_count = std::min(count, count_in_buffer_ - count_backedup_);
+  count_backedup_ = count_backedup_ + actual_count;
+  position_ = position_ - actual_count;
+}
+
+AsyncFileInputStream::~AsyncFileInputStream() {
+  {
+    absl::MutexLock lock(&mu_);
+    shutting_down_ = true;
+  }
+  if (fetcher_.joinable()) fetcher_.join();
+  close_ignoring_eintr(fd_);
+}
+
+int64_t AsyncFileInputStream::Position() const {
+  return position_;
+}
+
+}  // namespace util
+}  // namespace tink
+}  // namespace crypto
@@ -0,0 +1,89 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_UTIL_ASYNC_FILE_INPUT_STREAM_H_
+#define TINK_UTIL_ASYNC_FILE_INPUT_STREAM_H_
+
+#include <memory>
+#include <thread>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "tink/input_stream.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace util {
+
+// An InputStream that reads from a file descriptor, and prefetches the
+// next buffer on a background thread while the caller processes the
+// current one. This overlaps file I/O with whatever work is done on the
+// returned bytes (e.g. segment decryption in streaming AEAD), instead of
+// stalling on a blocking read() per buffer refill as FileInputStream does.
+// Can be plugged in anywhere an InputStream is accepted.
+class AsyncFileInputStream : public crypto::tink::InputStream {
+ public:
+  // Constructs an InputStream that will read from the file specified
+  // via 'file_descriptor', using a buffer of the specified size, if any
+  // (if no legal 'buffer_size' is given, a reasonable default will be used).
+  // Takes the ownership of the file, and will close it upon destruction.
+  explicit AsyncFileInputStream(int file_descriptor, int buffer_size = -1);
+
+  ~AsyncFileInputStream() override;
+
+  crypto::tink::util::StatusOr<int> Next(const void** data) override;
+
+  void BackUp(int count) override;
+
+  int64_t Position() const override;
+
+ private:
+  void FetcherLoop();
+  // Predicates for mu_.Await(); require mu_ to be held.
+  bool FetcherHasWork() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  bool FetchDone() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  util::Status status_;
+  int fd_;
+  const int buffer_size_;
+  std::unique_ptr<uint8_t[]> buffer_;  // buffer being consumed by the caller
+  int64_t position_;     // current position in the file (from the beginning)
+
+  // Counters that describe the state of the data in buffer_.
+  int count_in_buffer_;  // # of bytes available in buffer_
+  int count_backedup_;   // # of bytes available in buffer_ that were backed up
+  int buffer_offset_;    // offset at which the returned bytes start in buffer_
+
+  // Prefetch state shared with the fetcher thread. While fetch_requested_
+  // is set the fetcher thread owns next_buffer_ and fills it without
+  // holding mu_; the caller touches next_buffer_ only once next_ready_.
+  mutable absl::Mutex mu_;
+  std::unique_ptr<uint8_t[]> next_buffer_;
+  int next_count_ ABSL_GUARDED_BY(mu_);  // # of bytes read into next_buffer_
+  util::Status next_status_ ABSL_GUARDED_BY(mu_);  // status of the last fetch
+  bool fetch_requested_ ABSL_GUARDED_BY(mu_);
+  bool next_ready_ ABSL_GUARDED_BY(mu_);
+  bool shutting_down_ ABSL_GUARDED_BY(mu_);
+  std::thread fetcher_;
+};
+
+}  // namespace util
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_UTIL_ASYNC_FILE_INPUT_STREAM_H_
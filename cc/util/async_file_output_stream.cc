@@ -0,0 +1,218 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/util/async_file_output_stream.h"
+
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+
+#include "absl/memory/memory.h"
+#include "tink/output_stream.h"
+#include "tink/util/errors.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace util {
+
+namespace {
+
+// Attempts to close file descriptor fd, while ignoring EINTR.
+// (code borrowed from ZeroCopy-streams)
+int close_ignoring_eintr(int fd) {
+  int result;
+  do {
+    result = close(fd);
+  } while (result < 0 && errno == EINTR);
+  return result;
+}
+
+
+// Attempts to write 'count' bytes of data data from 'buf'
+// to file descriptor fd, while ignoring EINTR.
+int write_ignoring_eintr(int fd, const void *buf, size_t count) {
+  int result;
+  do {
+    result = write(fd, buf, count);
+  } while (result < 0 && errno == EINTR);
+  return result;
+}
+
+// Writes all 'count' bytes from 'buf' to file descriptor fd.
+util::Status write_all(int fd, const uint8_t* buf, int count) {
+  int total_written = 0;
+  while (total_written < count) {
+    int write_result = write_ignoring_eintr(
+        fd, buf + total_written, count - total_written);
+    if (write_result < 0) {  // An I/O error occurred.
+      return ToStatusF(
+          util::error::INTERNAL, "I/O error upon write: %d", errno);
+    } else if (write_result == 0) {  // No progress, hence abort.
+      return ToStatusF(util::error::INTERNAL,
+          "I/O error: failed to write %d bytes.", count - total_written);
+    }
+    // Managed to write some bytes, hence continue.
+    total_written += write_result;
+  }
+  return Status::OK;
+}
+
+}  // anonymous namespace
+
+
+AsyncFileOutputStream::AsyncFileOutputStream(int file_descriptor,
+                                             int buffer_size) :
+    buffer_size_(buffer_size > 0 ? buffer_size : 128 * 1024) {  // 128 KB
+  fd_ = file_descriptor;
+  count_in_buffer_ = 0;
+  count_backedup_ = 0;
+  buffer_ = nullptr;
+  position_ = 0;
+  buffer_offset_ = 0;
+  status_ = Status::OK;
+  write_buffer_ = absl::make_unique<uint8_t[]>(buffer_size_);
+  {
+    absl::MutexLock lock(&mu_);
+    write_count_ = 0;
+    write_status_ = Status::OK;
+    write_pending_ = false;
+    shutting_down_ = false;
+  }
+  writer_ = std::thread([this]() { WriterLoop(); });
+}
+
+bool AsyncFileOutputStream::WriterHasWork() const {
+  return write_pending_ || shutting_down_;
+}
+
+bool AsyncFileOutputStream::WriteDone() const {
+  return !write_pending_;
+}
+
+void AsyncFileOutputStream::WriterLoop() {
+  while (true) {
+    int count;
+    {
+      absl::MutexLock lock(&mu_);
+      mu_.Await(absl::Condition(this, &AsyncFileOutputStream::WriterHasWork));
+      if (shutting_down_) return;
+      count = write_count_;
+    }
+    auto status = write_all(fd_, write_buffer_.get(), count);
+    absl::MutexLock lock(&mu_);
+    if (!status.ok() && write_status_.ok()) write_status_ = status;
+    write_pending_ = false;
+  }
+}
+
+void AsyncFileOutputStream::ShutDownWriter() {
+  {
+    absl::MutexLock lock(&mu_);
+    shutting_down_ = true;
+  }
+  if (writer_.joinable()) writer_.join();
+}
+
+crypto::tink::util::StatusOr<int> AsyncFileOutputStream::Next(void** data) {
+  if (!status_.ok()) return status_;
+
+  if (buffer_ == nullptr) {  // possible only at the first call to Next()
+    buffer_ = absl::make_unique<uint8_t[]>(buffer_size_);
+    *data = buffer_.get();
+    count_in_buffer_ = buffer_size_;
+    position_ = buffer_size_;
+    return buffer_size_;
+  }
+
+  // If some space was backed up, return it first.
+  if (count_backedup_ > 0) {
+    position_ = position_ + count_backedup_;
+    buffer_offset_ = count_in_buffer_;
+    count_in_buffer_ = count_in_buffer_ + count_backedup_;
+    int backedup = count_backedup_;
+    count_backedup_ = 0;
+    *data = buffer_.get() + buffer_offset_;
+    return backedup;
+  }
+
+  // No space was backed up, so count_in_buffer_ == buffer_size_ holds here.
+  // Hand the full buffer to the writer thread (waiting until it is done
+  // with the previous one), and return the other buffer to the caller.
+  absl::MutexLock lock(&mu_);
+  mu_.Await(absl::Condition(this, &AsyncFileOutputStream::WriteDone));
+  if (!write_status_.ok()) {  // An earlier write failed.
+    status_ = write_status_;
+    return status_;
+  }
+  buffer_.swap(write_buffer_);
+  write_count_ = buffer_size_;
+  write_pending_ = true;
+  position_ = position_ + buffer_size_;
+  count_in_buffer_ = buffer_size_;
+  count_backedup_ = 0;
+  buffer_offset_ = 0;
+  *data = buffer_.get();
+  return buffer_size_;
+}
+
+void AsyncFileOutputStream::BackUp(int count) {
+  if (!status_.ok() || count < 1 || count_in_buffer_ == 0) return;
+  int curr_buffer_size = buffer_size_ - buffer_offset_;
+  int actual_count = std::min(count, curr_buffer_size - count_backedup_);
+  count_backedup_ += actual_count;
+  count_in_buffer_ -= actual_count;
+  position_ -= actual_count;
+}
+
+AsyncFileOutputStream::~AsyncFileOutputStream() {
+  Close().IgnoreError();
+  ShutDownWriter();
+}
+
+Status AsyncFileOutputStream::Close() {
+  if (!status_.ok()) return status_;
+  {  // Wait for a pending write, and check its outcome.
+    absl::MutexLock lock(&mu_);
+    mu_.Await(absl::Condition(this, &AsyncFileOutputStream::WriteDone));
+    if (!write_status_.ok()) {
+      status_ = write_status_;
+      return status_;
+    }
+  }
+  if (count_in_buffer_ > 0) {
+    // Write the remaining bytes.
+    status_ = write_all(fd_, buffer_.get(), count_in_buffer_);
+    if (!status_.ok()) return status_;
+  }
+  ShutDownWriter();
+  if (close_ignoring_eintr(fd_) == -1) {
+    status_ = ToStatusF(
+        util::error::INTERNAL, "I/O error upon close: %d", errno);
+    return status_;
+  }
+  status_ = Status(util::error::FAILED_PRECONDITION, "Stream closed");
+  return Status::OK;
+}
+
+int64_t AsyncFileOutputStream::Position() const {
+  return position_;
+}
+
+}  // namespace util
+}  // namespace tink
+}  // namespace crypto
@@ -0,0 +1,94 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_UTIL_ASYNC_FILE_OUTPUT_STREAM_H_
+#define TINK_UTIL_ASYNC_FILE_OUTPUT_STREAM_H_
+
+#include <memory>
+#include <thread>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "tink/output_stream.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace util {
+
+// An OutputStream that writes to a file descriptor, flushing full buffers
+// on a background thread while the caller fills the next one. This
+// overlaps file I/O with whatever work produces the bytes (e.g. segment
+// encryption in streaming AEAD), instead of stalling on a blocking
+// write() per flush as FileOutputStream does. Can be plugged in anywhere
+// an OutputStream is accepted.
+class AsyncFileOutputStream : public crypto::tink::OutputStream {
+ public:
+  // Constructs an OutputStream that will write to the file specified
+  // via 'file_descriptor', using a buffer of the specified size, if any
+  // (if no legal 'buffer_size' is given, a reasonable default will be used).
+  // Takes the ownership of the file, and will close it upon destruction.
+  explicit AsyncFileOutputStream(int file_descriptor, int buffer_size = -1);
+
+  ~AsyncFileOutputStream() override;
+
+  crypto::tink::util::StatusOr<int> Next(void** data) override;
+
+  void BackUp(int count) override;
+
+  crypto::tink::util::Status Close() override;
+
+  int64_t Position() const override;
+
+ private:
+  void WriterLoop();
+  // Joins the writer thread; may be called repeatedly.
+  void ShutDownWriter();
+  // Predicates for mu_.Await(); require mu_ to be held.
+  bool WriterHasWork() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  bool WriteDone() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  util::Status status_;
+  int fd_;
+  const int buffer_size_;
+  std::unique_ptr<uint8_t[]> buffer_;  // buffer being filled by the caller
+  int64_t position_;  // current position in the file (from the beginning)
+
+  // Counters that describe the state of the data in buffer_.
+  int count_in_buffer_;  // # of bytes in buffer_ that will be eventually
+                         // written to the file
+  int count_backedup_;   // # of bytes in buffer_ that were backed up
+  int buffer_offset_;    // offset where the returned *data-buffer starts
+                         // in buffer_
+
+  // Write state shared with the writer thread. While write_pending_ is
+  // set the writer thread owns write_buffer_ and writes it out without
+  // holding mu_; the caller touches write_buffer_ only once !write_pending_.
+  mutable absl::Mutex mu_;
+  std::unique_ptr<uint8_t[]> write_buffer_;
+  int write_count_ ABSL_GUARDED_BY(mu_);  // # of bytes to write
+  util::Status write_status_ ABSL_GUARDED_BY(mu_);  // of the last write
+  bool write_pending_ ABSL_GUARDED_BY(mu_);
+  bool shutting_down_ ABSL_GUARDED_BY(mu_);
+  std::thread writer_;
+};
+
+}  // namespace util
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_UTIL_ASYNC_FILE_OUTPUT_STREAM_H_
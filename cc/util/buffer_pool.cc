@@ -0,0 +1,110 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/util/buffer_pool.h"
+
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "absl/synchronization/mutex.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace util {
+
+// A Buffer whose memory block is owned by a BufferPool, and is returned
+// to the pool upon destruction of this Buffer.
+class PooledBuffer : public Buffer {
+ public:
+  // Constructs a new Buffer which uses the given 'mem_block' of
+  // 'allocated_size' bytes for the actual data, and returns it to 'pool'
+  // upon destruction. It is assumed that 'pool' and 'mem_block' are
+  // non-null, and that 'allocated_size' is positive.
+  PooledBuffer(BufferPool* pool, std::unique_ptr<char[]> mem_block,
+               int allocated_size)
+      : pool_(pool),
+        mem_block_(std::move(mem_block)),
+        allocated_size_(allocated_size),
+        size_(allocated_size) {}
+
+  char* const get_mem_block() const override { return mem_block_.get(); }
+
+  int allocated_size() const override { return allocated_size_; }
+
+  int size() const override { return size_; }
+
+  util::Status set_size(int new_size) override {
+    if (new_size < 0 || new_size > allocated_size_) {
+      return Status(crypto::tink::util::error::INVALID_ARGUMENT,
+                    "new_size must satisfy 0 <= new_size <= allocated_size()");
+    }
+    size_ = new_size;
+    return Status::OK;
+  }
+
+  ~PooledBuffer() override { pool_->Return(std::move(mem_block_)); }
+
+ private:
+  BufferPool* const pool_;
+  std::unique_ptr<char[]> mem_block_;
+  const int allocated_size_;
+  int size_;
+};
+
+// static
+StatusOr<std::unique_ptr<BufferPool>> BufferPool::New(int buffer_size,
+                                                      int max_pooled_buffers) {
+  if (buffer_size <= 0) {
+    return Status(crypto::tink::util::error::INVALID_ARGUMENT,
+                  "buffer_size must be positive");
+  }
+  if (max_pooled_buffers < 0) {
+    return Status(crypto::tink::util::error::INVALID_ARGUMENT,
+                  "max_pooled_buffers must be non-negative");
+  }
+  return {
+      absl::WrapUnique(new BufferPool(buffer_size, max_pooled_buffers))};
+}
+
+std::unique_ptr<Buffer> BufferPool::Rent() {
+  std::unique_ptr<char[]> mem_block;
+  {
+    absl::MutexLock lock(&mutex_);
+    if (!free_blocks_.empty()) {
+      mem_block = std::move(free_blocks_.back());
+      free_blocks_.pop_back();
+    }
+  }
+  if (mem_block == nullptr) {
+    mem_block = absl::make_unique<char[]>(buffer_size_);
+  }
+  return absl::make_unique<PooledBuffer>(this, std::move(mem_block),
+                                         buffer_size_);
+}
+
+void BufferPool::Return(std::unique_ptr<char[]> mem_block) {
+  absl::MutexLock lock(&mutex_);
+  if (static_cast<int>(free_blocks_.size()) < max_pooled_buffers_) {
+    free_blocks_.push_back(std::move(mem_block));
+  }
+  // Otherwise 'mem_block' is freed upon leaving this scope.
+}
+
+}  // namespace util
+}  // namespace tink
+}  // namespace crypto
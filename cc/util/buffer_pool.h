@@ -0,0 +1,77 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_UTIL_BUFFER_POOL_H_
+#define TINK_UTIL_BUFFER_POOL_H_
+
+#include <memory>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "tink/util/buffer.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace util {
+
+class PooledBuffer;
+
+// A thread-safe pool of reusable memory blocks of a fixed size, handed
+// out as Buffer-instances. When a rented Buffer is destroyed, its memory
+// block is returned to the pool and recycled by a subsequent Rent()-call,
+// so steady-state users (e.g. the per-segment ciphertext buffers of
+// streaming decryption) do not allocate and free a block per use.
+//
+// The pool must outlive all Buffers it has handed out.
+class BufferPool {
+ public:
+  // Creates a new BufferPool that hands out buffers of 'buffer_size' bytes,
+  // and retains at most 'max_pooled_buffers' returned memory blocks for
+  // reuse; blocks returned beyond that limit are freed.
+  static util::StatusOr<std::unique_ptr<BufferPool>> New(
+      int buffer_size, int max_pooled_buffers = 8);
+
+  // Returns a Buffer of allocated_size() equal to buffer_size(), backed
+  // by a recycled memory block if one is available, and by a newly
+  // allocated one otherwise. The contents of the buffer are unspecified.
+  std::unique_ptr<Buffer> Rent();
+
+  // Returns the size (in bytes) of the buffers handed out by this pool.
+  int buffer_size() const { return buffer_size_; }
+
+ private:
+  friend class PooledBuffer;
+
+  BufferPool(int buffer_size, int max_pooled_buffers)
+      : buffer_size_(buffer_size), max_pooled_buffers_(max_pooled_buffers) {}
+
+  // Returns 'mem_block' to the pool; called by rented Buffers upon their
+  // destruction.
+  void Return(std::unique_ptr<char[]> mem_block);
+
+  const int buffer_size_;
+  const int max_pooled_buffers_;
+  mutable absl::Mutex mutex_;
+  std::vector<std::unique_ptr<char[]>> free_blocks_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace util
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_UTIL_BUFFER_POOL_H_
@@ -0,0 +1,110 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/util/buffer_pool.h"
+
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
+#include "tink/subtle/random.h"
+#include "tink/util/status.h"
+#include "tink/util/test_matchers.h"
+
+namespace crypto {
+namespace tink {
+namespace util {
+namespace {
+
+using ::crypto::tink::test::IsOk;
+using ::crypto::tink::test::StatusIs;
+using testing::HasSubstr;
+
+TEST(BufferPoolTest, BasicFunctionality) {
+  for (auto buf_size : {1, 10, 100, 1000, 10000, 100000, 1000000}) {
+    SCOPED_TRACE(absl::StrCat("buf_size = ", buf_size));
+    auto pool_result = BufferPool::New(buf_size);
+    ASSERT_THAT(pool_result.status(), IsOk());
+    auto pool = std::move(pool_result.ValueOrDie());
+    EXPECT_EQ(buf_size, pool->buffer_size());
+    auto buf = pool->Rent();
+    EXPECT_EQ(buf_size, buf->size());
+    EXPECT_EQ(buf_size, buf->allocated_size());
+    auto data = subtle::Random::GetRandomBytes(buf_size);
+    std::memcpy(buf->get_mem_block(), data.data(), buf_size);
+    EXPECT_EQ(0, std::memcmp(data.data(), buf->get_mem_block(), buf_size));
+  }
+}
+
+TEST(BufferPoolTest, RecyclesReturnedBlocks) {
+  auto pool_result = BufferPool::New(1000);
+  ASSERT_THAT(pool_result.status(), IsOk());
+  auto pool = std::move(pool_result.ValueOrDie());
+  auto buf = pool->Rent();
+  char* mem_block = buf->get_mem_block();
+  ASSERT_THAT(buf->set_size(42), IsOk());
+  buf.reset();
+  // The returned block is recycled by the next Rent()-call, with the size
+  // of the resulting buffer reset to buffer_size().
+  auto recycled = pool->Rent();
+  EXPECT_EQ(mem_block, recycled->get_mem_block());
+  EXPECT_EQ(1000, recycled->size());
+  EXPECT_EQ(1000, recycled->allocated_size());
+}
+
+TEST(BufferPoolTest, OutstandingBuffersAreDistinct) {
+  auto pool_result = BufferPool::New(100);
+  ASSERT_THAT(pool_result.status(), IsOk());
+  auto pool = std::move(pool_result.ValueOrDie());
+  auto buf_1 = pool->Rent();
+  auto buf_2 = pool->Rent();
+  EXPECT_NE(buf_1->get_mem_block(), buf_2->get_mem_block());
+}
+
+TEST(BufferPoolTest, RetainsAtMostMaxPooledBuffers) {
+  auto pool_result = BufferPool::New(100, /* max_pooled_buffers = */ 1);
+  ASSERT_THAT(pool_result.status(), IsOk());
+  auto pool = std::move(pool_result.ValueOrDie());
+  auto buf_1 = pool->Rent();
+  auto buf_2 = pool->Rent();
+  char* mem_block_1 = buf_1->get_mem_block();
+  buf_1.reset();
+  buf_2.reset();  // Freed, as the pool retains at most one block.
+  // The single retained block is the one returned first.
+  auto recycled = pool->Rent();
+  EXPECT_EQ(mem_block_1, recycled->get_mem_block());
+}
+
+TEST(BufferPoolTest, BadBufferSizes) {
+  for (auto buf_size : {-10, -1, 0}) {
+    SCOPED_TRACE(absl::StrCat("buf_size = ", buf_size));
+    auto pool_result = BufferPool::New(buf_size);
+    EXPECT_THAT(pool_result.status(),
+                StatusIs(util::error::INVALID_ARGUMENT,
+                         HasSubstr("buffer_size must be positive")));
+  }
+  auto pool_result = BufferPool::New(42, /* max_pooled_buffers = */ -1);
+  EXPECT_THAT(pool_result.status(),
+              StatusIs(util::error::INVALID_ARGUMENT,
+                       HasSubstr("max_pooled_buffers must be non-negative")));
+}
+
+}  // namespace
+}  // namespace util
+}  // namespace tink
+}  // namespace crypto
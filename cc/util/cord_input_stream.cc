@@ -0,0 +1,76 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/util/cord_input_stream.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "absl/strings/cord.h"
+#include "absl/strings/string_view.h"
+#include "tink/input_stream.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace util {
+
+CordInputStream::CordInputStream(absl::Cord cord) : cord_(std::move(cord)) {
+  chunk_it_ = cord_.chunk_begin();
+  current_chunk_ = absl::string_view();
+  position_ = 0;
+  last_returned_size_ = 0;
+  count_backedup_ = 0;
+}
+
+crypto::tink::util::StatusOr<int> CordInputStream::Next(const void** data) {
+  if (count_backedup_ > 0) {  // Return the backed-up bytes.
+    // The last Next() always returned bytes ending at the end of
+    // current_chunk_, so the backed-up bytes are its suffix.
+    *data = current_chunk_.data() + (current_chunk_.size() - count_backedup_);
+    int count = count_backedup_;
+    position_ = position_ + count;
+    count_backedup_ = 0;
+    last_returned_size_ = count;
+    return count;
+  }
+  if (chunk_it_ == cord_.chunk_end()) {
+    return Status(util::error::OUT_OF_RANGE, "EOF");
+  }
+  current_chunk_ = *chunk_it_;
+  ++chunk_it_;
+  int count = current_chunk_.size();
+  *data = current_chunk_.data();
+  position_ = position_ + count;
+  last_returned_size_ = count;
+  return count;
+}
+
+void CordInputStream::BackUp(int count) {
+  if (count < 1 || count_backedup_ == last_returned_size_) return;
+  int actual_count = std::min(count, last_returned_size_ - count_backedup_);
+  count_backedup_ = count_backedup_ + actual_count;
+  position_ = position_ - actual_count;
+}
+
+int64_t CordInputStream::Position() const {
+  return position_;
+}
+
+}  // namespace util
+}  // namespace tink
+}  // namespace crypto
@@ -0,0 +1,60 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_UTIL_CORD_INPUT_STREAM_H_
+#define TINK_UTIL_CORD_INPUT_STREAM_H_
+
+#include <utility>
+
+#include "absl/strings/cord.h"
+#include "absl/strings/string_view.h"
+#include "tink/input_stream.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace util {
+
+// An InputStream that reads from an absl::Cord without flattening it or
+// copying its contents: Next() hands out pointers directly into the
+// Cord's chunks, one chunk at a time. The stream keeps its own reference
+// to the Cord, so the caller's Cord may be destroyed while the stream is
+// in use.
+class CordInputStream : public crypto::tink::InputStream {
+ public:
+  explicit CordInputStream(absl::Cord cord);
+
+  crypto::tink::util::StatusOr<int> Next(const void** data) override;
+
+  void BackUp(int count) override;
+
+  int64_t Position() const override;
+
+ private:
+  const absl::Cord cord_;
+  absl::Cord::ChunkIterator chunk_it_;   // next chunk to be handed out
+  absl::string_view current_chunk_;      // chunk last returned by Next()
+  int64_t position_;        // # of bytes of cord_ already consumed
+  int last_returned_size_;  // # of bytes returned by the last Next()
+  int count_backedup_;      // # of those bytes that were backed up
+};
+
+}  // namespace util
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_UTIL_CORD_INPUT_STREAM_H_
@@ -0,0 +1,144 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/util/cord_input_stream.h"
+
+#include <algorithm>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "absl/memory/memory.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/cord_test_helpers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "tink/subtle/random.h"
+
+namespace crypto {
+namespace tink {
+namespace {
+
+// Reads the specified 'input_stream' until no more bytes can be read,
+// and puts the read bytes into 'contents'.
+// Returns the status of the last input_stream->Next()-operation.
+util::Status ReadTillEnd(util::CordInputStream* input_stream,
+                         std::string* contents) {
+  contents->clear();
+  const void* buffer;
+  auto next_result = input_stream->Next(&buffer);
+  while (next_result.ok()) {
+    contents->append(static_cast<const char*>(buffer),
+                     next_result.ValueOrDie());
+    next_result = input_stream->Next(&buffer);
+  }
+  return next_result.status();
+}
+
+class CordInputStreamTest : public ::testing::Test {
+};
+
+TEST_F(CordInputStreamTest, ReadingStreams) {
+  for (auto stream_size : {0, 10, 100, 1000, 10000, 100000}) {
+    for (auto chunk_size : {1, 10, 1234}) {
+      SCOPED_TRACE(absl::StrCat("stream_size = ", stream_size,
+                                " chunk_size = ", chunk_size));
+      std::string contents = subtle::Random::GetRandomBytes(stream_size);
+      absl::Cord cord = absl::MakeFragmentedCord(
+          absl::StrSplit(contents, absl::ByLength(chunk_size)));
+      auto input_stream = absl::make_unique<util::CordInputStream>(cord);
+      std::string stream_contents;
+      auto status = ReadTillEnd(input_stream.get(), &stream_contents);
+      EXPECT_EQ(util::error::OUT_OF_RANGE, status.error_code());
+      EXPECT_EQ("EOF", status.error_message());
+      EXPECT_EQ(contents, stream_contents);
+      EXPECT_EQ(stream_size, input_stream->Position());
+    }
+  }
+}
+
+TEST_F(CordInputStreamTest, ZeroCopy) {
+  std::string contents = subtle::Random::GetRandomBytes(1000);
+  // A Cord made of a single flat chunk keeps the bytes in one place.
+  absl::Cord cord = absl::MakeCordFromExternal(
+      absl::string_view(contents), [](absl::string_view) {});
+  auto input_stream = absl::make_unique<util::CordInputStream>(cord);
+  const void* buffer;
+  auto next_result = input_stream->Next(&buffer);
+  EXPECT_TRUE(next_result.ok()) << next_result.status();
+  // The returned bytes are the chunk of the Cord itself, not a copy.
+  EXPECT_EQ(contents.data(), static_cast<const char*>(buffer));
+  EXPECT_EQ(contents.size(), next_result.ValueOrDie());
+}
+
+TEST_F(CordInputStreamTest, BackupAndPosition) {
+  std::string contents = subtle::Random::GetRandomBytes(1000);
+  absl::Cord cord = absl::MakeCordFromExternal(
+      absl::string_view(contents), [](absl::string_view) {});
+  const void* buffer;
+
+  // Prepare the stream and do the first call to Next().
+  auto input_stream = absl::make_unique<util::CordInputStream>(cord);
+  EXPECT_EQ(0, input_stream->Position());
+  auto next_result = input_stream->Next(&buffer);
+  EXPECT_TRUE(next_result.ok()) << next_result.status();
+  EXPECT_EQ(contents.size(), next_result.ValueOrDie());
+  EXPECT_EQ(contents.size(), input_stream->Position());
+
+  // BackUp several times, but in total fewer bytes than returned by Next().
+  int total_backup_size = 0;
+  for (auto backup_size : {0, 1, 5, 0, 10, 100, -42, 400, 20, -100}) {
+    SCOPED_TRACE(absl::StrCat("backup_size = ", backup_size));
+    input_stream->BackUp(backup_size);
+    total_backup_size += std::max(0, backup_size);
+    EXPECT_EQ(contents.size() - total_backup_size, input_stream->Position());
+  }
+  // Call Next(), it should return exactly the backed up bytes.
+  next_result = input_stream->Next(&buffer);
+  EXPECT_TRUE(next_result.ok()) << next_result.status();
+  EXPECT_EQ(total_backup_size, next_result.ValueOrDie());
+  EXPECT_EQ(contents.size(), input_stream->Position());
+  EXPECT_EQ(contents.data() + contents.size() - total_backup_size,
+            static_cast<const char*>(buffer));
+
+  // A BackUp of more bytes than returned by the last Next() is capped.
+  input_stream->BackUp(2 * total_backup_size);
+  EXPECT_EQ(contents.size() - total_backup_size, input_stream->Position());
+  next_result = input_stream->Next(&buffer);
+  EXPECT_TRUE(next_result.ok()) << next_result.status();
+  EXPECT_EQ(total_backup_size, next_result.ValueOrDie());
+  EXPECT_EQ(contents.size(), input_stream->Position());
+
+  // The stream is exhausted afterwards.
+  next_result = input_stream->Next(&buffer);
+  EXPECT_EQ(util::error::OUT_OF_RANGE, next_result.status().error_code());
+}
+
+TEST_F(CordInputStreamTest, OutlivesSourceCord) {
+  std::string contents = subtle::Random::GetRandomBytes(1000);
+  std::unique_ptr<util::CordInputStream> input_stream;
+  {
+    absl::Cord cord(contents);
+    input_stream = absl::make_unique<util::CordInputStream>(cord);
+  }
+  std::string stream_contents;
+  auto status = ReadTillEnd(input_stream.get(), &stream_contents);
+  EXPECT_EQ(util::error::OUT_OF_RANGE, status.error_code());
+  EXPECT_EQ(contents, stream_contents);
+}
+
+}  // namespace
+}  // namespace tink
+}  // namespace crypto
@@ -0,0 +1,73 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_UTIL_CORD_OUTPUT_STREAM_H_
+#define TINK_UTIL_CORD_OUTPUT_STREAM_H_
+
+#include "absl/strings/cord.h"
+#include "tink/output_stream.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace util {
+
+// An OutputStream that appends all written bytes to an absl::Cord.
+// Full internal buffers are handed over to the Cord as external chunks
+// rather than copied, so writing large outputs costs one allocation per
+// buffer and no extra copies. The destination Cord is complete only
+// after Close() has been called; the caller must ensure that it
+// outlives the stream.
+class CordOutputStream : public crypto::tink::OutputStream {
+ public:
+  // Constructs an OutputStream that will append to 'destination',
+  // using an internal buffer of the specified size, if any
+  // (if no legal 'buffer_size' is given, a reasonable default is used).
+  explicit CordOutputStream(absl::Cord* destination, int buffer_size = -1);
+
+  ~CordOutputStream() override;
+
+  crypto::tink::util::StatusOr<int> Next(void** data) override;
+
+  void BackUp(int count) override;
+
+  crypto::tink::util::Status Close() override;
+
+  int64_t Position() const override;
+
+ private:
+  // Appends the first 'count' bytes of buffer_ to destination_,
+  // transferring the ownership of buffer_ to the Cord.
+  void AppendBufferToDestination(int count);
+
+  util::Status status_;
+  absl::Cord* destination_;
+  char* buffer_;
+  const int buffer_size_;
+  int64_t position_;     // number of bytes handed out and not backed up
+
+  // Counters that describe the state of the data in buffer_.
+  int count_in_buffer_;  // # of bytes to be appended from buffer_
+  int count_backedup_;   // # of bytes in buffer_ that were backed up
+  int buffer_offset_;    // offset at which the returned bytes start in buffer_
+};
+
+}  // namespace util
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_UTIL_CORD_OUTPUT_STREAM_H_
@@ -0,0 +1,155 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/util/cord_output_stream.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "absl/memory/memory.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "tink/subtle/random.h"
+
+namespace crypto {
+namespace tink {
+namespace {
+
+// Writes 'contents' to the specified 'output_stream', and closes the stream.
+// Returns the status of output_stream->Close()-operation, or a non-OK status
+// of a prior output_stream->Next()-operation, if any.
+util::Status WriteToStream(util::CordOutputStream* output_stream,
+                           absl::string_view contents) {
+  void* buffer;
+  int pos = 0;
+  int remaining = contents.length();
+  int available_space = 0;
+  int available_bytes = 0;
+  while (remaining > 0) {
+    auto next_result = output_stream->Next(&buffer);
+    if (!next_result.ok()) return next_result.status();
+    available_space = next_result.ValueOrDie();
+    available_bytes = std::min(available_space, remaining);
+    memcpy(buffer, contents.data() + pos, available_bytes);
+    remaining -= available_bytes;
+    pos += available_bytes;
+  }
+  if (available_space > available_bytes) {
+    output_stream->BackUp(available_space - available_bytes);
+  }
+  return output_stream->Close();
+}
+
+class CordOutputStreamTest : public ::testing::Test {
+};
+
+TEST_F(CordOutputStreamTest, WritingStreams) {
+  for (auto stream_size : {0, 10, 100, 1000, 10000, 100000, 1000000}) {
+    for (auto buffer_size : {-1, 16, 1234}) {
+      SCOPED_TRACE(absl::StrCat("stream_size = ", stream_size,
+                                " buffer_size = ", buffer_size));
+      std::string contents = subtle::Random::GetRandomBytes(stream_size);
+      absl::Cord destination;
+      auto output_stream = absl::make_unique<util::CordOutputStream>(
+          &destination, buffer_size);
+      auto status = WriteToStream(output_stream.get(), contents);
+      EXPECT_TRUE(status.ok()) << status;
+      EXPECT_EQ(stream_size, output_stream->Position());
+      EXPECT_EQ(contents, std::string(destination));
+    }
+  }
+}
+
+TEST_F(CordOutputStreamTest, WriteAfterCloseFails) {
+  absl::Cord destination;
+  auto output_stream =
+      absl::make_unique<util::CordOutputStream>(&destination);
+  auto status = WriteToStream(output_stream.get(), "some contents");
+  EXPECT_TRUE(status.ok()) << status;
+
+  void* buffer;
+  auto next_result = output_stream->Next(&buffer);
+  EXPECT_EQ(util::error::FAILED_PRECONDITION,
+            next_result.status().error_code());
+  EXPECT_EQ("some contents", std::string(destination));
+}
+
+TEST_F(CordOutputStreamTest, BackupAndPosition) {
+  int buffer_size = 1234;
+  void* buffer;
+  absl::Cord destination;
+
+  // Prepare the stream and do the first call to Next().
+  auto output_stream =
+      absl::make_unique<util::CordOutputStream>(&destination, buffer_size);
+  EXPECT_EQ(0, output_stream->Position());
+  auto next_result = output_stream->Next(&buffer);
+  EXPECT_TRUE(next_result.ok()) << next_result.status();
+  EXPECT_EQ(buffer_size, next_result.ValueOrDie());
+  EXPECT_EQ(buffer_size, output_stream->Position());
+  std::memset(buffer, 'a', buffer_size);
+
+  // BackUp several times, but in total fewer bytes than returned by Next().
+  int total_backup_size = 0;
+  for (auto backup_size : {0, 1, 5, 0, 10, 100, -42, 400, 20, -100}) {
+    SCOPED_TRACE(absl::StrCat("backup_size = ", backup_size));
+    output_stream->BackUp(backup_size);
+    total_backup_size += std::max(0, backup_size);
+    EXPECT_EQ(buffer_size - total_backup_size, output_stream->Position());
+  }
+  // Call Next(), it should return exactly the backed up bytes.
+  next_result = output_stream->Next(&buffer);
+  EXPECT_TRUE(next_result.ok()) << next_result.status();
+  EXPECT_EQ(total_backup_size, next_result.ValueOrDie());
+  EXPECT_EQ(buffer_size, output_stream->Position());
+  std::memset(buffer, 'b', total_backup_size);
+
+  // Close the stream; all the written bytes must end up in the Cord.
+  auto status = output_stream->Close();
+  EXPECT_TRUE(status.ok()) << status;
+  std::string expected =
+      absl::StrCat(std::string(buffer_size - total_backup_size, 'a'),
+                   std::string(total_backup_size, 'b'));
+  EXPECT_EQ(expected, std::string(destination));
+}
+
+TEST_F(CordOutputStreamTest, MultipleBuffersBecomeSeparateChunks) {
+  int buffer_size = 1024;
+  int stream_size = 10 * buffer_size;
+  std::string contents = subtle::Random::GetRandomBytes(stream_size);
+  absl::Cord destination;
+  auto output_stream =
+      absl::make_unique<util::CordOutputStream>(&destination, buffer_size);
+  auto status = WriteToStream(output_stream.get(), contents);
+  EXPECT_TRUE(status.ok()) << status;
+  EXPECT_EQ(contents, std::string(destination));
+  // Full buffers are handed over to the Cord without copying, one
+  // buffer-sized chunk each.
+  int chunk_count = 0;
+  for (absl::string_view chunk : destination.Chunks()) {
+    EXPECT_EQ(buffer_size, chunk.size());
+    chunk_count++;
+  }
+  EXPECT_EQ(stream_size / buffer_size, chunk_count);
+}
+
+}  // namespace
+}  // namespace tink
+}  // namespace crypto
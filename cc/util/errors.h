@@ -31,6 +31,33 @@ util::Status ToStatusF(util::error::Code code,
   return util::Status(code, absl::StrFormat(format, args...));
 }
 
+// Preallocated Status objects for hot-path failures, where constructing a
+// fresh message per failure is measurable: the trial-decrypt loops of the
+// set wrappers produce one failure per non-matching key before the right
+// key succeeds. The objects are never destroyed; copying them is cheap as
+// the messages fit into the small-string buffer.
+
+// The ciphertext could not be decrypted with any matching key.
+inline const util::Status& DecryptionFailedStatus() {
+  static const util::Status* status =
+      new util::Status(util::error::INVALID_ARGUMENT, "decryption failed");
+  return *status;
+}
+
+// The MAC or signature did not verify with any matching key.
+inline const util::Status& VerificationFailedStatus() {
+  static const util::Status* status =
+      new util::Status(util::error::INVALID_ARGUMENT, "verification failed");
+  return *status;
+}
+
+// An AEAD authentication tag did not match.
+inline const util::Status& AuthenticationFailedStatus() {
+  static const util::Status* status =
+      new util::Status(util::error::INTERNAL, "Authentication failed");
+  return *status;
+}
+
 }  // namespace tink
 }  // namespace crypto
 
@@ -0,0 +1,85 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/util/execution_context.h"
+
+#include <thread>  // NOLINT(build/c++11)
+#include <utility>
+#include <vector>
+
+#include "absl/synchronization/blocking_counter.h"
+#include "absl/synchronization/mutex.h"
+
+namespace crypto {
+namespace tink {
+namespace util {
+
+namespace {
+
+absl::Mutex* GlobalContextMutex() {
+  static absl::Mutex* mutex = new absl::Mutex();
+  return mutex;
+}
+
+std::shared_ptr<ExecutionContext>* GlobalContext() {
+  static auto* context = new std::shared_ptr<ExecutionContext>();
+  return context;
+}
+
+}  // namespace
+
+void SetGlobalExecutionContext(std::shared_ptr<ExecutionContext> context) {
+  absl::MutexLock lock(GlobalContextMutex());
+  *GlobalContext() = std::move(context);
+}
+
+std::shared_ptr<ExecutionContext> GetGlobalExecutionContext() {
+  absl::MutexLock lock(GlobalContextMutex());
+  return *GlobalContext();
+}
+
+void RunParallelWork(ExecutionContext* context, int worker_count,
+                     const std::function<void()>& work) {
+  if (worker_count <= 1) {
+    work();
+    return;
+  }
+  std::shared_ptr<ExecutionContext> global_context;
+  if (context == nullptr) {
+    global_context = GetGlobalExecutionContext();
+    context = global_context.get();
+  }
+  if (context == nullptr) {
+    std::vector<std::thread> workers;
+    for (int i = 0; i < worker_count - 1; i++) workers.emplace_back(work);
+    work();
+    for (std::thread& worker : workers) worker.join();
+    return;
+  }
+  absl::BlockingCounter pending(worker_count - 1);
+  for (int i = 0; i < worker_count - 1; i++) {
+    context->Schedule([&work, &pending]() {
+      work();
+      pending.DecrementCount();
+    });
+  }
+  work();
+  pending.Wait();
+}
+
+}  // namespace util
+}  // namespace tink
+}  // namespace crypto
@@ -0,0 +1,64 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_UTIL_EXECUTION_CONTEXT_H_
+#define TINK_UTIL_EXECUTION_CONTEXT_H_
+
+#include <functional>
+#include <memory>
+
+namespace crypto {
+namespace tink {
+namespace util {
+
+// An abstraction over "where concurrent work runs", so that features which
+// parallelize (e.g. KeysetHandle::GetPrimitives()) can schedule onto an
+// application's existing thread pool instead of Tink spawning threads of
+// its own. Implement Schedule() as a hook into your pool and install the
+// context globally with SetGlobalExecutionContext(), or pass it to the
+// individual calls that accept one.
+class ExecutionContext {
+ public:
+  // Runs 'task' eventually, typically on another thread. Every submitted
+  // task must be run exactly once; Schedule() itself must not block on
+  // the task's completion.
+  virtual void Schedule(std::function<void()> task) = 0;
+
+  virtual ~ExecutionContext() {}
+};
+
+// Installs 'context' as the process-wide default used by parallel features
+// when no per-call context is given; pass nullptr to uninstall. Should be
+// set once at startup, before concurrent Tink usage.
+void SetGlobalExecutionContext(std::shared_ptr<ExecutionContext> context);
+
+// Returns the installed global context, or nullptr if none is installed.
+std::shared_ptr<ExecutionContext> GetGlobalExecutionContext();
+
+// Runs 'worker_count' invocations of 'work' concurrently and returns once
+// all of them have finished. The invocations are scheduled onto 'context'
+// if non-null, onto the global context otherwise, and onto freshly spawned
+// threads if neither is set; the calling thread always runs one invocation
+// itself, so a context with worker_count - 1 free threads suffices.
+// This is the scheduling primitive parallel features should build on.
+void RunParallelWork(ExecutionContext* context, int worker_count,
+                     const std::function<void()>& work);
+
+}  // namespace util
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_UTIL_EXECUTION_CONTEXT_H_
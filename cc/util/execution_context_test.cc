@@ -0,0 +1,93 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/util/execution_context.h"
+
+#include <atomic>
+#include <utility>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace crypto {
+namespace tink {
+namespace util {
+namespace {
+
+// An ExecutionContext that counts Schedule() calls and runs each task
+// right away in the scheduling thread.
+class CountingExecutionContext : public ExecutionContext {
+ public:
+  void Schedule(std::function<void()> task) override {
+    schedule_count++;
+    task();
+  }
+
+  int schedule_count = 0;
+};
+
+TEST(ExecutionContextTest, GlobalContextInstallAndUninstall) {
+  EXPECT_EQ(nullptr, GetGlobalExecutionContext());
+
+  auto context = std::make_shared<CountingExecutionContext>();
+  SetGlobalExecutionContext(context);
+  EXPECT_EQ(context, GetGlobalExecutionContext());
+
+  SetGlobalExecutionContext(nullptr);
+  EXPECT_EQ(nullptr, GetGlobalExecutionContext());
+}
+
+TEST(ExecutionContextTest, SingleWorkerRunsInline) {
+  CountingExecutionContext context;
+  int run_count = 0;
+  RunParallelWork(&context, 1, [&run_count]() { run_count++; });
+  EXPECT_EQ(1, run_count);
+  EXPECT_EQ(0, context.schedule_count);
+}
+
+TEST(ExecutionContextTest, WorkersAreScheduledOntoContext) {
+  CountingExecutionContext context;
+  std::atomic<int> run_count(0);
+  RunParallelWork(&context, 4, [&run_count]() { run_count++; });
+  EXPECT_EQ(4, run_count.load());
+  // The calling thread runs one invocation itself.
+  EXPECT_EQ(3, context.schedule_count);
+}
+
+TEST(ExecutionContextTest, SpawnsThreadsWithoutContext) {
+  std::atomic<int> run_count(0);
+  RunParallelWork(/* context = */ nullptr, 4,
+                  [&run_count]() { run_count++; });
+  EXPECT_EQ(4, run_count.load());
+}
+
+TEST(ExecutionContextTest, FallsBackToGlobalContext) {
+  auto context = std::make_shared<CountingExecutionContext>();
+  SetGlobalExecutionContext(context);
+
+  std::atomic<int> run_count(0);
+  RunParallelWork(/* context = */ nullptr, 3,
+                  [&run_count]() { run_count++; });
+  EXPECT_EQ(3, run_count.load());
+  EXPECT_EQ(2, context->schedule_count);
+
+  SetGlobalExecutionContext(nullptr);
+}
+
+}  // namespace
+}  // namespace util
+}  // namespace tink
+}  // namespace crypto
@@ -18,6 +18,7 @@
 
 #include <unistd.h>
 #include <algorithm>
+#include <cstring>
 
 #include "absl/memory/memory.h"
 #include "tink/input_stream.h"
@@ -101,6 +102,45 @@ void FileInputStream::BackUp(int count) {
   position_ = position_ - actual_count;
 }
 
+crypto::tink::util::Status FileInputStream::ReadExact(absl::Span<char> out) {
+  if (!status_.ok()) return status_;
+  int out_size = static_cast<int>(out.size());
+  int copied = 0;
+  // Serve backed-up bytes from the buffer first. The remaining backed-up
+  // bytes (if any) keep their position at the end of the buffer, so a
+  // partial consume just shrinks count_backedup_.
+  if (count_backedup_ > 0) {
+    int num_bytes_to_copy = std::min(count_backedup_, out_size);
+    int start = buffer_offset_ + (count_in_buffer_ - count_backedup_);
+    memcpy(out.data(), buffer_.get() + start, num_bytes_to_copy);
+    count_backedup_ = count_backedup_ - num_bytes_to_copy;
+    position_ = position_ + num_bytes_to_copy;
+    copied = num_bytes_to_copy;
+  }
+  // Read the rest from the file directly into 'out', without going
+  // through buffer_.
+  while (copied < out_size) {
+    int read_result =
+        read_ignoring_eintr(fd_, out.data() + copied, out_size - copied);
+    if (read_result <= 0) {  // EOF or an I/O error.
+      if (read_result == 0) {
+        status_ = Status(util::error::OUT_OF_RANGE, "EOF");
+      } else {
+        status_ = ToStatusF(util::error::INTERNAL, "I/O error: %d", read_result);
+      }
+      return status_;
+    }
+    copied = copied + read_result;
+    position_ = position_ + read_result;
+    // The buffer contents have been passed over; bytes served by
+    // ReadExact() cannot be backed up.
+    count_in_buffer_ = 0;
+    count_backedup_ = 0;
+    buffer_offset_ = 0;
+  }
+  return Status::OK;
+}
+
 FileInputStream::~FileInputStream() {
   close_ignoring_eintr(fd_);
 }
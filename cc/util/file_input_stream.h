@@ -19,6 +19,7 @@
 
 #include <memory>
 
+#include "absl/types/span.h"
 #include "tink/input_stream.h"
 #include "tink/util/status.h"
 #include "tink/util/statusor.h"
@@ -42,6 +43,11 @@ class FileInputStream : public crypto::tink::InputStream {
 
   void BackUp(int count) override;
 
+  // Serves the read from the backed-up bytes in the buffer first, and
+  // reads the rest from the file directly into 'out', bypassing the
+  // internal buffer.
+  crypto::tink::util::Status ReadExact(absl::Span<char> out) override;
+
   int64_t Position() const override;
 
  private:
@@ -20,6 +20,7 @@
 #include "absl/memory/memory.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "tink/util/test_util.h"
 
 namespace crypto {
@@ -166,6 +167,42 @@ TEST_F(FileInputStreamTest, testBackupAndPosition) {
             std::string(static_cast<const char*>(buffer), buffer_size));
 }
 
+TEST_F(FileInputStreamTest, testReadExact) {
+  int stream_size = 100000;
+  int buffer_size = 1234;
+  std::string file_contents;
+  std::string filename = "read_exact_test.bin";
+  int input_fd =
+      test::GetTestFileDescriptor(filename, stream_size, &file_contents);
+  auto input_stream =
+      absl::make_unique<util::FileInputStream>(input_fd, buffer_size);
+
+  // A large read is served directly into the output, bypassing the
+  // internal buffer.
+  std::string data(10000, '\0');
+  auto status = input_stream->ReadExact(absl::MakeSpan(&data[0], data.size()));
+  EXPECT_TRUE(status.ok()) << status;
+  EXPECT_EQ(file_contents.substr(0, 10000), data);
+  EXPECT_EQ(10000, input_stream->Position());
+
+  // Backed-up bytes are served first.
+  const void* buffer;
+  auto next_result = input_stream->Next(&buffer);
+  ASSERT_TRUE(next_result.ok()) << next_result.status();
+  EXPECT_EQ(buffer_size, next_result.ValueOrDie());
+  input_stream->BackUp(100);
+  std::string second(500, '\0');
+  status = input_stream->ReadExact(absl::MakeSpan(&second[0], 500));
+  EXPECT_TRUE(status.ok()) << status;
+  EXPECT_EQ(file_contents.substr(10000 + buffer_size - 100, 500), second);
+  EXPECT_EQ(10000 + buffer_size + 400, input_stream->Position());
+
+  // Reading past the end of the file fails with OUT_OF_RANGE.
+  std::string rest(stream_size - input_stream->Position() + 1, '\0');
+  status = input_stream->ReadExact(absl::MakeSpan(&rest[0], rest.size()));
+  EXPECT_EQ(util::error::OUT_OF_RANGE, status.error_code());
+}
+
 }  // namespace
 }  // namespace tink
 }  // namespace crypto
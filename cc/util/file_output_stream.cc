@@ -16,11 +16,15 @@
 
 #include "tink/util/file_output_stream.h"
 
+#include <limits.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #include <cstring>
 #include <algorithm>
+#include <vector>
 
 #include "absl/memory/memory.h"
+#include "absl/types/span.h"
 #include "tink/output_stream.h"
 #include "tink/util/errors.h"
 #include "tink/util/status.h"
@@ -53,6 +57,51 @@ int write_ignoring_eintr(int fd, const void *buf, size_t count) {
   return result;
 }
 
+// Attempts to write the data referenced by 'iov' to file descriptor fd,
+// while ignoring EINTR.
+int writev_ignoring_eintr(int fd, const struct iovec* iov, int iovcnt) {
+  int result;
+  do {
+    result = writev(fd, iov, iovcnt);
+  } while (result < 0 && errno == EINTR);
+  return result;
+}
+
+// Writes all the data referenced by the entries of 'iov' to file
+// descriptor fd, modifying the entries to account for partial writes.
+util::Status write_all_vectored(int fd, std::vector<struct iovec>* iov) {
+  size_t current = 0;
+  while (current < iov->size()) {
+    int batch_size = std::min(iov->size() - current,
+                              static_cast<size_t>(IOV_MAX));
+    int write_result = writev_ignoring_eintr(
+        fd, iov->data() + current, batch_size);
+    if (write_result < 0) {  // An I/O error occurred.
+      return ToStatusF(
+          util::error::INTERNAL, "I/O error upon write: %d", errno);
+    } else if (write_result == 0) {  // No progress, hence abort.
+      return ToStatusF(util::error::INTERNAL,
+          "I/O error: failed to write %d bytes.",
+          static_cast<int>((*iov)[current].iov_len));
+    }
+    // Skip the entries that were written in full, and adjust a partially
+    // written entry, if any.
+    size_t written = write_result;
+    while (written > 0) {
+      struct iovec& entry = (*iov)[current];
+      if (written >= entry.iov_len) {
+        written -= entry.iov_len;
+        current++;
+      } else {
+        entry.iov_base = static_cast<uint8_t*>(entry.iov_base) + written;
+        entry.iov_len -= written;
+        written = 0;
+      }
+    }
+  }
+  return Status::OK;
+}
+
 }  // anonymous namespace
 
 
@@ -165,6 +214,41 @@ int64_t FileOutputStream::Position() const {
   return position_;
 }
 
+Status FileOutputStream::WriteChunks(
+    absl::Span<const absl::Span<const uint8_t>> chunks) {
+  if (!status_.ok()) return status_;
+  std::vector<struct iovec> iov;
+  iov.reserve(chunks.size() + 1);
+  if (count_in_buffer_ > 0) {
+    // Flush the bytes committed via the Next()-protocol first, in the
+    // same writev-call, so that the write order is preserved.
+    struct iovec entry;
+    entry.iov_base = buffer_.get();
+    entry.iov_len = count_in_buffer_;
+    iov.push_back(entry);
+  }
+  int64_t total_chunk_size = 0;
+  for (const absl::Span<const uint8_t>& chunk : chunks) {
+    if (chunk.empty()) continue;
+    struct iovec entry;
+    entry.iov_base = const_cast<uint8_t*>(chunk.data());
+    entry.iov_len = chunk.size();
+    iov.push_back(entry);
+    total_chunk_size += chunk.size();
+  }
+  status_ = write_all_vectored(fd_, &iov);
+  if (!status_.ok()) return status_;
+  position_ = position_ + total_chunk_size;
+  // The entire buffer_ (if already allocated) is available again;
+  // register it as backed-up space, so that the next call to Next()
+  // returns it in full. This maintains the invariant on count_in_buffer_
+  // and count_backedup_ documented in the header.
+  count_in_buffer_ = 0;
+  count_backedup_ = (buffer_ == nullptr ? 0 : buffer_size_);
+  buffer_offset_ = 0;
+  return Status::OK;
+}
+
 }  // namespace util
 }  // namespace tink
 }  // namespace crypto
@@ -19,6 +19,7 @@
 
 #include <memory>
 
+#include "absl/types/span.h"
 #include "tink/output_stream.h"
 #include "tink/util/status.h"
 #include "tink/util/statusor.h"
@@ -46,6 +47,9 @@ class FileOutputStream : public crypto::tink::OutputStream {
 
   int64_t Position() const override;
 
+  crypto::tink::util::Status WriteChunks(
+      absl::Span<const absl::Span<const uint8_t>> chunks) override;
+
  private:
   util::Status status_;
   int fd_;
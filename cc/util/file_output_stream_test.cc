@@ -20,6 +20,7 @@
 #include "absl/memory/memory.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "tink/subtle/random.h"
 #include "tink/util/test_util.h"
 
@@ -177,6 +178,45 @@ TEST_F(FileOutputStreamTest, BackupAndPosition) {
   EXPECT_EQ(stream_contents, file_contents);
 }
 
+TEST_F(FileOutputStreamTest, WriteChunks) {
+  int buffer_size = 1234;
+  std::string part_0 = subtle::Random::GetRandomBytes(100);
+  std::string part_1 = subtle::Random::GetRandomBytes(50000);
+  std::string part_2 = subtle::Random::GetRandomBytes(42);
+  std::string part_3 = subtle::Random::GetRandomBytes(20000);
+  std::string filename = "write_chunks_test.bin";
+  int output_fd = test::GetTestFileDescriptor(filename);
+  auto output_stream =
+      absl::make_unique<util::FileOutputStream>(output_fd, buffer_size);
+
+  // Write part_0 through the regular Next()-protocol, without flushing.
+  void* buffer;
+  auto next_result = output_stream->Next(&buffer);
+  EXPECT_TRUE(next_result.ok()) << next_result.status();
+  EXPECT_EQ(buffer_size, next_result.ValueOrDie());
+  memcpy(buffer, part_0.data(), part_0.size());
+  output_stream->BackUp(buffer_size - part_0.size());
+  EXPECT_EQ(part_0.size(), output_stream->Position());
+
+  // Hand parts 1 and 2 to the direct scatter/gather path; the buffered
+  // part_0 must be written first.
+  absl::Span<const uint8_t> chunks[2] = {
+      absl::Span<const uint8_t>(
+          reinterpret_cast<const uint8_t*>(part_1.data()), part_1.size()),
+      absl::Span<const uint8_t>(
+          reinterpret_cast<const uint8_t*>(part_2.data()), part_2.size())};
+  auto status = output_stream->WriteChunks(absl::MakeConstSpan(chunks, 2));
+  EXPECT_TRUE(status.ok()) << status;
+  EXPECT_EQ(part_0.size() + part_1.size() + part_2.size(),
+            output_stream->Position());
+
+  // The Next()-protocol must still work after a direct write.
+  status = WriteToStream(output_stream.get(), part_3);
+  EXPECT_TRUE(status.ok()) << status;
+  std::string file_contents = test::ReadTestFile(filename);
+  EXPECT_EQ(part_0 + part_1 + part_2 + part_3, file_contents);
+}
+
 }  // namespace
 }  // namespace tink
 }  // namespace crypto
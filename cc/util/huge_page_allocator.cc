@@ -0,0 +1,57 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/util/huge_page_allocator.h"
+
+#include <cstdlib>
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace crypto {
+namespace tink {
+namespace util {
+
+void* AllocateHugePageRegion(size_t size) {
+#ifdef __linux__
+  // Pad to whole huge pages, so that together with the alignment the
+  // entire block can be backed by huge pages.
+  size_t padded_size = (size + kHugePageSize - 1) & ~(kHugePageSize - 1);
+  void* region = nullptr;
+  if (posix_memalign(&region, kHugePageSize, padded_size) == 0) {
+    // Best effort: if transparent huge pages are disabled on the system,
+    // the block simply stays on regular pages.
+    madvise(region, padded_size, MADV_HUGEPAGE);
+    return region;
+  }
+#endif
+  // Fallback: a plain allocation; freed with free(), like the aligned
+  // block above.
+  void* ptr = std::malloc(size);
+  if (ptr == nullptr) {
+    // Mirror the behavior of a failed ::operator new.
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void FreeHugePageRegion(void* ptr, size_t /* size */) { std::free(ptr); }
+
+}  // namespace util
+}  // namespace tink
+}  // namespace crypto
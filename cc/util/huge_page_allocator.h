@@ -0,0 +1,124 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_UTIL_HUGE_PAGE_ALLOCATOR_H_
+#define TINK_UTIL_HUGE_PAGE_ALLOCATOR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace crypto {
+namespace tink {
+namespace util {
+
+// Huge-page-backed allocation for large, long-lived buffers, in particular
+// the segment-sized buffers of streaming encryption: a 1MB buffer on
+// regular 4KB pages occupies 256 TLB entries, while on a single 2MB
+// transparent huge page it occupies one, which removes the TLB misses that
+// large-segment streaming workloads otherwise see on every pass over the
+// buffer.
+
+// The size of a transparent huge page on x86-64 and aarch64 Linux.
+constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+
+// Allocations below this size stay on the regular allocator even when huge
+// pages are requested: the allocation is padded to whole huge pages, which
+// only pays off when the buffer is a sizable fraction of one.
+constexpr size_t kMinHugePageAllocationSize = 512 * 1024;
+
+// Allocates a block of at least 'size' bytes. On Linux the block is
+// aligned to kHugePageSize, padded to whole huge pages, and marked with
+// madvise(MADV_HUGEPAGE), so that the kernel backs it with transparent
+// huge pages where the system configuration allows; elsewhere, and when an
+// aligned allocation is not possible, this is a plain allocation. The
+// block must be freed with FreeHugePageRegion().
+void* AllocateHugePageRegion(size_t size);
+
+// Frees a block of 'size' bytes allocated with AllocateHugePageRegion().
+void FreeHugePageRegion(void* ptr, size_t size);
+
+// A C++11 minimal allocator that serves large allocations from
+// AllocateHugePageRegion() when enabled, and behaves like the default
+// allocator otherwise. The allocation mode is per-instance state, so one
+// vector type can hold buffers of either mode, selected at run time (e.g.
+// via the params of a streaming primitive).
+template <typename T>
+class HugePageAllocator {
+ public:
+  using value_type = T;
+  // Storage must keep the allocator it was allocated with when it moves
+  // between containers (e.g. through a buffer pool), so that it is freed
+  // in the mode it was allocated in.
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  HugePageAllocator() : enabled_(false) {}
+  explicit HugePageAllocator(bool enabled) : enabled_(enabled) {}
+  template <typename U>
+  HugePageAllocator(const HugePageAllocator<U>& other)  // NOLINT
+      : enabled_(other.enabled()) {}
+
+  T* allocate(size_t n) {
+    size_t size = n * sizeof(T);
+    if (UsesHugePages(size)) {
+      return static_cast<T*>(AllocateHugePageRegion(size));
+    }
+    return static_cast<T*>(::operator new(size));
+  }
+
+  void deallocate(T* ptr, size_t n) {
+    size_t size = n * sizeof(T);
+    if (UsesHugePages(size)) {
+      FreeHugePageRegion(ptr, size);
+    } else {
+      ::operator delete(ptr);
+    }
+  }
+
+  bool enabled() const { return enabled_; }
+
+ private:
+  // Depends only on the allocation mode and the allocation size, so that
+  // deallocate() takes the same branch as the allocate()-call that
+  // produced the block.
+  bool UsesHugePages(size_t size) const {
+    return enabled_ && size >= kMinHugePageAllocationSize;
+  }
+
+  bool enabled_;
+};
+
+// Allocators are interchangeable iff they are in the same allocation mode.
+template <typename T, typename U>
+bool operator==(const HugePageAllocator<T>& a, const HugePageAllocator<U>& b) {
+  return a.enabled() == b.enabled();
+}
+
+template <typename T, typename U>
+bool operator!=(const HugePageAllocator<T>& a, const HugePageAllocator<U>& b) {
+  return !(a == b);
+}
+
+// The byte buffer type used for segment-sized streaming buffers.
+using HugePageVector = std::vector<uint8_t, HugePageAllocator<uint8_t>>;
+
+}  // namespace util
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_UTIL_HUGE_PAGE_ALLOCATOR_H_
@@ -0,0 +1,92 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/util/huge_page_allocator.h"
+
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#include "gtest/gtest.h"
+
+namespace crypto {
+namespace tink {
+namespace util {
+namespace {
+
+TEST(HugePageAllocatorTest, RegionIsUsableAndAligned) {
+  const size_t size = 3 * 1024 * 1024;  // not a multiple of kHugePageSize
+  void* region = AllocateHugePageRegion(size);
+  ASSERT_NE(region, nullptr);
+#ifdef __linux__
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(region) % kHugePageSize, 0u);
+#endif
+  // The whole requested range must be writable and readable.
+  std::memset(region, 0xab, size);
+  EXPECT_EQ(static_cast<unsigned char*>(region)[size - 1], 0xab);
+  FreeHugePageRegion(region, size);
+}
+
+TEST(HugePageAllocatorTest, EnabledVectorUsesAlignedStorage) {
+  HugePageVector buffer((HugePageAllocator<uint8_t>(true)));
+  buffer.resize(4 * 1024 * 1024);
+#ifdef __linux__
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(buffer.data()) % kHugePageSize, 0u);
+#endif
+  buffer[0] = 1;
+  buffer[buffer.size() - 1] = 2;
+  EXPECT_EQ(buffer[0], 1);
+  EXPECT_EQ(buffer[buffer.size() - 1], 2);
+}
+
+TEST(HugePageAllocatorTest, SmallAndDisabledVectorsBehaveNormally) {
+  // Small allocations stay on the regular allocator even when enabled.
+  HugePageVector small((HugePageAllocator<uint8_t>(true)));
+  small.resize(kMinHugePageAllocationSize / 2, 7);
+  EXPECT_EQ(small[small.size() - 1], 7);
+
+  HugePageVector disabled;  // default mode
+  disabled.resize(4 * 1024 * 1024, 9);
+  EXPECT_EQ(disabled[disabled.size() - 1], 9);
+  EXPECT_FALSE(disabled.get_allocator().enabled());
+}
+
+TEST(HugePageAllocatorTest, ModeMovesWithTheStorage) {
+  HugePageVector source((HugePageAllocator<uint8_t>(true)));
+  source.resize(4 * 1024 * 1024, 5);
+  const uint8_t* storage = source.data();
+
+  // Move assignment must carry the allocation mode along with the storage,
+  // so that the target frees it in the mode it was allocated in.
+  HugePageVector target;
+  target = std::move(source);
+  EXPECT_EQ(target.data(), storage);
+  EXPECT_TRUE(target.get_allocator().enabled());
+  EXPECT_EQ(target[target.size() - 1], 5);
+}
+
+TEST(HugePageAllocatorTest, AllocatorsCompareByMode) {
+  HugePageAllocator<uint8_t> enabled(true);
+  HugePageAllocator<uint8_t> also_enabled(true);
+  HugePageAllocator<uint8_t> disabled;
+  EXPECT_TRUE(enabled == also_enabled);
+  EXPECT_TRUE(enabled != disabled);
+}
+
+}  // namespace
+}  // namespace util
+}  // namespace tink
+}  // namespace crypto
@@ -16,10 +16,6 @@
 
 #include "tink/util/input_stream_util.h"
 
-#include <algorithm>
-
-#include "absl/algorithm/container.h"
-#include "absl/strings/str_cat.h"
 #include "absl/types/span.h"
 #include "tink/input_stream.h"
 #include "tink/util/statusor.h"
@@ -31,25 +27,14 @@ namespace {
 template <typename Result>
 util::StatusOr<Result> ReadBytesFromStreamImpl(int num_bytes,
                                                InputStream* input_stream) {
-  const void* buffer;
   Result result;
   if (num_bytes > 0) {
     result.resize(num_bytes);
-  }
-  int num_bytes_read = 0;
-
-  while (num_bytes_read < num_bytes) {
-    auto next_result = input_stream->Next(&buffer);
-    if (!next_result.ok()) return next_result.status();
-
-    int num_bytes_in_chunk = next_result.ValueOrDie();
-    int num_bytes_to_copy =
-        std::min(num_bytes - num_bytes_read, num_bytes_in_chunk);
-    absl::c_copy(absl::MakeSpan(reinterpret_cast<const char*>(buffer),
-                                num_bytes_to_copy),
-                 result.begin() + num_bytes_read);
-    input_stream->BackUp(num_bytes_in_chunk - num_bytes_to_copy);
-    num_bytes_read += num_bytes_to_copy;
+    // ReadExact() is a single virtual call for streams that can serve the
+    // whole read in one step, and loops over Next()/BackUp() otherwise.
+    auto status = input_stream->ReadExact(
+        absl::MakeSpan(reinterpret_cast<char*>(&result[0]), num_bytes));
+    if (!status.ok()) return status;
   }
   return result;
 }
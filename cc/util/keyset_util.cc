@@ -16,6 +16,7 @@
 
 #include "tink/util/keyset_util.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <random>
 
@@ -51,5 +52,15 @@ uint32_t GenerateUnusedKeyId(const Keyset& keyset) {
   }
 }
 
+uint32_t GenerateUnusedKeyId(absl::Span<const uint32_t> used_key_ids) {
+  while (true) {
+    uint32_t key_id = NewKeyId();
+    if (std::find(used_key_ids.begin(), used_key_ids.end(), key_id) ==
+        used_key_ids.end()) {
+      return key_id;
+    }
+  }
+}
+
 }  // namespace tink
 }  // namespace crypto
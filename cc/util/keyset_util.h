@@ -19,6 +19,7 @@
 
 #include <cstdint>
 
+#include "absl/types/span.h"
 #include "proto/tink.pb.h"
 
 namespace crypto {
@@ -27,6 +28,9 @@ namespace tink {
 // Generate a new random key ID not previously used in |keyset|.
 uint32_t GenerateUnusedKeyId(const google::crypto::tink::Keyset& keyset);
 
+// Generate a new random key ID not contained in |used_key_ids|.
+uint32_t GenerateUnusedKeyId(absl::Span<const uint32_t> used_key_ids);
+
 }  // namespace tink
 }  // namespace crypto
 
@@ -0,0 +1,212 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/util/mmap_keyset_repository.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/internal/endian.h"
+#include "absl/memory/memory.h"
+#include "tink/binary_keyset_reader.h"
+#include "tink/cleartext_keyset_handle.h"
+#include "tink/util/errors.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace util {
+
+using crypto::tink::util::Status;
+using crypto::tink::util::StatusOr;
+
+namespace {
+
+const char kMagic[] = "TINKKSR1";
+const int kMagicSize = 8;
+const int kHeaderSize = kMagicSize + 4;  // magic plus entry count
+const int kEntryFixedSize = 12;  // name length, keyset offset, keyset length
+
+// Attempts to close file descriptor fd, while ignoring EINTR.
+// (code borrowed from ZeroCopy-streams)
+int close_ignoring_eintr(int fd) {
+  int result;
+  do {
+    result = close(fd);
+  } while (result < 0 && errno == EINTR);
+  return result;
+}
+
+Status InvalidFile() {
+  return Status(util::error::INVALID_ARGUMENT,
+                "Invalid keyset repository file");
+}
+
+}  // anonymous namespace
+
+// static
+StatusOr<std::unique_ptr<MmapKeysetRepository>> MmapKeysetRepository::Open(
+    absl::string_view filename) {
+  std::string filename_str(filename);
+  int fd = open(filename_str.c_str(), O_RDONLY);
+  if (fd == -1) {
+    return ToStatusF(util::error::NOT_FOUND, "could not open file '%s': %d",
+                     filename_str.c_str(), errno);
+  }
+  struct stat s;
+  if (fstat(fd, &s) == -1) {
+    close_ignoring_eintr(fd);
+    return ToStatusF(util::error::UNAVAILABLE, "could not stat the file: %d",
+                     errno);
+  }
+  int64_t file_size = s.st_size;
+  if (file_size < kHeaderSize) {
+    close_ignoring_eintr(fd);
+    return InvalidFile();
+  }
+  void* addr = mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0);
+  if (addr == MAP_FAILED) {
+    close_ignoring_eintr(fd);
+    return ToStatusF(util::error::UNAVAILABLE, "could not mmap the file: %d",
+                     errno);
+  }
+  auto repository = absl::WrapUnique(
+      new MmapKeysetRepository(fd, static_cast<char*>(addr), file_size));
+  const char* data = repository->mmap_addr_;
+  if (memcmp(data, kMagic, kMagicSize) != 0) return InvalidFile();
+  uint32_t entry_count = absl::little_endian::Load32(data + kMagicSize);
+  int64_t position = kHeaderSize;
+  for (uint32_t i = 0; i < entry_count; i++) {
+    if (position + kEntryFixedSize > file_size) return InvalidFile();
+    uint32_t name_length = absl::little_endian::Load32(data + position);
+    uint32_t keyset_offset = absl::little_endian::Load32(data + position + 4);
+    uint32_t keyset_length = absl::little_endian::Load32(data + position + 8);
+    position += kEntryFixedSize;
+    if (position + name_length > file_size) return InvalidFile();
+    std::string name(data + position, name_length);
+    position += name_length;
+    if (static_cast<int64_t>(keyset_offset) + keyset_length > file_size) {
+      return InvalidFile();
+    }
+    repository->index_[std::move(name)] =
+        absl::string_view(data + keyset_offset, keyset_length);
+  }
+  return std::move(repository);
+}
+
+// static
+Status MmapKeysetRepository::Pack(
+    const std::vector<std::pair<std::string, std::string>>& keysets,
+    std::ostream* destination) {
+  if (destination == nullptr) {
+    return Status(util::error::INVALID_ARGUMENT,
+                  "destination must be non-null");
+  }
+  int64_t keyset_offset = kHeaderSize;
+  for (const auto& keyset : keysets) {
+    keyset_offset += kEntryFixedSize + keyset.first.size();
+  }
+  int64_t total_size = keyset_offset;
+  for (const auto& keyset : keysets) {
+    total_size += keyset.second.size();
+  }
+  if (total_size > static_cast<int64_t>(UINT32_MAX)) {
+    return Status(util::error::INVALID_ARGUMENT,
+                  "packed keysets must not exceed 4 GiB");
+  }
+  char length_buffer[4];
+  destination->write(kMagic, kMagicSize);
+  absl::little_endian::Store32(length_buffer, keysets.size());
+  destination->write(length_buffer, 4);
+  for (const auto& keyset : keysets) {
+    absl::little_endian::Store32(length_buffer, keyset.first.size());
+    destination->write(length_buffer, 4);
+    absl::little_endian::Store32(length_buffer, keyset_offset);
+    destination->write(length_buffer, 4);
+    absl::little_endian::Store32(length_buffer, keyset.second.size());
+    destination->write(length_buffer, 4);
+    destination->write(keyset.first.data(), keyset.first.size());
+    keyset_offset += keyset.second.size();
+  }
+  for (const auto& keyset : keysets) {
+    destination->write(keyset.second.data(), keyset.second.size());
+  }
+  if (!destination->good()) {
+    return Status(util::error::UNKNOWN, "writing to destination failed");
+  }
+  return Status::OK;
+}
+
+MmapKeysetRepository::~MmapKeysetRepository() {
+  munmap(mmap_addr_, file_size_);
+  close_ignoring_eintr(fd_);
+}
+
+std::vector<std::string> MmapKeysetRepository::KeysetNames() const {
+  std::vector<std::string> names;
+  names.reserve(index_.size());
+  for (const auto& entry : index_) {
+    names.push_back(entry.first);
+  }
+  return names;
+}
+
+StatusOr<absl::string_view> MmapKeysetRepository::GetSerializedKeyset(
+    absl::string_view name) const {
+  auto it = index_.find(std::string(name));
+  if (it == index_.end()) {
+    return ToStatusF(util::error::NOT_FOUND,
+                     "no keyset with name '%s' found",
+                     std::string(name).c_str());
+  }
+  return it->second;
+}
+
+StatusOr<std::shared_ptr<const KeysetHandle>>
+MmapKeysetRepository::GetKeysetHandle(absl::string_view name) const {
+  std::string name_str(name);
+  {  // "fast-path" check
+    absl::MutexLock lock(&handles_mutex_);
+    auto it = handles_.find(name_str);
+    if (it != handles_.end()) return it->second;
+  }
+  auto serialized_result = GetSerializedKeyset(name);
+  if (!serialized_result.ok()) return serialized_result.status();
+  auto reader_result = BinaryKeysetReader::New(serialized_result.ValueOrDie());
+  if (!reader_result.ok()) return reader_result.status();
+  auto handle_result =
+      CleartextKeysetHandle::Read(std::move(reader_result.ValueOrDie()));
+  if (!handle_result.ok()) return handle_result.status();
+  std::shared_ptr<const KeysetHandle> handle =
+      std::move(handle_result.ValueOrDie());
+  absl::MutexLock lock(&handles_mutex_);
+  // In case of a race the first inserted handle wins.
+  auto insert_result = handles_.emplace(std::move(name_str), std::move(handle));
+  return insert_result.first->second;
+}
+
+}  // namespace util
+}  // namespace tink
+}  // namespace crypto
@@ -0,0 +1,99 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_UTIL_MMAP_KEYSET_REPOSITORY_H_
+#define TINK_UTIL_MMAP_KEYSET_REPOSITORY_H_
+
+#include <memory>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "tink/keyset_handle.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace util {
+
+// A read-only repository of named, serialized cleartext keysets backed by a
+// single memory-mapped packed file, for deployments that persist very many
+// keysets and must not read them all at startup.
+//
+// The packed file starts with an 8-byte magic value and a 32-bit little-endian
+// entry count, followed by one index entry per keyset (32-bit little-endian
+// name length, keyset offset and keyset length, then the name bytes), followed
+// by the serialized keysets themselves at the recorded offsets. As the index
+// is contiguous at the front of the file, Open() faults in only the index
+// pages; the pages holding a keyset are touched on its first access. Offsets
+// are 32-bit, so a packed file is limited to 4 GiB.
+//
+// GetSerializedKeyset() returns a zero-copy view into the mapping that can be
+// handed directly to BinaryKeysetReader::New(); GetKeysetHandle() materializes
+// a KeysetHandle for a keyset on first access and caches it. All methods of a
+// repository instance are thread-safe.
+class MmapKeysetRepository {
+ public:
+  // Opens the packed file 'filename' and memory-maps it.
+  static crypto::tink::util::StatusOr<std::unique_ptr<MmapKeysetRepository>>
+  Open(absl::string_view filename);
+
+  // Writes the given (name, serialized keyset)-pairs to 'destination' in the
+  // packed file format understood by Open().
+  static crypto::tink::util::Status Pack(
+      const std::vector<std::pair<std::string, std::string>>& keysets,
+      std::ostream* destination);
+
+  ~MmapKeysetRepository();
+
+  // Returns the names of all keysets in this repository.
+  std::vector<std::string> KeysetNames() const;
+
+  // Returns a view of the serialized keyset with the given name; the view is
+  // valid as long as this repository exists.
+  crypto::tink::util::StatusOr<absl::string_view> GetSerializedKeyset(
+      absl::string_view name) const;
+
+  // Returns a handle for the keyset with the given name. The handle is
+  // parsed from the mapping on first access and cached afterwards.
+  crypto::tink::util::StatusOr<std::shared_ptr<const KeysetHandle>>
+  GetKeysetHandle(absl::string_view name) const;
+
+ private:
+  MmapKeysetRepository(int fd, char* mmap_addr, int64_t file_size)
+      : fd_(fd), mmap_addr_(mmap_addr), file_size_(file_size) {}
+
+  int fd_;
+  char* mmap_addr_;
+  int64_t file_size_;
+  // Maps keyset names to slices of the mapping; read-only after Open().
+  std::unordered_map<std::string, absl::string_view> index_;
+  mutable absl::Mutex handles_mutex_;
+  mutable std::unordered_map<std::string, std::shared_ptr<const KeysetHandle>>
+      handles_ ABSL_GUARDED_BY(handles_mutex_);
+};
+
+}  // namespace util
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_UTIL_MMAP_KEYSET_REPOSITORY_H_
@@ -0,0 +1,153 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/util/mmap_keyset_repository.h"
+
+#include <unistd.h>
+
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
+#include "tink/cleartext_keyset_handle.h"
+#include "tink/util/test_util.h"
+#include "proto/aes_gcm.pb.h"
+#include "proto/tink.pb.h"
+
+namespace crypto {
+namespace tink {
+namespace util {
+namespace {
+
+using ::crypto::tink::test::AddTinkKey;
+using ::google::crypto::tink::AesGcmKey;
+using ::google::crypto::tink::KeyData;
+using ::google::crypto::tink::Keyset;
+using ::google::crypto::tink::KeyStatusType;
+
+// Returns a serialized keyset with a single AES-GCM key with the given id.
+std::string NewSerializedKeyset(uint32_t key_id) {
+  Keyset keyset;
+  AesGcmKey key;
+  key.set_version(0);
+  key.set_key_value(absl::StrCat("some key value for key ", key_id));
+  AddTinkKey("type.googleapis.com/google.crypto.tink.AesGcmKey", key_id, key,
+             KeyStatusType::ENABLED, KeyData::SYMMETRIC, &keyset);
+  keyset.set_primary_key_id(key_id);
+  return keyset.SerializeAsString();
+}
+
+// Packs the given keysets, writes them to a test file with the given name,
+// and returns the full filename.
+std::string WriteRepositoryFile(
+    absl::string_view filename,
+    const std::vector<std::pair<std::string, std::string>>& keysets) {
+  std::stringstream packed;
+  auto pack_status = MmapKeysetRepository::Pack(keysets, &packed);
+  EXPECT_TRUE(pack_status.ok()) << pack_status;
+  std::string full_filename = absl::StrCat(test::TmpDir(), "/", filename);
+  close(test::GetTestFileDescriptor(filename, packed.str()));
+  return full_filename;
+}
+
+TEST(MmapKeysetRepositoryTest, ReadSerializedKeysets) {
+  std::vector<std::pair<std::string, std::string>> keysets = {
+      {"tenant-a", NewSerializedKeyset(42)},
+      {"tenant-b", NewSerializedKeyset(711)},
+      {"tenant-c", NewSerializedKeyset(4242)},
+  };
+  std::string filename = WriteRepositoryFile("keyset_repository", keysets);
+
+  auto repository_result = MmapKeysetRepository::Open(filename);
+  ASSERT_TRUE(repository_result.ok()) << repository_result.status();
+  auto repository = std::move(repository_result.ValueOrDie());
+  EXPECT_EQ(3, repository->KeysetNames().size());
+  for (const auto& keyset : keysets) {
+    auto serialized_result = repository->GetSerializedKeyset(keyset.first);
+    ASSERT_TRUE(serialized_result.ok()) << serialized_result.status();
+    EXPECT_EQ(keyset.second, serialized_result.ValueOrDie());
+  }
+  auto missing_result = repository->GetSerializedKeyset("no such tenant");
+  EXPECT_FALSE(missing_result.ok());
+  EXPECT_EQ(util::error::NOT_FOUND, missing_result.status().error_code());
+}
+
+TEST(MmapKeysetRepositoryTest, GetKeysetHandleIsLazyAndCached) {
+  std::vector<std::pair<std::string, std::string>> keysets = {
+      {"tenant-a", NewSerializedKeyset(42)},
+      {"tenant-b", NewSerializedKeyset(711)},
+  };
+  std::string filename = WriteRepositoryFile("keyset_repository_2", keysets);
+
+  auto repository_result = MmapKeysetRepository::Open(filename);
+  ASSERT_TRUE(repository_result.ok()) << repository_result.status();
+  auto repository = std::move(repository_result.ValueOrDie());
+  auto handle_result = repository->GetKeysetHandle("tenant-a");
+  ASSERT_TRUE(handle_result.ok()) << handle_result.status();
+  auto handle = handle_result.ValueOrDie();
+  EXPECT_EQ(42, CleartextKeysetHandle::GetKeyset(*handle).primary_key_id());
+
+  // Repeated access returns the cached handle.
+  auto second_result = repository->GetKeysetHandle("tenant-a");
+  ASSERT_TRUE(second_result.ok()) << second_result.status();
+  EXPECT_EQ(handle.get(), second_result.ValueOrDie().get());
+
+  auto missing_result = repository->GetKeysetHandle("no such tenant");
+  EXPECT_FALSE(missing_result.ok());
+  EXPECT_EQ(util::error::NOT_FOUND, missing_result.status().error_code());
+}
+
+TEST(MmapKeysetRepositoryTest, OpenRejectsCorruptFiles) {
+  {  // Missing file.
+    auto result = MmapKeysetRepository::Open(
+        absl::StrCat(test::TmpDir(), "/keyset_repository_does_not_exist"));
+    EXPECT_FALSE(result.ok());
+    EXPECT_EQ(util::error::NOT_FOUND, result.status().error_code());
+  }
+
+  {  // Wrong magic value.
+    std::string filename =
+        absl::StrCat(test::TmpDir(), "/keyset_repository_bad_magic");
+    close(test::GetTestFileDescriptor("keyset_repository_bad_magic",
+                                      "not a keyset repository"));
+    auto result = MmapKeysetRepository::Open(filename);
+    EXPECT_FALSE(result.ok());
+    EXPECT_EQ(util::error::INVALID_ARGUMENT, result.status().error_code());
+  }
+
+  {  // Truncated index.
+    std::stringstream packed;
+    auto pack_status = MmapKeysetRepository::Pack(
+        {{"tenant-a", NewSerializedKeyset(42)}}, &packed);
+    ASSERT_TRUE(pack_status.ok()) << pack_status;
+    std::string truncated = packed.str().substr(0, 14);
+    std::string filename =
+        absl::StrCat(test::TmpDir(), "/keyset_repository_truncated");
+    close(test::GetTestFileDescriptor("keyset_repository_truncated",
+                                      truncated));
+    auto result = MmapKeysetRepository::Open(filename);
+    EXPECT_FALSE(result.ok());
+    EXPECT_EQ(util::error::INVALID_ARGUMENT, result.status().error_code());
+  }
+}
+
+}  // namespace
+}  // namespace util
+}  // namespace tink
+}  // namespace crypto
@@ -0,0 +1,131 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/util/mmap_random_access_stream.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+
+#include "tink/random_access_stream.h"
+#include "tink/util/buffer.h"
+#include "tink/util/errors.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace util {
+
+using crypto::tink::util::Status;
+using crypto::tink::util::StatusOr;
+
+namespace {
+
+// Attempts to close file descriptor fd, while ignoring EINTR.
+// (code borrowed from ZeroCopy-streams)
+int close_ignoring_eintr(int fd) {
+  int result;
+  do {
+    result = close(fd);
+  } while (result < 0 && errno == EINTR);
+  return result;
+}
+
+}  // anonymous namespace
+
+MmapRandomAccessStream::MmapRandomAccessStream(int file_descriptor,
+                                               int64_t readahead_window) :
+    readahead_window_(readahead_window >= 0 ? readahead_window
+                      : 2 * 1024 * 1024) {  // 2 MB
+  fd_ = file_descriptor;
+  page_size_ = sysconf(_SC_PAGESIZE);
+  mmap_addr_ = nullptr;
+  file_size_ = 0;
+  status_ = Status::OK;
+  struct stat s;
+  if (fstat(fd_, &s) == -1) {
+    status_ = ToStatusF(util::error::UNAVAILABLE,
+                        "could not stat the file: %d", errno);
+    return;
+  }
+  file_size_ = s.st_size;
+  if (file_size_ == 0) return;  // mmap of a 0-length file would fail
+  void* addr = mmap(nullptr, file_size_, PROT_READ, MAP_SHARED, fd_, 0);
+  if (addr == MAP_FAILED) {
+    status_ = ToStatusF(util::error::UNAVAILABLE,
+                        "could not mmap the file: %d", errno);
+    return;
+  }
+  mmap_addr_ = static_cast<char*>(addr);
+}
+
+void MmapRandomAccessStream::Readahead(int64_t position) {
+  if (readahead_window_ == 0 || position >= file_size_) return;
+  // madvise operates on page-aligned regions.
+  int64_t start = (position / page_size_) * page_size_;
+  int64_t length = std::min(position + readahead_window_, file_size_) - start;
+  madvise(mmap_addr_ + start, length, MADV_WILLNEED);
+}
+
+Status MmapRandomAccessStream::PRead(int64_t position, int count,
+                                     Buffer* dest_buffer) {
+  if (dest_buffer == nullptr) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "dest_buffer must be non-null");
+  }
+  if (count <= 0) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "count must be positive");
+  }
+  if (count > dest_buffer->allocated_size()) {
+    return util::Status(util::error::INVALID_ARGUMENT, "buffer too small");
+  }
+  if (position < 0) {
+    return util::Status(util::error::INVALID_ARGUMENT,
+                        "position cannot be negative");
+  }
+  if (!status_.ok()) return status_;
+  if (position >= file_size_) {
+    dest_buffer->set_size(0).IgnoreError();
+    return Status(util::error::OUT_OF_RANGE, "EOF");
+  }
+  int read_count = std::min(static_cast<int64_t>(count),
+                            file_size_ - position);
+  crypto::tink::util::Status status = dest_buffer->set_size(read_count);
+  if (!status.ok()) return status;
+  memcpy(dest_buffer->get_mem_block(), mmap_addr_ + position, read_count);
+  Readahead(position + read_count);
+  return Status::OK;
+}
+
+MmapRandomAccessStream::~MmapRandomAccessStream() {
+  if (mmap_addr_ != nullptr) {
+    munmap(mmap_addr_, file_size_);
+  }
+  close_ignoring_eintr(fd_);
+}
+
+StatusOr<int64_t> MmapRandomAccessStream::size() {
+  if (!status_.ok()) return status_;
+  return file_size_;
+}
+
+}  // namespace util
+}  // namespace tink
+}  // namespace crypto
@@ -0,0 +1,74 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_UTIL_MMAP_RANDOM_ACCESS_STREAM_H_
+#define TINK_UTIL_MMAP_RANDOM_ACCESS_STREAM_H_
+
+#include <memory>
+
+#include "tink/random_access_stream.h"
+#include "tink/util/buffer.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace util {
+
+// A RandomAccessStream that memory-maps a file and serves PRead-requests
+// by copying from the mapping, avoiding the read-syscall per request that
+// FileRandomAccessStream incurs. After each PRead it advises the kernel
+// (via madvise(MADV_WILLNEED)) to prefetch a window of the file following
+// the read position, so that subsequent sequential-ish reads hit pages
+// that are already resident. Can be plugged in anywhere a
+// RandomAccessStream is accepted, e.g. DecryptingRandomAccessStream.
+class MmapRandomAccessStream : public crypto::tink::RandomAccessStream {
+ public:
+  // Constructs a MmapRandomAccessStream that will read from the file
+  // specified via 'file_descriptor', and that after each PRead hints the
+  // kernel to prefetch the next 'readahead_window' bytes of the file, if
+  // any (if no legal 'readahead_window' is given, a reasonable default
+  // will be used; a window of 0 disables the hints).
+  // Takes the ownership of the file, and will close it upon destruction.
+  explicit MmapRandomAccessStream(int file_descriptor,
+                                  int64_t readahead_window = -1);
+
+  ~MmapRandomAccessStream() override;
+
+  crypto::tink::util::Status PRead(int64_t position,
+                                   int count,
+                                   Buffer* dest_buffer) override;
+
+  crypto::tink::util::StatusOr<int64_t> size() override;
+
+ private:
+  // Advises the kernel to prefetch the readahead window starting
+  // at 'position'; a best-effort hint, failures are ignored.
+  void Readahead(int64_t position);
+
+  int fd_;
+  int64_t readahead_window_;
+  int64_t page_size_;
+  util::Status status_;  // status of the construction-time mapping
+  char* mmap_addr_;      // nullptr if the file is empty or mmap failed
+  int64_t file_size_;
+};
+
+}  // namespace util
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_UTIL_MMAP_RANDOM_ACCESS_STREAM_H_
@@ -17,8 +17,11 @@
 #ifndef TINK_UTIL_SECRET_DATA_H_
 #define TINK_UTIL_SECRET_DATA_H_
 
+#include <cstddef>
 #include <memory>
+#include <string>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "absl/strings/string_view.h"
@@ -109,6 +112,119 @@ inline SecretData SecretDataFromStringView(absl::string_view secret) {
   return {secret.begin(), secret.end()};
 }
 
+// Adopts the contents of 'secret': the returned SecretData holds a sanitized
+// copy, and the source is cleansed in place before it is released, so no
+// plaintext copy of the data outlives the call. Prefer this over
+// SecretDataFromStringView whenever a std::string holding the key material
+// (e.g. a parsed proto field) is already owned and no longer needed.
+inline SecretData SecretDataFromString(std::string&& secret) {
+  SecretData data(secret.begin(), secret.end());
+  if (!secret.empty()) {
+    internal::SafeZeroMemory(&secret[0], secret.size());
+  }
+  secret.clear();
+  return data;
+}
+
+// Activates, for the current thread and the lifetime of this object, a bump
+// region from which SecretData storage is allocated. All blocks handed out
+// from the region are wiped together when the arena goes out of scope, so a
+// derivation chain producing several short-lived SecretData temporaries
+// (HKDF outputs, split key halves, ...) pays for one allocation and one
+// cleansing pass instead of one per temporary.
+//
+// Every SecretData allocated while the arena is active MUST release its
+// storage before the arena goes out of scope; results that outlive the scope
+// have to be allocated (e.g. resized to their final size) beforehand and
+// filled in by copy. Allocations that do not fit into the remaining capacity
+// transparently fall back to the regular sanitized heap. Arenas may nest.
+class ScopedSecretArena {
+ public:
+  explicit ScopedSecretArena(std::size_t capacity) {
+    state_.base = static_cast<char*>(::operator new(capacity));
+    state_.capacity = capacity;
+    state_.prev = internal::ThreadActiveSecretArena();
+    internal::ThreadActiveSecretArena() = &state_;
+  }
+
+  ~ScopedSecretArena() {
+    internal::ThreadActiveSecretArena() = state_.prev;
+    internal::SafeZeroMemory(state_.base, state_.used);
+    ::operator delete(state_.base);
+  }
+
+  ScopedSecretArena(const ScopedSecretArena&) = delete;
+  ScopedSecretArena& operator=(const ScopedSecretArena&) = delete;
+
+ private:
+  internal::SecretArenaState state_;
+};
+
+// A heap-owned secret region with bulk teardown, intended to back all
+// SecretData (and SecretUniquePtr storage) of one keyset's primitives.
+// Unlike ScopedSecretArena, the arena outlives its activation scope: blocks
+// freed from it are not cleansed individually, and destroying the arena
+// wipes the whole used range in a single pass and releases it in one
+// operation. This turns the destructor cascade of a PrimitiveSet -- one
+// OPENSSL_cleanse-style wipe and one allocator round trip per key -- into a
+// single wipe and a single free, which matters when tenant eviction tears
+// down thousands of primitives at once.
+//
+// Usage:
+//   auto arena = absl::make_unique<util::SecretArena>(capacity);
+//   {
+//     util::SecretArena::ScopedActivation activation(arena.get());
+//     ... build the keyset's primitives ...
+//   }
+//   ... keep 'arena' alive next to the primitives; destroying it after the
+//   primitives wipes all their key material in one pass ...
+//
+// Allocations that do not fit into the remaining capacity fall back to the
+// regular sanitized heap and keep their individual cleansing. Activate on
+// one thread at a time; freeing arena-backed blocks is safe from any thread
+// while the arena is alive.
+class SecretArena {
+ public:
+  explicit SecretArena(std::size_t capacity) {
+    state_.base = static_cast<char*>(::operator new(capacity));
+    state_.capacity = capacity;
+    state_.deferred_cleanse = true;
+    internal::RegisterSecretArena(&state_);
+  }
+
+  ~SecretArena() {
+    internal::DeregisterSecretArena(&state_);
+    internal::SafeZeroMemory(state_.base, state_.used);
+    ::operator delete(state_.base);
+  }
+
+  SecretArena(const SecretArena&) = delete;
+  SecretArena& operator=(const SecretArena&) = delete;
+
+  // While in scope, SecretData allocations on the current thread that fit
+  // are served from 'arena'. Activations may nest with other arenas.
+  class ScopedActivation {
+   public:
+    explicit ScopedActivation(SecretArena* arena) : state_(&arena->state_) {
+      state_->prev = internal::ThreadActiveSecretArena();
+      internal::ThreadActiveSecretArena() = state_;
+    }
+
+    ~ScopedActivation() {
+      internal::ThreadActiveSecretArena() = state_->prev;
+    }
+
+    ScopedActivation(const ScopedActivation&) = delete;
+    ScopedActivation& operator=(const ScopedActivation&) = delete;
+
+   private:
+    internal::SecretArenaState* state_;
+  };
+
+ private:
+  internal::SecretArenaState state_;
+};
+
 template <typename T>
 class SecretValue {
  public:
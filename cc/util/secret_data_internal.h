@@ -17,8 +17,10 @@
 #ifndef TINK_UTIL_SECRET_DATA_INTERNAL_H_
 #define TINK_UTIL_SECRET_DATA_INTERNAL_H_
 
+#include <atomic>
 #include <cstddef>
 #include <memory>
+#include <mutex>
 
 #include "absl/base/attributes.h"
 
@@ -35,6 +37,187 @@ inline void SafeZeroMemory(char* ptr, std::size_t size) {
   }
 }
 
+// A size-classed pool of memory blocks backing SanitizingAllocator. Freed
+// blocks are zeroed immediately (the pool never holds key material) and kept
+// on a per-class free list instead of being returned to the OS, so that
+// workloads churning many short-lived SecretData buffers pay the allocation
+// cost only once per block. Blocks larger than the largest size class bypass
+// the pool. Thread-safe.
+class SanitizingBlockPool {
+ public:
+  static SanitizingBlockPool& GlobalInstance() {
+    // The pool is never destroyed: blocks stay usable during process
+    // shutdown, and all its memory is zeroed anyway.
+    static SanitizingBlockPool* instance = new SanitizingBlockPool();
+    return *instance;
+  }
+
+  ABSL_MUST_USE_RESULT void* Allocate(std::size_t size) {
+    int size_class = SizeClass(size);
+    if (size_class >= 0) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      FreeBlock* block = free_lists_[size_class];
+      if (block != nullptr) {
+        free_lists_[size_class] = block->next;
+        free_counts_[size_class]--;
+        block->next = nullptr;
+        return block;
+      }
+    }
+    return ::operator new(size_class >= 0 ? ClassSize(size_class) : size);
+  }
+
+  void Deallocate(void* ptr, std::size_t size) noexcept {
+    SafeZeroMemory(static_cast<char*>(ptr), size);
+    int size_class = SizeClass(size);
+    if (size_class >= 0) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (free_counts_[size_class] < kMaxBlocksPerClass) {
+        FreeBlock* block = static_cast<FreeBlock*>(ptr);
+        block->next = free_lists_[size_class];
+        free_lists_[size_class] = block;
+        free_counts_[size_class]++;
+        return;
+      }
+    }
+    ::operator delete(ptr);
+  }
+
+ private:
+  // Size classes are the powers of two from 32 to 4096 bytes, covering key
+  // material and key-derivation buffers; each class retains at most
+  // kMaxBlocksPerClass freed blocks (at most ~520 KiB in total).
+  static constexpr std::size_t kMinClassSize = 32;
+  static constexpr std::size_t kMaxClassSize = 4096;
+  static constexpr int kNumClasses = 8;
+  static constexpr int kMaxBlocksPerClass = 64;
+
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  SanitizingBlockPool() = default;
+
+  // Returns the smallest size class that fits 'size', or -1 if the pool
+  // does not handle this size.
+  static int SizeClass(std::size_t size) {
+    if (size == 0 || size > kMaxClassSize) return -1;
+    int size_class = 0;
+    std::size_t class_size = kMinClassSize;
+    while (class_size < size) {
+      class_size <<= 1;
+      size_class++;
+    }
+    return size_class;
+  }
+
+  static std::size_t ClassSize(int size_class) {
+    return kMinClassSize << size_class;
+  }
+
+  std::mutex mutex_;
+  FreeBlock* free_lists_[kNumClasses] = {};
+  int free_counts_[kNumClasses] = {};
+};
+
+// A bump region for short-lived secret temporaries, activated per thread by
+// util::ScopedSecretArena. While an arena is active, SanitizingAllocator
+// serves allocations that fit from its region; freed blocks are zeroed but
+// not reused, and the whole region is wiped in one pass when the arena goes
+// out of scope. Allocations that do not fit fall through to the block pool.
+struct SecretArenaState {
+  char* base = nullptr;
+  std::size_t capacity = 0;
+  std::size_t used = 0;
+  SecretArenaState* prev = nullptr;  // next-outer arena on this thread
+  // If set, blocks freed from this arena are not zeroed individually; the
+  // owner wipes the whole used range in one pass on teardown instead
+  // (see util::SecretArena).
+  bool deferred_cleanse = false;
+  SecretArenaState* next_registered = nullptr;  // see RegisterSecretArena
+};
+
+inline SecretArenaState*& ThreadActiveSecretArena() {
+  thread_local SecretArenaState* active = nullptr;
+  return active;
+}
+
+// Global registry of long-lived arenas (util::SecretArena), so that their
+// blocks are recognized on deallocation from any thread, also after the
+// arena's activation scope has ended. The count allows the deallocation hot
+// path to skip the registry lock entirely while no such arena exists.
+inline std::mutex& RegisteredSecretArenaMutex() {
+  static std::mutex* mutex = new std::mutex();
+  return *mutex;
+}
+
+inline SecretArenaState*& RegisteredSecretArenaHead() {
+  static SecretArenaState* head = nullptr;
+  return head;
+}
+
+inline std::atomic<int>& RegisteredSecretArenaCount() {
+  static std::atomic<int>* count = new std::atomic<int>(0);
+  return *count;
+}
+
+inline void RegisterSecretArena(SecretArenaState* arena) {
+  std::lock_guard<std::mutex> lock(RegisteredSecretArenaMutex());
+  arena->next_registered = RegisteredSecretArenaHead();
+  RegisteredSecretArenaHead() = arena;
+  RegisteredSecretArenaCount().fetch_add(1, std::memory_order_release);
+}
+
+inline void DeregisterSecretArena(SecretArenaState* arena) {
+  std::lock_guard<std::mutex> lock(RegisteredSecretArenaMutex());
+  SecretArenaState** link = &RegisteredSecretArenaHead();
+  while (*link != nullptr) {
+    if (*link == arena) {
+      *link = arena->next_registered;
+      RegisteredSecretArenaCount().fetch_sub(1, std::memory_order_release);
+      return;
+    }
+    link = &(*link)->next_registered;
+  }
+}
+
+inline void* SecretArenaAllocate(std::size_t size) {
+  SecretArenaState* arena = ThreadActiveSecretArena();
+  if (arena == nullptr) return nullptr;
+  constexpr std::size_t kAlignment = alignof(std::max_align_t);
+  std::size_t aligned_size = (size + kAlignment - 1) & ~(kAlignment - 1);
+  if (aligned_size > arena->capacity - arena->used) return nullptr;
+  void* ptr = arena->base + arena->used;
+  arena->used += aligned_size;
+  return ptr;
+}
+
+// Returns true if 'ptr' belongs to an active arena on this thread or to a
+// registered long-lived arena; the block's memory is then reclaimed with the
+// arena region. Unless the owning arena defers cleansing to its one-pass
+// teardown wipe, the block is zeroed here.
+inline bool SecretArenaDeallocate(void* ptr, std::size_t size) noexcept {
+  char* block = static_cast<char*>(ptr);
+  for (SecretArenaState* arena = ThreadActiveSecretArena(); arena != nullptr;
+       arena = arena->prev) {
+    if (block >= arena->base && block < arena->base + arena->capacity) {
+      if (!arena->deferred_cleanse) SafeZeroMemory(block, size);
+      return true;
+    }
+  }
+  if (RegisteredSecretArenaCount().load(std::memory_order_acquire) > 0) {
+    std::lock_guard<std::mutex> lock(RegisteredSecretArenaMutex());
+    for (SecretArenaState* arena = RegisteredSecretArenaHead();
+         arena != nullptr; arena = arena->next_registered) {
+      if (block >= arena->base && block < arena->base + arena->capacity) {
+        if (!arena->deferred_cleanse) SafeZeroMemory(block, size);
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 template <typename T>
 struct SanitizingAllocator {
   typedef T value_type;
@@ -45,12 +228,15 @@ struct SanitizingAllocator {
       const SanitizingAllocator<U>&) noexcept {}
 
   ABSL_MUST_USE_RESULT T* allocate(std::size_t n) {
-    return std::allocator<T>().allocate(n);
+    void* arena_block = SecretArenaAllocate(n * sizeof(T));
+    if (arena_block != nullptr) return static_cast<T*>(arena_block);
+    return static_cast<T*>(
+        SanitizingBlockPool::GlobalInstance().Allocate(n * sizeof(T)));
   }
 
   void deallocate(T* ptr, std::size_t n) noexcept {
-    SafeZeroMemory(reinterpret_cast<char*>(ptr), n * sizeof(T));
-    std::allocator<T>().deallocate(ptr, n);
+    if (SecretArenaDeallocate(ptr, n * sizeof(T))) return;
+    SanitizingBlockPool::GlobalInstance().Deallocate(ptr, n * sizeof(T));
   }
 
   // Allocator requirements mandate definition of eq and neq operators
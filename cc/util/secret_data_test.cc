@@ -16,6 +16,8 @@
 
 #include "tink/util/secret_data.h"
 
+#include <cstring>
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/strings/string_view.h"
@@ -50,6 +52,18 @@ TEST(SecretDataTest, SecretDataFromStringViewConstructor) {
   EXPECT_THAT(data, ElementsAreArray(kContents));
 }
 
+TEST(SecretDataTest, SecretDataFromStringCleansesSource) {
+  constexpr unsigned char kContents[] = {41, 42, 64, 12, 41,  0,
+                                         52, 56, 6,  12, 124, 16};
+  std::string s;
+  for (unsigned char c : kContents) {
+    s.push_back(c);
+  }
+  SecretData data = SecretDataFromString(std::move(s));
+  EXPECT_THAT(data, ElementsAreArray(kContents));
+  EXPECT_THAT(s, Eq(""));  // NOLINT(bugprone-use-after-move)
+}
+
 TEST(SecretDataTest, StringViewFromSecretData) {
   constexpr unsigned char kContents[] = {41, 42, 64, 12, 41,  0,
                                          52, 56, 6,  12, 124, 16};
@@ -111,6 +125,98 @@ TEST(SecretValueTest, MoveAssignment) {
   EXPECT_THAT(s.value(), AnyOf(Eq(0), Eq(102)));
 }
 
+TEST(SanitizingBlockPoolTest, RecyclesCleansedBlocks) {
+  auto& pool = internal::SanitizingBlockPool::GlobalInstance();
+  char* block = static_cast<char*>(pool.Allocate(100));
+  memset(block, 'k', 100);
+  pool.Deallocate(block, 100);
+  // The freed block is recycled for the next allocation of the same size
+  // class, and must come back cleansed.
+  char* recycled = static_cast<char*>(pool.Allocate(100));
+  EXPECT_THAT(recycled, Eq(block));
+  for (int i = 0; i < 100; i++) {
+    EXPECT_THAT(recycled[i], Eq(0)) << "at position " << i;
+  }
+  pool.Deallocate(recycled, 100);
+}
+
+TEST(SanitizingBlockPoolTest, OversizedBlocksBypassThePool) {
+  auto& pool = internal::SanitizingBlockPool::GlobalInstance();
+  char* block = static_cast<char*>(pool.Allocate(1 << 20));
+  memset(block, 'k', 1 << 20);
+  pool.Deallocate(block, 1 << 20);
+}
+
+TEST(ScopedSecretArenaTest, BumpAllocatesConsecutiveBlocks) {
+  ScopedSecretArena arena(1024);
+  SecretData first(16, 1);
+  SecretData second(16, 2);
+  // Both blocks come from the same bump region, adjacent up to alignment.
+  auto distance = reinterpret_cast<const char*>(second.data()) -
+                  reinterpret_cast<const char*>(first.data());
+  EXPECT_GE(distance, 16);
+  EXPECT_LE(distance, 64);
+  EXPECT_THAT(first, Eq(SecretData(16, 1)));
+  EXPECT_THAT(second, Eq(SecretData(16, 2)));
+}
+
+TEST(ScopedSecretArenaTest, OversizedAllocationsFallBack) {
+  ScopedSecretArena arena(64);
+  // Too large for the remaining arena capacity; served from the regular
+  // sanitized heap and freed there.
+  SecretData big(1024, 3);
+  EXPECT_THAT(big, Eq(SecretData(1024, 3)));
+}
+
+TEST(SecretArenaTest, BlocksOutliveTheActivationScope) {
+  SecretArena arena(1024);
+  SecretData data;
+  {
+    SecretArena::ScopedActivation activation(&arena);
+    data = SecretData(32, 1);
+  }
+  // The block stays valid after the activation ends and is reclaimed with
+  // the arena when 'data' is destroyed later.
+  EXPECT_THAT(data, Eq(SecretData(32, 1)));
+}
+
+TEST(SecretArenaTest, CleansingIsDeferredToArenaTeardown) {
+  SecretArena arena(1024);
+  const char* block;
+  {
+    SecretArena::ScopedActivation activation(&arena);
+    SecretData data(32, 42);
+    block = reinterpret_cast<const char*>(data.data());
+  }
+  // The individual destructor did not wipe the block; the arena does so in
+  // one pass when it is destroyed. The region is still owned by the arena
+  // here, so inspecting it is fine.
+  EXPECT_THAT(block[0], Eq(42));
+  EXPECT_THAT(block[31], Eq(42));
+}
+
+TEST(SecretArenaTest, OversizedAllocationsFallBack) {
+  SecretArena arena(64);
+  SecretArena::ScopedActivation activation(&arena);
+  SecretData big(1024, 3);
+  EXPECT_THAT(big, Eq(SecretData(1024, 3)));
+}
+
+TEST(ScopedSecretArenaTest, ArenasNest) {
+  ScopedSecretArena outer(256);
+  SecretData outer_data(16, 4);
+  {
+    ScopedSecretArena inner(256);
+    SecretData inner_data(16, 5);
+    EXPECT_THAT(inner_data, Eq(SecretData(16, 5)));
+    // Freeing a block of the outer arena while the inner one is active
+    // must find the owning arena.
+    outer_data = SecretData();
+  }
+  SecretData after_inner(16, 6);
+  EXPECT_THAT(after_inner, Eq(SecretData(16, 6)));
+}
+
 }  // namespace
 }  // namespace util
 }  // namespace tink
@@ -23,6 +23,7 @@
 #include "google/protobuf/arena.h"
 #include "absl/memory/memory.h"
 #include "tink/util/secret_data.h"
+#include "tink/util/statusor.h"
 
 namespace crypto {
 namespace tink {
@@ -48,6 +49,33 @@ inline google::protobuf::ArenaOptions SecretArenaOptions() {
 template <typename T>
 class SecretProto {
  public:
+  // Parses a serialized message directly onto the sanitizing arena. This
+  // avoids the intermediate heap-allocated message (and the field-by-field
+  // copy of the SecretProto(const T&) constructor): the parse is a handful of
+  // arena bumps instead of one allocation per field.
+  static crypto::tink::util::StatusOr<SecretProto<T>> ParseFromSecretData(
+      const SecretData& data) {
+    SecretProto<T> proto;
+    if (!proto.value_->ParseFromArray(data.data(), data.size())) {
+      return crypto::tink::util::Status(
+          crypto::tink::util::error::INVALID_ARGUMENT,
+          "Could not parse the input as a proto.");
+    }
+    return std::move(proto);
+  }
+
+  // Serializes the message into a SecretData, without materializing an
+  // intermediate plaintext std::string the way SerializeAsString() would.
+  crypto::tink::util::StatusOr<SecretData> SerializeAsSecretData() const {
+    SecretData data(value_->ByteSizeLong());
+    if (!value_->SerializeToArray(data.data(), static_cast<int>(data.size()))) {
+      return crypto::tink::util::Status(
+          crypto::tink::util::error::INTERNAL,
+          "Could not serialize the proto.");
+    }
+    return std::move(data);
+  }
+
   SecretProto() {}
 
   SecretProto(const SecretProto& other) { *value_ = *other.value_; }
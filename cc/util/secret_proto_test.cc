@@ -62,6 +62,31 @@ NestedTestProto CreateProto<NestedTestProto>() {
   return proto;
 }
 
+TYPED_TEST(SecretProtoTest, ParseFromSecretData) {
+  TypeParam proto = CreateProto<TypeParam>();
+  SecretData serialized = SecretDataFromStringView(proto.SerializeAsString());
+  auto parsed = SecretProto<TypeParam>::ParseFromSecretData(serialized);
+  ASSERT_TRUE(parsed.ok()) << parsed.status();
+  EXPECT_TRUE(MessageDifferencer::Equals(*parsed.ValueOrDie(), proto));
+}
+
+TYPED_TEST(SecretProtoTest, SerializeAsSecretData) {
+  TypeParam proto = CreateProto<TypeParam>();
+  SecretProto<TypeParam> secret(proto);
+  auto serialized = secret.SerializeAsSecretData();
+  ASSERT_TRUE(serialized.ok()) << serialized.status();
+  TypeParam parsed;
+  ASSERT_TRUE(parsed.ParseFromArray(serialized.ValueOrDie().data(),
+                                    serialized.ValueOrDie().size()));
+  EXPECT_TRUE(MessageDifferencer::Equals(parsed, proto));
+}
+
+TYPED_TEST(SecretProtoTest, ParseFromSecretDataFailure) {
+  SecretData bad = SecretDataFromStringView("not a serialized proto");
+  auto parsed = SecretProto<TypeParam>::ParseFromSecretData(bad);
+  EXPECT_FALSE(parsed.ok());
+}
+
 TYPED_TEST(SecretProtoTest, DefaultConstructor) {
   SecretProto<TypeParam> s;
   EXPECT_TRUE(MessageDifferencer::Equals(*s, TypeParam()));
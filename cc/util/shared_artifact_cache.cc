@@ -0,0 +1,251 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/util/shared_artifact_cache.h"
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstring>
+
+#include "absl/base/internal/endian.h"
+#include "absl/memory/memory.h"
+#include "tink/util/errors.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace util {
+
+using crypto::tink::util::Status;
+using crypto::tink::util::StatusOr;
+
+namespace {
+
+const char kMagic[] = "TINKSAC1";
+const int kMagicSize = 8;
+// Magic, then 32-bit little-endian slot count and maximal artifact size.
+const int kHeaderSize = kMagicSize + 8;
+// Slots probed per fingerprint; bounds both lookup cost and how many
+// artifacts can collide on a slot range before one is evicted.
+const int kProbeLength = 4;
+
+// Fixed-size prefix of every slot in the mapping. 'sequence' implements a
+// per-slot seqlock shared between processes: it is odd while a writer is in
+// the slot, and a reader accepts a copy only if the sequence is even and
+// unchanged across the copy.
+struct SlotHeader {
+  std::atomic<uint32_t> sequence;
+  uint32_t size;
+  uint64_t fingerprint;  // 0 marks an empty slot
+};
+
+static_assert(sizeof(SlotHeader) == 16, "unexpected SlotHeader layout");
+
+// Slots are laid out with 8-byte alignment so the atomic sequence word is
+// naturally aligned in every slot.
+uint64_t SlotStride(uint32_t max_artifact_size) {
+  return sizeof(SlotHeader) + ((static_cast<uint64_t>(max_artifact_size) + 7) &
+                               ~static_cast<uint64_t>(7));
+}
+
+// Attempts to close file descriptor fd, while ignoring EINTR.
+// (code borrowed from ZeroCopy-streams)
+int close_ignoring_eintr(int fd) {
+  int result;
+  do {
+    result = close(fd);
+  } while (result < 0 && errno == EINTR);
+  return result;
+}
+
+}  // anonymous namespace
+
+// static
+StatusOr<std::unique_ptr<SharedArtifactCache>> SharedArtifactCache::New(
+    absl::string_view filename, uint32_t slot_count,
+    uint32_t max_artifact_size) {
+  if (slot_count == 0 || max_artifact_size == 0) {
+    return Status(util::error::INVALID_ARGUMENT,
+                  "slot_count and max_artifact_size must be positive");
+  }
+  std::string filename_str(filename);
+  int fd = open(filename_str.c_str(), O_RDWR | O_CREAT, 0600);
+  if (fd == -1) {
+    return ToStatusF(util::error::UNAVAILABLE, "could not open file '%s': %d",
+                     filename_str.c_str(), errno);
+  }
+  // Serialize initialization against other processes creating the same file.
+  if (flock(fd, LOCK_EX) == -1) {
+    close_ignoring_eintr(fd);
+    return ToStatusF(util::error::UNAVAILABLE, "could not lock the file: %d",
+                     errno);
+  }
+  struct stat s;
+  if (fstat(fd, &s) == -1) {
+    flock(fd, LOCK_UN);
+    close_ignoring_eintr(fd);
+    return ToStatusF(util::error::UNAVAILABLE, "could not stat the file: %d",
+                     errno);
+  }
+  int64_t file_size = s.st_size;
+  if (file_size == 0) {
+    // Fresh file: fix its geometry and zero all slots.
+    file_size = kHeaderSize + slot_count * SlotStride(max_artifact_size);
+    if (ftruncate(fd, file_size) == -1) {
+      flock(fd, LOCK_UN);
+      close_ignoring_eintr(fd);
+      return ToStatusF(util::error::UNAVAILABLE,
+                       "could not resize the file: %d", errno);
+    }
+    char header[kHeaderSize];
+    memcpy(header, kMagic, kMagicSize);
+    absl::little_endian::Store32(header + kMagicSize, slot_count);
+    absl::little_endian::Store32(header + kMagicSize + 4, max_artifact_size);
+    if (pwrite(fd, header, kHeaderSize, 0) != kHeaderSize) {
+      flock(fd, LOCK_UN);
+      close_ignoring_eintr(fd);
+      return ToStatusF(util::error::UNAVAILABLE,
+                       "could not write the header: %d", errno);
+    }
+  } else {
+    // Existing file: attach with the geometry recorded in it.
+    char header[kHeaderSize];
+    if (pread(fd, header, kHeaderSize, 0) != kHeaderSize ||
+        memcmp(header, kMagic, kMagicSize) != 0) {
+      flock(fd, LOCK_UN);
+      close_ignoring_eintr(fd);
+      return Status(util::error::INVALID_ARGUMENT,
+                    "Invalid shared artifact cache file");
+    }
+    slot_count = absl::little_endian::Load32(header + kMagicSize);
+    max_artifact_size = absl::little_endian::Load32(header + kMagicSize + 4);
+    int64_t expected_size =
+        kHeaderSize + slot_count * SlotStride(max_artifact_size);
+    if (slot_count == 0 || max_artifact_size == 0 ||
+        file_size != expected_size) {
+      flock(fd, LOCK_UN);
+      close_ignoring_eintr(fd);
+      return Status(util::error::INVALID_ARGUMENT,
+                    "Invalid shared artifact cache file");
+    }
+  }
+  void* addr =
+      mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  flock(fd, LOCK_UN);
+  if (addr == MAP_FAILED) {
+    close_ignoring_eintr(fd);
+    return ToStatusF(util::error::UNAVAILABLE, "could not mmap the file: %d",
+                     errno);
+  }
+  return {absl::WrapUnique(
+      new SharedArtifactCache(fd, static_cast<char*>(addr), file_size,
+                              slot_count, max_artifact_size))};
+}
+
+// static
+uint64_t SharedArtifactCache::FingerprintBytes(absl::string_view data) {
+  uint64_t hash = 14695981039346656037ULL;  // FNV-1a offset basis
+  for (char c : data) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 1099511628211ULL;  // FNV-1a prime
+  }
+  return hash;
+}
+
+SharedArtifactCache::~SharedArtifactCache() {
+  munmap(mmap_addr_, file_size_);
+  close_ignoring_eintr(fd_);
+}
+
+char* SharedArtifactCache::SlotAddress(uint32_t slot_index) const {
+  return mmap_addr_ + kHeaderSize + slot_index * SlotStride(max_artifact_size_);
+}
+
+Status SharedArtifactCache::Put(uint64_t fingerprint,
+                                absl::string_view artifact) {
+  if (fingerprint == 0) {
+    return Status(util::error::INVALID_ARGUMENT,
+                  "fingerprint 0 is reserved for empty slots");
+  }
+  if (artifact.size() > max_artifact_size_) {
+    return ToStatusF(util::error::INVALID_ARGUMENT,
+                     "artifact of %d bytes exceeds the cache's maximum of %d",
+                     static_cast<int>(artifact.size()),
+                     static_cast<int>(max_artifact_size_));
+  }
+  // Prefer a slot that is empty or already holds this fingerprint; otherwise
+  // evict the first probed slot.
+  uint32_t victim_index = fingerprint % slot_count_;
+  for (int probe = 0; probe < kProbeLength; probe++) {
+    uint32_t slot_index = (fingerprint + probe) % slot_count_;
+    SlotHeader* slot = reinterpret_cast<SlotHeader*>(SlotAddress(slot_index));
+    uint64_t slot_fingerprint = slot->fingerprint;
+    if (slot_fingerprint == 0 || slot_fingerprint == fingerprint) {
+      victim_index = slot_index;
+      break;
+    }
+  }
+  SlotHeader* slot = reinterpret_cast<SlotHeader*>(SlotAddress(victim_index));
+  uint32_t sequence = slot->sequence.load(std::memory_order_acquire);
+  if (sequence & 1) {
+    // Another writer (possibly of another process) is in the slot; the cache
+    // is best effort, so simply drop this artifact.
+    return Status::OK;
+  }
+  if (!slot->sequence.compare_exchange_strong(sequence, sequence + 1,
+                                              std::memory_order_acq_rel)) {
+    return Status::OK;  // lost the race for the slot; see above
+  }
+  slot->fingerprint = fingerprint;
+  slot->size = artifact.size();
+  memcpy(reinterpret_cast<char*>(slot) + sizeof(SlotHeader), artifact.data(),
+         artifact.size());
+  slot->sequence.store(sequence + 2, std::memory_order_release);
+  return Status::OK;
+}
+
+bool SharedArtifactCache::Get(uint64_t fingerprint,
+                              std::string* artifact) const {
+  if (fingerprint == 0 || artifact == nullptr) return false;
+  for (int probe = 0; probe < kProbeLength; probe++) {
+    uint32_t slot_index = (fingerprint + probe) % slot_count_;
+    const SlotHeader* slot =
+        reinterpret_cast<const SlotHeader*>(SlotAddress(slot_index));
+    uint32_t sequence_before = slot->sequence.load(std::memory_order_acquire);
+    if (sequence_before & 1) continue;  // a writer is in the slot
+    if (slot->fingerprint != fingerprint) continue;
+    uint32_t size = slot->size;
+    if (size > max_artifact_size_) continue;  // torn write; skip
+    artifact->assign(reinterpret_cast<const char*>(slot) + sizeof(SlotHeader),
+                     size);
+    // Accept the copy only if no writer touched the slot while it was made.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot->sequence.load(std::memory_order_relaxed) == sequence_before) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace util
+}  // namespace tink
+}  // namespace crypto
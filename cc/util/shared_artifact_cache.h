@@ -0,0 +1,106 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_UTIL_SHARED_ARTIFACT_CACHE_H_
+#define TINK_UTIL_SHARED_ARTIFACT_CACHE_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "absl/strings/string_view.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace util {
+
+// An opt-in, best-effort cache of keyset-derived artifacts shared between
+// the processes of one host via a memory-mapped file: keyset fingerprint ->
+// artifact bytes. Sidecar deployments in which many processes wrap the same
+// keysets can have the first process record the non-secret products of that
+// work (e.g. a serialized KeysetInfo, validation verdicts, precomputed
+// dispatch tables) and the remaining ones pick them up instead of redoing it.
+//
+// The cache must never hold unprotected secret key material: live primitives,
+// parsed key protos and cipher contexts all embed secrets (or pointers that
+// are meaningless in another process) and are deliberately not shareable
+// through this class. Only artifacts that are safe to expose to every process
+// that can open the backing file may be stored.
+//
+// Reads are copy-on-attach: Get() copies the artifact out of the shared
+// mapping under a per-slot sequence check, so a caller never holds references
+// into memory another process may concurrently overwrite. The cache is a
+// fixed-size, direct-mapped slot array; storing an artifact may evict another
+// one, and concurrent writers may cause a Put() to be dropped. Callers must
+// treat every lookup as fallible and be able to recompute the artifact.
+//
+// Fingerprints must be stable across processes; KeysetHandle::Fingerprint()
+// is process-local and unsuitable. Use FingerprintBytes() over the serialized
+// keyset the processes received. Fingerprint 0 is reserved.
+class SharedArtifactCache {
+ public:
+  // Opens (or creates with the given geometry) the backing file 'filename'
+  // and maps it shared. If the file already exists, the geometry recorded in
+  // it is used and 'slot_count' and 'max_artifact_size' are ignored.
+  static crypto::tink::util::StatusOr<std::unique_ptr<SharedArtifactCache>>
+  New(absl::string_view filename, uint32_t slot_count,
+      uint32_t max_artifact_size);
+
+  // A 64-bit FNV-1a hash of 'data'; deterministic across processes, so
+  // suitable for keying this cache by the serialized keyset bytes.
+  static uint64_t FingerprintBytes(absl::string_view data);
+
+  ~SharedArtifactCache();
+
+  // Stores 'artifact' under 'fingerprint'; best effort -- the artifact may
+  // be dropped under writer contention and may later be evicted by other
+  // stores. Fails with INVALID_ARGUMENT if 'fingerprint' is 0 or 'artifact'
+  // exceeds the cache's maximal artifact size.
+  crypto::tink::util::Status Put(uint64_t fingerprint,
+                                 absl::string_view artifact);
+
+  // Copies the artifact stored under 'fingerprint' into '*artifact' and
+  // returns true, or returns false if no (consistent) entry is present.
+  bool Get(uint64_t fingerprint, std::string* artifact) const;
+
+  // The maximal artifact size of the attached cache.
+  uint32_t max_artifact_size() const { return max_artifact_size_; }
+
+ private:
+  SharedArtifactCache(int fd, char* mmap_addr, int64_t file_size,
+                      uint32_t slot_count, uint32_t max_artifact_size)
+      : fd_(fd),
+        mmap_addr_(mmap_addr),
+        file_size_(file_size),
+        slot_count_(slot_count),
+        max_artifact_size_(max_artifact_size) {}
+
+  char* SlotAddress(uint32_t slot_index) const;
+
+  int fd_;
+  char* mmap_addr_;
+  int64_t file_size_;
+  uint32_t slot_count_;
+  uint32_t max_artifact_size_;
+};
+
+}  // namespace util
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_UTIL_SHARED_ARTIFACT_CACHE_H_
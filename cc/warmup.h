@@ -0,0 +1,60 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_WARMUP_H_
+#define TINK_WARMUP_H_
+
+#include "tink/util/status.h"
+
+namespace crypto {
+namespace tink {
+
+///////////////////////////////////////////////////////////////////////////////
+// Optional interface for moving first-use costs of a primitive to startup.
+//
+// The first operation with each key pays one-time costs that do not recur
+// in steady state: lazy construction of the underlying primitive, CPU
+// feature dispatch resolution in the crypto library, page faults on key
+// schedules. Primitives which can absorb these costs up front implement
+// this interface alongside their primitive interface; callers discover
+// support via dynamic_cast:
+//
+//   auto* warmable = dynamic_cast<const Warmable*>(aead.get());
+//   if (warmable != nullptr) {
+//     auto status = warmable->Warmup();
+//   }
+//
+// Primitives obtained through KeysetHandle::GetPrimitive() are wrapper
+// objects; those wrappers implement this interface by running a
+// representative dummy operation with every key of the wrapped keyset, so
+// the first real operation hits warm code paths regardless of which key it
+// selects.
+class Warmable {
+ public:
+  // Runs representative dummy operations so that subsequent real operations
+  // start in steady state. Warmup is best-effort: every key is attempted
+  // even if some fail, and the first error encountered is returned. Safe to
+  // call multiple times; later calls are cheap no-ops semantically (they
+  // redo the dummy operations, which are then already warm).
+  virtual crypto::tink::util::Status Warmup() const = 0;
+
+  virtual ~Warmable() {}
+};
+
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_WARMUP_H_
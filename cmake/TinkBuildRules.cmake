@@ -55,6 +55,68 @@ list(APPEND TINK_INCLUDE_DIRS "${TINK_GENFILE_DIR}")
 
 set(TINK_IDE_FOLDER "Tink")
 
+# Opt-in build accelerators. TINK_UNITY_BUILD merges the sources of each
+# library into jumbo translation units, and TINK_PRECOMPILE_HEADERS compiles
+# the heavy third-party headers (absl, BoringSSL, protobuf) once and reuses
+# the result across all Tink libraries. Both cut clean-build times
+# considerably and both require CMake >= 3.16.
+option(TINK_UNITY_BUILD "Build each Tink library as a jumbo translation unit" OFF)
+option(TINK_PRECOMPILE_HEADERS "Precompile common third-party headers" OFF)
+if ((TINK_UNITY_BUILD OR TINK_PRECOMPILE_HEADERS)
+    AND ${CMAKE_VERSION} VERSION_LESS 3.16)
+  message(FATAL_ERROR
+          "TINK_UNITY_BUILD and TINK_PRECOMPILE_HEADERS require CMake >= 3.16")
+endif()
+
+# The headers precompiled under TINK_PRECOMPILE_HEADERS: the third-party
+# includes that appear in almost every Tink translation unit.
+set(TINK_PRECOMPILED_HEADER_LIST
+  <memory>
+  <string>
+  <utility>
+  <vector>
+  "absl/memory/memory.h"
+  "absl/strings/str_cat.h"
+  "absl/strings/string_view.h"
+  "google/protobuf/message_lite.h"
+  "openssl/evp.h"
+)
+
+# Applies the optional unity-build and precompiled-header settings to a
+# compiled (non-INTERFACE) target. The first target that requests
+# precompiled headers builds them; all later ones reuse that result, so
+# the headers are parsed once per build instead of once per TU.
+function(tink_apply_build_accelerators _target_name)
+  if (TINK_UNITY_BUILD)
+    set_property(TARGET ${_target_name} PROPERTY UNITY_BUILD true)
+  endif()
+  if (TINK_PRECOMPILE_HEADERS)
+    if (NOT TARGET tink_internal_pch)
+      # An empty source file, because a STATIC library needs one.
+      file(WRITE "${TINK_GENFILE_DIR}/tink_internal_pch.cc" "")
+      add_library(tink_internal_pch STATIC
+                  "${TINK_GENFILE_DIR}/tink_internal_pch.cc")
+      target_include_directories(tink_internal_pch PUBLIC ${TINK_INCLUDE_DIRS})
+      target_link_libraries(tink_internal_pch PUBLIC
+        absl::memory
+        absl::strings
+        crypto
+        protobuf::libprotobuf-lite
+      )
+      set_property(TARGET tink_internal_pch
+                   PROPERTY CXX_STANDARD ${TINK_CXX_STANDARD})
+      set_property(TARGET tink_internal_pch
+                   PROPERTY CXX_STANDARD_REQUIRED true)
+      target_precompile_headers(tink_internal_pch
+                                PRIVATE ${TINK_PRECOMPILED_HEADER_LIST})
+    endif()
+    # Linking the PCH target makes the include paths of the precompiled
+    # headers available to every reusing target.
+    target_link_libraries(${_target_name} PUBLIC tink_internal_pch)
+    target_precompile_headers(${_target_name} REUSE_FROM tink_internal_pch)
+  endif()
+endfunction(tink_apply_build_accelerators)
+
 # Declare the beginning of a new Tink library namespace.
 #
 # As a rule of thumb, every CMakeLists.txt should be a different module, named
@@ -136,6 +198,7 @@ function(tink_cc_library)
       set_property(TARGET ${_target_name}
                    PROPERTY FOLDER "${TINK_IDE_FOLDER}/Internal")
     endif()
+    tink_apply_build_accelerators(${_target_name})
   else()
     add_library(${_target_name} INTERFACE)
     target_include_directories(${_target_name} INTERFACE ${TINK_INCLUDE_DIRS})
@@ -191,6 +254,7 @@ function(tink_cc_test)
                PROPERTY FOLDER "${TINK_IDE_FOLDER}/Tests")
   set_property(TARGET ${_target_name} PROPERTY CXX_STANDARD ${TINK_CXX_STANDARD})
   set_property(TARGET ${_target_name} PROPERTY CXX_STANDARD_REQUIRED true)
+  tink_apply_build_accelerators(${_target_name})
 
   if (${CMAKE_VERSION} VERSION_LESS 3.9)
     add_test(NAME ${_target_name} COMMAND ${_target_name})
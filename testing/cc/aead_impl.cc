@@ -18,14 +18,10 @@
 #include "aead_impl.h"
 
 #include "tink/aead.h"
-#include "tink/binary_keyset_reader.h"
-#include "tink/cleartext_keyset_handle.h"
 #include "proto/testing/testing_api.grpc.pb.h"
 
 namespace tink_testing_api {
 
-using ::crypto::tink::BinaryKeysetReader;
-using ::crypto::tink::CleartextKeysetHandle;
 using ::grpc::ServerContext;
 using ::grpc::Status;
 
@@ -33,19 +29,7 @@ using ::grpc::Status;
 ::grpc::Status AeadImpl::Encrypt(grpc::ServerContext* context,
                                  const AeadEncryptRequest* request,
                                  AeadEncryptResponse* response) {
-  auto reader_result = BinaryKeysetReader::New(request->keyset());
-  if (!reader_result.ok()) {
-    response->set_err(reader_result.status().error_message());
-    return ::grpc::Status::OK;
-  }
-  auto handle_result =
-      CleartextKeysetHandle::Read(std::move(reader_result.ValueOrDie()));
-  if (!handle_result.ok()) {
-    response->set_err(handle_result.status().error_message());
-    return ::grpc::Status::OK;
-  }
-  auto aead_result =
-      handle_result.ValueOrDie()->GetPrimitive<crypto::tink::Aead>();
+  auto aead_result = aead_cache_.Get(request->keyset());
   if (!aead_result.ok()) {
     response->set_err(aead_result.status().error_message());
     return ::grpc::Status::OK;
@@ -64,19 +48,7 @@ using ::grpc::Status;
 ::grpc::Status AeadImpl::Decrypt(grpc::ServerContext* context,
                                  const AeadDecryptRequest* request,
                                  AeadDecryptResponse* response) {
-  auto reader_result = BinaryKeysetReader::New(request->keyset());
-  if (!reader_result.ok()) {
-    response->set_err(reader_result.status().error_message());
-    return ::grpc::Status::OK;
-  }
-  auto handle_result =
-      CleartextKeysetHandle::Read(std::move(reader_result.ValueOrDie()));
-  if (!handle_result.ok()) {
-    response->set_err(handle_result.status().error_message());
-    return ::grpc::Status::OK;
-  }
-  auto aead_result =
-      handle_result.ValueOrDie()->GetPrimitive<crypto::tink::Aead>();
+  auto aead_result = aead_cache_.Get(request->keyset());
   if (!aead_result.ok()) {
     response->set_err(aead_result.status().error_message());
     return ::grpc::Status::OK;
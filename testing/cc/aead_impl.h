@@ -21,6 +21,8 @@
 #include <grpcpp/server_context.h>
 #include <grpcpp/support/status.h>
 
+#include "tink/aead.h"
+#include "primitive_cache.h"
 #include "proto/testing/testing_api.grpc.pb.h"
 
 namespace tink_testing_api {
@@ -35,6 +37,9 @@ class AeadImpl final : public Aead::Service {
   grpc::Status Decrypt(grpc::ServerContext* context,
                        const AeadDecryptRequest* request,
                        AeadDecryptResponse* response) override;
+
+ private:
+  PrimitiveCache<crypto::tink::Aead> aead_cache_;
 };
 
 }  // namespace tink_testing_api
@@ -17,15 +17,11 @@
 // Implementation of an Deterministic AEAD Service.
 #include "deterministic_aead_impl.h"
 
-#include "tink/binary_keyset_reader.h"
-#include "tink/cleartext_keyset_handle.h"
 #include "tink/deterministic_aead.h"
 #include "proto/testing/testing_api.grpc.pb.h"
 
 namespace tink_testing_api {
 
-using ::crypto::tink::BinaryKeysetReader;
-using ::crypto::tink::CleartextKeysetHandle;
 using ::grpc::ServerContext;
 using ::grpc::Status;
 
@@ -34,19 +30,7 @@ using ::grpc::Status;
     grpc::ServerContext* context,
     const DeterministicAeadEncryptRequest* request,
     DeterministicAeadEncryptResponse* response) {
-  auto reader_result = BinaryKeysetReader::New(request->keyset());
-  if (!reader_result.ok()) {
-    response->set_err(reader_result.status().error_message());
-    return ::grpc::Status::OK;
-  }
-  auto handle_result =
-      CleartextKeysetHandle::Read(std::move(reader_result.ValueOrDie()));
-  if (!handle_result.ok()) {
-    response->set_err(handle_result.status().error_message());
-    return ::grpc::Status::OK;
-  }
-  auto daead_result = handle_result.ValueOrDie()
-                          ->GetPrimitive<crypto::tink::DeterministicAead>();
+  auto daead_result = daead_cache_.Get(request->keyset());
   if (!daead_result.ok()) {
     response->set_err(daead_result.status().error_message());
     return ::grpc::Status::OK;
@@ -66,19 +50,7 @@ using ::grpc::Status;
     grpc::ServerContext* context,
     const DeterministicAeadDecryptRequest* request,
     DeterministicAeadDecryptResponse* response) {
-  auto reader_result = BinaryKeysetReader::New(request->keyset());
-  if (!reader_result.ok()) {
-    response->set_err(reader_result.status().error_message());
-    return ::grpc::Status::OK;
-  }
-  auto handle_result =
-      CleartextKeysetHandle::Read(std::move(reader_result.ValueOrDie()));
-  if (!handle_result.ok()) {
-    response->set_err(handle_result.status().error_message());
-    return ::grpc::Status::OK;
-  }
-  auto daead_result = handle_result.ValueOrDie()
-                          ->GetPrimitive<crypto::tink::DeterministicAead>();
+  auto daead_result = daead_cache_.Get(request->keyset());
   if (!daead_result.ok()) {
     response->set_err(daead_result.status().error_message());
     return ::grpc::Status::OK;
@@ -21,6 +21,8 @@
 #include <grpcpp/server_context.h>
 #include <grpcpp/support/status.h>
 
+#include "tink/deterministic_aead.h"
+#include "primitive_cache.h"
 #include "proto/testing/testing_api.grpc.pb.h"
 
 namespace tink_testing_api {
@@ -37,6 +39,9 @@ class DeterministicAeadImpl final : public DeterministicAead::Service {
       grpc::ServerContext* context,
       const DeterministicAeadDecryptRequest* request,
       DeterministicAeadDecryptResponse* response) override;
+
+ private:
+  PrimitiveCache<crypto::tink::DeterministicAead> daead_cache_;
 };
 
 }  // namespace tink_testing_api
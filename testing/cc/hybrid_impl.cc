@@ -17,16 +17,12 @@
 // Implementation of a Hybrid encryption service
 #include "hybrid_impl.h"
 
-#include "tink/binary_keyset_reader.h"
-#include "tink/cleartext_keyset_handle.h"
 #include "tink/hybrid_decrypt.h"
 #include "tink/hybrid_encrypt.h"
 #include "proto/testing/testing_api.grpc.pb.h"
 
 namespace tink_testing_api {
 
-using ::crypto::tink::BinaryKeysetReader;
-using ::crypto::tink::CleartextKeysetHandle;
 using ::grpc::ServerContext;
 using ::grpc::Status;
 
@@ -34,20 +30,8 @@ using ::grpc::Status;
 ::grpc::Status HybridImpl::Encrypt(grpc::ServerContext* context,
                                    const HybridEncryptRequest* request,
                                    HybridEncryptResponse* response) {
-  auto reader_result = BinaryKeysetReader::New(request->public_keyset());
-  if (!reader_result.ok()) {
-    response->set_err(reader_result.status().error_message());
-    return ::grpc::Status::OK;
-  }
-  auto public_handle_result =
-      CleartextKeysetHandle::Read(std::move(reader_result.ValueOrDie()));
-  if (!public_handle_result.ok()) {
-    response->set_err(public_handle_result.status().error_message());
-    return ::grpc::Status::OK;
-  }
   auto hybrid_encrypt_result =
-      public_handle_result.ValueOrDie()
-          ->GetPrimitive<crypto::tink::HybridEncrypt>();
+      hybrid_encrypt_cache_.Get(request->public_keyset());
   if (!hybrid_encrypt_result.ok()) {
     response->set_err(hybrid_encrypt_result.status().error_message());
     return ::grpc::Status::OK;
@@ -66,20 +50,8 @@ using ::grpc::Status;
 ::grpc::Status HybridImpl::Decrypt(grpc::ServerContext* context,
                                    const HybridDecryptRequest* request,
                                    HybridDecryptResponse* response) {
-  auto reader_result = BinaryKeysetReader::New(request->private_keyset());
-  if (!reader_result.ok()) {
-    response->set_err(reader_result.status().error_message());
-    return ::grpc::Status::OK;
-  }
-  auto private_handle_result =
-      CleartextKeysetHandle::Read(std::move(reader_result.ValueOrDie()));
-  if (!private_handle_result.ok()) {
-    response->set_err(private_handle_result.status().error_message());
-    return ::grpc::Status::OK;
-  }
   auto hybrid_decrypt_result =
-      private_handle_result.ValueOrDie()
-          ->GetPrimitive<crypto::tink::HybridDecrypt>();
+      hybrid_decrypt_cache_.Get(request->private_keyset());
   if (!hybrid_decrypt_result.ok()) {
     response->set_err(hybrid_decrypt_result.status().error_message());
     return ::grpc::Status::OK;
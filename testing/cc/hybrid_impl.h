@@ -21,6 +21,9 @@
 #include <grpcpp/server_context.h>
 #include <grpcpp/support/status.h>
 
+#include "tink/hybrid_decrypt.h"
+#include "tink/hybrid_encrypt.h"
+#include "primitive_cache.h"
 #include "proto/testing/testing_api.grpc.pb.h"
 
 namespace tink_testing_api {
@@ -35,6 +38,10 @@ class HybridImpl final : public Hybrid::Service {
   grpc::Status Decrypt(grpc::ServerContext* context,
                        const HybridDecryptRequest* request,
                        HybridDecryptResponse* response) override;
+
+ private:
+  PrimitiveCache<crypto::tink::HybridEncrypt> hybrid_encrypt_cache_;
+  PrimitiveCache<crypto::tink::HybridDecrypt> hybrid_decrypt_cache_;
 };
 
 }  // namespace tink_testing_api
@@ -19,8 +19,6 @@
 #include <string>
 
 #include "absl/time/time.h"
-#include "tink/binary_keyset_reader.h"
-#include "tink/cleartext_keyset_handle.h"
 #include "tink/jwt/jwt_mac.h"
 #include "tink/jwt/jwt_public_key_sign.h"
 #include "tink/jwt/jwt_public_key_verify.h"
@@ -30,16 +28,9 @@
 
 namespace tink_testing_api {
 
-using ::crypto::tink::BinaryKeysetReader;
-using ::crypto::tink::CleartextKeysetHandle;
-using ::crypto::tink::KeysetHandle;
 using ::crypto::tink::util::StatusOr;
-using ::crypto::tink::JwtPublicKeySign;
-using ::crypto::tink::JwtPublicKeyVerify;
-using ::crypto::tink::JwtMac;
 using ::crypto::tink::RawJwt;
 using ::crypto::tink::VerifiedJwt;
-using ::crypto::tink::KeysetReader;
 
 using ::grpc::ServerContext;
 
@@ -210,20 +201,7 @@ crypto::tink::util::StatusOr<crypto::tink::JwtValidator> JwtValidatorFromProto(
 ::grpc::Status JwtImpl::ComputeMacAndEncode(grpc::ServerContext* context,
                                             const JwtSignRequest* request,
                                             JwtSignResponse* response) {
-  StatusOr<std::unique_ptr<KeysetReader>> reader_or =
-      BinaryKeysetReader::New(request->keyset());
-  if (!reader_or.ok()) {
-    response->set_err(reader_or.status().error_message());
-    return ::grpc::Status::OK;
-  }
-  StatusOr<std::unique_ptr<KeysetHandle>> handle_or =
-      CleartextKeysetHandle::Read(std::move(reader_or.ValueOrDie()));
-  if (!handle_or.ok()) {
-    response->set_err(handle_or.status().error_message());
-    return ::grpc::Status::OK;
-  }
-  StatusOr<std::unique_ptr<JwtMac>> jwt_mac_or =
-      handle_or.ValueOrDie()->GetPrimitive<JwtMac>();
+  auto jwt_mac_or = jwt_mac_cache_.Get(request->keyset());
   if (!jwt_mac_or.ok()) {
     response->set_err(jwt_mac_or.status().error_message());
     return ::grpc::Status::OK;
@@ -247,20 +225,7 @@ crypto::tink::util::StatusOr<crypto::tink::JwtValidator> JwtValidatorFromProto(
 ::grpc::Status JwtImpl::VerifyMacAndDecode(grpc::ServerContext* context,
                                            const JwtVerifyRequest* request,
                                            JwtVerifyResponse* response) {
-  StatusOr<std::unique_ptr<KeysetReader>> reader_or =
-      BinaryKeysetReader::New(request->keyset());
-  if (!reader_or.ok()) {
-    response->set_err(reader_or.status().error_message());
-    return ::grpc::Status::OK;
-  }
-  StatusOr<std::unique_ptr<KeysetHandle>> handle_or =
-      CleartextKeysetHandle::Read(std::move(reader_or.ValueOrDie()));
-  if (!handle_or.ok()) {
-    response->set_err(handle_or.status().error_message());
-    return ::grpc::Status::OK;
-  }
-  StatusOr<std::unique_ptr<JwtMac>> jwt_mac_or =
-      handle_or.ValueOrDie()->GetPrimitive<JwtMac>();
+  auto jwt_mac_or = jwt_mac_cache_.Get(request->keyset());
   if (!jwt_mac_or.ok()) {
     response->set_err(jwt_mac_or.status().error_message());
     return ::grpc::Status::OK;
@@ -282,20 +247,7 @@ crypto::tink::util::StatusOr<crypto::tink::JwtValidator> JwtValidatorFromProto(
 ::grpc::Status JwtImpl::PublicKeySignAndEncode(grpc::ServerContext* context,
                                    const JwtSignRequest* request,
                                    JwtSignResponse* response) {
-  StatusOr<std::unique_ptr<KeysetReader>> reader_or =
-      BinaryKeysetReader::New(request->keyset());
-  if (!reader_or.ok()) {
-    response->set_err(reader_or.status().error_message());
-    return ::grpc::Status::OK;
-  }
-  StatusOr<std::unique_ptr<KeysetHandle>> handle_or =
-      CleartextKeysetHandle::Read(std::move(reader_or.ValueOrDie()));
-  if (!handle_or.ok()) {
-    response->set_err(handle_or.status().error_message());
-    return ::grpc::Status::OK;
-  }
-  StatusOr<std::unique_ptr<JwtPublicKeySign>> jwt_sign_or =
-      handle_or.ValueOrDie()->GetPrimitive<JwtPublicKeySign>();
+  auto jwt_sign_or = jwt_sign_cache_.Get(request->keyset());
   if (!jwt_sign_or.ok()) {
     response->set_err(jwt_sign_or.status().error_message());
     return ::grpc::Status::OK;
@@ -318,20 +270,7 @@ crypto::tink::util::StatusOr<crypto::tink::JwtValidator> JwtValidatorFromProto(
 ::grpc::Status JwtImpl::PublicKeyVerifyAndDecode(grpc::ServerContext* context,
                                         const JwtVerifyRequest* request,
                                         JwtVerifyResponse* response) {
-  StatusOr<std::unique_ptr<KeysetReader>> reader_or =
-      BinaryKeysetReader::New(request->keyset());
-  if (!reader_or.ok()) {
-    response->set_err(reader_or.status().error_message());
-    return ::grpc::Status::OK;
-  }
-  StatusOr<std::unique_ptr<KeysetHandle>> handle_or =
-      CleartextKeysetHandle::Read(std::move(reader_or.ValueOrDie()));
-  if (!handle_or.ok()) {
-    response->set_err(handle_or.status().error_message());
-    return ::grpc::Status::OK;
-  }
-  StatusOr<std::unique_ptr<JwtPublicKeyVerify>> jwt_verify_or =
-      handle_or.ValueOrDie()->GetPrimitive<JwtPublicKeyVerify>();
+  auto jwt_verify_or = jwt_verify_cache_.Get(request->keyset());
   if (!jwt_verify_or.ok()) {
     response->set_err(jwt_verify_or.status().error_message());
     return ::grpc::Status::OK;
@@ -21,6 +21,10 @@
 #include <grpcpp/server_context.h>
 #include <grpcpp/support/status.h>
 
+#include "tink/jwt/jwt_mac.h"
+#include "tink/jwt/jwt_public_key_sign.h"
+#include "tink/jwt/jwt_public_key_verify.h"
+#include "primitive_cache.h"
 #include "proto/testing/testing_api.grpc.pb.h"
 
 namespace tink_testing_api {
@@ -43,6 +47,11 @@ class JwtImpl final : public Jwt::Service {
   grpc::Status PublicKeyVerifyAndDecode(grpc::ServerContext* context,
                                   const JwtVerifyRequest* request,
                                   JwtVerifyResponse* response) override;
+
+ private:
+  PrimitiveCache<crypto::tink::JwtMac> jwt_mac_cache_;
+  PrimitiveCache<crypto::tink::JwtPublicKeySign> jwt_sign_cache_;
+  PrimitiveCache<crypto::tink::JwtPublicKeyVerify> jwt_verify_cache_;
 };
 
 }  // namespace tink_testing_api
@@ -17,15 +17,11 @@
 // Implementation of a MAC Service.
 #include "mac_impl.h"
 
-#include "tink/binary_keyset_reader.h"
-#include "tink/cleartext_keyset_handle.h"
 #include "tink/mac.h"
 #include "proto/testing/testing_api.grpc.pb.h"
 
 namespace tink_testing_api {
 
-using ::crypto::tink::BinaryKeysetReader;
-using ::crypto::tink::CleartextKeysetHandle;
 using ::grpc::ServerContext;
 using ::grpc::Status;
 
@@ -33,19 +29,7 @@ using ::grpc::Status;
 ::grpc::Status MacImpl::ComputeMac(grpc::ServerContext* context,
                                    const ComputeMacRequest* request,
                                    ComputeMacResponse* response) {
-  auto reader_result = BinaryKeysetReader::New(request->keyset());
-  if (!reader_result.ok()) {
-    response->set_err(reader_result.status().error_message());
-    return ::grpc::Status::OK;
-  }
-  auto handle_result =
-      CleartextKeysetHandle::Read(std::move(reader_result.ValueOrDie()));
-  if (!handle_result.ok()) {
-    response->set_err(handle_result.status().error_message());
-    return ::grpc::Status::OK;
-  }
-  auto mac_result =
-      handle_result.ValueOrDie()->GetPrimitive<crypto::tink::Mac>();
+  auto mac_result = mac_cache_.Get(request->keyset());
   if (!mac_result.ok()) {
     response->set_err(mac_result.status().error_message());
     return ::grpc::Status::OK;
@@ -63,19 +47,7 @@ using ::grpc::Status;
 ::grpc::Status MacImpl::VerifyMac(grpc::ServerContext* context,
                                   const VerifyMacRequest* request,
                                   VerifyMacResponse* response) {
-  auto reader_result = BinaryKeysetReader::New(request->keyset());
-  if (!reader_result.ok()) {
-    response->set_err(reader_result.status().error_message());
-    return ::grpc::Status::OK;
-  }
-  auto handle_result =
-      CleartextKeysetHandle::Read(std::move(reader_result.ValueOrDie()));
-  if (!handle_result.ok()) {
-    response->set_err(handle_result.status().error_message());
-    return ::grpc::Status::OK;
-  }
-  auto mac_result =
-      handle_result.ValueOrDie()->GetPrimitive<crypto::tink::Mac>();
+  auto mac_result = mac_cache_.Get(request->keyset());
   if (!mac_result.ok()) {
     response->set_err(mac_result.status().error_message());
     return ::grpc::Status::OK;
@@ -21,6 +21,8 @@
 #include <grpcpp/server_context.h>
 #include <grpcpp/support/status.h>
 
+#include "tink/mac.h"
+#include "primitive_cache.h"
 #include "proto/testing/testing_api.grpc.pb.h"
 
 namespace tink_testing_api {
@@ -35,6 +37,9 @@ class MacImpl final : public Mac::Service {
   grpc::Status VerifyMac(grpc::ServerContext* context,
                          const VerifyMacRequest* request,
                          VerifyMacResponse* response) override;
+
+ private:
+  PrimitiveCache<crypto::tink::Mac> mac_cache_;
 };
 
 }  // namespace tink_testing_api
@@ -17,15 +17,11 @@
 // Implementation of a PrfSet Service.
 #include "prf_set_impl.h"
 
-#include "tink/binary_keyset_reader.h"
-#include "tink/cleartext_keyset_handle.h"
 #include "tink/prf/prf_set.h"
 #include "proto/testing/testing_api.grpc.pb.h"
 
 namespace tink_testing_api {
 
-using ::crypto::tink::BinaryKeysetReader;
-using ::crypto::tink::CleartextKeysetHandle;
 using ::grpc::ServerContext;
 using ::grpc::Status;
 
@@ -33,19 +29,7 @@ using ::grpc::Status;
 ::grpc::Status PrfSetImpl::KeyIds(ServerContext* context,
                                   const PrfSetKeyIdsRequest* request,
                                   PrfSetKeyIdsResponse* response) {
-  auto reader_result = BinaryKeysetReader::New(request->keyset());
-  if (!reader_result.ok()) {
-    response->set_err(reader_result.status().error_message());
-    return ::grpc::Status::OK;
-  }
-  auto handle_result =
-      CleartextKeysetHandle::Read(std::move(reader_result.ValueOrDie()));
-  if (!handle_result.ok()) {
-    response->set_err(handle_result.status().error_message());
-    return ::grpc::Status::OK;
-  }
-  auto prf_set_result =
-      handle_result.ValueOrDie()->GetPrimitive<crypto::tink::PrfSet>();
+  auto prf_set_result = prf_set_cache_.Get(request->keyset());
   if (!prf_set_result.ok()) {
     response->set_err(prf_set_result.status().error_message());
     return ::grpc::Status::OK;
@@ -62,19 +46,7 @@ using ::grpc::Status;
 ::grpc::Status PrfSetImpl::Compute(ServerContext* context,
                                    const PrfSetComputeRequest* request,
                                    PrfSetComputeResponse* response) {
-  auto reader_result = BinaryKeysetReader::New(request->keyset());
-  if (!reader_result.ok()) {
-    response->set_err(reader_result.status().error_message());
-    return ::grpc::Status::OK;
-  }
-  auto handle_result =
-      CleartextKeysetHandle::Read(std::move(reader_result.ValueOrDie()));
-  if (!handle_result.ok()) {
-    response->set_err(handle_result.status().error_message());
-    return ::grpc::Status::OK;
-  }
-  auto prf_set_result =
-      handle_result.ValueOrDie()->GetPrimitive<crypto::tink::PrfSet>();
+  auto prf_set_result = prf_set_cache_.Get(request->keyset());
   if (!prf_set_result.ok()) {
     response->set_err(prf_set_result.status().error_message());
     return ::grpc::Status::OK;
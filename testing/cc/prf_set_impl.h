@@ -21,6 +21,8 @@
 #include <grpcpp/server_context.h>
 #include <grpcpp/support/status.h>
 
+#include "tink/prf/prf_set.h"
+#include "primitive_cache.h"
 #include "proto/testing/testing_api.grpc.pb.h"
 
 namespace tink_testing_api {
@@ -35,6 +37,9 @@ class PrfSetImpl final : public PrfSet::Service {
   grpc::Status Compute(grpc::ServerContext* context,
                        const PrfSetComputeRequest* request,
                        PrfSetComputeResponse* response) override;
+
+ private:
+  PrimitiveCache<crypto::tink::PrfSet> prf_set_cache_;
 };
 
 }  // namespace tink_testing_api
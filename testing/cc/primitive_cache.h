@@ -0,0 +1,100 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_TESTING_SERIVCES_PRIMITIVE_CACHE_H_
+#define TINK_TESTING_SERIVCES_PRIMITIVE_CACHE_H_
+
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "tink/binary_keyset_reader.h"
+#include "tink/cleartext_keyset_handle.h"
+#include "tink/keyset_handle.h"
+#include "tink/util/statusor.h"
+
+namespace tink_testing_api {
+
+// An LRU cache of wrapped primitives, keyed by the serialized keyset they
+// were built from. Every testing service RPC carries the full serialized
+// keyset, and conformance runs reuse a handful of keysets across thousands
+// of requests, so parsing and wrapping each keyset once instead of once per
+// request removes most of the service-side work.
+//
+// Thread-safe. The returned primitives are shared between requests, which
+// is fine since Tink primitives are thread-safe.
+template <typename Primitive>
+class PrimitiveCache {
+ public:
+  // 'max_size' bounds the number of distinct keysets kept; beyond it the
+  // least recently used entry is evicted.
+  explicit PrimitiveCache(size_t max_size = 100) : max_size_(max_size) {}
+
+  // Returns the wrapped primitive for 'serialized_keyset' (a binary
+  // serialized cleartext keyset), building and caching it on the first use
+  // of the keyset.
+  crypto::tink::util::StatusOr<std::shared_ptr<Primitive>> Get(
+      const std::string& serialized_keyset) {
+    absl::MutexLock lock(&mutex_);
+    auto map_it = entries_.find(serialized_keyset);
+    if (map_it != entries_.end()) {
+      lru_.splice(lru_.begin(), lru_, map_it->second);
+      return map_it->second->second;
+    }
+    auto reader_result =
+        crypto::tink::BinaryKeysetReader::New(serialized_keyset);
+    if (!reader_result.ok()) {
+      return reader_result.status();
+    }
+    auto handle_result = crypto::tink::CleartextKeysetHandle::Read(
+        std::move(reader_result.ValueOrDie()));
+    if (!handle_result.ok()) {
+      return handle_result.status();
+    }
+    auto primitive_result =
+        handle_result.ValueOrDie()->GetPrimitive<Primitive>();
+    if (!primitive_result.ok()) {
+      return primitive_result.status();
+    }
+    std::shared_ptr<Primitive> primitive(
+        std::move(primitive_result.ValueOrDie()));
+    lru_.emplace_front(serialized_keyset, primitive);
+    entries_[serialized_keyset] = lru_.begin();
+    if (entries_.size() > max_size_) {
+      entries_.erase(lru_.back().first);
+      lru_.pop_back();
+    }
+    return primitive;
+  }
+
+ private:
+  using Entry = std::pair<std::string, std::shared_ptr<Primitive>>;
+
+  const size_t max_size_;
+  absl::Mutex mutex_;
+  // Cached entries, most recently used first.
+  std::list<Entry> lru_ ABSL_GUARDED_BY(mutex_);
+  std::unordered_map<std::string, typename std::list<Entry>::iterator>
+      entries_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace tink_testing_api
+
+#endif  // TINK_TESTING_SERIVCES_PRIMITIVE_CACHE_H_
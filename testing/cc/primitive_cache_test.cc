@@ -0,0 +1,105 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "primitive_cache.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "tink/binary_keyset_writer.h"
+#include "tink/cleartext_keyset_handle.h"
+#include "tink/mac.h"
+#include "tink/mac/mac_config.h"
+#include "tink/mac/mac_key_templates.h"
+
+namespace crypto {
+namespace tink {
+namespace {
+
+using ::crypto::tink::BinaryKeysetWriter;
+using ::crypto::tink::CleartextKeysetHandle;
+using ::crypto::tink::MacKeyTemplates;
+using ::tink_testing_api::PrimitiveCache;
+
+std::string ValidKeyset() {
+  auto handle_result = KeysetHandle::GenerateNew(MacKeyTemplates::HmacSha256());
+  EXPECT_TRUE(handle_result.ok());
+  std::stringbuf keyset;
+  auto writer_result =
+      BinaryKeysetWriter::New(absl::make_unique<std::ostream>(&keyset));
+  EXPECT_TRUE(writer_result.ok());
+
+  auto status = CleartextKeysetHandle::Write(writer_result.ValueOrDie().get(),
+                                             *handle_result.ValueOrDie());
+  EXPECT_TRUE(status.ok());
+  return keyset.str();
+}
+
+class PrimitiveCacheTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() { ASSERT_TRUE(MacConfig::Register().ok()); }
+};
+
+TEST_F(PrimitiveCacheTest, SameKeysetReturnsSamePrimitive) {
+  PrimitiveCache<Mac> cache;
+  std::string keyset = ValidKeyset();
+
+  auto first = cache.Get(keyset);
+  ASSERT_TRUE(first.ok());
+  auto second = cache.Get(keyset);
+  ASSERT_TRUE(second.ok());
+  EXPECT_EQ(first.ValueOrDie().get(), second.ValueOrDie().get());
+
+  auto mac_value =
+      first.ValueOrDie()->ComputeMac("some data to authenticate");
+  ASSERT_TRUE(mac_value.ok());
+  EXPECT_TRUE(second.ValueOrDie()
+                  ->VerifyMac(mac_value.ValueOrDie(),
+                              "some data to authenticate")
+                  .ok());
+}
+
+TEST_F(PrimitiveCacheTest, DifferentKeysetsGetDifferentPrimitives) {
+  PrimitiveCache<Mac> cache;
+  auto first = cache.Get(ValidKeyset());
+  ASSERT_TRUE(first.ok());
+  auto second = cache.Get(ValidKeyset());
+  ASSERT_TRUE(second.ok());
+  EXPECT_NE(first.ValueOrDie().get(), second.ValueOrDie().get());
+}
+
+TEST_F(PrimitiveCacheTest, InvalidKeysetFails) {
+  PrimitiveCache<Mac> cache;
+  EXPECT_FALSE(cache.Get("invalid keyset").ok());
+}
+
+TEST_F(PrimitiveCacheTest, EvictsLeastRecentlyUsedEntry) {
+  PrimitiveCache<Mac> cache(/*max_size=*/2);
+  std::string keyset_a = ValidKeyset();
+  std::string keyset_b = ValidKeyset();
+  std::string keyset_c = ValidKeyset();
+
+  auto a = cache.Get(keyset_a).ValueOrDie();
+  auto b = cache.Get(keyset_b).ValueOrDie();
+  // 'a' is the least recently used entry, so caching 'c' evicts it.
+  auto c = cache.Get(keyset_c).ValueOrDie();
+
+  EXPECT_NE(cache.Get(keyset_a).ValueOrDie().get(), a.get());
+  EXPECT_EQ(cache.Get(keyset_c).ValueOrDie().get(), c.get());
+}
+
+}  // namespace
+}  // namespace tink
+}  // namespace crypto
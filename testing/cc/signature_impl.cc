@@ -17,16 +17,12 @@
 // Implementation of a Signature Service
 #include "signature_impl.h"
 
-#include "tink/binary_keyset_reader.h"
-#include "tink/cleartext_keyset_handle.h"
 #include "tink/public_key_sign.h"
 #include "tink/public_key_verify.h"
 #include "proto/testing/testing_api.grpc.pb.h"
 
 namespace tink_testing_api {
 
-using ::crypto::tink::BinaryKeysetReader;
-using ::crypto::tink::CleartextKeysetHandle;
 using ::grpc::ServerContext;
 using ::grpc::Status;
 
@@ -34,19 +30,7 @@ using ::grpc::Status;
 ::grpc::Status SignatureImpl::Sign(grpc::ServerContext* context,
                                    const SignatureSignRequest* request,
                                    SignatureSignResponse* response) {
-  auto reader_result = BinaryKeysetReader::New(request->private_keyset());
-  if (!reader_result.ok()) {
-    response->set_err(reader_result.status().error_message());
-    return ::grpc::Status::OK;
-  }
-  auto private_handle_result =
-      CleartextKeysetHandle::Read(std::move(reader_result.ValueOrDie()));
-  if (!private_handle_result.ok()) {
-    response->set_err(private_handle_result.status().error_message());
-    return ::grpc::Status::OK;
-  }
-  auto signer_result = private_handle_result.ValueOrDie()
-                           ->GetPrimitive<crypto::tink::PublicKeySign>();
+  auto signer_result = sign_cache_.Get(request->private_keyset());
   if (!signer_result.ok()) {
     response->set_err(signer_result.status().error_message());
     return ::grpc::Status::OK;
@@ -64,19 +48,7 @@ using ::grpc::Status;
 ::grpc::Status SignatureImpl::Verify(grpc::ServerContext* context,
                                      const SignatureVerifyRequest* request,
                                      SignatureVerifyResponse* response) {
-  auto reader_result = BinaryKeysetReader::New(request->public_keyset());
-  if (!reader_result.ok()) {
-    response->set_err(reader_result.status().error_message());
-    return ::grpc::Status::OK;
-  }
-  auto public_handle_result =
-      CleartextKeysetHandle::Read(std::move(reader_result.ValueOrDie()));
-  if (!public_handle_result.ok()) {
-    response->set_err(public_handle_result.status().error_message());
-    return ::grpc::Status::OK;
-  }
-  auto verifier_result = public_handle_result.ValueOrDie()
-                             ->GetPrimitive<crypto::tink::PublicKeyVerify>();
+  auto verifier_result = verify_cache_.Get(request->public_keyset());
   if (!verifier_result.ok()) {
     response->set_err(verifier_result.status().error_message());
     return ::grpc::Status::OK;
@@ -21,6 +21,9 @@
 #include <grpcpp/server_context.h>
 #include <grpcpp/support/status.h>
 
+#include "tink/public_key_sign.h"
+#include "tink/public_key_verify.h"
+#include "primitive_cache.h"
 #include "proto/testing/testing_api.grpc.pb.h"
 
 namespace tink_testing_api {
@@ -35,6 +38,10 @@ class SignatureImpl final : public Signature::Service {
   grpc::Status Verify(grpc::ServerContext* context,
                       const SignatureVerifyRequest* request,
                       SignatureVerifyResponse* response) override;
+
+ private:
+  PrimitiveCache<crypto::tink::PublicKeySign> sign_cache_;
+  PrimitiveCache<crypto::tink::PublicKeyVerify> verify_cache_;
 };
 
 }  // namespace tink_testing_api
@@ -17,9 +17,10 @@
 // Implementation of a StreamingAEAD Service.
 #include "streaming_aead_impl.h"
 
+#include "absl/strings/string_view.h"
+#include "tink/input_stream.h"
+#include "tink/output_stream.h"
 #include "tink/streaming_aead.h"
-#include "tink/binary_keyset_reader.h"
-#include "tink/cleartext_keyset_handle.h"
 #include "tink/util/istream_input_stream.h"
 #include "tink/util/ostream_output_stream.h"
 #include "tink/util/status.h"
@@ -29,32 +30,97 @@ namespace tink_testing_api {
 
 namespace tinkutil = ::crypto::tink::util;
 
-using ::crypto::tink::BinaryKeysetReader;
-using ::crypto::tink::CleartextKeysetHandle;
 using ::crypto::tink::InputStream;
+using ::crypto::tink::OutputStream;
 using ::crypto::tink::util::IstreamInputStream;
 using ::crypto::tink::util::OstreamOutputStream;
 using ::grpc::ServerContext;
 using ::grpc::Status;
 
+namespace {
+
+// Writes 'contents' into 'output_stream', backing up the unused part of
+// the last block.
+tinkutil::Status WriteToOutputStream(OutputStream* output_stream,
+                                     absl::string_view contents) {
+  void* buffer;
+  int pos = 0;
+  int remaining = contents.length();
+  int available_space = 0;
+  int available_bytes = 0;
+  while (remaining > 0) {
+    auto next_result = output_stream->Next(&buffer);
+    if (!next_result.ok()) {
+      return next_result.status();
+    }
+    available_space = next_result.ValueOrDie();
+    available_bytes = std::min(available_space, remaining);
+    memcpy(buffer, contents.data() + pos, available_bytes);
+    remaining -= available_bytes;
+    pos += available_bytes;
+  }
+  if (available_space > available_bytes) {
+    output_stream->BackUp(available_space - available_bytes);
+  }
+  return tinkutil::Status::OK;
+}
+
+// An InputStream that pulls ciphertext chunks from the gRPC request
+// stream on demand, so a decryption never buffers more than one chunk.
+class GrpcReaderInputStream : public InputStream {
+ public:
+  explicit GrpcReaderInputStream(
+      grpc::ServerReaderWriter<StreamingAeadStreamDecryptResponse,
+                               StreamingAeadStreamDecryptRequest>* stream)
+      : stream_(stream), offset_(0), position_(0) {}
+
+  tinkutil::StatusOr<int> Next(const void** data) override {
+    while (offset_ == buffer_.size()) {
+      StreamingAeadStreamDecryptRequest request;
+      if (!stream_->Read(&request)) {
+        return tinkutil::Status(tinkutil::error::OUT_OF_RANGE,
+                                "Reached end of the ciphertext stream.");
+      }
+      if (!request.has_ciphertext_chunk()) {
+        return tinkutil::Status(
+            tinkutil::error::INVALID_ARGUMENT,
+            "All messages after the first must set ciphertext_chunk.");
+      }
+      buffer_ = request.ciphertext_chunk();
+      offset_ = 0;
+    }
+    *data = buffer_.data() + offset_;
+    int count = buffer_.size() - offset_;
+    offset_ = buffer_.size();
+    position_ += count;
+    return count;
+  }
+
+  void BackUp(int count) override {
+    if (count <= 0) return;
+    size_t actual_count = std::min(static_cast<size_t>(count), offset_);
+    offset_ -= actual_count;
+    position_ -= actual_count;
+  }
+
+  int64_t Position() const override { return position_; }
+
+ private:
+  grpc::ServerReaderWriter<StreamingAeadStreamDecryptResponse,
+                           StreamingAeadStreamDecryptRequest>* stream_;
+  std::string buffer_;
+  size_t offset_;
+  int64_t position_;
+};
+
+}  // namespace
+
 // Encrypts a message
 ::grpc::Status StreamingAeadImpl::Encrypt(
     grpc::ServerContext* context,
     const StreamingAeadEncryptRequest* request,
     StreamingAeadEncryptResponse* response) {
-  auto reader_result = BinaryKeysetReader::New(request->keyset());
-  if (!reader_result.ok()) {
-    response->set_err(reader_result.status().error_message());
-    return ::grpc::Status::OK;
-  }
-  auto handle_result =
-      CleartextKeysetHandle::Read(std::move(reader_result.ValueOrDie()));
-  if (!handle_result.ok()) {
-    response->set_err(handle_result.status().error_message());
-    return ::grpc::Status::OK;
-  }
-  auto streaming_aead_result =
-      handle_result.ValueOrDie()->GetPrimitive<crypto::tink::StreamingAead>();
+  auto streaming_aead_result = streaming_aead_cache_.Get(request->keyset());
   if (!streaming_aead_result.ok()) {
     response->set_err(streaming_aead_result.status().error_message());
     return ::grpc::Status::OK;
@@ -74,26 +140,11 @@ using ::grpc::Status;
   }
   auto encrypting_stream = std::move(encrypting_stream_result.ValueOrDie());
 
-  auto contents = request->plaintext();
-  void* buffer;
-  int pos = 0;
-  int remaining = contents.length();
-  int available_space = 0;
-  int available_bytes = 0;
-  while (remaining > 0) {
-    auto next_result = encrypting_stream->Next(&buffer);
-    if (!next_result.ok()) {
-      response->set_err(next_result.status().error_message());
-      return ::grpc::Status::OK;
-    }
-    available_space = next_result.ValueOrDie();
-    available_bytes = std::min(available_space, remaining);
-    memcpy(buffer, contents.data() + pos, available_bytes);
-    remaining -= available_bytes;
-    pos += available_bytes;
-  }
-  if (available_space > available_bytes) {
-    encrypting_stream->BackUp(available_space - available_bytes);
+  auto write_status =
+      WriteToOutputStream(encrypting_stream.get(), request->plaintext());
+  if (!write_status.ok()) {
+    response->set_err(write_status.error_message());
+    return ::grpc::Status::OK;
   }
   auto close_status = encrypting_stream->Close();
   if (!close_status.ok()) {
@@ -110,19 +161,7 @@ using ::grpc::Status;
     grpc::ServerContext* context,
     const StreamingAeadDecryptRequest* request,
     StreamingAeadDecryptResponse* response) {
-  auto reader_result = BinaryKeysetReader::New(request->keyset());
-  if (!reader_result.ok()) {
-    response->set_err(reader_result.status().error_message());
-    return ::grpc::Status::OK;
-  }
-  auto handle_result =
-      CleartextKeysetHandle::Read(std::move(reader_result.ValueOrDie()));
-  if (!handle_result.ok()) {
-    response->set_err(handle_result.status().error_message());
-    return ::grpc::Status::OK;
-  }
-  auto streaming_aead_result =
-      handle_result.ValueOrDie()->GetPrimitive<crypto::tink::StreamingAead>();
+  auto streaming_aead_result = streaming_aead_cache_.Get(request->keyset());
   if (!streaming_aead_result.ok()) {
     response->set_err(streaming_aead_result.status().error_message());
     return ::grpc::Status::OK;
@@ -165,4 +204,130 @@ using ::grpc::Status;
   return ::grpc::Status::OK;
 }
 
+// Encrypts a stream of plaintext chunks, emitting ciphertext chunks as
+// they are produced, so the payload is never held in memory as a whole.
+::grpc::Status StreamingAeadImpl::EncryptStream(
+    grpc::ServerContext* context,
+    grpc::ServerReaderWriter<StreamingAeadStreamEncryptResponse,
+                             StreamingAeadStreamEncryptRequest>* stream) {
+  StreamingAeadStreamEncryptRequest request;
+  StreamingAeadStreamEncryptResponse response;
+  if (!stream->Read(&request) || !request.has_header()) {
+    response.set_err("The first message of the stream must set the header.");
+    stream->Write(response);
+    return ::grpc::Status::OK;
+  }
+  auto streaming_aead_result =
+      streaming_aead_cache_.Get(request.header().keyset());
+  if (!streaming_aead_result.ok()) {
+    response.set_err(streaming_aead_result.status().error_message());
+    stream->Write(response);
+    return ::grpc::Status::OK;
+  }
+
+  auto ciphertext_stream = absl::make_unique<std::stringstream>();
+  auto ciphertext_buf = ciphertext_stream->rdbuf();
+  auto encrypting_stream_result =
+      streaming_aead_result.ValueOrDie()->NewEncryptingStream(
+          absl::make_unique<OstreamOutputStream>(std::move(ciphertext_stream)),
+          request.header().associated_data());
+  if (!encrypting_stream_result.ok()) {
+    response.set_err(encrypting_stream_result.status().error_message());
+    stream->Write(response);
+    return ::grpc::Status::OK;
+  }
+  auto encrypting_stream = std::move(encrypting_stream_result.ValueOrDie());
+
+  while (stream->Read(&request)) {
+    if (!request.has_plaintext_chunk()) {
+      response.set_err(
+          "All messages after the first must set plaintext_chunk.");
+      stream->Write(response);
+      return ::grpc::Status::OK;
+    }
+    auto write_status = WriteToOutputStream(encrypting_stream.get(),
+                                            request.plaintext_chunk());
+    if (!write_status.ok()) {
+      response.set_err(write_status.error_message());
+      stream->Write(response);
+      return ::grpc::Status::OK;
+    }
+    // Forward whatever ciphertext the encrypting stream has completed so
+    // far, and drop it from the buffer.
+    std::string ciphertext_chunk = ciphertext_buf->str();
+    if (!ciphertext_chunk.empty()) {
+      ciphertext_buf->str("");
+      response.set_ciphertext_chunk(ciphertext_chunk);
+      if (!stream->Write(response)) {
+        return ::grpc::Status::OK;
+      }
+    }
+  }
+  auto close_status = encrypting_stream->Close();
+  if (!close_status.ok()) {
+    response.set_err(close_status.error_message());
+    stream->Write(response);
+    return ::grpc::Status::OK;
+  }
+  response.set_ciphertext_chunk(ciphertext_buf->str());
+  stream->Write(response);
+  return ::grpc::Status::OK;
+}
+
+// Decrypts a stream of ciphertext chunks, emitting plaintext chunks as
+// they are decrypted.
+::grpc::Status StreamingAeadImpl::DecryptStream(
+    grpc::ServerContext* context,
+    grpc::ServerReaderWriter<StreamingAeadStreamDecryptResponse,
+                             StreamingAeadStreamDecryptRequest>* stream) {
+  StreamingAeadStreamDecryptRequest request;
+  StreamingAeadStreamDecryptResponse response;
+  if (!stream->Read(&request) || !request.has_header()) {
+    response.set_err("The first message of the stream must set the header.");
+    stream->Write(response);
+    return ::grpc::Status::OK;
+  }
+  auto streaming_aead_result =
+      streaming_aead_cache_.Get(request.header().keyset());
+  if (!streaming_aead_result.ok()) {
+    response.set_err(streaming_aead_result.status().error_message());
+    stream->Write(response);
+    return ::grpc::Status::OK;
+  }
+
+  auto decrypting_stream_result =
+      streaming_aead_result.ValueOrDie()->NewDecryptingStream(
+          absl::make_unique<GrpcReaderInputStream>(stream),
+          request.header().associated_data());
+  if (!decrypting_stream_result.ok()) {
+    response.set_err(decrypting_stream_result.status().error_message());
+    stream->Write(response);
+    return ::grpc::Status::OK;
+  }
+  auto decrypting_stream = std::move(decrypting_stream_result.ValueOrDie());
+
+  const void* buffer;
+  while (true) {
+    auto next_result = decrypting_stream->Next(&buffer);
+    if (next_result.status().error_code() == tinkutil::error::OUT_OF_RANGE) {
+      // End of stream.
+      break;
+    }
+    if (!next_result.ok()) {
+      response.set_err(next_result.status().error_message());
+      stream->Write(response);
+      return ::grpc::Status::OK;
+    }
+    auto read_bytes = next_result.ValueOrDie();
+    if (read_bytes > 0) {
+      response.set_plaintext_chunk(
+          std::string(reinterpret_cast<const char*>(buffer), read_bytes));
+      if (!stream->Write(response)) {
+        return ::grpc::Status::OK;
+      }
+    }
+  }
+  return ::grpc::Status::OK;
+}
+
 }  // namespace tink_testing_api
@@ -21,6 +21,8 @@
 #include <grpcpp/server_context.h>
 #include <grpcpp/support/status.h>
 
+#include "tink/streaming_aead.h"
+#include "primitive_cache.h"
 #include "proto/testing/testing_api.grpc.pb.h"
 
 namespace tink_testing_api {
@@ -35,6 +37,21 @@ class StreamingAeadImpl final : public StreamingAead::Service {
   grpc::Status Decrypt(grpc::ServerContext* context,
                        const StreamingAeadDecryptRequest* request,
                        StreamingAeadDecryptResponse* response) override;
+
+  grpc::Status EncryptStream(
+      grpc::ServerContext* context,
+      grpc::ServerReaderWriter<StreamingAeadStreamEncryptResponse,
+                               StreamingAeadStreamEncryptRequest>* stream)
+      override;
+
+  grpc::Status DecryptStream(
+      grpc::ServerContext* context,
+      grpc::ServerReaderWriter<StreamingAeadStreamDecryptResponse,
+                               StreamingAeadStreamDecryptRequest>* stream)
+      override;
+
+ private:
+  PrimitiveCache<crypto::tink::StreamingAead> streaming_aead_cache_;
 };
 
 }  // namespace tink_testing_api
@@ -35,6 +35,9 @@
 #include "jwt_impl.h"
 
 ABSL_FLAG(int, port, 23456, "the port");
+ABSL_FLAG(int, num_server_threads, 0,
+          "the number of server completion queues and polling threads; "
+          "0 keeps the gRPC default");
 
 void RunServer() {
   auto status = crypto::tink::TinkConfig::Register();
@@ -79,6 +82,20 @@ void RunServer() {
   tink_testing_api::JwtImpl jwt;
 
   grpc::ServerBuilder builder;
+  const int num_server_threads = absl::GetFlag(FLAGS_num_server_threads);
+  if (num_server_threads > 0) {
+    // Run one completion queue per thread and pin the poller count, so
+    // concurrent test shards execute in parallel instead of contending on
+    // the default server setup.
+    builder.SetSyncServerOption(grpc::ServerBuilder::SyncServerOption::NUM_CQS,
+                                num_server_threads);
+    builder.SetSyncServerOption(
+        grpc::ServerBuilder::SyncServerOption::MIN_POLLERS,
+        num_server_threads);
+    builder.SetSyncServerOption(
+        grpc::ServerBuilder::SyncServerOption::MAX_POLLERS,
+        num_server_threads);
+  }
   builder.AddListeningPort(
       server_address, ::grpc::experimental::LocalServerCredentials(LOCAL_TCP));
 